@@ -0,0 +1,102 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <Eigen/Geometry>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace collision_detection
+{
+/** \brief A dynamic bounding volume hierarchy over axis-aligned boxes identified by name.
+
+    Boxes can be inserted, moved and removed one at a time, and the names of all boxes intersecting a query box are
+    found without visiting every box. Boxes that are not finite (e.g. of infinite planes) are kept aside and reported
+    by every non-empty query. */
+class AABBTree
+{
+public:
+  using Box = Eigen::AlignedBox3d;
+
+  /** \brief Insert the box of \e id, or replace it if \e id is known. Empty boxes are not stored. */
+  void update(const std::string& id, const Box& box);
+
+  /** \brief Remove the box of \e id. Returns false if \e id is not known */
+  bool remove(const std::string& id);
+
+  /** \brief Remove all boxes */
+  void clear();
+
+  /** \brief Append the ids of the boxes intersecting \e box to \e ids */
+  void query(const Box& box, std::vector<std::string>& ids) const;
+
+  /** \brief The number of boxes in the tree */
+  std::size_t size() const
+  {
+    return leaves_.size() + unbounded_.size();
+  }
+
+  /** \brief The box bounding all boxes in the tree, empty if there are none. Unbounded boxes are not included. */
+  Box getBounds() const
+  {
+    return root_ < 0 ? Box() : nodes_[root_].box;
+  }
+
+private:
+  struct Node
+  {
+    Box box;
+    int parent = -1;
+    int left = -1;  // -1 for leaves
+    int right = -1;
+    std::string id;  // only set for leaves
+  };
+
+  int allocateNode();
+  void freeNode(int index);
+  void insertLeaf(int leaf);
+  void removeLeaf(int leaf);
+  void refit(int index);
+
+  std::vector<Node> nodes_;
+  std::vector<int> free_nodes_;
+  int root_ = -1;
+  std::map<std::string, int> leaves_;
+  std::set<std::string> unbounded_;
+};
+}  // namespace collision_detection
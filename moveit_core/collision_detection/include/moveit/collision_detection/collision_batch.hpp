@@ -0,0 +1,119 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace collision_detection
+{
+/** \brief Hands out the state indices of a batched collision check to the threads working on it.
+
+    It also tracks the first state found in collision, so that when a batch stops at its first collision, states
+    after that one are no longer handed out while states before it are still checked. */
+class CollisionBatchScheduler
+{
+public:
+  CollisionBatchScheduler(std::size_t count, bool stop_at_first_collision);
+
+  /** \brief Get the next state index to check. Returns false when no states are left to check. Thread-safe. */
+  bool next(std::size_t& index);
+
+  /** \brief Report that the state at \e index is in collision. Thread-safe. */
+  void reportCollision(std::size_t index);
+
+  /** \brief The lowest index reported in collision, or the batch size if none was */
+  std::size_t getFirstCollision() const
+  {
+    return first_collision_;
+  }
+
+  /** \brief Call \e worker on \e thread_count threads, counting the calling thread, and wait for all of them */
+  static void run(std::size_t thread_count, const std::function<void()>& worker);
+
+private:
+  const std::size_t count_;
+  const bool stop_at_first_collision_;
+  std::atomic<std::size_t> next_;
+  std::atomic<std::size_t> first_collision_;
+};
+
+/** \brief A fixed set of threads for splitting a single collision query into many small tasks.
+
+    Spawning threads for every query would cost more than the work in a query, so the threads of the pool live as long
+    as the pool. Tasks are claimed one at a time from a shared counter, by the pool threads and by the calling thread,
+    so threads that finish early take over the remaining tasks. One caller can use the pool at a time. */
+class CollisionThreadPool
+{
+public:
+  /** \brief Create a pool working with \e thread_count threads, counting the thread calling tryRun() */
+  explicit CollisionThreadPool(std::size_t thread_count);
+  ~CollisionThreadPool();
+
+  CollisionThreadPool(const CollisionThreadPool&) = delete;
+  CollisionThreadPool& operator=(const CollisionThreadPool&) = delete;
+
+  /** \brief The number of threads working on tasks, counting the calling thread */
+  std::size_t getThreadCount() const
+  {
+    return threads_.size() + 1;
+  }
+
+  /** \brief Call \e task(i) for each i in [0, \e count) and return once all calls are done.
+      Returns false without calling \e task if the pool is in use by another caller. */
+  bool tryRun(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+  void workerLoop();
+
+  std::mutex run_mutex_;  // held by the caller of tryRun() while its tasks are processed
+  std::mutex mutex_;
+  std::condition_variable wake_condition_;
+  std::condition_variable done_condition_;
+  const std::function<void(std::size_t)>* task_ = nullptr;
+  std::size_t task_count_ = 0;
+  std::atomic<std::size_t> next_task_{ 0 };
+  std::uint64_t generation_ = 0;
+  std::size_t finished_threads_ = 0;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+};
+}  // namespace collision_detection
@@ -143,6 +143,18 @@ struct CostSource
 
 struct CollisionResult;
 
+namespace MeshLODs
+{
+/** \brief The level of detail at which meshes are checked for collisions. The coarser levels contain the mesh. */
+enum MeshLOD
+{
+  EXACT,        ///< The mesh itself
+  CONVEX_HULL,  ///< The convex hull of the mesh
+  BOUNDING_BOX  ///< The bounding box of the mesh, aligned with the frame of the mesh
+};
+}  // namespace MeshLODs
+using MeshLOD = MeshLODs::MeshLOD;
+
 /** \brief Representation of a collision checking request */
 struct CollisionRequest
 {
@@ -178,6 +190,23 @@ struct CollisionRequest
   /** \brief When costs are computed, this value defines how many of the top cost sources should be returned */
   std::size_t max_cost_sources = 1;
 
+  /** \brief Size of the smallest octree cells to check. Checking coarser cells is faster; the cells then count as
+   * occupied as a whole, so the check is conservative. If 0, the leaves of the octree are checked. */
+  double octree_resolution = 0.0;
+
+  /** \brief The level of detail at which meshes are checked. Coarser levels are faster and contain the mesh, so the
+   * check is conservative: e.g. use them while sampling, and the exact meshes to validate the final result. */
+  MeshLOD mesh_lod = MeshLODs::EXACT;
+
+  /** \brief If true, record how often each pair of bodies is checked and how long that takes in
+   * CollisionResult::pair_statistics. This costs a map lookup per broadphase candidate and is meant for tuning. */
+  bool profile = false;
+
+  /** \brief If true, the answer may come from an approximate representation of the robot when the state is clearly
+   * free or clearly in collision, e.g. the collision spheres of CollisionEnvHybrid. Only boolean queries are
+   * approximated, requests for contacts, distances or costs are always answered exactly. */
+  bool approximate = false;
+
   /** \brief Function call that decides whether collision detection should stop. */
   std::function<bool(const CollisionResult&)> is_done = nullptr;
 
@@ -248,6 +277,18 @@ struct DistanceRequest
   /// Indicate if gradient should be calculated between each object.
   /// This is the normalized vector connecting the closest points on the two objects.
   bool compute_gradient = false;
+
+  /// Relative error allowed in the distance between two objects. A positive value lets the distance computation
+  /// between meshes stop early, once it is known to be within this fraction of the exact distance.
+  double relative_error = 0.0;
+
+  /// Absolute error allowed in the distance between two objects, see relative_error.
+  double absolute_error = 0.0;
+
+  /// Pairs of object names whose distance is computed before all others, e.g. the closest pair of a previous query
+  /// on a nearby state. For GLOBAL requests the search then skips the objects farther away than these pairs.
+  /// Backends that do not support warm starts ignore them. See DistanceQuery.
+  std::vector<std::pair<std::string, std::string> > warm_start_pairs;
 };
 
 /** \brief Generic representation of the distance information for a pair of objects */
@@ -330,6 +371,31 @@ struct DistanceResult
   }
 };
 
+/** \brief The cost of checking one pair of bodies, see CollisionRequest::profile */
+struct CollisionPairStatistics
+{
+  /// Number of times the broadphase reported the pair as candidates
+  std::size_t broadphase_candidates = 0;
+
+  /// Number of narrowphase checks of the pair, i.e. the candidates that were not skipped because of the ACM
+  std::size_t narrowphase_calls = 0;
+
+  /// Time spent in narrowphase checks of the pair, in seconds
+  double narrowphase_time = 0.0;
+
+  /// Add the statistics of \e other, e.g. to sum up several checks
+  CollisionPairStatistics& operator+=(const CollisionPairStatistics& other)
+  {
+    broadphase_candidates += other.broadphase_candidates;
+    narrowphase_calls += other.narrowphase_calls;
+    narrowphase_time += other.narrowphase_time;
+    return *this;
+  }
+};
+
+/** \brief Mapping between the names of a pair of bodies, ordered alphabetically, and the cost of checking the pair */
+using CollisionPairStatisticsMap = std::map<std::pair<std::string, std::string>, CollisionPairStatistics>;
+
 /** \brief Representation of a collision checking result */
 struct CollisionResult
 {
@@ -344,6 +410,7 @@ struct CollisionResult
     contact_count = 0;
     contacts.clear();
     cost_sources.clear();
+    pair_statistics.clear();
   }
 
   /** \brief Throttled warning printing the first collision pair, if any. All collisions are logged at DEBUG level */
@@ -367,5 +434,8 @@ struct CollisionResult
 
   /** \brief These are the individual cost sources when costs are computed */
   std::set<CostSource> cost_sources;
+
+  /** \brief The cost of checking each pair of bodies, if CollisionRequest::profile is set */
+  CollisionPairStatisticsMap pair_statistics;
 };
 }  // namespace collision_detection
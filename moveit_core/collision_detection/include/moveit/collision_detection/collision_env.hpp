@@ -42,6 +42,7 @@
 #include <moveit_msgs/msg/link_padding.hpp>
 #include <moveit_msgs/msg/link_scale.hpp>
 #include <moveit/collision_detection/world.hpp>
+#include <algorithm>
 
 namespace collision_detection
 {
@@ -110,6 +111,42 @@ public:
   virtual void checkCollision(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
                               const AllowedCollisionMatrix& acm) const;
 
+  /** \brief Check a batch of states for self and world collisions, as checkCollision() does for each of them.
+   *  Backends reuse their collision structures across the batch and check states on getBatchThreadCount() threads.
+   *  @param req A CollisionRequest object that encapsulates the collision request, used for every state
+   *  @param states The kinematic states for which checks are being made, all with up-to-date transforms
+   *  @param results Resized to the number of states; results[i] holds the result for states[i]
+   *  @param stop_at_first_collision If true, states after the first state found in collision may be left unchecked,
+   *         with cleared results
+   *  @return The index of the first state in collision, or states.size() if no state is in collision */
+  std::size_t checkCollisionBatch(const CollisionRequest& req,
+                                  const std::vector<const moveit::core::RobotState*>& states,
+                                  std::vector<CollisionResult>& results, bool stop_at_first_collision = false) const
+  {
+    return checkCollisionBatchHelper(req, states, results, nullptr, stop_at_first_collision);
+  }
+
+  /** \brief Check a batch of states for collisions as above, taking the allowed collision matrix \e acm into account */
+  std::size_t checkCollisionBatch(const CollisionRequest& req,
+                                  const std::vector<const moveit::core::RobotState*>& states,
+                                  std::vector<CollisionResult>& results, const AllowedCollisionMatrix& acm,
+                                  bool stop_at_first_collision = false) const
+  {
+    return checkCollisionBatchHelper(req, states, results, &acm, stop_at_first_collision);
+  }
+
+  /** \brief Set the number of threads checkCollisionBatch() distributes the states of a batch over (default 1) */
+  void setBatchThreadCount(std::size_t thread_count)
+  {
+    batch_thread_count_ = std::max<std::size_t>(thread_count, 1);
+  }
+
+  /** \brief Get the number of threads checkCollisionBatch() distributes the states of a batch over */
+  std::size_t getBatchThreadCount() const
+  {
+    return batch_thread_count_;
+  }
+
   /** \brief Check whether the robot model is in collision with the world. Any collisions between a robot link
    *  and the world are considered. Self collisions are not checked.
    *  @param req A CollisionRequest object that encapsulates the collision request
@@ -311,6 +348,13 @@ protected:
       @param links the names of the links whose padding or scaling were updated */
   virtual void updatedPaddingOrScaling(const std::vector<std::string>& links);
 
+  /** @brief Bundles the checkCollisionBatch() functions. The default implementation calls checkCollision() for each
+      state; backends override it to share their collision structures between the states of a batch. */
+  virtual std::size_t checkCollisionBatchHelper(const CollisionRequest& req,
+                                                const std::vector<const moveit::core::RobotState*>& states,
+                                                std::vector<CollisionResult>& results,
+                                                const AllowedCollisionMatrix* acm, bool stop_at_first_collision) const;
+
   /** @brief The kinematic model corresponding to this collision model*/
   moveit::core::RobotModelConstPtr robot_model_;
 
@@ -320,6 +364,9 @@ protected:
   /** @brief The internally maintained map (from link names to scaling)*/
   std::map<std::string, double> link_scale_;
 
+  /** @brief The number of threads a batch of states is checked on */
+  std::size_t batch_thread_count_ = 1;
+
 private:
   WorldPtr world_;             // The world always valid, never nullptr.
   WorldConstPtr world_const_;  // always same as world_
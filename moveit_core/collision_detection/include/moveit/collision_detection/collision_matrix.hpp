@@ -38,7 +38,10 @@
 
 #include <moveit/collision_detection/collision_common.hpp>
 #include <moveit/macros/class_forward.hpp>
+#include <moveit/robot_model/name_index_table.hpp>
 #include <moveit_msgs/msg/allowed_collision_matrix.hpp>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -71,6 +74,7 @@ enum Type
 using DecideContactFn = std::function<bool(collision_detection::Contact&)>;
 
 MOVEIT_CLASS_FORWARD(AllowedCollisionMatrix);  // Defines AllowedCollisionMatrixPtr, ConstPtr, WeakPtr... etc
+MOVEIT_CLASS_FORWARD(CompiledAllowedCollisionMatrix);  // Defines CompiledAllowedCollisionMatrixPtr, ConstPtr...
 
 /** @class AllowedCollisionMatrix
  *  @brief Definition of a structure for the allowed collision matrix. All elements in the collision world are referred
@@ -246,7 +250,14 @@ public:
   /** @brief Print the allowed collision matrix */
   void print(std::ostream& out) const;
 
+  /** @brief Get the index-based view of the allowed collision matrix.
+   *  The view is built on the first call after the matrix changed and shared by later calls, so it can be requested
+   *  once per collision query. */
+  CompiledAllowedCollisionMatrixConstPtr getCompiled() const;
+
 private:
+  friend class CompiledAllowedCollisionMatrix;
+
   bool getDefaultEntry(const std::string& name1, const std::string& name2,
                        AllowedCollision::Type& allowed_collision) const;
 
@@ -255,5 +266,95 @@ private:
 
   std::map<std::string, AllowedCollision::Type> default_entries_;
   std::map<std::string, DecideContactFn> default_allowed_contacts_;
+
+  /** @brief The view returned by getCompiled(), reset whenever the matrix changes */
+  mutable CompiledAllowedCollisionMatrixConstPtr compiled_;
+};
+
+/** @class CompiledAllowedCollisionMatrix
+ *  @brief A dense, index-based view of an AllowedCollisionMatrix, see AllowedCollisionMatrix::getCompiled().
+ *   Each name known to the matrix gets an index and the allowed collision type of every pair of indices is stored in
+ *   two bits, so collision callbacks can look up a pair without comparing strings. The view does not change: the
+ *   matrix builds a new one after it was modified. */
+class CompiledAllowedCollisionMatrix
+{
+public:
+  /** @brief Build the view of \e acm */
+  explicit CompiledAllowedCollisionMatrix(const AllowedCollisionMatrix& acm);
+
+  /** @brief Get a number identifying this view. No two views built in a process share it. */
+  std::uint32_t getSerial() const
+  {
+    return serial_;
+  }
+
+  /** @brief Get the names known to the matrix, in the order of their indices */
+  const std::vector<std::string>& getNames() const
+  {
+    return names_;
+  }
+
+  /** @brief Get the index of \e name, or -1 if the matrix has neither entries nor a default entry for it */
+  int getIndex(const std::string& name) const
+  {
+    return index_table_.find(name);
+  }
+
+  /** @brief Get the index of \e name, memoized in \e cache.
+   *  Collision objects keep such a cache, set to 0 initially, so looking them up again in the same view only costs
+   *  reading it. The cache may be shared between threads. */
+  int getIndex(const std::string& name, std::atomic<std::uint64_t>& cache) const
+  {
+    const std::uint64_t cached = cache.load(std::memory_order_relaxed);
+    if (static_cast<std::uint32_t>(cached >> 32) == serial_)
+      return static_cast<std::int32_t>(static_cast<std::uint32_t>(cached));
+    const int index = getIndex(name);
+    cache.store((static_cast<std::uint64_t>(serial_) << 32) | static_cast<std::uint32_t>(index),
+                std::memory_order_relaxed);
+    return index;
+  }
+
+  /** @brief Get the type of the allowed collision between the elements with indices \e index1 and \e index2.
+   *  The result is the one AllowedCollisionMatrix::getAllowedCollision() gives for their names; an index of -1 stands
+   *  for a name unknown to the matrix.
+   *  @param allowed_collision The allowed collision type will be filled here
+   *  @return false if the matrix has no entry or default entry for the pair */
+  bool getAllowedCollision(int index1, int index2, AllowedCollision::Type& allowed_collision) const
+  {
+    std::uint8_t code;
+    if (index1 >= 0 && index2 >= 0)
+    {
+      const std::size_t bit = 2 * (static_cast<std::size_t>(index1) * names_.size() + static_cast<std::size_t>(index2));
+      code = static_cast<std::uint8_t>((bits_[bit / 64] >> (bit % 64)) & 3u);
+    }
+    else if (index1 >= 0)
+    {
+      code = default_codes_[index1];
+    }
+    else if (index2 >= 0)
+    {
+      code = default_codes_[index2];
+    }
+    else
+    {
+      return false;
+    }
+    if (code == 0)
+      return false;
+    allowed_collision = static_cast<AllowedCollision::Type>(code - 1);
+    return true;
+  }
+
+private:
+  std::uint32_t serial_;
+  std::vector<std::string> names_;
+  moveit::core::NameIndexTable index_table_;
+
+  /** @brief For every pair of indices (i, j), at bit 2 * (i * size + j): 0 if there is no entry, the type plus 1
+   *  otherwise */
+  std::vector<std::uint64_t> bits_;
+
+  /** @brief For every index, 0 if there is no default entry, the default type plus 1 otherwise */
+  std::vector<std::uint8_t> default_codes_;
 };
 }  // namespace collision_detection
@@ -0,0 +1,80 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/collision_detection/collision_env.hpp>
+
+namespace collision_detection
+{
+/** \brief Repeated distance queries for states that change little from one query to the next.
+
+    Each query passes the closest pair found by the previous one as warm start pair (see
+    DistanceRequest::warm_start_pairs), so a GLOBAL query starts out bounded by the new distance of that pair instead
+    of searching all pairs from scratch. Setting DistanceRequest::distance_threshold in addition bounds the search to
+    the distances that matter to the caller. */
+class DistanceQuery
+{
+public:
+  explicit DistanceQuery(const DistanceRequest& req = DistanceRequest());
+
+  /** \brief Get the request used for the queries. Changes apply to the next query. */
+  DistanceRequest& getRequest()
+  {
+    return req_;
+  }
+
+  /** \brief Compute the distances between the links of the robot in \e state */
+  const DistanceResult& distanceSelf(const CollisionEnv& env, const moveit::core::RobotState& state);
+
+  /** \brief Compute the distances between the robot in \e state and the world of \e env */
+  const DistanceResult& distanceRobot(const CollisionEnv& env, const moveit::core::RobotState& state);
+
+  /** \brief Get the result of the last query */
+  const DistanceResult& getResult() const
+  {
+    return res_;
+  }
+
+  /** \brief Forget the result of the last query, so the next one is not warm started */
+  void reset();
+
+private:
+  /** \brief Use the closest pair of res_ as warm start pair of the next query */
+  void updateWarmStart();
+
+  DistanceRequest req_;
+  DistanceResult res_;
+};
+}  // namespace collision_detection
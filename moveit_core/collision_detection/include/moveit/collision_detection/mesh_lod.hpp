@@ -0,0 +1,58 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/collision_detection/collision_common.hpp>
+#include <geometric_shapes/shapes.h>
+
+#include <memory>
+#include <string>
+
+namespace collision_detection
+{
+/** \brief Create the level of detail \e lod of \e mesh, for collision checking.
+
+    The result contains \e mesh: its convex hull, or its bounding box aligned with the frame of the mesh. Results are
+    cached in memory by the content of the mesh, and on disk if a cache directory is set, so they are computed once per
+    mesh. Returns nullptr for MeshLODs::EXACT, or if the level could not be computed. */
+std::shared_ptr<const shapes::Mesh> createMeshLOD(const shapes::Mesh& mesh, MeshLOD lod);
+
+/** \brief Set the directory where createMeshLOD() keeps its results across processes. An empty directory disables the
+ * cache on disk. Defaults to the value of the MOVEIT_MESH_LOD_CACHE environment variable, if set. */
+void setMeshLODCacheDirectory(const std::string& directory);
+
+/** \brief Get the directory where createMeshLOD() keeps its results */
+std::string getMeshLODCacheDirectory();
+}  // namespace collision_detection
@@ -38,19 +38,40 @@
 
 #include <octomap/octomap.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <shared_mutex>
 #include <mutex>
 #include <functional>
+#include <unordered_map>
 
 namespace collision_detection
 {
 typedef octomap::OcTreeNode OccMapNode;
 
+/** @brief The cells of an OccMapTree that changed since the previous update callback */
+struct OccMapTreeChanges
+{
+  /** @brief Keys of the cells whose occupancy changed, including the cells cleared by decay */
+  octomap::KeySet keys;
+
+  /** @brief Corners of the bounding box of the changed cells, only valid if keys is not empty */
+  octomap::point3d min;
+  octomap::point3d max;
+
+  /** @brief The whole tree may have changed, e.g. because it was read from a file; keys are incomplete then */
+  bool full = false;
+};
+
 class OccMapTree : public octomap::OcTree
 {
 public:
+  using ChangeCallback = std::function<void(const OccMapTreeChanges&)>;
+
   OccMapTree(double resolution) : octomap::OcTree(resolution)
   {
   }
@@ -100,21 +121,158 @@ public:
 
   void triggerUpdateCallback()
   {
+    ++update_count_;
+    if (change_callback_ && isChangeDetectionEnabled())
+      change_callback_(takeChanges());
     if (update_callback_)
       update_callback_();
   }
 
+  /** @brief Get the number of updates announced through triggerUpdateCallback(). Collision checkers compare it to
+   *  tell whether data they derived from the tree is outdated. */
+  std::uint64_t getUpdateCount() const
+  {
+    return update_count_;
+  }
+
   /** @brief Set the callback to trigger when updates are received */
   void setUpdateCallback(const std::function<void()>& update_callback)
   {
     update_callback_ = update_callback;
   }
 
+  /** @brief Set the callback that receives the changed cells on triggerUpdateCallback(), before the update callback.
+   *  It is only called while change tracking is enabled. */
+  void setChangeCallback(const ChangeCallback& change_callback)
+  {
+    change_callback_ = change_callback;
+  }
+
+  /** @brief Track the keys of the cells whose occupancy changes, such that consumers can update incrementally instead
+   *  of processing the whole tree with each update. Lock the tree for writing before calling this. */
+  void enableChangeTracking(bool enable)
+  {
+    enableChangeDetection(enable);
+    resetChangeDetection();
+    decayed_keys_.clear();
+    full_change_ = false;
+  }
+
+  /** @brief Report the whole tree as changed with the next update, e.g. after reading it. Lock the tree for writing
+   *  before calling this. */
+  void markAllChanged()
+  {
+    full_change_ = true;
+  }
+
+  /** @brief Remember when occupied cells are hit, such that clearStaleCells() can clear cells that are not observed
+   *  anymore. Lock the tree for writing before calling this. */
+  void enableDecay(bool enable)
+  {
+    decay_ = enable;
+    if (!decay_)
+      hit_times_.clear();
+  }
+
+  /** @brief Clear the occupied cells that were not hit for \e max_age without ray casting, i.e. make them unknown.
+   *  Only cells hit while decay was enabled are cleared. Lock the tree for writing before calling this.
+   *  @return The number of cleared cells */
+  std::size_t clearStaleCells(std::chrono::steady_clock::duration max_age)
+  {
+    const std::chrono::steady_clock::time_point oldest = std::chrono::steady_clock::now() - max_age;
+    std::size_t cleared = 0;
+    for (auto it = hit_times_.begin(); it != hit_times_.end();)
+    {
+      if (it->second >= oldest)
+      {
+        ++it;
+        continue;
+      }
+      OccMapNode* node = search(it->first);
+      if (node && isNodeOccupied(node))
+      {
+        deleteNode(it->first);
+        if (isChangeDetectionEnabled())
+          decayed_keys_.insert(it->first);
+        ++cleared;
+      }
+      it = hit_times_.erase(it);
+    }
+    return cleared;
+  }
+
+  using octomap::OcTree::updateNode;
+
+  /** @brief Update the log-odds of a cell, remembering the time of occupied hits if decay is enabled */
+  OccMapNode* updateNode(const octomap::OcTreeKey& key, float log_odds_update, bool lazy_eval = false) override
+  {
+    if (decay_ && log_odds_update > 0.0f)
+      hit_times_[key] = std::chrono::steady_clock::now();
+    return octomap::OcTree::updateNode(key, log_odds_update, lazy_eval);
+  }
+
+  /** @brief Integrate a hit or a miss of a cell, remembering the time of hits if decay is enabled */
+  OccMapNode* updateNode(const octomap::OcTreeKey& key, bool occupied, bool lazy_eval = false) override
+  {
+    return updateNode(key, occupied ? getProbHitLog() : getProbMissLog(), lazy_eval);
+  }
+
 private:
+  /** @brief Collect and reset the changes since the previous call */
+  OccMapTreeChanges takeChanges()
+  {
+    OccMapTreeChanges changes;
+    {
+      // resetting the change detection modifies the tree
+      WriteLock lock = writing();
+      changes.full = full_change_;
+      for (octomap::KeyBoolMap::const_iterator it = changedKeysBegin(); it != changedKeysEnd(); ++it)
+        changes.keys.insert(it->first);
+      changes.keys.insert(decayed_keys_.begin(), decayed_keys_.end());
+      resetChangeDetection();
+      decayed_keys_.clear();
+      full_change_ = false;
+    }
+
+    const double half_size = 0.5 * getResolution();
+    const octomap::point3d half_extents(half_size, half_size, half_size);
+    for (octomap::KeySet::const_iterator it = changes.keys.begin(); it != changes.keys.end(); ++it)
+    {
+      const octomap::point3d center = keyToCoord(*it);
+      if (it == changes.keys.begin())
+      {
+        changes.min = center - half_extents;
+        changes.max = center + half_extents;
+        continue;
+      }
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        changes.min(i) = std::min(changes.min(i), center(i) - half_size);
+        changes.max(i) = std::max(changes.max(i), center(i) + half_size);
+      }
+    }
+    return changes;
+  }
+
   std::shared_mutex tree_mutex_;
   std::function<void()> update_callback_;
+  ChangeCallback change_callback_;
+  std::atomic<std::uint64_t> update_count_{ 0 };
+
+  octomap::KeySet decayed_keys_;
+  bool full_change_ = false;
+  bool decay_ = false;
+  std::unordered_map<octomap::OcTreeKey, std::chrono::steady_clock::time_point, octomap::OcTreeKey::KeyHash>
+      hit_times_;
 };
 
 using OccMapTreePtr = std::shared_ptr<OccMapTree>;
 using OccMapTreeConstPtr = std::shared_ptr<const OccMapTree>;
+
+/** @brief Create a compact copy of the occupied cells of \e tree for planning, e.g. to snapshot a monitored map.
+ *  The copy uses the coarsest cells of \e tree that are no larger than \e resolution, or the leaves of \e tree if
+ *  \e resolution is 0. A cell is occupied if any occupied leaf of \e tree lies within it, which is conservative for
+ *  collision checking. Free and unknown space is dropped and occupied cells get the maximum occupancy, such that the
+ *  copy is pruned as much as possible. Lock \e tree for reading before calling this. */
+std::shared_ptr<octomap::OcTree> createPlanningOcTree(const octomap::OcTree& tree, double resolution = 0.0);
 }  // namespace collision_detection
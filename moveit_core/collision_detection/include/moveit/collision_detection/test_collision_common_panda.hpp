@@ -51,6 +51,7 @@
 #include <algorithm>
 #include <ctype.h>
 #include <fstream>
+#include <thread>
 
 /** \brief Brings the panda robot in user defined home position */
 inline void setToHome(moveit::core::RobotState& panda_state)
@@ -266,6 +267,105 @@ TYPED_TEST_P(CollisionDetectorPandaTest, DistanceWorld)
   EXPECT_NEAR(res.distance, 0.029, 0.01);
 }
 
+/** \brief Batched checks must report the same collisions as checking each state on its own. */
+TYPED_TEST_P(CollisionDetectorPandaTest, CollisionBatch)
+{
+  shapes::ShapeConstPtr shape_ptr = std::make_shared<shapes::Box>(0.4, 0.4, 0.4);
+  Eigen::Isometry3d pos{ Eigen::Isometry3d::Identity() };
+  pos.translation().x() = 0.5;
+  pos.translation().z() = 0.4;
+  this->cenv_->getWorld()->addToObject("box", pos, shape_ptr, Eigen::Isometry3d::Identity());
+
+  random_numbers::RandomNumberGenerator rng(7);
+  const moveit::core::JointModelGroup* group = this->robot_model_->getJointModelGroup("panda_arm");
+  std::vector<moveit::core::RobotState> states(40, *this->robot_state_);
+  std::vector<const moveit::core::RobotState*> state_ptrs;
+  std::vector<bool> expected;
+  collision_detection::CollisionRequest req;
+  for (moveit::core::RobotState& state : states)
+  {
+    state.setToRandomPositions(group, rng);
+    state.update();
+    state_ptrs.push_back(&state);
+
+    collision_detection::CollisionResult res;
+    this->cenv_->checkCollision(req, res, state, *this->acm_);
+    expected.push_back(res.collision);
+  }
+  const std::size_t first_expected = std::find(expected.begin(), expected.end(), true) - expected.begin();
+  // the batch must exercise both outcomes
+  ASSERT_LT(first_expected, states.size());
+  ASSERT_NE(std::find(expected.begin(), expected.end(), false), expected.end());
+
+  for (std::size_t thread_count : { 1, 3 })
+  {
+    this->cenv_->setBatchThreadCount(thread_count);
+    std::vector<collision_detection::CollisionResult> results;
+    EXPECT_EQ(this->cenv_->checkCollisionBatch(req, state_ptrs, results, *this->acm_), first_expected);
+    ASSERT_EQ(results.size(), states.size());
+    for (std::size_t i = 0; i < states.size(); ++i)
+      EXPECT_EQ(results[i].collision, expected[i]) << "state " << i << ", " << thread_count << " threads";
+
+    EXPECT_EQ(this->cenv_->checkCollisionBatch(req, state_ptrs, results, *this->acm_, true), first_expected);
+    for (std::size_t i = 0; i <= first_expected; ++i)
+      EXPECT_EQ(results[i].collision, expected[i]) << "state " << i << ", " << thread_count << " threads";
+  }
+}
+
+/** \brief Checks running concurrently from several threads must agree with serial checks, also after the world
+ * changed between them. */
+TYPED_TEST_P(CollisionDetectorPandaTest, ConcurrentChecks)
+{
+  shapes::ShapeConstPtr shape_ptr = std::make_shared<shapes::Box>(0.4, 0.4, 0.4);
+  Eigen::Isometry3d pos{ Eigen::Isometry3d::Identity() };
+  pos.translation().x() = 0.5;
+  pos.translation().z() = 0.4;
+  this->cenv_->getWorld()->addToObject("box", pos, shape_ptr, Eigen::Isometry3d::Identity());
+
+  random_numbers::RandomNumberGenerator rng(11);
+  const moveit::core::JointModelGroup* group = this->robot_model_->getJointModelGroup("panda_arm");
+  std::vector<moveit::core::RobotState> states(20, *this->robot_state_);
+  for (moveit::core::RobotState& state : states)
+  {
+    state.setToRandomPositions(group, rng);
+    state.update();
+  }
+
+  collision_detection::CollisionRequest req;
+  for (double box_x : { 0.5, 3.0, 0.5 })
+  {
+    pos.translation().x() = box_x;
+    this->cenv_->getWorld()->moveObject("box", pos);
+
+    std::vector<bool> expected;
+    for (const moveit::core::RobotState& state : states)
+    {
+      collision_detection::CollisionResult res;
+      this->cenv_->checkCollision(req, res, state, *this->acm_);
+      expected.push_back(res.collision);
+    }
+
+    std::vector<std::vector<bool>> results(4);
+    std::vector<std::thread> threads;
+    for (std::vector<bool>& thread_results : results)
+    {
+      threads.emplace_back([&] {
+        for (const moveit::core::RobotState& state : states)
+        {
+          collision_detection::CollisionResult res;
+          this->cenv_->checkCollision(req, res, state, *this->acm_);
+          thread_results.push_back(res.collision);
+        }
+      });
+    }
+    for (std::thread& thread : threads)
+      thread.join();
+
+    for (const std::vector<bool>& thread_results : results)
+      EXPECT_EQ(thread_results, expected) << "box at x = " << box_x;
+  }
+}
+
 template <class CollisionAllocatorType>
 class DistanceCheckPandaTest : public CollisionDetectorPandaTest<CollisionAllocatorType>
 {
@@ -376,7 +476,8 @@ TYPED_TEST_P(DistanceFullPandaTest, DistancePoints)
 }
 
 REGISTER_TYPED_TEST_SUITE_P(CollisionDetectorPandaTest, InitOK, DefaultNotInCollision, LinksInCollision,
-                            RobotWorldCollision_1, RobotWorldCollision_2, PaddingTest, DistanceSelf, DistanceWorld);
+                            RobotWorldCollision_1, RobotWorldCollision_2, PaddingTest, DistanceSelf, DistanceWorld,
+                            CollisionBatch, ConcurrentChecks);
 
 REGISTER_TYPED_TEST_SUITE_P(DistanceCheckPandaTest, DistanceSingle);
 
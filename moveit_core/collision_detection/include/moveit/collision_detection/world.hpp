@@ -37,9 +37,12 @@
 #pragma once
 
 #include <moveit/macros/class_forward.hpp>
+#include <moveit/collision_detection/aabb_tree.hpp>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <functional>
 #include <Eigen/Geometry>
 #include <eigen_stl_containers/eigen_stl_vector_container.h>
@@ -127,27 +130,52 @@ public:
   /** iterator pointing to first change */
   const_iterator begin() const
   {
-    return objects_.begin();
+    return objects_->begin();
   }
   /** iterator pointing to end of changes */
   const_iterator end() const
   {
-    return objects_.end();
+    return objects_->end();
   }
   /** number of changes stored */
   std::size_t size() const
   {
-    return objects_.size();
+    return objects_->size();
   }
   /** find changes for a named object */
   const_iterator find(const std::string& object_id) const
   {
-    return objects_.find(object_id);
+    return objects_->find(object_id);
+  }
+
+  /** \brief Get a number that changes whenever the objects of the world change.
+   * Copies of a world have the same version until either of them changes. */
+  std::uint64_t getVersion() const
+  {
+    return version_;
   }
 
   /** \brief Check if a particular object exists in the collision world*/
   bool hasObject(const std::string& object_id) const;
 
+  /** \brief Maintain an AABB tree over the objects of the world, so that getObjectsInBox() does not need to visit
+   * every object. This is disabled by default, enabling it builds the tree over the current objects. */
+  void setSpatialIndexEnabled(bool enabled);
+
+  /** \brief Check if the world maintains an AABB tree over its objects */
+  bool isSpatialIndexEnabled() const
+  {
+    return static_cast<bool>(spatial_index_);
+  }
+
+  /** \brief Get the ids of the objects whose axis-aligned bounding boxes in the world frame intersect \e box.
+   * Objects with shapes of unbounded extent (planes, octrees) are always included. */
+  std::vector<std::string> getObjectsInBox(const Eigen::AlignedBox3d& box) const;
+
+  /** \brief Get the axis-aligned bounding box of an object in the world frame.
+   * The box is empty for unknown objects and objects without shapes. */
+  Eigen::AlignedBox3d getObjectAABB(const std::string& object_id) const;
+
   /** \brief Check if an object or subframe with given name exists in the collision world.
    * A subframe name needs to be prefixed with the object's name separated by a slash. */
   bool knowsTransform(const std::string& name) const;
@@ -328,6 +356,11 @@ private:
    * clone is made so that it can be safely modified later on. */
   void ensureUnique(ObjectPtr& obj);
 
+  /** \brief Make sure that the map of objects is known only to this instance of the World, copying it if it is
+   * shared with copies of this World. Call this before any change, so that ensureUnique() sees shared objects
+   * and the version changes. */
+  std::map<std::string, ObjectPtr>& ensureUniqueObjects();
+
   /* Add a shape with no checking */
   virtual void addToObjectInternal(const ObjectPtr& obj, const shapes::ShapeConstPtr& shape,
                                    const Eigen::Isometry3d& shape_pose);
@@ -335,8 +368,14 @@ private:
   /** \brief Updates the global shape and subframe poses. */
   void updateGlobalPosesInternal(ObjectPtr& obj, bool update_shape_poses = true, bool update_subframe_poses = true);
 
-  /** The objects maintained in the world */
-  std::map<std::string, ObjectPtr> objects_;
+  /** The objects maintained in the world. Copies of the world share the map until either of them changes. */
+  std::shared_ptr<std::map<std::string, ObjectPtr>> objects_;
+
+  /** The version of objects_, a new number is drawn from a counter shared by all worlds for each change */
+  std::uint64_t version_;
+
+  /** AABB tree over the objects, nullptr unless enabled. Copies of the world share it until either of them changes. */
+  std::shared_ptr<AABBTree> spatial_index_;
 
   /** Wrapper for a callback function to call when something changes in the world */
   class Observer
@@ -0,0 +1,215 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/aabb_tree.hpp>
+
+#include <cmath>
+
+namespace collision_detection
+{
+namespace
+{
+// half the surface area of a box, the cost of a node in the tree
+double getArea(const AABBTree::Box& box)
+{
+  const Eigen::Vector3d size = box.sizes();
+  return size.x() * size.y() + size.y() * size.z() + size.z() * size.x();
+}
+
+bool isFinite(const AABBTree::Box& box)
+{
+  return box.min().allFinite() && box.max().allFinite();
+}
+}  // namespace
+
+void AABBTree::update(const std::string& id, const Box& box)
+{
+  remove(id);
+  if (box.isEmpty())
+    return;
+  if (!isFinite(box))
+  {
+    unbounded_.insert(id);
+    return;
+  }
+
+  const int leaf = allocateNode();
+  nodes_[leaf].box = box;
+  nodes_[leaf].id = id;
+  leaves_[id] = leaf;
+  insertLeaf(leaf);
+}
+
+bool AABBTree::remove(const std::string& id)
+{
+  if (unbounded_.erase(id))
+    return true;
+  const auto it = leaves_.find(id);
+  if (it == leaves_.end())
+    return false;
+  removeLeaf(it->second);
+  freeNode(it->second);
+  leaves_.erase(it);
+  return true;
+}
+
+void AABBTree::clear()
+{
+  nodes_.clear();
+  free_nodes_.clear();
+  root_ = -1;
+  leaves_.clear();
+  unbounded_.clear();
+}
+
+void AABBTree::query(const Box& box, std::vector<std::string>& ids) const
+{
+  if (box.isEmpty())
+    return;
+  ids.insert(ids.end(), unbounded_.begin(), unbounded_.end());
+  if (root_ < 0)
+    return;
+
+  std::vector<int> stack{ root_ };
+  while (!stack.empty())
+  {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    if (!node.box.intersects(box))
+      continue;
+    if (node.left < 0)
+    {
+      ids.push_back(node.id);
+    }
+    else
+    {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+}
+
+int AABBTree::allocateNode()
+{
+  if (free_nodes_.empty())
+  {
+    nodes_.emplace_back();
+    return static_cast<int>(nodes_.size()) - 1;
+  }
+  const int index = free_nodes_.back();
+  free_nodes_.pop_back();
+  nodes_[index] = Node();
+  return index;
+}
+
+void AABBTree::freeNode(int index)
+{
+  nodes_[index].id.clear();
+  free_nodes_.push_back(index);
+}
+
+void AABBTree::insertLeaf(int leaf)
+{
+  if (root_ < 0)
+  {
+    root_ = leaf;
+    nodes_[leaf].parent = -1;
+    return;
+  }
+
+  // descend to the sibling whose box grows least by adding the leaf
+  const Box& box = nodes_[leaf].box;
+  int sibling = root_;
+  while (nodes_[sibling].left >= 0)
+  {
+    const Node& node = nodes_[sibling];
+    const double left_cost = getArea(nodes_[node.left].box.merged(box)) - getArea(nodes_[node.left].box);
+    const double right_cost = getArea(nodes_[node.right].box.merged(box)) - getArea(nodes_[node.right].box);
+    sibling = left_cost <= right_cost ? node.left : node.right;
+  }
+
+  // replace the sibling by a new node holding the sibling and the leaf
+  const int parent = allocateNode();
+  const int old_parent = nodes_[sibling].parent;
+  nodes_[parent].parent = old_parent;
+  nodes_[parent].left = sibling;
+  nodes_[parent].right = leaf;
+  nodes_[sibling].parent = parent;
+  nodes_[leaf].parent = parent;
+  if (old_parent < 0)
+    root_ = parent;
+  else if (nodes_[old_parent].left == sibling)
+    nodes_[old_parent].left = parent;
+  else
+    nodes_[old_parent].right = parent;
+  refit(parent);
+}
+
+void AABBTree::removeLeaf(int leaf)
+{
+  if (leaf == root_)
+  {
+    root_ = -1;
+    return;
+  }
+
+  // the sibling of the leaf takes the place of their parent
+  const int parent = nodes_[leaf].parent;
+  const int grandparent = nodes_[parent].parent;
+  const int sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+  nodes_[sibling].parent = grandparent;
+  if (grandparent < 0)
+  {
+    root_ = sibling;
+  }
+  else
+  {
+    if (nodes_[grandparent].left == parent)
+      nodes_[grandparent].left = sibling;
+    else
+      nodes_[grandparent].right = sibling;
+    refit(grandparent);
+  }
+  freeNode(parent);
+}
+
+void AABBTree::refit(int index)
+{
+  for (; index >= 0; index = nodes_[index].parent)
+  {
+    Node& node = nodes_[index];
+    node.box = nodes_[node.left].box.merged(nodes_[node.right].box);
+  }
+}
+}  // namespace collision_detection
@@ -0,0 +1,143 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/collision_batch.hpp>
+
+namespace collision_detection
+{
+CollisionBatchScheduler::CollisionBatchScheduler(std::size_t count, bool stop_at_first_collision)
+  : count_(count), stop_at_first_collision_(stop_at_first_collision), next_(0), first_collision_(count)
+{
+}
+
+bool CollisionBatchScheduler::next(std::size_t& index)
+{
+  index = next_.fetch_add(1, std::memory_order_relaxed);
+  if (index >= count_)
+    return false;
+  return !stop_at_first_collision_ || index < first_collision_.load(std::memory_order_relaxed);
+}
+
+void CollisionBatchScheduler::reportCollision(std::size_t index)
+{
+  std::size_t first = first_collision_.load(std::memory_order_relaxed);
+  while (index < first && !first_collision_.compare_exchange_weak(first, index, std::memory_order_relaxed))
+  {
+  }
+}
+
+void CollisionBatchScheduler::run(std::size_t thread_count, const std::function<void()>& worker)
+{
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count > 1 ? thread_count - 1 : 0);
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+}
+
+CollisionThreadPool::CollisionThreadPool(std::size_t thread_count)
+{
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads_.emplace_back([this] { workerLoop(); });
+}
+
+CollisionThreadPool::~CollisionThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_condition_.notify_all();
+  for (std::thread& thread : threads_)
+    thread.join();
+}
+
+bool CollisionThreadPool::tryRun(std::size_t count, const std::function<void(std::size_t)>& task)
+{
+  std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+  if (!run_lock.owns_lock())
+    return false;
+
+  if (threads_.empty() || count <= 1)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      task(i);
+    return true;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    task_count_ = count;
+    next_task_ = 0;
+    finished_threads_ = 0;
+    ++generation_;
+  }
+  wake_condition_.notify_all();
+
+  for (std::size_t i = next_task_++; i < count; i = next_task_++)
+    task(i);
+
+  // wait for every thread to be done with this run, so none of them still refers to task once this returns
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_condition_.wait(lock, [this] { return finished_threads_ == threads_.size(); });
+  task_ = nullptr;
+  return true;
+}
+
+void CollisionThreadPool::workerLoop()
+{
+  std::uint64_t generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    wake_condition_.wait(lock, [&] { return stop_ || generation_ != generation; });
+    if (stop_)
+      return;
+    generation = generation_;
+    const std::function<void(std::size_t)>& task = *task_;
+    const std::size_t count = task_count_;
+    lock.unlock();
+
+    for (std::size_t i = next_task_++; i < count; i = next_task_++)
+      task(i);
+
+    lock.lock();
+    if (++finished_threads_ == threads_.size())
+      done_condition_.notify_one();
+  }
+}
+}  // namespace collision_detection
@@ -35,6 +35,7 @@
 /* Author: Ioan Sucan, Jens Petit */
 
 #include <moveit/collision_detection/collision_env.hpp>
+#include <moveit/collision_detection/collision_batch.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <limits>
@@ -118,6 +119,7 @@ CollisionEnv::CollisionEnv(const CollisionEnv& other, const WorldPtr& world)
 {
   link_padding_ = other.link_padding_;
   link_scale_ = other.link_scale_;
+  batch_thread_count_ = other.batch_thread_count_;
 }
 void CollisionEnv::setPadding(const double padding)
 {
@@ -322,4 +324,34 @@ void CollisionEnv::checkCollision(const CollisionRequest& req, CollisionResult&
   if (!res.collision || (req.contacts && res.contacts.size() < req.max_contacts))
     checkRobotCollision(req, res, state, acm);
 }
+
+std::size_t CollisionEnv::checkCollisionBatchHelper(const CollisionRequest& req,
+                                                    const std::vector<const moveit::core::RobotState*>& states,
+                                                    std::vector<CollisionResult>& results,
+                                                    const AllowedCollisionMatrix* acm,
+                                                    bool stop_at_first_collision) const
+{
+  results.resize(states.size());
+  for (CollisionResult& res : results)
+    res.clear();
+
+  CollisionBatchScheduler scheduler(states.size(), stop_at_first_collision);
+  CollisionBatchScheduler::run(std::min(batch_thread_count_, states.size()), [&] {
+    std::size_t index;
+    while (scheduler.next(index))
+    {
+      if (acm)
+      {
+        checkCollision(req, results[index], *states[index], *acm);
+      }
+      else
+      {
+        checkCollision(req, results[index], *states[index]);
+      }
+      if (results[index].collision)
+        scheduler.reportCollision(index);
+    }
+  });
+  return scheduler.getFirstCollision();
+}
 }  // end of namespace collision_detection
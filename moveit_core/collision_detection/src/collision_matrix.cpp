@@ -39,6 +39,7 @@
 #include <rclcpp/logging.hpp>
 #include <functional>
 #include <iomanip>
+#include <set>
 #include <moveit/utils/logger.hpp>
 
 namespace collision_detection
@@ -49,6 +50,8 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.collision_detection_matrix");
 }
+
+std::atomic<std::uint32_t> next_compiled_serial{ 1 };
 }  // namespace
 
 AllowedCollisionMatrix::AllowedCollisionMatrix()
@@ -153,6 +156,7 @@ bool AllowedCollisionMatrix::hasEntry(const std::string& name1, const std::strin
 
 void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::string& name2, const bool allowed)
 {
+  compiled_.reset();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   entries_[name1][name2] = entries_[name2][name1] = v;
 
@@ -175,12 +179,14 @@ void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::strin
 
 void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::string& name2, DecideContactFn& fn)
 {
+  compiled_.reset();
   entries_[name1][name2] = entries_[name2][name1] = AllowedCollision::CONDITIONAL;
   allowed_contacts_[name1][name2] = allowed_contacts_[name2][name1] = fn;
 }
 
 void AllowedCollisionMatrix::removeEntry(const std::string& name)
 {
+  compiled_.reset();
   entries_.erase(name);
   allowed_contacts_.erase(name);
   for (auto& entry : entries_)
@@ -191,6 +197,7 @@ void AllowedCollisionMatrix::removeEntry(const std::string& name)
 
 void AllowedCollisionMatrix::removeEntry(const std::string& name1, const std::string& name2)
 {
+  compiled_.reset();
   auto jt = entries_.find(name1);
   if (jt != entries_.end())
   {
@@ -254,6 +261,7 @@ void AllowedCollisionMatrix::setEntry(const std::string& name, const bool allowe
 
 void AllowedCollisionMatrix::setEntry(const bool allowed)
 {
+  compiled_.reset();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   for (auto& entry : entries_)
   {
@@ -264,6 +272,7 @@ void AllowedCollisionMatrix::setEntry(const bool allowed)
 
 void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, const bool allowed)
 {
+  compiled_.reset();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   default_entries_[name] = v;
   default_allowed_contacts_.erase(name);
@@ -271,6 +280,7 @@ void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, const bool
 
 void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, DecideContactFn& fn)
 {
+  compiled_.reset();
   default_entries_[name] = AllowedCollision::CONDITIONAL;
   default_allowed_contacts_[name] = fn;
 }
@@ -371,6 +381,7 @@ bool AllowedCollisionMatrix::getAllowedCollision(const std::string& name1, const
 
 void AllowedCollisionMatrix::clear()
 {
+  compiled_.reset();
   entries_.clear();
   allowed_contacts_.clear();
   default_entries_.clear();
@@ -490,4 +501,46 @@ void AllowedCollisionMatrix::print(std::ostream& out) const
   }
 }
 
+CompiledAllowedCollisionMatrixConstPtr AllowedCollisionMatrix::getCompiled() const
+{
+  // concurrent collision queries may share a matrix, the first one to find no view builds it
+  CompiledAllowedCollisionMatrixConstPtr compiled = std::atomic_load(&compiled_);
+  if (!compiled)
+  {
+    compiled = std::make_shared<const CompiledAllowedCollisionMatrix>(*this);
+    std::atomic_store(&compiled_, compiled);
+  }
+  return compiled;
+}
+
+CompiledAllowedCollisionMatrix::CompiledAllowedCollisionMatrix(const AllowedCollisionMatrix& acm)
+  : serial_(next_compiled_serial++)
+{
+  std::set<std::string> names;
+  for (const auto& entry : acm.entries_)
+    names.insert(entry.first);
+  for (const auto& entry : acm.default_entries_)
+    names.insert(entry.first);
+  names_.assign(names.begin(), names.end());
+  index_table_ = moveit::core::NameIndexTable(names_);
+
+  const std::size_t size = names_.size();
+  bits_.assign((2 * size * size + 63) / 64, 0);
+  default_codes_.assign(size, 0);
+  AllowedCollision::Type type;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    if (acm.getDefaultEntry(names_[i], type))
+      default_codes_[i] = static_cast<std::uint8_t>(type + 1);
+    for (std::size_t j = 0; j < size; ++j)
+    {
+      if (acm.getAllowedCollision(names_[i], names_[j], type))
+      {
+        const std::size_t bit = 2 * (i * size + j);
+        bits_[bit / 64] |= static_cast<std::uint64_t>(type + 1) << (bit % 64);
+      }
+    }
+  }
+}
+
 }  // end of namespace collision_detection
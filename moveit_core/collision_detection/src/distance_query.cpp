@@ -0,0 +1,72 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/distance_query.hpp>
+
+namespace collision_detection
+{
+DistanceQuery::DistanceQuery(const DistanceRequest& req) : req_(req)
+{
+}
+
+const DistanceResult& DistanceQuery::distanceSelf(const CollisionEnv& env, const moveit::core::RobotState& state)
+{
+  res_.clear();
+  env.distanceSelf(req_, res_, state);
+  updateWarmStart();
+  return res_;
+}
+
+const DistanceResult& DistanceQuery::distanceRobot(const CollisionEnv& env, const moveit::core::RobotState& state)
+{
+  res_.clear();
+  env.distanceRobot(req_, res_, state);
+  updateWarmStart();
+  return res_;
+}
+
+void DistanceQuery::reset()
+{
+  res_.clear();
+  req_.warm_start_pairs.clear();
+}
+
+void DistanceQuery::updateWarmStart()
+{
+  req_.warm_start_pairs.clear();
+  const DistanceResultsData& closest = res_.minimum_distance;
+  if (!closest.link_names[0].empty() && !closest.link_names[1].empty())
+    req_.warm_start_pairs.emplace_back(closest.link_names[0], closest.link_names[1]);
+}
+}  // namespace collision_detection
@@ -0,0 +1,260 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/mesh_lod.hpp>
+#include <moveit/utils/logger.hpp>
+#include <geometric_shapes/bodies.h>
+#include <geometric_shapes/shape_operations.h>
+#include <rclcpp/logging.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace collision_detection
+{
+namespace
+{
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.core.collision_detection.mesh_lod");
+}
+
+// FNV-1a over the vertices and triangles of the mesh, identifying it in the caches
+std::uint64_t hashMesh(const shapes::Mesh& mesh)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  const auto add = [&hash](const void* data, std::size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+  };
+  add(&mesh.vertex_count, sizeof(mesh.vertex_count));
+  add(&mesh.triangle_count, sizeof(mesh.triangle_count));
+  add(mesh.vertices, 3 * mesh.vertex_count * sizeof(double));
+  add(mesh.triangles, 3 * mesh.triangle_count * sizeof(unsigned int));
+  return hash;
+}
+
+shapes::Mesh* createConvexHull(const shapes::Mesh& mesh)
+{
+  const bodies::ConvexMesh hull(&mesh);
+  const EigenSTL::vector_Vector3d& vertices = hull.getVertices();
+  const std::vector<unsigned int>& triangles = hull.getTriangles();
+  if (vertices.empty() || triangles.empty())
+    return nullptr;
+
+  auto* result = new shapes::Mesh(vertices.size(), triangles.size() / 3);
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+  {
+    for (std::size_t j = 0; j < 3; ++j)
+      result->vertices[3 * i + j] = vertices[i][j];
+  }
+  std::copy(triangles.begin(), triangles.end(), result->triangles);
+  return result;
+}
+
+shapes::Mesh* createBoundingBox(const shapes::Mesh& mesh)
+{
+  if (mesh.vertex_count == 0)
+    return nullptr;
+
+  Eigen::Vector3d min = Eigen::Map<const Eigen::Vector3d>(mesh.vertices);
+  Eigen::Vector3d max = min;
+  for (unsigned int i = 1; i < mesh.vertex_count; ++i)
+  {
+    const Eigen::Map<const Eigen::Vector3d> vertex(mesh.vertices + 3 * i);
+    min = min.cwiseMin(vertex);
+    max = max.cwiseMax(vertex);
+  }
+
+  // corner i has the maximum coordinate along x if bit 0 is set, along y for bit 1 and along z for bit 2
+  static const unsigned int TRIANGLES[] = { 0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                                            2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5 };
+  auto* result = new shapes::Mesh(8, 12);
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    result->vertices[3 * i] = (i & 1) ? max.x() : min.x();
+    result->vertices[3 * i + 1] = (i & 2) ? max.y() : min.y();
+    result->vertices[3 * i + 2] = (i & 4) ? max.z() : min.z();
+  }
+  std::memcpy(result->triangles, TRIANGLES, sizeof(TRIANGLES));
+  return result;
+}
+
+class MeshLODCache
+{
+public:
+  static MeshLODCache& getInstance()
+  {
+    static MeshLODCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const shapes::Mesh> get(const shapes::Mesh& mesh, MeshLOD lod)
+  {
+    const Key key{ hashMesh(mesh), lod };
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = meshes_.find(key);
+      if (it != meshes_.end())
+      {
+        if (std::shared_ptr<const shapes::Mesh> result = it->second.lock())
+          return result;
+      }
+    }
+
+    std::shared_ptr<const shapes::Mesh> result = load(key);
+    if (!result)
+    {
+      result.reset(lod == MeshLODs::CONVEX_HULL ? createConvexHull(mesh) : createBoundingBox(mesh));
+      if (!result)
+      {
+        RCLCPP_WARN(getLogger(), "Could not create level of detail %d of a mesh with %u vertices",
+                    static_cast<int>(lod), mesh.vertex_count);
+        return nullptr;
+      }
+      save(key, *result);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = meshes_.begin(); it != meshes_.end();)
+    {
+      if (it->second.expired())
+        it = meshes_.erase(it);
+      else
+        ++it;
+    }
+    meshes_[key] = result;
+    return result;
+  }
+
+  void setDirectory(const std::string& directory)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = directory;
+  }
+
+  std::string getDirectory()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return directory_;
+  }
+
+private:
+  using Key = std::pair<std::uint64_t, MeshLOD>;
+
+  MeshLODCache()
+  {
+    if (const char* directory = std::getenv("MOVEIT_MESH_LOD_CACHE"))
+      directory_ = directory;
+  }
+
+  std::filesystem::path getPath(const Key& key)
+  {
+    const std::string directory = getDirectory();
+    if (directory.empty())
+      return std::filesystem::path();
+    std::stringstream name;
+    name << std::hex << key.first << '_' << static_cast<int>(key.second) << ".mesh";
+    return std::filesystem::path(directory) / name.str();
+  }
+
+  std::shared_ptr<const shapes::Mesh> load(const Key& key)
+  {
+    const std::filesystem::path path = getPath(key);
+    if (path.empty() || !std::filesystem::exists(path))
+      return nullptr;
+    std::ifstream in(path);
+    std::shared_ptr<shapes::Shape> shape(shapes::constructShapeFromText(in));
+    if (!shape || shape->type != shapes::MESH)
+    {
+      RCLCPP_WARN(getLogger(), "Ignoring the invalid mesh level of detail cached in %s", path.string().c_str());
+      return nullptr;
+    }
+    return std::static_pointer_cast<const shapes::Mesh>(shape);
+  }
+
+  void save(const Key& key, const shapes::Mesh& mesh)
+  {
+    const std::filesystem::path path = getPath(key);
+    if (path.empty())
+      return;
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    // write to a temporary file first, so that other processes never read a partial mesh
+    std::stringstream tmp_name;
+    tmp_name << path.string() << ".tmp" << std::this_thread::get_id();
+    const std::filesystem::path tmp_path = tmp_name.str();
+    {
+      std::ofstream out(tmp_path);
+      if (!out || !shapes::saveAsText(&mesh, out))
+      {
+        RCLCPP_WARN(getLogger(), "Could not cache a mesh level of detail in %s", path.string().c_str());
+        return;
+      }
+    }
+    std::filesystem::rename(tmp_path, path, error);
+  }
+
+  std::mutex mutex_;
+  std::string directory_;
+  std::map<Key, std::weak_ptr<const shapes::Mesh>> meshes_;
+};
+}  // namespace
+
+std::shared_ptr<const shapes::Mesh> createMeshLOD(const shapes::Mesh& mesh, MeshLOD lod)
+{
+  if (lod == MeshLODs::EXACT)
+    return nullptr;
+  return MeshLODCache::getInstance().get(mesh, lod);
+}
+
+void setMeshLODCacheDirectory(const std::string& directory)
+{
+  MeshLODCache::getInstance().setDirectory(directory);
+}
+
+std::string getMeshLODCacheDirectory()
+{
+  return MeshLODCache::getInstance().getDirectory();
+}
+}  // namespace collision_detection
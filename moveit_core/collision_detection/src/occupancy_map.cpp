@@ -0,0 +1,88 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/occupancy_map.hpp>
+
+#include <cmath>
+
+namespace collision_detection
+{
+std::shared_ptr<octomap::OcTree> createPlanningOcTree(const octomap::OcTree& tree, double resolution)
+{
+  // cells of depth d are 2^(tree depth - d) leaves wide
+  unsigned int depth = tree.getTreeDepth();
+  double cell_size = tree.getResolution();
+  while (depth > 1 && 2.0 * cell_size <= resolution * (1.0 + 1e-9))
+  {
+    cell_size *= 2.0;
+    --depth;
+  }
+
+  auto planning_tree = std::make_shared<octomap::OcTree>(cell_size);
+  planning_tree->setOccupancyThres(tree.getOccupancyThres());
+  planning_tree->setClampingThresMin(tree.getClampingThresMin());
+  planning_tree->setClampingThresMax(tree.getClampingThresMax());
+  planning_tree->setProbHit(tree.getProbHit());
+  planning_tree->setProbMiss(tree.getProbMiss());
+  const float occupied = planning_tree->getClampingThresMaxLog();
+
+  // inner nodes hold the maximum occupancy of their children, so leaves iterated at depth are occupied if any of the
+  // leaves below them is
+  for (octomap::OcTree::leaf_iterator it = tree.begin_leafs(depth), end = tree.end_leafs(); it != end; ++it)
+  {
+    if (!tree.isNodeOccupied(*it))
+      continue;
+
+    // pruned leaves above depth span several cells of the copy
+    const int cells = static_cast<int>(std::lround(it.getSize() / cell_size));
+    const double first = 0.5 * cell_size * (1 - cells);
+    const octomap::point3d center = it.getCoordinate();
+    for (int x = 0; x < cells; ++x)
+    {
+      for (int y = 0; y < cells; ++y)
+      {
+        for (int z = 0; z < cells; ++z)
+        {
+          planning_tree->setNodeValue(center.x() + first + x * cell_size, center.y() + first + y * cell_size,
+                                      center.z() + first + z * cell_size, occupied, true);
+        }
+      }
+    }
+  }
+
+  planning_tree->updateInnerOccupancy();
+  planning_tree->prune();
+  return planning_tree;
+}
+}  // namespace collision_detection
@@ -36,10 +36,15 @@
 
 #include <moveit/collision_detection/world.hpp>
 #include <geometric_shapes/check_isometry.h>
+#include <geometric_shapes/shapes.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <atomic>
+#include <cmath>
+#include <limits>
+
 namespace collision_detection
 {
 namespace
@@ -48,15 +53,89 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.collision_detection_world");
 }
+
+std::uint64_t nextVersion()
+{
+  static std::atomic<std::uint64_t> version{ 0 };
+  return ++version;
+}
+
+// Grow box by the world frame bounding box of shape at pose. Returns false for shapes of unbounded extent.
+bool extendShapeAABB(const shapes::Shape& shape, const Eigen::Isometry3d& pose, Eigen::AlignedBox3d& box)
+{
+  const Eigen::Vector3d& center = pose.translation();
+  switch (shape.type)
+  {
+    case shapes::SPHERE:
+    {
+      const double radius = static_cast<const shapes::Sphere&>(shape).radius;
+      box.extend(Eigen::AlignedBox3d(center.array() - radius, center.array() + radius));
+      return true;
+    }
+    case shapes::BOX:
+    {
+      const double* size = static_cast<const shapes::Box&>(shape).size;
+      const Eigen::Vector3d half_extents =
+          0.5 * pose.linear().cwiseAbs() * Eigen::Vector3d(size[0], size[1], size[2]);
+      box.extend(Eigen::AlignedBox3d(center - half_extents, center + half_extents));
+      return true;
+    }
+    case shapes::CYLINDER:
+    case shapes::CONE:
+    {
+      double radius, length;
+      if (shape.type == shapes::CYLINDER)
+      {
+        radius = static_cast<const shapes::Cylinder&>(shape).radius;
+        length = static_cast<const shapes::Cylinder&>(shape).length;
+      }
+      else
+      {
+        radius = static_cast<const shapes::Cone&>(shape).radius;
+        length = static_cast<const shapes::Cone&>(shape).length;
+      }
+      // extent of a disc of the given radius around the axis, plus half the length along the axis
+      const Eigen::Vector3d axis = pose.linear().col(2);
+      const Eigen::Vector3d disc = (1.0 - axis.array().square()).max(0.0).sqrt() * radius;
+      const Eigen::Vector3d half_extents = 0.5 * length * axis.cwiseAbs() + disc;
+      box.extend(Eigen::AlignedBox3d(center - half_extents, center + half_extents));
+      return true;
+    }
+    case shapes::MESH:
+    {
+      const auto& mesh = static_cast<const shapes::Mesh&>(shape);
+      for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+        box.extend(pose * Eigen::Map<const Eigen::Vector3d>(mesh.vertices + 3 * i));
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// World frame bounding box of all shapes of obj, infinite if any of them is unbounded
+Eigen::AlignedBox3d computeObjectAABB(const World::Object& obj)
+{
+  Eigen::AlignedBox3d box;
+  for (std::size_t i = 0; i < obj.shapes_.size(); ++i)
+  {
+    if (!extendShapeAABB(*obj.shapes_[i], obj.global_shape_poses_[i], box))
+    {
+      const double inf = std::numeric_limits<double>::infinity();
+      return Eigen::AlignedBox3d(Eigen::Vector3d::Constant(-inf), Eigen::Vector3d::Constant(inf));
+    }
+  }
+  return box;
+}
 }  // namespace
 
-World::World()
+World::World() : objects_(std::make_shared<std::map<std::string, ObjectPtr>>()), version_(nextVersion())
 {
 }
 
 World::World(const World& other)
+  : objects_(other.objects_), version_(other.version_), spatial_index_(other.spatial_index_)
 {
-  objects_ = other.objects_;
 }
 
 World::~World()
@@ -90,7 +169,7 @@ void World::addToObject(const std::string& object_id, const Eigen::Isometry3d& p
 
   int action = ADD_SHAPE;
 
-  ObjectPtr& obj = objects_[object_id];
+  ObjectPtr& obj = ensureUniqueObjects()[object_id];
   if (!obj)
   {
     obj = std::make_shared<Object>(object_id);
@@ -109,16 +188,16 @@ void World::addToObject(const std::string& object_id, const Eigen::Isometry3d& p
 std::vector<std::string> World::getObjectIds() const
 {
   std::vector<std::string> ids;
-  ids.reserve(objects_.size());
-  for (const auto& object : objects_)
+  ids.reserve(objects_->size());
+  for (const auto& object : *objects_)
     ids.push_back(object.first);
   return ids;
 }
 
 World::ObjectConstPtr World::getObject(const std::string& object_id) const
 {
-  const auto it = objects_.find(object_id);
-  if (it == objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it == objects_->end())
   {
     return ObjectConstPtr();
   }
@@ -134,22 +213,68 @@ void World::ensureUnique(ObjectPtr& obj)
     obj = std::make_shared<Object>(*obj);
 }
 
+std::map<std::string, World::ObjectPtr>& World::ensureUniqueObjects()
+{
+  version_ = nextVersion();
+  if (objects_.use_count() > 1)
+    objects_ = std::make_shared<std::map<std::string, ObjectPtr>>(*objects_);
+  return *objects_;
+}
+
 bool World::hasObject(const std::string& object_id) const
 {
-  return objects_.find(object_id) != objects_.end();
+  return objects_->find(object_id) != objects_->end();
+}
+
+void World::setSpatialIndexEnabled(bool enabled)
+{
+  if (!enabled)
+  {
+    spatial_index_.reset();
+    return;
+  }
+  if (spatial_index_)
+    return;
+  spatial_index_ = std::make_shared<AABBTree>();
+  for (const auto& object : *objects_)
+    spatial_index_->update(object.first, computeObjectAABB(*object.second));
+}
+
+std::vector<std::string> World::getObjectsInBox(const Eigen::AlignedBox3d& box) const
+{
+  std::vector<std::string> ids;
+  if (spatial_index_)
+  {
+    spatial_index_->query(box, ids);
+    return ids;
+  }
+  for (const auto& object : *objects_)
+  {
+    if (box.intersects(computeObjectAABB(*object.second)))
+      ids.push_back(object.first);
+  }
+  return ids;
+}
+
+Eigen::AlignedBox3d World::getObjectAABB(const std::string& object_id) const
+{
+  const auto it = objects_->find(object_id);
+  if (it == objects_->end())
+    return Eigen::AlignedBox3d();
+  return computeObjectAABB(*it->second);
 }
 
 bool World::knowsTransform(const std::string& name) const
 {
   // Check object names first
-  const std::map<std::string, ObjectPtr>::const_iterator it = objects_.find(name);
-  if (it != objects_.end())
+  const std::map<std::string, ObjectPtr>::const_iterator it = objects_->find(name);
+  if (it != objects_->end())
   {
     return true;
   }
   else  // Then objects' subframes
   {
-    for (const std::pair<const std::string, ObjectPtr>& object : objects_)
+    for (const std::pair<const std::string, ObjectPtr>& object : *objects_)
     {
       // if "object name/" matches start of object_id, we found the matching object
       // rfind searches name for object.first in the first index (returns 0 if found)
@@ -177,14 +302,14 @@ const Eigen::Isometry3d& World::getTransform(const std::string& name, bool& fram
   // assume found
   frame_found = true;
 
-  const std::map<std::string, ObjectPtr>::const_iterator it = objects_.find(name);
-  if (it != objects_.end())
+  const std::map<std::string, ObjectPtr>::const_iterator it = objects_->find(name);
+  if (it != objects_->end())
   {
     return it->second->pose_;
   }
   else  // Search within subframes
   {
-    for (const std::pair<const std::string, ObjectPtr>& object : objects_)
+    for (const std::pair<const std::string, ObjectPtr>& object : *objects_)
     {
       // if "object name/" matches start of object_id, we found the matching object
       // rfind searches name for object.first in the first index (returns 0 if found)
@@ -207,8 +332,8 @@ const Eigen::Isometry3d& World::getTransform(const std::string& name, bool& fram
 
 const Eigen::Isometry3d& World::getGlobalShapeTransform(const std::string& object_id, const int shape_index) const
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it != objects_->end())
   {
     return it->second->global_shape_poses_[shape_index];
   }
@@ -222,8 +347,8 @@ const Eigen::Isometry3d& World::getGlobalShapeTransform(const std::string& objec
 
 const EigenSTL::vector_Isometry3d& World::getGlobalShapeTransforms(const std::string& object_id) const
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it != objects_->end())
   {
     return it->second->global_shape_poses_;
   }
@@ -238,8 +363,9 @@ const EigenSTL::vector_Isometry3d& World::getGlobalShapeTransforms(const std::st
 bool World::moveShapeInObject(const std::string& object_id, const shapes::ShapeConstPtr& shape,
                               const Eigen::Isometry3d& shape_pose)
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  std::map<std::string, ObjectPtr>& objects = ensureUniqueObjects();
+  const auto it = objects.find(object_id);
+  if (it != objects.end())
   {
     const unsigned int n = it->second->shapes_.size();
     for (unsigned int i = 0; i < n; ++i)
@@ -261,11 +387,13 @@ bool World::moveShapeInObject(const std::string& object_id, const shapes::ShapeC
 
 bool World::moveShapesInObject(const std::string& object_id, const EigenSTL::vector_Isometry3d& shape_poses)
 {
-  auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  std::map<std::string, ObjectPtr>& objects = ensureUniqueObjects();
+  auto it = objects.find(object_id);
+  if (it != objects.end())
   {
     if (shape_poses.size() == it->second->shapes_.size())
     {
+      ensureUnique(it->second);
       for (std::size_t i = 0; i < shape_poses.size(); ++i)
       {
         ASSERT_ISOMETRY(shape_poses[i])  // unsanitized input, could contain a non-isometry
@@ -281,8 +409,8 @@ bool World::moveShapesInObject(const std::string& object_id, const EigenSTL::vec
 
 bool World::moveObject(const std::string& object_id, const Eigen::Isometry3d& transform)
 {
-  const auto it = objects_.find(object_id);
-  if (it == objects_.end())
+  const auto it = objects_->find(object_id);
+  if (it == objects_->end())
     return false;
   if (transform.isApprox(Eigen::Isometry3d::Identity()))
     return true;  // object already at correct location
@@ -294,7 +422,7 @@ bool World::moveObject(const std::string& object_id, const Eigen::Isometry3d& tr
 bool World::setObjectPose(const std::string& object_id, const Eigen::Isometry3d& pose)
 {
   ASSERT_ISOMETRY(pose);  // unsanitized input, could contain a non-isometry
-  ObjectPtr& obj = objects_[object_id];
+  ObjectPtr& obj = ensureUniqueObjects()[object_id];
   int action;
   if (!obj)
   {
@@ -315,8 +443,9 @@ bool World::setObjectPose(const std::string& object_id, const Eigen::Isometry3d&
 
 bool World::removeShapeFromObject(const std::string& object_id, const shapes::ShapeConstPtr& shape)
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  std::map<std::string, ObjectPtr>& objects = ensureUniqueObjects();
+  const auto it = objects.find(object_id);
+  if (it != objects.end())
   {
     const unsigned int n = it->second->shapes_.size();
     for (unsigned int i = 0; i < n; ++i)
@@ -331,7 +460,7 @@ bool World::removeShapeFromObject(const std::string& object_id, const shapes::Sh
         if (it->second->shapes_.empty())
         {
           notify(it->second, DESTROY);
-          objects_.erase(it);
+          objects.erase(it);
         }
         else
         {
@@ -346,11 +475,12 @@ bool World::removeShapeFromObject(const std::string& object_id, const shapes::Sh
 
 bool World::removeObject(const std::string& object_id)
 {
-  const auto it = objects_.find(object_id);
-  if (it != objects_.end())
+  std::map<std::string, ObjectPtr>& objects = ensureUniqueObjects();
+  const auto it = objects.find(object_id);
+  if (it != objects.end())
   {
     notify(it->second, DESTROY);
-    objects_.erase(it);
+    objects.erase(it);
     return true;
   }
   return false;
@@ -358,14 +488,19 @@ bool World::removeObject(const std::string& object_id)
 
 void World::clearObjects()
 {
+  if (spatial_index_)
+    spatial_index_ = std::make_shared<AABBTree>();
   notifyAll(DESTROY);
-  objects_.clear();
+  // copies of the world keep their objects
+  objects_ = std::make_shared<std::map<std::string, ObjectPtr>>();
+  version_ = nextVersion();
 }
 
 bool World::setSubframesOfObject(const std::string& object_id, const moveit::core::FixedTransformsMap& subframe_poses)
 {
-  const auto obj_pair = objects_.find(object_id);
-  if (obj_pair == objects_.end())
+  std::map<std::string, ObjectPtr>& objects = ensureUniqueObjects();
+  const auto obj_pair = objects.find(object_id);
+  if (obj_pair == objects.end())
   {
     return false;
   }
@@ -373,6 +508,7 @@ bool World::setSubframesOfObject(const std::string& object_id, const moveit::cor
   {
     ASSERT_ISOMETRY(t.second)  // unsanitized input, could contain a non-isometry
   }
+  ensureUnique(obj_pair->second);
   obj_pair->second->subframe_poses_ = subframe_poses;
   obj_pair->second->global_subframe_poses_ = subframe_poses;
   updateGlobalPosesInternal(obj_pair->second, false, true);
@@ -422,12 +558,22 @@ void World::removeObserver(ObserverHandle observer_handle)
 
 void World::notifyAll(Action action)
 {
-  for (std::map<std::string, ObjectPtr>::const_iterator it = objects_.begin(); it != objects_.end(); ++it)
+  for (std::map<std::string, ObjectPtr>::const_iterator it = objects_->begin(); it != objects_->end(); ++it)
     notify(it->second, action);
 }
 
 void World::notify(const ObjectConstPtr& obj, Action action)
 {
+  if (spatial_index_)
+  {
+    // copies of the world keep their index
+    if (spatial_index_.use_count() > 1)
+      spatial_index_ = std::make_shared<AABBTree>(*spatial_index_);
+    if (action & DESTROY)
+      spatial_index_->remove(obj->id_);
+    else
+      spatial_index_->update(obj->id_, computeObjectAABB(*obj));
+  }
   for (Observer* observer : observers_)
     observer->callback_(obj, action);
 }
@@ -439,7 +585,7 @@ void World::notifyObserverAllObjects(const ObserverHandle observer_handle, Actio
     if (observer == observer_handle.observer_)
     {
       // call the callback for each object
-      for (const auto& object : objects_)
+      for (const auto& object : *objects_)
         observer->callback_(object.second, action);
       break;
     }
@@ -0,0 +1,113 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/collision_detection/mesh_lod.hpp>
+#include <geometric_shapes/mesh_operations.h>
+
+#include <filesystem>
+#include <memory>
+
+namespace
+{
+std::shared_ptr<shapes::Mesh> createSphereMesh()
+{
+  return std::shared_ptr<shapes::Mesh>(shapes::createMeshFromShape(shapes::Sphere(0.5)));
+}
+
+Eigen::AlignedBox3d getBounds(const shapes::Mesh& mesh)
+{
+  Eigen::AlignedBox3d bounds;
+  for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+    bounds.extend(Eigen::Vector3d(mesh.vertices[3 * i], mesh.vertices[3 * i + 1], mesh.vertices[3 * i + 2]));
+  return bounds;
+}
+}  // namespace
+
+TEST(MeshLOD, Levels)
+{
+  const std::shared_ptr<shapes::Mesh> mesh = createSphereMesh();
+  ASSERT_GT(mesh->vertex_count, 8u);
+  const Eigen::AlignedBox3d bounds = getBounds(*mesh);
+
+  EXPECT_FALSE(collision_detection::createMeshLOD(*mesh, collision_detection::MeshLODs::EXACT));
+
+  const auto hull = collision_detection::createMeshLOD(*mesh, collision_detection::MeshLODs::CONVEX_HULL);
+  ASSERT_TRUE(hull);
+  EXPECT_GT(hull->triangle_count, 0u);
+  EXPECT_LE(hull->vertex_count, mesh->vertex_count);
+  EXPECT_TRUE(getBounds(*hull).isApprox(bounds, 1e-9));
+
+  const auto box = collision_detection::createMeshLOD(*mesh, collision_detection::MeshLODs::BOUNDING_BOX);
+  ASSERT_TRUE(box);
+  EXPECT_EQ(box->vertex_count, 8u);
+  EXPECT_EQ(box->triangle_count, 12u);
+  EXPECT_TRUE(getBounds(*box).isApprox(bounds, 1e-9));
+
+  // levels are cached by the content of the mesh
+  const std::shared_ptr<shapes::Mesh> copy(mesh->clone());
+  EXPECT_EQ(collision_detection::createMeshLOD(*copy, collision_detection::MeshLODs::BOUNDING_BOX), box);
+}
+
+TEST(MeshLOD, DiskCache)
+{
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "moveit_test_mesh_lod";
+  std::filesystem::remove_all(directory);
+  collision_detection::setMeshLODCacheDirectory(directory.string());
+  EXPECT_EQ(collision_detection::getMeshLODCacheDirectory(), directory.string());
+
+  const std::shared_ptr<shapes::Mesh> mesh(shapes::createMeshFromShape(shapes::Box(0.1, 0.2, 0.3)));
+  std::size_t hull_vertex_count;
+  {
+    const auto hull = collision_detection::createMeshLOD(*mesh, collision_detection::MeshLODs::CONVEX_HULL);
+    ASSERT_TRUE(hull);
+    hull_vertex_count = hull->vertex_count;
+  }
+  ASSERT_TRUE(std::filesystem::exists(directory));
+  EXPECT_FALSE(std::filesystem::is_empty(directory));
+
+  // once the level is no longer in memory, it is loaded from disk
+  const auto hull = collision_detection::createMeshLOD(*mesh, collision_detection::MeshLODs::CONVEX_HULL);
+  ASSERT_TRUE(hull);
+  EXPECT_EQ(hull->vertex_count, hull_vertex_count);
+
+  collision_detection::setMeshLODCacheDirectory("");
+  std::filesystem::remove_all(directory);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,149 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/collision_detection/occupancy_map.hpp>
+#include <thread>
+#include <vector>
+
+TEST(OccMapTree, TrackChanges)
+{
+  collision_detection::OccMapTree tree(0.1);
+  std::vector<collision_detection::OccMapTreeChanges> changes;
+  tree.setChangeCallback([&changes](const collision_detection::OccMapTreeChanges& c) { changes.push_back(c); });
+
+  // no changes are reported until tracking is enabled
+  tree.updateNode(octomap::point3d(0.05, 0.05, 0.05), true);
+  tree.triggerUpdateCallback();
+  EXPECT_TRUE(changes.empty());
+
+  tree.enableChangeTracking(true);
+  tree.updateNode(octomap::point3d(0.55, 0.05, 0.05), true);
+  tree.updateNode(octomap::point3d(1.05, 0.25, 0.05), true);
+  tree.triggerUpdateCallback();
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_FALSE(changes[0].full);
+  EXPECT_EQ(changes[0].keys.size(), 2u);
+  EXPECT_EQ(changes[0].keys.count(tree.coordToKey(0.55, 0.05, 0.05)), 1u);
+  EXPECT_NEAR(changes[0].min.x(), 0.5, 1e-5);
+  EXPECT_NEAR(changes[0].min.y(), 0.0, 1e-5);
+  EXPECT_NEAR(changes[0].max.x(), 1.1, 1e-5);
+  EXPECT_NEAR(changes[0].max.y(), 0.3, 1e-5);
+
+  // the changes are reset with each update
+  tree.triggerUpdateCallback();
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_TRUE(changes[1].keys.empty());
+
+  tree.markAllChanged();
+  tree.triggerUpdateCallback();
+  ASSERT_EQ(changes.size(), 3u);
+  EXPECT_TRUE(changes[2].full);
+}
+
+TEST(OccMapTree, ClearStaleCells)
+{
+  collision_detection::OccMapTree tree(0.1);
+  std::vector<collision_detection::OccMapTreeChanges> changes;
+  tree.setChangeCallback([&changes](const collision_detection::OccMapTreeChanges& c) { changes.push_back(c); });
+  tree.enableChangeTracking(true);
+  tree.enableDecay(true);
+
+  const octomap::point3d stale(0.05, 0.05, 0.05);
+  const octomap::point3d fresh(1.05, 0.05, 0.05);
+  tree.updateNode(stale, true);
+  tree.updateNode(fresh, true);
+  tree.triggerUpdateCallback();
+  EXPECT_EQ(tree.clearStaleCells(std::chrono::hours(1)), 0u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  tree.updateNode(fresh, true);
+  EXPECT_EQ(tree.clearStaleCells(std::chrono::milliseconds(25)), 1u);
+  EXPECT_EQ(tree.search(stale), nullptr);
+  ASSERT_NE(tree.search(fresh), nullptr);
+  EXPECT_TRUE(tree.isNodeOccupied(tree.search(fresh)));
+
+  // the cleared cell is reported as changed
+  tree.triggerUpdateCallback();
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[1].keys.count(tree.coordToKey(stale)), 1u);
+
+  // cells are only cleared once
+  EXPECT_EQ(tree.clearStaleCells(std::chrono::milliseconds(25)), 0u);
+}
+
+TEST(OccMapTree, CreatePlanningOcTree)
+{
+  collision_detection::OccMapTree tree(0.1);
+  tree.updateNode(octomap::point3d(0.05, 0.05, 0.05), true);
+  tree.updateNode(octomap::point3d(0.55, 0.05, 0.05), false);
+  // a solid block of 2x2x2 leaves that is pruned into a single node
+  for (double x : { 1.05, 1.15 })
+  {
+    for (double y : { 1.05, 1.15 })
+    {
+      for (double z : { 1.05, 1.15 })
+      {
+        for (int i = 0; i < 10; ++i)
+          tree.updateNode(octomap::point3d(x, y, z), true);
+      }
+    }
+  }
+  tree.prune();
+
+  // at the resolution of the map, only free space is dropped
+  std::shared_ptr<octomap::OcTree> copy = collision_detection::createPlanningOcTree(tree);
+  EXPECT_DOUBLE_EQ(copy->getResolution(), 0.1);
+  ASSERT_NE(copy->search(0.05, 0.05, 0.05), nullptr);
+  EXPECT_TRUE(copy->isNodeOccupied(copy->search(0.05, 0.05, 0.05)));
+  EXPECT_EQ(copy->search(0.55, 0.05, 0.05), nullptr);
+  ASSERT_NE(copy->search(1.15, 1.05, 1.15), nullptr);
+  EXPECT_TRUE(copy->isNodeOccupied(copy->search(1.15, 1.05, 1.15)));
+  EXPECT_EQ(copy->getNumLeafNodes(), 2u);
+
+  // coarse cells are occupied if any of their leaves is
+  std::shared_ptr<octomap::OcTree> coarse = collision_detection::createPlanningOcTree(tree, 0.45);
+  EXPECT_DOUBLE_EQ(coarse->getResolution(), 0.4);
+  ASSERT_NE(coarse->search(0.35, 0.35, 0.35), nullptr);
+  EXPECT_TRUE(coarse->isNodeOccupied(coarse->search(0.35, 0.35, 0.35)));
+  EXPECT_EQ(coarse->search(0.55, 0.05, 0.05), nullptr);
+  ASSERT_NE(coarse->search(0.85, 0.85, 0.85), nullptr);
+  EXPECT_EQ(coarse->getNumLeafNodes(), 2u);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
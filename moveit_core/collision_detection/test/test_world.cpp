@@ -37,6 +37,8 @@
 #include <gtest/gtest.h>
 #include <moveit/collision_detection/world.hpp>
 #include <geometric_shapes/shapes.h>
+#include <algorithm>
+#include <cmath>
 #include <functional>
 
 using namespace collision_detection;
@@ -458,6 +460,107 @@ TEST(World, ObjectPoseAndSubframes)
   EXPECT_EQ(1.0, pose(2, 3));  // z
 }
 
+TEST(World, CopyOnWrite)
+{
+  World world;
+  shapes::ShapePtr box = std::make_shared<shapes::Box>(1, 1, 1);
+  world.addToObject("box", box, Eigen::Isometry3d::Identity());
+  world.addToObject("other", box, Eigen::Isometry3d::Identity());
+
+  // copies share the objects until they are changed
+  World copy(world);
+  EXPECT_EQ(world.getObject("box"), copy.getObject("box"));
+
+  copy.moveShapesInObject("box", { Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)) });
+  moveit::core::FixedTransformsMap subframes;
+  subframes["frame"] = Eigen::Isometry3d(Eigen::Translation3d(0, 1, 0));
+  copy.setSubframesOfObject("box", subframes);
+  copy.removeObject("other");
+  copy.addToObject("ball", std::make_shared<shapes::Sphere>(1.0), Eigen::Isometry3d::Identity());
+
+  EXPECT_NE(world.getObject("box"), copy.getObject("box"));
+  EXPECT_EQ(0.0, world.getGlobalShapeTransform("box", 0)(2, 3));
+  EXPECT_EQ(1.0, copy.getGlobalShapeTransform("box", 0)(2, 3));
+  EXPECT_FALSE(world.knowsTransform("box/frame"));
+  EXPECT_TRUE(copy.knowsTransform("box/frame"));
+  EXPECT_TRUE(world.hasObject("other"));
+  EXPECT_FALSE(copy.hasObject("other"));
+  EXPECT_FALSE(world.hasObject("ball"));
+  EXPECT_EQ(2u, world.size());
+  EXPECT_EQ(2u, copy.size());
+
+  copy.clearObjects();
+  EXPECT_EQ(2u, world.size());
+  EXPECT_EQ(0u, copy.size());
+}
+
+TEST(World, Version)
+{
+  World world;
+  const std::uint64_t empty_version = world.getVersion();
+  EXPECT_NE(empty_version, World().getVersion());
+
+  world.addToObject("box", std::make_shared<shapes::Box>(1, 1, 1), Eigen::Isometry3d::Identity());
+  EXPECT_NE(empty_version, world.getVersion());
+
+  // copies keep the version until they are changed
+  World copy(world);
+  EXPECT_EQ(world.getVersion(), copy.getVersion());
+  copy.setObjectPose("box", Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)));
+  EXPECT_NE(world.getVersion(), copy.getVersion());
+
+  const std::uint64_t version = copy.getVersion();
+  copy.clearObjects();
+  EXPECT_NE(version, copy.getVersion());
+}
+
+TEST(World, SpatialIndex)
+{
+  World world;
+  world.addToObject("box", std::make_shared<shapes::Box>(1, 1, 1), Eigen::Isometry3d::Identity());
+  world.addToObject("ball", std::make_shared<shapes::Sphere>(0.5), Eigen::Isometry3d(Eigen::Translation3d(5, 0, 0)));
+  world.addToObject("far", std::make_shared<shapes::Cylinder>(0.5, 1.0),
+                    Eigen::Isometry3d(Eigen::Translation3d(20, 0, 0)));
+
+  const Eigen::AlignedBox3d around_origin(Eigen::Vector3d(-1, -1, -1), Eigen::Vector3d(1, 1, 1));
+  const Eigen::AlignedBox3d around_ball(Eigen::Vector3d(4, -1, -1), Eigen::Vector3d(6, 1, 1));
+  const auto sorted = [](std::vector<std::string> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  };
+
+  // the linear scan and the index agree
+  const std::vector<std::string> scanned = sorted(world.getObjectsInBox(around_origin));
+  EXPECT_EQ(scanned, std::vector<std::string>{ "box" });
+  world.setSpatialIndexEnabled(true);
+  EXPECT_TRUE(world.isSpatialIndexEnabled());
+  EXPECT_EQ(scanned, sorted(world.getObjectsInBox(around_origin)));
+  EXPECT_EQ(sorted(world.getObjectsInBox(around_ball)), std::vector<std::string>{ "ball" });
+
+  // a rotated box reaches further along the world axes
+  const Eigen::AlignedBox3d rotated_box = world.getObjectAABB("box");
+  EXPECT_NEAR(rotated_box.max().x(), 0.5, 1e-9);
+  world.setObjectPose("box", Eigen::Isometry3d(Eigen::AngleAxisd(M_PI / 4, Eigen::Vector3d::UnitZ())));
+  EXPECT_NEAR(world.getObjectAABB("box").max().x(), std::sqrt(0.5), 1e-9);
+
+  // the index follows changes of the world, copies keep their index
+  World copy(world);
+  world.moveObject("ball", Eigen::Isometry3d(Eigen::Translation3d(-5, 0, 0)));
+  world.removeObject("box");
+  EXPECT_EQ(sorted(world.getObjectsInBox(around_origin)), std::vector<std::string>{ "ball" });
+  EXPECT_TRUE(world.getObjectsInBox(around_ball).empty());
+  EXPECT_EQ(sorted(copy.getObjectsInBox(around_origin)), std::vector<std::string>{ "box" });
+  EXPECT_EQ(sorted(copy.getObjectsInBox(around_ball)), std::vector<std::string>{ "ball" });
+
+  // unbounded shapes are reported by every query
+  world.addToObject("plane", std::make_shared<shapes::Plane>(0, 0, 1, 0), Eigen::Isometry3d::Identity());
+  EXPECT_EQ(sorted(world.getObjectsInBox(around_ball)), std::vector<std::string>{ "plane" });
+
+  world.clearObjects();
+  EXPECT_TRUE(world.getObjectsInBox(around_origin).empty());
+  EXPECT_EQ(sorted(copy.getObjectsInBox(around_origin)), std::vector<std::string>{ "box" });
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
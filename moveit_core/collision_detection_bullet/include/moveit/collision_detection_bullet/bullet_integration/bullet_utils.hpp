@@ -41,6 +41,7 @@
 #include <moveit/collision_detection_bullet/bullet_integration/basic_types.hpp>
 #include <moveit/collision_detection_bullet/bullet_integration/contact_checker_common.hpp>
 #include <moveit/collision_detection/collision_common.hpp>
+#include <moveit/collision_detection/collision_matrix.hpp>
 #include <moveit/macros/declare_ptr.hpp>
 #include <moveit/macros/class_forward.hpp>
 
@@ -152,6 +153,12 @@ public:
     return type_id_;
   }
 
+  /** @brief Get the index of the collision object name in \e acm, memoized for the view most recently used */
+  int getACMIndex(const collision_detection::CompiledAllowedCollisionMatrix& acm) const
+  {
+    return acm.getIndex(name_, acm_index_);
+  }
+
   /** \brief Check if two CollisionObjectWrapper objects point to the same source object
    *  \return True if same objects, false otherwise */
   bool sameObject(const CollisionObjectWrapper& other) const
@@ -231,8 +238,15 @@ protected:
 
   /** @brief Manages the collision shape pointer so they get destroyed */
   std::vector<std::shared_ptr<void>> data_;
+
+  /** @brief The cache used by getACMIndex() */
+  mutable std::atomic<std::uint64_t> acm_index_{ 0 };
 };
 
+/** \brief Allowed = true, looking the pair up by the indices of the objects in the index-based view \e acm */
+bool acmCheck(const CollisionObjectWrapper* cow0, const CollisionObjectWrapper* cow1,
+              const collision_detection::CompiledAllowedCollisionMatrix* acm);
+
 /** @brief Casted collision shape used for checking if an object is collision free between two discrete poses
  *
  *  The cast is not explicitly computed but implicitly represented through the single shape and the transformation
@@ -533,6 +547,9 @@ struct BroadphaseContactResultCallback
   double contact_distance_;
   const collision_detection::AllowedCollisionMatrix* acm_{ nullptr };
 
+  /** \brief The index-based view of \e acm_ used by needsCollision() */
+  collision_detection::CompiledAllowedCollisionMatrixConstPtr compiled_acm_;
+
   /** \brief Indicates if the callback is used for only self-collision checking */
   bool self_;
 
@@ -541,7 +558,12 @@ struct BroadphaseContactResultCallback
 
   BroadphaseContactResultCallback(ContactTestData& collisions, double contact_distance,
                                   const collision_detection::AllowedCollisionMatrix* acm, bool self, bool cast = false)
-    : collisions_(collisions), contact_distance_(contact_distance), acm_(acm), self_(self), cast_(cast)
+    : collisions_(collisions)
+    , contact_distance_(contact_distance)
+    , acm_(acm)
+    , compiled_acm_(acm ? acm->getCompiled() : nullptr)
+    , self_(self)
+    , cast_(cast)
   {
   }
 
@@ -554,12 +576,12 @@ struct BroadphaseContactResultCallback
   {
     if (cast_)
     {
-      return !collisions_.done && !isOnlyKinematic(cow0, cow1) && !acmCheck(cow0->getName(), cow1->getName(), acm_);
+      return !collisions_.done && !isOnlyKinematic(cow0, cow1) && !acmCheck(cow0, cow1, compiled_acm_.get());
     }
     else
     {
       return !collisions_.done && (self_ ? isOnlyKinematic(cow0, cow1) : !isOnlyKinematic(cow0, cow1)) &&
-             !acmCheck(cow0->getName(), cow1->getName(), acm_);
+             !acmCheck(cow0, cow1, compiled_acm_.get());
     }
   }
 
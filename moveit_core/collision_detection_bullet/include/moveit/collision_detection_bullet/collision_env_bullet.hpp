@@ -39,6 +39,8 @@
 #include <moveit/collision_detection/collision_env.hpp>
 #include <moveit/collision_detection_bullet/bullet_integration/bullet_discrete_bvh_manager.hpp>
 #include <moveit/collision_detection_bullet/bullet_integration/bullet_cast_bvh_manager.hpp>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 
 namespace collision_detection
@@ -99,6 +101,16 @@ protected:
   void addAttachedObjects(const moveit::core::RobotState& state,
                           std::vector<collision_detection_bullet::CollisionObjectWrapperPtr>& cows) const;
 
+  std::size_t checkCollisionBatchHelper(const CollisionRequest& req,
+                                        const std::vector<const moveit::core::RobotState*>& states,
+                                        std::vector<CollisionResult>& results, const AllowedCollisionMatrix* acm,
+                                        bool stop_at_first_collision) const override;
+
+  /** \brief Check one state of a batch for self and world collisions using \e manager */
+  void checkBatchStateCollision(const CollisionRequest& req, CollisionResult& res,
+                                const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm,
+                                const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager) const;
+
   /** \brief Bundles the different checkSelfCollision functions into a single function */
   void checkSelfCollisionHelper(const CollisionRequest& req, CollisionResult& res,
                                 const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm) const;
@@ -123,9 +135,22 @@ protected:
     new collision_detection_bullet::BulletCastBVHManager()
   };
 
-  // Lock manager_ and manager_CCD_, for thread-safe collision tests
+  // Lock manager_ and manager_CCD_, for thread-safe collision tests. A check finding them locked by another check
+  // uses the thread's copies instead, see getThreadManager().
   mutable std::mutex collision_env_mutex_;
 
+  /** \brief Identifies this environment in the thread-local manager copies */
+  std::uint64_t manager_id_;
+
+  /** \brief Changed whenever manager_ and manager_CCD_ change, so the thread-local copies of them are cloned again */
+  std::atomic<std::uint64_t> manager_version_{ 0 };
+
+  /** \brief Get the calling thread's copy of manager_, up to date with the world */
+  const collision_detection_bullet::BulletDiscreteBVHManagerPtr& getThreadManager() const;
+
+  /** \brief Get the calling thread's copy of manager_CCD_, up to date with the world */
+  const collision_detection_bullet::BulletCastBVHManagerPtr& getThreadCastManager() const;
+
   /** \brief Adds a world object to the collision managers */
   void addToManager(const World::Object* obj);
 
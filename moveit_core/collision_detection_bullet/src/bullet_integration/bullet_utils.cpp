@@ -38,6 +38,7 @@
 #include <BulletCollision/CollisionShapes/btShapeHull.h>
 #include <BulletCollision/Gimpact/btGImpactShape.h>
 #include <geometric_shapes/shapes.h>
+#include <chrono>
 #include <memory>
 #include <octomap/octomap.h>
 #include <rclcpp/logger.hpp>
@@ -81,6 +82,34 @@ bool acmCheck(const std::string& body_1, const std::string& body_2,
   }
 }
 
+bool acmCheck(const CollisionObjectWrapper* cow0, const CollisionObjectWrapper* cow1,
+              const collision_detection::CompiledAllowedCollisionMatrix* acm)
+{
+  if (acm == nullptr)
+  {
+    RCLCPP_DEBUG_STREAM(getLogger(),
+                        "No ACM, collision check between " << cow0->getName() << " and " << cow1->getName());
+    return false;
+  }
+
+  collision_detection::AllowedCollision::Type allowed_type;
+  if (!acm->getAllowedCollision(cow0->getACMIndex(*acm), cow1->getACMIndex(*acm), allowed_type))
+  {
+    RCLCPP_DEBUG_STREAM(getLogger(), "No entry in ACM found, collision check between " << cow0->getName() << " and "
+                                                                                      << cow1->getName());
+    return false;
+  }
+  if (allowed_type == collision_detection::AllowedCollision::Type::NEVER)
+  {
+    RCLCPP_DEBUG_STREAM(getLogger(), "Not allowed entry in ACM found, collision check between "
+                                         << cow0->getName() << " and " << cow1->getName());
+    return false;
+  }
+  RCLCPP_DEBUG_STREAM(getLogger(), "Entry in ACM found, skipping collision check as allowed "
+                                       << cow0->getName() << " and " << cow1->getName());
+  return true;
+}
+
 btCollisionShape* createShapePrimitive(const shapes::Box* geom, const CollisionObjectType& collision_object_type)
 {
   static_cast<void>(collision_object_type);
@@ -511,6 +540,15 @@ bool TesseractCollisionPairCallback::processOverlap(btBroadphasePair& pair)
   const CollisionObjectWrapper* cow1 = static_cast<const CollisionObjectWrapper*>(pair.m_pProxy1->m_clientObject);
 
   std::pair<std::string, std::string> pair_names{ cow0->getName(), cow1->getName() };
+  collision_detection::CollisionPairStatistics* statistics = nullptr;
+  if (results_callback_.collisions_.req.profile)
+  {
+    if (pair_names.second < pair_names.first)
+      std::swap(pair_names.first, pair_names.second);
+    statistics = &results_callback_.collisions_.res.pair_statistics[pair_names];
+    ++statistics->broadphase_candidates;
+  }
+
   if (results_callback_.needsCollision(cow0, cow1))
   {
     RCLCPP_DEBUG_STREAM(getLogger(), "Processing " << cow0->getName() << " vs " << cow1->getName());
@@ -529,7 +567,13 @@ bool TesseractCollisionPairCallback::processOverlap(btBroadphasePair& pair)
       contact_point_result.m_closestPointDistanceThreshold = static_cast<btScalar>(results_callback_.contact_distance_);
 
       // discrete collision detection query
+      const auto start = statistics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
       pair.m_algorithm->processCollision(&obj0_wrap, &obj1_wrap, dispatch_info_, &contact_point_result);
+      if (statistics)
+      {
+        ++statistics->narrowphase_calls;
+        statistics->narrowphase_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
     }
   }
   else
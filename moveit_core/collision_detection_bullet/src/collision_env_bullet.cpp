@@ -38,7 +38,9 @@
 #include <moveit/collision_detection_bullet/collision_detector_allocator_bullet.hpp>
 #include <moveit/collision_detection_bullet/bullet_integration/ros_bullet_utils.hpp>
 #include <moveit/collision_detection_bullet/bullet_integration/contact_checker_common.hpp>
+#include <moveit/collision_detection/collision_batch.hpp>
 #include <functional>
+#include <list>
 #include <bullet/btBulletCollisionCommon.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
@@ -50,8 +52,55 @@ const double MAX_DISTANCE_MARGIN = 99;
 
 using collision_detection_bullet::getLogger;
 
+namespace
+{
+// Identifies an environment in the thread-local manager copies, see getThreadCopy()
+std::atomic<std::uint64_t> next_manager_id{ 1 };
+
+// The number of environments a thread keeps manager copies for
+constexpr std::size_t MAX_CACHED_MANAGERS = 4;
+
+// Get the calling thread's copy of the manager \e source of the environment \e id. The copy is cloned again when
+// \e version changed since it was made; \e mutex guards \e source and \e version while cloning.
+template <typename ManagerPtr>
+const ManagerPtr& getThreadCopy(std::uint64_t id, const std::atomic<std::uint64_t>& version, std::mutex& mutex,
+                                const ManagerPtr& source)
+{
+  struct CachedManager
+  {
+    std::uint64_t id;
+    std::uint64_t version;
+    ManagerPtr manager;
+  };
+  // least recently used first; a list keeps the returned references valid while it is reordered
+  thread_local std::list<CachedManager> cache;
+
+  auto it = cache.begin();
+  while (it != cache.end() && it->id != id)
+    ++it;
+  if (it == cache.end())
+  {
+    if (cache.size() >= MAX_CACHED_MANAGERS)
+      cache.pop_front();
+    it = cache.insert(cache.end(), CachedManager{ id, 0, nullptr });
+  }
+  else
+  {
+    cache.splice(cache.end(), cache, it);
+  }
+
+  if (!it->manager || it->version != version.load(std::memory_order_acquire))
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    it->version = version.load(std::memory_order_relaxed);
+    it->manager = source->clone();
+  }
+  return it->manager;
+}
+}  // namespace
+
 CollisionEnvBullet::CollisionEnvBullet(const moveit::core::RobotModelConstPtr& model, double padding, double scale)
-  : CollisionEnv(model, padding, scale)
+  : CollisionEnv(model, padding, scale), manager_id_(next_manager_id++)
 {
   // request notifications about changes to new world
   observer_handle_ = getWorld()->addObserver(
@@ -65,7 +114,7 @@ CollisionEnvBullet::CollisionEnvBullet(const moveit::core::RobotModelConstPtr& m
 
 CollisionEnvBullet::CollisionEnvBullet(const moveit::core::RobotModelConstPtr& model, const WorldPtr& world,
                                        double padding, double scale)
-  : CollisionEnv(model, world, padding, scale)
+  : CollisionEnv(model, world, padding, scale), manager_id_(next_manager_id++)
 {
   // request notifications about changes to new world
   observer_handle_ = getWorld()->addObserver(
@@ -80,7 +129,7 @@ CollisionEnvBullet::CollisionEnvBullet(const moveit::core::RobotModelConstPtr& m
 }
 
 CollisionEnvBullet::CollisionEnvBullet(const CollisionEnvBullet& other, const WorldPtr& world)
-  : CollisionEnv(other, world)
+  : CollisionEnv(other, world), manager_id_(next_manager_id++)
 {
   // request notifications about changes to new world
   observer_handle_ = getWorld()->addObserver(
@@ -117,34 +166,36 @@ void CollisionEnvBullet::checkSelfCollisionHelper(const CollisionRequest& req, C
                                                   const moveit::core::RobotState& state,
                                                   const AllowedCollisionMatrix* acm) const
 {
-  std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  std::unique_lock<std::mutex> lock(collision_env_mutex_, std::try_to_lock);
+  const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager =
+      lock.owns_lock() ? manager_ : getThreadManager();
 
   std::vector<collision_detection_bullet::CollisionObjectWrapperPtr> cows;
   addAttachedObjects(state, cows);
 
   if (req.distance)
   {
-    manager_->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
+    manager->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
   }
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : cows)
   {
-    manager_->addCollisionObject(cow);
-    manager_->setCollisionObjectsTransform(
+    manager->addCollisionObject(cow);
+    manager->setCollisionObjectsTransform(
         cow->getName(), state.getAttachedBody(cow->getName())->getGlobalCollisionBodyTransforms()[0]);
   }
 
   // updating link positions with the current robot state
   for (const std::string& link : active_)
   {
-    manager_->setCollisionObjectsTransform(link, state.getCollisionBodyTransform(link, 0));
+    manager->setCollisionObjectsTransform(link, state.getCollisionBodyTransform(link, 0));
   }
 
-  manager_->contactTest(res, req, acm, true);
+  manager->contactTest(res, req, acm, true);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : cows)
   {
-    manager_->removeCollisionObject(cow->getName());
+    manager->removeCollisionObject(cow->getName());
   }
 }
 
@@ -180,29 +231,102 @@ void CollisionEnvBullet::checkRobotCollisionHelper(const CollisionRequest& req,
                                                    const moveit::core::RobotState& state,
                                                    const AllowedCollisionMatrix* acm) const
 {
-  std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  std::unique_lock<std::mutex> lock(collision_env_mutex_, std::try_to_lock);
+  const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager =
+      lock.owns_lock() ? manager_ : getThreadManager();
+
+  if (req.distance)
+  {
+    manager->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
+  }
+
+  std::vector<collision_detection_bullet::CollisionObjectWrapperPtr> attached_cows;
+  addAttachedObjects(state, attached_cows);
+  updateTransformsFromState(state, manager);
+
+  for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
+  {
+    manager->addCollisionObject(cow);
+    manager->setCollisionObjectsTransform(
+        cow->getName(), state.getAttachedBody(cow->getName())->getGlobalCollisionBodyTransforms()[0]);
+  }
+
+  manager->contactTest(res, req, acm, false);
+
+  for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
+  {
+    manager->removeCollisionObject(cow->getName());
+  }
+}
+
+std::size_t CollisionEnvBullet::checkCollisionBatchHelper(const CollisionRequest& req,
+                                                          const std::vector<const moveit::core::RobotState*>& states,
+                                                          std::vector<CollisionResult>& results,
+                                                          const AllowedCollisionMatrix* acm,
+                                                          bool stop_at_first_collision) const
+{
+  results.resize(states.size());
+  for (CollisionResult& res : results)
+    res.clear();
+
+  CollisionBatchScheduler scheduler(states.size(), stop_at_first_collision);
+  const std::size_t thread_count = std::min(getBatchThreadCount(), states.size());
+  if (thread_count <= 1)
+  {
+    // lock the manager once for the whole batch instead of twice per state
+    std::lock_guard<std::mutex> guard(collision_env_mutex_);
+    std::size_t index;
+    while (scheduler.next(index))
+    {
+      checkBatchStateCollision(req, results[index], *states[index], acm, manager_);
+      if (results[index].collision)
+        scheduler.reportCollision(index);
+    }
+    return scheduler.getFirstCollision();
+  }
 
+  CollisionBatchScheduler::run(thread_count, [&] {
+    // the bullet manager is not thread-safe, so every thread works on its own copy
+    const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager = getThreadManager();
+    std::size_t index;
+    while (scheduler.next(index))
+    {
+      checkBatchStateCollision(req, results[index], *states[index], acm, manager);
+      if (results[index].collision)
+        scheduler.reportCollision(index);
+    }
+  });
+  return scheduler.getFirstCollision();
+}
+
+void CollisionEnvBullet::checkBatchStateCollision(
+    const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
+    const AllowedCollisionMatrix* acm, const collision_detection_bullet::BulletDiscreteBVHManagerPtr& manager) const
+{
   if (req.distance)
   {
-    manager_->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
+    manager->setContactDistanceThreshold(MAX_DISTANCE_MARGIN);
   }
 
   std::vector<collision_detection_bullet::CollisionObjectWrapperPtr> attached_cows;
   addAttachedObjects(state, attached_cows);
-  updateTransformsFromState(state, manager_);
+  updateTransformsFromState(state, manager);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
   {
-    manager_->addCollisionObject(cow);
-    manager_->setCollisionObjectsTransform(
+    manager->addCollisionObject(cow);
+    manager->setCollisionObjectsTransform(
         cow->getName(), state.getAttachedBody(cow->getName())->getGlobalCollisionBodyTransforms()[0]);
   }
 
-  manager_->contactTest(res, req, acm, false);
+  // self collisions first, then collisions with the world, as CollisionEnv::checkCollision() does
+  manager->contactTest(res, req, acm, true);
+  if (!res.collision || (req.contacts && res.contacts.size() < req.max_contacts))
+    manager->contactTest(res, req, acm, false);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
   {
-    manager_->removeCollisionObject(cow->getName());
+    manager->removeCollisionObject(cow->getName());
   }
 }
 
@@ -211,33 +335,45 @@ void CollisionEnvBullet::checkRobotCollisionHelperCCD(const CollisionRequest& re
                                                       const moveit::core::RobotState& state2,
                                                       const AllowedCollisionMatrix* acm) const
 {
-  std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  std::unique_lock<std::mutex> lock(collision_env_mutex_, std::try_to_lock);
+  const collision_detection_bullet::BulletCastBVHManagerPtr& manager_CCD =
+      lock.owns_lock() ? manager_CCD_ : getThreadCastManager();
 
   std::vector<collision_detection_bullet::CollisionObjectWrapperPtr> attached_cows;
   addAttachedObjects(state1, attached_cows);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
   {
-    manager_CCD_->addCollisionObject(cow);
-    manager_CCD_->setCastCollisionObjectsTransform(
+    manager_CCD->addCollisionObject(cow);
+    manager_CCD->setCastCollisionObjectsTransform(
         cow->getName(), state1.getAttachedBody(cow->getName())->getGlobalCollisionBodyTransforms()[0],
         state2.getAttachedBody(cow->getName())->getGlobalCollisionBodyTransforms()[0]);
   }
 
   for (const std::string& link : active_)
   {
-    manager_CCD_->setCastCollisionObjectsTransform(link, state1.getCollisionBodyTransform(link, 0),
-                                                   state2.getCollisionBodyTransform(link, 0));
+    manager_CCD->setCastCollisionObjectsTransform(link, state1.getCollisionBodyTransform(link, 0),
+                                                  state2.getCollisionBodyTransform(link, 0));
   }
 
-  manager_CCD_->contactTest(res, req, acm, false);
+  manager_CCD->contactTest(res, req, acm, false);
 
   for (const collision_detection_bullet::CollisionObjectWrapperPtr& cow : attached_cows)
   {
-    manager_CCD_->removeCollisionObject(cow->getName());
+    manager_CCD->removeCollisionObject(cow->getName());
   }
 }
 
+const collision_detection_bullet::BulletDiscreteBVHManagerPtr& CollisionEnvBullet::getThreadManager() const
+{
+  return getThreadCopy(manager_id_, manager_version_, collision_env_mutex_, manager_);
+}
+
+const collision_detection_bullet::BulletCastBVHManagerPtr& CollisionEnvBullet::getThreadCastManager() const
+{
+  return getThreadCopy(manager_id_, manager_version_, collision_env_mutex_, manager_CCD_);
+}
+
 void CollisionEnvBullet::distanceSelf(const DistanceRequest& /*req*/, DistanceResult& /*res*/,
                                       const moveit::core::RobotState& /*state*/) const
 {
@@ -330,6 +466,7 @@ void CollisionEnvBullet::notifyObjectChange(const ObjectConstPtr& obj, World::Ac
   {
     updateManagedObject(obj->id_);
   }
+  ++manager_version_;
 }
 
 void CollisionEnvBullet::addAttachedObjects(const moveit::core::RobotState& state,
@@ -362,6 +499,8 @@ void CollisionEnvBullet::addAttachedObjects(const moveit::core::RobotState& stat
 
 void CollisionEnvBullet::updatedPaddingOrScaling(const std::vector<std::string>& links)
 {
+  std::lock_guard<std::mutex> guard(collision_env_mutex_);
+  ++manager_version_;
   for (const std::string& link : links)
   {
     if (robot_model_->getURDF()->links_.find(link) != robot_model_->getURDF()->links_.end())
@@ -52,12 +52,15 @@
 #include <fcl/distance.h>
 #endif
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <set>
 
 namespace collision_detection
 {
 MOVEIT_STRUCT_FORWARD(CollisionGeometryData);
+class FCLMeshLODs;
 
 /** \brief Wrapper around world, link and attached objects' geometry data. */
 struct CollisionGeometryData
@@ -112,6 +115,12 @@ struct CollisionGeometryData
     return "Object";
   }
 
+  /** \brief Returns the index of getID() in \e acm, memoized for the view most recently used with this object. */
+  int getACMIndex(const CompiledAllowedCollisionMatrix& acm) const
+  {
+    return acm.getIndex(getID(), acm_index);
+  }
+
   /** \brief Check if two CollisionGeometryData objects point to the same source object. */
   bool sameObject(const CollisionGeometryData& other) const
   {
@@ -135,6 +144,12 @@ struct CollisionGeometryData
     const World::Object* obj;
     const void* raw;
   } ptr;
+
+  /** \brief The cache used by getACMIndex() */
+  mutable std::atomic<std::uint64_t> acm_index{ 0 };
+
+  /** \brief The coarser levels of detail of the geometry, for meshes only */
+  std::shared_ptr<const FCLMeshLODs> mesh_lods;
 };
 
 /** \brief Data structure which is passed to the collision callback function of the collision manager. */
@@ -145,7 +160,12 @@ struct CollisionData
   }
 
   CollisionData(const CollisionRequest* req, CollisionResult* res, const AllowedCollisionMatrix* acm)
-    : req_(req), active_components_only_(nullptr), res_(res), acm_(acm), done_(false)
+    : req_(req)
+    , active_components_only_(nullptr)
+    , res_(res)
+    , acm_(acm)
+    , compiled_acm_(acm ? acm->getCompiled() : nullptr)
+    , done_(false)
   {
   }
 
@@ -171,6 +191,9 @@ struct CollisionData
   /** \brief The user-specified collision matrix (may be nullptr). */
   const AllowedCollisionMatrix* acm_;
 
+  /** \brief The index-based view of \e acm_ used for the lookups in the collision callback (nullptr if acm_ is). */
+  CompiledAllowedCollisionMatrixConstPtr compiled_acm_;
+
   /** \brief Flag indicating whether collision checking is complete. */
   bool done_;
 };
@@ -178,7 +201,8 @@ struct CollisionData
 /** \brief Data structure which is passed to the distance callback function of the collision manager. */
 struct DistanceData
 {
-  DistanceData(const DistanceRequest* req, DistanceResult* res) : req(req), res(res), done(false)
+  DistanceData(const DistanceRequest* req, DistanceResult* res)
+    : req(req), res(res), compiled_acm(req->acm ? req->acm->getCompiled() : nullptr), done(false)
   {
   }
   ~DistanceData()
@@ -191,6 +215,9 @@ struct DistanceData
   /** \brief Distance query results information. */
   DistanceResult* res;
 
+  /** \brief The index-based view of the collision matrix in \e req (nullptr if there is none). */
+  CompiledAllowedCollisionMatrixConstPtr compiled_acm;
+
   /** \brief Indicates if distance query is finished. */
   bool done;
 };
@@ -238,7 +265,11 @@ struct FCLGeometry
       if (collision_geometry_data_->ptr.raw == reinterpret_cast<const void*>(data))
         return;
     }
+    std::shared_ptr<const FCLMeshLODs> mesh_lods;
+    if (collision_geometry_data_)
+      mesh_lods = collision_geometry_data_->mesh_lods;
     collision_geometry_data_ = std::make_shared<CollisionGeometryData>(data, shape_index);
+    collision_geometry_data_->mesh_lods = std::move(mesh_lods);
     collision_geometry_->setUserData(collision_geometry_data_.get());
   }
 
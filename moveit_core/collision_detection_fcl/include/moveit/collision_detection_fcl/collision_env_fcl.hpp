@@ -38,6 +38,7 @@
 
 #include <moveit/collision_detection/collision_env.hpp>
 #include <moveit/collision_detection_fcl/collision_common.hpp>
+#include <moveit/collision_detection/collision_batch.hpp>
 
 #if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
 #include <fcl/broadphase/broadphase_collision_manager.h>
@@ -45,6 +46,7 @@
 #include <fcl/broadphase/broadphase.h>
 #endif
 
+#include <cstdint>
 #include <memory>
 
 namespace collision_detection
@@ -90,6 +92,14 @@ public:
 
   void setWorld(const WorldPtr& world) override;
 
+  /** \brief Split the self-collision check of states with at least \e min_object_count collision objects (links and
+   *   attached bodies) over a pool of \e thread_count threads. A thread count of 1, the default, checks serially.
+   *   Copies of this environment share the pool; a check finding the pool in use falls back to the serial check. */
+  void setSelfCollisionThreadCount(std::size_t thread_count, std::size_t min_object_count = 32);
+
+  /** \brief The number of threads a self-collision check is split over */
+  std::size_t getSelfCollisionThreadCount() const;
+
 protected:
   /** \brief Updates the FCL collision geometry and objects saved in the CollisionRobotFCL members to reflect a new
    *   padding or scaling of the robot links.
@@ -104,10 +114,31 @@ protected:
   void checkSelfCollisionHelper(const CollisionRequest& req, CollisionResult& res,
                                 const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm) const;
 
+  std::size_t checkCollisionBatchHelper(const CollisionRequest& req,
+                                        const std::vector<const moveit::core::RobotState*>& states,
+                                        std::vector<CollisionResult>& results, const AllowedCollisionMatrix* acm,
+                                        bool stop_at_first_collision) const override;
+
   /** \brief Bundles the different checkRobotCollision functions into a single function */
   void checkRobotCollisionHelper(const CollisionRequest& req, CollisionResult& res,
                                  const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm) const;
 
+  /** \brief Bundles the continuous checkRobotCollision functions into a single function. The robot links and attached
+   *   bodies moving from \e state1 to \e state2 are checked against the world with FCL's continuous collision check;
+   *   contacts report the time of contact as their percent_interpolation. Self collisions are not checked. */
+  void checkRobotCollisionHelperCCD(const CollisionRequest& req, CollisionResult& res,
+                                    const moveit::core::RobotState& state1, const moveit::core::RobotState& state2,
+                                    const AllowedCollisionMatrix* acm) const;
+
+  /** \brief Get the objects of the robot link or attached body \e name among \e links and \e attached */
+  void findRobotObjects(const FCLObject& links, const FCLObject& attached, const std::string& name,
+                        std::vector<fcl::CollisionObjectd*>& objects) const;
+
+  /** \brief Compute the distances of all pairs of objects from \e objects1 and \e objects2 into \e data, before the
+   *   broadphase search, so the search starts bounded by these distances */
+  void evaluateDistances(DistanceData& data, const std::vector<fcl::CollisionObjectd*>& objects1,
+                         const std::vector<fcl::CollisionObjectd*>& objects2) const;
+
   /** \brief Construct an FCL collision object from MoveIt's World::Object. */
   void constructFCLObjectWorld(const World::Object* obj, FCLObject& fcl_obj) const;
 
@@ -116,6 +147,10 @@ protected:
    *  If it does not exist in world, it is deleted. If it's not existing in \m fcl_objs_ yet, it's added there. */
   void updateFCLObject(const std::string& id);
 
+  /** \brief Makes sure that \m fcl_objs_ and \m manager_ are not shared with copies of this environment before they
+   *  are changed. The FCL collision objects themselves stay shared until they are moved. */
+  void ensureUniqueWorldObjects();
+
   /** \brief Out of the current robot state and its attached bodies construct an FCLObject which can then be used to
    *   check for collision.
    *
@@ -126,10 +161,40 @@ protected:
    *   \param fcl_obj The newly filled object */
   void constructFCLObjectRobot(const moveit::core::RobotState& state, FCLObject& fcl_obj) const;
 
+  /** \brief Construct the FCL collision objects for the robot links only, without the attached bodies */
+  void constructFCLObjectRobotLinks(const moveit::core::RobotState& state, FCLObject& fcl_obj) const;
+
+  /** \brief Move the objects created by constructFCLObjectRobotLinks() to the link transforms of \e state.
+   *   Only objects whose transform differs from the one recorded in \e transforms are moved: \e transforms is updated
+   *   for them and they are returned in \e changed. */
+  void updateFCLObjectRobotLinks(const moveit::core::RobotState& state, FCLObject& fcl_obj,
+                                 EigenSTL::vector_Isometry3d& transforms,
+                                 std::vector<fcl::CollisionObjectd*>& changed) const;
+
+  /** \brief Construct the FCL collision objects for the bodies attached to the robot in \e state */
+  void constructFCLObjectAttachedBodies(const moveit::core::RobotState& state, FCLObject& fcl_obj) const;
+
   /** \brief Prepares for the collision check through constructing an FCL collision object out of the current robot
    *   state and specifying a broadphase collision manager of FCL where the constructed object is registered to. */
   void allocSelfCollisionBroadPhase(const moveit::core::RobotState& state, FCLManager& manager) const;
 
+  /** \brief Get the calling thread's broadphase manager holding the robot links of this environment, with the links
+   *   moved to their transforms in \e state. The manager is built on the first call on a thread and kept for later
+   *   calls, which only update the links that moved. Attached bodies are not part of it, callers register them for
+   *   the duration of a check. */
+  FCLManager& getRobotManager(const moveit::core::RobotState& state) const;
+
+  /** \brief Check the objects in \e manager for collisions among each other, in parallel if configured */
+  void collideSelf(const CollisionRequest& req, CollisionResult& res, const AllowedCollisionMatrix* acm,
+                   FCLManager& manager) const;
+
+  /** \brief Split the self-collision check of \e manager over the thread pool. Returns false if the pool is busy. */
+  bool collideSelfParallel(CollisionData& cd, FCLManager& manager) const;
+
+  /** \brief Check the robot \e links and \e attached bodies for collisions with the world */
+  void collideWorld(const CollisionRequest& req, CollisionResult& res, const AllowedCollisionMatrix* acm,
+                    const FCLObject& links, const FCLObject& attached) const;
+
   /** \brief Converts all shapes which make up an attached body into a vector of FCLGeometryConstPtr.
    *
    *   When they are converted, they can be added to the FCL representation of the robot for collision checking.
@@ -146,9 +211,19 @@ protected:
   std::vector<FCLCollisionObjectConstPtr> robot_fcl_objs_;
 
   /// FCL collision manager which handles the collision checking process
-  std::unique_ptr<fcl::BroadPhaseCollisionManagerd> manager_;
+  std::shared_ptr<fcl::BroadPhaseCollisionManagerd> manager_;
+
+  /// FCL objects of the world objects. Copies of this environment share them and \m manager_ until either changes.
+  std::shared_ptr<std::map<std::string, FCLObject>> fcl_objs_;
+
+  /** \brief Identifies the robot link objects of this environment in the thread-local managers of getRobotManager() */
+  std::uint64_t robot_manager_id_;
+
+  /** \brief Threads for parallel self-collision checks, nullptr when checking serially */
+  std::shared_ptr<CollisionThreadPool> self_collision_pool_;
 
-  std::map<std::string, FCLObject> fcl_objs_;
+  /** \brief The minimum number of collision objects for a parallel self-collision check */
+  std::size_t parallel_min_object_count_ = 32;
 
 private:
   /** \brief Callback function executed for each change to the world environment */
@@ -0,0 +1,69 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/collision_detection/collision_common.hpp>
+#include <moveit/collision_detection_fcl/fcl_compat.hpp>
+#include <geometric_shapes/shapes.h>
+
+#include <array>
+#include <memory>
+#include <mutex>
+
+namespace collision_detection
+{
+/** \brief The coarser levels of detail of the FCL geometry of a mesh, see CollisionRequest::mesh_lod.
+
+    The geometry of a level is built from createMeshLOD() when a check first asks for it. */
+class FCLMeshLODs
+{
+public:
+  /** \brief Constructor for the levels of \e mesh, which must be the (scaled and padded) mesh of the exact geometry */
+  explicit FCLMeshLODs(const shapes::ShapeConstPtr& mesh);
+
+  /** \brief Get the geometry of level \e lod. Returns nullptr for MeshLODs::EXACT, or if the level could not be
+   * created; the exact geometry is checked then. */
+  const fcl::CollisionGeometryd* getGeometry(MeshLOD lod) const;
+
+private:
+  static constexpr std::size_t LOD_COUNT = 2;
+
+  shapes::ShapeConstPtr mesh_;
+
+  // index i holds the level MeshLOD(i + 1)
+  mutable std::array<std::once_flag, LOD_COUNT> once_;
+  mutable std::array<std::shared_ptr<fcl::CollisionGeometryd>, LOD_COUNT> geometries_;
+};
+}  // namespace collision_detection
@@ -0,0 +1,112 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/collision_detection_fcl/fcl_compat.hpp>
+
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+#include <fcl/geometry/octree/octree.h>
+#include <fcl/narrowphase/collision_object.h>
+#include <fcl/narrowphase/collision_request.h>
+#include <fcl/narrowphase/collision_result.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace collision_detection
+{
+class OccMapTree;
+
+/** \brief An FCL octree that keeps its occupied cells in a flat, coarse-to-fine hierarchy of boxes as well.
+
+    Discrete collision checks through collide() visit only the occupied cells that overlap the checked object, one
+    level at a time, without walking the octomap nodes. They can stop descending at a coarser level than the leaves of
+    the map; a cell checked there counts as occupied as a whole, which is conservative.
+
+    The hierarchy is built on the first check. If the octree is an OccMapTree, it is built again once the map announced
+    an update through OccMapTree::triggerUpdateCallback(); other octrees are expected not to change. Distance and
+    continuous checks use the FCL octree as before. */
+class FCLOcTreeHierarchy : public fcl::OcTreed
+{
+public:
+  explicit FCLOcTreeHierarchy(const std::shared_ptr<const octomap::OcTree>& tree);
+
+  /** \brief Get the depth of the smallest cells that are no smaller than \e resolution. A resolution of 0 gives the
+   * depth of the leaves. */
+  unsigned int getDepth(double resolution) const;
+
+  /** \brief Collide \e object with this octree placed at \e tree_pose, like fcl::collide() would. The octree is the
+   * first object of the contacts if \e tree_first is true. \e geometry is checked in place of the geometry of
+   * \e object, e.g. a coarser level of detail of it. Cells at \e depth are checked as boxes, without descending
+   * further. Cost sources are not computed. Returns the number of contacts in \e result. */
+  std::size_t collide(const fcl::CollisionObjectd& object, const fcl::CollisionGeometryd& geometry,
+                      const fcl::Transform3d& tree_pose, bool tree_first, const fcl::CollisionRequestd& request,
+                      fcl::CollisionResultd& result, unsigned int depth) const;
+
+private:
+  struct Cell
+  {
+    Eigen::Vector3d center;
+    std::uint32_t first_child;
+    // 0 for occupied leaves
+    std::uint32_t child_count;
+  };
+
+  struct Levels
+  {
+    std::uint64_t update_count;
+    // cells[d] holds the occupied cells of depth d; the children of a cell are contiguous in cells[d + 1]
+    std::vector<std::vector<Cell>> cells;
+  };
+
+  /** \brief Get the hierarchy of the current map, building it if needed */
+  std::shared_ptr<const Levels> getLevels() const;
+
+  /** \brief Add the occupied children of \e node to \e cells and return whether \e node contains an occupied leaf */
+  bool addCell(const octomap::OcTreeNode* node, unsigned int depth, std::vector<std::vector<Cell>>& cells,
+               Cell& cell) const;
+
+  std::shared_ptr<const octomap::OcTree> octree_;
+
+  // the map if the octree is an OccMapTree, nullptr otherwise
+  const OccMapTree* map_;
+
+  mutable std::mutex levels_mutex_;
+  mutable std::shared_ptr<const Levels> levels_;
+};
+}  // namespace collision_detection
+#endif
@@ -37,6 +37,8 @@
 #include <moveit/collision_detection_fcl/collision_common.hpp>
 #include <geometric_shapes/shapes.h>
 #include <moveit/collision_detection_fcl/fcl_compat.hpp>
+#include <moveit/collision_detection_fcl/fcl_mesh_lod.hpp>
+#include <moveit/collision_detection_fcl/fcl_octree_hierarchy.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <moveit/utils/logger.hpp>
@@ -50,6 +52,10 @@
 #include <fcl/octree.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
 #include <memory>
 #include <type_traits>
 #include <mutex>
@@ -62,6 +68,86 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.moveit_collision_detection_fcl");
 }
+
+// Pairs of objects farther apart than this cannot change the result of a distance query. The broadphase prunes the
+// objects whose bounding boxes are farther away; penetrating objects stay visible to signed distance queries.
+double getDistanceBound(const DistanceData& data)
+{
+  double bound = data.req->distance_threshold;
+  if (data.req->type == DistanceRequestType::GLOBAL)
+    bound = std::min(bound, data.res->minimum_distance.distance);
+  return std::max(bound, std::numeric_limits<double>::epsilon());
+}
+
+// The geometry of \e object to check at level of detail \e lod
+const fcl::CollisionGeometryd* getGeometry(const fcl::CollisionObjectd* object, MeshLOD lod)
+{
+  const fcl::CollisionGeometryd* geometry = object->collisionGeometry().get();
+  if (lod != MeshLODs::EXACT)
+  {
+    const CollisionGeometryData* cgd = static_cast<const CollisionGeometryData*>(geometry->getUserData());
+    if (cgd && cgd->mesh_lods)
+    {
+      if (const fcl::CollisionGeometryd* lod_geometry = cgd->mesh_lods->getGeometry(lod))
+        return lod_geometry;
+    }
+  }
+  return geometry;
+}
+
+// Collide two objects like fcl::collide(). Octrees are checked through their box hierarchy and meshes at the level of
+// detail asked for by the request, unless cost sources are computed.
+std::size_t collideObjects(const fcl::CollisionObjectd* o1, const fcl::CollisionObjectd* o2,
+                           const fcl::CollisionRequestd& request, fcl::CollisionResultd& result,
+                           const CollisionRequest& req)
+{
+  if (request.enable_cost)
+    return fcl::collide(o1, o2, request, result);
+
+  const fcl::CollisionGeometryd* g1 = getGeometry(o1, req.mesh_lod);
+  const fcl::CollisionGeometryd* g2 = getGeometry(o2, req.mesh_lod);
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+  if ((o1->getObjectType() == fcl::OT_OCTREE) != (o2->getObjectType() == fcl::OT_OCTREE))
+  {
+    const bool tree_first = o1->getObjectType() == fcl::OT_OCTREE;
+    const fcl::CollisionObjectd* tree = tree_first ? o1 : o2;
+    if (const auto* hierarchy = dynamic_cast<const FCLOcTreeHierarchy*>(tree->collisionGeometry().get()))
+    {
+      return hierarchy->collide(tree_first ? *o2 : *o1, tree_first ? *g2 : *g1, tree->getTransform(), tree_first,
+                                request, result, hierarchy->getDepth(req.octree_resolution));
+    }
+  }
+#endif
+  if (g1 == o1->collisionGeometry().get() && g2 == o2->collisionGeometry().get())
+    return fcl::collide(o1, o2, request, result);
+
+  // the contacts refer to the objects instead of their levels of detail
+  fcl::CollisionResultd lod_result;
+  fcl::collide(g1, o1->getTransform(), g2, o2->getTransform(), request, lod_result);
+  for (std::size_t i = 0; i < lod_result.numContacts(); ++i)
+  {
+    fcl::Contactd contact = lod_result.getContact(i);
+    contact.o1 = o1->collisionGeometry().get();
+    contact.o2 = o2->collisionGeometry().get();
+    result.addContact(contact);
+  }
+  return result.numContacts();
+}
+
+// Like collideObjects(), adding the call and its duration to \e statistics, if any
+std::size_t collideObjects(const fcl::CollisionObjectd* o1, const fcl::CollisionObjectd* o2,
+                           const fcl::CollisionRequestd& request, fcl::CollisionResultd& result,
+                           const CollisionRequest& req, CollisionPairStatistics* statistics)
+{
+  if (!statistics)
+    return collideObjects(o1, o2, request, result, req);
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::size_t num_contacts = collideObjects(o1, o2, request, result, req);
+  ++statistics->narrowphase_calls;
+  statistics->narrowphase_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return num_contacts;
+}
 }  // namespace
 
 bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data)
@@ -76,6 +162,15 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
   if (cd1->sameObject(*cd2))
     return false;
 
+  CollisionPairStatistics* statistics = nullptr;
+  if (cdata->req_->profile)
+  {
+    const std::string& id1 = cd1->getID();
+    const std::string& id2 = cd2->getID();
+    statistics = &cdata->res_->pair_statistics[id1 < id2 ? std::make_pair(id1, id2) : std::make_pair(id2, id1)];
+    ++statistics->broadphase_candidates;
+  }
+
   // If active components are specified
   if (cdata->active_components_only_)
   {
@@ -100,7 +195,8 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
   if (cdata->acm_)
   {
     AllowedCollision::Type type;
-    bool found = cdata->acm_->getAllowedCollision(cd1->getID(), cd2->getID(), type);
+    bool found = cdata->compiled_acm_->getAllowedCollision(cd1->getACMIndex(*cdata->compiled_acm_),
+                                                           cd2->getACMIndex(*cdata->compiled_acm_), type);
     if (found)
     {
       // if we have an entry in the collision matrix, we read it
@@ -204,10 +300,10 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
     std::size_t num_max_cost_sources = cdata->req_->max_cost_sources;
     bool enable_contact = true;
     fcl::CollisionResultd col_result;
-    int num_contacts = fcl::collide(o1, o2,
-                                    fcl::CollisionRequestd(std::numeric_limits<size_t>::max(), enable_contact,
-                                                           num_max_cost_sources, enable_cost),
-                                    col_result);
+    int num_contacts = collideObjects(o1, o2,
+                                      fcl::CollisionRequestd(std::numeric_limits<size_t>::max(), enable_contact,
+                                                             num_max_cost_sources, enable_cost),
+                                      col_result, *cdata->req_, statistics);
     if (num_contacts > 0)
     {
       if (cdata->req_->verbose)
@@ -280,9 +376,9 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
 
       fcl::CollisionResultd col_result;
       int num_contacts =
-          fcl::collide(o1, o2,
-                       fcl::CollisionRequestd(want_contact_count, enable_contact, num_max_cost_sources, enable_cost),
-                       col_result);
+          collideObjects(o1, o2,
+                         fcl::CollisionRequestd(want_contact_count, enable_contact, num_max_cost_sources, enable_cost),
+                         col_result, *cdata->req_, statistics);
       if (num_contacts > 0)
       {
         int num_contacts_initial = num_contacts;
@@ -341,8 +437,9 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
       std::size_t num_max_cost_sources = cdata->req_->max_cost_sources;
       bool enable_contact = false;
       fcl::CollisionResultd col_result;
-      int num_contacts = fcl::collide(
-          o1, o2, fcl::CollisionRequestd(1, enable_contact, num_max_cost_sources, enable_cost), col_result);
+      int num_contacts =
+          collideObjects(o1, o2, fcl::CollisionRequestd(1, enable_contact, num_max_cost_sources, enable_cost),
+                         col_result, *cdata->req_, statistics);
       if (num_contacts > 0)
       {
         cdata->res_->collision = true;
@@ -449,9 +546,10 @@ struct FCLShapeCache
   unsigned int clean_count_;
 };
 
-bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data, double& /*min_dist*/)
+bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data, double& min_dist)
 {
   DistanceData* cdata = reinterpret_cast<DistanceData*>(data);
+  min_dist = getDistanceBound(*cdata);
 
   const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->collisionGeometry()->getUserData());
   const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->collisionGeometry()->getUserData());
@@ -482,10 +580,11 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
 
   // use the collision matrix (if any) to avoid certain distance checks
   bool always_allow_collision = false;
-  if (cdata->req->acm)
+  if (cdata->compiled_acm)
   {
     AllowedCollision::Type type;
-    bool found = cdata->req->acm->getAllowedCollision(cd1->getID(), cd2->getID(), type);
+    bool found = cdata->compiled_acm->getAllowedCollision(cd1->getACMIndex(*cdata->compiled_acm),
+                                                          cd2->getACMIndex(*cdata->compiled_acm), type);
     if (found)
     {
       // if we have an entry in the collision matrix, we read it
@@ -581,7 +680,10 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
   {
     return false;
   }
-  double distance = fcl::distance(o1, o2, fcl::DistanceRequestd(cdata->req->enable_nearest_points), fcl_result);
+  fcl::DistanceRequestd fcl_request(cdata->req->enable_nearest_points);
+  fcl_request.rel_err = cdata->req->relative_error;
+  fcl_request.abs_err = cdata->req->absolute_error;
+  double distance = fcl::distance(o1, o2, fcl_request, fcl_result);
 
   // Check if either object is already in the map. If not add it or if present
   // check to see if the new distance is closer. If closer remove the existing
@@ -716,6 +818,7 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
     }
   }
 
+  min_dist = getDistanceBound(*cdata);
   return cdata->done;
 }
 
@@ -738,6 +841,56 @@ FCLShapeCache& getShapeCache()
   return cache;
 }
 
+/** \brief Process-wide registry of the BVH models built for meshes, keyed by the mesh.
+ *
+ * FCL geometries store the identity of the object they belong to, so they cannot be shared between the links of
+ * different robot models (which share their meshes, see moveit::core::MeshCache) or between the thread-local shape
+ * caches. Fitting the bounding volume hierarchy is the expensive part of creating the geometry of a mesh though, so
+ * new geometries are copied from an existing one for the same mesh whenever possible. Only weak references are kept,
+ * the registry does not extend the lifetime of any geometry. */
+template <typename BV>
+class MeshBVHRegistry
+{
+public:
+  static MeshBVHRegistry& getInstance()
+  {
+    static MeshBVHRegistry registry;
+    return registry;
+  }
+
+  /** \brief A copy of a BVH model built earlier for \e shape, or nullptr if there is none */
+  fcl::BVHModel<BV>* copy(const shapes::ShapeConstPtr& shape)
+  {
+    std::shared_ptr<const fcl::CollisionGeometryd> model;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = models_.find(shapes::ShapeConstWeakPtr(shape));
+      if (it != models_.end())
+        model = it->second.lock();
+    }
+    return model ? new fcl::BVHModel<BV>(static_cast<const fcl::BVHModel<BV>&>(*model)) : nullptr;
+  }
+
+  void add(const shapes::ShapeConstPtr& shape, const std::shared_ptr<const fcl::CollisionGeometryd>& model)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = models_.begin(); it != models_.end();)
+    {
+      if (it->first.expired() || it->second.expired())
+        it = models_.erase(it);
+      else
+        ++it;
+    }
+    models_[shapes::ShapeConstWeakPtr(shape)] = model;
+  }
+
+private:
+  using ShapeKey = shapes::ShapeConstWeakPtr;
+
+  std::mutex mutex_;
+  std::map<ShapeKey, std::weak_ptr<const fcl::CollisionGeometryd>, std::owner_less<ShapeKey>> models_;
+};
+
 /** \brief Templated helper function creating new collision geometry out of general object using an arbitrary bounding
  *  volume (BV).
  *
@@ -880,6 +1033,10 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
     break;
     case shapes::MESH:
     {
+      cg_g = MeshBVHRegistry<BV>::getInstance().copy(shape);
+      if (cg_g)
+        break;
+
       auto g = new fcl::BVHModel<BV>();
       const shapes::Mesh* mesh = static_cast<const shapes::Mesh*>(shape.get());
       if (mesh->vertex_count > 0 && mesh->triangle_count > 0)
@@ -905,7 +1062,11 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
     case shapes::OCTREE:
     {
       const shapes::OcTree* g = static_cast<const shapes::OcTree*>(shape.get());
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+      cg_g = new FCLOcTreeHierarchy(g->octree);
+#else
       cg_g = new fcl::OcTreed(g->octree);
+#endif
     }
     break;
     default:
@@ -919,6 +1080,11 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
     FCLGeometryConstPtr res = std::make_shared<const FCLGeometry>(cg_g, data, shape_index);
     cache.map_[wptr] = res;
     cache.bumpUseCount();
+    if (shape->type == shapes::MESH)
+    {
+      MeshBVHRegistry<BV>::getInstance().add(shape, res->collision_geometry_);
+      res->collision_geometry_data_->mesh_lods = std::make_shared<const FCLMeshLODs>(shape);
+    }
     return res;
   }
   return FCLGeometryConstPtr();
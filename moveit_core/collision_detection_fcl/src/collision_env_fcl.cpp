@@ -42,9 +42,14 @@
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
+#include <limits>
+#include <list>
 
 #if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
 #include <fcl/broadphase/broadphase_dynamic_AABB_tree.h>
+#include <fcl/geometry/shape/box.h>
+#include <fcl/narrowphase/continuous_collision.h>
 #endif
 
 namespace collision_detection
@@ -58,6 +63,22 @@ rclcpp::Logger getLogger()
   return moveit::getLogger("moveit.core.collision_detection_fcl");
 }
 
+// Identifies the robot geometry of an environment in the thread-local manager caches, see getRobotManager()
+std::atomic<std::uint64_t> next_robot_manager_id{ 1 };
+
+// The number of environments a thread keeps a robot manager for
+constexpr std::size_t MAX_CACHED_ROBOT_MANAGERS = 4;
+
+// A thread's broadphase manager for the robot links of one environment, see CollisionEnvFCL::getRobotManager()
+struct CachedRobotManager
+{
+  std::uint64_t id;
+  FCLManager manager;
+
+  // The link transforms the objects in manager were last moved to
+  EigenSTL::vector_Isometry3d transforms;
+};
+
 // Check whether this FCL version supports the requested computations
 void checkFCLCapabilities(const DistanceRequest& req)
 {
@@ -79,10 +100,26 @@ void checkFCLCapabilities(const DistanceRequest& req)
   static_cast<void>(req);  // silent -Wunused-parameter
 #endif
 }
+
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+struct SweptCandidateData
+{
+  const fcl::CollisionObjectd* probe;
+  std::vector<fcl::CollisionObjectd*> candidates;
+};
+
+// Collect the objects overlapping the probe box around a moving robot object
+bool sweptCandidateCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data)
+{
+  SweptCandidateData* cdata = static_cast<SweptCandidateData*>(data);
+  cdata->candidates.push_back(o1 == cdata->probe ? o2 : o1);
+  return false;
+}
+#endif
 }  // namespace
 
 CollisionEnvFCL::CollisionEnvFCL(const moveit::core::RobotModelConstPtr& model, double padding, double scale)
-  : CollisionEnv(model, padding, scale)
+  : CollisionEnv(model, padding, scale), robot_manager_id_(next_robot_manager_id++)
 {
   const std::vector<const moveit::core::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
   std::size_t index;
@@ -112,7 +149,8 @@ CollisionEnvFCL::CollisionEnvFCL(const moveit::core::RobotModelConstPtr& model,
     }
   }
 
-  manager_ = std::make_unique<fcl::DynamicAABBTreeCollisionManagerd>();
+  manager_ = std::make_shared<fcl::DynamicAABBTreeCollisionManagerd>();
+  fcl_objs_ = std::make_shared<std::map<std::string, FCLObject>>();
 
   // request notifications about changes to new world
   observer_handle_ = getWorld()->addObserver(
@@ -121,7 +159,7 @@ CollisionEnvFCL::CollisionEnvFCL(const moveit::core::RobotModelConstPtr& model,
 
 CollisionEnvFCL::CollisionEnvFCL(const moveit::core::RobotModelConstPtr& model, const WorldPtr& world, double padding,
                                  double scale)
-  : CollisionEnv(model, world, padding, scale)
+  : CollisionEnv(model, world, padding, scale), robot_manager_id_(next_robot_manager_id++)
 {
   const std::vector<const moveit::core::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
   std::size_t index;
@@ -150,7 +188,8 @@ CollisionEnvFCL::CollisionEnvFCL(const moveit::core::RobotModelConstPtr& model,
     }
   }
 
-  manager_ = std::make_unique<fcl::DynamicAABBTreeCollisionManagerd>();
+  manager_ = std::make_shared<fcl::DynamicAABBTreeCollisionManagerd>();
+  fcl_objs_ = std::make_shared<std::map<std::string, FCLObject>>();
 
   // request notifications about changes to new world
   observer_handle_ = getWorld()->addObserver(
@@ -163,17 +202,18 @@ CollisionEnvFCL::~CollisionEnvFCL()
   getWorld()->removeObserver(observer_handle_);
 }
 
-CollisionEnvFCL::CollisionEnvFCL(const CollisionEnvFCL& other, const WorldPtr& world) : CollisionEnv(other, world)
+CollisionEnvFCL::CollisionEnvFCL(const CollisionEnvFCL& other, const WorldPtr& world)
+  : CollisionEnv(other, world)
+  , robot_manager_id_(next_robot_manager_id++)
+  , self_collision_pool_(other.self_collision_pool_)
+  , parallel_min_object_count_(other.parallel_min_object_count_)
 {
   robot_geoms_ = other.robot_geoms_;
   robot_fcl_objs_ = other.robot_fcl_objs_;
 
-  manager_ = std::make_unique<fcl::DynamicAABBTreeCollisionManagerd>();
-
+  // the world objects and their broadphase are shared until either environment changes them, so that copies are cheap
+  manager_ = other.manager_;
   fcl_objs_ = other.fcl_objs_;
-  for (auto& fcl_obj : fcl_objs_)
-    fcl_obj.second.registerTo(manager_.get());
-  // manager_->update();
 
   // request notifications about changes to new world
   observer_handle_ = getWorld()->addObserver(
@@ -210,6 +250,12 @@ void CollisionEnvFCL::constructFCLObjectWorld(const World::Object* obj, FCLObjec
 }
 
 void CollisionEnvFCL::constructFCLObjectRobot(const moveit::core::RobotState& state, FCLObject& fcl_obj) const
+{
+  constructFCLObjectRobotLinks(state, fcl_obj);
+  constructFCLObjectAttachedBodies(state, fcl_obj);
+}
+
+void CollisionEnvFCL::constructFCLObjectRobotLinks(const moveit::core::RobotState& state, FCLObject& fcl_obj) const
 {
   fcl_obj.collision_objects_.reserve(robot_geoms_.size());
   fcl::Transform3d fcl_tf;
@@ -227,6 +273,39 @@ void CollisionEnvFCL::constructFCLObjectRobot(const moveit::core::RobotState& st
       fcl_obj.collision_objects_.push_back(FCLCollisionObjectPtr(coll_obj));
     }
   }
+}
+
+void CollisionEnvFCL::updateFCLObjectRobotLinks(const moveit::core::RobotState& state, FCLObject& fcl_obj,
+                                                EigenSTL::vector_Isometry3d& transforms,
+                                                std::vector<fcl::CollisionObjectd*>& changed) const
+{
+  // the objects were created by constructFCLObjectRobotLinks(), one for each link geometry, in the same order
+  changed.clear();
+  std::size_t object_index = 0;
+  fcl::Transform3d fcl_tf;
+  for (const FCLGeometryConstPtr& geom : robot_geoms_)
+  {
+    if (geom && geom->collision_geometry_)
+    {
+      const Eigen::Isometry3d& transform = state.getCollisionBodyTransform(geom->collision_geometry_data_->ptr.link,
+                                                                           geom->collision_geometry_data_->shape_index);
+      if (transform.matrix() != transforms[object_index].matrix())
+      {
+        transforms[object_index] = transform;
+        transform2fcl(transform, fcl_tf);
+        fcl::CollisionObjectd* coll_obj = fcl_obj.collision_objects_[object_index].get();
+        coll_obj->setTransform(fcl_tf);
+        coll_obj->computeAABB();
+        changed.push_back(coll_obj);
+      }
+      ++object_index;
+    }
+  }
+}
+
+void CollisionEnvFCL::constructFCLObjectAttachedBodies(const moveit::core::RobotState& state, FCLObject& fcl_obj) const
+{
+  fcl::Transform3d fcl_tf;
 
   // TODO: Implement a method for caching fcl::CollisionObject's for moveit::core::AttachedBody's
   std::vector<const moveit::core::AttachedBody*> ab;
@@ -275,11 +354,14 @@ void CollisionEnvFCL::checkSelfCollisionHelper(const CollisionRequest& req, Coll
                                                const moveit::core::RobotState& state,
                                                const AllowedCollisionMatrix* acm) const
 {
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
-  CollisionData cd(&req, &res, acm);
-  cd.enableGroup(getRobotModel());
-  manager.manager_->collide(&cd, &collisionCallback);
+  MOVEIT_TRACEPOINT_SCOPE("collision_env_fcl.check_self_collision");
+  FCLManager& manager = getRobotManager(state);
+  FCLObject attached;
+  constructFCLObjectAttachedBodies(state, attached);
+  attached.registerTo(manager.manager_.get());
+  collideSelf(req, res, acm, manager);
+  attached.unregisterFrom(manager.manager_.get());
+
   if (req.distance)
   {
     DistanceRequest dreq;
@@ -310,32 +392,30 @@ void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& req, Collision
   checkRobotCollisionHelper(req, res, state, &acm);
 }
 
-void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& /*req*/, CollisionResult& /*res*/,
-                                          const moveit::core::RobotState& /*state1*/,
-                                          const moveit::core::RobotState& /*state2*/) const
+void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                          const moveit::core::RobotState& state1,
+                                          const moveit::core::RobotState& state2) const
 {
-  RCLCPP_ERROR(getLogger(), "Continuous collision not implemented");
+  checkRobotCollisionHelperCCD(req, res, state1, state2, nullptr);
 }
 
-void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& /*req*/, CollisionResult& /*res*/,
-                                          const moveit::core::RobotState& /*state1*/,
-                                          const moveit::core::RobotState& /*state2*/,
-                                          const AllowedCollisionMatrix& /*acm*/) const
+void CollisionEnvFCL::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                          const moveit::core::RobotState& state1,
+                                          const moveit::core::RobotState& state2,
+                                          const AllowedCollisionMatrix& acm) const
 {
-  RCLCPP_ERROR(getLogger(), "Not implemented");
+  checkRobotCollisionHelperCCD(req, res, state1, state2, &acm);
 }
 
 void CollisionEnvFCL::checkRobotCollisionHelper(const CollisionRequest& req, CollisionResult& res,
                                                 const moveit::core::RobotState& state,
                                                 const AllowedCollisionMatrix* acm) const
 {
-  FCLObject fcl_obj;
-  constructFCLObjectRobot(state, fcl_obj);
-
-  CollisionData cd(&req, &res, acm);
-  cd.enableGroup(getRobotModel());
-  for (std::size_t i = 0; !cd.done_ && i < fcl_obj.collision_objects_.size(); ++i)
-    manager_->collide(fcl_obj.collision_objects_[i].get(), &cd, &collisionCallback);
+  MOVEIT_TRACEPOINT_SCOPE("collision_env_fcl.check_robot_collision");
+  const FCLManager& manager = getRobotManager(state);
+  FCLObject attached;
+  constructFCLObjectAttachedBodies(state, attached);
+  collideWorld(req, res, acm, manager.object_, attached);
 
   if (req.distance)
   {
@@ -354,36 +434,429 @@ void CollisionEnvFCL::checkRobotCollisionHelper(const CollisionRequest& req, Col
   }
 }
 
+void CollisionEnvFCL::checkRobotCollisionHelperCCD(const CollisionRequest& req, CollisionResult& res,
+                                                   const moveit::core::RobotState& state1,
+                                                   const moveit::core::RobotState& state2,
+                                                   const AllowedCollisionMatrix* acm) const
+{
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+  CollisionData cd(&req, &res, acm);
+  cd.enableGroup(getRobotModel());
+
+  FCLObject robot;
+  constructFCLObjectRobot(state1, robot);
+
+  // Conservative advancement bounds the motion of the robot objects between their poses in the two states, so no
+  // contact is missed however far they move. The robot object moves on the linear interpolation of its start and end
+  // pose, which is close to its actual motion for short segments. Octrees are not supported by conservative
+  // advancement and are checked at a fixed number of interpolated poses instead.
+  fcl::ContinuousCollisionRequestd ccd_req;
+  ccd_req.ccd_motion_type = fcl::CCDM_LINEAR;
+  for (const FCLCollisionObjectPtr& robot_obj : robot.collision_objects_)
+  {
+    const CollisionGeometryData* robot_cd =
+        static_cast<const CollisionGeometryData*>(robot_obj->collisionGeometry()->getUserData());
+    const moveit::core::LinkModel* link =
+        robot_cd->type == BodyTypes::ROBOT_LINK ? robot_cd->ptr.link : robot_cd->ptr.ab->getAttachedLink();
+    if (cd.active_components_only_ && cd.active_components_only_->find(link) == cd.active_components_only_->end())
+      continue;
+
+    Eigen::Isometry3d end_pose;
+    if (robot_cd->type == BodyTypes::ROBOT_LINK)
+    {
+      end_pose = state2.getCollisionBodyTransform(robot_cd->ptr.link, robot_cd->shape_index);
+    }
+    else
+    {
+      const moveit::core::AttachedBody* end_body = state2.getAttachedBody(robot_cd->getID());
+      if (!end_body)
+      {
+        RCLCPP_ERROR(getLogger(), "Body '%s' is only attached in the start state of the continuous collision check",
+                     robot_cd->getID().c_str());
+        return;
+      }
+      end_pose = end_body->getGlobalCollisionBodyTransforms()[robot_cd->shape_index];
+    }
+    const fcl::Transform3d start_tf = robot_obj->getTransform();
+    const fcl::Transform3d end_tf = transform2fcl(end_pose);
+
+    // the world objects overlapping the box around the object in both poses are candidates for a contact, the end
+    // pose is bounded the way fcl::CollisionObject bounds rotated geometry
+    const fcl::CollisionGeometryd& geometry = *robot_obj->collisionGeometry();
+    const Eigen::Vector3d end_center = end_tf * geometry.aabb_center;
+    fcl::AABBd swept = robot_obj->getAABB();
+    swept += fcl::AABBd(end_center - Eigen::Vector3d::Constant(geometry.aabb_radius),
+                        end_center + Eigen::Vector3d::Constant(geometry.aabb_radius));
+    fcl::Transform3d probe_tf = fcl::Transform3d::Identity();
+    probe_tf.translation() = swept.center();
+    fcl::CollisionObjectd probe(std::make_shared<fcl::Boxd>(swept.width(), swept.height(), swept.depth()), probe_tf);
+    probe.computeAABB();
+    SweptCandidateData candidate_data{ &probe, {} };
+    manager_->collide(&probe, &candidate_data, &sweptCandidateCallback);
+
+    for (fcl::CollisionObjectd* world_obj : candidate_data.candidates)
+    {
+      const CollisionGeometryData* world_cd =
+          static_cast<const CollisionGeometryData*>(world_obj->collisionGeometry()->getUserData());
+      AllowedCollision::Type type = AllowedCollision::NEVER;
+      if (cd.compiled_acm_ && cd.compiled_acm_->getAllowedCollision(robot_cd->getACMIndex(*cd.compiled_acm_),
+                                                                    world_cd->getACMIndex(*cd.compiled_acm_), type) &&
+          type == AllowedCollision::ALWAYS)
+        continue;
+
+      ccd_req.ccd_solver_type = world_obj->getObjectType() == fcl::OT_OCTREE ? fcl::CCDC_NAIVE :
+                                                                               fcl::CCDC_CONSERVATIVE_ADVANCEMENT;
+      fcl::ContinuousCollisionResultd ccd_res;
+      fcl::continuousCollide(robot_obj->collisionGeometry().get(), start_tf, end_tf,
+                             world_obj->collisionGeometry().get(), world_obj->getTransform(),
+                             world_obj->getTransform(), ccd_req, ccd_res);
+      if (!ccd_res.is_collide)
+        continue;
+
+      // the objects touch at the time of contact, their nearest points there locate the contact
+      Contact contact;
+      contact.body_name_1 = robot_cd->getID();
+      contact.body_type_1 = robot_cd->type;
+      contact.body_name_2 = world_cd->getID();
+      contact.body_type_2 = world_cd->type;
+      contact.percent_interpolation = ccd_res.time_of_contact;
+      contact.depth = 0.0;
+      fcl::DistanceRequestd dist_req(true);
+      fcl::DistanceResultd dist_res;
+      fcl::distance(robot_obj->collisionGeometry().get(), ccd_res.contact_tf1, world_obj->collisionGeometry().get(),
+                    ccd_res.contact_tf2, dist_req, dist_res);
+      contact.nearest_points[0] = dist_res.nearest_points[0];
+      contact.nearest_points[1] = dist_res.nearest_points[1];
+      contact.pos = 0.5 * (dist_res.nearest_points[0] + dist_res.nearest_points[1]);
+      const Eigen::Vector3d direction = dist_res.nearest_points[1] - dist_res.nearest_points[0];
+      contact.normal = direction.norm() > 0.0 ? Eigen::Vector3d(direction.normalized()) : Eigen::Vector3d::Zero();
+
+      if (type == AllowedCollision::CONDITIONAL)
+      {
+        DecideContactFn dcf;
+        if (acm->getAllowedCollision(contact.body_name_1, contact.body_name_2, dcf) && dcf(contact))
+          continue;
+      }
+
+      res.collision = true;
+      if (!req.contacts)
+        return;
+      const std::pair<std::string, std::string> pc = contact.body_name_1 < contact.body_name_2 ?
+                                                         std::make_pair(contact.body_name_1, contact.body_name_2) :
+                                                         std::make_pair(contact.body_name_2, contact.body_name_1);
+      std::vector<Contact>& pair_contacts = res.contacts[pc];
+      if (pair_contacts.size() < req.max_contacts_per_pair)
+      {
+        pair_contacts.push_back(contact);
+        ++res.contact_count;
+      }
+      if (res.contact_count >= req.max_contacts)
+        return;
+    }
+  }
+#else
+  static_cast<void>(req);
+  static_cast<void>(res);
+  static_cast<void>(state1);
+  static_cast<void>(state2);
+  static_cast<void>(acm);
+  RCLCPP_ERROR(getLogger(), "Continuous collision checking requires FCL 0.6 or newer");
+#endif
+}
+
+std::size_t CollisionEnvFCL::checkCollisionBatchHelper(const CollisionRequest& req,
+                                                       const std::vector<const moveit::core::RobotState*>& states,
+                                                       std::vector<CollisionResult>& results,
+                                                       const AllowedCollisionMatrix* acm,
+                                                       bool stop_at_first_collision) const
+{
+  // distances are computed by separate queries for each state, the batch would not save anything for them
+  if (req.distance)
+    return CollisionEnv::checkCollisionBatchHelper(req, states, results, acm, stop_at_first_collision);
+
+  results.resize(states.size());
+  for (CollisionResult& res : results)
+    res.clear();
+
+  CollisionBatchScheduler scheduler(states.size(), stop_at_first_collision);
+  CollisionBatchScheduler::run(std::min(getBatchThreadCount(), states.size()), [&] {
+    FCLObject attached;
+    std::size_t index;
+    while (scheduler.next(index))
+    {
+      // the robot links of the thread's manager are moved to the state; attached bodies may differ between states
+      const moveit::core::RobotState& state = *states[index];
+      FCLManager& manager = getRobotManager(state);
+      attached.clear();
+      constructFCLObjectAttachedBodies(state, attached);
+      attached.registerTo(manager.manager_.get());
+
+      CollisionResult& res = results[index];
+      collideSelf(req, res, acm, manager);
+      if (!res.collision || (req.contacts && res.contacts.size() < req.max_contacts))
+        collideWorld(req, res, acm, manager.object_, attached);
+
+      attached.unregisterFrom(manager.manager_.get());
+      if (res.collision)
+        scheduler.reportCollision(index);
+    }
+  });
+  return scheduler.getFirstCollision();
+}
+
+void CollisionEnvFCL::setSelfCollisionThreadCount(std::size_t thread_count, std::size_t min_object_count)
+{
+  self_collision_pool_ = thread_count > 1 ? std::make_shared<CollisionThreadPool>(thread_count) : nullptr;
+  parallel_min_object_count_ = min_object_count;
+}
+
+std::size_t CollisionEnvFCL::getSelfCollisionThreadCount() const
+{
+  return self_collision_pool_ ? self_collision_pool_->getThreadCount() : 1;
+}
+
+FCLManager& CollisionEnvFCL::getRobotManager(const moveit::core::RobotState& state) const
+{
+  // The managers of the environments checked most recently on this thread, least recently used first. They are looked
+  // up by id rather than by address, so an environment allocated where a destroyed one lived does not pick up its
+  // stale manager. A list keeps references to the managers valid while they are reordered or the oldest is dropped.
+  thread_local std::list<CachedRobotManager> cache;
+  thread_local std::vector<fcl::CollisionObjectd*> changed;
+
+  for (auto it = cache.begin(); it != cache.end(); ++it)
+  {
+    if (it->id == robot_manager_id_)
+    {
+      cache.splice(cache.end(), cache, it);
+      CachedRobotManager& entry = cache.back();
+      // links that did not move since the previous query keep their place in the tree; when most links moved,
+      // refitting the whole tree once is cheaper than reinserting them one by one
+      updateFCLObjectRobotLinks(state, entry.manager.object_, entry.transforms, changed);
+      if (2 * changed.size() > entry.transforms.size())
+      {
+        entry.manager.manager_->update();
+      }
+      else if (!changed.empty())
+      {
+        entry.manager.manager_->update(changed);
+      }
+      return entry.manager;
+    }
+  }
+
+  if (cache.size() >= MAX_CACHED_ROBOT_MANAGERS)
+    cache.pop_front();
+  cache.emplace_back();
+  CachedRobotManager& entry = cache.back();
+  entry.id = robot_manager_id_;
+  entry.manager.manager_ = std::make_shared<fcl::DynamicAABBTreeCollisionManagerd>();
+  constructFCLObjectRobotLinks(state, entry.manager.object_);
+  // NaN never compares equal, so the first update records the transforms of all links
+  entry.transforms.assign(entry.manager.object_.collision_objects_.size(),
+                          Eigen::Isometry3d(Eigen::Matrix4d::Constant(std::numeric_limits<double>::quiet_NaN())));
+  updateFCLObjectRobotLinks(state, entry.manager.object_, entry.transforms, changed);
+  entry.manager.object_.registerTo(entry.manager.manager_.get());
+  return entry.manager;
+}
+
+void CollisionEnvFCL::collideSelf(const CollisionRequest& req, CollisionResult& res, const AllowedCollisionMatrix* acm,
+                                  FCLManager& manager) const
+{
+  CollisionData cd(&req, &res, acm);
+  cd.enableGroup(getRobotModel());
+
+  // cost sources and user termination callbacks are accumulated across all pairs, so those requests stay serial
+  if (!self_collision_pool_ || manager.manager_->size() < parallel_min_object_count_ || req.cost || req.is_done ||
+      !collideSelfParallel(cd, manager))
+  {
+    manager.manager_->collide(&cd, &collisionCallback);
+  }
+}
+
+namespace
+{
+struct ParallelSelfCollisionData
+{
+  CollisionData* cd;
+  const fcl::CollisionObjectd* query;
+  const std::atomic<bool>* stop;
+};
+
+// Querying every object against the tree reports each pair twice, and the query object with itself: only the
+// query with the lower address of the two handles a pair.
+bool parallelSelfCollisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data)
+{
+  ParallelSelfCollisionData* pdata = static_cast<ParallelSelfCollisionData*>(data);
+  if (pdata->stop->load(std::memory_order_relaxed))
+    return true;
+  const fcl::CollisionObjectd* other = o1 == pdata->query ? o2 : o1;
+  if (!std::less<const fcl::CollisionObjectd*>()(pdata->query, other))
+    return false;
+  return collisionCallback(o1, o2, pdata->cd);
+}
+
+void mergeCollisionResult(const CollisionRequest& req, const CollisionResult& part, CollisionResult& res)
+{
+  for (const auto& [pair, statistics] : part.pair_statistics)
+    res.pair_statistics[pair] += statistics;
+  if (!part.collision)
+    return;
+  res.collision = true;
+  for (const auto& [pair, contacts] : part.contacts)
+  {
+    for (const Contact& contact : contacts)
+    {
+      if (res.contact_count >= req.max_contacts)
+        return;
+      std::vector<Contact>& pair_contacts = res.contacts[pair];
+      if (pair_contacts.size() >= req.max_contacts_per_pair)
+        break;
+      pair_contacts.push_back(contact);
+      ++res.contact_count;
+    }
+  }
+}
+}  // namespace
+
+bool CollisionEnvFCL::collideSelfParallel(CollisionData& cd, FCLManager& manager) const
+{
+  std::vector<fcl::CollisionObjectd*> objects;
+  manager.manager_->getObjects(objects);
+
+  // interleave the objects over more tasks than threads, so threads that finish early can take over
+  const std::size_t task_count = std::min(objects.size(), 4 * self_collision_pool_->getThreadCount());
+  std::vector<CollisionResult> task_results(task_count);
+  std::atomic<bool> stop{ false };
+  const std::function<void(std::size_t)> task = [&](std::size_t task_index) {
+    CollisionData task_cd(cd.req_, &task_results[task_index], cd.acm_);
+    task_cd.active_components_only_ = cd.active_components_only_;
+    ParallelSelfCollisionData pdata{ &task_cd, nullptr, &stop };
+    for (std::size_t i = task_index; i < objects.size() && !task_cd.done_; i += task_count)
+    {
+      pdata.query = objects[i];
+      manager.manager_->collide(objects[i], &pdata, &parallelSelfCollisionCallback);
+    }
+    // enough contacts were found by this task alone, or the first collision when no contacts are requested
+    if (task_cd.done_)
+      stop = true;
+  };
+  if (!self_collision_pool_->tryRun(task_count, task))
+    return false;
+
+  for (const CollisionResult& task_result : task_results)
+    mergeCollisionResult(*cd.req_, task_result, *cd.res_);
+  if (cd.res_->collision && (!cd.req_->contacts || cd.res_->contact_count >= cd.req_->max_contacts))
+    cd.done_ = true;
+  return true;
+}
+
+void CollisionEnvFCL::collideWorld(const CollisionRequest& req, CollisionResult& res, const AllowedCollisionMatrix* acm,
+                                   const FCLObject& links, const FCLObject& attached) const
+{
+  CollisionData cd(&req, &res, acm);
+  cd.enableGroup(getRobotModel());
+  for (std::size_t i = 0; !cd.done_ && i < links.collision_objects_.size(); ++i)
+    manager_->collide(links.collision_objects_[i].get(), &cd, &collisionCallback);
+  for (std::size_t i = 0; !cd.done_ && i < attached.collision_objects_.size(); ++i)
+    manager_->collide(attached.collision_objects_[i].get(), &cd, &collisionCallback);
+}
+
 void CollisionEnvFCL::distanceSelf(const DistanceRequest& req, DistanceResult& res,
                                    const moveit::core::RobotState& state) const
 {
+  MOVEIT_TRACEPOINT_SCOPE("collision_env_fcl.distance_self");
   checkFCLCapabilities(req);
 
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
+  FCLManager& manager = getRobotManager(state);
+  FCLObject attached;
+  constructFCLObjectAttachedBodies(state, attached);
+  attached.registerTo(manager.manager_.get());
   DistanceData drd(&req, &res);
 
+  std::vector<fcl::CollisionObjectd*> objects1, objects2;
+  for (std::size_t i = 0; req.type == DistanceRequestType::GLOBAL && i < req.warm_start_pairs.size(); ++i)
+  {
+    findRobotObjects(manager.object_, attached, req.warm_start_pairs[i].first, objects1);
+    findRobotObjects(manager.object_, attached, req.warm_start_pairs[i].second, objects2);
+    evaluateDistances(drd, objects1, objects2);
+  }
+
   manager.manager_->distance(&drd, &distanceCallback);
+  attached.unregisterFrom(manager.manager_.get());
 }
 
 void CollisionEnvFCL::distanceRobot(const DistanceRequest& req, DistanceResult& res,
                                     const moveit::core::RobotState& state) const
 {
+  MOVEIT_TRACEPOINT_SCOPE("collision_env_fcl.distance_robot");
   checkFCLCapabilities(req);
 
-  FCLObject fcl_obj;
-  constructFCLObjectRobot(state, fcl_obj);
+  const FCLManager& manager = getRobotManager(state);
+  FCLObject attached;
+  constructFCLObjectAttachedBodies(state, attached);
 
   DistanceData drd(&req, &res);
-  for (std::size_t i = 0; !drd.done && i < fcl_obj.collision_objects_.size(); ++i)
-    manager_->distance(fcl_obj.collision_objects_[i].get(), &drd, &distanceCallback);
+  std::vector<fcl::CollisionObjectd*> robot_objects, world_objects;
+  for (std::size_t i = 0; req.type == DistanceRequestType::GLOBAL && i < req.warm_start_pairs.size(); ++i)
+  {
+    // either name of the pair may be the robot object
+    for (bool robot_first : { true, false })
+    {
+      const std::string& robot_name = robot_first ? req.warm_start_pairs[i].first : req.warm_start_pairs[i].second;
+      const std::string& world_name = robot_first ? req.warm_start_pairs[i].second : req.warm_start_pairs[i].first;
+      world_objects.clear();
+      const auto it = fcl_objs_->find(world_name);
+      if (it == fcl_objs_->end())
+        continue;
+      for (const FCLCollisionObjectPtr& object : it->second.collision_objects_)
+        world_objects.push_back(object.get());
+      findRobotObjects(manager.object_, attached, robot_name, robot_objects);
+      evaluateDistances(drd, robot_objects, world_objects);
+    }
+  }
+
+  for (std::size_t i = 0; !drd.done && i < manager.object_.collision_objects_.size(); ++i)
+    manager_->distance(manager.object_.collision_objects_[i].get(), &drd, &distanceCallback);
+  for (std::size_t i = 0; !drd.done && i < attached.collision_objects_.size(); ++i)
+    manager_->distance(attached.collision_objects_[i].get(), &drd, &distanceCallback);
+}
+
+void CollisionEnvFCL::findRobotObjects(const FCLObject& links, const FCLObject& attached, const std::string& name,
+                                       std::vector<fcl::CollisionObjectd*>& objects) const
+{
+  objects.clear();
+  for (const FCLObject* fcl_obj : { &links, &attached })
+  {
+    for (const FCLCollisionObjectPtr& object : fcl_obj->collision_objects_)
+    {
+      if (static_cast<const CollisionGeometryData*>(object->collisionGeometry()->getUserData())->getID() == name)
+        objects.push_back(object.get());
+    }
+  }
+}
+
+void CollisionEnvFCL::evaluateDistances(DistanceData& data, const std::vector<fcl::CollisionObjectd*>& objects1,
+                                        const std::vector<fcl::CollisionObjectd*>& objects2) const
+{
+  double min_dist;
+  for (fcl::CollisionObjectd* object1 : objects1)
+  {
+    for (fcl::CollisionObjectd* object2 : objects2)
+    {
+      if (distanceCallback(object1, object2, &data, min_dist))
+        return;
+    }
+  }
 }
 
 void CollisionEnvFCL::updateFCLObject(const std::string& id)
 {
+  ensureUniqueWorldObjects();
+  std::map<std::string, FCLObject>& fcl_objs = *fcl_objs_;
+
   // remove FCL objects that correspond to this object
-  auto jt = fcl_objs_.find(id);
-  if (jt != fcl_objs_.end())
+  auto jt = fcl_objs.find(id);
+  if (jt != fcl_objs.end())
   {
     jt->second.unregisterFrom(manager_.get());
     jt->second.clear();
@@ -394,26 +867,37 @@ void CollisionEnvFCL::updateFCLObject(const std::string& id)
   if (it != getWorld()->end())
   {
     // construct FCL objects that correspond to this object
-    if (jt != fcl_objs_.end())
+    if (jt != fcl_objs.end())
     {
       constructFCLObjectWorld(it->second.get(), jt->second);
       jt->second.registerTo(manager_.get());
     }
     else
     {
-      constructFCLObjectWorld(it->second.get(), fcl_objs_[id]);
-      fcl_objs_[id].registerTo(manager_.get());
+      constructFCLObjectWorld(it->second.get(), fcl_objs[id]);
+      fcl_objs[id].registerTo(manager_.get());
     }
   }
   else
   {
-    if (jt != fcl_objs_.end())
-      fcl_objs_.erase(jt);
+    if (jt != fcl_objs.end())
+      fcl_objs.erase(jt);
   }
 
   // manager_->update();
 }
 
+void CollisionEnvFCL::ensureUniqueWorldObjects()
+{
+  if (manager_.use_count() == 1 && fcl_objs_.use_count() == 1)
+    return;
+
+  fcl_objs_ = std::make_shared<std::map<std::string, FCLObject>>(*fcl_objs_);
+  manager_ = std::make_shared<fcl::DynamicAABBTreeCollisionManagerd>();
+  for (auto& fcl_obj : *fcl_objs_)
+    fcl_obj.second.registerTo(manager_.get());
+}
+
 void CollisionEnvFCL::setWorld(const WorldPtr& world)
 {
   if (world == getWorld())
@@ -422,9 +906,9 @@ void CollisionEnvFCL::setWorld(const WorldPtr& world)
   // turn off notifications about old world
   getWorld()->removeObserver(observer_handle_);
 
-  // clear out objects from old world
-  manager_->clear();
-  fcl_objs_.clear();
+  // clear out objects from old world, copies of this environment keep theirs
+  manager_ = std::make_shared<fcl::DynamicAABBTreeCollisionManagerd>();
+  fcl_objs_ = std::make_shared<std::map<std::string, FCLObject>>();
   cleanCollisionGeometryCache();
 
   CollisionEnv::setWorld(world);
@@ -441,19 +925,21 @@ void CollisionEnvFCL::notifyObjectChange(const ObjectConstPtr& obj, World::Actio
 {
   if (action == World::DESTROY)
   {
-    auto it = fcl_objs_.find(obj->id_);
-    if (it != fcl_objs_.end())
+    ensureUniqueWorldObjects();
+    auto it = fcl_objs_->find(obj->id_);
+    if (it != fcl_objs_->end())
     {
       it->second.unregisterFrom(manager_.get());
       it->second.clear();
-      fcl_objs_.erase(it);
+      fcl_objs_->erase(it);
     }
     cleanCollisionGeometryCache();
   }
   else if (action == World::MOVE_SHAPE)
   {
-    auto it = fcl_objs_.find(obj->id_);
-    if (it == fcl_objs_.end())
+    ensureUniqueWorldObjects();
+    auto it = fcl_objs_->find(obj->id_);
+    if (it == fcl_objs_->end())
     {
       RCLCPP_ERROR(getLogger(), "Cannot move shapes of unknown FCL object: '%s'", obj->id_.c_str());
       return;
@@ -468,18 +954,21 @@ void CollisionEnvFCL::notifyObjectChange(const ObjectConstPtr& obj, World::Actio
       return;
     }
 
+    // update AABB in the FCL broadphase manager tree
+    // see https://github.com/moveit/moveit/pull/3601 for benchmarks
+    it->second.unregisterFrom(manager_.get());
     for (std::size_t i = 0; i < it->second.collision_objects_.size(); ++i)
     {
-      it->second.collision_objects_[i]->setTransform(transform2fcl(obj->global_shape_poses_[i]));
+      // copies of this environment may still use the collision object at its old pose
+      FCLCollisionObjectPtr& collision_object = it->second.collision_objects_[i];
+      if (collision_object.use_count() > 1)
+        collision_object = std::make_shared<fcl::CollisionObjectd>(*collision_object);
+      collision_object->setTransform(transform2fcl(obj->global_shape_poses_[i]));
 
       // compute AABB, order matters
       it->second.collision_geometry_[i]->collision_geometry_->computeLocalAABB();
-      it->second.collision_objects_[i]->computeAABB();
+      collision_object->computeAABB();
     }
-
-    // update AABB in the FCL broadphase manager tree
-    // see https://github.com/moveit/moveit/pull/3601 for benchmarks
-    it->second.unregisterFrom(manager_.get());
     it->second.registerTo(manager_.get());
   }
   else
@@ -492,6 +981,9 @@ void CollisionEnvFCL::notifyObjectChange(const ObjectConstPtr& obj, World::Actio
 
 void CollisionEnvFCL::updatedPaddingOrScaling(const std::vector<std::string>& links)
 {
+  // the cached robot managers hold copies of the old link objects
+  robot_manager_id_ = next_robot_manager_id++;
+
   std::size_t index;
   for (const auto& link : links)
   {
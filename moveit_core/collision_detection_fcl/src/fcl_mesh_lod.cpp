@@ -0,0 +1,80 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection_fcl/fcl_mesh_lod.hpp>
+#include <moveit/collision_detection/mesh_lod.hpp>
+
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+#include <fcl/geometry/bvh/BVH_model.h>
+#else
+#include <fcl/BVH/BVH_model.h>
+#endif
+
+#include <vector>
+
+namespace collision_detection
+{
+FCLMeshLODs::FCLMeshLODs(const shapes::ShapeConstPtr& mesh) : mesh_(mesh)
+{
+}
+
+const fcl::CollisionGeometryd* FCLMeshLODs::getGeometry(MeshLOD lod) const
+{
+  if (lod == MeshLODs::EXACT || static_cast<std::size_t>(lod) > LOD_COUNT)
+    return nullptr;
+
+  const std::size_t index = static_cast<std::size_t>(lod) - 1;
+  std::call_once(once_[index], [this, lod, index] {
+    const std::shared_ptr<const shapes::Mesh> mesh = createMeshLOD(static_cast<const shapes::Mesh&>(*mesh_), lod);
+    if (!mesh)
+      return;
+
+    std::vector<fcl::Triangle> tri_indices(mesh->triangle_count);
+    for (unsigned int i = 0; i < mesh->triangle_count; ++i)
+      tri_indices[i] = fcl::Triangle(mesh->triangles[3 * i], mesh->triangles[3 * i + 1], mesh->triangles[3 * i + 2]);
+
+    std::vector<fcl::Vector3d> points(mesh->vertex_count);
+    for (unsigned int i = 0; i < mesh->vertex_count; ++i)
+      points[i] = fcl::Vector3d(mesh->vertices[3 * i], mesh->vertices[3 * i + 1], mesh->vertices[3 * i + 2]);
+
+    auto model = std::make_shared<fcl::BVHModel<fcl::OBBRSSd>>();
+    model->beginModel();
+    model->addSubModel(points, tri_indices);
+    model->endModel();
+    model->computeLocalAABB();
+    geometries_[index] = model;
+  });
+  return geometries_[index].get();
+}
+}  // namespace collision_detection
@@ -0,0 +1,181 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection_fcl/fcl_octree_hierarchy.hpp>
+
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+#include <moveit/collision_detection/occupancy_map.hpp>
+#include <fcl/geometry/shape/box.h>
+#include <fcl/narrowphase/collision.h>
+
+#include <algorithm>
+
+namespace collision_detection
+{
+FCLOcTreeHierarchy::FCLOcTreeHierarchy(const std::shared_ptr<const octomap::OcTree>& tree)
+  : fcl::OcTreed(tree), octree_(tree), map_(dynamic_cast<const OccMapTree*>(tree.get()))
+{
+}
+
+unsigned int FCLOcTreeHierarchy::getDepth(double resolution) const
+{
+  unsigned int depth = octree_->getTreeDepth();
+  while (depth > 0 && octree_->getNodeSize(depth) < resolution)
+    --depth;
+  return depth;
+}
+
+std::shared_ptr<const FCLOcTreeHierarchy::Levels> FCLOcTreeHierarchy::getLevels() const
+{
+  const std::uint64_t update_count = map_ ? map_->getUpdateCount() : 0;
+  std::shared_ptr<const Levels> levels = std::atomic_load(&levels_);
+  if (levels && levels->update_count == update_count)
+    return levels;
+
+  std::lock_guard<std::mutex> guard(levels_mutex_);
+  levels = std::atomic_load(&levels_);
+  if (levels && levels->update_count == update_count)
+    return levels;
+
+  auto new_levels = std::make_shared<Levels>();
+  new_levels->update_count = update_count;
+  Cell root{ Eigen::Vector3d::Zero(), 0, 0 };
+  if (octree_->getRoot() && addCell(octree_->getRoot(), 0, new_levels->cells, root))
+  {
+    new_levels->cells.resize(std::max<std::size_t>(new_levels->cells.size(), 1));
+    new_levels->cells[0].push_back(root);
+  }
+  else
+  {
+    new_levels->cells.clear();
+  }
+  levels = new_levels;
+  std::atomic_store(&levels_, levels);
+  return levels;
+}
+
+bool FCLOcTreeHierarchy::addCell(const octomap::OcTreeNode* node, unsigned int depth,
+                                 std::vector<std::vector<Cell>>& cells, Cell& cell) const
+{
+  cell.first_child = 0;
+  cell.child_count = 0;
+  if (!octree_->nodeHasChildren(node))
+    return octree_->isNodeOccupied(node);
+
+  if (cells.size() < depth + 2)
+    cells.resize(depth + 2);
+  cell.first_child = cells[depth + 1].size();
+
+  // the children of a cell are ordered with x in bit 0, y in bit 1 and z in bit 2, as in octomap
+  const double offset = octree_->getNodeSize(depth + 1) / 2.0;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    if (!octree_->nodeChildExists(node, i))
+      continue;
+    Cell child;
+    child.center = cell.center + offset * Eigen::Vector3d((i & 1) ? 1.0 : -1.0, (i & 2) ? 1.0 : -1.0,
+                                                          (i & 4) ? 1.0 : -1.0);
+    // the descendants of the child only go to deeper levels, which keeps the children of this cell contiguous
+    if (addCell(octree_->getNodeChild(node, i), depth + 1, cells, child))
+    {
+      cells[depth + 1].push_back(child);
+      ++cell.child_count;
+    }
+  }
+  return cell.child_count > 0;
+}
+
+std::size_t FCLOcTreeHierarchy::collide(const fcl::CollisionObjectd& object, const fcl::CollisionGeometryd& geometry,
+                                        const fcl::Transform3d& tree_pose, bool tree_first,
+                                        const fcl::CollisionRequestd& request, fcl::CollisionResultd& result,
+                                        unsigned int depth) const
+{
+  const std::shared_ptr<const Levels> levels = getLevels();
+  if (levels->cells.empty() || request.num_max_contacts == 0)
+    return result.numContacts();
+
+  // the bounding box of the object, in the frame of the octree
+  const fcl::AABBd& aabb = object.getAABB();
+  const fcl::Transform3d tree_pose_inverse = tree_pose.inverse();
+  const Eigen::Vector3d center = tree_pose_inverse * (0.5 * (aabb.min_ + aabb.max_));
+  const Eigen::Vector3d half_extent = tree_pose_inverse.linear().cwiseAbs() * (0.5 * (aabb.max_ - aabb.min_));
+
+  struct Entry
+  {
+    unsigned int depth;
+    std::uint32_t index;
+  };
+  std::vector<Entry> stack{ { 0, 0 } };
+  while (!stack.empty())
+  {
+    const Entry entry = stack.back();
+    stack.pop_back();
+    const Cell& cell = levels->cells[entry.depth][entry.index];
+    const double half_size = octree_->getNodeSize(entry.depth) / 2.0;
+    if (((cell.center - center).cwiseAbs() - half_extent).maxCoeff() > half_size)
+      continue;
+
+    if (cell.child_count > 0 && entry.depth < depth)
+    {
+      for (std::uint32_t i = 0; i < cell.child_count; ++i)
+        stack.push_back({ entry.depth + 1, cell.first_child + i });
+      continue;
+    }
+
+    const fcl::Boxd box(2.0 * half_size, 2.0 * half_size, 2.0 * half_size);
+    fcl::Transform3d box_pose = tree_pose;
+    box_pose.translate(cell.center);
+    fcl::CollisionRequestd cell_request = request;
+    cell_request.num_max_contacts = request.num_max_contacts - result.numContacts();
+    fcl::CollisionResultd cell_result;
+    if (tree_first)
+      fcl::collide(&box, box_pose, &geometry, object.getTransform(), cell_request, cell_result);
+    else
+      fcl::collide(&geometry, object.getTransform(), &box, box_pose, cell_request, cell_result);
+
+    // the contacts refer to this octree and the object, not to the box, which goes out of scope, or to the geometry
+    for (std::size_t i = 0; i < cell_result.numContacts(); ++i)
+    {
+      fcl::Contactd contact = cell_result.getContact(i);
+      contact.o1 = tree_first ? this : object.collisionGeometry().get();
+      contact.o2 = tree_first ? object.collisionGeometry().get() : this;
+      result.addContact(contact);
+    }
+    if (result.numContacts() >= request.num_max_contacts)
+      break;
+  }
+  return result.numContacts();
+}
+}  // namespace collision_detection
+#endif
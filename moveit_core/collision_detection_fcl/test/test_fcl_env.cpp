@@ -37,6 +37,8 @@
 #include <gtest/gtest.h>
 
 #include <moveit/collision_detection/collision_common.hpp>
+#include <moveit/collision_detection/distance_query.hpp>
+#include <moveit/collision_detection/occupancy_map.hpp>
 
 #include <moveit/robot_model/robot_model.hpp>
 #include <moveit/robot_state/robot_state.hpp>
@@ -47,6 +49,7 @@
 #include <moveit/collision_detection_fcl/collision_env_fcl.hpp>
 
 #include <urdf_parser/urdf_parser.h>
+#include <random_numbers/random_numbers.h>
 #include <geometric_shapes/shape_operations.h>
 
 /** \brief Brings the panda robot in user defined home position */
@@ -174,6 +177,43 @@ TEST_F(CollisionDetectionEnvTest, RobotWorldCollision_1)
   ASSERT_FALSE(res.collision);
 }
 
+/** \brief Copies of an environment share its world objects until either of them changes them. */
+TEST_F(CollisionDetectionEnvTest, CopyOnWriteWorld)
+{
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+
+  Eigen::Isometry3d pos1 = Eigen::Isometry3d::Identity();
+  pos1.translation().z() = 0.3;
+  c_env_->getWorld()->addToObject("box", std::make_shared<const shapes::Box>(.1, .1, .1), pos1);
+
+  auto fcl_env = std::static_pointer_cast<collision_detection::CollisionEnvFCL>(c_env_);
+  collision_detection::CollisionEnvFCL copy(*fcl_env,
+                                            std::make_shared<collision_detection::World>(*c_env_->getWorld()));
+  copy.checkRobotCollision(req, res, *robot_state_, *acm_);
+  ASSERT_TRUE(res.collision);
+  res.clear();
+
+  Eigen::Isometry3d pos2 = Eigen::Isometry3d::Identity();
+  pos2.translation().x() = 2.0;
+  copy.getWorld()->setObjectPose("box", pos2);
+  copy.checkRobotCollision(req, res, *robot_state_, *acm_);
+  ASSERT_FALSE(res.collision);
+  res.clear();
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  ASSERT_TRUE(res.collision);
+  res.clear();
+
+  c_env_->getWorld()->removeObject("box");
+  c_env_->getWorld()->addToObject("other", std::make_shared<const shapes::Box>(.1, .1, .1), pos2);
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  ASSERT_FALSE(res.collision);
+  res.clear();
+  copy.getWorld()->setObjectPose("box", pos1);
+  copy.checkRobotCollision(req, res, *robot_state_, *acm_);
+  ASSERT_TRUE(res.collision);
+}
+
 /** \brief Adding obstacles to the world which are tested against the robot. */
 TEST_F(CollisionDetectionEnvTest, RobotWorldCollision_2)
 {
@@ -227,6 +267,283 @@ TEST_F(CollisionDetectionEnvTest, PaddingTest)
   ASSERT_FALSE(res.collision);
 }
 
+/** \brief Splitting self-collision checks over threads finds the same colliding pairs as the serial check. */
+TEST_F(CollisionDetectionEnvTest, ParallelSelfCollision)
+{
+  collision_detection::CollisionEnvFCL serial_env(robot_model_);
+  collision_detection::CollisionEnvFCL parallel_env(robot_model_);
+  parallel_env.setSelfCollisionThreadCount(4, 1);
+  EXPECT_EQ(parallel_env.getSelfCollisionThreadCount(), 4u);
+
+  collision_detection::CollisionRequest req;
+  req.contacts = true;
+  req.max_contacts = 100;
+
+  random_numbers::RandomNumberGenerator rng(3);
+  const moveit::core::JointModelGroup* group = robot_model_->getJointModelGroup("panda_arm");
+  for (int i = 0; i < 30; ++i)
+  {
+    robot_state_->setToRandomPositions(group, rng);
+    robot_state_->update();
+
+    collision_detection::CollisionResult serial_res, parallel_res;
+    serial_env.checkSelfCollision(req, serial_res, *robot_state_, *acm_);
+    parallel_env.checkSelfCollision(req, parallel_res, *robot_state_, *acm_);
+    ASSERT_EQ(serial_res.collision, parallel_res.collision);
+    ASSERT_EQ(serial_res.contact_count, parallel_res.contact_count);
+    for (const auto& contact : serial_res.contacts)
+      EXPECT_EQ(parallel_res.contacts.count(contact.first), 1u) << contact.first.first << " " << contact.first.second;
+
+    // without contacts, the check stops at the first collision found by any thread
+    collision_detection::CollisionRequest binary_req;
+    collision_detection::CollisionResult binary_res;
+    parallel_env.checkSelfCollision(binary_req, binary_res, *robot_state_, *acm_);
+    EXPECT_EQ(binary_res.collision, serial_res.collision);
+  }
+}
+
+/** \brief The index-based view of the ACM used by the collision callbacks gives the same answers as the ACM. */
+TEST_F(CollisionDetectionEnvTest, CompiledAllowedCollisionMatrix)
+{
+  // the colliding default configuration becomes valid once the copy of the matrix allowing everything is rebuilt
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  robot_state_->setToDefaultValues();
+  robot_state_->update();
+  collision_detection::AllowedCollisionMatrix acm(*acm_);
+  c_env_->checkSelfCollision(req, res, *robot_state_, acm);
+  ASSERT_TRUE(res.collision);
+  res.clear();
+  acm.setEntry(true);
+  c_env_->checkSelfCollision(req, res, *robot_state_, acm);
+  ASSERT_FALSE(res.collision);
+
+  collision_detection::DecideContactFn fn = [](collision_detection::Contact& /*contact*/) { return true; };
+  acm_->setEntry("panda_link0", "panda_hand", fn);
+  acm_->removeEntry("panda_link3");
+  acm_->setDefaultEntry("panda_link3", true);
+  acm_->setDefaultEntry("box", fn);
+
+  std::vector<std::string> names = robot_model_->getLinkModelNames();
+  names.push_back("box");
+  names.push_back("unknown_object");
+
+  auto compare = [this, &names] {
+    collision_detection::CompiledAllowedCollisionMatrixConstPtr compiled = acm_->getCompiled();
+    for (const std::string& name1 : names)
+    {
+      for (const std::string& name2 : names)
+      {
+        collision_detection::AllowedCollision::Type type, compiled_type;
+        const bool found = acm_->getAllowedCollision(name1, name2, type);
+        ASSERT_EQ(compiled->getAllowedCollision(compiled->getIndex(name1), compiled->getIndex(name2), compiled_type),
+                  found)
+            << name1 << " " << name2;
+        if (found)
+          EXPECT_EQ(compiled_type, type) << name1 << " " << name2;
+      }
+    }
+  };
+  compare();
+
+  // the view is shared until the matrix changes
+  const std::uint32_t serial = acm_->getCompiled()->getSerial();
+  EXPECT_EQ(acm_->getCompiled()->getSerial(), serial);
+  acm_->setEntry("panda_link1", "panda_link7", true);
+  EXPECT_NE(acm_->getCompiled()->getSerial(), serial);
+  compare();
+}
+
+/** \brief Checks on one environment reuse its broadphase manager, moving only the links that changed in between. */
+TEST_F(CollisionDetectionEnvTest, IncrementalRobotManagerUpdate)
+{
+  collision_detection::CollisionEnvFCL env(robot_model_);
+
+  collision_detection::CollisionRequest req;
+  req.contacts = true;
+  req.max_contacts = 100;
+
+  random_numbers::RandomNumberGenerator rng(5);
+  const moveit::core::JointModelGroup* group = robot_model_->getJointModelGroup("panda_arm");
+  const std::vector<std::string>& variables = group->getVariableNames();
+  for (int i = 0; i < 60; ++i)
+  {
+    // alternate between moving all joints, a single joint and nothing at all
+    if (i % 3 == 0)
+    {
+      robot_state_->setToRandomPositions(group, rng);
+    }
+    else if (i % 3 == 1)
+    {
+      const std::string& variable = variables[rng.uniformInteger(0, static_cast<int>(variables.size()) - 1)];
+      robot_state_->setVariablePosition(variable, robot_state_->getVariablePosition(variable) + 0.3);
+      robot_state_->enforceBounds();
+    }
+    robot_state_->update();
+
+    collision_detection::CollisionEnvFCL fresh_env(robot_model_);
+    collision_detection::CollisionResult res, fresh_res;
+    env.checkSelfCollision(req, res, *robot_state_, *acm_);
+    fresh_env.checkSelfCollision(req, fresh_res, *robot_state_, *acm_);
+    ASSERT_EQ(res.collision, fresh_res.collision);
+    ASSERT_EQ(res.contact_count, fresh_res.contact_count);
+    for (const auto& contact : fresh_res.contacts)
+      EXPECT_EQ(res.contacts.count(contact.first), 1u) << contact.first.first << " " << contact.first.second;
+  }
+}
+
+/** \brief Warm started distance queries along a path find the same minimum distances as independent queries. */
+TEST_F(CollisionDetectionEnvTest, DistanceQueryWarmStart)
+{
+  shapes::ShapeConstPtr box = std::make_shared<const shapes::Box>(0.1, 0.1, 0.1);
+  Eigen::Isometry3d pose{ Eigen::Isometry3d::Identity() };
+  pose.translation() = Eigen::Vector3d(0.5, 0.0, 0.5);
+  c_env_->getWorld()->addToObject("box", box, pose);
+  pose.translation() = Eigen::Vector3d(-0.4, 0.3, 0.2);
+  c_env_->getWorld()->addToObject("other_box", box, pose);
+
+  collision_detection::DistanceRequest req;
+  req.acm = acm_.get();
+  req.enable_nearest_points = true;
+  collision_detection::DistanceQuery self_query(req);
+  collision_detection::DistanceQuery robot_query(req);
+
+  const moveit::core::JointModelGroup* group = robot_model_->getJointModelGroup("panda_arm");
+  random_numbers::RandomNumberGenerator rng(7);
+  std::vector<double> from, to, positions;
+  robot_state_->copyJointGroupPositions(group, from);
+  for (int segment = 0; segment < 5; ++segment)
+  {
+    robot_state_->setToRandomPositions(group, rng);
+    robot_state_->copyJointGroupPositions(group, to);
+    for (int step = 0; step <= 10; ++step)
+    {
+      positions.resize(from.size());
+      for (std::size_t i = 0; i < from.size(); ++i)
+        positions[i] = from[i] + (to[i] - from[i]) * step / 10.0;
+      robot_state_->setJointGroupPositions(group, positions);
+      robot_state_->update();
+
+      collision_detection::DistanceResult self_res, robot_res;
+      c_env_->distanceSelf(req, self_res, *robot_state_);
+      c_env_->distanceRobot(req, robot_res, *robot_state_);
+      EXPECT_NEAR(self_query.distanceSelf(*c_env_, *robot_state_).minimum_distance.distance,
+                  self_res.minimum_distance.distance, 1e-9);
+      EXPECT_NEAR(robot_query.distanceRobot(*c_env_, *robot_state_).minimum_distance.distance,
+                  robot_res.minimum_distance.distance, 1e-9);
+      EXPECT_EQ(robot_query.getRequest().warm_start_pairs.size(), 1u);
+    }
+    from = to;
+  }
+}
+
+/** \brief Coarser levels of detail of the meshes contain the finer ones, so whatever collides at a finer level collides
+ * at the coarser ones as well. */
+TEST_F(CollisionDetectionEnvTest, MeshLODCollision)
+{
+  shapes::ShapeConstPtr shape_ptr = std::make_shared<shapes::Box>(0.3, 0.3, 0.3);
+  Eigen::Isometry3d pos{ Eigen::Isometry3d::Identity() };
+  pos.translation() = Eigen::Vector3d(0.45, 0.0, 0.45);
+  c_env_->getWorld()->addToObject("box", shape_ptr, pos);
+
+  random_numbers::RandomNumberGenerator rng(3);
+  const moveit::core::JointModelGroup* group = robot_model_->getJointModelGroup("panda_arm");
+  std::array<std::size_t, 3> collision_count{ 0, 0, 0 };
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    robot_state_->setToRandomPositions(group, rng);
+    robot_state_->update();
+
+    bool finer_collision = false;
+    for (collision_detection::MeshLOD lod : { collision_detection::MeshLODs::EXACT,
+                                              collision_detection::MeshLODs::CONVEX_HULL,
+                                              collision_detection::MeshLODs::BOUNDING_BOX })
+    {
+      collision_detection::CollisionRequest req;
+      req.mesh_lod = lod;
+      req.contacts = true;
+      collision_detection::CollisionResult res;
+      c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+      if (finer_collision)
+        EXPECT_TRUE(res.collision) << "state " << i << ", level " << lod;
+      for (const auto& [pair, contacts] : res.contacts)
+        EXPECT_TRUE(pair.first == "box" || pair.second == "box");
+      finer_collision = res.collision;
+      collision_count[lod] += res.collision ? 1 : 0;
+    }
+  }
+  EXPECT_GT(collision_count[collision_detection::MeshLODs::EXACT], 0u);
+  EXPECT_LT(collision_count[collision_detection::MeshLODs::EXACT], 50u);
+}
+
+/** \brief Profiled checks count the candidates and narrowphase checks of each pair, skipping those the ACM allows. */
+TEST_F(CollisionDetectionEnvTest, CollisionProfile)
+{
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  c_env_->checkSelfCollision(req, res, *robot_state_, *acm_);
+  EXPECT_TRUE(res.pair_statistics.empty());
+
+  req.profile = true;
+  c_env_->checkSelfCollision(req, res, *robot_state_, *acm_);
+  ASSERT_FALSE(res.pair_statistics.empty());
+  std::size_t narrowphase_calls = 0;
+  for (const auto& [pair, statistics] : res.pair_statistics)
+  {
+    EXPECT_LT(pair.first, pair.second);
+    EXPECT_GE(statistics.broadphase_candidates, statistics.narrowphase_calls);
+    EXPECT_GE(statistics.narrowphase_time, 0.0);
+    narrowphase_calls += statistics.narrowphase_calls;
+  }
+  EXPECT_GT(narrowphase_calls, 0u);
+
+  // adjacent links overlap in the broadphase, but the ACM allows them to collide
+  const auto it = res.pair_statistics.find({ "panda_link0", "panda_link1" });
+  ASSERT_NE(it, res.pair_statistics.end());
+  EXPECT_GT(it->second.broadphase_candidates, 0u);
+  EXPECT_EQ(it->second.narrowphase_calls, 0u);
+
+  res.clear();
+  EXPECT_TRUE(res.pair_statistics.empty());
+}
+
+/** \brief Octrees are checked through their box hierarchy: coarser checks are conservative, and map updates are seen
+ * by later checks. */
+TEST_F(CollisionDetectionEnvTest, OcTreeCollision)
+{
+  // a wall in front of the robot, out of its reach
+  auto tree = std::make_shared<collision_detection::OccMapTree>(0.02);
+  for (double y = -0.3; y <= 0.3; y += 0.02)
+  {
+    for (double z = 0.0; z <= 0.8; z += 0.02)
+      tree->updateNode(octomap::point3d(0.6, y, z), true);
+  }
+  c_env_->getWorld()->addToObject("octomap", std::make_shared<const shapes::OcTree>(tree),
+                                  Eigen::Isometry3d::Identity());
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  EXPECT_FALSE(res.collision);
+  res.clear();
+
+  // the cells of 0.64m containing the wall contain the robot base as well
+  req.octree_resolution = 0.5;
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  EXPECT_TRUE(res.collision);
+  res.clear();
+
+  req.octree_resolution = 0.0;
+  tree->updateNode(octomap::point3d(0.0, 0.0, 0.1), true);
+  tree->triggerUpdateCallback();
+  req.contacts = true;
+  c_env_->checkRobotCollision(req, res, *robot_state_, *acm_);
+  ASSERT_TRUE(res.collision);
+  ASSERT_EQ(res.contact_count, 1u);
+  const collision_detection::Contact& contact = res.contacts.begin()->second.front();
+  EXPECT_TRUE(contact.body_name_1 == "octomap" || contact.body_name_2 == "octomap");
+}
+
 /** \brief Continuous self collision checks of the robot.
  *
  *  Functionality not supported yet. */
@@ -271,10 +588,8 @@ TEST_F(CollisionDetectionEnvTest, DISABLED_ContinuousCollisionSelf)
   res.clear();
 }
 
-/** \brief Two similar robot poses are used as start and end pose of a continuous collision check.
- *
- *  Functionality not supported yet. */
-TEST_F(CollisionDetectionEnvTest, DISABLED_ContinuousCollisionWorld)
+/** \brief Two similar robot poses are used as start and end pose of a continuous collision check. */
+TEST_F(CollisionDetectionEnvTest, ContinuousCollisionWorld)
 {
   collision_detection::CollisionRequest req;
   req.contacts = true;
@@ -318,7 +633,22 @@ TEST_F(CollisionDetectionEnvTest, DISABLED_ContinuousCollisionWorld)
 
   c_env_->checkRobotCollision(req, res, state1, state2, *acm_);
   ASSERT_TRUE(res.collision);
-  ASSERT_EQ(res.contact_count, 4u);
+  ASSERT_GE(res.contact_count, 1u);
+  for (const auto& contact : res.contacts)
+  {
+    EXPECT_EQ(contact.first.first, "box");
+    for (const collision_detection::Contact& c : contact.second)
+    {
+      EXPECT_GT(c.percent_interpolation, 0.0);
+      EXPECT_LT(c.percent_interpolation, 1.0);
+    }
+  }
+  res.clear();
+
+  // the segment is valid once the box may collide with the robot
+  acm_->setEntry("box", robot_model_->getLinkModelNames(), true);
+  c_env_->checkRobotCollision(req, res, state1, state2, *acm_);
+  ASSERT_FALSE(res.collision);
   res.clear();
 }
 
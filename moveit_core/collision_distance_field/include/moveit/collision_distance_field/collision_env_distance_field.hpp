@@ -42,7 +42,9 @@
 #include <moveit/collision_detection/collision_env.hpp>
 #include <moveit/planning_scene/planning_scene.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <cstdint>
 #include <mutex>
+#include <unordered_map>
 
 namespace collision_detection
 {
@@ -141,6 +143,8 @@ public:
   {
     std::map<std::string, std::vector<PosedBodyPointDecompositionPtr>> posed_body_point_decompositions_;
     distance_field::DistanceFieldPtr distance_field_;
+    /** \brief Number of world objects occupying each obstacle cell of \ref distance_field_, by linear cell index */
+    std::unordered_map<std::int64_t, unsigned int> obstacle_cell_counts_;
   };
 
   ~CollisionEnvDistanceField() override;
@@ -200,6 +204,77 @@ public:
 
   void setWorld(const WorldPtr& world) override;
 
+  /**
+   * \brief Sets how the cells of the distance fields are stored.
+   *
+   * The world distance field is rebuilt right away, the distance
+   * fields of the robot are rebuilt on their next update.
+   * \ref distance_field::BLOCKED_STORAGE only allocates the regions
+   * near obstacles, which keeps large, mostly empty workcells small at
+   * fine resolutions.  Defaults to \ref distance_field::DENSE_STORAGE.
+   */
+  void setDistanceFieldStorage(distance_field::VoxelStorage storage);
+
+  distance_field::VoxelStorage getDistanceFieldStorage() const
+  {
+    return distance_field_storage_;
+  }
+
+  /**
+   * \brief Sets a directory in which world distance fields are kept
+   * between runs.
+   *
+   * A world distance field that is built from scratch is stored there
+   * with all its cells, in a file named after a hash of the world
+   * geometry and the field parameters.  When a field with the same
+   * hash is needed again, for example by the next process started
+   * with the same static scene, the file is read instead of
+   * propagating the field.  Later world changes are applied on top of
+   * the restored field as usual.  The world distance field is rebuilt
+   * right away.  An empty directory, the default, disables the cache.
+   */
+  void setDistanceFieldCacheDirectory(const std::string& directory);
+
+  const std::string& getDistanceFieldCacheDirectory() const
+  {
+    return distance_field_cache_directory_;
+  }
+
+  /**
+   * \brief Sets the number of threads that build and update the
+   * distance fields, see \ref
+   * distance_field::PropagationDistanceField::setPropagationThreadCount.
+   * Defaults to 1.
+   */
+  void setDistanceFieldThreadCount(unsigned int thread_count);
+
+  unsigned int getDistanceFieldThreadCount() const
+  {
+    return distance_field_thread_count_;
+  }
+
+  /**
+   * \brief Sets whether distance fields that are built from scratch
+   * use the exact distance transform of \ref
+   * distance_field::PropagationDistanceField::setPointsInField instead
+   * of propagating from every obstacle point.
+   *
+   * The transform costs the same for any number of obstacle points,
+   * which is much faster when the world field is rebuilt for each plan
+   * in a dense scene.  Its distances are exact, so they can be
+   * slightly smaller than propagated ones.  Incremental updates still
+   * propagate.  Defaults to false.
+   */
+  void setUseExactDistanceTransform(bool use_exact_distance_transform)
+  {
+    use_exact_distance_transform_ = use_exact_distance_transform;
+  }
+
+  bool getUseExactDistanceTransform() const
+  {
+    return use_exact_distance_transform_;
+  }
+
   distance_field::DistanceFieldConstPtr getDistanceField() const
   {
     return distance_field_cache_entry_->distance_field_;
@@ -213,9 +288,38 @@ public:
   void getCollisionGradients(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
                              const AllowedCollisionMatrix* acm, GroupStateRepresentationPtr& gsr) const;
 
+  /**
+   * \brief Computes the collision gradients of many states in one
+   * call, for example of all waypoints of a trajectory that is
+   * being optimized.
+   *
+   * Self and intra group gradients are computed state by state as in
+   * \ref getCollisionGradients.  The environment distances of the
+   * spheres of all states are then looked up in a single batched
+   * query of the world distance field.  That query interpolates the
+   * field trilinearly, so distances and gradients vary continuously
+   * with the sphere locations.
+   *
+   * @param gsrs One representation per state, missing ones are created and existing ones reused
+   */
+  void getCollisionGradients(const CollisionRequest& req, const std::vector<const moveit::core::RobotState*>& states,
+                             const AllowedCollisionMatrix* acm, std::vector<GroupStateRepresentationPtr>& gsrs) const;
+
   void getAllCollisions(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
                         const AllowedCollisionMatrix* acm, GroupStateRepresentationPtr& gsr) const;
 
+  /**
+   * \brief Computes the smallest clearance between the collision
+   * spheres of the group, including its attached bodies, and the
+   * world.  The clearance is negative if a sphere penetrates an
+   * obstacle and is only accurate to about the field resolution.
+   *
+   * @return false if the clearance is unknown, because a sphere is
+   * outside the distance field or larger than the propagation distance
+   */
+  bool getEnvironmentClearance(const std::string& group_name, const moveit::core::RobotState& state,
+                               double& clearance) const;
+
 protected:
   bool getSelfProximityGradients(GroupStateRepresentationPtr& gsr) const;
 
@@ -261,6 +365,13 @@ protected:
   void getGroupStateRepresentation(const DistanceFieldCacheEntryConstPtr& dfce, const moveit::core::RobotState& state,
                                    GroupStateRepresentationPtr& gsr) const;
 
+  /**
+   * \brief Gets a GroupStateRepresentation for dfce posed at state, reusing a pooled one no caller holds anymore
+   * instead of copying the pregenerated representation again.
+   */
+  void acquireGroupStateRepresentation(const DistanceFieldCacheEntryConstPtr& dfce,
+                                       const moveit::core::RobotState& state, GroupStateRepresentationPtr& gsr) const;
+
   bool compareCacheEntryToState(const DistanceFieldCacheEntryConstPtr& dfce,
                                 const moveit::core::RobotState& state) const;
 
@@ -271,9 +382,25 @@ protected:
 
   DistanceFieldCacheEntryWorldPtr generateDistanceFieldCacheEntryWorld();
 
+  /** \brief Creates a distance field with the configured size and build options holding the given points */
+  distance_field::DistanceFieldPtr createDistanceField(const EigenSTL::vector_Vector3d& points) const;
+
+  /** \brief Reads the world distance field for the given points from the cache directory, or creates and stores it */
+  distance_field::DistanceFieldPtr getCachedDistanceField(const EigenSTL::vector_Vector3d& points) const;
+
   void updateDistanceObject(const std::string& id, CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr& dfce,
                             EigenSTL::vector_Vector3d& add_points, EigenSTL::vector_Vector3d& subtract_points);
 
+  /**
+   * \brief Applies the change of one world object from old_points to new_points to the world distance field.
+   *
+   * Cells stay obstacles while any other object still occupies them, and cells already occupied by another object
+   * are not added again, so only the cells that actually change are passed to a single
+   * \ref distance_field::DistanceField::updatePointsInField call.
+   */
+  void updateObstacleCells(DistanceFieldCacheEntryWorld& dfce, const EigenSTL::vector_Vector3d& old_points,
+                           const EigenSTL::vector_Vector3d& new_points) const;
+
   bool getEnvironmentCollisions(const CollisionRequest& req, CollisionResult& res,
                                 const distance_field::DistanceFieldConstPtr& env_distance_field,
                                 GroupStateRepresentationPtr& gsr) const;
@@ -283,6 +410,21 @@ protected:
 
   void notifyObjectChange(const ObjectConstPtr& obj, World::Action action);
 
+  /** \brief Link decompositions and pregenerated group representations that only depend on the robot model and the
+   * decomposition settings, shared by all environments created with the same ones */
+  struct SelfCollisionModel
+  {
+    std::vector<BodyDecompositionConstPtr> link_body_decomposition_vector_;
+    std::map<std::string, unsigned int> link_body_decomposition_index_map_;
+    std::map<std::string, std::map<std::string, bool>> in_group_update_map_;
+    std::map<std::string, GroupStateRepresentationPtr> pregenerated_group_state_representation_map_;
+  };
+
+  /** \brief Fills the link decompositions and pregenerated group representations, reusing the ones of another
+   * environment with the same robot model and settings if there is one */
+  void
+  initializeSelfCollisionModel(const std::map<std::string, std::vector<CollisionSphere>>& link_body_decompositions);
+
   rclcpp::Logger logger_;
 
   Eigen::Vector3d size_;
@@ -291,6 +433,10 @@ protected:
   double resolution_;
   double collision_tolerance_;
   double max_propogation_distance_;
+  distance_field::VoxelStorage distance_field_storage_ = distance_field::DENSE_STORAGE;
+  unsigned int distance_field_thread_count_ = 1;
+  bool use_exact_distance_transform_ = false;
+  std::string distance_field_cache_directory_;
 
   std::vector<BodyDecompositionConstPtr> link_body_decomposition_vector_;
   std::map<std::string, unsigned int> link_body_decomposition_index_map_;
@@ -299,6 +445,10 @@ protected:
   DistanceFieldCacheEntryPtr distance_field_cache_entry_;
   std::map<std::string, std::map<std::string, bool>> in_group_update_map_;
   std::map<std::string, GroupStateRepresentationPtr> pregenerated_group_state_representation_map_;
+  std::shared_ptr<const SelfCollisionModel> self_collision_model_;
+
+  mutable std::mutex group_state_representation_pool_lock_;
+  mutable std::vector<GroupStateRepresentationPtr> group_state_representation_pool_;
 
   planning_scene::PlanningScenePtr planning_scene_;
 
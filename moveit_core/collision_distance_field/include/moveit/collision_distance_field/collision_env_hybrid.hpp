@@ -132,11 +132,39 @@ public:
                                         const moveit::core::RobotState& state, const AllowedCollisionMatrix& acm,
                                         GroupStateRepresentationPtr& gsr) const;
 
+  using CollisionEnvFCL::checkRobotCollision;
+
+  /** \brief Checks the robot against the world. Approximate requests are answered from the collision spheres of the
+   *  distance field when they clear the world or penetrate it by more than the approximate collision margin. States
+   *  in between, requests without a group and requests for contacts, distances or costs are checked exactly. */
+  void checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                           const moveit::core::RobotState& state) const override;
+
+  void checkRobotCollision(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
+                           const AllowedCollisionMatrix& acm) const override;
+
+  /** \brief Sets how far the collision spheres have to clear or penetrate the world for an approximate request to be
+   *  answered from them. It defaults to the diagonal of a distance field cell, the error of the sphere distances. */
+  void setApproximateCollisionMargin(double margin)
+  {
+    approximate_collision_margin_ = margin;
+  }
+
+  double getApproximateCollisionMargin() const
+  {
+    return approximate_collision_margin_;
+  }
+
   void setWorld(const WorldPtr& world) override;
 
   void getCollisionGradients(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
                              const AllowedCollisionMatrix* acm, GroupStateRepresentationPtr& gsr) const;
 
+  /** \brief Computes the distance field collision gradients of many states in one call, see
+   *  CollisionEnvDistanceField::getCollisionGradients */
+  void getCollisionGradients(const CollisionRequest& req, const std::vector<const moveit::core::RobotState*>& states,
+                             const AllowedCollisionMatrix* acm, std::vector<GroupStateRepresentationPtr>& gsrs) const;
+
   void getAllCollisions(const CollisionRequest& req, CollisionResult& res, const moveit::core::RobotState& state,
                         const AllowedCollisionMatrix* acm, GroupStateRepresentationPtr& gsr) const;
 
@@ -145,7 +173,18 @@ public:
     return cenv_distance_;
   }
 
+  /** \brief Gives access to the distance field environment, for example to configure how its fields are built */
+  const CollisionEnvDistanceFieldPtr& getCollisionEnvDistanceField()
+  {
+    return cenv_distance_;
+  }
+
 protected:
+  /** \brief Answers an approximate request from the collision spheres, returns false if it has to be checked exactly */
+  bool checkRobotCollisionApproximate(const CollisionRequest& req, CollisionResult& res,
+                                      const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm) const;
+
   CollisionEnvDistanceFieldPtr cenv_distance_;
+  double approximate_collision_margin_;
 };
 }  // namespace collision_detection
@@ -311,7 +311,16 @@ void BodyDecomposition::init(const std::vector<shapes::ShapeConstPtr>& shapes, c
     body_spheres = determineCollisionSpheres(bodies_.getBody(i), relative_cylinder_pose_);
     collision_spheres_.insert(collision_spheres_.end(), body_spheres.begin(), body_spheres.end());
 
-    distance_field::findInternalPointsConvex(*bodies_.getBody(i), resolution, body_collision_points);
+    // the body of a mesh is its convex hull, so the mesh itself is voxelized instead
+    if (shapes[i]->type == shapes::MESH)
+    {
+      distance_field::findInternalPointsMesh(*static_cast<const shapes::Mesh*>(shapes[i].get()), poses[i], resolution,
+                                             body_collision_points, padding);
+    }
+    else
+    {
+      distance_field::findInternalPointsConvex(*bodies_.getBody(i), resolution, body_collision_points);
+    }
     relative_collision_points_.insert(relative_collision_points_.end(), body_collision_points.begin(),
                                       body_collision_points.end());
   }
@@ -45,13 +45,92 @@
 #include <moveit/collision_distance_field/collision_common_distance_field.hpp>
 #include <moveit/distance_field/propagation_distance_field.hpp>
 #include <moveit/collision_distance_field/collision_detector_allocator_distance_field.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <functional>
+#include <iomanip>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <sstream>
+#include <tuple>
 #include <utility>
 #include <moveit/utils/logger.hpp>
 
 namespace collision_detection
 {
+namespace
+{
+// FNV-1a, which is stable across runs and platforms unlike std::hash
+void hashBytes(std::uint64_t& hash, const void* data, std::size_t size)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+}
+
+template <typename T>
+void hashValue(std::uint64_t& hash, const T& value)
+{
+  hashBytes(hash, &value, sizeof(T));
+}
+
+// sorted linear indices of the distance field cells holding the given points, ignoring points outside the field
+std::vector<std::int64_t> getObstacleCells(const distance_field::DistanceField& field,
+                                           EigenSTL::vector_Vector3d::const_iterator begin,
+                                           EigenSTL::vector_Vector3d::const_iterator end)
+{
+  std::vector<std::int64_t> cells;
+  cells.reserve(end - begin);
+  for (auto it = begin; it != end; ++it)
+  {
+    int x, y, z;
+    if (field.worldToGrid(it->x(), it->y(), it->z(), x, y, z))
+    {
+      cells.push_back((static_cast<std::int64_t>(x) * field.getYNumCells() + y) * field.getZNumCells() + z);
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+  return cells;
+}
+
+Eigen::Vector3d getCellCenter(const distance_field::DistanceField& field, std::int64_t cell)
+{
+  const std::int64_t yz = static_cast<std::int64_t>(field.getYNumCells()) * field.getZNumCells();
+  const int x = static_cast<int>(cell / yz);
+  const int y = static_cast<int>((cell % yz) / field.getZNumCells());
+  const int z = static_cast<int>(cell % field.getZNumCells());
+  Eigen::Vector3d center;
+  field.gridToWorld(x, y, z, center.x(), center.y(), center.z());
+  return center;
+}
+
+// settings that determine the link decompositions and pregenerated group representations
+struct SelfCollisionModelKey
+{
+  const moveit::core::RobotModel* robot_model;
+  double resolution;
+  double max_propogation_distance;
+  bool use_signed_distance_field;
+  std::vector<double> link_paddings;
+  std::vector<std::tuple<std::string, double, double, double, double>> link_spheres;
+
+  bool operator<(const SelfCollisionModelKey& other) const
+  {
+    return std::tie(robot_model, resolution, max_propogation_distance, use_signed_distance_field, link_paddings,
+                    link_spheres) < std::tie(other.robot_model, other.resolution, other.max_propogation_distance,
+                                             other.use_signed_distance_field, other.link_paddings, other.link_spheres);
+  }
+};
+}  // namespace
+
 const double EPSILON = 0.001f;
 
 const std::string collision_detection::CollisionDetectorAllocatorDistanceField::NAME("DISTANCE_FIELD");
@@ -105,11 +184,21 @@ CollisionEnvDistanceField::CollisionEnvDistanceField(const CollisionEnvDistanceF
   resolution_ = other.resolution_;
   collision_tolerance_ = other.collision_tolerance_;
   max_propogation_distance_ = other.max_propogation_distance_;
+  distance_field_storage_ = other.distance_field_storage_;
+  distance_field_thread_count_ = other.distance_field_thread_count_;
+  use_exact_distance_transform_ = other.use_exact_distance_transform_;
+  distance_field_cache_directory_ = other.distance_field_cache_directory_;
   link_body_decomposition_vector_ = other.link_body_decomposition_vector_;
   link_body_decomposition_index_map_ = other.link_body_decomposition_index_map_;
   in_group_update_map_ = other.in_group_update_map_;
   distance_field_cache_entry_world_ = generateDistanceFieldCacheEntryWorld();
   pregenerated_group_state_representation_map_ = other.pregenerated_group_state_representation_map_;
+  self_collision_model_ = other.self_collision_model_;
+  {
+    // the self collision distance field only depends on the robot, so copies keep using it while it stays valid
+    std::scoped_lock slock(other.update_cache_lock_);
+    distance_field_cache_entry_ = other.distance_field_cache_entry_;
+  }
   planning_scene_ = std::make_shared<planning_scene::PlanningScene>(robot_model_);
 
   // request notifications about changes to world
@@ -134,9 +223,51 @@ void CollisionEnvDistanceField::initialize(
   resolution_ = resolution;
   collision_tolerance_ = collision_tolerance;
   max_propogation_distance_ = max_propogation_distance;
+  planning_scene_ = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+  initializeSelfCollisionModel(link_body_decompositions);
+}
+
+void CollisionEnvDistanceField::initializeSelfCollisionModel(
+    const std::map<std::string, std::vector<CollisionSphere>>& link_body_decompositions)
+{
+  // models stay cached while any environment still uses them
+  static std::mutex cache_lock;
+  static std::map<SelfCollisionModelKey, std::weak_ptr<const SelfCollisionModel>> cache;
+
+  SelfCollisionModelKey key{ robot_model_.get(), resolution_, max_propogation_distance_, use_signed_distance_field_,
+                             {}, {} };
+  for (const moveit::core::LinkModel* link_model : robot_model_->getLinkModelsWithCollisionGeometry())
+  {
+    key.link_paddings.push_back(getLinkPadding(link_model->getName()));
+  }
+  for (const std::pair<const std::string, std::vector<CollisionSphere>>& link_spheres : link_body_decompositions)
+  {
+    for (const CollisionSphere& sphere : link_spheres.second)
+    {
+      key.link_spheres.emplace_back(link_spheres.first, sphere.relative_vec_.x(), sphere.relative_vec_.y(),
+                                    sphere.relative_vec_.z(), sphere.radius_);
+    }
+  }
+
+  std::scoped_lock slock(cache_lock);
+  std::shared_ptr<const SelfCollisionModel> model;
+  auto it = cache.find(key);
+  if (it != cache.end())
+    model = it->second.lock();
+
+  if (model)
+  {
+    RCLCPP_DEBUG(logger_, "Reusing the self collision model of another environment");
+    link_body_decomposition_vector_ = model->link_body_decomposition_vector_;
+    link_body_decomposition_index_map_ = model->link_body_decomposition_index_map_;
+    in_group_update_map_ = model->in_group_update_map_;
+    pregenerated_group_state_representation_map_ = model->pregenerated_group_state_representation_map_;
+    self_collision_model_ = model;
+    return;
+  }
+
   addLinkBodyDecompositions(resolution_, link_body_decompositions);
   moveit::core::RobotState state(robot_model_);
-  planning_scene_ = std::make_shared<planning_scene::PlanningScene>(robot_model_);
 
   const std::vector<const moveit::core::JointModelGroup*>& jmg = robot_model_->getJointModelGroups();
   for (const moveit::core::JointModelGroup* jm : jmg)
@@ -153,6 +284,26 @@ void CollisionEnvDistanceField::initialize(
         generateDistanceFieldCacheEntry(jm->getName(), state, &planning_scene_->getAllowedCollisionMatrix(), false);
     getGroupStateRepresentation(dfce, state, pregenerated_group_state_representation_map_[jm->getName()]);
   }
+
+  auto new_model = std::make_shared<SelfCollisionModel>();
+  new_model->link_body_decomposition_vector_ = link_body_decomposition_vector_;
+  new_model->link_body_decomposition_index_map_ = link_body_decomposition_index_map_;
+  new_model->in_group_update_map_ = in_group_update_map_;
+  new_model->pregenerated_group_state_representation_map_ = pregenerated_group_state_representation_map_;
+  self_collision_model_ = new_model;
+
+  for (auto entry = cache.begin(); entry != cache.end();)
+  {
+    if (entry->second.expired())
+    {
+      entry = cache.erase(entry);
+    }
+    else
+    {
+      ++entry;
+    }
+  }
+  cache[key] = self_collision_model_;
 }
 
 void CollisionEnvDistanceField::generateCollisionCheckingStructures(
@@ -171,7 +322,7 @@ void CollisionEnvDistanceField::generateCollisionCheckingStructures(
     (const_cast<CollisionEnvDistanceField*>(this))->distance_field_cache_entry_ = new_dfce;
     dfce = new_dfce;
   }
-  getGroupStateRepresentation(dfce, state, gsr);
+  acquireGroupStateRepresentation(dfce, state, gsr);
 }
 
 void CollisionEnvDistanceField::checkSelfCollisionHelper(const collision_detection::CollisionRequest& req,
@@ -928,10 +1079,6 @@ DistanceFieldCacheEntryPtr CollisionEnvDistanceField::generateDistanceFieldCache
               getAttachedBodyPointDecomposition(attached_body, resolution_));
         }
       }
-      dfce->distance_field_ = std::make_shared<distance_field::PropagationDistanceField>(
-          size_.x(), size_.y(), size_.z(), resolution_, origin_.x() - 0.5 * size_.x(), origin_.y() - 0.5 * size_.y(),
-          origin_.z() - 0.5 * size_.z(), max_propogation_distance_, use_signed_distance_field_);
-
       // TODO - deal with AllowedCollisionMatrix
       // now we need to actually set the points
       // TODO - deal with shifted robot
@@ -950,7 +1097,7 @@ DistanceFieldCacheEntryPtr CollisionEnvDistanceField::generateDistanceFieldCache
         all_points.insert(all_points.end(), collision_points.begin(), collision_points.end());
       }
 
-      dfce->distance_field_->addPointsToField(all_points);
+      dfce->distance_field_ = createDistanceField(all_points);
       RCLCPP_DEBUG(logger_, "CollisionRobot distance field has been initialized with %zu points.", all_points.size());
     }
   }
@@ -1129,8 +1276,7 @@ void CollisionEnvDistanceField::updateGroupStateRepresentationState(const moveit
       continue;
     }
 
-    // TODO: This logic for checking attached body count might be incorrect
-    if (gsr->attached_body_decompositions_.size() != att->getShapes().size())
+    if (gsr->attached_body_decompositions_[i]->getSize() != att->getShapes().size())
     {
       RCLCPP_WARN(logger_, "Attached body size discrepancy");
       continue;
@@ -1251,6 +1397,47 @@ void CollisionEnvDistanceField::getGroupStateRepresentation(const DistanceFieldC
   }
 }
 
+void CollisionEnvDistanceField::acquireGroupStateRepresentation(const DistanceFieldCacheEntryConstPtr& dfce,
+                                                                const moveit::core::RobotState& state,
+                                                                GroupStateRepresentationPtr& gsr) const
+{
+  static const std::size_t MAX_POOLED_GROUP_STATE_REPRESENTATIONS = 16;
+
+  GroupStateRepresentationPtr pooled_gsr;
+  {
+    std::scoped_lock slock(group_state_representation_pool_lock_);
+    // representations of replaced cache entries are never handed out again
+    group_state_representation_pool_.erase(
+        std::remove_if(group_state_representation_pool_.begin(), group_state_representation_pool_.end(),
+                       [&dfce](const GroupStateRepresentationPtr& pooled) {
+                         return pooled.use_count() == 1 && pooled->dfce_ != dfce;
+                       }),
+        group_state_representation_pool_.end());
+
+    // the pool holds the only reference once no caller uses a representation anymore
+    for (const GroupStateRepresentationPtr& pooled : group_state_representation_pool_)
+    {
+      if (pooled.use_count() == 1)
+      {
+        pooled_gsr = pooled;
+        break;
+      }
+    }
+  }
+
+  if (pooled_gsr)
+  {
+    gsr = pooled_gsr;
+    updateGroupStateRepresentationState(state, gsr);
+    return;
+  }
+
+  getGroupStateRepresentation(dfce, state, gsr);
+  std::scoped_lock slock(group_state_representation_pool_lock_);
+  if (group_state_representation_pool_.size() < MAX_POOLED_GROUP_STATE_REPRESENTATIONS)
+    group_state_representation_pool_.push_back(gsr);
+}
+
 bool CollisionEnvDistanceField::compareCacheEntryToState(const DistanceFieldCacheEntryConstPtr& dfce,
                                                          const moveit::core::RobotState& state) const
 {
@@ -1537,6 +1724,83 @@ void CollisionEnvDistanceField::getCollisionGradients(const CollisionRequest& re
   (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsr;
 }
 
+void CollisionEnvDistanceField::getCollisionGradients(const CollisionRequest& req,
+                                                      const std::vector<const moveit::core::RobotState*>& states,
+                                                      const AllowedCollisionMatrix* acm,
+                                                      std::vector<GroupStateRepresentationPtr>& gsrs) const
+{
+  gsrs.resize(states.size());
+  EigenSTL::vector_Vector3d sphere_centers;
+  for (std::size_t s{ 0 }; s < states.size(); ++s)
+  {
+    GroupStateRepresentationPtr& gsr = gsrs[s];
+    if (!gsr)
+    {
+      generateCollisionCheckingStructures(req.group_name, *states[s], acm, gsr, true);
+    }
+    else
+    {
+      updateGroupStateRepresentationState(*states[s], gsr);
+    }
+
+    // the link distance fields are shared between representations, so they are used before the next state is posed
+    getSelfProximityGradients(gsr);
+    getIntraGroupProximityGradients(gsr);
+
+    for (unsigned int i{ 0 }; i < gsr->dfce_->link_names_.size(); ++i)
+    {
+      if (gsr->dfce_->link_has_geometry_[i])
+      {
+        const EigenSTL::vector_Vector3d& centers = gsr->link_body_decompositions_[i]->getSphereCenters();
+        sphere_centers.insert(sphere_centers.end(), centers.begin(), centers.end());
+      }
+    }
+  }
+
+  if (states.empty())
+    return;
+
+  std::vector<double> distances;
+  EigenSTL::vector_Vector3d gradients;
+  distance_field_cache_entry_world_->distance_field_->getInterpolatedDistanceGradients(sphere_centers, distances,
+                                                                                        gradients);
+
+  // distribute the results in the same order the sphere centers were collected
+  std::size_t index{ 0 };
+  for (GroupStateRepresentationPtr& gsr : gsrs)
+  {
+    for (unsigned int i{ 0 }; i < gsr->dfce_->link_names_.size(); ++i)
+    {
+      if (!gsr->dfce_->link_has_geometry_[i])
+      {
+        continue;
+      }
+
+      GradientInfo& gradient = gsr->gradients_[i];
+      const std::size_t num_spheres = gsr->link_body_decompositions_[i]->getCollisionSpheres().size();
+      for (std::size_t k{ 0 }; k < num_spheres; ++k, ++index)
+      {
+        // out of bounds spheres get the uninitialized distance, which is not below the propagation distance
+        const double dist = distances[index];
+        if (dist >= max_propogation_distance_)
+        {
+          continue;
+        }
+
+        gradient.closest_distance = std::min(gradient.closest_distance, dist);
+        if (dist < gradient.distances[k])
+        {
+          gradient.types[k] = ENVIRONMENT;
+          gradient.distances[k] = dist;
+          gradient.gradients[k] = gradients[index];
+        }
+      }
+    }
+  }
+
+  (const_cast<CollisionEnvDistanceField*>(this))->last_gsr_ = gsrs.back();
+}
+
 void CollisionEnvDistanceField::getAllCollisions(const CollisionRequest& req, CollisionResult& res,
                                                  const moveit::core::RobotState& state,
                                                  const AllowedCollisionMatrix* acm,
@@ -1680,6 +1944,59 @@ bool CollisionEnvDistanceField::getEnvironmentProximityGradients(
   return in_collision;
 }
 
+bool CollisionEnvDistanceField::getEnvironmentClearance(const std::string& group_name,
+                                                        const moveit::core::RobotState& state, double& clearance) const
+{
+  if (!robot_model_->hasJointModelGroup(group_name))
+    return false;
+
+  distance_field::DistanceFieldConstPtr env_distance_field = distance_field_cache_entry_world_->distance_field_;
+  GroupStateRepresentationPtr gsr;
+  generateCollisionCheckingStructures(group_name, state, nullptr, gsr, false);
+
+  clearance = std::numeric_limits<double>::max();
+  for (unsigned int i{ 0 }; i < gsr->dfce_->link_names_.size() + gsr->dfce_->attached_body_names_.size(); ++i)
+  {
+    bool is_link = i < gsr->dfce_->link_names_.size();
+    if (is_link && !gsr->dfce_->link_has_geometry_[i])
+    {
+      continue;
+    }
+
+    const std::vector<CollisionSphere>* spheres;
+    const EigenSTL::vector_Vector3d* centers;
+    if (is_link)
+    {
+      spheres = &(gsr->link_body_decompositions_[i]->getCollisionSpheres());
+      centers = &(gsr->link_body_decompositions_[i]->getSphereCenters());
+    }
+    else
+    {
+      spheres = &(gsr->attached_body_decompositions_[i - gsr->dfce_->link_names_.size()]->getCollisionSpheres());
+      centers = &(gsr->attached_body_decompositions_[i - gsr->dfce_->link_names_.size()]->getSphereCenters());
+    }
+    for (std::size_t j{ 0 }; j < spheres->size(); ++j)
+    {
+      const Eigen::Vector3d& center = (*centers)[j];
+      const double radius = (*spheres)[j].radius_;
+      int x, y, z;
+      if (!env_distance_field->worldToGrid(center.x(), center.y(), center.z(), x, y, z))
+        return false;
+
+      // distances saturate at the propagation distance, so farther spheres only bound the clearance from below
+      double dist = env_distance_field->getDistance(x, y, z);
+      if (dist >= max_propogation_distance_)
+      {
+        if (radius > max_propogation_distance_)
+          return false;
+        dist = max_propogation_distance_;
+      }
+      clearance = std::min(clearance, dist - radius);
+    }
+  }
+  return true;
+}
+
 void CollisionEnvDistanceField::setWorld(const WorldPtr& world)
 {
   if (world == getWorld())
@@ -1690,6 +2007,8 @@ void CollisionEnvDistanceField::setWorld(const WorldPtr& world)
 
   // clear out objects from old world
   distance_field_cache_entry_world_->distance_field_->reset();
+  distance_field_cache_entry_world_->posed_body_point_decompositions_.clear();
+  distance_field_cache_entry_world_->obstacle_cell_counts_.clear();
 
   CollisionEnv::setWorld(world);
 
@@ -1701,7 +2020,37 @@ void CollisionEnvDistanceField::setWorld(const WorldPtr& world)
   getWorld()->notifyObserverAllObjects(observer_handle_, World::CREATE);
 }
 
-void CollisionEnvDistanceField::notifyObjectChange(const ObjectConstPtr& obj, World::Action action)
+void CollisionEnvDistanceField::setDistanceFieldStorage(distance_field::VoxelStorage storage)
+{
+  if (storage == distance_field_storage_)
+    return;
+  distance_field_storage_ = storage;
+
+  distance_field_cache_entry_world_ = generateDistanceFieldCacheEntryWorld();
+  std::scoped_lock slock(update_cache_lock_);
+  distance_field_cache_entry_.reset();
+}
+
+void CollisionEnvDistanceField::setDistanceFieldCacheDirectory(const std::string& directory)
+{
+  if (directory == distance_field_cache_directory_)
+    return;
+  distance_field_cache_directory_ = directory;
+
+  distance_field_cache_entry_world_ = generateDistanceFieldCacheEntryWorld();
+}
+
+void CollisionEnvDistanceField::setDistanceFieldThreadCount(unsigned int thread_count)
+{
+  distance_field_thread_count_ = std::max(thread_count, 1u);
+  // all distance fields are created by createDistanceField
+  std::static_pointer_cast<distance_field::PropagationDistanceField>(distance_field_cache_entry_world_->distance_field_)
+      ->setPropagationThreadCount(distance_field_thread_count_);
+  std::scoped_lock slock(update_cache_lock_);
+  distance_field_cache_entry_.reset();
+}
+
+void CollisionEnvDistanceField::notifyObjectChange(const ObjectConstPtr& obj, World::Action /*action*/)
 {
   rclcpp::Clock clock;
   rclcpp::Time start_time = clock.now();
@@ -1710,21 +2059,46 @@ void CollisionEnvDistanceField::notifyObjectChange(const ObjectConstPtr& obj, Wo
   EigenSTL::vector_Vector3d subtract_points;
   updateDistanceObject(obj->id_, distance_field_cache_entry_world_, add_points, subtract_points);
 
-  if (action == World::DESTROY)
-  {
-    distance_field_cache_entry_world_->distance_field_->removePointsFromField(subtract_points);
-  }
-  else if (action & (World::MOVE_SHAPE | World::REMOVE_SHAPE))
-  {
-    distance_field_cache_entry_world_->distance_field_->removePointsFromField(subtract_points);
-    distance_field_cache_entry_world_->distance_field_->addPointsToField(add_points);
+  // creation, destruction and moves all reduce to the difference between the old and the new points
+  updateObstacleCells(*distance_field_cache_entry_world_, subtract_points, add_points);
+
+  RCLCPP_DEBUG(logger_, "Modifying object %s took %lf s", obj->id_.c_str(), (clock.now() - start_time).seconds());
+}
+
+void CollisionEnvDistanceField::updateObstacleCells(DistanceFieldCacheEntryWorld& dfce,
+                                                    const EigenSTL::vector_Vector3d& old_points,
+                                                    const EigenSTL::vector_Vector3d& new_points) const
+{
+  distance_field::DistanceField& field = *dfce.distance_field_;
+  const std::vector<std::int64_t> old_cells = getObstacleCells(field, old_points.begin(), old_points.end());
+  const std::vector<std::int64_t> new_cells = getObstacleCells(field, new_points.begin(), new_points.end());
+
+  std::vector<std::int64_t> changed_cells;
+  std::set_difference(old_cells.begin(), old_cells.end(), new_cells.begin(), new_cells.end(),
+                      std::back_inserter(changed_cells));
+  EigenSTL::vector_Vector3d removed_points;
+  for (std::int64_t cell : changed_cells)
+  {
+    auto it = dfce.obstacle_cell_counts_.find(cell);
+    if (it != dfce.obstacle_cell_counts_.end() && --it->second == 0)
+    {
+      dfce.obstacle_cell_counts_.erase(it);
+      removed_points.push_back(getCellCenter(field, cell));
+    }
   }
-  else
+
+  changed_cells.clear();
+  std::set_difference(new_cells.begin(), new_cells.end(), old_cells.begin(), old_cells.end(),
+                      std::back_inserter(changed_cells));
+  EigenSTL::vector_Vector3d added_points;
+  for (std::int64_t cell : changed_cells)
   {
-    distance_field_cache_entry_world_->distance_field_->addPointsToField(add_points);
+    if (++dfce.obstacle_cell_counts_[cell] == 1)
+      added_points.push_back(getCellCenter(field, cell));
   }
 
-  RCLCPP_DEBUG(logger_, "Modifying object %s took %lf s", obj->id_.c_str(), (clock.now() - start_time).seconds());
+  if (!removed_points.empty() || !added_points.empty())
+    field.updatePointsInField(removed_points, added_points);
 }
 
 void CollisionEnvDistanceField::updateDistanceObject(const std::string& id, DistanceFieldCacheEntryWorldPtr& dfce,
@@ -1782,17 +2156,102 @@ CollisionEnvDistanceField::DistanceFieldCacheEntryWorldPtr
 CollisionEnvDistanceField::generateDistanceFieldCacheEntryWorld()
 {
   DistanceFieldCacheEntryWorldPtr dfce = std::make_shared<DistanceFieldCacheEntryWorld>();
-  dfce->distance_field_ = std::make_shared<distance_field::PropagationDistanceField>(
-      size_.x(), size_.y(), size_.z(), resolution_, origin_.x() - 0.5 * size_.x(), origin_.y() - 0.5 * size_.y(),
-      origin_.z() - 0.5 * size_.z(), max_propogation_distance_, use_signed_distance_field_);
 
   EigenSTL::vector_Vector3d add_points;
   EigenSTL::vector_Vector3d subtract_points;
+  std::vector<std::size_t> object_ends;
   for (const std::pair<const std::string, ObjectPtr>& object : *getWorld())
   {
     updateDistanceObject(object.first, dfce, add_points, subtract_points);
+    object_ends.push_back(add_points.size());
+  }
+  dfce->distance_field_ =
+      distance_field_cache_directory_.empty() ? createDistanceField(add_points) : getCachedDistanceField(add_points);
+
+  // count every object once per occupied cell so that later changes only touch cells no other object occupies
+  std::size_t object_begin = 0;
+  for (std::size_t object_end : object_ends)
+  {
+    for (std::int64_t cell : getObstacleCells(*dfce->distance_field_, add_points.begin() + object_begin,
+                                              add_points.begin() + object_end))
+      ++dfce->obstacle_cell_counts_[cell];
+    object_begin = object_end;
   }
-  dfce->distance_field_->addPointsToField(add_points);
   return dfce;
 }
+
+distance_field::DistanceFieldPtr
+CollisionEnvDistanceField::createDistanceField(const EigenSTL::vector_Vector3d& points) const
+{
+  auto distance_field = std::make_shared<distance_field::PropagationDistanceField>(
+      size_.x(), size_.y(), size_.z(), resolution_, origin_.x() - 0.5 * size_.x(), origin_.y() - 0.5 * size_.y(),
+      origin_.z() - 0.5 * size_.z(), max_propogation_distance_, use_signed_distance_field_, distance_field_storage_);
+  distance_field->setPropagationThreadCount(distance_field_thread_count_);
+  if (use_exact_distance_transform_)
+    distance_field->setPointsInField(points);
+  else
+    distance_field->addPointsToField(points);
+  return distance_field;
+}
+
+distance_field::DistanceFieldPtr
+CollisionEnvDistanceField::getCachedDistanceField(const EigenSTL::vector_Vector3d& points) const
+{
+  // the key covers everything the cells depend on, the points are hashed as the cells they fall into
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (int i = 0; i < 3; ++i)
+  {
+    hashValue(hash, size_[i]);
+    hashValue(hash, origin_[i]);
+  }
+  hashValue(hash, resolution_);
+  hashValue(hash, max_propogation_distance_);
+  hashValue(hash, use_signed_distance_field_);
+  hashValue(hash, use_exact_distance_transform_);
+  for (const Eigen::Vector3d& point : points)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      hashValue(hash, static_cast<std::int64_t>(std::floor(point[i] / resolution_)));
+    }
+  }
+
+  std::stringstream name;
+  name << "world_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".df";
+  const std::filesystem::path path = std::filesystem::path(distance_field_cache_directory_) / name.str();
+
+  // all distance fields are created by createDistanceField
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  if (in)
+  {
+    auto field = std::static_pointer_cast<distance_field::PropagationDistanceField>(
+        createDistanceField(EigenSTL::vector_Vector3d()));
+    if (field->readCellsFromStream(in))
+    {
+      RCLCPP_DEBUG(logger_, "Read world distance field from %s", path.string().c_str());
+      return field;
+    }
+    RCLCPP_WARN(logger_, "Ignoring unreadable distance field cache file %s", path.string().c_str());
+  }
+
+  auto field = std::static_pointer_cast<distance_field::PropagationDistanceField>(createDistanceField(points));
+
+  // write to a file of our own first, so that other processes never read a partial file
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  std::filesystem::path temporary_path = path;
+  temporary_path += ".tmp" + std::to_string(reinterpret_cast<std::uintptr_t>(this));
+  std::ofstream out(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  bool written = out && field->writeCellsToStream(out);
+  out.close();
+  written = written && !out.fail();
+  if (written)
+    std::filesystem::rename(temporary_path, path, ec);
+  if (!written || ec)
+  {
+    RCLCPP_WARN(logger_, "Could not store world distance field in %s", path.string().c_str());
+    std::filesystem::remove(temporary_path, ec);
+  }
+  return field;
+}
 }  // namespace collision_detection
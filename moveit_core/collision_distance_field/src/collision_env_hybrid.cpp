@@ -37,6 +37,8 @@
 #include <moveit/collision_distance_field/collision_detector_allocator_hybrid.hpp>
 #include <moveit/collision_distance_field/collision_env_hybrid.hpp>
 
+#include <cmath>
+
 namespace collision_detection
 {
 const std::string collision_detection::CollisionDetectorAllocatorHybrid::NAME("HYBRID");
@@ -50,6 +52,7 @@ CollisionEnvHybrid::CollisionEnvHybrid(
   , cenv_distance_(std::make_shared<collision_detection::CollisionEnvDistanceField>(
         robot_model, getWorld(), link_body_decompositions, size_x, size_y, size_z, origin, use_signed_distance_field,
         resolution, collision_tolerance, max_propogation_distance, padding, scale))
+  , approximate_collision_margin_(std::sqrt(3.0) * resolution)
 {
 }
 
@@ -62,6 +65,7 @@ CollisionEnvHybrid::CollisionEnvHybrid(
   , cenv_distance_(std::make_shared<collision_detection::CollisionEnvDistanceField>(
         robot_model, getWorld(), link_body_decompositions, size_x, size_y, size_z, origin, use_signed_distance_field,
         resolution, collision_tolerance, max_propogation_distance, padding, scale))
+  , approximate_collision_margin_(std::sqrt(3.0) * resolution)
 {
 }
 
@@ -69,6 +73,7 @@ CollisionEnvHybrid::CollisionEnvHybrid(const CollisionEnvHybrid& other, const Wo
   : CollisionEnvFCL(other, world)
   , cenv_distance_(std::make_shared<collision_detection::CollisionEnvDistanceField>(
         *other.getCollisionWorldDistanceField(), world))
+  , approximate_collision_margin_(other.approximate_collision_margin_)
 {
 }
 
@@ -160,6 +165,53 @@ void CollisionEnvHybrid::checkRobotCollisionDistanceField(const CollisionRequest
   cenv_distance_->checkRobotCollision(req, res, state, acm, gsr);
 }
 
+void CollisionEnvHybrid::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                             const moveit::core::RobotState& state) const
+{
+  if (!checkRobotCollisionApproximate(req, res, state, nullptr))
+    CollisionEnvFCL::checkRobotCollision(req, res, state);
+}
+
+void CollisionEnvHybrid::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                             const moveit::core::RobotState& state,
+                                             const AllowedCollisionMatrix& acm) const
+{
+  if (!checkRobotCollisionApproximate(req, res, state, &acm))
+    CollisionEnvFCL::checkRobotCollision(req, res, state, acm);
+}
+
+bool CollisionEnvHybrid::checkRobotCollisionApproximate(const CollisionRequest& req, CollisionResult& res,
+                                                        const moveit::core::RobotState& state,
+                                                        const AllowedCollisionMatrix* acm) const
+{
+  if (!req.approximate || req.contacts || req.distance || req.cost)
+    return false;
+
+  double clearance;
+  if (!cenv_distance_->getEnvironmentClearance(req.group_name, state, clearance))
+    return false;
+
+  if (clearance >= approximate_collision_margin_)
+    return true;
+
+  if (clearance <= -approximate_collision_margin_)
+  {
+    // the world distance field merges all objects, so it cannot tell whether the matrix allows the contact
+    if (acm)
+    {
+      AllowedCollision::Type type;
+      for (const auto& object : *getWorld())
+      {
+        if (acm->hasEntry(object.first) || acm->getDefaultEntry(object.first, type))
+          return false;
+      }
+    }
+    res.collision = true;
+    return true;
+  }
+  return false;
+}
+
 void CollisionEnvHybrid::setWorld(const WorldPtr& world)
 {
   if (world == getWorld())
@@ -176,6 +228,14 @@ void CollisionEnvHybrid::getCollisionGradients(const CollisionRequest& req, Coll
   cenv_distance_->getCollisionGradients(req, res, state, acm, gsr);
 }
 
+void CollisionEnvHybrid::getCollisionGradients(const CollisionRequest& req,
+                                               const std::vector<const moveit::core::RobotState*>& states,
+                                               const AllowedCollisionMatrix* acm,
+                                               std::vector<GroupStateRepresentationPtr>& gsrs) const
+{
+  cenv_distance_->getCollisionGradients(req, states, acm, gsrs);
+}
+
 void CollisionEnvHybrid::getAllCollisions(const CollisionRequest& req, CollisionResult& res,
                                           const moveit::core::RobotState& state, const AllowedCollisionMatrix* acm,
                                           GroupStateRepresentationPtr& gsr) const
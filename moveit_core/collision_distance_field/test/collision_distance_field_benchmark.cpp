@@ -0,0 +1,167 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Benchmarks for keeping the world distance field of CollisionEnvDistanceField up to date and for querying it.
+// To run this benchmark, 'cd' to the build/moveit_core/collision_distance_field directory and directly run the binary.
+
+#include <benchmark/benchmark.h>
+#include <geometric_shapes/shapes.h>
+#include <moveit/collision_distance_field/collision_env_distance_field.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Exposes the world distance field rebuild for comparison with the incremental updates
+class BenchmarkCollisionEnv : public collision_detection::CollisionEnvDistanceField
+{
+public:
+  using collision_detection::CollisionEnvDistanceField::CollisionEnvDistanceField;
+
+  void rebuildWorldDistanceField()
+  {
+    distance_field_cache_entry_world_ = generateDistanceFieldCacheEntryWorld();
+  }
+};
+
+// Creates an environment holding a row of boxes, the first of which is moved by the benchmarks
+std::shared_ptr<BenchmarkCollisionEnv>
+createEnvironment(int num_boxes, double resolution = collision_detection::DEFAULT_RESOLUTION)
+{
+  const moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  std::map<std::string, std::vector<collision_detection::CollisionSphere>> link_body_decompositions;
+  auto env = std::make_shared<BenchmarkCollisionEnv>(
+      robot_model, link_body_decompositions, collision_detection::DEFAULT_SIZE_X, collision_detection::DEFAULT_SIZE_Y,
+      collision_detection::DEFAULT_SIZE_Z, Eigen::Vector3d::Zero(),
+      collision_detection::DEFAULT_USE_SIGNED_DISTANCE_FIELD, resolution);
+  for (int i = 0; i < num_boxes; ++i)
+  {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation() = Eigen::Vector3d(-1.2 + 2.4 * i / num_boxes, 1.0, 0.5);
+    env->getWorld()->addToObject("box" + std::to_string(i), std::make_shared<const shapes::Box>(.1, .1, .1), pose);
+  }
+  return env;
+}
+
+Eigen::Isometry3d getMovedPose(std::size_t iteration)
+{
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(-1.2, 1.0 - 0.02 * (iteration % 2), 0.5);
+  return pose;
+}
+
+// Random right arm configurations of the PR2, which move the arm spheres through the row of boxes
+std::vector<moveit::core::RobotState> createArmStates(const moveit::core::RobotModelConstPtr& robot_model)
+{
+  std::vector<moveit::core::RobotState> states;
+  random_numbers::RandomNumberGenerator generator(42);
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("right_arm");
+  for (int i = 0; i < 100; ++i)
+  {
+    moveit::core::RobotState state(robot_model);
+    state.setToDefaultValues();
+    state.setToRandomPositions(group, generator);
+    state.update();
+    states.push_back(state);
+  }
+  return states;
+}
+}  // namespace
+
+// Moves one box in a scene and lets the environment update only the changed cells.
+static void incrementalObjectUpdate(benchmark::State& st)
+{
+  const std::shared_ptr<BenchmarkCollisionEnv> env = createEnvironment(st.range(0));
+  std::size_t iteration = 0;
+  for (auto _ : st)
+    env->getWorld()->setObjectPose("box0", getMovedPose(++iteration));
+}
+
+// Moves one box in a scene and propagates the whole world distance field again.
+static void fullRebuildObjectUpdate(benchmark::State& st)
+{
+  const std::shared_ptr<BenchmarkCollisionEnv> env = createEnvironment(st.range(0));
+  std::size_t iteration = 0;
+  for (auto _ : st)
+  {
+    st.PauseTiming();
+    env->getWorld()->setObjectPose("box0", getMovedPose(++iteration));
+    st.ResumeTiming();
+    env->rebuildWorldDistanceField();
+  }
+}
+
+// Checks the spheres of the right arm against the world for a batch of states, at the resolution in millimeters.
+static void sphereCollisionQueries(benchmark::State& st)
+{
+  const std::shared_ptr<BenchmarkCollisionEnv> env = createEnvironment(16, st.range(0) * 1e-3);
+  const std::vector<moveit::core::RobotState> states = createArmStates(env->getRobotModel());
+  collision_detection::CollisionRequest req;
+  req.group_name = "right_arm";
+  for (auto _ : st)
+  {
+    for (const moveit::core::RobotState& state : states)
+    {
+      collision_detection::CollisionResult res;
+      env->checkRobotCollision(req, res, state);
+      benchmark::DoNotOptimize(res.collision);
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * states.size());
+}
+
+// Computes the collision gradients of the right arm spheres for a batch of states in one call.
+static void sphereGradientQueries(benchmark::State& st)
+{
+  const std::shared_ptr<BenchmarkCollisionEnv> env = createEnvironment(16, st.range(0) * 1e-3);
+  const std::vector<moveit::core::RobotState> states = createArmStates(env->getRobotModel());
+  std::vector<const moveit::core::RobotState*> state_pointers;
+  for (const moveit::core::RobotState& state : states)
+    state_pointers.push_back(&state);
+  collision_detection::CollisionRequest req;
+  req.group_name = "right_arm";
+  std::vector<collision_detection::GroupStateRepresentationPtr> gsrs;
+  for (auto _ : st)
+  {
+    env->getCollisionGradients(req, state_pointers, nullptr, gsrs);
+  }
+  st.SetItemsProcessed(st.iterations() * states.size());
+}
+
+BENCHMARK(incrementalObjectUpdate)->RangeMultiplier(4)->Range(1, 64)->Unit(benchmark::kMillisecond);
+BENCHMARK(fullRebuildObjectUpdate)->RangeMultiplier(4)->Range(1, 64)->Unit(benchmark::kMillisecond);
+BENCHMARK(sphereCollisionQueries)->Arg(40)->Arg(20)->Arg(10)->Unit(benchmark::kMillisecond);
+BENCHMARK(sphereGradientQueries)->Arg(40)->Arg(20)->Arg(10)->Unit(benchmark::kMillisecond);
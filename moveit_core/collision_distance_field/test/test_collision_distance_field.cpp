@@ -39,19 +39,34 @@
 #include <moveit/transforms/transforms.hpp>
 #include <moveit/collision_distance_field/collision_distance_field_types.hpp>
 #include <moveit/collision_distance_field/collision_env_distance_field.hpp>
+#include <moveit/collision_distance_field/collision_env_hybrid.hpp>
 #include <moveit/utils/robot_model_test_utils.hpp>
 
 #include <geometric_shapes/shape_operations.h>
 #include <urdf_parser/urdf_parser.h>
 
+#include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <ctype.h>
 
 typedef collision_detection::CollisionEnvDistanceField DefaultCEnvType;
 
+// exposes the self collision model that environments of the same robot model share
+class SharedModelCEnvType : public DefaultCEnvType
+{
+public:
+  using DefaultCEnvType::DefaultCEnvType;
+
+  auto getSelfCollisionModel() const
+  {
+    return self_collision_model_;
+  }
+};
+
 class DistanceFieldCollisionDetectionTester : public testing::Test
 {
 protected:
@@ -330,6 +345,311 @@ TEST_F(DistanceFieldCollisionDetectionTester, AttachedBodyTester)
   ASSERT_TRUE(res.collision);
 }
 
+TEST_F(DistanceFieldCollisionDetectionTester, BlockedStorage)
+{
+  auto cenv = std::static_pointer_cast<DefaultCEnvType>(cenv_);
+  cenv->setDistanceFieldStorage(distance_field::BLOCKED_STORAGE);
+  EXPECT_EQ(cenv->getDistanceFieldStorage(), distance_field::BLOCKED_STORAGE);
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  req.group_name = "right_arm";
+
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  Eigen::Isometry3d pos1 = Eigen::Isometry3d::Identity();
+  pos1.translation().x() = 1.0;
+  robot_state.updateStateWithLinkAt("r_gripper_palm_link", pos1);
+  cenv->checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+
+  cenv->getWorld()->addToObject("box", std::make_shared<const shapes::Box>(.25, .25, .25), pos1);
+  res = collision_detection::CollisionResult();
+  cenv->checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+
+  cenv->getWorld()->removeObject("box");
+  res = collision_detection::CollisionResult();
+  cenv->checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+}
+
+TEST_F(DistanceFieldCollisionDetectionTester, ExactDistanceTransform)
+{
+  auto cenv = std::static_pointer_cast<DefaultCEnvType>(cenv_);
+  cenv->setUseExactDistanceTransform(true);
+  cenv->setDistanceFieldThreadCount(2);
+  EXPECT_TRUE(cenv->getUseExactDistanceTransform());
+  EXPECT_EQ(cenv->getDistanceFieldThreadCount(), 2u);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = "right_arm";
+
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  Eigen::Isometry3d pos1 = Eigen::Isometry3d::Identity();
+  pos1.translation().x() = 1.0;
+  robot_state.updateStateWithLinkAt("r_gripper_palm_link", pos1);
+  cenv->getWorld()->addToObject("box", std::make_shared<const shapes::Box>(.25, .25, .25), pos1);
+
+  // a copy builds its world distance field from scratch
+  DefaultCEnvType copy(*cenv, cenv->getWorld());
+  EXPECT_TRUE(copy.getUseExactDistanceTransform());
+  collision_detection::CollisionResult res;
+  copy.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+
+  res = collision_detection::CollisionResult();
+  copy.checkSelfCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+}
+
+TEST_F(DistanceFieldCollisionDetectionTester, BatchedCollisionGradients)
+{
+  auto cenv = std::static_pointer_cast<DefaultCEnvType>(cenv_);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = "right_arm";
+
+  moveit::core::RobotState default_state(robot_model_);
+  default_state.setToDefaultValues();
+  default_state.update();
+
+  Eigen::Isometry3d pos1 = Eigen::Isometry3d::Identity();
+  pos1.translation().x() = 0.8;
+  pos1.translation().y() = -0.2;
+  moveit::core::RobotState near_state(default_state);
+  near_state.updateStateWithLinkAt("r_gripper_palm_link", pos1);
+  pos1.translation().x() = 0.95;
+  cenv->getWorld()->addToObject("box", std::make_shared<const shapes::Box>(.1, .1, .1), pos1);
+
+  const std::vector<const moveit::core::RobotState*> states = { &default_state, &near_state };
+  std::vector<collision_detection::GroupStateRepresentationPtr> gsrs;
+  cenv->getCollisionGradients(req, states, acm_.get(), gsrs);
+  ASSERT_EQ(gsrs.size(), states.size());
+  EXPECT_EQ(cenv->getLastGroupStateRepresentation(), gsrs.back());
+
+  // the representations are reused by later calls
+  const std::vector<collision_detection::GroupStateRepresentationPtr> first_gsrs = gsrs;
+  cenv->getCollisionGradients(req, states, acm_.get(), gsrs);
+  EXPECT_EQ(gsrs, first_gsrs);
+
+  bool near_environment = false;
+  for (std::size_t s = 0; s < states.size(); ++s)
+  {
+    collision_detection::CollisionResult res;
+    collision_detection::GroupStateRepresentationPtr gsr;
+    cenv->getCollisionGradients(req, res, *states[s], acm_.get(), gsr);
+    ASSERT_EQ(gsrs[s]->gradients_.size(), gsr->gradients_.size());
+    for (std::size_t i = 0; i < gsr->gradients_.size(); ++i)
+    {
+      const collision_detection::GradientInfo& batched = gsrs[s]->gradients_[i];
+      const collision_detection::GradientInfo& single = gsr->gradients_[i];
+      ASSERT_EQ(batched.sphere_locations.size(), single.sphere_locations.size());
+      for (std::size_t k = 0; k < single.sphere_locations.size(); ++k)
+      {
+        EXPECT_TRUE(batched.sphere_locations[k].isApprox(single.sphere_locations[k]));
+        // interpolated and nearest cell distances differ by less than a cell
+        if (batched.types[k] == collision_detection::ENVIRONMENT && single.types[k] == collision_detection::ENVIRONMENT)
+        {
+          EXPECT_NEAR(batched.distances[k], single.distances[k], collision_detection::DEFAULT_RESOLUTION);
+          near_environment = near_environment || s == 1;
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(near_environment);
+}
+
+TEST_F(DistanceFieldCollisionDetectionTester, DistanceFieldCache)
+{
+  const std::filesystem::path directory =
+      std::filesystem::path(testing::TempDir()) / "moveit_distance_field_cache_test";
+  std::filesystem::remove_all(directory);
+
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+  Eigen::Isometry3d pos1 = Eigen::Isometry3d::Identity();
+  pos1.translation().x() = 1.0;
+  robot_state.updateStateWithLinkAt("r_gripper_palm_link", pos1);
+
+  auto cenv = std::static_pointer_cast<DefaultCEnvType>(cenv_);
+  cenv->getWorld()->addToObject("box", std::make_shared<const shapes::Box>(.25, .25, .25), pos1);
+  cenv->setDistanceFieldCacheDirectory(directory.string());
+  EXPECT_EQ(cenv->getDistanceFieldCacheDirectory(), directory.string());
+  ASSERT_EQ(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()), 1);
+
+  // an environment for the same world reads the stored field
+  DefaultCEnvType copy(*cenv, cenv->getWorld());
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()), 1);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = "right_arm";
+  collision_detection::CollisionResult res;
+  copy.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+
+  // the restored field is updated like a propagated one
+  copy.getWorld()->removeObject("box");
+  res = collision_detection::CollisionResult();
+  copy.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+
+  // a different world gets its own file
+  pos1.translation().x() = 0.5;
+  copy.getWorld()->addToObject("box", std::make_shared<const shapes::Box>(.25, .25, .25), pos1);
+  DefaultCEnvType other(copy, copy.getWorld());
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()), 2);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_F(DistanceFieldCollisionDetectionTester, OverlappingObjectUpdates)
+{
+  auto cenv = std::static_pointer_cast<DefaultCEnvType>(cenv_);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = "right_arm";
+
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  Eigen::Isometry3d pos1 = Eigen::Isometry3d::Identity();
+  pos1.translation().x() = 1.0;
+  robot_state.updateStateWithLinkAt("r_gripper_palm_link", pos1);
+  cenv->getWorld()->addToObject("box1", std::make_shared<const shapes::Box>(.25, .25, .25), pos1);
+  cenv->getWorld()->addToObject("box2", std::make_shared<const shapes::Box>(.25, .25, .25), pos1);
+
+  // the cells of box1 stay obstacles while box2 occupies them
+  cenv->getWorld()->removeObject("box1");
+  collision_detection::CollisionResult res;
+  cenv->checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+
+  // moving box2 away frees its old cells
+  Eigen::Isometry3d pos2 = Eigen::Isometry3d::Identity();
+  pos2.translation().x() = -1.0;
+  cenv->getWorld()->setObjectPose("box2", pos2);
+  res = collision_detection::CollisionResult();
+  cenv->checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+
+  robot_state.updateStateWithLinkAt("r_gripper_palm_link", pos2);
+  res = collision_detection::CollisionResult();
+  cenv->checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+
+  // the incrementally updated environment agrees with one built from scratch
+  DefaultCEnvType copy(*cenv, cenv->getWorld());
+  res = collision_detection::CollisionResult();
+  copy.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+}
+
+TEST_F(DistanceFieldCollisionDetectionTester, SharedSelfCollisionModel)
+{
+  std::map<std::string, std::vector<collision_detection::CollisionSphere>> link_body_decompositions;
+  SharedModelCEnvType cenv1(robot_model_, link_body_decompositions);
+  SharedModelCEnvType cenv2(robot_model_, link_body_decompositions);
+  ASSERT_TRUE(cenv1.getSelfCollisionModel());
+  EXPECT_EQ(cenv1.getSelfCollisionModel(), cenv2.getSelfCollisionModel());
+
+  SharedModelCEnvType coarse(robot_model_, link_body_decompositions, collision_detection::DEFAULT_SIZE_X,
+                             collision_detection::DEFAULT_SIZE_Y, collision_detection::DEFAULT_SIZE_Z,
+                             Eigen::Vector3d::Zero(), false, 0.05);
+  EXPECT_NE(cenv1.getSelfCollisionModel(), coarse.getSelfCollisionModel());
+
+  collision_detection::CollisionRequest req;
+  req.group_name = "whole_body";
+
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  Eigen::Isometry3d offset = Eigen::Isometry3d::Identity();
+  offset.translation().x() = .01;
+  robot_state.updateStateWithLinkAt("base_link", Eigen::Isometry3d::Identity());
+  robot_state.updateStateWithLinkAt("base_bellow_link", offset);
+  acm_->setEntry("base_link", "base_bellow_link", false);
+
+  // queries keep reporting the collision while they reuse pooled group state representations
+  std::vector<const collision_detection::GroupStateRepresentation*> gsrs;
+  for (int i = 0; i < 3; ++i)
+  {
+    collision_detection::CollisionResult res;
+    cenv2.checkCollision(req, res, robot_state, *acm_);
+    ASSERT_TRUE(res.collision);
+    gsrs.push_back(cenv2.getLastGroupStateRepresentation().get());
+  }
+  // the last representation stays referenced, so queries alternate between two of them
+  EXPECT_NE(gsrs[0], gsrs[1]);
+  EXPECT_EQ(gsrs[0], gsrs[2]);
+
+  acm_->setEntry("base_link", "base_bellow_link", true);
+  collision_detection::CollisionResult res;
+  cenv2.checkCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+}
+
+TEST_F(DistanceFieldCollisionDetectionTester, HybridApproximateQueries)
+{
+  std::map<std::string, std::vector<collision_detection::CollisionSphere>> link_body_decompositions;
+  collision_detection::CollisionEnvHybrid cenv(robot_model_, link_body_decompositions,
+                                               collision_detection::DEFAULT_SIZE_X, collision_detection::DEFAULT_SIZE_Y,
+                                               collision_detection::DEFAULT_SIZE_Z, Eigen::Vector3d::Zero(), false,
+                                               collision_detection::DEFAULT_RESOLUTION,
+                                               collision_detection::DEFAULT_COLLISION_TOLERANCE, 0.5);
+  EXPECT_DOUBLE_EQ(cenv.getApproximateCollisionMargin(), std::sqrt(3.0) * collision_detection::DEFAULT_RESOLUTION);
+  cenv.setApproximateCollisionMargin(0.02);
+
+  collision_detection::CollisionRequest req;
+  req.group_name = "right_arm";
+  req.approximate = true;
+
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  Eigen::Isometry3d pos1 = Eigen::Isometry3d::Identity();
+  pos1.translation().x() = 1.0;
+  robot_state.updateStateWithLinkAt("r_gripper_palm_link", pos1);
+
+  double clearance;
+  ASSERT_TRUE(cenv.getCollisionEnvDistanceField()->getEnvironmentClearance(req.group_name, robot_state, clearance));
+  EXPECT_GT(clearance, cenv.getApproximateCollisionMargin());
+  collision_detection::CollisionResult res;
+  cenv.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+
+  cenv.getWorld()->addToObject("box", std::make_shared<const shapes::Box>(.25, .25, .25), pos1);
+  ASSERT_TRUE(cenv.getCollisionEnvDistanceField()->getEnvironmentClearance(req.group_name, robot_state, clearance));
+  EXPECT_LT(clearance, -cenv.getApproximateCollisionMargin());
+  res = collision_detection::CollisionResult();
+  cenv.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+
+  // contacts are never approximated
+  req.contacts = true;
+  res = collision_detection::CollisionResult();
+  cenv.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_TRUE(res.collision);
+  EXPECT_GT(res.contact_count, 0u);
+  req.contacts = false;
+
+  // the spheres cannot apply the matrix to world objects, so allowed contacts are checked exactly
+  acm_->setDefaultEntry("box", true);
+  res = collision_detection::CollisionResult();
+  cenv.checkRobotCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+
+  collision_detection::CollisionEnvHybrid copy(cenv, cenv.getWorld());
+  EXPECT_DOUBLE_EQ(copy.getApproximateCollisionMargin(), 0.02);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -216,6 +216,60 @@ public:
   virtual bool sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
                       unsigned int max_attempts) = 0;
 
+  /**
+   * \brief Samples several states given the constraints, appending them to \e states.
+   *
+   * The default implementation calls sample() once per candidate. Derived samplers may produce the candidates
+   * together, e.g. by solving IK for all of them at once.
+   *
+   * @param [in] reference_state Reference state that will be used to do transforms or perform other actions. It is
+   *        also the state into which the group values of every sample are placed.
+   * @param [in] count The number of candidates to sample
+   * @param [in] max_attempts The maximum number of times to attempt to draw each candidate
+   * @param [out] states The successfully sampled states are appended to this vector
+   *
+   * @return The number of successfully sampled states
+   */
+  virtual std::size_t sampleBatch(const moveit::core::RobotState& reference_state, std::size_t count,
+                                  unsigned int max_attempts, std::vector<moveit::core::RobotState>& states);
+
+  /**
+   * \brief Get the number of candidates that sampleBatch() can produce faster than the same number of sample() calls.
+   *
+   * @return 1 if the sampler does not benefit from batch sampling
+   */
+  virtual std::size_t getPreferredBatchSize() const
+  {
+    return 1;
+  }
+
+  /**
+   * \brief Samples given the constraints, writing the variables of the group straight into \e values.
+   *
+   * This avoids the round-trip through a RobotState, e.g. when the values are the memory of a planner's state.
+   * Only samplers whose canSampleJointGroupPositions() returns true implement it.
+   *
+   * @param [out] values Receives one value per variable of the group, ordered like
+   *        moveit::core::JointModelGroup::getVariableNames()
+   * @param [in] reference_state Reference state that will be used to do transforms or perform other actions
+   * @param [in] max_attempts The maximum number of times to attempt to draw a sample
+   *
+   * @return True if a sample was successfully taken, false otherwise
+   */
+  virtual bool sampleJointGroupPositions(double* /*values*/, const moveit::core::RobotState& /*reference_state*/,
+                                         unsigned int /*max_attempts*/)
+  {
+    return false;
+  }
+
+  /**
+   * \brief Check whether sampleJointGroupPositions() can sample the configured constraints
+   */
+  virtual bool canSampleJointGroupPositions() const
+  {
+    return false;
+  }
+
   /**
    * \brief Returns whether or not the constraint sampler is valid or not.
    * To be valid, the joint model group must be available in the kinematic model and configure() must have successfully
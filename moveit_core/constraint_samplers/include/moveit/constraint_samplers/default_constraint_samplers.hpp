@@ -38,6 +38,7 @@
 
 #include <moveit/constraint_samplers/constraint_sampler.hpp>
 #include <moveit/macros/class_forward.hpp>
+#include <moveit/reachability_map/reachability_map.hpp>
 #include <random_numbers/random_numbers.h>
 #include <rclcpp/rclcpp.hpp>
 #include <string>
@@ -140,6 +141,17 @@ public:
 
   bool sample(moveit::core::RobotState& state, const moveit::core::RobotState& ks, unsigned int max_attempts) override;
 
+  bool sampleJointGroupPositions(double* values, const moveit::core::RobotState& reference_state,
+                                 unsigned int max_attempts) override;
+
+  /**
+   * \brief Returns true once configured, joint constraints never need a RobotState to be sampled
+   */
+  bool canSampleJointGroupPositions() const override
+  {
+    return is_valid_;
+  }
+
   /**
    * \brief Gets the number of constrained joints - joints that have an
    * additional bound beyond the joint limits.
@@ -217,7 +229,17 @@ protected:
 
   std::vector<const moveit::core::JointModel*> unbounded_; /**< \brief The joints that are not bounded except by joint
                                                              limits */
+  /// \brief A mimic joint of the group, whose value follows another variable of the group
+  struct MimicInfo
+  {
+    std::size_t index_;        /**< The index of the mimic joint in the joint state vector */
+    std::size_t source_index_; /**< The index of the mimicked joint in the joint state vector */
+    double factor_;
+    double offset_;
+  };
+
   std::vector<unsigned int> uindex_; /**< \brief The index of the unbounded joints in the joint state vector */
+  std::vector<MimicInfo> mimic_;     /**< \brief The mimic joints whose values are computed after sampling */
   std::vector<double> values_;       /**< \brief Values associated with this group to avoid continuously reallocating */
 };
 
@@ -418,6 +440,17 @@ public:
     ik_timeout_ = timeout;
   }
 
+  /**
+   * \brief Sets a reachability map of the IK tip frame relative to the IK base frame
+   *
+   * Sampled poses missing from the map are rejected before calling IK, and the configurations stored in the map seed
+   * IK instead of random values. The map is only used while its frames match those of the IK solver.
+   *
+   * @param reachability_map The map, or an empty pointer to stop using it
+   * @return False if the map was generated for a different group
+   */
+  bool setReachabilityMap(const reachability_map::ReachabilityMapConstPtr& reachability_map);
+
   /**
    * \brief Gets the position constraint associated with this sampler.
    *
@@ -486,6 +519,30 @@ public:
   bool sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
               unsigned int max_attempts) override;
 
+  /**
+   * \brief Produces several IK samples at once.
+   *
+   * This function samples \e count poses with \ref samplePose and solves IK for all of them with a single call of
+   * kinematics::KinematicsBase::searchPositionIKBatch(), which solves them in parallel if the solver supports it.
+   * Each pose is solved from a random seed. The group state validity callback is called for every solution, after the
+   * batch has been solved.
+   *
+   * @param reference_state A reference state that will be used for transforming the IK poses, and as the template of
+   *        the produced states
+   * @param count The number of poses to sample
+   * @param max_attempts The number of attempts to sample each pose
+   * @param states The valid samples are appended to this vector
+   *
+   * @return The number of valid samples
+   */
+  std::size_t sampleBatch(const moveit::core::RobotState& reference_state, std::size_t count,
+                          unsigned int max_attempts, std::vector<moveit::core::RobotState>& states) override;
+
+  /**
+   * \brief Returns the number of hardware threads if the IK solver solves batches in parallel, and 1 otherwise
+   */
+  std::size_t getPreferredBatchSize() const override;
+
   /**
    * \brief Returns a pose that falls within the constraint regions.
    *
@@ -548,7 +605,24 @@ protected:
               moveit::core::RobotState& state, bool use_as_seed);
   bool sampleHelper(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
                     unsigned int max_attempts);
+  /**
+   * \brief Samples a pose with \ref samplePose and transforms it into a query for the IK solver
+   *
+   * @return True if a pose was sampled, otherwise false
+   */
+  bool sampleIKQuery(geometry_msgs::msg::Pose& ik_query, const moveit::core::RobotState& reference_state,
+                     unsigned int max_attempts);
   bool validate(moveit::core::RobotState& state) const;
+  /**
+   * \brief Checks whether the frames of the reachability map match those of the IK solver
+   */
+  void checkReachabilityMap();
+  /**
+   * \brief Fills \e seed with a configuration of the reachability map for \e ik_query, in the order of the IK solver
+   *
+   * @return False if the reachability map is not used or has no configuration for the pose
+   */
+  bool getReachabilitySeed(const geometry_msgs::msg::Pose& ik_query, std::vector<double>& seed) const;
 
   random_numbers::RandomNumberGenerator random_number_generator_; /**< \brief Random generator used by the sampler */
   IKSamplingPose sampling_pose_;                                  /**< \brief Holder for the pose used for sampling */
@@ -560,5 +634,7 @@ protected:
   bool need_eef_to_ik_tip_transform_; /**< \brief True if the tip frame of the inverse kinematic is different than the
                                         frame of the end effector */
   Eigen::Isometry3d eef_to_ik_tip_transform_; /**< \brief Holds the transformation from end effector to IK tip frame */
+  reachability_map::ReachabilityMapConstPtr reachability_map_; /**< \brief Optional map of reachable IK queries */
+  bool use_reachability_map_{ false }; /**< \brief True if the frames of the map match those of the IK solver */
 };
 }  // namespace constraint_samplers
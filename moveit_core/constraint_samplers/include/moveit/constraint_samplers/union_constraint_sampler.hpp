@@ -152,6 +152,20 @@ public:
   bool sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
               unsigned int max_attempts) override;
 
+  /**
+   * \brief Produces a sample from all configured samplers, writing the variables of the group into \e values.
+   *
+   * Variables no sampler writes keep their value in \e reference_state. Each sampler writes into a buffer that is
+   * allocated when the union is constructed.
+   */
+  bool sampleJointGroupPositions(double* values, const moveit::core::RobotState& reference_state,
+                                 unsigned int max_attempts) override;
+
+  /**
+   * \brief Returns true if all samplers sample variables of this group with sampleJointGroupPositions()
+   */
+  bool canSampleJointGroupPositions() const override;
+
   /**
    * \brief Get the name of the constraint sampler, for debugging purposes
    * should be in CamelCase format.
@@ -165,5 +179,10 @@ public:
 
 protected:
   std::vector<ConstraintSamplerPtr> samplers_; /**< \brief Holder for sorted internal list of samplers*/
+  /** \brief For each sampler, the index of each of its group variables in the variables of this group */
+  std::vector<std::vector<std::size_t>> sampler_variable_indices_;
+  std::vector<std::vector<double>> sampler_values_; /**< \brief Buffers the samplers write their values to */
+  std::vector<double> values_;                      /**< \brief Values of this group, to avoid reallocating */
+  bool samplers_within_group_; /**< \brief True if all samplers only write variables of this group */
 };
 }  // namespace constraint_samplers
@@ -64,4 +64,21 @@ void constraint_samplers::ConstraintSampler::clear()
   is_valid_ = false;
   frame_depends_.clear();
 }
+
+std::size_t constraint_samplers::ConstraintSampler::sampleBatch(const moveit::core::RobotState& reference_state,
+                                                                std::size_t count, unsigned int max_attempts,
+                                                                std::vector<moveit::core::RobotState>& states)
+{
+  std::size_t num_sampled = 0;
+  moveit::core::RobotState state(reference_state);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (sample(state, reference_state, max_attempts))
+    {
+      states.push_back(state);
+      ++num_sampled;
+    }
+  }
+  return num_sampled;
+}
 }  // namespace constraint_samplers
@@ -37,8 +37,10 @@
 #include <moveit/constraint_samplers/default_constraint_samplers.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
+#include <algorithm>
 #include <cassert>
 #include <functional>
+#include <thread>
 #include <moveit/utils/logger.hpp>
 
 namespace constraint_samplers
@@ -161,14 +163,25 @@ bool JointConstraintSampler::configure(const std::vector<kinematic_constraints::
       uindex_.push_back(jmg_->getVariableGroupIndex(vars[0]));
     }
   }
+
+  // mimic joints are not sampled, but written with the sampled values when bypassing RobotState
+  for (const moveit::core::JointModel* joint : joints)
+  {
+    const moveit::core::JointModel* source = joint->getMimic();
+    if (source && joint->getVariableCount() == 1 && jmg_->hasJointModel(source->getName()))
+    {
+      mimic_.push_back({ static_cast<std::size_t>(jmg_->getVariableGroupIndex(joint->getName())),
+                         static_cast<std::size_t>(jmg_->getVariableGroupIndex(source->getName())),
+                         joint->getMimicFactor(), joint->getMimicOffset() });
+    }
+  }
   values_.resize(jmg_->getVariableCount());
   is_valid_ = true;
   return true;
 }
 
-bool JointConstraintSampler::sample(moveit::core::RobotState& state,
-                                    const moveit::core::RobotState& /* reference_state */,
-                                    unsigned int /* max_attempts */)
+bool JointConstraintSampler::sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
+                                    unsigned int max_attempts)
 {
   if (!is_valid_)
   {
@@ -176,21 +189,33 @@ bool JointConstraintSampler::sample(moveit::core::RobotState& state,
     return false;
   }
 
-  // sample the unbounded joints first (in case some joint variables are bounded)
-  std::vector<double> v;
-  for (std::size_t i = 0; i < unbounded_.size(); ++i)
+  sampleJointGroupPositions(values_.data(), reference_state, max_attempts);
+  state.setJointGroupPositions(jmg_, values_);
+
+  // we are always successful
+  return true;
+}
+
+bool JointConstraintSampler::sampleJointGroupPositions(double* values,
+                                                       const moveit::core::RobotState& /* reference_state */,
+                                                       unsigned int /* max_attempts */)
+{
+  if (!is_valid_)
   {
-    v.resize(unbounded_[i]->getVariableCount());
-    unbounded_[i]->getVariableRandomPositions(random_number_generator_, &v[0]);
-    for (std::size_t j = 0; j < v.size(); ++j)
-      values_[uindex_[i] + j] = v[j];
+    RCLCPP_WARN(getLogger(), "JointConstraintSampler not configured, won't sample");
+    return false;
   }
 
+  // sample the unbounded joints first (in case some joint variables are bounded)
+  for (std::size_t i = 0; i < unbounded_.size(); ++i)
+    unbounded_[i]->getVariableRandomPositions(random_number_generator_, values + uindex_[i]);
+
   // enforce the constraints for the constrained components (could be all of them)
   for (const JointInfo& bound : bounds_)
-    values_[bound.index_] = random_number_generator_.uniformReal(bound.min_bound_, bound.max_bound_);
+    values[bound.index_] = random_number_generator_.uniformReal(bound.min_bound_, bound.max_bound_);
 
-  state.setJointGroupPositions(jmg_, values_);
+  for (const MimicInfo& mimic : mimic_)
+    values[mimic.index_] = mimic.factor_ * values[mimic.source_index_] + mimic.offset_;
 
   // we are always successful
   return true;
@@ -202,6 +227,7 @@ void JointConstraintSampler::clear()
   bounds_.clear();
   unbounded_.clear();
   uindex_.clear();
+  mimic_.clear();
   values_.clear();
 }
 
@@ -248,6 +274,57 @@ void IKConstraintSampler::clear()
   transform_ik_ = false;
   eef_to_ik_tip_transform_ = Eigen::Isometry3d::Identity();
   need_eef_to_ik_tip_transform_ = false;
+  use_reachability_map_ = false;
+}
+
+bool IKConstraintSampler::setReachabilityMap(const reachability_map::ReachabilityMapConstPtr& reachability_map)
+{
+  if (reachability_map && (reachability_map->getGroupName() != jmg_->getName() ||
+                           reachability_map->getJointNames() != jmg_->getVariableNames()))
+  {
+    RCLCPP_ERROR(getLogger(), "The reachability map of group '%s' can't be used for group '%s'",
+                 reachability_map->getGroupName().c_str(), jmg_->getName().c_str());
+    return false;
+  }
+  reachability_map_ = reachability_map;
+  checkReachabilityMap();
+  return true;
+}
+
+void IKConstraintSampler::checkReachabilityMap()
+{
+  use_reachability_map_ = false;
+  if (!reachability_map_ || !kb_)
+    return;
+  use_reachability_map_ = moveit::core::Transforms::sameFrame(reachability_map_->getBaseFrame(), ik_frame_) &&
+                          moveit::core::Transforms::sameFrame(reachability_map_->getTipFrame(), kb_->getTipFrame());
+  if (!use_reachability_map_)
+  {
+    RCLCPP_WARN(getLogger(),
+                "Ignoring the reachability map of '%s' in frame '%s', the IK solver solves for '%s' in frame '%s'",
+                reachability_map_->getTipFrame().c_str(), reachability_map_->getBaseFrame().c_str(),
+                kb_->getTipFrame().c_str(), ik_frame_.c_str());
+  }
+}
+
+bool IKConstraintSampler::getReachabilitySeed(const geometry_msgs::msg::Pose& ik_query, std::vector<double>& seed) const
+{
+  if (!use_reachability_map_)
+    return false;
+
+  const Eigen::Isometry3d pose(Eigen::Translation3d(ik_query.position.x, ik_query.position.y, ik_query.position.z) *
+                               Eigen::Quaterniond(ik_query.orientation.w, ik_query.orientation.x,
+                                                  ik_query.orientation.y, ik_query.orientation.z));
+  std::vector<std::vector<double>> seeds;
+  if (!reachability_map_->getSeeds(pose, seeds) || seeds.empty())
+    return false;
+
+  // the seeds reaching the orientation of the query come first
+  const std::vector<size_t>& ik_joint_bijection = jmg_->getKinematicsSolverJointBijection();
+  seed.resize(ik_joint_bijection.size());
+  for (std::size_t i = 0; i < ik_joint_bijection.size(); ++i)
+    seed[i] = seeds.front()[ik_joint_bijection[i]];
+  return true;
 }
 
 bool IKConstraintSampler::configure(const IKSamplingPose& sp)
@@ -435,6 +512,7 @@ bool IKConstraintSampler::loadIKSolver()
                  kb_->getTipFrame().c_str());
     return false;
   }
+  checkReachabilityMap();
   return true;
 }
 
@@ -603,10 +681,26 @@ bool IKConstraintSampler::sampleHelper(moveit::core::RobotState& state, const mo
   }
 
   for (unsigned int a = 0; a < max_attempts; ++a)
+  {
+    geometry_msgs::msg::Pose ik_query;
+    if (!sampleIKQuery(ik_query, reference_state, max_attempts))
+      return false;
+
+    if (callIK(ik_query, adapted_ik_validity_callback, ik_timeout_, state, a == 0))
+      return true;
+  }
+  return false;
+}
+
+bool IKConstraintSampler::sampleIKQuery(geometry_msgs::msg::Pose& ik_query,
+                                        const moveit::core::RobotState& reference_state, unsigned int max_attempts)
+{
+  Eigen::Vector3d point;
+  Eigen::Quaterniond quat;  // quat is normalized by contract
+  // poses the reachability map has never seen are resampled right away, instead of failing IK after its timeout
+  for (unsigned int a = 1;; ++a)
   {
     // sample a point in the constraint region
-    Eigen::Vector3d point;
-    Eigen::Quaterniond quat;  // quat is normalized by contract
     if (!samplePose(point, quat, reference_state, max_attempts))
     {
       if (verbose_)
@@ -635,19 +729,89 @@ bool IKConstraintSampler::sampleHelper(moveit::core::RobotState& state, const mo
       quat = Eigen::Quaterniond(ikq.linear());  // ikq is isometry, so quat is normalized
     }
 
+    if (!use_reachability_map_ || reachability_map_->isReachable(Eigen::Translation3d(point) * quat))
+      break;
+    if (a >= max_attempts)
+    {
+      if (verbose_)
+        RCLCPP_INFO(getLogger(), "IK constraint sampler was unable to produce a reachable pose to run IK for");
+      return false;
+    }
+  }
+
+  ik_query.position.x = point.x();
+  ik_query.position.y = point.y();
+  ik_query.position.z = point.z();
+  ik_query.orientation.x = quat.x();
+  ik_query.orientation.y = quat.y();
+  ik_query.orientation.z = quat.z();
+  ik_query.orientation.w = quat.w();
+  return true;
+}
+
+std::size_t IKConstraintSampler::sampleBatch(const moveit::core::RobotState& reference_state, std::size_t count,
+                                             unsigned int max_attempts, std::vector<moveit::core::RobotState>& states)
+{
+  if (!is_valid_)
+  {
+    RCLCPP_WARN(getLogger(), "IKConstraintSampler not configured, won't sample");
+    return 0;
+  }
+
+  const std::vector<size_t>& ik_joint_bijection = jmg_->getKinematicsSolverJointBijection();
+  std::vector<geometry_msgs::msg::Pose> ik_queries;
+  std::vector<std::vector<double>> seeds;
+  ik_queries.reserve(count);
+  seeds.reserve(count);
+  std::vector<double> vals;
+  for (std::size_t i = 0; i < count; ++i)
+  {
     geometry_msgs::msg::Pose ik_query;
-    ik_query.position.x = point.x();
-    ik_query.position.y = point.y();
-    ik_query.position.z = point.z();
-    ik_query.orientation.x = quat.x();
-    ik_query.orientation.y = quat.y();
-    ik_query.orientation.z = quat.z();
-    ik_query.orientation.w = quat.w();
+    if (!sampleIKQuery(ik_query, reference_state, max_attempts))
+      break;
+    ik_queries.push_back(ik_query);
 
-    if (callIK(ik_query, adapted_ik_validity_callback, ik_timeout_, state, a == 0))
-      return true;
+    // sample a seed value, unless the reachability map has one
+    std::vector<double>& seed = seeds.emplace_back(ik_joint_bijection.size());
+    if (getReachabilitySeed(ik_query, seed))
+      continue;
+    jmg_->getVariableRandomPositions(random_number_generator_, vals);
+    for (std::size_t j = 0; j < ik_joint_bijection.size(); ++j)
+      seed[j] = vals[ik_joint_bijection[j]];
   }
-  return false;
+  if (ik_queries.empty())
+    return 0;
+
+  std::vector<std::vector<double>> ik_solutions;
+  std::vector<moveit_msgs::msg::MoveItErrorCodes> error_codes;
+  kb_->searchPositionIKBatch(ik_queries, seeds, ik_timeout_, ik_solutions, error_codes);
+
+  std::size_t num_sampled = 0;
+  std::vector<double> solution(ik_joint_bijection.size());
+  moveit::core::RobotState state(reference_state);
+  for (std::size_t i = 0; i < ik_queries.size() && i < error_codes.size(); ++i)
+  {
+    if (error_codes[i].val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+      continue;
+    for (std::size_t j = 0; j < ik_joint_bijection.size(); ++j)
+      solution[ik_joint_bijection[j]] = ik_solutions[i][j];
+    if (group_state_validity_callback_ && !group_state_validity_callback_(&state, jmg_, solution.data()))
+      continue;
+    state.setJointGroupPositions(jmg_, solution);
+    if (validate(state))
+    {
+      states.push_back(state);
+      ++num_sampled;
+    }
+  }
+  return num_sampled;
+}
+
+std::size_t IKConstraintSampler::getPreferredBatchSize() const
+{
+  if (!kb_ || !kb_->supportsParallelIKBatch())
+    return 1;
+  return std::max(1u, std::thread::hardware_concurrency());
 }
 
 bool IKConstraintSampler::validate(moveit::core::RobotState& state) const
@@ -667,19 +831,22 @@ bool IKConstraintSampler::callIK(const geometry_msgs::msg::Pose& ik_query,
   std::vector<double> seed(ik_joint_bijection.size(), 0.0);
   std::vector<double> vals;
 
-  if (use_as_seed)
+  if (use_as_seed || !getReachabilitySeed(ik_query, seed))
   {
-    state.copyJointGroupPositions(jmg_, vals);
-  }
-  else
-  {
-    // sample a seed value
-    jmg_->getVariableRandomPositions(random_number_generator_, vals);
-  }
+    if (use_as_seed)
+    {
+      state.copyJointGroupPositions(jmg_, vals);
+    }
+    else
+    {
+      // sample a seed value
+      jmg_->getVariableRandomPositions(random_number_generator_, vals);
+    }
 
-  assert(vals.size() == ik_joint_bijection.size());
-  for (std::size_t i = 0; i < ik_joint_bijection.size(); ++i)
-    seed[i] = vals[ik_joint_bijection[i]];
+    assert(vals.size() == ik_joint_bijection.size());
+    for (std::size_t i = 0; i < ik_joint_bijection.size(); ++i)
+      seed[i] = vals[ik_joint_bijection[i]];
+  }
 
   std::vector<double> ik_sol;
   moveit_msgs::msg::MoveItErrorCodes error;
@@ -140,12 +140,42 @@ UnionConstraintSampler::UnionConstraintSampler(const planning_scene::PlanningSce
     RCLCPP_DEBUG(getLogger(), "Union sampler for group '%s' includes sampler for group '%s'", jmg_->getName().c_str(),
                  sampler->getJointModelGroup()->getName().c_str());
   }
+
+  // the buffers for sampling without a RobotState are allocated once
+  samplers_within_group_ = jmg_ != nullptr;
+  for (const ConstraintSamplerPtr& sampler : samplers_)
+  {
+    std::vector<std::size_t>& indices = sampler_variable_indices_.emplace_back();
+    const std::vector<std::string>& variable_names = sampler->getJointModelGroup()->getVariableNames();
+    sampler_values_.emplace_back(variable_names.size());
+    for (const std::string& variable_name : variable_names)
+    {
+      if (!samplers_within_group_ ||
+          !jmg_->hasJointModel(jmg_->getParentModel().getJointOfVariable(variable_name)->getName()))
+      {
+        samplers_within_group_ = false;
+        break;
+      }
+      indices.push_back(jmg_->getVariableGroupIndex(variable_name));
+    }
+  }
+  if (jmg_)
+    values_.resize(jmg_->getVariableCount());
 }
 
 bool UnionConstraintSampler::sample(moveit::core::RobotState& state, const moveit::core::RobotState& reference_state,
                                     unsigned int max_attempts)
 {
   state = reference_state;
+  // samplers that don't need the state are combined without updating link transforms in between
+  if (canSampleJointGroupPositions())
+  {
+    if (!sampleJointGroupPositions(values_.data(), reference_state, max_attempts))
+      return false;
+    state.setJointGroupPositions(jmg_, values_);
+    return true;
+  }
+
   for (ConstraintSamplerPtr& sampler : samplers_)
   {
     // ConstraintSampler::sample returns states with dirty link transforms (because it only writes values)
@@ -158,4 +188,28 @@ bool UnionConstraintSampler::sample(moveit::core::RobotState& state, const movei
   return true;
 }
 
+bool UnionConstraintSampler::sampleJointGroupPositions(double* values,
+                                                       const moveit::core::RobotState& reference_state,
+                                                       unsigned int max_attempts)
+{
+  reference_state.copyJointGroupPositions(jmg_, values);
+  for (std::size_t i = 0; i < samplers_.size(); ++i)
+  {
+    std::vector<double>& sampler_values = sampler_values_[i];
+    if (!samplers_[i]->sampleJointGroupPositions(sampler_values.data(), reference_state, max_attempts))
+      return false;
+    const std::vector<std::size_t>& indices = sampler_variable_indices_[i];
+    for (std::size_t j = 0; j < indices.size(); ++j)
+      values[indices[j]] = sampler_values[j];
+  }
+  return true;
+}
+
+bool UnionConstraintSampler::canSampleJointGroupPositions() const
+{
+  return samplers_within_group_ &&
+         std::all_of(samplers_.begin(), samplers_.end(),
+                     [](const ConstraintSamplerPtr& sampler) { return sampler->canSampleJointGroupPositions(); });
+}
+
 }  // end of namespace constraint_samplers
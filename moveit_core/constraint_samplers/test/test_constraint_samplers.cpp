@@ -452,6 +452,112 @@ TEST_F(LoadPlanningModelsPr2, IKConstraintsSamplerValid)
   }
 }
 
+TEST_F(LoadPlanningModelsPr2, IKConstraintsSamplerBatch)
+{
+  moveit::core::RobotState ks_const(robot_model_);
+  ks_const.setToDefaultValues();
+  ks_const.update();
+
+  kinematic_constraints::PositionConstraint pc(robot_model_);
+  moveit_msgs::msg::PositionConstraint pcm;
+  pcm.link_name = "l_wrist_roll_link";
+  pcm.constraint_region.primitives.resize(1);
+  pcm.constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  pcm.constraint_region.primitives[0].dimensions.resize(1);
+  pcm.constraint_region.primitives[0].dimensions[0] = 0.001;
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.constraint_region.primitive_poses.resize(1);
+  pcm.constraint_region.primitive_poses[0].position.x = 0.55;
+  pcm.constraint_region.primitive_poses[0].position.y = 0.2;
+  pcm.constraint_region.primitive_poses[0].position.z = 1.25;
+  pcm.constraint_region.primitive_poses[0].orientation.w = 1.0;
+  pcm.weight = 1.0;
+  EXPECT_TRUE(pc.configure(pcm, ps_->getTransforms()));
+
+  constraint_samplers::IKConstraintSampler iks(ps_, "left_arm");
+  EXPECT_TRUE(iks.configure(constraint_samplers::IKSamplingPose(pc)));
+  EXPECT_GE(iks.getPreferredBatchSize(), 1u);
+
+  std::vector<moveit::core::RobotState> states;
+  const std::size_t num_sampled = iks.sampleBatch(ks_const, 20, 100, states);
+  EXPECT_GT(num_sampled, 0u);
+  ASSERT_EQ(states.size(), num_sampled);
+  for (moveit::core::RobotState& state : states)
+  {
+    state.update();
+    EXPECT_TRUE(pc.decide(state).satisfied);
+  }
+
+  // solutions rejected by the validity callback are not returned
+  iks.setGroupStateValidityCallback(
+      [](moveit::core::RobotState*, const moveit::core::JointModelGroup*, const double*) { return false; });
+  states.clear();
+  EXPECT_EQ(iks.sampleBatch(ks_const, 20, 100, states), 0u);
+  EXPECT_TRUE(states.empty());
+}
+
+TEST_F(LoadPlanningModelsPr2, IKConstraintsSamplerReachabilityMap)
+{
+  moveit::core::RobotState ks(robot_model_);
+  ks.setToDefaultValues();
+  ks.update();
+  const moveit::core::RobotState ks_const(ks);
+
+  kinematic_constraints::PositionConstraint pc(robot_model_);
+  moveit_msgs::msg::PositionConstraint pcm;
+  pcm.link_name = "l_wrist_roll_link";
+  pcm.constraint_region.primitives.resize(1);
+  pcm.constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  pcm.constraint_region.primitives[0].dimensions.resize(1);
+  pcm.constraint_region.primitives[0].dimensions[0] = 0.001;
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.constraint_region.primitive_poses.resize(1);
+  pcm.constraint_region.primitive_poses[0].position.x = 0.55;
+  pcm.constraint_region.primitive_poses[0].position.y = 0.2;
+  pcm.constraint_region.primitive_poses[0].position.z = 1.25;
+  pcm.constraint_region.primitive_poses[0].orientation.w = 1.0;
+  pcm.weight = 1.0;
+  EXPECT_TRUE(pc.configure(pcm, ps_->getTransforms()));
+
+  constraint_samplers::IKConstraintSampler iks(ps_, "left_arm");
+  ASSERT_TRUE(iks.configure(constraint_samplers::IKSamplingPose(pc)));
+
+  const moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup("left_arm");
+  const kinematics::KinematicsBaseConstPtr& kb = jmg->getSolverInstance();
+  std::string base_frame = kb->getBaseFrame();
+  if (!base_frame.empty() && base_frame[0] == '/')
+    base_frame.erase(base_frame.begin());
+
+  // a map of another group is rejected
+  const moveit::core::JointModelGroup* right_arm = robot_model_->getJointModelGroup("right_arm");
+  EXPECT_FALSE(iks.setReachabilityMap(std::make_shared<reachability_map::ReachabilityMap>(
+      "right_arm", base_frame, "r_wrist_roll_link", right_arm->getVariableNames(), 0.05)));
+
+  // nothing is reachable with an empty map, so no IK is even attempted
+  EXPECT_TRUE(iks.setReachabilityMap(std::make_shared<reachability_map::ReachabilityMap>(
+      "left_arm", base_frame, kb->getTipFrame(), jmg->getVariableNames(), 0.05)));
+  EXPECT_FALSE(iks.sample(ks, ks_const, 10));
+
+  // the seeds of a generated map solve the constraint
+  const reachability_map::ReachabilityMapPtr map =
+      reachability_map::ReachabilityMap::generate(ks_const, jmg, base_frame, kb->getTipFrame(), 0.2, 20000);
+  ASSERT_TRUE(map);
+  EXPECT_TRUE(iks.setReachabilityMap(map));
+  std::size_t num_sampled = 0;
+  for (int i = 0; i < 20; ++i)
+  {
+    if (iks.sample(ks, ks_const, 100))
+    {
+      ks.update();
+      EXPECT_TRUE(pc.decide(ks).satisfied);
+      ++num_sampled;
+    }
+  }
+  EXPECT_GT(num_sampled, 0u);
+
+  EXPECT_TRUE(iks.setReachabilityMap(reachability_map::ReachabilityMapConstPtr()));
+}
+
 TEST_F(LoadPlanningModelsPr2, UnionConstraintSampler)
 {
   moveit::core::RobotState ks(robot_model_);
@@ -623,6 +729,70 @@ TEST_F(LoadPlanningModelsPr2, UnionConstraintSampler)
   EXPECT_EQ(ikcs_test->getJointModelGroup()->getName(), "right_arm");
 }
 
+TEST_F(LoadPlanningModelsPr2, JointGroupPositionsSampling)
+{
+  moveit::core::RobotState ks(robot_model_);
+  ks.setToDefaultValues();
+  ks.update();
+  const moveit::core::RobotState ks_const(ks);
+
+  moveit_msgs::msg::JointConstraint torso_constraint;
+  torso_constraint.joint_name = "torso_lift_joint";
+  torso_constraint.position = ks.getVariablePosition("torso_lift_joint");
+  torso_constraint.tolerance_above = 0.01;
+  torso_constraint.tolerance_below = 0.01;
+  torso_constraint.weight = 1.0;
+  kinematic_constraints::JointConstraint jc1(robot_model_);
+  EXPECT_TRUE(jc1.configure(torso_constraint));
+
+  moveit_msgs::msg::JointConstraint elbow_constraint;
+  elbow_constraint.joint_name = "r_elbow_flex_joint";
+  elbow_constraint.position = ks.getVariablePosition("r_elbow_flex_joint");
+  elbow_constraint.tolerance_above = 0.01;
+  elbow_constraint.tolerance_below = 0.01;
+  elbow_constraint.weight = 1.0;
+  kinematic_constraints::JointConstraint jc2(robot_model_);
+  EXPECT_TRUE(jc2.configure(elbow_constraint));
+
+  auto jcsp = std::make_shared<constraint_samplers::JointConstraintSampler>(ps_, "arms_and_torso");
+  EXPECT_FALSE(jcsp->canSampleJointGroupPositions());
+  EXPECT_TRUE(jcsp->configure(std::vector<kinematic_constraints::JointConstraint>{ jc1 }));
+  EXPECT_TRUE(jcsp->canSampleJointGroupPositions());
+  auto jcsp2 = std::make_shared<constraint_samplers::JointConstraintSampler>(ps_, "arms");
+  EXPECT_TRUE(jcsp2->configure(std::vector<kinematic_constraints::JointConstraint>{ jc2 }));
+
+  // the values written without a RobotState satisfy the constraints
+  const moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup("arms_and_torso");
+  std::vector<double> values(jmg->getVariableCount());
+  for (int t = 0; t < 100; ++t)
+  {
+    EXPECT_TRUE(jcsp->sampleJointGroupPositions(values.data(), ks_const, 1));
+    ks.setJointGroupPositions(jmg, values);
+    EXPECT_TRUE(jc1.decide(ks).satisfied);
+    EXPECT_TRUE(ks.satisfiesBounds(jmg));
+  }
+
+  // a union of joint samplers is combined without a RobotState as well
+  constraint_samplers::UnionConstraintSampler ucs(ps_, "arms_and_torso", { jcsp2, jcsp });
+  EXPECT_TRUE(ucs.canSampleJointGroupPositions());
+  for (int t = 0; t < 100; ++t)
+  {
+    EXPECT_TRUE(ucs.sampleJointGroupPositions(values.data(), ks_const, 1));
+    ks.setJointGroupPositions(jmg, values);
+    EXPECT_TRUE(jc1.decide(ks).satisfied);
+    EXPECT_TRUE(jc2.decide(ks).satisfied);
+
+    EXPECT_TRUE(ucs.sample(ks, ks_const, 1));
+    EXPECT_TRUE(jc1.decide(ks).satisfied);
+    EXPECT_TRUE(jc2.decide(ks).satisfied);
+  }
+
+  // samplers that need a RobotState disable it for the union
+  auto iksp = std::make_shared<constraint_samplers::IKConstraintSampler>(ps_, "left_arm");
+  constraint_samplers::UnionConstraintSampler ucs2(ps_, "arms_and_torso", { jcsp, iksp });
+  EXPECT_FALSE(ucs2.canSampleJointGroupPositions());
+}
+
 TEST_F(LoadPlanningModelsPr2, PoseConstraintSamplerManager)
 {
   moveit::core::RobotState ks(robot_model_);
@@ -0,0 +1,228 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Velocity-level inverse kinematics with singularity damping and null-space objectives */
+
+#pragma once
+
+#include <moveit/macros/class_forward.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SVD>
+#include <cstddef>
+#include <vector>
+
+/** \brief Namespace for velocity-level (differential) inverse kinematics */
+namespace differential_ik
+{
+MOVEIT_CLASS_FORWARD(DifferentialIKSolver);  // Defines DifferentialIKSolverPtr, ConstPtr, WeakPtr... etc
+
+/**
+ * \brief Maps Cartesian velocities of a link to velocities of the variables of a kinematic chain.
+ *
+ * The solver inverts the group Jacobian with damped least squares: far from singularities the result equals the
+ * Moore-Penrose pseudo-inverse, close to them damping grows as the smallest singular value shrinks, which bounds
+ * joint velocities at the price of tracking error. Redundant chains additionally follow a secondary objective in the
+ * null space of the Jacobian, e.g. keeping the joints away from their position limits. Joints at a position limit
+ * and moving beyond it are locked and the remaining joints take over their motion.
+ *
+ * All workspaces are allocated at construction, so solve() does not allocate and can run in control loops, such as
+ * servoing, Cartesian interpolation or local planning. An instance must not be shared between threads.
+ */
+class DifferentialIKSolver
+{
+public:
+  /** \brief The factorization the Jacobian is inverted with */
+  enum class Decomposition
+  {
+    /** \brief Singular value decomposition of the Jacobian, robust at and beyond singularities */
+    SVD,
+    /** \brief Cholesky factorization of the damped 6x6 product of the Jacobian with its transpose. The conditioning
+     * is taken from the eigenvalues of that product, which is cheaper than the SVD for chains of 7 or more joints.
+     * Chains of less than 6 variables and singular products fall back to the SVD. */
+    CHOLESKY
+  };
+
+  struct Options
+  {
+    /** \brief The factorization the Jacobian is inverted with */
+    Decomposition decomposition = Decomposition::SVD;
+
+    /** \brief Smallest singular value of the Jacobian below which the inversion is damped */
+    double singularity_threshold = 0.05;
+
+    /** \brief Damping factor applied at an exact singularity, it decreases to zero at \e singularity_threshold */
+    double max_damping = 0.1;
+
+    /** \brief Gain of the null-space objective moving the joints towards the middle of their position range,
+     * 0 to disable it */
+    double joint_limit_avoidance_gain = 0.0;
+
+    /** \brief Lock joints which are at a position limit and would move beyond it */
+    bool lock_joints_at_limits = true;
+
+    /** \brief Distance to a position limit at which a joint counts as being at the limit */
+    double joint_limit_margin = 0.0;
+  };
+
+  /**
+   * \brief Construct a solver for a kinematic chain. Throws std::invalid_argument if \e group is not a chain or
+   * does not update \e tip.
+   * \param group The group to solve for
+   * \param tip The link whose velocity is commanded, by default the last link of the group
+   * \param options The solver options
+   */
+  DifferentialIKSolver(const moveit::core::JointModelGroup* group, const moveit::core::LinkModel* tip = nullptr,
+                       const Options& options = Options());
+
+  /**
+   * \brief Compute the variable velocities realizing a Cartesian velocity of the tip link
+   * \param state The state the Jacobian is evaluated at, its link transforms need to be up to date
+   * \param twist The linear and angular velocity of the tip link, expressed in the frame of the group root link
+   * \param[out] qdot The velocities of the group variables, resized only if needed
+   * \return False if the Jacobian could not be computed or the twist is not 6-dimensional
+   */
+  bool solve(const moveit::core::RobotState& state, const Eigen::Ref<const Eigen::VectorXd>& twist,
+             Eigen::VectorXd& qdot);
+
+  /**
+   * \brief Compute the variable velocities realizing a Cartesian velocity of the tip link, following a secondary
+   * objective in the null space of the Jacobian
+   * \param state The state the Jacobian is evaluated at, its link transforms need to be up to date
+   * \param twist The linear and angular velocity of the tip link, expressed in the frame of the group root link
+   * \param nullspace_velocity Desired velocities of the group variables, of which only the part not affecting the
+   * tip velocity is realized
+   * \param[out] qdot The velocities of the group variables, resized only if needed
+   * \return False if the Jacobian could not be computed or the dimensions do not match
+   */
+  bool solve(const moveit::core::RobotState& state, const Eigen::Ref<const Eigen::VectorXd>& twist,
+             const Eigen::Ref<const Eigen::VectorXd>& nullspace_velocity, Eigen::VectorXd& qdot);
+
+  const moveit::core::JointModelGroup* getJointModelGroup() const
+  {
+    return group_;
+  }
+
+  const moveit::core::LinkModel* getTipLink() const
+  {
+    return tip_;
+  }
+
+  const Options& getOptions() const
+  {
+    return options_;
+  }
+
+  void setOptions(const Options& options)
+  {
+    options_ = options;
+  }
+
+  /** \brief The Jacobian of the last solve() call, with the origin at the group root link */
+  const Eigen::MatrixXd& getJacobian() const
+  {
+    return jacobian_;
+  }
+
+  /** \brief The smallest singular value of the Jacobian of the last solve() call */
+  double getSmallestSingularValue() const
+  {
+    return smallest_singular_value_;
+  }
+
+  /** \brief The ratio of the largest to the smallest singular value of the Jacobian of the last solve() call */
+  double getConditionNumber() const
+  {
+    return condition_number_;
+  }
+
+  /** \brief The damping factor applied in the last solve() call */
+  double getDamping() const
+  {
+    return damping_;
+  }
+
+  /** \brief Whether a variable was locked at a position limit in the last solve() call */
+  bool isLocked(std::size_t variable) const
+  {
+    return locked_[variable];
+  }
+
+private:
+  bool solveImpl(const moveit::core::RobotState& state, const Eigen::Ref<const Eigen::VectorXd>& twist,
+                 const Eigen::VectorXd* nullspace_velocity, Eigen::VectorXd& qdot);
+
+  // the Jacobian with the locked columns zeroed out
+  const Eigen::MatrixXd& getLockedJacobian();
+
+  // set the conditioning of the chain and the damping from the extreme singular values of the Jacobian
+  void updateConditioning(double smallest_singular_value, double largest_singular_value);
+
+  // invert the locked Jacobian with the SVD, adding the secondary objective in the null space if requested
+  void solveSVD(bool first_iteration, const Eigen::Ref<const Eigen::VectorXd>& twist, bool use_nullspace,
+                Eigen::VectorXd& qdot);
+
+  // invert the locked Jacobian with the Cholesky factorization, return false if the factorization failed
+  bool solveCholesky(bool first_iteration, const Eigen::Ref<const Eigen::VectorXd>& twist, bool use_nullspace,
+                     Eigen::VectorXd& qdot);
+
+  const moveit::core::JointModelGroup* group_;
+  const moveit::core::LinkModel* tip_;
+  Options options_;
+
+  // position bounds of the group variables, unbounded variables have infinite bounds
+  Eigen::VectorXd min_positions_;
+  Eigen::VectorXd max_positions_;
+
+  // preallocated workspaces
+  Eigen::MatrixXd jacobian_;
+  Eigen::MatrixXd locked_jacobian_;
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd_;
+  Eigen::Matrix<double, 6, 6> gram_;
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 6, 6>> gram_eigen_;
+  Eigen::LLT<Eigen::Matrix<double, 6, 6>> gram_llt_;
+  Eigen::Matrix<double, 6, 1> gram_task_;
+  Eigen::VectorXd positions_;
+  Eigen::VectorXd secondary_;
+  Eigen::VectorXd weights_;
+  Eigen::VectorXd task_;
+  std::vector<bool> locked_;
+
+  double smallest_singular_value_ = 0.0;
+  double condition_number_ = 0.0;
+  double damping_ = 0.0;
+};
+}  // namespace differential_ik
@@ -0,0 +1,295 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Velocity-level inverse kinematics with singularity damping and null-space objectives */
+
+#include <moveit/differential_ik/differential_ik_solver.hpp>
+#include <moveit/utils/logger.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace differential_ik
+{
+namespace
+{
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.core.differential_ik");
+}
+
+// singular values below this fraction of the largest one are treated as zero, like in
+// RobotState::computeVariableVelocity()
+constexpr double PINV_TOLERANCE = std::numeric_limits<double>::epsilon();
+}  // namespace
+
+DifferentialIKSolver::DifferentialIKSolver(const moveit::core::JointModelGroup* group,
+                                           const moveit::core::LinkModel* tip, const Options& options)
+  : group_(group), tip_(tip), options_(options)
+{
+  if (!group_)
+    throw std::invalid_argument("DifferentialIKSolver needs a joint model group");
+  if (!group_->isChain())
+    throw std::invalid_argument("Group '" + group_->getName() + "' is not a chain");
+  if (!tip_)
+    tip_ = group_->getLinkModels().back();
+  if (!group_->getUpdatedLinkModelsSet().count(tip_))
+    throw std::invalid_argument("Link '" + tip_->getName() + "' is not updated by group '" + group_->getName() + "'");
+
+  const std::size_t n = group_->getVariableCount();
+  min_positions_.setConstant(n, -std::numeric_limits<double>::infinity());
+  max_positions_.setConstant(n, std::numeric_limits<double>::infinity());
+  const std::vector<std::string>& variable_names = group_->getVariableNames();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const moveit::core::VariableBounds& bounds = group_->getParentModel().getVariableBounds(variable_names[i]);
+    if (bounds.position_bounded_)
+    {
+      min_positions_(i) = bounds.min_position_;
+      max_positions_(i) = bounds.max_position_;
+    }
+  }
+
+  const std::size_t rank = std::min<std::size_t>(6, n);
+  jacobian_.setZero(6, n);
+  locked_jacobian_.setZero(6, n);
+  svd_ = Eigen::JacobiSVD<Eigen::MatrixXd>(6, n, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  positions_.setZero(n);
+  secondary_.setZero(n);
+  weights_.setZero(rank);
+  task_.setZero(rank);
+  locked_.assign(n, false);
+}
+
+bool DifferentialIKSolver::solve(const moveit::core::RobotState& state, const Eigen::Ref<const Eigen::VectorXd>& twist,
+                                 Eigen::VectorXd& qdot)
+{
+  return solveImpl(state, twist, nullptr, qdot);
+}
+
+bool DifferentialIKSolver::solve(const moveit::core::RobotState& state, const Eigen::Ref<const Eigen::VectorXd>& twist,
+                                 const Eigen::Ref<const Eigen::VectorXd>& nullspace_velocity, Eigen::VectorXd& qdot)
+{
+  if (static_cast<std::size_t>(nullspace_velocity.size()) != group_->getVariableCount())
+  {
+    RCLCPP_ERROR(getLogger(), "Null-space velocity has %ld elements, group '%s' has %u variables",
+                 static_cast<long>(nullspace_velocity.size()), group_->getName().c_str(), group_->getVariableCount());
+    return false;
+  }
+  secondary_ = nullspace_velocity;
+  return solveImpl(state, twist, &secondary_, qdot);
+}
+
+const Eigen::MatrixXd& DifferentialIKSolver::getLockedJacobian()
+{
+  if (std::find(locked_.begin(), locked_.end(), true) == locked_.end())
+    return jacobian_;
+  locked_jacobian_ = jacobian_;
+  for (std::size_t i = 0; i < locked_.size(); ++i)
+  {
+    if (locked_[i])
+      locked_jacobian_.col(i).setZero();
+  }
+  return locked_jacobian_;
+}
+
+void DifferentialIKSolver::updateConditioning(double smallest_singular_value, double largest_singular_value)
+{
+  smallest_singular_value_ = smallest_singular_value;
+  condition_number_ = smallest_singular_value_ > 0.0 ? largest_singular_value / smallest_singular_value_ :
+                                                       std::numeric_limits<double>::infinity();
+  const double ratio = smallest_singular_value_ / options_.singularity_threshold;
+  damping_ = smallest_singular_value_ < options_.singularity_threshold ?
+                 options_.max_damping * std::sqrt(1.0 - ratio * ratio) :
+                 0.0;
+}
+
+void DifferentialIKSolver::solveSVD(bool first_iteration, const Eigen::Ref<const Eigen::VectorXd>& twist,
+                                    bool use_nullspace, Eigen::VectorXd& qdot)
+{
+  svd_.compute(getLockedJacobian(), Eigen::ComputeThinU | Eigen::ComputeThinV);
+  const Eigen::VectorXd& s = svd_.singularValues();
+  const double largest = s(0);
+
+  // the damping and conditioning reflect the chain itself, not the joints locked by the previous iterations
+  if (first_iteration)
+    updateConditioning(s(s.size() - 1), largest);
+  const double damping_squared = damping_ * damping_;
+
+  // damped least squares: qdot = V * diag(s / (s^2 + damping^2)) * U^T * twist
+  for (Eigen::Index i = 0; i < s.size(); ++i)
+  {
+    const double denominator = s(i) * s(i) + damping_squared;
+    weights_(i) = (s(i) > largest * PINV_TOLERANCE && denominator > 0.0) ? s(i) / denominator : 0.0;
+  }
+  task_.noalias() = svd_.matrixU().transpose() * twist;
+  task_.array() *= weights_.array();
+  qdot.noalias() = svd_.matrixV() * task_;
+
+  // add the secondary objective projected into the null space: (I - V * diag(s^2 / (s^2 + damping^2)) * V^T)
+  if (use_nullspace)
+  {
+    for (Eigen::Index i = 0; i < s.size(); ++i)
+      weights_(i) *= s(i);
+    task_.noalias() = svd_.matrixV().transpose() * secondary_;
+    task_.array() *= weights_.array();
+    qdot += secondary_;
+    qdot.noalias() -= svd_.matrixV() * task_;
+  }
+}
+
+bool DifferentialIKSolver::solveCholesky(bool first_iteration, const Eigen::Ref<const Eigen::VectorXd>& twist,
+                                         bool use_nullspace, Eigen::VectorXd& qdot)
+{
+  const Eigen::MatrixXd& jacobian = getLockedJacobian();
+  gram_.noalias() = jacobian * jacobian.transpose();
+
+  // the eigenvalues of J * J^T are the squared singular values of J
+  if (first_iteration)
+  {
+    gram_eigen_.compute(gram_, Eigen::EigenvaluesOnly);
+    if (gram_eigen_.info() != Eigen::Success)
+      return false;
+    const Eigen::Matrix<double, 6, 1>& eigenvalues = gram_eigen_.eigenvalues();
+    updateConditioning(std::sqrt(std::max(eigenvalues(0), 0.0)), std::sqrt(std::max(eigenvalues(5), 0.0)));
+  }
+
+  // damped least squares: qdot = J^T * (J * J^T + damping^2 * I)^-1 * twist
+  gram_.diagonal().array() += damping_ * damping_;
+  gram_llt_.compute(gram_);
+  if (gram_llt_.info() != Eigen::Success)
+    return false;
+  gram_task_ = gram_llt_.solve(twist);
+  qdot.noalias() = jacobian.transpose() * gram_task_;
+
+  // add the secondary objective projected into the null space: (I - J^T * (J * J^T + damping^2 * I)^-1 * J)
+  if (use_nullspace)
+  {
+    gram_task_.noalias() = jacobian * secondary_;
+    gram_llt_.solveInPlace(gram_task_);
+    qdot += secondary_;
+    qdot.noalias() -= jacobian.transpose() * gram_task_;
+  }
+  return true;
+}
+
+bool DifferentialIKSolver::solveImpl(const moveit::core::RobotState& state,
+                                     const Eigen::Ref<const Eigen::VectorXd>& twist,
+                                     const Eigen::VectorXd* nullspace_velocity, Eigen::VectorXd& qdot)
+{
+  if (twist.size() != 6)
+  {
+    RCLCPP_ERROR(getLogger(), "Twist has %ld elements instead of 6", static_cast<long>(twist.size()));
+    return false;
+  }
+  if (!state.getJacobian(group_, tip_, Eigen::Vector3d::Zero(), jacobian_))
+    return false;
+
+  const std::size_t n = group_->getVariableCount();
+  const std::vector<int>& variable_indices = group_->getVariableIndexList();
+  for (std::size_t i = 0; i < n; ++i)
+    positions_(i) = state.getVariablePosition(variable_indices[i]);
+
+  // the secondary objective: the requested null-space velocity plus the gradient descent on the squared distance
+  // to the middle of the position ranges, normalized by their half-widths
+  const bool avoid_limits = options_.joint_limit_avoidance_gain > 0.0;
+  if (!nullspace_velocity)
+    secondary_.setZero();
+  if (avoid_limits)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      if (!std::isfinite(min_positions_(i)) || !std::isfinite(max_positions_(i)))
+        continue;
+      const double half_range = 0.5 * (max_positions_(i) - min_positions_(i));
+      if (half_range <= 0.0)
+        continue;
+      const double middle = 0.5 * (max_positions_(i) + min_positions_(i));
+      secondary_(i) -= options_.joint_limit_avoidance_gain * (positions_(i) - middle) / (half_range * half_range);
+    }
+  }
+  const bool use_nullspace = nullspace_velocity || avoid_limits;
+  // J * J^T is singular for chains of less than 6 variables
+  bool use_cholesky = options_.decomposition == Decomposition::CHOLESKY && n >= 6;
+
+  std::fill(locked_.begin(), locked_.end(), false);
+  qdot.resize(n);
+
+  // every iteration locks at least one more joint, or terminates
+  for (std::size_t iteration = 0; iteration <= n; ++iteration)
+  {
+    if (use_nullspace)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        if (locked_[i])
+          secondary_(i) = 0.0;
+      }
+    }
+    // a factorization failing at a singularity is repeated with the SVD, which is used from then on
+    if (use_cholesky && !solveCholesky(iteration == 0, twist, use_nullspace, qdot))
+      use_cholesky = false;
+    if (!use_cholesky)
+      solveSVD(iteration == 0, twist, use_nullspace, qdot);
+
+    if (!options_.lock_joints_at_limits)
+      break;
+    bool locked_joint = false;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      if (locked_[i])
+        continue;
+      if ((qdot(i) > 0.0 && positions_(i) >= max_positions_(i) - options_.joint_limit_margin) ||
+          (qdot(i) < 0.0 && positions_(i) <= min_positions_(i) + options_.joint_limit_margin))
+      {
+        locked_[i] = true;
+        locked_joint = true;
+      }
+    }
+    if (!locked_joint)
+      break;
+  }
+
+  // joints locked in the last iteration may still carry velocity
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (locked_[i])
+      qdot(i) = 0.0;
+  }
+  return true;
+}
+}  // namespace differential_ik
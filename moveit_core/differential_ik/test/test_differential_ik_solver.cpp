@@ -0,0 +1,205 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/differential_ik/differential_ik_solver.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+#include <gtest/gtest.h>
+#include <Eigen/QR>
+
+class PandaDifferentialIK : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    group_ = robot_model_->getJointModelGroup("panda_arm");
+    ASSERT_TRUE(group_);
+    state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
+    state_->setToDefaultValues();
+    ASSERT_TRUE(state_->setToDefaultValues(group_, "ready"));
+    state_->updateLinkTransforms();
+    twist_.resize(6);
+    twist_ << 0.1, -0.05, 0.02, 0.1, 0.2, -0.1;
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  const moveit::core::JointModelGroup* group_;
+  moveit::core::RobotStatePtr state_;
+  Eigen::VectorXd twist_;
+};
+
+TEST_F(PandaDifferentialIK, MatchesPseudoInverse)
+{
+  differential_ik::DifferentialIKSolver solver(group_);
+  Eigen::VectorXd qdot;
+  ASSERT_TRUE(solver.solve(*state_, twist_, qdot));
+  ASSERT_EQ(qdot.size(), 7);
+  EXPECT_EQ(solver.getDamping(), 0.0);
+  EXPECT_GT(solver.getSmallestSingularValue(), 0.0);
+  EXPECT_GE(solver.getConditionNumber(), 1.0);
+
+  const Eigen::MatrixXd jacobian = state_->getJacobian(group_);
+  const Eigen::VectorXd expected = jacobian.completeOrthogonalDecomposition().pseudoInverse() * twist_;
+  EXPECT_TRUE(qdot.isApprox(expected, 1e-8));
+  EXPECT_TRUE((jacobian * qdot).isApprox(twist_, 1e-8));
+
+  EXPECT_FALSE(solver.solve(*state_, Eigen::VectorXd::Zero(3), qdot));
+}
+
+TEST_F(PandaDifferentialIK, NullSpaceVelocity)
+{
+  differential_ik::DifferentialIKSolver solver(group_);
+  Eigen::VectorXd qdot, qdot_nullspace;
+  ASSERT_TRUE(solver.solve(*state_, twist_, qdot));
+  ASSERT_TRUE(solver.solve(*state_, twist_, Eigen::VectorXd::Ones(7), qdot_nullspace));
+
+  // the secondary objective changes the joint motion, but not the tip motion
+  const Eigen::MatrixXd jacobian = state_->getJacobian(group_);
+  EXPECT_GT((qdot_nullspace - qdot).norm(), 1e-3);
+  EXPECT_TRUE((jacobian * qdot_nullspace).isApprox(twist_, 1e-8));
+
+  EXPECT_FALSE(solver.solve(*state_, twist_, Eigen::VectorXd::Ones(3), qdot));
+}
+
+TEST_F(PandaDifferentialIK, SingularityDamping)
+{
+  differential_ik::DifferentialIKSolver solver(group_);
+  Eigen::VectorXd qdot, qdot_damped;
+  ASSERT_TRUE(solver.solve(*state_, twist_, qdot));
+
+  // a threshold above the smallest singular value makes the solver damp the inversion
+  differential_ik::DifferentialIKSolver::Options options;
+  options.singularity_threshold = 2.0 * solver.getSmallestSingularValue();
+  options.max_damping = 0.5;
+  solver.setOptions(options);
+  ASSERT_TRUE(solver.solve(*state_, twist_, qdot_damped));
+  EXPECT_GT(solver.getDamping(), 0.0);
+  EXPECT_LE(solver.getDamping(), options.max_damping);
+  EXPECT_LT(qdot_damped.norm(), qdot.norm());
+}
+
+TEST_F(PandaDifferentialIK, JointLimits)
+{
+  const moveit::core::VariableBounds& bounds = robot_model_->getVariableBounds("panda_joint1");
+  differential_ik::DifferentialIKSolver solver(group_);
+  Eigen::VectorXd qdot;
+
+  // a twist purely made of the motion of the first joint, with the joint at its upper limit
+  state_->setVariablePosition("panda_joint1", bounds.max_position_);
+  state_->updateLinkTransforms();
+  const Eigen::VectorXd twist = state_->getJacobian(group_).col(0);
+  ASSERT_TRUE(solver.solve(*state_, twist, qdot));
+  EXPECT_TRUE(solver.isLocked(0));
+  EXPECT_EQ(qdot(0), 0.0);
+  for (std::size_t i = 1; i < 7; ++i)
+    EXPECT_FALSE(solver.isLocked(i));
+  // the remaining six joints still realize the twist
+  EXPECT_TRUE((state_->getJacobian(group_) * qdot).isApprox(twist, 1e-6));
+
+  // without locking the joint moves beyond its limit
+  differential_ik::DifferentialIKSolver::Options options;
+  options.lock_joints_at_limits = false;
+  solver.setOptions(options);
+  ASSERT_TRUE(solver.solve(*state_, twist, qdot));
+  EXPECT_FALSE(solver.isLocked(0));
+  EXPECT_GT(qdot(0), 0.0);
+
+  // close to the limit and without a Cartesian motion, limit avoidance moves the joint back in the null space
+  options.joint_limit_avoidance_gain = 1.0;
+  solver.setOptions(options);
+  state_->setVariablePosition("panda_joint1", bounds.max_position_ - 0.1);
+  state_->updateLinkTransforms();
+  ASSERT_TRUE(solver.solve(*state_, Eigen::VectorXd::Zero(6), qdot));
+  EXPECT_LT((state_->getJacobian(group_) * qdot).norm(), 1e-8);
+
+  // a small step along the solution reduces the normalized distance to the middle of the ranges
+  const auto range_cost = [&](const Eigen::VectorXd& step) {
+    double cost = 0.0;
+    const std::vector<std::string>& names = group_->getVariableNames();
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+      const moveit::core::VariableBounds& b = robot_model_->getVariableBounds(names[i]);
+      const double q = state_->getVariablePosition(names[i]) + step(i);
+      const double distance = (q - 0.5 * (b.max_position_ + b.min_position_)) / (b.max_position_ - b.min_position_);
+      cost += distance * distance;
+    }
+    return cost;
+  };
+  EXPECT_GT(qdot.norm(), 0.0);
+  EXPECT_LT(range_cost(0.01 * qdot), range_cost(Eigen::VectorXd::Zero(7)));
+}
+
+TEST_F(PandaDifferentialIK, CholeskyMatchesSVD)
+{
+  differential_ik::DifferentialIKSolver::Options options;
+  options.joint_limit_avoidance_gain = 0.5;
+  differential_ik::DifferentialIKSolver svd_solver(group_, nullptr, options);
+  options.decomposition = differential_ik::DifferentialIKSolver::Decomposition::CHOLESKY;
+  differential_ik::DifferentialIKSolver cholesky_solver(group_, nullptr, options);
+  Eigen::VectorXd qdot_svd, qdot_cholesky;
+
+  // with a null-space objective
+  ASSERT_TRUE(svd_solver.solve(*state_, twist_, Eigen::VectorXd::Ones(7), qdot_svd));
+  ASSERT_TRUE(cholesky_solver.solve(*state_, twist_, Eigen::VectorXd::Ones(7), qdot_cholesky));
+  EXPECT_TRUE(qdot_cholesky.isApprox(qdot_svd, 1e-6));
+  EXPECT_NEAR(cholesky_solver.getSmallestSingularValue(), svd_solver.getSmallestSingularValue(), 1e-6);
+  EXPECT_NEAR(cholesky_solver.getConditionNumber(), svd_solver.getConditionNumber(), 1e-6);
+
+  // with damping close to a singularity
+  options.singularity_threshold = 2.0 * svd_solver.getSmallestSingularValue();
+  options.max_damping = 0.5;
+  cholesky_solver.setOptions(options);
+  options.decomposition = differential_ik::DifferentialIKSolver::Decomposition::SVD;
+  svd_solver.setOptions(options);
+  ASSERT_TRUE(svd_solver.solve(*state_, twist_, qdot_svd));
+  ASSERT_TRUE(cholesky_solver.solve(*state_, twist_, qdot_cholesky));
+  EXPECT_GT(cholesky_solver.getDamping(), 0.0);
+  EXPECT_NEAR(cholesky_solver.getDamping(), svd_solver.getDamping(), 1e-6);
+  EXPECT_TRUE(qdot_cholesky.isApprox(qdot_svd, 1e-6));
+
+  // with a joint locked at its limit
+  state_->setVariablePosition("panda_joint1", robot_model_->getVariableBounds("panda_joint1").max_position_);
+  state_->updateLinkTransforms();
+  const Eigen::VectorXd twist = state_->getJacobian(group_).col(0);
+  ASSERT_TRUE(svd_solver.solve(*state_, twist, qdot_svd));
+  ASSERT_TRUE(cholesky_solver.solve(*state_, twist, qdot_cholesky));
+  EXPECT_TRUE(cholesky_solver.isLocked(0));
+  EXPECT_TRUE(qdot_cholesky.isApprox(qdot_svd, 1e-6));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -180,8 +180,10 @@ public:
    * OcTrees as mentioned.  A bounding sphere is computed given the
    * shape; the bounding sphere is iterated through in 3D at the
    * resolution of the distance_field, with each point tested for
-   * point inclusion.  For more information about the behavior of
-   * bodies and poses please see the documentation for
+   * point inclusion.  Meshes are voxelized with \ref
+   * findInternalPointsMesh instead, so that the points of non-convex
+   * meshes do not fill their convex hull.  For more information about
+   * the behavior of bodies and poses please see the documentation for
    * geometric_shapes.
    *
    * @param [in] shape The shape to add to the distance field
@@ -312,6 +314,49 @@ public:
    */
   double getDistanceGradient(double x, double y, double z, double& gradient_x, double& gradient_y, double& gradient_z,
                              bool& in_bounds) const;
+
+  /**
+   * \brief Gets the distance at the given location by trilinear
+   * interpolation of the eight surrounding cells, together with the
+   * analytic gradient of the interpolated field.
+   *
+   * Unlike \ref getDistanceGradient, the returned distance and
+   * gradient vary continuously with the location, which is what
+   * gradient based optimizers need.  At a cell center the distance is
+   * exactly the cell's distance.
+   *
+   * @param [in] x The X location
+   * @param [in] y The Y location
+   * @param [in] z The Z location
+   * @param [out] gradient_x The X component of the gradient of the interpolated distance
+   * @param [out] gradient_y The Y component of the gradient of the interpolated distance
+   * @param [out] gradient_z The Z component of the gradient of the interpolated distance
+   *
+   * @param [out] in_bounds Whether or not all eight cells around
+   * (x,y,z) are in the distance field.  If not, the gradient is zero
+   * and an uninitialized distance is returned.
+   *
+   * @return The interpolated distance
+   */
+  double getInterpolatedDistanceGradient(double x, double y, double z, double& gradient_x, double& gradient_y,
+                                         double& gradient_z, bool& in_bounds) const;
+
+  /**
+   * \brief Batched version of \ref getInterpolatedDistanceGradient
+   * evaluating many locations in one call.
+   *
+   * Locations that are out of bounds get an uninitialized distance
+   * and a zero gradient.
+   *
+   * @param [in] points The locations to evaluate
+   * @param [out] distances The interpolated distance of each location, resized to match points
+   * @param [out] gradients The gradient of each location, resized to match points
+   *
+   * @return True if all locations were in bounds
+   */
+  bool getInterpolatedDistanceGradients(const EigenSTL::vector_Vector3d& points, std::vector<double>& distances,
+                                        EigenSTL::vector_Vector3d& gradients) const;
+
   /**
    * \brief Gets the distance to the closest obstacle at the given
    * integer cell location. The particulars of this function are
@@ -586,6 +631,20 @@ protected:
    */
   void getOcTreePoints(const octomap::OcTree* octree, EigenSTL::vector_Vector3d* points) const;
 
+  /**
+   * \brief Gets the distances of the eight cells of the box spanned by
+   * (x,y,z) and (x+1,y+1,z+1), used for interpolation.  The cells are
+   * expected to be valid.  The default implementation calls \ref
+   * getDistance for each of them, derived classes can read their
+   * storage directly.
+   *
+   * @param [in] x The smallest X index of the box
+   * @param [in] y The smallest Y index of the box
+   * @param [in] z The smallest Z index of the box
+   * @param [out] distances The cell distances, indexed by 4*dx + 2*dy + dz
+   */
+  virtual void getCornerDistances(int x, int y, int z, double distances[8]) const;
+
   /**
    * \brief Helper function that sets the point value and color given
    * the distance.
@@ -52,4 +52,27 @@ namespace distance_field
  *                   vector.
  */
 void findInternalPointsConvex(const bodies::Body& body, double resolution, EigenSTL::vector_Vector3d& points);
+
+/**
+ * \brief Find all points on a regular grid that are internal to a closed,
+ * possibly non-convex mesh.
+ *
+ * The grid holds the points whose coordinates are multiples of the
+ * resolution.  Every grid column along z is intersected with the mesh
+ * triangles and the points between pairs of crossings are internal (scanline
+ * parity).  Columns through shared edges and vertices count every surface
+ * layer exactly once, so closed meshes need not be convex or consistently
+ * wound.
+ *
+ * @param [in] mesh The mesh to discretize
+ * @param [in] pose The pose of the mesh
+ * @param [in] resolution The resolution at which to test
+ * @param [out] points The points internal to the mesh are appended to this
+ *                   vector, ordered by x, y and z.
+ * @param [in] padding Distance the vertices are moved away from the center of
+ *                   the mesh bounding box, like the padding of bodies::ConvexMesh
+ * @param [in] thread_count Number of threads that voxelize slabs of columns
+ */
+void findInternalPointsMesh(const shapes::Mesh& mesh, const Eigen::Isometry3d& pose, double resolution,
+                            EigenSTL::vector_Vector3d& points, double padding = 0.0, unsigned int thread_count = 1);
 }  // namespace distance_field
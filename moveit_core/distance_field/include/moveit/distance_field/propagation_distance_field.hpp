@@ -38,9 +38,11 @@
 
 #include <moveit/distance_field/voxel_grid.hpp>
 #include <moveit/distance_field/distance_field.hpp>
+#include <algorithm>
 #include <vector>
 #include <Eigen/Core>
 #include <set>
+#include <utility>
 #include <octomap/octomap.h>
 #include <rclcpp/rclcpp.hpp>
 
@@ -168,10 +170,14 @@ public:
    * \ref PropagationDistanceField description for more information on
    * the implications of this.
    *
+   * @param [in] storage How the voxel grid stores its cells.  With
+   * \ref BLOCKED_STORAGE only the regions within the maximum distance
+   * of obstacles are allocated.
+   *
    */
   PropagationDistanceField(double size_x, double size_y, double size_z, double resolution, double origin_x,
                            double origin_y, double origin_z, double max_distance,
-                           bool propagate_negative_distances = false);
+                           bool propagate_negative_distances = false, VoxelStorage storage = DENSE_STORAGE);
 
   /**
    * \brief Constructor based on an OcTree and bounding box
@@ -194,10 +200,14 @@ public:
    * and all obstacle cells will be assigned zero distance.  See the
    * \ref PropagationDistanceField description for more information on
    * the implications of this.
+   *
+   * @param [in] storage How the voxel grid stores its cells.  With
+   * \ref BLOCKED_STORAGE only the regions within the maximum distance
+   * of obstacles are allocated.
    */
   PropagationDistanceField(const octomap::OcTree& octree, const octomap::point3d& bbx_min,
                            const octomap::point3d& bbx_max, double max_distance,
-                           bool propagate_negative_distances = false);
+                           bool propagate_negative_distances = false, VoxelStorage storage = DENSE_STORAGE);
 
   /**
    * \brief Constructor that takes an istream and reads the contents
@@ -218,9 +228,14 @@ public:
    * \ref PropagationDistanceField description for more information on
    * the implications of this.
    *
+   * @param [in] storage How the voxel grid stores its cells.  With
+   * \ref BLOCKED_STORAGE only the regions within the maximum distance
+   * of obstacles are allocated.
+   *
    * @return
    */
-  PropagationDistanceField(std::istream& stream, double max_distance, bool propagate_negative_distances = false);
+  PropagationDistanceField(std::istream& stream, double max_distance, bool propagate_negative_distances = false,
+                           VoxelStorage storage = DENSE_STORAGE);
   /**
    * \brief Empty destructor
    *
@@ -298,6 +313,48 @@ public:
    */
   void reset() override;
 
+  /**
+   * \brief Replaces all obstacle points in the field with the given
+   * set and recomputes every cell from scratch.
+   *
+   * Rather than propagating a frontier outward, this computes an
+   * exact Euclidean distance transform of the whole grid as a
+   * sequence of separable one-dimensional lower envelope passes
+   * (Felzenszwalb and Huttenlocher).  Its cost depends only on the
+   * number of cells, which makes it the better choice for bulk
+   * rebuilds from dense point sets.  Distances are exact rather than
+   * propagated, so they can be slightly smaller than the values \ref
+   * addPointsToField would produce for the same points.  The field
+   * can be updated incrementally afterwards as usual.  The transform
+   * works on temporary dense arrays, also with \ref BLOCKED_STORAGE.
+   *
+   * @param [in] points The set of points that will be the only obstacle points in the field
+   */
+  void setPointsInField(const EigenSTL::vector_Vector3d& points);
+
+  /**
+   * \brief Sets the number of threads used to compute distances.
+   *
+   * With more than one thread, each distance level of a large
+   * propagation frontier is expanded in parallel, and the resulting
+   * updates are applied in the same order the serial propagation
+   * would apply them, so the field does not depend on the thread
+   * count.  The passes of \ref setPointsInField are split over the
+   * same number of threads.  Defaults to 1.
+   *
+   * @param [in] thread_count The number of threads, 0 is treated as 1
+   */
+  void setPropagationThreadCount(unsigned int thread_count)
+  {
+    propagation_thread_count_ = std::max(thread_count, 1u);
+  }
+
+  /** \brief The number of threads used to compute distances */
+  unsigned int getPropagationThreadCount() const
+  {
+    return propagation_thread_count_;
+  }
+
   /**
    * \brief Get the distance value associated with the cell indicated
    * by the world coordinate.  If the cell is invalid, max_distance
@@ -375,6 +432,39 @@ public:
    */
   bool readFromStream(std::istream& stream) override;
 
+  /**
+   * \brief Writes all cells of the propagated distance field to the
+   * supplied stream.
+   *
+   * Unlike \ref writeToStream, which only stores the obstacle cells
+   * so that reading has to propagate again, this stores the full
+   * state of every cell.  The format is a fixed size binary header
+   * followed by ten 32 bit integers per cell in native byte order,
+   * ordered by x, then y, then z, so the cell data can also be used
+   * straight from a memory mapped file.
+   *
+   * @param [in] stream The stream to which to write, opened in binary mode
+   *
+   * @return True if all data was written
+   */
+  bool writeCellsToStream(std::ostream& stream) const;
+
+  /**
+   * \brief Restores cells written by \ref writeCellsToStream without
+   * any propagation.
+   *
+   * The data has to come from a field with the same size, resolution,
+   * origin, maximum distance and negative distance setting as this
+   * one.  Storage mode and thread count may differ.
+   *
+   * @param [in] stream The stream from which to read, opened in binary mode
+   *
+   * @return True if the field was restored.  If the header does not
+   * match or the data is truncated or invalid, false is returned and
+   * the field is left reset.
+   */
+  bool readCellsFromStream(std::istream& stream);
+
   // passthrough docs to DistanceField
   double getUninitializedDistance() const override
   {
@@ -394,7 +484,16 @@ public:
    */
   const PropDistanceFieldVoxel& getCell(int x, int y, int z) const
   {
-    return voxel_grid_->getCell(x, y, z);
+    return std::as_const(*voxel_grid_).getCell(x, y, z);
+  }
+
+  /**
+   * \brief Gets the voxel grid that holds the cells, for example to
+   * inspect its memory use.
+   */
+  const VoxelGrid<PropDistanceFieldVoxel>& getVoxelGrid() const
+  {
+    return *voxel_grid_;
   }
 
   /**
@@ -417,19 +516,19 @@ public:
    */
   const PropDistanceFieldVoxel* getNearestCell(int x, int y, int z, double& dist, Eigen::Vector3i& pos) const
   {
-    const PropDistanceFieldVoxel* cell = &voxel_grid_->getCell(x, y, z);
+    const PropDistanceFieldVoxel* cell = &getCell(x, y, z);
     if (cell->distance_square_ > 0)
     {
       dist = sqrt_table_[cell->distance_square_];
       pos = cell->closest_point_;
-      const PropDistanceFieldVoxel* ncell = &voxel_grid_->getCell(pos.x(), pos.y(), pos.z());
+      const PropDistanceFieldVoxel* ncell = &getCell(pos.x(), pos.y(), pos.z());
       return ncell == cell ? nullptr : ncell;
     }
     if (cell->negative_distance_square_ > 0)
     {
       dist = -sqrt_table_[cell->negative_distance_square_];
       pos = cell->closest_negative_point_;
-      const PropDistanceFieldVoxel* ncell = &voxel_grid_->getCell(pos.x(), pos.y(), pos.z());
+      const PropDistanceFieldVoxel* ncell = &getCell(pos.x(), pos.y(), pos.z());
       return ncell == cell ? nullptr : ncell;
     }
     dist = 0.0;
@@ -493,6 +592,21 @@ private:
    */
   void propagateNegative();
 
+  /**
+   * \brief Multithreaded version of \ref propagatePositive and \ref
+   * propagateNegative.
+   *
+   * Each level is expanded in two phases: the frontier is split into
+   * chunks that compute candidate updates without writing, then each
+   * thread applies the candidates that fall into its own slab of the
+   * grid in frontier order.  Levels whose candidates would modify a
+   * voxel of the frontier itself are expanded serially.
+   *
+   * @param bucket_queue The queue to propagate, \ref bucket_queue_ or \ref negative_bucket_queue_
+   * @param negative Whether the negative distances are propagated
+   */
+  void propagateParallel(std::vector<EigenSTL::vector_Vector3i>& bucket_queue, bool negative);
+
   /**
    * \brief Determines distance based on actual voxel data
    *
@@ -502,6 +616,9 @@ private:
    */
   virtual double getDistance(const PropDistanceFieldVoxel& object) const;
 
+  /** \brief Reads the eight corner distances straight from the voxel grid */
+  void getCornerDistances(int x, int y, int z, double distances[8]) const override;
+
   /**
    * \brief Helper function to get a single number in a 27 connected
    * 3D voxel grid given dx, dy, and dz values.
@@ -547,6 +664,8 @@ private:
 
   bool propagate_negative_; /**< \brief Whether or not to propagate negative distances */
 
+  VoxelStorage storage_; /**< \brief How the voxel grid stores its cells */
+
   VoxelGrid<PropDistanceFieldVoxel>::Ptr voxel_grid_; /**< \brief Actual container for distance data */
 
   /// \brief Structure used to hold propagation frontier
@@ -564,6 +683,8 @@ private:
   double max_distance_; /**< \brief Holds maximum distance  */
   int max_distance_sq_; /**< \brief Holds maximum distance squared in cells */
 
+  unsigned int propagation_thread_count_ = 1; /**< \brief Number of threads used to compute distances */
+
   std::vector<double> sqrt_table_; /**< \brief Precomputed square root table for faster distance lookups */
 
   /**
@@ -37,7 +37,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <memory>
 #include <Eigen/Core>
 #include <moveit/macros/declare_ptr.hpp>
 
@@ -51,11 +54,23 @@ enum Dimension
   DIM_Z = 2
 };
 
+/// \brief Specifies how the cells of a VoxelGrid are stored
+enum VoxelStorage
+{
+  DENSE_STORAGE = 0,  ///< A single array holding every cell
+  BLOCKED_STORAGE = 1 ///< Blocks of 8x8x8 cells that are only allocated once a cell in them is written
+};
+
 /**
  * \brief VoxelGrid holds a dense 3D, axis-aligned set of data at a
  * given resolution, where the data is supplied as a template
  * parameter.
  *
+ * With \ref BLOCKED_STORAGE the grid is split into blocks of 8x8x8
+ * cells, stored in Morton order, that are allocated the first time
+ * one of their cells is accessed for writing.  Unallocated blocks
+ * read as the value passed to the last \ref reset, so mostly empty
+ * volumes only pay for the regions that hold data.
  */
 template <typename T>
 class VoxelGrid
@@ -87,9 +102,11 @@ public:
    *
    * @param [in] default_object An object that will be returned for any
    * future queries that are not valid
+   *
+   * @param [in] storage How the cells are stored
    */
   VoxelGrid(double size_x, double size_y, double size_z, double resolution, double origin_x, double origin_y,
-            double origin_z, T default_object);
+            double origin_z, T default_object, VoxelStorage storage = DENSE_STORAGE);
   virtual ~VoxelGrid();
 
   /**
@@ -116,9 +133,11 @@ public:
    * @param [in] origin_x Minimum point along the X axis of the volume
    * @param [in] origin_y Minimum point along the Y axis of the volume
    * @param [in] origin_z Minimum point along the Z axis of the volume
+   *
+   * @param [in] storage How the cells are stored
    */
   void resize(double size_x, double size_y, double size_z, double resolution, double origin_x, double origin_y,
-              double origin_z, T default_object);
+              double origin_z, T default_object, VoxelStorage storage = DENSE_STORAGE);
 
   /**
    * \brief Operator that gets the value of the given location (x, y,
@@ -282,6 +301,26 @@ public:
    */
   bool isCellValid(Dimension dim, int cell) const;
 
+  /**
+   * \brief Gets how the cells are stored.
+   */
+  VoxelStorage getStorage() const;
+
+  /**
+   * \brief Gets the number of cells that currently have memory
+   * allocated, which is the total number of cells for \ref
+   * DENSE_STORAGE.
+   *
+   * With \ref BLOCKED_STORAGE this is not synchronized with
+   * concurrent writes.
+   */
+  std::size_t getNumAllocatedCells() const;
+
+  /// \brief Number of cells along each side of a block of \ref BLOCKED_STORAGE
+  static constexpr int BLOCK_SIZE = 8;
+  /// \brief Number of cells in a block of \ref BLOCKED_STORAGE
+  static constexpr int BLOCK_CELLS = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+
 protected:
   T* data_;                /**< \brief Storage for the full set of data elements */
   T default_object_;       /**< \brief The default object to return in case of out-of-bounds query */
@@ -295,6 +334,11 @@ protected:
   int num_cells_total_;    /**< \brief The total number of voxels in the grid */
   int stride1_;            /**< \brief The step to take when stepping between consecutive X members in the 1D array */
   int stride2_; /**< \brief The step to take when stepping between consecutive Y members given an X in the 1D array */
+  VoxelStorage storage_;                       /**< \brief How the cells are stored */
+  std::unique_ptr<std::atomic<T*>[]> blocks_;  /**< \brief Block pointers for BLOCKED_STORAGE, null if unallocated */
+  int num_blocks_[3];                          /**< \brief The number of blocks in each dimension */
+  int num_blocks_total_;                       /**< \brief The total number of blocks in the grid */
+  T background_;                               /**< \brief The value of all cells in unallocated blocks */
 
   /**
    * \brief Gets the 1D index into the array, with no validity check.
@@ -307,6 +351,35 @@ protected:
    */
   int ref(int x, int y, int z) const;
 
+  /**
+   * \brief Gets the index of the block that holds a cell, with no
+   * validity check.
+   */
+  int blockRef(int x, int y, int z) const;
+
+  /**
+   * \brief Gets the Morton index of a cell within its block, which
+   * keeps neighboring cells close in memory.
+   */
+  static int blockOffset(int x, int y, int z);
+
+  /**
+   * \brief Gets a cell of \ref BLOCKED_STORAGE, allocating its block
+   * if needed.  Concurrent calls are safe.
+   */
+  T& getBlockCell(int x, int y, int z);
+
+  /**
+   * \brief Gets a cell of \ref BLOCKED_STORAGE, which is the
+   * background value if its block is unallocated.
+   */
+  const T& getBlockCell(int x, int y, int z) const;
+
+  /**
+   * \brief Frees all allocated blocks.
+   */
+  void releaseBlocks();
+
   /**
    * \brief Gets the cell number from the location
    */
@@ -337,14 +410,14 @@ protected:
 
 template <typename T>
 VoxelGrid<T>::VoxelGrid(double size_x, double size_y, double size_z, double resolution, double origin_x,
-                        double origin_y, double origin_z, T default_object)
-  : data_(nullptr)
+                        double origin_y, double origin_z, T default_object, VoxelStorage storage)
+  : data_(nullptr), storage_(DENSE_STORAGE), num_blocks_total_(0)
 {
-  resize(size_x, size_y, size_z, resolution, origin_x, origin_y, origin_z, default_object);
+  resize(size_x, size_y, size_z, resolution, origin_x, origin_y, origin_z, default_object, storage);
 }
 
 template <typename T>
-VoxelGrid<T>::VoxelGrid() : data_(nullptr)
+VoxelGrid<T>::VoxelGrid() : data_(nullptr), storage_(DENSE_STORAGE), num_blocks_total_(0)
 {
   for (int i = DIM_X; i <= DIM_Z; ++i)
   {
@@ -352,6 +425,7 @@ VoxelGrid<T>::VoxelGrid() : data_(nullptr)
     origin_[i] = 0;
     origin_minus_[i] = 0;
     num_cells_[i] = 0;
+    num_blocks_[i] = 0;
   }
   resolution_ = 1.0;
   oo_resolution_ = 1.0 / resolution_;
@@ -362,10 +436,12 @@ VoxelGrid<T>::VoxelGrid() : data_(nullptr)
 
 template <typename T>
 void VoxelGrid<T>::resize(double size_x, double size_y, double size_z, double resolution, double origin_x,
-                          double origin_y, double origin_z, T default_object)
+                          double origin_y, double origin_z, T default_object, VoxelStorage storage)
 {
   delete[] data_;
   data_ = nullptr;
+  releaseBlocks();
+  blocks_.reset();
 
   size_[DIM_X] = size_x;
   size_[DIM_Y] = size_y;
@@ -386,12 +462,29 @@ void VoxelGrid<T>::resize(double size_x, double size_y, double size_z, double re
   }
 
   default_object_ = default_object;
+  background_ = default_object;
+  storage_ = storage;
 
   stride1_ = num_cells_[DIM_Y] * num_cells_[DIM_Z];
   stride2_ = num_cells_[DIM_Z];
 
+  num_blocks_total_ = 1;
+  for (int i = DIM_X; i <= DIM_Z; ++i)
+  {
+    num_blocks_[i] = (num_cells_[i] + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    num_blocks_total_ *= num_blocks_[i];
+  }
+
   // initialize the data:
-  if (num_cells_total_ > 0)
+  if (num_cells_total_ <= 0)
+    return;
+  if (storage_ == BLOCKED_STORAGE)
+  {
+    blocks_.reset(new std::atomic<T*>[num_blocks_total_]);
+    for (int i = 0; i < num_blocks_total_; ++i)
+      blocks_[i].store(nullptr, std::memory_order_relaxed);
+  }
+  else
     data_ = new T[num_cells_total_];
 }
 
@@ -399,6 +492,75 @@ template <typename T>
 VoxelGrid<T>::~VoxelGrid()
 {
   delete[] data_;
+  releaseBlocks();
+}
+
+template <typename T>
+void VoxelGrid<T>::releaseBlocks()
+{
+  if (!blocks_)
+    return;
+  for (int i = 0; i < num_blocks_total_; ++i)
+    delete[] blocks_[i].exchange(nullptr, std::memory_order_relaxed);
+}
+
+template <typename T>
+inline int VoxelGrid<T>::blockRef(int x, int y, int z) const
+{
+  return ((x / BLOCK_SIZE) * num_blocks_[DIM_Y] + y / BLOCK_SIZE) * num_blocks_[DIM_Z] + z / BLOCK_SIZE;
+}
+
+template <typename T>
+inline int VoxelGrid<T>::blockOffset(int x, int y, int z)
+{
+  // spreads the three low bits of a coordinate so that they can be interleaved
+  static constexpr int SPREAD[BLOCK_SIZE] = { 0, 1, 8, 9, 64, 65, 72, 73 };
+  return (SPREAD[x % BLOCK_SIZE] << 2) | (SPREAD[y % BLOCK_SIZE] << 1) | SPREAD[z % BLOCK_SIZE];
+}
+
+template <typename T>
+T& VoxelGrid<T>::getBlockCell(int x, int y, int z)
+{
+  std::atomic<T*>& slot = blocks_[blockRef(x, y, z)];
+  T* block = slot.load(std::memory_order_acquire);
+  if (!block)
+  {
+    T* allocated = new T[BLOCK_CELLS];
+    std::fill(allocated, allocated + BLOCK_CELLS, background_);
+    // another thread may have allocated the same block in the meantime
+    if (slot.compare_exchange_strong(block, allocated, std::memory_order_acq_rel, std::memory_order_acquire))
+      block = allocated;
+    else
+      delete[] allocated;
+  }
+  return block[blockOffset(x, y, z)];
+}
+
+template <typename T>
+inline const T& VoxelGrid<T>::getBlockCell(int x, int y, int z) const
+{
+  const T* block = blocks_[blockRef(x, y, z)].load(std::memory_order_acquire);
+  return block ? block[blockOffset(x, y, z)] : background_;
+}
+
+template <typename T>
+inline VoxelStorage VoxelGrid<T>::getStorage() const
+{
+  return storage_;
+}
+
+template <typename T>
+std::size_t VoxelGrid<T>::getNumAllocatedCells() const
+{
+  if (storage_ != BLOCKED_STORAGE)
+    return data_ ? num_cells_total_ : 0;
+  std::size_t count = 0;
+  for (int i = 0; i < num_blocks_total_; ++i)
+  {
+    if (blocks_[i].load(std::memory_order_relaxed))
+      count += BLOCK_CELLS;
+  }
+  return count;
 }
 
 template <typename T>
@@ -469,37 +631,41 @@ inline const T& VoxelGrid<T>::operator()(const Eigen::Vector3d& pos) const
 template <typename T>
 inline T& VoxelGrid<T>::getCell(int x, int y, int z)
 {
+  if (storage_ == BLOCKED_STORAGE)
+    return getBlockCell(x, y, z);
   return data_[ref(x, y, z)];
 }
 
 template <typename T>
 inline const T& VoxelGrid<T>::getCell(int x, int y, int z) const
 {
+  if (storage_ == BLOCKED_STORAGE)
+    return getBlockCell(x, y, z);
   return data_[ref(x, y, z)];
 }
 
 template <typename T>
 inline T& VoxelGrid<T>::getCell(const Eigen::Vector3i& pos)
 {
-  return data_[ref(pos.x(), pos.y(), pos.z())];
+  return getCell(pos.x(), pos.y(), pos.z());
 }
 
 template <typename T>
 inline const T& VoxelGrid<T>::getCell(const Eigen::Vector3i& pos) const
 {
-  return data_[ref(pos.x(), pos.y(), pos.z())];
+  return getCell(pos.x(), pos.y(), pos.z());
 }
 
 template <typename T>
 inline void VoxelGrid<T>::setCell(int x, int y, int z, const T& obj)
 {
-  data_[ref(x, y, z)] = obj;
+  getCell(x, y, z) = obj;
 }
 
 template <typename T>
 inline void VoxelGrid<T>::setCell(const Eigen::Vector3i& pos, const T& obj)
 {
-  data_[ref(pos.x(), pos.y(), pos.z())] = obj;
+  getCell(pos.x(), pos.y(), pos.z()) = obj;
 }
 
 template <typename T>
@@ -531,6 +697,12 @@ inline double VoxelGrid<T>::getLocationFromCell(Dimension dim, int cell) const
 template <typename T>
 inline void VoxelGrid<T>::reset(const T& initial)
 {
+  if (storage_ == BLOCKED_STORAGE)
+  {
+    releaseBlocks();
+    background_ = initial;
+    return;
+  }
   std::fill(data_, data_ + num_cells_total_, initial);
 }
 
@@ -44,6 +44,7 @@
 #include <octomap/octomap.h>
 #include <octomap/OcTree.h>
 #include <moveit/utils/logger.hpp>
+#include <algorithm>
 
 namespace distance_field
 {
@@ -53,6 +54,40 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.distance_field");
 }
+
+// finds the box of cells used to interpolate at the continuous cell coordinate, cell centers are at integer values
+bool getInterpolationBox(double coordinate, int num_cells, int& index, double& offset)
+{
+  // written to also reject NaN
+  if (!(coordinate >= 0.0 && coordinate <= num_cells - 1) || num_cells < 2)
+  {
+    return false;
+  }
+  // on the upper boundary the last box is used, with the location on its far side
+  index = std::min(static_cast<int>(coordinate), num_cells - 2);
+  offset = coordinate - index;
+  return true;
+}
+
+// trilinear interpolation of the corner distances of a cell box, (tx, ty, tz) is the location within the box in [0, 1]
+double interpolateCorners(const double c[8], double tx, double ty, double tz, double inv_resolution,
+                          double& gradient_x, double& gradient_y, double& gradient_z)
+{
+  // interpolate along x first, the corners are indexed by 4*dx + 2*dy + dz
+  const double c00 = c[0] + (c[4] - c[0]) * tx;
+  const double c01 = c[1] + (c[5] - c[1]) * tx;
+  const double c10 = c[2] + (c[6] - c[2]) * tx;
+  const double c11 = c[3] + (c[7] - c[3]) * tx;
+  const double c0 = c00 + (c10 - c00) * ty;
+  const double c1 = c01 + (c11 - c01) * ty;
+
+  const double dx0 = (c[4] - c[0]) + ((c[6] - c[2]) - (c[4] - c[0])) * ty;
+  const double dx1 = (c[5] - c[1]) + ((c[7] - c[3]) - (c[5] - c[1])) * ty;
+  gradient_x = (dx0 + (dx1 - dx0) * tz) * inv_resolution;
+  gradient_y = ((c10 - c00) + ((c11 - c01) - (c10 - c00)) * tz) * inv_resolution;
+  gradient_z = (c1 - c0) * inv_resolution;
+  return c0 + (c1 - c0) * tz;
+}
 }  // namespace
 
 DistanceField::DistanceField(double size_x, double size_y, double size_z, double resolution, double origin_x,
@@ -140,6 +175,72 @@ void DistanceField::getIsoSurfaceMarkers(double min_distance, double max_distanc
   }
 }
 
+double DistanceField::getInterpolatedDistanceGradient(double x, double y, double z, double& gradient_x,
+                                                      double& gradient_y, double& gradient_z, bool& in_bounds) const
+{
+  const double inv_resolution = 1.0 / resolution_;
+  int index[3];
+  double offset[3];
+  in_bounds = getInterpolationBox((x - origin_x_) * inv_resolution, getXNumCells(), index[0], offset[0]) &&
+              getInterpolationBox((y - origin_y_) * inv_resolution, getYNumCells(), index[1], offset[1]) &&
+              getInterpolationBox((z - origin_z_) * inv_resolution, getZNumCells(), index[2], offset[2]);
+  if (!in_bounds)
+  {
+    gradient_x = 0.0;
+    gradient_y = 0.0;
+    gradient_z = 0.0;
+    return getUninitializedDistance();
+  }
+
+  double corners[8];
+  getCornerDistances(index[0], index[1], index[2], corners);
+  return interpolateCorners(corners, offset[0], offset[1], offset[2], inv_resolution, gradient_x, gradient_y,
+                            gradient_z);
+}
+
+bool DistanceField::getInterpolatedDistanceGradients(const EigenSTL::vector_Vector3d& points,
+                                                     std::vector<double>& distances,
+                                                     EigenSTL::vector_Vector3d& gradients) const
+{
+  distances.resize(points.size());
+  gradients.resize(points.size());
+
+  // the field properties are looked up once for the whole batch
+  const int num_cells[3] = { getXNumCells(), getYNumCells(), getZNumCells() };
+  const double inv_resolution = 1.0 / resolution_;
+  const double uninitialized_distance = getUninitializedDistance();
+
+  bool all_in_bounds = true;
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    int index[3];
+    double offset[3];
+    if (!getInterpolationBox((points[i].x() - origin_x_) * inv_resolution, num_cells[0], index[0], offset[0]) ||
+        !getInterpolationBox((points[i].y() - origin_y_) * inv_resolution, num_cells[1], index[1], offset[1]) ||
+        !getInterpolationBox((points[i].z() - origin_z_) * inv_resolution, num_cells[2], index[2], offset[2]))
+    {
+      distances[i] = uninitialized_distance;
+      gradients[i].setZero();
+      all_in_bounds = false;
+      continue;
+    }
+
+    double corners[8];
+    getCornerDistances(index[0], index[1], index[2], corners);
+    distances[i] = interpolateCorners(corners, offset[0], offset[1], offset[2], inv_resolution, gradients[i].x(),
+                                      gradients[i].y(), gradients[i].z());
+  }
+  return all_in_bounds;
+}
+
+void DistanceField::getCornerDistances(int x, int y, int z, double distances[8]) const
+{
+  for (int i = 0; i < 8; ++i)
+  {
+    distances[i] = getDistance(x + ((i >> 2) & 1), y + ((i >> 1) & 1), z + (i & 1));
+  }
+}
+
 void DistanceField::getGradientMarkers(double min_distance, double max_distance, const std::string& frame_id,
                                        const rclcpp::Time& stamp,
                                        visualization_msgs::msg::MarkerArray& marker_array) const
@@ -218,6 +319,11 @@ bool DistanceField::getShapePoints(const shapes::Shape* shape, const Eigen::Isom
     }
     getOcTreePoints(oc->octree.get(), points);
   }
+  else if (shape->type == shapes::MESH)
+  {
+    // the body of a mesh is its convex hull, so the mesh itself is voxelized instead
+    findInternalPointsMesh(*static_cast<const shapes::Mesh*>(shape), pose, resolution_, *points);
+  }
   else
   {
     bodies::Body* body = bodies::createEmptyBodyFromShapeType(shape->type);
@@ -298,28 +404,17 @@ void DistanceField::moveShapeInField(const shapes::Shape* shape, const Eigen::Is
     RCLCPP_WARN(getLogger(), "Move shape not supported for Octree");
     return;
   }
-  bodies::Body* body = bodies::createEmptyBodyFromShapeType(shape->type);
-  body->setDimensionsDirty(shape);
-  body->setPoseDirty(old_pose);
-  body->updateInternalData();
   EigenSTL::vector_Vector3d old_point_vec;
-  findInternalPointsConvex(*body, resolution_, old_point_vec);
-  body->setPose(new_pose);
+  getShapePoints(shape, old_pose, &old_point_vec);
   EigenSTL::vector_Vector3d new_point_vec;
-  findInternalPointsConvex(*body, resolution_, new_point_vec);
-  delete body;
+  getShapePoints(shape, new_pose, &new_point_vec);
   updatePointsInField(old_point_vec, new_point_vec);
 }
 
 void DistanceField::removeShapeFromField(const shapes::Shape* shape, const Eigen::Isometry3d& pose)
 {
-  bodies::Body* body = bodies::createEmptyBodyFromShapeType(shape->type);
-  body->setDimensionsDirty(shape);
-  body->setPoseDirty(pose);
-  body->updateInternalData();
   EigenSTL::vector_Vector3d point_vec;
-  findInternalPointsConvex(*body, resolution_, point_vec);
-  delete body;
+  getShapePoints(shape, pose, &point_vec);
   removePointsFromField(point_vec);
 }
 
@@ -35,6 +35,96 @@
 /* Author: Acorn Pooley */
 
 #include <moveit/distance_field/find_internal_points.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// twice the signed area of the triangle (a, b, p) projected on the xy plane
+double orient2d(const Eigen::Vector3d& a, const Eigen::Vector3d& b, double px, double py)
+{
+  return (b.x() - a.x()) * (py - a.y()) - (b.y() - a.y()) * (px - a.x());
+}
+
+// top-left fill rule for the edge from a to b of a counter-clockwise triangle: a column exactly on an edge only
+// belongs to the triangle for top and left edges, so that it crosses each surface layer exactly once
+bool isTopLeftEdge(const Eigen::Vector3d& a, const Eigen::Vector3d& b)
+{
+  return (a.y() == b.y() && b.x() < a.x()) || b.y() < a.y();
+}
+
+bool isInsideEdge(double w, const Eigen::Vector3d& a, const Eigen::Vector3d& b)
+{
+  return w > 0.0 || (w == 0.0 && isTopLeftEdge(a, b));
+}
+
+// appends the internal points of the columns x_begin <= i < x_end, y_begin <= j < y_end
+void findInternalPointsMeshSlab(const EigenSTL::vector_Vector3d& vertices, const shapes::Mesh& mesh, double resolution,
+                                int x_begin, int x_end, int y_begin, int y_end, EigenSTL::vector_Vector3d& points)
+{
+  const int num_y = y_end - y_begin;
+  std::vector<std::vector<double>> crossings(static_cast<std::size_t>(x_end - x_begin) * num_y);
+
+  for (unsigned int t = 0; t < mesh.triangle_count; ++t)
+  {
+    const Eigen::Vector3d& a = vertices[mesh.triangles[3 * t]];
+    Eigen::Vector3d b = vertices[mesh.triangles[3 * t + 1]];
+    Eigen::Vector3d c = vertices[mesh.triangles[3 * t + 2]];
+    double area = orient2d(a, b, c.x(), c.y());
+    // triangles parallel to the columns are never crossed
+    if (area == 0.0)
+      continue;
+    if (area < 0.0)
+    {
+      std::swap(b, c);
+      area = -area;
+    }
+
+    const int i_begin = std::max(x_begin, static_cast<int>(std::ceil(std::min({ a.x(), b.x(), c.x() }) / resolution)));
+    const int i_end = std::min(x_end, static_cast<int>(std::floor(std::max({ a.x(), b.x(), c.x() }) / resolution)) + 1);
+    const int j_begin = std::max(y_begin, static_cast<int>(std::ceil(std::min({ a.y(), b.y(), c.y() }) / resolution)));
+    const int j_end = std::min(y_end, static_cast<int>(std::floor(std::max({ a.y(), b.y(), c.y() }) / resolution)) + 1);
+    for (int i = i_begin; i < i_end; ++i)
+    {
+      const double px = i * resolution;
+      for (int j = j_begin; j < j_end; ++j)
+      {
+        const double py = j * resolution;
+        const double wa = orient2d(b, c, px, py);
+        const double wb = orient2d(c, a, px, py);
+        const double wc = orient2d(a, b, px, py);
+        if (isInsideEdge(wa, b, c) && isInsideEdge(wb, c, a) && isInsideEdge(wc, a, b))
+        {
+          crossings[static_cast<std::size_t>(i - x_begin) * num_y + (j - y_begin)].push_back(
+              (wa * a.z() + wb * b.z() + wc * c.z()) / area);
+        }
+      }
+    }
+  }
+
+  for (int i = x_begin; i < x_end; ++i)
+  {
+    for (int j = y_begin; j < y_end; ++j)
+    {
+      std::vector<double>& column = crossings[static_cast<std::size_t>(i - x_begin) * num_y + (j - y_begin)];
+      std::sort(column.begin(), column.end());
+      // an unpaired crossing of a mesh that is not closed is ignored
+      for (std::size_t k = 0; k + 1 < column.size(); k += 2)
+      {
+        const int z_end = static_cast<int>(std::floor(column[k + 1] / resolution));
+        for (int z = static_cast<int>(std::ceil(column[k] / resolution)); z <= z_end; ++z)
+        {
+          points.push_back(Eigen::Vector3d(i * resolution, j * resolution, z * resolution));
+        }
+      }
+    }
+  }
+}
+}  // namespace
 
 void distance_field::findInternalPointsConvex(const bodies::Body& body, double resolution,
                                               EigenSTL::vector_Vector3d& points)
@@ -62,3 +152,65 @@ void distance_field::findInternalPointsConvex(const bodies::Body& body, double r
     }
   }
 }
+
+void distance_field::findInternalPointsMesh(const shapes::Mesh& mesh, const Eigen::Isometry3d& pose, double resolution,
+                                            EigenSTL::vector_Vector3d& points, double padding,
+                                            unsigned int thread_count)
+{
+  if (mesh.vertex_count == 0 || mesh.triangle_count == 0 || resolution <= 0.0)
+    return;
+
+  EigenSTL::vector_Vector3d vertices(mesh.vertex_count);
+  Eigen::Vector3d box_min = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+  Eigen::Vector3d box_max = -box_min;
+  for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+  {
+    vertices[i] = Eigen::Vector3d(mesh.vertices[3 * i], mesh.vertices[3 * i + 1], mesh.vertices[3 * i + 2]);
+    box_min = box_min.cwiseMin(vertices[i]);
+    box_max = box_max.cwiseMax(vertices[i]);
+  }
+
+  const Eigen::Vector3d center = 0.5 * (box_min + box_max);
+  box_min = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+  box_max = -box_min;
+  for (Eigen::Vector3d& vertex : vertices)
+  {
+    const Eigen::Vector3d offset = vertex - center;
+    if (padding != 0.0 && offset.norm() > 0.0)
+      vertex += offset.normalized() * padding;
+    vertex = pose * vertex;
+    box_min = box_min.cwiseMin(vertex);
+    box_max = box_max.cwiseMax(vertex);
+  }
+
+  // columns of the grid points within the bounding box of the posed mesh
+  const int x_begin = static_cast<int>(std::ceil(box_min.x() / resolution));
+  const int x_end = static_cast<int>(std::floor(box_max.x() / resolution)) + 1;
+  const int y_begin = static_cast<int>(std::ceil(box_min.y() / resolution));
+  const int y_end = static_cast<int>(std::floor(box_max.y() / resolution)) + 1;
+  if (x_begin >= x_end || y_begin >= y_end)
+    return;
+
+  thread_count = std::max(1u, std::min(thread_count, static_cast<unsigned int>(x_end - x_begin)));
+  if (thread_count == 1)
+  {
+    findInternalPointsMeshSlab(vertices, mesh, resolution, x_begin, x_end, y_begin, y_end, points);
+    return;
+  }
+
+  // every thread voxelizes a slab of x values, which keeps the points ordered when appending the slabs
+  std::vector<EigenSTL::vector_Vector3d> slab_points(thread_count);
+  std::vector<std::thread> threads;
+  for (unsigned int thread = 0; thread < thread_count; ++thread)
+  {
+    const int slab_begin = x_begin + (x_end - x_begin) * static_cast<int>(thread) / static_cast<int>(thread_count);
+    const int slab_end = x_begin + (x_end - x_begin) * static_cast<int>(thread + 1) / static_cast<int>(thread_count);
+    threads.emplace_back(findInternalPointsMeshSlab, std::cref(vertices), std::cref(mesh), resolution, slab_begin,
+                         slab_end, y_begin, y_end, std::ref(slab_points[thread]));
+  }
+  for (unsigned int thread = 0; thread < thread_count; ++thread)
+  {
+    threads[thread].join();
+    points.insert(points.end(), slab_points[thread].begin(), slab_points[thread].end());
+  }
+}
@@ -42,6 +42,14 @@
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <moveit/utils/logger.hpp>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace distance_field
 {
@@ -51,13 +59,222 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.propagation_distance_field");
 }
+
+// binary cell format of writeCellsToStream
+constexpr std::uint32_t CELLS_MAGIC = 0x4346444d;  // "MDFC" in little endian
+constexpr std::uint32_t CELLS_VERSION = 1;
+constexpr int CELL_VALUES = 10;
+
+template <typename T>
+void writeBinary(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readBinary(std::istream& is, T& value)
+{
+  return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Frontiers smaller than this are expanded on the calling thread
+constexpr std::size_t MIN_PARALLEL_FRONTIER = 1024;
+
+// Squared distance of cells that have no feature on a distance transform line
+constexpr int EDT_INFINITY = std::numeric_limits<int>::max();
+
+/** \brief Fixed set of threads that run the same task on request, kept for the duration of one propagation */
+class PropagationWorkers
+{
+public:
+  explicit PropagationWorkers(unsigned int thread_count)
+  {
+    for (unsigned int i = 1; i < thread_count; ++i)
+      threads_.emplace_back([this, i] { work(i); });
+  }
+
+  ~PropagationWorkers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_)
+      thread.join();
+  }
+
+  unsigned int size() const
+  {
+    return static_cast<unsigned int>(threads_.size()) + 1;
+  }
+
+  /** \brief Runs task(thread_index) on every thread, including the calling one as index 0, and waits for all */
+  void run(const std::function<void(unsigned int)>& task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = &task;
+      pending_ = threads_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+    task(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    task_ = nullptr;
+  }
+
+private:
+  void work(unsigned int index)
+  {
+    std::size_t generation = 0;
+    while (true)
+    {
+      const std::function<void(unsigned int)>* task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [this, generation] { return stop_ || generation_ != generation; });
+        if (stop_)
+          return;
+        generation = generation_;
+        task = task_;
+      }
+      (*task)(index);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0)
+        done_.notify_one();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const std::function<void(unsigned int)>* task_ = nullptr;
+  std::size_t generation_ = 0;
+  std::size_t pending_ = 0;
+  bool stop_ = false;
+};
+
+/** \brief A voxel update found while expanding a propagation frontier */
+struct PropagationUpdate
+{
+  Eigen::Vector3i location;
+  Eigen::Vector3i closest_point;
+  int distance_square;
+  int update_direction;
+  bool applied;
+};
+
+/** \brief Scratch space for transforming one grid line */
+struct DistanceTransformLine
+{
+  std::vector<int> distance;
+  std::vector<int> source;
+  std::vector<int> vertices;
+  std::vector<double> boundaries;
+};
+
+/**
+ * \brief One pass of the separable squared Euclidean distance transform.
+ *
+ * Replaces the squared distances along a line of \e count cells with the
+ * lower envelope of the parabolas rooted at them, and carries along the
+ * index of the feature cell each minimum came from.
+ */
+void transformLine(int* distance, int* source, std::size_t stride, int count, DistanceTransformLine& line)
+{
+  line.distance.resize(count);
+  line.source.resize(count);
+  line.vertices.resize(count);
+  line.boundaries.resize(count + 1);
+  for (int q = 0; q < count; ++q)
+  {
+    line.distance[q] = distance[q * stride];
+    line.source[q] = source[q * stride];
+  }
+
+  int k = -1;
+  for (int q = 0; q < count; ++q)
+  {
+    if (line.distance[q] == EDT_INFINITY)
+      continue;
+    const double height = static_cast<double>(line.distance[q]) + static_cast<double>(q) * q;
+    double intersection = 0.0;
+    while (k >= 0)
+    {
+      const int p = line.vertices[k];
+      intersection = (height - (static_cast<double>(line.distance[p]) + static_cast<double>(p) * p)) / (2.0 * (q - p));
+      if (intersection > line.boundaries[k])
+        break;
+      --k;
+    }
+    ++k;
+    line.vertices[k] = q;
+    line.boundaries[k] = k == 0 ? -std::numeric_limits<double>::infinity() : intersection;
+  }
+  if (k < 0)
+    return;
+  line.boundaries[k + 1] = std::numeric_limits<double>::infinity();
+
+  k = 0;
+  for (int q = 0; q < count; ++q)
+  {
+    while (line.boundaries[k + 1] < q)
+      ++k;
+    const int p = line.vertices[k];
+    distance[q * stride] = (q - p) * (q - p) + line.distance[p];
+    source[q * stride] = line.source[p];
+  }
+}
+
+/**
+ * \brief Exact squared Euclidean distance transform of a grid stored with z varying fastest.
+ *
+ * Feature cells hold a distance of 0 and their own index in \e source, all
+ * others EDT_INFINITY. On return every cell holds the squared distance to
+ * its closest feature cell and that cell's index.
+ */
+void transformGrid(int num_x, int num_y, int num_z, std::vector<int>& distance, std::vector<int>& source,
+                   PropagationWorkers* workers)
+{
+  using LinePass = std::function<void(std::size_t, DistanceTransformLine&)>;
+  const auto run_pass = [workers](std::size_t line_count, const LinePass& pass) {
+    const unsigned int thread_count = workers ? workers->size() : 1;
+    const auto run_lines = [&](unsigned int thread) {
+      DistanceTransformLine line;
+      for (std::size_t i = line_count * thread / thread_count; i < line_count * (thread + 1) / thread_count; ++i)
+        pass(i, line);
+    };
+    if (workers)
+      workers->run(run_lines);
+    else
+      run_lines(0);
+  };
+
+  const std::size_t stride_y = num_z;
+  const std::size_t stride_x = static_cast<std::size_t>(num_y) * num_z;
+  run_pass(static_cast<std::size_t>(num_x) * num_y, [&](std::size_t i, DistanceTransformLine& line) {
+    const std::size_t start = i * stride_y;
+    transformLine(&distance[start], &source[start], 1, num_z, line);
+  });
+  run_pass(static_cast<std::size_t>(num_x) * num_z, [&](std::size_t i, DistanceTransformLine& line) {
+    const std::size_t start = (i / num_z) * stride_x + i % num_z;
+    transformLine(&distance[start], &source[start], stride_y, num_y, line);
+  });
+  run_pass(stride_x, [&](std::size_t i, DistanceTransformLine& line) {
+    transformLine(&distance[i], &source[i], stride_x, num_x, line);
+  });
+}
 }  // namespace
 
 PropagationDistanceField::PropagationDistanceField(double size_x, double size_y, double size_z, double resolution,
                                                    double origin_x, double origin_y, double origin_z,
-                                                   double max_distance, bool propagate_negative)
+                                                   double max_distance, bool propagate_negative, VoxelStorage storage)
   : DistanceField(size_x, size_y, size_z, resolution, origin_x, origin_y, origin_z)
   , propagate_negative_(propagate_negative)
+  , storage_(storage)
   , max_distance_(max_distance)
 {
   initialize();
@@ -65,10 +282,11 @@ PropagationDistanceField::PropagationDistanceField(double size_x, double size_y,
 
 PropagationDistanceField::PropagationDistanceField(const octomap::OcTree& octree, const octomap::point3d& bbx_min,
                                                    const octomap::point3d& bbx_max, double max_distance,
-                                                   bool propagate_negative_distances)
+                                                   bool propagate_negative_distances, VoxelStorage storage)
   : DistanceField(bbx_max.x() - bbx_min.x(), bbx_max.y() - bbx_min.y(), bbx_max.z() - bbx_min.z(),
                   octree.getResolution(), bbx_min.x(), bbx_min.y(), bbx_min.z())
   , propagate_negative_(propagate_negative_distances)
+  , storage_(storage)
   , max_distance_(max_distance)
   , max_distance_sq_(0)  // avoid gcc warning about uninitialized value
 {
@@ -77,8 +295,11 @@ PropagationDistanceField::PropagationDistanceField(const octomap::OcTree& octree
 }
 
 PropagationDistanceField::PropagationDistanceField(std::istream& is, double max_distance,
-                                                   bool propagate_negative_distances)
-  : DistanceField(0, 0, 0, 0, 0, 0, 0), propagate_negative_(propagate_negative_distances), max_distance_(max_distance)
+                                                   bool propagate_negative_distances, VoxelStorage storage)
+  : DistanceField(0, 0, 0, 0, 0, 0, 0)
+  , propagate_negative_(propagate_negative_distances)
+  , storage_(storage)
+  , max_distance_(max_distance)
 {
   readFromStream(is);
 }
@@ -86,9 +307,9 @@ PropagationDistanceField::PropagationDistanceField(std::istream& is, double max_
 void PropagationDistanceField::initialize()
 {
   max_distance_sq_ = ceil(max_distance_ / resolution_) * ceil(max_distance_ / resolution_);
-  voxel_grid_ =
-      std::make_shared<VoxelGrid<PropDistanceFieldVoxel>>(size_x_, size_y_, size_z_, resolution_, origin_x_, origin_y_,
-                                                          origin_z_, PropDistanceFieldVoxel(max_distance_sq_, 0));
+  voxel_grid_ = std::make_shared<VoxelGrid<PropDistanceFieldVoxel>>(
+      size_x_, size_y_, size_z_, resolution_, origin_x_, origin_y_, origin_z_,
+      PropDistanceFieldVoxel(max_distance_sq_, 0), storage_);
 
   initNeighborhoods();
 
@@ -225,7 +446,8 @@ void PropagationDistanceField::addNewObstacleVoxels(const EigenSTL::vector_Vecto
   EigenSTL::vector_Vector3i negative_stack;
   if (propagate_negative_)
   {
-    negative_stack.reserve(getXNumCells() * getYNumCells() * getZNumCells());
+    if (storage_ != BLOCKED_STORAGE)
+      negative_stack.reserve(getXNumCells() * getYNumCells() * getZNumCells());
     negative_bucket_queue_[0].reserve(voxel_points.size());
   }
 
@@ -307,11 +529,13 @@ void PropagationDistanceField::removeObstacleVoxels(const EigenSTL::vector_Vecto
   EigenSTL::vector_Vector3i negative_stack;
   int initial_update_direction = getDirectionNumber(0, 0, 0);
 
-  stack.reserve(getXNumCells() * getYNumCells() * getZNumCells());
+  if (storage_ != BLOCKED_STORAGE)
+    stack.reserve(getXNumCells() * getYNumCells() * getZNumCells());
   bucket_queue_[0].reserve(voxel_points.size());
   if (propagate_negative_)
   {
-    negative_stack.reserve(getXNumCells() * getYNumCells() * getZNumCells());
+    if (storage_ != BLOCKED_STORAGE)
+      negative_stack.reserve(getXNumCells() * getYNumCells() * getZNumCells());
     negative_bucket_queue_[0].reserve(voxel_points.size());
   }
 
@@ -389,6 +613,12 @@ void PropagationDistanceField::removeObstacleVoxels(const EigenSTL::vector_Vecto
 
 void PropagationDistanceField::propagatePositive()
 {
+  if (propagation_thread_count_ > 1)
+  {
+    propagateParallel(bucket_queue_, false);
+    return;
+  }
+
   // now process the queue:
   for (unsigned int i = 0; i < bucket_queue_.size(); ++i)
   {
@@ -422,14 +652,15 @@ void PropagationDistanceField::propagatePositive()
 
         // the real update code:
         // calculate the neighbor's new distance based on my closest filled voxel:
-        PropDistanceFieldVoxel* neighbor = &voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z());
         int new_distance_sq = (vptr->closest_point_ - nloc).squaredNorm();
         if (new_distance_sq > max_distance_sq_)
           continue;
 
-        if (new_distance_sq < neighbor->distance_square_)
+        // read-only until it is updated, so that blocked storage does not allocate unchanged neighbors
+        if (new_distance_sq < getCell(nloc.x(), nloc.y(), nloc.z()).distance_square_)
         {
           // update the neighboring voxel
+          PropDistanceFieldVoxel* neighbor = &voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z());
           neighbor->distance_square_ = new_distance_sq;
           neighbor->closest_point_ = vptr->closest_point_;
           neighbor->update_direction_ = getDirectionNumber(diff.x(), diff.y(), diff.z());
@@ -445,6 +676,12 @@ void PropagationDistanceField::propagatePositive()
 
 void PropagationDistanceField::propagateNegative()
 {
+  if (propagation_thread_count_ > 1)
+  {
+    propagateParallel(negative_bucket_queue_, true);
+    return;
+  }
+
   // now process the queue:
   for (unsigned int i = 0; i < negative_bucket_queue_.size(); ++i)
   {
@@ -479,14 +716,14 @@ void PropagationDistanceField::propagateNegative()
 
         // the real update code:
         // calculate the neighbor's new distance based on my closest filled voxel:
-        PropDistanceFieldVoxel* neighbor = &voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z());
         int new_distance_sq = (vptr->closest_negative_point_ - nloc).squaredNorm();
         if (new_distance_sq > max_distance_sq_)
           continue;
         // std::cout << "Looking at " << nloc.x() << " " << nloc.y() << " " << nloc.z() << " " << new_distance_sq << " "
         // << neighbor->negative_distance_square_ << '\n';
-        if (new_distance_sq < neighbor->negative_distance_square_)
+        if (new_distance_sq < getCell(nloc.x(), nloc.y(), nloc.z()).negative_distance_square_)
         {
+          PropDistanceFieldVoxel* neighbor = &voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z());
           // std::cout << "Updating " << nloc.x() << " " << nloc.y() << " " << nloc.z() << " " << new_distance_sq <<
           // '\n';
           // update the neighboring voxel
@@ -503,9 +740,253 @@ void PropagationDistanceField::propagateNegative()
   }
 }
 
+void PropagationDistanceField::propagateParallel(std::vector<EigenSTL::vector_Vector3i>& bucket_queue, bool negative)
+{
+  int PropDistanceFieldVoxel::*distance_square =
+      negative ? &PropDistanceFieldVoxel::negative_distance_square_ : &PropDistanceFieldVoxel::distance_square_;
+  Eigen::Vector3i PropDistanceFieldVoxel::*closest_point =
+      negative ? &PropDistanceFieldVoxel::closest_negative_point_ : &PropDistanceFieldVoxel::closest_point_;
+  int PropDistanceFieldVoxel::*update_direction =
+      negative ? &PropDistanceFieldVoxel::negative_update_direction_ : &PropDistanceFieldVoxel::update_direction_;
+
+  // the workers are only started once a frontier is large enough to be worth it
+  std::unique_ptr<PropagationWorkers> workers;
+  std::vector<std::vector<PropagationUpdate>> updates;
+  std::vector<std::vector<std::vector<std::size_t>>> owned_updates;
+  const int num_x = getXNumCells();
+
+  for (unsigned int i = 0; i < bucket_queue.size(); ++i)
+  {
+    EigenSTL::vector_Vector3i& frontier = bucket_queue[i];
+    const std::vector<EigenSTL::vector_Vector3i>& neighborhood_set = neighborhoods_[i > 1 ? 1 : i];
+
+    // expands a single frontier voxel, calling update(location, diff, new_distance_sq, voxel) for each improvement
+    const auto expand = [&](const Eigen::Vector3i& loc, const auto& update) {
+      const PropDistanceFieldVoxel& voxel = getCell(loc.x(), loc.y(), loc.z());
+      if (voxel.*update_direction < 0 || voxel.*update_direction > 26)
+      {
+        RCLCPP_ERROR(getLogger(), "PROGRAMMING ERROR: Invalid update direction detected: %d", voxel.*update_direction);
+        return;
+      }
+      for (const Eigen::Vector3i& diff : neighborhood_set[voxel.*update_direction])
+      {
+        Eigen::Vector3i nloc(loc.x() + diff.x(), loc.y() + diff.y(), loc.z() + diff.z());
+        if (!isCellValid(nloc.x(), nloc.y(), nloc.z()))
+          continue;
+        int new_distance_sq = (voxel.*closest_point - nloc).squaredNorm();
+        if (new_distance_sq > max_distance_sq_)
+          continue;
+        update(nloc, diff, new_distance_sq, voxel);
+      }
+    };
+
+    const auto expand_serially = [&] {
+      // voxels queued at this same level are not expanded again, as in the serial propagation
+      const std::size_t count = frontier.size();
+      for (std::size_t j = 0; j < count; ++j)
+      {
+        const Eigen::Vector3i loc = frontier[j];
+        expand(loc, [&](const Eigen::Vector3i& nloc, const Eigen::Vector3i& diff, int new_distance_sq,
+                        const PropDistanceFieldVoxel& voxel) {
+          if (new_distance_sq < getCell(nloc.x(), nloc.y(), nloc.z()).*distance_square)
+          {
+            PropDistanceFieldVoxel& neighbor = voxel_grid_->getCell(nloc.x(), nloc.y(), nloc.z());
+            neighbor.*distance_square = new_distance_sq;
+            neighbor.*closest_point = voxel.*closest_point;
+            neighbor.*update_direction = getDirectionNumber(diff.x(), diff.y(), diff.z());
+            bucket_queue[new_distance_sq].push_back(nloc);
+          }
+        });
+      }
+    };
+
+    if (frontier.size() < MIN_PARALLEL_FRONTIER)
+    {
+      expand_serially();
+      frontier.clear();
+      continue;
+    }
+
+    if (!workers)
+    {
+      workers = std::make_unique<PropagationWorkers>(propagation_thread_count_);
+      updates.resize(workers->size());
+      owned_updates.assign(workers->size(), std::vector<std::vector<std::size_t>>(workers->size()));
+    }
+    const unsigned int thread_count = workers->size();
+
+    // compute phase: collect the candidate updates of each frontier chunk without writing to the grid
+    std::atomic<bool> modifies_frontier{ false };
+    workers->run([&](unsigned int thread) {
+      std::vector<PropagationUpdate>& thread_updates = updates[thread];
+      thread_updates.clear();
+      for (std::vector<std::size_t>& owned : owned_updates[thread])
+        owned.clear();
+      bool conflict = false;
+      const std::size_t begin = frontier.size() * thread / thread_count;
+      const std::size_t end = frontier.size() * (thread + 1) / thread_count;
+      for (std::size_t j = begin; j < end; ++j)
+      {
+        // voxels queued at the first level by a removal search are not obstacles, and may improve each other
+        const Eigen::Vector3i& loc = frontier[j];
+        if (i == 0 && getCell(loc.x(), loc.y(), loc.z()).*distance_square != 0)
+          conflict = true;
+        expand(loc, [&](const Eigen::Vector3i& nloc, const Eigen::Vector3i& diff, int new_distance_sq,
+                        const PropDistanceFieldVoxel& voxel) {
+          // only read here, so that no blocks are allocated concurrently for candidates that are never applied
+          const int current = getCell(nloc.x(), nloc.y(), nloc.z()).*distance_square;
+          if (new_distance_sq >= current)
+            return;
+          // voxels at or below this level may still be expanded here, so they must not change underneath it
+          if (current <= static_cast<int>(i))
+            conflict = true;
+          owned_updates[thread][static_cast<std::size_t>(nloc.x()) * thread_count / num_x].push_back(
+              thread_updates.size());
+          thread_updates.push_back({ nloc, voxel.*closest_point, new_distance_sq,
+                                     getDirectionNumber(diff.x(), diff.y(), diff.z()), false });
+        });
+      }
+      if (conflict)
+        modifies_frontier = true;
+    });
+
+    if (modifies_frontier)
+    {
+      expand_serially();
+      frontier.clear();
+      continue;
+    }
+
+    // apply phase: each thread owns a slab of x values and applies its updates in frontier order
+    workers->run([&](unsigned int thread) {
+      for (unsigned int source = 0; source < thread_count; ++source)
+      {
+        for (std::size_t index : owned_updates[source][thread])
+        {
+          PropagationUpdate& update = updates[source][index];
+          PropDistanceFieldVoxel& neighbor =
+              voxel_grid_->getCell(update.location.x(), update.location.y(), update.location.z());
+          if (update.distance_square < neighbor.*distance_square)
+          {
+            neighbor.*distance_square = update.distance_square;
+            neighbor.*closest_point = update.closest_point;
+            neighbor.*update_direction = update.update_direction;
+            update.applied = true;
+          }
+        }
+      }
+    });
+
+    for (const std::vector<PropagationUpdate>& thread_updates : updates)
+    {
+      for (const PropagationUpdate& update : thread_updates)
+      {
+        if (update.applied)
+          bucket_queue[update.distance_square].push_back(update.location);
+      }
+    }
+    frontier.clear();
+  }
+}
+
+void PropagationDistanceField::setPointsInField(const EigenSTL::vector_Vector3d& points)
+{
+  const int num_x = getXNumCells();
+  const int num_y = getYNumCells();
+  const int num_z = getZNumCells();
+  const std::size_t num_cells = static_cast<std::size_t>(num_x) * num_y * num_z;
+  const auto index = [num_y, num_z](int x, int y, int z) {
+    return (static_cast<std::size_t>(x) * num_y + y) * num_z + z;
+  };
+  const auto location = [num_y, num_z](int cell) {
+    return Eigen::Vector3i(cell / (num_y * num_z), (cell / num_z) % num_y, cell % num_z);
+  };
+
+  std::vector<bool> occupied(num_cells, false);
+  for (const Eigen::Vector3d& point : points)
+  {
+    Eigen::Vector3i voxel_loc;
+    if (worldToGrid(point.x(), point.y(), point.z(), voxel_loc.x(), voxel_loc.y(), voxel_loc.z()))
+      occupied[index(voxel_loc.x(), voxel_loc.y(), voxel_loc.z())] = true;
+  }
+
+  std::unique_ptr<PropagationWorkers> workers;
+  if (propagation_thread_count_ > 1)
+    workers = std::make_unique<PropagationWorkers>(propagation_thread_count_);
+
+  // positive distances are measured to the closest occupied cell, negative ones to the closest free cell
+  std::vector<int> distance(num_cells);
+  std::vector<int> source(num_cells);
+  const auto transform = [&](bool features_occupied) {
+    for (std::size_t i = 0; i < num_cells; ++i)
+    {
+      const bool feature = occupied[i] == features_occupied;
+      distance[i] = feature ? 0 : EDT_INFINITY;
+      source[i] = feature ? static_cast<int>(i) : -1;
+    }
+    transformGrid(num_x, num_y, num_z, distance, source, workers.get());
+  };
+
+  const Eigen::Vector3i uninitialized(PropDistanceFieldVoxel::UNINITIALIZED, PropDistanceFieldVoxel::UNINITIALIZED,
+                                      PropDistanceFieldVoxel::UNINITIALIZED);
+  const int initial_update_direction = getDirectionNumber(0, 0, 0);
+
+  // blocked storage only keeps the cells within range of an obstacle, the others are left at their reset value
+  const bool blocked = storage_ == BLOCKED_STORAGE;
+  if (blocked)
+    voxel_grid_->reset(PropDistanceFieldVoxel(max_distance_sq_, 0));
+
+  transform(true);
+  for (int x = 0; x < num_x; ++x)
+  {
+    for (int y = 0; y < num_y; ++y)
+    {
+      for (int z = 0; z < num_z; ++z)
+      {
+        const std::size_t i = index(x, y, z);
+        const bool in_range = distance[i] <= max_distance_sq_;
+        if (blocked && !in_range)
+          continue;
+        PropDistanceFieldVoxel& voxel = voxel_grid_->getCell(x, y, z);
+        voxel.distance_square_ = in_range ? distance[i] : max_distance_sq_;
+        voxel.closest_point_ = in_range ? location(source[i]) : uninitialized;
+        voxel.update_direction_ = initial_update_direction;
+        voxel.negative_distance_square_ = 0;
+        voxel.closest_negative_point_ = Eigen::Vector3i(x, y, z);
+        voxel.negative_update_direction_ = initial_update_direction;
+      }
+    }
+  }
+
+  if (!propagate_negative_)
+    return;
+
+  transform(false);
+  for (int x = 0; x < num_x; ++x)
+  {
+    for (int y = 0; y < num_y; ++y)
+    {
+      for (int z = 0; z < num_z; ++z)
+      {
+        const std::size_t i = index(x, y, z);
+        if (!occupied[i])
+          continue;
+        PropDistanceFieldVoxel& voxel = voxel_grid_->getCell(x, y, z);
+        const bool in_range = distance[i] <= max_distance_sq_;
+        voxel.negative_distance_square_ = in_range ? distance[i] : max_distance_sq_;
+        voxel.closest_negative_point_ = in_range ? location(source[i]) : uninitialized;
+      }
+    }
+  }
+}
+
 void PropagationDistanceField::reset()
 {
   voxel_grid_->reset(PropDistanceFieldVoxel(max_distance_sq_, 0));
+  // writing every cell would allocate all blocks, free cells without a closest negative point are treated as their
+  // own closest negative point instead
+  if (storage_ == BLOCKED_STORAGE)
+    return;
   for (int x = 0; x < getXNumCells(); ++x)
   {
     for (int y = 0; y < getYNumCells(); ++y)
@@ -598,7 +1079,16 @@ double PropagationDistanceField::getDistance(double x, double y, double z) const
 
 double PropagationDistanceField::getDistance(int x, int y, int z) const
 {
-  return getDistance(voxel_grid_->getCell(x, y, z));
+  return getDistance(getCell(x, y, z));
+}
+
+void PropagationDistanceField::getCornerDistances(int x, int y, int z, double distances[8]) const
+{
+  for (int i = 0; i < 8; ++i)
+  {
+    const PropDistanceFieldVoxel& cell = getCell(x + ((i >> 2) & 1), y + ((i >> 1) & 1), z + (i & 1));
+    distances[i] = sqrt_table_[cell.distance_square_] - sqrt_table_[cell.negative_distance_square_];
+  }
 }
 
 bool PropagationDistanceField::isCellValid(int x, int y, int z) const
@@ -758,4 +1248,132 @@ bool PropagationDistanceField::readFromStream(std::istream& is)
   addNewObstacleVoxels(obs_points);
   return true;
 }
+
+bool PropagationDistanceField::writeCellsToStream(std::ostream& os) const
+{
+  writeBinary(os, CELLS_MAGIC);
+  writeBinary(os, CELLS_VERSION);
+  writeBinary(os, static_cast<std::int32_t>(getXNumCells()));
+  writeBinary(os, static_cast<std::int32_t>(getYNumCells()));
+  writeBinary(os, static_cast<std::int32_t>(getZNumCells()));
+  writeBinary(os, static_cast<std::int32_t>(max_distance_sq_));
+  writeBinary(os, static_cast<std::int32_t>(propagate_negative_));
+  writeBinary(os, resolution_);
+  writeBinary(os, origin_x_);
+  writeBinary(os, origin_y_);
+  writeBinary(os, origin_z_);
+
+  // directions of cells that were never updated are not initialized, they are written as the initial direction
+  const int initial_update_direction = getDirectionNumber(0, 0, 0);
+  auto direction = [initial_update_direction](int update_direction) {
+    return update_direction >= 0 && update_direction < 27 ? update_direction : initial_update_direction;
+  };
+
+  std::vector<std::int32_t> row(static_cast<std::size_t>(getZNumCells()) * CELL_VALUES);
+  for (int x = 0; x < getXNumCells(); ++x)
+  {
+    for (int y = 0; y < getYNumCells(); ++y)
+    {
+      std::int32_t* values = row.data();
+      for (int z = 0; z < getZNumCells(); ++z, values += CELL_VALUES)
+      {
+        const PropDistanceFieldVoxel& cell = getCell(x, y, z);
+        values[0] = cell.distance_square_;
+        values[1] = cell.negative_distance_square_;
+        values[2] = cell.closest_point_.x();
+        values[3] = cell.closest_point_.y();
+        values[4] = cell.closest_point_.z();
+        values[5] = cell.closest_negative_point_.x();
+        values[6] = cell.closest_negative_point_.y();
+        values[7] = cell.closest_negative_point_.z();
+        values[8] = direction(cell.update_direction_);
+        values[9] = direction(cell.negative_update_direction_);
+      }
+      os.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(std::int32_t));
+    }
+  }
+  return os.good();
+}
+
+bool PropagationDistanceField::readCellsFromStream(std::istream& is)
+{
+  reset();
+
+  std::uint32_t magic, version;
+  std::int32_t num_x, num_y, num_z, max_distance_sq, propagate_negative;
+  double resolution, origin_x, origin_y, origin_z;
+  if (!readBinary(is, magic) || !readBinary(is, version) || !readBinary(is, num_x) || !readBinary(is, num_y) ||
+      !readBinary(is, num_z) || !readBinary(is, max_distance_sq) || !readBinary(is, propagate_negative) ||
+      !readBinary(is, resolution) || !readBinary(is, origin_x) || !readBinary(is, origin_y) ||
+      !readBinary(is, origin_z))
+  {
+    RCLCPP_ERROR(getLogger(), "Could not read distance field cell header");
+    return false;
+  }
+  if (magic != CELLS_MAGIC || version != CELLS_VERSION)
+  {
+    RCLCPP_ERROR(getLogger(), "Stream does not hold distance field cells in a known format");
+    return false;
+  }
+  if (num_x != getXNumCells() || num_y != getYNumCells() || num_z != getZNumCells() ||
+      max_distance_sq != max_distance_sq_ || (propagate_negative != 0) != propagate_negative_ ||
+      resolution != resolution_ || origin_x != origin_x_ || origin_y != origin_y_ || origin_z != origin_z_)
+  {
+    RCLCPP_ERROR(getLogger(), "Distance field cells were written by a field with different parameters");
+    return false;
+  }
+
+  auto valid_point = [this](const std::int32_t* point) {
+    return (point[0] == PropDistanceFieldVoxel::UNINITIALIZED && point[1] == PropDistanceFieldVoxel::UNINITIALIZED &&
+            point[2] == PropDistanceFieldVoxel::UNINITIALIZED) ||
+           isCellValid(point[0], point[1], point[2]);
+  };
+  auto valid_square = [this](std::int32_t distance_square) {
+    return distance_square >= 0 && distance_square <= max_distance_sq_;
+  };
+
+  std::vector<std::int32_t> row(static_cast<std::size_t>(getZNumCells()) * CELL_VALUES);
+  for (int x = 0; x < getXNumCells(); ++x)
+  {
+    for (int y = 0; y < getYNumCells(); ++y)
+    {
+      if (!is.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(std::int32_t)))
+      {
+        RCLCPP_ERROR(getLogger(), "Distance field cell data is truncated");
+        reset();
+        return false;
+      }
+
+      const std::int32_t* values = row.data();
+      for (int z = 0; z < getZNumCells(); ++z, values += CELL_VALUES)
+      {
+        if (!valid_square(values[0]) || !valid_square(values[1]) || !valid_point(values + 2) ||
+            !valid_point(values + 5) || values[8] < 0 || values[8] >= 27 || values[9] < 0 || values[9] >= 27)
+        {
+          RCLCPP_ERROR(getLogger(), "Distance field cell data is invalid");
+          reset();
+          return false;
+        }
+
+        // free cells far from obstacles are what reset already left, skipping them keeps blocked storage sparse
+        const bool own_negative_point = (values[5] == x && values[6] == y && values[7] == z) ||
+                                        values[5] == PropDistanceFieldVoxel::UNINITIALIZED;
+        if (values[0] == max_distance_sq_ && values[1] == 0 && values[2] == PropDistanceFieldVoxel::UNINITIALIZED &&
+            own_negative_point)
+        {
+          continue;
+        }
+
+        PropDistanceFieldVoxel& cell = voxel_grid_->getCell(x, y, z);
+        cell.distance_square_ = values[0];
+        cell.negative_distance_square_ = values[1];
+        cell.closest_point_ = Eigen::Vector3i(values[2], values[3], values[4]);
+        cell.closest_negative_point_ = Eigen::Vector3i(values[5], values[6], values[7]);
+        cell.update_direction_ = values[8];
+        cell.negative_update_direction_ = values[9];
+      }
+    }
+  }
+  return true;
+}
 }  // namespace distance_field
@@ -0,0 +1,228 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// Benchmarks for building, updating and querying propagation distance fields.
+// To run this benchmark, 'cd' to the build/moveit_core/distance_field directory and directly run the binary.
+
+#include <benchmark/benchmark.h>
+#include <geometric_shapes/mesh_operations.h>
+#include <geometric_shapes/shapes.h>
+#include <moveit/distance_field/find_internal_points.hpp>
+#include <moveit/distance_field/propagation_distance_field.hpp>
+#include <memory>
+#include <random>
+
+using namespace distance_field;
+
+namespace
+{
+// A 2m x 2m x 1m scene holding a table top, a wall and scattered points like a depth sensor cloud
+constexpr double SCENE_SIZE_X = 2.0;
+constexpr double SCENE_SIZE_Y = 2.0;
+constexpr double SCENE_SIZE_Z = 1.0;
+constexpr double MAX_DISTANCE = 0.25;
+constexpr int QUERY_COUNT = 10000;
+
+double getResolution(const benchmark::State& st)
+{
+  return st.range(0) * 1e-3;
+}
+
+VoxelStorage getStorage(const benchmark::State& st)
+{
+  return st.range(1) ? BLOCKED_STORAGE : DENSE_STORAGE;
+}
+
+// Resolutions of 4, 2 and 1 cm for dense and blocked storage
+void resolutionAndStorageArguments(benchmark::internal::Benchmark* b)
+{
+  for (int resolution_mm : { 40, 20, 10 })
+  {
+    for (int storage : { 0, 1 })
+      b->Args({ resolution_mm, storage });
+  }
+}
+
+EigenSTL::vector_Vector3d createPointCloud(double resolution)
+{
+  EigenSTL::vector_Vector3d points;
+  for (double x = 0.4; x <= 1.6; x += resolution)
+  {
+    for (double y = 0.2; y <= 1.8; y += resolution)
+      points.push_back(Eigen::Vector3d(x, y, 0.4));
+  }
+  for (double y = 0.0; y <= SCENE_SIZE_Y; y += resolution)
+  {
+    for (double z = 0.0; z <= SCENE_SIZE_Z; z += resolution)
+      points.push_back(Eigen::Vector3d(1.9, y, z));
+  }
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> x(0.0, SCENE_SIZE_X);
+  std::uniform_real_distribution<double> y(0.0, SCENE_SIZE_Y);
+  std::uniform_real_distribution<double> z(0.0, SCENE_SIZE_Z);
+  for (int i = 0; i < 20000; ++i)
+    points.push_back(Eigen::Vector3d(x(generator), y(generator), z(generator)));
+  return points;
+}
+
+EigenSTL::vector_Vector3d createQueryPoints()
+{
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> x(0.0, SCENE_SIZE_X);
+  std::uniform_real_distribution<double> y(0.0, SCENE_SIZE_Y);
+  std::uniform_real_distribution<double> z(0.0, SCENE_SIZE_Z);
+  EigenSTL::vector_Vector3d points(QUERY_COUNT);
+  for (Eigen::Vector3d& point : points)
+    point = Eigen::Vector3d(x(generator), y(generator), z(generator));
+  return points;
+}
+
+std::unique_ptr<PropagationDistanceField> createDistanceField(const benchmark::State& st)
+{
+  auto df = std::make_unique<PropagationDistanceField>(SCENE_SIZE_X, SCENE_SIZE_Y, SCENE_SIZE_Z, getResolution(st),
+                                                       0.0, 0.0, 0.0, MAX_DISTANCE, true, getStorage(st));
+  df->addPointsToField(createPointCloud(getResolution(st)));
+  return df;
+}
+}  // namespace
+
+// Builds a signed field from the point cloud by propagating from the obstacle cells.
+static void constructFromPointCloud(benchmark::State& st)
+{
+  const EigenSTL::vector_Vector3d points = createPointCloud(getResolution(st));
+  for (auto _ : st)
+  {
+    PropagationDistanceField df(SCENE_SIZE_X, SCENE_SIZE_Y, SCENE_SIZE_Z, getResolution(st), 0.0, 0.0, 0.0,
+                                MAX_DISTANCE, true, getStorage(st));
+    df.addPointsToField(points);
+    benchmark::DoNotOptimize(df.getDistance(1.0, 1.0, 0.5));
+  }
+}
+
+// Builds a signed field from the point cloud with the exact distance transform on four threads.
+static void constructFromPointCloudExact(benchmark::State& st)
+{
+  const EigenSTL::vector_Vector3d points = createPointCloud(getResolution(st));
+  for (auto _ : st)
+  {
+    PropagationDistanceField df(SCENE_SIZE_X, SCENE_SIZE_Y, SCENE_SIZE_Z, getResolution(st), 0.0, 0.0, 0.0,
+                                MAX_DISTANCE, true, getStorage(st));
+    df.setPropagationThreadCount(4);
+    df.setPointsInField(points);
+    benchmark::DoNotOptimize(df.getDistance(1.0, 1.0, 0.5));
+  }
+}
+
+// Voxelizes a sphere mesh and adds it to a signed field.
+static void constructFromMesh(benchmark::State& st)
+{
+  std::unique_ptr<shapes::Mesh> mesh(shapes::createMeshFromShape(shapes::Sphere(0.3)));
+  const Eigen::Isometry3d pose(Eigen::Translation3d(1.0, 1.0, 0.5));
+  for (auto _ : st)
+  {
+    PropagationDistanceField df(SCENE_SIZE_X, SCENE_SIZE_Y, SCENE_SIZE_Z, getResolution(st), 0.0, 0.0, 0.0,
+                                MAX_DISTANCE, true, getStorage(st));
+    EigenSTL::vector_Vector3d points;
+    findInternalPointsMesh(*mesh, pose, getResolution(st), points);
+    df.addPointsToField(points);
+    benchmark::DoNotOptimize(df.getDistance(1.0, 1.0, 0.5));
+  }
+}
+
+// Moves a box of obstacle points by one cell through the point cloud field.
+static void incrementalUpdate(benchmark::State& st)
+{
+  const std::unique_ptr<PropagationDistanceField> df = createDistanceField(st);
+  const double resolution = getResolution(st);
+  EigenSTL::vector_Vector3d box[2];
+  for (double x = 0.8; x <= 1.0; x += resolution)
+  {
+    for (double y = 0.8; y <= 1.0; y += resolution)
+    {
+      for (double z = 0.6; z <= 0.8; z += resolution)
+      {
+        box[0].push_back(Eigen::Vector3d(x, y, z));
+        box[1].push_back(Eigen::Vector3d(x + resolution, y, z));
+      }
+    }
+  }
+  df->addPointsToField(box[0]);
+
+  std::size_t iteration = 0;
+  for (auto _ : st)
+  {
+    df->updatePointsInField(box[iteration % 2], box[(iteration + 1) % 2]);
+    ++iteration;
+  }
+}
+
+// Looks up distances and gradients of the closest cells.
+static void distanceGradientQueries(benchmark::State& st)
+{
+  const std::unique_ptr<PropagationDistanceField> df = createDistanceField(st);
+  const EigenSTL::vector_Vector3d points = createQueryPoints();
+  for (auto _ : st)
+  {
+    for (const Eigen::Vector3d& point : points)
+    {
+      Eigen::Vector3d gradient;
+      bool in_bounds;
+      benchmark::DoNotOptimize(df->getDistanceGradient(point.x(), point.y(), point.z(), gradient.x(), gradient.y(),
+                                                       gradient.z(), in_bounds));
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * points.size());
+}
+
+// Interpolates distances and gradients for a batch of points.
+static void interpolatedGradientQueries(benchmark::State& st)
+{
+  const std::unique_ptr<PropagationDistanceField> df = createDistanceField(st);
+  const EigenSTL::vector_Vector3d points = createQueryPoints();
+  std::vector<double> distances;
+  EigenSTL::vector_Vector3d gradients;
+  for (auto _ : st)
+  {
+    benchmark::DoNotOptimize(df->getInterpolatedDistanceGradients(points, distances, gradients));
+  }
+  st.SetItemsProcessed(st.iterations() * points.size());
+}
+
+BENCHMARK(constructFromPointCloud)->Apply(resolutionAndStorageArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(constructFromPointCloudExact)->Apply(resolutionAndStorageArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(constructFromMesh)->Apply(resolutionAndStorageArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(incrementalUpdate)->Apply(resolutionAndStorageArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(distanceGradientQueries)->Apply(resolutionAndStorageArguments)->Unit(benchmark::kMicrosecond);
+BENCHMARK(interpolatedGradientQueries)->Apply(resolutionAndStorageArguments)->Unit(benchmark::kMicrosecond);
@@ -43,6 +43,8 @@
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <octomap/octomap.h>
 #include <memory>
+#include <random>
+#include <sstream>
 
 using namespace distance_field;
 
@@ -657,6 +659,295 @@ TEST(TestSignedPropagationDistanceField, TestShape)
   ASSERT_TRUE(areDistanceFieldsDistancesEqual(df, test_df));
 }
 
+// Appends an axis aligned box with outward facing triangles to the vertices and triangles of a mesh
+void addBoxToMesh(const Eigen::Vector3d& min, const Eigen::Vector3d& max, std::vector<double>& vertices,
+                  std::vector<unsigned int>& triangles)
+{
+  const unsigned int first = vertices.size() / 3;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    vertices.push_back((i & 1) ? max.x() : min.x());
+    vertices.push_back((i & 2) ? max.y() : min.y());
+    vertices.push_back((i & 4) ? max.z() : min.z());
+  }
+  const unsigned int faces[12][3] = { { 0, 2, 1 }, { 1, 2, 3 }, { 4, 5, 6 }, { 5, 7, 6 }, { 0, 1, 4 }, { 1, 5, 4 },
+                                      { 2, 6, 3 }, { 3, 6, 7 }, { 0, 4, 2 }, { 2, 4, 6 }, { 1, 3, 5 }, { 3, 7, 5 } };
+  for (const auto& face : faces)
+  {
+    for (unsigned int vertex : face)
+      triangles.push_back(first + vertex);
+  }
+}
+
+TEST(TestSignedPropagationDistanceField, TestNonConvexMesh)
+{
+  // two separate boxes in one mesh, whose convex hull would also cover the gap between them
+  std::vector<double> vertices;
+  std::vector<unsigned int> triangles;
+  addBoxToMesh(Eigen::Vector3d(0.125, 0.125, 0.125), Eigen::Vector3d(0.375, 0.875, 0.875), vertices, triangles);
+  addBoxToMesh(Eigen::Vector3d(0.625, 0.125, 0.125), Eigen::Vector3d(0.875, 0.875, 0.875), vertices, triangles);
+  shapes::Mesh mesh(vertices.size() / 3, triangles.size() / 3);
+  std::copy(vertices.begin(), vertices.end(), mesh.vertices);
+  std::copy(triangles.begin(), triangles.end(), mesh.triangles);
+
+  const double resolution = 0.05;
+  EigenSTL::vector_Vector3d points;
+  findInternalPointsMesh(mesh, Eigen::Isometry3d::Identity(), resolution, points);
+  EXPECT_EQ(points.size(), 2u * 5u * 15u * 15u);
+  for (const Eigen::Vector3d& point : points)
+  {
+    EXPECT_TRUE(point.x() < 0.375 || point.x() > 0.625) << point.transpose();
+  }
+
+  // slabs voxelized in parallel give the same points in the same order
+  EigenSTL::vector_Vector3d parallel_points;
+  findInternalPointsMesh(mesh, Eigen::Isometry3d::Identity(), resolution, parallel_points, 0.0, 3);
+  ASSERT_EQ(parallel_points.size(), points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    EXPECT_EQ(parallel_points[i], points[i]);
+  }
+
+  // the signed field is negative inside the boxes and positive in the gap
+  PropagationDistanceField df(WIDTH, HEIGHT, DEPTH, resolution, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true);
+  df.addShapeToField(&mesh, Eigen::Isometry3d::Identity());
+  EXPECT_LT(df.getDistance(0.25, 0.5, 0.5), 0.0);
+  EXPECT_LT(df.getDistance(0.75, 0.5, 0.5), 0.0);
+  EXPECT_GT(df.getDistance(0.5, 0.5, 0.5), 0.0);
+
+  df.removeShapeFromField(&mesh, Eigen::Isometry3d::Identity());
+  EXPECT_GT(df.getDistance(0.25, 0.5, 0.5), 0.0);
+}
+
+TEST(TestSignedPropagationDistanceField, TestParallelPropagation)
+{
+  PropagationDistanceField serial_df(2.0, 2.0, 2.0, 0.02, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true);
+  PropagationDistanceField parallel_df(2.0, 2.0, 2.0, 0.02, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true);
+  parallel_df.setPropagationThreadCount(4);
+  EXPECT_EQ(parallel_df.getPropagationThreadCount(), 4u);
+
+  // scattered points and a dense slab, so that frontiers are large enough to be expanded in parallel
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> coordinate(0.0, 2.0);
+  EigenSTL::vector_Vector3d points;
+  for (unsigned int i = 0; i < 3000; ++i)
+    points.push_back(Eigen::Vector3d(coordinate(generator), coordinate(generator), coordinate(generator)));
+  for (unsigned int i = 0; i < 20000; ++i)
+    points.push_back(Eigen::Vector3d(0.8 + 0.1 * coordinate(generator), 1.0, 0.25 * coordinate(generator)));
+
+  serial_df.addPointsToField(points);
+  parallel_df.addPointsToField(points);
+  ASSERT_TRUE(areDistanceFieldsDistancesEqual(serial_df, parallel_df));
+
+  EigenSTL::vector_Vector3d removed(points.begin(), points.begin() + 1500);
+  removed.insert(removed.end(), points.begin() + 5000, points.begin() + 15000);
+  serial_df.removePointsFromField(removed);
+  parallel_df.removePointsFromField(removed);
+  ASSERT_TRUE(areDistanceFieldsDistancesEqual(serial_df, parallel_df));
+
+  for (int x = 0; x < serial_df.getXNumCells(); ++x)
+  {
+    for (int y = 0; y < serial_df.getYNumCells(); ++y)
+    {
+      for (int z = 0; z < serial_df.getZNumCells(); ++z)
+      {
+        ASSERT_EQ(serial_df.getCell(x, y, z).closest_point_, parallel_df.getCell(x, y, z).closest_point_);
+        ASSERT_EQ(serial_df.getCell(x, y, z).closest_negative_point_,
+                  parallel_df.getCell(x, y, z).closest_negative_point_);
+      }
+    }
+  }
+}
+
+TEST(TestSignedPropagationDistanceField, TestExactDistanceTransform)
+{
+  PropagationDistanceField df(0.6, 0.5, 0.7, 0.02, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, 0.2, true);
+  df.setPropagationThreadCount(3);
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> coordinate(0.0, 0.5);
+  EigenSTL::vector_Vector3d points;
+  for (unsigned int i = 0; i < 400; ++i)
+    points.push_back(Eigen::Vector3d(coordinate(generator), coordinate(generator), coordinate(generator)));
+  for (unsigned int i = 0; i < 4000; ++i)
+  {
+    points.push_back(Eigen::Vector3d(0.2 + 0.6 * coordinate(generator), 0.1 + 0.6 * coordinate(generator),
+                                     0.3 + 0.4 * coordinate(generator)));
+  }
+  df.setPointsInField(points);
+
+  EigenSTL::vector_Vector3i occupied, free;
+  for (int x = 0; x < df.getXNumCells(); ++x)
+  {
+    for (int y = 0; y < df.getYNumCells(); ++y)
+    {
+      for (int z = 0; z < df.getZNumCells(); ++z)
+        (df.getCell(x, y, z).distance_square_ == 0 ? occupied : free).push_back(Eigen::Vector3i(x, y, z));
+    }
+  }
+
+  // compare against the brute force squared distances, clamped to the maximum distance
+  const int max_distance_sq = df.getMaximumDistanceSquared();
+  const auto closest = [max_distance_sq](const Eigen::Vector3i& cell, const EigenSTL::vector_Vector3i& set) {
+    int best = max_distance_sq;
+    for (const Eigen::Vector3i& other : set)
+      best = std::min(best, (other - cell).squaredNorm());
+    return best;
+  };
+  for (const Eigen::Vector3i& cell : free)
+  {
+    const PropDistanceFieldVoxel& voxel = df.getCell(cell.x(), cell.y(), cell.z());
+    const int expected = closest(cell, occupied);
+    ASSERT_EQ(voxel.distance_square_, expected);
+    if (expected < max_distance_sq)
+    {
+      ASSERT_EQ((voxel.closest_point_ - cell).squaredNorm(), expected);
+    }
+    ASSERT_EQ(voxel.negative_distance_square_, 0);
+  }
+  for (const Eigen::Vector3i& cell : occupied)
+  {
+    const PropDistanceFieldVoxel& voxel = df.getCell(cell.x(), cell.y(), cell.z());
+    ASSERT_EQ(voxel.negative_distance_square_, closest(cell, free));
+  }
+
+  // the rebuilt field can still be updated incrementally, propagated distances are never below the exact ones
+  PropagationDistanceField test_df(0.6, 0.5, 0.7, 0.02, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, 0.2, true);
+  test_df.setPointsInField(EigenSTL::vector_Vector3d(points.begin() + 200, points.end()));
+  df.removePointsFromField(EigenSTL::vector_Vector3d(points.begin(), points.begin() + 200));
+  df.addPointsToField(EigenSTL::vector_Vector3d(points.begin() + 200, points.end()));
+  for (int x = 0; x < df.getXNumCells(); ++x)
+  {
+    for (int y = 0; y < df.getYNumCells(); ++y)
+    {
+      for (int z = 0; z < df.getZNumCells(); ++z)
+      {
+        const PropDistanceFieldVoxel& voxel = df.getCell(x, y, z);
+        const PropDistanceFieldVoxel& exact_voxel = test_df.getCell(x, y, z);
+        ASSERT_EQ(voxel.distance_square_ == 0, exact_voxel.distance_square_ == 0);
+        ASSERT_GE(voxel.distance_square_, exact_voxel.distance_square_);
+        ASSERT_GE(voxel.negative_distance_square_, exact_voxel.negative_distance_square_);
+      }
+    }
+  }
+}
+
+TEST(TestSignedPropagationDistanceField, TestBlockedStorage)
+{
+  PropagationDistanceField dense_df(2.0, 2.0, 2.0, 0.02, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true);
+  PropagationDistanceField blocked_df(2.0, 2.0, 2.0, 0.02, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true,
+                                      BLOCKED_STORAGE);
+  EXPECT_EQ(blocked_df.getVoxelGrid().getStorage(), BLOCKED_STORAGE);
+  EXPECT_EQ(blocked_df.getVoxelGrid().getNumAllocatedCells(), 0u);
+
+  // a small box in one corner of a mostly empty volume
+  EigenSTL::vector_Vector3d points;
+  for (double x = 0.2; x < 0.4; x += 0.02)
+  {
+    for (double y = 0.2; y < 0.4; y += 0.02)
+    {
+      for (double z = 0.2; z < 0.4; z += 0.02)
+        points.push_back(Eigen::Vector3d(x, y, z));
+    }
+  }
+  dense_df.addPointsToField(points);
+  blocked_df.addPointsToField(points);
+  ASSERT_TRUE(areDistanceFieldsDistancesEqual(dense_df, blocked_df));
+  const std::size_t num_cells = static_cast<std::size_t>(dense_df.getXNumCells()) * dense_df.getYNumCells() *
+                                static_cast<std::size_t>(dense_df.getZNumCells());
+  EXPECT_EQ(dense_df.getVoxelGrid().getNumAllocatedCells(), num_cells);
+  EXPECT_LT(blocked_df.getVoxelGrid().getNumAllocatedCells(), num_cells / 10);
+
+  EigenSTL::vector_Vector3d removed(points.begin(), points.begin() + points.size() / 2);
+  dense_df.removePointsFromField(removed);
+  blocked_df.removePointsFromField(removed);
+  ASSERT_TRUE(areDistanceFieldsDistancesEqual(dense_df, blocked_df));
+
+  blocked_df.setPropagationThreadCount(4);
+  dense_df.addPointsToField(removed);
+  blocked_df.addPointsToField(removed);
+  ASSERT_TRUE(areDistanceFieldsDistancesEqual(dense_df, blocked_df));
+
+  dense_df.setPointsInField(points);
+  blocked_df.setPointsInField(points);
+  ASSERT_TRUE(areDistanceFieldsDistancesEqual(dense_df, blocked_df));
+  EXPECT_LT(blocked_df.getVoxelGrid().getNumAllocatedCells(), num_cells / 10);
+
+  blocked_df.reset();
+  EXPECT_EQ(blocked_df.getVoxelGrid().getNumAllocatedCells(), 0u);
+  EXPECT_NEAR(blocked_df.getDistance(0.3, 0.3, 0.3), MAX_DIST, .0001);
+}
+
+TEST(TestSignedPropagationDistanceField, TestInterpolatedDistanceGradient)
+{
+  PropagationDistanceField df(1.0, 1.0, 1.0, 0.05, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, 0.4, true);
+  EigenSTL::vector_Vector3d obstacle;
+  for (double z = 0.0; z < 1.0; z += 0.05)
+    obstacle.push_back(Eigen::Vector3d(0.5, 0.5, z));
+  df.addPointsToField(obstacle);
+
+  // at cell centers the interpolated distance is the cell distance
+  for (int x = 0; x < df.getXNumCells(); x += 3)
+  {
+    for (int y = 0; y < df.getYNumCells(); y += 3)
+    {
+      double wx, wy, wz;
+      df.gridToWorld(x, y, 5, wx, wy, wz);
+      double gx, gy, gz;
+      bool in_bounds;
+      double dist = df.getInterpolatedDistanceGradient(wx, wy, wz, gx, gy, gz, in_bounds);
+      EXPECT_TRUE(in_bounds);
+      EXPECT_NEAR(dist, df.getDistance(x, y, 5), 1e-9);
+    }
+  }
+
+  // the gradient matches a finite difference of the interpolated distance and points away from the obstacle
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> location(0.1, 0.9);
+  EigenSTL::vector_Vector3d points;
+  for (int i = 0; i < 200; ++i)
+    points.push_back(Eigen::Vector3d(location(rng), location(rng), location(rng)));
+  const double step = 1e-6;
+  for (const Eigen::Vector3d& p : points)
+  {
+    double gx, gy, gz, ignore;
+    bool in_bounds;
+    df.getInterpolatedDistanceGradient(p.x(), p.y(), p.z(), gx, gy, gz, in_bounds);
+    ASSERT_TRUE(in_bounds);
+    double plus = df.getInterpolatedDistanceGradient(p.x() + step, p.y(), p.z(), ignore, ignore, ignore, in_bounds);
+    double minus = df.getInterpolatedDistanceGradient(p.x() - step, p.y(), p.z(), ignore, ignore, ignore, in_bounds);
+    EXPECT_NEAR(gx, (plus - minus) / (2 * step), 1e-4);
+    plus = df.getInterpolatedDistanceGradient(p.x(), p.y(), p.z() + step, ignore, ignore, ignore, in_bounds);
+    minus = df.getInterpolatedDistanceGradient(p.x(), p.y(), p.z() - step, ignore, ignore, ignore, in_bounds);
+    EXPECT_NEAR(gz, (plus - minus) / (2 * step), 1e-4);
+    if (std::abs(p.x() - 0.5) > 0.15 && std::abs(p.x() - 0.5) < 0.25 && std::abs(p.y() - 0.5) < 0.15)
+    {
+      EXPECT_GT(gx * (p.x() - 0.5), 0.0);
+    }
+  }
+
+  // the batched query gives the same results, out of bounds points get no gradient
+  points.push_back(Eigen::Vector3d(-0.5, 0.5, 0.5));
+  points.push_back(Eigen::Vector3d(0.5, 0.5, 1.5));
+  std::vector<double> distances;
+  EigenSTL::vector_Vector3d gradients;
+  EXPECT_FALSE(df.getInterpolatedDistanceGradients(points, distances, gradients));
+  ASSERT_EQ(distances.size(), points.size());
+  ASSERT_EQ(gradients.size(), points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    Eigen::Vector3d grad;
+    bool in_bounds;
+    double dist = df.getInterpolatedDistanceGradient(points[i].x(), points[i].y(), points[i].z(), grad.x(), grad.y(),
+                                                     grad.z(), in_bounds);
+    EXPECT_EQ(in_bounds, i + 2 < points.size());
+    EXPECT_DOUBLE_EQ(distances[i], dist);
+    EXPECT_TRUE(gradients[i].isApprox(grad) || (gradients[i].isZero() && grad.isZero()));
+  }
+  points.resize(points.size() - 2);
+  EXPECT_TRUE(df.getInterpolatedDistanceGradients(points, distances, gradients));
+}
+
 static const double PERF_WIDTH = 3.0;
 static const double PERF_HEIGHT = 3.0;
 static const double PERF_DEPTH = 4.0;
@@ -982,6 +1273,63 @@ TEST(TestSignedPropagationDistanceField, TestReadWrite)
   EXPECT_FALSE(areDistanceFieldsDistancesEqual(df, df3));
 }
 
+TEST(TestSignedPropagationDistanceField, TestReadWriteCells)
+{
+  PropagationDistanceField df(1.0, 1.0, 1.0, 0.05, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true);
+  EigenSTL::vector_Vector3d points;
+  for (double x = 0.3; x < 0.6; x += 0.05)
+  {
+    for (double y = 0.3; y < 0.6; y += 0.05)
+    {
+      for (double z = 0.3; z < 0.6; z += 0.05)
+        points.push_back(Eigen::Vector3d(x, y, z));
+    }
+  }
+  df.addPointsToField(points);
+
+  std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(df.writeCellsToStream(stream));
+  const std::string data = stream.str();
+
+  // the cells come back exactly, in either storage mode
+  for (VoxelStorage storage : { DENSE_STORAGE, BLOCKED_STORAGE })
+  {
+    PropagationDistanceField df2(1.0, 1.0, 1.0, 0.05, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true, storage);
+    std::istringstream in(data, std::ios::binary);
+    ASSERT_TRUE(df2.readCellsFromStream(in));
+    ASSERT_TRUE(areDistanceFieldsDistancesEqual(df, df2));
+    for (int x = 0; x < df.getXNumCells(); ++x)
+    {
+      for (int y = 0; y < df.getYNumCells(); ++y)
+      {
+        for (int z = 0; z < df.getZNumCells(); ++z)
+        {
+          ASSERT_EQ(df.getCell(x, y, z).closest_point_, df2.getCell(x, y, z).closest_point_);
+        }
+      }
+    }
+
+    // and the restored field can be updated incrementally like the original
+    EigenSTL::vector_Vector3d removed(points.begin(), points.begin() + points.size() / 3);
+    PropagationDistanceField updated(1.0, 1.0, 1.0, 0.05, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true);
+    updated.addPointsToField(points);
+    updated.removePointsFromField(removed);
+    df2.removePointsFromField(removed);
+    EXPECT_TRUE(areDistanceFieldsDistancesEqual(updated, df2));
+  }
+
+  // a field with different parameters rejects the data and stays empty
+  PropagationDistanceField other(1.0, 1.0, 1.0, 0.05, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST + 0.1, true);
+  std::istringstream in(data, std::ios::binary);
+  EXPECT_FALSE(other.readCellsFromStream(in));
+
+  // as does truncated data
+  PropagationDistanceField truncated(1.0, 1.0, 1.0, 0.05, ORIGIN_X, ORIGIN_Y, ORIGIN_Z, MAX_DIST, true);
+  std::istringstream half(data.substr(0, data.size() / 2), std::ios::binary);
+  EXPECT_FALSE(truncated.readCellsFromStream(half));
+  EXPECT_NEAR(truncated.getDistance(0.45, 0.45, 0.45), MAX_DIST, .0001);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -107,6 +107,55 @@ TEST(TestVoxelGrid, TestReadWrite)
   }
 }
 
+TEST(TestVoxelGrid, TestBlockedStorage)
+{
+  VoxelGrid<int> vg(0.2, 0.1, 0.3, 0.01, 0, 0, 0, -100, BLOCKED_STORAGE);
+  EXPECT_EQ(vg.getStorage(), BLOCKED_STORAGE);
+
+  int num_x = vg.getNumCells(DIM_X);
+  int num_y = vg.getNumCells(DIM_Y);
+  int num_z = vg.getNumCells(DIM_Z);
+  EXPECT_EQ(num_x, 20);
+  EXPECT_EQ(num_y, 10);
+  EXPECT_EQ(num_z, 30);
+
+  // nothing is allocated until a cell is written
+  vg.reset(7);
+  EXPECT_EQ(vg.getNumAllocatedCells(), 0u);
+  const VoxelGrid<int>& const_vg = vg;
+  EXPECT_EQ(const_vg.getCell(19, 9, 29), 7);
+  EXPECT_EQ(vg.getNumAllocatedCells(), 0u);
+
+  vg.setCell(1, 2, 3, 1);
+  EXPECT_EQ(vg.getNumAllocatedCells(), static_cast<std::size_t>(VoxelGrid<int>::BLOCK_CELLS));
+  EXPECT_EQ(const_vg.getCell(1, 2, 3), 1);
+  EXPECT_EQ(const_vg.getCell(3, 2, 1), 7);
+
+  // every cell keeps its own value, including the partial blocks at the end of each axis
+  for (int x = 0; x < num_x; ++x)
+  {
+    for (int y = 0; y < num_y; ++y)
+    {
+      for (int z = 0; z < num_z; ++z)
+        vg.getCell(x, y, z) = (x * num_y + y) * num_z + z;
+    }
+  }
+  for (int x = 0; x < num_x; ++x)
+  {
+    for (int y = 0; y < num_y; ++y)
+    {
+      for (int z = 0; z < num_z; ++z)
+        EXPECT_EQ(const_vg.getCell(x, y, z), (x * num_y + y) * num_z + z);
+    }
+  }
+  EXPECT_EQ(vg.getNumAllocatedCells(), static_cast<std::size_t>(3 * 2 * 4 * VoxelGrid<int>::BLOCK_CELLS));
+
+  vg.reset(0);
+  EXPECT_EQ(vg.getNumAllocatedCells(), 0u);
+  EXPECT_EQ(const_vg.getCell(1, 2, 3), 0);
+  EXPECT_EQ(vg(1000.0, 1000.0, 1000.0), -100);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
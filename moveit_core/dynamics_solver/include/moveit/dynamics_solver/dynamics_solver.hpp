@@ -41,9 +41,11 @@
 #include <kdl/chainidsolver_recursive_newton_euler.hpp>
 
 #include <moveit/robot_state/robot_state.hpp>
+#include <moveit/robot_trajectory/robot_trajectory.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
 #include <geometry_msgs/msg/wrench.hpp>
 #include <memory>
+#include <mutex>
 
 /** \brief This namespace includes the dynamics_solver library */
 namespace dynamics_solver
@@ -58,6 +60,14 @@ MOVEIT_CLASS_FORWARD(DynamicsSolver);  // Defines DynamicsSolverPtr, ConstPtr, W
 class DynamicsSolver
 {
 public:
+  /**
+   * @brief Preallocated solver state and buffers for the batch functions. Calls using different workspaces can run
+   * concurrently, while the functions without a workspace argument share one and are serialized.
+   * A workspace must not outlive the DynamicsSolver that created it.
+   */
+  struct Workspace;
+  using WorkspacePtr = std::shared_ptr<Workspace>;
+
   /**
    * @brief Initialize the dynamics solver
    * @param urdf_model The urdf model for the robot
@@ -87,6 +97,39 @@ public:
                   const std::vector<double>& joint_accelerations,
                   const std::vector<geometry_msgs::msg::Wrench>& wrenches, std::vector<double>& torques) const;
 
+  /**
+   * @brief Get the torques for a batch of joint states without external wrenches. Every column is one state, the rows
+   * have the order of joints for this group in the RobotModel. This avoids converting the inputs for each state
+   * separately when evaluating the inverse dynamics along a path.
+   * @param joint_angles The joint angles, this must have rows = number of joints in the group
+   * @param joint_velocities The joint velocities, same size as joint_angles
+   * @param joint_accelerations The joint accelerations, same size as joint_angles
+   * @param torques Computed set of torques are filled in here, resized to the size of joint_angles
+   * @return False if any of the input matrices are of the wrong size
+   */
+  bool getTorques(const Eigen::MatrixXd& joint_angles, const Eigen::MatrixXd& joint_velocities,
+                  const Eigen::MatrixXd& joint_accelerations, Eigen::MatrixXd& torques) const;
+
+  /**
+   * @brief Get the torques for a batch of joint states without external wrenches, like the function above, but using
+   * the buffers of \e workspace so that the computation does not allocate memory
+   * (except for resizing \e torques) and can run concurrently with other calls.
+   */
+  bool getTorques(const Eigen::MatrixXd& joint_angles, const Eigen::MatrixXd& joint_velocities,
+                  const Eigen::MatrixXd& joint_accelerations, Eigen::MatrixXd& torques, Workspace& workspace) const;
+
+  /**
+   * @brief Get the torques at every waypoint of a trajectory without external wrenches. Waypoints without
+   * velocities or accelerations are treated as if these were zero.
+   * @param trajectory The trajectory, its waypoints must be states of the robot model of this solver
+   * @param torques Computed set of torques are filled in here, one column per waypoint, the rows
+   * have the order of joints for this group in the RobotModel
+   * @param workspace The buffers to use, see createWorkspace()
+   * @return False if the inverse dynamics could not be computed
+   */
+  bool getTrajectoryTorques(const robot_trajectory::RobotTrajectory& trajectory, Eigen::MatrixXd& torques,
+                            Workspace& workspace) const;
+
   /**
    * @brief Get the maximum payload for this group (in kg). Payload is
    * the weight that this group can hold when the weight is attached to the origin
@@ -113,6 +156,25 @@ public:
   bool getPayloadTorques(const std::vector<double>& joint_angles, double payload,
                          std::vector<double>& joint_torques) const;
 
+  /**
+   * @brief Get the torques holding a payload at rest for a batch of joint configurations. With a payload of 0 these
+   * are the gravity compensation torques.
+   * @param joint_angles The joint angles, one column per configuration, this must have rows = number of joints in
+   * the group
+   * @param payload The payload for which to compute torques (in kg)
+   * @param joint_torques The resulting joint torques are filled in here, resized to the size of joint_angles
+   * @param workspace The buffers to use, see createWorkspace()
+   * @return False if the input matrix is of the wrong size
+   */
+  bool getPayloadTorques(const Eigen::MatrixXd& joint_angles, double payload, Eigen::MatrixXd& joint_torques,
+                         Workspace& workspace) const;
+
+  /**
+   * @brief Allocate the buffers for the batch functions. Create one workspace per thread and reuse it across calls.
+   * @return The workspace, or nullptr if the solver was not constructed properly
+   */
+  WorkspacePtr createWorkspace() const;
+
   /**
    * @brief Get maximum torques for this group
    * @return Vector of max torques
@@ -134,13 +196,21 @@ public:
   }
 
 private:
-  std::shared_ptr<KDL::ChainIdSolver_RNE> chain_id_solver_;  // KDL chain inverse dynamics
-  KDL::Chain kdl_chain_;                                     // KDL chain
+  // Run the inverse dynamics for the joint states and wrenches in workspace, the result is put in its torques
+  bool computeTorques(Workspace& workspace) const;
+
+  // Run the inverse dynamics for the joint angles in workspace at rest, with force (in N) acting against gravity
+  // at the origin of the tip link
+  bool computePayloadTorques(Workspace& workspace, double force) const;
+
+  KDL::Chain kdl_chain_;  // KDL chain
+  KDL::Vector gravity_vector_;
 
   moveit::core::RobotModelConstPtr robot_model_;
   const moveit::core::JointModelGroup* joint_model_group_;
 
-  moveit::core::RobotStatePtr state_;  // robot state
+  WorkspacePtr workspace_;             // used by the functions without a workspace argument
+  mutable std::mutex workspace_lock_;  // protects workspace_
 
   std::string base_name_, tip_name_;        // base name, tip name
   unsigned int num_joints_, num_segments_;  // number of joints in group, number of segments in group
@@ -39,6 +39,7 @@
 #include <kdl/jntarray.hpp>
 #include <kdl_parser/kdl_parser.hpp>
 #include <kdl/tree.hpp>
+#include <algorithm>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <moveit/utils/logger.hpp>
@@ -53,25 +54,6 @@ rclcpp::Logger getLogger()
 }
 }  // namespace
 
-namespace
-{
-inline geometry_msgs::msg::Vector3 transformVector(const Eigen::Isometry3d& transform,
-                                                   const geometry_msgs::msg::Vector3& vector)
-{
-  Eigen::Vector3d p;
-  p = Eigen::Vector3d(vector.x, vector.y, vector.z);
-  // transform has to be a valid isometry; the caller is responsible for the check
-  p = transform.linear() * p;
-
-  geometry_msgs::msg::Vector3 result;
-  result.x = p.x();
-  result.y = p.y();
-  result.z = p.z();
-
-  return result;
-}
-}  // namespace
-
 DynamicsSolver::DynamicsSolver(const moveit::core::RobotModelConstPtr& robot_model, const std::string& group_name,
                                const geometry_msgs::msg::Vector3& gravity_vector)
 {
@@ -126,9 +108,6 @@ DynamicsSolver::DynamicsSolver(const moveit::core::RobotModelConstPtr& robot_mod
   num_joints_ = kdl_chain_.getNrOfJoints();
   num_segments_ = kdl_chain_.getNrOfSegments();
 
-  state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
-  state_->setToDefaultValues();
-
   const std::vector<std::string>& joint_model_names = joint_model_group_->getJointModelNames();
   for (const std::string& joint_model_name : joint_model_names)
   {
@@ -148,7 +127,67 @@ DynamicsSolver::DynamicsSolver(const moveit::core::RobotModelConstPtr& robot_mod
   gravity_ = gravity.Norm();
   RCLCPP_DEBUG(getLogger(), "Gravity norm set to %f", gravity_);
 
-  chain_id_solver_ = std::make_shared<KDL::ChainIdSolver_RNE>(kdl_chain_, gravity);
+  gravity_vector_ = gravity;
+  workspace_ = createWorkspace();
+}
+
+struct DynamicsSolver::Workspace
+{
+  Workspace(const KDL::Chain& chain, const KDL::Vector& gravity, const moveit::core::RobotModelConstPtr& robot_model)
+    : chain_id_solver(chain, gravity)
+    , angles(chain.getNrOfJoints())
+    , velocities(chain.getNrOfJoints())
+    , accelerations(chain.getNrOfJoints())
+    , torques(chain.getNrOfJoints())
+    , gravity_torques(chain.getNrOfJoints())
+    , wrenches(chain.getNrOfSegments(), KDL::Wrench::Zero())
+    , state(robot_model)
+  {
+    state.setToDefaultValues();
+  }
+
+  KDL::ChainIdSolver_RNE chain_id_solver;  // keeps a reference to the chain of the DynamicsSolver
+  KDL::JntArray angles, velocities, accelerations, torques;
+  KDL::JntArray gravity_torques;  // torques without payload, used by getMaxPayload()
+  KDL::Wrenches wrenches;
+  moveit::core::RobotState state;  // for the transform of the tip link
+};
+
+DynamicsSolver::WorkspacePtr DynamicsSolver::createWorkspace() const
+{
+  if (!joint_model_group_)
+    return nullptr;
+  return std::make_shared<Workspace>(kdl_chain_, gravity_vector_, robot_model_);
+}
+
+bool DynamicsSolver::computeTorques(Workspace& workspace) const
+{
+  if (workspace.chain_id_solver.CartToJnt(workspace.angles, workspace.velocities, workspace.accelerations,
+                                          workspace.wrenches, workspace.torques) < 0)
+  {
+    RCLCPP_ERROR(getLogger(), "Something went wrong computing torques");
+    return false;
+  }
+  return true;
+}
+
+bool DynamicsSolver::computePayloadTorques(Workspace& workspace, double force) const
+{
+  SetToZero(workspace.velocities);
+  SetToZero(workspace.accelerations);
+  std::fill(workspace.wrenches.begin(), workspace.wrenches.end(), KDL::Wrench::Zero());
+  if (force != 0.0)
+  {
+    workspace.state.setJointGroupPositions(joint_model_group_, workspace.angles.data);
+    const Eigen::Isometry3d& base_frame = workspace.state.getFrameTransform(base_name_);  // valid isometry by contract
+    const Eigen::Isometry3d& tip_frame = workspace.state.getFrameTransform(tip_name_);    // valid isometry by contract
+    // transform has to be a valid isometry, here it is by construction
+    const Eigen::Vector3d local_force = (tip_frame.inverse() * base_frame).linear() * Eigen::Vector3d(0.0, 0.0, force);
+    workspace.wrenches.back().force = KDL::Vector(local_force.x(), local_force.y(), local_force.z());
+
+    RCLCPP_DEBUG(getLogger(), "New wrench (local frame): %f %f %f", local_force.x(), local_force.y(), local_force.z());
+  }
+  return computeTorques(workspace);
 }
 
 bool DynamicsSolver::getTorques(const std::vector<double>& joint_angles, const std::vector<double>& joint_velocities,
@@ -188,36 +227,121 @@ bool DynamicsSolver::getTorques(const std::vector<double>& joint_angles, const s
     return false;
   }
 
-  KDL::JntArray kdl_angles(num_joints_), kdl_velocities(num_joints_), kdl_accelerations(num_joints_),
-      kdl_torques(num_joints_);
-  KDL::Wrenches kdl_wrenches(num_segments_);
-
+  std::scoped_lock slock(workspace_lock_);
   for (unsigned int i = 0; i < num_joints_; ++i)
   {
-    kdl_angles(i) = joint_angles[i];
-    kdl_velocities(i) = joint_velocities[i];
-    kdl_accelerations(i) = joint_accelerations[i];
+    workspace_->angles(i) = joint_angles[i];
+    workspace_->velocities(i) = joint_velocities[i];
+    workspace_->accelerations(i) = joint_accelerations[i];
   }
 
   for (unsigned int i = 0; i < num_segments_; ++i)
   {
-    kdl_wrenches[i](0) = wrenches[i].force.x;
-    kdl_wrenches[i](1) = wrenches[i].force.y;
-    kdl_wrenches[i](2) = wrenches[i].force.z;
+    KDL::Wrench& kdl_wrench = workspace_->wrenches[i];
+    kdl_wrench(0) = wrenches[i].force.x;
+    kdl_wrench(1) = wrenches[i].force.y;
+    kdl_wrench(2) = wrenches[i].force.z;
+
+    kdl_wrench(3) = wrenches[i].torque.x;
+    kdl_wrench(4) = wrenches[i].torque.y;
+    kdl_wrench(5) = wrenches[i].torque.z;
+  }
+
+  if (!computeTorques(*workspace_))
+    return false;
+
+  for (unsigned int i = 0; i < num_joints_; ++i)
+    torques[i] = workspace_->torques(i);
+
+  return true;
+}
 
-    kdl_wrenches[i](3) = wrenches[i].torque.x;
-    kdl_wrenches[i](4) = wrenches[i].torque.y;
-    kdl_wrenches[i](5) = wrenches[i].torque.z;
+bool DynamicsSolver::getTorques(const Eigen::MatrixXd& joint_angles, const Eigen::MatrixXd& joint_velocities,
+                                const Eigen::MatrixXd& joint_accelerations, Eigen::MatrixXd& torques) const
+{
+  if (!joint_model_group_)
+  {
+    RCLCPP_DEBUG(getLogger(), "Did not construct DynamicsSolver object properly. "
+                              "Check error logs.");
+    return false;
   }
+  std::scoped_lock slock(workspace_lock_);
+  return getTorques(joint_angles, joint_velocities, joint_accelerations, torques, *workspace_);
+}
 
-  if (chain_id_solver_->CartToJnt(kdl_angles, kdl_velocities, kdl_accelerations, kdl_wrenches, kdl_torques) < 0)
+bool DynamicsSolver::getTorques(const Eigen::MatrixXd& joint_angles, const Eigen::MatrixXd& joint_velocities,
+                                const Eigen::MatrixXd& joint_accelerations, Eigen::MatrixXd& torques,
+                                Workspace& workspace) const
+{
+  if (!joint_model_group_)
   {
-    RCLCPP_ERROR(getLogger(), "Something went wrong computing torques");
+    RCLCPP_DEBUG(getLogger(), "Did not construct DynamicsSolver object properly. "
+                              "Check error logs.");
+    return false;
+  }
+  if (joint_angles.rows() != static_cast<Eigen::Index>(num_joints_))
+  {
+    RCLCPP_ERROR(getLogger(), "Joint angles matrix should have %d rows", num_joints_);
+    return false;
+  }
+  if (joint_velocities.rows() != joint_angles.rows() || joint_velocities.cols() != joint_angles.cols())
+  {
+    RCLCPP_ERROR(getLogger(), "Joint velocities matrix should have the size of the joint angles matrix");
+    return false;
+  }
+  if (joint_accelerations.rows() != joint_angles.rows() || joint_accelerations.cols() != joint_angles.cols())
+  {
+    RCLCPP_ERROR(getLogger(), "Joint accelerations matrix should have the size of the joint angles matrix");
     return false;
   }
 
-  for (unsigned int i = 0; i < num_joints_; ++i)
-    torques[i] = kdl_torques(i);
+  torques.resize(num_joints_, joint_angles.cols());
+  std::fill(workspace.wrenches.begin(), workspace.wrenches.end(), KDL::Wrench::Zero());
+  for (Eigen::Index sample = 0; sample < joint_angles.cols(); ++sample)
+  {
+    workspace.angles.data = joint_angles.col(sample);
+    workspace.velocities.data = joint_velocities.col(sample);
+    workspace.accelerations.data = joint_accelerations.col(sample);
+    if (!computeTorques(workspace))
+      return false;
+    torques.col(sample) = workspace.torques.data;
+  }
+
+  return true;
+}
+
+bool DynamicsSolver::getTrajectoryTorques(const robot_trajectory::RobotTrajectory& trajectory,
+                                          Eigen::MatrixXd& torques, Workspace& workspace) const
+{
+  if (!joint_model_group_)
+  {
+    RCLCPP_DEBUG(getLogger(), "Did not construct DynamicsSolver object properly. "
+                              "Check error logs.");
+    return false;
+  }
+  if (trajectory.getRobotModel() != robot_model_)
+  {
+    RCLCPP_ERROR(getLogger(), "The trajectory does not belong to the robot model of the dynamics solver");
+    return false;
+  }
+
+  const std::vector<int>& variable_indices = joint_model_group_->getVariableIndexList();
+  torques.resize(num_joints_, trajectory.getWayPointCount());
+  std::fill(workspace.wrenches.begin(), workspace.wrenches.end(), KDL::Wrench::Zero());
+  for (std::size_t sample = 0; sample < trajectory.getWayPointCount(); ++sample)
+  {
+    const moveit::core::RobotState& waypoint = trajectory.getWayPoint(sample);
+    for (unsigned int i = 0; i < num_joints_; ++i)
+    {
+      workspace.angles(i) = waypoint.getVariablePosition(variable_indices[i]);
+      workspace.velocities(i) = waypoint.hasVelocities() ? waypoint.getVariableVelocity(variable_indices[i]) : 0.0;
+      workspace.accelerations(i) =
+          waypoint.hasAccelerations() ? waypoint.getVariableAcceleration(variable_indices[i]) : 0.0;
+    }
+    if (!computeTorques(workspace))
+      return false;
+    torques.col(sample) = workspace.torques.data;
+  }
 
   return true;
 }
@@ -236,16 +360,18 @@ bool DynamicsSolver::getMaxPayload(const std::vector<double>& joint_angles, doub
     RCLCPP_ERROR(getLogger(), "Joint angles vector should be size %d", num_joints_);
     return false;
   }
-  std::vector<double> joint_velocities(num_joints_, 0.0), joint_accelerations(num_joints_, 0.0);
-  std::vector<double> torques(num_joints_, 0.0), zero_torques(num_joints_, 0.0);
 
-  std::vector<geometry_msgs::msg::Wrench> wrenches(num_segments_);
-  if (!getTorques(joint_angles, joint_velocities, joint_accelerations, wrenches, zero_torques))
+  std::scoped_lock slock(workspace_lock_);
+  for (unsigned int i = 0; i < num_joints_; ++i)
+    workspace_->angles(i) = joint_angles[i];
+  if (!computePayloadTorques(*workspace_, 0.0))
     return false;
+  workspace_->gravity_torques = workspace_->torques;
+  const KDL::JntArray& zero_torques = workspace_->gravity_torques;
 
   for (unsigned int i = 0; i < num_joints_; ++i)
   {
-    if (fabs(zero_torques[i]) >= max_torques_[i])
+    if (fabs(zero_torques(i)) >= max_torques_[i])
     {
       payload = 0.0;
       joint_saturated = i;
@@ -253,28 +379,18 @@ bool DynamicsSolver::getMaxPayload(const std::vector<double>& joint_angles, doub
     }
   }
 
-  state_->setJointGroupPositions(joint_model_group_, joint_angles);
-  const Eigen::Isometry3d& base_frame = state_->getFrameTransform(base_name_);  // valid isometry by contract
-  const Eigen::Isometry3d& tip_frame = state_->getFrameTransform(tip_name_);    // valid isometry by contract
-  Eigen::Isometry3d transform = tip_frame.inverse() * base_frame;               // valid isometry by construction
-  wrenches.back().force.z = 1.0;
-  wrenches.back().force = transformVector(transform, wrenches.back().force);
-  wrenches.back().torque = transformVector(transform, wrenches.back().torque);
-
-  RCLCPP_DEBUG(getLogger(), "New wrench (local frame): %f %f %f", wrenches.back().force.x, wrenches.back().force.y,
-               wrenches.back().force.z);
-
-  if (!getTorques(joint_angles, joint_velocities, joint_accelerations, wrenches, torques))
+  if (!computePayloadTorques(*workspace_, 1.0))
     return false;
+  const KDL::JntArray& torques = workspace_->torques;
 
   double min_payload = std::numeric_limits<double>::max();
   for (unsigned int i = 0; i < num_joints_; ++i)
   {
-    double payload_joint = std::max<double>((max_torques_[i] - zero_torques[i]) / (torques[i] - zero_torques[i]),
-                                            (-max_torques_[i] - zero_torques[i]) /
-                                                (torques[i] - zero_torques[i]));  // because we set the payload to 1.0
-    RCLCPP_DEBUG(getLogger(), "Joint: %d, Actual Torque: %f, Max Allowed: %f, Gravity: %f", i, torques[i],
-                 max_torques_[i], zero_torques[i]);
+    double payload_joint = std::max<double>((max_torques_[i] - zero_torques(i)) / (torques(i) - zero_torques(i)),
+                                            (-max_torques_[i] - zero_torques(i)) /
+                                                (torques(i) - zero_torques(i)));  // because we set the payload to 1.0
+    RCLCPP_DEBUG(getLogger(), "Joint: %d, Actual Torque: %f, Max Allowed: %f, Gravity: %f", i, torques(i),
+                 max_torques_[i], zero_torques(i));
     RCLCPP_DEBUG(getLogger(), "Joint: %d, Payload Allowed (N): %f", i, payload_joint);
     if (payload_joint < min_payload)
     {
@@ -306,21 +422,41 @@ bool DynamicsSolver::getPayloadTorques(const std::vector<double>& joint_angles,
     RCLCPP_ERROR(getLogger(), "Joint torques vector should be size %d", num_joints_);
     return false;
   }
-  std::vector<double> joint_velocities(num_joints_, 0.0), joint_accelerations(num_joints_, 0.0);
-  std::vector<geometry_msgs::msg::Wrench> wrenches(num_segments_);
-  state_->setJointGroupPositions(joint_model_group_, joint_angles);
 
-  const Eigen::Isometry3d& base_frame = state_->getFrameTransform(base_name_);  // valid isometry by contract
-  const Eigen::Isometry3d& tip_frame = state_->getFrameTransform(tip_name_);    // valid isometry by contract
-  Eigen::Isometry3d transform = tip_frame.inverse() * base_frame;               // valid isometry by construction
-  wrenches.back().force.z = payload * gravity_;
-  wrenches.back().force = transformVector(transform, wrenches.back().force);
-  wrenches.back().torque = transformVector(transform, wrenches.back().torque);
+  std::scoped_lock slock(workspace_lock_);
+  for (unsigned int i = 0; i < num_joints_; ++i)
+    workspace_->angles(i) = joint_angles[i];
+  if (!computePayloadTorques(*workspace_, payload * gravity_))
+    return false;
+  for (unsigned int i = 0; i < num_joints_; ++i)
+    joint_torques[i] = workspace_->torques(i);
+  return true;
+}
 
-  RCLCPP_DEBUG(getLogger(), "New wrench (local frame): %f %f %f", wrenches.back().force.x, wrenches.back().force.y,
-               wrenches.back().force.z);
+bool DynamicsSolver::getPayloadTorques(const Eigen::MatrixXd& joint_angles, double payload,
+                                       Eigen::MatrixXd& joint_torques, Workspace& workspace) const
+{
+  if (!joint_model_group_)
+  {
+    RCLCPP_DEBUG(getLogger(), "Did not construct DynamicsSolver object properly. "
+                              "Check error logs.");
+    return false;
+  }
+  if (joint_angles.rows() != static_cast<Eigen::Index>(num_joints_))
+  {
+    RCLCPP_ERROR(getLogger(), "Joint angles matrix should have %d rows", num_joints_);
+    return false;
+  }
 
-  return getTorques(joint_angles, joint_velocities, joint_accelerations, wrenches, joint_torques);
+  joint_torques.resize(num_joints_, joint_angles.cols());
+  for (Eigen::Index sample = 0; sample < joint_angles.cols(); ++sample)
+  {
+    workspace.angles.data = joint_angles.col(sample);
+    if (!computePayloadTorques(workspace, payload * gravity_))
+      return false;
+    joint_torques.col(sample) = workspace.torques.data;
+  }
+  return true;
 }
 
 const std::vector<double>& DynamicsSolver::getMaxTorques() const
@@ -46,6 +46,7 @@
 #include <moveit_msgs/msg/constraints.hpp>
 
 #include <iostream>
+#include <memory>
 #include <vector>
 
 /** \brief Representation and evaluation of kinematic constraints */
@@ -108,6 +109,22 @@ public:
    */
   virtual ConstraintEvaluationResult decide(const moveit::core::RobotState& state, bool verbose = false) const = 0;
 
+  /**
+   * \brief Compute the gradient of the distance returned by decide() with respect to the positions of the variables
+   * of a group
+   *
+   * Link constraints compute it from the group Jacobian, so optimizers don't need finite differences, which cost two
+   * forward kinematics evaluations per variable.
+   *
+   * @param [in] state The kinematic state used for evaluation, its link transforms need to be up to date
+   * @param [in] group The group to differentiate for, which needs to be a chain for link constraints
+   * @param [out] gradient The gradient, with one entry per variable of the group
+   *
+   * @return False if the constraint type has no analytic gradient, or the gradient is undefined in \e state
+   */
+  virtual bool computeDistanceGradient(const moveit::core::RobotState& state,
+                                       const moveit::core::JointModelGroup* group, Eigen::VectorXd& gradient) const;
+
   /** \brief This function returns true if this constraint is
       configured and able to decide whether states do meet the
       constraint or not. If this function returns false it means
@@ -246,6 +263,8 @@ public:
   bool equal(const KinematicConstraint& other, double margin) const override;
 
   ConstraintEvaluationResult decide(const moveit::core::RobotState& state, bool verbose = false) const override;
+  bool computeDistanceGradient(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* group,
+                               Eigen::VectorXd& gradient) const override;
   bool enabled() const override;
   void clear() override;
   void print(std::ostream& out = std::cout) const override;
@@ -322,6 +341,14 @@ public:
     return joint_tolerance_below_;
   }
 
+  /**
+   * \brief Whether the constrained joint is continuous, so that distances are computed over the wrap
+   */
+  bool isContinuous() const
+  {
+    return joint_is_continuous_;
+  }
+
 protected:
   const moveit::core::JointModel* joint_model_; /**< \brief The joint from the kinematic model for this constraint */
   bool joint_is_continuous_;                    /**< \brief Whether or not the joint is continuous */
@@ -403,6 +430,8 @@ public:
 
   void clear() override;
   ConstraintEvaluationResult decide(const moveit::core::RobotState& state, bool verbose = false) const override;
+  bool computeDistanceGradient(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* group,
+                               Eigen::VectorXd& gradient) const override;
   bool enabled() const override;
   void print(std::ostream& out = std::cout) const override;
 
@@ -510,6 +539,7 @@ protected:
   Eigen::Matrix3d desired_rotation_matrix_inv_; /**< The inverse of desired_rotation_matrix_ (for efficiency) */
   std::string desired_rotation_frame_id_;       /**< The target frame of the transform tree */
   bool mobile_frame_;                           /**< Whether or not the header frame is mobile or fixed */
+  const moveit::core::LinkModel* desired_rotation_frame_link_ = nullptr; /**< The robot link of a mobile frame */
   int parameterization_type_;                   /**< Parameterization type for orientation tolerance */
   double absolute_x_axis_tolerance_, absolute_y_axis_tolerance_,
       absolute_z_axis_tolerance_; /**< Storage for the tolerances */
@@ -591,6 +621,8 @@ public:
 
   void clear() override;
   ConstraintEvaluationResult decide(const moveit::core::RobotState& state, bool verbose = false) const override;
+  bool computeDistanceGradient(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* group,
+                               Eigen::VectorXd& gradient) const override;
   bool enabled() const override;
   void print(std::ostream& out = std::cout) const override;
 
@@ -666,6 +698,18 @@ public:
     return mobile_frame_;
   }
 
+  /**
+   * \brief Find the first constraint region containing a point
+   *
+   * Constraints with many regions keep a bounding volume hierarchy over them, so the lookup takes logarithmic time
+   * in the number of regions for points inside few of them.
+   *
+   * @param [in] point The point, in the constraint frame
+   *
+   * @return The index of the first region in getConstraintRegions() containing the point, or -1 if there is none
+   */
+  int findContainingRegion(const Eigen::Vector3d& point) const;
+
 protected:
   Eigen::Vector3d offset_;                         /**< \brief The target offset */
   bool has_offset_;                                /**< \brief Whether the offset is substantially different than 0.0 */
@@ -674,7 +718,25 @@ protected:
   EigenSTL::vector_Isometry3d constraint_region_pose_;
   bool mobile_frame_;                         /**< \brief Whether or not a mobile frame is employed*/
   std::string constraint_frame_id_;           /**< \brief The constraint frame id */
+  const moveit::core::LinkModel* constraint_frame_link_ = nullptr; /**< \brief The robot link of a mobile frame */
   const moveit::core::LinkModel* link_model_; /**< \brief The link model constraint subject */
+
+private:
+  /** \brief A node of the bounding volume hierarchy over the constraint regions */
+  struct RegionTreeNode
+  {
+    Eigen::AlignedBox3d box;  // bounds of all regions below the node
+    int children[2];          // node indices of the children, -1 for leaves
+    std::size_t begin, end;   // range of region_tree_indices_ covered by the node
+    std::size_t min_region;   // smallest region index below the node
+  };
+
+  /** \brief Build the bounding volume hierarchy, if there are enough regions for it to pay off */
+  void buildRegionTree();
+  int buildRegionTree(const std::vector<Eigen::AlignedBox3d>& boxes, std::size_t begin, std::size_t end);
+
+  std::vector<RegionTreeNode> region_tree_; /**< \brief The hierarchy nodes, the root first */
+  std::vector<std::size_t> region_tree_indices_; /**< \brief Region indices, ordered such that nodes cover ranges */
 };
 
 MOVEIT_CLASS_FORWARD(VisibilityConstraint);  // Defines VisibilityConstraintPtr, ConstPtr, WeakPtr... etc
@@ -872,6 +934,8 @@ protected:
 
   std::string target_frame_id_;      /**< \brief The target frame id */
   std::string sensor_frame_id_;      /**< \brief The sensor frame id */
+  const moveit::core::LinkModel* target_frame_link_ = nullptr; /**< \brief The robot link of the target frame */
+  const moveit::core::LinkModel* sensor_frame_link_ = nullptr; /**< \brief The robot link of the sensor frame */
   Eigen::Isometry3d sensor_pose_;    /**< \brief The sensor pose transformed into the transform frame */
   int sensor_view_direction_;        /**< \brief Storage for the sensor view direction */
   Eigen::Isometry3d target_pose_;    /**< \brief The target pose transformed into the transform frame */
@@ -880,6 +944,29 @@ protected:
   double target_radius_;             /**< \brief Storage for the target radius */
   double max_view_angle_;            /**< \brief Storage for the max view angle */
   double max_range_angle_;           /**< \brief Storage for the max range angle */
+
+private:
+  /** \brief A robot link tested against the cone through the bounding sphere of its collision geometry */
+  struct LinkSphere
+  {
+    const moveit::core::LinkModel* link_model;
+    Eigen::Vector3d center;  // in the link frame
+    double radius;
+  };
+
+  /** \brief Collision environments holding the cone, reused across decide() calls; defined in the source file */
+  struct ConeCollisionCache;
+
+  /**
+   * \brief Whether the bounding sphere of any robot link intersects the circular cone around the visibility cone
+   *
+   * The test is conservative: if it returns false, no link can collide with the cone mesh.
+   */
+  bool coneMayTouchRobot(const moveit::core::RobotState& state, const Eigen::Isometry3d& tform_world_to_sensor,
+                         const Eigen::Isometry3d& tform_world_to_target) const;
+
+  std::vector<LinkSphere> link_spheres_; /**< \brief The links whose contacts with the cone are not accepted */
+  std::shared_ptr<ConeCollisionCache> cone_cache_; /**< \brief Shared by copies of the constraint */
 };
 
 MOVEIT_CLASS_FORWARD(KinematicConstraintSet);  // Defines KinematicConstraintSetPtr, ConstPtr, WeakPtr... etc
@@ -997,6 +1084,46 @@ public:
   ConstraintEvaluationResult decide(const moveit::core::RobotState& state,
                                     std::vector<ConstraintEvaluationResult>& results, bool verbose = false) const;
 
+  /**
+   * \brief Determines whether all constraints are satisfied by state, without computing distances
+   *
+   * The constraints are evaluated cheapest first from flattened parameters: joint constraints, which do not need
+   * link transforms, then position constraints in fixed frames, then the remaining ones. The evaluation stops at the
+   * first violated constraint, so this is considerably faster than decide() for rejecting states.
+   *
+   * @param [in] state The state to test
+   * @param [in] verbose Whether to print the results of each constraint check, which evaluates all constraints
+   *
+   * @return True if all constraints are satisfied
+   */
+  bool isSatisfied(const moveit::core::RobotState& state, bool verbose = false) const;
+
+  /**
+   * \brief Determines for a batch of states whether they satisfy all constraints, without computing distances
+   *
+   * Each joint constraint is evaluated on all states at once, and the constraints needing link transforms are only
+   * evaluated on the states satisfying all joint constraints.
+   *
+   * @param [in] states The states to test, their link transforms need to be up to date
+   * @param [out] satisfied For each state, whether it satisfies all constraints
+   *
+   * @return The number of states satisfying all constraints
+   */
+  std::size_t decide(const std::vector<const moveit::core::RobotState*>& states, std::vector<bool>& satisfied) const;
+
+  /**
+   * \brief Compute the gradient of the summed distance returned by decide() with respect to the positions of the
+   * variables of a group
+   *
+   * @param [in] state The state to evaluate, its link transforms need to be up to date
+   * @param [in] group The group to differentiate for
+   * @param [out] gradient The gradient, with one entry per variable of the group
+   *
+   * @return False if any enabled constraint has no analytic gradient in \e state
+   */
+  bool computeDistanceGradient(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* group,
+                               Eigen::VectorXd& gradient) const;
+
   /**
    * \brief Whether or not another KinematicConstraintSet is equal to
    * this one.
@@ -1103,5 +1230,41 @@ protected:
                                                                                all
                                                                                internal visibility constraints */
   moveit_msgs::msg::Constraints all_constraints_; /**<  \brief Messages corresponding to all internal constraints */
+
+private:
+  /** \brief Joint constraints flattened into parallel arrays, one entry per constraint */
+  struct CompiledJointConstraints
+  {
+    std::vector<int> variable_indices;
+    std::vector<double> desired_positions;
+    std::vector<double> upper_tolerances;  // tolerance above, including the epsilon margin of JointConstraint
+    std::vector<double> lower_tolerances;  // negated tolerance below, including the epsilon margin
+
+    void clear();
+    void add(const JointConstraint& constraint);
+  };
+
+  /** \brief A position constraint in a fixed frame, whose regions are searched by the constraint itself */
+  struct CompiledPositionConstraint
+  {
+    const moveit::core::LinkModel* link_model;
+    Eigen::Vector3d offset;
+    const PositionConstraint* constraint;
+  };
+
+  /** \brief Rebuild the flattened representation of the enabled constraints used by isSatisfied() */
+  void compile();
+
+  /** \brief Evaluate the compiled joint constraints */
+  bool jointConstraintsSatisfied(const moveit::core::RobotState& state) const;
+
+  /** \brief Evaluate the constraints which need link transforms, compiled position constraints first */
+  bool linkConstraintsSatisfied(const moveit::core::RobotState& state) const;
+
+  CompiledJointConstraints compiled_joints_;             /**< \brief Joints constrained within their range */
+  CompiledJointConstraints compiled_continuous_joints_;  /**< \brief Continuous joints, compared over the wrap */
+  std::vector<CompiledPositionConstraint> compiled_positions_;
+  /** \brief The remaining enabled constraints, ordered by increasing evaluation cost */
+  std::vector<const KinematicConstraint*> remaining_constraints_;
 };
 }  // namespace kinematic_constraints
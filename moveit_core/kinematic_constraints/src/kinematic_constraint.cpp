@@ -44,10 +44,14 @@
 #include <rclcpp/logging.hpp>
 #include <rclcpp/time.hpp>
 #include <tf2_eigen/tf2_eigen.hpp>
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <limits>
 #include <math.h>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <typeinfo>
 #include <moveit/utils/logger.hpp>
 
@@ -62,6 +66,59 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.kinematic_constraints");
 }
+
+/** \brief Resolve a frame that is a link of \e model once, so decide() can use the link transform directly instead
+    of looking the frame up by name on every call. Returns nullptr for the model frame (which getFrameTransform()
+    reports as identity) and for frames that are not robot links, e.g. attached bodies. */
+const moveit::core::LinkModel* findFrameLink(const moveit::core::RobotModel& model, const std::string& frame_id)
+{
+  if (frame_id.empty() || frame_id == model.getModelFrame())
+    return nullptr;
+  bool found;
+  return model.getLinkModel(frame_id, &found);
+}
+
+const Eigen::Isometry3d& getFrameTransform(const moveit::core::RobotState& state, const moveit::core::LinkModel* link,
+                                           const std::string& frame_id)
+{
+  return link ? state.getGlobalLinkTransform(link) : state.getFrameTransform(frame_id);
+}
+
+/** \brief Compute the Jacobian of a point on \e link with respect to the variables of \e group, expressed in the model
+    frame. The Jacobian is zero if the group does not move the link. Returns false if the group is not a chain. */
+bool computeLinkJacobian(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* group,
+                         const moveit::core::LinkModel* link, const Eigen::Vector3d& offset, Eigen::MatrixXd& jacobian)
+{
+  if (!group->isChain())
+    return false;
+  if (!group->getUpdatedLinkModelsSet().count(link))
+  {
+    jacobian.setZero(6, group->getVariableCount());
+    return true;
+  }
+  if (!state.getJacobian(group, link, offset, jacobian))
+    return false;
+  // RobotState::getJacobian() expresses the Jacobian in the frame of the group root link
+  const moveit::core::LinkModel* root_link = group->getJointModels().front()->getParentLinkModel();
+  if (root_link)
+  {
+    const Eigen::Matrix3d& root_rotation = state.getGlobalLinkTransform(root_link).linear();
+    jacobian.topRows<3>() = root_rotation * jacobian.topRows<3>();
+    jacobian.bottomRows<3>() = root_rotation * jacobian.bottomRows<3>();
+  }
+  return true;
+}
+
+/** \brief Whether a mobile constraint frame moves with the variables of \e group */
+bool frameMovesWithGroup(const moveit::core::JointModelGroup* group, const moveit::core::LinkModel* frame_link)
+{
+  return frame_link && group->getUpdatedLinkModelsSet().count(frame_link);
+}
+
+double sign(double value)
+{
+  return value > 0.0 ? 1.0 : (value < 0.0 ? -1.0 : 0.0);
+}
 }  // namespace
 
 static double normalizeAngle(double angle)
@@ -78,6 +135,32 @@ static double normalizeAngle(double angle)
   return v;
 }
 
+// position constraints with at least this many regions search them through a bounding volume hierarchy
+static constexpr std::size_t REGION_TREE_MIN_REGIONS = 8;
+// maximum number of regions in a leaf of the hierarchy
+static constexpr std::size_t REGION_TREE_LEAF_SIZE = 4;
+// the hierarchy is split at medians, so this depth covers any number of regions
+static constexpr std::size_t REGION_TREE_MAX_DEPTH = 64;
+// margin added to the bounding boxes of the regions
+static constexpr double REGION_BOX_MARGIN = 1e-9;
+// relative sensor to target transforms closer than this share the cached visibility cone
+static constexpr double CONE_CACHE_TOLERANCE = 1e-12;
+
+// signed shortest distance of a continuous joint from its desired (normalized) position
+static double continuousJointDistance(double position, double desired_position)
+{
+  double dif = normalizeAngle(position) - desired_position;
+  if (dif > M_PI)
+  {
+    dif = 2.0 * M_PI - dif;
+  }
+  else if (dif < -M_PI)
+  {
+    dif += 2.0 * M_PI;  // we include a sign change to have dif > 0
+  }
+  return dif;
+}
+
 // Normalizes an angle to the interval [-pi, +pi] and then take the absolute value
 // The returned values will be in the following range [0, +pi]
 static double normalizeAbsoluteAngle(const double angle)
@@ -137,6 +220,13 @@ KinematicConstraint::KinematicConstraint(const moveit::core::RobotModelConstPtr&
 
 KinematicConstraint::~KinematicConstraint() = default;
 
+bool KinematicConstraint::computeDistanceGradient(const moveit::core::RobotState& /*state*/,
+                                                  const moveit::core::JointModelGroup* /*group*/,
+                                                  Eigen::VectorXd& /*gradient*/) const
+{
+  return false;
+}
+
 bool JointConstraint::configure(const moveit_msgs::msg::JointConstraint& jc)
 {
   // clearing before we configure to get rid of any old data
@@ -296,18 +386,7 @@ ConstraintEvaluationResult JointConstraint::decide(const moveit::core::RobotStat
 
   // compute signed shortest distance for continuous joints
   if (joint_is_continuous_)
-  {
-    dif = normalizeAngle(current_joint_position) - joint_position_;
-
-    if (dif > M_PI)
-    {
-      dif = 2.0 * M_PI - dif;
-    }
-    else if (dif < -M_PI)
-    {
-      dif += 2.0 * M_PI;  // we include a sign change to have dif > 0
-    }
-  }
+    dif = continuousJointDistance(current_joint_position, joint_position_);
   else
     dif = current_joint_position - joint_position_;
 
@@ -325,6 +404,32 @@ ConstraintEvaluationResult JointConstraint::decide(const moveit::core::RobotStat
   return ConstraintEvaluationResult(result, constraint_weight_ * fabs(dif));
 }
 
+bool JointConstraint::computeDistanceGradient(const moveit::core::RobotState& state,
+                                              const moveit::core::JointModelGroup* group,
+                                              Eigen::VectorXd& gradient) const
+{
+  gradient.setZero(group->getVariableCount());
+  if (!joint_model_)
+    return true;
+  const std::vector<int>& variable_indices = group->getVariableIndexList();
+  const auto it = std::find(variable_indices.begin(), variable_indices.end(), joint_variable_index_);
+  if (it == variable_indices.end())
+    return true;
+
+  // the distance is the weighted absolute difference; for continuous joints the wrap at +pi flips its sign
+  const double position = state.getVariablePosition(joint_variable_index_);
+  double dif = position - joint_position_;
+  double dif_derivative = 1.0;
+  if (joint_is_continuous_)
+  {
+    dif = continuousJointDistance(position, joint_position_);
+    if (normalizeAngle(position) - joint_position_ > M_PI)
+      dif_derivative = -1.0;
+  }
+  gradient(it - variable_indices.begin()) = constraint_weight_ * sign(dif) * dif_derivative;
+  return true;
+}
+
 bool JointConstraint::enabled() const
 {
   return joint_model_;
@@ -388,6 +493,7 @@ bool PositionConstraint::configure(const moveit_msgs::msg::PositionConstraint& p
   {
     constraint_frame_id_ = pc.header.frame_id;
     mobile_frame_ = true;
+    constraint_frame_link_ = findFrameLink(*robot_model_, constraint_frame_id_);
   }
 
   // load primitive shapes, first clearing any we already have
@@ -456,9 +562,113 @@ bool PositionConstraint::configure(const moveit_msgs::msg::PositionConstraint& p
   else
     constraint_weight_ = pc.weight;
 
+  buildRegionTree();
   return !constraint_region_.empty();
 }
 
+void PositionConstraint::buildRegionTree()
+{
+  region_tree_.clear();
+  region_tree_indices_.clear();
+  if (constraint_region_.size() < REGION_TREE_MIN_REGIONS)
+    return;
+
+  std::vector<Eigen::AlignedBox3d> boxes(constraint_region_.size());
+  for (std::size_t i = 0; i < constraint_region_.size(); ++i)
+  {
+    bodies::AABB aabb;
+    constraint_region_[i]->computeBoundingBox(aabb);
+    boxes[i] = aabb;
+    // points on the surface of a region must not fall outside its box due to rounding
+    boxes[i].min().array() -= REGION_BOX_MARGIN;
+    boxes[i].max().array() += REGION_BOX_MARGIN;
+  }
+  region_tree_indices_.resize(constraint_region_.size());
+  std::iota(region_tree_indices_.begin(), region_tree_indices_.end(), 0);
+  region_tree_.reserve(2 * constraint_region_.size() / REGION_TREE_LEAF_SIZE + 1);
+  buildRegionTree(boxes, 0, constraint_region_.size());
+}
+
+int PositionConstraint::buildRegionTree(const std::vector<Eigen::AlignedBox3d>& boxes, std::size_t begin,
+                                        std::size_t end)
+{
+  // the recursion reallocates region_tree_, so the node is filled in locally
+  const int index = static_cast<int>(region_tree_.size());
+  region_tree_.emplace_back();
+  RegionTreeNode node;
+  node.box.setEmpty();
+  node.children[0] = node.children[1] = -1;
+  node.begin = begin;
+  node.end = end;
+  node.min_region = std::numeric_limits<std::size_t>::max();
+  Eigen::AlignedBox3d centers;
+  centers.setEmpty();
+  for (std::size_t k = begin; k < end; ++k)
+  {
+    const std::size_t region = region_tree_indices_[k];
+    node.box.extend(boxes[region]);
+    centers.extend(boxes[region].center());
+    node.min_region = std::min(node.min_region, region);
+  }
+
+  // split at the median of the region centers along the longest axis, which bounds the depth by log2 of the count
+  if (end - begin > REGION_TREE_LEAF_SIZE)
+  {
+    Eigen::Index axis;
+    centers.sizes().maxCoeff(&axis);
+    const std::size_t middle = begin + (end - begin) / 2;
+    std::nth_element(region_tree_indices_.begin() + begin, region_tree_indices_.begin() + middle,
+                     region_tree_indices_.begin() + end, [&boxes, axis](std::size_t a, std::size_t b) {
+                       return boxes[a].center()(axis) < boxes[b].center()(axis);
+                     });
+    node.children[0] = buildRegionTree(boxes, begin, middle);
+    node.children[1] = buildRegionTree(boxes, middle, end);
+  }
+  region_tree_[index] = node;
+  return index;
+}
+
+int PositionConstraint::findContainingRegion(const Eigen::Vector3d& point) const
+{
+  if (region_tree_.empty())
+  {
+    for (std::size_t i = 0; i < constraint_region_.size(); ++i)
+    {
+      if (constraint_region_[i]->containsPoint(point))
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  // depth-first search for the smallest index of a containing region, pruning subtrees of larger indices
+  std::size_t best = constraint_region_.size();
+  std::array<int, REGION_TREE_MAX_DEPTH> stack;
+  std::size_t stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size > 0)
+  {
+    const RegionTreeNode& node = region_tree_[stack[--stack_size]];
+    if (node.min_region >= best || !node.box.contains(point))
+      continue;
+    if (node.children[0] < 0)
+    {
+      for (std::size_t k = node.begin; k < node.end; ++k)
+      {
+        const std::size_t region = region_tree_indices_[k];
+        if (region < best && constraint_region_[region]->containsPoint(point))
+          best = region;
+      }
+      continue;
+    }
+    // visit the child with the smaller region indices first, so that more subtrees get pruned
+    const bool first_smaller =
+        region_tree_[node.children[0]].min_region < region_tree_[node.children[1]].min_region;
+    stack[stack_size++] = node.children[first_smaller ? 1 : 0];
+    stack[stack_size++] = node.children[first_smaller ? 0 : 1];
+  }
+  return best < constraint_region_.size() ? static_cast<int>(best) : -1;
+}
+
 bool PositionConstraint::equal(const KinematicConstraint& other, double margin) const
 {
   if (other.getType() != type_)
@@ -525,11 +735,25 @@ ConstraintEvaluationResult PositionConstraint::decide(const moveit::core::RobotS
     return ConstraintEvaluationResult(true, 0.0);
 
   Eigen::Vector3d pt = state.getGlobalLinkTransform(link_model_) * offset_;
+  if (!region_tree_.empty() && !verbose)
+  {
+    // search the hierarchy in the constraint frame, rather than moving every region into the planning frame
+    const Eigen::Isometry3d* frame_transform =
+        mobile_frame_ ? &getFrameTransform(state, constraint_frame_link_, constraint_frame_id_) : nullptr;
+    const int region = findContainingRegion(frame_transform ? Eigen::Vector3d(frame_transform->inverse() * pt) : pt);
+    // like the linear search, a violated constraint reports the distance to the last region
+    const std::size_t i = region >= 0 ? static_cast<std::size_t>(region) : constraint_region_.size() - 1;
+    const Eigen::Vector3d center = frame_transform ?
+                                       Eigen::Vector3d(*frame_transform * constraint_region_pose_[i].translation()) :
+                                       constraint_region_[i]->getPose().translation();
+    return finishPositionConstraintDecision(pt, center, link_model_->getName(), constraint_weight_, region >= 0, false);
+  }
   if (mobile_frame_)
   {
+    const Eigen::Isometry3d& frame_transform = getFrameTransform(state, constraint_frame_link_, constraint_frame_id_);
     for (std::size_t i = 0; i < constraint_region_.size(); ++i)
     {
-      Eigen::Isometry3d tmp = state.getFrameTransform(constraint_frame_id_) * constraint_region_pose_[i];
+      Eigen::Isometry3d tmp = frame_transform * constraint_region_pose_[i];
       bool result = constraint_region_[i]->cloneAt(tmp)->containsPoint(pt, verbose);
       if (result || (i + 1 == constraint_region_pose_.size()))
       {
@@ -563,6 +787,37 @@ ConstraintEvaluationResult PositionConstraint::decide(const moveit::core::RobotS
   return ConstraintEvaluationResult(false, 0.0);
 }
 
+bool PositionConstraint::computeDistanceGradient(const moveit::core::RobotState& state,
+                                                 const moveit::core::JointModelGroup* group,
+                                                 Eigen::VectorXd& gradient) const
+{
+  gradient.setZero(group->getVariableCount());
+  if (!link_model_ || constraint_region_.empty())
+    return true;
+  if (mobile_frame_ && frameMovesWithGroup(group, constraint_frame_link_))
+    return false;
+
+  // the distance is taken to the center of the region decide() reports
+  const Eigen::Vector3d pt = state.getGlobalLinkTransform(link_model_) * offset_;
+  const Eigen::Isometry3d* frame_transform =
+      mobile_frame_ ? &getFrameTransform(state, constraint_frame_link_, constraint_frame_id_) : nullptr;
+  const int region = findContainingRegion(frame_transform ? Eigen::Vector3d(frame_transform->inverse() * pt) : pt);
+  const std::size_t i = region >= 0 ? static_cast<std::size_t>(region) : constraint_region_.size() - 1;
+  const Eigen::Vector3d center = frame_transform ?
+                                     Eigen::Vector3d(*frame_transform * constraint_region_pose_[i].translation()) :
+                                     constraint_region_[i]->getPose().translation();
+  const Eigen::Vector3d error = pt - center;
+  const double norm = error.norm();
+  if (norm <= std::numeric_limits<double>::epsilon())
+    return true;
+
+  Eigen::MatrixXd jacobian;
+  if (!computeLinkJacobian(state, group, link_model_, offset_, jacobian))
+    return false;
+  gradient = (constraint_weight_ / norm) * jacobian.topRows<3>().transpose() * error;
+  return true;
+}
+
 void PositionConstraint::print(std::ostream& out) const
 {
   if (enabled())
@@ -583,7 +838,10 @@ void PositionConstraint::clear()
   constraint_region_pose_.clear();
   mobile_frame_ = false;
   constraint_frame_id_ = "";
+  constraint_frame_link_ = nullptr;
   link_model_ = nullptr;
+  region_tree_.clear();
+  region_tree_indices_.clear();
 }
 
 bool PositionConstraint::enabled() const
@@ -632,6 +890,7 @@ bool OrientationConstraint::configure(const moveit_msgs::msg::OrientationConstra
     desired_rotation_frame_id_ = oc.header.frame_id;
     desired_rotation_matrix_ = Eigen::Matrix3d(q);
     mobile_frame_ = true;
+    desired_rotation_frame_link_ = findFrameLink(*robot_model_, desired_rotation_frame_id_);
   }
   std::stringstream matrix_str;
   matrix_str << desired_rotation_matrix_;
@@ -696,6 +955,7 @@ void OrientationConstraint::clear()
   desired_rotation_matrix_ = Eigen::Matrix3d::Identity();
   desired_rotation_matrix_inv_ = Eigen::Matrix3d::Identity();
   desired_rotation_frame_id_ = "";
+  desired_rotation_frame_link_ = nullptr;
   mobile_frame_ = false;
   absolute_z_axis_tolerance_ = absolute_y_axis_tolerance_ = absolute_x_axis_tolerance_ = 0.0;
 }
@@ -714,7 +974,9 @@ ConstraintEvaluationResult OrientationConstraint::decide(const moveit::core::Rob
   if (mobile_frame_)
   {
     // getFrameTransform() returns a valid isometry by contract
-    Eigen::Matrix3d tmp = state.getFrameTransform(desired_rotation_frame_id_).linear() * desired_rotation_matrix_;
+    Eigen::Matrix3d tmp =
+        getFrameTransform(state, desired_rotation_frame_link_, desired_rotation_frame_id_).linear() *
+        desired_rotation_matrix_;
     // getGlobalLinkTransform() returns a valid isometry by contract
     diff = Eigen::Isometry3d(tmp.transpose() * state.getGlobalLinkTransform(link_model_).linear());  // valid isometry
   }
@@ -779,6 +1041,74 @@ ConstraintEvaluationResult OrientationConstraint::decide(const moveit::core::Rob
   return ConstraintEvaluationResult(result, constraint_weight_ * (xyz_rotation(0) + xyz_rotation(1) + xyz_rotation(2)));
 }
 
+bool OrientationConstraint::computeDistanceGradient(const moveit::core::RobotState& state,
+                                                    const moveit::core::JointModelGroup* group,
+                                                    Eigen::VectorXd& gradient) const
+{
+  gradient.setZero(group->getVariableCount());
+  if (!link_model_)
+    return true;
+  if (mobile_frame_ && frameMovesWithGroup(group, desired_rotation_frame_link_))
+    return false;
+
+  // diff = desired^T * link like in decide(); rotating the link by a small world angle w rotates diff by desired^T * w
+  const Eigen::Matrix3d desired =
+      mobile_frame_ ?
+          Eigen::Matrix3d(getFrameTransform(state, desired_rotation_frame_link_, desired_rotation_frame_id_).linear() *
+                          desired_rotation_matrix_) :
+          desired_rotation_matrix_;
+  const Eigen::Matrix3d diff = desired.transpose() * state.getGlobalLinkTransform(link_model_).linear();
+
+  // derivative of the signed error components with respect to the rotation of diff
+  Eigen::Vector3d error;
+  Eigen::Matrix3d error_derivative;
+  if (parameterization_type_ == moveit_msgs::msg::OrientationConstraint::XYZ_EULER_ANGLES)
+  {
+    const auto euler_angles = calcEulerAngles(diff);
+    if (!std::get<bool>(euler_angles))
+      return false;  // the angles are not differentiable at the singularity
+    error = std::get<Eigen::Vector3d>(euler_angles);
+    // for diff = Rx(a) * Ry(b) * Rz(c), the angular velocity is [x, Rx(a) * y, Rx(a) * Ry(b) * z] * (da, db, dc)
+    const Eigen::Matrix3d rx = Eigen::AngleAxisd(error(0), Eigen::Vector3d::UnitX()).toRotationMatrix();
+    const Eigen::Matrix3d ry = Eigen::AngleAxisd(error(1), Eigen::Vector3d::UnitY()).toRotationMatrix();
+    Eigen::Matrix3d rates;
+    rates.col(0) = Eigen::Vector3d::UnitX();
+    rates.col(1) = rx.col(1);
+    rates.col(2) = rx * ry.col(2);
+    error_derivative = rates.inverse();
+  }
+  else
+  {
+    const Eigen::AngleAxisd aa(diff);
+    const Eigen::Vector3d rotation_vector = aa.axis() * aa.angle();
+    // the inverse of the left Jacobian of SO(3) maps angular velocities to rotation vector rates
+    const double angle = aa.angle();
+    Eigen::Matrix3d skew;
+    skew << 0.0, -rotation_vector.z(), rotation_vector.y(), rotation_vector.z(), 0.0, -rotation_vector.x(),
+        -rotation_vector.y(), rotation_vector.x(), 0.0;
+    Eigen::Matrix3d inverse_left_jacobian = Eigen::Matrix3d::Identity() - 0.5 * skew;
+    if (angle > 1e-6)
+    {
+      if (M_PI - angle < 1e-6)
+        return false;  // the rotation vector flips at pi
+      inverse_left_jacobian +=
+          (1.0 / (angle * angle) - (1.0 + std::cos(angle)) / (2.0 * angle * std::sin(angle))) * skew * skew;
+    }
+    const Eigen::Matrix3d& frame_rotation = desired_R_in_frame_id_;
+    error = frame_rotation * rotation_vector;
+    error_derivative = frame_rotation * inverse_left_jacobian;
+  }
+
+  // the distance is the weighted sum of the absolute errors
+  Eigen::MatrixXd jacobian;
+  if (!computeLinkJacobian(state, group, link_model_, Eigen::Vector3d::Zero(), jacobian))
+    return false;
+  const Eigen::Vector3d world_gradient =
+      constraint_weight_ * desired * error_derivative.transpose() * error.unaryExpr(&sign);
+  gradient = jacobian.bottomRows<3>().transpose() * world_gradient;
+  return true;
+}
+
 void OrientationConstraint::print(std::ostream& out) const
 {
   if (link_model_)
@@ -791,6 +1121,66 @@ void OrientationConstraint::print(std::ostream& out) const
     out << "No constraint" << '\n';
 }
 
+/** A pool of collision environments holding the visibility cone. decide() may run concurrently, so each call takes
+    an environment out of the pool and returns it afterwards. The cone is kept in the sensor frame and only rebuilt
+    when the target moves relative to the sensor, otherwise moving the object is enough. */
+struct VisibilityConstraint::ConeCollisionCache
+{
+  struct Entry
+  {
+    std::unique_ptr<collision_detection::CollisionEnvFCL> env;
+    shapes::ShapeConstPtr cone;
+    Eigen::Isometry3d sensor_to_target;
+  };
+
+  /** \brief Returns an entry to the pool when going out of scope */
+  class Lease
+  {
+  public:
+    Lease(ConeCollisionCache& cache, std::unique_ptr<Entry> entry) : cache_(cache), entry_(std::move(entry))
+    {
+    }
+    ~Lease()
+    {
+      std::lock_guard<std::mutex> lock(cache_.mutex);
+      cache_.entries.push_back(std::move(entry_));
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    Entry& operator*() const
+    {
+      return *entry_;
+    }
+
+  private:
+    ConeCollisionCache& cache_;
+    std::unique_ptr<Entry> entry_;
+  };
+
+  Lease acquire(const moveit::core::RobotModelConstPtr& robot_model)
+  {
+    std::unique_ptr<Entry> entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!entries.empty())
+      {
+        entry = std::move(entries.back());
+        entries.pop_back();
+      }
+    }
+    if (!entry)
+    {
+      entry = std::make_unique<Entry>();
+      entry->env = std::make_unique<collision_detection::CollisionEnvFCL>(robot_model);
+    }
+    return Lease(*this, std::move(entry));
+  }
+
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Entry>> entries;
+};
+
 VisibilityConstraint::VisibilityConstraint(const moveit::core::RobotModelConstPtr& model)
   : KinematicConstraint(model), robot_model_{ model }
 {
@@ -801,6 +1191,8 @@ void VisibilityConstraint::clear()
 {
   target_frame_id_ = "";
   sensor_frame_id_ = "";
+  target_frame_link_ = nullptr;
+  sensor_frame_link_ = nullptr;
   sensor_pose_ = Eigen::Isometry3d::Identity();
   sensor_view_direction_ = 0;
   target_pose_ = Eigen::Isometry3d::Identity();
@@ -809,6 +1201,8 @@ void VisibilityConstraint::clear()
   target_radius_ = -1.0;
   max_view_angle_ = 0.0;
   max_range_angle_ = 0.0;
+  link_spheres_.clear();
+  cone_cache_.reset();
 }
 
 bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstraint& vc,
@@ -853,6 +1247,7 @@ bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstrain
   else
   {
     target_frame_id_ = vc.target_pose.header.frame_id;
+    target_frame_link_ = findFrameLink(*robot_model_, target_frame_id_);
   }
 
   tf2::fromMsg(vc.sensor_pose.pose, sensor_pose_);
@@ -866,6 +1261,7 @@ bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstrain
   else
   {
     sensor_frame_id_ = vc.sensor_pose.header.frame_id;
+    sensor_frame_link_ = findFrameLink(*robot_model_, sensor_frame_id_);
   }
 
   if (vc.weight <= std::numeric_limits<double>::epsilon())
@@ -880,6 +1276,18 @@ bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstrain
   max_range_angle_ = vc.max_range_angle;
   sensor_view_direction_ = vc.sensor_view_direction;
 
+  // contacts of the cone with the sensor and target links are accepted by decideContact(), so only the other links
+  // with collision geometry can violate the constraint
+  for (const moveit::core::LinkModel* link : robot_model_->getLinkModelsWithCollisionGeometry())
+  {
+    if (moveit::core::Transforms::sameFrame(link->getName(), sensor_frame_id_) ||
+        moveit::core::Transforms::sameFrame(link->getName(), target_frame_id_))
+      continue;
+    link_spheres_.push_back(
+        LinkSphere{ link, link->getCenteredBoundingBoxOffset(), 0.5 * link->getShapeExtentsAtOrigin().norm() });
+  }
+  cone_cache_ = std::make_shared<ConeCollisionCache>();
+
   return enabled();
 }
 
@@ -1070,9 +1478,11 @@ ConstraintEvaluationResult VisibilityConstraint::decide(const moveit::core::Robo
 {
   // getFrameTransform() returns a valid isometry by contract
   // sensor_pose_ is valid isometry (checked in configure())
-  const Eigen::Isometry3d& tform_world_to_sensor = state.getFrameTransform(sensor_frame_id_) * sensor_pose_;
+  const Eigen::Isometry3d& tform_world_to_sensor =
+      getFrameTransform(state, sensor_frame_link_, sensor_frame_id_) * sensor_pose_;
   // target_pose_ is valid isometry (checked in configure())
-  const Eigen::Isometry3d& tform_world_to_target = state.getFrameTransform(target_frame_id_) * target_pose_;
+  const Eigen::Isometry3d& tform_world_to_target =
+      getFrameTransform(state, target_frame_link_, target_frame_id_) * target_pose_;
 
   // necessary to do subtraction as SENSOR_Z is 0 and SENSOR_X is 2
   const Eigen::Vector3d& sensor_view_axis = tform_world_to_sensor.linear().col(2 - sensor_view_direction_);
@@ -1138,17 +1548,33 @@ ConstraintEvaluationResult VisibilityConstraint::decide(const moveit::core::Robo
   // Check visibility cone collision constraint
   if (target_radius_ > std::numeric_limits<double>::epsilon())
   {
-    shapes::Mesh* m = getVisibilityCone(tform_world_to_sensor, tform_world_to_target);
-    if (!m)
+    // most states keep the robot well away from the cone, which bounding spheres show without a collision check
+    if (!verbose && !coneMayTouchRobot(state, tform_world_to_sensor, tform_world_to_target))
+      return ConstraintEvaluationResult(true, 0.0);
+
+    const ConeCollisionCache::Lease lease = cone_cache_->acquire(robot_model_);
+    ConeCollisionCache::Entry& entry = *lease;
+    const collision_detection::WorldPtr& world = entry.env->getWorld();
+
+    // the cone in the sensor frame only changes when the target moves relative to the sensor
+    const Eigen::Isometry3d sensor_to_target = tform_world_to_sensor.inverse() * tform_world_to_target;
+    if (!entry.cone || !entry.sensor_to_target.isApprox(sensor_to_target, CONE_CACHE_TOLERANCE))
     {
-      RCLCPP_ERROR(getLogger(),
-                   "Visibility constraint is violated because we could not create the visibility cone mesh.");
-      return ConstraintEvaluationResult(false, 0.0);
+      shapes::Mesh* m = getVisibilityCone(Eigen::Isometry3d::Identity(), sensor_to_target);
+      if (!m)
+      {
+        RCLCPP_ERROR(getLogger(),
+                     "Visibility constraint is violated because we could not create the visibility cone mesh.");
+        return ConstraintEvaluationResult(false, 0.0);
+      }
+      if (entry.cone)
+        world->removeObject("cone");
+      entry.cone.reset(m);
+      entry.sensor_to_target = sensor_to_target;
+      world->addToObject("cone", tform_world_to_sensor, entry.cone, Eigen::Isometry3d::Identity());
     }
-
-    // add the visibility cone as an object
-    const auto collision_env_local = std::make_shared<collision_detection::CollisionEnvFCL>(robot_model_);
-    collision_env_local->getWorld()->addToObject("cone", shapes::ShapeConstPtr(m), Eigen::Isometry3d::Identity());
+    else
+      world->setObjectPose("cone", tform_world_to_sensor);
 
     // check for collisions between the robot and the cone
     collision_detection::AllowedCollisionMatrix acm;
@@ -1163,18 +1589,16 @@ ConstraintEvaluationResult VisibilityConstraint::decide(const moveit::core::Robo
     req.max_contacts = 1;
 
     collision_detection::CollisionResult res;
-    collision_env_local->checkRobotCollision(req, res, state, acm);
+    entry.env->checkRobotCollision(req, res, state, acm);
 
     if (verbose)
     {
       std::stringstream ss;
-      m->print(ss);
+      entry.cone->print(ss);
       RCLCPP_INFO(getLogger(), "Visibility constraint %ssatisfied. Visibility cone approximation:\n %s",
                   res.collision ? "not " : "", ss.str().c_str());
     }
 
-    collision_env_local->getWorld()->removeObject("cone");
-
     return ConstraintEvaluationResult(!res.collision, res.collision ? res.contacts.begin()->second.front().depth : 0.0);
   }
 
@@ -1182,6 +1606,39 @@ ConstraintEvaluationResult VisibilityConstraint::decide(const moveit::core::Robo
   return ConstraintEvaluationResult(true, 0.0);
 }
 
+bool VisibilityConstraint::coneMayTouchRobot(const moveit::core::RobotState& state,
+                                             const Eigen::Isometry3d& tform_world_to_sensor,
+                                             const Eigen::Isometry3d& tform_world_to_target) const
+{
+  // the solid circular cone with the apex at the sensor and the target disc as its base contains the cone mesh
+  const Eigen::Vector3d& apex = tform_world_to_sensor.translation();
+  const Eigen::Vector3d axis = tform_world_to_target.translation() - apex;
+  const double length = axis.norm();
+  if (length <= std::numeric_limits<double>::epsilon())
+    return true;
+  const Eigen::Vector3d direction = axis / length;
+  const double slant = std::hypot(length, target_radius_);
+  const double cos_half_angle = length / slant;
+  const double sin_half_angle = target_radius_ / slant;
+
+  for (const LinkSphere& sphere : link_spheres_)
+  {
+    const Eigen::Vector3d v = state.getGlobalLinkTransform(sphere.link_model) * sphere.center - apex;
+    const double t = v.dot(direction);
+    // beyond the base of the cone
+    if (t > length + sphere.radius)
+      continue;
+    const double d = std::sqrt(std::max(0.0, v.squaredNorm() - t * t));
+    // the distance to the infinite cone is a lower bound of the distance to the finite one: behind the apex it is the
+    // distance to the apex, elsewhere the signed distance to the lateral surface
+    const double distance =
+        d * sin_half_angle + t * cos_half_angle < 0.0 ? v.norm() : d * cos_half_angle - t * sin_half_angle;
+    if (distance <= sphere.radius)
+      return true;
+  }
+  return false;
+}
+
 bool VisibilityConstraint::decideContact(const collision_detection::Contact& contact) const
 {
   if (contact.body_type_1 == collision_detection::BodyTypes::ROBOT_ATTACHED ||
@@ -1226,6 +1683,161 @@ void KinematicConstraintSet::clear()
   position_constraints_.clear();
   orientation_constraints_.clear();
   visibility_constraints_.clear();
+  compile();
+}
+
+void KinematicConstraintSet::CompiledJointConstraints::clear()
+{
+  variable_indices.clear();
+  desired_positions.clear();
+  upper_tolerances.clear();
+  lower_tolerances.clear();
+}
+
+void KinematicConstraintSet::CompiledJointConstraints::add(const JointConstraint& constraint)
+{
+  // the same margins as in JointConstraint::decide()
+  variable_indices.push_back(constraint.getJointVariableIndex());
+  desired_positions.push_back(constraint.getDesiredJointPosition());
+  upper_tolerances.push_back(constraint.getJointToleranceAbove() + 2.0 * std::numeric_limits<double>::epsilon());
+  lower_tolerances.push_back(-constraint.getJointToleranceBelow() - 2.0 * std::numeric_limits<double>::epsilon());
+}
+
+void KinematicConstraintSet::compile()
+{
+  compiled_joints_.clear();
+  compiled_continuous_joints_.clear();
+  compiled_positions_.clear();
+  remaining_constraints_.clear();
+
+  // disabled constraints are always satisfied, so they are skipped
+  std::vector<const KinematicConstraint*> orientation_constraints, mobile_position_constraints, visibility_constraints;
+  for (const KinematicConstraintPtr& kinematic_constraint : kinematic_constraints_)
+  {
+    if (!kinematic_constraint->enabled())
+      continue;
+    switch (kinematic_constraint->getType())
+    {
+      case KinematicConstraint::JOINT_CONSTRAINT:
+      {
+        const JointConstraint& jc = static_cast<const JointConstraint&>(*kinematic_constraint);
+        if (jc.isContinuous())
+          compiled_continuous_joints_.add(jc);
+        else
+          compiled_joints_.add(jc);
+        break;
+      }
+      case KinematicConstraint::POSITION_CONSTRAINT:
+      {
+        const PositionConstraint& pc = static_cast<const PositionConstraint&>(*kinematic_constraint);
+        if (pc.mobileReferenceFrame())
+        {
+          mobile_position_constraints.push_back(&pc);
+          break;
+        }
+        compiled_positions_.push_back(CompiledPositionConstraint{ pc.getLinkModel(), pc.getLinkOffset(), &pc });
+        break;
+      }
+      case KinematicConstraint::ORIENTATION_CONSTRAINT:
+        orientation_constraints.push_back(kinematic_constraint.get());
+        break;
+      default:
+        visibility_constraints.push_back(kinematic_constraint.get());
+        break;
+    }
+  }
+  // orientation errors are cheaper than resolving mobile frames, visibility constraints need a collision check
+  remaining_constraints_ = std::move(orientation_constraints);
+  remaining_constraints_.insert(remaining_constraints_.end(), mobile_position_constraints.begin(),
+                                mobile_position_constraints.end());
+  remaining_constraints_.insert(remaining_constraints_.end(), visibility_constraints.begin(),
+                                visibility_constraints.end());
+}
+
+bool KinematicConstraintSet::jointConstraintsSatisfied(const moveit::core::RobotState& state) const
+{
+  const double* positions = state.getVariablePositions();
+  const CompiledJointConstraints& joints = compiled_joints_;
+  for (std::size_t i = 0; i < joints.variable_indices.size(); ++i)
+  {
+    const double dif = positions[joints.variable_indices[i]] - joints.desired_positions[i];
+    if (dif > joints.upper_tolerances[i] || dif < joints.lower_tolerances[i])
+      return false;
+  }
+  const CompiledJointConstraints& continuous = compiled_continuous_joints_;
+  for (std::size_t i = 0; i < continuous.variable_indices.size(); ++i)
+  {
+    const double dif =
+        continuousJointDistance(positions[continuous.variable_indices[i]], continuous.desired_positions[i]);
+    if (dif > continuous.upper_tolerances[i] || dif < continuous.lower_tolerances[i])
+      return false;
+  }
+  return true;
+}
+
+bool KinematicConstraintSet::linkConstraintsSatisfied(const moveit::core::RobotState& state) const
+{
+  for (const CompiledPositionConstraint& position : compiled_positions_)
+  {
+    const Eigen::Vector3d pt = state.getGlobalLinkTransform(position.link_model) * position.offset;
+    if (position.constraint->findContainingRegion(pt) < 0)
+      return false;
+  }
+  for (const KinematicConstraint* kinematic_constraint : remaining_constraints_)
+  {
+    if (!kinematic_constraint->decide(state).satisfied)
+      return false;
+  }
+  return true;
+}
+
+bool KinematicConstraintSet::isSatisfied(const moveit::core::RobotState& state, bool verbose) const
+{
+  if (verbose)
+    return decide(state, true).satisfied;
+  return jointConstraintsSatisfied(state) && linkConstraintsSatisfied(state);
+}
+
+std::size_t KinematicConstraintSet::decide(const std::vector<const moveit::core::RobotState*>& states,
+                                           std::vector<bool>& satisfied) const
+{
+  satisfied.assign(states.size(), true);
+
+  // one joint constraint at a time over all states, without branching on the outcome
+  const CompiledJointConstraints& joints = compiled_joints_;
+  for (std::size_t i = 0; i < joints.variable_indices.size(); ++i)
+  {
+    const int index = joints.variable_indices[i];
+    const double desired = joints.desired_positions[i];
+    const double upper = joints.upper_tolerances[i];
+    const double lower = joints.lower_tolerances[i];
+    for (std::size_t s = 0; s < states.size(); ++s)
+    {
+      const double dif = states[s]->getVariablePosition(index) - desired;
+      satisfied[s] = satisfied[s] & (dif <= upper) & (dif >= lower);
+    }
+  }
+  const CompiledJointConstraints& continuous = compiled_continuous_joints_;
+  for (std::size_t i = 0; i < continuous.variable_indices.size(); ++i)
+  {
+    for (std::size_t s = 0; s < states.size(); ++s)
+    {
+      const double dif = continuousJointDistance(states[s]->getVariablePosition(continuous.variable_indices[i]),
+                                                 continuous.desired_positions[i]);
+      satisfied[s] = satisfied[s] & (dif <= continuous.upper_tolerances[i]) & (dif >= continuous.lower_tolerances[i]);
+    }
+  }
+
+  // link transforms only for the states surviving the joint constraints
+  std::size_t count = 0;
+  for (std::size_t s = 0; s < states.size(); ++s)
+  {
+    if (satisfied[s])
+      satisfied[s] = linkConstraintsSatisfied(*states[s]);
+    if (satisfied[s])
+      ++count;
+  }
+  return count;
 }
 
 bool KinematicConstraintSet::add(const std::vector<moveit_msgs::msg::JointConstraint>& jc)
@@ -1240,6 +1852,7 @@ bool KinematicConstraintSet::add(const std::vector<moveit_msgs::msg::JointConstr
     joint_constraints_.push_back(joint_constraint);
     all_constraints_.joint_constraints.push_back(joint_constraint);
   }
+  compile();
   return result;
 }
 
@@ -1256,6 +1869,7 @@ bool KinematicConstraintSet::add(const std::vector<moveit_msgs::msg::PositionCon
     position_constraints_.push_back(position_constraint);
     all_constraints_.position_constraints.push_back(position_constraint);
   }
+  compile();
   return result;
 }
 
@@ -1272,6 +1886,7 @@ bool KinematicConstraintSet::add(const std::vector<moveit_msgs::msg::Orientation
     orientation_constraints_.push_back(orientation_constraint);
     all_constraints_.orientation_constraints.push_back(orientation_constraint);
   }
+  compile();
   return result;
 }
 
@@ -1288,6 +1903,7 @@ bool KinematicConstraintSet::add(const std::vector<moveit_msgs::msg::VisibilityC
     visibility_constraints_.push_back(visibility_constraint);
     all_constraints_.visibility_constraints.push_back(visibility_constraint);
   }
+  compile();
   return result;
 }
 
@@ -1329,6 +1945,23 @@ ConstraintEvaluationResult KinematicConstraintSet::decide(const moveit::core::Ro
   return result;
 }
 
+bool KinematicConstraintSet::computeDistanceGradient(const moveit::core::RobotState& state,
+                                                     const moveit::core::JointModelGroup* group,
+                                                     Eigen::VectorXd& gradient) const
+{
+  gradient.setZero(group->getVariableCount());
+  Eigen::VectorXd constraint_gradient;
+  for (const KinematicConstraintPtr& kinematic_constraint : kinematic_constraints_)
+  {
+    if (!kinematic_constraint->enabled())
+      continue;
+    if (!kinematic_constraint->computeDistanceGradient(state, group, constraint_gradient))
+      return false;
+    gradient += constraint_gradient;
+  }
+  return true;
+}
+
 void KinematicConstraintSet::print(std::ostream& out) const
 {
   out << kinematic_constraints_.size() << " kinematic constraints" << '\n';
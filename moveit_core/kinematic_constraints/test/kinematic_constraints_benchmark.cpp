@@ -0,0 +1,296 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// To run this benchmark, 'cd' to the build/moveit_core/kinematic_constraints directory and directly run the binary.
+// Benchmarks on real robots take the robot as first argument, 0 for the panda arm and 1 for the right arm of the pr2.
+// Select a subset with e.g. --benchmark_filter='decideConstraint/orientation'.
+
+#include <benchmark/benchmark.h>
+#include <moveit/kinematic_constraints/kinematic_constraint.hpp>
+#include <moveit/kinematic_constraints/utils.hpp>
+#include <moveit/robot_model/robot_model.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <moveit/transforms/transforms.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+#include <tf2_eigen/tf2_eigen.hpp>
+
+namespace
+{
+// Number of random states the constraints are evaluated on, cycled through by the benchmarks
+constexpr std::size_t STATE_COUNT = 100;
+
+enum class ConstraintType
+{
+  JOINT,
+  POSITION,
+  ORIENTATION,
+  VISIBILITY,
+  MIXED
+};
+
+// A robot model, a planning group with its tip link, and random states of the group
+struct BenchmarkRobot
+{
+  moveit::core::RobotModelPtr robot_model;
+  const moveit::core::JointModelGroup* group = nullptr;
+  std::string tip_link;
+  std::vector<moveit::core::RobotState> states;
+};
+
+bool loadRobot(int robot_index, BenchmarkRobot& robot)
+{
+  robot.robot_model = moveit::core::loadTestingRobotModel(robot_index == 1 ? "pr2" : "panda");
+  const char* group_name = robot_index == 1 ? "right_arm" : "panda_arm";
+  robot.tip_link = robot_index == 1 ? "r_wrist_roll_link" : "panda_link8";
+  if (!robot.robot_model || !robot.robot_model->hasJointModelGroup(group_name) ||
+      !robot.robot_model->hasLinkModel(robot.tip_link))
+    return false;
+  robot.group = robot.robot_model->getJointModelGroup(group_name);
+
+  moveit::core::RobotState state(robot.robot_model);
+  state.setToDefaultValues();
+  random_numbers::RandomNumberGenerator rng(0);
+  robot.states.assign(STATE_COUNT, state);
+  for (moveit::core::RobotState& random_state : robot.states)
+  {
+    random_state.setToRandomPositions(robot.group, rng);
+    random_state.update();
+  }
+  return true;
+}
+
+geometry_msgs::msg::PoseStamped tipPose(const BenchmarkRobot& robot, const moveit::core::RobotState& state)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header.frame_id = robot.robot_model->getModelFrame();
+  pose.pose = tf2::toMsg(state.getGlobalLinkTransform(robot.tip_link));
+  return pose;
+}
+
+// Constraints of the given type, centered at the first state but wide enough to be satisfied by most random states,
+// such that the evaluation doesn't stop early
+moveit_msgs::msg::Constraints createConstraints(const BenchmarkRobot& robot, ConstraintType type)
+{
+  const moveit::core::RobotState& state = robot.states.front();
+  moveit_msgs::msg::Constraints constraints;
+  if (type == ConstraintType::JOINT || type == ConstraintType::MIXED)
+  {
+    constraints = kinematic_constraints::mergeConstraints(
+        constraints, kinematic_constraints::constructGoalConstraints(state, robot.group, M_PI, M_PI));
+  }
+  if (type == ConstraintType::POSITION || type == ConstraintType::ORIENTATION || type == ConstraintType::MIXED)
+  {
+    moveit_msgs::msg::Constraints pose_constraints =
+        kinematic_constraints::constructGoalConstraints(robot.tip_link, tipPose(robot, state), 1.0, M_PI);
+    if (type == ConstraintType::POSITION)
+      pose_constraints.orientation_constraints.clear();
+    else if (type == ConstraintType::ORIENTATION)
+      pose_constraints.position_constraints.clear();
+    constraints = kinematic_constraints::mergeConstraints(constraints, pose_constraints);
+  }
+  if (type == ConstraintType::VISIBILITY || type == ConstraintType::MIXED)
+  {
+    // the head camera of the pr2 looking at the gripper
+    moveit_msgs::msg::VisibilityConstraint vcm;
+    vcm.sensor_pose.header.frame_id = "narrow_stereo_optical_frame";
+    vcm.sensor_pose.pose.position.z = 0.05;
+    vcm.sensor_pose.pose.orientation.w = 1.0;
+    vcm.target_pose.header.frame_id = "r_gripper_palm_link";
+    vcm.target_pose.pose.orientation.w = 1.0;
+    vcm.target_radius = 0.05;
+    vcm.cone_sides = 10;
+    vcm.sensor_view_direction = moveit_msgs::msg::VisibilityConstraint::SENSOR_Z;
+    vcm.weight = 1.0;
+    if (robot.robot_model->hasLinkModel(vcm.sensor_pose.header.frame_id))
+      constraints.visibility_constraints.push_back(vcm);
+  }
+  return constraints;
+}
+
+void robotsAndTypes(benchmark::internal::Benchmark* benchmark)
+{
+  for (int robot_index : { 0, 1 })
+  {
+    for (ConstraintType type : { ConstraintType::JOINT, ConstraintType::POSITION, ConstraintType::ORIENTATION,
+                                 ConstraintType::MIXED })
+      benchmark->Args({ robot_index, static_cast<int>(type) });
+  }
+  // only the pr2 has a sensor frame
+  benchmark->Args({ 1, static_cast<int>(ConstraintType::VISIBILITY) });
+}
+}  // namespace
+
+// Benchmark decide() of a constraint set holding constraints of one type, or of all types for the mixed set
+static void decideConstraintSet(benchmark::State& st)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(0), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  kinematic_constraints::KinematicConstraintSet constraint_set(robot.robot_model);
+  const moveit::core::Transforms tf(robot.robot_model->getModelFrame());
+  const moveit_msgs::msg::Constraints constraints = createConstraints(robot, static_cast<ConstraintType>(st.range(1)));
+  if (!constraint_set.add(constraints, tf))
+  {
+    st.SkipWithError("Failed to configure the constraints.");
+    return;
+  }
+
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    benchmark::DoNotOptimize(constraint_set.decide(robot.states[i]));
+    i = (i + 1) % STATE_COUNT;
+  }
+  st.counters["constraints"] = static_cast<double>(kinematic_constraints::countIndividualConstraints(constraints));
+}
+
+// Benchmark isSatisfied() of a constraint set, which skips the distance computation and stops at the first violation
+static void isSatisfiedConstraintSet(benchmark::State& st)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(0), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  kinematic_constraints::KinematicConstraintSet constraint_set(robot.robot_model);
+  const moveit::core::Transforms tf(robot.robot_model->getModelFrame());
+  if (!constraint_set.add(createConstraints(robot, static_cast<ConstraintType>(st.range(1))), tf))
+  {
+    st.SkipWithError("Failed to configure the constraints.");
+    return;
+  }
+
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    benchmark::DoNotOptimize(constraint_set.isSatisfied(robot.states[i]));
+    i = (i + 1) % STATE_COUNT;
+  }
+}
+
+// Benchmark configuring a constraint set from a message, as done for every planning request
+static void configureConstraintSet(benchmark::State& st)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(0), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  const moveit::core::Transforms tf(robot.robot_model->getModelFrame());
+  const moveit_msgs::msg::Constraints constraints = createConstraints(robot, static_cast<ConstraintType>(st.range(1)));
+
+  for (auto _ : st)
+  {
+    kinematic_constraints::KinematicConstraintSet constraint_set(robot.robot_model);
+    if (!constraint_set.add(constraints, tf))
+    {
+      st.SkipWithError("Failed to configure the constraints.");
+      return;
+    }
+    benchmark::DoNotOptimize(constraint_set);
+  }
+}
+
+// Benchmark constructing joint goal constraints of the planning group from a state
+static void constructJointGoalConstraints(benchmark::State& st)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(0), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    benchmark::DoNotOptimize(kinematic_constraints::constructGoalConstraints(robot.states[i], robot.group, 1e-3));
+    i = (i + 1) % STATE_COUNT;
+  }
+}
+
+// Benchmark constructing pose goal constraints of the tip link
+static void constructPoseGoalConstraints(benchmark::State& st)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(0), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  std::vector<geometry_msgs::msg::PoseStamped> poses;
+  for (const moveit::core::RobotState& state : robot.states)
+    poses.push_back(tipPose(robot, state));
+
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    benchmark::DoNotOptimize(kinematic_constraints::constructGoalConstraints(robot.tip_link, poses[i]));
+    i = (i + 1) % STATE_COUNT;
+  }
+}
+
+// Benchmark merging two synthetic sets of the given number of joint constraints, half of them on the same joints
+static void mergeJointConstraints(benchmark::State& st)
+{
+  const int n_constraints = st.range(0);
+  moveit_msgs::msg::Constraints first, second;
+  for (int i = 0; i < n_constraints; ++i)
+  {
+    moveit_msgs::msg::JointConstraint jc;
+    jc.joint_name = "joint_" + std::to_string(i);
+    jc.position = 0.1 * i;
+    jc.tolerance_above = jc.tolerance_below = 0.5;
+    jc.weight = 1.0;
+    first.joint_constraints.push_back(jc);
+    jc.joint_name = "joint_" + std::to_string(i + n_constraints / 2);
+    jc.position += 0.2;
+    second.joint_constraints.push_back(jc);
+  }
+
+  for (auto _ : st)
+    benchmark::DoNotOptimize(kinematic_constraints::mergeConstraints(first, second));
+}
+
+BENCHMARK(decideConstraintSet)->Apply(robotsAndTypes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(isSatisfiedConstraintSet)->Apply(robotsAndTypes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(configureConstraintSet)->Apply(robotsAndTypes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(constructJointGoalConstraints)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(constructPoseGoalConstraints)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(mergeJointConstraints)->RangeMultiplier(10)->Range(10, 1000)->Unit(benchmark::kMicrosecond);
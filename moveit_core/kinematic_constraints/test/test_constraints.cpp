@@ -40,6 +40,7 @@
 #include <fstream>
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <math.h>
+#include <random>
 #include <moveit/utils/robot_model_test_utils.hpp>
 
 class LoadPlanningModelsPr2 : public testing::Test
@@ -508,6 +509,89 @@ TEST_F(LoadPlanningModelsPr2, PositionConstraintsMobile)
   EXPECT_TRUE(pc.decide(robot_state, false).satisfied);
 }
 
+TEST_F(LoadPlanningModelsPr2, PositionConstraintsManyRegions)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update(true);
+  moveit::core::Transforms tf(robot_model_->getModelFrame());
+  const Eigen::Vector3d wrist_position = robot_state.getGlobalLinkTransform("l_wrist_roll_link").translation();
+
+  // a row of overlapping boxes, ending with a large box containing all the others
+  moveit_msgs::msg::PositionConstraint pcm;
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.link_name = "l_wrist_roll_link";
+  pcm.weight = 1.0;
+  const std::size_t num_boxes = 40;
+  for (std::size_t i = 0; i <= num_boxes; ++i)
+  {
+    shape_msgs::msg::SolidPrimitive box;
+    box.type = shape_msgs::msg::SolidPrimitive::BOX;
+    box.dimensions = i < num_boxes ? std::vector<double>{ 0.12, 0.1, 0.1 } : std::vector<double>{ 5.0, 0.3, 0.3 };
+    geometry_msgs::msg::Pose pose;
+    pose.position.x = wrist_position.x() + (i < num_boxes ? 0.1 * (static_cast<double>(i) - 25.0) : 0.0);
+    pose.position.y = wrist_position.y();
+    pose.position.z = wrist_position.z();
+    pose.orientation.w = 1.0;
+    pcm.constraint_region.primitives.push_back(box);
+    pcm.constraint_region.primitive_poses.push_back(pose);
+  }
+
+  kinematic_constraints::PositionConstraint pc(robot_model_);
+  ASSERT_TRUE(pc.configure(pcm, tf));
+  const std::vector<bodies::BodyPtr>& regions = pc.getConstraintRegions();
+  ASSERT_EQ(regions.size(), num_boxes + 1);
+
+  // the hierarchy finds the same first region as a linear search
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> dx(-3.0, 3.0);
+  std::uniform_real_distribution<double> dyz(-0.2, 0.2);
+  int inside = 0;
+  for (int i = 0; i < 2000; ++i)
+  {
+    const Eigen::Vector3d point = wrist_position + Eigen::Vector3d(dx(generator), dyz(generator), dyz(generator));
+    int expected = -1;
+    for (std::size_t j = 0; expected < 0 && j < regions.size(); ++j)
+    {
+      if (regions[j]->containsPoint(point))
+        expected = static_cast<int>(j);
+    }
+    EXPECT_EQ(pc.findContainingRegion(point), expected);
+    if (expected >= 0)
+      ++inside;
+  }
+  EXPECT_GT(inside, 0);
+
+  // the wrist is inside the box with index 25, then outside all of them
+  kinematic_constraints::ConstraintEvaluationResult result = pc.decide(robot_state);
+  EXPECT_TRUE(result.satisfied);
+  EXPECT_NEAR(result.distance, 0.0, 1e-9);
+  EXPECT_EQ(pc.findContainingRegion(wrist_position), 25);
+
+  robot_state.setVariablePosition("torso_lift_joint", 0.3);
+  robot_state.update(true);
+  result = pc.decide(robot_state);
+  EXPECT_FALSE(result.satisfied);
+  // the verbose check searches linearly
+  const kinematic_constraints::ConstraintEvaluationResult verbose_result = pc.decide(robot_state, true);
+  EXPECT_FALSE(verbose_result.satisfied);
+  EXPECT_NEAR(result.distance, verbose_result.distance, 1e-9);
+
+  // the same regions in a mobile frame, which coincides with the model frame in the default state
+  pcm.header.frame_id = "base_footprint";
+  ASSERT_TRUE(pc.configure(pcm, tf));
+  ASSERT_TRUE(pc.mobileReferenceFrame());
+  robot_state.setToDefaultValues();
+  robot_state.update(true);
+  result = pc.decide(robot_state);
+  EXPECT_TRUE(result.satisfied);
+  robot_state.setVariablePosition("torso_lift_joint", 0.3);
+  robot_state.update(true);
+  result = pc.decide(robot_state);
+  EXPECT_FALSE(result.satisfied);
+  EXPECT_NEAR(result.distance, pc.decide(robot_state, true).distance, 1e-9);
+}
+
 TEST_F(LoadPlanningModelsPr2, PositionConstraintsEquality)
 {
   moveit::core::RobotState robot_state(robot_model_);
@@ -789,6 +873,58 @@ TEST_F(LoadPlanningModelsPr2, VisibilityConstraintsPR2)
   EXPECT_FALSE(vc.decide(robot_state, true).satisfied);
 }
 
+TEST_F(LoadPlanningModelsPr2, VisibilityConstraintsFastPath)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+  moveit::core::Transforms tf(robot_model_->getModelFrame());
+
+  kinematic_constraints::VisibilityConstraint vc(robot_model_);
+  moveit_msgs::msg::VisibilityConstraint vcm;
+  vcm.sensor_pose.header.frame_id = "narrow_stereo_optical_frame";
+  vcm.sensor_pose.pose.position.z = 0.05;
+  vcm.sensor_pose.pose.orientation.w = 1.0;
+  vcm.target_pose.header.frame_id = "l_gripper_r_finger_tip_link";
+  vcm.target_pose.pose.position.z = 0.03;
+  vcm.target_pose.pose.orientation.w = 1.0;
+  vcm.target_radius = .05;
+  vcm.cone_sides = 10;
+  vcm.sensor_view_direction = moveit_msgs::msg::VisibilityConstraint::SENSOR_Z;
+  vcm.weight = 1.0;
+  ASSERT_TRUE(vc.configure(vcm, tf));
+
+  // the bounding sphere test and the cached cone agree with the verbose evaluation, which rebuilds the cone
+  std::map<std::string, double> state_values;
+  state_values["l_shoulder_lift_joint"] = .5;
+  state_values["r_shoulder_pan_joint"] = .5;
+  state_values["r_elbow_flex_joint"] = -1.4;
+  robot_state.setVariablePositions(state_values);
+  robot_state.update();
+  EXPECT_FALSE(vc.decide(robot_state).satisfied);
+  EXPECT_FALSE(vc.decide(robot_state).satisfied);
+
+  state_values["r_shoulder_pan_joint"] = .4;
+  robot_state.setVariablePositions(state_values);
+  robot_state.update();
+  EXPECT_TRUE(vc.decide(robot_state).satisfied);
+
+  const moveit::core::JointModelGroup* right_arm = robot_model_->getJointModelGroup("right_arm");
+  ASSERT_TRUE(right_arm);
+  random_numbers::RandomNumberGenerator rng(11);
+  int violated = 0;
+  for (int i = 0; i < 100; ++i)
+  {
+    robot_state.setToRandomPositions(right_arm, rng);
+    robot_state.update();
+    const bool expected = vc.decide(robot_state, true).satisfied;
+    EXPECT_EQ(vc.decide(robot_state).satisfied, expected);
+    if (!expected)
+      ++violated;
+  }
+  EXPECT_LT(violated, 100);
+}
+
 TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSet)
 {
   moveit::core::RobotState robot_state(robot_model_);
@@ -855,6 +991,212 @@ TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSet)
   EXPECT_FALSE(kcs.decide(robot_state).satisfied);
 }
 
+TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSetCompiled)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+  moveit::core::Transforms tf(robot_model_->getModelFrame());
+
+  moveit_msgs::msg::Constraints constraints;
+  constraints.joint_constraints.resize(2);
+  constraints.joint_constraints[0].joint_name = "head_pan_joint";
+  constraints.joint_constraints[0].position = 0.4;
+  constraints.joint_constraints[0].tolerance_above = 0.1;
+  constraints.joint_constraints[0].tolerance_below = 0.05;
+  constraints.joint_constraints[0].weight = 1.0;
+  // a continuous joint
+  constraints.joint_constraints[1].joint_name = "l_wrist_roll_joint";
+  constraints.joint_constraints[1].position = 3.0;
+  constraints.joint_constraints[1].tolerance_above = 0.5;
+  constraints.joint_constraints[1].tolerance_below = 0.5;
+  constraints.joint_constraints[1].weight = 1.0;
+
+  // a sphere around the default position of the left wrist
+  const Eigen::Vector3d wrist_position = robot_state.getGlobalLinkTransform("l_wrist_roll_link").translation();
+  constraints.position_constraints.resize(1);
+  moveit_msgs::msg::PositionConstraint& pcm = constraints.position_constraints[0];
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.link_name = "l_wrist_roll_link";
+  pcm.constraint_region.primitives.resize(1);
+  pcm.constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  pcm.constraint_region.primitives[0].dimensions.resize(1);
+  pcm.constraint_region.primitives[0].dimensions[0] = 0.2;
+  pcm.constraint_region.primitive_poses.resize(1);
+  pcm.constraint_region.primitive_poses[0].position = tf2::toMsg(wrist_position);
+  pcm.constraint_region.primitive_poses[0].orientation.w = 1.0;
+  pcm.weight = 1.0;
+
+  // the default orientation of the right wrist
+  constraints.orientation_constraints.resize(1);
+  moveit_msgs::msg::OrientationConstraint& ocm = constraints.orientation_constraints[0];
+  ocm.header.frame_id = robot_model_->getModelFrame();
+  ocm.link_name = "r_wrist_roll_link";
+  ocm.orientation = tf2::toMsg(Eigen::Quaterniond(robot_state.getGlobalLinkTransform("r_wrist_roll_link").linear()));
+  ocm.absolute_x_axis_tolerance = 0.3;
+  ocm.absolute_y_axis_tolerance = 0.3;
+  ocm.absolute_z_axis_tolerance = 0.3;
+  ocm.weight = 1.0;
+
+  kinematic_constraints::KinematicConstraintSet kcs(robot_model_);
+  EXPECT_TRUE(kcs.add(constraints, tf));
+
+  // the compiled evaluation agrees with decide() on states scattered around the constraint boundaries
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> head_pan(0.2, 0.6);
+  std::uniform_real_distribution<double> wrist_roll(-M_PI, M_PI);
+  std::uniform_real_distribution<double> shoulder_pan(-0.6, 0.6);
+  std::uniform_real_distribution<double> forearm_roll(-0.6, 0.6);
+  std::vector<moveit::core::RobotState> states;
+  for (int i = 0; i < 500; ++i)
+  {
+    robot_state.setVariablePosition("head_pan_joint", head_pan(generator));
+    robot_state.setVariablePosition("l_wrist_roll_joint", wrist_roll(generator));
+    robot_state.setVariablePosition("l_shoulder_pan_joint", shoulder_pan(generator));
+    robot_state.setVariablePosition("r_forearm_roll_joint", forearm_roll(generator));
+    robot_state.update();
+    states.push_back(robot_state);
+  }
+
+  std::vector<const moveit::core::RobotState*> state_ptrs;
+  std::size_t expected_count = 0;
+  for (const moveit::core::RobotState& state : states)
+  {
+    state_ptrs.push_back(&state);
+    const bool expected = kcs.decide(state).satisfied;
+    EXPECT_EQ(kcs.isSatisfied(state), expected);
+    if (expected)
+      ++expected_count;
+  }
+  EXPECT_GT(expected_count, 0u);
+  EXPECT_LT(expected_count, states.size());
+
+  std::vector<bool> satisfied;
+  EXPECT_EQ(kcs.decide(state_ptrs, satisfied), expected_count);
+  ASSERT_EQ(satisfied.size(), states.size());
+  for (std::size_t i = 0; i < states.size(); ++i)
+    EXPECT_EQ(satisfied[i], kcs.decide(states[i]).satisfied);
+
+  // an empty set is satisfied by any state
+  kcs.clear();
+  EXPECT_TRUE(kcs.isSatisfied(states.front()));
+  EXPECT_EQ(kcs.decide(state_ptrs, satisfied), states.size());
+}
+
+TEST_F(LoadPlanningModelsPr2, DistanceGradients)
+{
+  const moveit::core::JointModelGroup* group = robot_model_->getJointModelGroup("right_arm");
+  ASSERT_TRUE(group);
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  const std::vector<std::pair<std::string, double>> positions = {
+    { "r_shoulder_pan_joint", -0.3 }, { "r_shoulder_lift_joint", 0.2 }, { "r_upper_arm_roll_joint", -0.5 },
+    { "r_elbow_flex_joint", -1.0 },   { "r_forearm_roll_joint", 0.4 },  { "r_wrist_flex_joint", -0.6 },
+    { "r_wrist_roll_joint", 0.3 }
+  };
+  for (const auto& [name, position] : positions)
+    robot_state.setVariablePosition(name, position);
+  robot_state.update();
+  moveit::core::Transforms tf(robot_model_->getModelFrame());
+
+  // compare an analytic gradient against central differences of the distance reported by decide()
+  const auto expect_gradient = [&](const auto& constraint, const Eigen::VectorXd& gradient) {
+    const std::vector<int>& variable_indices = group->getVariableIndexList();
+    ASSERT_EQ(gradient.size(), static_cast<Eigen::Index>(variable_indices.size()));
+    const double h = 1e-6;
+    for (std::size_t i = 0; i < variable_indices.size(); ++i)
+    {
+      moveit::core::RobotState perturbed(robot_state);
+      const double position = robot_state.getVariablePosition(variable_indices[i]);
+      perturbed.setVariablePosition(variable_indices[i], position + h);
+      perturbed.update();
+      const double upper = constraint.decide(perturbed).distance;
+      perturbed.setVariablePosition(variable_indices[i], position - h);
+      perturbed.update();
+      const double lower = constraint.decide(perturbed).distance;
+      EXPECT_NEAR(gradient(i), (upper - lower) / (2.0 * h), 1e-5) << "variable " << i;
+    }
+  };
+
+  moveit_msgs::msg::Constraints constraints;
+  Eigen::VectorXd gradient;
+
+  moveit_msgs::msg::JointConstraint jcm;
+  jcm.joint_name = "r_elbow_flex_joint";
+  jcm.position = -0.7;
+  jcm.tolerance_above = 0.1;
+  jcm.tolerance_below = 0.1;
+  jcm.weight = 2.0;
+  kinematic_constraints::JointConstraint jc(robot_model_);
+  ASSERT_TRUE(jc.configure(jcm));
+  ASSERT_TRUE(jc.computeDistanceGradient(robot_state, group, gradient));
+  expect_gradient(jc, gradient);
+  constraints.joint_constraints.push_back(jcm);
+
+  // the wrap around of continuous joints flips the sign of the gradient
+  jcm.joint_name = "r_forearm_roll_joint";
+  jcm.position = 0.4 - 1.1 * M_PI;
+  ASSERT_TRUE(jc.configure(jcm));
+  ASSERT_TRUE(jc.computeDistanceGradient(robot_state, group, gradient));
+  expect_gradient(jc, gradient);
+
+  moveit_msgs::msg::PositionConstraint pcm;
+  pcm.header.frame_id = robot_model_->getModelFrame();
+  pcm.link_name = "r_wrist_roll_link";
+  pcm.target_point_offset.x = 0.1;
+  pcm.constraint_region.primitives.resize(1);
+  pcm.constraint_region.primitives[0].type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  pcm.constraint_region.primitives[0].dimensions = { 0.05 };
+  pcm.constraint_region.primitive_poses.resize(1);
+  pcm.constraint_region.primitive_poses[0].position.x = 0.6;
+  pcm.constraint_region.primitive_poses[0].position.y = -0.4;
+  pcm.constraint_region.primitive_poses[0].position.z = 1.0;
+  pcm.constraint_region.primitive_poses[0].orientation.w = 1.0;
+  pcm.weight = 1.0;
+  kinematic_constraints::PositionConstraint pc(robot_model_);
+  ASSERT_TRUE(pc.configure(pcm, tf));
+  ASSERT_TRUE(pc.computeDistanceGradient(robot_state, group, gradient));
+  EXPECT_GT(gradient.norm(), 0.0);
+  expect_gradient(pc, gradient);
+  constraints.position_constraints.push_back(pcm);
+
+  // a desired orientation away from the current one, such that no error component is zero
+  const Eigen::Quaterniond desired(robot_state.getGlobalLinkTransform("r_wrist_roll_link").linear() *
+                                   Eigen::AngleAxisd(0.2, Eigen::Vector3d::UnitX()) *
+                                   Eigen::AngleAxisd(-0.3, Eigen::Vector3d::UnitY()) *
+                                   Eigen::AngleAxisd(0.25, Eigen::Vector3d::UnitZ()));
+  moveit_msgs::msg::OrientationConstraint ocm;
+  ocm.header.frame_id = robot_model_->getModelFrame();
+  ocm.link_name = "r_wrist_roll_link";
+  ocm.orientation = tf2::toMsg(desired);
+  ocm.absolute_x_axis_tolerance = 0.1;
+  ocm.absolute_y_axis_tolerance = 0.1;
+  ocm.absolute_z_axis_tolerance = 0.1;
+  ocm.weight = 0.5;
+  kinematic_constraints::OrientationConstraint oc(robot_model_);
+  for (const auto type : { moveit_msgs::msg::OrientationConstraint::XYZ_EULER_ANGLES,
+                           moveit_msgs::msg::OrientationConstraint::ROTATION_VECTOR })
+  {
+    ocm.parameterization = type;
+    ASSERT_TRUE(oc.configure(ocm, tf));
+    ASSERT_TRUE(oc.computeDistanceGradient(robot_state, group, gradient));
+    EXPECT_GT(gradient.norm(), 0.0);
+    expect_gradient(oc, gradient);
+  }
+  constraints.orientation_constraints.push_back(ocm);
+
+  // the gradient of a set is the sum of its constraints' gradients
+  kinematic_constraints::KinematicConstraintSet kset(robot_model_);
+  ASSERT_TRUE(kset.add(constraints, tf));
+  ASSERT_TRUE(kset.computeDistanceGradient(robot_state, group, gradient));
+  expect_gradient(kset, gradient);
+
+  // the frame of the orientation constraint must not move with the group
+  ocm.header.frame_id = "r_elbow_flex_link";
+  ASSERT_TRUE(oc.configure(ocm, tf));
+  EXPECT_FALSE(oc.computeDistanceGradient(robot_state, group, gradient));
+}
+
 TEST_F(LoadPlanningModelsPr2, TestKinematicConstraintSetEquality)
 {
   moveit::core::RobotState robot_state(robot_model_);
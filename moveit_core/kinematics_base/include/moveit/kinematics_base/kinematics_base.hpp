@@ -41,6 +41,7 @@
 #include <moveit/macros/class_forward.hpp>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/node.hpp>
+#include <atomic>
 #include <string>
 #include <functional>
 #include <moveit/utils/logger.hpp>
@@ -113,6 +114,7 @@ struct KinematicsQueryOptions
     : lock_redundant_joints(false)
     , return_approximate_solution(false)
     , discretization_method(DiscretizationMethods::NO_DISCRETIZATION)
+    , cancel(nullptr)
   {
   }
 
@@ -120,6 +122,8 @@ struct KinematicsQueryOptions
   bool return_approximate_solution;           /**<  KinematicsQueryOptions#return_approximate_solution. */
   DiscretizationMethod discretization_method; /**<  Enumeration value that indicates the method for discretizing the
                                                     redundant. joints KinematicsQueryOptions#discretization_method. */
+  const std::atomic<bool>* cancel;            /**<  If set, searches may stop early and fail once the flag becomes
+                                                    true, e.g. because a concurrent search already succeeded. */
 };
 
 /*
@@ -200,6 +204,24 @@ public:
                              const std::vector<double>& ik_seed_state, std::vector<std::vector<double> >& solutions,
                              KinematicsResult& result, const kinematics::KinematicsQueryOptions& options) const;
 
+  /**
+   * @brief Given a desired pose of the end-effector, compute all joint solutions that are able to reach it.
+   *
+   * The solutions are stored contiguously, getJointNames().size() values each, ordered by increasing distance to
+   * the seed state. Reusing @e solutions across calls avoids allocating memory for every solution. The default
+   * implementation flattens the solutions of the multiple-solution getPositionIK().
+   *
+   * @param ik_pose The desired pose of the tip link
+   * @param ik_seed_state an initial guess solution for the inverse kinematics
+   * @param solutions The joint values of all solutions, one after the other
+   * @param result A struct that reports the results of the query
+   * @param options An option struct which contains the type of redundancy discretization used
+   * @return True if at least one solution was found, false otherwise.
+   */
+  virtual bool getPositionIKSolutions(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                                      std::vector<double>& solutions, KinematicsResult& result,
+                                      const kinematics::KinematicsQueryOptions& options) const;
+
   /**
    * @brief Given a desired pose of the end-effector, search for the joint angles required to reach it.
    * This particular method is intended for "searching" for a solution by stepping through the redundancy
@@ -368,6 +390,67 @@ public:
     return false;
   }
 
+  /**
+   * @brief Given a sequence of desired poses of a single end-effector, e.g. the waypoints of a Cartesian path, search
+   * for the joint angles reaching each of them. Each pose is seeded with the solution of the previous one.
+   *
+   * The default implementation calls searchPositionIK() for one pose after the other. Solvers that can process the
+   * whole sequence in one call, e.g. by exploiting its continuity or by solving the poses in parallel, should override
+   * this function together with supportsIKSequence().
+   * @param ik_poses the desired poses of the tip link, in the order they are reached
+   * @param ik_seed_state an initial guess solution for the inverse kinematics of the first pose
+   * @param timeout The amount of time (in seconds) available to the solver for each pose
+   * @param solutions the solutions of the leading poses that were solved, one per pose
+   * @param error_code an error code that encodes the reason for failure or success
+   * @param options container for other IK options. See definition of KinematicsQueryOptions for details.
+   * @return True if a solution was found for every pose, false otherwise
+   */
+  virtual bool searchPositionIKSequence(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                        const std::vector<double>& ik_seed_state, double timeout,
+                                        std::vector<std::vector<double> >& solutions,
+                                        moveit_msgs::msg::MoveItErrorCodes& error_code,
+                                        const kinematics::KinematicsQueryOptions& options) const;
+
+  /**
+   * @brief Check if searchPositionIKSequence() processes a sequence of poses in one call, so that callers benefit from
+   * passing all poses at once instead of solving them one by one.
+   */
+  virtual bool supportsIKSequence() const
+  {
+    return false;
+  }
+
+  /**
+   * @brief Given a batch of independent desired poses of a single end-effector, e.g. grasp candidates or the samples of
+   * a reachability study, search for the joint angles reaching each of them.
+   *
+   * The default implementation calls searchPositionIK() for one pose after the other. Solvers whose searchPositionIK()
+   * may be called concurrently override this function to process the poses in parallel with
+   * searchPositionIKBatchParallel() and report so with supportsParallelIKBatch().
+   * @param ik_poses the desired poses of the tip link
+   * @param ik_seed_states initial guess solutions, either one for all poses or one per pose
+   * @param timeout The amount of time (in seconds) available to the solver for each pose
+   * @param solutions the solutions, one per pose. Solutions of failed poses are unspecified.
+   * @param error_codes error codes that encode the reason for failure or success, one per pose
+   * @param options container for other IK options. See definition of KinematicsQueryOptions for details.
+   * @param thread_count The maximum number of threads used by parallel implementations, 0 for one per hardware thread
+   * @return True if a solution was found for every pose, false otherwise
+   */
+  virtual bool searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                     const std::vector<std::vector<double> >& ik_seed_states, double timeout,
+                                     std::vector<std::vector<double> >& solutions,
+                                     std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                     const kinematics::KinematicsQueryOptions& options = KinematicsQueryOptions(),
+                                     std::size_t thread_count = 0) const;
+
+  /**
+   * @brief Check if searchPositionIKBatch() solves the poses of a batch in parallel.
+   */
+  virtual bool supportsParallelIKBatch() const
+  {
+    return false;
+  }
+
   /**
    * @brief Given a set of joint angles and a set of links, compute their pose
    * @param link_names A set of links for which FK needs to be computed
@@ -607,6 +690,18 @@ protected:
                    const std::string& base_frame, const std::vector<std::string>& tip_frames,
                    double search_discretization);
 
+  /** Solve the poses of searchPositionIKBatch() in parallel by calling searchPositionIK() concurrently.
+   *
+   * Only use this if searchPositionIK() is thread-safe, i.e. if it does not modify shared solver state.
+   * The parameters are the same as for searchPositionIKBatch().
+   */
+  bool searchPositionIKBatchParallel(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                     const std::vector<std::vector<double> >& ik_seed_states, double timeout,
+                                     std::vector<std::vector<double> >& solutions,
+                                     std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                     const kinematics::KinematicsQueryOptions& options,
+                                     std::size_t thread_count) const;
+
 private:
   std::string removeSlash(const std::string& str) const;
 };
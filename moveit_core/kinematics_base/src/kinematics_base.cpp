@@ -39,6 +39,11 @@
 #include <rclcpp/logger.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
 namespace kinematics
 {
 namespace
@@ -161,6 +166,78 @@ KinematicsBase::KinematicsBase() : default_timeout_(DEFAULT_TIMEOUT)
 
 KinematicsBase::~KinematicsBase() = default;
 
+bool KinematicsBase::searchPositionIKSequence(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                              const std::vector<double>& ik_seed_state, double timeout,
+                                              std::vector<std::vector<double> >& solutions,
+                                              moveit_msgs::msg::MoveItErrorCodes& error_code,
+                                              const KinematicsQueryOptions& options) const
+{
+  solutions.clear();
+  solutions.reserve(ik_poses.size());
+  std::vector<double> solution;
+  for (const geometry_msgs::msg::Pose& ik_pose : ik_poses)
+  {
+    if (!searchPositionIK(ik_pose, solutions.empty() ? ik_seed_state : solutions.back(), timeout, solution, error_code,
+                          options))
+      return false;
+    solutions.push_back(solution);
+  }
+  error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+  return true;
+}
+
+bool KinematicsBase::searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                          const std::vector<std::vector<double> >& ik_seed_states, double timeout,
+                                          std::vector<std::vector<double> >& solutions,
+                                          std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                          const KinematicsQueryOptions& options, std::size_t /*thread_count*/) const
+{
+  // the solver is not known to be thread-safe, so the poses are solved by the calling thread
+  return searchPositionIKBatchParallel(ik_poses, ik_seed_states, timeout, solutions, error_codes, options, 1);
+}
+
+bool KinematicsBase::searchPositionIKBatchParallel(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                                   const std::vector<std::vector<double> >& ik_seed_states,
+                                                   double timeout, std::vector<std::vector<double> >& solutions,
+                                                   std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                                   const KinematicsQueryOptions& options,
+                                                   std::size_t thread_count) const
+{
+  solutions.assign(ik_poses.size(), std::vector<double>());
+  error_codes.assign(ik_poses.size(), moveit_msgs::msg::MoveItErrorCodes());
+  if (ik_seed_states.size() != 1 && ik_seed_states.size() != ik_poses.size())
+  {
+    RCLCPP_ERROR(getLogger(), "Expected one seed state or one per pose (%zu) instead of %zu", ik_poses.size(),
+                 ik_seed_states.size());
+    for (moveit_msgs::msg::MoveItErrorCodes& error_code : error_codes)
+      error_code.val = moveit_msgs::msg::MoveItErrorCodes::INVALID_ROBOT_STATE;
+    return false;
+  }
+
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min(thread_count, ik_poses.size());
+
+  // std::vector<bool> packs its elements, so it cannot be written concurrently
+  std::vector<char> results(ik_poses.size(), false);
+  std::atomic<std::size_t> next_index{ 0 };
+  const auto worker = [&]() {
+    for (std::size_t i = next_index++; i < ik_poses.size(); i = next_index++)
+    {
+      results[i] = searchPositionIK(ik_poses[i], ik_seed_states[ik_seed_states.size() == 1 ? 0 : i], timeout,
+                                    solutions[i], error_codes[i], options);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+  return std::all_of(results.begin(), results.end(), [](char result) { return result; });
+}
+
 bool KinematicsBase::getPositionIK(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
                                    const std::vector<double>& ik_seed_state,
                                    std::vector<std::vector<double> >& solutions, KinematicsResult& result,
@@ -206,4 +283,29 @@ bool KinematicsBase::getPositionIK(const std::vector<geometry_msgs::msg::Pose>&
 
   return true;
 }
+
+bool KinematicsBase::getPositionIKSolutions(const geometry_msgs::msg::Pose& ik_pose,
+                                            const std::vector<double>& ik_seed_state, std::vector<double>& solutions,
+                                            KinematicsResult& result, const KinematicsQueryOptions& options) const
+{
+  solutions.clear();
+  std::vector<std::vector<double> > solution_list;
+  if (!getPositionIK(std::vector<geometry_msgs::msg::Pose>(1, ik_pose), ik_seed_state, solution_list, result, options))
+    return false;
+
+  // order the solutions by their L1 distance to the seed
+  std::vector<std::pair<double, std::size_t> > order(solution_list.size());
+  for (std::size_t i = 0; i < solution_list.size(); ++i)
+  {
+    double dist_from_seed = 0.0;
+    for (std::size_t j = 0; j < ik_seed_state.size() && j < solution_list[i].size(); ++j)
+      dist_from_seed += std::fabs(ik_seed_state[j] - solution_list[i][j]);
+    order[i] = std::make_pair(dist_from_seed, i);
+  }
+  std::sort(order.begin(), order.end());
+
+  for (const std::pair<double, std::size_t>& entry : order)
+    solutions.insert(solutions.end(), solution_list[entry.second].begin(), solution_list[entry.second].end());
+  return !solutions.empty();
+}
 }  // end of namespace kinematics
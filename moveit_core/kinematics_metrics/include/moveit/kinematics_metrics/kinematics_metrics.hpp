@@ -37,6 +37,7 @@
 #pragma once
 
 #include <moveit/robot_state/robot_state.hpp>
+#include <moveit/robot_trajectory/robot_trajectory.hpp>
 
 /** @brief Namespace for kinematics metrics */
 namespace kinematics_metrics
@@ -77,6 +78,33 @@ public:
                               const moveit::core::JointModelGroup* joint_model_group, double& manipulability_index,
                               bool translation = false) const;
 
+  /**
+   * @brief Get the manipulability for a given group at every waypoint of a trajectory. This reuses the Jacobian
+   * buffers between waypoints, and evaluates sqrt(det(JJ^T)) (or sqrt(det(J^TJ)) for fewer joints than task space
+   * dimensions) instead of decomposing the Jacobian.
+   * @param trajectory The trajectory to evaluate, its waypoints don't need up-to-date link transforms
+   * @param group_name The group name (e.g. "arm")
+   * @param manipulability_indices The computed manipulability for each waypoint
+   * @param thread_count The maximum number of threads to use, 0 for one per hardware thread
+   * @return False if the group was not found
+   */
+  bool getManipulabilityIndices(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group_name,
+                                std::vector<double>& manipulability_indices, bool translation = false,
+                                std::size_t thread_count = 1) const;
+
+  /**
+   * @brief Get the manipulability for a given group at every waypoint of a trajectory, see above
+   * @param trajectory The trajectory to evaluate, its waypoints don't need up-to-date link transforms
+   * @param joint_model_group A pointer to the desired joint model group
+   * @param manipulability_indices The computed manipulability for each waypoint
+   * @param thread_count The maximum number of threads to use, 0 for one per hardware thread
+   * @return False if the group is not a chain
+   */
+  bool getManipulabilityIndices(const robot_trajectory::RobotTrajectory& trajectory,
+                                const moveit::core::JointModelGroup* joint_model_group,
+                                std::vector<double>& manipulability_indices, bool translation = false,
+                                std::size_t thread_count = 1) const;
+
   /**
    * @brief Get the (translation) manipulability ellipsoid for a given group at a given joint configuration
    * @param state Complete kinematic state for the robot
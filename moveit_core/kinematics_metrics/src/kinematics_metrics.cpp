@@ -36,8 +36,11 @@
 
 #include <Eigen/Dense>
 #include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <math.h>
+#include <thread>
 #include <moveit/kinematics_metrics/kinematics_metrics.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
@@ -51,6 +54,20 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.kinematics_metrics");
 }
+
+// The product of the singular values of the (translation part of the) Jacobian. This is sqrt(det(JJ^T)), or
+// sqrt(det(J^TJ)) if J has fewer columns than rows, so the Gram matrix is at most 6x6 and lives on the stack.
+double computeManipulabilityIndex(const Eigen::MatrixXd& jacobian, bool translation)
+{
+  const auto task_jacobian = jacobian.topRows(translation ? 3 : 6);
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 6, 6> gram;
+  if (task_jacobian.cols() < task_jacobian.rows())
+    gram.noalias() = task_jacobian.transpose() * task_jacobian;
+  else
+    gram.noalias() = task_jacobian * task_jacobian.transpose();
+  // rounding can make the determinant of a singular Gram matrix slightly negative
+  return sqrt(std::max(gram.determinant(), 0.0));
+}
 }  // namespace
 
 double KinematicsMetrics::getJointLimitsPenalty(const moveit::core::RobotState& state,
@@ -129,51 +146,67 @@ bool KinematicsMetrics::getManipulabilityIndex(const moveit::core::RobotState& s
   Eigen::MatrixXd jacobian = state.getJacobian(joint_model_group);
   // Get joint limits penalty
   double penalty = getJointLimitsPenalty(state, joint_model_group);
-  if (translation)
+  // Get manipulability index
+  manipulability_index = penalty * computeManipulabilityIndex(jacobian, translation);
+  return true;
+}
+
+bool KinematicsMetrics::getManipulabilityIndices(const robot_trajectory::RobotTrajectory& trajectory,
+                                                 const std::string& group_name,
+                                                 std::vector<double>& manipulability_indices, bool translation,
+                                                 std::size_t thread_count) const
+{
+  const moveit::core::JointModelGroup* joint_model_group = robot_model_->getJointModelGroup(group_name);
+  if (joint_model_group)
   {
-    if (jacobian.cols() < 6)
-    {
-      Eigen::JacobiSVD<Eigen::MatrixXd> svdsolver(jacobian.topLeftCorner(3, jacobian.cols()));
-      Eigen::MatrixXd singular_values = svdsolver.singularValues();
-      manipulability_index = 1.0;
-      for (unsigned int i = 0; i < singular_values.rows(); ++i)
-      {
-        RCLCPP_DEBUG(getLogger(), "Singular value: %d %f", i, singular_values(i, 0));
-        manipulability_index *= singular_values(i, 0);
-      }
-      // Get manipulability index
-      manipulability_index = penalty * manipulability_index;
-    }
-    else
-    {
-      Eigen::MatrixXd jacobian_2 = jacobian.topLeftCorner(3, jacobian.cols());
-      Eigen::MatrixXd matrix = jacobian_2 * jacobian_2.transpose();
-      // Get manipulability index
-      manipulability_index = penalty * sqrt(matrix.determinant());
-    }
+    return getManipulabilityIndices(trajectory, joint_model_group, manipulability_indices, translation, thread_count);
   }
   else
   {
-    if (jacobian.cols() < 6)
+    return false;
+  }
+}
+
+bool KinematicsMetrics::getManipulabilityIndices(const robot_trajectory::RobotTrajectory& trajectory,
+                                                 const moveit::core::JointModelGroup* joint_model_group,
+                                                 std::vector<double>& manipulability_indices, bool translation,
+                                                 std::size_t thread_count) const
+{
+  // state.getJacobian() only works for chain groups.
+  if (!joint_model_group->isChain())
+  {
+    return false;
+  }
+
+  manipulability_indices.resize(trajectory.getWayPointCount());
+  std::atomic<std::size_t> next_waypoint{ 0 };
+  const auto worker = [&] {
+    // the waypoints are copied into a state of our own, as their link transforms may be dirty
+    moveit::core::RobotState state(trajectory.getRobotModel());
+    const moveit::core::LinkModel* tip = joint_model_group->getLinkModels().back();
+    Eigen::MatrixXd jacobian;
+    for (std::size_t i = next_waypoint++; i < manipulability_indices.size(); i = next_waypoint++)
     {
-      Eigen::JacobiSVD<Eigen::MatrixXd> svdsolver(jacobian);
-      Eigen::MatrixXd singular_values = svdsolver.singularValues();
-      manipulability_index = 1.0;
-      for (unsigned int i = 0; i < singular_values.rows(); ++i)
+      state.setVariablePositions(trajectory.getWayPoint(i).getVariablePositions());
+      if (!state.getJacobian(joint_model_group, tip, Eigen::Vector3d::Zero(), jacobian))
       {
-        RCLCPP_DEBUG(getLogger(), "Singular value: %d %f", i, singular_values(i, 0));
-        manipulability_index *= singular_values(i, 0);
+        manipulability_indices[i] = 0.0;
+        continue;
       }
-      // Get manipulability index
-      manipulability_index = penalty * manipulability_index;
+      manipulability_indices[i] =
+          getJointLimitsPenalty(state, joint_model_group) * computeManipulabilityIndex(jacobian, translation);
     }
-    else
-    {
-      Eigen::MatrixXd matrix = jacobian * jacobian.transpose();
-      // Get manipulability index
-      manipulability_index = penalty * sqrt(matrix.determinant());
-    }
-  }
+  };
+
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min(thread_count, manipulability_indices.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
   return true;
 }
 
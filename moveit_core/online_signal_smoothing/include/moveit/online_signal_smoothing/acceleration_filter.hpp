@@ -104,7 +104,8 @@ public:
 
   /**
    * Smooth the command signals for all DOF. This function limits the change in velocity using the acceleration
-   * specified in the robot model.
+   * specified in the robot model. After reset(), it does not allocate memory: the optimization problem is set up once
+   * and only its constraints are updated, warm starting from the solution of the previous call.
    * @param positions array of joint position commands
    * @param velocities array of joint velocity commands
    * @param accelerations (unused)
@@ -147,9 +148,12 @@ private:
   Eigen::VectorXd cur_acceleration_;
   Eigen::VectorXd positions_offset_;
   Eigen::VectorXd velocities_offset_;
+  Eigen::VectorXd lower_bound_;
+  Eigen::VectorXd upper_bound_;
   /** \brief Extracted joint limits from robot model */
   Eigen::VectorXd max_acceleration_limits_;
   Eigen::VectorXd min_acceleration_limits_;
+  moveit::core::JointBoundsVector joint_bounds_;
   /** \brief Pointer to robot model */
   moveit::core::RobotModelConstPtr robot_model_;
   /** \brief Constraint matrix for optimization problem */
@@ -81,6 +81,25 @@ public:
   bool reset(const Eigen::VectorXd& positions, const Eigen::VectorXd& velocities,
              const Eigen::VectorXd& accelerations) override;
 
+  /**
+   * Get the remaining duration of the trajectory computed by the last doSmoothing() call, which leads from its output
+   * to the smoothed target state. Its samples can e.g. be checked for collisions ahead of the motion.
+   * @return The duration in seconds, zero if there is no trajectory
+   */
+  double getTrajectoryDuration() const;
+
+  /**
+   * Sample the trajectory computed by the last doSmoothing() call. This does not allocate memory once the output
+   * vectors have the number of joints.
+   * @param time The time after the output of the last doSmoothing() call, clamped to the trajectory duration
+   * @param positions the joint positions at that time
+   * @param velocities the joint velocities at that time
+   * @param accelerations the joint accelerations at that time
+   * @return True if there is a trajectory to sample
+   */
+  bool sampleTrajectory(double time, Eigen::VectorXd& positions, Eigen::VectorXd& velocities,
+                        Eigen::VectorXd& accelerations);
+
 private:
   /**
    * A utility to print Ruckig's internal state
@@ -102,5 +121,9 @@ private:
   std::optional<ruckig::Ruckig<ruckig::DynamicDOFs>> ruckig_;
   std::optional<ruckig::InputParameter<ruckig::DynamicDOFs>> ruckig_input_;
   std::optional<ruckig::OutputParameter<ruckig::DynamicDOFs>> ruckig_output_;
+  /** \brief Buffers for samples of the Ruckig trajectory */
+  std::vector<double> sample_position_;
+  std::vector<double> sample_velocity_;
+  std::vector<double> sample_acceleration_;
 };
 }  // namespace online_signal_smoothing
@@ -145,6 +145,10 @@ bool AccelerationLimitedPlugin::initialize(rclcpp::Node::SharedPtr node, moveit:
   num_joints_ = num_joints;
   robot_model_ = robot_model;
   cur_acceleration_ = Eigen::VectorXd::Zero(num_joints);
+  positions_offset_ = Eigen::VectorXd::Zero(num_joints);
+  velocities_offset_ = Eigen::VectorXd::Zero(num_joints);
+  lower_bound_ = Eigen::VectorXd::Zero(num_joints);
+  upper_bound_ = Eigen::VectorXd::Zero(num_joints);
 
   // get node parameters and store in member variables
   auto param_listener = online_signal_smoothing::ParamListener(node_);
@@ -152,11 +156,11 @@ bool AccelerationLimitedPlugin::initialize(rclcpp::Node::SharedPtr node, moveit:
 
   // get robot acceleration limits and store in member variables
   auto joint_model_group = robot_model_->getJointModelGroup(params_.planning_group_name);
-  auto joint_bounds = joint_model_group->getActiveJointModelsBounds();
+  joint_bounds_ = joint_model_group->getActiveJointModelsBounds();
   min_acceleration_limits_ = Eigen::VectorXd::Zero(num_joints);
   max_acceleration_limits_ = Eigen::VectorXd::Zero(num_joints);
   size_t ind = 0;
-  for (const auto& joint_bound : joint_bounds)
+  for (const auto& joint_bound : joint_bounds_)
   {
     for (const auto& variable_bound : *joint_bound)
     {
@@ -186,7 +190,8 @@ bool AccelerationLimitedPlugin::initialize(rclcpp::Node::SharedPtr node, moveit:
   }
   constraints_sparse_.insert(num_constraints - 1, 0) = 0;
   osqp_set_default_settings(&osqp_settings_);
-  osqp_settings_.warm_start = 0;
+  // alpha changes little between consecutive commands, so the previous solution is a good initial guess
+  osqp_settings_.warm_start = 1;
   osqp_settings_.verbose = 0;
   osqp_data_ = std::make_shared<OSQPDataWrapper>(objective_sparse, constraints_sparse_);
   osqp_data_->q[0] = 0;
@@ -291,10 +296,11 @@ bool AccelerationLimitedPlugin::doSmoothing(Eigen::VectorXd& positions, Eigen::V
     constraints_sparse_.coeffRef(i, 0) = positions_offset_[i];
   }
   constraints_sparse_.coeffRef(num_constraints - 1, 0) = 1;
-  Eigen::VectorXd vel_point = last_positions_ + last_velocities_ * update_period;
-  Eigen::VectorXd upper_bound = vel_point - positions + max_acceleration_limits_ * (update_period * update_period);
-  Eigen::VectorXd lower_bound = vel_point - positions + min_acceleration_limits_ * (update_period * update_period);
-  if (!updateData(osqp_data_, osqp_workspace_, constraints_sparse_, lower_bound, upper_bound))
+  // the bounds are the displacement at the current velocity from the target, plus that of the acceleration limits
+  lower_bound_ = last_positions_ + last_velocities_ * update_period - positions;
+  upper_bound_ = lower_bound_ + max_acceleration_limits_ * (update_period * update_period);
+  lower_bound_ += min_acceleration_limits_ * (update_period * update_period);
+  if (!updateData(osqp_data_, osqp_workspace_, constraints_sparse_, lower_bound_, upper_bound_))
   {
     RCLCPP_ERROR_THROTTLE(getLogger(), *node_->get_clock(), 1000,
                           "failed to set osqp_update_bounds. Make sure the robot's acceleration limits are valid");
@@ -312,15 +318,13 @@ bool AccelerationLimitedPlugin::doSmoothing(Eigen::VectorXd& positions, Eigen::V
            osqp_workspace_->solution->x[0] <= ALPHA_UPPER_BOUND + osqp_settings_.eps_abs)
   {
     double alpha = osqp_workspace_->solution->x[0];
-    positions = alpha * last_positions_ + (1.0 - alpha) * positions.eval();
+    positions = alpha * last_positions_ + (1.0 - alpha) * positions;
     velocities = (positions - last_positions_) / update_period;
   }
   else
   {
-    auto joint_model_group = robot_model_->getJointModelGroup(params_.planning_group_name);
-    auto joint_bounds = joint_model_group->getActiveJointModelsBounds();
     cur_acceleration_ = -(last_velocities_) / update_period;
-    cur_acceleration_ *= jointLimitAccelerationScalingFactor(cur_acceleration_, joint_bounds);
+    cur_acceleration_ *= jointLimitAccelerationScalingFactor(cur_acceleration_, joint_bounds_);
     velocities = last_velocities_ + cur_acceleration_ * update_period;
     positions = last_positions_ + velocities * update_period;
   }
@@ -107,6 +107,8 @@ bool ButterworthFilterPlugin::initialize(rclcpp::Node::SharedPtr node, moveit::c
   online_signal_smoothing::ParamListener param_listener(node_);
   double filter_coeff = param_listener.get_params().butterworth_filter_coeff;
 
+  position_filters_.clear();
+  position_filters_.reserve(num_joints_);
   for (std::size_t i = 0; i < num_joints_; ++i)
   {
     position_filters_.emplace_back(filter_coeff);
@@ -124,10 +126,11 @@ bool ButterworthFilterPlugin::doSmoothing(Eigen::VectorXd& positions, Eigen::Vec
                           "Position vector to be smoothed does not have the right length.");
     return false;
   }
+  // The length was checked above, so the filters are accessed without bounds checks
   for (size_t i = 0; i < num_positions; ++i)
   {
     // Lowpass filter the position command
-    positions[i] = position_filters_.at(i).filter(positions[i]);
+    positions[i] = position_filters_[i].filter(positions[i]);
   }
   return true;
 };
@@ -36,6 +36,8 @@
 #include <rclcpp/clock.hpp>
 #include <rclcpp/logging.hpp>
 
+#include <algorithm>
+
 // Disable -Wold-style-cast because all _THROTTLE macros trigger this
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 
@@ -76,6 +78,10 @@ bool RuckigFilterPlugin::initialize(rclcpp::Node::SharedPtr node, moveit::core::
 
   ruckig_.emplace(ruckig::Ruckig<ruckig::DynamicDOFs>(num_joints, params_.update_period));
 
+  sample_position_.assign(num_joints, 0.0);
+  sample_velocity_.assign(num_joints, 0.0);
+  sample_acceleration_.assign(num_joints, 0.0);
+
   return true;
 }
 
@@ -93,15 +99,21 @@ bool RuckigFilterPlugin::doSmoothing(Eigen::VectorXd& positions, Eigen::VectorXd
     ruckig_output_->pass_to_input(*ruckig_input_);
   }
 
-  // Update Ruckig target state
-  ruckig_input_->target_position = std::vector<double>(positions.data(), positions.data() + positions.size());
+  const size_t num_joints = ruckig_input_->current_acceleration.size();
+  if (static_cast<size_t>(positions.size()) != num_joints)
+  {
+    RCLCPP_ERROR_STREAM(getLogger(), "Expected " << num_joints << " joint positions, got " << positions.size());
+    return false;
+  }
+
+  // Update Ruckig target state in place, so that smoothing at high rates does not allocate
+  std::copy(positions.data(), positions.data() + num_joints, ruckig_input_->target_position.begin());
   // We don't know what the next command will be. Assume velocity continues forward based on current state,
   // target_acceleration is zero.
-  const size_t num_joints = ruckig_input_->current_acceleration.size();
   for (size_t i = 0; i < num_joints; ++i)
   {
-    ruckig_input_->target_velocity.at(i) =
-        ruckig_input_->current_velocity.at(i) + ruckig_input_->current_acceleration.at(i) * params_.update_period;
+    ruckig_input_->target_velocity[i] =
+        ruckig_input_->current_velocity[i] + ruckig_input_->current_acceleration[i] * params_.update_period;
   }
   // target_acceleration remains a vector of zeroes
 
@@ -140,15 +152,41 @@ bool RuckigFilterPlugin::reset(const Eigen::VectorXd& positions, const Eigen::Ve
                                const Eigen::VectorXd& accelerations)
 {
   // Initialize Ruckig
-  ruckig_input_->current_position = std::vector<double>(positions.data(), positions.data() + positions.size());
-  ruckig_input_->current_velocity = std::vector<double>(velocities.data(), velocities.data() + velocities.size());
-  ruckig_input_->current_acceleration =
-      std::vector<double>(accelerations.data(), accelerations.data() + accelerations.size());
+  ruckig_input_->current_position.assign(positions.data(), positions.data() + positions.size());
+  ruckig_input_->current_velocity.assign(velocities.data(), velocities.data() + velocities.size());
+  ruckig_input_->current_acceleration.assign(accelerations.data(), accelerations.data() + accelerations.size());
 
   have_initial_ruckig_output_ = false;
   return true;
 }
 
+double RuckigFilterPlugin::getTrajectoryDuration() const
+{
+  if (!have_initial_ruckig_output_)
+  {
+    return 0.0;
+  }
+  return std::max(ruckig_output_->trajectory.get_duration() - ruckig_output_->time, 0.0);
+}
+
+bool RuckigFilterPlugin::sampleTrajectory(double time, Eigen::VectorXd& positions, Eigen::VectorXd& velocities,
+                                          Eigen::VectorXd& accelerations)
+{
+  if (!have_initial_ruckig_output_)
+  {
+    return false;
+  }
+
+  // The output of doSmoothing() lies at the current time of the output parameter on the trajectory
+  const double trajectory_time =
+      std::clamp(ruckig_output_->time + time, 0.0, ruckig_output_->trajectory.get_duration());
+  ruckig_output_->trajectory.at_time(trajectory_time, sample_position_, sample_velocity_, sample_acceleration_);
+  positions = Eigen::Map<const Eigen::VectorXd>(sample_position_.data(), sample_position_.size());
+  velocities = Eigen::Map<const Eigen::VectorXd>(sample_velocity_.data(), sample_velocity_.size());
+  accelerations = Eigen::Map<const Eigen::VectorXd>(sample_acceleration_.data(), sample_acceleration_.size());
+  return true;
+}
+
 bool RuckigFilterPlugin::getVelAccelJerkBounds(std::vector<double>& joint_velocity_bounds,
                                                std::vector<double>& joint_acceleration_bounds,
                                                std::vector<double>& joint_jerk_bounds)
@@ -71,5 +71,27 @@ public:
    *  @return True if response was generated correctly */
   [[nodiscard]] virtual moveit::core::MoveItErrorCode adapt(const planning_scene::PlanningSceneConstPtr& planning_scene,
                                                             planning_interface::MotionPlanRequest& req) const = 0;
+
+  /** @brief Declare whether adapt() may modify the planning request
+   *  @return True by default. Adapters that only validate the request return false, so that a planning pipeline can
+   *  run consecutive validating adapters concurrently. Their adapt() must then only read the request and the scene.
+   */
+  [[nodiscard]] virtual bool modifiesRequest() const
+  {
+    return true;
+  }
+
+  /** @brief Adapt the response of a successfully planned request to the request before adaptation
+   *  @param planning_scene Representation of the environment for the planning
+   *  @param req Motion planning request as it was passed to the planning pipeline, before any adapter modified it
+   *  @param res Motion planning response, planned for the adapted request
+   *  @details Called by the planning pipeline in reverse adapter order once the planner succeeded, before the
+   *  response adapters run. The default implementation is empty. Adapters that change the start state use it to
+   *  connect the solution to the original start state. */
+  virtual void adaptResponse(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                             const planning_interface::MotionPlanRequest& req,
+                             planning_interface::MotionPlanResponse& res) const
+  {
+  }
 };
 }  // namespace planning_interface
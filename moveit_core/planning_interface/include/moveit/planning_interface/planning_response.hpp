@@ -41,9 +41,30 @@
 #include <moveit_msgs/msg/move_it_error_codes.hpp>
 #include <moveit_msgs/msg/motion_plan_response.hpp>
 #include <moveit_msgs/msg/motion_plan_detailed_response.hpp>
+#include <optional>
+#include <utility>
 
 namespace planning_interface
 {
+/// \brief Statistics of the work done to answer a planning query, fields are empty if they were not measured
+struct MotionPlanStatistics
+{
+  /// Number of collision checks of robot states
+  std::optional<std::size_t> collision_checks;
+  /// Number of forward kinematics updates of robot states
+  std::optional<std::size_t> fk_calls;
+  /// Number of inverse kinematics queries
+  std::optional<std::size_t> ik_calls;
+  /// Number of states sampled by the planners
+  std::optional<std::size_t> states_sampled;
+  /// Time in seconds spent in the planning pipeline stages, i.e. the adapters and planners, in the order they ran
+  std::vector<std::pair<std::string, double>> stage_times;
+  /// Time in seconds spent simplifying the solution
+  std::optional<double> simplification_time;
+  /// Time in seconds spent waiting for the lock of the planning scene
+  std::optional<double> lock_wait_time;
+};
+
 /// \brief Response to a planning query
 struct MotionPlanResponse
 {
@@ -64,6 +85,8 @@ struct MotionPlanResponse
   /// The full starting state used for planning
   moveit_msgs::msg::RobotState start_state;
   std::string planner_id;
+  /// Statistics of the work done for the query
+  MotionPlanStatistics statistics;
 
   // \brief Enable checking of query success or failure, for example if(response) ...
   explicit operator bool() const
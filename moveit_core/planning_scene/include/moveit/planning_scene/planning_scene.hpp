@@ -41,6 +41,7 @@
 #include <moveit/transforms/transforms.hpp>
 #include <moveit/collision_detection/collision_detector_allocator.hpp>
 #include <moveit/collision_detection/world_diff.hpp>
+#include <moveit/collision_detection/collision_batch.hpp>
 #include <moveit/collision_detection/collision_env.hpp>
 #include <moveit/kinematic_constraints/kinematic_constraint.hpp>
 #include <moveit/kinematics_base/kinematics_base.hpp>
@@ -51,7 +52,9 @@
 #include <moveit_msgs/msg/constraints.hpp>
 #include <moveit_msgs/msg/planning_scene_components.hpp>
 #include <octomap_msgs/msg/octomap_with_pose.hpp>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include <optional>
 #include <thread>
@@ -342,6 +345,19 @@ public:
   bool isStateColliding(const moveit_msgs::msg::RobotState& state, const std::string& group = "",
                         bool verbose = false) const;
 
+  /** \brief Memoize the results of isStateColliding() for up to \e size states.
+      A size of 0 (the default) disables this. States are identified by their joint positions, rounded to multiples
+      of \e resolution, and by the ids and links of their attached bodies. The memoized results are discarded
+      whenever the world, the allowed collision matrix or the collision environments of this scene or of its parents
+      change. Changes made through references that were obtained from the non-const accessors before a result was
+      memoized are not noticed. */
+  void setCollisionCheckCacheSize(std::size_t size, double resolution = 1e-6);
+
+  /** \brief Get a number that changes whenever the allowed collision matrix or the collision environments of this
+      scene or of its parents change. Together with the version of getWorld(), it allows memoizing collision checks
+      outside of the scene, with the same limitations as setCollisionCheckCacheSize(). */
+  std::uint64_t getCollisionCheckVersion() const;
+
   /** \brief Check whether the current state is in collision, and if needed, updates the collision transforms of the
    * current state before the computation. */
   void checkCollision(const collision_detection::CollisionRequest& req, collision_detection::CollisionResult& res);
@@ -880,6 +896,19 @@ public:
   bool isPathValid(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group = "",
                    bool verbose = false, std::vector<std::size_t>* invalid_index = nullptr) const;
 
+  /** \brief Check the waypoints of a trajectory passed to isPathValid() on \e thread_count threads (default 1).
+   * The waypoints are checked in bisection order, the ends of the path first, then its middle and so on.
+   * If no \e invalid_index is requested, all threads stop as soon as an invalid waypoint is found.
+   * The state feasibility predicate needs to be thread-safe when more than one thread is used.
+   * A path validation running concurrently with another one of the same scene checks its waypoints sequentially. */
+  void setPathValidationThreadCount(std::size_t thread_count);
+
+  /** \brief Get the number of threads isPathValid() checks the waypoints of a trajectory on */
+  std::size_t getPathValidationThreadCount() const
+  {
+    return path_validation_pool_ ? path_validation_pool_->getThreadCount() : 1;
+  }
+
   /** \brief Get the top \e max_costs cost sources for a specified trajectory. The resulting costs are stored in \e
    * costs */
   void getCostSources(const robot_trajectory::RobotTrajectory& trajectory, std::size_t max_costs,
@@ -932,36 +961,82 @@ private:
    * Requires a valid robot_model_ */
   void initialize();
 
+  /* Discard memoized collision checks, called on every change that getCollisionCheckVersion() tracks */
+  void updateCollisionCheckVersion();
+
   /* Helper functions for processing collision objects */
   bool processCollisionObjectAdd(const moveit_msgs::msg::CollisionObject& object);
   bool processCollisionObjectRemove(const moveit_msgs::msg::CollisionObject& object);
   bool processCollisionObjectMove(const moveit_msgs::msg::CollisionObject& object);
 
+  /* Construct a MOVE message for an object whose geometry is shared with the parent scene.
+   * Returns false if the object cannot be described by a MOVE message. */
+  bool getCollisionObjectMoveMsg(moveit_msgs::msg::CollisionObject& collision_obj, const std::string& ns) const;
+
   MOVEIT_STRUCT_FORWARD(CollisionDetector);
 
-  /* Construct a new CollisionDector from allocator, copy-construct environments from parent_detector if not nullptr */
+  /* Construct a new CollisionDector from allocator, copy-construct environments from parent_detector if not nullptr.
+   * The environments are allocated when they are first used. */
   void allocateCollisionDetector(const collision_detection::CollisionDetectorAllocatorPtr& allocator,
                                  const CollisionDetectorPtr& parent_detector);
 
-  /* \brief A set of compatible collision detectors */
+  /* \brief A set of compatible collision detectors, whose environments are allocated on first use, so that scenes
+   * which never check collisions (e.g. for visualization or storage) don't construct them */
   struct CollisionDetector
   {
+    CollisionDetector() = default;
+    CollisionDetector(const CollisionDetector&) = delete;
+    CollisionDetector& operator=(const CollisionDetector&) = delete;
+
     collision_detection::CollisionDetectorAllocatorPtr alloc_;
-    collision_detection::CollisionEnvPtr cenv_;  // never nullptr
-    collision_detection::CollisionEnvConstPtr cenv_const_;
 
-    collision_detection::CollisionEnvPtr cenv_unpadded_;
-    collision_detection::CollisionEnvConstPtr cenv_unpadded_const_;
+    // what the environments are allocated from: the world and robot model of the scene, the detector to copy from
+    // (nullptr to construct new environments, released once allocated) and the padding and scaling to apply
+    collision_detection::WorldPtr world_;
+    moveit::core::RobotModelConstPtr robot_model_;
+    mutable CollisionDetectorConstPtr parent_;
+    std::map<std::string, double> link_padding_;
+    std::map<std::string, double> link_scale_;
 
     const collision_detection::CollisionEnvConstPtr& getCollisionEnv() const
     {
+      if (!allocated_.load(std::memory_order_acquire))
+        allocate();
       return cenv_const_;
     }
     const collision_detection::CollisionEnvConstPtr& getCollisionEnvUnpadded() const
     {
+      if (!allocated_.load(std::memory_order_acquire))
+        allocate();
       return cenv_unpadded_const_;
     }
-    void copyPadding(const CollisionDetector& src);
+    const collision_detection::CollisionEnvPtr& getCollisionEnvNonConst()
+    {
+      if (!allocated_.load(std::memory_order_acquire))
+        allocate();
+      return cenv_;
+    }
+
+    /* The padding and scaling of the padded environment, without allocating it */
+    const std::map<std::string, double>& getLinkPadding() const;
+    const std::map<std::string, double>& getLinkScale() const;
+    void getPadding(std::vector<moveit_msgs::msg::LinkPadding>& padding) const;
+    void getScale(std::vector<moveit_msgs::msg::LinkScale>& scale) const;
+    void setPadding(const std::vector<moveit_msgs::msg::LinkPadding>& padding);
+    void setScale(const std::vector<moveit_msgs::msg::LinkScale>& scale);
+
+    /* Allocate the environments, if that didn't happen yet. Safe to call concurrently. */
+    void allocate() const;
+
+  private:
+    mutable collision_detection::CollisionEnvPtr cenv_;  // nullptr until allocated
+    mutable collision_detection::CollisionEnvConstPtr cenv_const_;
+
+    mutable collision_detection::CollisionEnvPtr cenv_unpadded_;
+    mutable collision_detection::CollisionEnvConstPtr cenv_unpadded_const_;
+
+    mutable std::once_flag allocate_once_;
+    mutable std::atomic<bool> allocated_{ false };
   };
   friend struct CollisionDetector;
 
@@ -990,6 +1065,14 @@ private:
 
   std::optional<collision_detection::AllowedCollisionMatrix> acm_;  // if there is no value use parent's
 
+  // memoized results of isStateColliding(), nullptr unless enabled by setCollisionCheckCacheSize()
+  struct CollisionCheckCache;
+  std::unique_ptr<CollisionCheckCache> collision_check_cache_;
+  std::uint64_t collision_check_version_ = 0;
+
+  // threads checking the waypoints of isPathValid(), nullptr if they are checked sequentially
+  std::unique_ptr<collision_detection::CollisionThreadPool> path_validation_pool_;
+
   StateFeasibilityFn state_feasibility_;
   MotionFeasibilityFn motion_feasibility_;
 
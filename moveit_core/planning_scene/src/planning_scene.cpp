@@ -45,12 +45,20 @@
 #include <moveit/exceptions/exceptions.hpp>
 #include <moveit/robot_state/attached_body.hpp>
 #include <moveit/utils/message_checks.hpp>
+#include <moveit/utils/work_counters.hpp>
 #include <octomap_msgs/conversions.h>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <tf2_eigen/tf2_eigen.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 #include <moveit/utils/logger.hpp>
 
 namespace planning_scene
@@ -61,8 +69,127 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.planning_scene");
 }
+
+std::uint64_t nextCollisionCheckVersion()
+{
+  static std::atomic<std::uint64_t> version{ 0 };
+  return ++version;
+}
+
+// Identify a state by the group to check, its attached bodies and its rounded joint positions
+std::string getCollisionCheckKey(const moveit::core::RobotState& state, const std::string& group, double resolution)
+{
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  state.getAttachedBodies(attached_bodies);
+  std::sort(attached_bodies.begin(), attached_bodies.end(),
+            [](const moveit::core::AttachedBody* a, const moveit::core::AttachedBody* b) {
+              return a->getName() < b->getName();
+            });
+
+  std::string key = group;
+  key.push_back('\0');
+  for (const moveit::core::AttachedBody* attached_body : attached_bodies)
+  {
+    key += attached_body->getName();
+    key.push_back('\0');
+    key += attached_body->getAttachedLinkName();
+    key.push_back('\0');
+  }
+  const double* positions = state.getVariablePositions();
+  for (std::size_t i = 0; i < state.getVariableCount(); ++i)
+  {
+    const std::int64_t position = std::llround(positions[i] / resolution);
+    key.append(reinterpret_cast<const char*>(&position), sizeof(position));
+  }
+  return key;
+}
+
+// Order the indices [0, count) so that the ends of a path come first, then its middle,
+// then the middles of both halves and so on
+std::vector<std::size_t> getBisectionOrder(std::size_t count)
+{
+  std::vector<std::size_t> order;
+  order.reserve(count);
+  if (count == 0)
+    return order;
+  order.push_back(0);
+  if (count == 1)
+    return order;
+  order.push_back(count - 1);
+
+  // intervals whose inner indices are not ordered yet
+  std::deque<std::pair<std::size_t, std::size_t>> intervals;
+  intervals.emplace_back(0, count - 1);
+  while (!intervals.empty())
+  {
+    const auto [low, high] = intervals.front();
+    intervals.pop_front();
+    if (high - low < 2)
+      continue;
+    const std::size_t mid = low + (high - low) / 2;
+    order.push_back(mid);
+    intervals.emplace_back(low, mid);
+    intervals.emplace_back(mid, high);
+  }
+  return order;
+}
 }  // namespace
 
+// Bounded cache of collision check results, ordered from the most to the least recently used
+struct PlanningScene::CollisionCheckCache
+{
+  using Entries = std::list<std::pair<std::string, bool>>;
+
+  CollisionCheckCache(std::size_t size, double resolution) : size(size), resolution(resolution)
+  {
+  }
+
+  // Look up a result, after discarding all results if the scene changed since they were stored
+  std::optional<bool> find(const std::string& key, std::uint64_t current_world_version,
+                           std::uint64_t current_scene_version)
+  {
+    std::scoped_lock lock(mutex);
+    if (current_world_version != world_version || current_scene_version != scene_version)
+    {
+      entries.clear();
+      index.clear();
+      world_version = current_world_version;
+      scene_version = current_scene_version;
+      return std::nullopt;
+    }
+    const auto it = index.find(key);
+    if (it == index.end())
+      return std::nullopt;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+  }
+
+  // Store a result computed for the given versions of the scene
+  void insert(const std::string& key, bool collision, std::uint64_t current_world_version,
+              std::uint64_t current_scene_version)
+  {
+    std::scoped_lock lock(mutex);
+    if (current_world_version != world_version || current_scene_version != scene_version ||
+        index.find(key) != index.end())
+      return;
+    entries.emplace_front(key, collision);
+    index.emplace(key, entries.begin());
+    if (entries.size() > size)
+    {
+      index.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+
+  const std::size_t size;
+  const double resolution;
+  std::uint64_t world_version = 0;
+  std::uint64_t scene_version = 0;
+  Entries entries;
+  std::unordered_map<std::string, Entries::iterator> index;
+  std::mutex mutex;
+};
+
 const std::string PlanningScene::OCTOMAP_NS = "<octomap>";
 const std::string PlanningScene::DEFAULT_SCENE_NAME = "(noname)";
 
@@ -223,7 +350,6 @@ PlanningScene::PlanningScene(const PlanningSceneConstPtr& parent) : parent_(pare
   world_diff_ = std::make_shared<collision_detection::WorldDiff>(world_);
 
   allocateCollisionDetector(parent_->collision_detector_->alloc_, parent_->collision_detector_);
-  collision_detector_->copyPadding(*parent_->collision_detector_);
 }
 
 PlanningScenePtr PlanningScene::clone(const PlanningSceneConstPtr& scene)
@@ -246,10 +372,99 @@ PlanningScenePtr PlanningScene::diff(const moveit_msgs::msg::PlanningScene& msg)
   return result;
 }
 
-void PlanningScene::CollisionDetector::copyPadding(const PlanningScene::CollisionDetector& src)
+const std::map<std::string, double>& PlanningScene::CollisionDetector::getLinkPadding() const
+{
+  return allocated_.load(std::memory_order_acquire) ? cenv_->getLinkPadding() : link_padding_;
+}
+
+const std::map<std::string, double>& PlanningScene::CollisionDetector::getLinkScale() const
+{
+  return allocated_.load(std::memory_order_acquire) ? cenv_->getLinkScale() : link_scale_;
+}
+
+void PlanningScene::CollisionDetector::getPadding(std::vector<moveit_msgs::msg::LinkPadding>& padding) const
+{
+  padding.clear();
+  for (const auto& lp : getLinkPadding())
+  {
+    moveit_msgs::msg::LinkPadding lp_msg;
+    lp_msg.link_name = lp.first;
+    lp_msg.padding = lp.second;
+    padding.push_back(lp_msg);
+  }
+}
+
+void PlanningScene::CollisionDetector::getScale(std::vector<moveit_msgs::msg::LinkScale>& scale) const
+{
+  scale.clear();
+  for (const auto& ls : getLinkScale())
+  {
+    moveit_msgs::msg::LinkScale ls_msg;
+    ls_msg.link_name = ls.first;
+    ls_msg.scale = ls.second;
+    scale.push_back(ls_msg);
+  }
+}
+
+void PlanningScene::CollisionDetector::setPadding(const std::vector<moveit_msgs::msg::LinkPadding>& padding)
 {
-  cenv_->setLinkPadding(src.getCollisionEnv()->getLinkPadding());
-  cenv_->setLinkScale(src.getCollisionEnv()->getLinkScale());
+  if (allocated_.load(std::memory_order_acquire))
+  {
+    cenv_->setPadding(padding);
+    return;
+  }
+  // invalid values are reported when the padding is applied to the allocated environment
+  for (const moveit_msgs::msg::LinkPadding& lp : padding)
+    link_padding_[lp.link_name] = lp.padding;
+}
+
+void PlanningScene::CollisionDetector::setScale(const std::vector<moveit_msgs::msg::LinkScale>& scale)
+{
+  if (allocated_.load(std::memory_order_acquire))
+  {
+    cenv_->setScale(scale);
+    return;
+  }
+  for (const moveit_msgs::msg::LinkScale& ls : scale)
+    link_scale_[ls.link_name] = ls.scale;
+}
+
+void PlanningScene::CollisionDetector::allocate() const
+{
+  std::call_once(allocate_once_, [this] {
+    if (parent_)
+    {
+      // copy-construct collision environments (shares link shapes where the plugin supports it)
+      if (parent_->world_->getVersion() == world_->getVersion())
+      {
+        // the world objects are the ones of the parent environments as well
+        cenv_ = alloc_->allocateEnv(parent_->getCollisionEnv(), world_);
+        cenv_unpadded_ = alloc_->allocateEnv(parent_->getCollisionEnvUnpadded(), world_);
+      }
+      else
+      {
+        // either scene changed its world in the meantime: keep the robot of the parent environments,
+        // but construct the world objects from our world
+        cenv_ = alloc_->allocateEnv(parent_->getCollisionEnv(), std::make_shared<collision_detection::World>());
+        cenv_->setWorld(world_);
+        cenv_unpadded_ =
+            alloc_->allocateEnv(parent_->getCollisionEnvUnpadded(), std::make_shared<collision_detection::World>());
+        cenv_unpadded_->setWorld(world_);
+      }
+      parent_.reset();
+    }
+    else
+    {
+      cenv_ = alloc_->allocateEnv(world_, robot_model_);
+      cenv_unpadded_ = alloc_->allocateEnv(world_, robot_model_);
+    }
+    cenv_->setLinkPadding(link_padding_);
+    cenv_->setLinkScale(link_scale_);
+
+    cenv_const_ = cenv_;
+    cenv_unpadded_const_ = cenv_unpadded_;
+    allocated_.store(true, std::memory_order_release);
+  });
 }
 
 void PlanningScene::allocateCollisionDetector(const collision_detection::CollisionDetectorAllocatorPtr& allocator,
@@ -258,31 +473,32 @@ void PlanningScene::allocateCollisionDetector(const collision_detection::Collisi
   // Temporarily keep pointer to the previous (if any) collision detector to copy padding from
   CollisionDetectorPtr prev_coll_detector = collision_detector_;
 
-  // Construct a fresh CollisionDetector and store allocator
+  // Construct a fresh CollisionDetector, its environments are allocated on first use.
+  // If parent_detector is specified, they are copy-constructed from its environments,
+  // otherwise they are constructed from world and robot model.
   collision_detector_ = std::make_shared<CollisionDetector>();
   collision_detector_->alloc_ = allocator;
+  collision_detector_->world_ = world_;
+  collision_detector_->robot_model_ = getRobotModel();
+  collision_detector_->parent_ = parent_detector;
 
-  // If parent_detector is specified, copy-construct collision environments (copies link shapes and attached objects)
-  // Otherwise, construct new collision environment from world and robot model
-  if (parent_detector)
+  // Copy padding from the parent detector or the previous one, without allocating their environments
+  const CollisionDetectorPtr& padding_src = parent_detector ? parent_detector : prev_coll_detector;
+  if (padding_src)
   {
-    collision_detector_->cenv_ = collision_detector_->alloc_->allocateEnv(parent_detector->cenv_, world_);
-    collision_detector_->cenv_unpadded_ =
-        collision_detector_->alloc_->allocateEnv(parent_detector->cenv_unpadded_, world_);
+    collision_detector_->link_padding_ = padding_src->getLinkPadding();
+    collision_detector_->link_scale_ = padding_src->getLinkScale();
   }
   else
   {
-    collision_detector_->cenv_ = collision_detector_->alloc_->allocateEnv(world_, getRobotModel());
-    collision_detector_->cenv_unpadded_ = collision_detector_->alloc_->allocateEnv(world_, getRobotModel());
-
-    // Copy padding to collision_detector_->cenv_
-    if (prev_coll_detector)
-      collision_detector_->copyPadding(*prev_coll_detector);
+    for (const moveit::core::LinkModel* link : getRobotModel()->getLinkModelsWithCollisionGeometry())
+    {
+      collision_detector_->link_padding_[link->getName()] = 0.0;
+      collision_detector_->link_scale_[link->getName()] = 1.0;
+    }
   }
 
-  // Assign const pointers
-  collision_detector_->cenv_const_ = collision_detector_->cenv_;
-  collision_detector_->cenv_unpadded_const_ = collision_detector_->cenv_unpadded_;
+  updateCollisionCheckVersion();
 }
 
 const collision_detection::CollisionEnvConstPtr&
@@ -333,6 +549,7 @@ void PlanningScene::clearDiffs()
   acm_.reset();
   object_colors_.reset();
   object_types_.reset();
+  updateCollisionCheckVersion();
 }
 
 void PlanningScene::pushDiffs(const PlanningScenePtr& scene)
@@ -362,8 +579,8 @@ void PlanningScene::pushDiffs(const PlanningScenePtr& scene)
     scene->getAllowedCollisionMatrixNonConst() = acm_.value();
 
   collision_detection::CollisionEnvPtr active_cenv = scene->getCollisionEnvNonConst();
-  active_cenv->setLinkPadding(collision_detector_->cenv_->getLinkPadding());
-  active_cenv->setLinkScale(collision_detector_->cenv_->getLinkScale());
+  active_cenv->setLinkPadding(collision_detector_->getLinkPadding());
+  active_cenv->setLinkScale(collision_detector_->getLinkScale());
 
   if (world_diff_)
   {
@@ -438,6 +655,7 @@ void PlanningScene::checkCollision(const collision_detection::CollisionRequest&
                                    const moveit::core::RobotState& robot_state,
                                    const collision_detection::AllowedCollisionMatrix& acm) const
 {
+  moveit::countWork(&moveit::WorkCounters::collision_checks);
   // check collision with the world using the padded version
   req.pad_environment_collisions ? getCollisionEnv()->checkRobotCollision(req, res, robot_state, acm) :
                                    getCollisionEnvUnpadded()->checkRobotCollision(req, res, robot_state, acm);
@@ -555,6 +773,7 @@ void PlanningScene::checkSelfCollision(const collision_detection::CollisionReque
                                        const moveit::core::RobotState& robot_state,
                                        const collision_detection::AllowedCollisionMatrix& acm) const
 {
+  moveit::countWork(&moveit::WorkCounters::collision_checks);
   req.pad_self_collisions ? getCollisionEnv()->checkSelfCollision(req, res, robot_state, acm) :
                             getCollisionEnvUnpadded()->checkSelfCollision(req, res, robot_state, acm);
 }
@@ -619,7 +838,8 @@ void PlanningScene::getCollidingLinks(std::vector<std::string>& links, const mov
 
 const collision_detection::CollisionEnvPtr& PlanningScene::getCollisionEnvNonConst()
 {
-  return collision_detector_->cenv_;
+  updateCollisionCheckVersion();
+  return collision_detector_->getCollisionEnvNonConst();
 }
 
 moveit::core::RobotState& PlanningScene::getCurrentStateNonConst()
@@ -658,6 +878,7 @@ void PlanningScene::setCollisionObjectUpdateCallback(const collision_detection::
 
 collision_detection::AllowedCollisionMatrix& PlanningScene::getAllowedCollisionMatrixNonConst()
 {
+  updateCollisionCheckVersion();
   if (!acm_.has_value())
     acm_.emplace(collision_detection::AllowedCollisionMatrix(parent_->getAllowedCollisionMatrix()));
   return acm_.value();
@@ -723,8 +944,8 @@ void PlanningScene::getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& sce
     scene_msg.allowed_collision_matrix = moveit_msgs::msg::AllowedCollisionMatrix();
   }
 
-  collision_detector_->cenv_->getPadding(scene_msg.link_padding);
-  collision_detector_->cenv_->getScale(scene_msg.link_scale);
+  collision_detector_->getPadding(scene_msg.link_padding);
+  collision_detector_->getScale(scene_msg.link_scale);
 
   scene_msg.object_colors.clear();
   if (object_colors_)
@@ -777,7 +998,10 @@ void PlanningScene::getPlanningSceneDiffMsg(moveit_msgs::msg::PlanningScene& sce
       else
       {
         scene_msg.world.collision_objects.emplace_back();
-        getCollisionObjectMsg(scene_msg.world.collision_objects.back(), it.first);
+        // objects that were only moved are sent without their (possibly large) geometry
+        if (it.second != collision_detection::World::MOVE_SHAPE ||
+            !getCollisionObjectMoveMsg(scene_msg.world.collision_objects.back(), it.first))
+          getCollisionObjectMsg(scene_msg.world.collision_objects.back(), it.first);
       }
     }
     if (do_omap)
@@ -875,6 +1099,65 @@ bool PlanningScene::getCollisionObjectMsg(moveit_msgs::msg::CollisionObject& col
   return true;
 }
 
+bool PlanningScene::getCollisionObjectMoveMsg(moveit_msgs::msg::CollisionObject& collision_obj,
+                                              const std::string& ns) const
+{
+  if (!parent_)
+    return false;
+  collision_detection::CollisionEnv::ObjectConstPtr obj = world_->getObject(ns);
+  collision_detection::CollisionEnv::ObjectConstPtr parent_obj = parent_->getWorld()->getObject(ns);
+  if (!obj || !parent_obj || obj->shapes_ != parent_obj->shapes_ ||
+      obj->subframe_poses_.size() != parent_obj->subframe_poses_.size())
+    return false;
+  for (const auto& [name, pose] : obj->subframe_poses_)
+  {
+    const auto parent_subframe = parent_obj->subframe_poses_.find(name);
+    if (parent_subframe == parent_obj->subframe_poses_.end() || !parent_subframe->second.isApprox(pose))
+      return false;
+  }
+
+  moveit_msgs::msg::CollisionObject move_obj;
+  move_obj.header.frame_id = getPlanningFrame();
+  move_obj.pose = tf2::toMsg(obj->pose_);
+  move_obj.id = ns;
+  move_obj.operation = moveit_msgs::msg::CollisionObject::MOVE;
+
+  // processCollisionObjectMove() assigns the poses of primitives, meshes and planes to the shapes in this order
+  int last_kind = 0;
+  for (std::size_t j = 0; j < obj->shapes_.size(); ++j)
+  {
+    int kind;
+    std::vector<geometry_msgs::msg::Pose>* poses;
+    switch (obj->shapes_[j]->type)
+    {
+      case shapes::SPHERE:
+      case shapes::CYLINDER:
+      case shapes::CONE:
+      case shapes::BOX:
+        kind = 0;
+        poses = &move_obj.primitive_poses;
+        break;
+      case shapes::MESH:
+        kind = 1;
+        poses = &move_obj.mesh_poses;
+        break;
+      case shapes::PLANE:
+        kind = 2;
+        poses = &move_obj.plane_poses;
+        break;
+      default:
+        return false;
+    }
+    if (kind < last_kind)
+      return false;
+    last_kind = kind;
+    poses->push_back(tf2::toMsg(obj->shape_poses_[j]));
+  }
+
+  collision_obj = std::move(move_obj);
+  return true;
+}
+
 void PlanningScene::getCollisionObjectMsgs(std::vector<moveit_msgs::msg::CollisionObject>& collision_objs) const
 {
   collision_objs.clear();
@@ -1273,6 +1556,9 @@ void PlanningScene::decoupleParent()
   if (!acm_.has_value())
     acm_.emplace(collision_detection::AllowedCollisionMatrix(parent_->getAllowedCollisionMatrix()));
 
+  // copy the collision environments now, as the parent may change once this scene is used independently of it
+  collision_detector_->allocate();
+
   world_diff_.reset();
 
   if (!object_colors_)
@@ -1314,6 +1600,7 @@ void PlanningScene::decoupleParent()
 bool PlanningScene::setPlanningSceneDiffMsg(const moveit_msgs::msg::PlanningScene& scene_msg)
 {
   bool result = true;
+  updateCollisionCheckVersion();
 
   RCLCPP_DEBUG(getLogger(), "Adding planning scene diff");
   if (!scene_msg.name.empty())
@@ -1345,8 +1632,8 @@ bool PlanningScene::setPlanningSceneDiffMsg(const moveit_msgs::msg::PlanningScen
 
   if (!scene_msg.link_padding.empty() || !scene_msg.link_scale.empty())
   {
-    collision_detector_->cenv_->setPadding(scene_msg.link_padding);
-    collision_detector_->cenv_->setScale(scene_msg.link_scale);
+    collision_detector_->setPadding(scene_msg.link_padding);
+    collision_detector_->setScale(scene_msg.link_scale);
   }
 
   // if any colors have been specified, replace the ones we have with the specified ones
@@ -1368,6 +1655,7 @@ bool PlanningScene::setPlanningSceneMsg(const moveit_msgs::msg::PlanningScene& s
 {
   assert(scene_msg.is_diff == false);
   RCLCPP_DEBUG(getLogger(), "Setting new planning scene: '%s'", scene_msg.name.c_str());
+  updateCollisionCheckVersion();
   name_ = scene_msg.name;
 
   if (!scene_msg.robot_model_name.empty() && scene_msg.robot_model_name != getRobotModel()->getName())
@@ -1383,8 +1671,8 @@ bool PlanningScene::setPlanningSceneMsg(const moveit_msgs::msg::PlanningScene& s
   scene_transforms_.value()->setTransforms(scene_msg.fixed_frame_transforms);
   setCurrentState(scene_msg.robot_state);
   acm_.emplace(collision_detection::AllowedCollisionMatrix(scene_msg.allowed_collision_matrix));
-  collision_detector_->cenv_->setPadding(scene_msg.link_padding);
-  collision_detector_->cenv_->setScale(scene_msg.link_scale);
+  collision_detector_->setPadding(scene_msg.link_padding);
+  collision_detector_->setScale(scene_msg.link_scale);
   object_colors_ = std::make_unique<ObjectColorMap>();
   original_object_colors_ = std::make_unique<ObjectColorMap>();
   for (const moveit_msgs::msg::ObjectColor& object_color : scene_msg.object_colors)
@@ -2216,14 +2504,50 @@ bool PlanningScene::isStateColliding(const std::string& group, bool verbose)
 
 bool PlanningScene::isStateColliding(const moveit::core::RobotState& state, const std::string& group, bool verbose) const
 {
+  // verbose checks are not memoized, so that they always report the contacts
+  const bool use_cache = collision_check_cache_ && !verbose;
+  std::string key;
+  std::uint64_t world_version = 0;
+  std::uint64_t scene_version = 0;
+  if (use_cache)
+  {
+    key = getCollisionCheckKey(state, group, collision_check_cache_->resolution);
+    world_version = world_->getVersion();
+    scene_version = getCollisionCheckVersion();
+    if (const std::optional<bool> collision = collision_check_cache_->find(key, world_version, scene_version))
+      return *collision;
+  }
+
   collision_detection::CollisionRequest req;
   req.verbose = verbose;
   req.group_name = group;
   collision_detection::CollisionResult res;
   checkCollision(req, res, state);
+
+  if (use_cache)
+    collision_check_cache_->insert(key, res.collision, world_version, scene_version);
   return res.collision;
 }
 
+void PlanningScene::setCollisionCheckCacheSize(std::size_t size, double resolution)
+{
+  if (size == 0)
+    collision_check_cache_.reset();
+  else
+    collision_check_cache_ = std::make_unique<CollisionCheckCache>(size, resolution);
+}
+
+std::uint64_t PlanningScene::getCollisionCheckVersion() const
+{
+  // versions increase monotonically, so the maximum changes whenever any scene of the chain changes
+  return parent_ ? std::max(collision_check_version_, parent_->getCollisionCheckVersion()) : collision_check_version_;
+}
+
+void PlanningScene::updateCollisionCheckVersion()
+{
+  collision_check_version_ = nextCollisionCheckVersion();
+}
+
 bool PlanningScene::isStateFeasible(const moveit_msgs::msg::RobotState& state, bool verbose) const
 {
   if (state_feasibility_)
@@ -2277,7 +2601,7 @@ bool PlanningScene::isStateConstrained(const moveit_msgs::msg::RobotState& state
 bool PlanningScene::isStateConstrained(const moveit::core::RobotState& state,
                                        const kinematic_constraints::KinematicConstraintSet& constr, bool verbose) const
 {
-  return constr.decide(state, verbose).satisfied;
+  return constr.isSatisfied(state, verbose);
 }
 
 bool PlanningScene::isStateValid(const moveit::core::RobotState& state, const std::string& group, bool verbose) const
@@ -2372,19 +2696,47 @@ bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& traject
     invalid_index->clear();
   kinematic_constraints::KinematicConstraintSet ks_p(getRobotModel());
   ks_p.add(path_constraints, getTransforms());
-  std::size_t n_wp = trajectory.getWayPointCount();
-  for (std::size_t i = 0; i < n_wp; ++i)
-  {
-    const moveit::core::RobotState& st = trajectory.getWayPoint(i);
-
+  const auto is_waypoint_valid = [&](const moveit::core::RobotState& st) {
     bool this_state_valid = true;
     if (isStateColliding(st, group, verbose))
       this_state_valid = false;
     if (!isStateFeasible(st, verbose))
       this_state_valid = false;
-    if (!ks_p.empty() && !ks_p.decide(st, verbose).satisfied)
+    if (!ks_p.empty() && !ks_p.isSatisfied(st, verbose))
       this_state_valid = false;
+    return this_state_valid;
+  };
+
+  std::size_t n_wp = trajectory.getWayPointCount();
+
+  // check the waypoints in parallel first, if enabled
+  std::vector<char> waypoint_valid;
+  if (path_validation_pool_ && n_wp > 1)
+  {
+    const std::vector<std::size_t> order = getBisectionOrder(n_wp);
+    waypoint_valid.assign(n_wp, 1);
+    std::atomic<bool> cancel{ false };
+    const bool ran = path_validation_pool_->tryRun(n_wp, [&](std::size_t k) {
+      if (cancel.load(std::memory_order_relaxed))
+        return;
+      const std::size_t i = order[k];
+      if (!is_waypoint_valid(trajectory.getWayPoint(i)))
+      {
+        waypoint_valid[i] = 0;
+        // without invalid_index, the first invalid waypoint decides the result
+        if (!invalid_index)
+          cancel.store(true, std::memory_order_relaxed);
+      }
+    });
+    if (!ran)
+      waypoint_valid.clear();
+  }
 
+  for (std::size_t i = 0; i < n_wp; ++i)
+  {
+    const moveit::core::RobotState& st = trajectory.getWayPoint(i);
+
+    const bool this_state_valid = waypoint_valid.empty() ? is_waypoint_valid(st) : waypoint_valid[i] != 0;
     if (!this_state_valid)
     {
       if (invalid_index)
@@ -2448,6 +2800,14 @@ bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& traject
   return isPathValid(trajectory, EMP_CONSTRAINTS, EMP_CONSTRAINTS_VECTOR, group, verbose, invalid_index);
 }
 
+void PlanningScene::setPathValidationThreadCount(std::size_t thread_count)
+{
+  if (thread_count > 1)
+    path_validation_pool_ = std::make_unique<collision_detection::CollisionThreadPool>(thread_count);
+  else
+    path_validation_pool_.reset();
+}
+
 void PlanningScene::getCostSources(const robot_trajectory::RobotTrajectory& trajectory, std::size_t max_costs,
                                    std::set<collision_detection::CostSource>& costs, double overlap_fraction) const
 {
@@ -0,0 +1,194 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Benchmarks of collision checking and planning scene operations on the standard test robots */
+
+// To run this benchmark, 'cd' to the build/moveit_core/planning_scene directory and directly run the binary.
+// Benchmarks take the robot as first argument: 0 for the panda, 1 for the pr2 and 2 for the fanuc.
+// Pass --benchmark_out=results.json --benchmark_out_format=json to store the results for comparison across
+// releases, e.g. with compare.py of Google Benchmark.
+
+#include <benchmark/benchmark.h>
+#include <geometric_shapes/shapes.h>
+#include <moveit/collision_detection/collision_matrix.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
+#include <moveit/robot_model/robot_model.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+
+namespace
+{
+// Number of random states collisions are checked for, cycled through by the benchmarks
+constexpr std::size_t STATE_COUNT = 100;
+
+// A planning scene with obstacles around the robot, and random states of a planning group
+struct BenchmarkScene
+{
+  planning_scene::PlanningScenePtr planning_scene;
+  std::vector<moveit::core::RobotState> states;
+};
+
+bool loadScene(int robot_index, BenchmarkScene& scene)
+{
+  static const char* const ROBOTS[] = { "panda", "pr2", "fanuc" };
+  static const char* const GROUPS[] = { "panda_arm", "right_arm", "manipulator" };
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel(ROBOTS[robot_index]);
+  if (!robot_model || !robot_model->hasJointModelGroup(GROUPS[robot_index]))
+    return false;
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(GROUPS[robot_index]);
+
+  scene.planning_scene = std::make_shared<planning_scene::PlanningScene>(robot_model);
+  // a table in front of the robot and a few boxes on it
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(0.8, 0.0, 0.2);
+  scene.planning_scene->getWorldNonConst()->addToObject("table", std::make_shared<shapes::Box>(0.6, 1.2, 0.05), pose);
+  for (int i = 0; i < 3; ++i)
+  {
+    pose.translation() = Eigen::Vector3d(0.7, -0.3 + 0.3 * i, 0.3);
+    scene.planning_scene->getWorldNonConst()->addToObject("box_" + std::to_string(i),
+                                                          std::make_shared<shapes::Box>(0.1, 0.1, 0.15), pose);
+  }
+
+  moveit::core::RobotState state(robot_model);
+  state.setToDefaultValues();
+  random_numbers::RandomNumberGenerator rng(0);
+  scene.states.assign(STATE_COUNT, state);
+  for (moveit::core::RobotState& random_state : scene.states)
+  {
+    random_state.setToRandomPositions(group, rng);
+    random_state.update();
+  }
+  return true;
+}
+
+void robotsAndDistance(benchmark::internal::Benchmark* benchmark)
+{
+  for (int robot_index : { 0, 1, 2 })
+  {
+    benchmark->Args({ robot_index, 0 });
+    benchmark->Args({ robot_index, 1 });
+  }
+}
+}  // namespace
+
+// Benchmark self-collision checking of random states, optionally computing the distance to collision
+static void checkSelfCollision(benchmark::State& st)
+{
+  BenchmarkScene scene;
+  if (!loadScene(st.range(0), scene))
+  {
+    st.SkipWithError("The robot model or planning group doesn't exist.");
+    return;
+  }
+  collision_detection::CollisionRequest req;
+  req.distance = st.range(1) != 0;
+
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    collision_detection::CollisionResult res;
+    scene.planning_scene->checkSelfCollision(req, res, scene.states[i++ % STATE_COUNT]);
+    benchmark::DoNotOptimize(res);
+  }
+}
+
+// Benchmark collision checking of random states against the robot and the world, optionally computing the distance
+static void checkCollision(benchmark::State& st)
+{
+  BenchmarkScene scene;
+  if (!loadScene(st.range(0), scene))
+  {
+    st.SkipWithError("The robot model or planning group doesn't exist.");
+    return;
+  }
+  collision_detection::CollisionRequest req;
+  req.distance = st.range(1) != 0;
+
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    collision_detection::CollisionResult res;
+    scene.planning_scene->checkCollision(req, res, scene.states[i++ % STATE_COUNT]);
+    benchmark::DoNotOptimize(res);
+  }
+}
+
+// Benchmark the lookup of all link pairs in the allowed collision matrix
+static void allowedCollisionMatrixGetEntry(benchmark::State& st)
+{
+  BenchmarkScene scene;
+  if (!loadScene(st.range(0), scene))
+  {
+    st.SkipWithError("The robot model or planning group doesn't exist.");
+    return;
+  }
+  const collision_detection::AllowedCollisionMatrix& acm = scene.planning_scene->getAllowedCollisionMatrix();
+  const std::vector<std::string>& links =
+      scene.planning_scene->getRobotModel()->getLinkModelNamesWithCollisionGeometry();
+
+  for (auto _ : st)
+  {
+    collision_detection::AllowedCollision::Type type;
+    for (const std::string& first : links)
+    {
+      for (const std::string& second : links)
+        benchmark::DoNotOptimize(acm.getEntry(first, second, type));
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * links.size() * links.size());
+}
+
+// Benchmark creating a diff of a planning scene and modifying its state
+static void planningSceneDiff(benchmark::State& st)
+{
+  BenchmarkScene scene;
+  if (!loadScene(st.range(0), scene))
+  {
+    st.SkipWithError("The robot model or planning group doesn't exist.");
+    return;
+  }
+
+  std::size_t i = 0;
+  for (auto _ : st)
+  {
+    planning_scene::PlanningScenePtr diff = scene.planning_scene->diff();
+    diff->setCurrentState(scene.states[i++ % STATE_COUNT]);
+    benchmark::DoNotOptimize(diff);
+  }
+}
+
+BENCHMARK(checkSelfCollision)->Apply(robotsAndDistance)->Unit(benchmark::kMicrosecond);
+BENCHMARK(checkCollision)->Apply(robotsAndDistance)->Unit(benchmark::kMicrosecond);
+BENCHMARK(allowedCollisionMatrixGetEntry)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMicrosecond);
+BENCHMARK(planningSceneDiff)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMicrosecond);
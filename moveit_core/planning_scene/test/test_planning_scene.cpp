@@ -40,6 +40,7 @@
 #include <moveit/utils/message_checks.hpp>
 #include <moveit/utils/robot_model_test_utils.hpp>
 #include <urdf_parser/urdf_parser.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -235,6 +236,50 @@ TEST(PlanningScene, MakeAttachedDiff)
   ps->checkCollision(req, res);
 }
 
+TEST(PlanningScene, MovedObjectDiff)
+{
+  urdf::ModelInterfaceSharedPtr urdf_model = moveit::core::loadModelInterface("pr2");
+  srdf::ModelSharedPtr srdf_model = std::make_shared<srdf::Model>();
+  auto ps = std::make_shared<planning_scene::PlanningScene>(urdf_model, srdf_model);
+
+  collision_detection::World& world = *ps->getWorldNonConst();
+  Eigen::Isometry3d id = Eigen::Isometry3d::Identity();
+  world.addToObject("object", std::make_shared<const shapes::Box>(0.1, 0.2, 0.3), id);
+  world.addToObject("object", std::make_shared<const shapes::Sphere>(0.4),
+                    Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)));
+
+  /* a second scene receiving the messages of ps */
+  auto receiver = std::make_shared<planning_scene::PlanningScene>(urdf_model, srdf_model);
+  moveit_msgs::msg::PlanningScene ps_msg;
+  ps->getPlanningSceneMsg(ps_msg);
+  receiver->setPlanningSceneMsg(ps_msg);
+
+  /* moving the object sends its poses, but not its geometry */
+  planning_scene::PlanningScenePtr next = ps->diff();
+  const Eigen::Isometry3d pose(Eigen::Translation3d(1, 2, 3));
+  next->getWorldNonConst()->setObjectPose("object", pose);
+  next->getPlanningSceneDiffMsg(ps_msg);
+  ASSERT_EQ(ps_msg.world.collision_objects.size(), 1u);
+  EXPECT_EQ(ps_msg.world.collision_objects[0].operation, moveit_msgs::msg::CollisionObject::MOVE);
+  EXPECT_TRUE(ps_msg.world.collision_objects[0].primitives.empty());
+  EXPECT_EQ(ps_msg.world.collision_objects[0].primitive_poses.size(), 2u);
+
+  EXPECT_TRUE(receiver->usePlanningSceneMsg(ps_msg));
+  ASSERT_TRUE(receiver->getWorld()->hasObject("object"));
+  EXPECT_TRUE(receiver->getWorld()->getObject("object")->pose_.isApprox(pose));
+  EXPECT_EQ(receiver->getWorld()->getObject("object")->shapes_.size(), 2u);
+
+  /* changing the geometry sends the whole object */
+  next->getWorldNonConst()->addToObject("object", std::make_shared<const shapes::Sphere>(0.1), id);
+  next->getPlanningSceneDiffMsg(ps_msg);
+  ASSERT_EQ(ps_msg.world.collision_objects.size(), 1u);
+  EXPECT_EQ(ps_msg.world.collision_objects[0].operation, moveit_msgs::msg::CollisionObject::ADD);
+  EXPECT_EQ(ps_msg.world.collision_objects[0].primitives.size(), 3u);
+
+  EXPECT_TRUE(receiver->usePlanningSceneMsg(ps_msg));
+  EXPECT_EQ(receiver->getWorld()->getObject("object")->shapes_.size(), 3u);
+}
+
 TEST(PlanningScene, isStateValid)
 {
   moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
@@ -246,6 +291,99 @@ TEST(PlanningScene, isStateValid)
   }
 }
 
+TEST(PlanningScene, CollisionCheckCache)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  auto ps = std::make_shared<planning_scene::PlanningScene>(robot_model->getURDF(), robot_model->getSRDF());
+  ps->setCollisionCheckCacheSize(10);
+  moveit::core::RobotState state = ps->getCurrentState();
+  state.update();
+  const bool initially_colliding = ps->isStateColliding(state, "right_arm");
+  EXPECT_EQ(ps->isStateColliding(state, "right_arm"), initially_colliding);
+
+  // changes of the world invalidate the memoized results
+  const Eigen::Isometry3d pose = state.getGlobalLinkTransform("r_wrist_roll_link");
+  ps->getWorldNonConst()->addToObject("box", std::make_shared<const shapes::Box>(0.2, 0.2, 0.2), pose);
+  EXPECT_TRUE(ps->isStateColliding(state, "right_arm"));
+
+  // as do changes of the allowed collision matrix of a parent scene
+  planning_scene::PlanningScenePtr next = ps->diff();
+  next->setCollisionCheckCacheSize(10);
+  EXPECT_TRUE(next->isStateColliding(state, "right_arm"));
+  ps->getAllowedCollisionMatrixNonConst().setDefaultEntry("box", true);
+  EXPECT_EQ(next->isStateColliding(state, "right_arm"), initially_colliding);
+}
+
+TEST(PlanningScene, LazyCollisionEnvDiff)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  auto ps = std::make_shared<planning_scene::PlanningScene>(robot_model->getURDF(), robot_model->getSRDF());
+  moveit::core::RobotState state = ps->getCurrentState();
+  state.update();
+  const bool initially_colliding = ps->isStateColliding(state, "right_arm");
+  const Eigen::Isometry3d pose = state.getGlobalLinkTransform("r_wrist_roll_link");
+
+  // the collision environments of diffs are allocated when they are first used, after either world changed
+  planning_scene::PlanningScenePtr unchanged = ps->diff();
+  planning_scene::PlanningScenePtr changed = ps->diff();
+  changed->getWorldNonConst()->addToObject("box", std::make_shared<const shapes::Box>(0.2, 0.2, 0.2), pose);
+  ps->getWorldNonConst()->addToObject("other_box", std::make_shared<const shapes::Box>(0.2, 0.2, 0.2), pose);
+  planning_scene::PlanningScenePtr copied = ps->diff();
+
+  EXPECT_EQ(unchanged->isStateColliding(state, "right_arm"), initially_colliding);
+  EXPECT_TRUE(changed->isStateColliding(state, "right_arm"));
+  EXPECT_TRUE(copied->isStateColliding(state, "right_arm"));
+  EXPECT_TRUE(ps->isStateColliding(state, "right_arm"));
+
+  // padding set before the environment is allocated is applied to it
+  planning_scene::PlanningScenePtr padded = ps->diff();
+  moveit_msgs::msg::PlanningScene ps_msg;
+  ps_msg.is_diff = true;
+  moveit_msgs::msg::LinkPadding link_padding;
+  link_padding.link_name = "r_wrist_roll_link";
+  link_padding.padding = 0.1;
+  ps_msg.link_padding.push_back(link_padding);
+  EXPECT_TRUE(padded->usePlanningSceneMsg(ps_msg));
+  padded->getPlanningSceneMsg(ps_msg);
+  EXPECT_TRUE(std::any_of(ps_msg.link_padding.begin(), ps_msg.link_padding.end(), [](const auto& lp) {
+    return lp.link_name == "r_wrist_roll_link" && lp.padding == 0.1;
+  }));
+  EXPECT_DOUBLE_EQ(padded->getCollisionEnv()->getLinkPadding("r_wrist_roll_link"), 0.1);
+  EXPECT_DOUBLE_EQ(ps->getCollisionEnv()->getLinkPadding("r_wrist_roll_link"), 0.0);
+}
+
+TEST(PlanningScene, ParallelPathValidation)
+{
+  moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
+  auto ps = std::make_shared<planning_scene::PlanningScene>(robot_model->getURDF(), robot_model->getSRDF());
+  ps->setStateFeasibilityPredicate([](const moveit::core::RobotState& state, bool /*verbose*/) {
+    const double position = state.getVariablePosition("r_shoulder_pan_joint");
+    return position < 0.095 || position > 0.125;
+  });
+
+  robot_trajectory::RobotTrajectory trajectory(robot_model);
+  moveit::core::RobotState state = ps->getCurrentState();
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    state.setVariablePosition("r_shoulder_pan_joint", 0.01 * i);
+    state.update();
+    trajectory.addSuffixWayPoint(state, 0.1);
+  }
+
+  std::vector<std::size_t> sequential_invalid;
+  const bool sequential_valid = ps->isPathValid(trajectory, "", false, &sequential_invalid);
+  EXPECT_FALSE(sequential_valid);
+
+  ps->setPathValidationThreadCount(4);
+  EXPECT_EQ(ps->getPathValidationThreadCount(), 4u);
+  std::vector<std::size_t> parallel_invalid;
+  EXPECT_EQ(ps->isPathValid(trajectory, "", false, &parallel_invalid), sequential_valid);
+  EXPECT_EQ(parallel_invalid, sequential_invalid);
+  for (std::size_t i : { 10, 11, 12 })
+    EXPECT_NE(std::find(parallel_invalid.begin(), parallel_invalid.end(), i), parallel_invalid.end());
+  EXPECT_FALSE(ps->isPathValid(trajectory));
+}
+
 TEST(PlanningScene, loadGoodSceneGeometryNewFormat)
 {
   moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("pr2");
@@ -0,0 +1,181 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Voxelized map of the workspace poses a planning group can reach, with representative IK seeds per voxel */
+
+#pragma once
+
+#include <moveit/macros/class_forward.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <Eigen/Geometry>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** \brief Namespace for the workspace reachability map */
+namespace reachability_map
+{
+MOVEIT_CLASS_FORWARD(ReachabilityMap);  // Defines ReachabilityMapPtr, ConstPtr, WeakPtr... etc
+
+/**
+ * \brief Voxelized map of the tip poses a planning group reaches, relative to a base frame.
+ *
+ * Each occupied voxel stores the set of reachable orientations and a few joint configurations reaching it, which
+ * seed IK much better than random restarts. Orientations are binned by the direction of the tip's z axis, rotations
+ * about that axis are not distinguished. The map is generated offline by sampling the joint space, so it can only
+ * be as complete as the sampling was dense: a missing voxel means that no sample reached it.
+ */
+class ReachabilityMap
+{
+public:
+  /** \brief The number of orientation bins, 3x3 cells on each face of a cube around the tip */
+  static constexpr std::size_t NUM_ORIENTATION_BINS = 54;
+
+  /**
+   * \brief Construct an empty map
+   * \param group_name The planning group whose reachability is mapped
+   * \param base_frame The link the tip poses are expressed in
+   * \param tip_frame The link whose poses are mapped
+   * \param joint_names The variables of a seed, in the order of its values
+   * \param resolution The edge length of a voxel in meters
+   * \param max_seeds_per_voxel The maximum number of joint configurations kept per voxel
+   */
+  ReachabilityMap(const std::string& group_name, const std::string& base_frame, const std::string& tip_frame,
+                  const std::vector<std::string>& joint_names, double resolution, std::size_t max_seeds_per_voxel = 4);
+
+  /**
+   * \brief Generate a map by sampling random configurations of a group
+   * \param state The state providing the values of the joints outside the group, e.g. of a mobile base
+   * \param group The group to sample, seeds hold the values of its variables
+   * \param base_frame The link the tip poses are expressed in
+   * \param tip_frame The link whose poses are mapped
+   * \param resolution The edge length of a voxel in meters
+   * \param num_samples The number of random configurations to sample
+   * \param validity_callback Optional check rejecting samples, e.g. because of self-collision
+   * \return The map, or nullptr if the frames are unknown
+   */
+  static ReachabilityMapPtr generate(const moveit::core::RobotState& state, const moveit::core::JointModelGroup* group,
+                                     const std::string& base_frame, const std::string& tip_frame, double resolution,
+                                     std::size_t num_samples,
+                                     const moveit::core::GroupStateValidityCallbackFn& validity_callback =
+                                         moveit::core::GroupStateValidityCallbackFn());
+
+  /** \brief Load a map from a file written by save(), returns nullptr on failure */
+  static ReachabilityMapPtr load(const std::string& file_name);
+
+  /** \brief Write the map to a binary file */
+  bool save(const std::string& file_name) const;
+
+  /** \brief Add a sampled configuration reaching \e tip_pose, given relative to the base frame */
+  void addSample(const Eigen::Isometry3d& tip_pose, const std::vector<double>& joint_values);
+
+  /** \brief Check whether any sample reached the voxel of \e position, given relative to the base frame */
+  bool isPositionReachable(const Eigen::Vector3d& position) const;
+
+  /** \brief Check whether any sample reached the voxel and orientation bin of \e pose, relative to the base frame */
+  bool isReachable(const Eigen::Isometry3d& pose) const;
+
+  /**
+   * \brief Check whether any sample reached a voxel overlapping a sphere, given relative to the base frame
+   * \param center The center of the sphere
+   * \param radius The radius of the sphere, e.g. the bounding radius of a goal region
+   * \param max_voxels The maximum number of voxels to look up; larger spheres are assumed to be reachable
+   */
+  bool isRegionReachable(const Eigen::Vector3d& center, double radius, std::size_t max_voxels = 4096) const;
+
+  /**
+   * \brief Get the joint configurations stored for the voxel of \e pose, given relative to the base frame
+   * \param[out] seeds The configurations, those reaching the orientation bin of \e pose first
+   * \return False if no sample reached the voxel
+   */
+  bool getSeeds(const Eigen::Isometry3d& pose, std::vector<std::vector<double>>& seeds) const;
+
+  const std::string& getGroupName() const
+  {
+    return group_name_;
+  }
+
+  const std::string& getBaseFrame() const
+  {
+    return base_frame_;
+  }
+
+  const std::string& getTipFrame() const
+  {
+    return tip_frame_;
+  }
+
+  const std::vector<std::string>& getJointNames() const
+  {
+    return joint_names_;
+  }
+
+  double getResolution() const
+  {
+    return resolution_;
+  }
+
+  /** \brief Get the number of voxels reached by any sample */
+  std::size_t getNumVoxels() const
+  {
+    return voxels_.size();
+  }
+
+  /** \brief Get the orientation bin of \e orientation, from the direction of its z axis */
+  static std::size_t getOrientationBin(const Eigen::Matrix3d& orientation);
+
+private:
+  struct Voxel
+  {
+    /** \brief Bit i is set if the orientation bin i was reached */
+    std::uint64_t orientations = 0;
+    /** \brief The orientation bin of each seed */
+    std::vector<std::uint8_t> seed_bins;
+    /** \brief The seeds, one after another */
+    std::vector<double> seeds;
+  };
+
+  std::uint64_t getVoxelKey(const Eigen::Vector3d& position) const;
+
+  std::string group_name_;
+  std::string base_frame_;
+  std::string tip_frame_;
+  std::vector<std::string> joint_names_;
+  double resolution_;
+  std::size_t max_seeds_per_voxel_;
+  std::unordered_map<std::uint64_t, Voxel> voxels_;
+};
+}  // namespace reachability_map
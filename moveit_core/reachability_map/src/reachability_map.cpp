@@ -0,0 +1,332 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/reachability_map/reachability_map.hpp>
+#include <moveit/utils/logger.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace reachability_map
+{
+namespace
+{
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.core.reachability_map");
+}
+
+// bump when the file layout changes
+constexpr std::uint32_t FILE_VERSION = 1;
+// bits per voxel coordinate in a voxel key
+constexpr int KEY_BITS = 21;
+constexpr std::int64_t KEY_OFFSET = std::int64_t(1) << (KEY_BITS - 1);
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value)
+{
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeString(std::ofstream& file, const std::string& value)
+{
+  writeValue(file, static_cast<std::uint64_t>(value.size()));
+  file.write(value.data(), value.size());
+}
+
+bool readString(std::ifstream& file, std::string& value)
+{
+  std::uint64_t size;
+  if (!readValue(file, size))
+    return false;
+  value.resize(size);
+  return static_cast<bool>(file.read(value.data(), size));
+}
+}  // namespace
+
+ReachabilityMap::ReachabilityMap(const std::string& group_name, const std::string& base_frame,
+                                 const std::string& tip_frame, const std::vector<std::string>& joint_names,
+                                 double resolution, std::size_t max_seeds_per_voxel)
+  : group_name_(group_name)
+  , base_frame_(base_frame)
+  , tip_frame_(tip_frame)
+  , joint_names_(joint_names)
+  , resolution_(resolution)
+  , max_seeds_per_voxel_(max_seeds_per_voxel)
+{
+}
+
+ReachabilityMapPtr ReachabilityMap::generate(const moveit::core::RobotState& state,
+                                             const moveit::core::JointModelGroup* group, const std::string& base_frame,
+                                             const std::string& tip_frame, double resolution, std::size_t num_samples,
+                                             const moveit::core::GroupStateValidityCallbackFn& validity_callback)
+{
+  const moveit::core::RobotModel& robot_model = state.getRobotModel();
+  if (!robot_model.hasLinkModel(base_frame) || !robot_model.hasLinkModel(tip_frame))
+  {
+    RCLCPP_ERROR(getLogger(), "Unknown base frame '%s' or tip frame '%s'", base_frame.c_str(), tip_frame.c_str());
+    return ReachabilityMapPtr();
+  }
+
+  auto map = std::make_shared<ReachabilityMap>(group->getName(), base_frame, tip_frame,
+                                               group->getVariableNames(), resolution);
+  moveit::core::RobotState sample_state(state);
+  std::vector<double> joint_values;
+  for (std::size_t i = 0; i < num_samples; ++i)
+  {
+    sample_state.setToRandomPositions(group);
+    sample_state.updateLinkTransforms();
+    sample_state.copyJointGroupPositions(group, joint_values);
+    if (validity_callback && !validity_callback(&sample_state, group, joint_values.data()))
+      continue;
+    map->addSample(sample_state.getGlobalLinkTransform(base_frame).inverse() *
+                       sample_state.getGlobalLinkTransform(tip_frame),
+                   joint_values);
+  }
+  return map;
+}
+
+ReachabilityMapPtr ReachabilityMap::load(const std::string& file_name)
+{
+  std::ifstream file(file_name, std::ios_base::binary | std::ios_base::in);
+  if (!file)
+  {
+    RCLCPP_ERROR(getLogger(), "Unable to open reachability map %s", file_name.c_str());
+    return ReachabilityMapPtr();
+  }
+
+  std::uint32_t version;
+  std::string group_name, base_frame, tip_frame;
+  std::uint64_t num_joints;
+  if (!readValue(file, version) || version != FILE_VERSION || !readString(file, group_name) ||
+      !readString(file, base_frame) || !readString(file, tip_frame) || !readValue(file, num_joints))
+  {
+    RCLCPP_ERROR(getLogger(), "%s is not a reachability map of version %u", file_name.c_str(), FILE_VERSION);
+    return ReachabilityMapPtr();
+  }
+  std::vector<std::string> joint_names(num_joints);
+  for (std::string& joint_name : joint_names)
+    readString(file, joint_name);
+  double resolution;
+  std::uint64_t max_seeds_per_voxel, num_voxels;
+  readValue(file, resolution);
+  readValue(file, max_seeds_per_voxel);
+  readValue(file, num_voxels);
+
+  auto map = std::make_shared<ReachabilityMap>(group_name, base_frame, tip_frame, joint_names, resolution,
+                                               max_seeds_per_voxel);
+  map->voxels_.reserve(num_voxels);
+  for (std::uint64_t i = 0; i < num_voxels && file; ++i)
+  {
+    std::uint64_t key, num_seeds;
+    Voxel voxel;
+    readValue(file, key);
+    readValue(file, voxel.orientations);
+    readValue(file, num_seeds);
+    if (!file || num_seeds > max_seeds_per_voxel)
+      break;
+    voxel.seed_bins.resize(num_seeds);
+    voxel.seeds.resize(num_seeds * num_joints);
+    file.read(reinterpret_cast<char*>(voxel.seed_bins.data()), voxel.seed_bins.size());
+    file.read(reinterpret_cast<char*>(voxel.seeds.data()), voxel.seeds.size() * sizeof(double));
+    if (file)
+      map->voxels_.emplace(key, std::move(voxel));
+  }
+  if (map->voxels_.size() != num_voxels)
+  {
+    RCLCPP_ERROR(getLogger(), "Reachability map %s is truncated", file_name.c_str());
+    return ReachabilityMapPtr();
+  }
+
+  RCLCPP_INFO(getLogger(), "Loaded a reachability map of %zu voxels for group %s from %s", map->voxels_.size(),
+              group_name.c_str(), file_name.c_str());
+  return map;
+}
+
+bool ReachabilityMap::save(const std::string& file_name) const
+{
+  std::ofstream file(file_name, std::ios_base::binary | std::ios_base::out);
+  if (!file)
+  {
+    RCLCPP_ERROR(getLogger(), "Unable to write reachability map %s", file_name.c_str());
+    return false;
+  }
+
+  writeValue(file, FILE_VERSION);
+  writeString(file, group_name_);
+  writeString(file, base_frame_);
+  writeString(file, tip_frame_);
+  writeValue(file, static_cast<std::uint64_t>(joint_names_.size()));
+  for (const std::string& joint_name : joint_names_)
+    writeString(file, joint_name);
+  writeValue(file, resolution_);
+  writeValue(file, static_cast<std::uint64_t>(max_seeds_per_voxel_));
+  writeValue(file, static_cast<std::uint64_t>(voxels_.size()));
+  for (const auto& [key, voxel] : voxels_)
+  {
+    writeValue(file, key);
+    writeValue(file, voxel.orientations);
+    writeValue(file, static_cast<std::uint64_t>(voxel.seed_bins.size()));
+    file.write(reinterpret_cast<const char*>(voxel.seed_bins.data()), voxel.seed_bins.size());
+    file.write(reinterpret_cast<const char*>(voxel.seeds.data()), voxel.seeds.size() * sizeof(double));
+  }
+  return static_cast<bool>(file);
+}
+
+void ReachabilityMap::addSample(const Eigen::Isometry3d& tip_pose, const std::vector<double>& joint_values)
+{
+  Voxel& voxel = voxels_[getVoxelKey(tip_pose.translation())];
+  const std::size_t bin = getOrientationBin(tip_pose.linear());
+  const std::uint64_t bin_mask = std::uint64_t(1) << bin;
+
+  // keep the seeds spread over orientations: a new orientation replaces a seed of an orientation reached twice
+  if (voxel.seed_bins.size() < max_seeds_per_voxel_)
+  {
+    voxel.seed_bins.push_back(static_cast<std::uint8_t>(bin));
+    voxel.seeds.insert(voxel.seeds.end(), joint_values.begin(), joint_values.end());
+  }
+  else if ((voxel.orientations & bin_mask) == 0)
+  {
+    for (std::size_t i = 1; i < voxel.seed_bins.size(); ++i)
+    {
+      if (std::find(voxel.seed_bins.begin(), voxel.seed_bins.begin() + i, voxel.seed_bins[i]) !=
+          voxel.seed_bins.begin() + i)
+      {
+        voxel.seed_bins[i] = static_cast<std::uint8_t>(bin);
+        std::copy(joint_values.begin(), joint_values.end(), voxel.seeds.begin() + i * joint_names_.size());
+        break;
+      }
+    }
+  }
+  voxel.orientations |= bin_mask;
+}
+
+bool ReachabilityMap::isPositionReachable(const Eigen::Vector3d& position) const
+{
+  return voxels_.find(getVoxelKey(position)) != voxels_.end();
+}
+
+bool ReachabilityMap::isReachable(const Eigen::Isometry3d& pose) const
+{
+  const auto it = voxels_.find(getVoxelKey(pose.translation()));
+  return it != voxels_.end() && (it->second.orientations & (std::uint64_t(1) << getOrientationBin(pose.linear())));
+}
+
+bool ReachabilityMap::isRegionReachable(const Eigen::Vector3d& center, double radius, std::size_t max_voxels) const
+{
+  if (isPositionReachable(center))
+    return true;
+
+  // a voxel overlaps the sphere if its center is closer than the radius plus half its diagonal
+  const double max_distance = radius + resolution_ * std::sqrt(3.0) / 2.0;
+  const int extent = static_cast<int>(std::ceil(max_distance / resolution_));
+  const std::size_t side = 2 * extent + 1;
+  if (side * side * side > max_voxels)
+    return true;
+
+  const Eigen::Vector3d center_voxel = ((center / resolution_).array().floor() + 0.5) * resolution_;
+  for (int x = -extent; x <= extent; ++x)
+  {
+    for (int y = -extent; y <= extent; ++y)
+    {
+      for (int z = -extent; z <= extent; ++z)
+      {
+        const Eigen::Vector3d voxel = center_voxel + Eigen::Vector3d(x, y, z) * resolution_;
+        if ((voxel - center).norm() <= max_distance && isPositionReachable(voxel))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool ReachabilityMap::getSeeds(const Eigen::Isometry3d& pose, std::vector<std::vector<double>>& seeds) const
+{
+  seeds.clear();
+  const auto it = voxels_.find(getVoxelKey(pose.translation()));
+  if (it == voxels_.end())
+    return false;
+
+  const Voxel& voxel = it->second;
+  const std::size_t num_joints = joint_names_.size();
+  const std::uint8_t bin = static_cast<std::uint8_t>(getOrientationBin(pose.linear()));
+  for (std::size_t i = 0; i < voxel.seed_bins.size(); ++i)
+  {
+    const auto seed_begin = voxel.seeds.begin() + i * num_joints;
+    if (voxel.seed_bins[i] == bin)
+      seeds.emplace(seeds.begin(), seed_begin, seed_begin + num_joints);
+    else
+      seeds.emplace_back(seed_begin, seed_begin + num_joints);
+  }
+  return true;
+}
+
+std::size_t ReachabilityMap::getOrientationBin(const Eigen::Matrix3d& orientation)
+{
+  const Eigen::Vector3d axis = orientation.col(2);
+  Eigen::Index face_axis;
+  axis.cwiseAbs().maxCoeff(&face_axis);
+  const std::size_t face = 2 * face_axis + (axis[face_axis] < 0.0 ? 1 : 0);
+
+  // project the axis onto the cube face, the other two coordinates are within [-1, 1]
+  std::size_t cells[2];
+  for (int i = 0, j = 0; i < 3; ++i)
+  {
+    if (i == face_axis)
+      continue;
+    const double u = axis[i] / std::abs(axis[face_axis]);
+    cells[j++] = std::min<std::size_t>(2, static_cast<std::size_t>((u + 1.0) * 1.5));
+  }
+  return face * 9 + cells[0] * 3 + cells[1];
+}
+
+std::uint64_t ReachabilityMap::getVoxelKey(const Eigen::Vector3d& position) const
+{
+  std::uint64_t key = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const auto index = static_cast<std::int64_t>(std::floor(position[i] / resolution_)) + KEY_OFFSET;
+    key = (key << KEY_BITS) | (static_cast<std::uint64_t>(std::clamp<std::int64_t>(index, 0, 2 * KEY_OFFSET - 1)));
+  }
+  return key;
+}
+}  // namespace reachability_map
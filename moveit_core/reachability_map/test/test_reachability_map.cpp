@@ -0,0 +1,157 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/reachability_map/reachability_map.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <set>
+
+class PandaReachabilityMap : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    group_ = robot_model_->getJointModelGroup("panda_arm");
+    ASSERT_TRUE(group_);
+    state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
+    state_->setToDefaultValues();
+    map_ = reachability_map::ReachabilityMap::generate(*state_, group_, "panda_link0", "panda_link8", 0.1, 2000);
+    ASSERT_TRUE(map_);
+  }
+
+  Eigen::Isometry3d tipPose(moveit::core::RobotState& state) const
+  {
+    state.updateLinkTransforms();
+    return state.getGlobalLinkTransform("panda_link0").inverse() * state.getGlobalLinkTransform("panda_link8");
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  const moveit::core::JointModelGroup* group_;
+  moveit::core::RobotStatePtr state_;
+  reachability_map::ReachabilityMapPtr map_;
+};
+
+TEST_F(PandaReachabilityMap, OrientationBins)
+{
+  std::set<std::size_t> bins;
+  for (int i = 0; i < 1000; ++i)
+  {
+    const std::size_t bin =
+        reachability_map::ReachabilityMap::getOrientationBin(Eigen::Quaterniond::UnitRandom().toRotationMatrix());
+    EXPECT_LT(bin, reachability_map::ReachabilityMap::NUM_ORIENTATION_BINS);
+    bins.insert(bin);
+  }
+  // random orientations hit most bins
+  EXPECT_GT(bins.size(), reachability_map::ReachabilityMap::NUM_ORIENTATION_BINS / 2);
+}
+
+TEST_F(PandaReachabilityMap, Generate)
+{
+  EXPECT_GT(map_->getNumVoxels(), 0u);
+  EXPECT_EQ(map_->getJointNames(), group_->getVariableNames());
+
+  // every reached pose is in the map and has a seed reaching the same voxel
+  moveit::core::RobotState state(*state_);
+  std::vector<double> joint_values;
+  std::vector<std::vector<double>> seeds;
+  for (int i = 0; i < 20; ++i)
+  {
+    state.setToRandomPositions(group_);
+    const Eigen::Isometry3d pose = tipPose(state);
+    state.copyJointGroupPositions(group_, joint_values);
+    map_->addSample(pose, joint_values);
+    EXPECT_TRUE(map_->isPositionReachable(pose.translation()));
+    EXPECT_TRUE(map_->isReachable(pose));
+    ASSERT_TRUE(map_->getSeeds(pose, seeds));
+    EXPECT_FALSE(seeds.empty());
+    EXPECT_LE(seeds.size(), 4u);
+  }
+
+  for (int i = 0; i < 20; ++i)
+  {
+    state.setToRandomPositions(group_);
+    const Eigen::Isometry3d pose = tipPose(state);
+    if (!map_->getSeeds(pose, seeds))
+      continue;
+    for (const std::vector<double>& seed : seeds)
+    {
+      state.setJointGroupPositions(group_, seed);
+      EXPECT_TRUE(map_->isPositionReachable(tipPose(state).translation()));
+    }
+  }
+
+  // far beyond the arm's reach
+  EXPECT_FALSE(map_->isPositionReachable(Eigen::Vector3d(5.0, 0.0, 0.0)));
+  EXPECT_FALSE(map_->isRegionReachable(Eigen::Vector3d(5.0, 0.0, 0.0), 0.5));
+  EXPECT_TRUE(map_->isRegionReachable(Eigen::Vector3d(5.0, 0.0, 0.0), 4.6, 1000000));
+  // regions too large to look up are assumed to be reachable
+  EXPECT_TRUE(map_->isRegionReachable(Eigen::Vector3d(50.0, 0.0, 0.0), 10.0));
+  EXPECT_FALSE(map_->isReachable(Eigen::Isometry3d(Eigen::Translation3d(0.0, 0.0, -5.0))));
+}
+
+TEST_F(PandaReachabilityMap, SaveAndLoad)
+{
+  const std::string file_name = testing::TempDir() + "panda_arm_reachability.map";
+  ASSERT_TRUE(map_->save(file_name));
+  const reachability_map::ReachabilityMapConstPtr loaded = reachability_map::ReachabilityMap::load(file_name);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(loaded->getGroupName(), "panda_arm");
+  EXPECT_EQ(loaded->getBaseFrame(), "panda_link0");
+  EXPECT_EQ(loaded->getTipFrame(), "panda_link8");
+  EXPECT_EQ(loaded->getJointNames(), map_->getJointNames());
+  EXPECT_DOUBLE_EQ(loaded->getResolution(), map_->getResolution());
+  EXPECT_EQ(loaded->getNumVoxels(), map_->getNumVoxels());
+
+  moveit::core::RobotState state(*state_);
+  std::vector<std::vector<double>> seeds, loaded_seeds;
+  for (int i = 0; i < 50; ++i)
+  {
+    state.setToRandomPositions(group_);
+    const Eigen::Isometry3d pose = tipPose(state);
+    EXPECT_EQ(loaded->isReachable(pose), map_->isReachable(pose));
+    EXPECT_EQ(loaded->getSeeds(pose, loaded_seeds), map_->getSeeds(pose, seeds));
+    EXPECT_EQ(loaded_seeds, seeds);
+  }
+  std::remove(file_name.c_str());
+
+  EXPECT_FALSE(reachability_map::ReachabilityMap::load(file_name));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -405,6 +405,17 @@ public:
   double distance(const double* state1, const double* state2) const;
   void interpolate(const double* from, const double* to, double t, double* state) const;
 
+  /** \brief Compute the distance from \e state to each of the \e count group states stored one after the other in
+      \e states (e.g. the columns of a getVariableCount() x count matrix), writing them to \e distances.
+      Equivalent to calling distance() for every state, but much faster for groups made only of prismatic and
+      non-continuous revolute joints. */
+  void distances(const double* state, const double* states, std::size_t count, double* distances) const;
+
+  /** \brief Interpolate between \e from and \e to at each of the \e count interpolation parameters in \e t,
+      writing the group states one after the other to \e states. Equivalent to calling interpolate() for every
+      parameter, but much faster for groups made only of prismatic and non-continuous revolute joints. */
+  void interpolate(const double* from, const double* to, const double* t, std::size_t count, double* states) const;
+
   /** \brief Get the number of variables that describe this joint group. This includes variables necessary for mimic
       joints, so will always be >= getActiveVariableCount() */
   unsigned int getVariableCount() const
@@ -727,6 +738,11 @@ protected:
       the index values in variable_index_list_ are consecutive integers */
   bool is_contiguous_index_list_;
 
+  /** \brief Distance factors of all variables, if the group consists only of single-variable joints whose distance
+      is the weighted absolute difference of their values (prismatic and non-continuous revolute joints, no mimic
+      joints). Empty otherwise. Enables the vectorized batch distance and interpolation. */
+  Eigen::VectorXd linear_distance_factors_;
+
   /** \brief The set of labelled subgroups that are included in this group */
   std::vector<std::string> subgroup_names_;
 
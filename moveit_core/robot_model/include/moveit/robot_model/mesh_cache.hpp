@@ -0,0 +1,75 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_model/robot_model.hpp>
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief Process-wide cache of the meshes referenced by robot descriptions.
+
+    Several RobotModel instances are often created for the same robot within one process (e.g. move_group, servo
+    and hybrid planning components as composable nodes). All of them obtain their collision meshes from this cache,
+    so every mesh resource is parsed once and its geometry is shared between the models. Entries are reference
+    counted: a mesh is released when no model uses it anymore. The cache is thread-safe. */
+class MeshCache
+{
+public:
+  /** \brief The cache instance shared by all RobotModel instances of the process */
+  static MeshCache& getGlobal();
+
+  /** \brief Get the mesh for \e resource at \e scale. If it is not cached, it is loaded using \e loader, or from the
+      resource itself if no loader is given. Returns nullptr if the mesh cannot be loaded. */
+  shapes::ShapeConstPtr getMesh(const std::string& resource, const Eigen::Vector3d& scale,
+                                const MeshLoaderFn& loader = MeshLoaderFn());
+
+  /** \brief Number of meshes currently in use */
+  std::size_t size() const;
+
+private:
+  using Key = std::pair<std::string, std::array<double, 3>>;
+
+  mutable std::mutex mutex_;
+  std::map<Key, shapes::ShapeConstWeakPtr> meshes_;
+};
+}  // namespace core
+}  // namespace moveit
@@ -0,0 +1,121 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief Immutable hash table mapping names to indices.
+
+    RobotModel builds one table each for its links, joints and variables when the model is loaded, so lookups by
+    name on hot paths hash the name once and probe a flat array instead of walking a std::map. The table is never
+    modified after construction, so concurrent lookups need no locking. */
+class NameIndexTable
+{
+public:
+  NameIndexTable() = default;
+
+  /** \brief Map each name to its position in \e names */
+  explicit NameIndexTable(const std::vector<std::string>& names);
+
+  /** \brief Map each key of \e entries to its value */
+  explicit NameIndexTable(const std::map<std::string, std::size_t>& entries);
+
+  /** \brief Get the index for \e name, or -1 if the name is not in the table */
+  int find(std::string_view name) const
+  {
+    if (slots_.empty())
+      return -1;
+    const std::uint64_t hash = computeHash(name);
+    for (std::size_t slot = hash & mask_;; slot = (slot + 1) & mask_)
+    {
+      const int entry = slots_[slot];
+      if (entry < 0)
+        return -1;
+      const Entry& e = entries_[entry];
+      if (e.hash == hash && e.name == name)
+        return e.index;
+    }
+  }
+
+  /** \brief Check if \e name is in the table */
+  bool contains(std::string_view name) const
+  {
+    return find(name) >= 0;
+  }
+
+  /** \brief Number of names in the table */
+  std::size_t size() const
+  {
+    return entries_.size();
+  }
+
+  /** \brief The hash function used by the table (64-bit FNV-1a) */
+  static std::uint64_t computeHash(std::string_view name)
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : name)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+private:
+  struct Entry
+  {
+    std::uint64_t hash;
+    int index;
+    std::string name;
+  };
+
+  void build();
+
+  std::vector<Entry> entries_;
+
+  /** \brief Open addressing with linear probing; each slot holds a position in entries_ or -1 */
+  std::vector<int> slots_;
+  std::size_t mask_ = 0;
+};
+}  // namespace core
+}  // namespace moveit
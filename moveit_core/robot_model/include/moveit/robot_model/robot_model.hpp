@@ -48,8 +48,10 @@
 #include <moveit/robot_model/planar_joint_model.hpp>
 #include <moveit/robot_model/revolute_joint_model.hpp>
 #include <moveit/robot_model/prismatic_joint_model.hpp>
+#include <moveit/robot_model/name_index_table.hpp>
 #include <rclcpp/logging.hpp>
 #include <Eigen/Geometry>
+#include <functional>
 #include <iostream>
 
 /** \brief Main namespace for MoveIt */
@@ -70,6 +72,9 @@ static inline void checkInterpolationParamBounds(const rclcpp::Logger& logger, d
   RCLCPP_WARN_STREAM_EXPRESSION(logger, t < 0. || t > 1., "Interpolation parameter is not in the range [0, 1]: " << t);
 }
 
+/** \brief Function loading the mesh at \e resource (as referenced in the URDF) with the given \e scale */
+typedef std::function<shapes::ShapePtr(const std::string& resource, const Eigen::Vector3d& scale)> MeshLoaderFn;
+
 /** \brief Definition of a kinematic model. This class is not thread
     safe, however multiple instances can be created */
 class RobotModel
@@ -78,6 +83,12 @@ public:
   /** \brief Construct a kinematic model from a parsed description and a list of planning groups */
   RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model);
 
+  /** \brief Construct a kinematic model, loading the meshes of the collision geometry that are not in the MeshCache
+      yet through \e mesh_loader (e.g. from a RobotModelSnapshot) instead of from their resources. \e mesh_loader is
+      only used during construction. */
+  RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model,
+             const MeshLoaderFn& mesh_loader);
+
   /** \brief Destructor. Clear all memory. */
   ~RobotModel();
 
@@ -254,6 +265,25 @@ public:
   /** \brief Get a link by its name. Output error and return nullptr when the link is missing. */
   LinkModel* getLinkModel(const std::string& link, bool* has_link = nullptr);
 
+  /** \brief Table from link names to link indices, for resolving many names without map lookups */
+  const NameIndexTable& getLinkIndexTable() const
+  {
+    return link_index_table_;
+  }
+
+  /** \brief Table from joint names to joint indices, for resolving many names without map lookups */
+  const NameIndexTable& getJointIndexTable() const
+  {
+    return joint_index_table_;
+  }
+
+  /** \brief Table from variable names (and joint names, which map to their first variable) to variable indices.
+      This holds the same entries as getVariableIndex() resolves, but returns -1 instead of throwing. */
+  const NameIndexTable& getVariableIndexTable() const
+  {
+    return variable_index_table_;
+  }
+
   /** \brief Get the latest link upwards the kinematic tree, which is only connected via fixed joints
    *
    * This is useful, if the link should be warped to a specific pose using updateStateWithLinkAt().
@@ -569,6 +599,12 @@ protected:
       Additionally, it includes the names of the joints and the index for the first variable of that joint. */
   VariableIndexMap joint_variables_index_map_;
 
+  /** \brief Hash tables built from link_model_names_vector_, joint_model_names_vector_ and
+      joint_variables_index_map_ once the model is loaded; the name lookups go through these */
+  NameIndexTable link_index_table_;
+  NameIndexTable joint_index_table_;
+  NameIndexTable variable_index_table_;
+
   std::vector<int> active_joint_model_start_index_;
 
   /** \brief The bounds for all the active joint models */
@@ -640,7 +676,10 @@ private:
   LinkModel* constructLinkModel(const urdf::Link* urdf_link);
 
   /** \brief Given a geometry spec from the URDF and a filename (for a mesh), construct the corresponding shape object*/
-  shapes::ShapePtr constructShape(const urdf::Geometry* geom);
+  shapes::ShapeConstPtr constructShape(const urdf::Geometry* geom);
+
+  /** \brief Mesh loader used by constructShape(), only set during construction */
+  MeshLoaderFn mesh_loader_;
 };
 }  // namespace core
 }  // namespace moveit
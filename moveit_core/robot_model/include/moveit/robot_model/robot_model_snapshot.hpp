@@ -0,0 +1,109 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_model/robot_model.hpp>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief Binary cache of the collision meshes of a robot model.
+
+    Parsing mesh resources dominates the construction time of a RobotModel for most robots. A snapshot stores the
+    vertices and triangles of all meshes loaded by a RobotModel in a single binary file, keyed by a hash of the URDF
+    and SRDF documents. On the next start, getMeshLoader() serves the meshes from the snapshot and the RobotModel
+    is built without touching the mesh resources.
+
+    The file uses the native byte order and is meant as a machine-local cache. The key does not cover the contents
+    of the mesh files: delete the snapshot when meshes change without a change of the robot description. */
+class RobotModelSnapshot
+{
+public:
+  /** \brief Compute the key of a snapshot for the given robot description */
+  static std::uint64_t computeKey(const std::string& urdf_string, const std::string& srdf_string);
+
+  explicit RobotModelSnapshot(std::uint64_t key);
+
+  std::uint64_t getKey() const
+  {
+    return key_;
+  }
+
+  /** \brief Read the snapshot stored in \e path. Returns false (and leaves the snapshot empty) if the file is
+      missing or corrupt, or if it was written for a different key or format version. */
+  bool load(const std::string& path);
+
+  /** \brief Write the snapshot to \e path, replacing the file atomically */
+  bool save(const std::string& path) const;
+
+  /** \brief Mesh loader serving meshes from the snapshot. Meshes that are not contained in the snapshot are loaded
+      from their resource and added to it. The snapshot needs to outlive the returned function. */
+  MeshLoaderFn getMeshLoader();
+
+  /** \brief True if meshes were added since the snapshot was loaded */
+  bool isModified() const
+  {
+    return modified_;
+  }
+
+  std::size_t getMeshCount() const
+  {
+    return meshes_.size();
+  }
+
+private:
+  struct MeshData
+  {
+    std::vector<double> vertices;
+    std::vector<unsigned int> triangles;
+  };
+
+  using MeshKey = std::pair<std::string, std::array<double, 3>>;
+
+  shapes::ShapePtr loadMesh(const std::string& resource, const Eigen::Vector3d& scale);
+
+  std::uint64_t key_;
+  std::map<MeshKey, MeshData> meshes_;
+  bool modified_;
+};
+}  // namespace core
+}  // namespace moveit
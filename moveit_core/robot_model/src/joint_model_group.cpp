@@ -204,6 +204,21 @@ JointModelGroup::JointModelGroup(const std::string& group_name, const srdf::Mode
     }
   }
 
+  // groups of only prismatic and bounded revolute joints can compute distances and interpolate with plain vector math
+  const bool linear_joints_only =
+      mimic_joints_.empty() && !active_joint_model_vector_.empty() &&
+      std::all_of(active_joint_model_vector_.begin(), active_joint_model_vector_.end(), [](const JointModel* joint) {
+        return joint->getType() == JointModel::PRISMATIC ||
+               (joint->getType() == JointModel::REVOLUTE &&
+                !static_cast<const RevoluteJointModel*>(joint)->isContinuous());
+      });
+  if (linear_joints_only)
+  {
+    linear_distance_factors_.resize(variable_count_);
+    for (std::size_t i = 0; i < active_joint_model_vector_.size(); ++i)
+      linear_distance_factors_[active_joint_model_start_index_[i]] = active_joint_model_vector_[i]->getDistanceFactor();
+  }
+
   // when updating/sampling a group state only, only mimic joints that have their parent within the group get updated.
   for (const JointModel* mimic_joint : mimic_joints_)
   {
@@ -485,6 +500,38 @@ void JointModelGroup::interpolate(const double* from, const double* to, double t
   updateMimicJoints(state);
 }
 
+void JointModelGroup::distances(const double* state, const double* states, std::size_t count, double* distances) const
+{
+  if (linear_distance_factors_.size() == 0)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      distances[i] = distance(state, states + i * variable_count_);
+    return;
+  }
+
+  const Eigen::Map<const Eigen::VectorXd> from(state, variable_count_);
+  const Eigen::Map<const Eigen::MatrixXd> others(states, variable_count_, count);
+  for (std::size_t i = 0; i < count; ++i)
+    distances[i] = (others.col(i) - from).cwiseAbs().dot(linear_distance_factors_);
+}
+
+void JointModelGroup::interpolate(const double* from, const double* to, const double* t, std::size_t count,
+                                  double* states) const
+{
+  if (linear_distance_factors_.size() == 0)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      interpolate(from, to, t[i], states + i * variable_count_);
+    return;
+  }
+
+  const Eigen::Map<const Eigen::VectorXd> from_state(from, variable_count_);
+  const Eigen::Map<const Eigen::VectorXd> to_state(to, variable_count_);
+  Eigen::Map<Eigen::MatrixXd> result(states, variable_count_, count);
+  for (std::size_t i = 0; i < count; ++i)
+    result.col(i) = from_state + (to_state - from_state) * t[i];
+}
+
 void JointModelGroup::updateMimicJoints(double* values) const
 {
   // update mimic (only local joints as we are dealing with a local group state)
@@ -0,0 +1,98 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/mesh_cache.hpp>
+#include <geometric_shapes/mesh_operations.h>
+
+namespace moveit
+{
+namespace core
+{
+MeshCache& MeshCache::getGlobal()
+{
+  static MeshCache cache;
+  return cache;
+}
+
+shapes::ShapeConstPtr MeshCache::getMesh(const std::string& resource, const Eigen::Vector3d& scale,
+                                         const MeshLoaderFn& loader)
+{
+  const Key key(resource, { scale.x(), scale.y(), scale.z() });
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = meshes_.find(key);
+    if (it != meshes_.end())
+    {
+      if (shapes::ShapeConstPtr mesh = it->second.lock())
+        return mesh;
+    }
+  }
+
+  // Load without holding the lock, parsing meshes can take long. If another thread loaded the same mesh in the
+  // meantime, its instance is used instead.
+  shapes::ShapeConstPtr mesh =
+      loader ? loader(resource, scale) : shapes::ShapeConstPtr(shapes::createMeshFromResource(resource, scale));
+  if (!mesh)
+    return mesh;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  shapes::ShapeConstWeakPtr& entry = meshes_[key];
+  if (shapes::ShapeConstPtr existing = entry.lock())
+    return existing;
+  entry = mesh;
+
+  // drop entries of meshes that are no longer used by any model
+  for (auto it = meshes_.begin(); it != meshes_.end();)
+  {
+    if (it->second.expired())
+      it = meshes_.erase(it);
+    else
+      ++it;
+  }
+  return mesh;
+}
+
+std::size_t MeshCache::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::size_t count = 0;
+  for (const auto& entry : meshes_)
+  {
+    if (!entry.second.expired())
+      ++count;
+  }
+  return count;
+}
+}  // namespace core
+}  // namespace moveit
@@ -0,0 +1,83 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/name_index_table.hpp>
+
+namespace moveit
+{
+namespace core
+{
+NameIndexTable::NameIndexTable(const std::vector<std::string>& names)
+{
+  entries_.reserve(names.size());
+  for (std::size_t i = 0; i < names.size(); ++i)
+    entries_.push_back(Entry{ computeHash(names[i]), static_cast<int>(i), names[i] });
+  build();
+}
+
+NameIndexTable::NameIndexTable(const std::map<std::string, std::size_t>& entries)
+{
+  entries_.reserve(entries.size());
+  for (const auto& [name, index] : entries)
+    entries_.push_back(Entry{ computeHash(name), static_cast<int>(index), name });
+  build();
+}
+
+void NameIndexTable::build()
+{
+  if (entries_.empty())
+    return;
+
+  // keep the load factor at or below 0.5 so probe sequences stay short and always end at an empty slot
+  std::size_t capacity = 2;
+  while (capacity < 2 * entries_.size())
+    capacity *= 2;
+  mask_ = capacity - 1;
+  slots_.assign(capacity, -1);
+
+  for (std::size_t i = 0; i < entries_.size(); ++i)
+  {
+    std::size_t slot = entries_[i].hash & mask_;
+    while (slots_[slot] >= 0)
+    {
+      // a repeated name keeps the index it was given last
+      if (entries_[slots_[slot]].name == entries_[i].name)
+        break;
+      slot = (slot + 1) & mask_;
+    }
+    slots_[slot] = static_cast<int>(i);
+  }
+}
+}  // namespace core
+}  // namespace moveit
@@ -36,6 +36,7 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/robot_model/robot_model.hpp>
+#include <moveit/robot_model/mesh_cache.hpp>
 #include <geometric_shapes/shape_operations.h>
 #include <rclcpp/logger.hpp>
 #include <algorithm>
@@ -66,6 +67,17 @@ RobotModel::RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const sr
   buildModel(*urdf_model, *srdf_model);
 }
 
+RobotModel::RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model,
+                       const MeshLoaderFn& mesh_loader)
+  : mesh_loader_(mesh_loader)
+{
+  root_joint_ = nullptr;
+  urdf_ = urdf_model;
+  srdf_ = srdf_model;
+  buildModel(*urdf_model, *srdf_model);
+  mesh_loader_ = nullptr;
+}
+
 RobotModel::~RobotModel()
 {
   for (std::pair<const std::string, JointModelGroup*>& it : joint_model_group_map_)
@@ -109,6 +121,9 @@ void RobotModel::buildModel(const urdf::ModelInterface& urdf_model, const srdf::
 
     RCLCPP_DEBUG(getLogger(), "... computing joint indexing");
     buildJointInfo();
+    link_index_table_ = NameIndexTable(link_model_names_vector_);
+    joint_index_table_ = NameIndexTable(joint_model_names_vector_);
+    variable_index_table_ = NameIndexTable(joint_variables_index_map_);
 
     if (link_models_with_collision_geometry_vector_.empty())
     {
@@ -1253,7 +1268,7 @@ LinkModel* RobotModel::constructLinkModel(const urdf::Link* urdf_link)
   return new_link_model;
 }
 
-shapes::ShapePtr RobotModel::constructShape(const urdf::Geometry* geom)
+shapes::ShapeConstPtr RobotModel::constructShape(const urdf::Geometry* geom)
 {
   shapes::Shape* new_shape = nullptr;
   switch (geom->type)
@@ -1277,8 +1292,8 @@ shapes::ShapePtr RobotModel::constructShape(const urdf::Geometry* geom)
       if (!mesh->filename.empty())
       {
         Eigen::Vector3d scale(mesh->scale.x, mesh->scale.y, mesh->scale.z);
-        shapes::Mesh* m = shapes::createMeshFromResource(mesh->filename, scale);
-        new_shape = m;
+        // meshes are shared with all other robot models of the process
+        return MeshCache::getGlobal().getMesh(mesh->filename, scale, mesh_loader_);
       }
     }
     break;
@@ -1287,24 +1302,24 @@ shapes::ShapePtr RobotModel::constructShape(const urdf::Geometry* geom)
       break;
   }
 
-  return shapes::ShapePtr(new_shape);
+  return shapes::ShapeConstPtr(new_shape);
 }
 
 bool RobotModel::hasJointModel(const std::string& name) const
 {
-  return joint_model_map_.find(name) != joint_model_map_.end();
+  return joint_index_table_.contains(name);
 }
 
 bool RobotModel::hasLinkModel(const std::string& name) const
 {
-  return link_model_map_.find(name) != link_model_map_.end();
+  return link_index_table_.contains(name);
 }
 
 const JointModel* RobotModel::getJointModel(const std::string& name) const
 {
-  JointModelMap::const_iterator it = joint_model_map_.find(name);
-  if (it != joint_model_map_.end())
-    return it->second;
+  const int index = joint_index_table_.find(name);
+  if (index >= 0)
+    return joint_model_vector_[index];
   RCLCPP_ERROR(getLogger(), "Joint '%s' not found in model '%s'", name.c_str(), model_name_.c_str());
   return nullptr;
 }
@@ -1322,9 +1337,9 @@ const JointModel* RobotModel::getJointModel(size_t index) const
 
 JointModel* RobotModel::getJointModel(const std::string& name)
 {
-  JointModelMap::const_iterator it = joint_model_map_.find(name);
-  if (it != joint_model_map_.end())
-    return it->second;
+  const int index = joint_index_table_.find(name);
+  if (index >= 0)
+    return joint_model_vector_[index];
   RCLCPP_ERROR(getLogger(), "Joint '%s' not found in model '%s'", name.c_str(), model_name_.c_str());
   return nullptr;
 }
@@ -1349,9 +1364,9 @@ LinkModel* RobotModel::getLinkModel(const std::string& name, bool* has_link)
 {
   if (has_link)
     *has_link = true;  // Start out optimistic
-  LinkModelMap::const_iterator it = link_model_map_.find(name);
-  if (it != link_model_map_.end())
-    return it->second;
+  const int index = link_index_table_.find(name);
+  if (index >= 0)
+    return link_model_vector_[index];
 
   if (has_link)
   {
@@ -1440,10 +1455,10 @@ void RobotModel::getMissingVariableNames(const std::vector<std::string>& variabl
 
 size_t RobotModel::getVariableIndex(const std::string& variable) const
 {
-  VariableIndexMap::const_iterator it = joint_variables_index_map_.find(variable);
-  if (it == joint_variables_index_map_.end())
+  const int index = variable_index_table_.find(variable);
+  if (index < 0)
     throw Exception("Variable '" + variable + "' is not known to model '" + model_name_ + '\'');
-  return it->second;
+  return index;
 }
 
 double RobotModel::getMaximumExtent(const JointBoundsVector& active_joint_bounds) const
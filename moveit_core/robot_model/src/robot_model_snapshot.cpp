@@ -0,0 +1,274 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/robot_model_snapshot.hpp>
+#include <moveit/utils/logger.hpp>
+#include <geometric_shapes/mesh_operations.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.core.robot_model_snapshot");
+}
+
+constexpr char MAGIC[8] = { 'M', 'V', 'T', 'R', 'M', 'S', 'N', 'P' };
+constexpr std::uint32_t FORMAT_VERSION = 1;
+
+static_assert(sizeof(unsigned int) == sizeof(std::uint32_t), "mesh triangles are stored as 32 bit indices");
+
+// FNV-1a, 64 bit
+void hashBytes(std::uint64_t& hash, const char* data, std::size_t size)
+{
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+}
+
+template <typename T>
+void write(std::string& buffer, const T& value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::string& buffer, const std::vector<T>& values)
+{
+  write(buffer, static_cast<std::uint64_t>(values.size()));
+  buffer.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+/** \brief Bounds-checked reads from a binary buffer */
+class Reader
+{
+public:
+  explicit Reader(const std::string& buffer) : data_(buffer.data()), remaining_(buffer.size())
+  {
+  }
+
+  template <typename T>
+  bool read(T& value)
+  {
+    if (remaining_ < sizeof(T))
+      return false;
+    std::memcpy(&value, data_, sizeof(T));
+    data_ += sizeof(T);
+    remaining_ -= sizeof(T);
+    return true;
+  }
+
+  template <typename T>
+  bool readArray(std::vector<T>& values)
+  {
+    std::uint64_t size;
+    if (!read(size) || size > remaining_ / sizeof(T))
+      return false;
+    values.resize(size);
+    std::memcpy(values.data(), data_, size * sizeof(T));
+    data_ += size * sizeof(T);
+    remaining_ -= size * sizeof(T);
+    return true;
+  }
+
+  bool readString(std::string& value)
+  {
+    std::uint64_t size;
+    if (!read(size) || size > remaining_)
+      return false;
+    value.assign(data_, size);
+    data_ += size;
+    remaining_ -= size;
+    return true;
+  }
+
+  bool atEnd() const
+  {
+    return remaining_ == 0;
+  }
+
+private:
+  const char* data_;
+  std::size_t remaining_;
+};
+}  // namespace
+
+std::uint64_t RobotModelSnapshot::computeKey(const std::string& urdf_string, const std::string& srdf_string)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  hashBytes(hash, reinterpret_cast<const char*>(&FORMAT_VERSION), sizeof(FORMAT_VERSION));
+  hashBytes(hash, urdf_string.data(), urdf_string.size());
+  // separate the documents, so that moving text from one to the other changes the key
+  hashBytes(hash, "\0", 1);
+  hashBytes(hash, srdf_string.data(), srdf_string.size());
+  return hash;
+}
+
+RobotModelSnapshot::RobotModelSnapshot(std::uint64_t key) : key_(key), modified_(false)
+{
+}
+
+bool RobotModelSnapshot::load(const std::string& path)
+{
+  meshes_.clear();
+  modified_ = false;
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+  const std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  Reader reader(buffer);
+  char magic[sizeof(MAGIC)];
+  std::uint32_t version;
+  std::uint64_t key;
+  std::uint64_t mesh_count;
+  if (!reader.read(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !reader.read(version) ||
+      version != FORMAT_VERSION || !reader.read(key) || !reader.read(mesh_count))
+  {
+    RCLCPP_WARN(getLogger(), "Ignoring robot model snapshot '%s': unknown format", path.c_str());
+    return false;
+  }
+  if (key != key_)
+  {
+    RCLCPP_DEBUG(getLogger(), "Ignoring robot model snapshot '%s': it was written for another robot description",
+                 path.c_str());
+    return false;
+  }
+
+  std::map<MeshKey, MeshData> meshes;
+  for (std::uint64_t i = 0; i < mesh_count; ++i)
+  {
+    MeshKey mesh_key;
+    MeshData data;
+    if (!reader.readString(mesh_key.first) || !reader.read(mesh_key.second) || !reader.readArray(data.vertices) ||
+        !reader.readArray(data.triangles) || data.vertices.size() % 3 != 0 || data.triangles.size() % 3 != 0)
+    {
+      RCLCPP_WARN(getLogger(), "Ignoring robot model snapshot '%s': the file is truncated", path.c_str());
+      return false;
+    }
+    meshes[std::move(mesh_key)] = std::move(data);
+  }
+  if (!reader.atEnd())
+  {
+    RCLCPP_WARN(getLogger(), "Ignoring robot model snapshot '%s': unexpected trailing data", path.c_str());
+    return false;
+  }
+
+  meshes_ = std::move(meshes);
+  return true;
+}
+
+bool RobotModelSnapshot::save(const std::string& path) const
+{
+  std::string buffer;
+  buffer.append(MAGIC, sizeof(MAGIC));
+  write(buffer, FORMAT_VERSION);
+  write(buffer, key_);
+  write(buffer, static_cast<std::uint64_t>(meshes_.size()));
+  for (const auto& [mesh_key, data] : meshes_)
+  {
+    write(buffer, static_cast<std::uint64_t>(mesh_key.first.size()));
+    buffer.append(mesh_key.first);
+    write(buffer, mesh_key.second);
+    writeArray(buffer, data.vertices);
+    writeArray(buffer, data.triangles);
+  }
+
+  // write to a temporary file first, so that concurrently starting processes never read a partial snapshot
+  const std::string tmp_path =
+      path + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+    {
+      RCLCPP_WARN(getLogger(), "Unable to write robot model snapshot '%s'", tmp_path.c_str());
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+  {
+    RCLCPP_WARN(getLogger(), "Unable to move robot model snapshot to '%s'", path.c_str());
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+MeshLoaderFn RobotModelSnapshot::getMeshLoader()
+{
+  return [this](const std::string& resource, const Eigen::Vector3d& scale) { return loadMesh(resource, scale); };
+}
+
+shapes::ShapePtr RobotModelSnapshot::loadMesh(const std::string& resource, const Eigen::Vector3d& scale)
+{
+  const MeshKey mesh_key(resource, { scale.x(), scale.y(), scale.z() });
+  const auto it = meshes_.find(mesh_key);
+  if (it != meshes_.end())
+  {
+    const MeshData& data = it->second;
+    auto mesh = std::make_shared<shapes::Mesh>(data.vertices.size() / 3, data.triangles.size() / 3);
+    std::copy(data.vertices.begin(), data.vertices.end(), mesh->vertices);
+    std::copy(data.triangles.begin(), data.triangles.end(), mesh->triangles);
+    mesh->computeTriangleNormals();
+    mesh->computeVertexNormals();
+    return mesh;
+  }
+
+  shapes::Mesh* loaded = shapes::createMeshFromResource(resource, scale);
+  if (!loaded)
+    return shapes::ShapePtr();
+
+  MeshData& data = meshes_[mesh_key];
+  data.vertices.assign(loaded->vertices, loaded->vertices + 3 * loaded->vertex_count);
+  data.triangles.assign(loaded->triangles, loaded->triangles + 3 * loaded->triangle_count);
+  modified_ = true;
+  return shapes::ShapePtr(loaded);
+}
+}  // namespace core
+}  // namespace moveit
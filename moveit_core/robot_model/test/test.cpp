@@ -35,8 +35,13 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/robot_model/robot_model.hpp>
+#include <moveit/robot_model/mesh_cache.hpp>
+#include <moveit/robot_model/robot_model_snapshot.hpp>
 #include <urdf_parser/urdf_parser.h>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <map>
 #include <gtest/gtest.h>
 
 #include <moveit/utils/robot_model_test_utils.hpp>
@@ -172,6 +177,166 @@ TEST(FloatingJointTest, interpolation_test)
   }
 }
 
+TEST(NameIndexTable, MatchesModelLookups)
+{
+  const moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(model);
+
+  for (const moveit::core::LinkModel* link : model->getLinkModels())
+    EXPECT_EQ(model->getLinkIndexTable().find(link->getName()), static_cast<int>(link->getLinkIndex()));
+  for (const moveit::core::JointModel* joint : model->getJointModels())
+  {
+    EXPECT_EQ(model->getJointIndexTable().find(joint->getName()), static_cast<int>(joint->getJointIndex()));
+    if (joint->getVariableCount() > 0)
+    {
+      EXPECT_EQ(model->getVariableIndexTable().find(joint->getName()),
+                static_cast<int>(joint->getFirstVariableIndex()));
+    }
+  }
+  const std::vector<std::string>& variables = model->getVariableNames();
+  for (std::size_t i = 0; i < variables.size(); ++i)
+    EXPECT_EQ(model->getVariableIndexTable().find(variables[i]), static_cast<int>(i));
+
+  EXPECT_EQ(model->getLinkIndexTable().find("no_such_link"), -1);
+  EXPECT_EQ(model->getLinkIndexTable().find(""), -1);
+  EXPECT_FALSE(model->hasLinkModel("no_such_link"));
+  EXPECT_FALSE(model->hasJointModel("no_such_joint"));
+  EXPECT_THROW(model->getVariableIndex("no_such_variable"), moveit::Exception);
+
+  const moveit::core::NameIndexTable empty;
+  EXPECT_EQ(empty.find("a"), -1);
+  EXPECT_EQ(empty.size(), 0u);
+}
+
+TEST(JointModelGroup, BatchDistanceAndInterpolation)
+{
+  random_numbers::RandomNumberGenerator rng(5);
+  for (const auto& [robot, group_name] : { std::make_pair("panda", "panda_arm"), std::make_pair("pr2", "right_arm"),
+                                            std::make_pair("pr2", "whole_body") })
+  {
+    const moveit::core::RobotModelPtr model = moveit::core::loadTestingRobotModel(robot);
+    ASSERT_TRUE(model);
+    const moveit::core::JointModelGroup* group = model->getJointModelGroup(group_name);
+    ASSERT_TRUE(group) << group_name;
+
+    constexpr std::size_t COUNT = 17;
+    const std::size_t n = group->getVariableCount();
+    std::vector<double> from(n), to(n), states(n * COUNT), t(COUNT);
+    group->getVariableRandomPositions(rng, from.data());
+    group->getVariableRandomPositions(rng, to.data());
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+      group->getVariableRandomPositions(rng, states.data() + i * n);
+      t[i] = static_cast<double>(i) / (COUNT - 1);
+    }
+
+    std::vector<double> distances(COUNT);
+    group->distances(from.data(), states.data(), COUNT, distances.data());
+    for (std::size_t i = 0; i < COUNT; ++i)
+      EXPECT_NEAR(distances[i], group->distance(from.data(), states.data() + i * n), 1e-12) << group_name;
+
+    std::vector<double> interpolated(n * COUNT), expected(n);
+    group->interpolate(from.data(), to.data(), t.data(), COUNT, interpolated.data());
+    for (std::size_t i = 0; i < COUNT; ++i)
+    {
+      group->interpolate(from.data(), to.data(), t[i], expected.data());
+      for (std::size_t j = 0; j < n; ++j)
+        EXPECT_NEAR(interpolated[i * n + j], expected[j], 1e-12) << group_name;
+    }
+  }
+}
+
+TEST(MeshCache, SharedBetweenModels)
+{
+  const moveit::core::RobotModelPtr first = moveit::core::loadTestingRobotModel("panda");
+  const moveit::core::RobotModelPtr second = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+
+  std::size_t meshes = 0;
+  for (const moveit::core::LinkModel* link : first->getLinkModels())
+  {
+    const moveit::core::LinkModel* other = second->getLinkModel(link->getName());
+    ASSERT_EQ(link->getShapes().size(), other->getShapes().size());
+    for (std::size_t i = 0; i < link->getShapes().size(); ++i)
+    {
+      if (link->getShapes()[i]->type != shapes::MESH)
+        continue;
+      EXPECT_EQ(link->getShapes()[i], other->getShapes()[i]) << link->getName();
+      ++meshes;
+    }
+  }
+  EXPECT_GT(meshes, 0u);
+  EXPECT_GT(moveit::core::MeshCache::getGlobal().size(), 0u);
+}
+
+TEST(RobotModelSnapshot, RoundTrip)
+{
+  const urdf::ModelInterfaceSharedPtr urdf_model = moveit::core::loadModelInterface("panda");
+  const srdf::ModelSharedPtr srdf_model = moveit::core::loadSRDFModel("panda");
+  ASSERT_TRUE(urdf_model);
+  ASSERT_TRUE(srdf_model);
+
+  const std::uint64_t key = moveit::core::RobotModelSnapshot::computeKey("urdf", "srdf");
+  EXPECT_NE(key, moveit::core::RobotModelSnapshot::computeKey("urdfs", "rdf"));
+  const std::string path =
+      (std::filesystem::temp_directory_path() / ("robot_model_snapshot_test_" + std::to_string(key))).string();
+
+  // Collect the mesh vertices of every link. No other model may be alive, so that meshes are not served by the
+  // process-wide MeshCache.
+  const auto collect_vertices = [](const moveit::core::RobotModel& model) {
+    std::map<std::string, std::vector<std::vector<double>>> vertices;
+    for (const moveit::core::LinkModel* link : model.getLinkModels())
+    {
+      for (const shapes::ShapeConstPtr& shape : link->getShapes())
+      {
+        if (shape->type != shapes::MESH)
+          continue;
+        const auto& mesh = static_cast<const shapes::Mesh&>(*shape);
+        vertices[link->getName()].emplace_back(mesh.vertices, mesh.vertices + 3 * mesh.vertex_count);
+      }
+    }
+    return vertices;
+  };
+
+  // the first construction loads all meshes from their resources and records them
+  std::map<std::string, std::vector<std::vector<double>>> expected;
+  std::size_t mesh_count = 0;
+  {
+    moveit::core::RobotModelSnapshot recorded(key);
+    const auto model = std::make_shared<moveit::core::RobotModel>(urdf_model, srdf_model, recorded.getMeshLoader());
+    ASSERT_TRUE(recorded.isModified());
+    ASSERT_GT(recorded.getMeshCount(), 0u);
+    ASSERT_TRUE(recorded.save(path));
+    expected = collect_vertices(*model);
+    mesh_count = recorded.getMeshCount();
+  }
+
+  moveit::core::RobotModelSnapshot other_key(key + 1);
+  EXPECT_FALSE(other_key.load(path));
+  EXPECT_EQ(other_key.getMeshCount(), 0u);
+
+  // the second construction is served from the snapshot only
+  moveit::core::RobotModelSnapshot loaded(key);
+  ASSERT_TRUE(loaded.load(path));
+  EXPECT_EQ(loaded.getMeshCount(), mesh_count);
+  std::size_t loader_calls = 0;
+  moveit::core::MeshLoaderFn snapshot_loader = loaded.getMeshLoader();
+  const auto restored = std::make_shared<moveit::core::RobotModel>(
+      urdf_model, srdf_model, [&](const std::string& resource, const Eigen::Vector3d& scale) {
+        ++loader_calls;
+        return snapshot_loader(resource, scale);
+      });
+  EXPECT_GT(loader_calls, 0u);
+  EXPECT_FALSE(loaded.isModified());
+  EXPECT_EQ(collect_vertices(*restored), expected);
+
+  // truncated files are rejected
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  EXPECT_FALSE(loaded.load(path));
+  std::filesystem::remove(path);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
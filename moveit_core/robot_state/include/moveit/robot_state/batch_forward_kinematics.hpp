@@ -0,0 +1,172 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_state/robot_state.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief Caller-owned storage for the link transforms of many robot configurations at once.
+
+    Transforms are stored as structure-of-arrays: for every link, the twelve coefficients of the 3x4 affine
+    part of its global transform (row-major: r00 r01 r02 tx r10 r11 r12 ty r20 r21 r22 tz) are each kept in
+    their own contiguous row of getStateCount() values. This makes loops over the states of one coefficient
+    trivially vectorizable. The buffer also owns the scratch memory used by BatchForwardKinematics, so repeated
+    evaluations with the same batch size do not allocate. */
+class LinkTransformBatch
+{
+public:
+  /** \brief Number of coefficients stored per link transform (3x4 affine part) */
+  static constexpr std::size_t COEFFICIENTS = 12;
+
+  LinkTransformBatch() = default;
+
+  /** \brief Resize the buffer for \e link_count links and \e state_count states. Memory is only reallocated when
+      the total size grows. */
+  void resize(std::size_t link_count, std::size_t state_count);
+
+  std::size_t getLinkCount() const
+  {
+    return link_count_;
+  }
+
+  std::size_t getStateCount() const
+  {
+    return state_count_;
+  }
+
+  /** \brief Get the row of \e coefficient (0..11) of the transform of link \e link_index, one value per state */
+  double* getCoefficients(std::size_t link_index, std::size_t coefficient)
+  {
+    return data_.data() + (link_index * COEFFICIENTS + coefficient) * state_count_;
+  }
+
+  const double* getCoefficients(std::size_t link_index, std::size_t coefficient) const
+  {
+    return data_.data() + (link_index * COEFFICIENTS + coefficient) * state_count_;
+  }
+
+  /** \brief Assemble the transform of link \e link_index for state \e state_index */
+  Eigen::Isometry3d getTransform(std::size_t link_index, std::size_t state_index) const;
+
+private:
+  friend class BatchForwardKinematics;
+
+  std::size_t link_count_ = 0;
+  std::size_t state_count_ = 0;
+  std::vector<double> data_;
+
+  // scratch space used while evaluating: 12 coefficient rows plus one row of joint values
+  std::vector<double> scratch_;
+};
+
+/** \brief Forward kinematics for the links updated by a JointModelGroup, evaluated for many group configurations
+    in one call.
+
+    The kinematic topology (update order, parent links, joint types, fixed origin transforms and the location of
+    each joint's variables in the group state) is resolved once at construction. compute() then evaluates the
+    transforms of all links returned by getLinkModels() for every column of a matrix of group positions, writing
+    them into a LinkTransformBatch. Revolute, prismatic and fixed joints are evaluated with plain loops over the
+    states, which the compiler vectorizes; other joint types fall back to JointModel::computeTransform() per state.
+
+    Joints outside of the group (and links that are not updated by the group) take their values from a reference
+    RobotState, whose link transforms must be up to date. Instances are immutable after construction and can be
+    shared between threads, as long as each thread uses its own LinkTransformBatch. */
+class BatchForwardKinematics
+{
+public:
+  /** \brief Precompute the evaluation order for \e group. Throws moveit::Exception if \e group is nullptr. */
+  explicit BatchForwardKinematics(const JointModelGroup* group);
+
+  const JointModelGroup* getJointModelGroup() const
+  {
+    return group_;
+  }
+
+  /** \brief The links computed by compute(), in evaluation order. The link at index i in this vector is stored at
+      index i of the LinkTransformBatch. This is the same as JointModelGroup::getUpdatedLinkModels(). */
+  const std::vector<const LinkModel*>& getLinkModels() const
+  {
+    return group_->getUpdatedLinkModels();
+  }
+
+  /** \brief Get the index of \e link within LinkTransformBatch, or -1 if the link is not computed */
+  int getBatchLinkIndex(const LinkModel* link) const
+  {
+    return link ? batch_index_of_link_[link->getLinkIndex()] : -1;
+  }
+
+  /** \brief Compute the global transforms of getLinkModels() for all configurations in \e group_positions.
+      @param reference state providing values for everything that is not part of the group. Its link transforms
+             must be up to date.
+      @param group_positions matrix of size group->getVariableCount() x N; each column is one group state in the
+             same order as used by RobotState::setJointGroupPositions(). Mimic joints within the group are computed
+             from the joint they mimic; their entries in \e group_positions are ignored.
+      @param transforms output buffer, resized to getLinkModels().size() links and N states */
+  void compute(const RobotState& reference, const Eigen::Ref<const Eigen::MatrixXd>& group_positions,
+               LinkTransformBatch& transforms) const;
+
+private:
+  enum class StepType
+  {
+    FIXED,      ///< local transform is constant (fixed joint, or joint values taken from the reference state)
+    REVOLUTE,   ///< single revolute joint in the group
+    PRISMATIC,  ///< single prismatic joint in the group
+    GENERIC     ///< any other joint in the group, evaluated through JointModel::computeTransform()
+  };
+
+  struct Step
+  {
+    const LinkModel* link;
+    const JointModel* joint;
+    int parent_batch_index;  ///< -1 if the parent transform is taken from the reference state
+    StepType type;
+    int group_variable_index;  ///< first variable of the joint (or of the joint it mimics) in the group state
+    double mimic_factor;
+    double mimic_offset;
+    Eigen::Vector3d axis;
+  };
+
+  const JointModelGroup* group_;
+  std::vector<Step> steps_;
+  std::vector<int> batch_index_of_link_;
+};
+}  // namespace core
+}  // namespace moveit
@@ -50,6 +50,7 @@ struct CartesianPrecision
   double translational = 0.001;  //< max deviation in translation (meters)
   double rotational = 0.01;      //< max deviation in rotation (radians)
   double max_resolution = 1e-5;  //< max resolution for waypoints (fraction of total path)
+  double max_step_growth = 1.0;  //< max factor by which steps may exceed max_step where the joints move uniformly
 };
 
 /** \brief Struct with options for defining joint-space jump thresholds. */
@@ -167,6 +168,12 @@ public:
      If the deviation at the mid point of two consecutive waypoints is larger than the specified precision, another waypoint
      will be inserted at that mid point. The precision is specified separately for translation and rotation.
      The maximal resolution to consider (as fraction of the total path length) is specified by max_resolution.
+
+     If max_step_growth is larger than 1, the step adapts to the path: it doubles after each step whose joint motion is
+     as uniform as the previous one, up to max_step_growth times max_step, and is refined again where the joint motion
+     per step increases, e.g. near singularities and joint jumps. This needs much fewer IK calls on long paths, but note
+     that absolute jump thresholds then apply to the longer steps. With fixed steps and neither \e validCallback nor
+     \e cost_function, the poses of all steps are passed to the kinematics solver at once if it supportsIKSequence().
   */
   static Distance computeCartesianPath(
       const RobotState* start_state, const JointModelGroup* group, std::vector<std::shared_ptr<RobotState>>& traj,
@@ -221,6 +228,27 @@ public:
       const kinematics::KinematicsBase::IKCostFn& cost_function = kinematics::KinematicsBase::IKCostFn(),
       const Eigen::Isometry3d& link_offset = Eigen::Isometry3d::Identity());
 
+  /** \brief Compute the sequence of joint values that perform a general Cartesian path, interpolating the straight
+     segments between consecutive waypoints concurrently.
+
+     The path is the same as that of the previous function. The start state of every segment is first found by IK at
+     the preceding waypoint, seeded with the start state of the segment before. The segments are then interpolated on
+     up to \e thread_count threads (0 for one per hardware thread) and stitched together: a segment that does not start
+     within \e max_boundary_distance (in joint space) of the end of the previous segment is recomputed from that end, so
+     the path is continuous at the waypoints. Waypoints in the local reference frame are chained assuming that every
+     segment reaches its waypoint. \e validCallback and \e cost_function are called concurrently. The segments are
+     interpolated one after the other if the kinematics solver of the group reports that it must not be called
+     concurrently, i.e. if it does not supportsParallelIKBatch(). */
+  static Percentage computeCartesianPathParallel(
+      const RobotState* start_state, const JointModelGroup* group, std::vector<std::shared_ptr<RobotState>>& traj,
+      const LinkModel* link, const EigenSTL::vector_Isometry3d& waypoints, bool global_reference_frame,
+      const MaxEEFStep& max_step, const CartesianPrecision& precision,
+      const GroupStateValidityCallbackFn& validCallback = GroupStateValidityCallbackFn(),
+      const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions(),
+      const kinematics::KinematicsBase::IKCostFn& cost_function = kinematics::KinematicsBase::IKCostFn(),
+      const Eigen::Isometry3d& link_offset = Eigen::Isometry3d::Identity(), std::size_t thread_count = 0,
+      double max_boundary_distance = 1e-3);
+
   /** \brief Compute the sequence of joint values that correspond to a straight Cartesian path for a particular link.
 
      The Cartesian path to be followed is specified as a \e translation vector to be followed by the robot \e link.
@@ -0,0 +1,112 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_model/joint_model_group.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief Forward kinematics and Jacobian of a serial chain, specialized for its number of joints.
+
+    The generic forward kinematics in RobotState dispatch through JointModel::computeTransform() for every joint and
+    then walk all descendant links. For groups that are plain serial chains of revolute and prismatic joints (the
+    typical 6 or 7 DOF arm), create() returns an implementation whose joint loop has a compile-time trip count and
+    that applies each joint motion directly to the accumulated transform, with no virtual call per joint. Fixed
+    joints within the chain are folded into the origin of the next moving joint.
+
+    This is an opt-in code path: callers that evaluate the same chain very often (IK solvers, servoing, samplers)
+    create it once per group and fall back to RobotState when create() returns nullptr. */
+class ChainKinematics
+{
+public:
+  virtual ~ChainKinematics() = default;
+
+  /** \brief Specialized kinematics for \e group, or nullptr if the group is not a serial chain of up to
+      MAX_JOINTS single-variable revolute or prismatic joints without mimic joints. */
+  static std::unique_ptr<ChainKinematics> create(const JointModelGroup* group);
+
+  /** \brief Largest number of moving joints for which a specialization is compiled */
+  static constexpr std::size_t MAX_JOINTS = 8;
+
+  const JointModelGroup* getJointModelGroup() const
+  {
+    return group_;
+  }
+
+  /** \brief The link all transforms are relative to: the parent link of the first joint of the group
+      (nullptr if that joint is the root joint of the model) */
+  const LinkModel* getBaseLink() const
+  {
+    return base_link_;
+  }
+
+  /** \brief The links computeLinkTransforms() computes transforms for: the child links of all moving joints in chain
+      order, followed by the tip link of the group (which is repeated if it is the child of the last moving joint) */
+  const std::vector<const LinkModel*>& getLinkModels() const
+  {
+    return link_models_;
+  }
+
+  /** \brief Compute the transforms of getLinkModels() for the group positions \e group_positions (in the order of
+      the group variables), given the pose \e base of getBaseLink(). \e link_transforms needs to hold
+      getLinkModels().size() elements. */
+  virtual void computeLinkTransforms(const double* group_positions, const Eigen::Isometry3d& base,
+                                     Eigen::Isometry3d* link_transforms) const = 0;
+
+  /** \brief Compute the 6 x variable count Jacobian of the origin of the tip link from transforms previously
+      computed by computeLinkTransforms(). The Jacobian is expressed in the frame the transforms are given in, so
+      passing base = Identity yields the same Jacobian as RobotState::getJacobian(). */
+  virtual void computeJacobian(const Eigen::Isometry3d* link_transforms, Eigen::MatrixXd& jacobian) const = 0;
+
+protected:
+  ChainKinematics(const JointModelGroup* group, const LinkModel* base_link, std::vector<const LinkModel*> link_models)
+    : group_(group), base_link_(base_link), link_models_(std::move(link_models))
+  {
+  }
+
+private:
+  const JointModelGroup* group_;
+  const LinkModel* base_link_;
+  std::vector<const LinkModel*> link_models_;
+};
+}  // namespace core
+}  // namespace moveit
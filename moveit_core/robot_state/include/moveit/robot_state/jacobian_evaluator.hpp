@@ -0,0 +1,112 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_state/robot_state.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief Repeated evaluation of the Jacobian of a kinematic chain.
+
+    RobotState::getJacobian() validates the group and walks its joint models on every call. This class does that
+    work once on construction, so that an evaluation only reads the link transforms (and velocities) of a state and
+    writes into a caller-provided matrix. Once that matrix has the right size, no memory is allocated.
+
+    The Jacobian is the same as returned by RobotState::getJacobian() without quaternion representation: 6 rows
+    (linear velocity first, then angular velocity) and one column per variable of the group, expressed in the frame
+    of the group's root link. */
+class JacobianEvaluator
+{
+public:
+  /** \brief Prepare the evaluation of the Jacobian of \e group at \e tip (the last link of the group by default).
+      Throws moveit::Exception if the group is not a chain, does not update \e tip, or contains joints other than
+      revolute, prismatic or planar ones. */
+  JacobianEvaluator(const JointModelGroup* group, const LinkModel* tip = nullptr);
+
+  const JointModelGroup* getJointModelGroup() const
+  {
+    return group_;
+  }
+
+  const LinkModel* getTipLink() const
+  {
+    return tip_;
+  }
+
+  /** \brief Compute the Jacobian of the chain for the link transforms of \e state, which need to be up to date.
+      \param reference_point_position The reference point, with respect to the tip link
+      \return False if the state was constructed for a different robot model */
+  bool compute(const RobotState& state, Eigen::MatrixXd& jacobian,
+               const Eigen::Vector3d& reference_point_position = Eigen::Vector3d::Zero()) const;
+
+  /** \brief Compute the Jacobian and its time derivative for the link transforms and velocities of \e state.
+      \return False if the state has no velocities, was constructed for a different robot model, or if the chain
+      contains planar joints, for which the derivative is not supported. */
+  bool computeDerivative(const RobotState& state, Eigen::MatrixXd& jacobian, Eigen::MatrixXd& jacobian_derivative,
+                         const Eigen::Vector3d& reference_point_position = Eigen::Vector3d::Zero()) const;
+
+private:
+  enum class ColumnType
+  {
+    REVOLUTE,
+    PRISMATIC,
+    PLANAR
+  };
+
+  /** \brief Contribution of one active joint to the Jacobian */
+  struct Column
+  {
+    ColumnType type;
+    const LinkModel* child_link;
+    Eigen::Vector3d axis;  // joint axis in the child link frame (unused for planar joints)
+    int column;            // first column of the joint in the Jacobian
+    int variable_index;    // index of the first joint variable in the full robot state
+  };
+
+  bool checkState(const RobotState& state) const;
+
+  const JointModelGroup* group_;
+  const LinkModel* root_link_;
+  const LinkModel* tip_;
+  std::vector<Column> columns_;
+  bool has_planar_joints_;
+};
+}  // namespace core
+}  // namespace moveit
@@ -44,6 +44,7 @@
 #include <visualization_msgs/msg/marker_array.hpp>
 #include <std_msgs/msg/color_rgba.hpp>
 #include <geometry_msgs/msg/twist.hpp>
+#include <array>
 #include <cassert>
 
 #include <rclcpp/duration.hpp>
@@ -100,6 +101,29 @@ public:
   /** \brief Copy operator */
   RobotState& operator=(const RobotState& other);
 
+  /** \brief Flags selecting which parts of a state are transferred by copyFrom(). */
+  enum CopyMask : unsigned int
+  {
+    /** \brief Joint positions. Unless COPY_TRANSFORMS is also set, all transforms of this state are marked dirty. */
+    COPY_POSITIONS = 1u << 0,
+    /** \brief Joint velocities (and whether velocities are set at all) */
+    COPY_VELOCITIES = 1u << 1,
+    /** \brief Joint accelerations or efforts; both share the same storage, so they are copied together */
+    COPY_ACCELERATION_OR_EFFORT = 1u << 2,
+    /** \brief Computed (and dirty) transforms. Only used together with COPY_POSITIONS. */
+    COPY_TRANSFORMS = 1u << 3,
+    /** \brief Deep copies of the attached bodies, replacing the ones of this state */
+    COPY_ATTACHED_BODIES = 1u << 4,
+    COPY_ALL = COPY_POSITIONS | COPY_VELOCITIES | COPY_ACCELERATION_OR_EFFORT | COPY_TRANSFORMS | COPY_ATTACHED_BODIES
+  };
+
+  /** \brief Copy the parts of \e other selected by \e mask (a combination of CopyMask flags) into this state.
+
+      Parts that are not selected are left unchanged. Both states must be constructed for the same robot model, in
+      which case no memory is allocated unless attached bodies are copied. Throws std::invalid_argument if the robot
+      models differ. */
+  void copyFrom(const RobotState& other, unsigned int mask);
+
   /** \brief Get the robot model this state is constructed for. */
   const RobotModelConstPtr& getRobotModel() const
   {
@@ -1011,6 +1035,21 @@ public:
                  const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions(),
                  const kinematics::KinematicsBase::IKCostFn& cost_function = kinematics::KinematicsBase::IKCostFn());
 
+  /** \brief Solve IK for a sequence of poses of a single \e tip frame, e.g. the waypoints of a Cartesian path, passing
+      all poses to the kinematics solver at once (see kinematics::KinematicsBase::searchPositionIKSequence()).
+      The poses are assumed to be in the reference frame of the kinematic model. Each pose is seeded with the solution
+      of the previous one and the first pose with this state. For each of the leading poses that were solved, a copy of
+      this state with the solution is appended to \e states, and this state is set to the last solution.
+      Returns true if all poses were solved.
+      @param poses The poses the tip frame needs to achieve, in order
+      @param tip The name of the frame for which IK is attempted
+      @param states The states reaching the solved poses
+      @param timeout The timeout passed to the kinematics solver for each pose */
+  bool setFromIKSequence(const JointModelGroup* group, const EigenSTL::vector_Isometry3d& poses,
+                         const std::string& tip, std::vector<RobotStatePtr>& states,
+                         double timeout = 0.0,
+                         const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions());
+
   /**
       \brief setFromIK for multiple poses and tips (end effectors) when no solver exists for the jmg that can solver for
       non-chain kinematics. In this case, we divide the group into subgroups and do IK solving individually
@@ -1330,12 +1369,12 @@ public:
 
   bool dirtyLinkTransforms() const
   {
-    return dirty_link_transforms_;
+    return !dirty_link_transforms_.empty();
   }
 
   bool dirtyCollisionBodyTransforms() const
   {
-    return dirty_link_transforms_ || dirty_collision_body_transforms_;
+    return !dirty_link_transforms_.empty() || !dirty_collision_body_transforms_.empty();
   }
 
   /** \brief Returns true if anything in this state is dirty */
@@ -1668,6 +1707,72 @@ public:
   bool setToIKSolverFrame(Eigen::Isometry3d& pose, const std::string& ik_frame);
 
 private:
+  /** \brief The roots of the subtrees of the kinematic tree whose transforms need to be recomputed.
+
+      The stored subtrees are disjoint: a joint is only added if it is not already covered by one of the roots, and
+      roots that are descendants of an added joint are dropped. This allows changing joints in separate branches
+      (e.g. a wrist and a base joint, or two arms) without recomputing everything below their common root.
+      If more than MAX_ROOTS subtrees are dirty, they are merged into their common root, like it was done before. */
+  class DirtySubtrees
+  {
+  public:
+    static constexpr std::size_t MAX_ROOTS = 4;
+
+    bool empty() const
+    {
+      return size_ == 0;
+    }
+
+    void clear()
+    {
+      size_ = 0;
+    }
+
+    /** \brief Mark exactly the subtree starting at \e root dirty */
+    void set(const JointModel* root)
+    {
+      roots_[0] = root;
+      size_ = 1;
+    }
+
+    /** \brief Additionally mark the subtree starting at \e joint dirty */
+    void add(const JointModel* joint, const RobotModel& model)
+    {
+      for (std::size_t i = 0; i < size_;)
+      {
+        const JointModel* common_root = model.getCommonRoot(roots_[i], joint);
+        if (common_root == roots_[i])
+          return;  // already covered
+        if (common_root == joint)
+          roots_[i] = roots_[--size_];  // covered by the new root
+        else
+          ++i;
+      }
+      if (size_ < MAX_ROOTS)
+      {
+        roots_[size_++] = joint;
+        return;
+      }
+      for (std::size_t i = 0; i < size_; ++i)
+        joint = model.getCommonRoot(joint, roots_[i]);
+      set(joint);
+    }
+
+    const JointModel* const* begin() const
+    {
+      return roots_.data();
+    }
+
+    const JointModel* const* end() const
+    {
+      return roots_.data() + size_;
+    }
+
+  private:
+    std::array<const JointModel*, MAX_ROOTS> roots_;
+    std::size_t size_ = 0;
+  };
+
   void allocMemory();
   void init();
   void copyFrom(const RobotState& other);
@@ -1675,17 +1780,15 @@ private:
   void markDirtyJointTransforms(const JointModel* joint)
   {
     dirty_joint_transforms_[joint->getJointIndex()] = 1;
-    dirty_link_transforms_ =
-        dirty_link_transforms_ == nullptr ? joint : robot_model_->getCommonRoot(dirty_link_transforms_, joint);
+    dirty_link_transforms_.add(joint, *robot_model_);
   }
 
   void markDirtyJointTransforms(const JointModelGroup* group)
   {
     for (const JointModel* jm : group->getActiveJointModels())
       dirty_joint_transforms_[jm->getJointIndex()] = 1;
-    dirty_link_transforms_ = dirty_link_transforms_ == nullptr ?
-                                 group->getCommonRoot() :
-                                 robot_model_->getCommonRoot(dirty_link_transforms_, group->getCommonRoot());
+    for (const JointModel* jm : group->getJointRoots())
+      dirty_link_transforms_.add(jm, *robot_model_);
   }
 
   void markVelocity();
@@ -1697,8 +1800,12 @@ private:
   /** \brief Update all mimic joints within group */
   void updateMimicJoints(const JointModelGroup* group);
 
+  /** \brief Recompute the global transforms of all links below \e start. Attached bodies are not updated. */
   void updateLinkTransformsInternal(const JointModel* start);
 
+  /** \brief Recompute the global transforms of all attached bodies from their link transforms */
+  void updateAttachedBodyTransforms();
+
   void getMissingKeys(const std::map<std::string, double>& variable_map,
                       std::vector<std::string>& missing_variables) const;
   void getStateTreeJointString(std::ostream& ss, const JointModel* jm, const std::string& pfx0, bool last) const;
@@ -1721,12 +1828,12 @@ private:
   bool has_acceleration_ = false;
   bool has_effort_ = false;
 
-  const JointModel* dirty_link_transforms_ = nullptr;
-  const JointModel* dirty_collision_body_transforms_ = nullptr;
+  DirtySubtrees dirty_link_transforms_;
+  DirtySubtrees dirty_collision_body_transforms_;
 
   // All the following transform variables point into aligned memory.
   // They are updated lazily, based on the flags in dirty_joint_transforms_
-  // resp. the pointers dirty_link_transforms_ and dirty_collision_body_transforms_
+  // resp. the subtrees in dirty_link_transforms_ and dirty_collision_body_transforms_
   std::vector<Eigen::Isometry3d> variable_joint_transforms_;  ///< Local transforms of all joints
   std::vector<Eigen::Isometry3d> global_link_transforms_;  ///< Transforms from model frame to link frame for each link
   std::vector<Eigen::Isometry3d> global_collision_body_transforms_;  ///< Transforms from model frame to collision
@@ -0,0 +1,108 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/robot_state/robot_state.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace moveit
+{
+namespace core
+{
+/** \brief A pool of recycled RobotState instances for a single robot model.
+
+    Constructing or copy-constructing a RobotState allocates all of its buffers. Code that needs many short-lived
+    states (state validity checking, constraint sampling, trajectory generation) can instead acquire states from a
+    pool: states are returned to the pool when the handle handed out by acquire() goes out of scope, and subsequent
+    acquisitions reuse them without allocating. The pool is thread-safe. Handles may outlive the pool, in which case
+    the states are simply deleted on release. */
+class RobotStatePool
+{
+  struct Storage;
+
+public:
+  /** \brief Deleter of the handles returned by acquire(): gives the state back to its pool */
+  struct Releaser
+  {
+    std::weak_ptr<Storage> storage;
+    void operator()(RobotState* state) const;
+  };
+
+  /** \brief Handle to a state owned by the pool */
+  using StatePtr = std::unique_ptr<RobotState, Releaser>;
+
+  /** \brief Create a pool for \e robot_model holding \e initial_size preallocated states */
+  explicit RobotStatePool(const RobotModelConstPtr& robot_model, std::size_t initial_size = 0);
+
+  RobotStatePool(const RobotStatePool&) = delete;
+  RobotStatePool& operator=(const RobotStatePool&) = delete;
+
+  const RobotModelConstPtr& getRobotModel() const
+  {
+    return robot_model_;
+  }
+
+  /** \brief Get a state from the pool, allocating a new one only if no recycled state is available.
+
+      The returned state has no attached bodies, velocities, accelerations or efforts. Its positions are either the
+      default values of the model or whatever the previous user of the recycled state left in it. */
+  StatePtr acquire();
+
+  /** \brief Get a state from the pool and initialize it from \e source using RobotState::copyFrom() with \e mask.
+      By default only the joint positions are copied. */
+  StatePtr acquire(const RobotState& source, unsigned int mask = RobotState::COPY_POSITIONS);
+
+  /** \brief Make sure at least \e count states are available without allocating */
+  void reserve(std::size_t count);
+
+  /** \brief Number of idle states currently held by the pool */
+  std::size_t getAvailableCount() const;
+
+private:
+  struct Storage
+  {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<RobotState>> free_states;
+  };
+
+  std::unique_ptr<RobotState> createState() const;
+
+  RobotModelConstPtr robot_model_;
+  std::shared_ptr<Storage> storage_;
+};
+}  // namespace core
+}  // namespace moveit
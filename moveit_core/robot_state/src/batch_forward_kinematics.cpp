@@ -0,0 +1,332 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/batch_forward_kinematics.hpp>
+#include <moveit/robot_model/prismatic_joint_model.hpp>
+#include <moveit/robot_model/revolute_joint_model.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+constexpr std::size_t N_COEFF = LinkTransformBatch::COEFFICIENTS;
+
+// The functions below operate on blocks of 12 coefficient rows of n values each (see LinkTransformBatch).
+
+void broadcastTransform(const Eigen::Isometry3d& t, double* out, std::size_t n)
+{
+  for (int r = 0; r < 3; ++r)
+  {
+    for (int c = 0; c < 4; ++c)
+      std::fill_n(out + (4 * r + c) * n, n, t(r, c));
+  }
+}
+
+// out = a * b, with b being the same for all states. out must not alias a.
+void multiplyConstant(const double* a, const Eigen::Isometry3d& b, double* out, std::size_t n)
+{
+  for (int r = 0; r < 3; ++r)
+  {
+    const double* a0 = a + (4 * r + 0) * n;
+    const double* a1 = a + (4 * r + 1) * n;
+    const double* a2 = a + (4 * r + 2) * n;
+    const double* a3 = a + (4 * r + 3) * n;
+    for (int c = 0; c < 4; ++c)
+    {
+      const double b0 = b(0, c);
+      const double b1 = b(1, c);
+      const double b2 = b(2, c);
+      double* o = out + (4 * r + c) * n;
+      if (c < 3)
+      {
+        for (std::size_t s = 0; s < n; ++s)
+          o[s] = a0[s] * b0 + a1[s] * b1 + a2[s] * b2;
+      }
+      else
+      {
+        for (std::size_t s = 0; s < n; ++s)
+          o[s] = a0[s] * b0 + a1[s] * b1 + a2[s] * b2 + a3[s];
+      }
+    }
+  }
+}
+
+// out = a * Rot(axis, q[s]) for every state s. out must not alias a.
+void multiplyRevolute(const double* a, const Eigen::Vector3d& axis, const double* q, double* out, std::size_t n)
+{
+  const double x = axis.x();
+  const double y = axis.y();
+  const double z = axis.z();
+  const double x2 = x * x;
+  const double y2 = y * y;
+  const double z2 = z * z;
+  const double xy = x * y;
+  const double xz = x * z;
+  const double yz = y * z;
+
+  for (int r = 0; r < 3; ++r)
+  {
+    const double* a0 = a + (4 * r + 0) * n;
+    const double* a1 = a + (4 * r + 1) * n;
+    const double* a2 = a + (4 * r + 2) * n;
+    double* o0 = out + (4 * r + 0) * n;
+    double* o1 = out + (4 * r + 1) * n;
+    double* o2 = out + (4 * r + 2) * n;
+    for (std::size_t s = 0; s < n; ++s)
+    {
+      // same expressions as RevoluteJointModel::computeTransform()
+      const double c = std::cos(q[s]);
+      const double sn = std::sin(q[s]);
+      const double t = 1.0 - c;
+      const double r00 = t * x2 + c;
+      const double r10 = t * xy + z * sn;
+      const double r20 = t * xz - y * sn;
+      const double r01 = t * xy - z * sn;
+      const double r11 = t * y2 + c;
+      const double r21 = t * yz + x * sn;
+      const double r02 = t * xz + y * sn;
+      const double r12 = t * yz - x * sn;
+      const double r22 = t * z2 + c;
+      o0[s] = a0[s] * r00 + a1[s] * r10 + a2[s] * r20;
+      o1[s] = a0[s] * r01 + a1[s] * r11 + a2[s] * r21;
+      o2[s] = a0[s] * r02 + a1[s] * r12 + a2[s] * r22;
+    }
+    std::copy_n(a + (4 * r + 3) * n, n, out + (4 * r + 3) * n);
+  }
+}
+
+// out = a * Translation(axis * q[s]) for every state s. out must not alias a.
+void multiplyPrismatic(const double* a, const Eigen::Vector3d& axis, const double* q, double* out, std::size_t n)
+{
+  const double x = axis.x();
+  const double y = axis.y();
+  const double z = axis.z();
+  for (int r = 0; r < 3; ++r)
+  {
+    const double* a0 = a + (4 * r + 0) * n;
+    const double* a1 = a + (4 * r + 1) * n;
+    const double* a2 = a + (4 * r + 2) * n;
+    const double* a3 = a + (4 * r + 3) * n;
+    double* o3 = out + (4 * r + 3) * n;
+    for (std::size_t s = 0; s < n; ++s)
+      o3[s] = a3[s] + (a0[s] * x + a1[s] * y + a2[s] * z) * q[s];
+    std::copy_n(a0, n, out + (4 * r + 0) * n);
+    std::copy_n(a1, n, out + (4 * r + 1) * n);
+    std::copy_n(a2, n, out + (4 * r + 2) * n);
+  }
+}
+
+Eigen::Isometry3d loadTransform(const double* a, std::size_t n, std::size_t s)
+{
+  Eigen::Isometry3d t = Eigen::Isometry3d::Identity();
+  for (int r = 0; r < 3; ++r)
+  {
+    for (int c = 0; c < 4; ++c)
+      t(r, c) = a[(4 * r + c) * n + s];
+  }
+  return t;
+}
+
+void storeTransform(const Eigen::Isometry3d& t, double* out, std::size_t n, std::size_t s)
+{
+  for (int r = 0; r < 3; ++r)
+  {
+    for (int c = 0; c < 4; ++c)
+      out[(4 * r + c) * n + s] = t(r, c);
+  }
+}
+}  // namespace
+
+void LinkTransformBatch::resize(std::size_t link_count, std::size_t state_count)
+{
+  link_count_ = link_count;
+  state_count_ = state_count;
+  if (data_.size() < link_count * N_COEFF * state_count)
+    data_.resize(link_count * N_COEFF * state_count);
+  if (scratch_.size() < (N_COEFF + 1) * state_count)
+    scratch_.resize((N_COEFF + 1) * state_count);
+}
+
+Eigen::Isometry3d LinkTransformBatch::getTransform(std::size_t link_index, std::size_t state_index) const
+{
+  assert(link_index < link_count_ && state_index < state_count_);
+  return loadTransform(getCoefficients(link_index, 0), state_count_, state_index);
+}
+
+BatchForwardKinematics::BatchForwardKinematics(const JointModelGroup* group) : group_(group)
+{
+  if (!group_)
+    throw Exception("BatchForwardKinematics requires a valid JointModelGroup");
+
+  const RobotModel& model = group_->getParentModel();
+  batch_index_of_link_.assign(model.getLinkModelCount(), -1);
+
+  const std::vector<const LinkModel*>& links = group_->getUpdatedLinkModels();
+  steps_.reserve(links.size());
+  for (std::size_t i = 0; i < links.size(); ++i)
+  {
+    const LinkModel* link = links[i];
+    batch_index_of_link_[link->getLinkIndex()] = static_cast<int>(i);
+
+    Step step;
+    step.link = link;
+    step.joint = link->getParentJointModel();
+    const LinkModel* parent = link->getParentLinkModel();
+    // updated links are sorted such that parents come first
+    step.parent_batch_index = parent ? batch_index_of_link_[parent->getLinkIndex()] : -1;
+    step.type = StepType::FIXED;
+    step.group_variable_index = -1;
+    step.mimic_factor = 1.0;
+    step.mimic_offset = 0.0;
+    step.axis = Eigen::Vector3d::Zero();
+
+    const JointModel* joint = step.joint;
+    if (joint->getVariableCount() > 0 && group_->hasJointModel(joint->getName()))
+    {
+      // mimic joints are evaluated from the joint they follow, if that one is part of the group
+      const JointModel* source = joint;
+      if (joint->getMimic())
+      {
+        source = joint->getMimic();
+        step.mimic_factor = joint->getMimicFactor();
+        step.mimic_offset = joint->getMimicOffset();
+      }
+      if (group_->hasJointModel(source->getName()))
+      {
+        step.group_variable_index = group_->getVariableGroupIndex(source->getName());
+        if (joint->getType() == JointModel::REVOLUTE)
+        {
+          step.type = StepType::REVOLUTE;
+          step.axis = static_cast<const RevoluteJointModel*>(joint)->getAxis();
+        }
+        else if (joint->getType() == JointModel::PRISMATIC)
+        {
+          step.type = StepType::PRISMATIC;
+          step.axis = static_cast<const PrismaticJointModel*>(joint)->getAxis();
+        }
+        else
+        {
+          step.type = StepType::GENERIC;
+        }
+      }
+    }
+    steps_.push_back(step);
+  }
+}
+
+void BatchForwardKinematics::compute(const RobotState& reference,
+                                     const Eigen::Ref<const Eigen::MatrixXd>& group_positions,
+                                     LinkTransformBatch& transforms) const
+{
+  assert(reference.getRobotModel().get() == &group_->getParentModel());
+  if (static_cast<unsigned int>(group_positions.rows()) != group_->getVariableCount())
+  {
+    throw Exception("Expected " + std::to_string(group_->getVariableCount()) + " rows of group positions, got " +
+                    std::to_string(group_positions.rows()));
+  }
+
+  const std::size_t n = group_positions.cols();
+  transforms.resize(steps_.size(), n);
+  if (n == 0)
+    return;
+
+  double* a = transforms.scratch_.data();  // 12 rows: parent transform times joint origin
+  double* q = a + N_COEFF * n;             // 1 row: joint values
+
+  for (std::size_t i = 0; i < steps_.size(); ++i)
+  {
+    const Step& step = steps_[i];
+    double* out = transforms.getCoefficients(i, 0);
+    const Eigen::Isometry3d& origin = step.link->getJointOriginTransform();
+
+    // a = parent * origin
+    if (step.parent_batch_index >= 0)
+    {
+      multiplyConstant(transforms.getCoefficients(step.parent_batch_index, 0), origin, a, n);
+    }
+    else
+    {
+      const LinkModel* parent = step.link->getParentLinkModel();
+      broadcastTransform(parent ? reference.getGlobalLinkTransform(parent) * origin : origin, a, n);
+    }
+
+    switch (step.type)
+    {
+      case StepType::FIXED:
+      {
+        if (step.joint->getVariableCount() == 0)
+        {
+          std::copy_n(a, N_COEFF * n, out);
+        }
+        else
+        {
+          Eigen::Isometry3d joint_transform;
+          step.joint->computeTransform(reference.getJointPositions(step.joint), joint_transform);
+          multiplyConstant(a, joint_transform, out, n);
+        }
+        break;
+      }
+      case StepType::REVOLUTE:
+      case StepType::PRISMATIC:
+      {
+        const double* values = group_positions.data() + step.group_variable_index;
+        const Eigen::Index stride = group_positions.outerStride();
+        for (std::size_t s = 0; s < n; ++s)
+          q[s] = step.mimic_factor * values[s * stride] + step.mimic_offset;
+        if (step.type == StepType::REVOLUTE)
+          multiplyRevolute(a, step.axis, q, out, n);
+        else
+          multiplyPrismatic(a, step.axis, q, out, n);
+        break;
+      }
+      case StepType::GENERIC:
+      {
+        Eigen::Isometry3d joint_transform;
+        for (std::size_t s = 0; s < n; ++s)
+        {
+          const double* values = group_positions.data() + s * group_positions.outerStride() + step.group_variable_index;
+          step.joint->computeTransform(values, joint_transform);
+          storeTransform(loadTransform(a, n, s) * joint_transform, out, n, s);
+        }
+        break;
+      }
+    }
+  }
+}
+}  // namespace core
+}  // namespace moveit
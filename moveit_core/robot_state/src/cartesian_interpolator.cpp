@@ -36,7 +36,9 @@
 
 /* Author: Ioan Sucan, Sachin Chitta, Acorn Pooley, Mario Prats, Dave Coleman, Robert Haschke */
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <moveit/robot_state/cartesian_interpolator.hpp>
 #include <geometric_shapes/check_isometry.h>
 #include <rclcpp/logger.hpp>
@@ -52,6 +54,10 @@ namespace moveit::core
 // will be printed out.
 static const std::size_t MIN_STEPS_FOR_JUMP_THRESH = 10;
 
+// With adaptive steps, a step is refined if the joint-space distance per path fraction grows by more than this factor
+// relative to the previous step.
+static const double MAX_JOINT_RATE_INCREASE = 2.0;
+
 namespace
 {
 
@@ -247,25 +253,84 @@ CartesianInterpolator::Percentage CartesianInterpolator::computeCartesianPath(
   traj.clear();
   traj.push_back(std::make_shared<moveit::core::RobotState>(*start_state));
 
+  const auto pose_at = [&](double percentage) {
+    Eigen::Isometry3d pose(start_quaternion.slerp(percentage, target_quaternion));
+    pose.translation() = percentage * rotated_target.translation() + (1 - percentage) * start_pose.translation();
+    return pose;
+  };
+
   double last_valid_percentage = 0.0;
   Eigen::Isometry3d prev_pose = start_pose;
   RobotState prev_state(state);
-  for (std::size_t i = 1; i <= steps; ++i)
-  {
-    double percentage = static_cast<double>(i) / static_cast<double>(steps);
 
-    Eigen::Isometry3d pose(start_quaternion.slerp(percentage, target_quaternion));
-    pose.translation() = percentage * rotated_target.translation() + (1 - percentage) * start_pose.translation();
+  // Steps span a whole number of base steps of max_step. Where the joints move uniformly, the stride doubles after each
+  // successful step, up to max_step_growth base steps.
+  const std::size_t max_stride = std::max(std::size_t{ 1 }, static_cast<std::size_t>(precision.max_step_growth));
+  const kinematics::KinematicsBaseConstPtr& solver = group->getSolverInstance();
+  if (max_stride == 1 && !validCallback && !cost_function && solver && solver->supportsIKSequence() &&
+      solver->getTipFrames().size() == 1)
+  {
+    // the IK solutions of the steps only depend on each other, so the solver can receive all poses at once
+    EigenSTL::vector_Isometry3d poses;
+    poses.reserve(steps);
+    for (std::size_t i = 1; i <= steps; ++i)
+      poses.push_back(pose_at(static_cast<double>(i) / static_cast<double>(steps)) * inv_offset);
+    std::vector<RobotStatePtr> ik_states;
+    state.setFromIKSequence(group, poses, link->getName(), ik_states, 0.0, options);
+
+    for (std::size_t i = 0; i < ik_states.size(); ++i)
+    {
+      double percentage = static_cast<double>(i + 1) / static_cast<double>(steps);
+      const Eigen::Isometry3d pose = poses[i] * link_offset;
+      if (!validateAndImproveInterval(prev_state, *ik_states[i], prev_pose, pose, traj, percentage,
+                                      1.0 / static_cast<double>(steps), group, link, precision, validCallback, options,
+                                      cost_function, link_offset))
+        break;
+
+      prev_pose = pose;
+      prev_state = *ik_states[i];
+      last_valid_percentage = percentage;
+    }
+    return last_valid_percentage;
+  }
 
-    if (!state.setFromIK(group, pose * inv_offset, link->getName(), 0.0, validCallback, options, cost_function) ||
-        !validateAndImproveInterval(prev_state, state, prev_pose, pose, traj, percentage,
-                                    1.0 / static_cast<double>(steps), group, link, precision, validCallback, options,
-                                    cost_function, link_offset))
-      break;
+  std::size_t stride = 1;
+  std::size_t done_steps = 0;
+  double prev_joint_rate = 0.0;
+  while (done_steps < steps)
+  {
+    const std::size_t step_count = std::min(stride, steps - done_steps);
+    const double width = static_cast<double>(step_count) / static_cast<double>(steps);
+    double percentage = static_cast<double>(done_steps + step_count) / static_cast<double>(steps);
+    const Eigen::Isometry3d pose = pose_at(percentage);
+    const std::size_t traj_size = traj.size();
+
+    bool valid = state.setFromIK(group, pose * inv_offset, link->getName(), 0.0, validCallback, options, cost_function);
+    const double joint_rate = valid ? state.distance(prev_state, group) / width : 0.0;
+    // refine where the joints move faster per Cartesian step than before, i.e. near singularities and joint jumps
+    if (valid && step_count > 1 && joint_rate > MAX_JOINT_RATE_INCREASE * prev_joint_rate)
+      valid = false;
+    if (valid)
+      valid = validateAndImproveInterval(prev_state, state, prev_pose, pose, traj, percentage, width, group, link,
+                                         precision, validCallback, options, cost_function, link_offset);
+
+    if (!valid)
+    {
+      if (step_count == 1)
+        break;
+      // retry the interval with a smaller stride, starting from the last valid state
+      traj.resize(traj_size);
+      state = prev_state;
+      stride = std::max(std::size_t{ 1 }, step_count / 2);
+      continue;
+    }
 
     prev_pose = pose;
     prev_state = state;
+    prev_joint_rate = joint_rate;
+    done_steps += step_count;
     last_valid_percentage = percentage;
+    stride = std::min(max_stride, 2 * stride);
   }
 
   return last_valid_percentage;
@@ -306,6 +371,96 @@ CartesianInterpolator::Percentage CartesianInterpolator::computeCartesianPath(
   return percentage_solved;
 }
 
+CartesianInterpolator::Percentage CartesianInterpolator::computeCartesianPathParallel(
+    const RobotState* start_state, const JointModelGroup* group, std::vector<RobotStatePtr>& traj,
+    const LinkModel* link, const EigenSTL::vector_Isometry3d& waypoints, bool global_reference_frame,
+    const MaxEEFStep& max_step, const CartesianPrecision& precision, const GroupStateValidityCallbackFn& validCallback,
+    const kinematics::KinematicsQueryOptions& options, const kinematics::KinematicsBase::IKCostFn& cost_function,
+    const Eigen::Isometry3d& link_offset, std::size_t thread_count, double max_boundary_distance)
+{
+  const kinematics::KinematicsBaseConstPtr& solver = group->getSolverInstance();
+  if (waypoints.size() < 2 || thread_count == 1 || !solver || !solver->supportsParallelIKBatch())
+  {
+    return computeCartesianPath(start_state, group, traj, link, waypoints, global_reference_frame, max_step, precision,
+                                validCallback, options, cost_function, link_offset);
+  }
+
+  // waypoints in the local reference frame are relative to the preceding one
+  RobotState state(*start_state);
+  EigenSTL::vector_Isometry3d targets(waypoints);
+  if (!global_reference_frame)
+  {
+    Eigen::Isometry3d pose = state.getGlobalLinkTransform(link) * link_offset;
+    for (Eigen::Isometry3d& target : targets)
+      target = pose = pose * target;
+  }
+
+  // solve the start states of the segments one after the other, each IK call is much cheaper than a whole segment
+  std::vector<RobotStatePtr> segment_starts{ std::make_shared<RobotState>(state) };
+  const Eigen::Isometry3d inv_offset = link_offset.inverse();
+  for (std::size_t i = 0; i + 1 < targets.size(); ++i)
+  {
+    if (!state.setFromIK(group, targets[i] * inv_offset, link->getName(), 0.0, validCallback, options, cost_function))
+      break;
+    segment_starts.push_back(std::make_shared<RobotState>(state));
+  }
+
+  std::vector<std::vector<RobotStatePtr>> segments(targets.size());
+  std::vector<double> segment_percentages(targets.size(), 0.0);
+  std::atomic<std::size_t> next_segment{ 0 };
+  const auto worker = [&]() {
+    for (std::size_t i = next_segment++; i < segment_starts.size(); i = next_segment++)
+    {
+      segment_percentages[i] = computeCartesianPath(segment_starts[i].get(), group, segments[i], link, targets[i], true,
+                                                    max_step, precision, validCallback, options, cost_function,
+                                                    link_offset);
+    }
+  };
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min(thread_count, segment_starts.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // stitch the segments, recomputing those that do not start where the previous one ended
+  double percentage_solved = 0.0;
+  for (std::size_t i = 0; i < targets.size(); ++i)
+  {
+    std::vector<RobotStatePtr>::iterator start = segments[i].begin();
+    if (i > 0)
+    {
+      const RobotState* end_state = traj.back().get();
+      if (i >= segment_starts.size() || end_state->distance(*segment_starts[i], group) > max_boundary_distance)
+      {
+        RCLCPP_DEBUG(getLogger(), "Recomputing Cartesian path segment %zu from the end of the previous segment", i);
+        segment_percentages[i] = computeCartesianPath(end_state, group, segments[i], link, targets[i], true, max_step,
+                                                      precision, validCallback, options, cost_function, link_offset);
+        start = segments[i].begin();
+      }
+      // the first state of a segment duplicates the end of the previous one
+      if (!segments[i].empty())
+        std::advance(start, 1);
+    }
+    traj.insert(traj.end(), start, segments[i].end());
+
+    if (fabs(segment_percentages[i] - 1.0) < std::numeric_limits<double>::epsilon())
+    {
+      percentage_solved = static_cast<double>(i + 1) / static_cast<double>(targets.size());
+    }
+    else
+    {
+      percentage_solved += segment_percentages[i] / static_cast<double>(targets.size());
+      break;
+    }
+  }
+
+  return percentage_solved;
+}
+
 JumpThreshold JumpThreshold::disabled()
 {
   return JumpThreshold();
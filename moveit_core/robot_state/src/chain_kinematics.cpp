@@ -0,0 +1,210 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/chain_kinematics.hpp>
+#include <moveit/robot_model/prismatic_joint_model.hpp>
+#include <moveit/robot_model/revolute_joint_model.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "transform_kernels.hpp"
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+struct ChainJoint
+{
+  Eigen::Isometry3d origin;  // from the child link of the previous moving joint (or the base link) to this joint
+  Eigen::Vector3d axis;
+  bool revolute;
+  int variable;  // index of the joint variable within the group
+};
+
+// out = parent_to_joint * rotation(axis, angle), using the same expansion of Rodrigues' formula as
+// RevoluteJointModel::computeTransform()
+inline void applyRevolute(const Eigen::Vector3d& axis, double angle, const Eigen::Isometry3d& parent_to_joint,
+                          Eigen::Isometry3d& out)
+{
+  const double c = std::cos(angle);
+  const double s = std::sin(angle);
+  const double t = 1.0 - c;
+  Eigen::Matrix3d rotation;
+  rotation << t * axis.x() * axis.x() + c, t * axis.x() * axis.y() - axis.z() * s,
+      t * axis.x() * axis.z() + axis.y() * s,  //
+      t * axis.x() * axis.y() + axis.z() * s, t * axis.y() * axis.y() + c,
+      t * axis.y() * axis.z() - axis.x() * s,  //
+      t * axis.x() * axis.z() - axis.y() * s, t * axis.y() * axis.z() + axis.x() * s, t * axis.z() * axis.z() + c;
+  out.linear().noalias() = parent_to_joint.linear() * rotation;
+  out.translation() = parent_to_joint.translation();
+  out.makeAffine();
+}
+
+// out = parent_to_joint * translation(axis * distance)
+inline void applyPrismatic(const Eigen::Vector3d& axis, double distance, const Eigen::Isometry3d& parent_to_joint,
+                           Eigen::Isometry3d& out)
+{
+  out.linear() = parent_to_joint.linear();
+  out.translation().noalias() = parent_to_joint.translation() + parent_to_joint.linear() * (axis * distance);
+  out.makeAffine();
+}
+
+template <std::size_t N>
+class FixedChainKinematics final : public ChainKinematics
+{
+public:
+  FixedChainKinematics(const JointModelGroup* group, const LinkModel* base_link,
+                       std::vector<const LinkModel*> link_models, const std::vector<ChainJoint>& joints,
+                       const Eigen::Isometry3d& tip_offset)
+    : ChainKinematics(group, base_link, std::move(link_models)), tip_offset_(tip_offset)
+  {
+    std::copy(joints.begin(), joints.end(), joints_.begin());
+  }
+
+  void computeLinkTransforms(const double* group_positions, const Eigen::Isometry3d& base,
+                             Eigen::Isometry3d* link_transforms) const override
+  {
+    Eigen::Isometry3d parent_to_joint;
+    const Eigen::Isometry3d* parent = &base;
+    // N is a compile-time constant, so this loop is fully unrolled
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      const ChainJoint& joint = joints_[i];
+      detail::multiplyAffine(*parent, joint.origin, parent_to_joint);
+      if (joint.revolute)
+        applyRevolute(joint.axis, group_positions[joint.variable], parent_to_joint, link_transforms[i]);
+      else
+        applyPrismatic(joint.axis, group_positions[joint.variable], parent_to_joint, link_transforms[i]);
+      parent = &link_transforms[i];
+    }
+    detail::multiplyAffine(*parent, tip_offset_, link_transforms[N]);
+  }
+
+  void computeJacobian(const Eigen::Isometry3d* link_transforms, Eigen::MatrixXd& jacobian) const override
+  {
+    jacobian.resize(6, N);
+    const Eigen::Vector3d tip_point = link_transforms[N].translation();
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      const ChainJoint& joint = joints_[i];
+      const Eigen::Vector3d axis = link_transforms[i].linear() * joint.axis;
+      if (joint.revolute)
+      {
+        jacobian.block<3, 1>(0, joint.variable) = axis.cross(tip_point - link_transforms[i].translation());
+        jacobian.block<3, 1>(3, joint.variable) = axis;
+      }
+      else
+      {
+        jacobian.block<3, 1>(0, joint.variable) = axis;
+        jacobian.block<3, 1>(3, joint.variable) = Eigen::Vector3d::Zero();
+      }
+    }
+  }
+
+private:
+  std::array<ChainJoint, N> joints_;
+  Eigen::Isometry3d tip_offset_;
+};
+
+template <std::size_t N>
+std::unique_ptr<ChainKinematics> createFixedChain(const JointModelGroup* group, const LinkModel* base_link,
+                                                  std::vector<const LinkModel*>& link_models,
+                                                  const std::vector<ChainJoint>& joints,
+                                                  const Eigen::Isometry3d& tip_offset)
+{
+  if (joints.size() == N)
+    return std::make_unique<FixedChainKinematics<N>>(group, base_link, std::move(link_models), joints, tip_offset);
+  if constexpr (N > 1)
+    return createFixedChain<N - 1>(group, base_link, link_models, joints, tip_offset);
+  else
+    return nullptr;
+}
+}  // namespace
+
+std::unique_ptr<ChainKinematics> ChainKinematics::create(const JointModelGroup* group)
+{
+  if (!group || !group->isChain() || group->getJointModels().empty())
+    return nullptr;
+
+  const LinkModel* base_link = group->getJointModels().front()->getParentLinkModel();
+  const LinkModel* previous_link = base_link;
+  Eigen::Isometry3d offset = Eigen::Isometry3d::Identity();
+  std::vector<ChainJoint> joints;
+  std::vector<const LinkModel*> link_models;
+  for (const JointModel* joint_model : group->getJointModels())
+  {
+    // only serial chains without mimic joints can be specialized
+    if (joint_model->getParentLinkModel() != previous_link || joint_model->getMimic())
+      return nullptr;
+
+    const LinkModel* child_link = joint_model->getChildLinkModel();
+    offset = offset * child_link->getJointOriginTransform();
+    previous_link = child_link;
+
+    ChainJoint joint;
+    switch (joint_model->getType())
+    {
+      case JointModel::FIXED:
+        continue;
+      case JointModel::REVOLUTE:
+        joint.revolute = true;
+        joint.axis = static_cast<const RevoluteJointModel*>(joint_model)->getAxis();
+        break;
+      case JointModel::PRISMATIC:
+        joint.revolute = false;
+        joint.axis = static_cast<const PrismaticJointModel*>(joint_model)->getAxis();
+        break;
+      default:
+        return nullptr;
+    }
+    joint.origin = offset;
+    joint.variable = group->getVariableGroupIndex(joint_model->getName());
+    if (joint.variable < 0)
+      return nullptr;
+    joints.push_back(joint);
+    link_models.push_back(child_link);
+    offset.setIdentity();
+  }
+
+  if (joints.empty() || joints.size() > MAX_JOINTS || joints.size() != group->getVariableCount())
+    return nullptr;
+
+  // the tip link, rigidly attached to the last moving joint
+  link_models.push_back(previous_link);
+  return createFixedChain<MAX_JOINTS>(group, base_link, link_models, joints, offset);
+}
+}  // namespace core
+}  // namespace moveit
@@ -0,0 +1,248 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/jacobian_evaluator.hpp>
+#include <moveit/robot_model/prismatic_joint_model.hpp>
+#include <moveit/robot_model/revolute_joint_model.hpp>
+#include <moveit/utils/logger.hpp>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <cassert>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.core.jacobian_evaluator");
+}
+}  // namespace
+
+JacobianEvaluator::JacobianEvaluator(const JointModelGroup* group, const LinkModel* tip)
+  : group_(group), root_link_(nullptr), tip_(tip), has_planar_joints_(false)
+{
+  if (!group_)
+  {
+    throw Exception("JacobianEvaluator requires a valid JointModelGroup");
+  }
+  if (!group_->isChain())
+  {
+    throw Exception("The group '" + group_->getName() + "' is not a chain. Cannot compute Jacobian.");
+  }
+  if (group_->getActiveJointModels().empty() || group_->getLinkModels().empty())
+  {
+    throw Exception("The group '" + group_->getName() + "' doesn't contain any joint models. Cannot compute Jacobian.");
+  }
+  if (!tip_)
+    tip_ = group_->getLinkModels().back();
+  if (group_->getUpdatedLinkModelsSet().count(tip_) == 0)
+  {
+    throw Exception("Link '" + tip_->getName() + "' is not updated by the chain '" + group_->getName() + "'");
+  }
+
+  root_link_ = group_->getJointModels().front()->getParentLinkModel();
+
+  // same traversal as RobotState::getJacobian(): all active joints up to the parent joint of the tip link
+  int column = 0;
+  for (const JointModel* joint_model : group_->getActiveJointModels())
+  {
+    if (joint_model->getParentLinkModel() == tip_)
+      break;
+
+    Column entry;
+    entry.child_link = joint_model->getChildLinkModel();
+    entry.axis = Eigen::Vector3d::Zero();
+    entry.column = column;
+    entry.variable_index = joint_model->getFirstVariableIndex();
+    switch (joint_model->getType())
+    {
+      case JointModel::REVOLUTE:
+        entry.type = ColumnType::REVOLUTE;
+        entry.axis = static_cast<const RevoluteJointModel*>(joint_model)->getAxis();
+        break;
+      case JointModel::PRISMATIC:
+        entry.type = ColumnType::PRISMATIC;
+        entry.axis = static_cast<const PrismaticJointModel*>(joint_model)->getAxis();
+        break;
+      case JointModel::PLANAR:
+        entry.type = ColumnType::PLANAR;
+        has_planar_joints_ = true;
+        break;
+      default:
+        throw Exception("Joint '" + joint_model->getName() + "' of group '" + group_->getName() +
+                        "' has a type that is not supported in Jacobian computation");
+    }
+    columns_.push_back(entry);
+    column += static_cast<int>(joint_model->getVariableCount());
+  }
+}
+
+bool JacobianEvaluator::checkState(const RobotState& state) const
+{
+  if (state.getRobotModel().get() != &group_->getParentModel())
+  {
+    RCLCPP_ERROR(getLogger(), "The state was not constructed for the robot model of group '%s'",
+                 group_->getName().c_str());
+    return false;
+  }
+  assert(!state.dirtyLinkTransforms());
+  return true;
+}
+
+bool JacobianEvaluator::compute(const RobotState& state, Eigen::MatrixXd& jacobian,
+                                const Eigen::Vector3d& reference_point_position) const
+{
+  if (!checkState(state))
+    return false;
+
+  // everything is expressed with respect to the group root link
+  Eigen::Matrix3d root_rotation = Eigen::Matrix3d::Identity();
+  Eigen::Vector3d root_translation = Eigen::Vector3d::Zero();
+  if (root_link_)
+  {
+    const Eigen::Isometry3d& root_pose = state.getGlobalLinkTransform(root_link_);
+    root_rotation = root_pose.linear().transpose();
+    root_translation = root_pose.translation();
+  }
+  const Eigen::Vector3d tip_point =
+      root_rotation * (state.getGlobalLinkTransform(tip_) * reference_point_position - root_translation);
+
+  // no-op if the matrix already has the right size
+  jacobian.resize(6, group_->getVariableCount());
+  jacobian.setZero();
+
+  for (const Column& entry : columns_)
+  {
+    const Eigen::Isometry3d& link_pose = state.getGlobalLinkTransform(entry.child_link);
+    const Eigen::Matrix3d link_rotation = root_rotation * link_pose.linear();
+    const Eigen::Vector3d link_origin = root_rotation * (link_pose.translation() - root_translation);
+    switch (entry.type)
+    {
+      case ColumnType::REVOLUTE:
+      {
+        const Eigen::Vector3d axis = link_rotation * entry.axis;
+        jacobian.block<3, 1>(0, entry.column) = axis.cross(tip_point - link_origin);
+        jacobian.block<3, 1>(3, entry.column) = axis;
+        break;
+      }
+      case ColumnType::PRISMATIC:
+        jacobian.block<3, 1>(0, entry.column) = link_rotation * entry.axis;
+        break;
+      case ColumnType::PLANAR:
+        jacobian.block<3, 1>(0, entry.column) = link_rotation.col(0);
+        jacobian.block<3, 1>(0, entry.column + 1) = link_rotation.col(1);
+        jacobian.block<3, 1>(0, entry.column + 2) = link_rotation.col(2).cross(tip_point - link_origin);
+        jacobian.block<3, 1>(3, entry.column + 2) = link_rotation.col(2);
+        break;
+    }
+  }
+  return true;
+}
+
+bool JacobianEvaluator::computeDerivative(const RobotState& state, Eigen::MatrixXd& jacobian,
+                                          Eigen::MatrixXd& jacobian_derivative,
+                                          const Eigen::Vector3d& reference_point_position) const
+{
+  if (!state.hasVelocities())
+  {
+    RCLCPP_ERROR(getLogger(), "The Jacobian derivative requires a state with velocities");
+    return false;
+  }
+  if (has_planar_joints_)
+  {
+    RCLCPP_ERROR(getLogger(), "The Jacobian derivative is not supported for planar joints (group '%s')",
+                 group_->getName().c_str());
+    return false;
+  }
+  if (!compute(state, jacobian, reference_point_position))
+    return false;
+
+  Eigen::Matrix3d root_rotation = Eigen::Matrix3d::Identity();
+  Eigen::Vector3d root_translation = Eigen::Vector3d::Zero();
+  if (root_link_)
+  {
+    const Eigen::Isometry3d& root_pose = state.getGlobalLinkTransform(root_link_);
+    root_rotation = root_pose.linear().transpose();
+    root_translation = root_pose.translation();
+  }
+  const Eigen::Vector3d tip_point =
+      root_rotation * (state.getGlobalLinkTransform(tip_) * reference_point_position - root_translation);
+  const double* velocities = state.getVariableVelocities();
+
+  // linear velocity of the reference point
+  Eigen::Vector3d tip_velocity = Eigen::Vector3d::Zero();
+  for (const Column& entry : columns_)
+    tip_velocity += jacobian.block<3, 1>(0, entry.column) * velocities[entry.variable_index];
+
+  jacobian_derivative.resize(6, group_->getVariableCount());
+  jacobian_derivative.setZero();
+
+  // Walk down the chain, tracking the angular velocity of the current link and the linear velocity of its origin.
+  // Joint axes move with their link, so their derivative is omega x axis.
+  Eigen::Vector3d omega = Eigen::Vector3d::Zero();
+  Eigen::Vector3d origin_velocity = Eigen::Vector3d::Zero();
+  Eigen::Vector3d previous_origin = Eigen::Vector3d::Zero();
+  for (const Column& entry : columns_)
+  {
+    const Eigen::Isometry3d& link_pose = state.getGlobalLinkTransform(entry.child_link);
+    const Eigen::Vector3d axis = root_rotation * (link_pose.linear() * entry.axis);
+    const Eigen::Vector3d link_origin = root_rotation * (link_pose.translation() - root_translation);
+    const double velocity = velocities[entry.variable_index];
+
+    // the origin is rigidly attached to the previous link, unless moved by a prismatic joint (handled below)
+    origin_velocity += omega.cross(link_origin - previous_origin);
+    previous_origin = link_origin;
+
+    const Eigen::Vector3d axis_derivative = omega.cross(axis);
+    if (entry.type == ColumnType::REVOLUTE)
+    {
+      // the origin of the child link lies on the axis, so a revolute joint does not move it
+      jacobian_derivative.block<3, 1>(0, entry.column) =
+          axis_derivative.cross(tip_point - link_origin) + axis.cross(tip_velocity - origin_velocity);
+      jacobian_derivative.block<3, 1>(3, entry.column) = axis_derivative;
+      omega += axis * velocity;
+    }
+    else
+    {
+      jacobian_derivative.block<3, 1>(0, entry.column) = axis_derivative;
+      origin_velocity += axis * velocity;
+    }
+  }
+  return true;
+}
+}  // namespace core
+}  // namespace moveit
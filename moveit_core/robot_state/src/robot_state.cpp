@@ -50,6 +50,9 @@
 #include <moveit/macros/console_colors.hpp>
 #include <moveit/robot_model/aabb.hpp>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
+#include <moveit/utils/work_counters.hpp>
+#include "transform_kernels.hpp"
 
 namespace moveit
 {
@@ -61,6 +64,18 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.robot_state");
 }
+
+// Names of the root joints of the dirty subtrees in a RobotState, for debug output
+template <class DirtySubtrees>
+std::string dirtySubtreesString(const DirtySubtrees& subtrees)
+{
+  if (subtrees.empty())
+    return "NULL";
+  std::string result;
+  for (const JointModel* root : subtrees)
+    result += (result.empty() ? "" : ", ") + root->getName();
+  return result;
+}
 }  // namespace
 
 RobotState::RobotState(const RobotModelConstPtr& robot_model)
@@ -68,8 +83,6 @@ RobotState::RobotState(const RobotModelConstPtr& robot_model)
   , has_velocity_(false)
   , has_acceleration_(false)
   , has_effort_(false)
-  , dirty_link_transforms_(nullptr)
-  , dirty_collision_body_transforms_(nullptr)
   , rng_(nullptr)
 {
   if (robot_model == nullptr)
@@ -77,7 +90,7 @@ RobotState::RobotState(const RobotModelConstPtr& robot_model)
     throw std::invalid_argument("RobotState cannot be constructed with nullptr RobotModelConstPtr");
   }
 
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  dirty_link_transforms_.set(robot_model_->getRootJoint());
   init();
 }
 
@@ -133,6 +146,64 @@ void RobotState::copyFrom(const RobotState& other)
     attachBody(std::make_unique<AttachedBody>(*attached_body.second));
 }
 
+void RobotState::copyFrom(const RobotState& other, unsigned int mask)
+{
+  if (robot_model_ != other.robot_model_)
+  {
+    throw std::invalid_argument("RobotState::copyFrom() requires both states to use the same RobotModel");
+  }
+  if (this == &other)
+    return;
+
+  if ((mask & COPY_ALL) == COPY_ALL)
+  {
+    copyFrom(other);
+    return;
+  }
+
+  if (mask & COPY_POSITIONS)
+  {
+    // same robot model, so the assignments reuse the existing storage
+    position_ = other.position_;
+    if (mask & COPY_TRANSFORMS)
+    {
+      variable_joint_transforms_ = other.variable_joint_transforms_;
+      global_link_transforms_ = other.global_link_transforms_;
+      global_collision_body_transforms_ = other.global_collision_body_transforms_;
+      dirty_joint_transforms_ = other.dirty_joint_transforms_;
+      dirty_link_transforms_ = other.dirty_link_transforms_;
+      dirty_collision_body_transforms_ = other.dirty_collision_body_transforms_;
+    }
+    else
+    {
+      std::fill(dirty_joint_transforms_.begin(), dirty_joint_transforms_.end(), 1);
+      dirty_link_transforms_.set(robot_model_->getRootJoint());
+    }
+  }
+
+  if (mask & COPY_VELOCITIES)
+  {
+    has_velocity_ = other.has_velocity_;
+    if (has_velocity_)
+      velocity_ = other.velocity_;
+  }
+
+  if (mask & COPY_ACCELERATION_OR_EFFORT)
+  {
+    has_acceleration_ = other.has_acceleration_;
+    has_effort_ = other.has_effort_;
+    if (has_acceleration_ || has_effort_)
+      effort_or_acceleration_ = other.effort_or_acceleration_;
+  }
+
+  if (mask & COPY_ATTACHED_BODIES)
+  {
+    clearAttachedBodies();
+    for (const auto& attached_body : other.attached_body_map_)
+      attachBody(std::make_unique<AttachedBody>(*attached_body.second));
+  }
+}
+
 bool RobotState::checkJointTransforms(const JointModel* joint) const
 {
   if (dirtyJointTransform(joint))
@@ -264,7 +335,7 @@ void RobotState::setToRandomPositions()
   random_numbers::RandomNumberGenerator& rng = getRandomNumberGenerator();
   robot_model_->getVariableRandomPositions(rng, position_);
   std::fill(dirty_joint_transforms_.begin(), dirty_joint_transforms_.end(), 1);
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  dirty_link_transforms_.set(robot_model_->getRootJoint());
   // mimic values are correctly set in RobotModel
 }
 
@@ -343,7 +414,7 @@ void RobotState::setToDefaultValues()
   std::fill(velocity_.begin(), velocity_.end(), 0);
   std::fill(effort_or_acceleration_.begin(), effort_or_acceleration_.end(), 0);
   std::fill(dirty_joint_transforms_.begin(), dirty_joint_transforms_.end(), 1);
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  dirty_link_transforms_.set(robot_model_->getRootJoint());
 }
 
 void RobotState::setVariablePositions(const double* position)
@@ -355,7 +426,7 @@ void RobotState::setVariablePositions(const double* position)
 
   // Since all joint values have potentially changed, we will need to recompute all transforms
   std::fill(dirty_joint_transforms_.begin(), dirty_joint_transforms_.end(), 1);
-  dirty_link_transforms_ = robot_model_->getRootJoint();
+  dirty_link_transforms_.set(robot_model_->getRootJoint());
 }
 
 void RobotState::setVariablePositions(const std::map<std::string, double>& variable_map)
@@ -733,7 +804,7 @@ void RobotState::update(bool force)
   if (force)
   {
     std::fill(dirty_joint_transforms_.begin(), dirty_joint_transforms_.end(), 1);
-    dirty_link_transforms_ = robot_model_->getRootJoint();
+    dirty_link_transforms_.set(robot_model_->getRootJoint());
   }
 
   // this actually triggers all needed updates
@@ -742,15 +813,12 @@ void RobotState::update(bool force)
 
 void RobotState::updateCollisionBodyTransforms()
 {
-  if (dirty_link_transforms_ != nullptr)
+  if (!dirty_link_transforms_.empty())
     updateLinkTransforms();
 
-  if (dirty_collision_body_transforms_ != nullptr)
+  for (const JointModel* root : dirty_collision_body_transforms_)
   {
-    const std::vector<const LinkModel*>& links = dirty_collision_body_transforms_->getDescendantLinkModels();
-    dirty_collision_body_transforms_ = nullptr;
-
-    for (const LinkModel* link : links)
+    for (const LinkModel* link : root->getDescendantLinkModels())
     {
       const EigenSTL::vector_Isometry3d& ot = link->getCollisionOriginTransforms();
       const std::vector<int>& ot_id = link->areCollisionOriginTransformsIdentity();
@@ -764,34 +832,34 @@ void RobotState::updateCollisionBodyTransforms()
         }
         else
         {
-          global_collision_body_transforms_[index_co + j].affine().noalias() =
-              global_link_transforms_[index_l].affine() * ot[j].matrix();
+          detail::multiplyAffine(global_link_transforms_[index_l], ot[j],
+                                 global_collision_body_transforms_[index_co + j]);
         }
       }
     }
   }
+  dirty_collision_body_transforms_.clear();
 }
 
 void RobotState::updateLinkTransforms()
 {
-  if (dirty_link_transforms_ != nullptr)
+  if (!dirty_link_transforms_.empty())
   {
-    updateLinkTransformsInternal(dirty_link_transforms_);
-    if (dirty_collision_body_transforms_)
-    {
-      dirty_collision_body_transforms_ =
-          robot_model_->getCommonRoot(dirty_collision_body_transforms_, dirty_link_transforms_);
-    }
-    else
+    moveit::countWork(&moveit::WorkCounters::fk_calls);
+    // the dirty subtrees are disjoint, so they can be updated in any order
+    for (const JointModel* root : dirty_link_transforms_)
     {
-      dirty_collision_body_transforms_ = dirty_link_transforms_;
+      updateLinkTransformsInternal(root);
+      dirty_collision_body_transforms_.add(root, *robot_model_);
     }
-    dirty_link_transforms_ = nullptr;
+    dirty_link_transforms_.clear();
+    updateAttachedBodyTransforms();
   }
 }
 
 void RobotState::updateLinkTransformsInternal(const JointModel* start)
 {
+  MOVEIT_TRACEPOINT_COUNTER("robot_state.update_link_transforms", start->getDescendantLinkModels().size());
   for (const LinkModel* link : start->getDescendantLinkModels())
   {
     int idx_link = link->getLinkIndex();
@@ -801,21 +869,22 @@ void RobotState::updateLinkTransformsInternal(const JointModel* start)
       int idx_parent = parent->getLinkIndex();
       if (link->parentJointIsFixed())
       {  // fixed joint
-        global_link_transforms_[idx_link].affine().noalias() =
-            global_link_transforms_[idx_parent].affine() * link->getJointOriginTransform().matrix();
+        detail::multiplyAffine(global_link_transforms_[idx_parent], link->getJointOriginTransform(),
+                               global_link_transforms_[idx_link]);
       }
       else  // non-fixed joint
       {
         if (link->jointOriginTransformIsIdentity())
         {  // Link has identity transform
-          global_link_transforms_[idx_link].affine().noalias() =
-              global_link_transforms_[idx_parent].affine() * getJointTransform(link->getParentJointModel()).matrix();
+          detail::multiplyAffine(global_link_transforms_[idx_parent], getJointTransform(link->getParentJointModel()),
+                                 global_link_transforms_[idx_link]);
         }
         else
         {  // Link has non-identity transform
-          global_link_transforms_[idx_link].affine().noalias() =
-              global_link_transforms_[idx_parent].affine() * link->getJointOriginTransform().matrix() *
-              getJointTransform(link->getParentJointModel()).matrix();
+          Eigen::Isometry3d parent_to_joint;
+          detail::multiplyAffine(global_link_transforms_[idx_parent], link->getJointOriginTransform(), parent_to_joint);
+          detail::multiplyAffine(parent_to_joint, getJointTransform(link->getParentJointModel()),
+                                 global_link_transforms_[idx_link]);
         }
       }
     }
@@ -833,12 +902,15 @@ void RobotState::updateLinkTransformsInternal(const JointModel* start)
       }
       else
       {
-        global_link_transforms_[idx_link].affine().noalias() =
-            link->getJointOriginTransform().affine() * getJointTransform(root_joint).matrix();
+        detail::multiplyAffine(link->getJointOriginTransform(), getJointTransform(root_joint),
+                               global_link_transforms_[idx_link]);
       }
     }
   }
+}
 
+void RobotState::updateAttachedBodyTransforms()
+{
   // update attached bodies tf; these are usually very few, so we update them all
   for (const auto& attached_body : attached_body_map_)
   {
@@ -852,15 +924,7 @@ void RobotState::updateStateWithLinkAt(const LinkModel* link, const Eigen::Isome
   updateLinkTransforms();  // no link transforms must be dirty, otherwise the transform we set will be overwritten
 
   // update the fact that collision body transforms are out of date
-  if (dirty_collision_body_transforms_)
-  {
-    dirty_collision_body_transforms_ =
-        robot_model_->getCommonRoot(dirty_collision_body_transforms_, link->getParentJointModel());
-  }
-  else
-  {
-    dirty_collision_body_transforms_ = link->getParentJointModel();
-  }
+  dirty_collision_body_transforms_.add(link->getParentJointModel(), *robot_model_);
 
   global_link_transforms_[link->getLinkIndex()] = transform;
 
@@ -896,15 +960,10 @@ void RobotState::updateStateWithLinkAt(const LinkModel* link, const Eigen::Isome
       }
     }
     // all collision body transforms are invalid now
-    dirty_collision_body_transforms_ = parent_link->getParentJointModel();
+    dirty_collision_body_transforms_.set(parent_link->getParentJointModel());
   }
 
-  // update attached bodies tf; these are usually very few, so we update them all
-  for (const auto& attached_body : attached_body_map_)
-  {
-    attached_body.second->computeTransform(
-        global_link_transforms_[attached_body.second->getAttachedLink()->getLinkIndex()]);
-  }
+  updateAttachedBodyTransforms();
 }
 
 const LinkModel* RobotState::getRigidlyConnectedParentLinkModel(const std::string& frame) const
@@ -1114,7 +1173,7 @@ void RobotState::interpolate(const RobotState& to, double t, RobotState& state)
   robot_model_->interpolate(getVariablePositions(), to.getVariablePositions(), t, state.getVariablePositions());
 
   std::fill(state.dirty_joint_transforms_.begin(), state.dirty_joint_transforms_.end(), 1);
-  state.dirty_link_transforms_ = state.robot_model_->getRootJoint();
+  state.dirty_link_transforms_.set(state.robot_model_->getRootJoint());
 }
 
 void RobotState::interpolate(const RobotState& to, double t, RobotState& state, const JointModelGroup* joint_group) const
@@ -1783,6 +1842,7 @@ bool RobotState::setFromIK(const JointModelGroup* jmg, const EigenSTL::vector_Is
     RCLCPP_ERROR(getLogger(), "Number of poses must be the same as number of tips");
     return false;
   }
+  moveit::countWork(&moveit::WorkCounters::ik_calls);
 
   // Load solver
   const kinematics::KinematicsBaseConstPtr& solver = jmg->getSolverInstance();
@@ -2002,6 +2062,82 @@ bool RobotState::setFromIK(const JointModelGroup* jmg, const EigenSTL::vector_Is
   return false;
 }
 
+bool RobotState::setFromIKSequence(const JointModelGroup* jmg, const EigenSTL::vector_Isometry3d& poses_in,
+                                   const std::string& tip_in, std::vector<RobotStatePtr>& states, double timeout,
+                                   const kinematics::KinematicsQueryOptions& options)
+{
+  const kinematics::KinematicsBaseConstPtr& solver = jmg->getSolverInstance();
+  if (!solver)
+  {
+    RCLCPP_ERROR(getLogger(), "No kinematics solver instantiated for group '%s'", jmg->getName().c_str());
+    return false;
+  }
+  if (solver->getTipFrames().size() != 1)
+  {
+    RCLCPP_ERROR(getLogger(), "IK sequences require a kinematics solver with a single tip frame for group '%s'",
+                 jmg->getName().c_str());
+    return false;
+  }
+
+  // remove the frame '/' if there is one, as in setFromIK()
+  std::string pose_frame = tip_in;
+  if (!pose_frame.empty() && pose_frame[0] == '/')
+    pose_frame = pose_frame.substr(1);
+  std::string solver_tip_frame = solver->getTipFrame();
+  if (!solver_tip_frame.empty() && solver_tip_frame[0] == '/')
+    solver_tip_frame = solver_tip_frame.substr(1);
+
+  // the tip frame needs to be rigidly connected to the tip frame of the solver
+  Eigen::Isometry3d frame_to_solver_tip = Eigen::Isometry3d::Identity();
+  if (pose_frame != solver_tip_frame)
+  {
+    const LinkModel* pose_parent = getRigidlyConnectedParentLinkModel(pose_frame);
+    const LinkModel* tip_parent = getRigidlyConnectedParentLinkModel(solver_tip_frame);
+    if (!pose_parent || pose_parent != tip_parent)
+    {
+      RCLCPP_ERROR(getLogger(), "Cannot compute IK for pose reference frame '%s', available tip frame: '%s'",
+                   pose_frame.c_str(), solver_tip_frame.c_str());
+      return false;
+    }
+    frame_to_solver_tip = getFrameTransform(pose_frame).inverse() * getFrameTransform(solver_tip_frame);
+  }
+
+  std::vector<geometry_msgs::msg::Pose> ik_queries;
+  ik_queries.reserve(poses_in.size());
+  for (const Eigen::Isometry3d& pose_in : poses_in)
+  {
+    Eigen::Isometry3d pose = pose_in * frame_to_solver_tip;
+    if (!setToIKSolverFrame(pose, solver))
+      return false;
+    ik_queries.push_back(tf2::toMsg(pose));
+  }
+
+  // if no timeout has been specified, use the default one
+  if (timeout < std::numeric_limits<double>::epsilon())
+    timeout = jmg->getDefaultIKTimeout();
+
+  const std::vector<size_t>& bij = jmg->getKinematicsSolverJointBijection();
+  std::vector<double> initial_values;
+  copyJointGroupPositions(jmg, initial_values);
+  std::vector<double> seed(bij.size());
+  for (std::size_t i = 0; i < bij.size(); ++i)
+    seed[i] = initial_values[bij[i]];
+
+  std::vector<std::vector<double> > ik_solutions;
+  moveit_msgs::msg::MoveItErrorCodes error;
+  const bool solved = solver->searchPositionIKSequence(ik_queries, seed, timeout, ik_solutions, error, options);
+
+  std::vector<double> solution(bij.size());
+  for (const std::vector<double>& ik_solution : ik_solutions)
+  {
+    for (std::size_t i = 0; i < bij.size(); ++i)
+      solution[bij[i]] = ik_solution[i];
+    setJointGroupPositions(jmg, solution);
+    states.push_back(std::make_shared<RobotState>(*this));
+  }
+  return solved && ik_solutions.size() == poses_in.size();
+}
+
 bool RobotState::setFromIKSubgroups(const JointModelGroup* jmg, const EigenSTL::vector_Isometry3d& poses_in,
                                     const std::vector<std::string>& tips_in,
                                     const std::vector<std::vector<double> >& consistency_limits, double timeout,
@@ -2313,9 +2449,8 @@ void RobotState::printDirtyInfo(std::ostream& out) const
     if (joint->getVariableCount() > 0 && dirtyJointTransform(joint))
       out << "    " << joint->getName() << '\n';
   }
-  out << "  * Dirty Link Transforms: " << (dirty_link_transforms_ ? dirty_link_transforms_->getName() : "NULL") << '\n';
-  out << "  * Dirty Collision Body Transforms: "
-      << (dirty_collision_body_transforms_ ? dirty_collision_body_transforms_->getName() : "NULL\n");
+  out << "  * Dirty Link Transforms: " << dirtySubtreesString(dirty_link_transforms_) << '\n';
+  out << "  * Dirty Collision Body Transforms: " << dirtySubtreesString(dirty_collision_body_transforms_) << '\n';
 }
 
 void RobotState::printStateInfo(std::ostream& out) const
@@ -2353,9 +2488,8 @@ void RobotState::printStateInfo(std::ostream& out) const
   else
     out << "  * Acceleration: NULL\n";
 
-  out << "  * Dirty Link Transforms: " << (dirty_link_transforms_ ? dirty_link_transforms_->getName() : "NULL\n");
-  out << "  * Dirty Collision Body Transforms: "
-      << (dirty_collision_body_transforms_ ? dirty_collision_body_transforms_->getName() : "NULL\n");
+  out << "  * Dirty Link Transforms: " << dirtySubtreesString(dirty_link_transforms_) << '\n';
+  out << "  * Dirty Collision Body Transforms: " << dirtySubtreesString(dirty_collision_body_transforms_) << '\n';
 
   printTransforms(out);
 }
@@ -0,0 +1,125 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_state/robot_state_pool.hpp>
+#include <stdexcept>
+
+namespace moveit
+{
+namespace core
+{
+void RobotStatePool::Releaser::operator()(RobotState* state) const
+{
+  std::unique_ptr<RobotState> owned(state);
+  if (!owned)
+    return;
+
+  std::shared_ptr<Storage> pool = storage.lock();
+  if (!pool)
+    return;
+
+  // do not hand out stale data (or keep attached body callbacks alive) through recycled states
+  owned->clearAttachedBodies();
+  owned->setAttachedBodyUpdateCallback(AttachedBodyCallback());
+  owned->dropDynamics();
+
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  pool->free_states.push_back(std::move(owned));
+}
+
+RobotStatePool::RobotStatePool(const RobotModelConstPtr& robot_model, std::size_t initial_size)
+  : robot_model_(robot_model), storage_(std::make_shared<Storage>())
+{
+  if (!robot_model_)
+  {
+    throw std::invalid_argument("RobotStatePool cannot be constructed with nullptr RobotModelConstPtr");
+  }
+  reserve(initial_size);
+}
+
+std::unique_ptr<RobotState> RobotStatePool::createState() const
+{
+  auto state = std::make_unique<RobotState>(robot_model_);
+  state->setToDefaultValues();
+  return state;
+}
+
+RobotStatePool::StatePtr RobotStatePool::acquire()
+{
+  std::unique_ptr<RobotState> state;
+  {
+    std::lock_guard<std::mutex> lock(storage_->mutex);
+    if (!storage_->free_states.empty())
+    {
+      state = std::move(storage_->free_states.back());
+      storage_->free_states.pop_back();
+    }
+  }
+  if (!state)
+    state = createState();
+  return StatePtr(state.release(), Releaser{ storage_ });
+}
+
+RobotStatePool::StatePtr RobotStatePool::acquire(const RobotState& source, unsigned int mask)
+{
+  StatePtr state = acquire();
+  state->copyFrom(source, mask);
+  return state;
+}
+
+void RobotStatePool::reserve(std::size_t count)
+{
+  std::size_t available = getAvailableCount();
+  if (available >= count)
+    return;
+
+  // allocate outside of the lock, the states are independent of each other
+  std::vector<std::unique_ptr<RobotState>> states;
+  states.reserve(count - available);
+  for (; available < count; ++available)
+    states.push_back(createState());
+
+  std::lock_guard<std::mutex> lock(storage_->mutex);
+  storage_->free_states.reserve(storage_->free_states.size() + states.size());
+  for (auto& state : states)
+    storage_->free_states.push_back(std::move(state));
+}
+
+std::size_t RobotStatePool::getAvailableCount() const
+{
+  std::lock_guard<std::mutex> lock(storage_->mutex);
+  return storage_->free_states.size();
+}
+}  // namespace core
+}  // namespace moveit
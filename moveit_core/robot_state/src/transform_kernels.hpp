@@ -0,0 +1,101 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <Eigen/Geometry>
+
+#if defined(MOVEIT_ROBOT_STATE_USE_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace moveit
+{
+namespace core
+{
+namespace detail
+{
+#if defined(MOVEIT_ROBOT_STATE_USE_AVX2)
+/** \brief out = a * b for column-major 4x4 affine matrices. Implemented in transform_kernels_avx2.cpp, which is the
+    only translation unit compiled with AVX2 enabled (so that Eigen's alignment assumptions stay the same across the
+    library). */
+void multiplyAffineAVX2(const double* a, const double* b, double* out);
+#endif
+
+/** \brief Compute out = a * b for two affine transforms.
+
+    All transforms in RobotState are valid isometries, i.e. their last row is (0, 0, 0, 1). Only the 3x4 affine part
+    needs to be computed, which saves a quarter of the work of a general 4x4 product.
+    \e out must not alias \e a or \e b.
+
+    The implementation is selected at build time through the CMake option MOVEIT_ROBOT_STATE_SIMD:
+    AVX2 maps every column of the matrices onto one 256 bit register, NEON (AArch64 only) onto two 128 bit registers.
+    Otherwise, the product is left to Eigen. */
+inline void multiplyAffine(const Eigen::Isometry3d& a, const Eigen::Isometry3d& b, Eigen::Isometry3d& out)
+{
+#if defined(MOVEIT_ROBOT_STATE_USE_AVX2)
+  multiplyAffineAVX2(a.data(), b.data(), out.data());
+#elif defined(MOVEIT_ROBOT_STATE_USE_NEON)
+  const double* pa = a.data();
+  const double* pb = b.data();
+  double* po = out.data();
+  // column j of the result: sum_k a.col(k) * b(k, j); only the upper three rows are computed
+  for (int j = 0; j < 4; ++j)
+  {
+    const double* bj = pb + 4 * j;
+    float64x2_t xy = vmulq_n_f64(vld1q_f64(pa), bj[0]);
+    double z = pa[2] * bj[0];
+    xy = vfmaq_n_f64(xy, vld1q_f64(pa + 4), bj[1]);
+    z += pa[6] * bj[1];
+    xy = vfmaq_n_f64(xy, vld1q_f64(pa + 8), bj[2]);
+    z += pa[10] * bj[2];
+    if (j == 3)
+    {
+      xy = vaddq_f64(xy, vld1q_f64(pa + 12));
+      z += pa[14];
+    }
+    vst1q_f64(po + 4 * j, xy);
+    po[4 * j + 2] = z;
+  }
+  out.makeAffine();
+#else
+  out.linear().noalias() = a.linear() * b.linear();
+  out.translation().noalias() = a.linear() * b.translation();
+  out.translation() += a.translation();
+  out.makeAffine();
+#endif
+}
+}  // namespace detail
+}  // namespace core
+}  // namespace moveit
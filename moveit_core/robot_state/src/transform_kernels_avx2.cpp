@@ -0,0 +1,70 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// This translation unit is compiled with AVX2 and FMA enabled. It must not include Eigen (or any other header
+// with inline code depending on the instruction set), to keep the rest of the library unaffected.
+
+#include <immintrin.h>
+
+namespace moveit
+{
+namespace core
+{
+namespace detail
+{
+void multiplyAffineAVX2(const double* a, const double* b, double* out)
+{
+  // Each column of a column-major 4x4 double matrix fills exactly one 256 bit register.
+  // Since the last row of both inputs is (0, 0, 0, 1), the last row of the result is computed correctly as well.
+  const __m256d a0 = _mm256_loadu_pd(a);
+  const __m256d a1 = _mm256_loadu_pd(a + 4);
+  const __m256d a2 = _mm256_loadu_pd(a + 8);
+  const __m256d a3 = _mm256_loadu_pd(a + 12);
+  for (int j = 0; j < 3; ++j)
+  {
+    const double* bj = b + 4 * j;
+    __m256d r = _mm256_mul_pd(a0, _mm256_broadcast_sd(bj));
+    r = _mm256_fmadd_pd(a1, _mm256_broadcast_sd(bj + 1), r);
+    r = _mm256_fmadd_pd(a2, _mm256_broadcast_sd(bj + 2), r);
+    _mm256_storeu_pd(out + 4 * j, r);
+  }
+  const double* b3 = b + 12;
+  __m256d r = _mm256_fmadd_pd(a0, _mm256_broadcast_sd(b3), a3);
+  r = _mm256_fmadd_pd(a1, _mm256_broadcast_sd(b3 + 1), r);
+  r = _mm256_fmadd_pd(a2, _mm256_broadcast_sd(b3 + 2), r);
+  _mm256_storeu_pd(out + 12, r);
+}
+}  // namespace detail
+}  // namespace core
+}  // namespace moveit
@@ -43,6 +43,10 @@
 #include <kdl/treejnttojacsolver.hpp>
 #include <moveit/robot_model/robot_model.hpp>
 #include <moveit/robot_state/robot_state.hpp>
+#include <moveit/robot_state/batch_forward_kinematics.hpp>
+#include <moveit/robot_state/chain_kinematics.hpp>
+#include <moveit/robot_state/jacobian_evaluator.hpp>
+#include <moveit/robot_state/robot_state_pool.hpp>
 #include <moveit/utils/robot_model_test_utils.hpp>
 
 // Robot and planning group for benchmarks.
@@ -233,6 +237,27 @@ BENCHMARK_DEFINE_F(RobotStateBenchmark, copyConstruct)(benchmark::State& st)
   }
 }
 
+// Benchmark time to obtain copies of a RobotState's positions from a warm RobotStatePool.
+BENCHMARK_DEFINE_F(RobotStateBenchmark, poolAcquire)(benchmark::State& st)
+{
+  moveit::core::RobotState state(robot_model);
+  state.setToDefaultValues();
+  state.update();
+
+  const auto num = static_cast<std::size_t>(st.range(0));
+  moveit::core::RobotStatePool pool(robot_model, num);
+  std::vector<moveit::core::RobotStatePool::StatePtr> states;
+  states.reserve(num);
+  for (auto _ : st)
+  {
+    for (std::size_t i = 0; i < num; ++i)
+      states.push_back(pool.acquire(state));
+    benchmark::DoNotOptimize(states);
+    benchmark::ClobberMemory();
+    states.clear();
+  }
+}
+
 // Benchmark time to call `setToRandomPositions` and `update` on RobotState.
 BENCHMARK_DEFINE_F(RobotStateBenchmark, update)(benchmark::State& st)
 {
@@ -248,6 +273,95 @@ BENCHMARK_DEFINE_F(RobotStateBenchmark, update)(benchmark::State& st)
   }
 }
 
+// Benchmark time to compute the link transforms of a group for many configurations, one RobotState at a time.
+BENCHMARK_DEFINE_F(RobotStateBenchmark, groupForwardKinematics)(benchmark::State& st)
+{
+  moveit::core::RobotState state(robot_model);
+  state.setToDefaultValues();
+  state.update();
+  const moveit::core::JointModelGroup* jmg = state.getJointModelGroup(PANDA_TEST_GROUP);
+  if (!jmg)
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+
+  random_numbers::RandomNumberGenerator rng(0);
+  Eigen::MatrixXd positions(jmg->getVariableCount(), st.range(0));
+  for (Eigen::Index i = 0; i < positions.cols(); ++i)
+    jmg->getVariableRandomPositions(rng, positions.col(i).data());
+
+  for (auto _ : st)
+  {
+    for (Eigen::Index i = 0; i < positions.cols(); ++i)
+    {
+      state.setJointGroupPositions(jmg, positions.col(i).data());
+      state.updateLinkTransforms();
+      benchmark::DoNotOptimize(state.getGlobalLinkTransform(jmg->getLinkModels().back()));
+    }
+  }
+}
+
+// Benchmark time to compute the link transforms of a serial chain for many configurations with ChainKinematics.
+BENCHMARK_DEFINE_F(RobotStateBenchmark, chainForwardKinematics)(benchmark::State& st)
+{
+  const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(PANDA_TEST_GROUP);
+  if (!jmg)
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  const std::unique_ptr<moveit::core::ChainKinematics> chain = moveit::core::ChainKinematics::create(jmg);
+  if (!chain)
+  {
+    st.SkipWithError("The planning group is not a supported serial chain.");
+    return;
+  }
+
+  random_numbers::RandomNumberGenerator rng(0);
+  Eigen::MatrixXd positions(jmg->getVariableCount(), st.range(0));
+  for (Eigen::Index i = 0; i < positions.cols(); ++i)
+    jmg->getVariableRandomPositions(rng, positions.col(i).data());
+
+  EigenSTL::vector_Isometry3d transforms(chain->getLinkModels().size());
+  for (auto _ : st)
+  {
+    for (Eigen::Index i = 0; i < positions.cols(); ++i)
+    {
+      chain->computeLinkTransforms(positions.col(i).data(), Eigen::Isometry3d::Identity(), transforms.data());
+      benchmark::DoNotOptimize(transforms.back());
+    }
+  }
+}
+
+// Benchmark time to compute the link transforms of a group for many configurations with BatchForwardKinematics.
+BENCHMARK_DEFINE_F(RobotStateBenchmark, batchForwardKinematics)(benchmark::State& st)
+{
+  moveit::core::RobotState state(robot_model);
+  state.setToDefaultValues();
+  state.update();
+  const moveit::core::JointModelGroup* jmg = state.getJointModelGroup(PANDA_TEST_GROUP);
+  if (!jmg)
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+
+  random_numbers::RandomNumberGenerator rng(0);
+  Eigen::MatrixXd positions(jmg->getVariableCount(), st.range(0));
+  for (Eigen::Index i = 0; i < positions.cols(); ++i)
+    jmg->getVariableRandomPositions(rng, positions.col(i).data());
+
+  const moveit::core::BatchForwardKinematics fk(jmg);
+  moveit::core::LinkTransformBatch transforms;
+  for (auto _ : st)
+  {
+    fk.compute(state, positions, transforms);
+    benchmark::DoNotOptimize(transforms.getCoefficients(0, 0));
+    benchmark::ClobberMemory();
+  }
+}
+
 // Benchmark time to compute the Jacobian, using MoveIt's `getJacobian` function.
 BENCHMARK_DEFINE_F(RobotStateBenchmark, jacobianMoveIt)(benchmark::State& st)
 {
@@ -273,6 +387,34 @@ BENCHMARK_DEFINE_F(RobotStateBenchmark, jacobianMoveIt)(benchmark::State& st)
   }
 }
 
+// Benchmark time to compute the Jacobian using a precomputed JacobianEvaluator.
+BENCHMARK_DEFINE_F(RobotStateBenchmark, jacobianEvaluator)(benchmark::State& st)
+{
+  moveit::core::RobotState state(robot_model);
+  const moveit::core::JointModelGroup* jmg = state.getJointModelGroup(PANDA_TEST_GROUP);
+  if (!jmg)
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  const moveit::core::JacobianEvaluator evaluator(jmg);
+  Eigen::MatrixXd jacobian;
+
+  // Manually seeded RandomNumberGenerator for deterministic results
+  random_numbers::RandomNumberGenerator rng(0);
+
+  for (auto _ : st)
+  {
+    // Time only the jacobian computation, not the forward kinematics.
+    st.PauseTiming();
+    state.setToRandomPositions(jmg, rng);
+    state.updateLinkTransforms();
+    st.ResumeTiming();
+    evaluator.compute(state, jacobian);
+    benchmark::DoNotOptimize(jacobian.data());
+  }
+}
+
 // Benchmark time to compute the Jacobian using KDL.
 BENCHMARK_DEFINE_F(RobotStateBenchmark, jacobianKDL)(benchmark::State& st)
 {
@@ -328,7 +470,25 @@ BENCHMARK_REGISTER_F(RobotStateBenchmark, copyConstruct)
     ->RangeMultiplier(10)
     ->Range(100, 10000)
     ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(RobotStateBenchmark, poolAcquire)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000)
+    ->Unit(benchmark::kMillisecond);
 BENCHMARK_REGISTER_F(RobotStateBenchmark, update)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
 
+BENCHMARK_REGISTER_F(RobotStateBenchmark, groupForwardKinematics)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(RobotStateBenchmark, chainForwardKinematics)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(RobotStateBenchmark, batchForwardKinematics)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_REGISTER_F(RobotStateBenchmark, jacobianMoveIt);
+BENCHMARK_REGISTER_F(RobotStateBenchmark, jacobianEvaluator);
 BENCHMARK_REGISTER_F(RobotStateBenchmark, jacobianKDL);
@@ -35,6 +35,10 @@
 /* Author: Ioan Sucan */
 #include <moveit/robot_model/robot_model.hpp>
 #include <moveit/robot_state/robot_state.hpp>
+#include <moveit/robot_state/batch_forward_kinematics.hpp>
+#include <moveit/robot_state/chain_kinematics.hpp>
+#include <moveit/robot_state/jacobian_evaluator.hpp>
+#include <moveit/robot_state/robot_state_pool.hpp>
 #include <moveit/utils/robot_model_test_utils.hpp>
 #include <urdf_parser/urdf_parser.h>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
@@ -82,6 +86,14 @@ void checkJacobian(moveit::core::RobotState& state, const moveit::core::JointMod
   Eigen::MatrixXd jacobian;
   state.getJacobian(&joint_model_group, reference_link, Eigen::Vector3d::Zero(), jacobian);
 
+  // The precomputed evaluator has to agree with RobotState::getJacobian().
+  const moveit::core::JacobianEvaluator evaluator(&joint_model_group, reference_link);
+  Eigen::MatrixXd evaluated_jacobian;
+  ASSERT_TRUE(evaluator.compute(state, evaluated_jacobian));
+  EXPECT_TRUE((evaluated_jacobian - jacobian).isZero(1e-12)) << "JacobianEvaluator differs from getJacobian():\n"
+                                                             << evaluated_jacobian << '\n'
+                                                             << jacobian;
+
   // Verify that only elements of the Jacobian contain values that correspond to joints that are being used based on the reference link.
   const std::vector<const moveit::core::JointModel*>& joint_models = joint_model_group.getJointModels();
   auto it = std::find_if(joint_models.begin(), joint_models.end(), [&](const moveit::core::JointModel* jm) {
@@ -804,6 +816,192 @@ TEST_F(OneRobot, rigidlyConnectedParent)
   EXPECT_EQ(nullptr, state.getRigidlyConnectedParentLinkModel("/"));
 }
 
+// Compare the batched forward kinematics against RobotState::updateLinkTransforms() for random group states
+void checkBatchForwardKinematics(const moveit::core::RobotModelConstPtr& model, const std::string& group_name)
+{
+  const moveit::core::JointModelGroup* jmg = model->getJointModelGroup(group_name);
+  ASSERT_TRUE(jmg);
+
+  moveit::core::RobotState reference(model);
+  reference.setToDefaultValues();
+  reference.update();
+
+  constexpr int N_STATES = 17;
+  random_numbers::RandomNumberGenerator rng(0);
+  Eigen::MatrixXd positions(jmg->getVariableCount(), N_STATES);
+  for (int s = 0; s < N_STATES; ++s)
+    jmg->getVariableRandomPositions(rng, positions.col(s).data());
+
+  const moveit::core::BatchForwardKinematics fk(jmg);
+  moveit::core::LinkTransformBatch transforms;
+  fk.compute(reference, positions, transforms);
+  ASSERT_EQ(transforms.getStateCount(), static_cast<std::size_t>(N_STATES));
+  ASSERT_EQ(transforms.getLinkCount(), fk.getLinkModels().size());
+
+  moveit::core::RobotState state(reference);
+  for (int s = 0; s < N_STATES; ++s)
+  {
+    state.setJointGroupPositions(jmg, positions.col(s).data());
+    state.updateLinkTransforms();
+    for (const moveit::core::LinkModel* link : fk.getLinkModels())
+    {
+      const int index = fk.getBatchLinkIndex(link);
+      ASSERT_GE(index, 0);
+      EXPECT_TRUE(transforms.getTransform(index, s).isApprox(state.getGlobalLinkTransform(link), 1e-9))
+          << "Mismatch for link " << link->getName() << " in state " << s;
+    }
+  }
+}
+
+TEST_F(OneRobot, batchForwardKinematics)
+{
+  checkBatchForwardKinematics(robot_model_, "base_from_joints");
+  checkBatchForwardKinematics(robot_model_, "mim_joints");
+  checkBatchForwardKinematics(robot_model_, "base_from_base_to_e");
+}
+
+TEST(BatchForwardKinematics, Panda)
+{
+  const moveit::core::RobotModelConstPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(model);
+  checkBatchForwardKinematics(model, "panda_arm");
+
+  // links that are not updated by the group are not part of the batch
+  const moveit::core::BatchForwardKinematics fk(model->getJointModelGroup("panda_arm"));
+  EXPECT_EQ(fk.getBatchLinkIndex(model->getLinkModel("panda_link0")), -1);
+  EXPECT_GE(fk.getBatchLinkIndex(model->getLinkModel("panda_link8")), 0);
+}
+
+TEST(RobotState, IncrementalFKOfSeparateBranches)
+{
+  const moveit::core::RobotModelConstPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(model);
+
+  moveit::core::RobotState state(model);
+  state.setToDefaultValues();
+  state.update();
+
+  random_numbers::RandomNumberGenerator rng(42);
+  const std::vector<const moveit::core::JointModel*>& joints = model->getActiveJointModels();
+  for (int iteration = 0; iteration < 50; ++iteration)
+  {
+    // change joints in (likely) different branches of the tree before updating, covering merging of subtrees
+    const int changed_joints = 1 + iteration % 7;
+    for (int i = 0; i < changed_joints; ++i)
+    {
+      const moveit::core::JointModel* joint = joints[rng.uniformInteger(0, static_cast<int>(joints.size()) - 1)];
+      std::vector<double> values(joint->getVariableCount());
+      joint->getVariableRandomPositions(rng, values.data());
+      state.setJointPositions(joint, values.data());
+    }
+    EXPECT_TRUE(state.dirtyLinkTransforms());
+    state.update();
+    EXPECT_FALSE(state.dirty());
+
+    moveit::core::RobotState expected(model);
+    expected.setVariablePositions(state.getVariablePositions());
+    expected.update(true);
+    for (const moveit::core::LinkModel* link : model->getLinkModels())
+    {
+      EXPECT_TRUE(state.getGlobalLinkTransform(link).isApprox(expected.getGlobalLinkTransform(link), 1e-12))
+          << "Mismatch for link " << link->getName() << " in iteration " << iteration;
+      for (std::size_t j = 0; j < link->getShapes().size(); ++j)
+      {
+        EXPECT_TRUE(
+            state.getCollisionBodyTransform(link, j).isApprox(expected.getCollisionBodyTransform(link, j), 1e-12));
+      }
+    }
+  }
+}
+
+TEST(RobotState, CopyFromMask)
+{
+  const moveit::core::RobotModelConstPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(model);
+
+  moveit::core::RobotState source(model);
+  source.setToRandomPositions();
+  source.zeroVelocities();
+  source.update();
+  source.attachBody(std::make_unique<moveit::core::AttachedBody>(
+      model->getLinkModel("panda_hand"), "object", Eigen::Isometry3d::Identity(), std::vector<shapes::ShapeConstPtr>{},
+      EigenSTL::vector_Isometry3d{}, std::set<std::string>{}, trajectory_msgs::msg::JointTrajectory{},
+      moveit::core::FixedTransformsMap{}));
+
+  moveit::core::RobotState target(model);
+  target.setToDefaultValues();
+  target.update();
+  target.copyFrom(source, moveit::core::RobotState::COPY_POSITIONS);
+  EXPECT_TRUE(target.dirtyLinkTransforms());
+  EXPECT_FALSE(target.hasVelocities());
+  EXPECT_FALSE(target.hasAttachedBody("object"));
+  for (std::size_t i = 0; i < model->getVariableCount(); ++i)
+    EXPECT_EQ(target.getVariablePosition(i), source.getVariablePosition(i));
+  target.update();
+  for (const moveit::core::LinkModel* link : model->getLinkModels())
+    EXPECT_TRUE(target.getGlobalLinkTransform(link).isApprox(source.getGlobalLinkTransform(link), 1e-12));
+
+  moveit::core::RobotState copy(model);
+  copy.setToDefaultValues();
+  copy.copyFrom(source, moveit::core::RobotState::COPY_POSITIONS | moveit::core::RobotState::COPY_TRANSFORMS |
+                            moveit::core::RobotState::COPY_VELOCITIES);
+  EXPECT_FALSE(copy.dirtyLinkTransforms());
+  EXPECT_TRUE(copy.hasVelocities());
+  EXPECT_FALSE(copy.hasAttachedBody("object"));
+
+  copy.copyFrom(source, moveit::core::RobotState::COPY_ATTACHED_BODIES);
+  EXPECT_TRUE(copy.hasAttachedBody("object"));
+
+  moveit::core::RobotState other(moveit::core::loadTestingRobotModel("pr2"));
+  EXPECT_THROW(other.copyFrom(source, moveit::core::RobotState::COPY_POSITIONS), std::invalid_argument);
+}
+
+TEST(RobotStatePool, RecyclesStates)
+{
+  const moveit::core::RobotModelConstPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(model);
+
+  moveit::core::RobotStatePool pool(model, 2);
+  EXPECT_EQ(pool.getAvailableCount(), 2u);
+
+  moveit::core::RobotState source(model);
+  source.setToRandomPositions();
+  source.zeroVelocities();
+
+  const moveit::core::RobotState* recycled = nullptr;
+  {
+    moveit::core::RobotStatePool::StatePtr state = pool.acquire(source);
+    EXPECT_EQ(pool.getAvailableCount(), 1u);
+    EXPECT_FALSE(state->hasVelocities());
+    for (std::size_t i = 0; i < model->getVariableCount(); ++i)
+      EXPECT_EQ(state->getVariablePosition(i), source.getVariablePosition(i));
+
+    state->zeroVelocities();
+    state->attachBody(std::make_unique<moveit::core::AttachedBody>(
+        model->getLinkModel("panda_hand"), "object", Eigen::Isometry3d::Identity(),
+        std::vector<shapes::ShapeConstPtr>{}, EigenSTL::vector_Isometry3d{}, std::set<std::string>{},
+        trajectory_msgs::msg::JointTrajectory{}, moveit::core::FixedTransformsMap{}));
+    recycled = state.get();
+  }
+  EXPECT_EQ(pool.getAvailableCount(), 2u);
+
+  // the most recently released state is handed out first, without its attached bodies and velocities
+  moveit::core::RobotStatePool::StatePtr state = pool.acquire();
+  EXPECT_EQ(state.get(), recycled);
+  EXPECT_FALSE(state->hasVelocities());
+  EXPECT_FALSE(state->hasAttachedBody("object"));
+
+  // handles may outlive their pool
+  moveit::core::RobotStatePool::StatePtr orphan;
+  {
+    moveit::core::RobotStatePool short_lived(model);
+    orphan = short_lived.acquire(source);
+    EXPECT_EQ(short_lived.getAvailableCount(), 0u);
+  }
+  EXPECT_EQ(orphan->getVariablePosition(0), source.getVariablePosition(0));
+  orphan.reset();
+}
+
 TEST(getJacobian, RevoluteJoints)
 {
   // Robot URDF with four revolute joints.
@@ -1204,6 +1402,96 @@ TEST(getJacobian, GroupNotAtOrigin)
   checkJacobian(state, *jmg, makeVector({ 0.1, 0.4, 0.3 }), makeVector({ 0.5, 0.1, 0.2 }));
 }
 
+TEST(JacobianEvaluator, Derivative)
+{
+  const moveit::core::RobotModelConstPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(model);
+  const moveit::core::JointModelGroup* group = model->getJointModelGroup("panda_arm");
+  ASSERT_TRUE(group);
+  const moveit::core::JacobianEvaluator evaluator(group);
+  const Eigen::Vector3d reference_point(0.05, -0.02, 0.1);
+
+  moveit::core::RobotState state(model);
+  state.setToDefaultValues();
+  random_numbers::RandomNumberGenerator rng(7);
+  for (int iteration = 0; iteration < 10; ++iteration)
+  {
+    state.setToRandomPositions(group, rng);
+    Eigen::VectorXd positions;
+    state.copyJointGroupPositions(group, positions);
+    Eigen::VectorXd velocities(positions.size());
+    for (Eigen::Index i = 0; i < velocities.size(); ++i)
+      velocities[i] = rng.uniformReal(-1.0, 1.0);
+    state.setJointGroupVelocities(group, velocities);
+    state.update();
+
+    Eigen::MatrixXd jacobian, jacobian_derivative;
+    ASSERT_TRUE(evaluator.computeDerivative(state, jacobian, jacobian_derivative, reference_point));
+
+    // central differences along the joint velocities
+    constexpr double time_step = 1e-6;
+    Eigen::MatrixXd jacobian_forward, jacobian_backward;
+    state.setJointGroupPositions(group, positions + time_step * velocities);
+    state.update();
+    ASSERT_TRUE(evaluator.compute(state, jacobian_forward, reference_point));
+    state.setJointGroupPositions(group, positions - time_step * velocities);
+    state.update();
+    ASSERT_TRUE(evaluator.compute(state, jacobian_backward, reference_point));
+    const Eigen::MatrixXd expected = (jacobian_forward - jacobian_backward) / (2.0 * time_step);
+    EXPECT_TRUE((jacobian_derivative - expected).isZero(1e-6)) << jacobian_derivative << '\n' << expected;
+  }
+
+  // the derivative needs velocities
+  state.dropVelocities();
+  Eigen::MatrixXd jacobian, jacobian_derivative;
+  EXPECT_FALSE(evaluator.computeDerivative(state, jacobian, jacobian_derivative));
+
+  EXPECT_THROW(moveit::core::JacobianEvaluator(nullptr), moveit::Exception);
+}
+
+TEST(ChainKinematics, Panda)
+{
+  const moveit::core::RobotModelConstPtr model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(model);
+  const moveit::core::JointModelGroup* group = model->getJointModelGroup("panda_arm");
+  ASSERT_TRUE(group);
+  const std::unique_ptr<moveit::core::ChainKinematics> chain = moveit::core::ChainKinematics::create(group);
+  ASSERT_TRUE(chain);
+  const moveit::core::JacobianEvaluator evaluator(group);
+
+  moveit::core::RobotState state(model);
+  state.setToDefaultValues();
+  random_numbers::RandomNumberGenerator rng(3);
+  EigenSTL::vector_Isometry3d transforms(chain->getLinkModels().size());
+  for (int iteration = 0; iteration < 10; ++iteration)
+  {
+    state.setToRandomPositions(group, rng);
+    state.update();
+    std::vector<double> positions;
+    state.copyJointGroupPositions(group, positions);
+
+    const Eigen::Isometry3d base = chain->getBaseLink() ? state.getGlobalLinkTransform(chain->getBaseLink()) :
+                                                          Eigen::Isometry3d::Identity();
+    chain->computeLinkTransforms(positions.data(), base, transforms.data());
+    for (std::size_t i = 0; i < transforms.size(); ++i)
+    {
+      const moveit::core::LinkModel* link = chain->getLinkModels()[i];
+      EXPECT_TRUE(transforms[i].isApprox(state.getGlobalLinkTransform(link), 1e-12)) << link->getName();
+    }
+
+    // relative to the base link, the Jacobian matches the one of RobotState
+    Eigen::MatrixXd jacobian, expected_jacobian;
+    chain->computeLinkTransforms(positions.data(), Eigen::Isometry3d::Identity(), transforms.data());
+    chain->computeJacobian(transforms.data(), jacobian);
+    ASSERT_TRUE(evaluator.compute(state, expected_jacobian));
+    EXPECT_TRUE((jacobian - expected_jacobian).isZero(1e-12)) << jacobian << '\n' << expected_jacobian;
+  }
+
+  // the hand contains a mimic joint and cannot be specialized
+  EXPECT_FALSE(moveit::core::ChainKinematics::create(model->getJointModelGroup("hand")));
+  EXPECT_FALSE(moveit::core::ChainKinematics::create(nullptr));
+}
+
 TEST(getJointPositions, getFixedJointValue)
 {
   // Robot URDF with two revolute joints and a final fixed joint.
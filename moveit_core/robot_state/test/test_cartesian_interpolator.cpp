@@ -42,6 +42,8 @@
 
 #include <rclcpp/node.hpp>
 
+#include <atomic>
+
 using namespace moveit::core;
 
 class SimpleRobot : public testing::Test
@@ -198,6 +200,211 @@ TEST_F(SimpleRobot, checkRelativeJointSpaceJump)
   EXPECT_ANY_THROW(CartesianInterpolator::checkJointSpaceJump(joint_model_group, traj, JumpThreshold::relative(0.0)));
 }
 
+// IK solver of a robot with three orthogonal prismatic joints, counting its calls
+class XYZKinematics : public kinematics::KinematicsBase
+{
+public:
+  explicit XYZKinematics(bool supports_sequence) : supports_sequence_(supports_sequence)
+  {
+    setValues("", "xyz", "base", { "z" }, DEFAULT_SEARCH_DISCRETIZATION);
+  }
+
+  bool getPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& /*ik_seed_state*/,
+                     std::vector<double>& solution, moveit_msgs::msg::MoveItErrorCodes& error_code,
+                     const kinematics::KinematicsQueryOptions& /*options*/) const override
+  {
+    ++ik_calls;
+    solution = { ik_pose.position.x, ik_pose.position.y, ik_pose.position.z };
+    error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+    return true;
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double /*timeout*/, std::vector<double>& solution,
+                        moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const kinematics::KinematicsQueryOptions& options) const override
+  {
+    return getPositionIK(ik_pose, ik_seed_state, solution, error_code, options);
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double /*timeout*/, const std::vector<double>& /*consistency_limits*/,
+                        std::vector<double>& solution, moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const kinematics::KinematicsQueryOptions& options) const override
+  {
+    return getPositionIK(ik_pose, ik_seed_state, solution, error_code, options);
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double /*timeout*/, std::vector<double>& solution, const IKCallbackFn& /*solution_callback*/,
+                        moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const kinematics::KinematicsQueryOptions& options) const override
+  {
+    return getPositionIK(ik_pose, ik_seed_state, solution, error_code, options);
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double /*timeout*/, const std::vector<double>& /*consistency_limits*/,
+                        std::vector<double>& solution, const IKCallbackFn& /*solution_callback*/,
+                        moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const kinematics::KinematicsQueryOptions& options) const override
+  {
+    return getPositionIK(ik_pose, ik_seed_state, solution, error_code, options);
+  }
+
+  bool searchPositionIKSequence(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                const std::vector<double>& ik_seed_state, double timeout,
+                                std::vector<std::vector<double>>& solutions,
+                                moveit_msgs::msg::MoveItErrorCodes& error_code,
+                                const kinematics::KinematicsQueryOptions& options) const override
+  {
+    ++sequence_calls;
+    return KinematicsBase::searchPositionIKSequence(ik_poses, ik_seed_state, timeout, solutions, error_code, options);
+  }
+
+  bool supportsIKSequence() const override
+  {
+    return supports_sequence_;
+  }
+
+  bool supportsParallelIKBatch() const override
+  {
+    return true;
+  }
+
+  bool getPositionFK(const std::vector<std::string>& /*link_names*/, const std::vector<double>& joint_angles,
+                     std::vector<geometry_msgs::msg::Pose>& poses) const override
+  {
+    poses.resize(1);
+    poses[0].position.x = joint_angles[0];
+    poses[0].position.y = joint_angles[1];
+    poses[0].position.z = joint_angles[2];
+    return true;
+  }
+
+  const std::vector<std::string>& getJointNames() const override
+  {
+    return joint_names_;
+  }
+
+  const std::vector<std::string>& getLinkNames() const override
+  {
+    return tip_frames_;
+  }
+
+  mutable std::atomic<std::size_t> ik_calls{ 0 };
+  mutable std::size_t sequence_calls = 0;
+
+private:
+  bool supports_sequence_;
+  std::vector<std::string> joint_names_{ "base-x-joint", "x-y-joint", "y-z-joint" };
+};
+
+class XYZRobot : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    RobotModelBuilder builder("xyz", "base");
+    builder.addChain("base->x", "prismatic", {}, urdf::Vector3(1.0, 0.0, 0.0));
+    builder.addChain("x->y", "prismatic", {}, urdf::Vector3(0.0, 1.0, 0.0));
+    builder.addChain("y->z", "prismatic", {}, urdf::Vector3(0.0, 0.0, 1.0));
+    builder.addGroupChain("base", "z", "xyz");
+    ASSERT_TRUE(builder.isValid());
+    robot_model_ = builder.build();
+    group_ = robot_model_->getJointModelGroup("xyz");
+  }
+
+  std::shared_ptr<XYZKinematics> setSolver(bool supports_sequence)
+  {
+    auto solver = std::make_shared<XYZKinematics>(supports_sequence);
+    group_->setSolverAllocators([solver](const JointModelGroup* /*group*/) { return solver; });
+    return solver;
+  }
+
+  double computePath(std::vector<RobotStatePtr>& traj, const CartesianPrecision& precision)
+  {
+    RobotState start_state(robot_model_);
+    start_state.setToDefaultValues();
+    start_state.update();
+    return CartesianInterpolator::computeCartesianPath(&start_state, group_, traj, robot_model_->getLinkModel("z"),
+                                                       Eigen::Vector3d(1.0, 0.5, 0.0), true, MaxEEFStep(0.01, 0.0),
+                                                       precision);
+  }
+
+  RobotModelPtr robot_model_;
+  JointModelGroup* group_ = nullptr;
+};
+
+TEST_F(XYZRobot, adaptiveStepNeedsFewerIKCalls)
+{
+  std::vector<RobotStatePtr> fixed_traj;
+  const auto fixed_solver = setSolver(false);
+  EXPECT_DOUBLE_EQ(computePath(fixed_traj, CartesianPrecision()), 1.0);
+
+  CartesianPrecision precision;
+  precision.max_step_growth = 16.0;
+  std::vector<RobotStatePtr> adaptive_traj;
+  const auto adaptive_solver = setSolver(false);
+  EXPECT_DOUBLE_EQ(computePath(adaptive_traj, precision), 1.0);
+
+  // the joints move uniformly along the whole path, so the stride quickly reaches its maximum
+  EXPECT_LT(adaptive_solver->ik_calls * 8, fixed_solver->ik_calls);
+  EXPECT_LT(adaptive_traj.size() * 8, fixed_traj.size());
+  adaptive_traj.back()->update();
+  EXPECT_EIGEN_NEAR(adaptive_traj.back()->getGlobalLinkTransform("z").translation(), Eigen::Vector3d(1.0, 0.5, 0.0),
+                    1e-9);
+}
+
+TEST_F(XYZRobot, fixedStepsUseIKSequence)
+{
+  std::vector<RobotStatePtr> expected_traj;
+  setSolver(false);
+  EXPECT_DOUBLE_EQ(computePath(expected_traj, CartesianPrecision()), 1.0);
+
+  std::vector<RobotStatePtr> traj;
+  const auto solver = setSolver(true);
+  EXPECT_DOUBLE_EQ(computePath(traj, CartesianPrecision()), 1.0);
+  EXPECT_EQ(solver->sequence_calls, 1u);
+
+  ASSERT_EQ(traj.size(), expected_traj.size());
+  for (std::size_t i = 0; i < traj.size(); ++i)
+  {
+    EXPECT_NEAR(traj[i]->distance(*expected_traj[i]), 0.0, 1e-12) << "waypoint " << i;
+  }
+}
+
+TEST_F(XYZRobot, parallelSegmentsMatchSequentialPath)
+{
+  setSolver(false);
+  RobotState start_state(robot_model_);
+  start_state.setToDefaultValues();
+  start_state.update();
+  EigenSTL::vector_Isometry3d waypoints(4, Eigen::Isometry3d::Identity());
+  waypoints[0].translation() = Eigen::Vector3d(0.5, 0.0, 0.0);
+  waypoints[1].translation() = Eigen::Vector3d(0.5, 0.5, 0.0);
+  waypoints[2].translation() = Eigen::Vector3d(1.0, 0.5, 0.2);
+  waypoints[3].translation() = Eigen::Vector3d(0.0, 0.0, 0.0);
+  const LinkModel* link = robot_model_->getLinkModel("z");
+
+  std::vector<RobotStatePtr> expected_traj;
+  EXPECT_DOUBLE_EQ(CartesianInterpolator::computeCartesianPath(&start_state, group_, expected_traj, link, waypoints,
+                                                               true, MaxEEFStep(0.01, 0.0), CartesianPrecision()),
+                   1.0);
+  std::vector<RobotStatePtr> traj;
+  EXPECT_DOUBLE_EQ(CartesianInterpolator::computeCartesianPathParallel(
+                       &start_state, group_, traj, link, waypoints, true, MaxEEFStep(0.01, 0.0), CartesianPrecision(),
+                       GroupStateValidityCallbackFn(), kinematics::KinematicsQueryOptions(),
+                       kinematics::KinematicsBase::IKCostFn(), Eigen::Isometry3d::Identity(), 4),
+                   1.0);
+
+  ASSERT_EQ(traj.size(), expected_traj.size());
+  for (std::size_t i = 0; i < traj.size(); ++i)
+  {
+    EXPECT_NEAR(traj[i]->distance(*expected_traj[i]), 0.0, 1e-12) << "waypoint " << i;
+  }
+}
+
 // TODO - The tests below fail since no kinematic plugins are found. Move the tests to IK plugin package.
 // class PandaRobot : public testing::Test
 // {
@@ -0,0 +1,217 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/macros/class_forward.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <moveit/robot_trajectory/robot_trajectory.hpp>
+#include <moveit_msgs/msg/robot_trajectory.hpp>
+#include <Eigen/Core>
+#include <vector>
+
+namespace robot_trajectory
+{
+MOVEIT_CLASS_FORWARD(GroupTrajectory);  // Defines GroupTrajectoryPtr, ConstPtr, WeakPtr... etc
+
+/** \brief A trajectory of the variables of one group, stored in contiguous matrices.
+
+    Waypoint i is column i of the getVariableCount() x getWayPointCount() position, velocity and acceleration
+    matrices, in the order of JointModelGroup::getVariableIndexList(). All other variables of the robot are those of a
+    single reference state. RobotState waypoints are only created when asked for, so time parameterization,
+    smoothing and message conversion can work on the matrices directly. */
+class GroupTrajectory
+{
+public:
+  /** @brief Construct an empty trajectory for \e group (the whole robot if nullptr), with the other variables taken
+      from \e reference_state */
+  GroupTrajectory(const moveit::core::RobotState& reference_state, const moveit::core::JointModelGroup* group);
+
+  /** @brief Construct from \e trajectory, taking the variables outside of its group from its first waypoint */
+  explicit GroupTrajectory(const RobotTrajectory& trajectory);
+
+  const moveit::core::RobotModelConstPtr& getRobotModel() const
+  {
+    return reference_state_.getRobotModel();
+  }
+
+  /** @brief The group of the trajectory, nullptr for the whole robot */
+  const moveit::core::JointModelGroup* getGroup() const
+  {
+    return group_;
+  }
+
+  /** @brief The state the variables outside of the group are taken from */
+  const moveit::core::RobotState& getReferenceState() const
+  {
+    return reference_state_;
+  }
+
+  /** @brief The number of variables of each waypoint */
+  std::size_t getVariableCount() const
+  {
+    return variable_count_;
+  }
+
+  std::size_t getWayPointCount() const
+  {
+    return durations_.size();
+  }
+
+  std::size_t size() const
+  {
+    return durations_.size();
+  }
+
+  bool empty() const
+  {
+    return durations_.empty();
+  }
+
+  bool hasVelocities() const
+  {
+    return has_velocities_;
+  }
+
+  bool hasAccelerations() const
+  {
+    return has_accelerations_;
+  }
+
+  /** @brief Reserve storage for \e count waypoints */
+  void reserve(std::size_t count);
+
+  /** @brief Resize to \e count waypoints. New waypoints copy the group variables of the reference state. */
+  GroupTrajectory& resize(std::size_t count);
+
+  GroupTrajectory& clear()
+  {
+    return resize(0);
+  }
+
+  /** @brief Add a waypoint at the end, \e dt seconds after the previous one */
+  GroupTrajectory& addSuffixWayPoint(const Eigen::Ref<const Eigen::VectorXd>& positions, double dt);
+
+  /** @brief Add a waypoint with velocities and accelerations at the end, \e dt seconds after the previous one */
+  GroupTrajectory& addSuffixWayPoint(const Eigen::Ref<const Eigen::VectorXd>& positions,
+                                     const Eigen::Ref<const Eigen::VectorXd>& velocities,
+                                     const Eigen::Ref<const Eigen::VectorXd>& accelerations, double dt);
+
+  /** @brief Add the group variables of \e state at the end, \e dt seconds after the previous waypoint.
+      Velocities and accelerations are copied if \e state has them. */
+  GroupTrajectory& addSuffixWayPoint(const moveit::core::RobotState& state, double dt);
+
+  /** @brief The positions of all waypoints, one column per waypoint */
+  Eigen::Map<const Eigen::MatrixXd> getPositions() const
+  {
+    return Eigen::Map<const Eigen::MatrixXd>(positions_.data(), variable_count_, size());
+  }
+
+  Eigen::Map<Eigen::MatrixXd> getPositionsNonConst()
+  {
+    return Eigen::Map<Eigen::MatrixXd>(positions_.data(), variable_count_, size());
+  }
+
+  /** @brief The velocities of all waypoints, one column per waypoint. Zero unless they were set. */
+  Eigen::Map<const Eigen::MatrixXd> getVelocities() const
+  {
+    return Eigen::Map<const Eigen::MatrixXd>(velocities_.data(), variable_count_, size());
+  }
+
+  /** @brief Modifiable velocities of all waypoints, marks the trajectory as having velocities  */
+  Eigen::Map<Eigen::MatrixXd> getVelocitiesNonConst()
+  {
+    has_velocities_ = true;
+    return Eigen::Map<Eigen::MatrixXd>(velocities_.data(), variable_count_, size());
+  }
+
+  /** @brief The accelerations of all waypoints, one column per waypoint. Zero unless they were set. */
+  Eigen::Map<const Eigen::MatrixXd> getAccelerations() const
+  {
+    return Eigen::Map<const Eigen::MatrixXd>(accelerations_.data(), variable_count_, size());
+  }
+
+  /** @brief Modifiable accelerations of all waypoints, marks the trajectory as having accelerations */
+  Eigen::Map<Eigen::MatrixXd> getAccelerationsNonConst()
+  {
+    has_accelerations_ = true;
+    return Eigen::Map<Eigen::MatrixXd>(accelerations_.data(), variable_count_, size());
+  }
+
+  /** @brief The duration of each waypoint from the previous one */
+  const std::vector<double>& getWayPointDurations() const
+  {
+    return durations_;
+  }
+
+  std::vector<double>& getWayPointDurationsNonConst()
+  {
+    return durations_;
+  }
+
+  double getWayPointDurationFromStart(std::size_t index) const;
+
+  double getDuration() const;
+
+  /** @brief Write the group variables of waypoint \e index to \e state. Other variables of \e state are not changed,
+      velocities and accelerations are only written if the trajectory has them. */
+  void getWayPoint(std::size_t index, moveit::core::RobotState& state) const;
+
+  /** @brief Create a copy of the reference state at waypoint \e index */
+  moveit::core::RobotStatePtr getWayPointPtr(std::size_t index) const;
+
+  /** @brief Convert to a RobotTrajectory, creating one RobotState per waypoint */
+  void getRobotTrajectory(RobotTrajectory& trajectory) const;
+
+  /** @brief Convert to a message like RobotTrajectory::getRobotTrajectoryMsg().
+      Groups of single-variable joints are converted from the matrices directly, without creating any RobotState. */
+  void getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory) const;
+
+private:
+  // copy the group variables of source into column index of target
+  void copyGroupVariables(const double* source, std::vector<double>& target, std::size_t index) const;
+
+  moveit::core::RobotState reference_state_;
+  const moveit::core::JointModelGroup* group_;
+  std::size_t variable_count_;
+
+  // column-major getVariableCount() x getWayPointCount() matrices
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  std::vector<double> accelerations_;
+  std::vector<double> durations_;
+  bool has_velocities_ = false;
+  bool has_accelerations_ = false;
+};
+}  // namespace robot_trajectory
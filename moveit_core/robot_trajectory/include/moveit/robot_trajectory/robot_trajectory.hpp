@@ -42,6 +42,7 @@
 #include <moveit_msgs/msg/robot_state.hpp>
 #include <deque>
 #include <memory>
+#include <vector>
 #include <optional>
 
 #include <rcl/error_handling.h>
@@ -52,6 +53,8 @@
 
 namespace robot_trajectory
 {
+class GroupTrajectory;
+
 MOVEIT_CLASS_FORWARD(RobotTrajectory);  // Defines RobotTrajectoryPtr, ConstPtr, WeakPtr... etc
 
 /** \brief Maintain a sequence of waypoints and the time durations
@@ -155,6 +158,12 @@ public:
    */
   double getWayPointDurationFromStart(std::size_t index) const;
 
+  /** @brief The duration from start of every waypoint.
+   *  The cumulative sums are computed once and cached until the trajectory is modified, so time lookups cost
+   *  O(log n). The reference is valid until the next modification of the trajectory.
+   */
+  const std::vector<double>& getWayPointDurationsFromStart() const;
+
   double getWayPointDurationFromPrevious(std::size_t index) const
   {
     if (duration_from_previous_.size() > index)
@@ -172,6 +181,7 @@ public:
     if (duration_from_previous_.size() <= index)
       duration_from_previous_.resize(index + 1, 0.0);
     duration_from_previous_[index] = value;
+    durations_from_start_.reset();
     return *this;
   }
 
@@ -200,6 +210,7 @@ public:
     state->update();
     waypoints_.push_back(state);
     duration_from_previous_.push_back(dt);
+    durations_from_start_.reset();
     return *this;
   }
 
@@ -213,6 +224,7 @@ public:
     state->update();
     waypoints_.push_front(state);
     duration_from_previous_.push_front(dt);
+    durations_from_start_.reset();
     return *this;
   }
 
@@ -226,6 +238,7 @@ public:
     state->update();
     waypoints_.insert(waypoints_.begin() + index, state);
     duration_from_previous_.insert(duration_from_previous_.begin() + index, dt);
+    durations_from_start_.reset();
     return *this;
   }
 
@@ -252,6 +265,7 @@ public:
   {
     waypoints_.erase(waypoints_.begin() + index);
     duration_from_previous_.erase(duration_from_previous_.begin() + index);
+    durations_from_start_.reset();
     return *this;
   }
 
@@ -259,6 +273,7 @@ public:
   {
     waypoints_.clear();
     duration_from_previous_.clear();
+    durations_from_start_.reset();
     return *this;
   }
 
@@ -322,6 +337,16 @@ public:
    */
   bool getStateAtDurationFromStart(const double request_duration, moveit::core::RobotStatePtr& output_state) const;
 
+  /** @brief Sample the trajectory every \e dt seconds from start, and once more at its end, using linear time
+   *  interpolation as getStateAtDurationFromStart(). Velocities and accelerations are interpolated as well if the
+   *  waypoints have them. No RobotState is created; the samples are written to the matrices of \e output, which must
+   *  have the group of this trajectory and only grow, so the same output can be reused, e.g. once per control cycle.
+   *  @param dt The time between samples, must be positive.
+   *  @param output The resulting samples, with the durations between them.
+   *  @return False if the trajectory is empty, \e dt is not positive or \e output has a different group.
+   */
+  bool resample(double dt, GroupTrajectory& output) const;
+
   class Iterator
   {
     std::deque<moveit::core::RobotStatePtr>::iterator waypoint_iterator_;
@@ -396,6 +421,8 @@ private:
   const moveit::core::JointModelGroup* group_;
   std::deque<moveit::core::RobotStatePtr> waypoints_;
   std::deque<double> duration_from_previous_;
+  // cumulative sums of duration_from_previous_, created on demand by const lookups and reset by modifications
+  mutable std::shared_ptr<const std::vector<double>> durations_from_start_;
 };
 
 /** @brief Operator overload for printing trajectory to a stream */
@@ -0,0 +1,251 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_trajectory/group_trajectory.hpp>
+#include <rclcpp/duration.hpp>
+#include <rclcpp/time.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace robot_trajectory
+{
+namespace
+{
+moveit::core::RobotState getFirstWayPointOrDefault(const RobotTrajectory& trajectory)
+{
+  if (!trajectory.empty())
+    return trajectory.getFirstWayPoint();
+  moveit::core::RobotState state(trajectory.getRobotModel());
+  state.setToDefaultValues();
+  return state;
+}
+}  // namespace
+
+GroupTrajectory::GroupTrajectory(const moveit::core::RobotState& reference_state,
+                                 const moveit::core::JointModelGroup* group)
+  : reference_state_(reference_state)
+  , group_(group)
+  , variable_count_(group ? group->getVariableCount() : reference_state.getVariableCount())
+{
+}
+
+GroupTrajectory::GroupTrajectory(const RobotTrajectory& trajectory)
+  : GroupTrajectory(getFirstWayPointOrDefault(trajectory), trajectory.getGroup())
+{
+  reserve(trajectory.size());
+  for (std::size_t i = 0; i < trajectory.size(); ++i)
+    addSuffixWayPoint(trajectory.getWayPoint(i), trajectory.getWayPointDurationFromPrevious(i));
+}
+
+void GroupTrajectory::reserve(std::size_t count)
+{
+  positions_.reserve(count * variable_count_);
+  velocities_.reserve(count * variable_count_);
+  accelerations_.reserve(count * variable_count_);
+  durations_.reserve(count);
+}
+
+GroupTrajectory& GroupTrajectory::resize(std::size_t count)
+{
+  const std::size_t old_count = size();
+  positions_.resize(count * variable_count_);
+  velocities_.resize(count * variable_count_, 0.0);
+  accelerations_.resize(count * variable_count_, 0.0);
+  durations_.resize(count, 0.0);
+  for (std::size_t i = old_count; i < count; ++i)
+    copyGroupVariables(reference_state_.getVariablePositions(), positions_, i);
+  return *this;
+}
+
+GroupTrajectory& GroupTrajectory::addSuffixWayPoint(const Eigen::Ref<const Eigen::VectorXd>& positions, double dt)
+{
+  assert(static_cast<std::size_t>(positions.size()) == variable_count_);
+  positions_.insert(positions_.end(), positions.data(), positions.data() + variable_count_);
+  velocities_.resize(velocities_.size() + variable_count_, 0.0);
+  accelerations_.resize(accelerations_.size() + variable_count_, 0.0);
+  durations_.push_back(dt);
+  return *this;
+}
+
+GroupTrajectory& GroupTrajectory::addSuffixWayPoint(const Eigen::Ref<const Eigen::VectorXd>& positions,
+                                                    const Eigen::Ref<const Eigen::VectorXd>& velocities,
+                                                    const Eigen::Ref<const Eigen::VectorXd>& accelerations, double dt)
+{
+  assert(static_cast<std::size_t>(velocities.size()) == variable_count_);
+  assert(static_cast<std::size_t>(accelerations.size()) == variable_count_);
+  addSuffixWayPoint(positions, dt);
+  std::copy(velocities.data(), velocities.data() + variable_count_, velocities_.end() - variable_count_);
+  std::copy(accelerations.data(), accelerations.data() + variable_count_, accelerations_.end() - variable_count_);
+  has_velocities_ = has_accelerations_ = true;
+  return *this;
+}
+
+GroupTrajectory& GroupTrajectory::addSuffixWayPoint(const moveit::core::RobotState& state, double dt)
+{
+  const std::size_t index = size();
+  resize(index + 1);
+  durations_[index] = dt;
+  copyGroupVariables(state.getVariablePositions(), positions_, index);
+  if (state.hasVelocities())
+  {
+    copyGroupVariables(state.getVariableVelocities(), velocities_, index);
+    has_velocities_ = true;
+  }
+  if (state.hasAccelerations())
+  {
+    copyGroupVariables(state.getVariableAccelerations(), accelerations_, index);
+    has_accelerations_ = true;
+  }
+  return *this;
+}
+
+double GroupTrajectory::getWayPointDurationFromStart(std::size_t index) const
+{
+  if (durations_.empty())
+    return 0.0;
+  index = std::min(index, durations_.size() - 1);
+  return std::accumulate(durations_.begin(), durations_.begin() + index + 1, 0.0);
+}
+
+double GroupTrajectory::getDuration() const
+{
+  return std::accumulate(durations_.begin(), durations_.end(), 0.0);
+}
+
+void GroupTrajectory::getWayPoint(std::size_t index, moveit::core::RobotState& state) const
+{
+  const std::size_t offset = index * variable_count_;
+  if (group_)
+  {
+    state.setJointGroupPositions(group_, positions_.data() + offset);
+    if (has_velocities_)
+      state.setJointGroupVelocities(group_, velocities_.data() + offset);
+    if (has_accelerations_)
+      state.setJointGroupAccelerations(group_, accelerations_.data() + offset);
+  }
+  else
+  {
+    state.setVariablePositions(positions_.data() + offset);
+    if (has_velocities_)
+      state.setVariableVelocities(velocities_.data() + offset);
+    if (has_accelerations_)
+      state.setVariableAccelerations(accelerations_.data() + offset);
+  }
+}
+
+moveit::core::RobotStatePtr GroupTrajectory::getWayPointPtr(std::size_t index) const
+{
+  auto state = std::make_shared<moveit::core::RobotState>(reference_state_);
+  getWayPoint(index, *state);
+  return state;
+}
+
+void GroupTrajectory::getRobotTrajectory(RobotTrajectory& trajectory) const
+{
+  trajectory = RobotTrajectory(getRobotModel(), group_);
+  for (std::size_t i = 0; i < size(); ++i)
+    trajectory.addSuffixWayPoint(getWayPointPtr(i), durations_[i]);
+}
+
+void GroupTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory) const
+{
+  const std::vector<const moveit::core::JointModel*>& joints =
+      group_ ? group_->getActiveJointModels() : getRobotModel()->getActiveJointModels();
+  const bool multi_dof = std::any_of(joints.begin(), joints.end(), [](const moveit::core::JointModel* joint) {
+    return joint->getVariableCount() != 1;
+  });
+  if (multi_dof)
+  {
+    // transforms of multi-DOF joints are computed by RobotState
+    RobotTrajectory robot_trajectory(getRobotModel());
+    getRobotTrajectory(robot_trajectory);
+    robot_trajectory.getRobotTrajectoryMsg(trajectory);
+    return;
+  }
+
+  trajectory = moveit_msgs::msg::RobotTrajectory();
+  if (empty() || joints.empty())
+    return;
+
+  // row of each joint in the matrices
+  std::vector<std::size_t> rows;
+  rows.reserve(joints.size());
+  for (const moveit::core::JointModel* joint : joints)
+  {
+    trajectory.joint_trajectory.joint_names.push_back(joint->getName());
+    rows.push_back(group_ ? group_->getVariableGroupIndex(joint->getVariableNames()[0]) :
+                          joint->getFirstVariableIndex());
+  }
+  trajectory.joint_trajectory.header.frame_id = getRobotModel()->getModelFrame();
+  trajectory.joint_trajectory.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
+  trajectory.joint_trajectory.points.resize(size());
+
+  double time_from_start = 0.0;
+  for (std::size_t i = 0; i < size(); ++i)
+  {
+    trajectory_msgs::msg::JointTrajectoryPoint& point = trajectory.joint_trajectory.points[i];
+    const std::size_t offset = i * variable_count_;
+    point.positions.resize(rows.size());
+    for (std::size_t j = 0; j < rows.size(); ++j)
+      point.positions[j] = positions_[offset + rows[j]];
+    if (has_velocities_)
+    {
+      point.velocities.resize(rows.size());
+      for (std::size_t j = 0; j < rows.size(); ++j)
+        point.velocities[j] = velocities_[offset + rows[j]];
+    }
+    if (has_accelerations_)
+    {
+      point.accelerations.resize(rows.size());
+      for (std::size_t j = 0; j < rows.size(); ++j)
+        point.accelerations[j] = accelerations_[offset + rows[j]];
+    }
+    time_from_start += durations_[i];
+    point.time_from_start = rclcpp::Duration::from_seconds(time_from_start);
+  }
+}
+
+void GroupTrajectory::copyGroupVariables(const double* source, std::vector<double>& target, std::size_t index) const
+{
+  double* column = target.data() + index * variable_count_;
+  if (!group_)
+  {
+    std::copy(source, source + variable_count_, column);
+    return;
+  }
+  const std::vector<int>& indices = group_->getVariableIndexList();
+  for (std::size_t j = 0; j < variable_count_; ++j)
+    column[j] = source[indices[j]];
+}
+}  // namespace robot_trajectory
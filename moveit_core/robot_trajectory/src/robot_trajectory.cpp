@@ -36,12 +36,14 @@
 
 #include <math.h>
 #include <moveit/robot_trajectory/robot_trajectory.hpp>
+#include <moveit/robot_trajectory/group_trajectory.hpp>
 #include <moveit/robot_state/conversions.hpp>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/time.hpp>
 #include <tf2_eigen/tf2_eigen.hpp>
+#include <algorithm>
 #include <numeric>
 #include <optional>
 #include <moveit/utils/logger.hpp>
@@ -54,6 +56,101 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.robot_trajectory");
 }
+
+// copy the variables with the given indices from source to target
+void copyVariables(const double* source, const std::vector<int>& indices, std::vector<double>& target)
+{
+  target.resize(indices.size());
+  for (std::size_t j = 0; j < indices.size(); ++j)
+    target[j] = source[indices[j]];
+}
+
+std::vector<int> getVariableIndices(const moveit::core::RobotModel& robot_model, const std::vector<std::string>& names)
+{
+  std::vector<int> indices;
+  indices.reserve(names.size());
+  for (const std::string& name : names)
+    indices.push_back(robot_model.getVariableIndex(name));
+  return indices;
+}
+
+void setJointTrajectoryPoint(const trajectory_msgs::msg::JointTrajectoryPoint& point, const std::vector<int>& indices,
+                             moveit::core::RobotState& state)
+{
+  for (std::size_t j = 0; j < indices.size(); ++j)
+    state.setVariablePosition(indices[j], point.positions[j]);
+  if (!point.velocities.empty())
+  {
+    for (std::size_t j = 0; j < indices.size(); ++j)
+      state.setVariableVelocity(indices[j], point.velocities[j]);
+  }
+  if (!point.accelerations.empty())
+  {
+    for (std::size_t j = 0; j < indices.size(); ++j)
+      state.setVariableAcceleration(indices[j], point.accelerations[j]);
+  }
+  if (!point.effort.empty())
+  {
+    for (std::size_t j = 0; j < indices.size(); ++j)
+      state.setVariableEffort(indices[j], point.effort[j]);
+  }
+}
+
+// where the components of a planar twist are found among the variables of a multi-DOF joint
+struct PlanarVariables
+{
+  PlanarVariables() = default;
+
+  explicit PlanarVariables(const moveit::core::JointModel& joint)
+  {
+    const std::vector<std::string>& names = joint.getVariableNames();
+    for (std::size_t k = 0; k < names.size(); ++k)
+    {
+      if (names[k].find("/x") != std::string::npos)
+      {
+        x = static_cast<int>(k);
+      }
+      else if (names[k].find("/y") != std::string::npos)
+      {
+        y = static_cast<int>(k);
+      }
+      else if (names[k].find("/z") != std::string::npos)
+      {
+        z = static_cast<int>(k);
+      }
+      else if (names[k].find("/theta") != std::string::npos)
+      {
+        theta = static_cast<int>(k);
+      }
+    }
+    planar = true;
+  }
+
+  bool isPlanar() const
+  {
+    return planar;
+  }
+
+  geometry_msgs::msg::Twist toTwist(const double* values) const
+  {
+    geometry_msgs::msg::Twist twist;
+    if (x >= 0)
+      twist.linear.x = values[x];
+    if (y >= 0)
+      twist.linear.y = values[y];
+    if (z >= 0)
+      twist.linear.z = values[z];
+    if (theta >= 0)
+      twist.angular.z = values[theta];
+    return twist;
+  }
+
+  int x = -1;
+  int y = -1;
+  int z = -1;
+  int theta = -1;
+  bool planar = false;
+};
 }  // namespace
 
 RobotTrajectory::RobotTrajectory(const moveit::core::RobotModelConstPtr& robot_model)
@@ -95,7 +192,8 @@ const std::string& RobotTrajectory::getGroupName() const
 
 double RobotTrajectory::getDuration() const
 {
-  return std::accumulate(duration_from_previous_.begin(), duration_from_previous_.end(), 0.0);
+  const std::vector<double>& durations_from_start = getWayPointDurationsFromStart();
+  return durations_from_start.empty() ? 0.0 : durations_from_start.back();
 }
 
 double RobotTrajectory::getAverageSegmentDuration() const
@@ -127,6 +225,7 @@ void RobotTrajectory::swap(RobotTrajectory& other) noexcept
   std::swap(group_, other.group_);
   waypoints_.swap(other.waypoints_);
   duration_from_previous_.swap(other.duration_from_previous_);
+  durations_from_start_.swap(other.durations_from_start_);
 }
 
 RobotTrajectory& RobotTrajectory::append(const RobotTrajectory& source, double dt, size_t start_index, size_t end_index)
@@ -142,6 +241,7 @@ RobotTrajectory& RobotTrajectory::append(const RobotTrajectory& source, double d
                                  std::next(source.duration_from_previous_.begin(), end_index));
   if (duration_from_previous_.size() > index)
     duration_from_previous_[index] = dt;
+  durations_from_start_.reset();
 
   return *this;
 }
@@ -159,6 +259,7 @@ RobotTrajectory& RobotTrajectory::reverse()
     duration_from_previous_.push_back(duration_from_previous_.front());
     std::reverse(duration_from_previous_.begin(), duration_from_previous_.end());
     duration_from_previous_.pop_back();
+    durations_from_start_.reset();
   }
 
   return *this;
@@ -265,17 +366,24 @@ RobotTrajectory& RobotTrajectory::unwind(const moveit::core::RobotState& state)
 void RobotTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory,
                                             const std::vector<std::string>& joint_filter) const
 {
-  trajectory = moveit_msgs::msg::RobotTrajectory();
+  // The points of trajectory are resized instead of recreated, so converting into the same message again reuses its
+  // storage
+  trajectory.joint_trajectory.joint_names.clear();
+  trajectory.multi_dof_joint_trajectory.joint_names.clear();
+  trajectory.joint_trajectory.header = std_msgs::msg::Header();
+  trajectory.multi_dof_joint_trajectory.header = std_msgs::msg::Header();
   if (waypoints_.empty())
+  {
+    trajectory.joint_trajectory.points.clear();
+    trajectory.multi_dof_joint_trajectory.points.clear();
     return;
+  }
   const std::vector<const moveit::core::JointModel*>& jnts =
       group_ ? group_->getActiveJointModels() : robot_model_->getActiveJointModels();
 
-  std::vector<const moveit::core::JointModel*> onedof;
+  // Variable indices are looked up once for all waypoints
+  std::vector<int> onedof;
   std::vector<const moveit::core::JointModel*> mdof;
-  trajectory.joint_trajectory.joint_names.clear();
-  trajectory.multi_dof_joint_trajectory.joint_names.clear();
-
   for (const moveit::core::JointModel* active_joint : jnts)
   {
     // only consider joints listed in joint_filter
@@ -286,7 +394,7 @@ void RobotTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& t
     if (active_joint->getVariableCount() == 1)
     {
       trajectory.joint_trajectory.joint_names.push_back(active_joint->getName());
-      onedof.push_back(active_joint);
+      onedof.push_back(active_joint->getFirstVariableIndex());
     }
     else
     {
@@ -301,118 +409,73 @@ void RobotTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& t
     trajectory.joint_trajectory.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
     trajectory.joint_trajectory.points.resize(waypoints_.size());
   }
+  else
+  {
+    trajectory.joint_trajectory.points.clear();
+  }
 
+  // Offsets of the planar velocity components within the variables of each multi-DOF joint, -1 if not present
+  // TODO: currently only checking for planar multi DOF joints / need to add check for floating
+  std::vector<PlanarVariables> planar_variables(mdof.size());
   if (!mdof.empty())
   {
     trajectory.multi_dof_joint_trajectory.header.frame_id = robot_model_->getModelFrame();
     trajectory.multi_dof_joint_trajectory.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
     trajectory.multi_dof_joint_trajectory.points.resize(waypoints_.size());
+    for (std::size_t j = 0; j < mdof.size(); ++j)
+    {
+      if (mdof[j]->getType() == moveit::core::JointModel::JointType::PLANAR)
+        planar_variables[j] = PlanarVariables(*mdof[j]);
+    }
+  }
+  else
+  {
+    trajectory.multi_dof_joint_trajectory.points.clear();
   }
 
-  static const auto ZERO_DURATION = rclcpp::Duration::from_seconds(0);
-  double total_time = 0.0;
+  const std::vector<double>& durations_from_start = getWayPointDurationsFromStart();
   for (std::size_t i = 0; i < waypoints_.size(); ++i)
   {
-    if (duration_from_previous_.size() > i)
-      total_time += duration_from_previous_[i];
+    moveit::core::RobotState& waypoint = *waypoints_[i];
+    const rclcpp::Duration time_from_start = rclcpp::Duration::from_seconds(durations_from_start[i]);
 
     if (!onedof.empty())
     {
-      trajectory.joint_trajectory.points[i].positions.resize(onedof.size());
-      trajectory.joint_trajectory.points[i].velocities.reserve(onedof.size());
-
-      for (std::size_t j = 0; j < onedof.size(); ++j)
-      {
-        trajectory.joint_trajectory.points[i].positions[j] =
-            waypoints_[i]->getVariablePosition(onedof[j]->getFirstVariableIndex());
-        // if we have velocities/accelerations/effort, copy those too
-        if (waypoints_[i]->hasVelocities())
-        {
-          trajectory.joint_trajectory.points[i].velocities.push_back(
-              waypoints_[i]->getVariableVelocity(onedof[j]->getFirstVariableIndex()));
-        }
-        if (waypoints_[i]->hasAccelerations())
-        {
-          trajectory.joint_trajectory.points[i].accelerations.push_back(
-              waypoints_[i]->getVariableAcceleration(onedof[j]->getFirstVariableIndex()));
-        }
-        if (waypoints_[i]->hasEffort())
-        {
-          trajectory.joint_trajectory.points[i].effort.push_back(
-              waypoints_[i]->getVariableEffort(onedof[j]->getFirstVariableIndex()));
-        }
-      }
-      // clear velocities if we have an incomplete specification
-      if (trajectory.joint_trajectory.points[i].velocities.size() != onedof.size())
-        trajectory.joint_trajectory.points[i].velocities.clear();
-      // clear accelerations if we have an incomplete specification
-      if (trajectory.joint_trajectory.points[i].accelerations.size() != onedof.size())
-        trajectory.joint_trajectory.points[i].accelerations.clear();
-      // clear effort if we have an incomplete specification
-      if (trajectory.joint_trajectory.points[i].effort.size() != onedof.size())
-        trajectory.joint_trajectory.points[i].effort.clear();
-
-      if (duration_from_previous_.size() > i)
-      {
-        trajectory.joint_trajectory.points[i].time_from_start = rclcpp::Duration::from_seconds(total_time);
-      }
+      trajectory_msgs::msg::JointTrajectoryPoint& point = trajectory.joint_trajectory.points[i];
+      copyVariables(waypoint.getVariablePositions(), onedof, point.positions);
+      // if we have velocities/accelerations/effort, copy those too
+      if (waypoint.hasVelocities())
+        copyVariables(waypoint.getVariableVelocities(), onedof, point.velocities);
       else
-      {
-        trajectory.joint_trajectory.points[i].time_from_start = ZERO_DURATION;
-      }
+        point.velocities.clear();
+      if (waypoint.hasAccelerations())
+        copyVariables(waypoint.getVariableAccelerations(), onedof, point.accelerations);
+      else
+        point.accelerations.clear();
+      if (waypoint.hasEffort())
+        copyVariables(waypoint.getVariableEffort(), onedof, point.effort);
+      else
+        point.effort.clear();
+      point.time_from_start = time_from_start;
     }
     if (!mdof.empty())
     {
-      trajectory.multi_dof_joint_trajectory.points[i].transforms.resize(mdof.size());
+      trajectory_msgs::msg::MultiDOFJointTrajectoryPoint& point = trajectory.multi_dof_joint_trajectory.points[i];
+      point.transforms.resize(mdof.size());
+      point.velocities.clear();
+      point.accelerations.clear();
       for (std::size_t j = 0; j < mdof.size(); ++j)
       {
-        geometry_msgs::msg::TransformStamped ts = tf2::eigenToTransform(waypoints_[i]->getJointTransform(mdof[j]));
-        trajectory.multi_dof_joint_trajectory.points[i].transforms[j] = ts.transform;
-        // TODO: currently only checking for planar multi DOF joints / need to add check for floating
-        if (waypoints_[i]->hasVelocities() && (mdof[j]->getType() == moveit::core::JointModel::JointType::PLANAR))
+        point.transforms[j] = tf2::eigenToTransform(waypoint.getJointTransform(mdof[j])).transform;
+        if (waypoint.hasVelocities() && planar_variables[j].isPlanar())
         {
-          const std::vector<std::string> names = mdof[j]->getVariableNames();
-          const double* velocities = waypoints_[i]->getJointVelocities(mdof[j]);
-          const double* accelerations = waypoints_[i]->getJointAccelerations(mdof[j]);
-
-          geometry_msgs::msg::Twist point_velocity;
-          geometry_msgs::msg::Twist point_acceleration;
-
-          for (std::size_t k = 0; k < names.size(); ++k)
-          {
-            if (names[k].find("/x") != std::string::npos)
-            {
-              point_velocity.linear.x = velocities[k];
-              point_acceleration.linear.x = accelerations[k];
-            }
-            else if (names[k].find("/y") != std::string::npos)
-            {
-              point_velocity.linear.y = velocities[k];
-              point_acceleration.linear.y = accelerations[k];
-            }
-            else if (names[k].find("/z") != std::string::npos)
-            {
-              point_velocity.linear.z = velocities[k];
-              point_acceleration.linear.z = accelerations[k];
-            }
-            else if (names[k].find("/theta") != std::string::npos)
-            {
-              point_velocity.angular.z = velocities[k];
-              point_acceleration.angular.z = accelerations[k];
-            }
-          }
-          trajectory.multi_dof_joint_trajectory.points[i].velocities.push_back(point_velocity);
-          trajectory.multi_dof_joint_trajectory.points[i].accelerations.push_back(point_acceleration);
+          const double* velocities = waypoint.getJointVelocities(mdof[j]);
+          const double* accelerations = waypoint.getJointAccelerations(mdof[j]);
+          point.velocities.push_back(planar_variables[j].toTwist(velocities));
+          point.accelerations.push_back(planar_variables[j].toTwist(accelerations));
         }
       }
-      if (duration_from_previous_.size() > i)
-      {
-        trajectory.multi_dof_joint_trajectory.points[i].time_from_start = rclcpp::Duration::from_seconds(total_time);
-      }
-      else
-      {
-        trajectory.multi_dof_joint_trajectory.points[i].time_from_start = ZERO_DURATION;
-      }
+      point.time_from_start = time_from_start;
     }
   }
 }
@@ -427,17 +490,15 @@ RobotTrajectory& RobotTrajectory::setRobotTrajectoryMsg(const moveit::core::Robo
   rclcpp::Time last_time_stamp = trajectory.header.stamp;
   rclcpp::Time this_time_stamp = last_time_stamp;
 
+  // Variable indices are looked up once for all points
+  std::vector<int> variable_indices;
+  if (state_count > 0)
+    variable_indices = getVariableIndices(*robot_model_, trajectory.joint_names);
   for (std::size_t i = 0; i < state_count; ++i)
   {
     this_time_stamp = rclcpp::Time(trajectory.header.stamp) + trajectory.points[i].time_from_start;
     auto st = std::make_shared<moveit::core::RobotState>(copy);
-    st->setVariablePositions(trajectory.joint_names, trajectory.points[i].positions);
-    if (!trajectory.points[i].velocities.empty())
-      st->setVariableVelocities(trajectory.joint_names, trajectory.points[i].velocities);
-    if (!trajectory.points[i].accelerations.empty())
-      st->setVariableAccelerations(trajectory.joint_names, trajectory.points[i].accelerations);
-    if (!trajectory.points[i].effort.empty())
-      st->setVariableEffort(trajectory.joint_names, trajectory.points[i].effort);
+    setJointTrajectoryPoint(trajectory.points[i], variable_indices, *st);
     addSuffixWayPoint(st, (this_time_stamp - last_time_stamp).seconds());
     last_time_stamp = this_time_stamp;
   }
@@ -459,33 +520,32 @@ RobotTrajectory& RobotTrajectory::setRobotTrajectoryMsg(const moveit::core::Robo
                                      trajectory.joint_trajectory.header.stamp;
   rclcpp::Time this_time_stamp = last_time_stamp;
 
+  // Variable indices and joints are looked up once for all points
+  std::vector<int> variable_indices;
+  if (!trajectory.joint_trajectory.points.empty())
+    variable_indices = getVariableIndices(*robot_model_, trajectory.joint_trajectory.joint_names);
+  std::vector<const moveit::core::JointModel*> mdof_joints;
+  if (!trajectory.multi_dof_joint_trajectory.points.empty())
+  {
+    for (const std::string& joint_name : trajectory.multi_dof_joint_trajectory.joint_names)
+      mdof_joints.push_back(robot_model_->getJointModel(joint_name));
+  }
+
   for (std::size_t i = 0; i < state_count; ++i)
   {
     auto st = std::make_shared<moveit::core::RobotState>(copy);
     if (trajectory.joint_trajectory.points.size() > i)
     {
-      st->setVariablePositions(trajectory.joint_trajectory.joint_names, trajectory.joint_trajectory.points[i].positions);
-      if (!trajectory.joint_trajectory.points[i].velocities.empty())
-      {
-        st->setVariableVelocities(trajectory.joint_trajectory.joint_names,
-                                  trajectory.joint_trajectory.points[i].velocities);
-      }
-      if (!trajectory.joint_trajectory.points[i].accelerations.empty())
-      {
-        st->setVariableAccelerations(trajectory.joint_trajectory.joint_names,
-                                     trajectory.joint_trajectory.points[i].accelerations);
-      }
-      if (!trajectory.joint_trajectory.points[i].effort.empty())
-        st->setVariableEffort(trajectory.joint_trajectory.joint_names, trajectory.joint_trajectory.points[i].effort);
+      setJointTrajectoryPoint(trajectory.joint_trajectory.points[i], variable_indices, *st);
       this_time_stamp = rclcpp::Time(trajectory.joint_trajectory.header.stamp) +
                         trajectory.joint_trajectory.points[i].time_from_start;
     }
     if (trajectory.multi_dof_joint_trajectory.points.size() > i)
     {
-      for (std::size_t j = 0; j < trajectory.multi_dof_joint_trajectory.joint_names.size(); ++j)
+      for (std::size_t j = 0; j < mdof_joints.size(); ++j)
       {
         Eigen::Isometry3d t = tf2::transformToEigen(trajectory.multi_dof_joint_trajectory.points[i].transforms[j]);
-        st->setJointPositions(trajectory.multi_dof_joint_trajectory.joint_names[j], t);
+        st->setJointPositions(mdof_joints[j], t);
       }
       this_time_stamp = rclcpp::Time(trajectory.multi_dof_joint_trajectory.header.stamp) +
                         trajectory.multi_dof_joint_trajectory.points[i].time_from_start;
@@ -509,7 +569,7 @@ RobotTrajectory& RobotTrajectory::setRobotTrajectoryMsg(const moveit::core::Robo
 void RobotTrajectory::findWayPointIndicesForDurationAfterStart(double duration, int& before, int& after,
                                                                double& blend) const
 {
-  if (duration < 0.0)
+  if (duration < 0.0 || waypoints_.empty())
   {
     before = 0;
     after = 0;
@@ -517,41 +577,47 @@ void RobotTrajectory::findWayPointIndicesForDurationAfterStart(double duration,
     return;
   }
 
-  // Find indices
-  std::size_t index = 0, num_points = waypoints_.size();
-  double running_duration = 0.0;
-  for (; index < num_points; ++index)
-  {
-    running_duration += duration_from_previous_[index];
-    if (running_duration >= duration)
-      break;
-  }
-  before = std::max<int>(index - 1, 0);
+  // Find the first waypoint reached at or after duration
+  const std::vector<double>& durations_from_start = getWayPointDurationsFromStart();
+  const std::size_t num_points = waypoints_.size();
+  const auto it = std::lower_bound(durations_from_start.begin(), durations_from_start.end(), duration);
+  const std::size_t index = std::distance(durations_from_start.begin(), it);
+  before = std::max<int>(static_cast<int>(index) - 1, 0);
   after = std::min<int>(index, num_points - 1);
 
   // Compute duration blend
-  double before_time = running_duration - duration_from_previous_[index];
   if (after == before)
   {
     blend = 1.0;
   }
   else
   {
-    blend = (duration - before_time) / duration_from_previous_[index];
+    blend = (duration - durations_from_start[before]) / duration_from_previous_[index];
+  }
+}
+
+const std::vector<double>& RobotTrajectory::getWayPointDurationsFromStart() const
+{
+  std::shared_ptr<const std::vector<double>> durations_from_start = std::atomic_load(&durations_from_start_);
+  if (!durations_from_start)
+  {
+    auto sums = std::make_shared<std::vector<double>>(duration_from_previous_.size());
+    std::partial_sum(duration_from_previous_.begin(), duration_from_previous_.end(), sums->begin());
+    // Concurrent const lookups may race to create the cache, only the first result is stored so references stay valid
+    durations_from_start = sums;
+    std::shared_ptr<const std::vector<double>> expected;
+    if (!std::atomic_compare_exchange_strong(&durations_from_start_, &expected, durations_from_start))
+      durations_from_start = expected;
   }
+  return *durations_from_start;
 }
 
 double RobotTrajectory::getWayPointDurationFromStart(std::size_t index) const
 {
   if (duration_from_previous_.empty())
     return 0.0;
-  if (index >= duration_from_previous_.size())
-    index = duration_from_previous_.size() - 1;
-
-  double time = 0.0;
-  for (std::size_t i = 0; i <= index; ++i)
-    time += duration_from_previous_[i];
-  return time;
+  const std::vector<double>& durations_from_start = getWayPointDurationsFromStart();
+  return durations_from_start[std::min(index, durations_from_start.size() - 1)];
 }
 
 bool RobotTrajectory::getStateAtDurationFromStart(const double request_duration,
@@ -570,6 +636,90 @@ bool RobotTrajectory::getStateAtDurationFromStart(const double request_duration,
   return true;
 }
 
+bool RobotTrajectory::resample(double dt, GroupTrajectory& output) const
+{
+  if (waypoints_.empty() || dt <= 0.0)
+    return false;
+  if (output.getGroup() != group_ || output.getRobotModel() != robot_model_)
+  {
+    RCLCPP_ERROR(getLogger(), "Cannot resample into a trajectory of a different group");
+    return false;
+  }
+
+  const std::vector<double>& durations_from_start = getWayPointDurationsFromStart();
+  const double duration = durations_from_start.back();
+  const std::size_t sample_count = static_cast<std::size_t>(std::ceil(duration / dt)) + 1;
+  output.resize(sample_count);
+  std::vector<double>& output_durations = output.getWayPointDurationsNonConst();
+
+  const bool with_velocities = waypoints_.front()->hasVelocities();
+  const bool with_accelerations = waypoints_.front()->hasAccelerations();
+  Eigen::Map<Eigen::MatrixXd> positions = output.getPositionsNonConst();
+  std::optional<Eigen::Map<Eigen::MatrixXd>> velocities;
+  std::optional<Eigen::Map<Eigen::MatrixXd>> accelerations;
+  if (with_velocities)
+    velocities.emplace(output.getVelocitiesNonConst());
+  if (with_accelerations)
+    accelerations.emplace(output.getAccelerationsNonConst());
+
+  const std::vector<const moveit::core::JointModel*>& joints =
+      group_ ? group_->getJointModels() : robot_model_->getJointModels();
+  std::vector<int> all_variables;
+  if (!group_)
+  {
+    all_variables.resize(robot_model_->getVariableCount());
+    std::iota(all_variables.begin(), all_variables.end(), 0);
+  }
+  const std::vector<int>& variables = group_ ? group_->getVariableIndexList() : all_variables;
+  std::vector<double> interpolated(robot_model_->getVariableCount());
+
+  // The sample times increase, so the enclosing waypoints are found by advancing a cursor
+  std::size_t after = 0;
+  double last_t = 0.0;
+  for (std::size_t sample = 0; sample < sample_count; ++sample)
+  {
+    // always sample the end of the trajectory as well
+    const double t = std::min(duration, sample * dt);
+    while (after + 1 < waypoints_.size() && durations_from_start[after] < t)
+      ++after;
+    const std::size_t before = after > 0 ? after - 1 : 0;
+    const double blend =
+        (after == before) ? 1.0 : (t - durations_from_start[before]) / duration_from_previous_[after];
+
+    const moveit::core::RobotState& from = *waypoints_[before];
+    const moveit::core::RobotState& to = *waypoints_[after];
+    for (const moveit::core::JointModel* joint : joints)
+    {
+      if (joint->getVariableCount() == 0)
+        continue;
+      const int first = joint->getFirstVariableIndex();
+      joint->interpolate(from.getVariablePositions() + first, to.getVariablePositions() + first, blend,
+                         interpolated.data() + first);
+    }
+    for (std::size_t i = 0; i < variables.size(); ++i)
+    {
+      const int variable = variables[i];
+      positions(i, sample) = interpolated[variable];
+      if (velocities)
+      {
+        (*velocities)(i, sample) =
+            from.getVariableVelocity(variable) +
+            blend * (to.getVariableVelocity(variable) - from.getVariableVelocity(variable));
+      }
+      if (accelerations)
+      {
+        (*accelerations)(i, sample) =
+            from.getVariableAcceleration(variable) +
+            blend * (to.getVariableAcceleration(variable) - from.getVariableAcceleration(variable));
+      }
+    }
+
+    output_durations[sample] = t - last_t;
+    last_t = t;
+  }
+  return true;
+}
+
 void RobotTrajectory::print(std::ostream& out, std::vector<int> variable_indexes) const
 {
   size_t num_points = getWayPointCount();
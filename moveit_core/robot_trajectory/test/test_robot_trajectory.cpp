@@ -37,6 +37,7 @@
 #include <moveit/robot_model/robot_model.hpp>
 #include <moveit/robot_state/robot_state.hpp>
 #include <moveit/robot_trajectory/robot_trajectory.hpp>
+#include <moveit/robot_trajectory/group_trajectory.hpp>
 #include <moveit/utils/robot_model_test_utils.hpp>
 #include <urdf_parser/urdf_parser.h>
 #include <gtest/gtest.h>
@@ -598,6 +599,157 @@ TEST_F(RobotTrajectoryTestFixture, RobotTrajectoryDensity)
   EXPECT_FALSE(density.has_value());
 }
 
+TEST_F(RobotTrajectoryTestFixture, GroupTrajectoryConversion)
+{
+  robot_trajectory::RobotTrajectoryPtr trajectory;
+  initTestTrajectory(trajectory);
+  const moveit::core::JointModelGroup* group = robot_model_->getJointModelGroup(arm_jmg_name_);
+  trajectory->getWayPointPtr(2)->setVariablePosition(0, 0.5);
+
+  robot_trajectory::GroupTrajectory group_trajectory(*trajectory);
+  ASSERT_EQ(group_trajectory.size(), trajectory->size());
+  EXPECT_EQ(group_trajectory.getVariableCount(), group->getVariableCount());
+  EXPECT_EQ(group_trajectory.getDuration(), trajectory->getDuration());
+  EXPECT_TRUE(group_trajectory.hasVelocities());
+  EXPECT_EQ(group_trajectory.getPositions()(0, 2), 0.5);
+  EXPECT_EQ(group_trajectory.getVelocities()(0, 0), 1.0);
+
+  // waypoints are only created on request
+  moveit::core::RobotState state(*robot_state_);
+  group_trajectory.getWayPoint(2, state);
+  EXPECT_EQ(state.getVariablePosition(0), 0.5);
+  EXPECT_EQ(group_trajectory.getWayPointPtr(1)->getVariablePosition(0), robot_state_->getVariablePosition(0));
+
+  // the messages of both representations agree
+  moveit_msgs::msg::RobotTrajectory expected_msg, msg;
+  trajectory->getRobotTrajectoryMsg(expected_msg);
+  group_trajectory.getRobotTrajectoryMsg(msg);
+  EXPECT_EQ(msg, expected_msg);
+
+  // the matrices can be edited directly
+  group_trajectory.getPositionsNonConst().row(0).setConstant(0.25);
+  group_trajectory.addSuffixWayPoint(Eigen::VectorXd::Zero(group->getVariableCount()), 0.2);
+  robot_trajectory::RobotTrajectory converted(robot_model_);
+  group_trajectory.getRobotTrajectory(converted);
+  ASSERT_EQ(converted.size(), trajectory->size() + 1);
+  EXPECT_EQ(converted.getGroup(), group);
+  EXPECT_EQ(converted.getWayPoint(3).getVariablePosition(0), 0.25);
+  EXPECT_EQ(converted.getLastWayPoint().getVariablePosition(0), 0.0);
+  EXPECT_DOUBLE_EQ(converted.getDuration(), trajectory->getDuration() + 0.2);
+}
+
+TEST_F(RobotTrajectoryTestFixture, MessageConversionReusesMessage)
+{
+  robot_trajectory::RobotTrajectoryPtr trajectory;
+  initTestTrajectory(trajectory);
+  for (std::size_t i = 0; i < trajectory->size(); ++i)
+  {
+    trajectory->getWayPointPtr(i)->setVariablePosition(0, 0.1 * i);
+    trajectory->getWayPointPtr(i)->setVariableVelocity(0, 1.0 + i);
+  }
+
+  moveit_msgs::msg::RobotTrajectory msg;
+  trajectory->getRobotTrajectoryMsg(msg);
+  ASSERT_EQ(msg.joint_trajectory.points.size(), trajectory->size());
+  const std::size_t num_joints = msg.joint_trajectory.joint_names.size();
+  EXPECT_EQ(msg.joint_trajectory.points[3].positions.size(), num_joints);
+  EXPECT_EQ(msg.joint_trajectory.points[3].velocities.size(), num_joints);
+  EXPECT_EQ(msg.joint_trajectory.points[3].positions[0], 0.3);
+  EXPECT_EQ(msg.joint_trajectory.points[3].velocities[0], 4.0);
+  EXPECT_NEAR(rclcpp::Duration(msg.joint_trajectory.points[3].time_from_start).seconds(), 0.4, 1e-9);
+
+  robot_trajectory::RobotTrajectory converted(robot_model_, arm_jmg_name_);
+  converted.setRobotTrajectoryMsg(*robot_state_, msg);
+  ASSERT_EQ(converted.size(), trajectory->size());
+  EXPECT_EQ(converted.getWayPoint(3).getVariablePosition(0), 0.3);
+  EXPECT_EQ(converted.getWayPoint(3).getVariableVelocity(0), 4.0);
+  EXPECT_NEAR(converted.getDuration(), trajectory->getDuration(), 1e-9);
+
+  // Converting a shorter trajectory without velocities into the same message leaves nothing of the previous one
+  trajectory->removeWayPoint(4);
+  for (std::size_t i = 0; i < trajectory->size(); ++i)
+    trajectory->getWayPointPtr(i)->zeroVelocities();
+  robot_trajectory::RobotTrajectory no_velocities(robot_model_, arm_jmg_name_);
+  for (std::size_t i = 0; i < trajectory->size(); ++i)
+  {
+    moveit::core::RobotState state(robot_model_);
+    state.setVariablePositions(trajectory->getWayPoint(i).getVariablePositions());
+    no_velocities.addSuffixWayPoint(state, 0.1);
+  }
+  no_velocities.getRobotTrajectoryMsg(msg);
+  ASSERT_EQ(msg.joint_trajectory.points.size(), 4u);
+  EXPECT_TRUE(msg.joint_trajectory.points[3].velocities.empty());
+  EXPECT_EQ(msg.joint_trajectory.points[3].positions[0], 0.3);
+}
+
+TEST_F(RobotTrajectoryTestFixture, LookupByTime)
+{
+  robot_trajectory::RobotTrajectoryPtr trajectory;
+  initTestTrajectory(trajectory);
+  for (std::size_t i = 0; i < trajectory->size(); ++i)
+    trajectory->getWayPointPtr(i)->setVariablePosition(0, 0.1 * i);
+
+  int before, after;
+  double blend;
+  trajectory->findWayPointIndicesForDurationAfterStart(0.25, before, after, blend);
+  EXPECT_EQ(before, 1);
+  EXPECT_EQ(after, 2);
+  EXPECT_NEAR(blend, 0.5, 1e-9);
+  trajectory->findWayPointIndicesForDurationAfterStart(10.0, before, after, blend);
+  EXPECT_EQ(before, 4);
+  EXPECT_EQ(after, 4);
+  EXPECT_EQ(blend, 1.0);
+
+  // The cached durations from start follow modifications
+  EXPECT_NEAR(trajectory->getWayPointDurationFromStart(2), 0.3, 1e-9);
+  trajectory->setWayPointDurationFromPrevious(1, 0.5);
+  EXPECT_NEAR(trajectory->getWayPointDurationFromStart(2), 0.7, 1e-9);
+  EXPECT_NEAR(trajectory->getDuration(), 0.9, 1e-9);
+  trajectory->removeWayPoint(0);
+  EXPECT_NEAR(trajectory->getWayPointDurationFromStart(0), 0.5, 1e-9);
+  ASSERT_EQ(trajectory->getWayPointDurationsFromStart().size(), trajectory->size());
+
+  auto state = std::make_shared<moveit::core::RobotState>(robot_model_);
+  ASSERT_TRUE(trajectory->getStateAtDurationFromStart(0.55, state));
+  EXPECT_NEAR(state->getVariablePosition(0), 0.15, 1e-9);
+}
+
+TEST_F(RobotTrajectoryTestFixture, Resample)
+{
+  robot_trajectory::RobotTrajectoryPtr trajectory;
+  initTestTrajectory(trajectory);
+  for (std::size_t i = 0; i < trajectory->size(); ++i)
+  {
+    trajectory->getWayPointPtr(i)->setVariablePosition(0, 0.1 * i);
+    trajectory->getWayPointPtr(i)->setVariableVelocity(0, 1.0 + i);
+  }
+
+  robot_trajectory::GroupTrajectory samples(*robot_state_, trajectory->getGroup());
+  ASSERT_TRUE(trajectory->resample(0.03, samples));
+  // 0.5 s with one sample every 0.03 s and one at the end
+  ASSERT_EQ(samples.size(), 18u);
+  EXPECT_NEAR(samples.getDuration(), trajectory->getDuration(), 1e-9);
+  EXPECT_NEAR(samples.getWayPointDurations().back(), 0.02, 1e-9);
+  ASSERT_TRUE(samples.hasVelocities());
+
+  auto state = std::make_shared<moveit::core::RobotState>(robot_model_);
+  for (std::size_t i = 0; i < samples.size(); ++i)
+  {
+    ASSERT_TRUE(trajectory->getStateAtDurationFromStart(samples.getWayPointDurationFromStart(i), state));
+    EXPECT_NEAR(samples.getPositions()(0, i), state->getVariablePosition(0), 1e-9) << "sample " << i;
+  }
+  EXPECT_NEAR(samples.getVelocities()(0, 0), 1.0, 1e-9);
+  EXPECT_NEAR(samples.getVelocities()(0, 17), 5.0, 1e-9);
+
+  // The buffers are reused for fewer samples
+  ASSERT_TRUE(trajectory->resample(0.25, samples));
+  EXPECT_EQ(samples.size(), 3u);
+  EXPECT_FALSE(trajectory->resample(0.0, samples));
+
+  robot_trajectory::GroupTrajectory other_group(*robot_state_, nullptr);
+  EXPECT_FALSE(trajectory->resample(0.1, other_group));
+}
+
 TEST_F(OneRobot, Unwind)
 {
   const double epsilon = 1e-4;
@@ -92,6 +92,43 @@ public:
                              const double max_velocity_scaling_factor = 1.0,
                              const double max_acceleration_scaling_factor = 1.0);
 
+  /**
+   * \brief Re-smooth only the suffix of a trajectory whose prefix is already being executed.
+   * The waypoint at \e start_index is replaced by the current kinematic state of the group in \e start_state and the
+   * waypoints before it are left untouched. Smoothing resumes from that waypoint, so the cost only depends on the
+   * length of the changed suffix.
+   * \param[in,out] trajectory A time-parameterized path whose suffix needs smoothing.
+   * \param start_index Index of the waypoint to resume from
+   * \param start_state Positions, velocities and accelerations of the group at \e start_index
+   * \param max_velocity_scaling_factor A factor in the range [0,1] which can slow down the trajectory.
+   * \param max_acceleration_scaling_factor A factor in the range [0,1] which can slow down the trajectory.
+   * \param mitigate_overshoot If true, overshoot is mitigated by extending trajectory duration.
+   * \param overshoot_threshold If an overshoot is greater than this, duration is extended (radians, for a single joint)
+   * \return true if successful.
+   */
+  static bool applySmoothingFromWayPoint(robot_trajectory::RobotTrajectory& trajectory, const size_t start_index,
+                                         const moveit::core::RobotState& start_state,
+                                         const double max_velocity_scaling_factor = 1.0,
+                                         const double max_acceleration_scaling_factor = 1.0,
+                                         const bool mitigate_overshoot = false,
+                                         const double overshoot_threshold = 0.01);
+
+  /**
+   * \brief Apply smoothing to several time-parameterized trajectories concurrently, see applySmoothing().
+   * \param[in,out] trajectories Paths which need smoothing.
+   * \param max_velocity_scaling_factor A factor in the range [0,1] which can slow down the trajectories.
+   * \param max_acceleration_scaling_factor A factor in the range [0,1] which can slow down the trajectories.
+   * \param mitigate_overshoot If true, overshoot is mitigated by extending trajectory duration.
+   * \param overshoot_threshold If an overshoot is greater than this, duration is extended (radians, for a single joint)
+   * \param thread_count The maximum number of threads to use, 0 for one per hardware thread
+   * \return For each trajectory, whether it was smoothed successfully.
+   */
+  static std::vector<bool> applySmoothingBatch(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                               const double max_velocity_scaling_factor = 1.0,
+                                               const double max_acceleration_scaling_factor = 1.0,
+                                               const bool mitigate_overshoot = false,
+                                               const double overshoot_threshold = 0.01, std::size_t thread_count = 0);
+
 private:
   /**
    * \brief A utility function to check if the group is defined.
@@ -139,10 +176,12 @@ private:
    * \param[in, out] ruckig_input    Necessary input for Ruckig smoothing. Contains kinematic limits (vel, accel, jerk)
    * \param mitigate_overshoot If true, overshoot is mitigated by extending trajectory duration.
    * \param overshoot_threshold If an overshoot is greater than this, duration is extended (radians, for a single joint)
+   * \param start_index Waypoints before this index are not modified
    */
   [[nodiscard]] static bool runRuckig(robot_trajectory::RobotTrajectory& trajectory,
                                       ruckig::InputParameter<ruckig::DynamicDOFs>& ruckig_input,
-                                      const bool mitigate_overshoot = false, const double overshoot_threshold = 0.01);
+                                      const bool mitigate_overshoot = false, const double overshoot_threshold = 0.01,
+                                      const size_t start_index = 0);
 
   /**
    * \brief Extend the duration of every trajectory segment
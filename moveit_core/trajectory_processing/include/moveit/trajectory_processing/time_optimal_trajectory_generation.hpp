@@ -40,6 +40,7 @@
 
 #include <Eigen/Core>
 #include <list>
+#include <vector>
 #include <moveit/robot_trajectory/robot_trajectory.hpp>
 #include <moveit/trajectory_processing/time_parameterization.hpp>
 
@@ -107,18 +108,21 @@ public:
    **/
   double getNextSwitchingPoint(double s, bool& discontinuity) const;
 
-  /// @brief Return a list of all switching points as a pair (arc length to switching point, discontinuity)
-  std::list<std::pair<double, bool>> getSwitchingPoints() const;
+  /// @brief Return all switching points as pairs (arc length to switching point, discontinuity), sorted by arc length
+  const std::vector<std::pair<double, bool>>& getSwitchingPoints() const;
 
 private:
   // Default constructor private to prevent misuse. Use `create` instead to create a Path object.
   Path() = default;
 
+  // Find the segment containing arc length s and make s relative to its start.
+  // Lookups mostly move monotonically along the path, so they start from the segment of the previous lookup.
   PathSegment* getPathSegment(double& s) const;
 
   double length_ = 0.0;
-  std::list<std::pair<double, bool>> switching_points_;
-  std::list<std::unique_ptr<PathSegment>> path_segments_;
+  std::vector<std::pair<double, bool>> switching_points_;
+  std::vector<std::unique_ptr<PathSegment>> path_segments_;
+  mutable std::size_t cached_path_segment_ = 0;
 };
 
 class Trajectory
@@ -255,6 +259,23 @@ public:
                          const double max_velocity_scaling_factor = 1.0,
                          const double max_acceleration_scaling_factor = 1.0) const override;
 
+protected:
+  /**
+   * \brief Time-parameterize the blended path through the waypoints of a trajectory and resample it
+   * \param path The path to parameterize, with one dimension per variable of the trajectory's group
+   * \param max_velocity Velocity limits of the group's variables, already scaled
+   * \param max_acceleration Acceleration limits of the group's variables, already scaled
+   * \param[in,out] trajectory Its waypoints are replaced by samples spaced resample_dt_ apart in time
+   * \return false if the path could not be parameterized
+   */
+  virtual bool parameterizePath(const Path& path, const Eigen::VectorXd& max_velocity,
+                                const Eigen::VectorXd& max_acceleration,
+                                robot_trajectory::RobotTrajectory& trajectory) const;
+
+  const double path_tolerance_;
+  const double resample_dt_;
+  const double min_angle_change_;
+
 private:
   bool doTimeParameterizationCalculations(robot_trajectory::RobotTrajectory& trajectory,
                                           const Eigen::VectorXd& max_velocity,
@@ -274,10 +295,6 @@ private:
    * \return The user requested scaling factor, if it is valid. Otherwise, return 1.0.
    */
   double verifyScalingFactor(const double requested_scaling_factor, const LimitType limit_type) const;
-
-  const double path_tolerance_;
-  const double resample_dt_;
-  const double min_angle_change_;
 };
 
 // clang-format off
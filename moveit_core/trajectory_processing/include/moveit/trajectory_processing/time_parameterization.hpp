@@ -1,9 +1,22 @@
 #pragma once
 
 #include <moveit/robot_trajectory/robot_trajectory.hpp>
+#include <functional>
+#include <vector>
 
 namespace trajectory_processing
 {
+/**
+ * \brief Process several trajectories concurrently
+ * \param[in,out] trajectories The trajectories to process, null pointers fail
+ * \param process Function processing one trajectory, called concurrently for different trajectories
+ * \param thread_count The maximum number of threads to use, 0 for one per hardware thread
+ * \return For each trajectory, the result of \e process
+ */
+std::vector<bool> processTrajectoryBatch(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                         const std::function<bool(robot_trajectory::RobotTrajectory&)>& process,
+                                         std::size_t thread_count = 0);
+
 /**
  * @brief Base class for trajectory parameterization algorithms
  */
@@ -56,5 +69,27 @@ public:
                                  const std::vector<moveit_msgs::msg::JointLimits>& joint_limits,
                                  const double max_velocity_scaling_factor = 1.0,
                                  const double max_acceleration_scaling_factor = 1.0) const = 0;
+
+  /**
+   * \brief Compute the time stamps of several trajectories concurrently, e.g. of candidate solutions of different
+   * planners. The trajectories are processed by computeTimeStamps(), which must therefore not modify the instance.
+   * \param[in,out] trajectories Paths which need time-parameterization
+   * \param max_velocity_scaling_factor A factor in the range [0,1] which can slow down the trajectories.
+   * \param max_acceleration_scaling_factor A factor in the range [0,1] which can slow down the trajectories.
+   * \param thread_count The maximum number of threads to use, 0 for one per hardware thread
+   * \return For each trajectory, whether it was time-parameterized successfully
+   */
+  std::vector<bool> computeTimeStampsBatch(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                           const double max_velocity_scaling_factor = 1.0,
+                                           const double max_acceleration_scaling_factor = 1.0,
+                                           std::size_t thread_count = 0) const
+  {
+    return processTrajectoryBatch(
+        trajectories,
+        [&](robot_trajectory::RobotTrajectory& trajectory) {
+          return computeTimeStamps(trajectory, max_velocity_scaling_factor, max_acceleration_scaling_factor);
+        },
+        thread_count);
+  }
 };
 }  // namespace trajectory_processing
@@ -0,0 +1,98 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/dynamics_solver/dynamics_solver.hpp>
+#include <moveit/trajectory_processing/time_optimal_trajectory_generation.hpp>
+#include <vector>
+
+namespace trajectory_processing
+{
+// Spacing of the path samples at which the dynamics are evaluated, in the units of the path (rad or m)
+constexpr double DEFAULT_DYNAMICS_GRID_STEP = 0.01;
+
+MOVEIT_CLASS_FORWARD(TorqueLimitedTimeParameterization);
+
+/**
+ * \brief Time-optimal parameterization that enforces joint effort limits in addition to velocity and acceleration
+ * limits. The waypoints are blended into a differentiable path as in TimeOptimalTrajectoryGeneration. Along this path
+ * the joint torques are an affine function of the path acceleration and the squared path velocity,
+ *   tau = a(s) * s'' + b(s) * s'^2 + c(s),
+ * whose coefficients are obtained from three batched inverse dynamics evaluations per path sample. They are computed
+ * once per sample and then reused by a backward pass computing the reachable path velocities and a greedy forward pass
+ * choosing the maximum feasible path acceleration (reachability analysis, as in TOPP-RA).
+ * The limits are enforced at the path samples; \e grid_step controls their spacing.
+ * The trajectory's group must be the group of the dynamics solver. As the dynamics solver is not thread-safe, neither
+ * is this class.
+ */
+class TorqueLimitedTimeParameterization : public TimeOptimalTrajectoryGeneration
+{
+public:
+  /**
+   * \brief Constructor
+   * \param dynamics_solver Inverse dynamics of the group to parameterize, its effort limits are used by default
+   * \param path_tolerance Maximum deviation from the intermediate waypoints, see TimeOptimalTrajectoryGeneration
+   * \param resample_dt Time between the waypoints of the resulting trajectory
+   * \param min_angle_change Waypoints closer than this to their predecessor are dropped
+   * \param grid_step Distance along the path between the samples at which the dynamics are evaluated
+   */
+  TorqueLimitedTimeParameterization(const dynamics_solver::DynamicsSolverConstPtr& dynamics_solver,
+                                    const double path_tolerance = DEFAULT_PATH_TOLERANCE,
+                                    const double resample_dt = 0.1, const double min_angle_change = 0.001,
+                                    const double grid_step = DEFAULT_DYNAMICS_GRID_STEP);
+
+  /**
+   * \brief Override the effort limits of the dynamics solver
+   * \param effort_limits One limit in Nm or N per variable of the group, non-positive values disable the limit
+   * \return false if the number of limits does not match the group
+   */
+  bool setEffortLimits(const std::vector<double>& effort_limits);
+
+  /** \brief Effort limits per variable of the group, non-positive values are not enforced */
+  const std::vector<double>& getEffortLimits() const
+  {
+    return effort_limits_;
+  }
+
+protected:
+  bool parameterizePath(const Path& path, const Eigen::VectorXd& max_velocity, const Eigen::VectorXd& max_acceleration,
+                        robot_trajectory::RobotTrajectory& trajectory) const override;
+
+private:
+  dynamics_solver::DynamicsSolverConstPtr dynamics_solver_;
+  std::vector<double> effort_limits_;
+  const double grid_step_;
+};
+}  // namespace trajectory_processing
@@ -40,6 +40,7 @@
 #include <Eigen/Geometry>
 #include <limits>
 #include <moveit/trajectory_processing/ruckig_traj_smoothing.hpp>
+#include <moveit/trajectory_processing/time_parameterization.hpp>
 #include <vector>
 #include <moveit/utils/logger.hpp>
 
@@ -92,6 +93,67 @@ bool RuckigSmoothing::applySmoothing(robot_trajectory::RobotTrajectory& trajecto
   return runRuckig(trajectory, ruckig_input, mitigate_overshoot, overshoot_threshold);
 }
 
+bool RuckigSmoothing::applySmoothingFromWayPoint(robot_trajectory::RobotTrajectory& trajectory,
+                                                 const size_t start_index, const moveit::core::RobotState& start_state,
+                                                 const double max_velocity_scaling_factor,
+                                                 const double max_acceleration_scaling_factor,
+                                                 const bool mitigate_overshoot, const double overshoot_threshold)
+{
+  if (!validateGroup(trajectory))
+  {
+    return false;
+  }
+
+  const size_t num_waypoints = trajectory.getWayPointCount();
+  if (start_index >= num_waypoints)
+  {
+    RCLCPP_ERROR_STREAM(getLogger(), "Cannot resume smoothing from waypoint " << start_index << " of a trajectory with "
+                                                                              << num_waypoints << " waypoints.");
+    return false;
+  }
+
+  // Continue from the actual state of the group instead of the nominal waypoint
+  const moveit::core::JointModelGroup* const group = trajectory.getGroup();
+  const moveit::core::RobotStatePtr& resume_waypoint = trajectory.getWayPointPtr(start_index);
+  std::vector<double> values;
+  start_state.copyJointGroupPositions(group, values);
+  resume_waypoint->setJointGroupPositions(group, values);
+  start_state.copyJointGroupVelocities(group, values);
+  resume_waypoint->setJointGroupVelocities(group, values);
+  start_state.copyJointGroupAccelerations(group, values);
+  resume_waypoint->setJointGroupAccelerations(group, values);
+
+  if (num_waypoints - start_index < 2)
+  {
+    return true;
+  }
+
+  const size_t num_dof = group->getVariableCount();
+  ruckig::InputParameter<ruckig::DynamicDOFs> ruckig_input{ num_dof };
+  if (!getRobotModelBounds(max_velocity_scaling_factor, max_acceleration_scaling_factor, group, ruckig_input))
+  {
+    RCLCPP_ERROR(getLogger(), "Error while retrieving kinematic limits (vel/accel/jerk) from RobotModel.");
+    return false;
+  }
+
+  return runRuckig(trajectory, ruckig_input, mitigate_overshoot, overshoot_threshold, start_index);
+}
+
+std::vector<bool>
+RuckigSmoothing::applySmoothingBatch(const std::vector<robot_trajectory::RobotTrajectoryPtr>& trajectories,
+                                     const double max_velocity_scaling_factor,
+                                     const double max_acceleration_scaling_factor, const bool mitigate_overshoot,
+                                     const double overshoot_threshold, std::size_t thread_count)
+{
+  return processTrajectoryBatch(
+      trajectories,
+      [&](robot_trajectory::RobotTrajectory& trajectory) {
+        return applySmoothing(trajectory, max_velocity_scaling_factor, max_acceleration_scaling_factor,
+                              mitigate_overshoot, overshoot_threshold);
+      },
+      thread_count);
+}
+
 bool RuckigSmoothing::applySmoothing(robot_trajectory::RobotTrajectory& trajectory,
                                      const std::unordered_map<std::string, double>& velocity_limits,
                                      const std::unordered_map<std::string, double>& acceleration_limits,
@@ -246,7 +308,8 @@ bool RuckigSmoothing::getRobotModelBounds(const double max_velocity_scaling_fact
 
 bool RuckigSmoothing::runRuckig(robot_trajectory::RobotTrajectory& trajectory,
                                 ruckig::InputParameter<ruckig::DynamicDOFs>& ruckig_input,
-                                const bool mitigate_overshoot, const double overshoot_threshold)
+                                const bool mitigate_overshoot, const double overshoot_threshold,
+                                const size_t start_index)
 {
   const size_t num_waypoints = trajectory.getWayPointCount();
   const moveit::core::JointModelGroup* const group = trajectory.getGroup();
@@ -258,7 +321,7 @@ bool RuckigSmoothing::runRuckig(robot_trajectory::RobotTrajectory& trajectory,
 
   // Initialize the smoother
   ruckig::Ruckig<ruckig::DynamicDOFs> ruckig(num_dof, trajectory.getAverageSegmentDuration());
-  initializeRuckigState(*trajectory.getFirstWayPointPtr(), group, ruckig_input);
+  initializeRuckigState(*trajectory.getWayPointPtr(start_index), group, ruckig_input);
 
   // Cache the trajectory in case we need to reset it
   robot_trajectory::RobotTrajectory original_trajectory =
@@ -267,7 +330,7 @@ bool RuckigSmoothing::runRuckig(robot_trajectory::RobotTrajectory& trajectory,
   ruckig::Result ruckig_result;
   double duration_extension_factor = 1;
   bool smoothing_complete = false;
-  size_t waypoint_idx = 0;
+  size_t waypoint_idx = start_index;
   while ((duration_extension_factor <= MAX_DURATION_EXTENSION_FACTOR) && !smoothing_complete)
   {
     while (waypoint_idx < num_waypoints - 1)
@@ -312,7 +375,7 @@ bool RuckigSmoothing::runRuckig(robot_trajectory::RobotTrajectory& trajectory,
         extendTrajectoryDuration(duration_extension_factor, waypoint_idx, num_dof, move_group_idx, original_trajectory,
                                  trajectory);
 
-        initializeRuckigState(*trajectory.getFirstWayPointPtr(), group, ruckig_input);
+        initializeRuckigState(*trajectory.getWayPointPtr(start_index), group, ruckig_input);
         // Begin the for() loop again
         break;
       }
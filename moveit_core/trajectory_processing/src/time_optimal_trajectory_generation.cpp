@@ -45,6 +45,7 @@
 #include <moveit/trajectory_processing/time_optimal_trajectory_generation.hpp>
 #include <vector>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
 
 namespace trajectory_processing
 {
@@ -304,16 +305,33 @@ double Path::getLength() const
 
 PathSegment* Path::getPathSegment(double& s) const
 {
-  std::list<std::unique_ptr<PathSegment>>::const_iterator it = path_segments_.begin();
-  std::list<std::unique_ptr<PathSegment>>::const_iterator next = it;
-  ++next;
-  while (next != path_segments_.end() && s >= (*next)->position_)
+  // segment i contains s if it is the last segment starting at or before s (or the first segment)
+  const std::size_t count = path_segments_.size();
+  const auto contains = [this, count, s](std::size_t i) {
+    return (i == 0 || s >= path_segments_[i]->position_) && (i + 1 == count || s < path_segments_[i + 1]->position_);
+  };
+
+  std::size_t index = std::min(cached_path_segment_, count - 1);
+  if (!contains(index))
   {
-    it = next;
-    ++next;
+    if (index + 1 < count && contains(index + 1))
+    {
+      ++index;
+    }
+    else
+    {
+      const auto next = std::upper_bound(path_segments_.begin() + 1, path_segments_.end(), s,
+                                         [](double position, const std::unique_ptr<PathSegment>& path_segment) {
+                                           return position < path_segment->position_;
+                                         });
+      index = (next - path_segments_.begin()) - 1;
+    }
   }
-  s -= (*it)->position_;
-  return (*it).get();
+  cached_path_segment_ = index;
+
+  PathSegment* path_segment = path_segments_[index].get();
+  s -= path_segment->position_;
+  return path_segment;
 }
 
 Eigen::VectorXd Path::getConfig(double s) const
@@ -336,11 +354,10 @@ Eigen::VectorXd Path::getCurvature(double s) const
 
 double Path::getNextSwitchingPoint(double s, bool& discontinuity) const
 {
-  std::list<std::pair<double, bool>>::const_iterator it = switching_points_.begin();
-  while (it != switching_points_.end() && it->first <= s)
-  {
-    ++it;
-  }
+  const auto it = std::upper_bound(switching_points_.begin(), switching_points_.end(), s,
+                                   [](double position, const std::pair<double, bool>& point) {
+                                     return position < point.first;
+                                   });
   if (it == switching_points_.end())
   {
     discontinuity = true;
@@ -350,7 +367,7 @@ double Path::getNextSwitchingPoint(double s, bool& discontinuity) const
   return it->first;
 }
 
-std::list<std::pair<double, bool>> Path::getSwitchingPoints() const
+const std::vector<std::pair<double, bool>>& Path::getSwitchingPoints() const
 {
   return switching_points_;
 }
@@ -566,8 +583,10 @@ bool Trajectory::integrateForward(std::list<TrajectoryStep>& trajectory, double
   double path_pos = trajectory.back().path_pos_;
   double path_vel = trajectory.back().path_vel_;
 
-  std::list<std::pair<double, bool>> switching_points = path_.getSwitchingPoints();
-  std::list<std::pair<double, bool>>::iterator next_discontinuity = switching_points.begin();
+  const std::vector<std::pair<double, bool>>& switching_points = path_.getSwitchingPoints();
+  auto next_discontinuity =
+      std::upper_bound(switching_points.begin(), switching_points.end(), path_pos,
+                       [](double position, const std::pair<double, bool>& point) { return position < point.first; });
 
   while (true)
   {
@@ -927,6 +946,7 @@ bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotT
 {
   if (trajectory.empty())
     return true;
+  MOVEIT_TRACEPOINT_SCOPE("trajectory_processing.totg");
 
   const moveit::core::JointModelGroup* group = trajectory.getGroup();
   if (!group)
@@ -1234,13 +1254,23 @@ bool TimeOptimalTrajectoryGeneration::doTimeParameterizationCalculations(robot_t
     return false;
   }
 
-  std::optional<Trajectory> parameterized = Trajectory::create(*path, max_velocity, max_acceleration, DEFAULT_TIMESTEP);
+  return parameterizePath(*path, max_velocity, max_acceleration, trajectory);
+}
+
+bool TimeOptimalTrajectoryGeneration::parameterizePath(const Path& path, const Eigen::VectorXd& max_velocity,
+                                                       const Eigen::VectorXd& max_acceleration,
+                                                       robot_trajectory::RobotTrajectory& trajectory) const
+{
+  std::optional<Trajectory> parameterized = Trajectory::create(path, max_velocity, max_acceleration, DEFAULT_TIMESTEP);
   if (!parameterized)
   {
     RCLCPP_ERROR(getLogger(), "Couldn't create trajectory");
     return false;
   }
 
+  const std::vector<int>& idx = trajectory.getGroup()->getVariableIndexList();
+  const unsigned num_joints = trajectory.getGroup()->getVariableCount();
+
   // Compute sample count
   const size_t sample_count = std::ceil(parameterized->getDuration() / resample_dt_);
 
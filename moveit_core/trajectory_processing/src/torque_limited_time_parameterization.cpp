@@ -0,0 +1,334 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <moveit/trajectory_processing/torque_limited_time_parameterization.hpp>
+#include <moveit/utils/logger.hpp>
+
+namespace trajectory_processing
+{
+namespace
+{
+// Coefficients below this are treated as zero, and constraints may be violated by this much due to rounding
+constexpr double EPSILON = 1e-9;
+// Path accelerations by which the bounds of the feasible range may cross due to rounding
+constexpr double ACCELERATION_TOLERANCE = 1e-6;
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.core.torque_limited_time_parameterization");
+}
+
+// Linear constraint u * sdd + x * sd^2 <= bound on the path acceleration sdd and the squared path velocity sd^2
+struct PathConstraint
+{
+  double u;
+  double x;
+  double bound;
+};
+
+// Restrict [x_min, x_max] to the values satisfying coefficient * x <= bound
+void restrictInterval(const double coefficient, const double bound, double& x_min, double& x_max)
+{
+  if (coefficient > EPSILON)
+  {
+    x_max = std::min(x_max, bound / coefficient);
+  }
+  else if (coefficient < -EPSILON)
+  {
+    x_min = std::max(x_min, bound / coefficient);
+  }
+  else if (bound < -EPSILON)
+  {
+    x_min = INF;
+    x_max = -INF;
+  }
+}
+
+// Range of squared path velocities for which some path acceleration satisfies all constraints. The path acceleration
+// is eliminated by requiring every lower bound on it to be below every upper bound.
+void computeFeasibleSquaredVelocities(const std::vector<PathConstraint>& constraints, double& x_min, double& x_max)
+{
+  x_min = 0.0;
+  x_max = INF;
+  for (const PathConstraint& upper : constraints)
+  {
+    if (upper.u > EPSILON)
+    {
+      for (const PathConstraint& lower : constraints)
+      {
+        if (lower.u < -EPSILON)
+        {
+          restrictInterval(lower.x * upper.u - upper.x * lower.u, lower.bound * upper.u - upper.bound * lower.u, x_min,
+                           x_max);
+        }
+      }
+    }
+    else if (upper.u >= -EPSILON)
+    {
+      restrictInterval(upper.x, upper.bound, x_min, x_max);
+    }
+  }
+}
+
+// Range of path accelerations satisfying all constraints at the squared path velocity x
+void computeFeasibleAccelerations(const std::vector<PathConstraint>& constraints, const double x, double& u_min,
+                                  double& u_max)
+{
+  u_min = -INF;
+  u_max = INF;
+  for (const PathConstraint& constraint : constraints)
+  {
+    if (constraint.u > EPSILON)
+    {
+      u_max = std::min(u_max, (constraint.bound - constraint.x * x) / constraint.u);
+    }
+    else if (constraint.u < -EPSILON)
+    {
+      u_min = std::max(u_min, (constraint.bound - constraint.x * x) / constraint.u);
+    }
+  }
+}
+}  // namespace
+
+TorqueLimitedTimeParameterization::TorqueLimitedTimeParameterization(
+    const dynamics_solver::DynamicsSolverConstPtr& dynamics_solver, const double path_tolerance,
+    const double resample_dt, const double min_angle_change, const double grid_step)
+  : TimeOptimalTrajectoryGeneration(path_tolerance, resample_dt, min_angle_change)
+  , dynamics_solver_(dynamics_solver)
+  , grid_step_(grid_step)
+{
+  const moveit::core::JointModelGroup* group = dynamics_solver_->getGroup();
+  if (!group)
+  {
+    return;
+  }
+
+  // The dynamics solver reports one limit per joint of the group, including fixed joints
+  const std::vector<const moveit::core::JointModel*>& joint_models = group->getJointModels();
+  const std::vector<double>& max_torques = dynamics_solver_->getMaxTorques();
+  for (size_t i = 0; i < joint_models.size() && i < max_torques.size(); ++i)
+  {
+    if (joint_models[i]->getVariableCount() == 1)
+    {
+      effort_limits_.push_back(max_torques[i]);
+    }
+  }
+}
+
+bool TorqueLimitedTimeParameterization::setEffortLimits(const std::vector<double>& effort_limits)
+{
+  const moveit::core::JointModelGroup* group = dynamics_solver_->getGroup();
+  if (!group || effort_limits.size() != group->getVariableCount())
+  {
+    RCLCPP_ERROR(getLogger(), "Expected one effort limit per variable of the dynamics solver's group");
+    return false;
+  }
+  effort_limits_ = effort_limits;
+  return true;
+}
+
+bool TorqueLimitedTimeParameterization::parameterizePath(const Path& path, const Eigen::VectorXd& max_velocity,
+                                                         const Eigen::VectorXd& max_acceleration,
+                                                         robot_trajectory::RobotTrajectory& trajectory) const
+{
+  const moveit::core::JointModelGroup* group = trajectory.getGroup();
+  if (group != dynamics_solver_->getGroup())
+  {
+    RCLCPP_ERROR(getLogger(), "The trajectory's group '%s' is not the group of the dynamics solver",
+                 group->getName().c_str());
+    return false;
+  }
+  const Eigen::Index num_joints = max_velocity.size();
+  if (effort_limits_.size() != static_cast<size_t>(num_joints))
+  {
+    RCLCPP_ERROR(getLogger(), "Expected %ld effort limits, got %zu", static_cast<long>(num_joints),
+                 effort_limits_.size());
+    return false;
+  }
+  if (grid_step_ <= 0.0)
+  {
+    RCLCPP_ERROR(getLogger(), "Invalid grid step %f, must be greater than 0.0", grid_step_);
+    return false;
+  }
+
+  // Sample the path and its derivatives with respect to the arc length s
+  const size_t num_steps = std::max<size_t>(1, static_cast<size_t>(std::ceil(path.getLength() / grid_step_)));
+  const double ds = path.getLength() / num_steps;
+  Eigen::MatrixXd positions(num_joints, num_steps + 1);
+  Eigen::MatrixXd tangents(num_joints, num_steps + 1);
+  Eigen::MatrixXd curvatures(num_joints, num_steps + 1);
+  for (size_t i = 0; i <= num_steps; ++i)
+  {
+    const double s = std::min(i * ds, path.getLength());
+    positions.col(i) = path.getConfig(s);
+    tangents.col(i) = path.getTangent(s);
+    curvatures.col(i) = path.getCurvature(s);
+  }
+
+  // With q' = q_s * sd and q'' = q_s * sdd + q_ss * sd^2, the inverse dynamics along the path are
+  // tau = a * sdd + b * sd^2 + c with a = M * q_s, b = M * q_ss + C(q_s) * q_s and c = g.
+  const Eigen::MatrixXd zeros = Eigen::MatrixXd::Zero(num_joints, num_steps + 1);
+  // a workspace of our own, so that trajectories can be parameterized concurrently
+  const dynamics_solver::DynamicsSolver::WorkspacePtr workspace = dynamics_solver_->createWorkspace();
+  Eigen::MatrixXd a, b, c;
+  if (!workspace || !dynamics_solver_->getTorques(positions, zeros, zeros, c, *workspace) ||
+      !dynamics_solver_->getTorques(positions, zeros, tangents, a, *workspace) ||
+      !dynamics_solver_->getTorques(positions, tangents, curvatures, b, *workspace))
+  {
+    RCLCPP_ERROR(getLogger(), "Failed to evaluate the inverse dynamics along the path");
+    return false;
+  }
+  a -= c;
+  b -= c;
+
+  // Constraints at sample i, except for those connecting it to the next sample
+  std::vector<PathConstraint> constraints;
+  const auto set_sample_constraints = [&](const size_t i) {
+    constraints.clear();
+    constraints.push_back({ 0.0, -1.0, 0.0 });
+    for (Eigen::Index j = 0; j < num_joints; ++j)
+    {
+      const double tangent = tangents(j, i);
+      if (std::fabs(tangent) > EPSILON)
+      {
+        constraints.push_back({ 0.0, 1.0, std::pow(max_velocity[j] / tangent, 2) });
+      }
+      constraints.push_back({ tangent, curvatures(j, i), max_acceleration[j] });
+      constraints.push_back({ -tangent, -curvatures(j, i), max_acceleration[j] });
+      if (effort_limits_[j] > 0.0)
+      {
+        constraints.push_back({ a(j, i), b(j, i), effort_limits_[j] - c(j, i) });
+        constraints.push_back({ -a(j, i), -b(j, i), effort_limits_[j] + c(j, i) });
+      }
+    }
+  };
+
+  // Backward pass: the squared path velocities at each sample from which the end of the path can be reached at rest.
+  // Consecutive samples are connected by a constant path acceleration, sd^2[i + 1] = sd^2[i] + 2 * ds * sdd[i].
+  std::vector<double> reachable_min(num_steps + 1, 0.0);
+  std::vector<double> reachable_max(num_steps + 1, 0.0);
+  for (size_t i = num_steps; i-- > 0;)
+  {
+    set_sample_constraints(i);
+    constraints.push_back({ 2.0 * ds, 1.0, reachable_max[i + 1] });
+    constraints.push_back({ -2.0 * ds, -1.0, -reachable_min[i + 1] });
+    computeFeasibleSquaredVelocities(constraints, reachable_min[i], reachable_max[i]);
+    if (reachable_min[i] > reachable_max[i] + EPSILON)
+    {
+      RCLCPP_ERROR(getLogger(), "The path cannot be followed within the joint limits (at s = %f of %f)", i * ds,
+                   path.getLength());
+      return false;
+    }
+    reachable_max[i] = std::max(reachable_min[i], reachable_max[i]);
+  }
+  if (reachable_min[0] > EPSILON)
+  {
+    RCLCPP_ERROR(getLogger(), "The path cannot be followed within the joint limits when starting at rest");
+    return false;
+  }
+
+  // Forward pass: greedily pick the largest path acceleration that keeps the end reachable
+  std::vector<double> squared_velocities(num_steps + 1, 0.0);
+  std::vector<double> path_accelerations(num_steps, 0.0);
+  std::vector<double> times(num_steps + 1, 0.0);
+  for (size_t i = 0; i < num_steps; ++i)
+  {
+    const double x = squared_velocities[i];
+    set_sample_constraints(i);
+    double u_min, u_max;
+    computeFeasibleAccelerations(constraints, x, u_min, u_max);
+    u_min = std::max(u_min, (reachable_min[i + 1] - x) / (2.0 * ds));
+    u_max = std::min(u_max, (reachable_max[i + 1] - x) / (2.0 * ds));
+    if (u_min > u_max + ACCELERATION_TOLERANCE)
+    {
+      RCLCPP_ERROR(getLogger(), "No feasible path acceleration at s = %f of %f", i * ds, path.getLength());
+      return false;
+    }
+
+    squared_velocities[i + 1] = std::clamp(x + 2.0 * ds * u_max, reachable_min[i + 1], reachable_max[i + 1]);
+    path_accelerations[i] = (squared_velocities[i + 1] - x) / (2.0 * ds);
+    const double velocity_sum = std::sqrt(x) + std::sqrt(squared_velocities[i + 1]);
+    if (velocity_sum <= 0.0)
+    {
+      RCLCPP_ERROR(getLogger(), "The path velocity drops to zero at s = %f of %f", i * ds, path.getLength());
+      return false;
+    }
+    times[i + 1] = times[i] + 2.0 * ds / velocity_sum;
+  }
+
+  // Resample and fill in trajectory
+  const std::vector<int>& idx = group->getVariableIndexList();
+  const double duration = times.back();
+  const size_t sample_count = std::ceil(duration / resample_dt_);
+  moveit::core::RobotState waypoint = moveit::core::RobotState(trajectory.getWayPoint(0));
+  trajectory.clear();
+  double last_t = 0;
+  size_t step = 0;
+  for (size_t sample = 0; sample <= sample_count; ++sample)
+  {
+    // always sample the end of the trajectory as well
+    const double t = std::min(duration, sample * resample_dt_);
+    while (step + 1 < num_steps && times[step + 1] <= t)
+    {
+      ++step;
+    }
+    const double dt = t - times[step];
+    const double path_acceleration = path_accelerations[step];
+    const double start_velocity = std::sqrt(squared_velocities[step]);
+    const double path_velocity = std::max(0.0, start_velocity + path_acceleration * dt);
+    const double s = std::min(std::min((step + 1) * ds, path.getLength()),
+                              step * ds + start_velocity * dt + 0.5 * path_acceleration * dt * dt);
+    const Eigen::VectorXd position = path.getConfig(s);
+    const Eigen::VectorXd tangent = path.getTangent(s);
+    const Eigen::VectorXd acceleration =
+        tangent * path_acceleration + path.getCurvature(s) * path_velocity * path_velocity;
+
+    for (Eigen::Index j = 0; j < num_joints; ++j)
+    {
+      waypoint.setVariablePosition(idx[j], position[j]);
+      waypoint.setVariableVelocity(idx[j], tangent[j] * path_velocity);
+      waypoint.setVariableAcceleration(idx[j], acceleration[j]);
+    }
+
+    trajectory.addSuffixWayPoint(waypoint, t - last_t);
+    last_t = t;
+  }
+
+  return true;
+}
+}  // namespace trajectory_processing
@@ -83,6 +83,72 @@ static void robotTrajectoryCreate(benchmark::State& st)
   }
 }
 
+// Create a sinusoidal, timed test trajectory of the test group with the given number of waypoints.
+static robot_trajectory::RobotTrajectoryPtr createTestTrajectory(const moveit::core::RobotModelPtr& robot_model,
+                                                                 const moveit::core::JointModelGroup* group,
+                                                                 int n_states)
+{
+  moveit::core::RobotState robot_state(robot_model);
+  robot_state.setToDefaultValues();
+  auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, group);
+  for (int i = 0; i < n_states; ++i)
+  {
+    const double joint_value = std::sin(0.001 * i);
+    Eigen::VectorXd joint_values = Eigen::VectorXd::Constant(group->getActiveVariableCount(), joint_value);
+    robot_state.setJointGroupActivePositions(group, joint_values);
+    trajectory->addSuffixWayPoint(robot_state, 0.1);
+  }
+  return trajectory;
+}
+
+// Benchmark conversion of a trajectory with a given number of waypoints to a message.
+static void robotTrajectoryToMsg(benchmark::State& st)
+{
+  int n_states = st.range(0);
+  const moveit::core::RobotModelPtr& robot_model = moveit::core::loadTestingRobotModel(TEST_ROBOT);
+
+  // Make sure the group exists, otherwise exit early with an error.
+  if (!robot_model->hasJointModelGroup(TEST_GROUP))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  auto trajectory = createTestTrajectory(robot_model, robot_model->getJointModelGroup(TEST_GROUP), n_states);
+
+  for (auto _ : st)
+  {
+    moveit_msgs::msg::RobotTrajectory trajectory_msg;
+    trajectory->getRobotTrajectoryMsg(trajectory_msg);
+    benchmark::DoNotOptimize(trajectory_msg);
+  }
+}
+
+// Benchmark conversion of a trajectory message with a given number of waypoints to a trajectory.
+static void robotTrajectoryFromMsg(benchmark::State& st)
+{
+  int n_states = st.range(0);
+  const moveit::core::RobotModelPtr& robot_model = moveit::core::loadTestingRobotModel(TEST_ROBOT);
+
+  // Make sure the group exists, otherwise exit early with an error.
+  if (!robot_model->hasJointModelGroup(TEST_GROUP))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  auto* group = robot_model->getJointModelGroup(TEST_GROUP);
+  moveit_msgs::msg::RobotTrajectory trajectory_msg;
+  createTestTrajectory(robot_model, group, n_states)->getRobotTrajectoryMsg(trajectory_msg);
+  moveit::core::RobotState reference_state(robot_model);
+  reference_state.setToDefaultValues();
+
+  for (auto _ : st)
+  {
+    robot_trajectory::RobotTrajectory trajectory(robot_model, group);
+    trajectory.setRobotTrajectoryMsg(reference_state, trajectory_msg);
+    benchmark::DoNotOptimize(trajectory);
+  }
+}
+
 // Benchmark timing of a trajectory with a given number of waypoints, via TOTG.
 static void robotTrajectoryTiming(benchmark::State& st)
 {
@@ -131,5 +197,40 @@ static void robotTrajectoryTiming(benchmark::State& st)
   }
 }
 
+// Benchmark TOTG on a dense path with blends at every waypoint, as generated by Cartesian planning.
+// With the complexity fit, the time per waypoint should stay constant as the waypoint count grows.
+static void timeOptimalDensePath(benchmark::State& st)
+{
+  const int n_waypoints = st.range(0);
+  std::vector<Eigen::VectorXd> waypoints;
+  waypoints.reserve(n_waypoints);
+  for (int i = 0; i < n_waypoints; ++i)
+  {
+    // a slowly turning helix in the first three joints, with small steps like a Cartesian path
+    const double t = 0.002 * i;
+    Eigen::VectorXd waypoint = Eigen::VectorXd::Zero(7);
+    waypoint.head<3>() << std::cos(t), std::sin(t), 0.1 * t;
+    waypoints.push_back(waypoint);
+  }
+  const Eigen::VectorXd max_velocity = Eigen::VectorXd::Constant(7, 1.0);
+  const Eigen::VectorXd max_acceleration = Eigen::VectorXd::Constant(7, 2.0);
+
+  for (auto _ : st)
+  {
+    auto path = trajectory_processing::Path::create(waypoints, /*max_deviation=*/0.0001);
+    if (!path)
+    {
+      st.SkipWithError("Failed to create the path.");
+      return;
+    }
+    auto trajectory = trajectory_processing::Trajectory::create(*path, max_velocity, max_acceleration);
+    benchmark::DoNotOptimize(trajectory);
+  }
+  st.SetComplexityN(n_waypoints);
+}
+
 BENCHMARK(robotTrajectoryCreate)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(robotTrajectoryToMsg)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(robotTrajectoryFromMsg)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMillisecond);
 BENCHMARK(robotTrajectoryTiming)->RangeMultiplier(10)->Range(10, 20000)->Unit(benchmark::kMillisecond);
+BENCHMARK(timeOptimalDensePath)->RangeMultiplier(2)->Range(625, 10000)->Unit(benchmark::kMillisecond)->Complexity();
@@ -139,6 +139,71 @@ TEST_F(RuckigTests, trajectory_duration)
   EXPECT_LT(trajectory_->getWayPointDurationFromStart(trajectory_->getWayPointCount() - 1), 1.11 * ideal_duration);
 }
 
+TEST_F(RuckigTests, resume_from_waypoint)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.zeroVelocities();
+  robot_state.zeroAccelerations();
+  for (size_t i = 0; i < 5; ++i)
+  {
+    robot_state.setVariablePosition("panda_joint1", 0.05 * i);
+    trajectory_->addSuffixWayPoint(robot_state, DEFAULT_TIMESTEP);
+  }
+  ASSERT_TRUE(smoother_.applySmoothing(*trajectory_));
+  const robot_trajectory::RobotTrajectory executed_prefix(*trajectory_, true /* deep copy */);
+
+  // The robot lags behind waypoint 2 and the goal moved further away
+  robot_state = trajectory_->getWayPoint(2);
+  robot_state.setVariablePosition("panda_joint1", 0.09);
+  trajectory_->getWayPointPtr(4)->setVariablePosition("panda_joint1", 0.3);
+
+  EXPECT_FALSE(smoother_.applySmoothingFromWayPoint(*trajectory_, trajectory_->getWayPointCount(), robot_state));
+  ASSERT_TRUE(smoother_.applySmoothingFromWayPoint(*trajectory_, 2, robot_state));
+
+  // The executed prefix is untouched, the resumed waypoint matches the given state
+  for (size_t i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(trajectory_->getWayPoint(i).getVariablePosition("panda_joint1"),
+              executed_prefix.getWayPoint(i).getVariablePosition("panda_joint1"));
+    EXPECT_EQ(trajectory_->getWayPointDurationFromPrevious(i), executed_prefix.getWayPointDurationFromPrevious(i));
+  }
+  EXPECT_EQ(trajectory_->getWayPointDurationFromPrevious(2), executed_prefix.getWayPointDurationFromPrevious(2));
+  EXPECT_DOUBLE_EQ(trajectory_->getWayPoint(2).getVariablePosition("panda_joint1"), 0.09);
+  EXPECT_DOUBLE_EQ(trajectory_->getLastWayPoint().getVariablePosition("panda_joint1"), 0.3);
+}
+
+TEST_F(RuckigTests, batch)
+{
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.zeroVelocities();
+  robot_state.zeroAccelerations();
+  std::vector<double> joint_positions;
+  robot_state.copyJointGroupPositions(JOINT_GROUP, joint_positions);
+
+  std::vector<robot_trajectory::RobotTrajectoryPtr> trajectories;
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, JOINT_GROUP);
+    robot_state.setJointGroupPositions(JOINT_GROUP, joint_positions);
+    trajectory->addSuffixWayPoint(robot_state, DEFAULT_TIMESTEP);
+    std::vector<double> target_positions = joint_positions;
+    target_positions.at(0) += 0.05 * (i + 1);
+    robot_state.setJointGroupPositions(JOINT_GROUP, target_positions);
+    trajectory->addSuffixWayPoint(robot_state, DEFAULT_TIMESTEP);
+    trajectories.push_back(trajectory);
+  }
+  // a trajectory without group cannot be smoothed
+  trajectories.push_back(std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_));
+
+  const std::vector<bool> results = smoother_.applySmoothingBatch(trajectories);
+  EXPECT_EQ(results, (std::vector<bool>{ true, true, true, true, false }));
+  // longer motions take longer
+  for (std::size_t i = 1; i < 4; ++i)
+    EXPECT_GT(trajectories[i]->getDuration(), trajectories[i - 1]->getDuration());
+}
+
 TEST_F(RuckigTests, single_waypoint)
 {
   // With only one waypoint, Ruckig cannot smooth the trajectory.
@@ -637,6 +637,48 @@ TEST(time_optimal_trajectory_generation, testTimeStepZeroMakesTrajectoryInvalid)
                                   /*time_step=*/0));
 }
 
+TEST(time_optimal_trajectory_generation, testBatch)
+{
+  auto robot_model = moveit::core::loadTestingRobotModel("panda");
+  ASSERT_TRUE(robot_model);
+  setAccelerationLimits(robot_model);
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup("panda_arm");
+  ASSERT_TRUE(group);
+  moveit::core::RobotState waypoint_state(robot_model);
+  waypoint_state.setToDefaultValues();
+
+  // trajectories of different lengths, and one that cannot be parameterized
+  std::vector<robot_trajectory::RobotTrajectoryPtr> trajectories;
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, group);
+    waypoint_state.setJointGroupPositions(group, std::vector<double>{ 0.0, -0.5, 0.0, -2.0, 0.0, 1.5, 0.0 });
+    trajectory->addSuffixWayPoint(waypoint_state, 0.0);
+    waypoint_state.setJointGroupPositions(group, std::vector<double>{ 0.1 * (i + 1), -0.5, 0.0, -2.0, 0.0, 1.5, 0.0 });
+    trajectory->addSuffixWayPoint(waypoint_state, 0.0);
+    trajectories.push_back(trajectory);
+  }
+  trajectories.push_back(nullptr);
+
+  std::vector<robot_trajectory::RobotTrajectory> expected;
+  const TimeOptimalTrajectoryGeneration totg;
+  for (std::size_t i = 0; i + 1 < trajectories.size(); ++i)
+  {
+    expected.emplace_back(*trajectories[i], true /* deep copy */);
+    ASSERT_TRUE(totg.computeTimeStamps(expected.back()));
+  }
+
+  const std::vector<bool> results = totg.computeTimeStampsBatch(trajectories, 1.0, 1.0, /*thread_count=*/4);
+  ASSERT_EQ(results.size(), trajectories.size());
+  EXPECT_FALSE(results.back());
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    EXPECT_TRUE(results[i]);
+    ASSERT_EQ(trajectories[i]->size(), expected[i].size());
+    EXPECT_DOUBLE_EQ(trajectories[i]->getDuration(), expected[i].getDuration());
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
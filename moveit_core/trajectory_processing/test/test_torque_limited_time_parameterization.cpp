@@ -0,0 +1,206 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/trajectory_processing/torque_limited_time_parameterization.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+
+using trajectory_processing::TimeOptimalTrajectoryGeneration;
+using trajectory_processing::TorqueLimitedTimeParameterization;
+
+namespace
+{
+constexpr char JOINT_GROUP[] = "panda_arm";
+
+class TorqueLimitedTimeParameterizationTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    ASSERT_TRUE(robot_model_);
+    // The URDF does not contain acceleration limits
+    for (moveit::core::JointModel* joint_model : robot_model_->getActiveJointModels())
+    {
+      std::vector<moveit_msgs::msg::JointLimits> joint_bounds_msg(joint_model->getVariableBoundsMsg());
+      for (auto& joint_bound : joint_bounds_msg)
+      {
+        joint_bound.has_acceleration_limits = true;
+        joint_bound.max_acceleration = 1.0;
+      }
+      joint_model->setVariableBounds(joint_bounds_msg);
+    }
+
+    geometry_msgs::msg::Vector3 gravity;
+    gravity.z = -9.81;
+    dynamics_solver_ = std::make_shared<dynamics_solver::DynamicsSolver>(robot_model_, JOINT_GROUP, gravity);
+    group_ = robot_model_->getJointModelGroup(JOINT_GROUP);
+
+    trajectory_ = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, group_);
+    moveit::core::RobotState waypoint(robot_model_);
+    waypoint.setToDefaultValues();
+    waypoint.setJointGroupPositions(group_, std::vector<double>{ -0.5, -0.5, 0.0, -2.0, 0.0, 1.5, 0.0 });
+    trajectory_->addSuffixWayPoint(waypoint, 0.0);
+    waypoint.setJointGroupPositions(group_, std::vector<double>{ 0.5, 0.5, 0.3, -1.5, 0.2, 1.8, 0.5 });
+    trajectory_->addSuffixWayPoint(waypoint, 0.0);
+  }
+
+  // Torques required at every waypoint, except the last one where the motion stops
+  Eigen::MatrixXd computeTorques(const robot_trajectory::RobotTrajectory& trajectory) const
+  {
+    const Eigen::Index num_joints = group_->getVariableCount();
+    const Eigen::Index num_waypoints = trajectory.getWayPointCount() - 1;
+    Eigen::MatrixXd positions(num_joints, num_waypoints);
+    Eigen::MatrixXd velocities(num_joints, num_waypoints);
+    Eigen::MatrixXd accelerations(num_joints, num_waypoints);
+    for (Eigen::Index i = 0; i < num_waypoints; ++i)
+    {
+      Eigen::VectorXd values;
+      trajectory.getWayPoint(i).copyJointGroupPositions(group_, values);
+      positions.col(i) = values;
+      trajectory.getWayPoint(i).copyJointGroupVelocities(group_, values);
+      velocities.col(i) = values;
+      trajectory.getWayPoint(i).copyJointGroupAccelerations(group_, values);
+      accelerations.col(i) = values;
+    }
+    Eigen::MatrixXd torques;
+    EXPECT_TRUE(dynamics_solver_->getTorques(positions, velocities, accelerations, torques));
+    return torques;
+  }
+
+  moveit::core::RobotModelPtr robot_model_;
+  const moveit::core::JointModelGroup* group_;
+  dynamics_solver::DynamicsSolverPtr dynamics_solver_;
+  robot_trajectory::RobotTrajectoryPtr trajectory_;
+};
+}  // namespace
+
+TEST_F(TorqueLimitedTimeParameterizationTest, batchedTorquesMatchSingleEvaluation)
+{
+  const std::vector<double> positions{ 0.1, -0.4, 0.2, -1.8, 0.3, 1.6, 0.4 };
+  std::vector<double> torques(positions.size());
+  ASSERT_TRUE(dynamics_solver_->getPayloadTorques(positions, 0.0 /* payload */, torques));
+
+  const Eigen::VectorXd zeros = Eigen::VectorXd::Zero(positions.size());
+  Eigen::MatrixXd batch_torques;
+  ASSERT_TRUE(dynamics_solver_->getTorques(Eigen::Map<const Eigen::VectorXd>(positions.data(), positions.size()),
+                                           zeros, zeros, batch_torques));
+  ASSERT_EQ(batch_torques.cols(), 1);
+  for (size_t j = 0; j < torques.size(); ++j)
+    EXPECT_NEAR(batch_torques(j, 0), torques[j], 1e-9);
+
+  EXPECT_FALSE(dynamics_solver_->getTorques(Eigen::MatrixXd::Zero(3, 2), Eigen::MatrixXd::Zero(3, 2),
+                                            Eigen::MatrixXd::Zero(3, 2), batch_torques));
+}
+
+TEST_F(TorqueLimitedTimeParameterizationTest, workspaceBatchesMatchSingleEvaluation)
+{
+  const dynamics_solver::DynamicsSolver::WorkspacePtr workspace = dynamics_solver_->createWorkspace();
+  ASSERT_TRUE(workspace);
+
+  // Holding torques of a batch of configurations
+  Eigen::MatrixXd positions(7, 2);
+  positions.col(0) << 0.1, -0.4, 0.2, -1.8, 0.3, 1.6, 0.4;
+  positions.col(1) << -0.3, 0.2, -0.1, -2.2, 0.1, 1.9, -0.2;
+  const double payload = 2.0;
+  Eigen::MatrixXd batch_torques;
+  ASSERT_TRUE(dynamics_solver_->getPayloadTorques(positions, payload, batch_torques, *workspace));
+  ASSERT_EQ(batch_torques.cols(), 2);
+  for (Eigen::Index i = 0; i < positions.cols(); ++i)
+  {
+    const std::vector<double> config(positions.col(i).data(), positions.col(i).data() + positions.rows());
+    std::vector<double> torques(config.size());
+    ASSERT_TRUE(dynamics_solver_->getPayloadTorques(config, payload, torques));
+    for (size_t j = 0; j < torques.size(); ++j)
+      EXPECT_NEAR(batch_torques(j, i), torques[j], 1e-9);
+  }
+
+  // Inverse dynamics along a time-parameterized trajectory
+  ASSERT_TRUE(TimeOptimalTrajectoryGeneration().computeTimeStamps(*trajectory_));
+  ASSERT_TRUE(dynamics_solver_->getTrajectoryTorques(*trajectory_, batch_torques, *workspace));
+  ASSERT_EQ(batch_torques.cols(), static_cast<Eigen::Index>(trajectory_->getWayPointCount()));
+  const Eigen::MatrixXd torques = computeTorques(*trajectory_);
+  EXPECT_TRUE(batch_torques.leftCols(torques.cols()).isApprox(torques, 1e-9));
+}
+
+TEST_F(TorqueLimitedTimeParameterizationTest, effortLimitsSlowDownTrajectory)
+{
+  robot_trajectory::RobotTrajectory kinematic_trajectory(*trajectory_, true /* deep copy */);
+  ASSERT_TRUE(TimeOptimalTrajectoryGeneration().computeTimeStamps(kinematic_trajectory));
+
+  // Without binding effort limits, the result matches the kinematically limited time-optimal trajectory
+  TorqueLimitedTimeParameterization totg(dynamics_solver_, 0.1, 0.01);
+  ASSERT_TRUE(totg.setEffortLimits(std::vector<double>(7, 1e6)));
+  robot_trajectory::RobotTrajectory unlimited_trajectory(*trajectory_, true /* deep copy */);
+  ASSERT_TRUE(totg.computeTimeStamps(unlimited_trajectory));
+  EXPECT_NEAR(unlimited_trajectory.getDuration(), kinematic_trajectory.getDuration(),
+              0.05 * kinematic_trajectory.getDuration());
+
+  // Allow only a small margin above the torques needed to hold the robot against gravity
+  robot_trajectory::RobotTrajectory resting_trajectory(kinematic_trajectory, true /* deep copy */);
+  for (size_t i = 0; i < resting_trajectory.getWayPointCount(); ++i)
+  {
+    resting_trajectory.getWayPointPtr(i)->zeroVelocities();
+    resting_trajectory.getWayPointPtr(i)->zeroAccelerations();
+  }
+  const Eigen::MatrixXd static_torques = computeTorques(resting_trajectory);
+  std::vector<double> effort_limits(7);
+  for (Eigen::Index j = 0; j < static_torques.rows(); ++j)
+    effort_limits[j] = static_torques.row(j).cwiseAbs().maxCoeff() + 0.5;
+  ASSERT_TRUE(totg.setEffortLimits(effort_limits));
+
+  ASSERT_TRUE(totg.computeTimeStamps(*trajectory_));
+  EXPECT_GT(trajectory_->getDuration(), kinematic_trajectory.getDuration());
+  EXPECT_NEAR(trajectory_->getLastWayPoint().getVariablePosition("panda_joint1"), 0.5, 1e-6);
+
+  // The limits are enforced at the dynamics samples, allow for the deviation in between
+  const Eigen::MatrixXd torques = computeTorques(*trajectory_);
+  for (Eigen::Index j = 0; j < torques.rows(); ++j)
+    EXPECT_LE(torques.row(j).cwiseAbs().maxCoeff(), 1.05 * effort_limits[j]) << "joint " << j;
+}
+
+TEST_F(TorqueLimitedTimeParameterizationTest, infeasibleEffortLimits)
+{
+  // The robot cannot even hold itself against gravity
+  TorqueLimitedTimeParameterization totg(dynamics_solver_);
+  ASSERT_TRUE(totg.setEffortLimits(std::vector<double>(7, 1e-3)));
+  EXPECT_FALSE(totg.setEffortLimits(std::vector<double>(3, 1.0)));
+  EXPECT_FALSE(totg.computeTimeStamps(*trajectory_));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
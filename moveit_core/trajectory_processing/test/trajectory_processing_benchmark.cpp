@@ -0,0 +1,275 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// To run this benchmark, 'cd' to the build/moveit_core/trajectory_processing directory and directly run the binary.
+// Benchmarks take {waypoint count, degrees of freedom} as arguments, where 7 DOF is the panda arm and 14 DOF both pr2
+// arms. Select a subset with e.g. --benchmark_filter='timeOptimal/cartesian/10000/14'.
+
+#include <benchmark/benchmark.h>
+#include <moveit/robot_model/robot_model.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <moveit/robot_trajectory/robot_trajectory.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+#include <moveit/trajectory_processing/ruckig_traj_smoothing.hpp>
+#include <moveit/trajectory_processing/time_optimal_trajectory_generation.hpp>
+#include <moveit_msgs/msg/robot_trajectory.hpp>
+
+#include <random>
+
+namespace
+{
+// Joint space step between waypoints of a dense path, as generated by Cartesian planning
+constexpr double CARTESIAN_STEP = 0.001;
+// Maximum joint space step between waypoints of a sparse path, as generated by sampling-based planning
+constexpr double JOINT_SPACE_STEP = 0.02;
+
+enum class PathType
+{
+  CARTESIAN,
+  JOINT_SPACE
+};
+
+// A robot model and planning group with the requested number of degrees of freedom
+struct BenchmarkRobot
+{
+  moveit::core::RobotModelPtr robot_model;
+  const moveit::core::JointModelGroup* group = nullptr;
+  std::unordered_map<std::string, double> velocity_limits;
+  std::unordered_map<std::string, double> acceleration_limits;
+  std::unordered_map<std::string, double> jerk_limits;
+};
+
+bool loadRobot(int dof, BenchmarkRobot& robot)
+{
+  robot.robot_model = moveit::core::loadTestingRobotModel(dof == 14 ? "pr2" : "panda");
+  const char* group_name = dof == 14 ? "arms" : "panda_arm";
+  if (!robot.robot_model || !robot.robot_model->hasJointModelGroup(group_name))
+    return false;
+  robot.group = robot.robot_model->getJointModelGroup(group_name);
+  if (static_cast<int>(robot.group->getActiveVariableCount()) != dof)
+    return false;
+
+  // use the same limits for both robots, so results only depend on the path
+  for (const std::string& joint_name : robot.group->getActiveJointModelNames())
+  {
+    robot.velocity_limits[joint_name] = 1.0;
+    robot.acceleration_limits[joint_name] = 2.0;
+    robot.jerk_limits[joint_name] = 100.0;
+  }
+  return true;
+}
+
+// Create a path without time stamps, the same for every run
+robot_trajectory::RobotTrajectoryPtr createPath(const BenchmarkRobot& robot, PathType type, int n_waypoints)
+{
+  auto trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot.robot_model, robot.group);
+  moveit::core::RobotState state(robot.robot_model);
+  state.setToDefaultValues();
+
+  const std::size_t dof = robot.group->getActiveVariableCount();
+  Eigen::VectorXd positions = Eigen::VectorXd::Zero(dof);
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> step(-JOINT_SPACE_STEP, JOINT_SPACE_STEP);
+  for (int i = 0; i < n_waypoints; ++i)
+  {
+    if (type == PathType::CARTESIAN)
+    {
+      // a slowly turning curve in which all joints move smoothly together
+      for (std::size_t j = 0; j < dof; ++j)
+        positions[j] = 0.5 * std::sin(CARTESIAN_STEP * i * (1.0 + 0.1 * j));
+    }
+    else
+    {
+      // a random walk with a corner at every waypoint
+      for (std::size_t j = 0; j < dof; ++j)
+        positions[j] += step(rng);
+    }
+    state.setJointGroupActivePositions(robot.group, positions);
+    trajectory->addSuffixWayPoint(state, 0.0);
+  }
+  return trajectory;
+}
+
+void waypointCountsAndDofs(benchmark::internal::Benchmark* benchmark)
+{
+  for (int dof : { 7, 14 })
+  {
+    for (int n_waypoints : { 10, 100, 1000, 10000 })
+      benchmark->Args({ n_waypoints, dof });
+  }
+}
+
+void resampleDtArgs(benchmark::internal::Benchmark* benchmark)
+{
+  for (int resample_dt_ms : { 1, 10, 100 })
+  {
+    for (int n_waypoints : { 100, 1000, 10000 })
+      benchmark->Args({ n_waypoints, 7, resample_dt_ms });
+  }
+}
+
+void defaultResampleDtArgs(benchmark::internal::Benchmark* benchmark)
+{
+  for (int dof : { 7, 14 })
+  {
+    for (int n_waypoints : { 10, 100, 1000, 10000 })
+      benchmark->Args({ n_waypoints, dof, 100 });
+  }
+}
+}  // namespace
+
+// Benchmark TOTG on a path of a given type, with resample_dt in milliseconds as optional third argument
+static void timeOptimal(benchmark::State& st, PathType type)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(1), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  const double resample_dt = st.range(2) * 1e-3;
+  const robot_trajectory::RobotTrajectoryPtr path = createPath(robot, type, st.range(0));
+  trajectory_processing::TimeOptimalTrajectoryGeneration totg(/*path_tolerance=*/0.1, resample_dt);
+
+  for (auto _ : st)
+  {
+    st.PauseTiming();
+    robot_trajectory::RobotTrajectory trajectory(*path, /*deepcopy=*/true);
+    st.ResumeTiming();
+    if (!totg.computeTimeStamps(trajectory, robot.velocity_limits, robot.acceleration_limits))
+    {
+      st.SkipWithError("Failed to compute time stamps.");
+      return;
+    }
+  }
+}
+
+// Benchmark Ruckig smoothing of a path time-parameterized by TOTG
+static void ruckigSmoothing(benchmark::State& st, PathType type)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(1), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  const robot_trajectory::RobotTrajectoryPtr path = createPath(robot, type, st.range(0));
+  trajectory_processing::TimeOptimalTrajectoryGeneration totg(/*path_tolerance=*/0.1, /*resample_dt=*/0.1);
+  if (!totg.computeTimeStamps(*path, robot.velocity_limits, robot.acceleration_limits))
+  {
+    st.SkipWithError("Failed to compute time stamps.");
+    return;
+  }
+
+  for (auto _ : st)
+  {
+    st.PauseTiming();
+    robot_trajectory::RobotTrajectory trajectory(*path, /*deepcopy=*/true);
+    st.ResumeTiming();
+    if (!trajectory_processing::RuckigSmoothing::applySmoothing(trajectory, robot.velocity_limits,
+                                                                robot.acceleration_limits, robot.jerk_limits))
+    {
+      st.SkipWithError("Failed to smooth the trajectory.");
+      return;
+    }
+  }
+  st.counters["waypoints"] = static_cast<double>(path->getWayPointCount());
+}
+
+// Benchmark conversion of a trajectory with time stamps, velocities and accelerations to a message
+static void trajectoryToMsg(benchmark::State& st)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(1), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  const robot_trajectory::RobotTrajectoryPtr trajectory = createPath(robot, PathType::CARTESIAN, st.range(0));
+  for (std::size_t i = 0; i < trajectory->getWayPointCount(); ++i)
+  {
+    trajectory->setWayPointDurationFromPrevious(i, 0.01);
+    trajectory->getWayPointPtr(i)->zeroVelocities();
+    trajectory->getWayPointPtr(i)->zeroAccelerations();
+  }
+
+  moveit_msgs::msg::RobotTrajectory msg;
+  for (auto _ : st)
+  {
+    trajectory->getRobotTrajectoryMsg(msg);
+    benchmark::DoNotOptimize(msg);
+  }
+}
+
+// Benchmark conversion of a trajectory message to a trajectory
+static void trajectoryFromMsg(benchmark::State& st)
+{
+  BenchmarkRobot robot;
+  if (!loadRobot(st.range(1), robot))
+  {
+    st.SkipWithError("The planning group doesn't exist.");
+    return;
+  }
+  const robot_trajectory::RobotTrajectoryPtr path = createPath(robot, PathType::CARTESIAN, st.range(0));
+  for (std::size_t i = 0; i < path->getWayPointCount(); ++i)
+    path->setWayPointDurationFromPrevious(i, 0.01);
+  moveit_msgs::msg::RobotTrajectory msg;
+  path->getRobotTrajectoryMsg(msg);
+  const moveit::core::RobotState& reference_state = path->getFirstWayPoint();
+
+  robot_trajectory::RobotTrajectory trajectory(robot.robot_model, robot.group);
+  for (auto _ : st)
+  {
+    trajectory.setRobotTrajectoryMsg(reference_state, msg);
+    benchmark::DoNotOptimize(trajectory);
+  }
+}
+
+BENCHMARK_CAPTURE(timeOptimal, cartesian, PathType::CARTESIAN)
+    ->Apply(defaultResampleDtArgs)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(timeOptimal, joint_space, PathType::JOINT_SPACE)
+    ->Apply(defaultResampleDtArgs)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(timeOptimal, cartesian_resample_dt, PathType::CARTESIAN)
+    ->Apply(resampleDtArgs)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ruckigSmoothing, cartesian, PathType::CARTESIAN)
+    ->Apply(waypointCountsAndDofs)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(ruckigSmoothing, joint_space, PathType::JOINT_SPACE)
+    ->Apply(waypointCountsAndDofs)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(trajectoryToMsg)->Apply(waypointCountsAndDofs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(trajectoryFromMsg)->Apply(waypointCountsAndDofs)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,107 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Opt-in tracepoints at the stage boundaries of the planning stack */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/// Tracepoints are compiled in only when moveit_core is built with -DMOVEIT_ENABLE_TRACING=ON. They are then emitted
+/// as LTTng userspace events of the "moveit" provider, e.g. recorded with
+/// @code{sh}
+/// lttng create moveit && lttng enable-event -u 'moveit:*' && lttng add-context -u -t vtid && lttng start
+/// @endcode
+/// and analyzed with the moveit_trace_analysis.py script. Otherwise, the macros expand to nothing and don't evaluate
+/// their arguments.
+///
+/// @code{C++}
+/// MOVEIT_TRACEPOINT_SCOPE("planning_pipeline.generate_plan");  // begin and end of the enclosing scope
+/// MOVEIT_TRACEPOINT_SCOPE_DETAIL("planning_pipeline.planner", planner->getDescription());
+/// MOVEIT_TRACEPOINT_COUNTER("robot_state.update_link_transforms", link_count);
+/// @endcode
+#ifdef MOVEIT_ENABLE_TRACING
+
+namespace moveit
+{
+namespace tracing
+{
+/// @brief Emits the begin of a traced stage in the calling thread.
+void traceScopeBegin(const char* stage, const char* detail);
+
+/// @brief Emits the end of a traced stage in the calling thread.
+void traceScopeEnd(const char* stage, const char* detail);
+
+/// @brief Emits a value of a named counter, e.g. the amount of work done by a call.
+void traceCounter(const char* name, int64_t value);
+
+/// @brief Emits the begin of a stage on construction and its end on destruction.
+class TraceScope
+{
+public:
+  TraceScope(const char* stage, std::string detail = std::string()) : stage_(stage), detail_(std::move(detail))
+  {
+    traceScopeBegin(stage_, detail_.c_str());
+  }
+  ~TraceScope()
+  {
+    traceScopeEnd(stage_, detail_.c_str());
+  }
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+  const char* stage_;
+  std::string detail_;
+};
+}  // namespace tracing
+}  // namespace moveit
+
+#define MOVEIT_TRACEPOINT_CONCAT_IMPL(a, b) a##b
+#define MOVEIT_TRACEPOINT_CONCAT(a, b) MOVEIT_TRACEPOINT_CONCAT_IMPL(a, b)
+#define MOVEIT_TRACEPOINT_SCOPE(stage)                                                                                 \
+  const ::moveit::tracing::TraceScope MOVEIT_TRACEPOINT_CONCAT(moveit_tracepoint_scope_, __LINE__)(stage)
+#define MOVEIT_TRACEPOINT_SCOPE_DETAIL(stage, detail)                                                                  \
+  const ::moveit::tracing::TraceScope MOVEIT_TRACEPOINT_CONCAT(moveit_tracepoint_scope_, __LINE__)(stage, detail)
+#define MOVEIT_TRACEPOINT_COUNTER(name, value) ::moveit::tracing::traceCounter(name, static_cast<int64_t>(value))
+
+#else
+
+#define MOVEIT_TRACEPOINT_SCOPE(stage) ((void)0)
+#define MOVEIT_TRACEPOINT_SCOPE_DETAIL(stage, detail) ((void)0)
+#define MOVEIT_TRACEPOINT_COUNTER(name, value) ((void)0)
+
+#endif
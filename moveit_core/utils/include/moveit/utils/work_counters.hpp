@@ -0,0 +1,80 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Counters of the work done for a planning request */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace moveit
+{
+/** @brief Counts of the expensive operations done on behalf of one request, e.g. one motion plan request.
+ *
+ * The counters are installed for the calling thread with a ScopedWorkCounters object, and incremented by the core
+ * operations (collision checks, forward and inverse kinematics, state sampling) done by that thread. Code running work
+ * of the request in other threads installs the same counters there, hence the counters are atomic. */
+struct WorkCounters
+{
+  std::atomic<std::size_t> collision_checks{ 0 };
+  std::atomic<std::size_t> fk_calls{ 0 };
+  std::atomic<std::size_t> ik_calls{ 0 };
+  std::atomic<std::size_t> states_sampled{ 0 };
+};
+
+/** @brief The counters installed for the calling thread, nullptr if the work of the thread is not counted */
+WorkCounters* getThreadWorkCounters();
+
+/** @brief Installs counters for the calling thread for the lifetime of the object, restoring the previous ones on
+ * destruction. Passing nullptr stops counting in the scope. */
+class ScopedWorkCounters
+{
+public:
+  explicit ScopedWorkCounters(WorkCounters* counters);
+  ~ScopedWorkCounters();
+  ScopedWorkCounters(const ScopedWorkCounters&) = delete;
+  ScopedWorkCounters& operator=(const ScopedWorkCounters&) = delete;
+
+private:
+  WorkCounters* previous_;
+};
+
+/** @brief Adds to a counter of the calling thread, if counters are installed */
+inline void countWork(std::atomic<std::size_t> WorkCounters::*counter, std::size_t count = 1)
+{
+  if (WorkCounters* counters = getThreadWorkCounters())
+    (counters->*counter).fetch_add(count, std::memory_order_relaxed);
+}
+}  // namespace moveit
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+
+######################################################################
+# Software License Agreement (BSD License)
+#
+#  Copyright (c) 2026, MoveIt maintainers
+#  All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions
+#  are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above
+#     copyright notice, this list of conditions and the following
+#     disclaimer in the documentation and/or other materials provided
+#     with the distribution.
+#   * Neither the name of the copyright holder nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+#  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+#  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+#  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+#  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+#  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+#  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+#  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+#  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+#  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+#  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+#  POSSIBILITY OF SUCH DAMAGE.
+######################################################################
+
+"""Summarize the latency of the planning stack stages from an LTTng trace of the "moveit" tracepoints.
+
+Build moveit_core with -DMOVEIT_ENABLE_TRACING=ON and record a trace, including the thread ids:
+
+    lttng create moveit
+    lttng enable-event -u 'moveit:*'
+    lttng add-context -u -t vtid
+    lttng start
+    # ... run the requests to profile ...
+    lttng stop
+
+Then summarize it with
+
+    moveit_trace_analysis.py ~/lttng-traces/moveit-<date>
+
+For each stage, the script prints the number of calls and their total, mean, median, 95th percentile and maximum
+duration, and the fraction of the time of the enclosing stage. For each counter, it prints the number of samples
+and their sum. Requires the babeltrace2 Python bindings (python3-bt2).
+"""
+
+import argparse
+import collections
+import sys
+
+import bt2
+
+
+class Stage:
+    def __init__(self):
+        self.durations = []
+        self.parents = collections.Counter()
+        self.parent_durations = []
+
+
+def field(event, name, default=None):
+    try:
+        return event[name]
+    except KeyError:
+        return default
+
+
+def percentile(sorted_values, fraction):
+    return sorted_values[min(len(sorted_values) - 1, int(fraction * len(sorted_values)))]
+
+
+def read_trace(path):
+    stages = collections.defaultdict(Stage)
+    counters = collections.defaultdict(list)
+    # Open scopes per thread: (key, begin time)
+    open_scopes = collections.defaultdict(list)
+    missing_tid = False
+
+    for msg in bt2.TraceCollectionMessageIterator(path):
+        if type(msg) is not bt2._EventMessageConst:
+            continue
+        event = msg.event
+        if not event.name.startswith("moveit:"):
+            continue
+        time_ns = msg.default_clock_snapshot.ns_from_origin
+        tid = field(event, "vtid")
+        if tid is None:
+            missing_tid = True
+            tid = 0
+
+        if event.name == "moveit:counter":
+            counters[str(event["name"])].append(int(event["value"]))
+            continue
+
+        key = str(event["stage"])
+        detail = str(event["detail"])
+        if detail:
+            key += "[" + detail + "]"
+        scopes = open_scopes[tid]
+        if event.name == "moveit:scope_begin":
+            scopes.append((key, time_ns))
+        elif event.name == "moveit:scope_end":
+            # Unmatched ends stem from scopes that began before the trace started
+            index = next((i for i in reversed(range(len(scopes))) if scopes[i][0] == key), None)
+            if index is None:
+                continue
+            begin_ns = scopes[index][1]
+            del scopes[index:]
+            stage = stages[key]
+            stage.durations.append((time_ns - begin_ns) * 1e-9)
+            stage.parents[scopes[-1][0] if scopes else ""] += 1
+
+    if missing_tid:
+        print(
+            "Warning: the trace has no vtid context, nested stages of concurrent threads may be mismatched",
+            file=sys.stderr,
+        )
+    return stages, counters
+
+
+def print_summary(stages, counters):
+    total_by_key = {key: sum(stage.durations) for key, stage in stages.items()}
+    print(
+        f"{'stage':<70} {'calls':>8} {'total s':>10} {'mean ms':>10} {'p50 ms':>10} {'p95 ms':>10} "
+        f"{'max ms':>10} {'of parent':>9}"
+    )
+    for key, stage in sorted(stages.items(), key=lambda item: -total_by_key[item[0]]):
+        durations = sorted(stage.durations)
+        parent = stage.parents.most_common(1)[0][0]
+        share = ""
+        if parent and total_by_key.get(parent):
+            share = f"{100.0 * total_by_key[key] / total_by_key[parent]:.1f}%"
+        print(
+            f"{key:<70} {len(durations):>8} {total_by_key[key]:>10.3f} "
+            f"{1e3 * total_by_key[key] / len(durations):>10.3f} {1e3 * percentile(durations, 0.5):>10.3f} "
+            f"{1e3 * percentile(durations, 0.95):>10.3f} {1e3 * durations[-1]:>10.3f} {share:>9}"
+        )
+
+    if counters:
+        print()
+        print(f"{'counter':<70} {'samples':>10} {'sum':>14}")
+        for name, values in sorted(counters.items()):
+            print(f"{name:<70} {len(values):>10} {sum(values):>14}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Summarize an LTTng trace of the moveit tracepoints")
+    parser.add_argument("trace", help="directory of the LTTng trace")
+    args = parser.parse_args()
+    stages, counters = read_trace(args.trace)
+    if not stages and not counters:
+        print("No moveit events found in the trace", file=sys.stderr)
+        return 1
+    print_summary(stages, counters)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
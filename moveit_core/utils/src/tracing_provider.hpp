@@ -0,0 +1,61 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: LTTng tracepoint provider of the "moveit" events, see moveit/utils/tracing.hpp */
+
+// This header is read several times by lttng-ust, so it has no include guard
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER moveit
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "tracing_provider.hpp"
+
+#if !defined(MOVEIT_UTILS_TRACING_PROVIDER_HPP) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define MOVEIT_UTILS_TRACING_PROVIDER_HPP
+
+#include <lttng/tracepoint.h>
+
+TRACEPOINT_EVENT(moveit, scope_begin, TP_ARGS(const char*, stage_arg, const char*, detail_arg),
+                 TP_FIELDS(ctf_string(stage, stage_arg) ctf_string(detail, detail_arg)))
+
+TRACEPOINT_EVENT(moveit, scope_end, TP_ARGS(const char*, stage_arg, const char*, detail_arg),
+                 TP_FIELDS(ctf_string(stage, stage_arg) ctf_string(detail, detail_arg)))
+
+TRACEPOINT_EVENT(moveit, counter, TP_ARGS(const char*, name_arg, int64_t, value_arg),
+                 TP_FIELDS(ctf_string(name, name_arg) ctf_integer(int64_t, value, value_arg)))
+
+#endif
+
+#include <lttng/tracepoint-event.h>
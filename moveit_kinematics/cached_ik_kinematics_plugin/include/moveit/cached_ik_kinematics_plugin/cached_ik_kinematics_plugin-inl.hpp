@@ -36,6 +36,8 @@
 
 #pragma once
 
+#include <tf2_eigen/tf2_eigen.hpp>
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 
@@ -69,6 +71,79 @@ void CachedIKKinematicsPlugin<KinematicsPlugin>::initCache(const std::string& ro
   // cache_.verifyCache(fk);
 }
 
+template <class KinematicsPlugin>
+void CachedIKKinematicsPlugin<KinematicsPlugin>::loadReachabilityMap(const std::string& group_name)
+{
+  if (params_.reachability_map_file.empty())
+    return;
+  const rclcpp::Logger logger = moveit::getLogger("moveit.core.cached_ik_kinematics_plugin");
+  const reachability_map::ReachabilityMapConstPtr map =
+      reachability_map::ReachabilityMap::load(params_.reachability_map_file);
+  if (!map)
+    return;
+
+  const auto strip_slash = [](const std::string& frame) {
+    return frame.empty() || frame[0] != '/' ? frame : frame.substr(1);
+  };
+  if (map->getGroupName() != group_name ||
+      strip_slash(map->getBaseFrame()) != strip_slash(KinematicsPlugin::getBaseFrame()) ||
+      strip_slash(map->getTipFrame()) != strip_slash(KinematicsPlugin::getTipFrame()))
+  {
+    RCLCPP_ERROR(logger, "Ignoring reachability map %s, it maps '%s' in frame '%s' of group '%s'",
+                 params_.reachability_map_file.c_str(), map->getTipFrame().c_str(), map->getBaseFrame().c_str(),
+                 map->getGroupName().c_str());
+    return;
+  }
+
+  // the map stores seeds like the variables of the group, the solver orders them like its joints
+  reachability_seed_indices_.clear();
+  const std::vector<std::string>& map_joints = map->getJointNames();
+  for (const std::string& joint_name : KinematicsPlugin::getJointNames())
+  {
+    const auto it = std::find(map_joints.begin(), map_joints.end(), joint_name);
+    if (it == map_joints.end())
+    {
+      RCLCPP_ERROR(logger, "Ignoring reachability map %s, it has no values of joint '%s'",
+                   params_.reachability_map_file.c_str(), joint_name.c_str());
+      reachability_seed_indices_.clear();
+      return;
+    }
+    reachability_seed_indices_.push_back(it - map_joints.begin());
+  }
+  reachability_map_ = map;
+}
+
+template <class KinematicsPlugin>
+bool CachedIKKinematicsPlugin<KinematicsPlugin>::isUnreachable(const geometry_msgs::msg::Pose& ik_pose,
+                                                               moveit_msgs::msg::MoveItErrorCodes& error_code) const
+{
+  if (!reachability_map_)
+    return false;
+  Eigen::Isometry3d pose;
+  tf2::fromMsg(ik_pose, pose);
+  if (reachability_map_->isReachable(pose))
+    return false;
+  error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
+  return true;
+}
+
+template <class KinematicsPlugin>
+const std::vector<double>& CachedIKKinematicsPlugin<KinematicsPlugin>::getFallbackSeed(
+    const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state, std::vector<double>& seed) const
+{
+  if (!reachability_map_)
+    return ik_seed_state;
+  Eigen::Isometry3d pose;
+  tf2::fromMsg(ik_pose, pose);
+  std::vector<std::vector<double>> seeds;
+  if (!reachability_map_->getSeeds(pose, seeds) || seeds.empty())
+    return ik_seed_state;
+  seed.resize(reachability_seed_indices_.size());
+  for (std::size_t i = 0; i < reachability_seed_indices_.size(); ++i)
+    seed[i] = seeds.front()[reachability_seed_indices_[i]];
+  return seed;
+}
+
 template <class KinematicsPlugin>
 bool CachedMultiTipIKKinematicsPlugin<KinematicsPlugin>::initialize(
     const rclcpp::Node::SharedPtr& node, const moveit::core::RobotModel& robot_model, const std::string& group_name,
@@ -92,10 +167,15 @@ bool CachedIKKinematicsPlugin<KinematicsPlugin>::getPositionIK(const geometry_ms
                                                                moveit_msgs::msg::MoveItErrorCodes& error_code,
                                                                const KinematicsQueryOptions& options) const
 {
+  if (isUnreachable(ik_pose, error_code))
+    return false;
   Pose pose(ik_pose);
   const IKEntry& nearest = cache_.getBestApproximateIKSolution(pose);
-  bool solution_found = KinematicsPlugin::getPositionIK(ik_pose, nearest.second, solution, error_code, options) ||
-                        KinematicsPlugin::getPositionIK(ik_pose, ik_seed_state, solution, error_code, options);
+  std::vector<double> seed;
+  bool solution_found =
+      KinematicsPlugin::getPositionIK(ik_pose, nearest.second, solution, error_code, options) ||
+      KinematicsPlugin::getPositionIK(ik_pose, getFallbackSeed(ik_pose, ik_seed_state, seed), solution, error_code,
+                                      options);
   if (solution_found)
     cache_.updateCache(nearest, pose, solution);
   return solution_found;
@@ -108,6 +188,8 @@ bool CachedIKKinematicsPlugin<KinematicsPlugin>::searchPositionIK(const geometry
                                                                   moveit_msgs::msg::MoveItErrorCodes& error_code,
                                                                   const KinematicsQueryOptions& options) const
 {
+  if (isUnreachable(ik_pose, error_code))
+    return false;
   std::chrono::time_point<std::chrono::system_clock> start(std::chrono::system_clock::now());
   Pose pose(ik_pose);
   const IKEntry& nearest = cache_.getBestApproximateIKSolution(pose);
@@ -116,8 +198,9 @@ bool CachedIKKinematicsPlugin<KinematicsPlugin>::searchPositionIK(const geometry
   if (!solution_found)
   {
     std::chrono::duration<double> diff = std::chrono::system_clock::now() - start;
-    solution_found =
-        KinematicsPlugin::searchPositionIK(ik_pose, ik_seed_state, diff.count(), solution, error_code, options);
+    std::vector<double> seed;
+    solution_found = KinematicsPlugin::searchPositionIK(ik_pose, getFallbackSeed(ik_pose, ik_seed_state, seed),
+                                                        diff.count(), solution, error_code, options);
   }
   if (solution_found)
     cache_.updateCache(nearest, pose, solution);
@@ -130,6 +213,8 @@ bool CachedIKKinematicsPlugin<KinematicsPlugin>::searchPositionIK(
     const std::vector<double>& consistency_limits, std::vector<double>& solution,
     moveit_msgs::msg::MoveItErrorCodes& error_code, const KinematicsQueryOptions& options) const
 {
+  if (isUnreachable(ik_pose, error_code))
+    return false;
   std::chrono::time_point<std::chrono::system_clock> start(std::chrono::system_clock::now());
   Pose pose(ik_pose);
   const IKEntry& nearest = cache_.getBestApproximateIKSolution(pose);
@@ -154,6 +239,8 @@ bool CachedIKKinematicsPlugin<KinematicsPlugin>::searchPositionIK(const geometry
                                                                   moveit_msgs::msg::MoveItErrorCodes& error_code,
                                                                   const KinematicsQueryOptions& options) const
 {
+  if (isUnreachable(ik_pose, error_code))
+    return false;
   std::chrono::time_point<std::chrono::system_clock> start(std::chrono::system_clock::now());
   Pose pose(ik_pose);
   const IKEntry& nearest = cache_.getBestApproximateIKSolution(pose);
@@ -162,8 +249,9 @@ bool CachedIKKinematicsPlugin<KinematicsPlugin>::searchPositionIK(const geometry
   if (!solution_found)
   {
     std::chrono::duration<double> diff = std::chrono::system_clock::now() - start;
-    solution_found = KinematicsPlugin::searchPositionIK(ik_pose, ik_seed_state, diff.count(), solution,
-                                                        solution_callback, error_code, options);
+    std::vector<double> seed;
+    solution_found = KinematicsPlugin::searchPositionIK(ik_pose, getFallbackSeed(ik_pose, ik_seed_state, seed),
+                                                        diff.count(), solution, solution_callback, error_code, options);
   }
   if (solution_found)
     cache_.updateCache(nearest, pose, solution);
@@ -176,6 +264,8 @@ bool CachedIKKinematicsPlugin<KinematicsPlugin>::searchPositionIK(
     const std::vector<double>& consistency_limits, std::vector<double>& solution, const IKCallbackFn& solution_callback,
     moveit_msgs::msg::MoveItErrorCodes& error_code, const KinematicsQueryOptions& options) const
 {
+  if (isUnreachable(ik_pose, error_code))
+    return false;
   std::chrono::time_point<std::chrono::system_clock> start(std::chrono::system_clock::now());
   Pose pose(ik_pose);
   const IKEntry& nearest = cache_.getBestApproximateIKSolution(pose);
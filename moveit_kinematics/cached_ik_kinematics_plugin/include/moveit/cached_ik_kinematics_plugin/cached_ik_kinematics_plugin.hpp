@@ -39,6 +39,7 @@
 #include <moveit/cached_ik_kinematics_plugin/detail/NearestNeighborsGNAT.hpp>
 #include <moveit/kdl_kinematics_plugin/kdl_kinematics_plugin.hpp>
 #include <moveit/kinematics_base/kinematics_base.hpp>
+#include <moveit/reachability_map/reachability_map.hpp>
 #include <moveit/robot_model/robot_model.hpp>
 // TODO: Remove conditional includes when released to all active distros.
 #if __has_include(<tf2/LinearMath/Quaternion.hpp>)
@@ -51,7 +52,12 @@
 #else
 #include <tf2/LinearMath/Vector3.h>
 #endif
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <filesystem>
@@ -61,7 +67,14 @@
 namespace cached_ik_kinematics_plugin
 {
 
-/** \brief A cache of inverse kinematic solutions */
+/**
+  \brief A cache of inverse kinematic solutions
+
+  Lookups never take the cache mutex: they query an immutable nearest-neighbor
+  index that is atomically replaced whenever new entries are added. New entries
+  are queued and inserted in batches by a background thread, which also saves
+  the cache to disk.
+*/
 class IKCache
 {
 public:
@@ -123,8 +136,26 @@ public:
   void updateCache(const IKEntry& nearest, const std::vector<Pose>& poses, const std::vector<double>& config) const;
   /** verify with forward kinematics that the cache entries are correct */
   void verifyCache(kdl_kinematics_plugin::KDLKinematicsPlugin& fk) const;
+  /** block until all queued entries have been inserted and can be found by lookups */
+  void flush() const;
+  /** number of entries in the cache, including queued ones */
+  std::size_t size() const
+  {
+    return num_entries_;
+  }
 
 protected:
+  using IKIndex = NearestNeighborsGNAT<IKEntry*>;
+
+  /** create an empty nearest-neighbor index that uses the pose distance */
+  std::shared_ptr<IKIndex> createIndex() const;
+  /** queue an entry for insertion by the background thread */
+  void queueEntry(const std::vector<Pose>& poses, const std::vector<double>& config) const;
+  /** insert queued entries, rebuild the index and save the cache until stopped */
+  void updateIndexLoop();
+  /** stop the background thread, after it inserted all queued entries */
+  void stopWorker();
+
   /** compute the distance between two joint configurations */
   double configDistance2(const std::vector<double>& config1, const std::vector<double>& config2) const;
   /** save current state of cache to disk */
@@ -144,17 +175,34 @@ protected:
 
   /**
     the IK methods are declared const in the base class, but the
-    wrapped methods need to modify the cache, so the next four members
+    wrapped methods need to modify the cache, so the following members
     are mutable
-    cache of IK solutions
+    cache of IK solutions; a deque keeps entries in place as it grows,
+    so the index and returned references stay valid
   */
-  mutable std::vector<IKEntry> ik_cache_;
-  /** nearest neighbor data structure over IK cache entries */
-  mutable NearestNeighborsGNAT<IKEntry*> ik_nn_;
+  mutable std::deque<IKEntry> ik_cache_;
+  /** nearest neighbor data structure over the first num_indexed_entries_ IK cache entries, accessed atomically */
+  mutable std::shared_ptr<const IKIndex> ik_nn_;
+  /** number of IK cache entries covered by ik_nn_ */
+  mutable std::size_t num_indexed_entries_{ 0 };
+  /** entries waiting to be inserted by the background thread */
+  mutable std::vector<IKEntry> pending_entries_;
+  /** number of IK cache entries, including pending ones */
+  mutable std::atomic<std::size_t> num_entries_{ 0 };
   /** size of the cache when it was last saved */
   mutable unsigned int last_saved_cache_size_{ 0 };
+  /** whether flush() waits for the background thread */
+  mutable bool flush_requested_{ false };
+  /** whether the background thread should exit */
+  bool stop_worker_{ false };
   /** mutex for changing IK cache */
   mutable std::mutex lock_;
+  /** wakes up the background thread */
+  mutable std::condition_variable worker_condition_;
+  /** signals that the background thread published a new index */
+  mutable std::condition_variable index_condition_;
+  /** background thread inserting pending entries */
+  std::thread worker_;
 };
 
 /** a container of IK caches for cases where there is no fixed base frame */
@@ -275,8 +323,19 @@ private:
   cached_ik_kinematics::Params params_;
 
   IKCache cache_;
+  reachability_map::ReachabilityMapConstPtr reachability_map_;
+  /** for each joint of the solver, the index of its value in the seeds of the reachability map */
+  std::vector<std::size_t> reachability_seed_indices_;
 
   void initCache(const std::string& robot_id, const std::string& group_name, const std::string& cache_name);
+  /** load the reachability map, if any, and check that it maps the solver's frames */
+  void loadReachabilityMap(const std::string& group_name);
+  /** fail right away for poses the reachability map has never reached */
+  bool isUnreachable(const geometry_msgs::msg::Pose& ik_pose, moveit_msgs::msg::MoveItErrorCodes& error_code) const;
+  /** the seed of the reachability map for ik_pose, or ik_seed_state if there is none */
+  const std::vector<double>& getFallbackSeed(const geometry_msgs::msg::Pose& ik_pose,
+                                             const std::vector<double>& ik_seed_state,
+                                             std::vector<double>& seed) const;
 
   /* Using templates and SFINAE magic, we can selectively enable/disable methods depending on
      availability of API in wrapped KinematicsPlugin class.
@@ -298,6 +357,7 @@ private:
     if (!KinematicsPlugin::initialize(node, robot_model, group_name, base_frame, tip_frames, search_discretization))
       return false;
     initCache(robot_model.getName(), group_name, base_frame + tip_frames[0]);
+    loadReachabilityMap(group_name);
     return true;
   }
 
@@ -319,6 +379,7 @@ private:
     if (!KinematicsPlugin::initialize(robot_description, group_name, base_frame, tip_frame, search_discretization))
       return false;
     initCache(robot_description, group_name, base_frame + tip_frame);
+    loadReachabilityMap(group_name);
     return true;
   }
 
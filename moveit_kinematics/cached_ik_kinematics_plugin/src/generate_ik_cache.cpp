@@ -0,0 +1,201 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Offline generation of dense IK caches for the Cached IK Kinematics Plugin */
+
+#include <limits>
+#include <rclcpp/rclcpp.hpp>
+#include <boost/program_options.hpp>
+#include <moveit/cached_ik_kinematics_plugin/cached_ik_kinematics_plugin.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
+#include <moveit/robot_model_loader/robot_model_loader.hpp>
+#include <moveit/utils/logger.hpp>
+
+namespace po = boost::program_options;
+
+// Fill the IK cache of a planning group with random configurations whose end effector lies in a workspace region,
+// such that the Cached IK Kinematics Plugin starts from a dense cache instead of filling it query by query.
+int main(int argc, char* argv[])
+{
+  std::string group_name;
+  std::string base;
+  std::string tip;
+  std::vector<double> region_min;
+  std::vector<double> region_max;
+  unsigned int num;
+  bool check_collisions;
+  cached_ik_kinematics_plugin::IKCache::Options opts;
+  po::options_description desc("Options");
+  // clang-format off
+  desc.add_options()
+      ("help", "show help message")
+      ("group", po::value<std::string>(&group_name)->required(), "name of planning group")
+      ("base", po::value<std::string>(&base)->default_value("default"),
+       "base frame of the IK solver (by default the parent link of the group, like the kinematics plugin loader)")
+      ("tip", po::value<std::string>(&tip)->default_value("default"),
+       "tip frame of the IK solver (by default the last link of the group)")
+      ("min", po::value<std::vector<double>>(&region_min)->multitoken(),
+       "minimum x y z of the workspace region, in the base frame (unbounded by default)")
+      ("max", po::value<std::vector<double>>(&region_max)->multitoken(),
+       "maximum x y z of the workspace region, in the base frame (unbounded by default)")
+      ("num", po::value<unsigned int>(&num)->default_value(100000), "number of random configurations to sample")
+      ("check_collisions", po::value<bool>(&check_collisions)->default_value(true),
+       "whether to skip configurations in self-collision")
+      ("max_cache_size", po::value<unsigned int>(&opts.max_cache_size)->default_value(opts.max_cache_size),
+       "maximum number of cache entries")
+      ("min_pose_distance", po::value<double>(&opts.min_pose_distance)->default_value(opts.min_pose_distance),
+       "minimum distance between end effector poses of cache entries")
+      ("min_joint_config_distance",
+       po::value<double>(&opts.min_joint_config_distance)->default_value(opts.min_joint_config_distance),
+       "minimum distance between joint configurations of cache entries")
+      ("cached_ik_path", po::value<std::string>(&opts.cached_ik_path)->default_value(opts.cached_ik_path),
+       "directory of the cache files (by default the current working directory)");
+  // clang-format on
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+
+  if (vm.count("help") != 0u)
+  {
+    std::cout << desc << '\n';
+    return 1;
+  }
+  po::notify(vm);
+
+  if ((!region_min.empty() && region_min.size() != 3) || (!region_max.empty() && region_max.size() != 3))
+  {
+    std::cerr << "The workspace region corners need 3 coordinates each\n";
+    return 1;
+  }
+  if (region_min.empty())
+    region_min.assign(3, -std::numeric_limits<double>::infinity());
+  if (region_max.empty())
+    region_max.assign(3, std::numeric_limits<double>::infinity());
+
+  rclcpp::init(argc, argv);
+  rclcpp::Node::SharedPtr node = rclcpp::Node::make_shared("generate_ik_cache");
+  moveit::setNodeLoggerName(node->get_name());
+
+  // the kinematics solvers are not loaded, so a cached solver configured for the group can't write the same cache file
+  robot_model_loader::RobotModelLoader robot_model_loader(node, "robot_description", false);
+  const moveit::core::RobotModelPtr& robot_model = robot_model_loader.getModel();
+  if (!robot_model)
+  {
+    RCLCPP_ERROR(node->get_logger(), "Unable to load the robot model");
+    rclcpp::shutdown();
+    return 1;
+  }
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(group_name);
+  if (group == nullptr)
+  {
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  if (base == "default")
+  {
+    const moveit::core::LinkModel* parent = group->getLinkModels().front()->getParentJointModel()->getParentLinkModel();
+    base = parent ? parent->getName() : robot_model->getModelFrame();
+  }
+  if (!base.empty() && base[0] == '/')
+    base = base.substr(1);
+  if (tip == "default")
+    tip = group->getLinkModels().back()->getName();
+  if (!robot_model->hasLinkModel(base) || !robot_model->hasLinkModel(tip))
+  {
+    RCLCPP_ERROR(node->get_logger(), "Unknown base frame '%s' or tip frame '%s'", base.c_str(), tip.c_str());
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  // IK solvers order the configuration like the active joints of the group
+  const std::vector<std::string>& joint_names = group->getActiveJointModelNames();
+  cached_ik_kinematics_plugin::IKCache cache;
+  cache.initializeCache(robot_model->getName(), group_name, base + tip, joint_names.size(), opts);
+
+  planning_scene::PlanningScene planning_scene(robot_model);
+  moveit::core::RobotState& robot_state = planning_scene.getCurrentStateNonConst();
+  robot_state.setToDefaultValues();
+  collision_detection::CollisionRequest collision_request;
+  collision_detection::CollisionResult collision_result;
+  std::vector<double> config(joint_names.size());
+  unsigned int num_outside = 0, num_self_collisions = 0;
+
+  for (unsigned int i = 1; i <= num && cache.size() < opts.max_cache_size; ++i)
+  {
+    robot_state.setToRandomPositions(group);
+    robot_state.updateLinkTransforms();
+    const Eigen::Isometry3d pose =
+        robot_state.getGlobalLinkTransform(base).inverse() * robot_state.getGlobalLinkTransform(tip);
+    const Eigen::Vector3d& position = pose.translation();
+    if ((position.array() < Eigen::Map<const Eigen::Array3d>(region_min.data())).any() ||
+        (position.array() > Eigen::Map<const Eigen::Array3d>(region_max.data())).any())
+    {
+      ++num_outside;
+      continue;
+    }
+    if (check_collisions)
+    {
+      collision_result.clear();
+      planning_scene.checkSelfCollision(collision_request, collision_result);
+      if (collision_result.collision)
+      {
+        ++num_self_collisions;
+        continue;
+      }
+    }
+
+    cached_ik_kinematics_plugin::IKCache::Pose cache_pose;
+    cache_pose.position.setValue(position.x(), position.y(), position.z());
+    const Eigen::Quaterniond orientation(pose.linear());
+    cache_pose.orientation = tf2::Quaternion(orientation.x(), orientation.y(), orientation.z(), orientation.w());
+    for (std::size_t j = 0; j < joint_names.size(); ++j)
+      config[j] = robot_state.getVariablePosition(joint_names[j]);
+    cache.updateCache(cache.getBestApproximateIKSolution(cache_pose), cache_pose, config);
+
+    // make the new entries visible, so that later samples are compared against them
+    if (i % 100 == 0)
+    {
+      cache.flush();
+      RCLCPP_INFO(node->get_logger(),
+                  "%zu cache entries after %u samples, %u outside the workspace region, %u in self-collision",
+                  cache.size(), i, num_outside, num_self_collisions);
+    }
+  }
+  cache.flush();
+  RCLCPP_INFO(node->get_logger(), "Generated %zu cache entries for group %s", cache.size(), group_name.c_str());
+
+  rclcpp::shutdown();
+  return 0;
+}
@@ -35,8 +35,10 @@
 /* Author: Mark Moll */
 
 #include <numeric>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 
 #include <moveit/cached_ik_kinematics_plugin/cached_ik_kinematics_plugin.hpp>
 #include <moveit/utils/logger.hpp>
@@ -49,30 +51,42 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.core.dynamics_solver");
 }
+// number of queued entries that triggers an index update
+constexpr std::size_t BATCH_SIZE = 32;
+// maximum time an entry stays queued before it is inserted
+constexpr std::chrono::milliseconds MAX_QUEUE_TIME(1000);
 }  // namespace
-IKCache::IKCache()
+
+IKCache::IKCache() = default;
+
+IKCache::~IKCache()
+{
+  stopWorker();
+  if (!ik_cache_.empty())
+    saveCache();
+}
+
+std::shared_ptr<IKCache::IKIndex> IKCache::createIndex() const
 {
+  auto index = std::make_shared<IKIndex>();
   // set distance function for nearest-neighbor queries
-  ik_nn_.setDistanceFunction([](const IKEntry* entry1, const IKEntry* entry2) {
+  index->setDistanceFunction([](const IKEntry* entry1, const IKEntry* entry2) {
     double dist = 0.;
     for (unsigned int i = 0; i < entry1->first.size(); ++i)
       dist += entry1->first[i].distance(entry2->first[i]);
     return dist;
   });
-}
-
-IKCache::~IKCache()
-{
-  if (!ik_cache_.empty())
-    saveCache();
+  return index;
 }
 
 void IKCache::initializeCache(const std::string& robot_id, const std::string& group_name, const std::string& cache_name,
                               const unsigned int num_joints, const Options& opts)
 {
+  // insert entries of a previous initialization before they are discarded
+  stopWorker();
+
   // read ROS parameters
   max_cache_size_ = opts.max_cache_size;
-  ik_cache_.reserve(max_cache_size_);
   min_pose_distance_ = opts.min_pose_distance;
   min_config_distance2_ = opts.min_joint_config_distance;
   min_config_distance2_ *= min_config_distance2_;
@@ -91,57 +105,60 @@ void IKCache::initializeCache(const std::string& robot_id, const std::string& gr
                                std::to_string(std::sqrt(min_config_distance2_)) + ".ikcache");
 
   ik_cache_.clear();
-  ik_nn_.clear();
+  std::atomic_store(&ik_nn_, std::shared_ptr<const IKIndex>());
+  num_indexed_entries_ = 0;
+  pending_entries_.clear();
   last_saved_cache_size_ = 0;
   if (std::filesystem::exists(cache_file_name_))
   {
-    // read cache
+    // read the whole cache at once and decode it from memory
     std::ifstream cache_file(cache_file_name_, std::ios_base::binary | std::ios_base::in);
-    cache_file.read(reinterpret_cast<char*>(&last_saved_cache_size_), sizeof(unsigned int));
-    unsigned int num_dofs;
-    cache_file.read(reinterpret_cast<char*>(&num_dofs), sizeof(unsigned int));
-    unsigned int num_tips;
-    cache_file.read(reinterpret_cast<char*>(&num_tips), sizeof(unsigned int));
-
-    RCLCPP_INFO(getLogger(), "Found %d IK solutions for a %d-dof system with %d end effectors in %s",
-                last_saved_cache_size_, num_dofs, num_tips, cache_file_name_.string().c_str());
+    std::vector<char> data((std::istreambuf_iterator<char>(cache_file)), std::istreambuf_iterator<char>());
+    unsigned int header[3] = { 0, 0, 0 };
+    if (data.size() >= sizeof(header))
+      memcpy(header, data.data(), sizeof(header));
+    unsigned int num_dofs = header[1];
+    unsigned int num_tips = header[2];
 
     unsigned int position_size = 3 * sizeof(tf2Scalar);
     unsigned int orientation_size = 4 * sizeof(tf2Scalar);
     unsigned int pose_size = position_size + orientation_size;
     unsigned int config_size = num_dofs * sizeof(double);
     unsigned int offset_conf = pose_size * num_tips;
-    unsigned int bufsize = offset_conf + config_size;
-    char* buffer = new char[bufsize];
-    IKEntry entry;
-    entry.first.resize(num_tips);
-    entry.second.resize(num_dofs);
-    ik_cache_.reserve(last_saved_cache_size_);
-
-    for (unsigned i = 0; i < last_saved_cache_size_; ++i)
+    std::size_t entry_size = offset_conf + config_size;
+    std::size_t num_stored = entry_size > 0 ? (data.size() - sizeof(header)) / entry_size : 0;
+    if (num_stored < header[0])
+    {
+      RCLCPP_WARN(getLogger(), "Cache file %s is truncated, reading %zu of %d IK solutions",
+                  cache_file_name_.string().c_str(), num_stored, header[0]);
+    }
+    last_saved_cache_size_ = std::min<std::size_t>(header[0], num_stored);
+
+    RCLCPP_INFO(getLogger(), "Found %d IK solutions for a %d-dof system with %d end effectors in %s",
+                last_saved_cache_size_, num_dofs, num_tips, cache_file_name_.string().c_str());
+
+    const char* buffer = data.data() + sizeof(header);
+    for (unsigned i = 0; i < last_saved_cache_size_; ++i, buffer += entry_size)
     {
+      IKEntry& entry = ik_cache_.emplace_back(std::vector<Pose>(num_tips), std::vector<double>(num_dofs));
       unsigned int j = 0;
-      cache_file.read(buffer, bufsize);
       for (auto& pose : entry.first)
       {
         memcpy(&pose.position[0], buffer + j * pose_size, position_size);
         memcpy(&pose.orientation[0], buffer + j * pose_size + position_size, orientation_size);
         ++j;
       }
-      memcpy(&entry.second[0], buffer + offset_conf, config_size);
-      ik_cache_.push_back(entry);
+      memcpy(entry.second.data(), buffer + offset_conf, config_size);
     }
-    RCLCPP_INFO(getLogger(), "freeing buffer");
-    delete[] buffer;
-    RCLCPP_INFO(getLogger(), "freed buffer");
-    std::vector<IKEntry*> ik_entry_ptrs(last_saved_cache_size_);
-    for (unsigned int i = 0; i < last_saved_cache_size_; ++i)
-      ik_entry_ptrs[i] = &ik_cache_[i];
-    ik_nn_.add(ik_entry_ptrs);
   }
+  num_entries_ = ik_cache_.size();
 
   num_joints_ = num_joints;
 
+  // the background thread builds the index of the loaded entries, so lookups start before it is complete
+  stop_worker_ = false;
+  worker_ = std::thread([this] { updateIndexLoop(); });
+
   RCLCPP_INFO(getLogger(), "cache file %s initialized!", cache_file_name_.string().c_str());
 }
 
@@ -158,43 +175,39 @@ double IKCache::configDistance2(const std::vector<double>& config1, const std::v
 
 const IKCache::IKEntry& IKCache::getBestApproximateIKSolution(const Pose& pose) const
 {
-  if (ik_cache_.empty())
+  std::shared_ptr<const IKIndex> ik_nn = std::atomic_load(&ik_nn_);
+  if (!ik_nn || ik_nn->size() == 0)
   {
     static IKEntry dummy = std::make_pair(std::vector<Pose>(1, pose), std::vector<double>(num_joints_, 0.));
     return dummy;
   }
   IKEntry query = std::make_pair(std::vector<Pose>(1, pose), std::vector<double>());
-  return *ik_nn_.nearest(&query);
+  return *ik_nn->nearest(&query);
 }
 
 const IKCache::IKEntry& IKCache::getBestApproximateIKSolution(const std::vector<Pose>& poses) const
 {
-  if (ik_cache_.empty())
+  std::shared_ptr<const IKIndex> ik_nn = std::atomic_load(&ik_nn_);
+  if (!ik_nn || ik_nn->size() == 0)
   {
     static IKEntry dummy = std::make_pair(poses, std::vector<double>(num_joints_, 0.));
     return dummy;
   }
   IKEntry query = std::make_pair(poses, std::vector<double>());
-  return *ik_nn_.nearest(&query);
+  return *ik_nn->nearest(&query);
 }
 
 void IKCache::updateCache(const IKEntry& nearest, const Pose& pose, const std::vector<double>& config) const
 {
-  if (ik_cache_.size() < ik_cache_.capacity() && (nearest.first[0].distance(pose) > min_pose_distance_ ||
-                                                  configDistance2(nearest.second, config) > min_config_distance2_))
-  {
-    std::lock_guard<std::mutex> slock(lock_);
-    ik_cache_.emplace_back(std::vector<Pose>(1u, pose), config);
-    ik_nn_.add(&ik_cache_.back());
-    if (ik_cache_.size() >= last_saved_cache_size_ + 500u || ik_cache_.size() == max_cache_size_)
-      saveCache();
-  }
+  if (num_entries_ < max_cache_size_ && (nearest.first[0].distance(pose) > min_pose_distance_ ||
+                                         configDistance2(nearest.second, config) > min_config_distance2_))
+    queueEntry(std::vector<Pose>(1u, pose), config);
 }
 
 void IKCache::updateCache(const IKEntry& nearest, const std::vector<Pose>& poses,
                           const std::vector<double>& config) const
 {
-  if (ik_cache_.size() < ik_cache_.capacity())
+  if (num_entries_ < max_cache_size_)
   {
     bool add_to_cache = configDistance2(nearest.second, config) > min_config_distance2_;
     if (!add_to_cache)
@@ -211,20 +224,96 @@ void IKCache::updateCache(const IKEntry& nearest, const std::vector<Pose>& poses
       }
     }
     if (add_to_cache)
+      queueEntry(poses, config);
+  }
+}
+
+void IKCache::queueEntry(const std::vector<Pose>& poses, const std::vector<double>& config) const
+{
+  std::lock_guard<std::mutex> slock(lock_);
+  // concurrent callers may have filled the cache since the unlocked check
+  if (!worker_.joinable() || num_entries_ >= max_cache_size_)
+    return;
+  pending_entries_.emplace_back(poses, config);
+  ++num_entries_;
+  if (pending_entries_.size() >= BATCH_SIZE || num_entries_ == max_cache_size_)
+    worker_condition_.notify_one();
+}
+
+void IKCache::flush() const
+{
+  std::unique_lock<std::mutex> slock(lock_);
+  flush_requested_ = true;
+  worker_condition_.notify_one();
+  index_condition_.wait(slock, [this] {
+    return !worker_.joinable() || (pending_entries_.empty() && num_indexed_entries_ == ik_cache_.size());
+  });
+}
+
+void IKCache::updateIndexLoop()
+{
+  std::unique_lock<std::mutex> slock(lock_);
+  while (true)
+  {
+    worker_condition_.wait_for(slock, MAX_QUEUE_TIME, [this] {
+      return stop_worker_ || flush_requested_ || num_indexed_entries_ != ik_cache_.size() ||
+             pending_entries_.size() >= BATCH_SIZE || (!pending_entries_.empty() && num_entries_ == max_cache_size_);
+    });
+    flush_requested_ = false;
+
+    if (!pending_entries_.empty() || num_indexed_entries_ != ik_cache_.size())
     {
-      std::lock_guard<std::mutex> slock(lock_);
-      ik_cache_.emplace_back(poses, config);
-      ik_nn_.add(&ik_cache_.back());
-      if (ik_cache_.size() >= last_saved_cache_size_ + 500u || ik_cache_.size() == max_cache_size_)
+      for (IKEntry& entry : pending_entries_)
+        ik_cache_.push_back(std::move(entry));
+      pending_entries_.clear();
+      const std::size_t num_entries = ik_cache_.size();
+
+      // only this thread modifies ik_cache_, so the index can be built without blocking updateCache()
+      slock.unlock();
+      std::shared_ptr<IKIndex> ik_nn = createIndex();
+      std::vector<IKEntry*> ik_entry_ptrs(num_entries);
+      for (std::size_t i = 0; i < num_entries; ++i)
+        ik_entry_ptrs[i] = &ik_cache_[i];
+      ik_nn->add(ik_entry_ptrs);
+      std::atomic_store(&ik_nn_, std::shared_ptr<const IKIndex>(std::move(ik_nn)));
+      if (num_entries >= last_saved_cache_size_ + 500u || num_entries == max_cache_size_)
         saveCache();
+      slock.lock();
+
+      num_indexed_entries_ = num_entries;
     }
+    index_condition_.notify_all();
+
+    if (stop_worker_ && pending_entries_.empty())
+      break;
+  }
+}
+
+void IKCache::stopWorker()
+{
+  std::thread worker;
+  {
+    std::lock_guard<std::mutex> slock(lock_);
+    if (!worker_.joinable())
+      return;
+    stop_worker_ = true;
+    worker = std::move(worker_);
+    worker_condition_.notify_one();
   }
+  worker.join();
+  // wake up flush() callers waiting for the stopped thread
+  index_condition_.notify_all();
 }
 
 void IKCache::saveCache() const
 {
   if (cache_file_name_.empty())
+  {
     RCLCPP_ERROR(getLogger(), "can't save cache before initialization");
+    return;
+  }
+  if (ik_cache_.empty())
+    return;
 
   RCLCPP_INFO(getLogger(), "writing %ld IK solutions to %s", ik_cache_.size(), cache_file_name_.string().c_str());
 
@@ -263,6 +352,8 @@ void IKCache::verifyCache(kdl_kinematics_plugin::KDLKinematicsPlugin& fk) const
   std::vector<geometry_msgs::msg::Pose> poses(tip_names.size());
   double error, max_error = 0.;
 
+  flush();
+  std::lock_guard<std::mutex> slock(lock_);
   for (const auto& entry : ik_cache_)
   {
     fk.getPositionFK(tip_names, entry.second, poses);
@@ -49,6 +49,10 @@
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <ikfast_kinematics_parameters.hpp>
 #include <moveit/utils/logger.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
 
 using namespace moveit::core;
 
@@ -145,17 +149,8 @@ enum IkParameterizationType
   /// when serializing the ik parameterizations
 };
 
-// struct for storing and sorting solutions
-struct LimitObeyingSol
-{
-  std::vector<double> value;
-  double dist_from_seed;
-
-  bool operator<(const LimitObeyingSol& a) const
-  {
-    return dist_from_seed < a.dist_from_seed;
-  }
-};
+// minimum number of redundant joint samples solved by each thread
+const std::size_t MIN_SAMPLES_PER_THREAD = 8;
 
 // Code generated by IKFast56/61
 #include "_ROBOT_NAME___GROUP_NAME__ikfast_solver.cpp"
@@ -247,6 +242,16 @@ public:
                      std::vector<std::vector<double>>& solutions, kinematics::KinematicsResult& result,
                      const kinematics::KinematicsQueryOptions& options) const override;
 
+  /**
+   * @brief Given a desired pose of the end-effector, compute all joint solutions within the joint limits.
+   *
+   * The solutions are filtered in a single contiguous buffer and sorted by their distance to the seed. The samples of
+   * the redundant joint are solved in parallel.
+   */
+  bool getPositionIKSolutions(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                              std::vector<double>& solutions, kinematics::KinematicsResult& result,
+                              const kinematics::KinematicsQueryOptions& options) const override;
+
   /**
    * @brief Given a desired pose of the end-effector, search for the joint angles required to reach it.
    * This particular method is intended for "searching" for a solutions by stepping through the redundancy
@@ -305,6 +310,26 @@ public:
       const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
       const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
 
+  /**
+   * @brief Given a batch of independent desired poses of the end-effector, search for the joint angles reaching each
+   * of them. The analytic solver is stateless, so the poses are solved in parallel.
+   */
+  bool searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                             const std::vector<std::vector<double>>& ik_seed_states, double timeout,
+                             std::vector<std::vector<double>>& solutions,
+                             std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                             const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions(),
+                             std::size_t thread_count = 0) const override
+  {
+    return searchPositionIKBatchParallel(ik_poses, ik_seed_states, timeout, solutions, error_codes, options,
+                                         thread_count);
+  }
+
+  bool supportsParallelIKBatch() const override
+  {
+    return true;
+  }
+
   /**
    * @brief Given a set of joint angles and a set of links, compute their pose
    *
@@ -354,6 +379,25 @@ private:
   void getSolution(const IkSolutionList<IkReal>& solutions, const std::vector<double>& ik_seed_state, int i,
                    std::vector<double>& solution) const;
 
+  /**
+   * @brief Rotates joints by 360° to be near seed state where possible, after enforcing the joint limits
+   */
+  void adjustToSeed(const std::vector<double>& ik_seed_state, double* solution) const;
+
+  /**
+   * @brief Appends the solutions of the set that are within the joint limits to a contiguous buffer
+   * @param tolerance Tolerance of the joint limit check
+   * @param buffer Joint values of the solutions, num_joints_ per solution, adjusted to the seed state
+   * @return The number of appended solutions
+   */
+  size_t appendSolutionsWithinLimits(const IkSolutionList<IkReal>& solutions, const std::vector<double>& ik_seed_state,
+                                     double tolerance, std::vector<double>& buffer) const;
+
+  /**
+   * @brief Sorts the solutions of a contiguous buffer by their distance to the seed state
+   */
+  void sortByDistanceToSeed(const std::vector<double>& ik_seed_state, std::vector<double>& buffer) const;
+
   /**
    * @brief If the value is outside of min/max then it tries to +/- 2 * pi to put the value into the range
    */
@@ -690,7 +734,11 @@ void IKFastKinematicsPlugin::getSolution(const IkSolutionList<IkReal>& solutions
   const IkSolutionBase<IkReal>& sol = solutions.GetSolution(i);
   std::vector<IkReal> vsolfree(sol.GetFree().size());
   sol.GetSolution(&solution[0], vsolfree.size() > 0 ? &vsolfree[0] : nullptr);
+  adjustToSeed(ik_seed_state, solution.data());
+}
 
+void IKFastKinematicsPlugin::adjustToSeed(const std::vector<double>& ik_seed_state, double* solution) const
+{
   // rotate joints by +/-360° where it is possible and useful
   for (std::size_t i = 0; i < num_joints_; ++i)
   {
@@ -712,6 +760,65 @@ void IKFastKinematicsPlugin::getSolution(const IkSolutionList<IkReal>& solutions
   }
 }
 
+size_t IKFastKinematicsPlugin::appendSolutionsWithinLimits(const IkSolutionList<IkReal>& solutions,
+                                                           const std::vector<double>& ik_seed_state, double tolerance,
+                                                           std::vector<double>& buffer) const
+{
+  const size_t num_solutions = solutions.GetNumSolutions();
+  size_t num_appended = 0;
+  std::vector<IkReal> vsolfree;
+  buffer.reserve(buffer.size() + num_solutions * num_joints_);
+  for (size_t s = 0; s < num_solutions; ++s)
+  {
+    // IKFast56/61
+    const IkSolutionBase<IkReal>& sol = solutions.GetSolution(s);
+    vsolfree.resize(sol.GetFree().size());
+    const size_t offset = buffer.size();
+    buffer.resize(offset + num_joints_);
+    double* values = buffer.data() + offset;
+    sol.GetSolution(values, vsolfree.size() > 0 ? &vsolfree[0] : nullptr);
+    adjustToSeed(ik_seed_state, values);
+
+    bool obeys_limits = true;
+    for (size_t i = 0; i < num_joints_; ++i)
+    {
+      if (joint_has_limits_vector_[i] &&
+          ((values[i] < (joint_min_vector_[i] - tolerance)) || (values[i] > (joint_max_vector_[i] + tolerance))))
+      {
+        obeys_limits = false;
+        break;
+      }
+    }
+    if (obeys_limits)
+      ++num_appended;
+    else
+      buffer.resize(offset);
+  }
+  return num_appended;
+}
+
+void IKFastKinematicsPlugin::sortByDistanceToSeed(const std::vector<double>& ik_seed_state,
+                                                  std::vector<double>& buffer) const
+{
+  const size_t num_solutions = buffer.size() / num_joints_;
+  std::vector<std::pair<double, size_t>> order(num_solutions);
+  for (size_t s = 0; s < num_solutions; ++s)
+  {
+    double dist_from_seed = 0.0;
+    for (size_t i = 0; i < num_joints_; ++i)
+      dist_from_seed += fabs(ik_seed_state[i] - buffer[s * num_joints_ + i]);
+    order[s] = std::make_pair(dist_from_seed, s);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<double> sorted(buffer.size());
+  for (size_t s = 0; s < num_solutions; ++s)
+  {
+    std::copy_n(buffer.begin() + order[s].second * num_joints_, num_joints_, sorted.begin() + s * num_joints_);
+  }
+  buffer.swap(sorted);
+}
+
 double IKFastKinematicsPlugin::enforceLimits(double joint_value, double min, double max) const
 {
   // If the joint_value is greater than max subtract 2 * PI until it is less than the max
@@ -878,40 +985,25 @@ bool IKFastKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik
   {
     RCLCPP_DEBUG_STREAM(getLogger(), "No need to search since no free params/redundant joints");
 
-    std::vector<geometry_msgs::msg::Pose> ik_poses(1, ik_pose);
-    std::vector<std::vector<double>> solutions;
+    // Find all IK solutions within joint limits, sorted by their distance to the seed
+    std::vector<double> solutions;
     kinematics::KinematicsResult kinematic_result;
-    // Find all IK solutions within joint limits
-    if (!getPositionIK(ik_poses, ik_seed_state, solutions, kinematic_result, options))
+    if (!getPositionIKSolutions(ik_pose, ik_seed_state, solutions, kinematic_result, options))
     {
       RCLCPP_DEBUG(getLogger(), "No solution whatsoever");
       error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
       return false;
     }
 
-    // sort solutions by their distance to the seed
-    std::vector<LimitObeyingSol> solutions_obey_limits;
-    for (std::size_t i = 0; i < solutions.size(); ++i)
-    {
-      double dist_from_seed = 0.0;
-      for (std::size_t j = 0; j < ik_seed_state.size(); ++j)
-      {
-        dist_from_seed += fabs(ik_seed_state[j] - solutions[i][j]);
-      }
-
-      solutions_obey_limits.push_back({ solutions[i], dist_from_seed });
-    }
-    std::sort(solutions_obey_limits.begin(), solutions_obey_limits.end());
-
     // check for collisions if a callback is provided
     if (solution_callback)
     {
-      for (std::size_t i = 0; i < solutions_obey_limits.size(); ++i)
+      for (size_t offset = 0; offset < solutions.size(); offset += num_joints_)
       {
-        solution_callback(ik_pose, solutions_obey_limits[i].value, error_code);
+        solution.assign(solutions.begin() + offset, solutions.begin() + offset + num_joints_);
+        solution_callback(ik_pose, solution, error_code);
         if (error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
         {
-          solution = solutions_obey_limits[i].value;
           RCLCPP_DEBUG(getLogger(), "Solution passes callback");
           return true;
         }
@@ -922,7 +1014,7 @@ bool IKFastKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik
     }
     else
     {
-      solution = solutions_obey_limits[0].value;
+      solution.assign(solutions.begin(), solutions.begin() + num_joints_);
       error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
       return true;  // no collision check callback provided
     }
@@ -1001,70 +1093,54 @@ bool IKFastKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik
   std::vector<double> best_solution;
   int nattempts = 0, nvalid = 0;
 
+  IkSolutionList<IkReal> solutions;
+  std::vector<double> solutions_within_limits;
   while (true)
   {
-    IkSolutionList<IkReal> solutions;
     size_t numsol = solve(frame, vfree, solutions);
 
     RCLCPP_DEBUG_STREAM(getLogger(), "Found " << numsol << " solutions from IKFast");
 
-    if (numsol > 0)
+    nattempts += numsol;
+    solutions_within_limits.clear();
+    appendSolutionsWithinLimits(solutions, ik_seed_state, 0.0, solutions_within_limits);
+    for (size_t offset = 0; offset < solutions_within_limits.size(); offset += num_joints_)
     {
-      for (size_t s = 0; s < numsol; ++s)
+      solution.assign(solutions_within_limits.begin() + offset,
+                      solutions_within_limits.begin() + offset + num_joints_);
+
+      // This solution is within joint limits, now check if in collision (if callback provided)
+      if (solution_callback)
+      {
+        solution_callback(ik_pose, solution, error_code);
+      }
+      else
       {
-        nattempts++;
-        std::vector<double> sol;
-        getSolution(solutions, ik_seed_state, s, sol);
+        error_code.val = error_code.SUCCESS;
+      }
 
-        bool obeys_limits = true;
-        for (size_t i = 0; i < sol.size(); ++i)
-        {
-          if (joint_has_limits_vector_[i] && (sol[i] < joint_min_vector_[i] || sol[i] > joint_max_vector_[i]))
-          {
-            obeys_limits = false;
-            break;
-          }
-          // RCLCPP_INFO_STREAM(getLogger(),"Num " << i << " value " << sol[i] << " has limits " <<
-          // joint_has_limits_vector_[i] << " " << joint_min_vector_[i] << " " << joint_max_vector_[i]);
-        }
-        if (obeys_limits)
+      if (error_code.val == error_code.SUCCESS)
+      {
+        nvalid++;
+        if (search_mode & OPTIMIZE_MAX_JOINT)
         {
-          getSolution(solutions, ik_seed_state, s, solution);
-
-          // This solution is within joint limits, now check if in collision (if callback provided)
-          if (solution_callback)
+          // Costs for solution: Largest joint motion
+          double costs = 0.0;
+          for (unsigned int i = 0; i < solution.size(); ++i)
           {
-            solution_callback(ik_pose, solution, error_code);
+            double d = fabs(ik_seed_state[i] - solution[i]);
+            if (d > costs)
+              costs = d;
           }
-          else
+          if (costs < best_costs || best_costs == -1.0)
           {
-            error_code.val = error_code.SUCCESS;
-          }
-
-          if (error_code.val == error_code.SUCCESS)
-          {
-            nvalid++;
-            if (search_mode & OPTIMIZE_MAX_JOINT)
-            {
-              // Costs for solution: Largest joint motion
-              double costs = 0.0;
-              for (unsigned int i = 0; i < solution.size(); ++i)
-              {
-                double d = fabs(ik_seed_state[i] - solution[i]);
-                if (d > costs)
-                  costs = d;
-              }
-              if (costs < best_costs || best_costs == -1.0)
-              {
-                best_costs = costs;
-                best_solution = solution;
-              }
-            }
-            else
-              // Return first feasible solution
-              return true;
+            best_costs = costs;
+            best_solution = solution;
           }
         }
+        else
+          // Return first feasible solution
+          return true;
       }
     }
 
@@ -1145,62 +1221,32 @@ bool IKFastKinematicsPlugin::getPositionIK(const geometry_msgs::msg::Pose& ik_po
   size_t numsol = solve(frame, vfree, solutions);
   RCLCPP_DEBUG_STREAM(getLogger(), "Found " << numsol << " solutions from IKFast");
 
-  std::vector<LimitObeyingSol> solutions_obey_limits;
-
-  if (numsol)
+  // find the solution within limits that is closest to ik_seed_state in a single pass
+  std::vector<double> solutions_within_limits;
+  appendSolutionsWithinLimits(solutions, ik_seed_state, LIMIT_TOLERANCE, solutions_within_limits);
+  size_t best_offset = 0;
+  double best_dist_from_seed = std::numeric_limits<double>::infinity();
+  for (size_t offset = 0; offset < solutions_within_limits.size(); offset += num_joints_)
   {
-    std::vector<double> solution_obey_limits;
-    for (std::size_t s = 0; s < numsol; ++s)
+    double dist_from_seed = 0.0;
+    for (size_t i = 0; i < num_joints_; ++i)
+      dist_from_seed += fabs(ik_seed_state[i] - solutions_within_limits[offset + i]);
+    if (dist_from_seed < best_dist_from_seed)
     {
-      std::vector<double> sol;
-      getSolution(solutions, ik_seed_state, s, sol);
-      RCLCPP_DEBUG(getLogger(), "Sol %d: %e   %e   %e   %e   %e   %e", static_cast<int>(s), sol[0], sol[1], sol[2],
-                   sol[3], sol[4], sol[5]);
-
-      bool obeys_limits = true;
-      for (std::size_t i = 0; i < sol.size(); ++i)
-      {
-        // Add tolerance to limit check
-        if (joint_has_limits_vector_[i] && ((sol[i] < (joint_min_vector_[i] - LIMIT_TOLERANCE)) ||
-                                            (sol[i] > (joint_max_vector_[i] + LIMIT_TOLERANCE))))
-        {
-          // One element of solution is not within limits
-          obeys_limits = false;
-          RCLCPP_DEBUG_STREAM(getLogger(), "Not in limits! " << static_cast<int>(i) << " value " << sol[i]
-                                                             << " has limit: " << joint_has_limits_vector_[i]
-                                                             << "  being  " << joint_min_vector_[i] << " to "
-                                                             << joint_max_vector_[i]);
-          break;
-        }
-      }
-      if (obeys_limits)
-      {
-        // All elements of this solution obey limits
-        getSolution(solutions, ik_seed_state, s, solution_obey_limits);
-        double dist_from_seed = 0.0;
-        for (std::size_t i = 0; i < ik_seed_state.size(); ++i)
-        {
-          dist_from_seed += fabs(ik_seed_state[i] - solution_obey_limits[i]);
-        }
-
-        solutions_obey_limits.push_back({ solution_obey_limits, dist_from_seed });
-      }
+      best_dist_from_seed = dist_from_seed;
+      best_offset = offset;
     }
   }
-  else
-  {
-    RCLCPP_DEBUG(getLogger(), "No IK solution");
-  }
 
-  // Sort the solutions under limits and find the one that is closest to ik_seed_state
-  if (!solutions_obey_limits.empty())
+  if (!solutions_within_limits.empty())
   {
-    std::sort(solutions_obey_limits.begin(), solutions_obey_limits.end());
-    solution = solutions_obey_limits[0].value;
+    solution.assign(solutions_within_limits.begin() + best_offset,
+                    solutions_within_limits.begin() + best_offset + num_joints_);
     error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
     return true;
   }
 
+  RCLCPP_DEBUG(getLogger(), "No IK solution within limits");
   error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
   return false;
 }
@@ -1213,13 +1259,6 @@ bool IKFastKinematicsPlugin::getPositionIK(const std::vector<geometry_msgs::msg:
 {
   RCLCPP_DEBUG_STREAM(getLogger(), "getPositionIK with multiple solutions");
 
-  if (!initialized_)
-  {
-    RCLCPP_ERROR(getLogger(), "kinematics not active");
-    result.kinematic_error = kinematics::KinematicErrors::SOLVER_NOT_ACTIVE;
-    return false;
-  }
-
   if (ik_poses.empty())
   {
     RCLCPP_ERROR(getLogger(), "ik_poses is empty");
@@ -1234,6 +1273,30 @@ bool IKFastKinematicsPlugin::getPositionIK(const std::vector<geometry_msgs::msg:
     return false;
   }
 
+  std::vector<double> solution_buffer;
+  if (!getPositionIKSolutions(ik_poses[0], ik_seed_state, solution_buffer, result, options))
+    return false;
+
+  for (size_t offset = 0; offset < solution_buffer.size(); offset += num_joints_)
+    solutions.emplace_back(solution_buffer.begin() + offset, solution_buffer.begin() + offset + num_joints_);
+  return true;
+}
+
+bool IKFastKinematicsPlugin::getPositionIKSolutions(const geometry_msgs::msg::Pose& ik_pose,
+                                                    const std::vector<double>& ik_seed_state,
+                                                    std::vector<double>& solutions,
+                                                    kinematics::KinematicsResult& result,
+                                                    const kinematics::KinematicsQueryOptions& options) const
+{
+  solutions.clear();
+
+  if (!initialized_)
+  {
+    RCLCPP_ERROR(getLogger(), "kinematics not active");
+    result.kinematic_error = kinematics::KinematicErrors::SOLVER_NOT_ACTIVE;
+    return false;
+  }
+
   if (ik_seed_state.size() < num_joints_)
   {
     RCLCPP_ERROR_STREAM(getLogger(), "ik_seed_state only has " << ik_seed_state.size()
@@ -1243,13 +1306,9 @@ bool IKFastKinematicsPlugin::getPositionIK(const std::vector<geometry_msgs::msg:
   }
 
   KDL::Frame frame;
-  transformToChainFrame(ik_poses[0], frame);
+  transformToChainFrame(ik_pose, frame);
 
   // solving ik
-  std::vector<IkSolutionList<IkReal>> solution_set;
-  IkSolutionList<IkReal> ik_solutions;
-  std::vector<double> vfree;
-  int numsol = 0;
   std::vector<double> sampled_joint_vals;
   if (!redundant_joint_indices_.empty())
   {
@@ -1278,72 +1337,54 @@ bool IKFastKinematicsPlugin::getPositionIK(const std::vector<geometry_msgs::msg:
       result.kinematic_error = kinematics::KinematicErrors::UNSUPORTED_DISCRETIZATION_REQUESTED;
       return false;
     }
-
-    for (unsigned int i = 0; i < sampled_joint_vals.size(); ++i)
-    {
-      vfree.clear();
-      vfree.push_back(sampled_joint_vals[i]);
-      numsol += solve(frame, vfree, ik_solutions);
-      solution_set.push_back(ik_solutions);
-    }
   }
-  else
+
+  if (sampled_joint_vals.size() <= 1)
   {
     // computing for single solution set
-    numsol = solve(frame, vfree, ik_solutions);
-    solution_set.push_back(ik_solutions);
+    IkSolutionList<IkReal> ik_solutions;
+    solve(frame, sampled_joint_vals, ik_solutions);
+    appendSolutionsWithinLimits(ik_solutions, ik_seed_state, LIMIT_TOLERANCE, solutions);
   }
-
-  RCLCPP_DEBUG_STREAM(getLogger(), "Found " << numsol << " solutions from IKFast");
-  bool solutions_found = false;
-  if (numsol > 0)
+  else
   {
-    /*
-      Iterating through all solution sets and storing those that do not exceed joint limits.
-    */
-    for (unsigned int r = 0; r < solution_set.size(); ++r)
-    {
-      ik_solutions = solution_set[r];
-      numsol = ik_solutions.GetNumSolutions();
-      for (int s = 0; s < numsol; ++s)
+    // the analytic solver is stateless, so the samples of the redundant joint are solved in parallel, each into its
+    // own buffer to keep the order of the samples
+    std::vector<std::vector<double>> sample_solutions(sampled_joint_vals.size());
+    std::atomic<size_t> next_sample{ 0 };
+    const auto solve_samples = [&] {
+      KDL::Frame sample_frame = frame;
+      IkSolutionList<IkReal> ik_solutions;
+      std::vector<double> vfree(1);
+      for (size_t i = next_sample++; i < sampled_joint_vals.size(); i = next_sample++)
       {
-        std::vector<double> sol;
-        getSolution(ik_solutions, ik_seed_state, s, sol);
-
-        bool obeys_limits = true;
-        for (unsigned int i = 0; i < sol.size(); ++i)
-        {
-          // Add tolerance to limit check
-          if (joint_has_limits_vector_[i] && ((sol[i] < (joint_min_vector_[i] - LIMIT_TOLERANCE)) ||
-                                              (sol[i] > (joint_max_vector_[i] + LIMIT_TOLERANCE))))
-          {
-            // One element of solution is not within limits
-            obeys_limits = false;
-            RCLCPP_DEBUG_STREAM(getLogger(), "Not in limits! " << i << " value " << sol[i]
-                                                               << " has limit: " << joint_has_limits_vector_[i]
-                                                               << "  being  " << joint_min_vector_[i] << " to "
-                                                               << joint_max_vector_[i]);
-            break;
-          }
-        }
-        if (obeys_limits)
-        {
-          // All elements of solution obey limits
-          solutions_found = true;
-          solutions.push_back(sol);
-        }
+        vfree[0] = sampled_joint_vals[i];
+        solve(sample_frame, vfree, ik_solutions);
+        appendSolutionsWithinLimits(ik_solutions, ik_seed_state, LIMIT_TOLERANCE, sample_solutions[i]);
       }
-    }
-
-    if (solutions_found)
-    {
-      result.kinematic_error = kinematics::KinematicErrors::OK;
-      return true;
-    }
+    };
+
+    const size_t thread_count =
+        std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                         (sampled_joint_vals.size() + MIN_SAMPLES_PER_THREAD - 1) / MIN_SAMPLES_PER_THREAD);
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (size_t i = 1; i < thread_count; ++i)
+      threads.emplace_back(solve_samples);
+    solve_samples();
+    for (std::thread& thread : threads)
+      thread.join();
+
+    for (const std::vector<double>& sample_solution : sample_solutions)
+      solutions.insert(solutions.end(), sample_solution.begin(), sample_solution.end());
   }
-  else
+
+  RCLCPP_DEBUG_STREAM(getLogger(), "Found " << solutions.size() / num_joints_ << " solutions within limits");
+  if (!solutions.empty())
   {
-    RCLCPP_DEBUG_STREAM(getLogger(), "No IK solution");
+    sortByDistanceToSeed(ik_seed_state, solutions);
+    result.kinematic_error = kinematics::KinematicErrors::OK;
+    return true;
   }
 
   result.kinematic_error = kinematics::KinematicErrors::NO_SOLUTION;
@@ -60,6 +60,10 @@
 #include <moveit/robot_state/robot_state.hpp>
 
 #include <cfloat>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace KDL
 {
@@ -68,6 +72,8 @@ class ChainIkSolverVelMimicSVD;
 
 namespace kdl_kinematics_plugin
 {
+struct SolverWorkspace;
+
 /**
  * @brief Specific implementation of kinematics using KDL.
  * This version supports any kinematic chain, also including mimic joints.
@@ -75,10 +81,21 @@ namespace kdl_kinematics_plugin
 class KDLKinematicsPlugin : public kinematics::KinematicsBase
 {
 public:
+  /**
+   * @brief Convergence statistics of the last searchPositionIK() call of a thread
+   */
+  struct SolverStatistics
+  {
+    unsigned int attempts = 0;    ///< Number of seeds tried, i.e. random restarts plus one
+    unsigned int iterations = 0;  ///< Solver iterations summed over all attempts
+    bool converged = false;       ///< Whether a solution was returned
+  };
+
   /**
    *  @brief Default constructor
    */
   KDLKinematicsPlugin();
+  ~KDLKinematicsPlugin() override;
 
   bool
   getPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
@@ -108,9 +125,29 @@ public:
       const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
       const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions()) const override;
 
+  /**
+   * @brief Solve the poses in parallel, searchPositionIK() keeps all mutable solver state local to the calling thread
+   */
+  bool searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                             const std::vector<std::vector<double> >& ik_seed_states, double timeout,
+                             std::vector<std::vector<double> >& solutions,
+                             std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                             const kinematics::KinematicsQueryOptions& options = kinematics::KinematicsQueryOptions(),
+                             std::size_t thread_count = 0) const override;
+
+  bool supportsParallelIKBatch() const override
+  {
+    return true;
+  }
+
   bool getPositionFK(const std::vector<std::string>& link_names, const std::vector<double>& joint_angles,
                      std::vector<geometry_msgs::msg::Pose>& poses) const override;
 
+  /**
+   * @brief Get the statistics of the last searchPositionIK() call made by the calling thread
+   */
+  SolverStatistics getLastSolverStatistics() const;
+
   bool initialize(const rclcpp::Node::SharedPtr& node, const moveit::core::RobotModel& robot_model,
                   const std::string& group_name, const std::string& base_frame,
                   const std::vector<std::string>& tip_frames, double search_discretization) override;
@@ -134,7 +171,16 @@ protected:
                 KDL::JntArray& q_out, const unsigned int max_iter, const Eigen::VectorXd& joint_weights,
                 const Twist& cartesian_weights) const;
 
+  /// Solve position IK with Levenberg-Marquardt steps projected onto the joint limits, returns the same codes as
+  /// CartToJnt()
+  int solveLevenbergMarquardt(const KDL::JntArray& q_init, const KDL::Frame& p_in, KDL::JntArray& q_out,
+                              const unsigned int max_iter, const Eigen::VectorXd& joint_weights,
+                              const Twist& cartesian_weights) const;
+
 private:
+  /** @brief Get the solvers of the calling thread, the lookup only locks the first time a thread uses this plugin */
+  SolverWorkspace& getSolverWorkspace() const;
+
   void getJointWeights();
   bool timedOut(const rclcpp::Time& start_time, double duration) const;
 
@@ -147,6 +193,9 @@ private:
   bool checkConsistency(const Eigen::VectorXd& seed_state, const std::vector<double>& consistency_limits,
                         const Eigen::VectorXd& solution) const;
 
+  /** @brief Random number generator of the calling thread */
+  static random_numbers::RandomNumberGenerator& getRandomNumberGenerator();
+
   void getRandomConfiguration(Eigen::VectorXd& jnt_array) const;
 
   /** @brief Get a random configuration within consistency limits close to the seed state
@@ -166,14 +215,16 @@ private:
   moveit_msgs::msg::KinematicSolverInfo solver_info_;  ///< Stores information for the inverse kinematics solver
 
   const moveit::core::JointModelGroup* joint_model_group_;
-  moveit::core::RobotStatePtr state_;
   KDL::Chain kdl_chain_;
-  std::unique_ptr<KDL::ChainFkSolverPos> fk_solver_;
   std::vector<JointMimic> mimic_joints_;
   std::vector<double> joint_weights_;
   Eigen::VectorXd joint_min_, joint_max_;  ///< joint limits
 
   std::shared_ptr<kdl_kinematics::ParamListener> param_listener_;
   kdl_kinematics::Params params_;
+
+  std::uint64_t id_;  ///< Unique id of the current chain of this instance, identifies the thread-local workspaces
+  mutable std::mutex workspaces_lock_;
+  mutable std::map<std::thread::id, std::unique_ptr<SolverWorkspace>> workspaces_;
 };
 }  // namespace kdl_kinematics_plugin
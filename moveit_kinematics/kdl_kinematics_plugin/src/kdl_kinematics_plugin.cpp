@@ -48,9 +48,16 @@
 
 #include <kdl_parser/kdl_parser.hpp>
 #include <kdl/chainfksolverpos_recursive.hpp>
+#include <kdl/chainjnttojacsolver.hpp>
 #include <kdl/frames_io.hpp>
 #include <kdl/kinfam_io.hpp>
 
+#include <Eigen/Cholesky>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
 namespace kdl_kinematics_plugin
 {
 namespace
@@ -63,21 +70,95 @@ rclcpp::Logger getLogger()
 
 static rclcpp::Clock steady_clock = rclcpp::Clock(RCL_ROS_TIME);
 
-KDLKinematicsPlugin::KDLKinematicsPlugin() : initialized_(false)
+/** @brief The KDL solvers keep intermediate results as members, so every thread needs its own instances */
+struct SolverWorkspace
+{
+  SolverWorkspace(const KDL::Chain& chain, const std::vector<JointMimic>& mimic_joints, bool position_ik)
+    : fk_solver(chain), ik_solver_vel(chain, mimic_joints, position_ik), jacobian_solver(chain)
+    , jacobian(chain.getNrOfJoints())
+  {
+  }
+
+  KDL::ChainFkSolverPos_recursive fk_solver;
+  KDL::ChainIkSolverVelMimicSVD ik_solver_vel;
+
+  // Levenberg-Marquardt solver
+  KDL::ChainJntToJacSolver jacobian_solver;
+  KDL::Jacobian jacobian;
+  Eigen::MatrixXd normal_matrix;
+  Eigen::LDLT<Eigen::MatrixXd> factorization;
+  double damping = 1e-3;  ///< damping of the last converged query, warm starts the next one
+
+  KDLKinematicsPlugin::SolverStatistics statistics;
+};
+
+namespace
+{
+std::atomic<std::uint64_t> next_plugin_id{ 1 };
+
+// Recently used workspaces of the calling thread, most recent first, an id of 0 marks an empty slot. Entries of
+// destroyed or re-initialized plugins are never matched again because ids are not reused, and are eventually evicted.
+struct CachedWorkspace
+{
+  std::uint64_t plugin_id = 0;
+  SolverWorkspace* workspace = nullptr;
+};
+constexpr std::size_t THREAD_CACHE_SIZE = 4;
+thread_local std::array<CachedWorkspace, THREAD_CACHE_SIZE> thread_cache;
+}  // namespace
+
+KDLKinematicsPlugin::KDLKinematicsPlugin() : initialized_(false), id_(next_plugin_id++)
 {
 }
 
+KDLKinematicsPlugin::~KDLKinematicsPlugin() = default;
+
+SolverWorkspace& KDLKinematicsPlugin::getSolverWorkspace() const
+{
+  for (auto it = thread_cache.begin(); it != thread_cache.end(); ++it)
+  {
+    if (it->plugin_id == id_)
+    {
+      std::rotate(thread_cache.begin(), it, it + 1);
+      return *thread_cache.front().workspace;
+    }
+  }
+
+  SolverWorkspace* workspace = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(workspaces_lock_);
+    std::unique_ptr<SolverWorkspace>& entry = workspaces_[std::this_thread::get_id()];
+    if (!entry)
+    {
+      const bool position_ik = params_.position_only_ik || params_.orientation_vs_position == 0.0;
+      entry = std::make_unique<SolverWorkspace>(kdl_chain_, mimic_joints_, position_ik);
+    }
+    workspace = entry.get();
+  }
+
+  // evict the least recently used entry
+  std::rotate(thread_cache.begin(), thread_cache.end() - 1, thread_cache.end());
+  thread_cache.front() = CachedWorkspace{ id_, workspace };
+  return *workspace;
+}
+
+random_numbers::RandomNumberGenerator& KDLKinematicsPlugin::getRandomNumberGenerator()
+{
+  // searchPositionIK() may be called concurrently by searchPositionIKBatch(), so every thread samples on its own
+  thread_local random_numbers::RandomNumberGenerator rng;
+  return rng;
+}
+
 void KDLKinematicsPlugin::getRandomConfiguration(Eigen::VectorXd& jnt_array) const
 {
-  state_->setToRandomPositions(joint_model_group_);
-  state_->copyJointGroupPositions(joint_model_group_, &jnt_array[0]);
+  joint_model_group_->getVariableRandomPositions(getRandomNumberGenerator(), &jnt_array[0]);
 }
 
 void KDLKinematicsPlugin::getRandomConfiguration(const Eigen::VectorXd& seed_state,
                                                  const std::vector<double>& consistency_limits,
                                                  Eigen::VectorXd& jnt_array) const
 {
-  joint_model_group_->getVariableRandomPositionsNearBy(state_->getRandomNumberGenerator(), &jnt_array[0],
+  joint_model_group_->getVariableRandomPositionsNearBy(getRandomNumberGenerator(), &jnt_array[0],
                                                        &seed_state[0], consistency_limits);
 }
 
@@ -240,10 +321,12 @@ bool KDLKinematicsPlugin::initialize(const rclcpp::Node::SharedPtr& node, const
     }
   }
 
-  // Setup the joint state groups that we need
-  state_ = std::make_shared<moveit::core::RobotState>(robot_model_);
-
-  fk_solver_ = std::make_unique<KDL::ChainFkSolverPos_recursive>(kdl_chain_);
+  // workspaces built for a previous chain must not be used anymore
+  {
+    std::lock_guard<std::mutex> lock(workspaces_lock_);
+    workspaces_.clear();
+    id_ = next_plugin_id++;
+  }
 
   initialized_ = true;
   RCLCPP_DEBUG(getLogger(), "KDL solver initialized");
@@ -355,7 +438,9 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   jnt_seed_state.data = Eigen::Map<const Eigen::VectorXd>(ik_seed_state.data(), ik_seed_state.size());
   jnt_pos_in = jnt_seed_state;
 
-  KDL::ChainIkSolverVelMimicSVD ik_solver_vel(kdl_chain_, mimic_joints_, orientation_vs_position_weight == 0.0);
+  SolverWorkspace& workspace = getSolverWorkspace();
+  workspace.statistics = SolverStatistics();
+  const bool levenberg_marquardt = params_.solver == "levenberg_marquardt";
   solution.resize(dimension_);
 
   KDL::Frame pose_desired;
@@ -370,6 +455,7 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   do
   {
     ++attempt;
+    workspace.statistics.attempts = attempt;
     if (attempt > 1)  // randomly re-seed after first attempt
     {
       if (!consistency_limits_mimic.empty())
@@ -383,9 +469,12 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
       RCLCPP_DEBUG_STREAM(getLogger(), "New random configuration (" << attempt << "): " << jnt_pos_in);
     }
 
-    int ik_valid =
-        CartToJnt(ik_solver_vel, jnt_pos_in, pose_desired, jnt_pos_out, params_.max_solver_iterations,
-                  Eigen::Map<const Eigen::VectorXd>(joint_weights_.data(), joint_weights_.size()), cartesian_weights);
+    const Eigen::Map<const Eigen::VectorXd> joint_weights(joint_weights_.data(), joint_weights_.size());
+    int ik_valid = levenberg_marquardt ?
+                       solveLevenbergMarquardt(jnt_pos_in, pose_desired, jnt_pos_out, params_.max_solver_iterations,
+                                               joint_weights, cartesian_weights) :
+                       CartToJnt(workspace.ik_solver_vel, jnt_pos_in, pose_desired, jnt_pos_out,
+                                 params_.max_solver_iterations, joint_weights, cartesian_weights);
     if (ik_valid == 0 || options.return_approximate_solution)  // found acceptable solution
     {
       if (!consistency_limits_mimic.empty() &&
@@ -402,11 +491,12 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
 
       // solution passed consistency check and solution callback
       error_code.val = error_code.SUCCESS;
+      workspace.statistics.converged = true;
       RCLCPP_DEBUG_STREAM(getLogger(), "Solved after " << (steady_clock.now() - start_time).seconds() << " < "
                                                        << timeout << "s and " << attempt << " attempts");
       return true;
     }
-  } while (!timedOut(start_time, timeout));
+  } while (!timedOut(start_time, timeout) && !(options.cancel && *options.cancel));
 
   RCLCPP_DEBUG_STREAM(getLogger(), "IK timed out after " << (steady_clock.now() - start_time).seconds() << " > "
                                                          << timeout << "s and " << attempt << " attempts");
@@ -414,11 +504,23 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::msg::Pose& ik_po
   return false;
 }
 
+bool KDLKinematicsPlugin::searchPositionIKBatch(const std::vector<geometry_msgs::msg::Pose>& ik_poses,
+                                               const std::vector<std::vector<double> >& ik_seed_states, double timeout,
+                                               std::vector<std::vector<double> >& solutions,
+                                               std::vector<moveit_msgs::msg::MoveItErrorCodes>& error_codes,
+                                               const kinematics::KinematicsQueryOptions& options,
+                                               std::size_t thread_count) const
+{
+  return searchPositionIKBatchParallel(ik_poses, ik_seed_states, timeout, solutions, error_codes, options,
+                                       thread_count);
+}
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 int KDLKinematicsPlugin::CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, const KDL::JntArray& q_init,
                                    const KDL::Frame& p_in, KDL::JntArray& q_out, const unsigned int max_iter,
                                    const Eigen::VectorXd& joint_weights, const Twist& cartesian_weights) const
 {
+  KDL::ChainFkSolverPos& fk_solver = getSolverWorkspace().fk_solver;
   double last_delta_twist_norm = DBL_MAX;
   double step_size = 1.0;
   KDL::Frame f;
@@ -434,7 +536,7 @@ int KDLKinematicsPlugin::CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, con
   bool success = false;
   for (i = 0; i < max_iter; ++i)
   {
-    fk_solver_->JntToCart(q_out, f);
+    fk_solver.JntToCart(q_out, f);
     delta_twist = diff(f, p_in);
     RCLCPP_DEBUG_STREAM(getLogger(), "[" << std::setw(3) << i << "] delta_twist: " << delta_twist);
 
@@ -492,10 +594,120 @@ int KDLKinematicsPlugin::CartToJnt(KDL::ChainIkSolverVelMimicSVD& ik_solver, con
 
   int result = (i == max_iter) ? -3 : (success ? 0 : -2);
   RCLCPP_DEBUG_STREAM(getLogger(), "Result " << result << " after " << i << " iterations: " << q_out);
+  getSolverWorkspace().statistics.iterations += i;
+
+  return result;
+}
+
+int KDLKinematicsPlugin::solveLevenbergMarquardt(const KDL::JntArray& q_init, const KDL::Frame& p_in,
+                                                 KDL::JntArray& q_out, const unsigned int max_iter,
+                                                 const Eigen::VectorXd& joint_weights,
+                                                 const Twist& cartesian_weights) const
+{
+  constexpr double MIN_DAMPING = 1e-9;
+  constexpr double MAX_DAMPING = 1e9;
+
+  SolverWorkspace& workspace = getSolverWorkspace();
+  const bool position_only = cartesian_weights.bottomRows<3>().isZero();
+  const Eigen::Index reduced_size = joint_weights.rows();
+
+  // weighted twist towards the target, returns the error norm compared against epsilon as in CartToJnt()
+  KDL::Frame f;
+  const auto compute_error = [&](const KDL::JntArray& q, Twist& weighted_error) {
+    workspace.fk_solver.JntToCart(q, f);
+    const KDL::Twist delta_twist = diff(f, p_in);
+    weighted_error.topRows<3>() = Eigen::Map<const Eigen::Vector3d>(delta_twist.vel.data);
+    weighted_error.bottomRows<3>() = Eigen::Map<const Eigen::Vector3d>(delta_twist.rot.data);
+    weighted_error.array() *= cartesian_weights.array();
+    return std::max(delta_twist.vel.Norm(), position_only ? 0.0 : delta_twist.rot.Norm());
+  };
+
+  KDL::JntArray q_candidate(q_out.rows()), delta_q(q_out.rows());
+  Eigen::ArrayXd limit_weights = Eigen::ArrayXd::Ones(reduced_size);
+  Eigen::ArrayXd candidate_limit_weights(reduced_size);
+  Eigen::MatrixXd reduced_jacobian(6, reduced_size);
+  Eigen::MatrixXd hessian;
+  Eigen::VectorXd gradient;
+  Eigen::VectorXd step;
+  Twist error, candidate_error;
+
+  q_out = q_init;
+  double error_norm = compute_error(q_out, error);
+  double damping = workspace.damping;
+  bool update_jacobian = true;
+
+  unsigned int i;
+  bool success = false;
+  for (i = 0; i < max_iter; ++i)
+  {
+    if (error_norm <= params_.epsilon)
+    {
+      success = true;
+      break;
+    }
 
+    // the normal equations remain valid while steps are rejected, only the damping changes
+    if (update_jacobian)
+    {
+      workspace.jacobian_solver.JntToJac(q_out, workspace.jacobian);
+      reduced_jacobian.setZero();
+      for (unsigned int j = 0; j < q_out.rows(); ++j)
+      {
+        reduced_jacobian.col(mimic_joints_[j].map_index) +=
+            mimic_joints_[j].multiplier * workspace.jacobian.data.col(j);
+      }
+      // joints clipped at their limits in the last step barely move in the next one
+      reduced_jacobian = cartesian_weights.asDiagonal() * reduced_jacobian *
+                         (limit_weights * joint_weights.array()).matrix().asDiagonal();
+      hessian.noalias() = reduced_jacobian.transpose() * reduced_jacobian;
+      gradient.noalias() = reduced_jacobian.transpose() * error;
+      update_jacobian = false;
+    }
+
+    workspace.normal_matrix = hessian;
+    workspace.normal_matrix.diagonal().array() += damping * (hessian.diagonal().array() + MIN_DAMPING);
+    workspace.factorization.compute(workspace.normal_matrix);
+    step = workspace.factorization.solve(gradient);
+    step.array() *= limit_weights * joint_weights.array();
+
+    for (unsigned int j = 0; j < q_out.rows(); ++j)
+      delta_q(j) = step[mimic_joints_[j].map_index] * mimic_joints_[j].multiplier;
+    clipToJointLimits(q_out, delta_q, candidate_limit_weights);
+    KDL::Add(q_out, delta_q, q_candidate);
+
+    const double candidate_error_norm = compute_error(q_candidate, candidate_error);
+    RCLCPP_DEBUG(getLogger(), "[%3d] error: %f -> %f, damping: %g", i, error_norm, candidate_error_norm, damping);
+    if (candidate_error.squaredNorm() < error.squaredNorm())
+    {
+      q_out = q_candidate;
+      error = candidate_error;
+      error_norm = candidate_error_norm;
+      limit_weights = candidate_limit_weights;
+      damping = std::max(damping * 0.1, MIN_DAMPING);
+      update_jacobian = true;
+    }
+    else
+    {
+      damping *= 10.0;
+      if (damping > MAX_DAMPING)  // no descent direction left, stuck in a local minimum
+        break;
+    }
+  }
+
+  if (success)
+    workspace.damping = std::min(std::max(damping, 1e-6), 1.0);
+  workspace.statistics.iterations += i;
+
+  int result = (i == max_iter) ? -3 : (success ? 0 : -2);
+  RCLCPP_DEBUG_STREAM(getLogger(), "Result " << result << " after " << i << " iterations: " << q_out);
   return result;
 }
 
+KDLKinematicsPlugin::SolverStatistics KDLKinematicsPlugin::getLastSolverStatistics() const
+{
+  return getSolverWorkspace().statistics;
+}
+
 void KDLKinematicsPlugin::clipToJointLimits(const KDL::JntArray& q, KDL::JntArray& q_delta,
                                             Eigen::ArrayXd& weighting) const
 {
@@ -541,10 +753,11 @@ bool KDLKinematicsPlugin::getPositionFK(const std::vector<std::string>& link_nam
   KDL::JntArray jnt_pos_in(dimension_);
   jnt_pos_in.data = Eigen::Map<const Eigen::VectorXd>(joint_angles.data(), joint_angles.size());
 
+  KDL::ChainFkSolverPos& fk_solver = getSolverWorkspace().fk_solver;
   bool valid = true;
   for (unsigned int i = 0; i < poses.size(); ++i)
   {
-    if (fk_solver_->JntToCart(jnt_pos_in, p_out) >= 0)
+    if (fk_solver.JntToCart(jnt_pos_in, p_out) >= 0)
     {
       poses[i] = tf2::toMsg(p_out);
     }
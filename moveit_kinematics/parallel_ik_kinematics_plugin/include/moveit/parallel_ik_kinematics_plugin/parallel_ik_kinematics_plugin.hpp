@@ -0,0 +1,240 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Wrapper running several seeded IK searches concurrently */
+
+#pragma once
+
+#include <moveit/kinematics_base/kinematics_base.hpp>
+#include <moveit/robot_model/robot_model.hpp>
+#include <moveit/utils/logger.hpp>
+#include <random_numbers/random_numbers.h>
+#include <parallel_ik_kinematics_parameters.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace parallel_ik_kinematics_plugin
+{
+/**
+ * @brief Wrapper for kinematics::KinematicsBase-derived IK solvers that runs several seeded searches concurrently.
+ *
+ * Every search runs on its own instance of the wrapped solver: the first one starts from the given seed, the others
+ * from random seeds. The first solution that passes the consistency limits and the solution callback is returned.
+ * The remaining searches are then stopped through KinematicsQueryOptions::cancel, which wrapped solvers should check
+ * between their random restarts.
+ */
+template <class KinematicsPlugin>
+class ParallelIKKinematicsPlugin : public KinematicsPlugin
+{
+public:
+  using IKCallbackFn = kinematics::KinematicsBase::IKCallbackFn;
+  using KinematicsQueryOptions = kinematics::KinematicsQueryOptions;
+
+  bool initialize(const rclcpp::Node::SharedPtr& node, const moveit::core::RobotModel& robot_model,
+                  const std::string& group_name, const std::string& base_frame,
+                  const std::vector<std::string>& tip_frames, double search_discretization) override
+  {
+    std::string kinematics_param_prefix = "robot_description_kinematics." + group_name;
+    param_listener_ = std::make_shared<parallel_ik_kinematics::ParamListener>(node, kinematics_param_prefix);
+    params_ = param_listener_->get_params();
+
+    solvers_.clear();
+    if (!KinematicsPlugin::initialize(node, robot_model, group_name, base_frame, tip_frames, search_discretization))
+      return false;
+    // this instance runs the first search, the additional instances the others
+    for (int i = 1; i < params_.num_parallel_attempts; ++i)
+    {
+      auto solver = std::make_unique<KinematicsPlugin>();
+      if (!solver->initialize(node, robot_model, group_name, base_frame, tip_frames, search_discretization))
+      {
+        RCLCPP_ERROR(moveit::getLogger("moveit.kinematics.parallel_ik_kinematics_plugin"),
+                     "Failed to initialize solver instance %d of group %s", i, group_name.c_str());
+        solvers_.clear();
+        return false;
+      }
+      solvers_.push_back(std::move(solver));
+    }
+    return true;
+  }
+
+  using KinematicsPlugin::setRedundantJoints;
+  bool setRedundantJoints(const std::vector<unsigned int>& redundant_joint_indices) override
+  {
+    bool result = KinematicsPlugin::setRedundantJoints(redundant_joint_indices);
+    for (const auto& solver : solvers_)
+      result = solver->setRedundantJoints(redundant_joint_indices) && result;
+    return result;
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double timeout, std::vector<double>& solution, moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const KinematicsQueryOptions& options = KinematicsQueryOptions()) const override
+  {
+    return searchParallel(ik_pose, ik_seed_state, timeout, std::vector<double>(), solution, IKCallbackFn(), error_code,
+                          options);
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double timeout, const std::vector<double>& consistency_limits, std::vector<double>& solution,
+                        moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const KinematicsQueryOptions& options = KinematicsQueryOptions()) const override
+  {
+    return searchParallel(ik_pose, ik_seed_state, timeout, consistency_limits, solution, IKCallbackFn(), error_code,
+                          options);
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double timeout, std::vector<double>& solution, const IKCallbackFn& solution_callback,
+                        moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const KinematicsQueryOptions& options = KinematicsQueryOptions()) const override
+  {
+    return searchParallel(ik_pose, ik_seed_state, timeout, std::vector<double>(), solution, solution_callback,
+                          error_code, options);
+  }
+
+  bool searchPositionIK(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                        double timeout, const std::vector<double>& consistency_limits, std::vector<double>& solution,
+                        const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
+                        const KinematicsQueryOptions& options = KinematicsQueryOptions()) const override
+  {
+    return searchParallel(ik_pose, ik_seed_state, timeout, consistency_limits, solution, solution_callback,
+                          error_code, options);
+  }
+
+private:
+  std::shared_ptr<parallel_ik_kinematics::ParamListener> param_listener_;
+  parallel_ik_kinematics::Params params_;
+
+  /** @brief Solver instances running the searches from random seeds */
+  std::vector<std::unique_ptr<KinematicsPlugin>> solvers_;
+
+  /** @brief Sample a random seed within the joint limits, and within the consistency limits of @e seed if given */
+  std::vector<double> getRandomSeed(const std::vector<double>& seed,
+                                    const std::vector<double>& consistency_limits) const
+  {
+    // every search thread samples on its own
+    thread_local random_numbers::RandomNumberGenerator rng;
+    std::vector<double> random_seed(seed);
+    const std::vector<std::string>& joint_names = this->getJointNames();
+    for (std::size_t i = 0; i < joint_names.size() && i < random_seed.size(); ++i)
+    {
+      const moveit::core::JointModel* joint = this->robot_model_->getJointModel(joint_names[i]);
+      if (joint == nullptr || joint->getVariableCount() != 1)
+        continue;
+      if (consistency_limits.size() == seed.size())
+      {
+        joint->getVariableRandomPositionsNearBy(rng, &random_seed[i], &seed[i], consistency_limits[i]);
+      }
+      else
+      {
+        joint->getVariableRandomPositions(rng, &random_seed[i]);
+      }
+    }
+    return random_seed;
+  }
+
+  bool searchParallel(const geometry_msgs::msg::Pose& ik_pose, const std::vector<double>& ik_seed_state,
+                      double timeout, const std::vector<double>& consistency_limits, std::vector<double>& solution,
+                      const IKCallbackFn& solution_callback, moveit_msgs::msg::MoveItErrorCodes& error_code,
+                      const KinematicsQueryOptions& options) const
+  {
+    if (solvers_.empty())
+    {
+      return KinematicsPlugin::searchPositionIK(ik_pose, ik_seed_state, timeout, consistency_limits, solution,
+                                                solution_callback, error_code, options);
+    }
+
+    // set once a search succeeded, cancelling the others
+    std::atomic<bool> solved{ false };
+    KinematicsQueryOptions search_options = options;
+    search_options.cancel = &solved;
+
+    std::mutex lock;
+    bool has_solution = false;
+    IKCallbackFn callback;
+    if (solution_callback)
+    {
+      callback = [&](const geometry_msgs::msg::Pose& pose, const std::vector<double>& candidate,
+                     moveit_msgs::msg::MoveItErrorCodes& code) {
+        // callbacks usually update shared state, e.g. a RobotState, so they are never called concurrently
+        std::lock_guard<std::mutex> slock(lock);
+        if (solved)
+        {
+          code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
+          return;
+        }
+        solution_callback(pose, candidate, code);
+        if (code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+          solved = true;
+      };
+    }
+
+    std::vector<moveit_msgs::msg::MoveItErrorCodes> error_codes(solvers_.size() + 1);
+    const auto search = [&](std::size_t i) {
+      const KinematicsPlugin& solver = i == 0 ? *this : *solvers_[i - 1];
+      const std::vector<double> seed = i == 0 ? ik_seed_state : getRandomSeed(ik_seed_state, consistency_limits);
+      std::vector<double> candidate;
+      if (!solver.KinematicsPlugin::searchPositionIK(ik_pose, seed, timeout, consistency_limits, candidate, callback,
+                                                     error_codes[i], search_options))
+        return;
+      // with a solution callback, only the search whose candidate it accepted succeeds
+      std::lock_guard<std::mutex> slock(lock);
+      if (!has_solution)
+      {
+        has_solution = true;
+        solution = std::move(candidate);
+        solved = true;
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(solvers_.size());
+    for (std::size_t i = 1; i <= solvers_.size(); ++i)
+      threads.emplace_back(search, i);
+    search(0);
+    for (std::thread& thread : threads)
+      thread.join();
+
+    if (has_solution)
+    {
+      error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+      return true;
+    }
+    error_code = error_codes.front();
+    return false;
+  }
+};
+}  // namespace parallel_ik_kinematics_plugin
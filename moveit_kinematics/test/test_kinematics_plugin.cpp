@@ -581,6 +581,72 @@ TEST_F(KinematicsTest, searchIK)
   EXPECT_GE(success, EXPECTED_SUCCESS_RATE * num_ik_tests_);
 }
 
+TEST_F(KinematicsTest, searchIKStatistics)
+{
+  const auto kdl_solver = std::dynamic_pointer_cast<kdl_kinematics_plugin::KDLKinematicsPlugin>(kinematics_solver_);
+  if (!kdl_solver)
+    GTEST_SKIP() << "Solver statistics are only reported by the KDL plugin";
+
+  std::vector<double> fk_values, solution;
+  moveit_msgs::msg::MoveItErrorCodes error_code;
+  const std::vector<std::string>& fk_names = kinematics_solver_->getTipFrames();
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.copyJointGroupPositions(jmg_, fk_values);
+  std::vector<geometry_msgs::msg::Pose> poses;
+  ASSERT_TRUE(kinematics_solver_->getPositionFK(fk_names, fk_values, poses));
+
+  // seeded with the solution itself, the first attempt converges immediately
+  ASSERT_TRUE(kinematics_solver_->searchPositionIK(poses[0], fk_values, timeout_, solution, error_code));
+  const kdl_kinematics_plugin::KDLKinematicsPlugin::SolverStatistics statistics = kdl_solver->getLastSolverStatistics();
+  EXPECT_TRUE(statistics.converged);
+  EXPECT_EQ(statistics.attempts, 1u);
+  EXPECT_LE(statistics.iterations, 1u);
+}
+
+TEST_F(KinematicsTest, searchIKBatch)
+{
+  const std::vector<std::string>& fk_names = kinematics_solver_->getTipFrames();
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+
+  std::vector<geometry_msgs::msg::Pose> poses;
+  std::vector<double> fk_values;
+  for (unsigned int i = 0; i < num_ik_tests_; ++i)
+  {
+    robot_state.setToRandomPositions(jmg_, this->rng_);
+    robot_state.copyJointGroupPositions(jmg_, fk_values);
+    std::vector<geometry_msgs::msg::Pose> tip_poses;
+    ASSERT_TRUE(kinematics_solver_->getPositionFK(fk_names, fk_values, tip_poses));
+    poses.push_back(tip_poses[0]);
+  }
+
+  const std::vector<std::vector<double>> seeds{ std::vector<double>(kinematics_solver_->getJointNames().size(), 0.0) };
+  std::vector<std::vector<double>> solutions;
+  std::vector<moveit_msgs::msg::MoveItErrorCodes> error_codes;
+  kinematics_solver_->searchPositionIKBatch(poses, seeds, timeout_, solutions, error_codes);
+  ASSERT_EQ(solutions.size(), poses.size());
+  ASSERT_EQ(error_codes.size(), poses.size());
+
+  unsigned int success = 0;
+  for (std::size_t i = 0; i < poses.size(); ++i)
+  {
+    if (error_codes[i].val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+      continue;
+    success++;
+
+    const std::vector<geometry_msgs::msg::Pose> desired_poses{ poses[i] };
+    std::vector<geometry_msgs::msg::Pose> reached_poses;
+    kinematics_solver_->getPositionFK(fk_names, solutions[i], reached_poses);
+    EXPECT_NEAR_POSES(desired_poses, reached_poses, tolerance_);
+  }
+  EXPECT_GE(success, EXPECTED_SUCCESS_RATE * num_ik_tests_);
+
+  // the number of seed states must match the number of poses unless a single seed is shared
+  const std::vector<std::vector<double>> wrong_seeds(poses.size() + 1, seeds[0]);
+  EXPECT_FALSE(kinematics_solver_->searchPositionIKBatch(poses, wrong_seeds, timeout_, solutions, error_codes));
+}
+
 TEST_F(KinematicsTest, searchIKWithCallback)
 {
   std::vector<double> seed, fk_values, solution;
@@ -706,6 +772,53 @@ TEST_F(KinematicsTest, getIKMultipleSolutions)
   EXPECT_GE(success, EXPECTED_SUCCESS_RATE * num_ik_multiple_tests_);
 }
 
+TEST_F(KinematicsTest, getIKSolutionsBuffer)
+{
+  std::vector<double> fk_values, solutions;
+  kinematics::KinematicsQueryOptions options;
+  kinematics::KinematicsResult result;
+
+  const std::size_t num_joints = kinematics_solver_->getJointNames().size();
+  const std::vector<std::string>& fk_names = kinematics_solver_->getTipFrames();
+  moveit::core::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+
+  unsigned int success = 0;
+  for (unsigned int i = 0; i < num_ik_multiple_tests_; ++i)
+  {
+    robot_state.setToRandomPositions(jmg_, this->rng_);
+    robot_state.copyJointGroupPositions(jmg_, fk_values);
+    std::vector<geometry_msgs::msg::Pose> poses;
+    ASSERT_TRUE(kinematics_solver_->getPositionFK(fk_names, fk_values, poses));
+
+    if (!kinematics_solver_->getPositionIKSolutions(poses[0], fk_values, solutions, result, options))
+      continue;
+    ASSERT_FALSE(solutions.empty());
+    ASSERT_EQ(solutions.size() % num_joints, 0u);
+    success++;
+
+    // the solutions are stored one after the other, in order of increasing distance to the seed
+    double previous_distance = 0.0;
+    std::vector<geometry_msgs::msg::Pose> reached_poses;
+    for (std::size_t offset = 0; offset < solutions.size(); offset += num_joints)
+    {
+      const std::vector<double> solution(solutions.begin() + offset, solutions.begin() + offset + num_joints);
+      kinematics_solver_->getPositionFK(fk_names, solution, reached_poses);
+      EXPECT_NEAR_POSES(poses, reached_poses, tolerance_);
+
+      const double distance =
+          (Eigen::Map<const Eigen::VectorXd>(solution.data(), num_joints) -
+           Eigen::Map<const Eigen::VectorXd>(fk_values.data(), num_joints))
+              .array()
+              .abs()
+              .sum();
+      EXPECT_GE(distance, previous_distance);
+      previous_distance = distance;
+    }
+  }
+  EXPECT_GE(success, EXPECTED_SUCCESS_RATE * num_ik_multiple_tests_);
+}
+
 // validate that getPositionIK() retrieves closest solution to seed
 TEST_F(KinematicsTest, getNearestIKSolution)
 {
@@ -37,7 +37,9 @@
 #pragma once
 
 #include <chomp_interface/chomp_interface.hpp>
+#include <moveit/collision_detection/world.hpp>
 #include <moveit/planning_interface/planning_interface.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
 
 #include <rclcpp/rclcpp.hpp>
 
@@ -61,9 +63,26 @@ public:
 
   void initialize();
 
+  /**
+   * \brief Get a planning scene with the contents of the given scene that uses the hybrid collision detector
+   *
+   * By default, this is a diff of the given scene whose distance field is built from scratch. With the parameter
+   * persistent_distance_field, the context keeps one scene for all requests and only updates its distance field
+   * with the objects that changed since the last request.
+   */
+  planning_scene::PlanningScenePtr getHybridPlanningScene(const planning_scene::PlanningSceneConstPtr& planning_scene);
+
 private:
+  /** \brief Update the world of the persistent scene to match the given world, object by object */
+  void updatePersistentWorld(const collision_detection::World& world);
+
   CHOMPInterfacePtr chomp_interface_;
   moveit::core::RobotModelConstPtr robot_model_;
+
+  planning_scene::PlanningScenePtr persistent_scene_;
+  /** The world version the persistent scene was last updated to, and the objects of that world */
+  std::uint64_t persistent_world_version_;
+  std::map<std::string, collision_detection::World::ObjectConstPtr> persistent_objects_;
 };
 
 }  // namespace chomp_interface
@@ -85,5 +85,7 @@ void CHOMPInterface::loadParams()
   }
   node_->get_parameter_or("chomp.enable_failure_recovery", params_.enable_failure_recovery_, false);
   node_->get_parameter_or("chomp.max_recovery_attempts", params_.max_recovery_attempts_, 5);
+  node_->get_parameter_or("chomp.persistent_distance_field", params_.persistent_distance_field_, false);
+  node_->get_parameter_or("chomp.num_threads", params_.num_threads_, 0);
 }
 }  // namespace chomp_interface
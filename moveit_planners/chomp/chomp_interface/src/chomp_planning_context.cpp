@@ -35,18 +35,97 @@
 /* Author: Chittaranjan Srinivas Swaminathan */
 
 #include <chomp_interface/chomp_planning_context.hpp>
+#include <moveit/collision_distance_field/collision_detector_allocator_hybrid.hpp>
 #include <moveit/robot_state/conversions.hpp>
 
+#include <algorithm>
+
 namespace chomp_interface
 {
 CHOMPPlanningContext::CHOMPPlanningContext(const std::string& name, const std::string& group,
                                            const moveit::core::RobotModelConstPtr& model,
                                            const rclcpp::Node::SharedPtr& node)
-  : planning_interface::PlanningContext(name, group), robot_model_(model)
+  : planning_interface::PlanningContext(name, group), robot_model_(model), persistent_world_version_(0)
 {
   chomp_interface_ = std::make_shared<CHOMPInterface>(node);
 }
 
+planning_scene::PlanningScenePtr
+CHOMPPlanningContext::getHybridPlanningScene(const planning_scene::PlanningSceneConstPtr& planning_scene)
+{
+  if (!chomp_interface_->getParams().persistent_distance_field_)
+  {
+    planning_scene::PlanningScenePtr ps = planning_scene->diff();
+    ps->allocateCollisionDetector(collision_detection::CollisionDetectorAllocatorHybrid::create());
+    return ps;
+  }
+
+  if (!persistent_scene_)
+  {
+    persistent_scene_ = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+    persistent_scene_->allocateCollisionDetector(collision_detection::CollisionDetectorAllocatorHybrid::create());
+    persistent_objects_.clear();
+  }
+
+  // everything but the world is cheap to copy
+  persistent_scene_->setCurrentState(planning_scene->getCurrentState());
+  persistent_scene_->getAllowedCollisionMatrixNonConst() = planning_scene->getAllowedCollisionMatrix();
+  persistent_scene_->getTransformsNonConst().setAllTransforms(planning_scene->getTransforms().getAllTransforms());
+  const collision_detection::CollisionEnvConstPtr& cenv = planning_scene->getCollisionEnv();
+  persistent_scene_->getCollisionEnvNonConst()->setLinkPadding(cenv->getLinkPadding());
+  persistent_scene_->getCollisionEnvNonConst()->setLinkScale(cenv->getLinkScale());
+
+  // copies of a world share its version, so the world is usually unchanged between requests on the same scene
+  const collision_detection::World& world = *planning_scene->getWorld();
+  if (persistent_objects_.empty() || world.getVersion() != persistent_world_version_)
+  {
+    updatePersistentWorld(world);
+    persistent_world_version_ = world.getVersion();
+  }
+  return persistent_scene_;
+}
+
+void CHOMPPlanningContext::updatePersistentWorld(const collision_detection::World& world)
+{
+  const collision_detection::WorldPtr& persistent_world = persistent_scene_->getWorldNonConst();
+  for (auto it = persistent_objects_.begin(); it != persistent_objects_.end();)
+  {
+    if (!world.hasObject(it->first))
+    {
+      persistent_world->removeObject(it->first);
+      it = persistent_objects_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  // objects are copied before they are modified, so an object that is still shared didn't change
+  for (const auto& [id, object] : world)
+  {
+    collision_detection::World::ObjectConstPtr& persistent_object = persistent_objects_[id];
+    if (persistent_object == object)
+      continue;
+
+    // a moved object only updates the cells it left and entered, a changed one is replaced
+    if (persistent_object && persistent_object->shapes_ == object->shapes_ &&
+        persistent_object->shape_poses_.size() == object->shape_poses_.size() &&
+        std::equal(object->shape_poses_.begin(), object->shape_poses_.end(), persistent_object->shape_poses_.begin(),
+                   [](const Eigen::Isometry3d& a, const Eigen::Isometry3d& b) { return a.matrix() == b.matrix(); }))
+    {
+      persistent_world->setObjectPose(id, object->pose_);
+    }
+    else
+    {
+      persistent_world->removeObject(id);
+      persistent_world->addToObject(id, object->pose_, object->shapes_, object->shape_poses_);
+    }
+    persistent_world->setSubframesOfObject(id, object->subframe_poses_);
+    persistent_object = object;
+  }
+}
+
 void CHOMPPlanningContext::solve(planning_interface::MotionPlanDetailedResponse& res)
 {
   chomp_interface_->solve(planning_scene_, request_, chomp_interface_->getParams(), res);
@@ -33,7 +33,6 @@
  *********************************************************************/
 
 #include <chomp_interface/chomp_planning_context.hpp>
-#include <moveit/collision_distance_field/collision_detector_allocator_hybrid.hpp>
 #include <moveit/planning_interface/planning_interface.hpp>
 #include <moveit/planning_scene/planning_scene.hpp>
 #include <moveit/robot_model/robot_model.hpp>
@@ -90,13 +89,9 @@ public:
       return planning_interface::PlanningContextPtr();
     }
 
-    // create PlanningScene using hybrid collision detector
-    planning_scene::PlanningScenePtr ps = planning_scene->diff();
-    ps->allocateCollisionDetector(collision_detection::CollisionDetectorAllocatorHybrid::create());
-
-    // retrieve and configure existing context
+    // retrieve and configure existing context, with a PlanningScene using the hybrid collision detector
     const CHOMPPlanningContextPtr& context = planning_contexts_.at(req.group_name);
-    context->setPlanningScene(ps);
+    context->setPlanningScene(context->getHybridPlanningScene(planning_scene));
     context->setMotionPlanRequest(req);
     error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
     return context;
@@ -108,7 +108,7 @@ private:
   //                     const std::string& group_name,
   //                     Eigen::VectorXd& state_vec);
 
-  void setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i);
+  void setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i, moveit::core::RobotState& state);
 
   // collision_proximity::CollisionProximitySpace::TrajectorySafety checkCurrentIterValidity();
 
@@ -134,6 +134,8 @@ private:
 
   std::vector<ChompCost> joint_costs_;
   collision_detection::GroupStateRepresentationPtr gsr_;
+  std::vector<moveit::core::RobotState> point_states_; /**< Robot state of each point in the trajectory */
+  std::vector<collision_detection::GroupStateRepresentationPtr> point_gsrs_; /**< Collision structures of each point */
   bool initialized_;
 
   std::vector<std::vector<std::string> > collision_point_joint_names_;
@@ -168,11 +170,7 @@ private:
   Eigen::MatrixXd collision_increments_;
   Eigen::MatrixXd final_increments_;
 
-  // temporary variables for all functions:
-  Eigen::VectorXd smoothness_derivative_;
-  Eigen::MatrixXd jacobian_;
-  Eigen::MatrixXd jacobian_pseudo_inverse_;
-  Eigen::MatrixXd jacobian_jacobian_tranpose_;
+  // temporary variables for all functions, those of the per point computations are local to their threads
   Eigen::VectorXd random_state_;
   Eigen::VectorXd joint_state_velocities_;
 
@@ -212,8 +210,8 @@ private:
   void getRandomMomentum();
   void updateMomentum();
   void updatePositionFromMomentum();
-  void calculatePseudoInverse();
-  void computeJointProperties(int trajectoryPoint);
+  void calculatePseudoInverse(const Eigen::MatrixXd& jacobian, Eigen::MatrixXd& jacobian_pseudo_inverse) const;
+  void computeJointProperties(int trajectoryPoint, const moveit::core::RobotState& state);
   bool isCurrentTrajectoryMeshToMeshCollisionFree() const;
 };
 }  // namespace chomp
@@ -94,6 +94,9 @@ public:
                                     an initial path is not found with the specified chomp parameters */
   int max_recovery_attempts_;    /*!< this the maximum recovery attempts to find a collision free path after an initial
                                     failure to find a solution */
+  bool persistent_distance_field_; /*!< if set to true, the planning contexts keep their distance field between
+                                       requests and only update it with the objects that changed */
+  int num_threads_; /*!< number of threads computing the trajectory points in parallel, 0 for one per hardware thread */
 };
 
 }  // namespace chomp
@@ -45,7 +45,9 @@
 #include <rclcpp/logging.hpp>
 #include <eigen3/Eigen/Core>
 #include <eigen3/Eigen/LU>
+#include <algorithm>
 #include <random>
+#include <thread>
 #include <visualization_msgs/msg/marker_array.hpp>
 
 namespace chomp
@@ -56,6 +58,30 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.planners.chomp.optimizer");
 }
+
+// Minimum number of indices processed by one thread, smaller blocks cost more to distribute than to compute
+constexpr int MIN_BLOCK_SIZE = 4;
+
+// Call process(block_begin, block_end) for contiguous blocks covering the indices [begin, end], each block on its own
+// thread. Every index is processed by exactly one call, so the results don't depend on the number of threads.
+template <typename Function>
+void parallelFor(int begin, int end, int num_threads, const Function& process)
+{
+  const int count = end - begin + 1;
+  if (count <= 0)
+    return;
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  num_threads = std::max(1, std::min(num_threads, count / MIN_BLOCK_SIZE));
+
+  const int block_size = (count + num_threads - 1) / num_threads;
+  std::vector<std::thread> threads;
+  for (int block_begin = begin + block_size; block_begin <= end; block_begin += block_size)
+    threads.emplace_back(process, block_begin, std::min(block_begin + block_size - 1, end));
+  process(begin, std::min(begin + block_size - 1, end));
+  for (std::thread& thread : threads)
+    thread.join();
+}
 }  // namespace
 
 ChompOptimizer::ChompOptimizer(ChompTrajectory* trajectory, const planning_scene::PlanningSceneConstPtr& planning_scene,
@@ -140,10 +166,6 @@ void ChompOptimizer::initialize()
   smoothness_increments_ = Eigen::MatrixXd::Zero(num_vars_free_, num_joints_);
   collision_increments_ = Eigen::MatrixXd::Zero(num_vars_free_, num_joints_);
   final_increments_ = Eigen::MatrixXd::Zero(num_vars_free_, num_joints_);
-  smoothness_derivative_ = Eigen::VectorXd::Zero(num_vars_all_);
-  jacobian_ = Eigen::MatrixXd::Zero(3, num_joints_);
-  jacobian_pseudo_inverse_ = Eigen::MatrixXd::Zero(num_joints_, 3);
-  jacobian_jacobian_tranpose_ = Eigen::MatrixXd::Zero(3, 3);
   random_state_ = Eigen::VectorXd::Zero(num_joints_);
   joint_state_velocities_ = Eigen::VectorXd::Zero(num_joints_);
 
@@ -164,6 +186,8 @@ void ChompOptimizer::initialize()
   collision_free_iteration_ = 0;
   is_collision_free_ = false;
   state_is_in_collision_.resize(num_vars_all_);
+  point_states_.assign(num_vars_all_, state_);
+  point_gsrs_.assign(num_vars_all_, collision_detection::GroupStateRepresentationPtr());
   point_is_in_collision_.resize(num_vars_all_, std::vector<int>(num_collision_points_));
 
   last_improvement_iteration_ = -1;
@@ -538,24 +562,19 @@ bool ChompOptimizer::isCurrentTrajectoryMeshToMeshCollisionFree() const
 
 void ChompOptimizer::calculateSmoothnessIncrements()
 {
-  for (int i = 0; i < num_joints_; ++i)
-  {
-    joint_costs_[i].getDerivative(group_trajectory_.getJointTrajectory(i), smoothness_derivative_);
-    smoothness_increments_.col(i) = -smoothness_derivative_.segment(group_trajectory_.getStartIndex(), num_vars_free_);
-  }
+  // the joints are independent, each block of joints uses its own derivative buffer
+  parallelFor(0, num_joints_ - 1, parameters_->num_threads_, [this](int block_begin, int block_end) {
+    Eigen::VectorXd smoothness_derivative = Eigen::VectorXd::Zero(num_vars_all_);
+    for (int i = block_begin; i <= block_end; ++i)
+    {
+      joint_costs_[i].getDerivative(group_trajectory_.getJointTrajectory(i), smoothness_derivative);
+      smoothness_increments_.col(i) = -smoothness_derivative.segment(group_trajectory_.getStartIndex(), num_vars_free_);
+    }
+  });
 }
 
 void ChompOptimizer::calculateCollisionIncrements()
 {
-  double potential;
-  double vel_mag_sq;
-  double vel_mag;
-  Eigen::Vector3d potential_gradient;
-  Eigen::Vector3d normalized_velocity;
-  Eigen::Matrix3d orthogonal_projector;
-  Eigen::Vector3d curvature_vector;
-  Eigen::Vector3d cartesian_gradient;
-
   collision_increments_.setZero(num_vars_free_, num_joints_);
 
   int start_point = 0;
@@ -577,56 +596,63 @@ void ChompOptimizer::calculateCollisionIncrements()
     start_point = free_vars_start_;
   }
 
-  for (int i = start_point; i <= end_point; ++i)
-  {
-    for (int j = 0; j < num_collision_points_; ++j)
+  // each point only writes its own row of the increments, each block of points uses its own jacobian buffers
+  parallelFor(start_point, end_point, parameters_->num_threads_, [this](int block_begin, int block_end) {
+    double potential;
+    double vel_mag_sq;
+    double vel_mag;
+    Eigen::Vector3d potential_gradient;
+    Eigen::Vector3d normalized_velocity;
+    Eigen::Matrix3d orthogonal_projector;
+    Eigen::Vector3d curvature_vector;
+    Eigen::Vector3d cartesian_gradient;
+    Eigen::MatrixXd jacobian = Eigen::MatrixXd::Zero(3, num_joints_);
+    Eigen::MatrixXd jacobian_pseudo_inverse = Eigen::MatrixXd::Zero(num_joints_, 3);
+
+    for (int i = block_begin; i <= block_end; ++i)
     {
-      potential = collision_point_potential_[i][j];
+      for (int j = 0; j < num_collision_points_; ++j)
+      {
+        potential = collision_point_potential_[i][j];
 
-      if (potential < 0.0001)
-        continue;
+        if (potential < 0.0001)
+          continue;
 
-      potential_gradient = -collision_point_potential_gradient_[i][j];
+        potential_gradient = -collision_point_potential_gradient_[i][j];
 
-      vel_mag = collision_point_vel_mag_[i][j];
-      vel_mag_sq = vel_mag * vel_mag;
+        vel_mag = collision_point_vel_mag_[i][j];
+        vel_mag_sq = vel_mag * vel_mag;
 
-      // all math from the CHOMP paper:
+        // all math from the CHOMP paper:
 
-      normalized_velocity = collision_point_vel_eigen_[i][j] / vel_mag;
-      orthogonal_projector = Eigen::Matrix3d::Identity() - (normalized_velocity * normalized_velocity.transpose());
-      curvature_vector = (orthogonal_projector * collision_point_acc_eigen_[i][j]) / vel_mag_sq;
-      cartesian_gradient = vel_mag * (orthogonal_projector * potential_gradient - potential * curvature_vector);
+        normalized_velocity = collision_point_vel_eigen_[i][j] / vel_mag;
+        orthogonal_projector = Eigen::Matrix3d::Identity() - (normalized_velocity * normalized_velocity.transpose());
+        curvature_vector = (orthogonal_projector * collision_point_acc_eigen_[i][j]) / vel_mag_sq;
+        cartesian_gradient = vel_mag * (orthogonal_projector * potential_gradient - potential * curvature_vector);
 
-      // pass it through the jacobian transpose to get the increments
-      getJacobian(i, collision_point_pos_eigen_[i][j], collision_point_joint_names_[i][j], jacobian_);
+        // pass it through the jacobian transpose to get the increments
+        getJacobian(i, collision_point_pos_eigen_[i][j], collision_point_joint_names_[i][j], jacobian);
 
-      if (parameters_->use_pseudo_inverse_)
-      {
-        calculatePseudoInverse();
-        collision_increments_.row(i - free_vars_start_).transpose() -= jacobian_pseudo_inverse_ * cartesian_gradient;
-      }
-      else
-      {
-        collision_increments_.row(i - free_vars_start_).transpose() -= jacobian_.transpose() * cartesian_gradient;
-      }
-
-      /*
-        if(point_is_in_collision_[i][j])
+        if (parameters_->use_pseudo_inverse_)
         {
-        break;
+          calculatePseudoInverse(jacobian, jacobian_pseudo_inverse);
+          collision_increments_.row(i - free_vars_start_).transpose() -= jacobian_pseudo_inverse * cartesian_gradient;
         }
-      */
+        else
+        {
+          collision_increments_.row(i - free_vars_start_).transpose() -= jacobian.transpose() * cartesian_gradient;
+        }
+      }
     }
-  }
-  // cout << collision_increments_ << endl;
+  });
 }
 
-void ChompOptimizer::calculatePseudoInverse()
+void ChompOptimizer::calculatePseudoInverse(const Eigen::MatrixXd& jacobian,
+                                            Eigen::MatrixXd& jacobian_pseudo_inverse) const
 {
-  jacobian_jacobian_tranpose_ =
-      jacobian_ * jacobian_.transpose() + Eigen::MatrixXd::Identity(3, 3) * parameters_->pseudo_inverse_ridge_factor_;
-  jacobian_pseudo_inverse_ = jacobian_.transpose() * jacobian_jacobian_tranpose_.inverse();
+  const Eigen::Matrix3d jacobian_jacobian_tranpose =
+      jacobian * jacobian.transpose() + Eigen::Matrix3d::Identity() * parameters_->pseudo_inverse_ridge_factor_;
+  jacobian_pseudo_inverse = jacobian.transpose() * jacobian_jacobian_tranpose.inverse();
 }
 
 void ChompOptimizer::calculateTotalIncrements()
@@ -714,11 +740,11 @@ double ChompOptimizer::getCollisionCost()
   return parameters_->obstacle_cost_weight_ * collision_cost;
 }
 
-void ChompOptimizer::computeJointProperties(int trajectory_point)
+void ChompOptimizer::computeJointProperties(int trajectory_point, const moveit::core::RobotState& state)
 {
   for (int j = 0; j < num_joints_; ++j)
   {
-    const moveit::core::JointModel* joint_model = state_.getJointModel(joint_names_[j]);
+    const moveit::core::JointModel* joint_model = state.getJointModel(joint_names_[j]);
     const moveit::core::RevoluteJointModel* revolute_joint =
         dynamic_cast<const moveit::core::RevoluteJointModel*>(joint_model);
     const moveit::core::PrismaticJointModel* prismatic_joint =
@@ -726,9 +752,9 @@ void ChompOptimizer::computeJointProperties(int trajectory_point)
 
     std::string parent_link_name = joint_model->getParentLinkModel()->getName();
     std::string child_link_name = joint_model->getChildLinkModel()->getName();
-    Eigen::Isometry3d joint_transform = state_.getGlobalLinkTransform(parent_link_name) *
+    Eigen::Isometry3d joint_transform = state.getGlobalLinkTransform(parent_link_name) *
                                         (robot_model_->getLinkModel(child_link_name)->getJointOriginTransform() *
-                                         (state_.getJointTransform(joint_model)));
+                                         (state.getJointTransform(joint_model)));
 
     // joint_transform = inverseWorldTransform * jointTransform;
     Eigen::Vector3d axis;
@@ -873,29 +899,37 @@ void ChompOptimizer::performForwardKinematics()
     end = num_vars_all_ - 1;
   }
 
-  is_collision_free_ = true;
-
-  auto total_dur = std::chrono::duration<double>::zero();
+  // Set Robot states from trajectory points, each point has its own state so they are updated in parallel...
+  parallelFor(start, end, parameters_->num_threads_, [this](int block_begin, int block_end) {
+    for (int i = block_begin; i <= block_end; ++i)
+      setRobotStateFromPoint(group_trajectory_, i, point_states_[i]);
+  });
 
-  // for each point in the trajectory
+  std::vector<const moveit::core::RobotState*> states;
+  std::vector<collision_detection::GroupStateRepresentationPtr> gsrs;
+  states.reserve(end - start + 1);
+  gsrs.reserve(end - start + 1);
   for (int i = start; i <= end; ++i)
   {
-    // Set Robot state from trajectory point...
-    collision_detection::CollisionRequest req;
-    collision_detection::CollisionResult res;
-    req.group_name = planning_group_;
-    setRobotStateFromPoint(group_trajectory_, i);
-    auto grad = std::chrono::system_clock::now();
-
-    hy_env_->getCollisionGradients(req, res, state_, nullptr, gsr_);
-    total_dur += (std::chrono::system_clock::now() - grad);
-    computeJointProperties(i);
-    state_is_in_collision_[i] = false;
-
-    // Keep vars in scope
+    states.push_back(&point_states_[i]);
+    gsrs.push_back(point_gsrs_[i]);
+  }
+
+  // ...and get the collision gradients of all of them at once
+  collision_detection::CollisionRequest req;
+  req.group_name = planning_group_;
+  hy_env_->getCollisionGradients(req, states, &planning_scene_->getAllowedCollisionMatrix(), gsrs);
+
+  // for each point in the trajectory
+  parallelFor(start, end, parameters_->num_threads_, [this, start, &gsrs](int block_begin, int block_end) {
+    for (int i = block_begin; i <= block_end; ++i)
     {
+      point_gsrs_[i] = gsrs[i - start];
+      computeJointProperties(i, point_states_[i]);
+      state_is_in_collision_[i] = false;
+
       size_t j = 0;
-      for (const collision_detection::GradientInfo& info : gsr_->gradients_)
+      for (const collision_detection::GradientInfo& info : point_gsrs_[i]->gradients_)
       {
         for (size_t k = 0; k < info.sphere_locations.size(); ++k)
         {
@@ -914,36 +948,39 @@ void ChompOptimizer::performForwardKinematics()
           if (point_is_in_collision_[i][j])
           {
             state_is_in_collision_[i] = true;
-            is_collision_free_ = false;
           }
           j++;
         }
       }
     }
-  }
+  });
+  is_collision_free_ = std::none_of(state_is_in_collision_.begin() + start, state_is_in_collision_.begin() + end + 1,
+                                    [](int in_collision) { return in_collision; });
 
   // now, get the vel and acc for each collision point (using finite differencing)
-  for (int i = free_vars_start_; i <= free_vars_end_; ++i)
-  {
-    for (int j = 0; j < num_collision_points_; ++j)
+  parallelFor(free_vars_start_, free_vars_end_, parameters_->num_threads_, [&](int block_begin, int block_end) {
+    for (int i = block_begin; i <= block_end; ++i)
     {
-      collision_point_vel_eigen_[i][j] = Eigen::Vector3d(0, 0, 0);
-      collision_point_acc_eigen_[i][j] = Eigen::Vector3d(0, 0, 0);
-      for (int k = -DIFF_RULE_LENGTH / 2; k <= DIFF_RULE_LENGTH / 2; ++k)
+      for (int j = 0; j < num_collision_points_; ++j)
       {
-        collision_point_vel_eigen_[i][j] +=
-            (inv_time * DIFF_RULES[0][k + DIFF_RULE_LENGTH / 2]) * collision_point_pos_eigen_[i + k][j];
-        collision_point_acc_eigen_[i][j] +=
-            (inv_time_sq * DIFF_RULES[1][k + DIFF_RULE_LENGTH / 2]) * collision_point_pos_eigen_[i + k][j];
-      }
+        collision_point_vel_eigen_[i][j] = Eigen::Vector3d(0, 0, 0);
+        collision_point_acc_eigen_[i][j] = Eigen::Vector3d(0, 0, 0);
+        for (int k = -DIFF_RULE_LENGTH / 2; k <= DIFF_RULE_LENGTH / 2; ++k)
+        {
+          collision_point_vel_eigen_[i][j] +=
+              (inv_time * DIFF_RULES[0][k + DIFF_RULE_LENGTH / 2]) * collision_point_pos_eigen_[i + k][j];
+          collision_point_acc_eigen_[i][j] +=
+              (inv_time_sq * DIFF_RULES[1][k + DIFF_RULE_LENGTH / 2]) * collision_point_pos_eigen_[i + k][j];
+        }
 
-      // get the norm of the velocity:
-      collision_point_vel_mag_[i][j] = collision_point_vel_eigen_[i][j].norm();
+        // get the norm of the velocity:
+        collision_point_vel_mag_[i][j] = collision_point_vel_eigen_[i][j].norm();
+      }
     }
-  }
+  });
 }
 
-void ChompOptimizer::setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i)
+void ChompOptimizer::setRobotStateFromPoint(ChompTrajectory& group_trajectory, int i, moveit::core::RobotState& state)
 {
   const Eigen::MatrixXd::RowXpr& point = group_trajectory.getTrajectoryPoint(i);
 
@@ -952,8 +989,8 @@ void ChompOptimizer::setRobotStateFromPoint(ChompTrajectory& group_trajectory, i
   for (size_t j = 0; j < group_trajectory.getNumJoints(); ++j)
     joint_states.emplace_back(point(0, j));
 
-  state_.setJointGroupActivePositions(planning_group_, joint_states);
-  state_.update();
+  state.setJointGroupActivePositions(planning_group_, joint_states);
+  state.update();
 }
 
 void ChompOptimizer::perturbTrajectory()
@@ -64,6 +64,8 @@ ChompParameters::ChompParameters()
   trajectory_initialization_method_ = std::string("quintic-spline");
   enable_failure_recovery_ = false;
   max_recovery_attempts_ = 5;
+  persistent_distance_field_ = false;
+  num_threads_ = 0;
 }
 
 ChompParameters::~ChompParameters() = default;
@@ -62,12 +62,18 @@ private:
                              bool verbose = false) const;
   bool checkStateValidity(ompl::base::State* new_goal, const moveit::core::RobotState& state,
                           bool verbose = false) const;
+  /** @brief Check a sampled state against the goal constraints, counting and reporting failures */
+  bool checkSampledConstraints(const moveit::core::RobotState& state, unsigned int attempts_so_far, bool verbose);
+  /** @brief Sample a batch of goal states with the constraint sampler, keeping the valid ones for later calls */
+  void sampleBatch(ompl::base::State* new_goal, std::size_t batch_size, bool verbose);
 
   const ModelBasedPlanningContext* planning_context_;
   kinematic_constraints::KinematicConstraintSetPtr kinematic_constraint_set_;
   constraint_samplers::ConstraintSamplerPtr constraint_sampler_;
   ompl::base::StateSamplerPtr default_sampler_;
   moveit::core::RobotState work_state_;
+  /** @brief Valid goal states of the last batch, added to the goal region one per sampling call */
+  std::vector<moveit::core::RobotState> pending_goal_states_;
   unsigned int invalid_sampled_constraints_;
   bool warned_invalid_samples_;
   unsigned int verbose_display_;
@@ -75,5 +75,7 @@ private:
   unsigned int constrained_success_;
   unsigned int constrained_failure_;
   double inv_dim_;
+  /** @brief True if the constraint sampler writes the joint space state directly, without using work_state_ */
+  bool sample_joint_group_positions_;
 };
 }  // namespace ompl_interface
@@ -135,6 +135,7 @@ struct ConstraintApproximationConstructionOptions
     , explicit_motions(false)
     , explicit_points_resolution(0.0)
     , max_explicit_points(0)
+    , thread_count(0)
   {
   }
 
@@ -145,6 +146,8 @@ struct ConstraintApproximationConstructionOptions
   bool explicit_motions;
   double explicit_points_resolution;
   unsigned int max_explicit_points;
+  /// the number of threads checking candidate connections, 0 for one per hardware thread
+  unsigned int thread_count;
 };
 
 struct ConstraintApproximationConstructionResults
@@ -0,0 +1,90 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Motion validator that checks segments coarse-to-fine and remembers the validity of recently checked states */
+
+#pragma once
+
+#include <moveit/ompl_interface/detail/threadsafe_state_storage.hpp>
+#include <ompl/base/MotionValidator.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ompl_interface
+{
+class ModelBasedPlanningContext;
+
+/** @class BisectionMotionValidator
+    @brief A motion validator that checks the states of a segment in bisection order, so that an obstacle in the
+    middle of a segment is found after few checks.
+
+    The validity of recently checked states is remembered in a fixed-size table indexed by a hash of their joint values,
+    so states that are checked again, e.g. the endpoints shared by consecutive motions, are not checked again.
+    Optionally, collisions with the world are checked with the continuous collision API between the endpoints of a
+    segment instead of at the interpolated states. Self-collisions, path constraints and feasibility are then only
+    checked at the endpoints, so continuous checking is skipped if there are path constraints.
+
+    The table is not invalidated, so the validator has to be replaced when the planning scene or the constraints
+    change. */
+class BisectionMotionValidator : public ompl::base::MotionValidator
+{
+public:
+  /** @brief Constructor
+      @param planning_context The context whose space information and planning scene are used
+      @param cache_size The number of entries in the validity table, 0 to disable it
+      @param continuous_collision_checking Whether to check world collisions of segments with the continuous API */
+  BisectionMotionValidator(const ModelBasedPlanningContext* planning_context, std::size_t cache_size,
+                           bool continuous_collision_checking);
+
+  bool checkMotion(const ompl::base::State* s1, const ompl::base::State* s2) const override;
+  bool checkMotion(const ompl::base::State* s1, const ompl::base::State* s2,
+                   std::pair<ompl::base::State*, double>& last_valid) const override;
+
+private:
+  bool isStateValid(const ompl::base::State* state) const;
+  bool isSegmentCollisionFree(const ompl::base::State* s1, const ompl::base::State* s2) const;
+  std::uint64_t hashState(const ompl::base::State* state) const;
+
+  const ModelBasedPlanningContext* planning_context_;
+  bool continuous_collision_checking_;
+
+  // entries hold the hash of a state with the lowest bit replaced by its validity, 0 marks an empty entry
+  mutable std::vector<std::atomic<std::uint64_t>> cache_;
+
+  // the two endpoints of a segment checked with the continuous collision API
+  TSStateStorage tss_from_;
+  TSStateStorage tss_to_;
+};
+}  // namespace ompl_interface
@@ -146,6 +146,15 @@ public:
    * */
   void jacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values, Eigen::Ref<Eigen::MatrixXd> out) const override;
 
+  /** \brief Evaluate the constraint function and its Jacobian together.
+   *
+   * Equivalent to calling `function` and `jacobian` with the same joint values, but the forward kinematics and the
+   * constraint error are only computed once.
+   * */
+  virtual void functionAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values,
+                                   Eigen::Ref<Eigen::VectorXd> out_function,
+                                   Eigen::Ref<Eigen::MatrixXd> out_jacobian) const;
+
   /** \brief Wrapper for forward kinematics calculated by MoveIt's Robot State.
    *
    * TODO(jeroendm) Are these actually const, as the robot state is modified? How come it works?
@@ -193,6 +202,14 @@ public:
    * */
   virtual Eigen::MatrixXd calcErrorJacobian(const Eigen::Ref<const Eigen::VectorXd>& /*x*/) const;
 
+  /** \brief Calculate both `calcError` and `calcErrorJacobian` for the same parameters.
+   *
+   * Used by `jacobian`, which needs the error for the derivative of the penalty functions. Override it when the two
+   * share intermediate results.
+   * */
+  virtual void calcErrorAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd& error,
+                                    Eigen::MatrixXd& error_jacobian) const;
+
   // the methods below are specifically for debugging and testing
 
   const std::string& getLinkName()
@@ -219,6 +236,12 @@ protected:
   TSStateStorage state_storage_;
   const moveit::core::JointModelGroup* joint_model_group_;
 
+  /** \brief Get this thread's robot state with up-to-date link transforms for the given joint values.
+   *
+   * The transforms are only recomputed if the joint values differ from those of the previous call in this thread.
+   * */
+  moveit::core::RobotState* updateRobotState(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const;
+
   // all attributes below can be considered const as soon as the constraint message is parsed
   // but I (jeroendm) do not know how to elegantly express this in C++
   // parsing the constraints message and passing all this data members separately to the constructor
@@ -322,6 +345,10 @@ public:
 
   void jacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values, Eigen::Ref<Eigen::MatrixXd> out) const override;
 
+  void functionAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values,
+                           Eigen::Ref<Eigen::VectorXd> out_function,
+                           Eigen::Ref<Eigen::MatrixXd> out_jacobian) const override;
+
 private:
   /** \brief Position bounds under this threshold are interpreted as equality constraints, the others as unbounded.
    *
@@ -413,6 +440,10 @@ public:
    * performance?
    * */
   Eigen::MatrixXd calcErrorJacobian(const Eigen::Ref<const Eigen::VectorXd>& x) const override;
+
+  /** \brief Compute the angle-axis representation of the orientation error only once for the error and its Jacobian. */
+  void calcErrorAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd& error,
+                            Eigen::MatrixXd& error_jacobian) const override;
 };
 
 /** \brief Extract position constraints from the MoveIt message.
@@ -38,7 +38,9 @@
 
 #include <ompl/config.h>
 #include <ompl/base/ProjectionEvaluator.h>
-#include <moveit/ompl_interface/detail/threadsafe_state_storage.hpp>
+#include <moveit/robot_model/link_model.hpp>
+#include <Eigen/Geometry>
+#include <vector>
 
 typedef Eigen::Ref<Eigen::VectorXd> OMPLProjection;
 
@@ -47,7 +49,10 @@ namespace ompl_interface
 class ModelBasedPlanningContext;
 
 /** @class ProjectionEvaluatorLinkPose
-    @brief */
+    @brief Projects a state to the position of a link.
+
+    Only the joints on the chain from the link up to the first joint of the group are evaluated, starting from the
+    transform of the links above the chain in the complete initial state, which the group variables do not change. */
 class ProjectionEvaluatorLinkPose : public ompl::base::ProjectionEvaluator
 {
 public:
@@ -58,9 +63,16 @@ public:
   void project(const ompl::base::State* state, OMPLProjection projection) const override;
 
 private:
-  const ModelBasedPlanningContext* planning_context_;
+  struct ChainLink
+  {
+    const moveit::core::LinkModel* link;
+    int group_index;  // index of the values of the parent joint in the group state, -1 if not a group joint
+    std::vector<double> fixed_values;  // values of the parent joint if it is not a group joint
+  };
+
   const moveit::core::LinkModel* link_;
-  TSStateStorage tss_;
+  Eigen::Isometry3d root_transform_;
+  std::vector<ChainLink> chain_;  // ordered from the root towards link_
 };
 
 /** @class ProjectionEvaluatorJointValue
@@ -77,4 +89,19 @@ public:
 private:
   std::vector<unsigned int> variables_;
 };
+
+/** @class ProjectionEvaluatorRandomLinear
+    @brief Projects the group variables with a random matrix with orthonormal rows, computed once at construction */
+class ProjectionEvaluatorRandomLinear : public ompl::base::ProjectionEvaluator
+{
+public:
+  ProjectionEvaluatorRandomLinear(const ModelBasedPlanningContext* pc, unsigned int dimension);
+
+  unsigned int getDimension() const override;
+  void defaultCellSizes() override;
+  void project(const ompl::base::State* state, OMPLProjection projection) const override;
+
+private:
+  Eigen::MatrixXd projection_matrix_;
+};
 }  // namespace ompl_interface
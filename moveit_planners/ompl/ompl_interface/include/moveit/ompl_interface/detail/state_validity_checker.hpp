@@ -41,6 +41,10 @@
  * - Kinematic path constraints.
  * - Generic user-specified feasibility using the `isStateFeasible` of the planning scene.
  *
+ * Optionally, self-collisions are checked before collisions with the world, skipping the exact self-collision check
+ * for states in which the bounding spheres of the robot links are apart, and states close to recently found
+ * colliding states are rejected without checking them.
+ *
  * IMPORTANT: Although the isValid method takes the state as `const ompl::base::State* state`,
  * it uses const_cast to modify the validity of the state with `markInvalid` and `markValid` for caching.
  * **/
@@ -50,6 +54,8 @@
 #include <moveit/ompl_interface/detail/threadsafe_state_storage.hpp>
 #include <moveit/collision_detection/collision_common.hpp>
 #include <ompl/base/StateValidityChecker.h>
+#include <atomic>
+#include <mutex>
 
 namespace ompl_interface
 {
@@ -60,7 +66,21 @@ class ModelBasedPlanningContext;
 class StateValidityChecker : public ompl::base::StateValidityChecker
 {
 public:
+  /** \brief Number of checked states, and of states rejected by each stage of the check */
+  struct Statistics
+  {
+    std::atomic<std::size_t> checked_states{ 0 };
+    std::atomic<std::size_t> bounds_rejections{ 0 };
+    std::atomic<std::size_t> cache_rejections{ 0 };
+    std::atomic<std::size_t> path_constraints_rejections{ 0 };
+    std::atomic<std::size_t> feasibility_rejections{ 0 };
+    std::atomic<std::size_t> self_collision_rejections{ 0 };  // only with staged collision checking
+    std::atomic<std::size_t> collision_rejections{ 0 };
+    std::atomic<std::size_t> skipped_self_collision_checks{ 0 };
+  };
+
   StateValidityChecker(const ModelBasedPlanningContext* planning_context);
+  ~StateValidityChecker() override;
 
   bool isValid(const ompl::base::State* state) const override
   {
@@ -86,7 +106,28 @@ public:
 
   void setVerbose(bool flag);
 
+  /** \brief Check self-collisions before collisions with the world (for the checks without distance computation).
+   * The exact self-collision check is skipped if the bounding spheres of all link pairs that are checked and not
+   * always allowed to collide are apart. Bounding spheres are not used for links with padding or scaling. */
+  void setStagedCollisionChecking(bool flag);
+
+  /** \brief Remember the last \e size states found in collision and reject states closer than \e radius (in the
+   * distance of the state space) to any of these without checking them. This approximation speeds up planners that
+   * sample densely near obstacles but can reject valid states. A size of 0 disables the cache. */
+  void setInvalidStateCache(std::size_t size, double radius);
+
+  const Statistics& getStatistics() const
+  {
+    return statistics_;
+  }
+
 protected:
+  // Check collisions of robot_state, in stages if enabled. A colliding state is added to the invalid state cache.
+  bool checkCollision(const ompl::base::State* state, moveit::core::RobotState& robot_state, bool verbose) const;
+
+  // Whether state is close to a recently found colliding state
+  bool isInInvalidStateCache(const ompl::base::State* state) const;
+
   const ModelBasedPlanningContext* planning_context_;
   std::string group_name_;
   TSStateStorage tss_;
@@ -97,6 +138,32 @@ protected:
 
   collision_detection::CollisionRequest collision_request_with_cost_;
   bool verbose_;
+
+  mutable Statistics statistics_;
+
+private:
+  struct LinkSphere
+  {
+    const moveit::core::LinkModel* link;
+    Eigen::Vector3d center;  // in the link frame
+    double radius;
+  };
+
+  // Whether the bounding spheres show that robot_state is free of self-collisions, needs up-to-date link transforms
+  bool areBoundingSpheresApart(const moveit::core::RobotState& robot_state) const;
+
+  bool staged_collision_checking_;
+  bool use_bounding_spheres_;
+  std::vector<LinkSphere> link_spheres_;
+  std::vector<std::pair<std::size_t, std::size_t>> link_sphere_pairs_;  // indices into link_spheres_
+
+  // Ring buffer of recently found colliding states, protected by invalid_state_cache_lock_
+  ompl::base::StateSpacePtr invalid_state_space_;
+  std::size_t invalid_state_cache_size_;
+  double invalid_state_cache_radius_;
+  mutable std::vector<ompl::base::State*> invalid_states_;
+  mutable std::size_t next_invalid_state_;
+  mutable std::mutex invalid_state_cache_lock_;
 };
 
 /** \brief A StateValidityChecker that can handle states of type `ompl::base::ConstraintStateSpace::StateType`.
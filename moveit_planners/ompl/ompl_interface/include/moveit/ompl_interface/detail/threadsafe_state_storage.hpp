@@ -37,11 +37,17 @@
 #pragma once
 
 #include <moveit/robot_state/robot_state.hpp>
+#include <cstdint>
+#include <map>
 #include <thread>
 #include <mutex>
 
 namespace ompl_interface
 {
+/** @brief Provides one RobotState per thread, all initialized from the same start state.
+ *
+ * The states are looked up in a small thread-local cache first, so repeated calls from the same thread do not
+ * lock. The mutex is only taken the first time a thread requests its state. */
 class TSStateStorage
 {
 public:
@@ -52,6 +58,8 @@ public:
   moveit::core::RobotState* getStateStorage() const;
 
 private:
+  /// unique for each instance (unlike its address), identifies the instance in the thread-local caches
+  const std::uint64_t id_;
   moveit::core::RobotState start_state_;
   mutable std::map<std::thread::id, moveit::core::RobotState*> thread_states_;
   mutable std::mutex lock_;
@@ -45,6 +45,7 @@
 #include <ompl/tools/multiplan/ParallelPlan.h>
 #include <ompl/base/StateStorage.h>
 #include <ompl/base/spaces/constraint/ConstrainedStateSpace.h>
+#include <moveit/utils/work_counters.hpp>
 
 namespace ompl_interface
 {
@@ -289,6 +290,18 @@ public:
     hybridize_ = flag;
   }
 
+  /* @brief Get the fraction of the allowed planning time given to solving when solutions are simplified */
+  double getSolveTimeFraction() const
+  {
+    return solve_time_fraction_;
+  }
+
+  /* @brief Set the fraction of the allowed planning time given to solving when solutions are simplified.
+     The remaining time until the deadline is given to simplification, so that both together never exceed the
+     allowed planning time. Values are clamped to (0, 1], 1 lets solving use the complete budget.
+  */
+  void setSolveTimeFraction(double fraction);
+
   /* @brief Solve the planning problem. Return true if the problem is solved
      @param timeout The time to spend on solving
      @param count The number of runs to combine the paths of, in an attempt to generate better quality paths
@@ -315,6 +328,13 @@ public:
     return last_simplify_time_;
   }
 
+  /* @brief Get the work counters of the thread running the current solve(), installed by the state validity checkers
+   * in the planning threads */
+  moveit::WorkCounters* getWorkCounters() const
+  {
+    return work_counters_;
+  }
+
   /* @brief Apply smoothing and try to simplify the plan
      @param timeout The amount of time allowed to be spent on simplifying the plan*/
   void simplifySolution(double timeout);
@@ -348,6 +368,9 @@ protected:
   void preSolve();
   void postSolve();
 
+  /** @brief Invalidate the roadmap of a multi-query planner if the world changed since it was last used */
+  void updatePersistentRoadmap(ob::Planner& planner);
+
   void startSampling();
   void stopSampling();
 
@@ -384,6 +407,9 @@ protected:
   virtual ob::PlannerTerminationCondition constructPlannerTerminationCondition(double timeout,
                                                                                const ompl::time::point& start);
 
+  /** @brief Time given to solve() out of the allowed planning time of the request, see setSolveTimeFraction() */
+  double getSolveTimeout() const;
+
   void registerTerminationCondition(const ob::PlannerTerminationCondition& ptc);
   void unregisterTerminationCondition();
 
@@ -418,6 +444,9 @@ protected:
   /// the time spent simplifying the last plan
   double last_simplify_time_;
 
+  /// the work counters of the thread running the current solve()
+  moveit::WorkCounters* work_counters_ = nullptr;
+
   /// maximum number of valid states to store in the goal region for any planning request (when such sampling is
   /// possible)
   unsigned int max_goal_samples_;
@@ -443,6 +472,10 @@ protected:
   /// when false, clears planners before running solve()
   bool multi_query_planning_enabled_;
 
+  /// the multi-query planner whose roadmap is known to be valid in the world with version roadmap_world_version_
+  std::weak_ptr<ob::Planner> roadmap_planner_;
+  std::uint64_t roadmap_world_version_ = 0;
+
   ConstraintsLibraryPtr constraints_library_;
 
   bool simplify_solutions_;
@@ -452,5 +485,8 @@ protected:
 
   // if false parallel plan returns the first solution found
   bool hybridize_;
+
+  // fraction of the allowed planning time used for solving if solutions are simplified afterwards
+  double solve_time_fraction_;
 };
 }  // namespace ompl_interface
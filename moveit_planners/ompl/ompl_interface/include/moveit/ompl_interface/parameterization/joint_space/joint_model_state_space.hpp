@@ -51,5 +51,14 @@ public:
   {
     return PARAMETERIZATION_TYPE;
   }
+
+  /** @brief Unless a custom distance function is set, use the batch distance of the joint model group, which is
+      vectorized for groups of prismatic and non-continuous revolute joints */
+  double distance(const ompl::base::State* state1, const ompl::base::State* state2) const override;
+
+  /** @brief Unless a custom interpolation function is set, use the batch interpolation of the joint model group,
+      which is vectorized for groups of prismatic and non-continuous revolute joints */
+  void interpolate(const ompl::base::State* from, const ompl::base::State* to, const double t,
+                   ompl::base::State* state) const override;
 };
 }  // namespace ompl_interface
@@ -258,6 +258,10 @@ public:
   void setTagSnapToSegment(double snap);
 
 protected:
+  /** @brief Set the tag of the state interpolated at \e t between \e from and \e to */
+  void setInterpolatedTag(const ompl::base::State* from, const ompl::base::State* to, const double t,
+                          ompl::base::State* state) const;
+
   ModelBasedStateSpaceSpecification spec_;
   std::vector<moveit::core::JointModel::Bounds> joint_bounds_storage_;
   std::vector<const moveit::core::JointModel*> joint_model_vector_;
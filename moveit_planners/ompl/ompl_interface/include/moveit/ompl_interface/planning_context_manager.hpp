@@ -79,6 +79,15 @@ private:
 class PlanningContextManager
 {
 public:
+  /** @brief Usage of the pool of planning contexts that are reused across requests */
+  struct ContextPoolStatistics
+  {
+    std::size_t hits = 0;    ///< requests served by a pooled context
+    std::size_t misses = 0;  ///< requests for which a new context was constructed
+    std::size_t pooled = 0;  ///< contexts in the pool
+    std::size_t in_use = 0;  ///< pooled contexts currently used by a request
+  };
+
   PlanningContextManager(moveit::core::RobotModelConstPtr robot_model,
                          constraint_samplers::ConstraintSamplerManagerPtr csm);
   ~PlanningContextManager();
@@ -169,6 +178,27 @@ public:
     return robot_model_;
   }
 
+  /** @brief Get the maximum number of contexts pooled per planner configuration and state space type, 0 if unlimited */
+  std::size_t getMaximumPooledContexts() const
+  {
+    return max_pooled_contexts_;
+  }
+
+  /** @brief Set the maximum number of contexts pooled per planner configuration and state space type, 0 if unlimited.
+      Requests finding all pooled contexts in use construct a new context, which is only pooled if there is room. */
+  void setMaximumPooledContexts(std::size_t max_pooled_contexts);
+
+  /** @brief Construct contexts for the planner configuration \e config_name ahead of requests, until its pool holds
+      \e count contexts. The contexts use the state space selected for requests without path constraints.
+      @return The number of contexts pooled for this configuration */
+  std::size_t preallocatePlanningContexts(const std::string& config_name, std::size_t count);
+
+  /** @brief Get the hit and miss counts of the context pool, e.g. to choose its size */
+  ContextPoolStatistics getContextPoolStatistics() const;
+
+  /** @brief Reset the hit and miss counts of the context pool */
+  void resetContextPoolStatistics();
+
   /** \brief Returns a planning context to OMPLInterface, which in turn passes it to OMPLPlannerManager.
    *
    * This function checks the input and reads planner specific configurations.
@@ -215,11 +245,22 @@ protected:
   template <typename T>
   void registerPlannerAllocatorHelper(const std::string& planner_id);
 
-  /** \brief This is the function that constructs new planning contexts if no previous ones exist that are suitable */
+  /** \brief This is the function that returns a pooled planning context that is not in use, or constructs a new one if
+      there is none */
   ModelBasedPlanningContextPtr getPlanningContext(const planning_interface::PlannerConfigurationSettings& config,
                                                   const ModelBasedStateSpaceFactoryPtr& factory,
                                                   const moveit_msgs::msg::MotionPlanRequest& req) const;
 
+  /** \brief Construct a new planning context, without adding it to the pool */
+  ModelBasedPlanningContextPtr createPlanningContext(const planning_interface::PlannerConfigurationSettings& config,
+                                                     const ModelBasedStateSpaceFactoryPtr& factory,
+                                                     const moveit_msgs::msg::MotionPlanRequest& req) const;
+
+  /** \brief Select the state space factory for a request, as configured for the planner configuration */
+  const ModelBasedStateSpaceFactoryPtr&
+  selectStateSpaceFactory(const planning_interface::PlannerConfigurationSettings& config,
+                          const moveit_msgs::msg::MotionPlanRequest& req) const;
+
   const ModelBasedStateSpaceFactoryPtr& getStateSpaceFactory(const std::string& factory_type) const;
   const ModelBasedStateSpaceFactoryPtr& getStateSpaceFactory(const std::string& group_name,
                                                              const moveit_msgs::msg::MotionPlanRequest& req) const;
@@ -260,6 +301,9 @@ protected:
   /// needed)
   unsigned int minimum_waypoint_count_;
 
+  /// the maximum number of contexts pooled per planner configuration and state space type, 0 if unlimited
+  std::size_t max_pooled_contexts_;
+
   /// Multi-query planner allocator
   MultiQueryPlannerAllocator planner_allocator_;
 
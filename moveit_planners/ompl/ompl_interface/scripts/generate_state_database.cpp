@@ -46,6 +46,7 @@
 #include <moveit/utils/message_checks.hpp>
 
 #include <boost/math/constants/constants.hpp>
+#include <algorithm>
 #include <sstream>
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("moveit.planners_ompl.generate_state_database");
@@ -95,6 +96,11 @@ struct GenerateStateDatabaseParameters
     node->get_parameter_or("explicit_points_resolution", construction_opts.explicit_points_resolution, 0.05);
     getUintParameterOr(node, "max_explicit_points", construction_opts.max_explicit_points, 200);
 
+    // connections are checked on one thread per hardware thread by default
+    int thread_count;
+    node->get_parameter_or("thread_count", thread_count, 0);
+    construction_opts.thread_count = static_cast<unsigned int>(std::max(thread_count, 0));
+
     // local planning in JointModel state space
     node->get_parameter_or("state_space_parameterization", construction_opts.state_space_parameterization,
                            std::string("JointModel"));
@@ -92,6 +92,44 @@ bool ConstrainedGoalSampler::stateValidityCallback(ob::State* new_goal, const mo
   return checkStateValidity(new_goal, solution_state, verbose);
 }
 
+bool ConstrainedGoalSampler::checkSampledConstraints(const moveit::core::RobotState& state,
+                                                     unsigned int attempts_so_far, bool verbose)
+{
+  if (kinematic_constraint_set_->isSatisfied(state, verbose))
+    return true;
+
+  invalid_sampled_constraints_++;
+  if (!warned_invalid_samples_ && invalid_sampled_constraints_ >= (attempts_so_far * 8) / 10)
+  {
+    warned_invalid_samples_ = true;
+    RCLCPP_WARN(getLogger(), "More than 80%% of the sampled goal states "
+                             "fail to satisfy the constraints imposed on the goal sampler. "
+                             "Is the constrained sampler working correctly?");
+  }
+  return false;
+}
+
+void ConstrainedGoalSampler::sampleBatch(ob::State* new_goal, std::size_t batch_size, bool verbose)
+{
+  // the validity callback runs after the batch is solved, so the sampled solutions are checked one by one
+  constraint_sampler_->setGroupStateValidityCallback(
+      [this, new_goal, verbose](moveit::core::RobotState* robot_state, const moveit::core::JointModelGroup* joint_group,
+                                const double* joint_group_variable_values) {
+        return stateValidityCallback(new_goal, robot_state, joint_group, joint_group_variable_values, verbose);
+      });
+
+  std::vector<moveit::core::RobotState> states;
+  constraint_sampler_->sampleBatch(work_state_, batch_size, planning_context_->getMaximumStateSamplingAttempts(),
+                                   states);
+  for (moveit::core::RobotState& state : states)
+  {
+    state.update();
+    if (checkSampledConstraints(state, samplingAttemptsCount(), verbose) &&
+        checkStateValidity(new_goal, state, verbose))
+      pending_goal_states_.push_back(std::move(state));
+  }
+}
+
 bool ConstrainedGoalSampler::sampleUsingConstraintSampler(const ob::GoalLazySamples* gls, ob::State* new_goal)
 {
   unsigned int max_attempts = planning_context_->getMaximumGoalSamplingAttempts();
@@ -109,6 +147,15 @@ bool ConstrainedGoalSampler::sampleUsingConstraintSampler(const ob::GoalLazySamp
   if (planning_context_->getOMPLSimpleSetup()->getProblemDefinition()->hasSolution())
     return false;
 
+  // stream the remaining valid states of the last batch, one per call
+  if (!pending_goal_states_.empty())
+  {
+    planning_context_->getOMPLStateSpace()->copyToOMPLState(new_goal, pending_goal_states_.back());
+    pending_goal_states_.pop_back();
+    return true;
+  }
+
+  const std::size_t batch_size = constraint_sampler_ ? constraint_sampler_->getPreferredBatchSize() : 1;
   unsigned int max_attempts_div2 = max_attempts / 2;
   for (unsigned int a = gls->samplingAttemptsCount(); a < max_attempts && gls->isSampling(); ++a)
   {
@@ -122,7 +169,18 @@ bool ConstrainedGoalSampler::sampleUsingConstraintSampler(const ob::GoalLazySamp
       }
     }
 
-    if (constraint_sampler_)
+    if (constraint_sampler_ && batch_size > 1)
+    {
+      // solve IK for a batch of candidates at once, in parallel if the solver supports it
+      sampleBatch(new_goal, batch_size, verbose);
+      if (!pending_goal_states_.empty())
+      {
+        planning_context_->getOMPLStateSpace()->copyToOMPLState(new_goal, pending_goal_states_.back());
+        pending_goal_states_.pop_back();
+        return true;
+      }
+    }
+    else if (constraint_sampler_)
     {
       // makes the constraint sampler also perform a validity callback
       moveit::core::GroupStateValidityCallbackFn gsvcf = [this, new_goal,
@@ -136,22 +194,9 @@ bool ConstrainedGoalSampler::sampleUsingConstraintSampler(const ob::GoalLazySamp
       if (constraint_sampler_->sample(work_state_, planning_context_->getMaximumStateSamplingAttempts()))
       {
         work_state_.update();
-        if (kinematic_constraint_set_->decide(work_state_, verbose).satisfied)
-        {
-          if (checkStateValidity(new_goal, work_state_, verbose))
-            return true;
-        }
-        else
-        {
-          invalid_sampled_constraints_++;
-          if (!warned_invalid_samples_ && invalid_sampled_constraints_ >= (attempts_so_far * 8) / 10)
-          {
-            warned_invalid_samples_ = true;
-            RCLCPP_WARN(getLogger(), "More than 80%% of the sampled goal states "
-                                     "fail to satisfy the constraints imposed on the goal sampler. "
-                                     "Is the constrained sampler working correctly?");
-          }
-        }
+        if (checkSampledConstraints(work_state_, attempts_so_far, verbose) &&
+            checkStateValidity(new_goal, work_state_, verbose))
+          return true;
       }
     }
     else
@@ -160,7 +205,7 @@ bool ConstrainedGoalSampler::sampleUsingConstraintSampler(const ob::GoalLazySamp
       if (static_cast<const StateValidityChecker*>(si_->getStateValidityChecker().get())->isValid(new_goal, verbose))
       {
         planning_context_->getOMPLStateSpace()->copyToRobotState(work_state_, new_goal);
-        if (kinematic_constraint_set_->decide(work_state_, verbose).satisfied)
+        if (kinematic_constraint_set_->isSatisfied(work_state_, verbose))
           return true;
       }
     }
@@ -36,6 +36,8 @@
 
 #include <moveit/ompl_interface/detail/constrained_sampler.hpp>
 #include <moveit/ompl_interface/model_based_planning_context.hpp>
+#include <moveit/ompl_interface/parameterization/joint_space/joint_model_state_space.hpp>
+#include <moveit/utils/work_counters.hpp>
 
 #include <utility>
 
@@ -50,6 +52,13 @@ ompl_interface::ConstrainedSampler::ConstrainedSampler(const ModelBasedPlanningC
   , constrained_failure_(0)
 {
   inv_dim_ = space_->getDimension() > 0 ? 1.0 / static_cast<double>(space_->getDimension()) : 1.0;
+
+  // the values of a joint space state are the variables of its group, so they can be sampled in place
+  const ModelBasedStateSpacePtr& state_space = pc->getOMPLStateSpace();
+  sample_joint_group_positions_ =
+      constraint_sampler_->canSampleJointGroupPositions() &&
+      state_space->getParameterizationType() == JointModelStateSpace::PARAMETERIZATION_TYPE &&
+      constraint_sampler_->getJointModelGroup() == state_space->getJointModelGroup();
 }
 
 double ompl_interface::ConstrainedSampler::getConstrainedSamplingRate() const
@@ -66,6 +75,25 @@ double ompl_interface::ConstrainedSampler::getConstrainedSamplingRate() const
 
 bool ompl_interface::ConstrainedSampler::sampleC(ob::State* state)
 {
+  moveit::countWork(&moveit::WorkCounters::states_sampled);
+  if (sample_joint_group_positions_)
+  {
+    auto* values_state = state->as<ModelBasedStateSpace::StateType>();
+    if (constraint_sampler_->sampleJointGroupPositions(values_state->values,
+                                                       planning_context_->getCompleteInitialRobotState(),
+                                                       planning_context_->getMaximumStateSamplingAttempts()))
+    {
+      values_state->clearKnownInformation();
+      if (space_->satisfiesBounds(state))
+      {
+        ++constrained_success_;
+        return true;
+      }
+    }
+    ++constrained_failure_;
+    return false;
+  }
+
   if (constraint_sampler_->sample(work_state_, planning_context_->getCompleteInitialRobotState(),
                                   planning_context_->getMaximumStateSamplingAttempts()))
   {
@@ -39,9 +39,16 @@
 #include <fstream>
 #include <moveit/ompl_interface/detail/constrained_sampler.hpp>
 #include <moveit/ompl_interface/detail/constraints_library.hpp>
+#include <moveit/collision_detection/collision_batch.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <ompl/datastructures/NearestNeighborsGNAT.h>
 #include <ompl/tools/config/SelfConfig.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 namespace ompl_interface
@@ -103,6 +110,154 @@ void hexToMsg(const std::string& hex, T& msg)
     return;
   }
 }
+
+// Approximation databases are stored in a flat binary format (native byte order) that is read with a single call:
+// the magic and version, the serialization length of a state, the number of states, the serialized states, and per
+// state its connections followed by its explicit motions as (connected state, first, end) index triples.
+// Databases written with ompl::base::StateStorage serialization are still loaded.
+constexpr char BINARY_DATABASE_MAGIC[8] = { 'M', 'O', 'V', 'E', 'I', 'T', 'D', 'B' };
+constexpr std::uint32_t BINARY_DATABASE_VERSION = 1;
+
+bool isBinaryDatabase(const std::string& filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  char magic[sizeof(BINARY_DATABASE_MAGIC)];
+  return in.read(magic, sizeof(magic)) && std::memcmp(magic, BINARY_DATABASE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool storeBinaryDatabase(const ConstraintApproximationStateStorage& storage, const std::string& filename)
+{
+  const ob::StateSpacePtr& space = storage.getStateSpace();
+  const std::uint32_t state_length = space->getSerializationLength();
+  std::vector<char> buffer;
+  auto append = [&buffer](const void* data, std::size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+  };
+  auto append_index = [&append](std::size_t value) {
+    const std::uint64_t index = value;
+    append(&index, sizeof(index));
+  };
+
+  append(BINARY_DATABASE_MAGIC, sizeof(BINARY_DATABASE_MAGIC));
+  append(&BINARY_DATABASE_VERSION, sizeof(BINARY_DATABASE_VERSION));
+  append(&state_length, sizeof(state_length));
+  append_index(storage.size());
+  const std::size_t states_offset = buffer.size();
+  buffer.resize(states_offset + storage.size() * state_length);
+  for (std::size_t i = 0; i < storage.size(); ++i)
+    space->serialize(buffer.data() + states_offset + i * state_length, storage.getState(i));
+
+  for (std::size_t i = 0; i < storage.size(); ++i)
+  {
+    const ConstrainedStateMetadata& md = storage.getMetadata(i);
+    append_index(md.first.size());
+    for (std::size_t connected : md.first)
+      append_index(connected);
+    append_index(md.second.size());
+    for (const auto& [connected, range] : md.second)
+    {
+      append_index(connected);
+      append_index(range.first);
+      append_index(range.second);
+    }
+  }
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return out.good();
+}
+
+bool loadBinaryDatabase(const std::string& filename, ConstraintApproximationStateStorage& storage)
+{
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if (!in.good())
+    return false;
+  std::vector<char> buffer(static_cast<std::size_t>(in.tellg()));
+  in.seekg(0);
+  if (!in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+    return false;
+
+  std::size_t offset = 0;
+  auto read = [&buffer, &offset](void* data, std::size_t size) {
+    if (size > buffer.size() - offset)
+      return false;
+    std::memcpy(data, buffer.data() + offset, size);
+    offset += size;
+    return true;
+  };
+  auto read_index = [&read](std::size_t& value) {
+    std::uint64_t index;
+    if (!read(&index, sizeof(index)))
+      return false;
+    value = static_cast<std::size_t>(index);
+    return true;
+  };
+
+  char magic[sizeof(BINARY_DATABASE_MAGIC)];
+  std::uint32_t version;
+  std::uint32_t state_length;
+  std::size_t state_count;
+  const ob::StateSpacePtr& space = storage.getStateSpace();
+  if (!read(magic, sizeof(magic)) || std::memcmp(magic, BINARY_DATABASE_MAGIC, sizeof(magic)) != 0 ||
+      !read(&version, sizeof(version)) || version != BINARY_DATABASE_VERSION ||
+      !read(&state_length, sizeof(state_length)) || state_length != space->getSerializationLength() ||
+      !read_index(state_count) || state_count > (buffer.size() - offset) / std::max<std::size_t>(state_length, 1))
+    return false;
+
+  storage.clear();
+  ompl::base::ScopedState<> state(space);
+  for (std::size_t i = 0; i < state_count; ++i)
+  {
+    space->deserialize(state.get(), buffer.data() + offset + i * state_length);
+    storage.addState(state.get());
+  }
+  offset += state_count * state_length;
+
+  for (std::size_t i = 0; i < state_count; ++i)
+  {
+    ConstrainedStateMetadata& md = storage.getMetadata(i);
+    std::size_t count;
+    if (!read_index(count) || count > state_count)
+      return false;
+    md.first.resize(count);
+    for (std::size_t& connected : md.first)
+    {
+      if (!read_index(connected))
+        return false;
+    }
+    if (!read_index(count) || count > state_count)
+      return false;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+      std::size_t connected;
+      std::pair<std::size_t, std::size_t> range;
+      if (!read_index(connected) || !read_index(range.first) || !read_index(range.second))
+        return false;
+      md.second[connected] = range;
+    }
+  }
+  return offset == buffer.size();
+}
+
+// Interpolate \e steps states from \e from towards \e to into \e states and check that all but the first satisfy
+// \e kset
+bool interpolateConnection(const ModelBasedStateSpace& space, const ob::State* from, const ob::State* to,
+                           unsigned int steps, const kinematic_constraints::KinematicConstraintSet& kset,
+                           moveit::core::RobotState& robot_state, std::vector<ob::State*>& states)
+{
+  const double step = 1.0 / static_cast<double>(steps);
+  space.interpolate(from, to, step, states[0]);
+  for (unsigned int k = 1; k < steps; ++k)
+  {
+    const double this_step = step / (1.0 - (k - 1) * step);
+    space.interpolate(states[k - 1], to, this_step, states[k]);
+    space.copyToRobotState(robot_state, states[k]);
+    if (!kset.decide(robot_state).satisfied)
+      return false;
+  }
+  return true;
+}
 }  // namespace
 
 class ConstraintApproximationStateSampler : public ob::StateSampler
@@ -324,7 +479,17 @@ void ConstraintsLibrary::loadConstraintApproximations(const std::string& path)
     moveit_msgs::msg::Constraints msg;
     hexToMsg(serialization, msg);
     auto* cass = new ConstraintApproximationStateStorage(context_->getOMPLSimpleSetup()->getStateSpace());
-    cass->load((std::string{ path }.append("/").append(filename)).c_str());
+    const std::string database = std::string{ path }.append("/").append(filename);
+    if (!isBinaryDatabase(database))
+    {
+      cass->load(database.c_str());
+    }
+    else if (!loadBinaryDatabase(database, *cass))
+    {
+      RCLCPP_ERROR(getLogger(), "Unable to load constraint approximation from '%s'", database.c_str());
+      delete cass;
+      continue;
+    }
     auto cap = std::make_shared<ConstraintApproximation>(group, state_space_parameterization, explicit_motions, msg,
                                                          filename, ompl::base::StateStoragePtr(cass), milestones);
     if (constraint_approximations_.find(cap->getName()) != constraint_approximations_.end())
@@ -369,8 +534,11 @@ void ConstraintsLibrary::saveConstraintApproximations(const std::string& path)
       msgToHex(it->second->getConstraintsMsg(), serialization);
       fout << serialization << '\n';
       fout << it->second->getFilename() << '\n';
-      if (it->second->getStateStorage())
-        it->second->getStateStorage()->store((path + "/" + it->second->getFilename()).c_str());
+      const std::string database = path + "/" + it->second->getFilename();
+      if (it->second->getStateStorage() &&
+          !storeBinaryDatabase(*static_cast<ConstraintApproximationStateStorage*>(it->second->getStateStorage().get()),
+                               database))
+        RCLCPP_ERROR(getLogger(), "Unable to save constraint approximation to '%s'", database.c_str());
     }
   }
   else
@@ -551,81 +719,123 @@ ompl::base::StateStoragePtr ConstraintsLibrary::constructConstraintApproximation
   {
     RCLCPP_INFO(getLogger(), "Computing graph connections (max %u edges per sample) ...", options.edges_per_sample);
 
-    // construct connections
-    const ob::StateSpacePtr& space = pcontext->getOMPLSimpleSetup()->getStateSpace();
-    unsigned int milestones = state_storage->size();
-    std::vector<ob::State*> int_states(options.max_explicit_points, nullptr);
-    pcontext->getOMPLSimpleSetup()->getSpaceInformation()->allocStates(int_states);
+    // Candidate connections are found through a nearest-neighbor index and checked in parallel, closest first.
+    // Each milestone keeps up to edges_per_sample valid candidates, which are then added in index order as long as
+    // neither end has reached edges_per_sample connections.
+    const ModelBasedStateSpacePtr& space = pcontext->getOMPLStateSpace();
+    const std::size_t milestones = state_storage->size();
+    ompl::NearestNeighborsGNAT<std::size_t> milestone_index;
+    milestone_index.setDistanceFunction([&state_storage, &space](std::size_t a, std::size_t b) {
+      return space->distance(state_storage->getState(a), state_storage->getState(b));
+    });
+    std::vector<std::size_t> milestone_ids(milestones);
+    for (std::size_t j = 0; j < milestones; ++j)
+      milestone_ids[j] = j;
+    milestone_index.add(milestone_ids);
 
-    ompl::time::point start = ompl::time::now();
-    int good = 0;
-    int done = -1;
+    auto interpolation_steps = [&options](double distance) {
+      const double steps = options.explicit_points_resolution > 0.0 ? distance / options.explicit_points_resolution :
+                                                                       options.max_explicit_points;
+      return std::max(1u, static_cast<unsigned int>(std::min<double>(options.max_explicit_points, steps)));
+    };
 
-    for (std::size_t j = 0; j < milestones; ++j)
+    // robot states and interpolation buffers, reused by the tasks
+    struct Workspace
     {
-      int done_now = 100 * j / milestones;
-      if (done != done_now)
+      moveit::core::RobotState robot_state;
+      std::vector<ob::State*> states;
+    };
+    std::vector<std::unique_ptr<Workspace>> workspaces;
+    std::mutex mutex;
+    auto acquire_workspace = [&]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (workspaces.empty())
       {
-        done = done_now;
-        RCLCPP_INFO(getLogger(), "%d%% complete", done);
+        auto workspace = std::make_unique<Workspace>(Workspace{ default_state, {} });
+        workspace->states.resize(std::max(1u, options.max_explicit_points), nullptr);
+        pcontext->getOMPLSimpleSetup()->getSpaceInformation()->allocStates(workspace->states);
+        return workspace;
       }
-      if (cass->getMetadata(j).first.size() >= options.edges_per_sample)
-        continue;
+      std::unique_ptr<Workspace> workspace = std::move(workspaces.back());
+      workspaces.pop_back();
+      return workspace;
+    };
 
+    ompl::time::point start = ompl::time::now();
+    std::vector<std::vector<std::size_t>> candidates(milestones);
+    auto find_candidates = [&](std::size_t j) {
+      std::unique_ptr<Workspace> workspace = acquire_workspace();
+      std::vector<std::size_t> neighbors;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        milestone_index.nearestR(j, options.max_edge_length, neighbors);
+      }
       const ob::State* sj = state_storage->getState(j);
-
-      for (std::size_t i = j + 1; i < milestones; ++i)
+      for (std::size_t i : neighbors)
       {
-        if (cass->getMetadata(i).first.size() >= options.edges_per_sample)
+        if (i <= j)
           continue;
-        double d = space->distance(state_storage->getState(i), sj);
+        const double d = space->distance(state_storage->getState(i), sj);
         if (d >= options.max_edge_length)
           continue;
-        unsigned int isteps =
-            std::min<unsigned int>(options.max_explicit_points, d / options.explicit_points_resolution);
-        double step = 1.0 / static_cast<double>(isteps);
-        bool ok = true;
-        space->interpolate(state_storage->getState(i), sj, step, int_states[0]);
-        for (unsigned int k = 1; k < isteps; ++k)
+        if (interpolateConnection(*space, state_storage->getState(i), sj, interpolation_steps(d), kset,
+                                  workspace->robot_state, workspace->states))
         {
-          double this_step = step / (1.0 - (k - 1) * step);
-          space->interpolate(int_states[k - 1], sj, this_step, int_states[k]);
-          pcontext->getOMPLStateSpace()->copyToRobotState(robot_state, int_states[k]);
-          if (!kset.decide(robot_state).satisfied)
-          {
-            ok = false;
+          candidates[j].push_back(i);
+          if (candidates[j].size() >= options.edges_per_sample)
             break;
-          }
         }
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      workspaces.push_back(std::move(workspace));
+    };
+
+    const std::size_t thread_count =
+        options.thread_count > 0 ? options.thread_count : std::max(1u, std::thread::hardware_concurrency());
+    collision_detection::CollisionThreadPool pool(thread_count);
+    pool.tryRun(milestones, find_candidates);
+    RCLCPP_INFO(getLogger(), "Checked candidate connections on %zu threads in %lf seconds", thread_count,
+                ompl::time::seconds(ompl::time::now() - start));
+
+    std::unique_ptr<Workspace> workspace = acquire_workspace();
+    int good = 0;
+    for (std::size_t j = 0; j < milestones; ++j)
+    {
+      const ob::State* sj = state_storage->getState(j);
+      for (std::size_t i : candidates[j])
+      {
+        if (cass->getMetadata(j).first.size() >= options.edges_per_sample)
+          break;
+        if (cass->getMetadata(i).first.size() >= options.edges_per_sample)
+          continue;
 
-        if (ok)
-        {
-          cass->getMetadata(i).first.push_back(j);
-          cass->getMetadata(j).first.push_back(i);
+        cass->getMetadata(i).first.push_back(j);
+        cass->getMetadata(j).first.push_back(i);
 
-          if (options.explicit_motions)
+        if (options.explicit_motions)
+        {
+          const unsigned int isteps = interpolation_steps(space->distance(state_storage->getState(i), sj));
+          interpolateConnection(*space, state_storage->getState(i), sj, isteps, kset, workspace->robot_state,
+                                workspace->states);
+          cass->getMetadata(i).second[j].first = state_storage->size();
+          for (unsigned int k = 0; k < isteps; ++k)
           {
-            cass->getMetadata(i).second[j].first = state_storage->size();
-            for (unsigned int k = 0; k < isteps; ++k)
-            {
-              int_states[k]->as<ModelBasedStateSpace::StateType>()->tag = -1;
-              state_storage->addState(int_states[k]);
-            }
-            cass->getMetadata(i).second[j].second = state_storage->size();
-            cass->getMetadata(j).second[i] = cass->getMetadata(i).second[j];
+            workspace->states[k]->as<ModelBasedStateSpace::StateType>()->tag = -1;
+            state_storage->addState(workspace->states[k]);
           }
-
-          good++;
-          if (cass->getMetadata(j).first.size() >= options.edges_per_sample)
-            break;
+          cass->getMetadata(i).second[j].second = state_storage->size();
+          cass->getMetadata(j).second[i] = cass->getMetadata(i).second[j];
         }
+        good++;
       }
     }
+    workspaces.push_back(std::move(workspace));
 
     result.state_connection_time = ompl::time::seconds(ompl::time::now() - start);
     RCLCPP_INFO(getLogger(), "Computed possible connexions in %lf seconds. Added %d connexions",
                 result.state_connection_time, good);
-    pcontext->getOMPLSimpleSetup()->getSpaceInformation()->freeStates(int_states);
+    for (std::unique_ptr<Workspace>& unused_workspace : workspaces)
+      pcontext->getOMPLSimpleSetup()->getSpaceInformation()->freeStates(unused_workspace->states);
 
     return state_storage;
   }
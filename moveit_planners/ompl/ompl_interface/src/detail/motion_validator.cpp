@@ -0,0 +1,215 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/ompl_interface/detail/motion_validator.hpp>
+#include <moveit/ompl_interface/model_based_planning_context.hpp>
+#include <moveit/collision_detection/collision_env.hpp>
+
+#include <cstring>
+#include <queue>
+
+namespace ompl_interface
+{
+BisectionMotionValidator::BisectionMotionValidator(const ModelBasedPlanningContext* planning_context,
+                                                   std::size_t cache_size, bool continuous_collision_checking)
+  : ompl::base::MotionValidator(planning_context->getOMPLSimpleSetup()->getSpaceInformation())
+  , planning_context_(planning_context)
+  , continuous_collision_checking_(continuous_collision_checking)
+  , cache_(cache_size)
+  , tss_from_(planning_context->getCompleteInitialRobotState())
+  , tss_to_(planning_context->getCompleteInitialRobotState())
+{
+  for (std::atomic<std::uint64_t>& entry : cache_)
+  {
+    entry.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::uint64_t BisectionMotionValidator::hashState(const ompl::base::State* state) const
+{
+  const double* values = state->as<ModelBasedStateSpace::StateType>()->values;
+  const unsigned int variable_count = planning_context_->getOMPLStateSpace()->getJointModelGroup()->getVariableCount();
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned int i = 0; i < variable_count; ++i)
+  {
+    std::uint64_t bits;
+    std::memcpy(&bits, values + i, sizeof(bits));
+    hash ^= bits + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+bool BisectionMotionValidator::isStateValid(const ompl::base::State* state) const
+{
+  if (cache_.empty())
+  {
+    return si_->isValid(state);
+  }
+
+  const std::uint64_t key = hashState(state) & ~std::uint64_t{ 1 };
+  std::atomic<std::uint64_t>& entry = cache_[key % cache_.size()];
+  const std::uint64_t cached = entry.load(std::memory_order_relaxed);
+  if (key != 0 && (cached & ~std::uint64_t{ 1 }) == key)
+  {
+    return (cached & 1) != 0;
+  }
+
+  const bool valid = si_->isValid(state);
+  if (key != 0)
+  {
+    entry.store(key | (valid ? 1 : 0), std::memory_order_relaxed);
+  }
+  return valid;
+}
+
+bool BisectionMotionValidator::isSegmentCollisionFree(const ompl::base::State* s1, const ompl::base::State* s2) const
+{
+  moveit::core::RobotState* from = tss_from_.getStateStorage();
+  moveit::core::RobotState* to = tss_to_.getStateStorage();
+  planning_context_->getOMPLStateSpace()->copyToRobotState(*from, s1);
+  planning_context_->getOMPLStateSpace()->copyToRobotState(*to, s2);
+
+  const planning_scene::PlanningSceneConstPtr& planning_scene = planning_context_->getPlanningScene();
+  collision_detection::CollisionRequest request;
+  request.group_name = planning_context_->getGroupName();
+  collision_detection::CollisionResult result;
+  planning_scene->getCollisionEnv()->checkRobotCollision(request, result, *from, *to,
+                                                          planning_scene->getAllowedCollisionMatrix());
+  return !result.collision;
+}
+
+bool BisectionMotionValidator::checkMotion(const ompl::base::State* s1, const ompl::base::State* s2) const
+{
+  if (!isStateValid(s2))
+  {
+    invalid_++;
+    return false;
+  }
+
+  bool result = true;
+  if (continuous_collision_checking_ && !planning_context_->getPathConstraints())
+  {
+    result = isSegmentCollisionFree(s1, s2);
+  }
+  else
+  {
+    const unsigned int nd = si_->getStateSpace()->validSegmentCount(s1, s2);
+    if (nd > 1)
+    {
+      // check the middle of the remaining intervals first
+      std::queue<std::pair<unsigned int, unsigned int>> intervals;
+      intervals.emplace(1, nd - 1);
+      ompl::base::State* test = si_->allocState();
+      while (!intervals.empty())
+      {
+        const auto [first, last] = intervals.front();
+        intervals.pop();
+        const unsigned int mid = (first + last) / 2;
+        si_->getStateSpace()->interpolate(s1, s2, static_cast<double>(mid) / static_cast<double>(nd), test);
+        if (!isStateValid(test))
+        {
+          result = false;
+          break;
+        }
+        if (first < mid)
+        {
+          intervals.emplace(first, mid - 1);
+        }
+        if (mid < last)
+        {
+          intervals.emplace(mid + 1, last);
+        }
+      }
+      si_->freeState(test);
+    }
+  }
+
+  if (result)
+  {
+    valid_++;
+  }
+  else
+  {
+    invalid_++;
+  }
+  return result;
+}
+
+bool BisectionMotionValidator::checkMotion(const ompl::base::State* s1, const ompl::base::State* s2,
+                                           std::pair<ompl::base::State*, double>& last_valid) const
+{
+  // the first invalid state is needed, so the states are checked in order from s1
+  bool result = true;
+  const unsigned int nd = si_->getStateSpace()->validSegmentCount(s1, s2);
+  if (nd > 1)
+  {
+    ompl::base::State* test = si_->allocState();
+    for (unsigned int j = 1; j < nd; ++j)
+    {
+      si_->getStateSpace()->interpolate(s1, s2, static_cast<double>(j) / static_cast<double>(nd), test);
+      if (!isStateValid(test))
+      {
+        last_valid.second = static_cast<double>(j - 1) / static_cast<double>(nd);
+        if (last_valid.first != nullptr)
+        {
+          si_->getStateSpace()->interpolate(s1, s2, last_valid.second, last_valid.first);
+        }
+        result = false;
+        break;
+      }
+    }
+    si_->freeState(test);
+  }
+
+  if (result && !isStateValid(s2))
+  {
+    last_valid.second = static_cast<double>(nd - 1) / static_cast<double>(nd);
+    if (last_valid.first != nullptr)
+    {
+      si_->getStateSpace()->interpolate(s1, s2, last_valid.second, last_valid.first);
+    }
+    result = false;
+  }
+
+  if (result)
+  {
+    valid_++;
+  }
+  else
+  {
+    invalid_++;
+  }
+  return result;
+}
+}  // namespace ompl_interface
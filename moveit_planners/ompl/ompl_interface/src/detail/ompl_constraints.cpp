@@ -151,26 +151,65 @@ void BaseConstraint::function(const Eigen::Ref<const Eigen::VectorXd>& joint_val
 void BaseConstraint::jacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values,
                               Eigen::Ref<Eigen::MatrixXd> out) const
 {
-  const Eigen::VectorXd constraint_error = calcError(joint_values);
+  Eigen::VectorXd constraint_error;
+  Eigen::MatrixXd robot_jacobian;
+  calcErrorAndJacobian(joint_values, constraint_error, robot_jacobian);
   const Eigen::VectorXd constraint_derivative = bounds_.derivative(constraint_error);
-  const Eigen::MatrixXd robot_jacobian = calcErrorJacobian(joint_values);
   for (std::size_t i = 0; i < bounds_.size(); ++i)
   {
     out.row(i) = constraint_derivative[i] * robot_jacobian.row(i);
   }
 }
 
-Eigen::Isometry3d BaseConstraint::forwardKinematics(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
+void BaseConstraint::functionAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values,
+                                         Eigen::Ref<Eigen::VectorXd> out_function,
+                                         Eigen::Ref<Eigen::MatrixXd> out_jacobian) const
+{
+  Eigen::VectorXd constraint_error;
+  Eigen::MatrixXd robot_jacobian;
+  calcErrorAndJacobian(joint_values, constraint_error, robot_jacobian);
+  out_function = bounds_.penalty(constraint_error);
+  const Eigen::VectorXd constraint_derivative = bounds_.derivative(constraint_error);
+  for (std::size_t i = 0; i < bounds_.size(); ++i)
+  {
+    out_jacobian.row(i) = constraint_derivative[i] * robot_jacobian.row(i);
+  }
+}
+
+moveit::core::RobotState* BaseConstraint::updateRobotState(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
 {
   moveit::core::RobotState* robot_state = state_storage_.getStateStorage();
-  robot_state->setJointGroupPositions(joint_model_group_, joint_values);
-  return robot_state->getGlobalLinkTransform(link_name_);
+
+  // OMPL evaluates the function and the Jacobian at the same joint values, in which case the link transforms of the
+  // previous evaluation in this thread are still valid and are not recomputed
+  if (!robot_state->dirtyLinkTransforms())
+  {
+    const std::vector<int>& indices = joint_model_group_->getVariableIndexList();
+    const double* positions = robot_state->getVariablePositions();
+    bool unchanged = true;
+    for (std::size_t i = 0; unchanged && i < indices.size(); ++i)
+    {
+      unchanged = positions[indices[i]] == joint_values[i];
+    }
+    if (unchanged)
+    {
+      return robot_state;
+    }
+  }
+
+  robot_state->setJointGroupPositions(joint_model_group_, joint_values.data());
+  robot_state->updateLinkTransforms();
+  return robot_state;
+}
+
+Eigen::Isometry3d BaseConstraint::forwardKinematics(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
+{
+  return updateRobotState(joint_values)->getGlobalLinkTransform(link_name_);
 }
 
 Eigen::MatrixXd BaseConstraint::robotGeometricJacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values) const
 {
-  moveit::core::RobotState* robot_state = state_storage_.getStateStorage();
-  robot_state->setJointGroupPositions(joint_model_group_, joint_values);
+  moveit::core::RobotState* robot_state = updateRobotState(joint_values);
   Eigen::MatrixXd jacobian;
   // return value (success) not used, could return a garbage jacobian.
   robot_state->getJacobian(joint_model_group_, joint_model_group_->getLinkModel(link_name_),
@@ -192,6 +231,13 @@ Eigen::MatrixXd BaseConstraint::calcErrorJacobian(const Eigen::Ref<const Eigen::
   return Eigen::MatrixXd::Zero(getCoDimension(), n_);
 }
 
+void BaseConstraint::calcErrorAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd& error,
+                                          Eigen::MatrixXd& error_jacobian) const
+{
+  error = calcError(x);
+  error_jacobian = calcErrorJacobian(x);
+}
+
 /******************************************
  * Position constraints
  * ****************************************/
@@ -304,6 +350,14 @@ void EqualityPositionConstraint::jacobian(const Eigen::Ref<const Eigen::VectorXd
   }
 }
 
+void EqualityPositionConstraint::functionAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& joint_values,
+                                                     Eigen::Ref<Eigen::VectorXd> out_function,
+                                                     Eigen::Ref<Eigen::MatrixXd> out_jacobian) const
+{
+  function(joint_values, out_function);
+  jacobian(joint_values, out_jacobian);
+}
+
 /******************************************
  * Orientation constraints
  * ****************************************/
@@ -330,6 +384,16 @@ Eigen::MatrixXd OrientationConstraint::calcErrorJacobian(const Eigen::Ref<const
   return -angularVelocityToAngleAxis(aa.angle(), aa.axis()) * robotGeometricJacobian(x).bottomRows(3);
 }
 
+void OrientationConstraint::calcErrorAndJacobian(const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd& error,
+                                                 Eigen::MatrixXd& error_jacobian) const
+{
+  // the rotation error and its derivative share the angle-axis decomposition of the orientation difference
+  Eigen::Matrix3d orientation_difference = forwardKinematics(x).linear().transpose() * target_orientation_;
+  Eigen::AngleAxisd aa{ orientation_difference };
+  error = aa.axis() * aa.angle();
+  error_jacobian = -angularVelocityToAngleAxis(aa.angle(), aa.axis()) * robotGeometricJacobian(x).bottomRows(3);
+}
+
 /************************************
  * MoveIt constraint message parsing
  * **********************************/
@@ -38,15 +38,60 @@
 #include <moveit/ompl_interface/model_based_planning_context.hpp>
 #include <moveit/ompl_interface/parameterization/model_based_state_space.hpp>
 
+#include <ompl/util/RandomNumbers.h>
+#include <Eigen/QR>
+#include <algorithm>
 #include <utility>
 
 ompl_interface::ProjectionEvaluatorLinkPose::ProjectionEvaluatorLinkPose(const ModelBasedPlanningContext* pc,
                                                                          const std::string& link)
   : ompl::base::ProjectionEvaluator(pc->getOMPLStateSpace())
-  , planning_context_(pc)
-  , link_(planning_context_->getJointModelGroup()->getLinkModel(link))
-  , tss_(planning_context_->getCompleteInitialRobotState())
+  , link_(pc->getJointModelGroup()->getLinkModel(link))
+  , root_transform_(Eigen::Isometry3d::Identity())
 {
+  const moveit::core::JointModelGroup* jmg = pc->getJointModelGroup();
+  const moveit::core::RobotState& initial_state = pc->getCompleteInitialRobotState();
+
+  // links from link_ up to the root, the chain starts at the topmost one whose parent joint is a group joint
+  std::vector<const moveit::core::LinkModel*> path;
+  std::size_t chain_length = 0;
+  for (const moveit::core::LinkModel* l = link_; l != nullptr; l = l->getParentLinkModel())
+  {
+    path.push_back(l);
+    if (jmg->hasJointModel(l->getParentJointModel()->getName()))
+    {
+      chain_length = path.size();
+    }
+  }
+  if (chain_length == 0)
+  {
+    if (link_)
+    {
+      root_transform_ = initial_state.getGlobalLinkTransform(link_);
+    }
+    return;
+  }
+
+  const moveit::core::LinkModel* chain_parent = path[chain_length - 1]->getParentLinkModel();
+  if (chain_parent)
+  {
+    root_transform_ = initial_state.getGlobalLinkTransform(chain_parent);
+  }
+  for (std::size_t i = chain_length; i-- > 0;)
+  {
+    const moveit::core::JointModel* joint = path[i]->getParentJointModel();
+    ChainLink chain_link{ path[i], -1, {} };
+    if (joint->getVariableCount() > 0 && jmg->hasJointModel(joint->getName()))
+    {
+      chain_link.group_index = jmg->getVariableGroupIndex(joint->getName());
+    }
+    else
+    {
+      const double* values = initial_state.getJointPositions(joint);
+      chain_link.fixed_values.assign(values, values + joint->getVariableCount());
+    }
+    chain_.push_back(std::move(chain_link));
+  }
 }
 
 unsigned int ompl_interface::ProjectionEvaluatorLinkPose::getDimension() const
@@ -65,10 +110,18 @@ void ompl_interface::ProjectionEvaluatorLinkPose::defaultCellSizes()
 void ompl_interface::ProjectionEvaluatorLinkPose::project(const ompl::base::State* state,
                                                           OMPLProjection projection) const
 {
-  moveit::core::RobotState* s = tss_.getStateStorage();
-  planning_context_->getOMPLStateSpace()->copyToRobotState(*s, state);
+  const double* values = state->as<ModelBasedStateSpace::StateType>()->values;
+  Eigen::Isometry3d transform = root_transform_;
+  Eigen::Isometry3d joint_transform;
+  for (const ChainLink& chain_link : chain_)
+  {
+    chain_link.link->getParentJointModel()->computeTransform(
+        chain_link.group_index >= 0 ? values + chain_link.group_index : chain_link.fixed_values.data(),
+        joint_transform);
+    transform = transform * chain_link.link->getJointOriginTransform() * joint_transform;
+  }
 
-  const Eigen::Vector3d& o = s->getGlobalLinkTransform(link_).translation();
+  const Eigen::Vector3d& o = transform.translation();
   projection(0) = o.x();
   projection(1) = o.y();
   projection(2) = o.z();
@@ -97,3 +150,37 @@ void ompl_interface::ProjectionEvaluatorJointValue::project(const ompl::base::St
   for (std::size_t i = 0; i < variables_.size(); ++i)
     projection(i) = state->as<ModelBasedStateSpace::StateType>()->values[variables_[i]];
 }
+
+ompl_interface::ProjectionEvaluatorRandomLinear::ProjectionEvaluatorRandomLinear(const ModelBasedPlanningContext* pc,
+                                                                                 unsigned int dimension)
+  : ompl::base::ProjectionEvaluator(pc->getOMPLStateSpace())
+{
+  const unsigned int variable_count = pc->getJointModelGroup()->getVariableCount();
+  dimension = std::min(dimension, variable_count);
+
+  // orthonormalize the columns of a random gaussian matrix, so the projection does not stretch any direction
+  ompl::RNG rng;
+  Eigen::MatrixXd random(variable_count, dimension);
+  for (Eigen::Index i = 0; i < random.size(); ++i)
+    random.data()[i] = rng.gaussian01();
+  const Eigen::MatrixXd q = Eigen::HouseholderQR<Eigen::MatrixXd>(random).householderQ();
+  projection_matrix_ = q.leftCols(dimension).transpose();
+}
+
+unsigned int ompl_interface::ProjectionEvaluatorRandomLinear::getDimension() const
+{
+  return projection_matrix_.rows();
+}
+
+void ompl_interface::ProjectionEvaluatorRandomLinear::defaultCellSizes()
+{
+  cellSizes_.clear();
+  cellSizes_.resize(projection_matrix_.rows(), 0.1);
+}
+
+void ompl_interface::ProjectionEvaluatorRandomLinear::project(const ompl::base::State* state,
+                                                              OMPLProjection projection) const
+{
+  const double* values = state->as<ModelBasedStateSpace::StateType>()->values;
+  projection = projection_matrix_ * Eigen::Map<const Eigen::VectorXd>(values, projection_matrix_.cols());
+}
@@ -37,9 +37,12 @@
 #include <moveit/ompl_interface/detail/state_validity_checker.hpp>
 #include <moveit/ompl_interface/model_based_planning_context.hpp>
 #include <ompl/base/spaces/constraint/ConstrainedStateSpace.h>
+#include <cmath>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
+#include <moveit/utils/work_counters.hpp>
 
 namespace ompl_interface
 {
@@ -57,6 +60,11 @@ ompl_interface::StateValidityChecker::StateValidityChecker(const ModelBasedPlann
   , group_name_(pc->getGroupName())
   , tss_(pc->getCompleteInitialRobotState())
   , verbose_(false)
+  , staged_collision_checking_(false)
+  , use_bounding_spheres_(false)
+  , invalid_state_cache_size_(0)
+  , invalid_state_cache_radius_(0.0)
+  , next_invalid_state_(0)
 {
   specs_.clearanceComputationType = ompl::base::StateValidityCheckerSpecs::APPROXIMATE;
   specs_.hasValidDirectionComputation = false;
@@ -75,11 +83,172 @@ ompl_interface::StateValidityChecker::StateValidityChecker(const ModelBasedPlann
   collision_request_with_distance_verbose_.verbose = true;
 }
 
+StateValidityChecker::~StateValidityChecker()
+{
+  RCLCPP_DEBUG(getLogger(),
+               "%zu states checked, rejected: %zu by bounds, %zu by the invalid state cache, %zu by path constraints, "
+               "%zu by feasibility, %zu by self-collisions, %zu by collisions; %zu self-collision checks skipped",
+               statistics_.checked_states.load(), statistics_.bounds_rejections.load(),
+               statistics_.cache_rejections.load(), statistics_.path_constraints_rejections.load(),
+               statistics_.feasibility_rejections.load(), statistics_.self_collision_rejections.load(),
+               statistics_.collision_rejections.load(), statistics_.skipped_self_collision_checks.load());
+  for (ompl::base::State* state : invalid_states_)
+    invalid_state_space_->freeState(state);
+}
+
 void ompl_interface::StateValidityChecker::setVerbose(bool flag)
 {
   verbose_ = flag;
 }
 
+void StateValidityChecker::setStagedCollisionChecking(bool flag)
+{
+  staged_collision_checking_ = flag;
+  use_bounding_spheres_ = false;
+  link_spheres_.clear();
+  link_sphere_pairs_.clear();
+  if (!flag)
+    return;
+
+  // attached bodies are part of the self-collision check, but are not covered by the spheres of the links
+  std::vector<const moveit::core::AttachedBody*> attached_bodies;
+  planning_context_->getCompleteInitialRobotState().getAttachedBodies(attached_bodies);
+  if (!attached_bodies.empty())
+    return;
+
+  const planning_scene::PlanningSceneConstPtr& planning_scene = planning_context_->getPlanningScene();
+  const collision_detection::CollisionEnvConstPtr& collision_env = collision_request_simple_.pad_self_collisions ?
+                                                                       planning_scene->getCollisionEnv() :
+                                                                       planning_scene->getCollisionEnvUnpadded();
+  for (const moveit::core::LinkModel* link : planning_scene->getRobotModel()->getLinkModelsWithCollisionGeometry())
+  {
+    // padded or scaled shapes can extend beyond the bounding sphere of the link
+    if (collision_env->getLinkPadding(link->getName()) != 0.0 || collision_env->getLinkScale(link->getName()) != 1.0)
+    {
+      RCLCPP_DEBUG(getLogger(), "Link '%s' is padded or scaled, self-collisions are always checked exactly",
+                   link->getName().c_str());
+      link_spheres_.clear();
+      return;
+    }
+    link_spheres_.push_back(
+        { link, link->getCenteredBoundingBoxOffset(), 0.5 * link->getShapeExtentsAtOrigin().norm() });
+  }
+
+  // like the collision checker, only consider pairs with at least one link moved by the group
+  const moveit::core::JointModelGroup* group = planning_scene->getRobotModel()->getJointModelGroup(group_name_);
+  const collision_detection::AllowedCollisionMatrix& acm = planning_scene->getAllowedCollisionMatrix();
+  for (std::size_t i = 0; i < link_spheres_.size(); ++i)
+  {
+    for (std::size_t j = i + 1; j < link_spheres_.size(); ++j)
+    {
+      const std::string& name1 = link_spheres_[i].link->getName();
+      const std::string& name2 = link_spheres_[j].link->getName();
+      if (group && !group->isLinkUpdated(name1) && !group->isLinkUpdated(name2))
+        continue;
+      collision_detection::AllowedCollision::Type type;
+      if (acm.getAllowedCollision(name1, name2, type) && type == collision_detection::AllowedCollision::ALWAYS)
+        continue;
+      link_sphere_pairs_.emplace_back(i, j);
+    }
+  }
+  use_bounding_spheres_ = true;
+}
+
+void StateValidityChecker::setInvalidStateCache(std::size_t size, double radius)
+{
+  std::scoped_lock slock(invalid_state_cache_lock_);
+  for (ompl::base::State* state : invalid_states_)
+    invalid_state_space_->freeState(state);
+  invalid_states_.clear();
+  next_invalid_state_ = 0;
+  invalid_state_space_ = si_->getStateSpace();
+  invalid_state_cache_size_ = size;
+  invalid_state_cache_radius_ = radius;
+}
+
+bool StateValidityChecker::isInInvalidStateCache(const ompl::base::State* state) const
+{
+  if (invalid_state_cache_size_ == 0)
+    return false;
+  std::scoped_lock slock(invalid_state_cache_lock_);
+  for (const ompl::base::State* invalid_state : invalid_states_)
+  {
+    if (invalid_state_space_->distance(invalid_state, state) < invalid_state_cache_radius_)
+      return true;
+  }
+  return false;
+}
+
+bool StateValidityChecker::areBoundingSpheresApart(const moveit::core::RobotState& robot_state) const
+{
+  for (const auto& [i, j] : link_sphere_pairs_)
+  {
+    const LinkSphere& sphere1 = link_spheres_[i];
+    const LinkSphere& sphere2 = link_spheres_[j];
+    const Eigen::Vector3d center1 = robot_state.getGlobalLinkTransform(sphere1.link) * sphere1.center;
+    const Eigen::Vector3d center2 = robot_state.getGlobalLinkTransform(sphere2.link) * sphere2.center;
+    if ((center1 - center2).squaredNorm() <= std::pow(sphere1.radius + sphere2.radius, 2))
+      return false;
+  }
+  return true;
+}
+
+bool StateValidityChecker::checkCollision(const ompl::base::State* state, moveit::core::RobotState& robot_state,
+                                          bool verbose) const
+{
+  const collision_detection::CollisionRequest& req =
+      verbose ? collision_request_simple_verbose_ : collision_request_simple_;
+  const planning_scene::PlanningSceneConstPtr& planning_scene = planning_context_->getPlanningScene();
+  collision_detection::CollisionResult res;
+  if (!staged_collision_checking_)
+  {
+    planning_scene->checkCollision(req, res, robot_state);
+  }
+  else
+  {
+    moveit::countWork(&moveit::WorkCounters::collision_checks);
+    robot_state.updateCollisionBodyTransforms();
+    const collision_detection::AllowedCollisionMatrix& acm = planning_scene->getAllowedCollisionMatrix();
+    if (use_bounding_spheres_ && areBoundingSpheresApart(robot_state))
+    {
+      statistics_.skipped_self_collision_checks++;
+    }
+    else
+    {
+      (req.pad_self_collisions ? planning_scene->getCollisionEnv() : planning_scene->getCollisionEnvUnpadded())
+          ->checkSelfCollision(req, res, robot_state, acm);
+      if (res.collision)
+        statistics_.self_collision_rejections++;
+    }
+    if (!res.collision)
+    {
+      (req.pad_environment_collisions ? planning_scene->getCollisionEnv() : planning_scene->getCollisionEnvUnpadded())
+          ->checkRobotCollision(req, res, robot_state, acm);
+      if (res.collision)
+        statistics_.collision_rejections++;
+    }
+  }
+  if (!res.collision)
+    return true;
+
+  if (!staged_collision_checking_)
+    statistics_.collision_rejections++;
+  if (invalid_state_cache_size_ > 0)
+  {
+    std::scoped_lock slock(invalid_state_cache_lock_);
+    if (invalid_states_.size() < invalid_state_cache_size_)
+    {
+      invalid_states_.push_back(invalid_state_space_->cloneState(state));
+    }
+    else
+    {
+      invalid_state_space_->copyState(invalid_states_[next_invalid_state_], state);
+      next_invalid_state_ = (next_invalid_state_ + 1) % invalid_state_cache_size_;
+    }
+  }
+  return false;
+}
+
 bool StateValidityChecker::isValid(const ompl::base::State* state, bool verbose) const
 {
   assert(state != nullptr);
@@ -88,6 +257,9 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, bool verbose)
   {
     return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
   }
+  MOVEIT_TRACEPOINT_SCOPE("ompl.state_validity_check");
+  const moveit::ScopedWorkCounters work_counters(planning_context_->getWorkCounters());
+  statistics_.checked_states++;
 
   if (!si_->satisfiesBounds(state))
   {
@@ -95,6 +267,15 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, bool verbose)
     {
       RCLCPP_INFO(getLogger(), "State outside bounds");
     }
+    statistics_.bounds_rejections++;
+    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
+    return false;
+  }
+
+  // reject states close to recently found colliding states
+  if (isInInvalidStateCache(state))
+  {
+    statistics_.cache_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
     return false;
   }
@@ -104,8 +285,9 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, bool verbose)
 
   // check path constraints
   const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
-  if (kset && !kset->decide(*robot_state, verbose).satisfied)
+  if (kset && !kset->isSatisfied(*robot_state, verbose))
   {
+    statistics_.path_constraints_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
     return false;
   }
@@ -113,15 +295,14 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, bool verbose)
   // check feasibility
   if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
   {
+    statistics_.feasibility_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
     return false;
   }
 
   // check collision avoidance
-  collision_detection::CollisionResult res;
-  planning_context_->getPlanningScene()->checkCollision(
-      verbose ? collision_request_simple_verbose_ : collision_request_simple_, res, *robot_state);
-  if (!res.collision)
+  const bool valid = checkCollision(state, *robot_state, verbose);
+  if (valid)
   {
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markValid();
   }
@@ -129,7 +310,7 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, bool verbose)
   {
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
   }
-  return !res.collision;
+  return valid;
 }
 
 bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist, bool verbose) const
@@ -142,6 +323,9 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist,
     dist = state->as<ModelBasedStateSpace::StateType>()->distance;
     return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
   }
+  MOVEIT_TRACEPOINT_SCOPE("ompl.state_validity_check");
+  const moveit::ScopedWorkCounters work_counters(planning_context_->getWorkCounters());
+  statistics_.checked_states++;
 
   if (!si_->satisfiesBounds(state))
   {
@@ -149,6 +333,7 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist,
     {
       RCLCPP_INFO(getLogger(), "State outside bounds");
     }
+    statistics_.bounds_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid(0.0);
     return false;
   }
@@ -163,6 +348,7 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist,
     kinematic_constraints::ConstraintEvaluationResult cer = kset->decide(*robot_state, verbose);
     if (!cer.satisfied)
     {
+      statistics_.path_constraints_rejections++;
       dist = cer.distance;
       const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid(dist);
       return false;
@@ -172,6 +358,7 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist,
   // check feasibility
   if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
   {
+    statistics_.feasibility_rejections++;
     dist = 0.0;
     return false;
   }
@@ -181,6 +368,8 @@ bool StateValidityChecker::isValid(const ompl::base::State* state, double& dist,
   planning_context_->getPlanningScene()->checkCollision(
       verbose ? collision_request_with_distance_verbose_ : collision_request_with_distance_, res, *robot_state);
   dist = res.distance;
+  if (res.collision)
+    statistics_.collision_rejections++;
   return !res.collision;
 }
 
@@ -229,11 +418,22 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
   {
     return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
   }
+  const moveit::ScopedWorkCounters work_counters(planning_context_->getWorkCounters());
+  statistics_.checked_states++;
 
   // do not use the unwrapped state here, as satisfiesBounds expects a state of type ConstrainedStateSpace::StateType
   if (!si_->satisfiesBounds(wrapped_state))  // si_ = ompl::base::SpaceInformation
   {
     RCLCPP_DEBUG(getLogger(), "State outside bounds");
+    statistics_.bounds_rejections++;
+    const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
+    return false;
+  }
+
+  // reject states close to recently found colliding states
+  if (isInInvalidStateCache(wrapped_state))
+  {
+    statistics_.cache_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
     return false;
   }
@@ -244,8 +444,9 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
 
   // check path constraints
   const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
-  if (kset && !kset->decide(*robot_state, verbose).satisfied)
+  if (kset && !kset->isSatisfied(*robot_state, verbose))
   {
+    statistics_.path_constraints_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
     return false;
   }
@@ -253,15 +454,14 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
   // check feasibility
   if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
   {
+    statistics_.feasibility_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
     return false;
   }
 
   // check collision avoidance
-  collision_detection::CollisionResult res;
-  planning_context_->getPlanningScene()->checkCollision(
-      verbose ? collision_request_simple_verbose_ : collision_request_simple_, res, *robot_state);
-  if (!res.collision)
+  const bool valid = checkCollision(wrapped_state, *robot_state, verbose);
+  if (valid)
   {
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markValid();
   }
@@ -269,7 +469,7 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
   {
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
   }
-  return !res.collision;
+  return valid;
 }
 
 bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* wrapped_state, double& dist,
@@ -286,11 +486,14 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
     dist = state->as<ModelBasedStateSpace::StateType>()->distance;
     return state->as<ModelBasedStateSpace::StateType>()->isMarkedValid();
   }
+  const moveit::ScopedWorkCounters work_counters(planning_context_->getWorkCounters());
+  statistics_.checked_states++;
 
   // do not use the unwrapped state here, as satisfiesBounds expects a state of type ConstrainedStateSpace::StateType
   if (!si_->satisfiesBounds(wrapped_state))  // si_ = ompl::base::SpaceInformation
   {
     RCLCPP_DEBUG(getLogger(), "State outside bounds");
+    statistics_.bounds_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid(0.0);
     return false;
   }
@@ -302,8 +505,9 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
 
   // check path constraints
   const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
-  if (kset && !kset->decide(*robot_state, verbose).satisfied)
+  if (kset && !kset->isSatisfied(*robot_state, verbose))
   {
+    statistics_.path_constraints_rejections++;
     const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
     return false;
   }
@@ -311,6 +515,7 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
   // check feasibility
   if (!planning_context_->getPlanningScene()->isStateFeasible(*robot_state, verbose))
   {
+    statistics_.feasibility_rejections++;
     dist = 0.0;
     return false;
   }
@@ -320,6 +525,8 @@ bool ConstrainedPlanningStateValidityChecker::isValid(const ompl::base::State* w
   planning_context_->getPlanningScene()->checkCollision(
       verbose ? collision_request_with_distance_verbose_ : collision_request_with_distance_, res, *robot_state);
   dist = res.distance;
+  if (res.collision)
+    statistics_.collision_rejections++;
   return !res.collision;
 }
 }  // namespace ompl_interface
@@ -35,14 +35,33 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/ompl_interface/detail/threadsafe_state_storage.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace
+{
+std::atomic<std::uint64_t> next_storage_id{ 1 };
+
+// Recently used states of the calling thread, most recent first, an id of 0 marks an empty slot. Entries of
+// destroyed storages are never matched again because storage ids are not reused, and are eventually evicted.
+struct CachedState
+{
+  std::uint64_t storage_id = 0;
+  moveit::core::RobotState* state = nullptr;
+};
+constexpr std::size_t THREAD_CACHE_SIZE = 8;
+thread_local std::array<CachedState, THREAD_CACHE_SIZE> thread_cache;
+}  // namespace
 
 ompl_interface::TSStateStorage::TSStateStorage(const moveit::core::RobotModelPtr& robot_model)
-  : start_state_(robot_model)
+  : id_(next_storage_id++), start_state_(robot_model)
 {
   start_state_.setToDefaultValues();
 }
 
-ompl_interface::TSStateStorage::TSStateStorage(const moveit::core::RobotState& start_state) : start_state_(start_state)
+ompl_interface::TSStateStorage::TSStateStorage(const moveit::core::RobotState& start_state)
+  : id_(next_storage_id++), start_state_(start_state)
 {
 }
 
@@ -56,18 +75,34 @@ ompl_interface::TSStateStorage::~TSStateStorage()
 
 moveit::core::RobotState* ompl_interface::TSStateStorage::getStateStorage() const
 {
-  moveit::core::RobotState* st = nullptr;
-  std::unique_lock<std::mutex> slock(lock_);  /// \todo use Thread Local Storage?
-  std::map<std::thread::id, moveit::core::RobotState*>::const_iterator it =
-      thread_states_.find(std::this_thread::get_id());
-  if (it == thread_states_.end())
+  for (auto it = thread_cache.begin(); it != thread_cache.end(); ++it)
   {
-    st = new moveit::core::RobotState(start_state_);
-    thread_states_[std::this_thread::get_id()] = st;
+    if (it->storage_id == id_)
+    {
+      // keep the states that are in use at the front, so they are not evicted by a storage accessed once
+      std::rotate(thread_cache.begin(), it, it + 1);
+      return thread_cache.front().state;
+    }
   }
-  else
+
+  moveit::core::RobotState* st = nullptr;
   {
-    st = it->second;
+    std::unique_lock<std::mutex> slock(lock_);
+    std::map<std::thread::id, moveit::core::RobotState*>::const_iterator it =
+        thread_states_.find(std::this_thread::get_id());
+    if (it == thread_states_.end())
+    {
+      st = new moveit::core::RobotState(start_state_);
+      thread_states_[std::this_thread::get_id()] = st;
+    }
+    else
+    {
+      st = it->second;
+    }
   }
+
+  // evict the least recently used entry
+  std::rotate(thread_cache.begin(), thread_cache.end() - 1, thread_cache.end());
+  thread_cache.front() = CachedState{ id_, st };
   return st;
 }
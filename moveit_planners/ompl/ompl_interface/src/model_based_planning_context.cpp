@@ -41,6 +41,7 @@
 
 #include <moveit/ompl_interface/model_based_planning_context.hpp>
 #include <moveit/ompl_interface/detail/state_validity_checker.hpp>
+#include <moveit/ompl_interface/detail/motion_validator.hpp>
 #include <moveit/ompl_interface/detail/constrained_sampler.hpp>
 #include <moveit/ompl_interface/detail/constrained_goal_sampler.hpp>
 #include <moveit/ompl_interface/detail/goal_union.hpp>
@@ -51,6 +52,7 @@
 
 #include <moveit/utils/lexical_casts.hpp>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
 
 #include <ompl/config.h>
 #include <ompl/base/samplers/UniformValidStateSampler.h>
@@ -99,6 +101,7 @@ ModelBasedPlanningContext::ModelBasedPlanningContext(const std::string& name,
   , simplify_solutions_(true)
   , interpolate_(true)
   , hybridize_(true)
+  , solve_time_fraction_(1.0)
 {
   complete_initial_robot_state_.setToDefaultValues();  // avoid uninitialized memory
   complete_initial_robot_state_.update();
@@ -224,6 +227,27 @@ ompl::base::ProjectionEvaluatorPtr ModelBasedPlanningContext::getProjectionEvalu
       return std::make_shared<ProjectionEvaluatorJointValue>(this, j);
     }
   }
+  else if (peval.rfind("random_linear(", 0) == 0 && peval[peval.length() - 1] == ')')
+  {
+    // a random projection of all group variables to the given number of dimensions
+    unsigned int dimension = 0;
+    try
+    {
+      dimension = boost::lexical_cast<unsigned int>(boost::trim_copy(peval.substr(14, peval.length() - 15)));
+    }
+    catch (const boost::bad_lexical_cast&)
+    {
+    }
+    if (dimension == 0)
+    {
+      RCLCPP_ERROR(getLogger(), "%s: Invalid dimension for random linear projection: '%s'", name_.c_str(),
+                   peval.c_str());
+    }
+    else
+    {
+      return std::make_shared<ProjectionEvaluatorRandomLinear>(this, dimension);
+    }
+  }
   else
   {
     RCLCPP_ERROR(getLogger(), "Unable to allocate projection evaluator based on description: '%s'", peval.c_str());
@@ -402,6 +426,74 @@ void ModelBasedPlanningContext::useConfig()
     cfg.erase(it);
   }
 
+  // check how much of the allowed planning time is reserved for solving, the remainder is used for simplification
+  it = cfg.find("solve_time_fraction");
+  if (it != cfg.end())
+  {
+    setSolveTimeFraction(boost::lexical_cast<double>(it->second));
+    cfg.erase(it);
+  }
+
+  // check whether motions should be validated coarse-to-fine with a table of recently checked states
+  bool bisection_motion_validation = false;
+  it = cfg.find("bisection_motion_validation");
+  if (it != cfg.end())
+  {
+    bisection_motion_validation = boost::lexical_cast<bool>(it->second);
+    cfg.erase(it);
+  }
+  std::size_t motion_validation_cache_size = 4096;
+  it = cfg.find("motion_validation_cache_size");
+  if (it != cfg.end())
+  {
+    motion_validation_cache_size = boost::lexical_cast<std::size_t>(it->second);
+    cfg.erase(it);
+  }
+  bool continuous_motion_validation = false;
+  it = cfg.find("continuous_motion_validation");
+  if (it != cfg.end())
+  {
+    continuous_motion_validation = boost::lexical_cast<bool>(it->second);
+    cfg.erase(it);
+  }
+  if (bisection_motion_validation && !spec_.constrained_state_space_)
+  {
+    ompl_simple_setup_->getSpaceInformation()->setMotionValidator(std::make_shared<BisectionMotionValidator>(
+        this, motion_validation_cache_size, continuous_motion_validation));
+  }
+
+  // check whether self-collisions should be checked in stages before collisions with the world,
+  // and whether recently found colliding states should be remembered to reject states close to them
+  bool staged_collision_checking = false;
+  it = cfg.find("staged_collision_checking");
+  if (it != cfg.end())
+  {
+    staged_collision_checking = boost::lexical_cast<bool>(it->second);
+    cfg.erase(it);
+  }
+  std::size_t invalid_state_cache_size = 0;
+  it = cfg.find("invalid_state_cache_size");
+  if (it != cfg.end())
+  {
+    invalid_state_cache_size = boost::lexical_cast<std::size_t>(it->second);
+    cfg.erase(it);
+  }
+  double invalid_state_cache_radius = 0.0;
+  it = cfg.find("invalid_state_cache_radius");
+  if (it != cfg.end())
+  {
+    invalid_state_cache_radius = boost::lexical_cast<double>(it->second);
+    cfg.erase(it);
+  }
+  if (ompl_simple_setup_->getStateValidityChecker())
+  {
+    auto* state_validity_checker =
+        static_cast<StateValidityChecker*>(ompl_simple_setup_->getStateValidityChecker().get());
+    state_validity_checker->setStagedCollisionChecking(staged_collision_checking);
+    state_validity_checker->setInvalidStateCache(invalid_state_cache_radius > 0.0 ? invalid_state_cache_size : 0,
+                                                 invalid_state_cache_radius);
+  }
+
   // remove the 'type' parameter; the rest are parameters for the planner itself
   it = cfg.find("type");
   if (it == cfg.end())
@@ -449,6 +541,22 @@ void ModelBasedPlanningContext::setPlanningVolume(const moveit_msgs::msg::Worksp
                                         wparams.max_corner.y, wparams.min_corner.z, wparams.max_corner.z);
 }
 
+void ModelBasedPlanningContext::setSolveTimeFraction(double fraction)
+{
+  if (!(fraction > 0.0 && fraction <= 1.0))
+  {
+    RCLCPP_WARN(getLogger(), "%s: Solve time fraction %g is not in (0, 1], using 1", name_.c_str(), fraction);
+    fraction = 1.0;
+  }
+  solve_time_fraction_ = fraction;
+}
+
+double ModelBasedPlanningContext::getSolveTimeout() const
+{
+  // without simplification there is nothing to reserve time for
+  return simplify_solutions_ ? solve_time_fraction_ * request_.allowed_planning_time : request_.allowed_planning_time;
+}
+
 void ModelBasedPlanningContext::simplifySolution(double timeout)
 {
   ompl::time::point start = ompl::time::now();
@@ -630,18 +738,6 @@ void ModelBasedPlanningContext::clear()
   {
     ompl_simple_setup_->clear();
   }
-  else
-  {
-    // For LazyPRM and LazyPRMstar we assume that the environment *could* have changed
-    // This means that we need to reset the validity flags for every node and edge in
-    // the roadmap. For PRM and PRMstar we assume that the environment is static. If
-    // this is not the case, then multi-query planning should not be enabled.
-    auto planner = dynamic_cast<ompl::geometric::LazyPRM*>(ompl_simple_setup_->getPlanner().get());
-    if (planner != nullptr)
-    {
-      planner->clearValidity();
-    }
-  }
   ompl_simple_setup_->clearStartStates();
   ompl_simple_setup_->setGoal(ob::GoalPtr());
   ompl_simple_setup_->setStateValidityChecker(ob::StateValidityCheckerPtr());
@@ -748,10 +844,43 @@ void ModelBasedPlanningContext::preSolve()
   {
     planner->clear();
   }
+  else if (planner)
+  {
+    updatePersistentRoadmap(*planner);
+  }
   startSampling();
   ompl_simple_setup_->getSpaceInformation()->getMotionValidator()->resetMotionCounter();
 }
 
+void ModelBasedPlanningContext::updatePersistentRoadmap(ob::Planner& planner)
+{
+  // The roadmap is kept across requests and only has to be revisited when the world changed since it was last used
+  // by this context. LazyPRM and LazyPRMstar check vertices and edges when a query needs them, so resetting their
+  // validity flags is enough. PRM and PRMstar check edges while building the roadmap and have to start over.
+  // A roadmap this context did not use yet (reused from another context or loaded from disk) is assumed to match
+  // the current world, only the validity flags of lazy planners are reset conservatively.
+  const std::uint64_t world_version = getPlanningScene()->getWorld()->getVersion();
+  const bool known_roadmap = roadmap_planner_.lock().get() == &planner;
+  if (known_roadmap && roadmap_world_version_ == world_version)
+  {
+    return;
+  }
+
+  auto lazy_planner = dynamic_cast<ompl::geometric::LazyPRM*>(&planner);
+  if (lazy_planner != nullptr)
+  {
+    lazy_planner->clearValidity();
+  }
+  else if (known_roadmap)
+  {
+    RCLCPP_INFO(getLogger(), "%s: The world changed, discarding the roadmap of planner '%s'", name_.c_str(),
+                planner.getName().c_str());
+    planner.clear();
+  }
+  roadmap_planner_ = ompl_simple_setup_->getPlanner();
+  roadmap_world_version_ = world_version;
+}
+
 void ModelBasedPlanningContext::postSolve()
 {
   stopSampling();
@@ -772,7 +901,7 @@ void ModelBasedPlanningContext::postSolve()
 void ModelBasedPlanningContext::solve(planning_interface::MotionPlanResponse& res)
 {
   res.planner_id = request_.planner_id;
-  res.error_code = solve(request_.allowed_planning_time, request_.num_planning_attempts);
+  res.error_code = solve(getSolveTimeout(), request_.num_planning_attempts);
   if (res.error_code.val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
   {
     RCLCPP_ERROR(getLogger(), "Unable to solve the planning problem");
@@ -783,6 +912,7 @@ void ModelBasedPlanningContext::solve(planning_interface::MotionPlanResponse& re
   {
     simplifySolution(request_.allowed_planning_time - ptime);
     ptime += getLastSimplifyTime();
+    res.statistics.simplification_time = getLastSimplifyTime();
   }
 
   if (interpolate_)
@@ -802,7 +932,7 @@ void ModelBasedPlanningContext::solve(planning_interface::MotionPlanResponse& re
 void ModelBasedPlanningContext::solve(planning_interface::MotionPlanDetailedResponse& res)
 {
   res.planner_id = request_.planner_id;
-  res.error_code = solve(request_.allowed_planning_time, request_.num_planning_attempts);
+  res.error_code = solve(getSolveTimeout(), request_.num_planning_attempts);
   if (res.error_code.val != moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
   {
     RCLCPP_INFO(getLogger(), "Unable to solve the planning problem");
@@ -847,7 +977,9 @@ void ModelBasedPlanningContext::solve(planning_interface::MotionPlanDetailedResp
 
 const moveit_msgs::msg::MoveItErrorCodes ModelBasedPlanningContext::solve(double timeout, unsigned int count)
 {
+  MOVEIT_TRACEPOINT_SCOPE_DETAIL("ompl.solve", request_.planner_id);
   ompl::time::point start = ompl::time::now();
+  work_counters_ = moveit::getThreadWorkCounters();
   preSolve();
 
   moveit_msgs::msg::MoveItErrorCodes result;
@@ -43,3 +43,30 @@ ompl_interface::JointModelStateSpace::JointModelStateSpace(const ModelBasedState
 {
   setName(getName() + "_" + PARAMETERIZATION_TYPE);
 }
+
+double ompl_interface::JointModelStateSpace::distance(const ompl::base::State* state1,
+                                                      const ompl::base::State* state2) const
+{
+  if (distance_function_)
+  {
+    return distance_function_(state1, state2);
+  }
+  double d;
+  spec_.joint_model_group_->distances(state1->as<StateType>()->values, state2->as<StateType>()->values, 1, &d);
+  return d;
+}
+
+void ompl_interface::JointModelStateSpace::interpolate(const ompl::base::State* from, const ompl::base::State* to,
+                                                       const double t, ompl::base::State* state) const
+{
+  if (interpolation_function_)
+  {
+    ModelBasedStateSpace::interpolate(from, to, t, state);
+    return;
+  }
+  // clear any cached info (such as validity known or not)
+  state->as<StateType>()->clearKnownInformation();
+  spec_.joint_model_group_->interpolate(from->as<StateType>()->values, to->as<StateType>()->values, &t, 1,
+                                        state->as<StateType>()->values);
+  setInterpolatedTag(from, to, t, state);
+}
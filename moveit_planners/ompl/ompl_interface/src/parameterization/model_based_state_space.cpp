@@ -37,6 +37,7 @@
 #include <moveit/ompl_interface/parameterization/model_based_state_space.hpp>
 #include <utility>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/work_counters.hpp>
 
 namespace ompl_interface
 {
@@ -218,20 +219,24 @@ void ModelBasedStateSpace::interpolate(const ompl::base::State* from, const ompl
     // perform the actual interpolation
     spec_.joint_model_group_->interpolate(from->as<StateType>()->values, to->as<StateType>()->values, t,
                                           state->as<StateType>()->values);
+    setInterpolatedTag(from, to, t, state);
+  }
+}
 
-    // compute tag
-    if (from->as<StateType>()->tag >= 0 && t < 1.0 - tag_snap_to_segment_)
-    {
-      state->as<StateType>()->tag = from->as<StateType>()->tag;
-    }
-    else if (to->as<StateType>()->tag >= 0 && t > tag_snap_to_segment_)
-    {
-      state->as<StateType>()->tag = to->as<StateType>()->tag;
-    }
-    else
-    {
-      state->as<StateType>()->tag = -1;
-    }
+void ModelBasedStateSpace::setInterpolatedTag(const ompl::base::State* from, const ompl::base::State* to,
+                                              const double t, ompl::base::State* state) const
+{
+  if (from->as<StateType>()->tag >= 0 && t < 1.0 - tag_snap_to_segment_)
+  {
+    state->as<StateType>()->tag = from->as<StateType>()->tag;
+  }
+  else if (to->as<StateType>()->tag >= 0 && t > tag_snap_to_segment_)
+  {
+    state->as<StateType>()->tag = to->as<StateType>()->tag;
+  }
+  else
+  {
+    state->as<StateType>()->tag = -1;
   }
 }
 
@@ -279,12 +284,14 @@ ompl::base::StateSamplerPtr ModelBasedStateSpace::allocDefaultStateSampler() con
 
     void sampleUniform(ompl::base::State* state) override
     {
+      moveit::countWork(&moveit::WorkCounters::states_sampled);
       joint_model_group_->getVariableRandomPositions(moveit_rng_, state->as<StateType>()->values, *joint_bounds_);
       state->as<StateType>()->clearKnownInformation();
     }
 
     void sampleUniformNear(ompl::base::State* state, const ompl::base::State* near, const double distance) override
     {
+      moveit::countWork(&moveit::WorkCounters::states_sampled);
       joint_model_group_->getVariableRandomPositionsNearBy(moveit_rng_, state->as<StateType>()->values, *joint_bounds_,
                                                            near->as<StateType>()->values, distance);
       state->as<StateType>()->clearKnownInformation();
@@ -38,6 +38,7 @@
 #include <moveit/robot_state/conversions.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <algorithm>
 #include <utility>
 
 #include <ompl/geometric/planners/AnytimePathShortening.h>
@@ -92,7 +93,10 @@ rclcpp::Logger getLogger()
 
 struct PlanningContextManager::CachedContexts
 {
+  // pooled contexts per planner configuration name and state space factory type
   std::map<std::pair<std::string, std::string>, std::vector<ModelBasedPlanningContextPtr> > contexts_;
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
   std::mutex lock_;
 };
 
@@ -261,6 +265,7 @@ PlanningContextManager::PlanningContextManager(moveit::core::RobotModelConstPtr
   , max_planning_threads_(4)
   , max_solution_segment_length_(0.0)
   , minimum_waypoint_count_(2)
+  , max_pooled_contexts_(0)
 {
   cached_contexts_ = std::make_shared<CachedContexts>();
   registerDefaultPlanners();
@@ -338,22 +343,72 @@ void PlanningContextManager::setPlannerConfigurations(const planning_interface::
   planner_configs_ = pconfig;
 }
 
+ModelBasedPlanningContextPtr
+PlanningContextManager::createPlanningContext(const planning_interface::PlannerConfigurationSettings& config,
+                                              const ModelBasedStateSpaceFactoryPtr& factory,
+                                              const moveit_msgs::msg::MotionPlanRequest& req) const
+{
+  ModelBasedStateSpaceSpecification space_spec(robot_model_, config.group);
+  ModelBasedPlanningContextSpecification context_spec;
+  context_spec.config_ = config.config;
+  context_spec.planner_selector_ = getPlannerSelector();
+  context_spec.constraint_sampler_manager_ = constraint_sampler_manager_;
+  context_spec.state_space_ = factory->getNewStateSpace(space_spec);
+
+  if (factory->getType() == ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
+  {
+    RCLCPP_DEBUG_STREAM(getLogger(), "planning_context_manager: Using OMPL's constrained state space for planning.");
+
+    // Select the correct type of constraints based on the path constraints in the planning request.
+    ompl::base::ConstraintPtr ompl_constraint = createOMPLConstraints(robot_model_, config.group, req.path_constraints);
+
+    // Fail if ompl constraints could not be parsed successfully
+    if (!ompl_constraint)
+    {
+      return ModelBasedPlanningContextPtr();
+    }
+
+    // Create a constrained state space of type "projected state space".
+    // Other types are available, so we probably should add another setting to ompl_planning.yaml
+    // to choose between them.
+    context_spec.constrained_state_space_ =
+        std::make_shared<ob::ProjectedStateSpace>(context_spec.state_space_, ompl_constraint);
+
+    // Pass the constrained state space to ompl simple setup through the creation of a
+    // ConstrainedSpaceInformation object. This makes sure the state space is properly initialized.
+    context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(
+        std::make_shared<ob::ConstrainedSpaceInformation>(context_spec.constrained_state_space_));
+  }
+  else
+  {
+    // Choose the correct simple setup type to load
+    context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(context_spec.state_space_);
+  }
+
+  RCLCPP_DEBUG(getLogger(), "Creating new planning context");
+  return std::make_shared<ModelBasedPlanningContext>(config.name, context_spec);
+}
+
 ModelBasedPlanningContextPtr
 PlanningContextManager::getPlanningContext(const planning_interface::PlannerConfigurationSettings& config,
                                            const ModelBasedStateSpaceFactoryPtr& factory,
                                            const moveit_msgs::msg::MotionPlanRequest& req) const
 {
-  // Check for a cached planning context
-  ModelBasedPlanningContextPtr context;
+  // Do not pool a constrained planning context, as the constraints could be changed
+  // and need to be parsed again.
+  const bool poolable = factory->getType() != ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE;
+  const auto key = std::make_pair(config.name, factory->getType());
 
+  // Check for a pooled planning context that is not in use
+  ModelBasedPlanningContextPtr context;
   {
-    std::unique_lock<std::mutex> slock(cached_contexts_->lock_);
-    auto cached_contexts = cached_contexts_->contexts_.find(std::make_pair(config.name, factory->getType()));
+    std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+    auto cached_contexts = cached_contexts_->contexts_.find(key);
     if (cached_contexts != cached_contexts_->contexts_.end())
     {
       for (const ModelBasedPlanningContextPtr& cached_context : cached_contexts->second)
       {
-        if (cached_context.unique())
+        if (cached_context.use_count() == 1)
         {
           RCLCPP_DEBUG(getLogger(), "Reusing cached planning context");
           context = cached_context;
@@ -361,60 +416,29 @@ PlanningContextManager::getPlanningContext(const planning_interface::PlannerConf
         }
       }
     }
-  }
-
-  // Create a new planning context
-  if (!context)
-  {
-    ModelBasedStateSpaceSpecification space_spec(robot_model_, config.group);
-    ModelBasedPlanningContextSpecification context_spec;
-    context_spec.config_ = config.config;
-    context_spec.planner_selector_ = getPlannerSelector();
-    context_spec.constraint_sampler_manager_ = constraint_sampler_manager_;
-    context_spec.state_space_ = factory->getNewStateSpace(space_spec);
-
-    if (factory->getType() == ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
+    if (context)
     {
-      RCLCPP_DEBUG_STREAM(getLogger(), "planning_context_manager: Using OMPL's constrained state space for planning.");
-
-      // Select the correct type of constraints based on the path constraints in the planning request.
-      ompl::base::ConstraintPtr ompl_constraint =
-          createOMPLConstraints(robot_model_, config.group, req.path_constraints);
-
-      // Fail if ompl constraints could not be parsed successfully
-      if (!ompl_constraint)
-      {
-        return ModelBasedPlanningContextPtr();
-      }
-
-      // Create a constrained state space of type "projected state space".
-      // Other types are available, so we probably should add another setting to ompl_planning.yaml
-      // to choose between them.
-      context_spec.constrained_state_space_ =
-          std::make_shared<ob::ProjectedStateSpace>(context_spec.state_space_, ompl_constraint);
-
-      // Pass the constrained state space to ompl simple setup through the creation of a
-      // ConstrainedSpaceInformation object. This makes sure the state space is properly initialized.
-      context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(
-          std::make_shared<ob::ConstrainedSpaceInformation>(context_spec.constrained_state_space_));
+      ++cached_contexts_->hits_;
     }
     else
     {
-      // Choose the correct simple setup type to load
-      context_spec.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(context_spec.state_space_);
+      ++cached_contexts_->misses_;
     }
+  }
 
-    RCLCPP_DEBUG(getLogger(), "Creating new planning context");
-    context = std::make_shared<ModelBasedPlanningContext>(config.name, context_spec);
+  // Create a new planning context
+  if (!context)
+  {
+    context = createPlanningContext(config, factory, req);
+    if (!context)
+      return context;
 
-    // Do not cache a constrained planning context, as the constraints could be changed
-    // and need to be parsed again.
-    if (factory->getType() != ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
+    if (poolable)
     {
-      {
-        std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
-        cached_contexts_->contexts_[std::make_pair(config.name, factory->getType())].push_back(context);
-      }
+      std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+      std::vector<ModelBasedPlanningContextPtr>& pool = cached_contexts_->contexts_[key];
+      if (max_pooled_contexts_ == 0 || pool.size() < max_pooled_contexts_)
+        pool.push_back(context);
     }
   }
 
@@ -434,6 +458,97 @@ PlanningContextManager::getPlanningContext(const planning_interface::PlannerConf
   return context;
 }
 
+void PlanningContextManager::setMaximumPooledContexts(std::size_t max_pooled_contexts)
+{
+  max_pooled_contexts_ = max_pooled_contexts;
+  if (max_pooled_contexts_ == 0)
+    return;
+
+  // drop surplus contexts that are not in use, the ones in use are dropped by their last owner
+  std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+  for (auto& [key, pool] : cached_contexts_->contexts_)
+  {
+    for (auto it = pool.begin(); it != pool.end() && pool.size() > max_pooled_contexts_;)
+    {
+      if (it->use_count() == 1)
+      {
+        it = pool.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    if (pool.size() > max_pooled_contexts_)
+      pool.resize(max_pooled_contexts_);
+  }
+}
+
+std::size_t PlanningContextManager::preallocatePlanningContexts(const std::string& config_name, std::size_t count)
+{
+  auto pc = planner_configs_.find(config_name);
+  if (pc == planner_configs_.end())
+  {
+    RCLCPP_ERROR(getLogger(), "Cannot find planning configuration '%s'", config_name.c_str());
+    return 0;
+  }
+
+  // contexts are created for requests without path constraints, which is what the pool is used for
+  moveit_msgs::msg::MotionPlanRequest req;
+  req.group_name = pc->second.group;
+  const ModelBasedStateSpaceFactoryPtr& factory = selectStateSpaceFactory(pc->second, req);
+  if (!factory || factory->getType() == ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE)
+    return 0;
+
+  const auto key = std::make_pair(pc->second.name, factory->getType());
+  if (max_pooled_contexts_ > 0)
+    count = std::min(count, max_pooled_contexts_);
+
+  std::size_t pooled = 0;
+  {
+    std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+    pooled = cached_contexts_->contexts_[key].size();
+  }
+  // construct outside of the lock, so concurrent requests are not blocked by the construction
+  std::vector<ModelBasedPlanningContextPtr> contexts;
+  for (std::size_t i = pooled; i < count; ++i)
+  {
+    if (ModelBasedPlanningContextPtr context = createPlanningContext(pc->second, factory, req))
+      contexts.push_back(context);
+  }
+
+  std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+  std::vector<ModelBasedPlanningContextPtr>& pool = cached_contexts_->contexts_[key];
+  for (const ModelBasedPlanningContextPtr& context : contexts)
+  {
+    if (max_pooled_contexts_ == 0 || pool.size() < max_pooled_contexts_)
+      pool.push_back(context);
+  }
+  return pool.size();
+}
+
+PlanningContextManager::ContextPoolStatistics PlanningContextManager::getContextPoolStatistics() const
+{
+  ContextPoolStatistics statistics;
+  std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+  statistics.hits = cached_contexts_->hits_;
+  statistics.misses = cached_contexts_->misses_;
+  for (const auto& [key, pool] : cached_contexts_->contexts_)
+  {
+    statistics.pooled += pool.size();
+    statistics.in_use += static_cast<std::size_t>(std::count_if(
+        pool.begin(), pool.end(), [](const ModelBasedPlanningContextPtr& context) { return context.use_count() > 1; }));
+  }
+  return statistics;
+}
+
+void PlanningContextManager::resetContextPoolStatistics()
+{
+  std::lock_guard<std::mutex> slock(cached_contexts_->lock_);
+  cached_contexts_->hits_ = 0;
+  cached_contexts_->misses_ = 0;
+}
+
 const ModelBasedStateSpaceFactoryPtr& PlanningContextManager::getStateSpaceFactory(const std::string& factory_type) const
 {
   auto f = factory_type.empty() ? state_space_factories_.begin() : state_space_factories_.find(factory_type);
@@ -481,6 +596,61 @@ PlanningContextManager::getStateSpaceFactory(const std::string& group,
   }
 }
 
+const ModelBasedStateSpaceFactoryPtr&
+PlanningContextManager::selectStateSpaceFactory(const planning_interface::PlannerConfigurationSettings& config,
+                                                const moveit_msgs::msg::MotionPlanRequest& req) const
+{
+  // State space selection process
+  // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+  // There are 3 options for the factory_selector
+  // 1) enforce_constrained_state_space = true AND there are path constraints in the planning request
+  //         Overrides all other settings and selects a ConstrainedPlanningStateSpace factory
+  // 2) enforce_joint_model_state_space = true
+  //         If 1) is false, then this one overrides the remaining settings and returns a JointModelStateSpace factory
+  // 3) Not 1) or 2), then the factory is selected based on the priority that each one returns.
+  //         See PoseModelStateSpaceFactory::canRepresentProblem for details on the selection process.
+  //         In short, it returns a PoseModelStateSpace if there is an IK solver and a path constraint.
+  //
+  // enforce_constrained_state_space
+  // ****************************************
+  // Check if the user wants to use an OMPL ConstrainedStateSpace for planning.
+  // This is done by setting 'enforce_constrained_state_space' to 'true' for the desired group in ompl_planing.yaml.
+  // If there are no path constraints in the planning request, this option is ignored, as the constrained state space is
+  // only useful for paths constraints. (And at the moment only a single position constraint is supported, hence:
+  //     req.path_constraints.position_constraints.size() == 1
+  // is used in the selection process below.)
+  //
+  // enforce_joint_model_state_space
+  // *******************************
+  // Check if sampling in JointModelStateSpace is enforced for this group by user.
+  // This is done by setting 'enforce_joint_model_state_space' to 'true' for the desired group in ompl_planning.yaml.
+  //
+  // Some planning problems like orientation path constraints are represented in PoseModelStateSpace and sampled via IK.
+  // However consecutive IK solutions are not checked for proximity at the moment and sometimes happen to be flipped,
+  // leading to invalid trajectories. This workaround lets the user prevent this problem by forcing rejection sampling
+  // in JointModelStateSpace.
+  auto constrained_planning_iterator = config.config.find("enforce_constrained_state_space");
+  auto joint_space_planning_iterator = config.config.find("enforce_joint_model_state_space");
+
+  // Use ConstrainedPlanningStateSpace if there is exactly one position constraint and/or one orientation constraint
+  if (constrained_planning_iterator != config.config.end() &&
+      boost::lexical_cast<bool>(constrained_planning_iterator->second) &&
+      ((req.path_constraints.position_constraints.size() == 1) ||
+       (req.path_constraints.orientation_constraints.size() == 1)))
+  {
+    return getStateSpaceFactory(ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE);
+  }
+  else if (joint_space_planning_iterator != config.config.end() &&
+           boost::lexical_cast<bool>(joint_space_planning_iterator->second))
+  {
+    return getStateSpaceFactory(JointModelStateSpace::PARAMETERIZATION_TYPE);
+  }
+  else
+  {
+    return getStateSpaceFactory(config.group, req);
+  }
+}
+
 ModelBasedPlanningContextPtr PlanningContextManager::getPlanningContext(
     const planning_scene::PlanningSceneConstPtr& planning_scene, const moveit_msgs::msg::MotionPlanRequest& req,
     moveit_msgs::msg::MoveItErrorCodes& error_code, const rclcpp::Node::SharedPtr& node,
@@ -526,55 +696,10 @@ ModelBasedPlanningContextPtr PlanningContextManager::getPlanningContext(
     }
   }
 
-  // State space selection process
-  // ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
-  // There are 3 options for the factory_selector
-  // 1) enforce_constrained_state_space = true AND there are path constraints in the planning request
-  //         Overrides all other settings and selects a ConstrainedPlanningStateSpace factory
-  // 2) enforce_joint_model_state_space = true
-  //         If 1) is false, then this one overrides the remaining settings and returns a JointModelStateSpace factory
-  // 3) Not 1) or 2), then the factory is selected based on the priority that each one returns.
-  //         See PoseModelStateSpaceFactory::canRepresentProblem for details on the selection process.
-  //         In short, it returns a PoseModelStateSpace if there is an IK solver and a path constraint.
-  //
-  // enforce_constrained_state_space
-  // ****************************************
-  // Check if the user wants to use an OMPL ConstrainedStateSpace for planning.
-  // This is done by setting 'enforce_constrained_state_space' to 'true' for the desired group in ompl_planing.yaml.
-  // If there are no path constraints in the planning request, this option is ignored, as the constrained state space is
-  // only useful for paths constraints. (And at the moment only a single position constraint is supported, hence:
-  //     req.path_constraints.position_constraints.size() == 1
-  // is used in the selection process below.)
-  //
-  // enforce_joint_model_state_space
-  // *******************************
-  // Check if sampling in JointModelStateSpace is enforced for this group by user.
-  // This is done by setting 'enforce_joint_model_state_space' to 'true' for the desired group in ompl_planning.yaml.
-  //
-  // Some planning problems like orientation path constraints are represented in PoseModelStateSpace and sampled via IK.
-  // However consecutive IK solutions are not checked for proximity at the moment and sometimes happen to be flipped,
-  // leading to invalid trajectories. This workaround lets the user prevent this problem by forcing rejection sampling
-  // in JointModelStateSpace.
-  ModelBasedStateSpaceFactoryPtr factory;
-  auto constrained_planning_iterator = pc->second.config.find("enforce_constrained_state_space");
-  auto joint_space_planning_iterator = pc->second.config.find("enforce_joint_model_state_space");
-
-  // Use ConstrainedPlanningStateSpace if there is exactly one position constraint and/or one orientation constraint
-  if (constrained_planning_iterator != pc->second.config.end() &&
-      boost::lexical_cast<bool>(constrained_planning_iterator->second) &&
-      ((req.path_constraints.position_constraints.size() == 1) ||
-       (req.path_constraints.orientation_constraints.size() == 1)))
-  {
-    factory = getStateSpaceFactory(ConstrainedPlanningStateSpace::PARAMETERIZATION_TYPE);
-  }
-  else if (joint_space_planning_iterator != pc->second.config.end() &&
-           boost::lexical_cast<bool>(joint_space_planning_iterator->second))
+  const ModelBasedStateSpaceFactoryPtr& factory = selectStateSpaceFactory(pc->second, req);
+  if (!factory)
   {
-    factory = getStateSpaceFactory(JointModelStateSpace::PARAMETERIZATION_TYPE);
-  }
-  else
-  {
-    factory = getStateSpaceFactory(pc->second.group, req);
+    return ModelBasedPlanningContextPtr();
   }
 
   ModelBasedPlanningContextPtr context = getPlanningContext(pc->second, factory, req);
@@ -0,0 +1,151 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Checks that BisectionMotionValidator agrees with OMPL's DiscreteMotionValidator */
+
+#include "load_test_robot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <moveit/ompl_interface/detail/motion_validator.hpp>
+#include <moveit/ompl_interface/detail/state_validity_checker.hpp>
+#include <moveit/ompl_interface/model_based_planning_context.hpp>
+#include <moveit/ompl_interface/parameterization/joint_space/joint_model_state_space.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
+
+#include <ompl/base/DiscreteMotionValidator.h>
+#include <ompl/geometric/SimpleSetup.h>
+
+class TestMotionValidator : public ompl_interface_testing::LoadTestRobot, public testing::Test
+{
+public:
+  TestMotionValidator(const std::string& robot_name, const std::string& group_name)
+    : LoadTestRobot(robot_name, group_name)
+  {
+  }
+
+  /** Random motions and a motion into self-collision are classified like by the discrete motion validator **/
+  void testAgreesWithDiscreteValidator(const std::vector<double>& valid_position,
+                                       const std::vector<double>& position_in_self_collision)
+  {
+    SCOPED_TRACE("testAgreesWithDiscreteValidator");
+
+    const ompl::base::SpaceInformationPtr& si = planning_context_->getOMPLSimpleSetup()->getSpaceInformation();
+    auto discrete = std::make_shared<ompl::base::DiscreteMotionValidator>(si);
+    auto bisection = std::make_shared<ompl_interface::BisectionMotionValidator>(planning_context_.get(), 1024, false);
+
+    ompl::base::ScopedState<> valid_state(state_space_);
+    robot_state_->setJointGroupPositions(joint_model_group_, valid_position);
+    state_space_->copyToOMPLState(valid_state.get(), *robot_state_);
+    ompl::base::ScopedState<> colliding_state(state_space_);
+    robot_state_->setJointGroupPositions(joint_model_group_, position_in_self_collision);
+    state_space_->copyToOMPLState(colliding_state.get(), *robot_state_);
+
+    EXPECT_FALSE(bisection->checkMotion(valid_state.get(), colliding_state.get()));
+    EXPECT_FALSE(bisection->checkMotion(colliding_state.get(), valid_state.get()));
+    EXPECT_TRUE(bisection->checkMotion(valid_state.get(), valid_state.get()));
+
+    std::pair<ompl::base::State*, double> last_valid{ si->allocState(), 0.0 };
+    std::pair<ompl::base::State*, double> expected_last_valid{ si->allocState(), 0.0 };
+    ompl::base::StateSamplerPtr sampler = si->allocStateSampler();
+    ompl::base::ScopedState<> s1(state_space_);
+    ompl::base::ScopedState<> s2(state_space_);
+    for (int i = 0; i < 50; ++i)
+    {
+      sampler->sampleUniform(s1.get());
+      sampler->sampleUniform(s2.get());
+      EXPECT_EQ(bisection->checkMotion(s1.get(), s2.get()), discrete->checkMotion(s1.get(), s2.get()));
+      // checking again uses the table and gives the same result
+      EXPECT_EQ(bisection->checkMotion(s1.get(), s2.get()), discrete->checkMotion(s1.get(), s2.get()));
+
+      const bool valid = bisection->checkMotion(s1.get(), s2.get(), last_valid);
+      EXPECT_EQ(valid, discrete->checkMotion(s1.get(), s2.get(), expected_last_valid));
+      if (!valid)
+      {
+        EXPECT_DOUBLE_EQ(last_valid.second, expected_last_valid.second);
+      }
+    }
+    si->freeState(last_valid.first);
+    si->freeState(expected_last_valid.first);
+  }
+
+protected:
+  void SetUp() override
+  {
+    ompl_interface::ModelBasedStateSpaceSpecification space_spec(robot_model_, group_name_);
+    state_space_ = std::make_shared<ompl_interface::JointModelStateSpace>(space_spec);
+    state_space_->computeLocations();
+
+    planning_context_spec_.state_space_ = state_space_;
+    planning_context_spec_.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(state_space_);
+    planning_context_ =
+        std::make_shared<ompl_interface::ModelBasedPlanningContext>(group_name_, planning_context_spec_);
+
+    planning_scene_ = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+    planning_context_->setPlanningScene(planning_scene_);
+    moveit::core::RobotState start_state(robot_model_);
+    start_state.setToDefaultValues();
+    planning_context_->setCompleteInitialState(start_state);
+
+    const ompl::base::SpaceInformationPtr& si = planning_context_->getOMPLSimpleSetup()->getSpaceInformation();
+    si->setStateValidityChecker(std::make_shared<ompl_interface::StateValidityChecker>(planning_context_.get()));
+    si->setup();
+  }
+
+  ompl_interface::ModelBasedStateSpacePtr state_space_;
+  ompl_interface::ModelBasedPlanningContextSpecification planning_context_spec_;
+  ompl_interface::ModelBasedPlanningContextPtr planning_context_;
+  planning_scene::PlanningScenePtr planning_scene_;
+};
+
+class PandaMotionValidator : public TestMotionValidator
+{
+protected:
+  PandaMotionValidator() : TestMotionValidator("panda", "panda_arm")
+  {
+  }
+};
+
+TEST_F(PandaMotionValidator, testAgreesWithDiscreteValidator)
+{
+  // the "ready" state and a state with a collision between "hand" and "panda_link2"
+  testAgreesWithDiscreteValidator({ 0., -0.785, 0., -2.356, 0., 1.571, 0.785 },
+                                  { 2.31827, -0.169668, 2.5225, -2.98568, -0.36355, 0.808339, 0.0843406 });
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
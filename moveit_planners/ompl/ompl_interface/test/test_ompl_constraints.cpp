@@ -221,6 +221,40 @@ protected:
     }
   }
 
+  void testFunctionAndJacobian()
+  {
+    SCOPED_TRACE("testFunctionAndJacobian");
+
+    const auto codim = constraint_->getCoDimension();
+    Eigen::VectorXd q_previous = getRandomState();
+    for (int i = 0; i < NUM_RANDOM_TESTS; ++i)
+    {
+      auto q = getRandomState();
+
+      // evaluating at other joint values in between must not leave stale link transforms behind
+      Eigen::VectorXd f_previous(codim);
+      constraint_->function(q_previous, f_previous);
+
+      Eigen::VectorXd f(codim);
+      Eigen::MatrixXd jac(codim, num_dofs_);
+      constraint_->function(q, f);
+      constraint_->jacobian(q, jac);
+
+      Eigen::VectorXd f_combined(codim);
+      Eigen::MatrixXd jac_combined(codim, num_dofs_);
+      constraint_->functionAndJacobian(q, f_combined, jac_combined);
+
+      EXPECT_LT((f - f_combined).lpNorm<1>(), 1e-12);
+      EXPECT_LT((jac - jac_combined).lpNorm<1>(), 1e-12);
+
+      Eigen::VectorXd f_again(codim);
+      constraint_->function(q_previous, f_again);
+      EXPECT_LT((f_previous - f_again).lpNorm<1>(), 1e-12);
+
+      q_previous = q;
+    }
+  }
+
   void testOMPLProjectedStateSpaceConstruction()
   {
     SCOPED_TRACE("testOMPLProjectedStateSpaceConstruction");
@@ -328,6 +362,16 @@ TEST_F(PandaConstraintTest, PositionConstraintJacobian)
   testJacobian();
 }
 
+TEST_F(PandaConstraintTest, FunctionAndJacobian)
+{
+  setPositionConstraints();
+  testFunctionAndJacobian();
+
+  constraint_.reset();
+  setEqualityPositionConstraints();
+  testFunctionAndJacobian();
+}
+
 TEST_F(PandaConstraintTest, PositionConstraintOMPLCheck)
 {
   setPositionConstraints();
@@ -214,6 +214,107 @@ public:
     }
   }
 
+  void testContextPool(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testContextPool");
+
+    planning_interface::PlannerConfigurationSettings pconfig_settings;
+    pconfig_settings.group = group_name_;
+    pconfig_settings.name = group_name_;
+    pconfig_settings.config = { { "enforce_joint_model_state_space", "1" } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { pconfig_settings.name, pconfig_settings } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+
+    // a released context is reused by the next request
+    auto pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    const auto* first_context = pc.get();
+    pc.reset();
+    pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc, nullptr);
+    EXPECT_EQ(pc.get(), first_context);
+
+    // a concurrent request gets a new context
+    auto pc2 = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc2, nullptr);
+    EXPECT_NE(pc2.get(), pc.get());
+
+    auto statistics = pcm.getContextPoolStatistics();
+    EXPECT_EQ(statistics.hits, 1u);
+    EXPECT_EQ(statistics.misses, 2u);
+    EXPECT_EQ(statistics.pooled, 2u);
+    EXPECT_EQ(statistics.in_use, 2u);
+
+    // shrinking the pool keeps the contexts in use until they are released
+    pc2.reset();
+    pcm.setMaximumPooledContexts(1);
+    statistics = pcm.getContextPoolStatistics();
+    EXPECT_EQ(statistics.pooled, 1u);
+    EXPECT_EQ(statistics.in_use, 1u);
+
+    // preallocated contexts serve the first requests
+    ompl_interface::PlanningContextManager preallocated_pcm(robot_model_, constraint_sampler_manager_);
+    preallocated_pcm.setPlannerConfigurations(pconfig_map);
+    EXPECT_EQ(preallocated_pcm.preallocatePlanningContexts(group_name_, 2), 2u);
+    EXPECT_EQ(preallocated_pcm.preallocatePlanningContexts("unknown_config", 2), 0u);
+    auto pc3 = preallocated_pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    auto pc4 = preallocated_pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    ASSERT_NE(pc3, nullptr);
+    ASSERT_NE(pc4, nullptr);
+    statistics = preallocated_pcm.getContextPoolStatistics();
+    EXPECT_EQ(statistics.hits, 2u);
+    EXPECT_EQ(statistics.misses, 0u);
+
+    planning_interface::MotionPlanDetailedResponse res;
+    pc3->solve(res);
+    EXPECT_EQ(res.error_code.val, moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+
+    preallocated_pcm.resetContextPoolStatistics();
+    statistics = preallocated_pcm.getContextPoolStatistics();
+    EXPECT_EQ(statistics.hits, 0u);
+    EXPECT_EQ(statistics.pooled, 2u);
+  }
+
+  void testSolveTimeFraction(const std::vector<double>& start, const std::vector<double>& goal)
+  {
+    SCOPED_TRACE("testSolveTimeFraction");
+
+    planning_interface::PlannerConfigurationSettings pconfig_settings;
+    pconfig_settings.group = group_name_;
+    pconfig_settings.name = group_name_;
+    pconfig_settings.config = { { "enforce_joint_model_state_space", "0" }, { "solve_time_fraction", "0.5" } };
+
+    planning_interface::PlannerConfigurationMap pconfig_map{ { pconfig_settings.name, pconfig_settings } };
+    moveit_msgs::msg::MoveItErrorCodes error_code;
+    planning_interface::MotionPlanRequest request = createRequest(start, goal);
+
+    ompl_interface::PlanningContextManager pcm(robot_model_, constraint_sampler_manager_);
+    pcm.setPlannerConfigurations(pconfig_map);
+    auto pc = pcm.getPlanningContext(planning_scene_, request, error_code, node_, false);
+    EXPECT_DOUBLE_EQ(pc->getSolveTimeFraction(), 0.5);
+
+    // invalid fractions fall back to giving the complete budget to solving
+    pc->setSolveTimeFraction(0.0);
+    EXPECT_DOUBLE_EQ(pc->getSolveTimeFraction(), 1.0);
+    pc->setSolveTimeFraction(0.5);
+
+    planning_interface::MotionPlanDetailedResponse res;
+    pc->solve(res);
+    ASSERT_EQ(res.error_code.val, moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+
+    // solving and simplification together stay within the allowed planning time
+    ASSERT_GE(res.processing_time.size(), 2u);
+    EXPECT_EQ(res.description[0], "plan");
+    EXPECT_EQ(res.description[1], "simplify");
+    EXPECT_LE(res.processing_time[0], 0.5 * request.allowed_planning_time + 0.1);
+    EXPECT_LE(res.processing_time[0] + res.processing_time[1], request.allowed_planning_time + 0.1);
+  }
+
 protected:
   void SetUp() override
   {
@@ -324,6 +425,16 @@ TEST_F(PandaTestPlanningContext, testSimpleRequest)
   testSimpleRequest({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
 }
 
+TEST_F(PandaTestPlanningContext, testContextPool)
+{
+  testContextPool({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
+TEST_F(PandaTestPlanningContext, testSolveTimeFraction)
+{
+  testSolveTimeFraction({ 0., -0.785, 0., -2.356, 0, 1.571, 0.785 }, { 0., -0.785, 0., -2.356, 0, 1.571, 0.685 });
+}
+
 // TODO(seng): This test is temporarily disabled as it is flaky since #1300. Re-enable when #2015 is resolved.
 // TEST_F(PandaTestPlanningContext, testPathConstraints)
 // {
@@ -0,0 +1,164 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Checks that the projection evaluators match forward kinematics and project consistently */
+
+#include "load_test_robot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <moveit/ompl_interface/detail/projection_evaluators.hpp>
+#include <moveit/ompl_interface/model_based_planning_context.hpp>
+#include <moveit/ompl_interface/parameterization/joint_space/joint_model_state_space.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
+
+#include <ompl/geometric/SimpleSetup.h>
+
+class TestProjectionEvaluators : public ompl_interface_testing::LoadTestRobot, public testing::Test
+{
+public:
+  TestProjectionEvaluators(const std::string& robot_name, const std::string& group_name)
+    : LoadTestRobot(robot_name, group_name)
+  {
+  }
+
+  /** The link projection gives the link position computed by the RobotState for random states **/
+  void testLinkPose()
+  {
+    SCOPED_TRACE("testLinkPose");
+
+    ompl_interface::ProjectionEvaluatorLinkPose projection(planning_context_.get(), ee_link_name_);
+    ASSERT_EQ(projection.getDimension(), 3u);
+
+    ompl::base::ScopedState<> state(state_space_);
+    Eigen::VectorXd projected(3);
+    for (int i = 0; i < 20; ++i)
+    {
+      robot_state_->setToRandomPositions(joint_model_group_);
+      robot_state_->update();
+      state_space_->copyToOMPLState(state.get(), *robot_state_);
+      projection.project(state.get(), projected);
+      EXPECT_TRUE(projected.isApprox(robot_state_->getGlobalLinkTransform(ee_link_name_).translation(), 1e-9))
+          << projected.transpose();
+    }
+  }
+
+  /** The random linear projection is linear and has the requested dimension **/
+  void testRandomLinear()
+  {
+    SCOPED_TRACE("testRandomLinear");
+
+    ompl_interface::ProjectionEvaluatorRandomLinear projection(planning_context_.get(), 3);
+    ASSERT_EQ(projection.getDimension(), 3u);
+
+    ompl::base::ScopedState<> a(state_space_), b(state_space_), sum(state_space_);
+    robot_state_->setToRandomPositions(joint_model_group_);
+    state_space_->copyToOMPLState(a.get(), *robot_state_);
+    robot_state_->setToRandomPositions(joint_model_group_);
+    state_space_->copyToOMPLState(b.get(), *robot_state_);
+    for (unsigned int i = 0; i < joint_model_group_->getVariableCount(); ++i)
+    {
+      sum->as<ompl_interface::JointModelStateSpace::StateType>()->values[i] =
+          a->as<ompl_interface::JointModelStateSpace::StateType>()->values[i] +
+          b->as<ompl_interface::JointModelStateSpace::StateType>()->values[i];
+    }
+
+    Eigen::VectorXd pa(3), pb(3), psum(3);
+    projection.project(a.get(), pa);
+    projection.project(b.get(), pb);
+    projection.project(sum.get(), psum);
+    EXPECT_TRUE(psum.isApprox(pa + pb, 1e-9));
+  }
+
+protected:
+  void SetUp() override
+  {
+    ompl_interface::ModelBasedStateSpaceSpecification space_spec(robot_model_, group_name_);
+    state_space_ = std::make_shared<ompl_interface::JointModelStateSpace>(space_spec);
+    state_space_->computeLocations();
+
+    planning_context_spec_.state_space_ = state_space_;
+    planning_context_spec_.ompl_simple_setup_ = std::make_shared<ompl::geometric::SimpleSetup>(state_space_);
+    planning_context_ =
+        std::make_shared<ompl_interface::ModelBasedPlanningContext>(group_name_, planning_context_spec_);
+
+    planning_scene_ = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+    planning_context_->setPlanningScene(planning_scene_);
+    moveit::core::RobotState start_state(robot_model_);
+    start_state.setToDefaultValues();
+    planning_context_->setCompleteInitialState(start_state);
+  }
+
+  ompl_interface::ModelBasedStateSpacePtr state_space_;
+  ompl_interface::ModelBasedPlanningContextSpecification planning_context_spec_;
+  ompl_interface::ModelBasedPlanningContextPtr planning_context_;
+  planning_scene::PlanningScenePtr planning_scene_;
+};
+
+class PandaProjection : public TestProjectionEvaluators
+{
+protected:
+  PandaProjection() : TestProjectionEvaluators("panda", "panda_arm")
+  {
+  }
+};
+
+TEST_F(PandaProjection, testLinkPose)
+{
+  testLinkPose();
+}
+
+TEST_F(PandaProjection, testRandomLinear)
+{
+  testRandomLinear();
+}
+
+class FanucProjection : public TestProjectionEvaluators
+{
+protected:
+  FanucProjection() : TestProjectionEvaluators("fanuc", "manipulator")
+  {
+  }
+};
+
+TEST_F(FanucProjection, testLinkPose)
+{
+  testLinkPose();
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
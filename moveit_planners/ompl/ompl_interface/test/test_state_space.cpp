@@ -188,6 +188,42 @@ TEST_F(LoadPlanningModelsPr2, StateSpaceCopy)
   joint_model_state_space.freeState(state);
 }
 
+// The joint space distance and interpolation match the joint model group, with (panda_arm) and without (right_arm of
+// the PR2, which has continuous joints) the vectorized path
+TEST(TestJointModelStateSpace, MatchesJointModelGroup)
+{
+  for (const auto& [robot_name, group_name] :
+       { std::make_pair("panda", "panda_arm"), std::make_pair("pr2", "right_arm") })
+  {
+    SCOPED_TRACE(group_name);
+    moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel(robot_name);
+    const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(group_name);
+    ompl_interface::ModelBasedStateSpaceSpecification spec(robot_model, group_name);
+    auto ss = std::make_shared<ompl_interface::JointModelStateSpace>(spec);
+    ss->setup();
+
+    ompl::base::ScopedState<> from(ss), to(ss), state(ss);
+    std::vector<double> expected(jmg->getVariableCount());
+    moveit::core::RobotState robot_state(robot_model);
+    for (int i = 0; i < 20; ++i)
+    {
+      robot_state.setToRandomPositions(jmg);
+      ss->copyToOMPLState(from.get(), robot_state);
+      robot_state.setToRandomPositions(jmg);
+      ss->copyToOMPLState(to.get(), robot_state);
+
+      const double* from_values = from->as<ompl_interface::JointModelStateSpace::StateType>()->values;
+      const double* to_values = to->as<ompl_interface::JointModelStateSpace::StateType>()->values;
+      EXPECT_NEAR(ss->distance(from.get(), to.get()), jmg->distance(from_values, to_values), 1e-12);
+
+      ss->interpolate(from.get(), to.get(), 0.3, state.get());
+      jmg->interpolate(from_values, to_values, 0.3, expected.data());
+      for (std::size_t j = 0; j < expected.size(); ++j)
+        EXPECT_NEAR(state->as<ompl_interface::JointModelStateSpace::StateType>()->values[j], expected[j], 1e-12);
+    }
+  }
+}
+
 // Run the OMPL sanity checks on the diff drive model
 TEST(TestDiffDrive, TestStateSpace)
 {
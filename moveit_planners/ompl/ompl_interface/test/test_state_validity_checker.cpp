@@ -39,6 +39,7 @@
  *        - States inside and outside joint limits.
  *        - States that are in self-collision.
  *        - Position constraints on the robot's end-effector link.
+ *        - Staged collision checking and the cache of invalid states.
  *
  *    It does not yet test:
  *        - Collision with objects in the environment.
@@ -152,6 +153,36 @@ public:
     EXPECT_TRUE(robot_state_->satisfiesBounds());
   }
 
+  /** This test takes a valid state and a state that is known to be in self-collision as input. **/
+  void testStagedCollisionChecking(const std::vector<double>& valid_position,
+                                   const std::vector<double>& position_in_self_collision)
+  {
+    SCOPED_TRACE("testStagedCollisionChecking");
+
+    auto checker = std::make_shared<ompl_interface::StateValidityChecker>(planning_context_.get());
+    checker->setVerbose(VERBOSE);
+    checker->setStagedCollisionChecking(true);
+    checker->setInvalidStateCache(16, 1e-3);
+
+    ompl::base::ScopedState<> ompl_state(state_space_);
+    robot_state_->setJointGroupPositions(joint_model_group_, valid_position);
+    state_space_->copyToOMPLState(ompl_state.get(), *robot_state_);
+    EXPECT_TRUE(checker->isValid(ompl_state.get()));
+
+    robot_state_->setJointGroupPositions(joint_model_group_, position_in_self_collision);
+    state_space_->copyToOMPLState(ompl_state.get(), *robot_state_);
+    EXPECT_FALSE(checker->isValid(ompl_state.get()));
+    EXPECT_EQ(checker->getStatistics().self_collision_rejections, 1u);
+
+    // a state very close to the colliding one is rejected by the cache, without checking collisions
+    ompl_state->as<ompl_interface::JointModelStateSpace::StateType>()->values[0] += 1e-4;
+    ompl_state->as<ompl_interface::JointModelStateSpace::StateType>()->clearKnownInformation();
+    EXPECT_FALSE(checker->isValid(ompl_state.get()));
+    EXPECT_EQ(checker->getStatistics().cache_rejections, 1u);
+    EXPECT_EQ(checker->getStatistics().self_collision_rejections, 1u);
+    EXPECT_EQ(checker->getStatistics().checked_states, 3u);
+  }
+
   void testPathConstraints(const std::vector<double>& position_in_joint_limits)
   {
     SCOPED_TRACE("testPathConstraints");
@@ -289,6 +320,12 @@ TEST_F(PandaValidity, testSelfCollision)
   testSelfCollision({ 2.31827, -0.169668, 2.5225, -2.98568, -0.36355, 0.808339, 0.0843406 });
 }
 
+TEST_F(PandaValidity, testStagedCollisionChecking)
+{
+  testStagedCollisionChecking({ 0., -0.785, 0., -2.356, 0., 1.571, 0.785 },
+                              { 2.31827, -0.169668, 2.5225, -2.98568, -0.36355, 0.808339, 0.0843406 });
+}
+
 TEST_F(PandaValidity, testPathConstraints)
 {
   // use the panda "ready" state from the srdf config
@@ -325,6 +362,12 @@ TEST_F(FanucTest, testSelfCollision)
   testSelfCollision({ -2.95993, -0.682185, -2.43873, -0.939784, 3.0544, 0.882294 });
 }
 
+TEST_F(FanucTest, testStagedCollisionChecking)
+{
+  testStagedCollisionChecking({ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 },
+                              { -2.95993, -0.682185, -2.43873, -0.939784, 3.0544, 0.882294 });
+}
+
 TEST_F(FanucTest, testPathConstraints)
 {
   // I assume the Fanucs's zero state is within limits and self-collision free
@@ -41,6 +41,8 @@ The skeleton of this test was taken from test_state_validity_checker.cpp by Jero
 #include "load_test_robot.hpp"
 #include <moveit/ompl_interface/detail/threadsafe_state_storage.hpp>
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 /** \brief Generic implementation of the tests that can be executed on different robots. **/
 class TestThreadSafeStateStorage : public ompl_interface_testing::LoadTestRobot, public testing::Test
@@ -74,6 +76,53 @@ public:
     }
   }
 
+  /** Each thread gets its own state, which is returned again on later calls, and each storage has its own states **/
+  void testThreadStates()
+  {
+    SCOPED_TRACE("testThreadStates");
+
+    std::vector<moveit::core::RobotState*> states(4, nullptr);
+    {
+      ompl_interface::TSStateStorage const tss(*robot_state_);
+      std::vector<std::thread> threads;
+      for (std::size_t i = 0; i < states.size(); ++i)
+      {
+        threads.emplace_back([&tss, &states, i] {
+          states[i] = tss.getStateStorage();
+          for (int call = 0; call < 100; ++call)
+          {
+            if (tss.getStateStorage() != states[i])
+            {
+              states[i] = nullptr;
+            }
+          }
+        });
+      }
+      for (std::thread& thread : threads)
+      {
+        thread.join();
+      }
+
+      for (std::size_t i = 0; i < states.size(); ++i)
+      {
+        ASSERT_NE(states[i], nullptr);
+        for (std::size_t j = 0; j < i; ++j)
+        {
+          EXPECT_NE(states[i], states[j]);
+        }
+      }
+    }
+
+    // storages used alternately by the same thread do not share states
+    ompl_interface::TSStateStorage const tss_a(*robot_state_);
+    ompl_interface::TSStateStorage const tss_b(*robot_state_);
+    moveit::core::RobotState* state_a = tss_a.getStateStorage();
+    moveit::core::RobotState* state_b = tss_b.getStateStorage();
+    EXPECT_NE(state_a, state_b);
+    EXPECT_EQ(tss_a.getStateStorage(), state_a);
+    EXPECT_EQ(tss_b.getStateStorage(), state_b);
+  }
+
 protected:
   void SetUp() override
   {
@@ -96,6 +145,11 @@ TEST_F(PandaTest, testConstruction)
   testReadback({ 0., -0.785, 0., -2.356, 0., 1.571, 0.785 });
 }
 
+TEST_F(PandaTest, testThreadStates)
+{
+  testThreadStates();
+}
+
 /***************************************************************************
  * Run all tests on the Fanuc robot
  * ************************************************************************/
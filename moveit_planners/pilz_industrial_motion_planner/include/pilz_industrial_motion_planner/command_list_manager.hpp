@@ -108,6 +108,20 @@ public:
                       const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
                       const moveit_msgs::msg::MotionSequenceRequest& req_list);
 
+  /**
+   * @brief Enables planning the requests of different groups concurrently.
+   *
+   * The requests of a group are still planned one after the other, because
+   * each of them starts at the end state of the previous one. Only enable this
+   * if the planners of the pipeline can be called concurrently. By default, it
+   * is set by the parameter
+   * "robot_description_planning.concurrent_group_planning".
+   */
+  void setConcurrentGroupPlanning(bool enable)
+  {
+    concurrent_group_planning_ = enable;
+  }
+
 private:
   using MotionResponseCont = std::vector<planning_interface::MotionPlanResponse>;
   using RobotState_OptRef = const std::optional<std::reference_wrapper<const moveit::core::RobotState>>;
@@ -137,6 +151,28 @@ private:
                                         const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
                                         const moveit_msgs::msg::MotionSequenceRequest& req_list) const;
 
+  /**
+   * @brief Solve the sequence items of each group in its own thread.
+   *
+   * @return Container of generated trajectories, in the order of the
+   * requests.
+   */
+  MotionResponseCont solveSequenceItemsConcurrently(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                                    const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
+                                                    const moveit_msgs::msg::MotionSequenceRequest& req_list) const;
+
+  /**
+   * @brief Solve a single sequence item, starting at the end state of the
+   * last trajectory of its group in the specified responses.
+   *
+   * @return The response of the planning pipeline.
+   */
+  static planning_interface::MotionPlanResponse
+  solveSequenceItem(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                    const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
+                    const moveit_msgs::msg::MotionSequenceItem& seq_item,
+                    const MotionResponseCont& motion_plan_responses);
+
   /**
    * @return TRUE if the blending radii of specified trajectories overlap,
    * otherwise FALSE. The functions returns FALSE if both trajectories are from
@@ -223,6 +259,9 @@ private:
 
   std::shared_ptr<cartesian_limits::ParamListener> param_listener_;
   cartesian_limits::Params params_;
+
+  //! Plan the requests of different groups concurrently
+  bool concurrent_group_planning_{ false };
 };
 
 inline void CommandListManager::checkLastBlendRadiusZero(const moveit_msgs::msg::MotionSequenceRequest& req_list)
@@ -36,6 +36,8 @@
 
 #include <pilz_industrial_motion_planner/joint_limits_extension.hpp>
 
+#include <moveit/robot_model/robot_model.hpp>
+
 #include <map>
 #include <vector>
 #include <string>
@@ -51,8 +53,18 @@ namespace pilz_industrial_motion_planner
 class JointLimitsContainer
 {
 public:
+  /**
+   * @brief Limits of the variables of a group, indexed like the variables of
+   * the JointModelGroup. Variables without a limit have a default JointLimit,
+   * which has no limits set.
+   */
+  using GroupLimits = std::vector<JointLimit>;
+
   /**
    * @brief Add a limit
+   *
+   * Removes the tables compiled by compileGroupLimits().
+   *
    * @param joint_name  Name if the joint this limit belongs to
    * @param joint_limit Limit of the joint
    * @return true if the limit was added, false
@@ -124,6 +136,29 @@ public:
    */
   std::map<std::string, JointLimit>::const_iterator end() const;
 
+  /**
+   * @brief Compile a table of limits for each group of the model, such that
+   * the limits of waypoints can be verified without looking up joint names
+   * @param model robot model whose groups are compiled
+   */
+  void compileGroupLimits(const moveit::core::RobotModel& model);
+
+  /**
+   * @brief get the compiled limits of a group
+   * @param group_name
+   * @return limits indexed like the variables of the group, or nullptr if
+   * they were not compiled
+   */
+  const GroupLimits* getGroupLimits(const std::string& group_name) const;
+
+  /**
+   * @brief get the limits of the given joints
+   * @param joint_names
+   * @return limits in the order of joint_names, default limits for joints
+   * without a limit
+   */
+  GroupLimits getLimits(const std::vector<std::string>& joint_names) const;
+
   /**
    * @brief verify position limit of single joint
    * @param joint_name
@@ -156,6 +191,30 @@ public:
    */
   bool verifyDecelerationLimit(const std::string& joint_name, double joint_acceleration) const;
 
+  /**
+   * @brief verify the position limit of a joint limit
+   * @return true if within limits, false otherwise
+   */
+  static bool verifyPositionLimit(const JointLimit& joint_limit, double joint_position);
+
+  /**
+   * @brief verify the velocity limit of a joint limit
+   * @return true if within limits, false otherwise
+   */
+  static bool verifyVelocityLimit(const JointLimit& joint_limit, double joint_velocity);
+
+  /**
+   * @brief verify the acceleration limit of a joint limit
+   * @return true if within limits, false otherwise
+   */
+  static bool verifyAccelerationLimit(const JointLimit& joint_limit, double joint_acceleration);
+
+  /**
+   * @brief verify the deceleration limit of a joint limit
+   * @return true if within limits, false otherwise
+   */
+  static bool verifyDecelerationLimit(const JointLimit& joint_limit, double joint_acceleration);
+
 private:
   /**
    * @brief update the most strict limit with given joint limit
@@ -167,5 +226,8 @@ private:
 protected:
   /// Actual container object containing the data
   std::map<std::string, JointLimit> container_;
+
+  /// Compiled limits of the groups
+  std::map<std::string, GroupLimits> group_limits_;
 };
 }  // namespace pilz_industrial_motion_planner
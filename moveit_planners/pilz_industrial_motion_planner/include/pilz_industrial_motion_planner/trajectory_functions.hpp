@@ -79,6 +79,32 @@ bool computePoseIK(const planning_scene::PlanningSceneConstPtr& scene, const std
                    const std::map<std::string, double>& seed, std::map<std::string, double>& solution,
                    bool check_self_collision = true, const double timeout = 0.0);
 
+/**
+ * @brief compute the inverse kinematics of a sequence of poses, e.g. the
+ * samples of a Cartesian trajectory, each seeded with the solution of the
+ * previous one
+ *
+ * The poses are passed to the kinematics solver at once, and self collision is
+ * only checked for the resulting solutions. Starting with the first pose that
+ * fails, the poses are solved one by one like computePoseIK() does.
+ * @param scene: planning scene
+ * @param group_name: name of planning group
+ * @param link_name: name of target link
+ * @param poses: target poses in the model frame
+ * @param seed: seed state of IK solver for the first pose
+ * @param solutions: solutions of the leading poses that were solved
+ * @param check_self_collision: true to enable self collision checking of the
+ * solutions
+ * @param timeout: timeout for IK of each pose, if not set the default solver
+ * timeout is used
+ * @return true if all poses were solved
+ */
+bool computePoseSequenceIK(const planning_scene::PlanningSceneConstPtr& scene, const std::string& group_name,
+                           const std::string& link_name, const EigenSTL::vector_Isometry3d& poses,
+                           const std::map<std::string, double>& seed,
+                           std::vector<std::map<std::string, double>>& solutions, bool check_self_collision = true,
+                           const double timeout = 0.0);
+
 /**
  * @brief compute the pose of a link at a given robot state
  * @param robot_state: an arbitrary robot state (with collision objects attached)
@@ -112,6 +138,23 @@ bool verifySampleJointLimits(const std::map<std::string, double>& position_last,
                              const std::map<std::string, double>& position_current, double duration_last,
                              double duration_current, const JointLimitsContainer& joint_limits);
 
+/**
+ * @brief verify the velocity/acceleration limits of current sample, like
+ * above, for joints given by index
+ * @param joint_names: names of the joints, only used for reporting
+ * @param position_last: position of last sample
+ * @param velocity_last: velocity of last sample
+ * @param position_current: position of current sample
+ * @param duration_last: duration of last sample
+ * @param duration_current: duration of current sample
+ * @param joint_limits: limits of the joints, in the order of joint_names
+ * @return
+ */
+bool verifySampleJointLimits(const std::vector<std::string>& joint_names, const std::vector<double>& position_last,
+                             const std::vector<double>& velocity_last, const std::vector<double>& position_current,
+                             double duration_last, double duration_current,
+                             const JointLimitsContainer::GroupLimits& joint_limits);
+
 /**
  * @brief Generate joint trajectory from a KDL Cartesian trajectory
  * @param scene: planning scene
@@ -205,6 +248,28 @@ bool linearSearchIntersectionPoint(const std::string& link_name, const Eigen::Ve
                                    const robot_trajectory::RobotTrajectoryPtr& traj, bool inverseOrder,
                                    std::size_t& index);
 
+/**
+ * @brief Performs a bisection search for the intersection point of the
+ * trajectory with the blending radius.
+ *
+ * The step to the next probed waypoint doubles, starting at the blending
+ * sphere center, until a waypoint outside of the sphere is found. The crossing
+ * is then bisected. Only O(log n) waypoint poses are evaluated for n waypoints
+ * inside the sphere. If the distance to the center grows monotonically up to
+ * the crossing, the result is the same as linearSearchIntersectionPoint().
+ * Otherwise, one of the crossings is found.
+ * @param center_position Center of blending sphere.
+ * @param r Radius of blending sphere.
+ * @param traj The trajectory.
+ * @param inverseOrder TRUE: Farthest element from blending sphere center is
+ * located at the
+ * smallest index of trajectroy.
+ * @param index The intersection index which has to be determined.
+ */
+bool bisectionSearchIntersectionPoint(const std::string& link_name, const Eigen::Vector3d& center_position,
+                                      const double r, const robot_trajectory::RobotTrajectoryPtr& traj,
+                                      bool inverseOrder, std::size_t& index);
+
 bool intersectionFound(const Eigen::Vector3d& p_center, const Eigen::Vector3d& p_current, const Eigen::Vector3d& p_next,
                        double r);
 
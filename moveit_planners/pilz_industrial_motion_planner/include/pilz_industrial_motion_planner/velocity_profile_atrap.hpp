@@ -36,6 +36,7 @@
 
 #include <kdl/velocityprofile.hpp>
 #include <iostream>
+#include <vector>
 
 namespace pilz_industrial_motion_planner
 {
@@ -168,6 +169,22 @@ public:
    * @return
    */
   double Acc(double time) const override;
+
+  /**
+   * @brief Get position, velocity and acceleration at several times at once,
+   * with the same values as Pos(), Vel() and Acc()
+   *
+   * The values of the k-th time are written to index k * stride of the
+   * buffers, such that the profiles of several joints can fill one row-major
+   * buffer of time samples.
+   * @param times: time samples
+   * @param positions: buffer for the positions
+   * @param velocities: buffer for the velocities
+   * @param accelerations: buffer for the accelerations
+   * @param stride: distance of consecutive samples in the buffers
+   */
+  void sample(const std::vector<double>& times, double* positions, double* velocities, double* accelerations,
+              std::size_t stride = 1) const;
   /**
    * @brief Write basic information
    * @param os
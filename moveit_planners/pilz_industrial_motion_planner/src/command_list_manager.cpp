@@ -37,7 +37,11 @@
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <cassert>
+#include <exception>
 #include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
 #include <sstream>
 
 #include <moveit/planning_pipeline/planning_pipeline.hpp>
@@ -70,6 +74,7 @@ CommandListManager::CommandListManager(const rclcpp::Node::SharedPtr& node,
 
   aggregated_limit_active_joints = pilz_industrial_motion_planner::JointLimitsAggregator::getAggregatedLimits(
       node_, PARAM_NAMESPACE_LIMITS, model_->getActiveJointModels());
+  aggregated_limit_active_joints.compileGroupLimits(*model_);
 
   param_listener_ =
       std::make_shared<cartesian_limits::ParamListener>(node, PARAM_NAMESPACE_LIMITS + ".cartesian_limits");
@@ -79,6 +84,8 @@ CommandListManager::CommandListManager(const rclcpp::Node::SharedPtr& node,
   limits.setJointLimits(aggregated_limit_active_joints);
   limits.setCartesianLimits(params_);
 
+  node_->get_parameter(PARAM_NAMESPACE_LIMITS + ".concurrent_group_planning", concurrent_group_planning_);
+
   plan_comp_builder_.setModel(model);
   plan_comp_builder_.setBlender(std::unique_ptr<pilz_industrial_motion_planner::TrajectoryBlender>(
       new pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow(limits)));
@@ -239,32 +246,111 @@ CommandListManager::solveSequenceItems(const planning_scene::PlanningSceneConstP
                                        const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
                                        const moveit_msgs::msg::MotionSequenceRequest& req_list) const
 {
+  if (concurrent_group_planning_ && getGroupNames(req_list).size() > 1)
+  {
+    return solveSequenceItemsConcurrently(planning_scene, planning_pipeline, req_list);
+  }
+
   MotionResponseCont motion_plan_responses;
   size_t curr_req_index{ 0 };
   const size_t num_req{ req_list.items.size() };
   for (const auto& seq_item : req_list.items)
   {
-    planning_interface::MotionPlanRequest req{ seq_item.req };
-    setStartState(motion_plan_responses, req.group_name, req.start_state);
-
-    planning_interface::MotionPlanResponse res;
-    if (!planning_pipeline->generatePlan(planning_scene, req, res))
-    {
-      RCLCPP_ERROR(getLogger(), "Generating a plan with planning pipeline failed.");
-      res.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
-    }
-    if (res.error_code.val != res.error_code.SUCCESS)
-    {
-      std::ostringstream os;
-      os << "Could not solve request\n";  // TODO(henning): re-enable "---\n" << req << "\n---\n";
-      throw PlanningPipelineException(os.str(), res.error_code.val);
-    }
-    motion_plan_responses.emplace_back(res);
+    motion_plan_responses.emplace_back(
+        solveSequenceItem(planning_scene, planning_pipeline, seq_item, motion_plan_responses));
     RCLCPP_DEBUG_STREAM(getLogger(), "Solved [" << ++curr_req_index << '/' << num_req << ']');
   }
   return motion_plan_responses;
 }
 
+CommandListManager::MotionResponseCont CommandListManager::solveSequenceItemsConcurrently(
+    const planning_scene::PlanningSceneConstPtr& planning_scene,
+    const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
+    const moveit_msgs::msg::MotionSequenceRequest& req_list) const
+{
+  const size_t num_req{ req_list.items.size() };
+  MotionResponseCont motion_plan_responses(num_req);
+
+  // Like the sequential planning, report the failure of the first request
+  std::mutex failure_mutex;
+  size_t failed_req_index{ std::numeric_limits<size_t>::max() };
+  std::exception_ptr failure;
+
+  std::vector<std::future<void>> group_plans;
+  for (const auto& group_name : getGroupNames(req_list))
+  {
+    group_plans.push_back(std::async(std::launch::async, [&, group_name] {
+      MotionResponseCont group_responses;
+      for (size_t i = 0; i < num_req; ++i)
+      {
+        if (req_list.items.at(i).req.group_name != group_name)
+        {
+          continue;
+        }
+        {
+          // Requests after a failed one are not needed anymore
+          std::lock_guard<std::mutex> lock(failure_mutex);
+          if (i > failed_req_index)
+          {
+            return;
+          }
+        }
+        try
+        {
+          group_responses.emplace_back(
+              solveSequenceItem(planning_scene, planning_pipeline, req_list.items.at(i), group_responses));
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(failure_mutex);
+          if (i < failed_req_index)
+          {
+            failed_req_index = i;
+            failure = std::current_exception();
+          }
+          return;
+        }
+        motion_plan_responses.at(i) = group_responses.back();
+        RCLCPP_DEBUG_STREAM(getLogger(), "Solved [" << i + 1 << '/' << num_req << ']');
+      }
+    }));
+  }
+  for (auto& group_plan : group_plans)
+  {
+    group_plan.wait();
+  }
+
+  if (failure)
+  {
+    std::rethrow_exception(failure);
+  }
+  return motion_plan_responses;
+}
+
+planning_interface::MotionPlanResponse
+CommandListManager::solveSequenceItem(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                      const planning_pipeline::PlanningPipelinePtr& planning_pipeline,
+                                      const moveit_msgs::msg::MotionSequenceItem& seq_item,
+                                      const MotionResponseCont& motion_plan_responses)
+{
+  planning_interface::MotionPlanRequest req{ seq_item.req };
+  setStartState(motion_plan_responses, req.group_name, req.start_state);
+
+  planning_interface::MotionPlanResponse res;
+  if (!planning_pipeline->generatePlan(planning_scene, req, res))
+  {
+    RCLCPP_ERROR(getLogger(), "Generating a plan with planning pipeline failed.");
+    res.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+  }
+  if (res.error_code.val != res.error_code.SUCCESS)
+  {
+    std::ostringstream os;
+    os << "Could not solve request\n";  // TODO(henning): re-enable "---\n" << req << "\n---\n";
+    throw PlanningPipelineException(os.str(), res.error_code.val);
+  }
+  return res;
+}
+
 void CommandListManager::checkForNegativeRadii(const moveit_msgs::msg::MotionSequenceRequest& req_list)
 {
   if (!std::all_of(req_list.items.begin(), req_list.items.end(),
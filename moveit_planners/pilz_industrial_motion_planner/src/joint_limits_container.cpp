@@ -63,6 +63,7 @@ bool JointLimitsContainer::addLimit(const std::string& joint_name,
     RCLCPP_ERROR_STREAM(getLogger(), "joint_limit for joint " << joint_name << " already contained.");
     return false;
   }
+  group_limits_.clear();
   return true;
 }
 
@@ -116,28 +117,82 @@ std::map<std::string, JointLimit>::const_iterator JointLimitsContainer::end() co
   return container_.end();
 }
 
+void JointLimitsContainer::compileGroupLimits(const moveit::core::RobotModel& model)
+{
+  group_limits_.clear();
+  for (const moveit::core::JointModelGroup* group : model.getJointModelGroups())
+  {
+    GroupLimits& limits = group_limits_[group->getName()];
+    limits.reserve(group->getVariableCount());
+    for (const std::string& variable_name : group->getVariableNames())
+    {
+      const auto it = container_.find(variable_name);
+      limits.push_back(it == container_.end() ? JointLimit() : it->second);
+    }
+  }
+}
+
+const JointLimitsContainer::GroupLimits* JointLimitsContainer::getGroupLimits(const std::string& group_name) const
+{
+  const auto it = group_limits_.find(group_name);
+  return it == group_limits_.end() ? nullptr : &it->second;
+}
+
+JointLimitsContainer::GroupLimits JointLimitsContainer::getLimits(const std::vector<std::string>& joint_names) const
+{
+  GroupLimits limits;
+  limits.reserve(joint_names.size());
+  for (const std::string& joint_name : joint_names)
+  {
+    const auto it = container_.find(joint_name);
+    limits.push_back(it == container_.end() ? JointLimit() : it->second);
+  }
+  return limits;
+}
+
 bool JointLimitsContainer::verifyPositionLimit(const std::string& joint_name, double joint_position) const
 {
-  return !hasLimit(joint_name) || !getLimit(joint_name).has_position_limits ||
-         (joint_position >= getLimit(joint_name).min_position && joint_position <= getLimit(joint_name).max_position);
+  const auto it = container_.find(joint_name);
+  return it == container_.end() || verifyPositionLimit(it->second, joint_position);
 }
 
 bool JointLimitsContainer::verifyVelocityLimit(const std::string& joint_name, double joint_velocity) const
 {
-  return !hasLimit(joint_name) || !getLimit(joint_name).has_velocity_limits ||
-         fabs(joint_velocity) <= getLimit(joint_name).max_velocity;
+  const auto it = container_.find(joint_name);
+  return it == container_.end() || verifyVelocityLimit(it->second, joint_velocity);
 }
 
 bool JointLimitsContainer::verifyAccelerationLimit(const std::string& joint_name, double joint_acceleration) const
 {
-  return !hasLimit(joint_name) || !getLimit(joint_name).has_acceleration_limits ||
-         fabs(joint_acceleration) <= getLimit(joint_name).max_acceleration;
+  const auto it = container_.find(joint_name);
+  return it == container_.end() || verifyAccelerationLimit(it->second, joint_acceleration);
 }
 
 bool JointLimitsContainer::verifyDecelerationLimit(const std::string& joint_name, double joint_acceleration) const
 {
-  return !hasLimit(joint_name) || !getLimit(joint_name).has_deceleration_limits ||
-         fabs(joint_acceleration) <= -1.0 * getLimit(joint_name).max_deceleration;
+  const auto it = container_.find(joint_name);
+  return it == container_.end() || verifyDecelerationLimit(it->second, joint_acceleration);
+}
+
+bool JointLimitsContainer::verifyPositionLimit(const JointLimit& joint_limit, double joint_position)
+{
+  return !joint_limit.has_position_limits ||
+         (joint_position >= joint_limit.min_position && joint_position <= joint_limit.max_position);
+}
+
+bool JointLimitsContainer::verifyVelocityLimit(const JointLimit& joint_limit, double joint_velocity)
+{
+  return !joint_limit.has_velocity_limits || fabs(joint_velocity) <= joint_limit.max_velocity;
+}
+
+bool JointLimitsContainer::verifyAccelerationLimit(const JointLimit& joint_limit, double joint_acceleration)
+{
+  return !joint_limit.has_acceleration_limits || fabs(joint_acceleration) <= joint_limit.max_acceleration;
+}
+
+bool JointLimitsContainer::verifyDecelerationLimit(const JointLimit& joint_limit, double joint_acceleration)
+{
+  return !joint_limit.has_deceleration_limits || fabs(joint_acceleration) <= -1.0 * joint_limit.max_deceleration;
 }
 
 void JointLimitsContainer::updateCommonLimit(const JointLimit& joint_limit, JointLimit& common_limit)
@@ -74,6 +74,7 @@ bool CommandPlanner::initialize(const moveit::core::RobotModelConstPtr& model, c
   // Obtain the aggregated joint limits
   aggregated_limit_active_joints_ = pilz_industrial_motion_planner::JointLimitsAggregator::getAggregatedLimits(
       node, PARAM_NAMESPACE_LIMITS, model->getActiveJointModels());
+  aggregated_limit_active_joints_.compileGroupLimits(*model);
 
   // Obtain cartesian limits
   param_listener_ =
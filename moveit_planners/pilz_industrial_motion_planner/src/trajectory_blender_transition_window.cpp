@@ -276,16 +276,16 @@ bool pilz_industrial_motion_planner::TrajectoryBlenderTransitionWindow::searchIn
   Eigen::Isometry3d circ_pose = req.first_trajectory->getLastWayPoint().getFrameTransform(req.link_name);
 
   // Search for intersection points according to distance
-  if (!linearSearchIntersectionPoint(req.link_name, circ_pose.translation(), req.blend_radius, req.first_trajectory,
-                                     true, first_interse_index))
+  if (!bisectionSearchIntersectionPoint(req.link_name, circ_pose.translation(), req.blend_radius, req.first_trajectory,
+                                        true, first_interse_index))
   {
     RCLCPP_ERROR_STREAM(getLogger(), "Intersection point of first trajectory not found.");
     return false;
   }
   RCLCPP_INFO_STREAM(getLogger(), "Intersection point of first trajectory found, index: " << first_interse_index);
 
-  if (!linearSearchIntersectionPoint(req.link_name, circ_pose.translation(), req.blend_radius, req.second_trajectory,
-                                     false, second_interse_index))
+  if (!bisectionSearchIntersectionPoint(req.link_name, circ_pose.translation(), req.blend_radius,
+                                        req.second_trajectory, false, second_interse_index))
   {
     RCLCPP_ERROR_STREAM(getLogger(), "Intersection point of second trajectory not found.");
     return false;
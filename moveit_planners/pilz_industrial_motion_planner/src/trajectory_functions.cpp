@@ -34,6 +34,8 @@
 
 #include <pilz_industrial_motion_planner/trajectory_functions.hpp>
 
+#include <algorithm>
+
 #include <moveit/planning_scene/planning_scene.hpp>
 // TODO: Remove conditional include when released to all active distros.
 #if __has_include(<tf2/LinearMath/Quaternion.hpp>)
@@ -52,6 +54,32 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("pilz_trajectory_functions");
 }
+
+// limits of the joints of a trajectory, from the compiled limits of the group if available
+pilz_industrial_motion_planner::JointLimitsContainer::GroupLimits
+getTrajectoryJointLimits(const pilz_industrial_motion_planner::JointLimitsContainer& joint_limits,
+                         const moveit::core::RobotModel& robot_model, const std::string& group_name,
+                         const std::vector<std::string>& joint_names)
+{
+  const pilz_industrial_motion_planner::JointLimitsContainer::GroupLimits* group_limits =
+      joint_limits.getGroupLimits(group_name);
+  if (!group_limits || !robot_model.hasJointModelGroup(group_name))
+  {
+    return joint_limits.getLimits(joint_names);
+  }
+  const moveit::core::JointModelGroup* group = robot_model.getJointModelGroup(group_name);
+  pilz_industrial_motion_planner::JointLimitsContainer::GroupLimits limits;
+  limits.reserve(joint_names.size());
+  for (const std::string& joint_name : joint_names)
+  {
+    // the name of a single variable joint is also the name of its variable
+    const bool is_group_variable =
+        group->hasJointModel(joint_name) && group->getJointModel(joint_name)->getVariableCount() == 1;
+    limits.push_back(is_group_variable ? group_limits->at(group->getVariableGroupIndex(joint_name)) :
+                                         joint_limits.getLimits({ joint_name }).front());
+  }
+  return limits;
+}
 }  // namespace
 
 bool pilz_industrial_motion_planner::computePoseIK(const planning_scene::PlanningSceneConstPtr& scene,
@@ -122,6 +150,67 @@ bool pilz_industrial_motion_planner::computePoseIK(const planning_scene::Plannin
                        timeout);
 }
 
+bool pilz_industrial_motion_planner::computePoseSequenceIK(const planning_scene::PlanningSceneConstPtr& scene,
+                                                           const std::string& group_name, const std::string& link_name,
+                                                           const EigenSTL::vector_Isometry3d& poses,
+                                                           const std::map<std::string, double>& seed,
+                                                           std::vector<std::map<std::string, double>>& solutions,
+                                                           bool check_self_collision, const double timeout)
+{
+  solutions.clear();
+  const moveit::core::RobotModelConstPtr& robot_model = scene->getRobotModel();
+  if (!robot_model->hasJointModelGroup(group_name))
+  {
+    RCLCPP_ERROR_STREAM(getLogger(), "Robot model has no planning group named as " << group_name);
+    return false;
+  }
+  const moveit::core::JointModelGroup* jmg = robot_model->getJointModelGroup(group_name);
+  solutions.reserve(poses.size());
+
+  // pass all poses to solvers with a single tip frame at once, each seeded with the solution of the previous one
+  const kinematics::KinematicsBaseConstPtr& solver = jmg->getSolverInstance();
+  if (solver && solver->getTipFrames().size() == 1)
+  {
+    moveit::core::RobotState rstate{ scene->getCurrentState() };
+    rstate.setVariablePositions(seed);
+    std::vector<moveit::core::RobotStatePtr> states;
+    states.reserve(poses.size());
+    rstate.setFromIKSequence(jmg, poses, link_name, states, timeout);
+
+    // the solver didn't see the collision checks, so they're done on the solutions only
+    std::vector<double> positions;
+    for (const moveit::core::RobotStatePtr& state : states)
+    {
+      if (check_self_collision)
+      {
+        state->copyJointGroupPositions(jmg, positions);
+        if (!isStateColliding(scene, state.get(), jmg, positions.data()))
+          break;
+      }
+      std::map<std::string, double>& solution = solutions.emplace_back();
+      for (const auto& joint_name : jmg->getActiveJointModelNames())
+      {
+        solution[joint_name] = state->getVariablePosition(joint_name);
+      }
+    }
+  }
+
+  // solve the remaining poses one by one, searching for collision free solutions
+  std::map<std::string, double> solution_last = solutions.empty() ? seed : solutions.back();
+  for (std::size_t i = solutions.size(); i < poses.size(); ++i)
+  {
+    std::map<std::string, double> solution;
+    if (!computePoseIK(scene, group_name, link_name, poses[i], robot_model->getModelFrame(), solution_last, solution,
+                       check_self_collision, timeout))
+    {
+      return false;
+    }
+    solutions.push_back(solution);
+    solution_last = std::move(solution);
+  }
+  return true;
+}
+
 bool pilz_industrial_motion_planner::computeLinkFK(moveit::core::RobotState& robot_state, const std::string& link_name,
                                                    const std::map<std::string, double>& joint_state,
                                                    Eigen::Isometry3d& pose)
@@ -146,6 +235,24 @@ bool pilz_industrial_motion_planner::verifySampleJointLimits(
     const std::map<std::string, double>& position_last, const std::map<std::string, double>& velocity_last,
     const std::map<std::string, double>& position_current, double duration_last, double duration_current,
     const pilz_industrial_motion_planner::JointLimitsContainer& joint_limits)
+{
+  std::vector<std::string> joint_names;
+  std::vector<double> positions_last, velocities_last, positions_current;
+  for (const auto& pos : position_current)
+  {
+    joint_names.push_back(pos.first);
+    positions_last.push_back(position_last.at(pos.first));
+    velocities_last.push_back(velocity_last.at(pos.first));
+    positions_current.push_back(pos.second);
+  }
+  return verifySampleJointLimits(joint_names, positions_last, velocities_last, positions_current, duration_last,
+                                 duration_current, joint_limits.getLimits(joint_names));
+}
+
+bool pilz_industrial_motion_planner::verifySampleJointLimits(
+    const std::vector<std::string>& joint_names, const std::vector<double>& position_last,
+    const std::vector<double>& velocity_last, const std::vector<double>& position_current, double duration_last,
+    double duration_current, const pilz_industrial_motion_planner::JointLimitsContainer::GroupLimits& joint_limits)
 {
   const double epsilon = 10e-6;
   if (duration_current <= epsilon)
@@ -156,44 +263,44 @@ bool pilz_industrial_motion_planner::verifySampleJointLimits(
 
   double velocity_current, acceleration_current;
 
-  for (const auto& pos : position_current)
+  for (size_t i = 0; i < joint_names.size(); ++i)
   {
-    velocity_current = (pos.second - position_last.at(pos.first)) / duration_current;
+    const JointLimit& limit = joint_limits[i];
+    velocity_current = (position_current[i] - position_last[i]) / duration_current;
 
-    if (!joint_limits.verifyVelocityLimit(pos.first, velocity_current))
+    if (!JointLimitsContainer::verifyVelocityLimit(limit, velocity_current))
     {
       RCLCPP_ERROR_STREAM(getLogger(), "Joint velocity limit of "
-                                           << pos.first << " violated. Set the velocity scaling factor lower!"
+                                           << joint_names[i] << " violated. Set the velocity scaling factor lower!"
                                            << " Actual joint velocity is " << velocity_current
-                                           << ", while the limit is " << joint_limits.getLimit(pos.first).max_velocity
-                                           << ". ");
+                                           << ", while the limit is " << limit.max_velocity << ". ");
       return false;
     }
 
-    acceleration_current = (velocity_current - velocity_last.at(pos.first)) / (duration_last + duration_current) * 2;
+    acceleration_current = (velocity_current - velocity_last[i]) / (duration_last + duration_current) * 2;
     // acceleration case
-    if (fabs(velocity_last.at(pos.first)) <= fabs(velocity_current))
+    if (fabs(velocity_last[i]) <= fabs(velocity_current))
     {
-      if (!joint_limits.verifyAccelerationLimit(pos.first, acceleration_current))
+      if (!JointLimitsContainer::verifyAccelerationLimit(limit, acceleration_current))
       {
         RCLCPP_ERROR_STREAM(getLogger(), "Joint acceleration limit of "
-                                             << pos.first << " violated. Set the acceleration scaling factor lower!"
+                                             << joint_names[i]
+                                             << " violated. Set the acceleration scaling factor lower!"
                                              << " Actual joint acceleration is " << acceleration_current
-                                             << ", while the limit is "
-                                             << joint_limits.getLimit(pos.first).max_acceleration << ". ");
+                                             << ", while the limit is " << limit.max_acceleration << ". ");
         return false;
       }
     }
     // deceleration case
     else
     {
-      if (!joint_limits.verifyDecelerationLimit(pos.first, acceleration_current))
+      if (!JointLimitsContainer::verifyDecelerationLimit(limit, acceleration_current))
       {
         RCLCPP_ERROR_STREAM(getLogger(), "Joint deceleration limit of "
-                                             << pos.first << " violated. Set the acceleration scaling factor lower!"
+                                             << joint_names[i]
+                                             << " violated. Set the acceleration scaling factor lower!"
                                              << " Actual joint deceleration is " << acceleration_current
-                                             << ", while the limit is "
-                                             << joint_limits.getLimit(pos.first).max_deceleration << ". ");
+                                             << ", while the limit is " << limit.max_deceleration << ". ");
         return false;
       }
     }
@@ -212,7 +319,6 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
 {
   RCLCPP_DEBUG(getLogger(), "Generate joint trajectory from a Cartesian trajectory.");
 
-  const moveit::core::RobotModelConstPtr& robot_model = scene->getRobotModel();
   rclcpp::Clock clock;
   rclcpp::Time generation_begin = clock.now();
 
@@ -226,27 +332,43 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
   time_samples.push_back(trajectory.Duration());
 
   // sample the trajectory and solve the inverse kinematics
-  Eigen::Isometry3d pose_sample;
-  std::map<std::string, double> ik_solution_last, ik_solution, joint_velocity_last;
-  ik_solution_last = initial_joint_position;
-  for (const auto& item : ik_solution_last)
+  EigenSTL::vector_Isometry3d pose_samples(time_samples.size());
+  for (std::size_t i = 0; i < time_samples.size(); ++i)
   {
-    joint_velocity_last[item.first] = 0.0;
+    tf2::transformKDLToEigen(trajectory.Pos(time_samples[i]), pose_samples[i]);
   }
+  std::vector<std::map<std::string, double>> ik_solutions;
+  computePoseSequenceIK(scene, group_name, link_name, pose_samples, initial_joint_position, ik_solutions,
+                        check_self_collision);
+
+  // the joints are ordered like the initial joint positions, their limits are looked up once
+  std::vector<std::string> joint_names;
+  std::vector<double> ik_solution_last, ik_solution, joint_velocity_last;
+  for (const auto& start_joint : initial_joint_position)
+  {
+    joint_names.push_back(start_joint.first);
+    ik_solution_last.push_back(start_joint.second);
+  }
+  joint_velocity_last.assign(joint_names.size(), 0.0);
+  ik_solution.resize(joint_names.size());
+  const JointLimitsContainer::GroupLimits trajectory_limits =
+      getTrajectoryJointLimits(joint_limits, *scene->getRobotModel(), group_name, joint_names);
 
   for (std::vector<double>::const_iterator time_iter = time_samples.begin(); time_iter != time_samples.end();
        ++time_iter)
   {
-    tf2::transformKDLToEigen(trajectory.Pos(*time_iter), pose_sample);
-
-    if (!computePoseIK(scene, group_name, link_name, pose_sample, robot_model->getModelFrame(), ik_solution_last,
-                       ik_solution, check_self_collision))
+    const std::size_t sample_index = time_iter - time_samples.begin();
+    if (sample_index >= ik_solutions.size())
     {
       RCLCPP_ERROR(getLogger(), "Failed to compute inverse kinematics solution for sampled Cartesian pose.");
       error_code.val = moveit_msgs::msg::MoveItErrorCodes::NO_IK_SOLUTION;
       joint_trajectory.points.clear();
       return false;
     }
+    for (size_t j = 0; j < joint_names.size(); ++j)
+    {
+      ik_solution[j] = ik_solutions[sample_index].at(joint_names[j]);
+    }
 
     // check the joint limits
     double duration_current_sample = sampling_time;
@@ -262,8 +384,8 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
 
     // skip the first sample with zero time from start for limits checking
     if (time_iter != time_samples.begin() &&
-        !verifySampleJointLimits(ik_solution_last, joint_velocity_last, ik_solution, sampling_time,
-                                 duration_current_sample, joint_limits))
+        !verifySampleJointLimits(joint_names, ik_solution_last, joint_velocity_last, ik_solution, sampling_time,
+                                 duration_current_sample, trajectory_limits))
     {
       RCLCPP_ERROR_STREAM(getLogger(), "Inverse kinematics solution at "
                                            << *time_iter
@@ -277,31 +399,28 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
     trajectory_msgs::msg::JointTrajectoryPoint point;
 
     // set joint names
-    joint_trajectory.joint_names.clear();
-    for (const auto& start_joint : initial_joint_position)
+    if (sample_index == 0)
     {
-      joint_trajectory.joint_names.push_back(start_joint.first);
+      joint_trajectory.joint_names = joint_names;
     }
 
     point.time_from_start = rclcpp::Duration::from_seconds(*time_iter);
-    for (const auto& joint_name : joint_trajectory.joint_names)
+    point.positions = ik_solution;
+    for (size_t j = 0; j < joint_names.size(); ++j)
     {
-      point.positions.push_back(ik_solution.at(joint_name));
-
       if (time_iter != time_samples.begin() && time_iter != time_samples.end() - 1)
       {
-        double joint_velocity =
-            (ik_solution.at(joint_name) - ik_solution_last.at(joint_name)) / duration_current_sample;
+        double joint_velocity = (ik_solution[j] - ik_solution_last[j]) / duration_current_sample;
         point.velocities.push_back(joint_velocity);
-        point.accelerations.push_back((joint_velocity - joint_velocity_last.at(joint_name)) /
+        point.accelerations.push_back((joint_velocity - joint_velocity_last[j]) /
                                       (duration_current_sample + sampling_time) * 2);
-        joint_velocity_last[joint_name] = joint_velocity;
+        joint_velocity_last[j] = joint_velocity;
       }
       else
       {
         point.velocities.push_back(0.);
         point.accelerations.push_back(0.);
-        joint_velocity_last[joint_name] = 0.;
+        joint_velocity_last[j] = 0.;
       }
     }
 
@@ -330,25 +449,37 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
 {
   RCLCPP_DEBUG(getLogger(), "Generate joint trajectory from a Cartesian trajectory.");
 
-  const moveit::core::RobotModelConstPtr& robot_model = scene->getRobotModel();
   rclcpp::Clock clock;
   rclcpp::Time generation_begin = clock.now();
 
-  std::map<std::string, double> ik_solution_last = initial_joint_position;
-  std::map<std::string, double> joint_velocity_last = initial_joint_velocity;
+  // the joints are ordered like the initial joint positions, their limits are looked up once
+  std::vector<double> ik_solution_last, ik_solution, joint_velocity_last;
   double duration_last = 0;
   double duration_current = 0;
   joint_trajectory.joint_names.clear();
-  for (const auto& joint_position : ik_solution_last)
+  for (const auto& joint_position : initial_joint_position)
   {
     joint_trajectory.joint_names.push_back(joint_position.first);
+    ik_solution_last.push_back(joint_position.second);
+    joint_velocity_last.push_back(initial_joint_velocity.at(joint_position.first));
+  }
+  ik_solution.resize(joint_trajectory.joint_names.size());
+  const JointLimitsContainer::GroupLimits trajectory_limits =
+      getTrajectoryJointLimits(joint_limits, *scene->getRobotModel(), group_name, joint_trajectory.joint_names);
+
+  // compute inverse kinematics
+  EigenSTL::vector_Isometry3d poses(trajectory.points.size());
+  for (size_t i = 0; i < trajectory.points.size(); ++i)
+  {
+    tf2::fromMsg(trajectory.points[i].pose, poses[i]);
   }
-  std::map<std::string, double> ik_solution;
+  std::vector<std::map<std::string, double>> ik_solutions;
+  computePoseSequenceIK(scene, group_name, link_name, poses, initial_joint_position, ik_solutions,
+                        check_self_collision);
+
   for (size_t i = 0; i < trajectory.points.size(); ++i)
   {
-    // compute inverse kinematics
-    if (!computePoseIK(scene, group_name, link_name, trajectory.points.at(i).pose, robot_model->getModelFrame(),
-                       ik_solution_last, ik_solution, check_self_collision))
+    if (i >= ik_solutions.size())
     {
       RCLCPP_ERROR(getLogger(), "Failed to compute inverse kinematics solution for sampled "
                                 "Cartesian pose.");
@@ -357,6 +488,11 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
       return false;
     }
 
+    for (size_t j = 0; j < joint_trajectory.joint_names.size(); ++j)
+    {
+      ik_solution[j] = ik_solutions[i].at(joint_trajectory.joint_names[j]);
+    }
+
     // verify the joint limits
     if (i == 0)
     {
@@ -369,8 +505,8 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
           trajectory.points.at(i).time_from_start.seconds() - trajectory.points.at(i - 1).time_from_start.seconds();
     }
 
-    if (!verifySampleJointLimits(ik_solution_last, joint_velocity_last, ik_solution, duration_last, duration_current,
-                                 joint_limits))
+    if (!verifySampleJointLimits(joint_trajectory.joint_names, ik_solution_last, joint_velocity_last, ik_solution,
+                                 duration_last, duration_current, trajectory_limits))
     {
       // LCOV_EXCL_START since the same code was captured in a test in the other
       // overload generateJointTrajectory(...,
@@ -389,15 +525,15 @@ bool pilz_industrial_motion_planner::generateJointTrajectory(
     // compute the waypoint
     trajectory_msgs::msg::JointTrajectoryPoint waypoint_joint;
     waypoint_joint.time_from_start = trajectory.points.at(i).time_from_start;
-    for (const auto& joint_name : joint_trajectory.joint_names)
+    waypoint_joint.positions = ik_solution;
+    for (size_t j = 0; j < joint_trajectory.joint_names.size(); ++j)
     {
-      waypoint_joint.positions.push_back(ik_solution.at(joint_name));
-      double joint_velocity = (ik_solution.at(joint_name) - ik_solution_last.at(joint_name)) / duration_current;
+      double joint_velocity = (ik_solution[j] - ik_solution_last[j]) / duration_current;
       waypoint_joint.velocities.push_back(joint_velocity);
-      waypoint_joint.accelerations.push_back((joint_velocity - joint_velocity_last.at(joint_name)) /
+      waypoint_joint.accelerations.push_back((joint_velocity - joint_velocity_last[j]) /
                                              (duration_current + duration_last) * 2);
       // update the joint velocity
-      joint_velocity_last[joint_name] = joint_velocity;
+      joint_velocity_last[j] = joint_velocity;
     }
 
     // update joint trajectory
@@ -566,6 +702,60 @@ bool pilz_industrial_motion_planner::linearSearchIntersectionPoint(const std::st
   return false;
 }
 
+bool pilz_industrial_motion_planner::bisectionSearchIntersectionPoint(const std::string& link_name,
+                                                                      const Eigen::Vector3d& center_position, double r,
+                                                                      const robot_trajectory::RobotTrajectoryPtr& traj,
+                                                                      bool inverseOrder, std::size_t& index)
+{
+  RCLCPP_DEBUG(getLogger(), "Start bisection search for intersection point.");
+
+  const size_t waypoint_num = traj->getWayPointCount();
+  if (waypoint_num < 2)
+  {
+    return false;
+  }
+
+  // distance to the center of the waypoint with the given number of steps from the start of the search
+  const auto distance = [&](size_t steps) {
+    const size_t i = inverseOrder ? waypoint_num - 1 - steps : steps;
+    return (traj->getWayPointPtr(i)->getFrameTransform(link_name).translation() - center_position).norm();
+  };
+  if (distance(0) > r)
+  {
+    return false;
+  }
+
+  // probe with doubling steps for a waypoint outside of the sphere
+  size_t inside = 0;
+  size_t outside = 1;
+  while (distance(outside) < r)
+  {
+    if (outside == waypoint_num - 1)
+    {
+      return false;
+    }
+    inside = outside;
+    outside = std::min(2 * outside, waypoint_num - 1);
+  }
+
+  // bisect the crossing between the last waypoint inside and the first outside
+  while (outside - inside > 1)
+  {
+    const size_t middle = inside + (outside - inside) / 2;
+    if (distance(middle) >= r)
+    {
+      outside = middle;
+    }
+    else
+    {
+      inside = middle;
+    }
+  }
+
+  index = inverseOrder ? waypoint_num - 1 - inside : inside;
+  return true;
+}
+
 bool pilz_industrial_motion_planner::intersectionFound(const Eigen::Vector3d& p_center,
                                                        const Eigen::Vector3d& p_current, const Eigen::Vector3d& p_next,
                                                        double r)
@@ -135,23 +135,25 @@ void TrajectoryGeneratorPTP::planPTP(const std::map<std::string, double>& start_
   }
 
   // compute the fastest trajectory and choose the slowest joint as leading axis
-  std::string leading_axis = joint_trajectory.joint_names.front();
+  // the profiles are ordered like the joint names
+  const std::size_t num_joints = joint_trajectory.joint_names.size();
+  std::size_t leading_axis = 0;
   double max_duration = -1.0;
 
-  std::map<std::string, VelocityProfileATrap> velocity_profile;
-  for (const auto& joint_name : joint_trajectory.joint_names)
+  std::vector<VelocityProfileATrap> velocity_profile;
+  velocity_profile.reserve(num_joints);
+  for (std::size_t j = 0; j < num_joints; ++j)
   {
-    // create vecocity profile if necessary
-    velocity_profile.insert(std::make_pair(
-        joint_name, VelocityProfileATrap(velocity_scaling_factor * most_strict_limit_.max_velocity,
-                                         acceleration_scaling_factor * most_strict_limit_.max_acceleration,
-                                         acceleration_scaling_factor * most_strict_limit_.max_deceleration)));
+    const std::string& joint_name = joint_trajectory.joint_names[j];
+    velocity_profile.emplace_back(velocity_scaling_factor * most_strict_limit_.max_velocity,
+                                  acceleration_scaling_factor * most_strict_limit_.max_acceleration,
+                                  acceleration_scaling_factor * most_strict_limit_.max_deceleration);
 
-    velocity_profile.at(joint_name).SetProfile(start_pos.at(joint_name), goal_pos.at(joint_name));
-    if (velocity_profile.at(joint_name).Duration() > max_duration)
+    velocity_profile[j].SetProfile(start_pos.at(joint_name), goal_pos.at(joint_name));
+    if (velocity_profile[j].Duration() > max_duration)
     {
-      max_duration = velocity_profile.at(joint_name).Duration();
-      leading_axis = joint_name;
+      max_duration = velocity_profile[j].Duration();
+      leading_axis = j;
     }
   }
 
@@ -159,27 +161,27 @@ void TrajectoryGeneratorPTP::planPTP(const std::map<std::string, double>& start_
   // This should only work if all axes have same max_vel, max_acc, max_dec
   // values
   // reset the velocity profile for other joints
-  double acc_time = velocity_profile.at(leading_axis).firstPhaseDuration();
-  double const_time = velocity_profile.at(leading_axis).secondPhaseDuration();
-  double dec_time = velocity_profile.at(leading_axis).thirdPhaseDuration();
+  double acc_time = velocity_profile[leading_axis].firstPhaseDuration();
+  double const_time = velocity_profile[leading_axis].secondPhaseDuration();
+  double dec_time = velocity_profile[leading_axis].thirdPhaseDuration();
 
-  for (const auto& joint_name : joint_trajectory.joint_names)
+  for (std::size_t j = 0; j < num_joints; ++j)
   {
-    if (joint_name != leading_axis)
+    if (j != leading_axis)
     {
+      const std::string& joint_name = joint_trajectory.joint_names[j];
       // make full synchronization
       // causes the program to terminate if acc_time<=0 or dec_time<=0 (should
       // be prevented by goal_reached block above)
       // by using the most strict limit, the following should always return true
-      if (!velocity_profile.at(joint_name)
-               .setProfileAllDurations(start_pos.at(joint_name), goal_pos.at(joint_name), acc_time, const_time,
-                                       dec_time))
+      if (!velocity_profile[j].setProfileAllDurations(start_pos.at(joint_name), goal_pos.at(joint_name), acc_time,
+                                                      const_time, dec_time))
       // LCOV_EXCL_START
       {
         std::stringstream error_str;
         error_str << "TrajectoryGeneratorPTP::planPTP(): Can not synchronize "
                      "velocity profile of axis "
-                  << joint_name << " with leading axis " << leading_axis;
+                  << joint_name << " with leading axis " << joint_trajectory.joint_names[leading_axis];
         throw PtpVelocityProfileSyncFailed(error_str.str());
       }
       // LCOV_EXCL_STOP
@@ -188,6 +190,7 @@ void TrajectoryGeneratorPTP::planPTP(const std::map<std::string, double>& start_
 
   // first generate the time samples
   std::vector<double> time_samples;
+  time_samples.reserve(static_cast<std::size_t>(max_duration / sampling_time) + 2);
   for (double t_sample = 0.0; t_sample < max_duration; t_sample += sampling_time)
   {
     time_samples.push_back(t_sample);
@@ -195,18 +198,27 @@ void TrajectoryGeneratorPTP::planPTP(const std::map<std::string, double>& start_
   // add last time
   time_samples.push_back(max_duration);
 
-  // construct joint trajectory point
-  for (double time_stamp : time_samples)
+  // sample all profiles at once into row-major buffers, one row per time sample
+  const std::size_t num_samples = time_samples.size();
+  std::vector<double> positions(num_samples * num_joints);
+  std::vector<double> velocities(num_samples * num_joints);
+  std::vector<double> accelerations(num_samples * num_joints);
+  for (std::size_t j = 0; j < num_joints; ++j)
   {
-    trajectory_msgs::msg::JointTrajectoryPoint point;
-    point.time_from_start = rclcpp::Duration::from_seconds(time_stamp);
-    for (std::string& joint_name : joint_trajectory.joint_names)
-    {
-      point.positions.push_back(velocity_profile.at(joint_name).Pos(time_stamp));
-      point.velocities.push_back(velocity_profile.at(joint_name).Vel(time_stamp));
-      point.accelerations.push_back(velocity_profile.at(joint_name).Acc(time_stamp));
-    }
-    joint_trajectory.points.push_back(point);
+    velocity_profile[j].sample(time_samples, positions.data() + j, velocities.data() + j, accelerations.data() + j,
+                               num_joints);
+  }
+
+  // construct joint trajectory points
+  joint_trajectory.points.reserve(joint_trajectory.points.size() + num_samples);
+  for (std::size_t k = 0; k < num_samples; ++k)
+  {
+    const std::size_t row = k * num_joints;
+    trajectory_msgs::msg::JointTrajectoryPoint& point = joint_trajectory.points.emplace_back();
+    point.time_from_start = rclcpp::Duration::from_seconds(time_samples[k]);
+    point.positions.assign(positions.begin() + row, positions.begin() + row + num_joints);
+    point.velocities.assign(velocities.begin() + row, velocities.begin() + row + num_joints);
+    point.accelerations.assign(accelerations.begin() + row, accelerations.begin() + row + num_joints);
   }
 
   // Set last point velocity and acceleration to zero
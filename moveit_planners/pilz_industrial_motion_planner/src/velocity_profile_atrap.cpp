@@ -381,6 +381,18 @@ double VelocityProfileATrap::Acc(double time) const
   }
 }
 
+void VelocityProfileATrap::sample(const std::vector<double>& times, double* positions, double* velocities,
+                                  double* accelerations, std::size_t stride) const
+{
+  // qualified calls are not dispatched virtually and can be inlined
+  for (std::size_t k = 0; k < times.size(); ++k)
+  {
+    positions[k * stride] = VelocityProfileATrap::Pos(times[k]);
+    velocities[k * stride] = VelocityProfileATrap::Vel(times[k]);
+    accelerations[k * stride] = VelocityProfileATrap::Acc(times[k]);
+  }
+}
+
 KDL::VelocityProfile* VelocityProfileATrap::Clone() const
 {
   VelocityProfileATrap* trap = new VelocityProfileATrap(max_vel_, max_acc_, max_dec_);
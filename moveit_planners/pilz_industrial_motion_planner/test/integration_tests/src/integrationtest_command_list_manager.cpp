@@ -584,6 +584,28 @@ TEST_F(IntegrationTestCommandListManager, TestDifferentGroups)
   }
 }
 
+/**
+ * @brief Checks that planning the groups concurrently yields the same
+ * trajectories as planning the requests one after the other.
+ */
+TEST_F(IntegrationTestCommandListManager, TestDifferentGroupsConcurrently)
+{
+  Sequence seq{ data_loader_->getSequence("ComplexSequenceWithGripper") };
+  ASSERT_GE(seq.size(), 1u);
+
+  manager_->setConcurrentGroupPlanning(false);
+  RobotTrajCont res_sequential{ manager_->solve(scene_, pipeline_, seq.toRequest()) };
+  manager_->setConcurrentGroupPlanning(true);
+  RobotTrajCont res_concurrent{ manager_->solve(scene_, pipeline_, seq.toRequest()) };
+
+  ASSERT_EQ(res_concurrent.size(), res_sequential.size());
+  for (size_t i = 0; i < res_concurrent.size(); ++i)
+  {
+    EXPECT_EQ(res_concurrent.at(i)->getGroupName(), res_sequential.at(i)->getGroupName());
+    EXPECT_EQ(res_concurrent.at(i)->getWayPointCount(), res_sequential.at(i)->getWayPointCount());
+  }
+}
+
 /**
  * @brief Checks that no exception is thrown if two gripper commands are
  * blended.
@@ -203,6 +203,39 @@ TEST_F(JointLimitsContainerTest, FirstPositionEmpty)
   EXPECT_EQ(-1, limits.min_position);
 }
 
+/**
+ * @brief The limits of several joints are returned in the requested order,
+ * unknown joints get default limits
+ */
+TEST_F(JointLimitsContainerTest, GetLimitsInOrder)
+{
+  JointLimitsContainer::GroupLimits limits = container_.getLimits({ "joint6", "unknown", "joint1" });
+  ASSERT_EQ(3u, limits.size());
+  EXPECT_EQ(2, limits[0].max_velocity);
+  EXPECT_FALSE(limits[1].has_position_limits);
+  EXPECT_FALSE(limits[1].has_velocity_limits);
+  EXPECT_EQ(3, limits[2].max_acceleration);
+}
+
+/**
+ * @brief The checks of a single limit agree with the checks by joint name
+ */
+TEST_F(JointLimitsContainerTest, VerifySingleLimit)
+{
+  const JointLimit& lim1 = container_.getLimit("joint1");
+  EXPECT_TRUE(JointLimitsContainer::verifyPositionLimit(lim1, 1.5));
+  EXPECT_FALSE(JointLimitsContainer::verifyPositionLimit(lim1, 2.5));
+  EXPECT_EQ(container_.verifyPositionLimit("joint1", 2.5), JointLimitsContainer::verifyPositionLimit(lim1, 2.5));
+  EXPECT_TRUE(JointLimitsContainer::verifyAccelerationLimit(lim1, -3));
+  EXPECT_FALSE(JointLimitsContainer::verifyAccelerationLimit(lim1, 3.5));
+
+  const JointLimit& lim6 = container_.getLimit("joint6");
+  EXPECT_TRUE(JointLimitsContainer::verifyVelocityLimit(lim6, -2));
+  EXPECT_FALSE(JointLimitsContainer::verifyVelocityLimit(lim6, 2.5));
+  EXPECT_TRUE(JointLimitsContainer::verifyDecelerationLimit(lim6, -100));
+  EXPECT_FALSE(JointLimitsContainer::verifyDecelerationLimit(lim6, 101));
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -725,6 +725,63 @@ TEST_F(TrajectoryFunctionsTestFlangeAndGripper, testComputePoseIKSelfCollisionFo
                                                              frame_id, ik_seed, ik_actual, true));
 }
 
+/**
+ * @brief Test the inverse kinematics of a pose sequence, each pose is seeded
+ * with the solution of the previous one.
+ */
+TEST_F(TrajectoryFunctionsTestFlangeAndGripper, testComputePoseSequenceIK)
+{
+  moveit::core::RobotState rstate(robot_model_);
+  const moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup(planning_group_);
+
+  std::vector<double> start_positions = { 0, 0.5, -0.5, 0, 0.5, 0 };
+  std::map<std::string, double> ik_seed;
+  for (std::size_t i = 0; i < joint_names_.size(); ++i)
+  {
+    ik_seed[joint_names_[i]] = start_positions[i];
+  }
+
+  // poses along a small joint space motion
+  EigenSTL::vector_Isometry3d poses;
+  std::vector<std::vector<double>> expected_positions;
+  for (std::size_t k = 1; k <= 10; ++k)
+  {
+    std::vector<double> positions = start_positions;
+    for (double& position : positions)
+    {
+      position += 0.01 * static_cast<double>(k);
+    }
+    rstate.setJointGroupPositions(jmg, positions);
+    rstate.update();
+    poses.push_back(rstate.getFrameTransform(tcp_link_));
+    expected_positions.push_back(positions);
+  }
+
+  std::vector<std::map<std::string, double>> ik_solutions;
+  ASSERT_TRUE(pilz_industrial_motion_planner::computePoseSequenceIK(planning_scene_, planning_group_, tcp_link_, poses,
+                                                                    ik_seed, ik_solutions, false));
+  ASSERT_EQ(ik_solutions.size(), poses.size());
+  for (std::size_t k = 0; k < poses.size(); ++k)
+  {
+    for (std::size_t i = 0; i < joint_names_.size(); ++i)
+    {
+      EXPECT_NEAR(ik_solutions[k].at(joint_names_[i]), expected_positions[k][i], 4 * IK_SEED_OFFSET);
+    }
+  }
+
+  // a pose that is always in self collision ends the solved sequence
+  rstate.setJointGroupPositions(jmg, std::vector<double>{ 0, 2.3, -2.3, 0, 0, 0 });
+  rstate.update();
+  poses.push_back(rstate.getFrameTransform(tcp_link_));
+  EXPECT_FALSE(pilz_industrial_motion_planner::computePoseSequenceIK(planning_scene_, planning_group_, tcp_link_, poses,
+                                                                     ik_seed, ik_solutions, true));
+  EXPECT_EQ(ik_solutions.size(), poses.size() - 1);
+
+  EXPECT_FALSE(pilz_industrial_motion_planner::computePoseSequenceIK(planning_scene_, "InvalidGroupName", tcp_link_,
+                                                                     poses, ik_seed, ik_solutions, false));
+  EXPECT_TRUE(ik_solutions.empty());
+}
+
 /**
  * @brief Check that function VerifySampleJointLimits() returns 'false' in case
  * of very small sample duration.
@@ -918,6 +975,111 @@ TEST_F(TrajectoryFunctionsTestFlangeAndGripper, testGenerateJointTrajectoryWithI
       joint_trajectory, error_code, check_self_collision));
 }
 
+/**
+ * @brief Check that the bisection search finds the same intersection points as
+ * the linear search, for a trajectory moving away from the sphere center.
+ */
+TEST_F(TrajectoryFunctionsTestFlangeAndGripper, testBisectionSearchIntersectionPoint)
+{
+  const moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup(planning_group_);
+  robot_trajectory::RobotTrajectoryPtr trajectory =
+      std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, planning_group_);
+  moveit::core::RobotState rstate(robot_model_);
+  for (std::size_t k = 0; k < 50; ++k)
+  {
+    rstate.setJointGroupPositions(jmg, std::vector<double>{ 0, 0.5 + 0.005 * static_cast<double>(k), -0.5, 0, 0.5, 0 });
+    rstate.update();
+    trajectory->addSuffixWayPoint(rstate, 0.1);
+  }
+
+  const Eigen::Vector3d first_position = trajectory->getFirstWayPoint().getFrameTransform(tcp_link_).translation();
+  const Eigen::Vector3d last_position = trajectory->getLastWayPoint().getFrameTransform(tcp_link_).translation();
+  const double length = (last_position - first_position).norm();
+  for (const double r : { 0.01 * length, 0.3 * length, 0.9 * length })
+  {
+    std::size_t linear_index, bisection_index;
+    ASSERT_TRUE(pilz_industrial_motion_planner::linearSearchIntersectionPoint(tcp_link_, first_position, r, trajectory,
+                                                                              false, linear_index));
+    ASSERT_TRUE(pilz_industrial_motion_planner::bisectionSearchIntersectionPoint(tcp_link_, first_position, r,
+                                                                                 trajectory, false, bisection_index));
+    EXPECT_EQ(bisection_index, linear_index);
+
+    ASSERT_TRUE(pilz_industrial_motion_planner::linearSearchIntersectionPoint(tcp_link_, last_position, r, trajectory,
+                                                                              true, linear_index));
+    ASSERT_TRUE(pilz_industrial_motion_planner::bisectionSearchIntersectionPoint(tcp_link_, last_position, r,
+                                                                                 trajectory, true, bisection_index));
+    EXPECT_EQ(bisection_index, linear_index);
+  }
+
+  // the sphere contains the whole trajectory
+  std::size_t index;
+  EXPECT_FALSE(pilz_industrial_motion_planner::bisectionSearchIntersectionPoint(tcp_link_, first_position, 2 * length,
+                                                                                trajectory, false, index));
+}
+
+/**
+ * @brief Check that the compiled limits of a group are ordered like its
+ * variables, and that the sample check by index agrees with the one by name.
+ */
+TEST_F(TrajectoryFunctionsTestFlangeAndGripper, testCompiledGroupLimits)
+{
+  pilz_industrial_motion_planner::JointLimitsContainer joint_limits;
+  pilz_industrial_motion_planner::JointLimit test_joint_limits;
+  test_joint_limits.has_velocity_limits = true;
+  for (std::size_t i = 0; i < joint_names_.size(); ++i)
+  {
+    test_joint_limits.max_velocity = 1.0 + static_cast<double>(i);
+    joint_limits.addLimit(joint_names_[i], test_joint_limits);
+  }
+  EXPECT_EQ(nullptr, joint_limits.getGroupLimits(planning_group_));
+
+  joint_limits.compileGroupLimits(*robot_model_);
+  const moveit::core::JointModelGroup* jmg = robot_model_->getJointModelGroup(planning_group_);
+  const pilz_industrial_motion_planner::JointLimitsContainer::GroupLimits* group_limits =
+      joint_limits.getGroupLimits(planning_group_);
+  ASSERT_NE(nullptr, group_limits);
+  ASSERT_EQ(jmg->getVariableCount(), group_limits->size());
+  for (const std::string& joint_name : joint_names_)
+  {
+    EXPECT_EQ(joint_limits.getLimit(joint_name).max_velocity,
+              group_limits->at(jmg->getVariableGroupIndex(joint_name)).max_velocity);
+  }
+
+  // adding a limit invalidates the compiled limits
+  joint_limits.addLimit("unknown_joint", test_joint_limits);
+  EXPECT_EQ(nullptr, joint_limits.getGroupLimits(planning_group_));
+
+  // the last joint moves too fast
+  std::map<std::string, double> position_last, velocity_last, position_current;
+  std::vector<double> positions_last, velocities_last, positions_current;
+  for (std::size_t i = 0; i < joint_names_.size(); ++i)
+  {
+    position_last[joint_names_[i]] = 0.0;
+    velocity_last[joint_names_[i]] = 0.0;
+    position_current[joint_names_[i]] = (i + 1 == joint_names_.size()) ? 1.5 * static_cast<double>(i + 1) : 0.1;
+  }
+  std::vector<std::string> names;
+  for (const auto& position : position_current)
+  {
+    names.push_back(position.first);
+    positions_last.push_back(position_last[position.first]);
+    velocities_last.push_back(velocity_last[position.first]);
+    positions_current.push_back(position.second);
+  }
+  const double duration = 1.0;
+  EXPECT_FALSE(pilz_industrial_motion_planner::verifySampleJointLimits(position_last, velocity_last, position_current,
+                                                                       duration, duration, joint_limits));
+  EXPECT_FALSE(pilz_industrial_motion_planner::verifySampleJointLimits(
+      names, positions_last, velocities_last, positions_current, duration, duration, joint_limits.getLimits(names)));
+
+  position_current[joint_names_.back()] = 0.1;
+  positions_current.assign(positions_current.size(), 0.1);
+  EXPECT_TRUE(pilz_industrial_motion_planner::verifySampleJointLimits(position_last, velocity_last, position_current,
+                                                                      duration, duration, joint_limits));
+  EXPECT_TRUE(pilz_industrial_motion_planner::verifySampleJointLimits(
+      names, positions_last, velocities_last, positions_current, duration, duration, joint_limits.getLimits(names)));
+}
+
 /**
  * @brief Check that function determineAndCheckSamplingTime() returns 'false' if
  * both of the needed vectors have an incorrect vector size.
@@ -624,6 +624,35 @@ TEST(ATrapTest, Test_Clone)
   delete vp_clone;
 }
 
+/**
+ * @brief Sampling several times at once gives the same values as Pos(), Vel()
+ * and Acc(), written to the strided buffers
+ */
+TEST(ATrapTest, Test_Sample)
+{
+  pilz_industrial_motion_planner::VelocityProfileATrap vp =
+      pilz_industrial_motion_planner::VelocityProfileATrap(4, 2, 1);
+  EXPECT_TRUE(vp.setProfileAllDurations(3, 35, 3.0, 4.0, 5.0));
+
+  const std::vector<double> times{ -1, 0, 2, 3, 5, 7, 9, 12, 13 };
+  const std::size_t stride = 2;
+  std::vector<double> positions(times.size() * stride, -1.0);
+  std::vector<double> velocities(times.size() * stride, -1.0);
+  std::vector<double> accelerations(times.size() * stride, -1.0);
+  vp.sample(times, positions.data(), velocities.data(), accelerations.data(), stride);
+
+  for (std::size_t k = 0; k < times.size(); ++k)
+  {
+    EXPECT_EQ(positions[k * stride], vp.Pos(times[k]));
+    EXPECT_EQ(velocities[k * stride], vp.Vel(times[k]));
+    EXPECT_EQ(accelerations[k * stride], vp.Acc(times[k]));
+    // the values in between belong to other profiles
+    EXPECT_EQ(positions[k * stride + 1], -1.0);
+    EXPECT_EQ(velocities[k * stride + 1], -1.0);
+    EXPECT_EQ(accelerations[k * stride + 1], -1.0);
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -39,10 +39,17 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 #include <Eigen/Geometry>
 
 #include <moveit/planning_scene/planning_scene.hpp>
 #include <moveit/kinematic_constraints/kinematic_constraint.hpp>
+#include <moveit/collision_distance_field/collision_detector_allocator_hybrid.hpp>
+#include <moveit/collision_distance_field/collision_env_hybrid.hpp>
 
 #include <stomp_moveit/stomp_moveit_task.hpp>
 #include <stomp_moveit/conversion_functions.hpp>
@@ -58,6 +65,8 @@ namespace costs
 // Interpolation step size for collision checking (joint space, L2 norm)
 constexpr double COL_CHECK_DISTANCE = 0.05;
 constexpr double CONSTRAINT_CHECK_DISTANCE = 0.05;
+// Coarser step for distance field checks, the required clearance covers the motion between samples
+constexpr double DISTANCE_FIELD_CHECK_DISTANCE = 0.1;
 
 /**
  * Creates a cost function from a robot state validation function.
@@ -185,6 +194,36 @@ CostFn getCostFunctionFromStateValidator(const StateValidatorFn& state_validator
   return cost_fn;
 }
 
+/**
+ * Creates a function that provides a separate robot state for each calling thread.
+ * The states are initialized from the current state of the planning scene when a thread requests one for the first
+ * time. This allows state validators to update their states while evaluating several rollouts concurrently.
+ *
+ * @param planning_scene    The planning scene providing the initial state values
+ *
+ * @return                  Function returning the robot state of the calling thread
+ */
+std::function<moveit::core::RobotState&()>
+getThreadStateFunction(const std::shared_ptr<const planning_scene::PlanningScene>& planning_scene)
+{
+  struct ThreadStates
+  {
+    std::mutex mutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<moveit::core::RobotState>> states;
+  };
+  auto thread_states = std::make_shared<ThreadStates>();
+
+  return [=]() -> moveit::core::RobotState& {
+    std::lock_guard<std::mutex> lock(thread_states->mutex);
+    auto& state = thread_states->states[std::this_thread::get_id()];
+    if (!state)
+    {
+      state = std::make_unique<moveit::core::RobotState>(planning_scene->getCurrentState());
+    }
+    return *state;
+  };
+}
+
 /**
  * Creates a cost function for binary collisions of group states in the planning scene.
  * This function uses a StateValidatorFn for computing smooth penalty costs from binary
@@ -201,9 +240,10 @@ CostFn getCollisionCostFunction(const std::shared_ptr<const planning_scene::Plan
 {
   const auto& joints = group ? group->getActiveJointModels() : planning_scene->getRobotModel()->getActiveJointModels();
   const auto& group_name = group ? group->getName() : "";
+  const auto get_state = getThreadStateFunction(planning_scene);
 
   StateValidatorFn collision_validator_fn = [=](const Eigen::VectorXd& positions) {
-    static moveit::core::RobotState state(planning_scene->getCurrentState());
+    moveit::core::RobotState& state = get_state();
 
     // Update robot state values
     setJointPositions(positions, joints, state);
@@ -215,6 +255,74 @@ CostFn getCollisionCostFunction(const std::shared_ptr<const planning_scene::Plan
   return getCostFunctionFromStateValidator(collision_validator_fn, COL_CHECK_DISTANCE);
 }
 
+/**
+ * Creates a cost function for collisions of group states that uses distance fields instead of exact collision checks.
+ * States are represented by the collision spheres of the distance field, self collisions are checked between spheres
+ * and the clearance to the world is looked up in the world distance field. States with less than the minimum clearance
+ * receive a penalty that grows linearly from 0 at the minimum clearance to the full penalty at contact.
+ * This is much cheaper than getCollisionCostFunction() and intended for evaluating noisy rollouts, while the optimized
+ * trajectory is still checked exactly. States outside of the distance field are checked exactly as well.
+ *
+ * The distance fields are generated for the planning scene when calling this function.
+ *
+ * @param planning_scene    The planning scene instance to use for collision checking
+ * @param group             The group to use for computing link transforms from joint positions
+ * @param collision_penalty The penalty cost value applied to colliding states
+ * @param min_clearance     The distance to the world below which states are penalized
+ *
+ * @return                  Cost function that computes smooth costs for path segments close to collisions
+ */
+CostFn getDistanceFieldCollisionCostFunction(const std::shared_ptr<const planning_scene::PlanningScene>& planning_scene,
+                                             const moveit::core::JointModelGroup* group, double collision_penalty,
+                                             double min_clearance)
+{
+  const auto& group_name = group ? group->getName() : "";
+  const auto& joints = group ? group->getActiveJointModels() : planning_scene->getRobotModel()->getActiveJointModels();
+
+  // Generate the distance fields of robot and world with a hybrid collision environment in a diff of the scene
+  std::shared_ptr<planning_scene::PlanningScene> distance_field_scene = planning_scene->diff();
+  distance_field_scene->allocateCollisionDetector(collision_detection::CollisionDetectorAllocatorHybrid::create());
+  const auto hybrid_env = std::dynamic_pointer_cast<const collision_detection::CollisionEnvHybrid>(
+      distance_field_scene->getCollisionEnv(collision_detection::CollisionDetectorAllocatorHybrid::NAME));
+  if (!hybrid_env || group_name.empty())
+  {
+    return getCollisionCostFunction(planning_scene, group, collision_penalty);
+  }
+  const auto world_distance_field = hybrid_env->getCollisionWorldDistanceField();
+  const auto get_state = getThreadStateFunction(planning_scene);
+
+  StateValidatorFn collision_validator_fn = [=](const Eigen::VectorXd& positions) {
+    moveit::core::RobotState& state = get_state();
+
+    // Update robot state values
+    setJointPositions(positions, joints, state);
+    state.update();
+
+    collision_detection::CollisionRequest request;
+    request.group_name = group_name;
+    collision_detection::CollisionResult result;
+    hybrid_env->checkSelfCollisionDistanceField(request, result, state,
+                                                distance_field_scene->getAllowedCollisionMatrix());
+    if (result.collision)
+    {
+      return collision_penalty;
+    }
+
+    double clearance;
+    if (!world_distance_field->getEnvironmentClearance(group_name, state, clearance))
+    {
+      return planning_scene->isStateColliding(state, group_name) ? collision_penalty : 0.0;
+    }
+    if (clearance >= min_clearance)
+    {
+      return 0.0;
+    }
+    return clearance <= 0.0 ? collision_penalty : collision_penalty * (min_clearance - clearance) / min_clearance;
+  };
+
+  return getCostFunctionFromStateValidator(collision_validator_fn, DISTANCE_FIELD_CHECK_DISTANCE);
+}
+
 /**
  * Creates a cost function for binary constraint checks applied to group states.
  * This function uses a StateValidatorFn for computing smooth penalty costs from binary
@@ -235,9 +343,10 @@ CostFn getConstraintsCostFunction(const std::shared_ptr<const planning_scene::Pl
 
   kinematic_constraints::KinematicConstraintSet constraints(planning_scene->getRobotModel());
   constraints.add(constraints_msg, planning_scene->getTransforms());
+  const auto get_state = getThreadStateFunction(planning_scene);
 
   StateValidatorFn constraints_validator_fn = [=](const Eigen::VectorXd& positions) {
-    static moveit::core::RobotState state(planning_scene->getCurrentState());
+    moveit::core::RobotState& state = get_state();
 
     // Update robot state values
     setJointPositions(positions, joints, state);
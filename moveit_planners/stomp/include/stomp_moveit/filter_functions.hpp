@@ -45,6 +45,8 @@
 
 #include <stomp/utils.h>
 
+#include <memory>
+
 namespace stomp_moveit
 {
 namespace filters
@@ -68,11 +70,13 @@ FilterFn simpleSmoothingMatrix(size_t num_timesteps)
   // adapter after solving the STOMP trajectory.
   Eigen::MatrixXd smoothing_matrix;
   stomp::generateSmoothingMatrix(num_timesteps, 1.0 /* dt */, smoothing_matrix);
+
+  // The smoothing matrix is dense, so all joint dimensions are filtered with a single matrix product.
+  // The input copy is kept in a buffer that is only allocated once.
+  auto unfiltered_values = std::make_shared<Eigen::MatrixXd>();
   return [=](const Eigen::MatrixXd& /*values*/, Eigen::MatrixXd& filtered_values) {
-    for (auto row : filtered_values.rowwise())
-    {
-      row.transpose() = smoothing_matrix * row.transpose();
-    }
+    *unfiltered_values = filtered_values;
+    filtered_values.noalias() = (*unfiltered_values) * smoothing_matrix.transpose();
     return true;
   };
 }
@@ -107,12 +111,14 @@ FilterFn enforcePositionBounds(const moveit::core::JointModelGroup* group)
  */
 FilterFn chain(const std::vector<FilterFn>& filter_functions)
 {
+  // Buffer for the intermediate filter results, reused for all calls
+  auto values_in = std::make_shared<Eigen::MatrixXd>();
   return [=](const Eigen::MatrixXd& values, Eigen::MatrixXd& filtered_values) {
-    Eigen::MatrixXd values_in = values;
+    *values_in = values;
     for (const auto& filter_fn : filter_functions)
     {
-      filter_fn(values_in, filtered_values);
-      values_in = filtered_values;
+      filter_fn(*values_in, filtered_values);
+      *values_in = filtered_values;
     }
     return true;
   };
@@ -40,9 +40,14 @@
 #pragma once
 
 #include <stomp_moveit/stomp_moveit_task.hpp>  // Function definitions
-#include <stomp_moveit/math/multivariate_gaussian.hpp>
+#include <Eigen/Cholesky>
 #include <Eigen/Geometry>
 
+#include <rsl/random.hpp>
+
+#include <memory>
+#include <random>
+
 namespace stomp_moveit
 {
 namespace noise
@@ -80,24 +85,29 @@ NoiseGeneratorFn getNormalDistributionGenerator(size_t num_timesteps, const std:
   covariance = covariance.fullPivLu().inverse();
   covariance /= covariance.array().abs().matrix().maxCoeff();
 
-  // create random generators
-  std::vector<math::MultivariateGaussianPtr> rand_generators(stddev.size());
-  for (auto& r : rand_generators)
-  {
-    r = std::make_shared<math::MultivariateGaussian>(Eigen::VectorXd::Zero(num_timesteps), covariance);
-  }
+  // All joints share the same covariance, so a single Cholesky factor is used for sampling the noise of all joints
+  const Eigen::MatrixXd covariance_cholesky = covariance.llt().matrixL();
+  const Eigen::ArrayXd stddev_values = Eigen::Map<const Eigen::ArrayXd>(stddev.data(), stddev.size());
 
-  auto raw_noise = std::make_shared<Eigen::VectorXd>(num_timesteps);
+  // Buffer for standard normal samples, one column per joint, allocated once for all iterations of a plan
+  auto raw_noise = std::make_shared<Eigen::MatrixXd>(num_timesteps, stddev.size());
+  auto normal_dist = std::make_shared<std::normal_distribution<double>>(0.0, 1.0);
   NoiseGeneratorFn noise_generator_fn = [=](const Eigen::MatrixXd& values, Eigen::MatrixXd& noisy_values,
                                             Eigen::MatrixXd& noise) {
-    for (int i = 0; i < values.rows(); ++i)
+    // Draw the samples of all joints in one pass and correlate them with a single triangular matrix product
+    raw_noise->resize(values.cols(), values.rows());
+    for (Eigen::Index i = 0; i < raw_noise->size(); ++i)
     {
-      rand_generators[i]->sample(*raw_noise);
-      raw_noise->head(1).setZero();
-      raw_noise->tail(1).setZero();  // zeroing out the start and end noise values
-      noise.row(i).transpose() = stddev.at(i) * (*raw_noise);
-      noisy_values.row(i) = values.row(i) + noise.row(i);
+      raw_noise->data()[i] = (*normal_dist)(rsl::rng());
     }
+    noise.resize(values.rows(), values.cols());
+    noise.transpose().noalias() = covariance_cholesky.triangularView<Eigen::Lower>() * (*raw_noise);
+
+    // zeroing out the start and end noise values
+    noise.col(0).setZero();
+    noise.col(noise.cols() - 1).setZero();
+    noise.array().colwise() *= stddev_values.head(values.rows());
+    noisy_values = values + noise;
     return true;
   };
   return noise_generator_fn;
@@ -54,6 +54,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include <stomp/task.h>
 
 namespace stomp_moveit
@@ -75,20 +85,63 @@ using DoneFn =
 //
 // The ComposableTask stores custom functions for the most important callback types in STOMP and applies them during
 // a motion planning run. This class is used for injecting MoveIt concepts and other custom features into STOMP.
+//
+// STOMP evaluates the costs of the noisy rollouts one after the other. With more than one thread, the costs of each
+// rollout are already computed by a worker thread as soon as the rollout is generated, so that all rollouts of an
+// iteration are evaluated concurrently. The cost function must support concurrent calls in that case.
 class ComposableTask final : public stomp::Task
 {
 public:
+  /**
+   * @brief Constructor
+   * @param num_threads The number of threads evaluating rollout costs, 0 for one per hardware thread. With a single
+   *                    thread, all costs are computed sequentially when STOMP requests them.
+   */
   ComposableTask(NoiseGeneratorFn noise_generator_fn, CostFn cost_fn, FilterFn filter_fn,
-                 PostIterationFn post_iteration_fn, DoneFn done_fn)
+                 PostIterationFn post_iteration_fn, DoneFn done_fn, std::size_t num_threads = 1)
     : noise_generator_fn_(std::move(noise_generator_fn))
     , cost_fn_(std::move(cost_fn))
+    , noisy_cost_fn_(cost_fn_)
     , filter_fn_(std::move(filter_fn))
     , post_iteration_fn_(std::move(post_iteration_fn))
     , done_fn_(std::move(done_fn))
   {
+    if (num_threads == 0)
+    {
+      num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (num_threads > 1)
+    {
+      workers_.reserve(num_threads);
+      for (std::size_t i = 0; i < num_threads; ++i)
+      {
+        workers_.emplace_back([this] { processJobs(); });
+      }
+    }
+  }
+
+  /**
+   * @brief Sets a separate cost function for the noisy rollouts, e.g. a cheaper approximation of the cost function used
+   * for the optimized trajectory. It must be set before planning, since worker threads may use it at any time after.
+   * @param noisy_cost_fn The cost function applied in computeNoisyCosts()
+   */
+  void setNoisyCostFunction(CostFn noisy_cost_fn)
+  {
+    noisy_cost_fn_ = std::move(noisy_cost_fn);
   }
 
-  ~ComposableTask() = default;
+  ~ComposableTask()
+  {
+    {
+      std::lock_guard<std::mutex> lock(jobs_mutex_);
+      stop_workers_ = true;
+    }
+    jobs_condition_.notify_all();
+    for (auto& worker : workers_)
+    {
+      worker.join();
+    }
+  }
 
   /**
    * @brief Generates a noisy trajectory from the parameters.
@@ -102,10 +155,30 @@ public:
    * @return True if cost were properly computed, otherwise false
    */
   bool generateNoisyParameters(const Eigen::MatrixXd& parameters, std::size_t /*start_timestep*/,
-                               std::size_t /*num_timesteps*/, int /*iteration_number*/, int /*rollout_number*/,
+                               std::size_t /*num_timesteps*/, int /*iteration_number*/, int rollout_number,
                                Eigen::MatrixXd& parameters_noise, Eigen::MatrixXd& noise) override
   {
-    return noise_generator_fn_(parameters, parameters_noise, noise);
+    if (!noise_generator_fn_(parameters, parameters_noise, noise))
+    {
+      return false;
+    }
+
+    // Start evaluating the new rollout in the background, computeNoisyCosts() picks up the result
+    if (!workers_.empty())
+    {
+      auto rollout = std::make_shared<RolloutCosts>();
+      rollout->values = parameters_noise;
+      std::packaged_task<bool()> job(
+          [this, rollout] { return noisy_cost_fn_(rollout->values, rollout->costs, rollout->validity); });
+      rollout->result = job.get_future();
+      {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        jobs_.push_back(std::move(job));
+      }
+      jobs_condition_.notify_one();
+      pending_rollouts_[rollout_number] = std::move(rollout);
+    }
+    return true;
   }
 
   /**
@@ -136,10 +209,25 @@ public:
    * @return True if cost were properly computed, otherwise false
    */
   bool computeNoisyCosts(const Eigen::MatrixXd& parameters, std::size_t /*start_timestep*/,
-                         std::size_t /*num_timesteps*/, int /*iteration_number*/, int /*rollout_number*/,
+                         std::size_t /*num_timesteps*/, int /*iteration_number*/, int rollout_number,
                          Eigen::VectorXd& costs, bool& validity) override
   {
-    return cost_fn_(parameters, costs, validity);
+    // Use the costs computed in the background if the rollout hasn't changed since it was generated
+    const auto it = pending_rollouts_.find(rollout_number);
+    if (it != pending_rollouts_.end())
+    {
+      const auto rollout = std::move(it->second);
+      pending_rollouts_.erase(it);
+      const bool success = rollout->result.get();
+      if (rollout->values.rows() == parameters.rows() && rollout->values.cols() == parameters.cols() &&
+          rollout->values == parameters)
+      {
+        costs = rollout->costs;
+        validity = rollout->validity;
+        return success;
+      }
+    }
+    return noisy_cost_fn_(parameters, costs, validity);
   }
 
   /**
@@ -188,10 +276,49 @@ public:
   }
 
 private:
+  // @brief A rollout whose costs are being computed by a worker thread
+  struct RolloutCosts
+  {
+    Eigen::MatrixXd values;
+    Eigen::VectorXd costs;
+    bool validity = false;
+    std::future<bool> result;
+  };
+
+  // @brief Worker thread loop running queued cost evaluations until the task is destroyed
+  void processJobs()
+  {
+    while (true)
+    {
+      std::packaged_task<bool()> job;
+      {
+        std::unique_lock<std::mutex> lock(jobs_mutex_);
+        jobs_condition_.wait(lock, [this] { return stop_workers_ || !jobs_.empty(); });
+        if (jobs_.empty())
+        {
+          return;
+        }
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+      }
+      job();
+    }
+  }
+
   NoiseGeneratorFn noise_generator_fn_;
   CostFn cost_fn_;
+  CostFn noisy_cost_fn_;
   FilterFn filter_fn_;
   PostIterationFn post_iteration_fn_;
   DoneFn done_fn_;
+
+  // Rollouts that were generated but whose costs haven't been requested yet, by rollout number
+  std::unordered_map<int, std::shared_ptr<RolloutCosts>> pending_rollouts_;
+
+  std::deque<std::packaged_task<bool()>> jobs_;
+  std::mutex jobs_mutex_;
+  std::condition_variable jobs_condition_;
+  bool stop_workers_ = false;
+  std::vector<std::thread> workers_;
 };
 }  // namespace stomp_moveit
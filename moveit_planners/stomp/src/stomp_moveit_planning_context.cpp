@@ -144,7 +144,8 @@ bool extractSeedTrajectory(const planning_interface::MotionPlanRequest& req,
 }
 
 // @brief Build a STOMP task that uses MoveIt callback types for planning in STOMP
-stomp::TaskPtr createStompTask(const stomp::StompConfiguration& config, StompPlanningContext& context)
+stomp::TaskPtr createStompTask(const stomp::StompConfiguration& config, StompPlanningContext& context,
+                               const stomp_moveit::Params& params)
 {
   const size_t num_timesteps = config.num_timesteps;
   const auto planning_scene = context.getPlanningScene();
@@ -159,16 +160,19 @@ stomp::TaskPtr createStompTask(const stomp::StompConfiguration& config, StompPla
   // Cost, noise and filter functions are provided for planning.
   // TODO(henningkayser): parameterize cost penalties
   using namespace stomp_moveit;
-  CostFn cost_fn;
-  if (!constraints.empty())
+  CostFn cost_fn = costs::getCollisionCostFunction(planning_scene, group, 1.0 /* collision penalty */);
+  CostFn noisy_cost_fn = cost_fn;
+  if (params.rollout_collision_cost == "distance_field")
   {
-    cost_fn = costs::sum({ costs::getCollisionCostFunction(planning_scene, group, 1.0 /* collision penalty */),
-                           costs::getConstraintsCostFunction(planning_scene, group, constraints.getAllConstraints(),
-                                                             1.0 /* constraint penalty */) });
+    noisy_cost_fn = costs::getDistanceFieldCollisionCostFunction(planning_scene, group, 1.0 /* collision penalty */,
+                                                                 params.rollout_min_clearance);
   }
-  else
+  if (!constraints.empty())
   {
-    cost_fn = costs::getCollisionCostFunction(planning_scene, group, 1.0 /* collision penalty */);
+    const auto constraints_cost_fn = costs::getConstraintsCostFunction(
+        planning_scene, group, constraints.getAllConstraints(), 1.0 /* constraint penalty */);
+    cost_fn = costs::sum({ cost_fn, constraints_cost_fn });
+    noisy_cost_fn = costs::sum({ noisy_cost_fn, constraints_cost_fn });
   }
 
   // TODO(henningkayser): parameterize stddev
@@ -182,8 +186,10 @@ stomp::TaskPtr createStompTask(const stomp::StompConfiguration& config, StompPla
       visualization::getSuccessTrajectoryPublisher(context.getPathPublisher(), planning_scene, group);
 
   // Initialize and return STOMP task
-  stomp::TaskPtr task =
-      std::make_shared<ComposableTask>(noise_generator_fn, cost_fn, filter_fn, iteration_callback_fn, done_callback_fn);
+  auto task = std::make_shared<ComposableTask>(noise_generator_fn, cost_fn, filter_fn, iteration_callback_fn,
+                                               done_callback_fn, params.num_threads);
+  // The optimized trajectory is always checked with the exact cost function, which decides its validity
+  task->setNoisyCostFunction(noisy_cost_fn);
   return task;
 }
 
@@ -241,7 +247,7 @@ void StompPlanningContext::solve(planning_interface::MotionPlanResponse& res)
   {
     config.num_timesteps = input_trajectory->size();
   }
-  const auto task = createStompTask(config, *this);
+  const auto task = createStompTask(config, *this, params_);
   stomp_ = std::make_shared<stomp::Stomp>(config, task);
 
   std::condition_variable cv;
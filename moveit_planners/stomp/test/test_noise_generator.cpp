@@ -69,6 +69,27 @@ TEST(NoiseGeneratorTest, testStartEndUnchanged)
   EXPECT_EQ(VALUES.col(TIMESTEPS - 1), noisy_values.col(TIMESTEPS - 1));
 }
 
+TEST(NoiseGeneratorTest, testStddevPerJoint)
+{
+  // Joints without standard deviation must not receive any noise
+  std::vector<double> stddev = STDDEV;
+  stddev[1] = 0.0;
+  auto noise_gen = stomp_moveit::noise::getNormalDistributionGenerator(TIMESTEPS, stddev);
+
+  auto noise = NOISE;
+  auto noisy_values = NOISY_VALUES;
+  noise_gen(VALUES, noisy_values, noise);
+  EXPECT_TRUE(noise.row(1).isZero());
+  EXPECT_EQ(noisy_values.row(1), VALUES.row(1));
+  EXPECT_FALSE(noise.row(0).isZero());
+
+  // Joints are sampled independently, and every call samples new noise
+  EXPECT_NE(noise.row(0), noise.row(2));
+  const auto previous_noise = noise;
+  noise_gen(VALUES, noisy_values, noise);
+  EXPECT_NE(noise, previous_noise);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
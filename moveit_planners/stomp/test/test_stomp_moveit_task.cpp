@@ -0,0 +1,148 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/** @file
+ * @brief Tests for the concurrent rollout cost evaluation of the ComposableTask
+ */
+
+#include <gtest/gtest.h>
+#include <stomp_moveit/cost_functions.hpp>
+#include <stomp_moveit/stomp_moveit_task.hpp>
+
+#include <atomic>
+
+constexpr size_t TIMESTEPS = 50;
+constexpr size_t VARIABLES = 6;
+constexpr int ROLLOUTS = 10;
+
+namespace
+{
+// Noise generator adding a constant offset that is different for each generated rollout
+stomp_moveit::NoiseGeneratorFn getOffsetGenerator()
+{
+  auto offset = std::make_shared<double>(0.0);
+  return [offset](const Eigen::MatrixXd& values, Eigen::MatrixXd& noisy_values, Eigen::MatrixXd& noise) {
+    *offset += 0.1;
+    noise = Eigen::MatrixXd::Constant(values.rows(), values.cols(), *offset);
+    noisy_values = values + noise;
+    return true;
+  };
+}
+
+// Cost function tagging all waypoints whose first joint value exceeds 0.55 as invalid
+stomp_moveit::CostFn getThresholdCostFunction(std::atomic<int>& num_calls)
+{
+  auto state_validator_fn = [](const Eigen::VectorXd& state_positions) {
+    return state_positions(0) > 0.55 ? 1.0 : 0.0;
+  };
+  auto cost_fn = stomp_moveit::costs::getCostFunctionFromStateValidator(state_validator_fn, 0.0);
+  return [cost_fn, &num_calls](const Eigen::MatrixXd& values, Eigen::VectorXd& costs, bool& validity) {
+    ++num_calls;
+    return cost_fn(values, costs, validity);
+  };
+}
+
+stomp_moveit::ComposableTask createTask(std::atomic<int>& num_calls, std::size_t num_threads)
+{
+  return stomp_moveit::ComposableTask(
+      getOffsetGenerator(), getThresholdCostFunction(num_calls),
+      [](const Eigen::MatrixXd& /*values*/, Eigen::MatrixXd& /*filtered_values*/) { return true; },
+      [](int /*iteration_number*/, double /*cost*/, const Eigen::MatrixXd& /*values*/) {},
+      [](bool /*success*/, int /*total_iterations*/, double /*final_cost*/, const Eigen::MatrixXd& /*values*/) {},
+      num_threads);
+}
+}  // namespace
+
+TEST(ComposableTaskTest, testConcurrentRolloutCosts)
+{
+  // GIVEN a sequential and a concurrent task with the same noise generator and cost function
+  std::atomic<int> sequential_calls{ 0 };
+  std::atomic<int> concurrent_calls{ 0 };
+  auto sequential_task = createTask(sequential_calls, 1);
+  auto concurrent_task = createTask(concurrent_calls, 4);
+  const Eigen::MatrixXd values = Eigen::MatrixXd::Zero(VARIABLES, TIMESTEPS);
+
+  // WHEN all rollouts of an iteration are generated before their costs are computed
+  std::vector<Eigen::MatrixXd> sequential_rollouts(ROLLOUTS), concurrent_rollouts(ROLLOUTS);
+  Eigen::MatrixXd noise;
+  for (int r = 0; r < ROLLOUTS; ++r)
+  {
+    ASSERT_TRUE(sequential_task.generateNoisyParameters(values, 0, TIMESTEPS, 0, r, sequential_rollouts[r], noise));
+    ASSERT_TRUE(concurrent_task.generateNoisyParameters(values, 0, TIMESTEPS, 0, r, concurrent_rollouts[r], noise));
+  }
+
+  // THEN both tasks compute the same costs and validity for each rollout
+  for (int r = 0; r < ROLLOUTS; ++r)
+  {
+    Eigen::VectorXd sequential_costs, concurrent_costs;
+    bool sequential_validity, concurrent_validity;
+    ASSERT_TRUE(sequential_task.computeNoisyCosts(sequential_rollouts[r], 0, TIMESTEPS, 0, r, sequential_costs,
+                                                  sequential_validity));
+    ASSERT_TRUE(concurrent_task.computeNoisyCosts(concurrent_rollouts[r], 0, TIMESTEPS, 0, r, concurrent_costs,
+                                                  concurrent_validity));
+    EXPECT_EQ(sequential_costs, concurrent_costs);
+    EXPECT_EQ(sequential_validity, concurrent_validity);
+    EXPECT_EQ(concurrent_validity, r < 5);
+  }
+
+  // THEN the concurrent task evaluated each rollout exactly once
+  EXPECT_EQ(sequential_calls, ROLLOUTS);
+  EXPECT_EQ(concurrent_calls, ROLLOUTS);
+}
+
+TEST(ComposableTaskTest, testModifiedRolloutIsReevaluated)
+{
+  // GIVEN a concurrent task that started evaluating a generated rollout
+  std::atomic<int> num_calls{ 0 };
+  auto task = createTask(num_calls, 2);
+  const Eigen::MatrixXd values = Eigen::MatrixXd::Zero(VARIABLES, TIMESTEPS);
+  Eigen::MatrixXd rollout, noise;
+  ASSERT_TRUE(task.generateNoisyParameters(values, 0, TIMESTEPS, 0, 0, rollout, noise));
+
+  // WHEN the rollout is modified before its costs are requested
+  rollout.row(0).setConstant(1.0);
+  Eigen::VectorXd costs;
+  bool validity = true;
+  ASSERT_TRUE(task.computeNoisyCosts(rollout, 0, TIMESTEPS, 0, 0, costs, validity));
+
+  // THEN the costs are computed for the modified rollout
+  EXPECT_FALSE(validity);
+  EXPECT_EQ(num_calls, 2);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -51,11 +51,22 @@
 #include <rclcpp/node.hpp>
 #include <rclcpp/parameter_value.hpp>
 #include <rclcpp/time.hpp>
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <moveit/utils/logger.hpp>
 
+// The activity topic of the controller manager is not available in all active distros.
+#if __has_include(<controller_manager_msgs/msg/controller_manager_activity.hpp>)
+#include <controller_manager_msgs/msg/controller_manager_activity.hpp>
+#define MOVEIT_HAS_CONTROLLER_MANAGER_ACTIVITY 1
+#else
+#define MOVEIT_HAS_CONTROLLER_MANAGER_ACTIVITY 0
+#endif
+
 static const rclcpp::Duration CONTROLLER_INFORMATION_VALIDITY_AGE = rclcpp::Duration::from_seconds(1.0);
 static const double SERVICE_CALL_TIMEOUT = 1.0;
 
@@ -108,10 +119,25 @@ class Ros2ControlManager : public moveit_controller_manager::MoveItControllerMan
   typedef std::map<std::string, moveit_controller_manager::MoveItControllerHandlePtr> HandleMap;
   HandleMap handles_;
 
+  /** @brief States of all controllers of the controller manager, as reported by list_controllers. */
+  std::unordered_map<std::string /* controller name */, std::string /* state */> controller_states_;
+
+  /** @brief Time the last list_controllers request was sent. */
   rclcpp::Time controllers_stamp_{ 0, 0, RCL_ROS_TIME };
+  /** @brief Whether a list_controllers response was applied yet. */
+  bool controllers_listed_ = false;
+
+  /** @brief Response to a list_controllers request that was sent but not yet applied. */
+  std::optional<rclcpp::Client<controller_manager_msgs::srv::ListControllers>::FutureAndRequestId> pending_list_;
+
+  /** @brief Number of received activity messages when the pending list_controllers request was sent. */
+  std::size_t list_activity_count_ = 0;
+  /** @brief Number of received activity messages known to agree with the cached controller states. */
+  std::size_t verified_activity_count_ = 0;
 
   /**
-   * @brief Protects access to managed_controllers_, active_controllers_, allocators_, handles_, and controllers_stamp.
+   * @brief Protects access to managed_controllers_, active_controllers_, allocators_, handles_, controller_states_,
+   * controllers_stamp_, pending_list_ and the activity counts above.
    */
   std::mutex controllers_mutex_;
 
@@ -119,6 +145,14 @@ class Ros2ControlManager : public moveit_controller_manager::MoveItControllerMan
   rclcpp::Client<controller_manager_msgs::srv::ListControllers>::SharedPtr list_controllers_service_;
   rclcpp::Client<controller_manager_msgs::srv::SwitchController>::SharedPtr switch_controller_service_;
 
+#if MOVEIT_HAS_CONTROLLER_MANAGER_ACTIVITY
+  // Controller state changes are published on the activity topic, the cached controller information is only
+  // refreshed when they disagree with it. Written from the executor, hence not protected by controllers_mutex_.
+  rclcpp::Subscription<controller_manager_msgs::msg::ControllerManagerActivity>::SharedPtr activity_subscription_;
+  std::shared_ptr<const controller_manager_msgs::msg::ControllerManagerActivity> activity_;
+  std::atomic<std::size_t> activity_count_{ 0 };
+#endif
+
   // Chained controllers have dependencies (other controllers which must be running)
   std::unordered_map<std::string /* controller name */, std::vector<std::string> /* dependencies */> dependency_map_;
 
@@ -132,26 +166,98 @@ class Ros2ControlManager : public moveit_controller_manager::MoveItControllerMan
     return s.state == std::string("active");
   }
 
+  /**
+   * \brief Check if the controller manager publishes its activity, controllers_mutex_ must be locked externally
+   * @return true if the cached controller information is refreshed on activity instead of periodically
+   */
+  bool hasActivityFeed() const
+  {
+#if MOVEIT_HAS_CONTROLLER_MANAGER_ACTIVITY
+    return activity_subscription_ && activity_subscription_->get_publisher_count() > 0;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * \brief Check if the cached controller information needs to be refreshed, controllers_mutex_ must be locked
+   * externally.
+   * With an activity feed, it is outdated if the latest reported controller states differ from the cached ones.
+   * Otherwise it is throttled down to 1 Hz.
+   * @return true if list_controllers needs to be called
+   */
+  bool isOutdated()
+  {
+    if (!controllers_listed_)
+      return true;
+#if MOVEIT_HAS_CONTROLLER_MANAGER_ACTIVITY
+    if (hasActivityFeed())
+    {
+      // activity_ is stored before the count is incremented, so it is at least as new as activity_count
+      const std::size_t activity_count = activity_count_;
+      if (activity_count == verified_activity_count_)
+        return false;
+      const auto activity = std::atomic_load(&activity_);
+      if (activity->controllers.size() != controller_states_.size())
+        return true;
+      for (const auto& controller : activity->controllers)
+      {
+        const auto it = controller_states_.find(controller.name);
+        if (it == controller_states_.end() || it->second != controller.state.label)
+          return true;
+      }
+      verified_activity_count_ = activity_count;
+      return false;
+    }
+#endif
+    return (node_->now() - controllers_stamp_) >= CONTROLLER_INFORMATION_VALIDITY_AGE;
+  }
+
+  /**
+   * \brief Send a list_controllers request without waiting for the response, unless one is pending already.
+   * controllers_mutex_ must be locked externally
+   */
+  void requestControllers()
+  {
+    if (pending_list_)
+      return;
+
+    controllers_stamp_ = node_->now();
+#if MOVEIT_HAS_CONTROLLER_MANAGER_ACTIVITY
+    list_activity_count_ = activity_count_;
+#endif
+    auto request = std::make_shared<controller_manager_msgs::srv::ListControllers::Request>();
+    pending_list_.emplace(list_controllers_service_->async_send_request(request));
+  }
+
   /**
    * \brief  Call list_controllers and populate managed_controllers_ and active_controllers_. Allocates handles if
    * needed.
-   * Throttled down to 1 Hz, controllers_mutex_ must be locked externally
+   * Skipped while the cached information is up to date (see isOutdated()), controllers_mutex_ must be locked externally
    * @param force force rediscover
    */
   void discover(bool force = false)
   {
-    // Skip if controller stamp is too new for new discovery, enforce update if force==true
-    if (!force && ((node_->now() - controllers_stamp_) < CONTROLLER_INFORMATION_VALIDITY_AGE))
+    // A prefetched response is only used while it is new enough
+    if (pending_list_ && (node_->now() - controllers_stamp_) >= CONTROLLER_INFORMATION_VALIDITY_AGE)
     {
-      return;
+      list_controllers_service_->remove_pending_request(pending_list_->request_id);
+      pending_list_.reset();
     }
 
-    controllers_stamp_ = node_->now();
+    // Skip if cached controller information is up to date, enforce update if force==true
+    if (!force && !pending_list_ && !isOutdated())
+    {
+      return;
+    }
 
-    auto request = std::make_shared<controller_manager_msgs::srv::ListControllers::Request>();
-    auto result_future = list_controllers_service_->async_send_request(request);
-    if (result_future.wait_for(std::chrono::duration<double>(SERVICE_CALL_TIMEOUT)) == std::future_status::timeout)
+    requestControllers();
+    auto result_future = std::move(*pending_list_);
+    pending_list_.reset();
+    if (result_future.future.wait_for(std::chrono::duration<double>(SERVICE_CALL_TIMEOUT)) ==
+        std::future_status::timeout)
     {
+      list_controllers_service_->remove_pending_request(result_future.request_id);
       RCLCPP_WARN_STREAM(getLogger(), "Failed to read controllers from "
                                           << list_controllers_service_->get_service_name() << " within "
                                           << SERVICE_CALL_TIMEOUT << " seconds");
@@ -160,15 +266,20 @@ class Ros2ControlManager : public moveit_controller_manager::MoveItControllerMan
 
     managed_controllers_.clear();
     active_controllers_.clear();
+    controller_states_.clear();
 
-    auto result = result_future.get();
+    auto result = result_future.future.get();
     if (!Ros2ControlManager::fixChainedControllers(result))
     {
       return;
     }
+    controllers_listed_ = true;
+    verified_activity_count_ = list_activity_count_;
 
     for (const controller_manager_msgs::msg::ControllerState& controller : result->controller)
     {
+      controller_states_[controller.name] = controller.state;
+
       // If the controller is active, add it to the map of active controllers.
       if (isActive(controller))
       {
@@ -232,6 +343,35 @@ class Ros2ControlManager : public moveit_controller_manager::MoveItControllerMan
     }
   }
 
+  /**
+   * \brief Apply a successful switch to the cached controller information, so that it does not need to be listed
+   * again. controllers_mutex_ must be locked externally
+   * @param request the switch request
+   */
+  void applySwitch(const controller_manager_msgs::srv::SwitchController::Request& request)
+  {
+    for (const std::string& name : request.deactivate_controllers)
+    {
+      active_controllers_.erase(name);
+      controller_states_[name] = "inactive";
+      ControllersMap::iterator it = managed_controllers_.find(getAbsName(name));
+      if (it != managed_controllers_.end())
+        it->second.state = "inactive";
+    }
+    for (const std::string& name : request.activate_controllers)
+    {
+      controller_states_[name] = "active";
+      ControllersMap::iterator it = managed_controllers_.find(getAbsName(name));
+      if (it != managed_controllers_.end())
+      {
+        it->second.state = "active";
+        // required interfaces are stored as joint names already, like the claimed ones of active controllers
+        controller_manager_msgs::msg::ControllerState& active = active_controllers_[name] = it->second;
+        active.claimed_interfaces = active.required_command_interfaces;
+      }
+    }
+  }
+
   /**
    * \brief Get fully qualified name
    * @param name name to be resolved to an absolute name
@@ -280,10 +420,31 @@ public:
         getAbsName("controller_manager/list_controllers"));
     switch_controller_service_ = node_->create_client<controller_manager_msgs::srv::SwitchController>(
         getAbsName("controller_manager/switch_controller"));
+#if MOVEIT_HAS_CONTROLLER_MANAGER_ACTIVITY
+    activity_subscription_ = node_->create_subscription<controller_manager_msgs::msg::ControllerManagerActivity>(
+        getAbsName("controller_manager/activity"), rclcpp::QoS(1).reliable(),
+        [this](const controller_manager_msgs::msg::ControllerManagerActivity::ConstSharedPtr& msg) {
+          std::atomic_store(&activity_, msg);
+          ++activity_count_;
+        });
+#endif
+
+    // don't wait for the controllers here, so that several controller managers can be discovered concurrently
+    std::scoped_lock<std::mutex> lock(controllers_mutex_);
+    requestControllers();
+  }
 
+  /**
+   * \brief Send a list_controllers request if the cached controller information is outdated, without waiting for the
+   * response. The next query uses it, which allows refreshing several controller managers concurrently.
+   */
+  void prefetchControllers()
+  {
     std::scoped_lock<std::mutex> lock(controllers_mutex_);
-    discover(true);
+    if (!pending_list_ && isOutdated())
+      requestControllers();
   }
+
   /**
    * \brief Find and return the pre-allocated handle for the given controller.
    * @param name
@@ -292,6 +453,8 @@ public:
   moveit_controller_manager::MoveItControllerHandlePtr getControllerHandle(const std::string& name) override
   {
     std::scoped_lock<std::mutex> lock(controllers_mutex_);
+    if (!controllers_listed_)
+      discover();
     HandleMap::iterator it = handles_.find(name);
     if (it != handles_.end())
     {  // controller is manager by this interface
@@ -341,6 +504,8 @@ public:
   void getControllerJoints(const std::string& name, std::vector<std::string>& joints) override
   {
     std::scoped_lock<std::mutex> lock(controllers_mutex_);
+    if (!controllers_listed_)
+      discover();
     ControllersMap::iterator it = managed_controllers_.find(name);
     if (it != managed_controllers_.end())
     {
@@ -370,6 +535,13 @@ public:
     return c;
   }
 
+  /** \brief A switch request sent by requestSwitch(), whose response is awaited by finishSwitch() */
+  struct PendingSwitch
+  {
+    controller_manager_msgs::srv::SwitchController::Request::SharedPtr request;
+    std::optional<rclcpp::Client<controller_manager_msgs::srv::SwitchController>::FutureAndRequestId> response;
+  };
+
   /**
    * \brief Filter lists for managed controller and computes switching set.
    * Stopped list might be extended by unsupported controllers that claim needed resources
@@ -379,6 +551,21 @@ public:
    */
   bool switchControllers(const std::vector<std::string>& activate_base,
                          const std::vector<std::string>& deactivate_base) override
+  {
+    PendingSwitch pending = requestSwitch(activate_base, deactivate_base);
+    return finishSwitch(pending, std::chrono::steady_clock::now() +
+                                     std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(SERVICE_CALL_TIMEOUT)));
+  }
+
+  /**
+   * \brief Compute the switching set like switchControllers() and send it without waiting for the response
+   * @param activate vector of controllers to be activated
+   * @param deactivate vector of controllers to be deactivated
+   * @return the pending switch, without request if there is nothing to switch
+   */
+  PendingSwitch requestSwitch(const std::vector<std::string>& activate_base,
+                              const std::vector<std::string>& deactivate_base)
   {
     // add controller dependencies
     std::vector<std::string> activate = activate_base;
@@ -401,8 +588,9 @@ public:
     // activation dependencies must be started first, but they are processed last, so the order needs to be flipped
     std::reverse(activate.begin(), activate.end());
 
+    // the cached information is only trusted if the controller manager reports state changes on its activity topic
     std::scoped_lock<std::mutex> lock(controllers_mutex_);
-    discover(true);
+    discover(!hasActivityFeed());
 
     // Holds the list of controllers that are currently active and their resources
     // Example:
@@ -475,20 +663,42 @@ public:
     // successfully activated or deactivated.
     request->strictness = controller_manager_msgs::srv::SwitchController::Request::STRICT;
 
+    PendingSwitch pending;
     if (!request->activate_controllers.empty() || !request->deactivate_controllers.empty())
     {  // something to switch?
-      auto result_future = switch_controller_service_->async_send_request(request);
-      if (result_future.wait_for(std::chrono::duration<double>(SERVICE_CALL_TIMEOUT)) == std::future_status::timeout)
-      {
-        RCLCPP_ERROR_STREAM(getLogger(), "Couldn't switch controllers at "
-                                             << switch_controller_service_->get_service_name() << " within "
-                                             << SERVICE_CALL_TIMEOUT << " seconds");
-        return false;
-      }
-      discover(true);
-      return result_future.get()->ok;
+      pending.request = request;
+      pending.response.emplace(switch_controller_service_->async_send_request(request));
     }
-    return true;
+    return pending;
+  }
+
+  /**
+   * \brief Wait for the response to a switch sent by requestSwitch() and update the cached controller information
+   * @param pending the pending switch
+   * @param deadline time until which to wait for the response
+   * @return true if switching succeeded
+   */
+  bool finishSwitch(PendingSwitch& pending, const std::chrono::steady_clock::time_point& deadline)
+  {
+    if (!pending.request)
+      return true;  // nothing to switch
+
+    if (pending.response->future.wait_until(deadline) == std::future_status::timeout)
+    {
+      switch_controller_service_->remove_pending_request(pending.response->request_id);
+      RCLCPP_ERROR_STREAM(getLogger(), "Couldn't switch controllers at "
+                                           << switch_controller_service_->get_service_name() << " within "
+                                           << SERVICE_CALL_TIMEOUT << " seconds");
+      return false;
+    }
+
+    const bool ok = pending.response->future.get()->ok;
+    std::scoped_lock<std::mutex> lock(controllers_mutex_);
+    if (ok)
+      applySwitch(*pending.request);  // a strict switch either changes all requested controllers or none
+    else
+      controllers_listed_ = false;  // list again on the next query
+    return ok;
   }
   /**
    * \brief fixChainedControllers modifies ListControllers service response if it contains chained controllers.
@@ -575,6 +785,19 @@ class Ros2ControlMultiManager : public moveit_controller_manager::MoveItControll
     }
   }
 
+  /**
+   * \brief Send list_controllers requests to all outdated interfaces at once, so that the following queries don't
+   * wait for the responses one after the other
+   */
+  void prefetchControllers()
+  {
+    for (std::pair<const std::string, moveit_ros_control_interface::Ros2ControlManagerPtr>& controller_manager :
+         controller_managers_)
+    {
+      controller_manager.second->prefetchControllers();
+    }
+  }
+
   /**
    * \brief Get namespace (including leading and trailing slashes) from controller name
    * @param name
@@ -615,6 +838,7 @@ public:
   {
     std::unique_lock<std::mutex> lock(controller_managers_mutex_);
     discover();
+    prefetchControllers();
 
     for (std::pair<const std::string, moveit_ros_control_interface::Ros2ControlManagerPtr>& controller_manager :
          controller_managers_)
@@ -631,6 +855,7 @@ public:
   {
     std::unique_lock<std::mutex> lock(controller_managers_mutex_);
     discover();
+    prefetchControllers();
 
     for (std::pair<const std::string, moveit_ros_control_interface::Ros2ControlManagerPtr>& controller_manager :
          controller_managers_)
@@ -675,22 +900,35 @@ public:
   }
 
   /**
-   * \brief delegates switch to all known interfaces. Stops on first failing switch.
+   * \brief delegates switch to all known interfaces. The switches are sent to all interfaces before waiting for any
+   * response, so they overlap and share one timeout.
    * @param activate vector of controllers to be activated
    * @param deactivate vector of controllers to be deactivated
-   * @return true if switching succeeded
+   * @return true if all switches succeeded
    */
   bool switchControllers(const std::vector<std::string>& activate, const std::vector<std::string>& deactivate) override
   {
     std::unique_lock<std::mutex> lock(controller_managers_mutex_);
 
+    std::vector<std::pair<Ros2ControlManager*, Ros2ControlManager::PendingSwitch>> pending_switches;
+    pending_switches.reserve(controller_managers_.size());
     for (std::pair<const std::string, moveit_ros_control_interface::Ros2ControlManagerPtr>& controller_manager :
          controller_managers_)
     {
-      if (!controller_manager.second->switchControllers(activate, deactivate))
-        return false;
+      pending_switches.emplace_back(controller_manager.second.get(),
+                                    controller_manager.second->requestSwitch(activate, deactivate));
     }
-    return true;
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(SERVICE_CALL_TIMEOUT));
+    bool ok = true;
+    for (auto& [controller_manager, pending_switch] : pending_switches)
+    {
+      if (!controller_manager->finishSwitch(pending_switch, deadline))
+        ok = false;
+    }
+    return ok;
   }
 };
 
@@ -0,0 +1,101 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit_simple_controller_manager/action_based_controller_handle.hpp>
+#include <trajectory_msgs/msg/joint_trajectory.hpp>
+#include <condition_variable>
+#include <mutex>
+
+namespace moveit_simple_controller_manager
+{
+/*
+ * Streams trajectories to a controller through its trajectory topic, e.g. the joint_trajectory topic of the
+ * joint_trajectory_controller, instead of sending action goals.
+ * A new trajectory replaces the executed one from its start time on, so trajectories can be updated while they are
+ * executed without canceling a goal and waiting for action round trips. Since the topic provides no result, execution
+ * is considered done once the duration of the last trajectory has passed.
+ */
+class JointTrajectoryStreamControllerHandle : public ActionBasedControllerHandleBase
+{
+public:
+  JointTrajectoryStreamControllerHandle(const rclcpp::Node::SharedPtr& node, const std::string& name,
+                                        const std::string& topic);
+
+  /**
+   * @brief Publish a trajectory, replacing the executed one from the trajectory's start time on.
+   * A trajectory without header stamp starts immediately.
+   */
+  bool sendTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory) override;
+
+  /**
+   * @brief Stop the controller by publishing an empty trajectory.
+   */
+  bool cancelExecution() override;
+
+  /**
+   * @brief Blocks until the last sent trajectory is expected to be finished.
+   * @param timeout Duration to wait before failing. Default value indicates no timeout.
+   * @return True if the trajectory finished or was canceled, false on timeout.
+   */
+  bool waitForExecution(const rclcpp::Duration& timeout = rclcpp::Duration::from_seconds(-1.0)) override;
+
+  moveit_controller_manager::ExecutionStatus getLastExecutionStatus() override;
+
+  void addJoint(const std::string& name) override
+  {
+    joints_.push_back(name);
+  }
+
+  void getJoints(std::vector<std::string>& joints) override
+  {
+    joints = joints_;
+  }
+
+private:
+  const rclcpp::Node::SharedPtr node_;
+  rclcpp::Publisher<trajectory_msgs::msg::JointTrajectory>::SharedPtr trajectory_publisher_;
+  std::vector<std::string> joints_;
+
+  // Protects the execution state below, which is shared between sendTrajectory(), cancelExecution() and
+  // waitForExecution()
+  std::mutex execution_mutex_;
+  std::condition_variable execution_condition_;
+  rclcpp::Time end_time_;  // time the last sent trajectory is expected to be finished
+  moveit_controller_manager::ExecutionStatus last_exec_;
+  bool done_;
+};
+
+}  // namespace moveit_simple_controller_manager
@@ -0,0 +1,141 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit_simple_controller_manager/joint_trajectory_stream_controller_handle.hpp>
+
+namespace moveit_simple_controller_manager
+{
+JointTrajectoryStreamControllerHandle::JointTrajectoryStreamControllerHandle(const rclcpp::Node::SharedPtr& node,
+                                                                             const std::string& name,
+                                                                             const std::string& topic)
+  : ActionBasedControllerHandleBase(name, "moveit.simple_controller_manager.joint_trajectory_stream_controller_handle")
+  , node_(node)
+  , end_time_(0, 0, node->get_clock()->get_clock_type())
+  , last_exec_(moveit_controller_manager::ExecutionStatus::SUCCEEDED)
+  , done_(true)
+{
+  trajectory_publisher_ = node_->create_publisher<trajectory_msgs::msg::JointTrajectory>(
+      topic.empty() ? name_ : name_ + "/" + topic, rclcpp::SystemDefaultsQoS());
+}
+
+bool JointTrajectoryStreamControllerHandle::sendTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory)
+{
+  if (!trajectory.multi_dof_joint_trajectory.points.empty())
+  {
+    RCLCPP_ERROR_STREAM(logger_, name_ << " cannot stream multi-DOF trajectories");
+    return false;
+  }
+  if (trajectory_publisher_->get_subscription_count() == 0)
+  {
+    RCLCPP_ERROR_STREAM(logger_, "No controller subscribes to " << trajectory_publisher_->get_topic_name());
+    return false;
+  }
+
+  trajectory_msgs::msg::JointTrajectory msg = trajectory.joint_trajectory;
+  const rclcpp::Time now = node_->now();
+  // the controller starts trajectories without stamp on reception, stamp them to know when they end
+  if (rclcpp::Time(msg.header.stamp).nanoseconds() == 0)
+    msg.header.stamp = now;
+  const rclcpp::Time start(msg.header.stamp, now.get_clock_type());
+  const rclcpp::Time end = msg.points.empty() ? start : start + rclcpp::Duration(msg.points.back().time_from_start);
+
+  {
+    std::scoped_lock<std::mutex> lock(execution_mutex_);
+    if (done_)
+    {
+      RCLCPP_INFO_STREAM(logger_, "streaming trajectory to " << name_);
+    }
+    else
+    {
+      RCLCPP_INFO_STREAM(logger_, "streaming replacement for the currently executed trajectory to " << name_);
+    }
+    end_time_ = end;
+    last_exec_ = moveit_controller_manager::ExecutionStatus::RUNNING;
+    done_ = false;
+  }
+  execution_condition_.notify_all();
+
+  trajectory_publisher_->publish(msg);
+  return true;
+}
+
+bool JointTrajectoryStreamControllerHandle::cancelExecution()
+{
+  {
+    std::scoped_lock<std::mutex> lock(execution_mutex_);
+    if (done_)
+      return true;
+    RCLCPP_INFO_STREAM(logger_, "Cancelling execution for " << name_);
+    last_exec_ = moveit_controller_manager::ExecutionStatus::PREEMPTED;
+    done_ = true;
+  }
+  execution_condition_.notify_all();
+
+  // an empty trajectory makes the controller hold its current position
+  trajectory_publisher_->publish(trajectory_msgs::msg::JointTrajectory());
+  return true;
+}
+
+bool JointTrajectoryStreamControllerHandle::waitForExecution(const rclcpp::Duration& timeout)
+{
+  const rclcpp::Time start = node_->now();
+  std::unique_lock<std::mutex> lock(execution_mutex_);
+  while (!done_)
+  {
+    const rclcpp::Time now = node_->now();
+    if (now >= end_time_)
+    {
+      last_exec_ = moveit_controller_manager::ExecutionStatus::SUCCEEDED;
+      done_ = true;
+      break;
+    }
+    if (timeout >= std::chrono::nanoseconds(0) && (now - start) > timeout)
+    {
+      RCLCPP_WARN(logger_, "waitForExecution timed out");
+      return false;
+    }
+    // poll, since the end time moves with replacements and the clock may be simulated
+    execution_condition_.wait_for(
+        lock, std::min<std::chrono::nanoseconds>(50ms, (end_time_ - now).to_chrono<std::chrono::nanoseconds>()));
+  }
+  return true;
+}
+
+moveit_controller_manager::ExecutionStatus JointTrajectoryStreamControllerHandle::getLastExecutionStatus()
+{
+  std::scoped_lock<std::mutex> lock(execution_mutex_);
+  return last_exec_;
+}
+
+}  // namespace moveit_simple_controller_manager
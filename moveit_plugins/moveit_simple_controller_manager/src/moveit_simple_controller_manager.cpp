@@ -38,6 +38,7 @@
 #include <moveit_simple_controller_manager/action_based_controller_handle.hpp>
 #include <moveit_simple_controller_manager/gripper_controller_handle.hpp>
 #include <moveit_simple_controller_manager/follow_joint_trajectory_controller_handle.hpp>
+#include <moveit_simple_controller_manager/joint_trajectory_stream_controller_handle.hpp>
 #include <boost/algorithm/string/join.hpp>
 #include <pluginlib/class_list_macros.hpp>
 #include <rclcpp/logger.hpp>
@@ -119,19 +120,20 @@ public:
     {
       try
       {
-        std::string action_ns;
-        const std::string& action_ns_param = makeParameterName(PARAM_BASE_NAME, controller_name, "action_ns");
-        if (!node_->get_parameter(action_ns_param, action_ns))
+        std::string type;
+        if (!node_->get_parameter(makeParameterName(PARAM_BASE_NAME, controller_name, "type"), type))
         {
-          RCLCPP_ERROR_STREAM(getLogger(), "No action namespace specified for controller `"
-                                               << controller_name << "` through parameter `" << action_ns_param << '`');
+          RCLCPP_ERROR_STREAM(getLogger(), "No type specified for controller " << controller_name);
           continue;
         }
 
-        std::string type;
-        if (!node_->get_parameter(makeParameterName(PARAM_BASE_NAME, controller_name, "type"), type))
+        // streamed controllers are reached through a topic instead of an action
+        std::string action_ns;
+        const std::string& action_ns_param = makeParameterName(PARAM_BASE_NAME, controller_name, "action_ns");
+        if (type != "JointTrajectoryStream" && !node_->get_parameter(action_ns_param, action_ns))
         {
-          RCLCPP_ERROR_STREAM(getLogger(), "No type specified for controller " << controller_name);
+          RCLCPP_ERROR_STREAM(getLogger(), "No action namespace specified for controller `"
+                                               << controller_name << "` through parameter `" << action_ns_param << '`');
           continue;
         }
 
@@ -192,6 +194,15 @@ public:
           RCLCPP_INFO_STREAM(getLogger(), "Added FollowJointTrajectory controller for " << controller_name);
           controllers_[controller_name] = new_handle;
         }
+        else if (type == "JointTrajectoryStream")
+        {
+          std::string topic;
+          node_->get_parameter_or(makeParameterName(PARAM_BASE_NAME, controller_name, "topic"), topic,
+                                  std::string("joint_trajectory"));
+          new_handle = std::make_shared<JointTrajectoryStreamControllerHandle>(node_, controller_name, topic);
+          RCLCPP_INFO_STREAM(getLogger(), "Added JointTrajectoryStream controller for " << controller_name);
+          controllers_[controller_name] = new_handle;
+        }
         else
         {
           RCLCPP_ERROR_STREAM(getLogger(), "Unknown controller type: " << type);
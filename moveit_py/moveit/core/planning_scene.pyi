@@ -5,6 +5,7 @@ class PlanningScene:
     name: Any
     def __init__(self, *args, **kwargs) -> None: ...
     def apply_collision_object(self, *args, **kwargs) -> Any: ...
+    def are_states_colliding(self, *args, **kwargs) -> Any: ...
     def check_collision(self, *args, **kwargs) -> Any: ...
     def check_collision_unpadded(self, *args, **kwargs) -> Any: ...
     def check_self_collision(self, *args, **kwargs) -> Any: ...
@@ -6,8 +6,11 @@ class RobotState:
     joint_efforts: Any
     joint_positions: Any
     joint_velocities: Any
+    variable_positions: Any
+    variable_velocities: Any
     def __init__(self, *args, **kwargs) -> None: ...
     def clear_attached_bodies(self, *args, **kwargs) -> Any: ...
+    def compute_link_transforms(self, *args, **kwargs) -> Any: ...
     def get_frame_transform(self, *args, **kwargs) -> Any: ...
     def get_global_link_transform(self, *args, **kwargs) -> Any: ...
     def get_jacobian(self, *args, **kwargs) -> Any: ...
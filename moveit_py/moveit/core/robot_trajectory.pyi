@@ -7,6 +7,8 @@ class RobotTrajectory:
     def apply_ruckig_smoothing(self, *args, **kwargs) -> Any: ...
     def get_robot_trajectory_msg(self, *args, **kwargs) -> Any: ...
     def get_waypoint_durations(self, *args, **kwargs) -> Any: ...
+    def get_waypoint_positions(self, *args, **kwargs) -> Any: ...
+    def get_waypoint_velocities(self, *args, **kwargs) -> Any: ...
     def set_robot_trajectory_msg(self, *args, **kwargs) -> Any: ...
     def unwind(self, *args, **kwargs) -> Any: ...
     def __getitem__(self, index) -> Any: ...
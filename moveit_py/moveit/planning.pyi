@@ -38,6 +38,7 @@ class PlanningComponent:
     def get_named_target_state_values(self, *args, **kwargs) -> Any: ...
     def get_start_state(self, *args, **kwargs) -> Any: ...
     def plan(self, *args, **kwargs) -> Any: ...
+    def plan_async(self, *args, **kwargs) -> Any: ...
     def set_goal_state(self, *args, **kwargs) -> Any: ...
     def set_path_constraints(self, *args, **kwargs) -> Any: ...
     def set_start_state(self, *args, **kwargs) -> Any: ...
@@ -97,6 +97,39 @@ moveit_msgs::msg::PlanningScene getPlanningSceneMsg(std::shared_ptr<planning_sce
   return planning_scene_msg;
 }
 
+py::array_t<bool>
+areStatesColliding(const std::shared_ptr<planning_scene::PlanningScene>& planning_scene,
+                   const moveit::core::RobotState& robot_state, const std::string& joint_model_group_name,
+                   const py::array_t<double, py::array::c_style | py::array::forcecast>& positions)
+{
+  const moveit::core::JointModelGroup* joint_model_group = robot_state.getJointModelGroup(joint_model_group_name);
+  if (!joint_model_group)
+  {
+    throw std::invalid_argument("Invalid joint model group name");
+  }
+  const std::size_t variable_count = joint_model_group->getVariableCount();
+  if (positions.ndim() != 2 || static_cast<std::size_t>(positions.shape(1)) != variable_count)
+  {
+    throw std::invalid_argument("Expected one row of joint model group positions per state");
+  }
+
+  const py::ssize_t state_count = positions.shape(0);
+  py::array_t<bool> colliding(state_count);
+  const double* input = positions.data();
+  bool* output = colliding.mutable_data();
+  {
+    py::gil_scoped_release release;
+    moveit::core::RobotState state(robot_state);
+    for (py::ssize_t i = 0; i < state_count; ++i)
+    {
+      state.setJointGroupPositions(joint_model_group, input + i * variable_count);
+      state.update();
+      output[i] = planning_scene->isStateColliding(state, joint_model_group_name);
+    }
+  }
+  return colliding;
+}
+
 void initPlanningScene(py::module& m)
 {
   py::module planning_scene = m.def_submodule("planning_scene");
@@ -251,7 +284,8 @@ void initPlanningScene(py::module& m)
       .def("is_state_valid",
            py::overload_cast<const moveit::core::RobotState&, const std::string&, bool>(
                &planning_scene::PlanningScene::isStateValid, py::const_),
-           py::arg("robot_state"), py::arg("joint_model_group_name"), py::arg("verbose") = false)
+           py::arg("robot_state"), py::arg("joint_model_group_name"), py::arg("verbose") = false,
+           py::call_guard<py::gil_scoped_release>())
       .def("is_state_colliding",
            py::overload_cast<const std::string&, bool>(&planning_scene::PlanningScene::isStateColliding),
            py::arg("joint_model_group_name"), py::arg("verbose") = false,
@@ -269,6 +303,7 @@ void initPlanningScene(py::module& m)
            py::overload_cast<const moveit::core::RobotState&, const std::string&, bool>(
                &planning_scene::PlanningScene::isStateColliding, py::const_),
            py::arg("robot_state"), py::arg("joint_model_group_name"), py::arg("verbose") = false,
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state is in collision.
 
@@ -280,10 +315,24 @@ void initPlanningScene(py::module& m)
                bool: True if the robot state is in collision, false otherwise.
            )")
 
+      .def("are_states_colliding", &moveit_py::bind_planning_scene::areStatesColliding, py::arg("robot_state"),
+           py::arg("joint_model_group_name"), py::arg("positions"),
+           R"(
+           Check a batch of joint model group positions for collisions, without holding the GIL. The planning scene must not be modified concurrently.
+
+	   Args:
+               robot_state (:py:class:`moveit_py.core.RobotState`): The robot state providing the values of the variables outside of the group.
+               joint_model_group_name (str): The name of the group to check collision for.
+               positions (:py:class:`numpy.ndarray`): An N x M array, one row of group variable positions per state.
+           Returns:
+               :py:class:`numpy.ndarray`: N booleans, true for the states in collision.
+           )")
+
       .def("is_state_constrained",
            py::overload_cast<const moveit::core::RobotState&, const moveit_msgs::msg::Constraints&, bool>(
                &planning_scene::PlanningScene::isStateConstrained, py::const_),
            py::arg("state"), py::arg("constraints"), py::arg("verbose") = false,
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state fulfills the passed constraints
 
@@ -300,6 +349,7 @@ void initPlanningScene(py::module& m)
                              std::vector<std::size_t>*>(&planning_scene::PlanningScene::isPathValid, py::const_),
            py::arg("trajectory"), py::arg("joint_model_group_name"), py::arg("verbose") = false,
            py::arg("invalid_index") = nullptr,
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if a given path is valid. Each state is checked for validity (collision avoidance and feasibility)
 
@@ -334,6 +384,7 @@ void initPlanningScene(py::module& m)
            py::overload_cast<const collision_detection::CollisionRequest&, collision_detection::CollisionResult&,
                              moveit::core::RobotState&>(&planning_scene::PlanningScene::checkCollision, py::const_),
            py::arg("collision_request"), py::arg("collision_result"), py::arg("state"),
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state is in collision.
 
@@ -351,6 +402,7 @@ void initPlanningScene(py::module& m)
                              moveit::core::RobotState&, const collision_detection::AllowedCollisionMatrix&>(
                &planning_scene::PlanningScene::checkCollision, py::const_),
            py::arg("collision_request"), py::arg("collision_result"), py::arg("state"), py::arg("acm"),
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state is in collision.
 
@@ -384,6 +436,7 @@ void initPlanningScene(py::module& m)
                              moveit::core::RobotState&>(&planning_scene::PlanningScene::checkCollisionUnpadded,
                                                         py::const_),
            py::arg("collision_request"), py::arg("collision_result"), py::arg("state"),
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state is in collision.
 
@@ -401,6 +454,7 @@ void initPlanningScene(py::module& m)
                              moveit::core::RobotState&, const collision_detection::AllowedCollisionMatrix&>(
                &planning_scene::PlanningScene::checkCollisionUnpadded, py::const_),
            py::arg("collision_request"), py::arg("collision_result"), py::arg("state"), py::arg("acm"),
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state is in collision.
 
@@ -432,6 +486,7 @@ void initPlanningScene(py::module& m)
            py::overload_cast<const collision_detection::CollisionRequest&, collision_detection::CollisionResult&,
                              moveit::core::RobotState&>(&planning_scene::PlanningScene::checkSelfCollision, py::const_),
            py::arg("collision_request"), py::arg("collision_result"), py::arg("state"),
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state is in collision.
 
@@ -449,6 +504,7 @@ void initPlanningScene(py::module& m)
                              moveit::core::RobotState&, const collision_detection::AllowedCollisionMatrix&>(
                &planning_scene::PlanningScene::checkSelfCollision, py::const_),
            py::arg("collision_request"), py::arg("collision_result"), py::arg("state"), py::arg("acm"),
+           py::call_guard<py::gil_scoped_release>(),
            R"(
            Check if the robot state is in collision.
 
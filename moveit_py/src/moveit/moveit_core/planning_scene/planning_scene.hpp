@@ -38,6 +38,7 @@
 
 #include <pybind11/pybind11.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include <moveit_py/moveit_py_utils/copy_ros_msg.hpp>
 #include <moveit_py/moveit_py_utils/ros_msg_typecasters.hpp>
@@ -57,6 +58,11 @@ Eigen::MatrixXd getFrameTransform(std::shared_ptr<planning_scene::PlanningScene>
 
 moveit_msgs::msg::PlanningScene getPlanningSceneMsg(std::shared_ptr<planning_scene::PlanningScene>& planning_scene);
 
+py::array_t<bool>
+areStatesColliding(const std::shared_ptr<planning_scene::PlanningScene>& planning_scene,
+                   const moveit::core::RobotState& robot_state, const std::string& joint_model_group_name,
+                   const py::array_t<double, py::array::c_style | py::array::forcecast>& positions);
+
 void initPlanningScene(py::module& m);
 }  // namespace bind_planning_scene
 }  // namespace moveit_py
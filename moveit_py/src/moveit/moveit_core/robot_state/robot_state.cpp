@@ -206,6 +206,78 @@ bool setToDefaultValues(moveit::core::RobotState* self, const std::string& joint
   return self->setToDefaultValues(joint_model_group, state_name);
 }
 
+py::array_t<double> getVariablePositions(const py::object& self)
+{
+  auto& state = self.cast<moveit::core::RobotState&>();
+  py::array_t<double> positions({ static_cast<py::ssize_t>(state.getVariableCount()) }, { sizeof(double) },
+                                state.getVariablePositions(), self);
+  // writing through the view would bypass the dirty flags of the transforms, positions are set with the setter
+  positions.attr("setflags")(py::arg("write") = false);
+  return positions;
+}
+
+void setVariablePositions(moveit::core::RobotState* self, const DoubleArray& positions)
+{
+  if (positions.ndim() != 1 || static_cast<std::size_t>(positions.size()) != self->getVariableCount())
+  {
+    throw std::invalid_argument("Expected one position per variable of the robot state");
+  }
+  self->setVariablePositions(positions.data());
+}
+
+py::array_t<double> getVariableVelocities(const py::object& self)
+{
+  auto& state = self.cast<moveit::core::RobotState&>();
+  return py::array_t<double>({ static_cast<py::ssize_t>(state.getVariableCount()) }, { sizeof(double) },
+                             state.getVariableVelocities(), self);
+}
+
+void setVariableVelocities(moveit::core::RobotState* self, const DoubleArray& velocities)
+{
+  if (velocities.ndim() != 1 || static_cast<std::size_t>(velocities.size()) != self->getVariableCount())
+  {
+    throw std::invalid_argument("Expected one velocity per variable of the robot state");
+  }
+  self->setVariableVelocities(velocities.data());
+}
+
+py::array_t<double> computeLinkTransforms(const moveit::core::RobotState* self,
+                                          const std::string& joint_model_group_name, const DoubleArray& positions,
+                                          const std::string& link_name)
+{
+  const moveit::core::JointModelGroup* joint_model_group = self->getJointModelGroup(joint_model_group_name);
+  if (!joint_model_group)
+  {
+    throw std::invalid_argument("Invalid joint model group name");
+  }
+  const moveit::core::LinkModel* link_model = self->getLinkModel(link_name);
+  if (!link_model)
+  {
+    throw std::invalid_argument("Invalid link name");
+  }
+  const std::size_t variable_count = joint_model_group->getVariableCount();
+  if (positions.ndim() != 2 || static_cast<std::size_t>(positions.shape(1)) != variable_count)
+  {
+    throw std::invalid_argument("Expected one row of joint model group positions per state");
+  }
+
+  const py::ssize_t state_count = positions.shape(0);
+  py::array_t<double> transforms({ state_count, py::ssize_t{ 4 }, py::ssize_t{ 4 } });
+  const double* input = positions.data();
+  double* output = transforms.mutable_data();
+  {
+    py::gil_scoped_release release;
+    moveit::core::RobotState state(*self);
+    for (py::ssize_t i = 0; i < state_count; ++i)
+    {
+      state.setJointGroupPositions(joint_model_group, input + i * variable_count);
+      Eigen::Map<Eigen::Matrix<double, 4, 4, Eigen::RowMajor>>(output + i * 16) =
+          state.getGlobalLinkTransform(link_model).matrix();
+    }
+  }
+  return transforms;
+}
+
 void initRobotState(py::module& m)
 {
   py::module robot_state = m.def_submodule("robot_state");
@@ -339,6 +411,19 @@ void initRobotState(py::module& m)
       .def_property("joint_efforts", &moveit_py::bind_robot_state::getJointEfforts,
                     &moveit_py::bind_robot_state::setJointEfforts, py::return_value_policy::copy)
 
+      // Views of the variable values, ordered like the variable names of the robot model
+      .def_property("variable_positions", &moveit_py::bind_robot_state::getVariablePositions,
+                    &moveit_py::bind_robot_state::setVariablePositions,
+                    R"(
+                    :py:class:`numpy.ndarray`: A read-only view of the positions of all variables, without copying them. Assign an array to set the positions.
+                    )")
+
+      .def_property("variable_velocities", &moveit_py::bind_robot_state::getVariableVelocities,
+                    &moveit_py::bind_robot_state::setVariableVelocities,
+                    R"(
+                    :py:class:`numpy.ndarray`: A writable view of the velocities of all variables, without copying them.
+                    )")
+
       .def("set_joint_group_positions",
            py::overload_cast<const std::string&, const Eigen::VectorXd&>(
                &moveit::core::RobotState::setJointGroupPositions),
@@ -435,6 +520,20 @@ void initRobotState(py::module& m)
            :py:class:`numpy.ndarray`: The transform of the specified link in the global frame.
        )")
 
+      .def("compute_link_transforms", &moveit_py::bind_robot_state::computeLinkTransforms,
+           py::arg("joint_model_group_name"), py::arg("positions"), py::arg("link_name"),
+           R"(
+       Computes the global transforms of a link for a batch of joint model group positions, without modifying this robot state and without holding the GIL.
+
+       Args:
+           joint_model_group_name (str): The name of the joint model group of the positions.
+           positions (:py:class:`numpy.ndarray`): An N x M array, one row of group variable positions per state.
+           link_name (str): The name of the link to get the transforms for.
+
+       Returns:
+           :py:class:`numpy.ndarray`: An N x 4 x 4 array of the transforms of the link in the global frame.
+       )")
+
       // Setting state from inverse kinematics
       .def(
           "set_from_ik",
@@ -442,6 +541,7 @@ void initRobotState(py::module& m)
              const std::string& tip,
              double timeout) { return self->setFromIK(self->getJointModelGroup(group), pose, tip, timeout); },
           py::arg("joint_model_group_name"), py::arg("geometry_pose"), py::arg("tip_name"), py::arg("timeout") = 0.0,
+          py::call_guard<py::gil_scoped_release>(),
           R"(
            Sets the state of the robot to the one that results from solving the inverse kinematics for the specified group.
 
@@ -44,6 +44,7 @@
 #endif
 #include <pybind11/eigen.h>
 #pragma GCC diagnostic pop
+#include <pybind11/numpy.h>
 #include <moveit_py/moveit_py_utils/copy_ros_msg.hpp>
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <moveit/robot_state/robot_state.hpp>
@@ -78,6 +79,19 @@ Eigen::MatrixXd getJacobian(const moveit::core::RobotState* self, const std::str
 bool setToDefaultValues(moveit::core::RobotState* self, const std::string& joint_model_group_name,
                         const std::string& state_name);
 
+/// Contiguous array of doubles, converted from other NumPy inputs if needed
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+py::array_t<double> getVariablePositions(const py::object& self);
+void setVariablePositions(moveit::core::RobotState* self, const DoubleArray& positions);
+
+py::array_t<double> getVariableVelocities(const py::object& self);
+void setVariableVelocities(moveit::core::RobotState* self, const DoubleArray& velocities);
+
+py::array_t<double> computeLinkTransforms(const moveit::core::RobotState* self,
+                                          const std::string& joint_model_group_name, const DoubleArray& positions,
+                                          const std::string& link_name);
+
 void initRobotState(py::module& m);
 }  // namespace bind_robot_state
 }  // namespace moveit_py
@@ -38,6 +38,9 @@
 #include <moveit_py/moveit_py_utils/ros_msg_typecasters.hpp>
 #include <moveit/trajectory_processing/trajectory_tools.hpp>
 
+#include <algorithm>
+#include <functional>
+
 namespace moveit_py
 {
 namespace bind_robot_trajectory
@@ -58,6 +61,48 @@ setRobotTrajectoryMsg(const std::shared_ptr<robot_trajectory::RobotTrajectory>&
   return robot_trajectory->setRobotTrajectoryMsg(robot_state, msg);
 }
 
+namespace
+{
+// The waypoints are separate robot states, so their values are gathered into one contiguous array, without the GIL
+py::array_t<double> getWaypointValues(const robot_trajectory::RobotTrajectory& robot_trajectory,
+                                      const std::function<const double*(const moveit::core::RobotState&)>& values)
+{
+  const std::size_t variable_count = robot_trajectory.getRobotModel()->getVariableCount();
+  py::array_t<double> array({ static_cast<py::ssize_t>(robot_trajectory.getWayPointCount()),
+                              static_cast<py::ssize_t>(variable_count) });
+  double* output = array.mutable_data();
+  {
+    py::gil_scoped_release release;
+    for (std::size_t i = 0; i < robot_trajectory.getWayPointCount(); ++i)
+    {
+      const double* waypoint_values = values(robot_trajectory.getWayPoint(i));
+      if (waypoint_values)
+      {
+        std::copy(waypoint_values, waypoint_values + variable_count, output + i * variable_count);
+      }
+      else
+      {
+        std::fill(output + i * variable_count, output + (i + 1) * variable_count, 0.0);
+      }
+    }
+  }
+  return array;
+}
+}  // namespace
+
+py::array_t<double> getWaypointPositions(const robot_trajectory::RobotTrajectory& robot_trajectory)
+{
+  return getWaypointValues(robot_trajectory,
+                           [](const moveit::core::RobotState& waypoint) { return waypoint.getVariablePositions(); });
+}
+
+py::array_t<double> getWaypointVelocities(const robot_trajectory::RobotTrajectory& robot_trajectory)
+{
+  return getWaypointValues(robot_trajectory, [](const moveit::core::RobotState& waypoint) -> const double* {
+    return waypoint.hasVelocities() ? waypoint.getVariableVelocities() : nullptr;
+  });
+}
+
 void initRobotTrajectory(py::module& m)
 {
   py::module robot_trajectory = m.def_submodule("robot_trajectory");
@@ -135,6 +180,20 @@ void initRobotTrajectory(py::module& m)
            Returns:
                list of float: The duration from previous of each waypoint in the trajectory.
            )")
+      .def("get_waypoint_positions", &moveit_py::bind_robot_trajectory::getWaypointPositions,
+           R"(
+           Get the positions of all waypoints as one array.
+
+           Returns:
+               :py:class:`numpy.ndarray`: An N x M array with the positions of the M robot variables at each of the N waypoints.
+           )")
+      .def("get_waypoint_velocities", &moveit_py::bind_robot_trajectory::getWaypointVelocities,
+           R"(
+           Get the velocities of all waypoints as one array, zero for waypoints without velocities.
+
+           Returns:
+               :py:class:`numpy.ndarray`: An N x M array with the velocities of the M robot variables at each of the N waypoints.
+           )")
       .def("apply_totg_time_parameterization", &trajectory_processing::applyTOTGTimeParameterization,
            py::arg("velocity_scaling_factor"), py::arg("acceleration_scaling_factor"), py::kw_only(),
            py::arg("path_tolerance") = 0.1, py::arg("resample_dt") = 0.1, py::arg("min_angle_change") = 0.001,
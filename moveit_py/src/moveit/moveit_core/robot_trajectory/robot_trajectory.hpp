@@ -39,6 +39,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <moveit/robot_trajectory/robot_trajectory.hpp>
 #include <moveit_msgs/msg/robot_trajectory.hpp>
 #include <rclcpp/rclcpp.hpp>
@@ -56,6 +57,9 @@ robot_trajectory::RobotTrajectory
 setRobotTrajectoryMsg(const std::shared_ptr<robot_trajectory::RobotTrajectory>& robot_trajectory,
                       const moveit::core::RobotState& robot_state, const moveit_msgs::msg::RobotTrajectory& msg);
 
+py::array_t<double> getWaypointPositions(const robot_trajectory::RobotTrajectory& robot_trajectory);
+py::array_t<double> getWaypointVelocities(const robot_trajectory::RobotTrajectory& robot_trajectory);
+
 void initRobotTrajectory(py::module& m);
 }  // namespace bind_robot_trajectory
 }  // namespace moveit_py
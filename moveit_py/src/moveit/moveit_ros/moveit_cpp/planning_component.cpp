@@ -35,7 +35,10 @@
 /* Author: Peter David Fagan */
 
 #include "planning_component.hpp"
+#include <exception>
 #include <memory>
+#include <stdexcept>
+#include <thread>
 
 namespace moveit_py
 {
@@ -104,6 +107,64 @@ plan(std::shared_ptr<moveit_cpp::PlanningComponent>& planning_component,
   }
 }
 
+py::object planAsync(
+    std::shared_ptr<moveit_cpp::PlanningComponent>& planning_component,
+    std::shared_ptr<moveit_cpp::PlanningComponent::PlanRequestParameters>& single_plan_parameters,
+    std::shared_ptr<moveit_cpp::PlanningComponent::MultiPipelinePlanRequestParameters>& multi_plan_parameters,
+    std::shared_ptr<planning_scene::PlanningScene>& planning_scene,
+    std::optional<const moveit::planning_pipeline_interfaces::SolutionSelectionFunction> solution_selection_function,
+    std::optional<moveit::planning_pipeline_interfaces::StoppingCriterionFunction> stopping_criterion_callback)
+{
+  py::object future = py::module_::import("concurrent.futures").attr("Future")();
+  future.attr("set_running_or_notify_cancel")();
+
+  // The thread plans without the GIL and acquires it only to complete the future. The Python objects it holds are
+  // copied here and released while holding the GIL, too.
+  std::thread([planning_component, single_plan_parameters, multi_plan_parameters, planning_scene,
+               solution_selection_function, stopping_criterion_callback, future]() mutable {
+    std::optional<planning_interface::MotionPlanResponse> response;
+    std::exception_ptr error;
+    try
+    {
+      response = plan(planning_component, single_plan_parameters, multi_plan_parameters, planning_scene,
+                      solution_selection_function, stopping_criterion_callback);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    py::gil_scoped_acquire acquire;
+    if (response)
+    {
+      future.attr("set_result")(py::cast(std::move(*response)));
+    }
+    else
+    {
+      try
+      {
+        std::rethrow_exception(error);
+      }
+      catch (py::error_already_set& e)
+      {
+        future.attr("set_exception")(e.value());
+      }
+      catch (const std::invalid_argument& e)
+      {
+        future.attr("set_exception")(py::handle(PyExc_ValueError)(e.what()));
+      }
+      catch (const std::exception& e)
+      {
+        future.attr("set_exception")(py::handle(PyExc_RuntimeError)(e.what()));
+      }
+    }
+    solution_selection_function.reset();
+    stopping_criterion_callback.reset();
+    future = py::object();
+  }).detach();
+  return future;
+}
+
 bool setGoal(std::shared_ptr<moveit_cpp::PlanningComponent>& planning_component,
              std::optional<std::string> configuration_name, std::optional<moveit::core::RobotState> robot_state,
              std::optional<geometry_msgs::msg::PoseStamped> pose_stamped_msg, std::optional<std::string> pose_link,
@@ -332,14 +393,25 @@ void initPlanningComponent(py::module& m)
       .def("plan", &moveit_py::bind_planning_component::plan, py::arg("single_plan_parameters") = nullptr,
            py::arg("multi_plan_parameters") = nullptr, py::arg("planning_scene") = nullptr,
            py::arg("solution_selection_function") = nullptr, py::arg("stopping_criterion_callback") = nullptr,
-           py::return_value_policy::move,
+           py::return_value_policy::move, py::call_guard<py::gil_scoped_release>(),
            R"(
-           Plan a motion plan using the current start and goal states.
+           Plan a motion plan using the current start and goal states. The GIL is released while planning.
 
 	   Args:
                plan_parameters (moveit_py.core.PlanParameters): The parameters to use for planning.
            )")
 
+      .def("plan_async", &moveit_py::bind_planning_component::planAsync, py::arg("single_plan_parameters") = nullptr,
+           py::arg("multi_plan_parameters") = nullptr, py::arg("planning_scene") = nullptr,
+           py::arg("solution_selection_function") = nullptr, py::arg("stopping_criterion_callback") = nullptr,
+           R"(
+           Start planning a motion plan in a background thread, without holding the GIL. Takes the arguments of plan().
+           The start and goal states of the planning component must not be changed until the future is done, so concurrent plans should use one planning component each.
+
+	   Returns:
+               concurrent.futures.Future: A future of the motion plan response.
+           )")
+
       .def("set_path_constraints", &moveit_cpp::PlanningComponent::setPathConstraints, py::arg("path_constraints"),
            py::return_value_policy::move,
            R"(
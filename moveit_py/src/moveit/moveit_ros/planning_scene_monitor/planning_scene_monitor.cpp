@@ -140,7 +140,7 @@ void initPlanningSceneMonitor(py::module& m)
 	       Stops the state monitor.
 	   )")
       .def("request_planning_scene_state", &planning_scene_monitor::PlanningSceneMonitor::requestPlanningSceneState,
-           py::arg("service_name"),
+           py::arg("service_name"), py::call_guard<py::gil_scoped_release>(),
            R"(
 	       Request the planning scene.
 
@@ -149,6 +149,7 @@ void initPlanningSceneMonitor(py::module& m)
 	   )")
 
       .def("wait_for_current_robot_state", &planning_scene_monitor::PlanningSceneMonitor::waitForCurrentRobotState,
+           py::call_guard<py::gil_scoped_release>(),
            R"(
 	   Waits for the current robot state to be received.
 	   )")
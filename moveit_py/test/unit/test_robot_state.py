@@ -148,6 +148,60 @@ class TestRobotState(unittest.TestCase):
             robot_state.get_joint_group_accelerations("panda_arm").tolist(),
         )
 
+    def test_variable_positions_view(self):
+        """
+        Test that the variable positions are a read-only view of the state, set by assignment
+        """
+        robot_model = get_robot_model()
+        robot_state = RobotState(robot_model)
+        robot_state.set_to_default_values()
+        positions = robot_state.variable_positions
+
+        self.assertIsInstance(positions, np.ndarray)
+        self.assertFalse(positions.flags.writeable)
+
+        new_positions = np.full(positions.shape, 0.1)
+        robot_state.variable_positions = new_positions
+        # the view shares the memory of the state
+        self.assertEqual(positions.tolist(), new_positions.tolist())
+        self.assertTrue(robot_state.dirty)
+
+    def test_variable_velocities_view(self):
+        """
+        Test that writing to the variable velocities view sets the velocities of the state
+        """
+        robot_model = get_robot_model()
+        robot_state = RobotState(robot_model)
+        velocities = robot_state.variable_velocities
+        velocities[:] = 1.0
+
+        self.assertEqual(
+            robot_state.get_joint_group_velocities("panda_arm").tolist(), [1.0] * 7
+        )
+
+    def test_compute_link_transforms(self):
+        """
+        Test that the batched link transforms match the transforms of single states
+        """
+        robot_model = get_robot_model()
+        robot_state = RobotState(robot_model)
+        robot_state.set_to_default_values()
+        robot_state.update()
+        positions = np.array([[0.0] * 7, [0.5] * 7])
+        transforms = robot_state.compute_link_transforms(
+            joint_model_group_name="panda_arm",
+            positions=positions,
+            link_name="panda_link8",
+        )
+
+        self.assertEqual(transforms.shape, (2, 4, 4))
+        for i in range(2):
+            robot_state.set_joint_group_positions("panda_arm", positions[i])
+            robot_state.update()
+            np.testing.assert_allclose(
+                transforms[i], robot_state.get_global_link_transform("panda_link8")
+            )
+
     # TODO (peterdavidfagan): requires kinematics solver to be loaded
     # def test_set_from_ik(self):
     #    """
@@ -50,6 +50,7 @@
 #include <pluginlib/class_loader.hpp>
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <functional>
@@ -151,6 +152,9 @@ protected:
                               const planning_interface::MotionPlanDetailedResponse& motion_plan_response, bool solved,
                               double total_time);
 
+  /// Store the measured planning statistics of a run, e.g. the number of collision checks and the time of each stage
+  virtual void collectStatistics(PlannerRunData& metrics, const planning_interface::MotionPlanStatistics& statistics);
+
   /// Compute the similarity of each (final) trajectory to all other (final) trajectories in the experiment and write
   /// the results to planner_data metrics
   void computeAveragePathSimilarities(PlannerBenchmarkData& planner_data,
@@ -195,6 +199,11 @@ protected:
   /// Execute the given motion plan request on the set of planners for the set number of runs
   void runBenchmark(moveit_msgs::msg::MotionPlanRequest request, const BenchmarkOptions& options);
 
+  /// Execute the given motion plan request like runBenchmark(), but distribute the runs of all planners over
+  /// options.workers threads. Each worker plans with its own planning pipelines in its own clone of the planning scene.
+  /// Run events and metric collection are serialized, and each run reports how many runs were planning concurrently.
+  void runBenchmarkParallel(const moveit_msgs::msg::MotionPlanRequest& request, const BenchmarkOptions& options);
+
   std::shared_ptr<planning_scene_monitor::PlanningSceneMonitor> planning_scene_monitor_;
   std::shared_ptr<moveit_warehouse::PlanningSceneStorage> planning_scene_storage_;
   std::shared_ptr<moveit_warehouse::PlanningSceneWorldStorage> planning_scene_world_storage_;
@@ -203,12 +212,15 @@ protected:
   std::shared_ptr<moveit_warehouse::TrajectoryConstraintsStorage> trajectory_constraints_storage_;
 
   rclcpp::Node::SharedPtr node_;
-  warehouse_ros::DatabaseLoader db_loader_;
+  moveit_warehouse::DatabaseConnectionPool db_connection_pool_;
   planning_scene::PlanningScenePtr planning_scene_;
   std::shared_ptr<moveit_cpp::MoveItCpp> moveit_cpp_;
 
   std::vector<PlannerBenchmarkData> benchmark_data_;
 
+  /// Planning pipelines of the workers of runBenchmarkParallel(), one set per worker
+  std::vector<std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>> worker_pipelines_;
+
   std::vector<PreRunEventFunction> pre_event_functions_;
   std::vector<PostRunEventFunction> post_event_functions_;
   std::vector<PlannerStartEventFunction> planner_start_functions_;
@@ -67,6 +67,8 @@ namespace moveit_ros_benchmarks
 ///         trajectory_constraints_regex
 ///         predefined_poses_group: # Group where the predefined poses are specified
 ///         predefined_poses: # List of named targets
+///         workers: # Number of threads to distribute the runs of all planners over, 1 (default) runs sequentially
+///         pin_workers: # Whether to pin each worker thread to its own CPU (Linux only, default false)
 ///     planning_pipelines:
 ///       pipeline_names: # List of pipeline names to be loaded by moveit_cpp
 ///       pipelines: # List of pipeline names to be used by the benchmark tool
@@ -114,6 +116,8 @@ struct BenchmarkOptions
   std::string trajectory_constraint_regex;    // Regex for trajectory_constraint in database
   std::vector<std::string> predefined_poses;  // List of named targets
   std::string predefined_poses_group;         // Group where the predefined poses are specified
+  int workers;                                // Number of threads executing runs concurrently
+  bool pin_workers;                           // Pin each worker thread to its own CPU
   std::vector<double> goal_offsets =
       std::vector<double>(CARTESIAN_DOF);  // Offset applied to goal constraints: x, y, z, roll, pitch, yaw
 
@@ -36,6 +36,7 @@
 
 #include <moveit/benchmarks/BenchmarkExecutor.hpp>
 #include <moveit/moveit_cpp/planning_component.hpp>
+#include <moveit/planning_pipeline_interfaces/planning_pipeline_interfaces.hpp>
 #include <moveit/utils/lexical_casts.hpp>
 #include <moveit/utils/moveit_error_code.hpp>
 #include <moveit/robot_state/conversions.hpp>
@@ -60,9 +61,14 @@ using boost_progress_display = boost::progress_display;
 #include <boost/filesystem.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <math.h>
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 #ifndef _WIN32
+#include <pthread.h>
 #include <unistd.h>
 #else
 #include <winsock2.h>
@@ -105,7 +111,7 @@ BenchmarkExecutor::BenchmarkExecutor(const rclcpp::Node::SharedPtr& node, const
   , constraints_storage_{ nullptr }
   , trajectory_constraints_storage_{ nullptr }
   , node_{ node }
-  , db_loader_{ node }
+  , db_connection_pool_{ node }
 {
   planning_scene_ = planning_scene_monitor_->getPlanningScene();
 }
@@ -408,9 +414,10 @@ bool BenchmarkExecutor::loadBenchmarkQueryData(
 {
   try
   {
-    warehouse_ros::DatabaseConnection::Ptr warehouse_connection = db_loader_.loadDatabase();
-    warehouse_connection->setParams(options.hostname, options.port, 20);
-    if (warehouse_connection->connect())
+    // reuse the connection of previous benchmarks on the same database
+    warehouse_ros::DatabaseConnection::Ptr warehouse_connection =
+        db_connection_pool_.getConnection(options.hostname, options.port, 20);
+    if (warehouse_connection)
     {
       planning_scene_storage_ = std::make_shared<moveit_warehouse::PlanningSceneStorage>(warehouse_connection);
       planning_scene_world_storage_ =
@@ -609,10 +616,12 @@ bool BenchmarkExecutor::loadQueries(const std::string& regex, const std::string&
     return true;
   }
 
+  // fetch all matching queries at once instead of one database round-trip per query
+  std::vector<moveit_warehouse::MotionPlanRequestWithMetadata> planning_queries;
   std::vector<std::string> query_names;
   try
   {
-    planning_scene_storage_->getPlanningQueriesNames(regex, query_names, scene_name);
+    planning_scene_storage_->getPlanningQueries(regex, planning_queries, query_names, scene_name);
   }
   catch (std::exception& ex)
   {
@@ -620,28 +629,17 @@ bool BenchmarkExecutor::loadQueries(const std::string& regex, const std::string&
     return false;
   }
 
-  if (query_names.empty())
+  if (planning_queries.empty())
   {
     RCLCPP_ERROR(getLogger(), "Scene '%s' has no associated queries", scene_name.c_str());
     return false;
   }
 
-  for (const std::string& query_name : query_names)
+  for (std::size_t i = 0; i < planning_queries.size(); ++i)
   {
-    moveit_warehouse::MotionPlanRequestWithMetadata planning_query;
-    try
-    {
-      planning_scene_storage_->getPlanningQuery(planning_query, scene_name, query_name);
-    }
-    catch (std::exception& ex)
-    {
-      RCLCPP_ERROR(getLogger(), "Error loading motion planning query '%s': %s", query_name.c_str(), ex.what());
-      continue;
-    }
-
     BenchmarkRequest query;
-    query.name = query_name;
-    query.request = static_cast<moveit_msgs::msg::MotionPlanRequest>(*planning_query);
+    query.name = query_names[i];
+    query.request = static_cast<moveit_msgs::msg::MotionPlanRequest>(*planning_queries[i]);
     queries.push_back(query);
   }
   RCLCPP_INFO(getLogger(), "Loaded queries successfully");
@@ -652,37 +650,23 @@ bool BenchmarkExecutor::loadStates(const std::string& regex, std::vector<StartSt
 {
   if (!regex.empty())
   {
-    std::regex start_regex(regex);
+    std::vector<moveit_warehouse::RobotStateWithMetadata> robot_states;
     std::vector<std::string> state_names;
-    robot_state_storage_->getKnownRobotStates(state_names);
-
-    if (state_names.empty())
+    try
+    {
+      robot_state_storage_->getRobotStates(regex, robot_states, state_names);
+    }
+    catch (std::exception& ex)
     {
-      RCLCPP_WARN(getLogger(), "Database does not contain any named states");
+      RCLCPP_ERROR(getLogger(), "Runtime error when loading states: %s", ex.what());
     }
 
-    for (const std::string& state_name : state_names)
+    for (std::size_t i = 0; i < robot_states.size(); ++i)
     {
-      std::smatch match;
-      if (std::regex_match(state_name, match, start_regex))
-      {
-        moveit_warehouse::RobotStateWithMetadata robot_state;
-        try
-        {
-          if (robot_state_storage_->getRobotState(robot_state, state_name))
-          {
-            StartState start_state;
-            start_state.state = moveit_msgs::msg::RobotState(*robot_state);
-            start_state.name = state_name;
-            start_states.push_back(start_state);
-          }
-        }
-        catch (std::exception& ex)
-        {
-          RCLCPP_ERROR(getLogger(), "Runtime error when loading state '%s': %s", state_name.c_str(), ex.what());
-          continue;
-        }
-      }
+      StartState start_state;
+      start_state.state = moveit_msgs::msg::RobotState(*robot_states[i]);
+      start_state.name = state_names[i];
+      start_states.push_back(start_state);
     }
 
     if (start_states.empty())
@@ -698,27 +682,23 @@ bool BenchmarkExecutor::loadPathConstraints(const std::string& regex, std::vecto
 {
   if (!regex.empty())
   {
+    std::vector<moveit_warehouse::ConstraintsWithMetadata> constrs;
     std::vector<std::string> cnames;
-    constraints_storage_->getKnownConstraints(regex, cnames);
+    try
+    {
+      constraints_storage_->getConstraints(regex, constrs, cnames);
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(getLogger(), "Runtime error when loading path constraints: %s", ex.what());
+    }
 
-    for (const std::string& cname : cnames)
+    for (std::size_t i = 0; i < constrs.size(); ++i)
     {
-      moveit_warehouse::ConstraintsWithMetadata constr;
-      try
-      {
-        if (constraints_storage_->getConstraints(constr, cname))
-        {
-          PathConstraints constraint;
-          constraint.constraints.push_back(*constr);
-          constraint.name = cname;
-          constraints.push_back(constraint);
-        }
-      }
-      catch (std::exception& ex)
-      {
-        RCLCPP_ERROR(getLogger(), "Runtime error when loading path constraint '%s': %s", cname.c_str(), ex.what());
-        continue;
-      }
+      PathConstraints constraint;
+      constraint.constraints.push_back(*constrs[i]);
+      constraint.name = cnames[i];
+      constraints.push_back(constraint);
     }
 
     if (constraints.empty())
@@ -738,27 +718,23 @@ bool BenchmarkExecutor::loadTrajectoryConstraints(const std::string& regex,
 {
   if (!regex.empty())
   {
+    std::vector<moveit_warehouse::TrajectoryConstraintsWithMetadata> constrs;
     std::vector<std::string> cnames;
-    trajectory_constraints_storage_->getKnownTrajectoryConstraints(regex, cnames);
+    try
+    {
+      trajectory_constraints_storage_->getTrajectoryConstraints(regex, constrs, cnames);
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(getLogger(), "Runtime error when loading trajectory constraints: %s", ex.what());
+    }
 
-    for (const std::string& cname : cnames)
+    for (std::size_t i = 0; i < constrs.size(); ++i)
     {
-      moveit_warehouse::TrajectoryConstraintsWithMetadata constr;
-      try
-      {
-        if (trajectory_constraints_storage_->getTrajectoryConstraints(constr, cname))
-        {
-          TrajectoryConstraints constraint;
-          constraint.constraints = *constr;
-          constraint.name = cname;
-          constraints.push_back(constraint);
-        }
-      }
-      catch (std::exception& ex)
-      {
-        RCLCPP_ERROR(getLogger(), "Runtime error when loading trajectory constraint '%s': %s", cname.c_str(), ex.what());
-        continue;
-      }
+      TrajectoryConstraints constraint;
+      constraint.constraints = *constrs[i];
+      constraint.name = cnames[i];
+      constraints.push_back(constraint);
     }
 
     if (constraints.empty())
@@ -775,6 +751,12 @@ bool BenchmarkExecutor::loadTrajectoryConstraints(const std::string& regex,
 
 void BenchmarkExecutor::runBenchmark(moveit_msgs::msg::MotionPlanRequest request, const BenchmarkOptions& options)
 {
+  if (options.workers > 1)
+  {
+    runBenchmarkParallel(request, options);
+    return;
+  }
+
   benchmark_data_.clear();
 
   auto num_planners = 0;
@@ -861,6 +843,7 @@ void BenchmarkExecutor::runBenchmark(moveit_msgs::msg::MotionPlanRequest request
           post_event_fn(request, responses[j], planner_data[j]);
         }
         collectMetrics(planner_data[j], responses[j], solved[j], total_time);
+        collectStatistics(planner_data[j], response.statistics);
         dt = std::chrono::system_clock::now() - start;
         double metriconstraints_storage_time = dt.count();
         RCLCPP_DEBUG(getLogger(), "Spent %lf seconds collecting metrics", metriconstraints_storage_time);
@@ -963,6 +946,7 @@ void BenchmarkExecutor::runBenchmark(moveit_msgs::msg::MotionPlanRequest request
         }
 
         collectMetrics(planner_data[j], responses[j], solved[j], total_time);
+        collectStatistics(planner_data[j], response.statistics);
         dt = std::chrono::system_clock::now() - start;
         double metriconstraints_storage_time = dt.count();
         RCLCPP_DEBUG(getLogger(), "Spent %lf seconds collecting metrics", metriconstraints_storage_time);
@@ -983,6 +967,201 @@ void BenchmarkExecutor::runBenchmark(moveit_msgs::msg::MotionPlanRequest request
   }
 }
 
+void BenchmarkExecutor::runBenchmarkParallel(const moveit_msgs::msg::MotionPlanRequest& request,
+                                             const BenchmarkOptions& options)
+{
+  benchmark_data_.clear();
+
+  // A planner configuration is a planner of a pipeline, or a set of pipelines planning in parallel
+  struct PlannerConfiguration
+  {
+    // Request passed to the events
+    moveit_msgs::msg::MotionPlanRequest request;
+    // Pipeline and planner ids
+    std::vector<std::pair<std::string, std::string>> pipelines;
+  };
+  std::vector<PlannerConfiguration> configurations;
+  for (const std::pair<const std::string, std::vector<std::string>>& pipeline_entry : options.planning_pipelines)
+  {
+    for (const std::string& planner_id : pipeline_entry.second)
+    {
+      configurations.push_back({ request, { { pipeline_entry.first, planner_id } } });
+      configurations.back().request.planner_id = planner_id;
+    }
+  }
+  for (const std::pair<const std::string, std::vector<std::pair<std::string, std::string>>>& parallel_pipeline_entry :
+       options.parallel_planning_pipelines)
+  {
+    configurations.push_back({ request, parallel_pipeline_entry.second });
+  }
+
+  const std::size_t num_runs = configurations.size() * options.runs;
+  const std::size_t num_workers = std::min<std::size_t>(options.workers, num_runs);
+  if (num_workers == 0)
+  {
+    return;
+  }
+
+  // Each worker uses its own planning pipelines and planning scene, so that no planner instance, planning context or
+  // scene is shared
+  std::vector<std::string> pipeline_names;
+  for (const auto& [pipeline_name, pipeline] : moveit_cpp_->getPlanningPipelines())
+  {
+    pipeline_names.push_back(pipeline_name);
+  }
+  while (worker_pipelines_.size() < num_workers)
+  {
+    worker_pipelines_.push_back(moveit::planning_pipeline_interfaces::createPlanningPipelineMap(
+        pipeline_names, planning_scene_monitor_->getRobotModel(), node_));
+  }
+  std::vector<planning_scene::PlanningScenePtr> worker_scenes;
+  for (std::size_t w = 0; w < num_workers; ++w)
+  {
+    worker_scenes.push_back(planning_scene::PlanningScene::clone(planning_scene_));
+  }
+
+  benchmark_data_.assign(configurations.size(), PlannerBenchmarkData(options.runs));
+  std::vector<std::vector<planning_interface::MotionPlanDetailedResponse>> responses(
+      configurations.size(), std::vector<planning_interface::MotionPlanDetailedResponse>(options.runs));
+  std::vector<std::vector<bool>> solved(configurations.size(), std::vector<bool>(options.runs));
+
+  // Planner start events
+  for (std::size_t i = 0; i < configurations.size(); ++i)
+  {
+    for (PlannerStartEventFunction& planner_start_function : planner_start_functions_)
+    {
+      planner_start_function(configurations[i].request, benchmark_data_[i]);
+    }
+  }
+
+  boost_progress_display progress(num_runs, std::cout);
+  std::atomic<std::size_t> next_run{ 0 };
+  std::atomic<int> active_runs{ 0 };
+  // Serializes the events, which are not required to be thread-safe, and the metric collection on planning_scene_
+  std::mutex events_mutex;
+
+  const auto worker = [&](std::size_t worker_index) {
+    if (options.pin_workers)
+    {
+#ifdef __linux__
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(worker_index % std::max(1u, std::thread::hardware_concurrency()), &cpu_set);
+      if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) != 0)
+      {
+        RCLCPP_WARN(getLogger(), "Could not pin benchmark worker %zu to a CPU", worker_index);
+      }
+#else
+      RCLCPP_WARN_ONCE(getLogger(), "Pinning benchmark workers to CPUs requires Linux");
+#endif
+    }
+
+    const auto& pipelines = worker_pipelines_[worker_index];
+    const planning_scene::PlanningScenePtr& planning_scene = worker_scenes[worker_index];
+    for (std::size_t run = next_run++; run < num_runs; run = next_run++)
+    {
+      const std::size_t i = run / options.runs;
+      const std::size_t j = run % options.runs;
+      const PlannerConfiguration& configuration = configurations[i];
+
+      moveit_msgs::msg::MotionPlanRequest run_request = configuration.request;
+      {
+        // Pre-run events
+        std::scoped_lock lock(events_mutex);
+        for (PreRunEventFunction& pre_event_function : pre_event_functions_)
+        {
+          pre_event_function(run_request);
+        }
+      }
+
+      std::vector<planning_interface::MotionPlanRequest> motion_plan_requests;
+      for (const auto& [pipeline_id, planner_id] : configuration.pipelines)
+      {
+        motion_plan_requests.push_back(run_request);
+        motion_plan_requests.back().pipeline_id = pipeline_id;
+        motion_plan_requests.back().planner_id = planner_id;
+      }
+      planning_scene->setCurrentState(run_request.start_state);
+
+      // Solve problem
+      const int concurrent_runs = ++active_runs;
+      std::chrono::system_clock::time_point start = std::chrono::system_clock::now();
+
+      planning_interface::MotionPlanResponse response;
+      double processing_time;
+      if (motion_plan_requests.size() == 1)
+      {
+        response = moveit::planning_pipeline_interfaces::planWithSinglePipeline(motion_plan_requests.front(),
+                                                                                planning_scene, pipelines);
+        processing_time = response.planning_time;
+      }
+      else
+      {
+        const auto plan_responses = moveit::planning_pipeline_interfaces::planWithParallelPipelines(
+            motion_plan_requests, planning_scene, pipelines, nullptr,
+            &moveit::planning_pipeline_interfaces::getShortestSolution);
+        if (!plan_responses.empty())
+        {
+          response = plan_responses.front();
+        }
+        else
+        {
+          response.error_code = moveit::core::MoveItErrorCode::FAILURE;
+        }
+        processing_time =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count();
+      }
+
+      std::chrono::duration<double> dt = std::chrono::system_clock::now() - start;
+      double total_time = dt.count();
+      --active_runs;
+
+      solved[i][j] = bool(response.error_code);
+      responses[i][j].error_code = response.error_code;
+      if (response.trajectory)
+      {
+        responses[i][j].description.push_back("plan");
+        responses[i][j].trajectory.push_back(response.trajectory);
+        responses[i][j].processing_time.push_back(processing_time);
+      }
+
+      // Collect data
+      std::scoped_lock lock(events_mutex);
+      // Post-run events
+      for (PostRunEventFunction& post_event_fn : post_event_functions_)
+      {
+        post_event_fn(run_request, responses[i][j], benchmark_data_[i][j]);
+      }
+      collectMetrics(benchmark_data_[i][j], responses[i][j], solved[i][j], total_time);
+      collectStatistics(benchmark_data_[i][j], response.statistics);
+      // Runs planning concurrently compete for CPU time, so report the load of each run
+      benchmark_data_[i][j]["concurrent_runs INTEGER"] = std::to_string(concurrent_runs);
+      ++progress;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t w = 0; w < num_workers; ++w)
+  {
+    threads.emplace_back(worker, w);
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (std::size_t i = 0; i < configurations.size(); ++i)
+  {
+    computeAveragePathSimilarities(benchmark_data_[i], responses[i], solved[i]);
+
+    // Planner completion events
+    for (PlannerCompletionEventFunction& planner_completion_fn : planner_completion_functions_)
+    {
+      planner_completion_fn(configurations[i].request, benchmark_data_[i]);
+    }
+  }
+}
+
 void BenchmarkExecutor::collectMetrics(PlannerRunData& metrics,
                                        const planning_interface::MotionPlanDetailedResponse& motion_plan_response,
                                        bool solved, double total_time)
@@ -1054,6 +1233,27 @@ void BenchmarkExecutor::collectMetrics(PlannerRunData& metrics,
   }
 }
 
+void BenchmarkExecutor::collectStatistics(PlannerRunData& metrics,
+                                          const planning_interface::MotionPlanStatistics& statistics)
+{
+  const auto collect_count = [&metrics](const std::string& name, const std::optional<std::size_t>& count) {
+    if (count)
+      metrics[name + " INTEGER"] = std::to_string(*count);
+  };
+  const auto collect_time = [&metrics](const std::string& name, const std::optional<double>& time) {
+    if (time)
+      metrics[name + " REAL"] = moveit::core::toString(*time);
+  };
+  collect_count("collision_checks", statistics.collision_checks);
+  collect_count("fk_calls", statistics.fk_calls);
+  collect_count("ik_calls", statistics.ik_calls);
+  collect_count("states_sampled", statistics.states_sampled);
+  collect_time("simplification_time", statistics.simplification_time);
+  collect_time("lock_wait_time", statistics.lock_wait_time);
+  for (const auto& [stage, time] : statistics.stage_times)
+    collect_time("stage_" + stage + "_time", time);
+}
+
 void BenchmarkExecutor::computeAveragePathSimilarities(
     PlannerBenchmarkData& planner_data, const std::vector<planning_interface::MotionPlanDetailedResponse>& responses,
     const std::vector<bool>& solved)
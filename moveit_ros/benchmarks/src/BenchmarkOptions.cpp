@@ -90,6 +90,8 @@ bool BenchmarkOptions::readBenchmarkOptions(const rclcpp::Node::SharedPtr& node)
     node->get_parameter_or(std::string("benchmark_config.parameters.predefined_poses"), predefined_poses, {});
     node->get_parameter_or(std::string("benchmark_config.parameters.predefined_poses_group"), predefined_poses_group,
                            std::string(""));
+    node->get_parameter_or(std::string("benchmark_config.parameters.workers"), workers, 1);
+    node->get_parameter_or(std::string("benchmark_config.parameters.pin_workers"), pin_workers, false);
 
     if (!node->get_parameter(std::string("benchmark_config.parameters.group"), group_name))
     {
@@ -47,6 +47,8 @@
 #include <moveit_msgs/action/global_planner.hpp>
 #include <moveit_msgs/msg/motion_plan_response.hpp>
 
+#include <functional>
+
 namespace moveit::hybrid_planning
 {
 /**
@@ -55,6 +57,9 @@ namespace moveit::hybrid_planning
 class GlobalPlannerInterface
 {
 public:
+  /** Callback receiving intermediate solutions of the global planner */
+  using SolutionCallback = std::function<void(const moveit_msgs::msg::MotionPlanResponse& solution)>;
+
   GlobalPlannerInterface() = default;
   GlobalPlannerInterface(const GlobalPlannerInterface&) = default;
   GlobalPlannerInterface(GlobalPlannerInterface&&) = default;
@@ -80,5 +85,20 @@ public:
    * @return True if reset was successful
    */
   virtual bool reset() noexcept = 0;
+
+  /**
+   * Set the callback that receives intermediate solutions while plan() is running, e.g. the first solutions of
+   * anytime or parallel planners, so that they can be executed before planning finishes. The final solution is only
+   * returned by plan().
+   * @param solution_callback Callback, which may be called from planner threads
+   */
+  void setSolutionCallback(const SolutionCallback& solution_callback)
+  {
+    solution_callback_ = solution_callback;
+  }
+
+protected:
+  // Receives intermediate solutions, may be empty
+  SolutionCallback solution_callback_;
 };
 }  // namespace moveit::hybrid_planning
@@ -144,6 +144,12 @@ bool GlobalPlannerComponent::initializeGlobalPlanner()
     return false;
   }
   RCLCPP_INFO(node_->get_logger(), "Using global planner plugin '%s'", planner_plugin_name_.c_str());
+
+  // Intermediate solutions are published like final ones, so that the local planner can follow them right away
+  global_planner_instance_->setSolutionCallback([this](const moveit_msgs::msg::MotionPlanResponse& solution) {
+    RCLCPP_INFO(node_->get_logger(), "Publishing intermediate global solution");
+    global_trajectory_pub_->publish(solution);
+  });
   return true;
 }
 
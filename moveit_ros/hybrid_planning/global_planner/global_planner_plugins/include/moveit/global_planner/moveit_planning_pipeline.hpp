@@ -44,6 +44,8 @@
 #include <moveit/moveit_cpp/moveit_cpp.hpp>
 #include <moveit/moveit_cpp/planning_component.hpp>
 
+#include <mutex>
+
 namespace moveit::hybrid_planning
 {
 class MoveItPlanningPipeline : public GlobalPlannerInterface
@@ -58,7 +60,24 @@ public:
       override;
 
 private:
+  // Convert a planning solution into a MotionPlanResponse message and remember it for predicting start states
+  moveit_msgs::msg::MotionPlanResponse toMsg(const planning_interface::MotionPlanResponse& solution,
+                                             const std::string& group_name);
+
+  // Predict the state the robot reaches after planning_time when it keeps following the last solution, nullptr if it
+  // does not follow it
+  moveit::core::RobotStatePtr predictStartState(const std::string& group_name, double planning_time);
+
   rclcpp::Node::SharedPtr node_ptr_;
   std::shared_ptr<moveit_cpp::MoveItCpp> moveit_cpp_;
+
+  // Namespaces of the plan request parameters of pipelines that run in parallel, empty to plan with a single pipeline
+  std::vector<std::string> parallel_plan_request_namespaces_;
+  // Plan replans from the predicted instead of the current state
+  bool predict_start_state_;
+
+  // Last returned or streamed solution, which is kept across resets
+  std::mutex last_solution_mutex_;
+  robot_trajectory::RobotTrajectoryPtr last_solution_;
 };
 }  // namespace moveit::hybrid_planning
@@ -33,16 +33,24 @@
  *********************************************************************/
 
 #include <moveit/global_planner/moveit_planning_pipeline.hpp>
+#include <moveit/planning_pipeline_interfaces/solution_selection_functions.hpp>
 #include <moveit/planning_scene/planning_scene.hpp>
 #include <moveit/robot_state/conversions.hpp>
 
+#include <limits>
+
 namespace moveit::hybrid_planning
 {
 const std::string PLANNING_SCENE_MONITOR_NS = "planning_scene_monitor_options.";
 const std::string PLANNING_PIPELINES_NS = "planning_pipelines.";
 const std::string PLAN_REQUEST_PARAM_NS = "plan_request_params.";
+const std::string PARALLEL_PLANNING_NS = "parallel_planning.";
 const std::string UNDEFINED = "<undefined>";
 
+// rad: L1-norm sum for all joints of the group. If the robot is farther away from the last solution, it is not
+// considered to follow it
+constexpr double FOLLOWING_DISTANCE_THRESHOLD = 0.2;
+
 bool MoveItPlanningPipeline::initialize(const rclcpp::Node::SharedPtr& node)
 {
   // TODO(andyz): how to standardize this for planning pipelines other than ompl?
@@ -62,6 +70,12 @@ bool MoveItPlanningPipeline::initialize(const rclcpp::Node::SharedPtr& node)
   node->declare_parameter<double>(PLAN_REQUEST_PARAM_NS + "max_acceleration_scaling_factor", 1.0);
   node->declare_parameter<std::vector<std::string>>("ompl.planning_plugins", { "ompl_interface/OMPLPlanner" });
 
+  // Replanning while executing: plan from the state the robot is predicted to reach after the planning time, and
+  // optionally run several pipelines in parallel whose solutions are streamed as soon as they improve
+  predict_start_state_ = node->declare_parameter<bool>(PLAN_REQUEST_PARAM_NS + "predict_start_state", false);
+  parallel_plan_request_namespaces_ = node->declare_parameter<std::vector<std::string>>(
+      PARALLEL_PLANNING_NS + "plan_request_namespaces", std::vector<std::string>());
+
   // Planning Scene options
   node->declare_parameter<std::string>(PLANNING_SCENE_MONITOR_NS + "name", UNDEFINED);
   node->declare_parameter<std::string>(PLANNING_SCENE_MONITOR_NS + "robot_description", UNDEFINED);
@@ -85,10 +99,62 @@ bool MoveItPlanningPipeline::initialize(const rclcpp::Node::SharedPtr& node)
 
 bool MoveItPlanningPipeline::reset() noexcept
 {
-  // Do Nothing
+  // The last solution is kept, since it predicts the start state of the next replan
   return true;
 }
 
+moveit_msgs::msg::MotionPlanResponse
+MoveItPlanningPipeline::toMsg(const planning_interface::MotionPlanResponse& solution, const std::string& group_name)
+{
+  moveit_msgs::msg::MotionPlanResponse response;
+  response.trajectory_start = solution.start_state;
+  response.group_name = group_name;
+  solution.trajectory->getRobotTrajectoryMsg(response.trajectory);
+  response.error_code = solution.error_code;
+
+  std::scoped_lock<std::mutex> lock(last_solution_mutex_);
+  last_solution_ = solution.trajectory;
+  return response;
+}
+
+moveit::core::RobotStatePtr MoveItPlanningPipeline::predictStartState(const std::string& group_name,
+                                                                       double planning_time)
+{
+  robot_trajectory::RobotTrajectoryPtr last_solution;
+  {
+    std::scoped_lock<std::mutex> lock(last_solution_mutex_);
+    last_solution = last_solution_;
+  }
+  moveit::core::RobotStatePtr current_state;
+  if (!last_solution || last_solution->empty() || !moveit_cpp_->getCurrentState(current_state, 1.0))
+    return nullptr;
+
+  // Find where the robot is along the last solution
+  const moveit::core::JointModelGroup* group = moveit_cpp_->getRobotModel()->getJointModelGroup(group_name);
+  if (group == nullptr)
+    return nullptr;
+  std::size_t closest_index = 0;
+  double closest_distance = std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < last_solution->getWayPointCount(); ++i)
+  {
+    const double distance = last_solution->getWayPoint(i).distance(*current_state, group);
+    if (distance < closest_distance)
+    {
+      closest_distance = distance;
+      closest_index = i;
+    }
+  }
+  if (closest_distance > FOLLOWING_DISTANCE_THRESHOLD)
+    return nullptr;
+
+  // The robot keeps following the last solution while planning, the state is clamped to its end
+  const double duration_from_start = last_solution->getWayPointDurationFromStart(closest_index) + planning_time;
+  moveit::core::RobotStatePtr predicted_state = std::make_shared<moveit::core::RobotState>(*current_state);
+  if (!last_solution->getStateAtDurationFromStart(duration_from_start, predicted_state))
+    return nullptr;
+  return predicted_state;
+}
+
 moveit_msgs::msg::MotionPlanResponse MoveItPlanningPipeline::plan(
     const std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::GlobalPlanner>> global_goal_handle)
 {
@@ -127,8 +193,53 @@ moveit_msgs::msg::MotionPlanResponse MoveItPlanningPipeline::plan(
   // Copy goal constraint into planning component
   planning_components->setGoal(motion_plan_req.goal_constraints);
 
+  // Replans start from where the robot will be once they are done, so that it doesn't need to stop for them
+  if (predict_start_state_)
+  {
+    if (const moveit::core::RobotStatePtr start_state =
+            predictStartState(motion_plan_req.group_name, plan_params.planning_time))
+    {
+      RCLCPP_INFO(node_ptr_->get_logger(), "Planning from the predicted state after %.2f s along the last solution",
+                  plan_params.planning_time);
+      planning_components->setStartState(*start_state);
+    }
+  }
+
   // Plan motion
-  auto plan_solution = planning_components->plan(plan_params);
+  planning_interface::MotionPlanResponse plan_solution;
+  if (parallel_plan_request_namespaces_.empty())
+  {
+    plan_solution = planning_components->plan(plan_params);
+  }
+  else
+  {
+    // Stream each solution that is shorter than the ones before, without waiting for the slower pipelines
+    const moveit_cpp::PlanningComponent::MultiPipelinePlanRequestParameters multi_plan_params(
+        node_ptr_, parallel_plan_request_namespaces_);
+    std::size_t streamed_solutions = 0;
+    double shortest_length = std::numeric_limits<double>::infinity();
+    const auto stream_solutions =
+        [&](const moveit::planning_pipeline_interfaces::PlanResponsesContainer& plan_responses_container,
+            const std::vector<planning_interface::MotionPlanRequest>& /* unused */) {
+          const std::vector<planning_interface::MotionPlanResponse>& solutions =
+              plan_responses_container.getSolutions();
+          for (; streamed_solutions < solutions.size(); ++streamed_solutions)
+          {
+            const planning_interface::MotionPlanResponse& solution = solutions[streamed_solutions];
+            if (!solution || !solution.trajectory)
+              continue;
+            const double length = robot_trajectory::pathLength(*solution.trajectory);
+            if (length < shortest_length && solution_callback_)
+            {
+              shortest_length = length;
+              solution_callback_(toMsg(solution, motion_plan_req.group_name));
+            }
+          }
+          return false;  // all pipelines run until their planning time is used up
+        };
+    plan_solution = planning_components->plan(
+        multi_plan_params, &moveit::planning_pipeline_interfaces::getShortestSolution, stream_solutions);
+  }
   if (!bool(plan_solution.error_code))
   {
     response.error_code = plan_solution.error_code;
@@ -136,12 +247,7 @@ moveit_msgs::msg::MotionPlanResponse MoveItPlanningPipeline::plan(
   }
 
   // Transform solution into MotionPlanResponse and publish it
-  response.trajectory_start = plan_solution.start_state;
-  response.group_name = motion_plan_req.group_name;
-  plan_solution.trajectory->getRobotTrajectoryMsg(response.trajectory);
-  response.error_code = plan_solution.error_code;
-
-  return response;
+  return toMsg(plan_solution, motion_plan_req.group_name);
 }
 }  // namespace moveit::hybrid_planning
 
@@ -0,0 +1,92 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planner_logic_plugins/continuous_replanning.hpp>
+
+namespace moveit::hybrid_planning
+{
+ReactionResult ContinuousReplanning::react(const HybridPlanningEvent& event)
+{
+  switch (event)
+  {
+    case HybridPlanningEvent::HYBRID_PLANNING_REQUEST_RECEIVED:
+      local_planner_started_ = false;
+      finished_ = false;
+      return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS,
+                            HybridPlanningAction::SEND_GLOBAL_SOLVER_REQUEST);
+    case HybridPlanningEvent::GLOBAL_SOLUTION_AVAILABLE:
+      // Intermediate solutions are executed right away, later ones replace the reference trajectory
+      if (!local_planner_started_ && !finished_)
+      {
+        local_planner_started_ = true;
+        return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS,
+                              HybridPlanningAction::SEND_LOCAL_SOLVER_REQUEST);
+      }
+      return ReactionResult(event, "Do nothing", moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+    case HybridPlanningEvent::GLOBAL_PLANNING_ACTION_SUCCESSFUL:
+      if (finished_)
+      {
+        return ReactionResult(event, "Do nothing", moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+      }
+      if (!local_planner_started_)
+      {
+        local_planner_started_ = true;
+        return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS,
+                              HybridPlanningAction::SEND_LOCAL_SOLVER_REQUEST);
+      }
+      // Replan from where the robot will be while it keeps executing the current solution
+      return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS,
+                            HybridPlanningAction::SEND_GLOBAL_SOLVER_REQUEST);
+    case HybridPlanningEvent::GLOBAL_PLANNING_ACTION_ABORTED:
+      // A failed replan keeps the current reference trajectory
+      if (local_planner_started_ || finished_)
+      {
+        return ReactionResult(event, "Keep executing the last global solution",
+                              moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+      }
+      return ReactionResult(event, "Global planner failed to find a solution",
+                            moveit_msgs::msg::MoveItErrorCodes::PLANNING_FAILED);
+    case HybridPlanningEvent::LOCAL_PLANNING_ACTION_SUCCESSFUL:
+      finished_ = true;
+      return ReactionResult(event, "", moveit_msgs::msg::MoveItErrorCodes::SUCCESS,
+                            HybridPlanningAction::RETURN_HP_SUCCESS);
+    default:
+      return ReplanInvalidatedTrajectory::react(event);
+  }
+}
+}  // namespace moveit::hybrid_planning
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(moveit::hybrid_planning::ContinuousReplanning, moveit::hybrid_planning::PlannerLogicInterface)
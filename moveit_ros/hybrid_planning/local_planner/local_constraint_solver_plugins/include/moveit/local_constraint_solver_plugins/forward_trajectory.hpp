@@ -34,8 +34,8 @@
 
 /* Author: Sebastian Jahr
    Description: Simple local solver plugin that forwards the next waypoint of the sampled local trajectory.
-   The local solver stops for two conditions: invalid waypoint (likely due to collision) or if it has been stuck for
-   several iterations.
+   The local solver stops for two conditions: invalid waypoint of the local trajectory (likely due to collision) or if
+   it has been stuck for several iterations.
  */
 
 #pragma once
@@ -61,6 +61,11 @@ public:
         trajectory_msgs::msg::JointTrajectory& local_solution) override;
 
 private:
+  // Write state as the only point of local_solution, reusing its storage
+  void setCommand(const moveit::core::RobotState& state, double time_from_start,
+                  const robot_trajectory::RobotTrajectory& local_trajectory,
+                  trajectory_msgs::msg::JointTrajectory& local_solution);
+
   rclcpp::Node::SharedPtr node_;
   planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor_;
   bool path_invalidation_event_send_;  // Send path invalidation event only once
@@ -69,5 +74,15 @@ private:
   // Detect when the local planner gets stuck
   size_t num_iterations_stuck_;
   moveit::core::RobotStatePtr prev_waypoint_target_;
+
+  // Read-only copy of the monitored scene for collision checking, with the versions of the scene it was copied from
+  planning_scene::PlanningScenePtr scene_;
+  std::uint64_t scene_world_version_ = 0;
+  std::uint64_t scene_collision_check_version_ = 0;
+
+  // Buffers reused by each iteration
+  moveit::core::RobotStatePtr current_state_;
+  std::vector<std::string> command_joint_names_;
+  std::vector<int> command_variable_indices_;
 };
 }  // namespace moveit::hybrid_planning
@@ -42,6 +42,22 @@ namespace
 // If stuck for this many iterations or more, abort the local planning action
 constexpr size_t STUCK_ITERATIONS_THRESHOLD = 5;
 constexpr double STUCK_THRESHOLD_RAD = 1e-4;  // L1-norm sum across all joints
+
+// Waypoints whose collision checks are memoized, the local trajectories of consecutive iterations mostly overlap
+constexpr std::size_t COLLISION_CHECK_CACHE_SIZE = 1024;
+
+// States are copied without attached bodies, which would be copied by allocating new ones
+constexpr unsigned int STATE_COPY_MASK =
+    moveit::core::RobotState::COPY_POSITIONS | moveit::core::RobotState::COPY_VELOCITIES |
+    moveit::core::RobotState::COPY_ACCELERATION_OR_EFFORT | moveit::core::RobotState::COPY_TRANSFORMS;
+
+// Copy the variables with the given indices into values, which keeps its storage if the size does not change
+void copyVariables(const double* variables, const std::vector<int>& indices, std::vector<double>& values)
+{
+  values.resize(indices.size());
+  for (std::size_t i = 0; i < indices.size(); ++i)
+    values[i] = variables[indices[i]];
+}
 }  // namespace
 
 namespace moveit::hybrid_planning
@@ -73,9 +89,52 @@ bool ForwardTrajectory::reset()
   num_iterations_stuck_ = 0;
   prev_waypoint_target_.reset();
   path_invalidation_event_send_ = false;
+  scene_.reset();
   return true;
 };
 
+void ForwardTrajectory::setCommand(const moveit::core::RobotState& state, double time_from_start,
+                                   const robot_trajectory::RobotTrajectory& local_trajectory,
+                                   trajectory_msgs::msg::JointTrajectory& local_solution)
+{
+  // The single-DOF joints of the group are looked up once
+  if (command_joint_names_.empty())
+  {
+    const moveit::core::JointModelGroup* group = local_trajectory.getGroup();
+    const std::vector<const moveit::core::JointModel*>& joints =
+        group ? group->getActiveJointModels() : local_trajectory.getRobotModel()->getActiveJointModels();
+    for (const moveit::core::JointModel* joint : joints)
+    {
+      if (joint->getVariableCount() == 1)
+      {
+        command_joint_names_.push_back(joint->getName());
+        command_variable_indices_.push_back(joint->getFirstVariableIndex());
+      }
+    }
+  }
+
+  // Assigning into the previous solution reuses the storage of its strings and vectors
+  local_solution.header.frame_id = local_trajectory.getRobotModel()->getModelFrame();
+  local_solution.header.stamp = rclcpp::Time(0, 0, RCL_ROS_TIME);
+  local_solution.joint_names = command_joint_names_;
+  local_solution.points.resize(1);
+  trajectory_msgs::msg::JointTrajectoryPoint& point = local_solution.points[0];
+  copyVariables(state.getVariablePositions(), command_variable_indices_, point.positions);
+  if (state.hasVelocities())
+    copyVariables(state.getVariableVelocities(), command_variable_indices_, point.velocities);
+  else
+    point.velocities.clear();
+  if (state.hasAccelerations())
+    copyVariables(state.getVariableAccelerations(), command_variable_indices_, point.accelerations);
+  else
+    point.accelerations.clear();
+  if (state.hasEffort())
+    copyVariables(state.getVariableEffort(), command_variable_indices_, point.effort);
+  else
+    point.effort.clear();
+  point.time_from_start = rclcpp::Duration::from_seconds(time_from_start);
+}
+
 moveit_msgs::action::LocalPlanner::Feedback
 ForwardTrajectory::solve(const robot_trajectory::RobotTrajectory& local_trajectory,
                          const std::shared_ptr<const moveit_msgs::action::LocalPlanner::Goal> /* unused */,
@@ -87,31 +146,46 @@ ForwardTrajectory::solve(const robot_trajectory::RobotTrajectory& local_trajecto
   RCLCPP_INFO_THROTTLE(node_->get_logger(), *node_->get_clock(), 2000 /* ms */, "The local planner is solving...");
 #pragma GCC diagnostic pop
 
-  // Create controller command trajectory
-  robot_trajectory::RobotTrajectory robot_command(local_trajectory.getRobotModel(), local_trajectory.getGroupName());
+  // Controller command, forwarded as local solution
+  const moveit::core::RobotState* command = &local_trajectory.getWayPoint(0);
+  double command_time_from_start = 0.0;
 
   // Feedback
   moveit_msgs::action::LocalPlanner::Feedback feedback_result;
 
   // If this flag is set, ignore collisions
-  if (!stop_before_collision_)
-  {
-    robot_command.addSuffixWayPoint(local_trajectory.getWayPoint(0), 0.0);
-  }
-  else
+  if (stop_before_collision_)
   {
     // Get current planning scene
     planning_scene_monitor_->updateFrameTransforms();
 
-    moveit::core::RobotStatePtr current_state;
-    bool is_path_valid = false;
+    if (!current_state_)
+      current_state_ = std::make_shared<moveit::core::RobotState>(local_trajectory.getRobotModel());
+    std::uint64_t world_version = 0;
+    std::uint64_t collision_check_version = 0;
     // Lock the planning scene as briefly as possible
     {
       planning_scene_monitor_->updateSceneWithCurrentState();
       planning_scene_monitor::LockedPlanningSceneRO locked_planning_scene(planning_scene_monitor_);
-      current_state = std::make_shared<moveit::core::RobotState>(locked_planning_scene->getCurrentState());
-      is_path_valid = locked_planning_scene->isPathValid(local_trajectory, local_trajectory.getGroupName(), false);
+      current_state_->copyFrom(locked_planning_scene->getCurrentState(), STATE_COPY_MASK);
+      world_version = locked_planning_scene->getWorld()->getVersion();
+      collision_check_version = locked_planning_scene->getCollisionCheckVersion();
+    }
+
+    // Collision checks use a scene that is only replaced when the world or the collision environment changes, so that
+    // the checks of waypoints that were already checked in earlier iterations are reused
+    if (!scene_ || world_version != scene_world_version_ || collision_check_version != scene_collision_check_version_)
+    {
+      const planning_scene::PlanningSceneConstPtr snapshot = planning_scene_monitor_->getSceneSnapshot();
+      if (snapshot)
+      {
+        scene_ = snapshot->diff();
+        scene_->setCollisionCheckCacheSize(COLLISION_CHECK_CACHE_SIZE);
+        scene_world_version_ = world_version;
+        scene_collision_check_version_ = collision_check_version;
+      }
     }
+    const bool is_path_valid = scene_ && scene_->isPathValid(local_trajectory, local_trajectory.getGroupName(), false);
 
     // Check if path is valid
     if (is_path_valid)
@@ -120,8 +194,7 @@ ForwardTrajectory::solve(const robot_trajectory::RobotTrajectory& local_trajecto
       {
         path_invalidation_event_send_ = false;  // Reset flag
       }
-      // Forward next waypoint to the robot controller
-      robot_command.addSuffixWayPoint(local_trajectory.getWayPoint(0), 0.0);
+      // Forward next waypoint to the robot controller, which is the default command
     }
     else
     {
@@ -132,28 +205,27 @@ ForwardTrajectory::solve(const robot_trajectory::RobotTrajectory& local_trajecto
       }
       RCLCPP_INFO(node_->get_logger(), "Collision ahead, holding current position");
       // Keep current position
-      moveit::core::RobotState current_state_command(*current_state);
-      if (current_state_command.hasVelocities())
+      if (current_state_->hasVelocities())
       {
-        current_state_command.zeroVelocities();
+        current_state_->zeroVelocities();
       }
-      if (current_state_command.hasAccelerations())
+      if (current_state_->hasAccelerations())
       {
-        current_state_command.zeroAccelerations();
+        current_state_->zeroAccelerations();
       }
-      robot_command.empty();
-      robot_command.addSuffixWayPoint(*current_state, local_trajectory.getWayPointDurationFromPrevious(0));
+      command = current_state_.get();
+      command_time_from_start = local_trajectory.getWayPointDurationFromPrevious(0);
     }
 
     // Detect if the local solver is stuck
     if (!prev_waypoint_target_)
     {
       // Just initialize if this is the first iteration
-      prev_waypoint_target_ = robot_command.getFirstWayPointPtr();
+      prev_waypoint_target_ = std::make_shared<moveit::core::RobotState>(*command);
     }
     else
     {
-      if (prev_waypoint_target_->distance(*robot_command.getFirstWayPointPtr()) <= STUCK_THRESHOLD_RAD)
+      if (prev_waypoint_target_->distance(*command) <= STUCK_THRESHOLD_RAD)
       {
         ++num_iterations_stuck_;
         if (num_iterations_stuck_ > STUCK_ITERATIONS_THRESHOLD)
@@ -165,14 +237,15 @@ ForwardTrajectory::solve(const robot_trajectory::RobotTrajectory& local_trajecto
           RCLCPP_INFO(node_->get_logger(), "The local planner has been stuck for several iterations. Aborting.");
         }
       }
-      prev_waypoint_target_ = robot_command.getFirstWayPointPtr();
+      if (prev_waypoint_target_)
+        prev_waypoint_target_->copyFrom(*command, STATE_COPY_MASK);
+      else
+        prev_waypoint_target_ = std::make_shared<moveit::core::RobotState>(*command);
     }
   }
 
-  // Transform robot trajectory into joint_trajectory message
-  moveit_msgs::msg::RobotTrajectory robot_command_msg;
-  robot_command.getRobotTrajectoryMsg(robot_command_msg);
-  local_solution = robot_command_msg.joint_trajectory;
+  // Write the command into the joint_trajectory message
+  setCommand(*command, command_time_from_start, local_trajectory, local_solution);
 
   return feedback_result;
 }
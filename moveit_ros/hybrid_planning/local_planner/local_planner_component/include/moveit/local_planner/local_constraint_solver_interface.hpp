@@ -77,7 +77,8 @@ public:
    * Solve local planning problem for the current iteration
    * @param local_trajectory The local trajectory to pursue
    * @param local_goal Local goal constraints
-   * @param local_solution solution plan in joint space
+   * @param local_solution solution plan in joint space. The same message is passed each iteration, so implementations
+   * should overwrite its contents in place to reuse its storage instead of assigning a newly created message
    * @return Feedback event from the current solver call i.e. "Collision detected"
    */
   virtual moveit_msgs::action::LocalPlanner::Feedback
@@ -61,6 +61,10 @@
 #include <tf2_ros/buffer.h>
 #include <tf2_ros/transform_listener.h>
 
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
 // Forward declaration of parameter class allows users to implement custom parameters
 namespace local_planner_parameters
 {
@@ -79,6 +83,16 @@ enum class LocalPlannerState : int8_t
   LOCAL_PLANNING_ACTIVE = 3
 };
 
+/// Timing statistics of the local planning loop. Each iteration is due at the end of the period it started in.
+struct LocalPlannerTimingStatistics
+{
+  std::size_t iterations = 0;       // Number of executed iterations
+  std::size_t overruns = 0;         // Number of iterations that finished after their deadline
+  std::size_t skipped_periods = 0;  // Number of periods without iteration because of overruns
+  std::chrono::nanoseconds max_iteration_duration{ 0 };
+  std::chrono::nanoseconds total_iteration_duration{ 0 };
+};
+
 /**
  * Class LocalPlannerComponent - ROS 2 component node that implements a local planner.
  */
@@ -108,9 +122,15 @@ public:
 
   /**
    * Handle the planners current job based on the internal state each iteration when the planner is started.
+   * Measures the iteration against its deadline, see getTimingStatistics().
    */
   void executeIteration();
 
+  /**
+   * Get the timing statistics of the current or last local planning loop
+   */
+  LocalPlannerTimingStatistics getTimingStatistics() const;
+
   // This function is required to make this class a valid NodeClass
   // see https://docs.ros2.org/foxy/api/rclcpp_components/register__node__macro_8hpp.html
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr get_node_base_interface()  // NOLINT
@@ -122,6 +142,12 @@ private:
   /** \brief Reset internal data members including state_ = LocalPlannerState::AWAIT_GLOBAL_TRAJECTORY */
   void reset();
 
+  /** \brief Handle the planners current job based on the internal state, called by executeIteration() */
+  void processState();
+
+  /** \brief Start the timer calling executeIteration() and reset the timing statistics */
+  void startLoop();
+
   std::shared_ptr<rclcpp::Node> node_;
 
   // Planner configuration
@@ -133,6 +159,18 @@ private:
   // Timer to periodically call executeIteration()
   rclcpp::TimerBase::SharedPtr timer_;
 
+  // Deadline scheduling of the local planning loop. The periods are counted from the start of the loop.
+  std::chrono::steady_clock::time_point loop_start_time_;
+  std::chrono::steady_clock::duration iteration_period_;
+  std::int64_t last_period_index_;
+  LocalPlannerTimingStatistics timing_statistics_;
+  mutable std::mutex timing_statistics_mutex_;
+
+  // Buffers reused by each iteration, in order not to allocate states and trajectories at the planning frequency
+  moveit::core::RobotStatePtr current_robot_state_;
+  robot_trajectory::RobotTrajectoryPtr local_trajectory_;
+  trajectory_msgs::msg::JointTrajectory local_solution_;
+
   // Latest action goal handle
   std::shared_ptr<rclcpp_action::ServerGoalHandle<moveit_msgs::action::LocalPlanner>> local_planning_goal_handle_;
 
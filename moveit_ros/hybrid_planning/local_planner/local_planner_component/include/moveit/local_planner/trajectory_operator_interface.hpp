@@ -87,6 +87,8 @@ public:
   /**
    * Return the current local constraints based on the newest robot state
    * @param current_state Current RobotState
+   * @param local_trajectory Local trajectory to follow. The same trajectory is passed each iteration, so
+   * implementations should overwrite its waypoints in place instead of allocating new ones
    * @return Current local constraints that define the local planning goal
    */
   virtual moveit_msgs::action::LocalPlanner::Feedback
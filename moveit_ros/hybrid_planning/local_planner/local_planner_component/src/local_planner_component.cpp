@@ -42,6 +42,8 @@
 
 #include <moveit_msgs/msg/constraints.hpp>
 
+#include <algorithm>
+
 namespace moveit::hybrid_planning
 {
 using namespace std::chrono_literals;
@@ -52,6 +54,16 @@ const auto JOIN_THREAD_TIMEOUT = std::chrono::seconds(1);
 
 // If the trajectory progress reaches more than 0.X the global goal state is considered as reached
 constexpr double PROGRESS_THRESHOLD = 0.995;
+
+// The current state is copied without attached bodies, which would be copied by allocating new ones
+constexpr unsigned int CURRENT_STATE_COPY_MASK =
+    moveit::core::RobotState::COPY_POSITIONS | moveit::core::RobotState::COPY_VELOCITIES |
+    moveit::core::RobotState::COPY_ACCELERATION_OR_EFFORT | moveit::core::RobotState::COPY_TRANSFORMS;
+
+double toMilliseconds(const std::chrono::nanoseconds& duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
 }  // namespace
 
 LocalPlannerComponent::LocalPlannerComponent(const rclcpp::NodeOptions& options)
@@ -101,6 +113,10 @@ bool LocalPlannerComponent::initialize()
   planning_scene_monitor_->monitorDiffs(true);
   planning_scene_monitor_->stopPublishingPlanningScene();
 
+  const moveit::core::RobotModelConstPtr& robot_model = planning_scene_monitor_->getRobotModel();
+  current_robot_state_ = std::make_shared<moveit::core::RobotState>(robot_model);
+  local_trajectory_ = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, config_->group_name);
+
   // Load trajectory operator plugin
   try
   {
@@ -197,11 +213,7 @@ bool LocalPlannerComponent::initialize()
         }
         // Start a local planning loop.
         // This needs to return quickly to avoid blocking the executor, so run the local planner in a new thread.
-        auto local_planner_timer = [&]() {
-          timer_ =
-              node_->create_wall_timer(1s / config_->local_planning_frequency, [this]() { return executeIteration(); });
-        };
-        long_callback_thread_ = std::thread(local_planner_timer);
+        long_callback_thread_ = std::thread([this]() { startLoop(); });
       },
       rcl_action_server_get_default_options(), cb_group_);
 
@@ -249,10 +261,70 @@ bool LocalPlannerComponent::initialize()
   return true;
 }
 
+void LocalPlannerComponent::startLoop()
+{
+  {
+    std::scoped_lock<std::mutex> lock(timing_statistics_mutex_);
+    iteration_period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / config_->local_planning_frequency));
+    loop_start_time_ = std::chrono::steady_clock::now();
+    last_period_index_ = -1;
+    timing_statistics_ = LocalPlannerTimingStatistics();
+  }
+  timer_ = node_->create_wall_timer(iteration_period_, [this]() { return executeIteration(); });
+}
+
+LocalPlannerTimingStatistics LocalPlannerComponent::getTimingStatistics() const
+{
+  std::scoped_lock<std::mutex> lock(timing_statistics_mutex_);
+  return timing_statistics_;
+}
+
 void LocalPlannerComponent::executeIteration()
 {
-  auto result = std::make_shared<moveit_msgs::action::LocalPlanner::Result>();
+  // The iteration is due at the end of the period it started in, a late start leaves less time
+  const auto start = std::chrono::steady_clock::now();
+  const std::int64_t period_index = (start - loop_start_time_) / iteration_period_;
+  const auto deadline = loop_start_time_ + (period_index + 1) * iteration_period_;
+
+  processState();
+
+  const auto end = std::chrono::steady_clock::now();
+  const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+  std::scoped_lock<std::mutex> lock(timing_statistics_mutex_);
+  ++timing_statistics_.iterations;
+  timing_statistics_.total_iteration_duration += duration;
+  timing_statistics_.max_iteration_duration = std::max(timing_statistics_.max_iteration_duration, duration);
+  if (period_index > last_period_index_ + 1)
+    timing_statistics_.skipped_periods += period_index - last_period_index_ - 1;
+  last_period_index_ = period_index;
+  if (end > deadline)
+  {
+    ++timing_statistics_.overruns;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+    RCLCPP_WARN_THROTTLE(node_->get_logger(), *node_->get_clock(), 1000 /* ms */,
+                         "Local planning iteration took %.2f ms and missed its deadline by %.2f ms "
+                         "(%zu of %zu iterations overran)",
+                         toMilliseconds(duration), toMilliseconds(end - deadline), timing_statistics_.overruns,
+                         timing_statistics_.iterations);
+#pragma GCC diagnostic pop
+  }
 
+  // Summarize the loop once it is stopped
+  if (timer_->is_canceled())
+  {
+    RCLCPP_INFO(node_->get_logger(),
+                "Local planning loop finished after %zu iterations: %zu overran and %zu periods were skipped, "
+                "iterations took %.2f ms on average and %.2f ms at most at a period of %.2f ms",
+                timing_statistics_.iterations, timing_statistics_.overruns, timing_statistics_.skipped_periods,
+                toMilliseconds(timing_statistics_.total_iteration_duration) / timing_statistics_.iterations,
+                toMilliseconds(timing_statistics_.max_iteration_duration), toMilliseconds(iteration_period_));
+  }
+}
+
+void LocalPlannerComponent::processState()
+{
   // Do different things depending on the planner's internal state
   switch (state_)
   {
@@ -263,6 +335,7 @@ void LocalPlannerComponent::executeIteration()
     // Notify action client that local planning failed
     case LocalPlannerState::ABORT:
     {
+      auto result = std::make_shared<moveit_msgs::action::LocalPlanner::Result>();
       result->error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
       result->error_message = "Local planner is in an aborted state. Resetting.";
       local_planning_goal_handle_->abort(result);
@@ -273,24 +346,22 @@ void LocalPlannerComponent::executeIteration()
     case LocalPlannerState::LOCAL_PLANNING_ACTIVE:
     {
       // Read current robot state
-      const moveit::core::RobotState current_robot_state = [this] {
+      {
         planning_scene_monitor::LockedPlanningSceneRO ls(planning_scene_monitor_);
-        return ls->getCurrentState();
-      }();
+        current_robot_state_->copyFrom(ls->getCurrentState(), CURRENT_STATE_COPY_MASK);
+      }
 
       // Check if the global goal is reached
-      if (trajectory_operator_instance_->getTrajectoryProgress(current_robot_state) > PROGRESS_THRESHOLD)
+      if (trajectory_operator_instance_->getTrajectoryProgress(*current_robot_state_) > PROGRESS_THRESHOLD)
       {
-        local_planning_goal_handle_->succeed(result);
+        local_planning_goal_handle_->succeed(std::make_shared<moveit_msgs::action::LocalPlanner::Result>());
         reset();
         return;
       }
 
       // Get local goal trajectory to follow
-      robot_trajectory::RobotTrajectory local_trajectory =
-          robot_trajectory::RobotTrajectory(planning_scene_monitor_->getRobotModel(), config_->group_name);
       *local_planner_feedback_ =
-          trajectory_operator_instance_->getLocalTrajectory(current_robot_state, local_trajectory);
+          trajectory_operator_instance_->getLocalTrajectory(*current_robot_state_, *local_trajectory_);
 
       // Feedback is only sent when the hybrid planning architecture should react to a discrete event that occurred
       // during the identification of the local planning problem
@@ -303,12 +374,12 @@ void LocalPlannerComponent::executeIteration()
       }
 
       // Solve local planning problem
-      trajectory_msgs::msg::JointTrajectory local_solution;
+      trajectory_msgs::msg::JointTrajectory& local_solution = local_solution_;
 
       // Feedback is only send when the hybrid planning architecture should react to a discrete event that occurred
       // while computing a local solution
       *local_planner_feedback_ = local_constraint_solver_instance_->solve(
-          local_trajectory, local_planning_goal_handle_->get_goal(), local_solution);
+          *local_trajectory_, local_planning_goal_handle_->get_goal(), local_solution);
 
       // Feedback is only send when the hybrid planning architecture should react to a discrete event
       if (!local_planner_feedback_->feedback.empty())
@@ -350,6 +421,7 @@ void LocalPlannerComponent::executeIteration()
     }
     default:
     {
+      auto result = std::make_shared<moveit_msgs::action::LocalPlanner::Result>();
       result->error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
       result->error_message = "Unexpected failure.";
       local_planning_goal_handle_->abort(result);
@@ -365,6 +437,7 @@ void LocalPlannerComponent::reset()
 {
   local_constraint_solver_instance_->reset();
   trajectory_operator_instance_->reset();
+  local_trajectory_->clear();
   timer_->cancel();
   state_ = LocalPlannerState::AWAIT_GLOBAL_TRAJECTORY;
 }
@@ -51,8 +51,8 @@ public:
   SimpleSampler() = default;
   ~SimpleSampler() override = default;
 
-  bool initialize([[maybe_unused]] const rclcpp::Node::SharedPtr& node,
-                  const moveit::core::RobotModelConstPtr& robot_model, const std::string& group_name) override;
+  bool initialize(const rclcpp::Node::SharedPtr& node, const moveit::core::RobotModelConstPtr& robot_model,
+                  const std::string& group_name) override;
   moveit_msgs::action::LocalPlanner::Feedback
   addTrajectorySegment(const robot_trajectory::RobotTrajectory& new_trajectory) override;
   moveit_msgs::action::LocalPlanner::Feedback
@@ -64,6 +64,8 @@ public:
 private:
   std::size_t
       next_waypoint_index_;  // Indicates which reference trajectory waypoint is the current local goal constrained
+  std::size_t trajectory_horizon_ = 1;       // Number of reference waypoints in the local trajectory
+  bool resume_from_current_state_ = false;  // Continue a replaced reference trajectory where the robot is
   moveit_msgs::action::LocalPlanner::Feedback feedback_;  // Empty feedback
   trajectory_processing::TimeOptimalTrajectoryGeneration time_parametrization_;
   const moveit::core::JointModelGroup* joint_group_;
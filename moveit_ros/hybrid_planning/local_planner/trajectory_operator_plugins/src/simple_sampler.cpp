@@ -36,6 +36,9 @@
 
 #include <moveit/kinematic_constraints/utils.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace moveit::hybrid_planning
 {
 namespace
@@ -43,9 +46,21 @@ namespace
 constexpr double WAYPOINT_RADIAN_TOLERANCE = 0.2;  // rad: L1-norm sum for all joints
 }  // namespace
 
-bool SimpleSampler::initialize([[maybe_unused]] const rclcpp::Node::SharedPtr& node,
-                               const moveit::core::RobotModelConstPtr& robot_model, const std::string& group_name)
+bool SimpleSampler::initialize(const rclcpp::Node::SharedPtr& node, const moveit::core::RobotModelConstPtr& robot_model,
+                               const std::string& group_name)
 {
+  // Upcoming reference waypoints in the local trajectory, which lets the local solver check them for collisions early
+  int trajectory_horizon = 1;
+  if (node->has_parameter("trajectory_horizon"))
+  {
+    node->get_parameter<int>("trajectory_horizon", trajectory_horizon);
+  }
+  else
+  {
+    trajectory_horizon = node->declare_parameter<int>("trajectory_horizon", 1);
+  }
+  trajectory_horizon_ = static_cast<std::size_t>(std::max(trajectory_horizon, 1));
+
   reference_trajectory_ = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model, group_name);
   next_waypoint_index_ = 0;
   joint_group_ = robot_model->getJointModelGroup(group_name);
@@ -64,6 +79,9 @@ SimpleSampler::addTrajectorySegment(const robot_trajectory::RobotTrajectory& new
   // Parametrize trajectory and calculate velocity and accelerations
   time_parametrization_.computeTimeStamps(*reference_trajectory_);
 
+  // Replanned trajectories start ahead of the robot, which must not return to their first waypoint
+  resume_from_current_state_ = true;
+
   // Return empty feedback
   return feedback_;
 }
@@ -85,11 +103,24 @@ SimpleSampler::getLocalTrajectory(const moveit::core::RobotState& current_state,
     return feedback_;
   }
 
-  // Delete previous local trajectory
-  local_trajectory.clear();
+  // Start following a new reference trajectory at the waypoint closest to the current state
+  if (resume_from_current_state_)
+  {
+    resume_from_current_state_ = false;
+    double closest_distance = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < reference_trajectory_->getWayPointCount(); ++i)
+    {
+      const double distance = reference_trajectory_->getWayPoint(i).distance(current_state, joint_group_);
+      if (distance < closest_distance)
+      {
+        closest_distance = distance;
+        next_waypoint_index_ = i;
+      }
+    }
+  }
 
   // Get next desired robot state
-  const moveit::core::RobotState next_desired_goal_state = reference_trajectory_->getWayPoint(next_waypoint_index_);
+  const moveit::core::RobotState& next_desired_goal_state = reference_trajectory_->getWayPoint(next_waypoint_index_);
 
   // Check if state is reached
   if (next_desired_goal_state.distance(current_state, joint_group_) <= WAYPOINT_RADIAN_TOLERANCE)
@@ -98,9 +129,31 @@ SimpleSampler::getLocalTrajectory(const moveit::core::RobotState& current_state,
     next_waypoint_index_ = std::min(next_waypoint_index_ + 1, reference_trajectory_->getWayPointCount() - 1);
   }
 
-  // Construct local trajectory containing the next global trajectory waypoint
-  local_trajectory.addSuffixWayPoint(reference_trajectory_->getWayPoint(next_waypoint_index_),
-                                     reference_trajectory_->getWayPointDurationFromPrevious(next_waypoint_index_));
+  // Construct local trajectory containing the next global trajectory waypoints within the horizon
+  const std::size_t waypoint_count =
+      std::min(trajectory_horizon_, reference_trajectory_->getWayPointCount() - next_waypoint_index_);
+  if (local_trajectory.getWayPointCount() == waypoint_count)
+  {
+    // Overwrite the waypoints of the previous iteration, which only allocates if the waypoints have attached bodies
+    for (std::size_t i = 0; i < waypoint_count; ++i)
+    {
+      const std::size_t index = next_waypoint_index_ + i;
+      local_trajectory.getWayPointPtr(i)->copyFrom(reference_trajectory_->getWayPoint(index),
+                                                   moveit::core::RobotState::COPY_ALL);
+      local_trajectory.setWayPointDurationFromPrevious(i,
+                                                       reference_trajectory_->getWayPointDurationFromPrevious(index));
+    }
+  }
+  else
+  {
+    local_trajectory.clear();
+    for (std::size_t i = 0; i < waypoint_count; ++i)
+    {
+      const std::size_t index = next_waypoint_index_ + i;
+      local_trajectory.addSuffixWayPoint(reference_trajectory_->getWayPoint(index),
+                                         reference_trajectory_->getWayPointDurationFromPrevious(index));
+    }
+  }
 
   // Return empty feedback
   return feedback_;
@@ -43,6 +43,10 @@ namespace move_group
 static const std::string PLANNER_SERVICE_NAME =
     "plan_kinematic_path";  // name of the advertised service (within the ~ namespace)
 static const std::string EXECUTE_ACTION_NAME = "execute_trajectory";  // name of 'execute' action
+static const std::string PLAN_BATCH_SERVICE_NAME =
+    "plan_kinematic_path_batch";  // name of the service that plans several independent requests concurrently
+static const std::string PLAN_BATCH_RESULTS_TOPIC_NAME =
+    "plan_kinematic_path_batch/results";  // topic on which the batch planning service streams its results
 static const std::string QUERY_PLANNERS_SERVICE_NAME =
     "query_planner_interface";  // name of the advertised query planners service
 static const std::string GET_PLANNER_PARAMS_SERVICE_NAME =
@@ -75,7 +75,7 @@ rclcpp::Logger getLogger()
 namespace move_group
 {
 MoveGroupCartesianPathService::MoveGroupCartesianPathService()
-  : MoveGroupCapability("CartesianPathService"), display_computed_paths_(true)
+  : MoveGroupCapability("CartesianPathService"), display_computed_paths_(true), thread_count_(1)
 {
 }
 
@@ -84,6 +84,11 @@ void MoveGroupCartesianPathService::initialize()
   display_path_ =
       context_->moveit_cpp_->getNode()->create_publisher<moveit_msgs::msg::DisplayTrajectory>(DISPLAY_PATH_TOPIC, 10);
 
+  // segments are only interpolated concurrently if the kinematics solver of the group supports concurrent calls
+  int thread_count = 1;
+  context_->moveit_cpp_->getNode()->get_parameter_or("cartesian_path_thread_count", thread_count, 1);
+  thread_count_ = static_cast<std::size_t>(std::max(0, thread_count));
+
   cartesian_path_service_ = context_->moveit_cpp_->getNode()->create_service<moveit_msgs::srv::GetCartesianPath>(
 
       CARTESIAN_PATH_SERVICE_NAME,
@@ -183,9 +188,13 @@ bool MoveGroupCartesianPathService::computeService(
             jump_threshold = moveit::core::JumpThreshold::relative(req->jump_threshold);
           }
           std::vector<moveit::core::RobotStatePtr> traj;
-          res->fraction = moveit::core::CartesianInterpolator::computeCartesianPath(
+          res->fraction = moveit::core::CartesianInterpolator::computeCartesianPathParallel(
               &start_state, jmg, traj, start_state.getLinkModel(link_name), waypoints, global_frame,
-              moveit::core::MaxEEFStep(req->max_step), moveit::core::CartesianPrecision{}, constraint_fn);
+              moveit::core::MaxEEFStep(req->max_step), moveit::core::CartesianPrecision{}, constraint_fn,
+              kinematics::KinematicsQueryOptions(), kinematics::KinematicsBase::IKCostFn(),
+              Eigen::Isometry3d::Identity(), thread_count_);
+          // this also covers the boundaries between the segments of the waypoints
+          res->fraction *= moveit::core::CartesianInterpolator::checkJointSpaceJump(jmg, traj, jump_threshold);
           moveit::core::robotStateToRobotStateMsg(start_state, res->start_state);
 
           robot_trajectory::RobotTrajectory rt(context_->planning_scene_monitor_->getRobotModel(), req->group_name);
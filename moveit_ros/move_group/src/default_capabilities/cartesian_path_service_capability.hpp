@@ -58,5 +58,6 @@ private:
   rclcpp::Publisher<moveit_msgs::msg::DisplayTrajectory>::SharedPtr display_path_;
 
   bool display_computed_paths_;
+  std::size_t thread_count_;  // threads interpolating the segments between waypoints, 0 for one per hardware thread
 };
 }  // namespace move_group
@@ -44,6 +44,7 @@
 #include <moveit/utils/message_checks.hpp>
 #include <moveit/move_group/capability_names.hpp>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
 
 namespace move_group
 {
@@ -84,6 +85,7 @@ void MoveGroupMoveAction::initialize()
 
 void MoveGroupMoveAction::executeMoveCallback(const std::shared_ptr<MGActionGoal>& goal)
 {
+  MOVEIT_TRACEPOINT_SCOPE("move_group.move_action");
   goal_ = goal;
   RCLCPP_INFO(getLogger(), "executing..");
   setMoveState(PLANNING, goal_);
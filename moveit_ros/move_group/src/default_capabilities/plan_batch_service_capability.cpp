@@ -0,0 +1,179 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Plan several independent motion plan requests concurrently against one planning scene snapshot */
+
+#include "plan_batch_service_capability.hpp"
+
+#include <moveit/moveit_cpp/moveit_cpp.hpp>
+#include <moveit/planning_pipeline/planning_pipeline.hpp>
+#include <moveit/move_group/capability_names.hpp>
+#include <moveit/robot_state/conversions.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace move_group
+{
+
+namespace
+{
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.ros.move_group.plan_batch_service");
+}
+}  // namespace
+
+MoveGroupPlanBatchService::MoveGroupPlanBatchService() : MoveGroupCapability("motion_plan_batch_service")
+{
+}
+
+void MoveGroupPlanBatchService::initialize()
+{
+  const rclcpp::Node::SharedPtr& node = context_->moveit_cpp_->getNode();
+  int thread_count = 0;
+  node->get_parameter_or("plan_batch_thread_count", thread_count, 0);
+  thread_count_ = thread_count > 0 ? static_cast<std::size_t>(thread_count) :
+                                     std::max(1u, std::thread::hardware_concurrency());
+
+  result_publisher_ = node->create_publisher<moveit_msgs::msg::MotionPlanDetailedResponse>(
+      PLAN_BATCH_RESULTS_TOPIC_NAME, rclcpp::SystemDefaultsQoS());
+  plan_batch_service_ = node->create_service<moveit_msgs::srv::GetMotionSequence>(
+      PLAN_BATCH_SERVICE_NAME, [this](const std::shared_ptr<rmw_request_id_t>& request_header,
+                                      const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Request>& req,
+                                      const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Response>& res) {
+        return computePlanBatchService(request_header, req, res);
+      });
+}
+
+bool MoveGroupPlanBatchService::computePlanBatchService(
+    const std::shared_ptr<rmw_request_id_t>& /* unused */,
+    const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Request>& req,
+    const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Response>& res)
+{
+  const std::vector<moveit_msgs::msg::MotionSequenceItem>& items = req->request.items;
+  RCLCPP_INFO(getLogger(), "Received new batch planning service request with %zu motion plan requests...",
+              items.size());
+  res->response.error_code.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+  if (items.empty())
+    return true;
+
+  const rclcpp::Time planning_start = context_->moveit_cpp_->getNode()->now();
+  // before we start planning, ensure that we have the latest robot state received...
+  if (std::any_of(items.begin(), items.end(), [](const moveit_msgs::msg::MotionSequenceItem& item) {
+        return static_cast<bool>(item.req.start_state.is_diff);
+      }))
+    context_->planning_scene_monitor_->waitForCurrentRobotState(planning_start);
+  context_->planning_scene_monitor_->updateFrameTransforms();
+
+  // plan all requests against the same copy of the scene, so that scene updates neither block nor affect the batch
+  planning_scene::PlanningSceneConstPtr planning_scene;
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
+    planning_scene = planning_scene::PlanningScene::clone(ps);
+  }
+  moveit::core::robotStateToRobotStateMsg(planning_scene->getCurrentState(), res->response.sequence_start);
+
+  std::vector<moveit_msgs::msg::MotionPlanResponse> responses(items.size());
+  std::atomic<std::size_t> next_request{ 0 };
+  const auto plan_requests = [&]() {
+    for (std::size_t i = next_request++; i < items.size(); i = next_request++)
+    {
+      planRequest(planning_scene, items[i].req, responses[i]);
+
+      moveit_msgs::msg::MotionPlanDetailedResponse result;
+      result.trajectory_start = responses[i].trajectory_start;
+      result.group_name = responses[i].group_name;
+      result.trajectory.push_back(responses[i].trajectory);
+      result.description.push_back(std::to_string(i));
+      result.processing_time.push_back(responses[i].planning_time);
+      result.error_code = responses[i].error_code;
+      result_publisher_->publish(result);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < std::min(thread_count_, items.size()); ++i)
+    threads.emplace_back(plan_requests);
+  plan_requests();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // report the first failure, the individual error codes are available from the streamed results
+  res->response.planned_trajectories.resize(items.size());
+  for (std::size_t i = 0; i < items.size(); ++i)
+  {
+    res->response.planned_trajectories[i] = std::move(responses[i].trajectory);
+    if (res->response.error_code.val == moveit_msgs::msg::MoveItErrorCodes::SUCCESS)
+      res->response.error_code = responses[i].error_code;
+  }
+  res->response.planning_time = (context_->moveit_cpp_->getNode()->now() - planning_start).seconds();
+  return true;
+}
+
+void MoveGroupPlanBatchService::planRequest(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                            const moveit_msgs::msg::MotionPlanRequest& req,
+                                            moveit_msgs::msg::MotionPlanResponse& res) const
+{
+  // Select planning_pipeline to handle request
+  const planning_pipeline::PlanningPipelinePtr planning_pipeline = resolvePlanningPipeline(req.pipeline_id);
+  if (!planning_pipeline)
+  {
+    res.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+    return;
+  }
+
+  try
+  {
+    planning_interface::MotionPlanResponse mp_res;
+    if (!planning_pipeline->generatePlan(planning_scene, req, mp_res, context_->debug_))
+    {
+      RCLCPP_ERROR(getLogger(), "Generating a plan with planning pipeline failed.");
+      mp_res.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+    }
+    mp_res.getMessage(res);
+  }
+  catch (std::exception& ex)
+  {
+    RCLCPP_ERROR(getLogger(), "Planning pipeline threw an exception: %s", ex.what());
+    res.error_code.val = moveit_msgs::msg::MoveItErrorCodes::FAILURE;
+  }
+}
+}  // namespace move_group
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(move_group::MoveGroupPlanBatchService, move_group::MoveGroupCapability)
@@ -0,0 +1,68 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Plan several independent motion plan requests concurrently against one planning scene snapshot */
+
+#pragma once
+
+#include <moveit/move_group/move_group_capability.hpp>
+#include <moveit_msgs/msg/motion_plan_detailed_response.hpp>
+#include <moveit_msgs/srv/get_motion_sequence.hpp>
+
+namespace move_group
+{
+/** \brief Plans the items of a motion sequence request as independent queries, concurrently and against one snapshot
+ * of the planning scene. planned_trajectories[i] of the response holds the solution of items[i], which is empty if
+ * planning failed. Each result is also published on PLAN_BATCH_RESULTS_TOPIC_NAME as soon as it is available, with the
+ * index of its request as description. The blend radii of the items are ignored. */
+class MoveGroupPlanBatchService : public MoveGroupCapability
+{
+public:
+  MoveGroupPlanBatchService();
+
+  void initialize() override;
+
+private:
+  bool computePlanBatchService(const std::shared_ptr<rmw_request_id_t>& request_header,
+                               const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Request>& req,
+                               const std::shared_ptr<moveit_msgs::srv::GetMotionSequence::Response>& res);
+
+  void planRequest(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                   const moveit_msgs::msg::MotionPlanRequest& req, moveit_msgs::msg::MotionPlanResponse& res) const;
+
+  rclcpp::Service<moveit_msgs::srv::GetMotionSequence>::SharedPtr plan_batch_service_;
+  rclcpp::Publisher<moveit_msgs::msg::MotionPlanDetailedResponse>::SharedPtr result_publisher_;
+  std::size_t thread_count_;
+};
+}  // namespace move_group
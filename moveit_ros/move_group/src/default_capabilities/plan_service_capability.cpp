@@ -40,6 +40,7 @@
 #include <moveit/planning_pipeline/planning_pipeline.hpp>
 #include <moveit/move_group/capability_names.hpp>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
 
 namespace move_group
 {
@@ -70,6 +71,7 @@ bool MoveGroupPlanService::computePlanService(const std::shared_ptr<rmw_request_
                                               const std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Request>& req,
                                               const std::shared_ptr<moveit_msgs::srv::GetMotionPlan::Response>& res)
 {
+  MOVEIT_TRACEPOINT_SCOPE("move_group.plan_service");
   RCLCPP_INFO(getLogger(), "Received new planning service request...");
   // before we start planning, ensure that we have the latest robot state received...
   if (static_cast<bool>(req->motion_plan_request.start_state.is_diff))
@@ -0,0 +1,361 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/*      Title     : servo_benchmark.cpp
+ *      Project   : moveit_servo
+ *      Created   : 10/14/2026
+ *      Author    : MoveIt maintainers
+ *
+ *      Description : Measures the latency, jitter and allocations of servo cycles for the different command types,
+ *                    on a simulated robot that follows the commands perfectly.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <moveit_servo/servo.hpp>
+#include <moveit_servo/utils/common.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/joint_state.hpp>
+#include <moveit/utils/logger.hpp>
+
+using namespace moveit_servo;
+
+namespace
+{
+// Allocations are only counted in the benchmark thread, while a cycle is measured
+thread_local bool count_allocations = false;
+thread_local std::size_t allocation_count = 0;
+
+struct CycleStatistics
+{
+  std::vector<double> cycle_times;     // [s]
+  std::vector<double> wakeup_jitters;  // [s]
+  std::size_t allocations = 0;
+  std::size_t missed_deadlines = 0;
+};
+
+double percentile(std::vector<double> values, double fraction)
+{
+  if (values.empty())
+  {
+    return 0.0;
+  }
+  const auto index = static_cast<std::size_t>(std::round(fraction * static_cast<double>(values.size() - 1)));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+// Update the command for the time since the start of the benchmark, in place to not disturb the allocation count
+void updateCommand(ServoInput& command, double time, const Eigen::Isometry3d& initial_pose)
+{
+  const double wave = std::sin(2.0 * M_PI * time / 4.0);
+  if (auto* joint_jog = std::get_if<JointJogCommand>(&command))
+  {
+    std::fill(joint_jog->velocities.begin(), joint_jog->velocities.end(), 0.2 * wave);
+  }
+  else if (auto* twist = std::get_if<TwistCommand>(&command))
+  {
+    twist->velocities << 0.0, 0.0, 0.05 * wave, 0.0, 0.0, 0.2 * wave;
+  }
+  else if (auto* pose = std::get_if<PoseCommand>(&command))
+  {
+    pose->pose = initial_pose;
+    pose->pose.translate(Eigen::Vector3d(0.0, 0.0, 0.05 * (1.0 - std::cos(2.0 * M_PI * time / 4.0))));
+  }
+}
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+  if (count_allocations)
+  {
+    ++allocation_count;
+  }
+  if (void* ptr = std::malloc(size == 0 ? 1 : size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (count_allocations)
+  {
+    ++allocation_count;
+  }
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, std::max(static_cast<std::size_t>(alignment), sizeof(void*)), size == 0 ? 1 : size) == 0)
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /* alignment */) noexcept
+{
+  std::free(ptr);
+}
+
+int main(int argc, char* argv[])
+{
+  rclcpp::init(argc, argv);
+
+  const rclcpp::Node::SharedPtr node = std::make_shared<rclcpp::Node>("moveit_servo_benchmark");
+  moveit::setNodeLoggerName(node->get_name());
+
+  const std::string param_namespace = "moveit_servo";
+  const std::shared_ptr<const servo::ParamListener> servo_param_listener =
+      std::make_shared<const servo::ParamListener>(node, param_namespace);
+  const servo::Params servo_params = servo_param_listener->get_params();
+
+  const double rate = node->declare_parameter<double>("benchmark.rate", 1.0 / servo_params.publish_period);
+  const auto num_cycles = node->declare_parameter<int64_t>("benchmark.cycles", 2000);
+  const auto command_types = node->declare_parameter<std::vector<std::string>>(
+      "benchmark.command_types", std::vector<std::string>{ "joint_jog", "twist", "pose" });
+  const auto initial_state = node->declare_parameter<std::string>("benchmark.initial_state", "ready");
+  const auto output_file = node->declare_parameter<std::string>("benchmark.output_file", "");
+
+  const planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor =
+      createPlanningSceneMonitor(node, servo_params);
+  const moveit::core::RobotModelConstPtr& robot_model = planning_scene_monitor->getRobotModel();
+  const moveit::core::JointModelGroup* joint_model_group =
+      robot_model->getJointModelGroup(servo_params.move_group_name);
+  if (joint_model_group == nullptr)
+  {
+    RCLCPP_ERROR_STREAM(node->get_logger(), "Unknown move group " << servo_params.move_group_name);
+    return EXIT_FAILURE;
+  }
+
+  // The simulated robot follows the commands perfectly, its joint states are published as if by the robot driver
+  auto simulated_state = std::make_shared<moveit::core::RobotState>(robot_model);
+  simulated_state->setToDefaultValues();
+  if (!initial_state.empty() && !simulated_state->setToDefaultValues(joint_model_group, initial_state))
+  {
+    RCLCPP_WARN_STREAM(node->get_logger(), "Unknown named state " << initial_state << ", starting at default values");
+  }
+  simulated_state->update();
+  const moveit::core::RobotState start_state(*simulated_state);
+
+  std::mutex simulated_state_mutex;
+  std::atomic<bool> stop_joint_states{ false };
+  auto joint_state_publisher =
+      node->create_publisher<sensor_msgs::msg::JointState>(servo_params.joint_topic, rclcpp::SystemDefaultsQoS());
+  std::thread joint_state_thread([&] {
+    sensor_msgs::msg::JointState joint_state;
+    joint_state.name = robot_model->getVariableNames();
+    rclcpp::WallRate joint_state_rate(1.0 / servo_params.publish_period);
+    while (rclcpp::ok() && !stop_joint_states)
+    {
+      {
+        std::lock_guard<std::mutex> lock(simulated_state_mutex);
+        joint_state.position.assign(simulated_state->getVariablePositions(),
+                                    simulated_state->getVariablePositions() + robot_model->getVariableCount());
+        joint_state.velocity.assign(simulated_state->getVariableVelocities(),
+                                    simulated_state->getVariableVelocities() + robot_model->getVariableCount());
+      }
+      joint_state.header.stamp = node->now();
+      joint_state_publisher->publish(joint_state);
+      joint_state_rate.sleep();
+    }
+  });
+
+  // The joint commands are published like by the servo node, nobody needs to listen
+  trajectory_msgs::msg::JointTrajectory trajectory_message;
+  std_msgs::msg::Float64MultiArray multi_array_message;
+  rclcpp::Publisher<trajectory_msgs::msg::JointTrajectory>::SharedPtr trajectory_publisher;
+  rclcpp::Publisher<std_msgs::msg::Float64MultiArray>::SharedPtr multi_array_publisher;
+  const bool use_trajectory = servo_params.command_out_type == "trajectory_msgs/JointTrajectory";
+  if (use_trajectory)
+  {
+    trajectory_publisher = node->create_publisher<trajectory_msgs::msg::JointTrajectory>(
+        servo_params.command_out_topic, rclcpp::SystemDefaultsQoS());
+  }
+  else
+  {
+    multi_array_publisher = node->create_publisher<std_msgs::msg::Float64MultiArray>(servo_params.command_out_topic,
+                                                                                     rclcpp::SystemDefaultsQoS());
+  }
+
+  Servo servo(node, servo_param_listener, planning_scene_monitor);
+  auto robot_state = planning_scene_monitor->getStateMonitor()->getCurrentState();
+  const auto base_frame = getIKSolverBaseFrame(robot_state, servo_params.move_group_name);
+  const auto tip_frame = getIKSolverTipFrame(robot_state, servo_params.move_group_name);
+
+  // The results of several runs, e.g. for different configurations, are appended to the same file
+  std::ofstream output;
+  if (!output_file.empty())
+  {
+    const bool write_header = !std::ifstream(output_file).good();
+    output.open(output_file, std::ios::app);
+    if (output.is_open() && write_header)
+    {
+      output << "command_type,rate,cycles,p50_cycle_time,p90_cycle_time,p99_cycle_time,p999_cycle_time,"
+                "max_cycle_time,p99_wakeup_jitter,max_wakeup_jitter,allocations_per_cycle,missed_deadlines\n";
+    }
+  }
+
+  const auto period =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate));
+  for (const std::string& command_type : command_types)
+  {
+    ServoInput command;
+    if (command_type == "joint_jog")
+    {
+      servo.setCommandType(CommandType::JOINT_JOG);
+      const auto& joint_names = joint_model_group->getActiveJointModelNames();
+      command = JointJogCommand{ joint_names, std::vector<double>(joint_names.size(), 0.0) };
+    }
+    else if (command_type == "twist" && base_frame.has_value())
+    {
+      servo.setCommandType(CommandType::TWIST);
+      command = TwistCommand{ *base_frame, Eigen::Vector<double, 6>::Zero() };
+    }
+    else if (command_type == "pose" && base_frame.has_value() && tip_frame.has_value())
+    {
+      servo.setCommandType(CommandType::POSE);
+      command = PoseCommand{ *base_frame, Eigen::Isometry3d::Identity() };
+    }
+    else
+    {
+      RCLCPP_ERROR_STREAM(node->get_logger(), "Skipping unknown or unsupported command type " << command_type);
+      continue;
+    }
+
+    // Start every command type at the same state
+    {
+      std::lock_guard<std::mutex> lock(simulated_state_mutex);
+      *simulated_state = start_state;
+    }
+    *robot_state = start_state;
+    Eigen::Isometry3d initial_pose = Eigen::Isometry3d::Identity();
+    if (base_frame.has_value() && tip_frame.has_value())
+    {
+      initial_pose = robot_state->getGlobalLinkTransform(*base_frame).inverse() *
+                     robot_state->getGlobalLinkTransform(*tip_frame);
+    }
+    std::deque<KinematicState> joint_cmd_rolling_window;
+    KinematicState next_joint_state = extractRobotState(robot_state, servo_params.move_group_name);
+    servo.resetSmoothing(next_joint_state);
+
+    CycleStatistics statistics;
+    statistics.cycle_times.reserve(static_cast<std::size_t>(num_cycles));
+    statistics.wakeup_jitters.reserve(static_cast<std::size_t>(num_cycles));
+    const auto start = std::chrono::steady_clock::now();
+    auto deadline = start;
+    for (int64_t cycle = 0; cycle < num_cycles && rclcpp::ok(); ++cycle)
+    {
+      std::this_thread::sleep_until(deadline);
+      const auto wakeup = std::chrono::steady_clock::now();
+
+      // Measure from the receipt of the command to the publication of the joint command
+      allocation_count = 0;
+      count_allocations = true;
+      updateCommand(command, std::chrono::duration<double>(wakeup - start).count(), initial_pose);
+      servo.getNextJointState(robot_state, command, next_joint_state);
+      const bool valid = servo.getStatus() != StatusCode::INVALID;
+      if (valid && use_trajectory)
+      {
+        updateSlidingWindow(next_joint_state, joint_cmd_rolling_window, servo_params.max_expected_latency, node->now());
+        if (composeTrajectoryMessage(servo_params, joint_cmd_rolling_window, trajectory_message))
+        {
+          trajectory_publisher->publish(trajectory_message);
+        }
+      }
+      else if (valid)
+      {
+        composeMultiArrayMessage(servo_params, next_joint_state, multi_array_message);
+        multi_array_publisher->publish(multi_array_message);
+      }
+      const auto done = std::chrono::steady_clock::now();
+      count_allocations = false;
+
+      statistics.cycle_times.push_back(std::chrono::duration<double>(done - wakeup).count());
+      statistics.wakeup_jitters.push_back(std::chrono::duration<double>(wakeup - deadline).count());
+      statistics.allocations += allocation_count;
+      deadline += period;
+      if (done > deadline)
+      {
+        ++statistics.missed_deadlines;
+      }
+
+      // The simulated robot reaches the commanded state
+      if (valid)
+      {
+        robot_state->setJointGroupPositions(joint_model_group, next_joint_state.positions);
+        robot_state->setJointGroupVelocities(joint_model_group, next_joint_state.velocities);
+        std::lock_guard<std::mutex> lock(simulated_state_mutex);
+        *simulated_state = *robot_state;
+      }
+    }
+
+    const std::size_t measured_cycles = statistics.cycle_times.size();
+    const double allocations_per_cycle =
+        measured_cycles > 0 ? static_cast<double>(statistics.allocations) / static_cast<double>(measured_cycles) : 0.0;
+    const double us = 1e6;
+    RCLCPP_INFO(node->get_logger(),
+                "%s: %zu cycles at %.1f Hz, cycle time [us] p50 %.1f p90 %.1f p99 %.1f p99.9 %.1f max %.1f, "
+                "wakeup jitter [us] p99 %.1f max %.1f, %.2f allocations per cycle, %zu missed deadlines",
+                command_type.c_str(), measured_cycles, rate, us * percentile(statistics.cycle_times, 0.5),
+                us * percentile(statistics.cycle_times, 0.9), us * percentile(statistics.cycle_times, 0.99),
+                us * percentile(statistics.cycle_times, 0.999), us * percentile(statistics.cycle_times, 1.0),
+                us * percentile(statistics.wakeup_jitters, 0.99), us * percentile(statistics.wakeup_jitters, 1.0),
+                allocations_per_cycle, statistics.missed_deadlines);
+    if (output.is_open())
+    {
+      output << command_type << ',' << rate << ',' << measured_cycles << ',' << percentile(statistics.cycle_times, 0.5)
+             << ',' << percentile(statistics.cycle_times, 0.9) << ',' << percentile(statistics.cycle_times, 0.99) << ','
+             << percentile(statistics.cycle_times, 0.999) << ',' << percentile(statistics.cycle_times, 1.0) << ','
+             << percentile(statistics.wakeup_jitters, 0.99) << ',' << percentile(statistics.wakeup_jitters, 1.0)
+             << ',' << allocations_per_cycle << ',' << statistics.missed_deadlines << '\n';
+    }
+  }
+
+  stop_joint_states = true;
+  joint_state_thread.join();
+  rclcpp::shutdown();
+  return EXIT_SUCCESS;
+}
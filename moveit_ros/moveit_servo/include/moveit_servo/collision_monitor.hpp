@@ -42,8 +42,10 @@
 #pragma once
 
 #include <moveit_servo_lib_parameters.hpp>
+#include <moveit/collision_detection/distance_query.hpp>
 #include <moveit/planning_scene_monitor/planning_scene_monitor.hpp>
 #include <moveit/planning_scene/planning_scene.hpp>
+#include <condition_variable>
 
 namespace moveit_servo
 {
@@ -51,22 +53,138 @@ namespace moveit_servo
 class CollisionMonitor
 {
 public:
+  /**
+   * \brief Create a collision monitor for the move group of the servo parameters.
+   * Further groups can be added to share the planning scene and the collision checking thread, e.g. for dual arms.
+   * @param planning_scene_monitor The planning scene monitor providing the state and the scene to check.
+   * @param servo_params The parameters of the move group, they must outlive the collision monitor or its group.
+   * @param collision_velocity_scale The velocity scaling of the move group, updated by the collision monitor.
+   */
   CollisionMonitor(const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor,
                    const servo::Params& servo_params, std::atomic<double>& collision_velocity_scale);
 
+  ~CollisionMonitor();
+
+  CollisionMonitor(const CollisionMonitor&) = delete;
+  CollisionMonitor& operator=(const CollisionMonitor&) = delete;
+
   void start();
 
   void stop();
 
+  /**
+   * \brief Add a move group whose collisions are checked in the same cycles as those of the other groups.
+   * The rates and the lookahead horizon of the first added group apply to all groups.
+   * @param servo_params The parameters of the move group, they must outlive the collision monitor or its group.
+   * @param collision_velocity_scale The velocity scaling of the move group, updated by the collision monitor.
+   * @return False if the group is unknown or was added already.
+   */
+  bool addGroup(const servo::Params& servo_params, std::atomic<double>& collision_velocity_scale);
+
+  /**
+   * \brief Remove a move group, its velocity scaling is no longer updated.
+   * @param group_name The name of the move group.
+   */
+  void removeGroup(const std::string& group_name);
+
+  /**
+   * \brief Enable or disable the collision checks of a move group. The velocity scaling of a disabled group keeps
+   * its last value.
+   * @param group_name The name of the move group.
+   * @param check_collisions Whether collisions of the group are checked.
+   */
+  void setCollisionChecking(const std::string& group_name, bool check_collisions);
+
+  /**
+   * \brief Update the joint velocities commanded by servo, which are propagated by the collision lookahead.
+   * This never blocks: the update is skipped while the collision monitor thread checks collisions.
+   * @param group_name The name of the commanded move group.
+   * @param joint_position_delta The commanded change of the joint group positions over one servo period.
+   * @param period The servo period [s].
+   */
+  void updateCommandedVelocities(const std::string& group_name, const Eigen::VectorXd& joint_position_delta,
+                                 double period);
+
 private:
+  // The collision checking state of a move group
+  struct Group
+  {
+    Group(const servo::Params& servo_params, std::atomic<double>& collision_velocity_scale,
+          const moveit::core::RobotModelConstPtr& robot_model);
+
+    const servo::Params& servo_params;
+    std::atomic<double>& collision_velocity_scale;
+    const moveit::core::JointModelGroup* joint_model_group;
+    bool enabled = true;
+
+    // The distance queries for robot self collisions and for collisions with other objects in the collision scene.
+    // They are warm started with the closest pair of the previous check.
+    collision_detection::DistanceQuery self_distance_query;
+    collision_detection::DistanceQuery scene_distance_query;
+
+    // The state of the last check: the positions of the links of the move group and their least clearance to the
+    // distance at which servo decelerates
+    std::vector<Eigen::Vector3d> checked_link_positions;
+    double checked_clearance = 0.0;
+
+    // The commanded joint velocities and the buffer of the lookahead positions
+    Eigen::VectorXd commanded_velocities;
+    Eigen::VectorXd lookahead_positions;
+  };
+
   /**
    * \brief The collision checking function, this will run in a separate thread.
+   * Collisions are checked when the planning scene is updated, at a rate adapted to the clearance of the robot and
+   * the motion of its links: near collisions at collision_check_rate, far from them and without much motion down to
+   * min_collision_check_rate. All groups are checked in the same cycle against the same scene and robot state.
    */
   void checkCollisions();
 
-  // Variables
+  /**
+   * \brief Find a group by name, groups_mutex_ must be locked.
+   * @return The group, or nullptr if there is no group of that name.
+   */
+  Group* findGroup(const std::string& group_name) const;
+
+  /**
+   * \brief Check whether the robot state requires a collision check of a group, it must have up to date link
+   * transforms.
+   * @param group The checked group.
+   * @param time_since_check The time since the last collision check.
+   * @return True if the links moved too far since the last check or the last check is too long ago.
+   */
+  bool isCheckDue(const Group& group, std::chrono::steady_clock::duration time_since_check) const;
+
+  /**
+   * \brief Check whether a group is commanded to move and considered by the collision lookahead.
+   */
+  static bool isLookaheadMoving(const Group& group);
 
-  const servo::Params& servo_params_;
+  /**
+   * \brief Check the motion of the commanded velocities of all groups over the lookahead horizon for collisions.
+   * @param planning_scene The locked planning scene to check against.
+   * @param settings The parameters for the horizon of the lookahead.
+   * @return The velocity scaling that slows down the robot in proportion to the time until the predicted collision.
+   */
+  double predictCollisionScale(const planning_scene::PlanningScene& planning_scene, const servo::Params& settings);
+
+  /**
+   * \brief Check the distances of a group to collisions and update its velocity scaling.
+   * @param group The checked group.
+   * @param planning_scene The locked planning scene to check against.
+   */
+  void checkGroup(Group& group, const planning_scene::PlanningScene& planning_scene);
+
+  // Signals planning scene updates to the collision monitor thread. It is shared with the update callback of the
+  // planning scene monitor, which can't be removed and may outlive the collision monitor.
+  struct SceneUpdateSignal
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool updated = false;
+  };
+
+  // Variables
 
   const planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor_;
   moveit::core::RobotState robot_state_;
@@ -76,15 +194,23 @@ private:
   // The flag used for stopping the collision monitor thread.
   std::atomic<bool> stop_requested_;
 
-  // The scaling factor when approaching a collision.
-  std::atomic<double>& collision_velocity_scale_;
+  std::shared_ptr<SceneUpdateSignal> scene_update_signal_;
+
+  // The checked groups, in the order they were added. The mutex is locked by the collision monitor thread while it
+  // checks collisions.
+  mutable std::mutex groups_mutex_;
+  std::vector<std::unique_ptr<Group>> groups_;
+
+  // The versions of the scene of the last check
+  std::uint64_t checked_world_version_ = 0;
+  std::uint64_t checked_collision_check_version_ = 0;
 
-  // The data structures used to get information about robot self collisions.
-  collision_detection::CollisionRequest self_collision_request_;
-  collision_detection::CollisionResult self_collision_result_;
-  // The data structures used to get information about robot collision with other objects in the collision scene.
-  collision_detection::CollisionRequest scene_collision_request_;
-  collision_detection::CollisionResult scene_collision_result_;
+  // The buffers of the collision lookahead and the velocity scaling it demanded in the last check
+  std::vector<moveit::core::RobotState> lookahead_states_;
+  std::vector<const moveit::core::RobotState*> lookahead_state_ptrs_;
+  std::vector<collision_detection::CollisionResult> lookahead_results_;
+  collision_detection::CollisionRequest lookahead_request_;
+  double predicted_collision_scale_ = 1.0;
 };
 
 }  // namespace moveit_servo
@@ -45,6 +45,7 @@
 #include <moveit_servo/collision_monitor.hpp>
 #include <moveit_servo/utils/command.hpp>
 #include <moveit_servo/utils/datatypes.hpp>
+#include <moveit_servo/utils/spsc_queue.hpp>
 #include <moveit/kinematics_base/kinematics_base.hpp>
 #include <moveit/online_signal_smoothing/smoothing_base_class.hpp>
 #include <moveit/planning_scene_monitor/planning_scene_monitor.hpp>
@@ -62,8 +63,18 @@ namespace moveit_servo
 class Servo
 {
 public:
+  /**
+   * \brief Create servo for the move group of the parameters.
+   * Several move groups, e.g. the arms of a dual arm robot, can be servoed by instances sharing the planning scene
+   * monitor and the collision monitor. Their collisions are then checked in the same cycles, against the same scene.
+   * @param node The node used by servo.
+   * @param servo_param_listener The listener of the servo parameters.
+   * @param planning_scene_monitor The planning scene monitor providing the robot state and the scene.
+   * @param collision_monitor The collision monitor of another servo instance to share, or nullptr to create one.
+   */
   Servo(const rclcpp::Node::SharedPtr& node, std::shared_ptr<const servo::ParamListener> servo_param_listener,
-        const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor);
+        const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor,
+        const std::shared_ptr<CollisionMonitor>& collision_monitor = nullptr);
 
   ~Servo();
 
@@ -81,6 +92,33 @@ public:
    */
   KinematicState getNextJointState(const moveit::core::RobotStatePtr& robot_state, const ServoInput& command);
 
+  /**
+   * \brief Computes the joint state required to follow the given command, reusing the memory of the output state.
+   * Once the output state has been sized by a first call, joint jog commands for the move group are processed without
+   * allocating memory, unless joints need to be halted or a smoothing plugin allocates.
+   * @param robot_state RobotStatePtr instance used for calculating the next joint state.
+   * @param command The command to follow, std::variant type, can handle JointJog, Twist and Pose.
+   * @param next_joint_state The required joint state.
+   */
+  void getNextJointState(const moveit::core::RobotStatePtr& robot_state, const ServoInput& command,
+                         KinematicState& next_joint_state);
+
+  /**
+   * \brief Push a command to the queue of servo, e.g. from a component in the same process, avoiding the latency and
+   * copies of messages. Lock-free, may be called by a single producer thread while the servo loop takes the commands.
+   * @param command The command to follow, stamped with the time it was created to detect stale commands. It is copied
+   * into a preallocated element of the queue, reusing its memory.
+   * @return False if the queue is full, i.e. the servo loop doesn't keep up with the commands.
+   */
+  bool pushCommand(const StampedServoInput& command);
+
+  /**
+   * \brief Take the oldest command from the queue of commands pushed by pushCommand(), to be called by the servo loop.
+   * @param command The oldest command. Its previous content is reused by the queue.
+   * @return False if the queue is empty.
+   */
+  bool popCommand(StampedServoInput& command);
+
   /**
    * \brief Set the type of incoming servo command.
    * @param command_type The type of command servo should expect.
@@ -106,11 +144,16 @@ public:
   std::string getStatusMessage() const;
 
   /**
-   * \brief Start/Stop collision checking thread.
-   * @param check_collision Stops collision checking thread if false, starts it if true.
+   * \brief Start/Stop collision checking of the move group.
+   * @param check_collision Stops collision checking if false, starts it if true.
    */
   void setCollisionChecking(const bool check_collision);
 
+  /**
+   * \brief Get the collision monitor, e.g. to share it with servo instances for other move groups.
+   */
+  const std::shared_ptr<CollisionMonitor>& getCollisionMonitor() const;
+
   /**
    * \brief Returns the most recent servo parameters.
    */
@@ -180,9 +223,10 @@ private:
    * \brief Compute the change in joint position required to follow the received command.
    * @param command The incoming servo command.
    * @param robot_state RobotStatePtr instance used for calculating the command.
-   * @return The joint position change required (delta).
+   * @param joint_position_delta The joint position change required (delta).
    */
-  Eigen::VectorXd jointDeltaFromCommand(const ServoInput& command, const moveit::core::RobotStatePtr& robot_state);
+  void jointDeltaFromCommand(const ServoInput& command, const moveit::core::RobotStatePtr& robot_state,
+                             Eigen::VectorXd& joint_position_delta);
 
   /**
    * \brief Validate the servo parameters
@@ -225,7 +269,7 @@ private:
 
   // This value will be updated by CollisionMonitor in a separate thread.
   std::atomic<double> collision_velocity_scale_ = 1.0;
-  std::unique_ptr<CollisionMonitor> collision_monitor_;
+  std::shared_ptr<CollisionMonitor> collision_monitor_;
 
   // Pointer to the (optional) smoothing plugin.
   pluginlib::UniquePtr<online_signal_smoothing::SmoothingBaseClass> smoother_ = nullptr;
@@ -235,6 +279,16 @@ private:
 
   // The current joint limit safety margins for each active joint position variable.
   std::vector<double> joint_limit_margins_;
+
+  // The move group is fixed, so its joints are looked up once. The buffers of getNextJointState() are sized at
+  // construction, such that servoing doesn't allocate memory on every cycle.
+  const moveit::core::JointModelGroup* joint_model_group_;
+  moveit::core::JointBoundsVector joint_bounds_;
+  Eigen::VectorXd current_positions_;
+  Eigen::VectorXd joint_position_delta_;
+
+  // Commands pushed directly to servo, waiting for the servo loop.
+  std::unique_ptr<SPSCQueue<StampedServoInput>> command_queue_;
 };
 
 }  // namespace moveit_servo
@@ -51,7 +51,7 @@
 #include <std_msgs/msg/float64_multi_array.hpp>
 #include <std_srvs/srv/set_bool.hpp>
 #include <trajectory_msgs/msg/joint_trajectory.hpp>
-#include <std_msgs/msg/float64_multi_array.hpp>
+#include <chrono>
 
 namespace moveit_servo
 {
@@ -74,6 +74,16 @@ public:
   // Skip linting due to unconventional function naming
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr get_node_base_interface();  // NOLINT
 
+  /**
+   * \brief Push a command directly to the servo loop, bypassing the command topics.
+   * Meant for a component running in the same process, e.g. visual servoing, to avoid the latency and copies of
+   * messages. Lock-free, may be called by a single producer thread. A pushed command is followed instead of the
+   * command messages until it goes stale, and must be of the current command type.
+   * @param command The command, stamped with the time it was created by the clock of the node.
+   * @return False if the queue of pushed commands is full.
+   */
+  bool pushCommand(const StampedServoInput& command);
+
 private:
   /**
    * \brief Loop that handles different types of incoming commands.
@@ -99,9 +109,34 @@ private:
   void twistCallback(const geometry_msgs::msg::TwistStamped::ConstSharedPtr& msg);
   void poseCallback(const geometry_msgs::msg::PoseStamped::ConstSharedPtr& msg);
 
-  std::optional<KinematicState> processJointJogCommand(const moveit::core::RobotStatePtr& robot_state);
-  std::optional<KinematicState> processTwistCommand(const moveit::core::RobotStatePtr& robot_state);
-  std::optional<KinematicState> processPoseCommand(const moveit::core::RobotStatePtr& robot_state);
+  // Compute next_joint_state_ for the latest command, return false if there is no state to command
+  bool processJointJogCommand(const moveit::core::RobotStatePtr& robot_state);
+  bool processTwistCommand(const moveit::core::RobotStatePtr& robot_state);
+  bool processPoseCommand(const moveit::core::RobotStatePtr& robot_state);
+  bool processQueuedCommand(const moveit::core::RobotStatePtr& robot_state);
+
+  /**
+   * \brief Publish the joint command rolling window as trajectory, in a loaned message if the middleware supports it or
+   * else in a message reused across cycles.
+   */
+  void publishTrajectory();
+
+  /**
+   * \brief Configure the scheduling policy, priority and CPU affinity of the calling servo loop thread.
+   */
+  void configureServoLoopThread();
+
+  /**
+   * \brief Record the computation time of a servo loop cycle and publish the statistics once per second.
+   * @param cycle_time The computation time of the cycle.
+   */
+  void updateCycleStatistics(std::chrono::steady_clock::duration cycle_time);
+
+  /**
+   * \brief Record the latency from the creation of the command followed in this cycle to the publication of the joint
+   * command, once per command.
+   */
+  void updateCommandLatency();
 
   // Variables
 
@@ -111,9 +146,17 @@ private:
   planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor_;
 
   KinematicState last_commanded_state_;  // Used when commands go stale;
+  KinematicState next_joint_state_;      // Reused by every cycle of the servo loop
+  ServoInput servo_input_;               // Reused by every cycle of the servo loop
   control_msgs::msg::JointJog latest_joint_jog_;
   geometry_msgs::msg::TwistStamped latest_twist_;
   geometry_msgs::msg::PoseStamped latest_pose_;
+  // The newest command pushed by pushCommand()
+  StampedServoInput queued_command_;
+  bool has_queued_command_ = false;
+  // The stamps of the command followed in the current cycle and of the last command whose latency was recorded
+  rclcpp::Time latest_command_stamp_;
+  int64_t last_latency_stamp_nanoseconds_ = 0;
   rclcpp::Subscription<control_msgs::msg::JointJog>::SharedPtr joint_jog_subscriber_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr twist_subscriber_;
   rclcpp::Subscription<geometry_msgs::msg::PoseStamped>::SharedPtr pose_subscriber_;
@@ -121,6 +164,17 @@ private:
   rclcpp::Publisher<std_msgs::msg::Float64MultiArray>::SharedPtr multi_array_publisher_;
   rclcpp::Publisher<trajectory_msgs::msg::JointTrajectory>::SharedPtr trajectory_publisher_;
   rclcpp::Publisher<moveit_msgs::msg::ServoStatus>::SharedPtr status_publisher_;
+  rclcpp::Publisher<std_msgs::msg::Float64MultiArray>::SharedPtr cycle_statistics_publisher_;
+
+  // Timing statistics of the servo loop cycles since they were last published
+  std_msgs::msg::Float64MultiArray cycle_statistics_;
+  std::size_t cycle_count_ = 0;
+  std::size_t cycle_overrun_count_ = 0;
+  std::chrono::steady_clock::duration cycle_time_sum_{ 0 };
+  std::chrono::steady_clock::duration cycle_time_max_{ 0 };
+  std::size_t command_latency_count_ = 0;
+  double command_latency_sum_ = 0.0;
+  double command_latency_max_ = 0.0;
 
   rclcpp::Service<moveit_msgs::srv::ServoCommandType>::SharedPtr switch_command_type_;
   rclcpp::Service<std_srvs::srv::SetBool>::SharedPtr pause_servo_;
@@ -138,6 +192,10 @@ private:
 
   // rolling window of joint commands
   std::deque<KinematicState> joint_cmd_rolling_window_;
+
+  // The output messages, reused by every cycle of the servo loop
+  trajectory_msgs::msg::JointTrajectory trajectory_message_;
+  std_msgs::msg::Float64MultiArray multi_array_message_;
 };
 
 }  // namespace moveit_servo
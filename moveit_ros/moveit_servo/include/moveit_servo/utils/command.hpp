@@ -62,6 +62,21 @@ JointDeltaResult jointDeltaFromJointJog(const JointJogCommand& command, const mo
                                         const servo::Params& servo_params,
                                         const JointNameToMoveGroupIndexMap& joint_name_group_index_map);
 
+/**
+ * \brief Compute the change in joint position for the given joint jog command, without allocating memory.
+ * @param command The joint jog command.
+ * @param robot_state_ The current robot state as obtained from PlanningSceneMonitor.
+ * @param servo_params The servo parameters.
+ * @param joint_name_group_index_map Mapping between joint subgroup name and move group joint vector position.
+ * @param joint_position_delta The joint position change required (delta), only resized if its size differs from the
+ * number of active joints of the move group.
+ * @return The status.
+ */
+StatusCode jointDeltaFromJointJog(const JointJogCommand& command, const moveit::core::RobotStatePtr& robot_state,
+                                  const servo::Params& servo_params,
+                                  const JointNameToMoveGroupIndexMap& joint_name_group_index_map,
+                                  Eigen::VectorXd& joint_position_delta);
+
 /**
  * \brief Compute the change in joint position for the given twist command.
  * @param command The twist command.
@@ -122,6 +122,20 @@ geometry_msgs::msg::Pose poseFromCartesianDelta(const Eigen::VectorXd& delta_x,
 std::optional<trajectory_msgs::msg::JointTrajectory>
 composeTrajectoryMessage(const servo::Params& servo_params, const std::deque<KinematicState>& joint_cmd_rolling_window);
 
+/**
+ * \brief Fill a trajectory message from a rolling window queue of joint state commands, reusing the memory of the
+ * message. Once a message has been filled, a window with the same joints and number of commands is composed without
+ * allocating memory, such that a message kept across cycles or loaned from the middleware can be published at a flat
+ * cost per cycle.
+ * @param servo_params The configuration used by servo, required for setting some field of the trajectory message.
+ * @param joint_cmd_rolling_window A rolling window queue of joint state commands.
+ * @param joint_trajectory The trajectory message, left unchanged if it can't be created.
+ * @return True if the window has enough commands to create the trajectory message.
+ */
+bool composeTrajectoryMessage(const servo::Params& servo_params,
+                              const std::deque<KinematicState>& joint_cmd_rolling_window,
+                              trajectory_msgs::msg::JointTrajectory& joint_trajectory);
+
 /**
  * \brief Adds a new joint state command to a queue containing commands over a time window. Also modifies the velocities
  * of the commands to help avoid overshooting.
@@ -143,6 +157,15 @@ void updateSlidingWindow(KinematicState& next_joint_state, std::deque<KinematicS
 std_msgs::msg::Float64MultiArray composeMultiArrayMessage(const servo::Params& servo_params,
                                                           const KinematicState& joint_state);
 
+/**
+ * \brief Fill a Float64MultiArray message from given joint state, reusing the memory of the message.
+ * @param servo_params The configuration used by servo, required for selecting position vs velocity.
+ * @param joint_state The joint state to be added into the Float64MultiArray.
+ * @param multi_array The Float64MultiArray message.
+ */
+void composeMultiArrayMessage(const servo::Params& servo_params, const KinematicState& joint_state,
+                              std_msgs::msg::Float64MultiArray& multi_array);
+
 /**
  * \brief Computes scaling factor for velocity when the robot is near a singularity.
  * @param robot_state A pointer to the current robot state.
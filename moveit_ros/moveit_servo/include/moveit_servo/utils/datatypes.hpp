@@ -110,6 +110,13 @@ struct PoseCommand
 // The generic input type for servo that can be JointJog, Twist or Pose.
 typedef std::variant<JointJogCommand, TwistCommand, PoseCommand> ServoInput;
 
+// A servo command with the time it was created, like the header stamp of the corresponding command message.
+struct StampedServoInput
+{
+  ServoInput command;
+  rclcpp::Time stamp;
+};
+
 // The output datatype of servo, this structure contains the names of the joints along with their positions, velocities and accelerations.
 struct KinematicState
 {
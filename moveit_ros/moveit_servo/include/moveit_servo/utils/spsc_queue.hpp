@@ -0,0 +1,133 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/*      Title       : spsc_queue.hpp
+ *      Project     : moveit_servo
+ *      Created     : 10/14/2026
+ *      Author      : MoveIt maintainers
+ *
+ *      Description : A lock-free single producer, single consumer queue to pass servo commands between threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace moveit_servo
+{
+
+/**
+ * \brief A bounded, lock-free queue for one producer thread and one consumer thread.
+ * The elements are preallocated and swapped in and out of the queue, such that elements holding memory, e.g. vectors,
+ * keep it for reuse by the producer and the consumer.
+ */
+template <typename T>
+class SPSCQueue
+{
+public:
+  /**
+   * \brief Create a queue.
+   * @param capacity The maximum number of elements in the queue.
+   */
+  explicit SPSCQueue(std::size_t capacity) : buffer_(capacity + 1)
+  {
+  }
+
+  // Disable copy construction.
+  SPSCQueue(const SPSCQueue&) = delete;
+
+  // Disable copy assignment.
+  SPSCQueue& operator=(SPSCQueue&) = delete;
+
+  /**
+   * \brief Append an element, to be called by the producer thread.
+   * @param value The element to append.
+   * @return False if the queue is full.
+   */
+  bool push(const T& value)
+  {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t next_tail = next(tail);
+    if (next_tail == head_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    buffer_[tail] = value;
+    tail_.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * \brief Remove the oldest element, to be called by the consumer thread.
+   * @param value The removed element. Its previous content is swapped into the queue.
+   * @return False if the queue is empty.
+   */
+  bool pop(T& value)
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    using std::swap;
+    swap(value, buffer_[head]);
+    head_.store(next(head), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * \brief Check whether the queue is empty. Only exact when called by the consumer thread.
+   */
+  bool empty() const
+  {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+private:
+  std::size_t next(std::size_t index) const
+  {
+    return (index + 1 == buffer_.size()) ? 0 : index + 1;
+  }
+
+  // One slot stays free to tell a full queue from an empty one.
+  std::vector<T> buffer_;
+  // The indices are written by different threads, keep them on separate cache lines.
+  alignas(64) std::atomic<std::size_t> head_{ 0 };
+  alignas(64) std::atomic<std::size_t> tail_{ 0 };
+};
+
+}  // namespace moveit_servo
@@ -0,0 +1,58 @@
+import launch
+import launch_ros
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_param_builder import ParameterBuilder
+from moveit_configs_utils import MoveItConfigsBuilder
+
+
+def generate_launch_description():
+    moveit_config = (
+        MoveItConfigsBuilder("moveit_resources_panda")
+        .robot_description(file_path="config/panda.urdf.xacro")
+        .joint_limits(file_path="config/hard_joint_limits.yaml")
+        .robot_description_kinematics()
+        .to_moveit_configs()
+    )
+
+    # Get parameters for the Servo node
+    servo_params = {
+        "moveit_servo": ParameterBuilder("moveit_servo")
+        .yaml("config/panda_simulated_config.yaml")
+        .to_dict()
+    }
+
+    # This sets the update rate and planning group name for the acceleration limiting filter.
+    acceleration_filter_update_period = {"update_period": 0.01}
+    planning_group_name = {"planning_group_name": "panda_arm"}
+
+    # The benchmark simulates the robot and publishes its joint states, no controllers are needed
+    benchmark_params = {
+        "benchmark.rate": LaunchConfiguration("rate"),
+        "benchmark.cycles": LaunchConfiguration("cycles"),
+        "benchmark.output_file": LaunchConfiguration("output_file"),
+    }
+    servo_benchmark = launch_ros.actions.Node(
+        package="moveit_servo",
+        executable="servo_benchmark",
+        parameters=[
+            servo_params,
+            acceleration_filter_update_period,
+            planning_group_name,
+            benchmark_params,
+            moveit_config.robot_description,
+            moveit_config.robot_description_semantic,
+            moveit_config.robot_description_kinematics,
+            moveit_config.joint_limits,
+        ],
+        output="screen",
+    )
+
+    return launch.LaunchDescription(
+        [
+            DeclareLaunchArgument("rate", default_value="100.0"),
+            DeclareLaunchArgument("cycles", default_value="2000"),
+            DeclareLaunchArgument("output_file", default_value=""),
+            servo_benchmark,
+        ]
+    )
@@ -40,6 +40,7 @@
 #include <moveit_servo/collision_monitor.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <moveit/utils/logger.hpp>
+#include <algorithm>
 
 namespace moveit_servo
 {
@@ -51,18 +52,48 @@ rclcpp::Logger getLogger()
 }
 }  // namespace
 
+CollisionMonitor::Group::Group(const servo::Params& servo_params, std::atomic<double>& collision_velocity_scale,
+                               const moveit::core::RobotModelConstPtr& robot_model)
+  : servo_params(servo_params)
+  , collision_velocity_scale(collision_velocity_scale)
+  , joint_model_group(robot_model->getJointModelGroup(servo_params.move_group_name))
+  , commanded_velocities(Eigen::VectorXd::Zero(joint_model_group->getActiveJointModelNames().size()))
+{
+  for (collision_detection::DistanceQuery* query : { &scene_distance_query, &self_distance_query })
+  {
+    query->getRequest().group_name = servo_params.move_group_name;
+    query->getRequest().enableGroup(robot_model);
+  }
+}
+
 CollisionMonitor::CollisionMonitor(const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor,
                                    const servo::Params& servo_params, std::atomic<double>& collision_velocity_scale)
-  : servo_params_(servo_params)
-  , planning_scene_monitor_(planning_scene_monitor)
+  : planning_scene_monitor_(planning_scene_monitor)
   , robot_state_(planning_scene_monitor->getPlanningScene()->getCurrentState())
-  , collision_velocity_scale_(collision_velocity_scale)
+  , stop_requested_(false)
+  , scene_update_signal_(std::make_shared<SceneUpdateSignal>())
 {
-  scene_collision_request_.distance = true;
-  scene_collision_request_.group_name = servo_params.move_group_name;
+  if (!addGroup(servo_params, collision_velocity_scale))
+  {
+    RCLCPP_ERROR_STREAM(getLogger(), "Collision monitor can't check the move group " << servo_params.move_group_name);
+  }
 
-  self_collision_request_.distance = true;
-  self_collision_request_.group_name = servo_params.move_group_name;
+  planning_scene_monitor_->addUpdateCallback(
+      [signal = scene_update_signal_](planning_scene_monitor::PlanningSceneMonitor::SceneUpdateType /* type */) {
+        {
+          std::scoped_lock lock(signal->mutex);
+          signal->updated = true;
+        }
+        signal->condition.notify_one();
+      });
+}
+
+CollisionMonitor::~CollisionMonitor()
+{
+  if (monitor_thread_.joinable())
+  {
+    stop();
+  }
 }
 
 void CollisionMonitor::start()
@@ -73,15 +104,15 @@ void CollisionMonitor::start()
     monitor_thread_ = std::thread(&CollisionMonitor::checkCollisions, this);
     RCLCPP_INFO_STREAM(getLogger(), "Collision monitor started");
   }
-  else
-  {
-    RCLCPP_ERROR_STREAM(getLogger(), "Collision monitor could not be started");
-  }
 }
 
 void CollisionMonitor::stop()
 {
-  stop_requested_ = true;
+  {
+    std::scoped_lock lock(scene_update_signal_->mutex);
+    stop_requested_ = true;
+  }
+  scene_update_signal_->condition.notify_one();
   if (monitor_thread_.joinable())
   {
     monitor_thread_.join();
@@ -89,89 +120,329 @@ void CollisionMonitor::stop()
   RCLCPP_INFO_STREAM(getLogger(), "Collision monitor stopped");
 }
 
-void CollisionMonitor::checkCollisions()
+bool CollisionMonitor::addGroup(const servo::Params& servo_params, std::atomic<double>& collision_velocity_scale)
+{
+  const moveit::core::RobotModelConstPtr& robot_model = planning_scene_monitor_->getRobotModel();
+  std::scoped_lock lock(groups_mutex_);
+  if (!robot_model->hasJointModelGroup(servo_params.move_group_name) ||
+      findGroup(servo_params.move_group_name) != nullptr)
+  {
+    return false;
+  }
+  groups_.push_back(std::make_unique<Group>(servo_params, collision_velocity_scale, robot_model));
+  return true;
+}
+
+void CollisionMonitor::removeGroup(const std::string& group_name)
+{
+  std::scoped_lock lock(groups_mutex_);
+  groups_.erase(std::remove_if(groups_.begin(), groups_.end(),
+                               [&](const std::unique_ptr<Group>& group) {
+                                 return group->servo_params.move_group_name == group_name;
+                               }),
+                groups_.end());
+}
+
+void CollisionMonitor::setCollisionChecking(const std::string& group_name, bool check_collisions)
+{
+  std::scoped_lock lock(groups_mutex_);
+  if (Group* group = findGroup(group_name))
+  {
+    group->enabled = check_collisions;
+    // The state is checked again as soon as checking is reenabled
+    group->checked_link_positions.clear();
+  }
+}
+
+void CollisionMonitor::updateCommandedVelocities(const std::string& group_name,
+                                                 const Eigen::VectorXd& joint_position_delta, double period)
 {
-  rclcpp::WallRate rate(servo_params_.collision_check_rate);
+  std::unique_lock<std::mutex> lock(groups_mutex_, std::try_to_lock);
+  if (!lock.owns_lock())
+  {
+    return;
+  }
+  Group* group = findGroup(group_name);
+  if (group && group->servo_params.collision_lookahead_time > 0.0 &&
+      joint_position_delta.size() == group->commanded_velocities.size())
+  {
+    group->commanded_velocities = joint_position_delta / period;
+  }
+}
+
+CollisionMonitor::Group* CollisionMonitor::findGroup(const std::string& group_name) const
+{
+  for (const std::unique_ptr<Group>& group : groups_)
+  {
+    if (group->servo_params.move_group_name == group_name)
+    {
+      return group.get();
+    }
+  }
+  return nullptr;
+}
+
+bool CollisionMonitor::isCheckDue(const Group& group, std::chrono::steady_clock::duration time_since_check) const
+{
+  const std::vector<const moveit::core::LinkModel*>& links = group.joint_model_group->getUpdatedLinkModels();
+  if (time_since_check >= std::chrono::duration<double>(1.0 / group.servo_params.min_collision_check_rate) ||
+      group.checked_clearance <= 0.0 || group.checked_link_positions.size() != links.size())
+  {
+    return true;
+  }
 
-  bool approaching_self_collision, approaching_scene_collision;
-  double self_collision_threshold_delta, scene_collision_threshold_delta;
-  double self_collision_scale, scene_collision_scale;
+  // The robot may have used up too much of its clearance if any link moved far enough
+  const double max_motion = group.servo_params.collision_check_motion_fraction * group.checked_clearance;
+  for (std::size_t i = 0; i < links.size(); ++i)
+  {
+    if ((robot_state_.getGlobalLinkTransform(links[i]).translation() - group.checked_link_positions[i]).norm() >
+        max_motion)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CollisionMonitor::isLookaheadMoving(const Group& group)
+{
+  return group.enabled && group.servo_params.check_collisions && group.servo_params.collision_lookahead_time > 0.0 &&
+         (group.commanded_velocities.array() != 0.0).any();
+}
+
+double CollisionMonitor::predictCollisionScale(const planning_scene::PlanningScene& planning_scene,
+                                               const servo::Params& settings)
+{
+  // A single moving group is checked like its distance queries, several groups moving at once also against each other
+  const Group* moving_group = nullptr;
+  lookahead_request_.group_name.clear();
+  for (const std::unique_ptr<Group>& group : groups_)
+  {
+    if (isLookaheadMoving(*group))
+    {
+      lookahead_request_.group_name = moving_group ? std::string() : group->servo_params.move_group_name;
+      moving_group = group.get();
+    }
+  }
+
+  // Propagate the commanded velocities from the current state to the states at the ends of the lookahead steps
+  const auto steps = static_cast<std::size_t>(settings.collision_lookahead_steps);
+  const double step_time = settings.collision_lookahead_time / static_cast<double>(steps);
+  lookahead_states_.resize(steps, robot_state_);
+  lookahead_state_ptrs_.resize(steps);
+  for (std::size_t i = 0; i < steps; ++i)
+  {
+    moveit::core::RobotState& state = lookahead_states_[i];
+    state = robot_state_;
+    const double time = step_time * static_cast<double>(i + 1);
+    for (const std::unique_ptr<Group>& group : groups_)
+    {
+      if (isLookaheadMoving(*group))
+      {
+        robot_state_.copyJointGroupPositions(group->joint_model_group, group->lookahead_positions);
+        group->lookahead_positions += time * group->commanded_velocities;
+        state.setJointGroupPositions(group->joint_model_group, group->lookahead_positions);
+        state.enforceBounds(group->joint_model_group);
+      }
+    }
+    state.updateCollisionBodyTransforms();
+    lookahead_state_ptrs_[i] = &state;
+  }
+
+  // Find the first step ending in a collision, then check the swept motion of the steps before it
+  const collision_detection::CollisionEnvConstPtr& env = planning_scene.getCollisionEnv();
+  const collision_detection::AllowedCollisionMatrix& acm = planning_scene.getAllowedCollisionMatrix();
+  std::size_t first_collision =
+      env->checkCollisionBatch(lookahead_request_, lookahead_state_ptrs_, lookahead_results_, acm, true);
+  if (settings.collision_lookahead_continuous)
+  {
+    const moveit::core::RobotState* step_start = &robot_state_;
+    for (std::size_t i = 0; i < first_collision; ++i)
+    {
+      collision_detection::CollisionResult result;
+      env->checkRobotCollision(lookahead_request_, result, *step_start, lookahead_states_[i], acm);
+      if (result.collision)
+      {
+        first_collision = i;
+        break;
+      }
+      step_start = &lookahead_states_[i];
+    }
+  }
+
+  // Slow down in proportion to the time until the collision, such that the robot halts a step before it
+  return static_cast<double>(first_collision) / static_cast<double>(steps);
+}
+
+void CollisionMonitor::checkGroup(Group& group, const planning_scene::PlanningScene& planning_scene)
+{
+  const servo::Params& servo_params = group.servo_params;
   const double log_val = -log(0.001);
+  const double self_velocity_scale_coefficient{ log_val / servo_params.self_collision_proximity_threshold };
+  const double scene_velocity_scale_coefficient{ log_val / servo_params.scene_collision_proximity_threshold };
+
+  // Check collision with environment.
+  group.scene_distance_query.getRequest().acm = &planning_scene.getAllowedCollisionMatrix();
+  const collision_detection::DistanceResult& scene_collision_result =
+      group.scene_distance_query.distanceRobot(*planning_scene.getCollisionEnv(), robot_state_);
+
+  // Check robot self collision.
+  group.self_distance_query.getRequest().acm = &planning_scene.getAllowedCollisionMatrix();
+  const collision_detection::DistanceResult& self_collision_result =
+      group.self_distance_query.distanceSelf(*planning_scene.getCollisionEnvUnpadded(), robot_state_);
+
+  const double scene_collision_distance = scene_collision_result.minimum_distance.distance;
+  const double self_collision_distance = self_collision_result.minimum_distance.distance;
+  group.checked_clearance = std::min(scene_collision_distance - servo_params.scene_collision_proximity_threshold,
+                                     self_collision_distance - servo_params.self_collision_proximity_threshold);
+  const std::vector<const moveit::core::LinkModel*>& links = group.joint_model_group->getUpdatedLinkModels();
+  group.checked_link_positions.resize(links.size());
+  for (std::size_t i = 0; i < links.size(); ++i)
+  {
+    group.checked_link_positions[i] = robot_state_.getGlobalLinkTransform(links[i]).translation();
+  }
+
+  // If collision detected scale velocity to 0, else start decelerating exponentially.
+  // velocity_scale = e ^ k * (collision_distance - threshold)
+  // k = - ln(0.001) / collision_proximity_threshold
+  // velocity_scale should equal one when collision_distance is at collision_proximity_threshold.
+  // velocity_scale should equal 0.001 when collision_distance is at zero.
+  //
+  // NOTE:
+  // collision_velocity_scale is shared by the primary servo thread. Be sure to not set any
+  // intermediate values in this function or they can be picked up and throw off scaling while processing
+  // joint updates.
+
+  if (self_collision_result.collision || scene_collision_result.collision)
+  {
+    group.collision_velocity_scale = 0.0;
+  }
+  else
+  {
+    double self_collision_scale = 1.0;
+    double scene_collision_scale = 1.0;
+
+    if (scene_collision_distance < servo_params.scene_collision_proximity_threshold)
+    {
+      const double scene_collision_threshold_delta =
+          scene_collision_distance - servo_params.scene_collision_proximity_threshold;
+      scene_collision_scale = std::exp(scene_velocity_scale_coefficient * scene_collision_threshold_delta);
+    }
+
+    if (self_collision_distance < servo_params.self_collision_proximity_threshold)
+    {
+      const double self_collision_threshold_delta =
+          self_collision_distance - servo_params.self_collision_proximity_threshold;
+      self_collision_scale = std::exp(self_velocity_scale_coefficient * self_collision_threshold_delta);
+    }
+
+    // Use the scaling factor with lower value, i.e maximum scale down.
+    group.collision_velocity_scale =
+        std::min({ scene_collision_scale, self_collision_scale, predicted_collision_scale_ });
+  }
+}
+
+void CollisionMonitor::checkCollisions()
+{
+  auto last_check_time = std::chrono::steady_clock::now() - std::chrono::hours(1);
 
   while (rclcpp::ok() && !stop_requested_)
   {
-    const double self_velocity_scale_coefficient{ log_val / servo_params_.self_collision_proximity_threshold };
-    const double scene_velocity_scale_coefficient{ log_val / servo_params_.scene_collision_proximity_threshold };
-
-    if (servo_params_.check_collisions)
-    {
-      // Get a read-only copy of the planning scene.
-      planning_scene_monitor::LockedPlanningSceneRO locked_scene(planning_scene_monitor_);
-
-      // Fetch latest robot state using planning scene instead of state monitor due to
-      // https://github.com/moveit/moveit2/issues/2748
-      robot_state_ = locked_scene->getCurrentState();
-      // This must be called before doing collision checking.
-      robot_state_.updateCollisionBodyTransforms();
-
-      // Check collision with environment.
-      scene_collision_result_.clear();
-      locked_scene->getCollisionEnv()->checkRobotCollision(scene_collision_request_, scene_collision_result_,
-                                                           robot_state_, locked_scene->getAllowedCollisionMatrix());
-
-      // Check robot self collision.
-      self_collision_result_.clear();
-      locked_scene->getCollisionEnvUnpadded()->checkSelfCollision(
-          self_collision_request_, self_collision_result_, robot_state_, locked_scene->getAllowedCollisionMatrix());
-
-      // If collision detected scale velocity to 0, else start decelerating exponentially.
-      // velocity_scale = e ^ k * (collision_distance - threshold)
-      // k = - ln(0.001) / collision_proximity_threshold
-      // velocity_scale should equal one when collision_distance is at collision_proximity_threshold.
-      // velocity_scale should equal 0.001 when collision_distance is at zero.
-      //
-      // NOTE:
-      // collision_velocity_scale_ is shared by the primary servo thread. Be sure to not set any
-      // intermediate values in this loop or they can be picked up and throw off scaling while processing
-      // joint updates.
-
-      if (self_collision_result_.collision || scene_collision_result_.collision)
+    // The rates of the first group apply to all groups
+    double collision_check_rate, min_collision_check_rate;
+    {
+      std::scoped_lock lock(groups_mutex_);
+      collision_check_rate = groups_.empty() ? 0.0 : groups_.front()->servo_params.collision_check_rate;
+      min_collision_check_rate = groups_.empty() ? 0.0 : groups_.front()->servo_params.min_collision_check_rate;
+    }
+
+    // Wait for the next planning scene update, but don't check more often than collision_check_rate. Without updates
+    // the state is checked at min_collision_check_rate anyway.
+    if (collision_check_rate > 0.0)
+    {
+      const auto min_period = std::chrono::duration<double>(1.0 / collision_check_rate);
+      std::this_thread::sleep_until(last_check_time + std::chrono::duration_cast<std::chrono::nanoseconds>(min_period));
+    }
+    {
+      std::unique_lock<std::mutex> lock(scene_update_signal_->mutex);
+      const auto is_woken = [this] { return scene_update_signal_->updated || stop_requested_; };
+      if (min_collision_check_rate > 0.0)
       {
-        collision_velocity_scale_ = 0.0;
+        const auto max_period = std::chrono::duration<double>(1.0 / min_collision_check_rate);
+        scene_update_signal_->condition.wait_until(
+            lock, last_check_time + std::chrono::duration_cast<std::chrono::nanoseconds>(max_period), is_woken);
       }
       else
       {
-        self_collision_scale = scene_collision_scale = 1.0;
+        scene_update_signal_->condition.wait(lock, is_woken);
+      }
+      scene_update_signal_->updated = false;
+    }
+    if (stop_requested_)
+    {
+      break;
+    }
 
-        approaching_scene_collision =
-            scene_collision_result_.distance < servo_params_.scene_collision_proximity_threshold;
-        approaching_self_collision = self_collision_result_.distance < servo_params_.self_collision_proximity_threshold;
+    std::scoped_lock groups_lock(groups_mutex_);
+    bool check_any_group = false;
+    for (const std::unique_ptr<Group>& group : groups_)
+    {
+      if (group->enabled && !group->servo_params.check_collisions)
+      {
+        // If collision checking is disabled we do not scale
+        group->collision_velocity_scale = 1.0;
+        // The state is checked again as soon as checking is reenabled
+        group->checked_link_positions.clear();
+      }
+      check_any_group |= group->enabled && group->servo_params.check_collisions;
+    }
+    if (!check_any_group)
+    {
+      predicted_collision_scale_ = 1.0;
+      continue;
+    }
 
-        if (approaching_scene_collision)
-        {
-          scene_collision_threshold_delta =
-              scene_collision_result_.distance - servo_params_.scene_collision_proximity_threshold;
-          scene_collision_scale = std::exp(scene_velocity_scale_coefficient * scene_collision_threshold_delta);
-        }
+    // Get a read-only copy of the planning scene.
+    planning_scene_monitor::LockedPlanningSceneRO locked_scene(planning_scene_monitor_);
 
-        if (approaching_self_collision)
-        {
-          self_collision_threshold_delta =
-              self_collision_result_.distance - servo_params_.self_collision_proximity_threshold;
-          self_collision_scale = std::exp(self_velocity_scale_coefficient * self_collision_threshold_delta);
-        }
+    // Fetch latest robot state using planning scene instead of state monitor due to
+    // https://github.com/moveit/moveit2/issues/2748
+    robot_state_ = locked_scene->getCurrentState();
+    // This must be called before doing collision checking.
+    robot_state_.updateCollisionBodyTransforms();
 
-        // Use the scaling factor with lower value, i.e maximum scale down.
-        collision_velocity_scale_ = std::min(scene_collision_scale, self_collision_scale);
+    // Skip the check if neither the scene changed, nor the robot moved much, nor the last check is too long ago.
+    // The lookahead is checked in every cycle while the robot is commanded to move or slowed down by it.
+    const auto now = std::chrono::steady_clock::now();
+    bool check_due = locked_scene->getWorld()->getVersion() != checked_world_version_ ||
+                     locked_scene->getCollisionCheckVersion() != checked_collision_check_version_ ||
+                     predicted_collision_scale_ != 1.0;
+    bool lookahead = false;
+    for (const std::unique_ptr<Group>& group : groups_)
+    {
+      if (group->enabled && group->servo_params.check_collisions)
+      {
+        lookahead |= isLookaheadMoving(*group);
+        check_due = check_due || isCheckDue(*group, now - last_check_time);
       }
     }
-    else
+    if (!check_due && !lookahead)
     {
-      // If collision checking is disabled we do not scale
-      collision_velocity_scale_ = 1.0;
+      continue;
     }
+    last_check_time = now;
+    checked_world_version_ = locked_scene->getWorld()->getVersion();
+    checked_collision_check_version_ = locked_scene->getCollisionCheckVersion();
 
-    rate.sleep();
+    // All groups are slowed down by a collision predicted for their combined motion
+    predicted_collision_scale_ = lookahead ? predictCollisionScale(*locked_scene, groups_.front()->servo_params) : 1.0;
+    for (const std::unique_ptr<Group>& group : groups_)
+    {
+      if (group->enabled && group->servo_params.check_collisions)
+      {
+        checkGroup(*group, *locked_scene);
+      }
+    }
   }
 }
 }  // namespace moveit_servo
@@ -56,7 +56,8 @@ namespace moveit_servo
 {
 
 Servo::Servo(const rclcpp::Node::SharedPtr& node, std::shared_ptr<const servo::ParamListener> servo_param_listener,
-             const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor)
+             const planning_scene_monitor::PlanningSceneMonitorPtr& planning_scene_monitor,
+             const std::shared_ptr<CollisionMonitor>& collision_monitor)
   : node_(node)
   , logger_(moveit::getLogger("moveit.ros.servo"))
   , servo_param_listener_{ std::move(servo_param_listener) }
@@ -77,18 +78,36 @@ Servo::Servo(const rclcpp::Node::SharedPtr& node, std::shared_ptr<const servo::P
     std::exit(EXIT_FAILURE);
   }
 
+  command_queue_ = std::make_unique<SPSCQueue<StampedServoInput>>(servo_params_.command_queue_size);
+
   moveit::core::RobotStatePtr robot_state = planning_scene_monitor_->getStateMonitor()->getCurrentState();
 
-  // Create the collision checker and start collision checking.
-  collision_monitor_ =
-      std::make_unique<CollisionMonitor>(planning_scene_monitor_, servo_params_, std::ref(collision_velocity_scale_));
+  // Create the collision checker or join the shared one, and start collision checking.
+  if (collision_monitor)
+  {
+    collision_monitor_ = collision_monitor;
+    if (!collision_monitor_->addGroup(servo_params_, collision_velocity_scale_))
+    {
+      RCLCPP_ERROR_STREAM(logger_, "The move group '" << servo_params_.move_group_name
+                                                      << "' is already checked by the shared collision monitor");
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  else
+  {
+    collision_monitor_ =
+        std::make_shared<CollisionMonitor>(planning_scene_monitor_, servo_params_, std::ref(collision_velocity_scale_));
+  }
   collision_monitor_->start();
 
   servo_status_ = StatusCode::NO_WARNING;
 
-  const auto& move_group_joint_names = planning_scene_monitor_->getRobotModel()
-                                           ->getJointModelGroup(servo_params_.move_group_name)
-                                           ->getActiveJointModelNames();
+  joint_model_group_ = planning_scene_monitor_->getRobotModel()->getJointModelGroup(servo_params_.move_group_name);
+  joint_bounds_ = joint_model_group_->getActiveJointModelsBounds();
+  current_positions_ = Eigen::VectorXd::Zero(joint_model_group_->getActiveJointModelNames().size());
+  joint_position_delta_ = Eigen::VectorXd::Zero(joint_model_group_->getActiveJointModelNames().size());
+
+  const auto& move_group_joint_names = joint_model_group_->getActiveJointModelNames();
   // Create subgroup map
   for (const auto& sub_group_name : planning_scene_monitor_->getRobotModel()->getJointModelGroupNames())
   {
@@ -131,7 +150,7 @@ Servo::Servo(const rclcpp::Node::SharedPtr& node, std::shared_ptr<const servo::P
 
 Servo::~Servo()
 {
-  setCollisionChecking(false);
+  collision_monitor_->removeGroup(servo_params_.move_group_name);
 }
 
 void Servo::setSmoothingPlugin()
@@ -179,7 +198,12 @@ void Servo::resetSmoothing(const KinematicState& state)
 
 void Servo::setCollisionChecking(const bool check_collision)
 {
-  check_collision ? collision_monitor_->start() : collision_monitor_->stop();
+  collision_monitor_->setCollisionChecking(servo_params_.move_group_name, check_collision);
+}
+
+const std::shared_ptr<CollisionMonitor>& Servo::getCollisionMonitor() const
+{
+  return collision_monitor_;
 }
 
 bool Servo::validateParams(const servo::Params& servo_params)
@@ -324,6 +348,16 @@ std::string Servo::getStatusMessage() const
   return SERVO_STATUS_CODE_MAP.at(servo_status_);
 }
 
+bool Servo::pushCommand(const StampedServoInput& command)
+{
+  return command_queue_->push(command);
+}
+
+bool Servo::popCommand(StampedServoInput& command)
+{
+  return command_queue_->pop(command);
+}
+
 CommandType Servo::getCommandType() const
 {
   return expected_command_type_;
@@ -371,18 +405,17 @@ KinematicState Servo::haltJoints(const std::vector<size_t>& joint_variables_to_h
   return bounded_state;
 }
 
-Eigen::VectorXd Servo::jointDeltaFromCommand(const ServoInput& command, const moveit::core::RobotStatePtr& robot_state)
+void Servo::jointDeltaFromCommand(const ServoInput& command, const moveit::core::RobotStatePtr& robot_state,
+                                  Eigen::VectorXd& joint_position_deltas)
 {
   // Determine joint_name_group_index_map, if no subgroup is active, the map is empty
+  static const JointNameToMoveGroupIndexMap NO_SUBGROUP_INDEX_MAP;
   const auto& active_subgroup_name =
       servo_params_.active_subgroup.empty() ? servo_params_.move_group_name : servo_params_.active_subgroup;
   const auto& joint_name_group_index_map = (active_subgroup_name != servo_params_.move_group_name) ?
                                                joint_name_to_index_maps_.at(servo_params_.active_subgroup) :
-                                               JointNameToMoveGroupIndexMap();
+                                               NO_SUBGROUP_INDEX_MAP;
 
-  const int num_joints =
-      robot_state->getJointModelGroup(servo_params_.move_group_name)->getActiveJointModelNames().size();
-  Eigen::VectorXd joint_position_deltas(num_joints);
   joint_position_deltas.setZero();
 
   JointDeltaResult delta_result;
@@ -392,9 +425,14 @@ Eigen::VectorXd Servo::jointDeltaFromCommand(const ServoInput& command, const mo
   {
     if (expected_type == CommandType::JOINT_JOG)
     {
-      delta_result = jointDeltaFromJointJog(std::get<JointJogCommand>(command), robot_state, servo_params_,
-                                            joint_name_group_index_map);
-      servo_status_ = delta_result.first;
+      // Joint jog commands are computed in place, the other commands still allocate their intermediate results
+      servo_status_ = jointDeltaFromJointJog(std::get<JointJogCommand>(command), robot_state, servo_params_,
+                                             joint_name_group_index_map, joint_position_deltas);
+      if (servo_status_ == StatusCode::INVALID)
+      {
+        joint_position_deltas.setZero();
+      }
+      return;
     }
     else if (expected_type == CommandType::TWIST)
     {
@@ -463,11 +501,17 @@ Eigen::VectorXd Servo::jointDeltaFromCommand(const ServoInput& command, const mo
     servo_status_ = StatusCode::INVALID;
     RCLCPP_WARN_STREAM(logger_, "Incoming servo command type does not match known command types.");
   }
-
-  return joint_position_deltas;
 }
 
 KinematicState Servo::getNextJointState(const moveit::core::RobotStatePtr& robot_state, const ServoInput& command)
+{
+  KinematicState target_state;
+  getNextJointState(robot_state, command, target_state);
+  return target_state;
+}
+
+void Servo::getNextJointState(const moveit::core::RobotStatePtr& robot_state, const ServoInput& command,
+                              KinematicState& target_state)
 {
   // Set status to clear
   servo_status_ = StatusCode::NO_WARNING;
@@ -475,22 +519,29 @@ KinematicState Servo::getNextJointState(const moveit::core::RobotStatePtr& robot
   // Update the parameters
   updateParams();
 
-  // Get the joint model group info.
-  const moveit::core::JointModelGroup* joint_model_group =
-      robot_state->getJointModelGroup(servo_params_.move_group_name);
-
   // Get necessary information about joints
-  const std::vector<std::string> joint_names = joint_model_group->getActiveJointModelNames();
-  const moveit::core::JointBoundsVector joint_bounds = joint_model_group->getActiveJointModelsBounds();
+  const std::vector<std::string>& joint_names = joint_model_group_->getActiveJointModelNames();
   const int num_joints = joint_names.size();
 
   // Extract current state from robot state
-  KinematicState current_state = extractRobotState(robot_state, servo_params_.move_group_name);
-  KinematicState target_state(num_joints);
-  target_state.joint_names = joint_names;
+  robot_state->copyJointGroupPositions(joint_model_group_, current_positions_);
+
+  // Reset the target state, its memory is only reallocated if it doesn't match the move group
+  if (target_state.joint_names != joint_names)
+  {
+    target_state = KinematicState(num_joints);
+    target_state.joint_names = joint_names;
+  }
+  target_state.positions.setZero();
+  target_state.velocities.setZero();
+  target_state.accelerations.setZero();
 
   // Compute the change in joint position due to the incoming command
-  Eigen::VectorXd joint_position_delta = jointDeltaFromCommand(command, robot_state);
+  jointDeltaFromCommand(command, robot_state, joint_position_delta_);
+  collision_monitor_->updateCommandedVelocities(servo_params_.move_group_name, joint_position_delta_,
+                                                servo_params_.publish_period);
+  const Eigen::VectorXd& joint_position_delta = joint_position_delta_;
+  const Eigen::VectorXd& current_positions = current_positions_;
 
   if (collision_velocity_scale_ > 0 && collision_velocity_scale_ < 1)
   {
@@ -505,47 +556,42 @@ KinematicState Servo::getNextJointState(const moveit::core::RobotStatePtr& robot
   // The computations can be skipped also in case we are halting.
   if (servo_status_ != StatusCode::INVALID && servo_status_ != StatusCode::HALT_FOR_COLLISION)
   {
-    // Compute the next joint positions based on the joint position deltas
-    target_state.positions = current_state.positions + joint_position_delta;
-
     // Compute the joint velocities required to reach positions
     target_state.velocities = joint_position_delta / servo_params_.publish_period;
 
     // Scale down the velocity based on joint velocity limit or user defined scaling if applicable.
     const double joint_velocity_limit_scale = jointLimitVelocityScalingFactor(
-        target_state.velocities, joint_bounds, servo_params_.override_velocity_scaling_factor);
+        target_state.velocities, joint_bounds_, servo_params_.override_velocity_scaling_factor);
     if (joint_velocity_limit_scale < 1.0)  // 1.0 means no scaling.
     {
       RCLCPP_DEBUG_STREAM(logger_, "Joint velocity limit scaling applied by a factor of " << joint_velocity_limit_scale);
     }
     target_state.velocities *= joint_velocity_limit_scale;
 
-    // Adjust joint position based on scaled down velocity
-    target_state.positions = current_state.positions + (target_state.velocities * servo_params_.publish_period);
-
-    // Apply collision scaling to the joint position delta
+    // Adjust joint position based on scaled down velocity, and apply collision scaling to the joint position delta
     target_state.positions =
-        current_state.positions + collision_velocity_scale_ * (target_state.positions - current_state.positions);
+        current_positions + collision_velocity_scale_ * (target_state.velocities * servo_params_.publish_period);
 
     // Compute velocities based on smoothed joint positions
-    target_state.velocities = (target_state.positions - current_state.positions) / servo_params_.publish_period;
+    target_state.velocities = (target_state.positions - current_positions) / servo_params_.publish_period;
 
     // Check if any joints are going past joint position limits.
     const std::vector<size_t> joint_variables_to_halt =
-        jointVariablesToHalt(target_state.positions, target_state.velocities, joint_bounds, joint_limit_margins_);
+        jointVariablesToHalt(target_state.positions, target_state.velocities, joint_bounds_, joint_limit_margins_);
 
     // Apply halting if any joints need to be halted.
     if (!joint_variables_to_halt.empty())
     {
       servo_status_ = StatusCode::JOINT_BOUND;
+      KinematicState current_state(num_joints);
+      current_state.joint_names = joint_names;
+      current_state.positions = current_positions;
       target_state = haltJoints(joint_variables_to_halt, current_state, target_state);
     }
   }
 
   // Apply smoothing to the positions if a smoother was provided.
   doSmoothing(target_state);
-
-  return target_state;
 }
 
 std::optional<Eigen::Isometry3d> Servo::getPlanningToCommandFrameTransform(const std::string& command_frame,
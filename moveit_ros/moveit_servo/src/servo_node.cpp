@@ -47,6 +47,12 @@
 #include <moveit/utils/logger.hpp>
 #include <moveit_servo/servo_node.hpp>
 
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace moveit_servo
 {
 
@@ -72,16 +78,6 @@ ServoNode::ServoNode(const rclcpp::NodeOptions& options)
 {
   moveit::setNodeLoggerName(node_->get_name());
 
-  // Configure SCHED_FIFO and priority
-  if (realtime_tools::configure_sched_fifo(servo_params_.thread_priority))
-  {
-    RCLCPP_INFO_STREAM(node_->get_logger(), "Enabled SCHED_FIFO and higher thread priority.");
-  }
-  else
-  {
-    RCLCPP_WARN_STREAM(node_->get_logger(), "Could not enable FIFO RT scheduling policy. Continuing with the default.");
-  }
-
   // Check if a realtime kernel is available
   if (!realtime_tools::has_realtime_kernel())
   {
@@ -126,6 +122,23 @@ ServoNode::ServoNode(const rclcpp::NodeOptions& options)
   status_publisher_ =
       node_->create_publisher<moveit_msgs::msg::ServoStatus>(servo_params_.status_topic, rclcpp::SystemDefaultsQoS());
 
+  // Create cycle statistics publisher
+  if (!servo_params_.cycle_statistics_topic.empty())
+  {
+    cycle_statistics_publisher_ = node_->create_publisher<std_msgs::msg::Float64MultiArray>(
+        servo_params_.cycle_statistics_topic, rclcpp::SystemDefaultsQoS());
+    for (const char* label :
+         { "mean_cycle_time", "max_cycle_time", "overruns", "mean_command_latency", "max_command_latency" })
+    {
+      std_msgs::msg::MultiArrayDimension dimension;
+      dimension.label = label;
+      dimension.size = 1;
+      dimension.stride = 1;
+      cycle_statistics_.layout.dim.push_back(dimension);
+    }
+    cycle_statistics_.data.resize(cycle_statistics_.layout.dim.size());
+  }
+
   // Create service to enable switching command type
   switch_command_type_ = node_->create_service<moveit_msgs::srv::ServoCommandType>(
       "~/switch_command_type", [this](const std::shared_ptr<moveit_msgs::srv::ServoCommandType::Request>& request,
@@ -186,6 +199,11 @@ void ServoNode::switchCommandType(const std::shared_ptr<moveit_msgs::srv::ServoC
   response->success = (request->command_type == static_cast<int8_t>(servo_->getCommandType()));
 }
 
+bool ServoNode::pushCommand(const StampedServoInput& command)
+{
+  return servo_->pushCommand(command);
+}
+
 void ServoNode::jointJogCallback(const control_msgs::msg::JointJog::ConstSharedPtr& msg)
 {
   latest_joint_jog_ = *msg;
@@ -204,9 +222,9 @@ void ServoNode::poseCallback(const geometry_msgs::msg::PoseStamped::ConstSharedP
   new_pose_msg_ = true;
 }
 
-std::optional<KinematicState> ServoNode::processJointJogCommand(const moveit::core::RobotStatePtr& robot_state)
+bool ServoNode::processJointJogCommand(const moveit::core::RobotStatePtr& robot_state)
 {
-  std::optional<KinematicState> next_joint_state = std::nullopt;
+  bool has_next_joint_state = false;
   // Reject any other command types that had arrived simultaneously.
   new_twist_msg_ = new_pose_msg_ = false;
 
@@ -214,8 +232,17 @@ std::optional<KinematicState> ServoNode::processJointJogCommand(const moveit::co
                              rclcpp::Duration::from_seconds(servo_params_.incoming_command_timeout);
   if (!command_stale)
   {
-    JointJogCommand command{ latest_joint_jog_.joint_names, latest_joint_jog_.velocities };
-    next_joint_state = servo_->getNextJointState(robot_state, command);
+    // Assigning to the reused command keeps its memory as long as the number of joints doesn't change
+    if (!std::holds_alternative<JointJogCommand>(servo_input_))
+    {
+      servo_input_ = JointJogCommand{};
+    }
+    auto& command = std::get<JointJogCommand>(servo_input_);
+    command.names = latest_joint_jog_.joint_names;
+    command.velocities = latest_joint_jog_.velocities;
+    servo_->getNextJointState(robot_state, servo_input_, next_joint_state_);
+    latest_command_stamp_ = latest_joint_jog_.header.stamp;
+    has_next_joint_state = true;
   }
   else
   {
@@ -223,17 +250,18 @@ std::optional<KinematicState> ServoNode::processJointJogCommand(const moveit::co
     new_joint_jog_msg_ = !result.first;
     if (new_joint_jog_msg_)
     {
-      next_joint_state = result.second;
+      next_joint_state_ = result.second;
+      has_next_joint_state = true;
       RCLCPP_DEBUG_STREAM(node_->get_logger(), "Joint jog command timed out. Halting to a stop.");
     }
   }
 
-  return next_joint_state;
+  return has_next_joint_state;
 }
 
-std::optional<KinematicState> ServoNode::processTwistCommand(const moveit::core::RobotStatePtr& robot_state)
+bool ServoNode::processTwistCommand(const moveit::core::RobotStatePtr& robot_state)
 {
-  std::optional<KinematicState> next_joint_state = std::nullopt;
+  bool has_next_joint_state = false;
 
   // Mark latest twist command as processed.
   // Reject any other command types that had arrived simultaneously.
@@ -246,8 +274,10 @@ std::optional<KinematicState> ServoNode::processTwistCommand(const moveit::core:
     const Eigen::Vector<double, 6> velocities{ latest_twist_.twist.linear.x,  latest_twist_.twist.linear.y,
                                                latest_twist_.twist.linear.z,  latest_twist_.twist.angular.x,
                                                latest_twist_.twist.angular.y, latest_twist_.twist.angular.z };
-    const TwistCommand command{ latest_twist_.header.frame_id, velocities };
-    next_joint_state = servo_->getNextJointState(robot_state, command);
+    servo_input_ = TwistCommand{ latest_twist_.header.frame_id, velocities };
+    servo_->getNextJointState(robot_state, servo_input_, next_joint_state_);
+    latest_command_stamp_ = latest_twist_.header.stamp;
+    has_next_joint_state = true;
   }
   else
   {
@@ -255,17 +285,18 @@ std::optional<KinematicState> ServoNode::processTwistCommand(const moveit::core:
     new_twist_msg_ = !result.first;
     if (new_twist_msg_)
     {
-      next_joint_state = result.second;
+      next_joint_state_ = result.second;
+      has_next_joint_state = true;
       RCLCPP_DEBUG_STREAM(node_->get_logger(), "Twist command timed out. Halting to a stop.");
     }
   }
 
-  return next_joint_state;
+  return has_next_joint_state;
 }
 
-std::optional<KinematicState> ServoNode::processPoseCommand(const moveit::core::RobotStatePtr& robot_state)
+bool ServoNode::processPoseCommand(const moveit::core::RobotStatePtr& robot_state)
 {
-  std::optional<KinematicState> next_joint_state = std::nullopt;
+  bool has_next_joint_state = false;
 
   // Mark latest pose command as processed.
   // Reject any other command types that had arrived simultaneously.
@@ -275,8 +306,10 @@ std::optional<KinematicState> ServoNode::processPoseCommand(const moveit::core::
                              rclcpp::Duration::from_seconds(servo_params_.incoming_command_timeout);
   if (!command_stale)
   {
-    const PoseCommand command = poseFromPoseStamped(latest_pose_);
-    next_joint_state = servo_->getNextJointState(robot_state, command);
+    servo_input_ = poseFromPoseStamped(latest_pose_);
+    servo_->getNextJointState(robot_state, servo_input_, next_joint_state_);
+    latest_command_stamp_ = latest_pose_.header.stamp;
+    has_next_joint_state = true;
   }
   else
   {
@@ -284,18 +317,151 @@ std::optional<KinematicState> ServoNode::processPoseCommand(const moveit::core::
     new_pose_msg_ = !result.first;
     if (new_pose_msg_)
     {
-      next_joint_state = result.second;
+      next_joint_state_ = result.second;
+      has_next_joint_state = true;
       RCLCPP_DEBUG_STREAM(node_->get_logger(), "Pose command timed out. Halting to a stop.");
     }
   }
 
-  return next_joint_state;
+  return has_next_joint_state;
+}
+
+bool ServoNode::processQueuedCommand(const moveit::core::RobotStatePtr& robot_state)
+{
+  bool has_next_joint_state = false;
+  // Reject the command messages that had arrived simultaneously.
+  new_joint_jog_msg_ = new_twist_msg_ = new_pose_msg_ = false;
+
+  const bool command_stale = (node_->now() - queued_command_.stamp) >=
+                             rclcpp::Duration::from_seconds(servo_params_.incoming_command_timeout);
+  if (!command_stale)
+  {
+    servo_->getNextJointState(robot_state, queued_command_.command, next_joint_state_);
+    latest_command_stamp_ = queued_command_.stamp;
+    has_next_joint_state = true;
+  }
+  else
+  {
+    auto result = servo_->smoothHalt(last_commanded_state_);
+    has_queued_command_ = !result.first;
+    if (has_queued_command_)
+    {
+      next_joint_state_ = result.second;
+      has_next_joint_state = true;
+      RCLCPP_DEBUG_STREAM(node_->get_logger(), "Pushed command timed out. Halting to a stop.");
+    }
+  }
+
+  return has_next_joint_state;
+}
+
+void ServoNode::publishTrajectory()
+{
+  // Middlewares that can loan messages avoid copying and serializing the message when publishing
+  if (trajectory_publisher_->can_loan_messages())
+  {
+    auto loaned_message = trajectory_publisher_->borrow_loaned_message();
+    if (composeTrajectoryMessage(servo_params_, joint_cmd_rolling_window_, loaned_message.get()))
+    {
+      trajectory_publisher_->publish(std::move(loaned_message));
+    }
+  }
+  else if (composeTrajectoryMessage(servo_params_, joint_cmd_rolling_window_, trajectory_message_))
+  {
+    trajectory_publisher_->publish(trajectory_message_);
+  }
+}
+
+void ServoNode::configureServoLoopThread()
+{
+  // Configure SCHED_FIFO and priority
+  if (realtime_tools::configure_sched_fifo(servo_params_.thread_priority))
+  {
+    RCLCPP_INFO_STREAM(node_->get_logger(), "Enabled SCHED_FIFO and higher thread priority.");
+  }
+  else
+  {
+    RCLCPP_WARN_STREAM(node_->get_logger(), "Could not enable FIFO RT scheduling policy. Continuing with the default.");
+  }
+
+  if (servo_params_.thread_cpu_affinity.empty())
+  {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const auto cpu : servo_params_.thread_cpu_affinity)
+  {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) == 0)
+  {
+    RCLCPP_INFO_STREAM(node_->get_logger(), "Restricted the servo loop thread to the configured CPUs.");
+  }
+  else
+  {
+    RCLCPP_WARN_STREAM(node_->get_logger(), "Could not set the CPU affinity of the servo loop thread.");
+  }
+#else
+  RCLCPP_WARN_STREAM(node_->get_logger(), "Setting the CPU affinity of the servo loop thread requires Linux.");
+#endif
+}
+
+void ServoNode::updateCycleStatistics(std::chrono::steady_clock::duration cycle_time)
+{
+  if (!cycle_statistics_publisher_)
+  {
+    return;
+  }
+
+  ++cycle_count_;
+  cycle_time_sum_ += cycle_time;
+  cycle_time_max_ = std::max(cycle_time_max_, cycle_time);
+  if (cycle_time > std::chrono::duration<double>(servo_params_.publish_period))
+  {
+    ++cycle_overrun_count_;
+  }
+
+  if (static_cast<double>(cycle_count_) * servo_params_.publish_period >= 1.0)
+  {
+    using Seconds = std::chrono::duration<double>;
+    cycle_statistics_.data[0] =
+        std::chrono::duration_cast<Seconds>(cycle_time_sum_).count() / static_cast<double>(cycle_count_);
+    cycle_statistics_.data[1] = std::chrono::duration_cast<Seconds>(cycle_time_max_).count();
+    cycle_statistics_.data[2] = static_cast<double>(cycle_overrun_count_);
+    cycle_statistics_.data[3] =
+        command_latency_count_ > 0 ? command_latency_sum_ / static_cast<double>(command_latency_count_) : 0.0;
+    cycle_statistics_.data[4] = command_latency_max_;
+    cycle_statistics_publisher_->publish(cycle_statistics_);
+
+    cycle_count_ = cycle_overrun_count_ = command_latency_count_ = 0;
+    cycle_time_sum_ = cycle_time_max_ = std::chrono::steady_clock::duration::zero();
+    command_latency_sum_ = command_latency_max_ = 0.0;
+  }
+}
+
+void ServoNode::updateCommandLatency()
+{
+  // A command is followed by several cycles until the next one arrives, only the first of them measures its latency
+  if (!cycle_statistics_publisher_ || latest_command_stamp_.nanoseconds() == last_latency_stamp_nanoseconds_)
+  {
+    return;
+  }
+  last_latency_stamp_nanoseconds_ = latest_command_stamp_.nanoseconds();
+
+  const double latency = (node_->now() - latest_command_stamp_).seconds();
+  ++command_latency_count_;
+  command_latency_sum_ += latency;
+  command_latency_max_ = std::max(command_latency_max_, latency);
 }
 
 void ServoNode::servoLoop()
 {
+  configureServoLoopThread();
+
   moveit_msgs::msg::ServoStatus status_msg;
-  std::optional<KinematicState> next_joint_state = std::nullopt;
+  bool has_next_joint_state = false;
   rclcpp::WallRate servo_frequency(1 / servo_params_.publish_period);
 
   // wait for first robot joint state update
@@ -326,7 +492,8 @@ void ServoNode::servoLoop()
       continue;
     }
 
-    std::lock_guard<std::mutex> lock_guard(lock_);
+    std::unique_lock<std::mutex> lock(lock_);
+    const auto cycle_start = std::chrono::steady_clock::now();
     const bool use_trajectory = servo_params_.command_out_type == "trajectory_msgs/JointTrajectory";
     const auto cur_time = node_->now();
 
@@ -346,20 +513,30 @@ void ServoNode::servoLoop()
     robot_state->setJointGroupPositions(joint_model_group, current_state.positions);
     robot_state->setJointGroupVelocities(joint_model_group, current_state.velocities);
 
-    next_joint_state = std::nullopt;
+    // Take the commands pushed directly to servo, only the newest one is followed
+    while (servo_->popCommand(queued_command_))
+    {
+      has_queued_command_ = true;
+    }
+
+    has_next_joint_state = false;
     const CommandType expected_type = servo_->getCommandType();
 
-    if (expected_type == CommandType::JOINT_JOG && new_joint_jog_msg_)
+    if (has_queued_command_)
+    {
+      has_next_joint_state = processQueuedCommand(robot_state);
+    }
+    else if (expected_type == CommandType::JOINT_JOG && new_joint_jog_msg_)
     {
-      next_joint_state = processJointJogCommand(robot_state);
+      has_next_joint_state = processJointJogCommand(robot_state);
     }
     else if (expected_type == CommandType::TWIST && new_twist_msg_)
     {
-      next_joint_state = processTwistCommand(robot_state);
+      has_next_joint_state = processTwistCommand(robot_state);
     }
     else if (expected_type == CommandType::POSE && new_pose_msg_)
     {
-      next_joint_state = processPoseCommand(robot_state);
+      has_next_joint_state = processPoseCommand(robot_state);
     }
     else if (new_joint_jog_msg_ || new_twist_msg_ || new_pose_msg_)
     {
@@ -367,24 +544,22 @@ void ServoNode::servoLoop()
       RCLCPP_WARN_STREAM(node_->get_logger(), "Command type has not been set, cannot accept input");
     }
 
-    if (next_joint_state && (servo_->getStatus() != StatusCode::INVALID) &&
+    if (has_next_joint_state && (servo_->getStatus() != StatusCode::INVALID) &&
         (servo_->getStatus() != StatusCode::HALT_FOR_COLLISION))
     {
       if (use_trajectory)
       {
-        auto& next_joint_state_value = next_joint_state.value();
-        updateSlidingWindow(next_joint_state_value, joint_cmd_rolling_window_, servo_params_.max_expected_latency,
+        updateSlidingWindow(next_joint_state_, joint_cmd_rolling_window_, servo_params_.max_expected_latency,
                             cur_time);
-        if (const auto msg = composeTrajectoryMessage(servo_params_, joint_cmd_rolling_window_))
-        {
-          trajectory_publisher_->publish(msg.value());
-        }
+        publishTrajectory();
       }
       else
       {
-        multi_array_publisher_->publish(composeMultiArrayMessage(servo_->getParams(), next_joint_state.value()));
+        composeMultiArrayMessage(servo_->getParams(), next_joint_state_, multi_array_message_);
+        multi_array_publisher_->publish(multi_array_message_);
       }
-      last_commanded_state_ = next_joint_state.value();
+      last_commanded_state_ = next_joint_state_;
+      updateCommandLatency();
     }
     else
     {
@@ -397,6 +572,8 @@ void ServoNode::servoLoop()
     status_msg.message = servo_->getStatusMessage();
     status_publisher_->publish(status_msg);
 
+    lock.unlock();
+    updateCycleStatistics(std::chrono::steady_clock::now() - cycle_start);
     servo_frequency.sleep();
   }
 }
@@ -38,8 +38,12 @@
  */
 
 #include <moveit_servo/utils/command.hpp>
+#include <moveit/differential_ik/differential_ik_solver.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <cmath>
+#include <memory>
+
 namespace
 {
 rclcpp::Logger getLogger()
@@ -82,25 +86,46 @@ namespace moveit_servo
 JointDeltaResult jointDeltaFromJointJog(const JointJogCommand& command, const moveit::core::RobotStatePtr& robot_state,
                                         const servo::Params& servo_params,
                                         const JointNameToMoveGroupIndexMap& joint_name_group_index_map)
+{
+  Eigen::VectorXd joint_position_delta;
+  const StatusCode status =
+      jointDeltaFromJointJog(command, robot_state, servo_params, joint_name_group_index_map, joint_position_delta);
+  return std::make_pair(status, joint_position_delta);
+}
+
+StatusCode jointDeltaFromJointJog(const JointJogCommand& command, const moveit::core::RobotStatePtr& robot_state,
+                                  const servo::Params& servo_params,
+                                  const JointNameToMoveGroupIndexMap& joint_name_group_index_map,
+                                  Eigen::VectorXd& joint_position_delta)
 {
   // Find the target joint position based on the commanded joint velocity
   StatusCode status = StatusCode::NO_WARNING;
-  const auto& group_name =
-      servo_params.active_subgroup.empty() ? servo_params.move_group_name : servo_params.active_subgroup;
-  const moveit::core::JointModelGroup* joint_model_group = robot_state->getJointModelGroup(group_name);
-  const auto joint_names = joint_model_group->getActiveJointModelNames();
-  Eigen::VectorXd joint_position_delta(joint_names.size());
-  Eigen::VectorXd velocities(joint_names.size());
+  const bool use_subgroup =
+      !servo_params.active_subgroup.empty() && servo_params.active_subgroup != servo_params.move_group_name;
+  const auto& group_name = use_subgroup ? servo_params.active_subgroup : servo_params.move_group_name;
+  const auto& joint_names = robot_state->getJointModelGroup(group_name)->getActiveJointModelNames();
 
-  velocities.setZero();
-  bool names_valid = true;
+  // The deltas are written directly to their position in the move group vector, which is only resized if necessary
+  joint_position_delta.resize(
+      robot_state->getJointModelGroup(servo_params.move_group_name)->getActiveJointModelNames().size());
+  joint_position_delta.setZero();
+  double velocity_to_delta = servo_params.publish_period;
+  if (servo_params.command_in_type == "unitless")
+  {
+    velocity_to_delta *= servo_params.scale.joint;
+  }
 
+  bool names_valid = true;
+  bool velocity_valid = true;
   for (size_t i = 0; i < command.names.size(); ++i)
   {
     auto it = std::find(joint_names.begin(), joint_names.end(), command.names[i]);
     if (it != std::end(joint_names))
     {
-      velocities[std::distance(joint_names.begin(), it)] = command.velocities[i];
+      const size_t index =
+          use_subgroup ? joint_name_group_index_map.at(*it) : std::distance(joint_names.begin(), it);
+      velocity_valid &= std::isfinite(command.velocities[i]);
+      joint_position_delta[index] = command.velocities[i] * velocity_to_delta;
     }
     else
     {
@@ -110,16 +135,8 @@ JointDeltaResult jointDeltaFromJointJog(const JointJogCommand& command, const mo
       break;
     }
   }
-  const bool velocity_valid = isValidCommand(velocities);
-  if (names_valid && velocity_valid)
-  {
-    joint_position_delta = velocities * servo_params.publish_period;
-    if (servo_params.command_in_type == "unitless")
-    {
-      joint_position_delta *= servo_params.scale.joint;
-    }
-  }
-  else
+
+  if (!names_valid || !velocity_valid)
   {
     status = StatusCode::INVALID;
     if (!names_valid)
@@ -135,13 +152,7 @@ JointDeltaResult jointDeltaFromJointJog(const JointJogCommand& command, const mo
     }
   }
 
-  if (!servo_params.active_subgroup.empty() && servo_params.active_subgroup != servo_params.move_group_name)
-  {
-    return std::make_pair(status, createMoveGroupDelta(joint_position_delta, robot_state, servo_params,
-                                                       joint_name_group_index_map));
-  }
-
-  return std::make_pair(status, joint_position_delta);
+  return status;
 }
 
 JointDeltaResult jointDeltaFromTwist(const TwistCommand& command, const moveit::core::RobotStatePtr& robot_state,
@@ -368,14 +379,27 @@ JointDeltaResult jointDeltaFromIK(const Eigen::VectorXd& cartesian_position_delt
   }
   else
   {
-    // Robot does not have an IK solver, use inverse Jacobian to compute IK.
-    const Eigen::MatrixXd jacobian = robot_state->getJacobian(joint_model_group);
-    const Eigen::JacobiSVD<Eigen::MatrixXd> svd =
-        Eigen::JacobiSVD<Eigen::MatrixXd>(jacobian, Eigen::ComputeThinU | Eigen::ComputeThinV);
-    const Eigen::MatrixXd matrix_s = svd.singularValues().asDiagonal();
-    const Eigen::MatrixXd pseudo_inverse = svd.matrixV() * matrix_s.inverse() * svd.matrixU().transpose();
-
-    delta_theta = pseudo_inverse * cartesian_position_delta;
+    // Robot does not have an IK solver, use the damped inverse Jacobian to compute IK.
+    // The Cartesian delta is small, so solving for it like for a velocity gives the joint delta.
+    // The solver is kept across servo cycles, so that its workspaces are only allocated once. It holds on to the robot
+    // model, whose groups it refers to. The damped least squares are computed with a Cholesky factorization, which is
+    // cheaper than the SVD at servo rates.
+    robot_state->updateLinkTransforms();
+    thread_local moveit::core::RobotModelConstPtr diff_ik_robot_model;
+    thread_local std::unique_ptr<differential_ik::DifferentialIKSolver> diff_ik_solver;
+    if (!diff_ik_solver || diff_ik_solver->getJointModelGroup() != joint_model_group)
+    {
+      differential_ik::DifferentialIKSolver::Options options;
+      options.decomposition = differential_ik::DifferentialIKSolver::Decomposition::CHOLESKY;
+      diff_ik_solver = std::make_unique<differential_ik::DifferentialIKSolver>(joint_model_group, nullptr, options);
+      diff_ik_robot_model = robot_state->getRobotModel();
+    }
+    if (!diff_ik_solver->solve(*robot_state, cartesian_position_delta, delta_theta))
+    {
+      status = StatusCode::INVALID;
+      delta_theta.setZero();
+      RCLCPP_WARN_STREAM(getLogger(), "Could not compute the Jacobian of group " << joint_model_group->getName());
+    }
   }
 
   if (!servo_params.active_subgroup.empty() && servo_params.active_subgroup != servo_params.move_group_name)
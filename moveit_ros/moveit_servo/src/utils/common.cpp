@@ -38,6 +38,9 @@
  */
 
 #include <moveit_servo/utils/common.hpp>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
 
 namespace
 {
@@ -150,54 +153,54 @@ geometry_msgs::msg::Pose poseFromCartesianDelta(const Eigen::VectorXd& delta_x,
 std::optional<trajectory_msgs::msg::JointTrajectory>
 composeTrajectoryMessage(const servo::Params& servo_params, const std::deque<KinematicState>& joint_cmd_rolling_window)
 {
-  if (joint_cmd_rolling_window.size() < MIN_POINTS_FOR_TRAJ_MSG)
+  trajectory_msgs::msg::JointTrajectory joint_trajectory;
+  if (!composeTrajectoryMessage(servo_params, joint_cmd_rolling_window, joint_trajectory))
   {
     return {};
   }
+  return joint_trajectory;
+}
 
-  trajectory_msgs::msg::JointTrajectory joint_trajectory;
+bool composeTrajectoryMessage(const servo::Params& servo_params,
+                              const std::deque<KinematicState>& joint_cmd_rolling_window,
+                              trajectory_msgs::msg::JointTrajectory& joint_trajectory)
+{
+  if (joint_cmd_rolling_window.size() < MIN_POINTS_FOR_TRAJ_MSG)
+  {
+    return false;
+  }
 
-  joint_trajectory.joint_names = joint_cmd_rolling_window.front().joint_names;
-  joint_trajectory.points.reserve(joint_cmd_rolling_window.size() + 1);
-  joint_trajectory.header.stamp = joint_cmd_rolling_window.front().time_stamp;
-
-  auto add_point = [servo_params](trajectory_msgs::msg::JointTrajectory& joint_trajectory, const KinematicState& state) {
-    trajectory_msgs::msg::JointTrajectoryPoint point;
-    size_t num_joints = state.positions.size();
-    point.positions.reserve(num_joints);
-    point.velocities.reserve(num_joints);
-    point.accelerations.reserve(num_joints);
-    if (servo_params.publish_joint_positions)
-    {
-      for (const auto& pos : state.positions)
-      {
-        point.positions.emplace_back(pos);
-      }
-    }
-    if (servo_params.publish_joint_velocities)
+  // The joints don't change between cycles, so the names are only copied into a new message
+  const KinematicState& first_state = joint_cmd_rolling_window.front();
+  if (joint_trajectory.joint_names != first_state.joint_names)
+  {
+    joint_trajectory.joint_names = first_state.joint_names;
+  }
+  joint_trajectory.header.stamp = first_state.time_stamp;
+
+  // Assigning to the fields of existing points keeps their memory
+  const auto assign_field = [](bool publish, const Eigen::VectorXd& values, std::vector<double>& field) {
+    if (publish)
     {
-      for (const auto& vel : state.velocities)
-      {
-        point.velocities.emplace_back(vel);
-      }
+      field.assign(values.data(), values.data() + values.size());
     }
-    if (servo_params.publish_joint_accelerations)
+    else
     {
-      for (const auto& acc : state.accelerations)
-      {
-        point.accelerations.emplace_back(acc);
-      }
+      field.clear();
     }
-    point.time_from_start = state.time_stamp - joint_trajectory.header.stamp;
-    joint_trajectory.points.emplace_back(point);
   };
-
-  for (size_t i = 0; i < joint_cmd_rolling_window.size() - 1; ++i)
+  joint_trajectory.points.resize(joint_cmd_rolling_window.size() - 1);
+  for (size_t i = 0; i < joint_trajectory.points.size(); ++i)
   {
-    add_point(joint_trajectory, joint_cmd_rolling_window[i]);
+    const KinematicState& state = joint_cmd_rolling_window[i];
+    trajectory_msgs::msg::JointTrajectoryPoint& point = joint_trajectory.points[i];
+    assign_field(servo_params.publish_joint_positions, state.positions, point.positions);
+    assign_field(servo_params.publish_joint_velocities, state.velocities, point.velocities);
+    assign_field(servo_params.publish_joint_accelerations, state.accelerations, point.accelerations);
+    point.time_from_start = state.time_stamp - joint_trajectory.header.stamp;
   }
 
-  return joint_trajectory;
+  return true;
 }
 
 void updateSlidingWindow(KinematicState& next_joint_state, std::deque<KinematicState>& joint_cmd_rolling_window,
@@ -259,6 +262,13 @@ std_msgs::msg::Float64MultiArray composeMultiArrayMessage(const servo::Params& s
                                                           const KinematicState& joint_state)
 {
   std_msgs::msg::Float64MultiArray multi_array;
+  composeMultiArrayMessage(servo_params, joint_state, multi_array);
+  return multi_array;
+}
+
+void composeMultiArrayMessage(const servo::Params& servo_params, const KinematicState& joint_state,
+                              std_msgs::msg::Float64MultiArray& multi_array)
+{
   const size_t num_joints = joint_state.joint_names.size();
   multi_array.data.resize(num_joints);
   if (servo_params.publish_joint_positions)
@@ -275,8 +285,10 @@ std_msgs::msg::Float64MultiArray composeMultiArrayMessage(const servo::Params& s
       multi_array.data[i] = joint_state.velocities[i];
     }
   }
-
-  return multi_array;
+  else
+  {
+    std::fill(multi_array.data.begin(), multi_array.data.end(), 0.0);
+  }
 }
 
 std::pair<double, StatusCode> velocityScalingFactorForSingularity(const moveit::core::RobotStatePtr& robot_state,
@@ -297,39 +309,42 @@ std::pair<double, StatusCode> velocityScalingFactorForSingularity(const moveit::
   // Get size of total controllable dimensions.
   const size_t dims = target_delta_x.size();
 
-  // Get the current Jacobian and compute SVD
-  const Eigen::JacobiSVD<Eigen::MatrixXd> current_svd = Eigen::JacobiSVD<Eigen::MatrixXd>(
-      robot_state->getJacobian(joint_model_group), Eigen::ComputeThinU | Eigen::ComputeThinV);
-  const Eigen::MatrixXd matrix_s = current_svd.singularValues().asDiagonal();
-
-  // Compute pseudo inverse
-  const Eigen::MatrixXd pseudo_inverse = current_svd.matrixV() * matrix_s.inverse() * current_svd.matrixU().transpose();
+  // Decompose J * J^T of the current Jacobian J, its eigenvalues are the squared singular values of J and its
+  // eigenvectors the left singular vectors. This is cheaper than the SVD of J for 7 or more joints.
+  const Eigen::MatrixXd jacobian = robot_state->getJacobian(joint_model_group);
+  const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> current_decomposition(jacobian * jacobian.transpose());
+  const Eigen::VectorXd& current_eigenvalues = current_decomposition.eigenvalues();
 
   // Get the singular vector corresponding to least singular value.
-  // This vector represents the least responsive dimension. By convention this is the last column of the matrix U.
-  // The sign of the singular vector from result of SVD is not reliable, so we need to do extra checking to make sure of
-  // the sign. See R. Bro, "Resolving the Sign Ambiguity in the Singular Value Decomposition".
-  Eigen::VectorXd vector_towards_singularity = current_svd.matrixU().col(dims - 1);
+  // This vector represents the least responsive dimension. The eigenvalues are sorted in increasing order, so this is
+  // the first eigenvector. The sign of the singular vector is not reliable, so we need to do extra checking to make
+  // sure of the sign. See R. Bro, "Resolving the Sign Ambiguity in the Singular Value Decomposition".
+  Eigen::VectorXd vector_towards_singularity = current_decomposition.eigenvectors().col(0);
 
   // Compute the current condition number. The ratio of max and min singular values.
-  // By convention these are the first and last element of the diagonal.
-  const double current_condition_number = current_svd.singularValues()(0) / current_svd.singularValues()(dims - 1);
+  const double current_condition_number = std::sqrt(current_eigenvalues(dims - 1) / current_eigenvalues(0));
 
   // Take a small step in the direction of vector_towards_singularity
   const Eigen::VectorXd delta_x = vector_towards_singularity * servo_params.singularity_step_scale;
 
-  // Compute the new joint angles if we take the small step delta_x
+  // Compute the new joint angles if we take the small step delta_x, using the pseudo inverse
+  // J^T * (J * J^T)^-1 = J^T * U * diag(1 / s^2) * U^T of the same decomposition
   Eigen::VectorXd next_joint_angles;
   robot_state->copyJointGroupPositions(joint_model_group, next_joint_angles);
-  next_joint_angles += pseudo_inverse * delta_x;
+  next_joint_angles +=
+      jacobian.transpose() *
+      (current_decomposition.eigenvectors() *
+       (current_decomposition.eigenvectors().transpose() * delta_x).cwiseQuotient(current_eigenvalues));
 
-  // Compute the Jacobian SVD for the new robot state.
+  // Compute the singular values of the Jacobian for the new robot state.
   robot_state->setJointGroupPositions(joint_model_group, next_joint_angles);
-  const Eigen::JacobiSVD<Eigen::MatrixXd> next_svd = Eigen::JacobiSVD<Eigen::MatrixXd>(
-      robot_state->getJacobian(joint_model_group), Eigen::ComputeThinU | Eigen::ComputeThinV);
+  const Eigen::MatrixXd next_jacobian = robot_state->getJacobian(joint_model_group);
+  const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> next_decomposition(next_jacobian * next_jacobian.transpose(),
+                                                                          Eigen::EigenvaluesOnly);
 
   // Compute condition number for the new Jacobian.
-  const double next_condition_number = next_svd.singularValues()(0) / next_svd.singularValues()(dims - 1);
+  const double next_condition_number =
+      std::sqrt(next_decomposition.eigenvalues()(dims - 1) / next_decomposition.eigenvalues()(0));
 
   // If the condition number has increased, we are moving towards singularity and the direction of the
   // vector_towards_singularity is correct. If the condition number has decreased, it means the sign of
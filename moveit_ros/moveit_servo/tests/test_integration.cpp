@@ -41,6 +41,43 @@
 
 #include "servo_cpp_fixture.hpp"
 
+#include <cstdlib>
+
+namespace
+{
+// Heap allocations are only counted on the thread that enabled counting, the ROS threads keep allocating
+thread_local bool count_allocations = false;
+thread_local std::size_t allocation_count = 0;
+}  // namespace
+
+#ifdef __GLIBC__
+// Test hook replacing the allocation functions of glibc, which also serve operator new and Eigen
+extern "C"
+{
+  void* __libc_malloc(std::size_t size);
+  void* __libc_calloc(std::size_t count, std::size_t size);
+  void* __libc_realloc(void* ptr, std::size_t size);
+
+  void* malloc(std::size_t size)
+  {
+    allocation_count += count_allocations;
+    return __libc_malloc(size);
+  }
+
+  void* calloc(std::size_t count, std::size_t size)
+  {
+    allocation_count += count_allocations;
+    return __libc_calloc(count, size);
+  }
+
+  void* realloc(void* ptr, std::size_t size)
+  {
+    allocation_count += count_allocations;
+    return __libc_realloc(ptr, size);
+  }
+}
+#endif
+
 namespace
 {
 
@@ -72,6 +109,35 @@ TEST_F(ServoCppFixture, JointJogTest)
   ASSERT_NEAR(delta, 0.01, tol);
 }
 
+TEST_F(ServoCppFixture, JointJogWithoutAllocationTest)
+{
+#ifndef __GLIBC__
+  GTEST_SKIP() << "Counting allocations requires glibc";
+#endif
+  planning_scene_monitor::LockedPlanningSceneRO locked_scene(planning_scene_monitor_);
+  auto robot_state = std::make_shared<moveit::core::RobotState>(locked_scene->getCurrentState());
+
+  const moveit_servo::ServoInput joint_jog_z = moveit_servo::JointJogCommand{ { "panda_joint7" }, { 1.0 } };
+  servo_test_instance_->setCommandType(moveit_servo::CommandType::JOINT_JOG);
+
+  // The first cycle sizes the output state, the following ones must reuse its memory
+  moveit_servo::KinematicState next_state;
+  servo_test_instance_->getNextJointState(robot_state, joint_jog_z, next_state);
+  ASSERT_EQ(servo_test_instance_->getStatus(), moveit_servo::StatusCode::NO_WARNING);
+
+  allocation_count = 0;
+  count_allocations = true;
+  for (int cycle = 0; cycle < 100; ++cycle)
+  {
+    servo_test_instance_->getNextJointState(robot_state, joint_jog_z, next_state);
+  }
+  count_allocations = false;
+
+  EXPECT_EQ(allocation_count, 0u);
+  EXPECT_EQ(servo_test_instance_->getStatus(), moveit_servo::StatusCode::NO_WARNING);
+  EXPECT_EQ(next_state.joint_names.size(), 7u);
+}
+
 TEST_F(ServoCppFixture, TwistTest)
 {
   planning_scene_monitor::LockedPlanningSceneRO locked_scene(planning_scene_monitor_);
@@ -159,6 +225,27 @@ TEST_F(ServoCppFixture, PoseTest)
   ASSERT_NEAR(delta, expected_delta, tol);
 }
 
+TEST_F(ServoCppFixture, SharedCollisionMonitorTest)
+{
+  const auto& collision_monitor = servo_test_instance_->getCollisionMonitor();
+  std::atomic<double> hand_collision_velocity_scale = 0.0;
+
+  // The move group of the servo instance is checked already
+  ASSERT_FALSE(collision_monitor->addGroup(servo_params_, hand_collision_velocity_scale));
+
+  // Another group is checked by the same collision monitor thread
+  servo::Params hand_params = servo_params_;
+  hand_params.move_group_name = "hand";
+  ASSERT_TRUE(collision_monitor->addGroup(hand_params, hand_collision_velocity_scale));
+  const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (hand_collision_velocity_scale == 0.0 && std::chrono::steady_clock::now() < timeout)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_GT(hand_collision_velocity_scale, 0.0);
+  collision_monitor->removeGroup(hand_params.move_group_name);
+}
+
 }  // namespace
 
 int main(int argc, char** argv)
@@ -43,6 +43,7 @@
 #include <moveit_servo/servo.hpp>
 #include <moveit_servo/utils/common.hpp>
 #include <moveit_servo/utils/datatypes.hpp>
+#include <moveit_servo/utils/spsc_queue.hpp>
 #include <moveit/utils/robot_model_test_utils.hpp>
 #include <tf2_eigen/tf2_eigen.hpp>
 
@@ -268,6 +269,12 @@ TEST(ServoUtilsUnitTests, SlidingWinodw)
   ASSERT_TRUE(msg.has_value());
   ASSERT_EQ(msg.value().points.size(), 6ul);
 
+  // Composing into an existing message gives the same trajectory
+  trajectory_msgs::msg::JointTrajectory reused_msg;
+  reused_msg.points.resize(10);
+  ASSERT_TRUE(moveit_servo::composeTrajectoryMessage(params, window, reused_msg));
+  ASSERT_EQ(reused_msg, msg.value());
+
   // remove all but MIN_POINTS_FOR_TRAJ_MSG - 1 points
   constexpr int min_points_for_traj_msg = 3;
   while (window.size() > min_points_for_traj_msg - 1)
@@ -279,6 +286,33 @@ TEST(ServoUtilsUnitTests, SlidingWinodw)
   ASSERT_FALSE(msg.has_value());
 }
 
+TEST(ServoUtilsUnitTests, CommandQueue)
+{
+  using moveit_servo::SPSCQueue;
+  using moveit_servo::StampedServoInput;
+  using moveit_servo::TwistCommand;
+  SPSCQueue<StampedServoInput> queue(2);
+  StampedServoInput command;
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.pop(command));
+
+  // The queue holds up to its capacity and returns the commands in order
+  for (int i = 0; i < 2; ++i)
+  {
+    const TwistCommand twist{ "panda_link0", Eigen::Vector<double, 6>::Constant(i) };
+    ASSERT_TRUE(queue.push(StampedServoInput{ twist, rclcpp::Time(i, 0, RCL_ROS_TIME) }));
+  }
+  ASSERT_FALSE(queue.push(command));
+  for (int i = 0; i < 2; ++i)
+  {
+    ASSERT_TRUE(queue.pop(command));
+    ASSERT_EQ(command.stamp, rclcpp::Time(i, 0, RCL_ROS_TIME));
+    ASSERT_EQ(std::get<TwistCommand>(command.command).velocities[0], i);
+  }
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.pop(command));
+}
+
 }  // namespace
 
 int main(int argc, char** argv)
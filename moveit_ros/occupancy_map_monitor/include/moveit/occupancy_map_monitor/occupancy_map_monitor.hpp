@@ -44,10 +44,12 @@
 #include <rclcpp/rclcpp.hpp>
 #include <tf2_ros/buffer.h>
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -64,6 +66,7 @@ public:
     double map_resolution;
     std::string map_frame;
     std::vector<std::pair<std::string, std::string>> sensor_plugins;
+    double decay_time = 0.0; /*!< Seconds after which occupied cells that are not hit anymore get cleared, 0 disables */
   };
 
   /**
@@ -249,6 +252,14 @@ public:
     tree_->setUpdateCallback(update_callback);
   }
 
+  /**
+   * @brief      Set the callback that receives the cells changed by each update of the maintained octomap. Change
+   *             tracking of the octree is enabled while a callback is set.
+   *
+   * @param[in]  change_callback  The change callback function
+   */
+  void setChangeCallback(const collision_detection::OccMapTree::ChangeCallback& change_callback);
+
   /**
    * @brief      Sets the transform cache callback.
    *
@@ -313,6 +324,11 @@ private:
   bool getShapeTransformCache(std::size_t index, const std::string& target_frame, const rclcpp::Time& target_time,
                               ShapeTransformCache& cache) const;
 
+  /**
+   * @brief      Periodically clear the occupied cells that were not hit for the decay time, until the monitor stops.
+   */
+  void decayThread();
+
   std::unique_ptr<MiddlewareHandle> middleware_handle_; /*!< The abstract interface to ros */
   std::shared_ptr<tf2_ros::Buffer> tf_buffer_;          /*!< TF buffer */
   Parameters parameters_;
@@ -330,6 +346,11 @@ private:
 
   bool active_; /*!< True when actively monitoring updaters */
 
+  std::thread decay_thread_;                /*!< Thread clearing stale cells if decay is enabled */
+  std::condition_variable decay_condition_; /*!< Notified to stop the decay thread */
+  std::mutex decay_lock_;                   /*!< Mutex for decay_running_ */
+  bool decay_running_;                      /*!< True while the decay thread should run */
+
   rclcpp::Logger logger_;
 };
 }  // namespace occupancy_map_monitor
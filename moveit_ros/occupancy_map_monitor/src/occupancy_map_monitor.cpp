@@ -43,6 +43,8 @@
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/node.hpp>
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -69,10 +71,11 @@ OccupancyMapMonitor::OccupancyMapMonitor(std::unique_ptr<MiddlewareHandle> middl
                                          const std::shared_ptr<tf2_ros::Buffer>& tf_buffer)
   : middleware_handle_{ std::move(middleware_handle) }
   , tf_buffer_{ tf_buffer }
-  , parameters_{ 0.0, "", {} }
+  , parameters_{ 0.0, "", {}, 0.0 }
   , debug_info_{ false }
   , mesh_handle_count_{ 0 }
   , active_{ false }
+  , decay_running_{ false }
   , logger_(moveit::getLogger("moveit.ros.occupancy_map_monitor"))
 {
   if (middleware_handle_ == nullptr)
@@ -97,6 +100,11 @@ OccupancyMapMonitor::OccupancyMapMonitor(std::unique_ptr<MiddlewareHandle> middl
 
   tree_ = std::make_shared<collision_detection::OccMapTree>(parameters_.map_resolution);
   tree_const_ = tree_;
+  if (parameters_.decay_time > 0.0)
+  {
+    RCLCPP_DEBUG(logger_, "Clearing octomap cells that were not hit for %lf s", parameters_.decay_time);
+    tree_->enableDecay(true);
+  }
 
   for (const auto& [sensor_name, sensor_type] : parameters_.sensor_plugins)
   {
@@ -180,6 +188,13 @@ void OccupancyMapMonitor::addUpdater(const OccupancyMapUpdaterPtr& updater)
     RCLCPP_ERROR(logger_, "nullptr updater was specified");
 }
 
+void OccupancyMapMonitor::setChangeCallback(const collision_detection::OccMapTree::ChangeCallback& change_callback)
+{
+  collision_detection::OccMapTree::WriteLock lock = tree_->writing();
+  tree_->setChangeCallback(change_callback);
+  tree_->enableChangeTracking(static_cast<bool>(change_callback));
+}
+
 void OccupancyMapMonitor::publishDebugInformation(bool flag)
 {
   debug_info_ = flag;
@@ -305,6 +320,7 @@ bool OccupancyMapMonitor::loadMapCallback(const std::shared_ptr<rmw_request_id_t
   try
   {
     response->success = tree_->readBinary(request->filename);
+    tree_->markAllChanged();
   }
   catch (...)
   {
@@ -325,6 +341,12 @@ void OccupancyMapMonitor::startMonitor()
   /* initialize all of the occupancy map updaters */
   for (OccupancyMapUpdaterPtr& map_updater : map_updaters_)
     map_updater->start();
+
+  if (parameters_.decay_time > 0.0 && !decay_thread_.joinable())
+  {
+    decay_running_ = true;
+    decay_thread_ = std::thread([this] { decayThread(); });
+  }
 }
 
 void OccupancyMapMonitor::stopMonitor()
@@ -332,6 +354,39 @@ void OccupancyMapMonitor::stopMonitor()
   active_ = false;
   for (OccupancyMapUpdaterPtr& map_updater : map_updaters_)
     map_updater->stop();
+
+  if (decay_thread_.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> _(decay_lock_);
+      decay_running_ = false;
+    }
+    decay_condition_.notify_one();
+    decay_thread_.join();
+  }
+}
+
+void OccupancyMapMonitor::decayThread()
+{
+  const auto max_age = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(parameters_.decay_time));
+  // look for stale cells several times per decay time, so that they are cleared at most a quarter of it too late
+  const auto period = std::max<std::chrono::steady_clock::duration>(max_age / 4, std::chrono::milliseconds(10));
+
+  std::unique_lock<std::mutex> lock(decay_lock_);
+  while (!decay_condition_.wait_for(lock, period, [this] { return !decay_running_; }))
+  {
+    std::size_t cleared;
+    {
+      collision_detection::OccMapTree::WriteLock tree_lock = tree_->writing();
+      cleared = tree_->clearStaleCells(max_age);
+    }
+    if (cleared > 0)
+    {
+      RCLCPP_DEBUG(logger_, "Cleared %zu stale octomap cells", cleared);
+      tree_->triggerUpdateCallback();
+    }
+  }
 }
 
 OccupancyMapMonitor::~OccupancyMapMonitor()
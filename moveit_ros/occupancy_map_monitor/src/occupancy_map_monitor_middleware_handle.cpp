@@ -54,7 +54,7 @@ OccupancyMapMonitorMiddlewareHandle::OccupancyMapMonitorMiddlewareHandle(const r
                                                                          double map_resolution,
                                                                          const std::string& map_frame)
   : node_{ node }
-  , parameters_{ map_resolution, map_frame, {} }
+  , parameters_{ map_resolution, map_frame, {}, 0.0 }
   , logger_(moveit::getLogger("moveit.ros.occupancy_map_monitor"))
 {
   try
@@ -87,6 +87,8 @@ OccupancyMapMonitorMiddlewareHandle::OccupancyMapMonitorMiddlewareHandle(const r
     }
   }
 
+  node_->get_parameter("octomap_decay_time", parameters_.decay_time);
+
   std::vector<std::string> sensor_names;
   if (!node_->get_parameter("sensors", sensor_names))
   {
@@ -93,6 +93,9 @@ private:
   double max_update_rate_;
   unsigned int skip_vertical_pixels_;
   unsigned int skip_horizontal_pixels_;
+  bool project_on_gpu_;
+  unsigned int num_threads_;
+  std::size_t free_space_queue_size_;
 
   unsigned int image_callback_count_;
   double average_callback_dt_;
@@ -105,6 +108,7 @@ private:
   std::vector<double> x_cache_, y_cache_;
   double inv_fx_, inv_fy_, K0_, K2_, K4_, K5_;
   std::vector<unsigned int> filtered_labels_;
+  std::vector<unsigned short> filtered_keys_;
   rclcpp::Time last_depth_callback_start_;
   rclcpp::Logger logger_;
 };
@@ -71,6 +71,9 @@ DepthImageOctomapUpdater::DepthImageOctomapUpdater()
   , max_update_rate_(0)
   , skip_vertical_pixels_(4)
   , skip_horizontal_pixels_(6)
+  , project_on_gpu_(true)
+  , num_threads_(1)
+  , free_space_queue_size_(20)
   , image_callback_count_(0)
   , average_callback_dt_(0.0)
   , good_tf_(5)
@@ -105,6 +108,9 @@ bool DepthImageOctomapUpdater::setParams(const std::string& name_space)
         node_->get_parameter(name_space + ".skip_horizontal_pixels", skip_horizontal_pixels_) &&
         node_->get_parameter(name_space + ".filtered_cloud_topic", filtered_cloud_topic_) &&
         node_->get_parameter(name_space + ".ns", ns_);
+    node_->get_parameter_or(name_space + ".project_on_gpu", project_on_gpu_, true);
+    node_->get_parameter_or(name_space + ".num_threads", num_threads_, 1u);
+    node_->get_parameter_or(name_space + ".free_space_queue_size", free_space_queue_size_, std::size_t(20));
     return true;
   }
   catch (const rclcpp::exceptions::InvalidParameterTypeException& e)
@@ -123,7 +129,7 @@ bool DepthImageOctomapUpdater::initialize(const rclcpp::Node::SharedPtr& node)
   filtered_label_transport_ = std::make_unique<image_transport::ImageTransport>(node_);
 
   tf_buffer_ = monitor_->getTFClient();
-  free_space_updater_ = std::make_unique<LazyFreeSpaceUpdater>(tree_);
+  free_space_updater_ = std::make_unique<LazyFreeSpaceUpdater>(tree_, 10, free_space_queue_size_, num_threads_);
 
   // create our mesh filter
   mesh_filter_ = std::make_unique<mesh_filter::MeshFilter<mesh_filter::StereoCameraModel>>(
@@ -135,6 +141,13 @@ bool DepthImageOctomapUpdater::initialize(const rclcpp::Node::SharedPtr& node)
   mesh_filter_->setTransformCallback(
       [this](mesh_filter::MeshHandle mesh, Eigen::Isometry3d& tf) { return getShapeTransform(mesh, tf); });
 
+  // back-project and voxelize the depth images together with the filtering, the octree origin has the center key
+  if (project_on_gpu_ && !mesh_filter_->enableKeyProjection(tree_->getResolution(), tree_->coordToKey(0.0)))
+  {
+    RCLCPP_WARN(logger_, "The OpenGL implementation does not support the key projection, projecting on the CPU");
+    project_on_gpu_ = false;
+  }
+
   return true;
 }
 
@@ -432,10 +445,6 @@ void DepthImageOctomapUpdater::depthImageCallback(const sensor_msgs::msg::Image:
   if (filtered_labels_.size() < img_size)
     filtered_labels_.resize(img_size);
 
-  // get the labels of the filtered data
-  const unsigned int* labels_row = &filtered_labels_[0];
-  mesh_filter_->getFilteredLabels(&filtered_labels_[0]);
-
   // publish debug information if needed
   if (debug_info_)
   {
@@ -500,84 +509,120 @@ void DepthImageOctomapUpdater::depthImageCallback(const sensor_msgs::msg::Image:
     pub_filtered_depth_image_.publish(filtered_msg, *info_msg);
   }
 
-  // figure out occupied cells and model cells
-  tree_->lockRead();
+  const int h_bound = h - skip_vertical_pixels_;
+  const int w_bound = w - skip_horizontal_pixels_;
 
-  try
+  if (project_on_gpu_)
   {
-    const int h_bound = h - skip_vertical_pixels_;
-    const int w_bound = w - skip_horizontal_pixels_;
+    // the keys were computed by the mesh filter, only their types need to be sorted out
+    if (filtered_keys_.size() < 4 * img_size)
+      filtered_keys_.resize(4 * img_size);
 
-    if (is_u_short)
+    Eigen::Isometry3d transform = Eigen::Isometry3d::Identity();
+    const tf2::Matrix3x3& basis = map_h_sensor.getBasis();
+    for (int i = 0; i < 3; ++i)
     {
-      const uint16_t* input_row = reinterpret_cast<const uint16_t*>(&depth_msg->data[0]);
+      for (int j = 0; j < 3; ++j)
+        transform.linear()(i, j) = basis[i][j];
+    }
+    transform.translation() = Eigen::Vector3d(sensor_origin.x(), sensor_origin.y(), sensor_origin.z());
+    mesh_filter_->getFilteredKeys(transform, &filtered_keys_[0]);
 
-      for (int y = skip_vertical_pixels_; y < h_bound; ++y, labels_row += w, input_row += w)
+    for (int y = skip_vertical_pixels_; y < h_bound; ++y)
+    {
+      const unsigned short* keys_row = &filtered_keys_[4 * y * w];
+      for (int x = skip_horizontal_pixels_; x < w_bound; ++x)
       {
-        for (int x = skip_horizontal_pixels_; x < w_bound; ++x)
-        {
-          // not filtered
-          if (labels_row[x] == mesh_filter::MeshFilterBase::BACKGROUND)
-          {
-            float zz = static_cast<float>(input_row[x]) * 1e-3;  // scale from mm to m
-            float yy = y_cache_[y] * zz;
-            float xx = x_cache_[x] * zz;
-            /* transform to map frame */
-            tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
-            occupied_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
-          }
-          // on far plane or a model point -> remove
-          else if (labels_row[x] >= mesh_filter::MeshFilterBase::FAR_CLIP)
-          {
-            float zz = input_row[x] * 1e-3;
-            float yy = y_cache_[y] * zz;
-            float xx = x_cache_[x] * zz;
-            /* transform to map frame */
-            tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
-            // add to the list of model cells
-            model_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
-          }
-        }
+        const unsigned short* key = keys_row + 4 * x;
+        if (key[3] == mesh_filter::MeshFilterBase::OCCUPIED_KEY)
+          occupied_cells.insert(octomap::OcTreeKey(key[0], key[1], key[2]));
+        else if (key[3] == mesh_filter::MeshFilterBase::MODEL_KEY)
+          model_cells.insert(octomap::OcTreeKey(key[0], key[1], key[2]));
       }
     }
-    else
-    {
-      const float* input_row = reinterpret_cast<const float*>(&depth_msg->data[0]);
+  }
+  else
+  {
+    // get the labels of the filtered data
+    const unsigned int* labels_row = &filtered_labels_[0];
+    mesh_filter_->getFilteredLabels(&filtered_labels_[0]);
+
+    // figure out occupied cells and model cells
+    tree_->lockRead();
 
-      for (int y = skip_vertical_pixels_; y < h_bound; ++y, labels_row += w, input_row += w)
+    try
+    {
+      if (is_u_short)
       {
-        for (int x = skip_horizontal_pixels_; x < w_bound; ++x)
+        const uint16_t* input_row = reinterpret_cast<const uint16_t*>(&depth_msg->data[0]);
+
+        for (int y = skip_vertical_pixels_; y < h_bound; ++y, labels_row += w, input_row += w)
         {
-          if (labels_row[x] == mesh_filter::MeshFilterBase::BACKGROUND)
+          for (int x = skip_horizontal_pixels_; x < w_bound; ++x)
           {
-            float zz = input_row[x];
-            float yy = y_cache_[y] * zz;
-            float xx = x_cache_[x] * zz;
-            /* transform to map frame */
-            tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
-            occupied_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
+            // not filtered
+            if (labels_row[x] == mesh_filter::MeshFilterBase::BACKGROUND)
+            {
+              float zz = static_cast<float>(input_row[x]) * 1e-3;  // scale from mm to m
+              float yy = y_cache_[y] * zz;
+              float xx = x_cache_[x] * zz;
+              /* transform to map frame */
+              tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
+              occupied_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
+            }
+            // on far plane or a model point -> remove
+            else if (labels_row[x] >= mesh_filter::MeshFilterBase::FAR_CLIP)
+            {
+              float zz = input_row[x] * 1e-3;
+              float yy = y_cache_[y] * zz;
+              float xx = x_cache_[x] * zz;
+              /* transform to map frame */
+              tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
+              // add to the list of model cells
+              model_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
+            }
           }
-          else if (labels_row[x] >= mesh_filter::MeshFilterBase::FAR_CLIP)
+        }
+      }
+      else
+      {
+        const float* input_row = reinterpret_cast<const float*>(&depth_msg->data[0]);
+
+        for (int y = skip_vertical_pixels_; y < h_bound; ++y, labels_row += w, input_row += w)
+        {
+          for (int x = skip_horizontal_pixels_; x < w_bound; ++x)
           {
-            float zz = input_row[x];
-            float yy = y_cache_[y] * zz;
-            float xx = x_cache_[x] * zz;
-            /* transform to map frame */
-            tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
-            // add to the list of model cells
-            model_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
+            if (labels_row[x] == mesh_filter::MeshFilterBase::BACKGROUND)
+            {
+              float zz = input_row[x];
+              float yy = y_cache_[y] * zz;
+              float xx = x_cache_[x] * zz;
+              /* transform to map frame */
+              tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
+              occupied_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
+            }
+            else if (labels_row[x] >= mesh_filter::MeshFilterBase::FAR_CLIP)
+            {
+              float zz = input_row[x];
+              float yy = y_cache_[y] * zz;
+              float xx = x_cache_[x] * zz;
+              /* transform to map frame */
+              tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(xx, yy, zz);
+              // add to the list of model cells
+              model_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
+            }
           }
         }
       }
     }
-  }
-  catch (...)
-  {
+    catch (...)
+    {
+      tree_->unlockRead();
+      RCLCPP_ERROR(logger_, "Internal error while parsing depth data");
+      return;
+    }
     tree_->unlockRead();
-    RCLCPP_ERROR(logger_, "Internal error while parsing depth data");
-    return;
   }
-  tree_->unlockRead();
 
   /* cells that overlap with the model are not occupied */
   for (const octomap::OcTreeKey& model_cell : model_cells)
@@ -37,10 +37,12 @@
 #pragma once
 
 #include <moveit/collision_detection/occupancy_map.hpp>
+#include <chrono>
 #include <deque>
 #include <unordered_map>
 #include <condition_variable>
 #include <thread>
+#include <vector>
 #include <rclcpp/logger.hpp>
 
 namespace occupancy_map_monitor
@@ -48,12 +50,45 @@ namespace occupancy_map_monitor
 class LazyFreeSpaceUpdater
 {
 public:
-  LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size = 10);
+  /** \brief Counters and delays of the frames passing through the updater */
+  struct Statistics
+  {
+    /** \brief Number of frames waiting in the input queue */
+    std::size_t queue_size = 0;
+
+    /** \brief Number of frames whose free cells were marked */
+    std::size_t processed_frames = 0;
+
+    /** \brief Number of frames merged into the newest queued frame because the input queue was full */
+    std::size_t merged_frames = 0;
+
+    /** \brief Number of frames dropped because the input queue was full or the previous batch was not processed */
+    std::size_t dropped_frames = 0;
+
+    /** \brief Seconds between pushing the oldest frame of the last batch and marking its free cells */
+    double lag = 0.0;
+
+    /** \brief Largest lag so far, in seconds */
+    double max_lag = 0.0;
+  };
+
+  /**
+   * \brief Start the threads that mark the free cells of pushed frames in \e tree
+   * \param max_batch_size Number of frames with the same sensor origin that are merged into one batch
+   * \param max_queue_size Number of frames that may wait to be batched, 0 for no limit. When the queue is full, a new
+   * frame is merged into the newest queued frame if they share the sensor origin, else the oldest frame is dropped.
+   * \param num_threads Number of threads casting the rays of a batch
+   */
+  LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size = 10,
+                       std::size_t max_queue_size = 20, unsigned int num_threads = 1);
   ~LazyFreeSpaceUpdater();
 
   void pushLazyUpdate(octomap::KeySet* occupied_cells, octomap::KeySet* model_cells,
                       const octomap::point3d& sensor_origin);
 
+  /** \brief Get a snapshot of the queue depth, the dropped frames and the lag of the updates */
+  Statistics getStatistics() const;
+
 private:
 #ifdef __APPLE__
   typedef std::unordered_map<octomap::OcTreeKey, unsigned int, octomap::OcTreeKey::KeyHash> OcTreeKeyCountMap;
@@ -63,8 +98,22 @@ private:
   typedef std::tr1::unordered_map<octomap::OcTreeKey, unsigned int, octomap::OcTreeKey::KeyHash> OcTreeKeyCountMap;
 #endif
 
-  void pushBatchToProcess(OcTreeKeyCountMap* occupied_cells, octomap::KeySet* model_cells,
-                          const octomap::point3d& sensor_origin);
+  /** \brief One or more frames with the same sensor origin, the occupied cells are counted once per frame */
+  struct LazyUpdate
+  {
+    OcTreeKeyCountMap* occupied_cells = nullptr;
+    octomap::KeySet* model_cells = nullptr;
+    octomap::point3d sensor_origin;
+    /** \brief Time the oldest frame was pushed */
+    std::chrono::steady_clock::time_point stamp;
+    unsigned int frames = 0;
+  };
+
+  static void mergeUpdate(LazyUpdate& update, const OcTreeKeyCountMap& occupied_cells,
+                          const octomap::KeySet& model_cells, unsigned int frames);
+  static void deleteUpdate(LazyUpdate& update);
+
+  void pushBatchToProcess(LazyUpdate& batch);
 
   void lazyUpdateThread();
   void processThread();
@@ -72,23 +121,29 @@ private:
   collision_detection::OccMapTreePtr tree_;
   bool running_;
   std::size_t max_batch_size_;
+  std::size_t max_queue_size_;
+  unsigned int num_threads_;
   double max_sensor_delta_;
 
-  std::deque<octomap::KeySet*> occupied_cells_sets_;
-  std::deque<octomap::KeySet*> model_cells_sets_;
-  std::deque<octomap::point3d> sensor_origins_;
+  std::deque<LazyUpdate> update_queue_;
   std::condition_variable update_condition_;
-  std::mutex update_cell_sets_lock_;
+  mutable std::mutex update_cell_sets_lock_;
 
-  OcTreeKeyCountMap* process_occupied_cells_set_;
-  octomap::KeySet* process_model_cells_set_;
-  octomap::point3d process_sensor_origin_;
+  LazyUpdate process_batch_;
   std::condition_variable process_condition_;
   std::mutex cell_process_lock_;
 
-  std::thread update_thread_;
-  std::thread process_thread_;
+  /** \brief Ray ends of the batch being processed with their counts */
+  std::vector<std::pair<octomap::OcTreeKey, unsigned int>> ray_ends_;
+  std::vector<octomap::KeyRay> key_rays_;
+  std::vector<OcTreeKeyCountMap> thread_free_cells_;
+
+  Statistics statistics_;
+  mutable std::mutex statistics_lock_;
 
   rclcpp::Logger logger_;
+
+  std::thread update_thread_;
+  std::thread process_thread_;
 };
 }  // namespace occupancy_map_monitor
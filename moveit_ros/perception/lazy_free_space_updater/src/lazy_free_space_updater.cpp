@@ -38,20 +38,25 @@
 #include <rclcpp/logging.hpp>
 #include <rclcpp/clock.hpp>
 #include <moveit/utils/logger.hpp>
+#include <algorithm>
+#include <omp.h>
 
 namespace occupancy_map_monitor
 {
 
-LazyFreeSpaceUpdater::LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size)
+LazyFreeSpaceUpdater::LazyFreeSpaceUpdater(const collision_detection::OccMapTreePtr& tree, unsigned int max_batch_size,
+                                           std::size_t max_queue_size, unsigned int num_threads)
   : tree_(tree)
   , running_(true)
   , max_batch_size_(max_batch_size)
+  , max_queue_size_(max_queue_size)
+  , num_threads_(std::max(num_threads, 1u))
   , max_sensor_delta_(1e-3)  // 1mm
-  , process_occupied_cells_set_(nullptr)
-  , process_model_cells_set_(nullptr)
+  , key_rays_(num_threads_)
+  , thread_free_cells_(num_threads_)
+  , logger_(moveit::getLogger("moveit.ros.lazy_free_space_updater"))
   , update_thread_([this] { lazyUpdateThread(); })
   , process_thread_([this] { processThread(); })
-  , logger_(moveit::getLogger("moveit.ros.lazy_free_space_updater"))
 {
 }
 
@@ -68,6 +73,10 @@ LazyFreeSpaceUpdater::~LazyFreeSpaceUpdater()
   }
   update_thread_.join();
   process_thread_.join();
+
+  for (LazyUpdate& update : update_queue_)
+    deleteUpdate(update);
+  deleteUpdate(process_batch_);
 }
 
 void LazyFreeSpaceUpdater::pushLazyUpdate(octomap::KeySet* occupied_cells, octomap::KeySet* model_cells,
@@ -76,32 +85,109 @@ void LazyFreeSpaceUpdater::pushLazyUpdate(octomap::KeySet* occupied_cells, octom
   RCLCPP_DEBUG(logger_, "Pushing %lu occupied cells and %lu model cells for lazy updating...",
                static_cast<long unsigned int>(occupied_cells->size()),
                static_cast<long unsigned int>(model_cells->size()));
+
+  // count the occupied cells before locking, so that the batching thread is not blocked meanwhile
+  LazyUpdate update;
+  update.occupied_cells = new OcTreeKeyCountMap(occupied_cells->size());
+  for (const octomap::OcTreeKey& it : *occupied_cells)
+    update.occupied_cells->emplace(it, 1);
+  delete occupied_cells;
+  update.model_cells = model_cells;
+  update.sensor_origin = sensor_origin;
+  update.stamp = std::chrono::steady_clock::now();
+  update.frames = 1;
+
+  std::size_t merged_frames = 0;
+  std::size_t dropped_frames = 0;
+  {
+    std::scoped_lock _(update_cell_sets_lock_);
+    if (max_queue_size_ > 0 && update_queue_.size() >= max_queue_size_)
+    {
+      // keep the memory bounded: merge frames seen from the same origin, drop the oldest frame otherwise
+      LazyUpdate& newest = update_queue_.back();
+      if ((newest.sensor_origin - sensor_origin).norm() <= max_sensor_delta_)
+      {
+        mergeUpdate(newest, *update.occupied_cells, *update.model_cells, update.frames);
+        merged_frames = update.frames;
+        deleteUpdate(update);
+      }
+      else
+      {
+        dropped_frames = update_queue_.front().frames;
+        deleteUpdate(update_queue_.front());
+        update_queue_.pop_front();
+      }
+    }
+    if (update.occupied_cells)
+      update_queue_.push_back(update);
+    update_condition_.notify_one();
+  }
+
+  if (merged_frames > 0 || dropped_frames > 0)
+  {
+    std::scoped_lock _(statistics_lock_);
+    statistics_.merged_frames += merged_frames;
+    statistics_.dropped_frames += dropped_frames;
+  }
+  if (dropped_frames > 0)
+    RCLCPP_WARN(logger_, "Lazy update queue is full. Dropping the oldest set of cells to be freed.");
+}
+
+LazyFreeSpaceUpdater::Statistics LazyFreeSpaceUpdater::getStatistics() const
+{
+  Statistics statistics;
+  {
+    std::scoped_lock _(statistics_lock_);
+    statistics = statistics_;
+  }
   std::scoped_lock _(update_cell_sets_lock_);
-  occupied_cells_sets_.push_back(occupied_cells);
-  model_cells_sets_.push_back(model_cells);
-  sensor_origins_.push_back(sensor_origin);
-  update_condition_.notify_one();
+  statistics.queue_size = 0;
+  for (const LazyUpdate& update : update_queue_)
+    statistics.queue_size += update.frames;
+  return statistics;
+}
+
+void LazyFreeSpaceUpdater::mergeUpdate(LazyUpdate& update, const OcTreeKeyCountMap& occupied_cells,
+                                       const octomap::KeySet& model_cells, unsigned int frames)
+{
+  for (const std::pair<const octomap::OcTreeKey, unsigned int>& it : occupied_cells)
+    (*update.occupied_cells)[it.first] += it.second;
+  update.model_cells->insert(model_cells.begin(), model_cells.end());
+  update.frames += frames;
+}
+
+void LazyFreeSpaceUpdater::deleteUpdate(LazyUpdate& update)
+{
+  delete update.occupied_cells;
+  update.occupied_cells = nullptr;
+  delete update.model_cells;
+  update.model_cells = nullptr;
+  update.frames = 0;
 }
 
-void LazyFreeSpaceUpdater::pushBatchToProcess(OcTreeKeyCountMap* occupied_cells, octomap::KeySet* model_cells,
-                                              const octomap::point3d& sensor_origin)
+void LazyFreeSpaceUpdater::pushBatchToProcess(LazyUpdate& batch)
 {
   // this is basically a queue of size 1. if this function is called repeatedly without any work being done by
-  // processThread(),
-  // data can be lost; this is intentional, to avoid spending too much time clearing the octomap
-  if (cell_process_lock_.try_lock())
+  // processThread(), the pending batch is replaced by the newer one; this is intentional, to avoid spending too much
+  // time clearing the octomap with outdated data
+  std::size_t dropped_frames = 0;
   {
-    process_occupied_cells_set_ = occupied_cells;
-    process_model_cells_set_ = model_cells;
-    process_sensor_origin_ = sensor_origin;
+    std::scoped_lock _(cell_process_lock_);
+    if (process_batch_.occupied_cells)
+    {
+      dropped_frames = process_batch_.frames;
+      deleteUpdate(process_batch_);
+    }
+    process_batch_ = batch;
     process_condition_.notify_one();
-    cell_process_lock_.unlock();
   }
-  else
+  batch = LazyUpdate();
+
+  if (dropped_frames > 0)
   {
-    RCLCPP_WARN(logger_, "Previous batch update did not complete. Ignoring set of cells to be freed.");
-    delete occupied_cells;
-    delete model_cells;
+    RCLCPP_WARN(logger_, "Previous batch update did not complete. Dropping the oldest set of cells to be freed.");
+    std::scoped_lock _(statistics_lock_);
+    statistics_.dropped_frames += dropped_frames;
   }
 }
 
@@ -110,87 +196,83 @@ void LazyFreeSpaceUpdater::processThread()
   const float lg_0 = tree_->getClampingThresMinLog() - tree_->getClampingThresMaxLog();
   const float lg_miss = tree_->getProbMissLog();
 
-  octomap::KeyRay key_ray1, key_ray2;
-  OcTreeKeyCountMap free_cells1, free_cells2;
+  OcTreeKeyCountMap& free_cells = thread_free_cells_[0];
 
   while (running_)
   {
-    free_cells1.clear();
-    free_cells2.clear();
+    LazyUpdate batch;
+    {
+      std::unique_lock<std::mutex> ulock(cell_process_lock_);
+      while (!process_batch_.occupied_cells && running_)
+        process_condition_.wait(ulock);
 
-    std::unique_lock<std::mutex> ulock(cell_process_lock_);
-    while (!process_occupied_cells_set_ && running_)
-      process_condition_.wait(ulock);
+      if (!running_)
+        break;
 
-    if (!running_)
-      break;
+      // take the batch, so that a newer one can be pushed while this one is processed
+      batch = process_batch_;
+      process_batch_ = LazyUpdate();
+    }
 
     RCLCPP_DEBUG(logger_,
                  "Begin processing batched update: marking free cells due to %lu occupied cells and %lu model cells",
-                 static_cast<long unsigned int>(process_occupied_cells_set_->size()),
-                 static_cast<long unsigned int>(process_model_cells_set_->size()));
+                 static_cast<long unsigned int>(batch.occupied_cells->size()),
+                 static_cast<long unsigned int>(batch.model_cells->size()));
 
     rclcpp::Clock clock;
     rclcpp::Time start = clock.now();
+
+    /* rays end at the occupied cells, weighted by the number of frames they were seen in, and at the model cells */
+    ray_ends_.assign(batch.occupied_cells->begin(), batch.occupied_cells->end());
+    for (const octomap::OcTreeKey& it : *batch.model_cells)
+      ray_ends_.emplace_back(it, 1);
+
     tree_->lockRead();
 
-#pragma omp sections
+    /* compute the free cells along each ray, each thread counts into its own map */
+    const int num_ray_ends = static_cast<int>(ray_ends_.size());
+#pragma omp parallel num_threads(num_threads_) if (num_threads_ > 1)
     {
-#pragma omp section
-      {
-        /* compute the free cells along each ray that ends at an occupied cell */
-        for (std::pair<const octomap::OcTreeKey, unsigned int>& it : *process_occupied_cells_set_)
-        {
-          if (tree_->computeRayKeys(process_sensor_origin_, tree_->keyToCoord(it.first), key_ray1))
-          {
-            for (octomap::OcTreeKey& jt : key_ray1)
-              free_cells1[jt] += it.second;
-          }
-        }
-      }
+      const int thread_id = omp_get_thread_num();
+      octomap::KeyRay& key_ray = key_rays_[thread_id];
+      OcTreeKeyCountMap& thread_free_cells = thread_free_cells_[thread_id];
+      thread_free_cells.clear();
 
-#pragma omp section
+#pragma omp for schedule(dynamic, 64)
+      for (int i = 0; i < num_ray_ends; ++i)
       {
-        /* compute the free cells along each ray that ends at a model cell */
-        for (const octomap::OcTreeKey& it : *process_model_cells_set_)
+        if (tree_->computeRayKeys(batch.sensor_origin, tree_->keyToCoord(ray_ends_[i].first), key_ray))
         {
-          if (tree_->computeRayKeys(process_sensor_origin_, tree_->keyToCoord(it), key_ray2))
-          {
-            for (octomap::OcTreeKey& jt : key_ray2)
-              free_cells2[jt]++;
-          }
+          for (const octomap::OcTreeKey& jt : key_ray)
+            thread_free_cells[jt] += ray_ends_[i].second;
         }
       }
     }
 
     tree_->unlockRead();
 
-    for (std::pair<const octomap::OcTreeKey, unsigned int>& it : *process_occupied_cells_set_)
+    for (unsigned int i = 1; i < num_threads_; ++i)
     {
-      free_cells1.erase(it.first);
-      free_cells2.erase(it.first);
+      for (const std::pair<const octomap::OcTreeKey, unsigned int>& it : thread_free_cells_[i])
+        free_cells[it.first] += it.second;
+      thread_free_cells_[i].clear();
     }
 
-    for (const octomap::OcTreeKey& it : *process_model_cells_set_)
-    {
-      free_cells1.erase(it);
-      free_cells2.erase(it);
-    }
-    RCLCPP_DEBUG(logger_, "Marking %lu cells as free...",
-                 static_cast<long unsigned int>(free_cells1.size() + free_cells2.size()));
+    for (const std::pair<const octomap::OcTreeKey, unsigned int>& it : ray_ends_)
+      free_cells.erase(it.first);
+
+    RCLCPP_DEBUG(logger_, "Marking %lu cells as free...", static_cast<long unsigned int>(free_cells.size()));
 
     tree_->lockWrite();
 
     try
     {
       // set the logodds to the minimum for the cells that are part of the model
-      for (const octomap::OcTreeKey& it : *process_model_cells_set_)
+      for (const octomap::OcTreeKey& it : *batch.model_cells)
         tree_->updateNode(it, lg_0);
 
       /* mark free cells only if not seen occupied in this cloud */
-      for (std::pair<const octomap::OcTreeKey, unsigned int>& it : free_cells1)
-        tree_->updateNode(it.first, it.second * lg_miss);
-      for (std::pair<const octomap::OcTreeKey, unsigned int>& it : free_cells2)
+      for (std::pair<const octomap::OcTreeKey, unsigned int>& it : free_cells)
         tree_->updateNode(it.first, it.second * lg_miss);
     }
     catch (...)
@@ -200,77 +282,69 @@ void LazyFreeSpaceUpdater::processThread()
     tree_->unlockWrite();
     tree_->triggerUpdateCallback();
 
-    RCLCPP_DEBUG(logger_, "Marked free cells in %lf ms", (clock.now() - start).seconds() * 1000.0);
+    const double lag = std::chrono::duration<double>(std::chrono::steady_clock::now() - batch.stamp).count();
+    {
+      std::scoped_lock _(statistics_lock_);
+      statistics_.processed_frames += batch.frames;
+      statistics_.lag = lag;
+      statistics_.max_lag = std::max(statistics_.max_lag, lag);
+    }
+    RCLCPP_DEBUG(logger_, "Marked free cells of %u frames in %lf ms, %lf ms after the oldest frame was pushed",
+                 batch.frames, (clock.now() - start).seconds() * 1000.0, lag * 1000.0);
 
-    delete process_occupied_cells_set_;
-    process_occupied_cells_set_ = nullptr;
-    delete process_model_cells_set_;
-    process_model_cells_set_ = nullptr;
+    deleteUpdate(batch);
   }
 }
 
 void LazyFreeSpaceUpdater::lazyUpdateThread()
 {
-  OcTreeKeyCountMap* occupied_cells_set = nullptr;
-  octomap::KeySet* model_cells_set = nullptr;
-  octomap::point3d sensor_origin;
-  unsigned int batch_size = 0;
+  LazyUpdate batch;
+  std::deque<LazyUpdate> updates;
 
   while (running_)
   {
-    std::unique_lock<std::mutex> ulock(update_cell_sets_lock_);
-    while (occupied_cells_sets_.empty() && running_)
-      update_condition_.wait(ulock);
+    {
+      std::unique_lock<std::mutex> ulock(update_cell_sets_lock_);
+      while (update_queue_.empty() && running_)
+        update_condition_.wait(ulock);
 
-    if (!running_)
-      break;
+      if (!running_)
+        break;
 
-    if (batch_size == 0)
-    {
-      occupied_cells_set = new OcTreeKeyCountMap();
-      octomap::KeySet* s = occupied_cells_sets_.front();
-      occupied_cells_sets_.pop_front();
-      for (const octomap::OcTreeKey& it : *s)
-        (*occupied_cells_set)[it]++;
-      delete s;
-      model_cells_set = model_cells_sets_.front();
-      model_cells_sets_.pop_front();
-      sensor_origin = sensor_origins_.front();
-      sensor_origins_.pop_front();
-      batch_size++;
+      // merge outside of the lock, so that pushing frames is never blocked by batching
+      updates.swap(update_queue_);
     }
 
-    while (!occupied_cells_sets_.empty())
+    for (LazyUpdate& update : updates)
     {
-      if ((sensor_origins_.front() - sensor_origin).norm() > max_sensor_delta_)
+      if (batch.occupied_cells && (update.sensor_origin - batch.sensor_origin).norm() > max_sensor_delta_)
       {
         RCLCPP_DEBUG(logger_, "Pushing %u sets of occupied/model cells to free cells update thread (origin changed)",
-                     batch_size);
-        pushBatchToProcess(occupied_cells_set, model_cells_set, sensor_origin);
-        batch_size = 0;
-        break;
+                     batch.frames);
+        pushBatchToProcess(batch);
+      }
+
+      if (!batch.occupied_cells)
+      {
+        batch = update;
+      }
+      else
+      {
+        mergeUpdate(batch, *update.occupied_cells, *update.model_cells, update.frames);
+        deleteUpdate(update);
       }
-      sensor_origins_.pop_front();
-
-      octomap::KeySet* add_occ = occupied_cells_sets_.front();
-      for (const octomap::OcTreeKey& it : *add_occ)
-        (*occupied_cells_set)[it]++;
-      occupied_cells_sets_.pop_front();
-      delete add_occ;
-      octomap::KeySet* mod_occ = model_cells_sets_.front();
-      model_cells_set->insert(mod_occ->begin(), mod_occ->end());
-      model_cells_sets_.pop_front();
-      delete mod_occ;
-      batch_size++;
     }
+    updates.clear();
 
-    if (batch_size >= max_batch_size_)
+    if (batch.frames >= max_batch_size_)
     {
-      RCLCPP_DEBUG(logger_, "Pushing %u sets of occupied/model cells to free cells update thread", batch_size);
-      pushBatchToProcess(occupied_cells_set, model_cells_set, sensor_origin);
-      occupied_cells_set = nullptr;
-      batch_size = 0;
+      RCLCPP_DEBUG(logger_, "Pushing %u sets of occupied/model cells to free cells update thread", batch.frames);
+      pushBatchToProcess(batch);
     }
   }
+
+  for (LazyUpdate& update : updates)
+    deleteUpdate(update);
+  deleteUpdate(batch);
 }
 }  // namespace occupancy_map_monitor
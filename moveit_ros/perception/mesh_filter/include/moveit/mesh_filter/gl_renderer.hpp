@@ -69,8 +69,9 @@ public:
    * \param[in] height height of the framebuffers
    * \param[in] near distance of the near clipping plane in meters
    * \param[in] far distance of the far clipping plane in meters
+   * \param[in] color_format internal format of the color buffer, e.g. GL_RGBA16 for exact 16 bit values
    */
-  GLRenderer(unsigned width, unsigned height, double near = 0.1, double far = 10.0);
+  GLRenderer(unsigned width, unsigned height, double near = 0.1, double far = 10.0, GLenum color_format = GL_RGBA);
 
   /** \brief destructor, destroys frame buffer objects and OpenGL context*/
   ~GLRenderer();
@@ -101,6 +102,12 @@ public:
    */
   void getColorBuffer(unsigned char* buffer) const;
 
+  /**
+   * \brief retrieves the color buffer from OpenGL with 16 bit per channel
+   * \param[out] buffer pointer to memory where the 4 color values of each pixel need to be stored
+   */
+  void getColorBuffer(unsigned short* buffer) const;
+
   /**
    * \brief retrieves the depth buffer from OpenGL
    * \author Suat Gedikli (gedikli@willowgarage.com)
@@ -108,6 +115,15 @@ public:
    */
   void getDepthBuffer(float* buffer) const;
 
+  /**
+   * \brief starts to download the color and/or depth buffer into pixel buffer objects without waiting for the
+   * transfer. The next getColorBuffer(unsigned char*) or getDepthBuffer() until the next begin() then only wait for the
+   * remaining transfer instead of stalling the pipeline with a synchronous download.
+   * \param[in] color whether to download the color buffer
+   * \param[in] depth whether to download the depth buffer
+   */
+  void startReadback(bool color, bool depth) const;
+
   /**
    * \brief loads, compiles, links and adds GLSL shaders from files to the current OpenGL context.
    * \author Suat Gedikli (gedikli@willowgarage.com)
@@ -259,6 +275,15 @@ private:
    */
   static void deleteGLContext();
 
+  /**
+   * \brief copies the content of a pixel buffer object that a readback was started for
+   * \param[in] pbo handle to the pixel buffer object
+   * \param[out] buffer pointer to memory where the content needs to be stored
+   * \param[in] size number of bytes to copy
+   * \return false if the pixel buffer object could not be mapped
+   */
+  static bool copyPixelBuffer(GLuint pbo, void* buffer, std::size_t size);
+
   /** \brief width of frame buffer objects in pixels*/
   unsigned width_;
 
@@ -277,6 +302,21 @@ private:
   /** \brief handle to depth buffer*/
   GLuint depth_id_;
 
+  /** \brief internal format of the color buffer*/
+  GLenum color_format_;
+
+  /** \brief handle to the pixel buffer object for asynchronous downloads of the color buffer*/
+  GLuint color_pbo_;
+
+  /** \brief handle to the pixel buffer object for asynchronous downloads of the depth buffer*/
+  GLuint depth_pbo_;
+
+  /** \brief whether color_pbo_ holds a download of the current color buffer*/
+  mutable bool color_readback_;
+
+  /** \brief whether depth_pbo_ holds a download of the current depth buffer*/
+  mutable bool depth_readback_;
+
   /** \brief handle to program that is currently used*/
   GLuint program_;
 
@@ -85,6 +85,14 @@ public:
    * \return const reference of the parameters object of the used Sensor
    */
   const typename SensorType::Parameters& parameters() const;
+
+  /**
+   * \brief enables the projection of the filtered depth map into voxel keys with the shaders of the sensor model
+   * \param[in] resolution edge length of the voxels in meters
+   * \param[in] key_offset offset added to the quantized coordinates, e.g. the key of the octree origin
+   * \return false if the OpenGL implementation does not support the projection
+   */
+  bool enableKeyProjection(double resolution, unsigned short key_offset);
 };
 
 template <typename SensorType>
@@ -108,4 +116,11 @@ const typename SensorType::Parameters& MeshFilter<SensorType>::parameters() cons
   return static_cast<typename SensorType::Parameters&>(*sensor_parameters_);
 }
 
+template <typename SensorType>
+bool MeshFilter<SensorType>::enableKeyProjection(double resolution, unsigned short key_offset)
+{
+  return MeshFilterBase::enableKeyProjection(resolution, key_offset, SensorType::FILTER_VERTEX_SHADER_SOURCE,
+                                             SensorType::PROJECT_FRAGMENT_SHADER_SOURCE);
+}
+
 }  // namespace mesh_filter
@@ -77,6 +77,14 @@ public:
     FIRST_LABEL = 16
   };
 
+  /** \brief types of the keys retrieved by getFilteredKeys */
+  enum
+  {
+    NO_KEY = 0,
+    OCCUPIED_KEY = 1,
+    MODEL_KEY = 2
+  };
+
 public:
   /**
    * \brief Constructor
@@ -130,6 +138,8 @@ public:
    * \brief retrieves the filtered depth values
    * \author Suat Gedikli (gedikli@willowgarage.com)
    * \param[out] depth pointer to buffer to be filled with depth values.
+   * \note If the filtered labels or depth were retrieved for the previous sensor data, their download is started
+   * right after filtering, such that retrieving them again only waits for the remaining transfer.
    */
   void getFilteredDepth(float* depth) const;
 
@@ -151,6 +161,26 @@ public:
    */
   void getModelDepth(float* depth) const;
 
+  /**
+   * \brief enables the third pass that back-projects the sensor data and quantizes it into voxel keys on the GPU
+   * \param[in] resolution edge length of the voxels in meters
+   * \param[in] key_offset offset added to the quantized coordinates, e.g. the key of the octree origin
+   * \param[in] vertex_shader source code of the vertex shader of the pass
+   * \param[in] fragment_shader source code of the fragment shader of the pass
+   * \return false if the OpenGL implementation does not support the pass
+   */
+  bool enableKeyProjection(double resolution, unsigned short key_offset, const std::string& vertex_shader,
+                           const std::string& fragment_shader);
+
+  /**
+   * \brief back-projects the last input depth image into the voxel keys of its points
+   * \param[in] transform transformation from the sensor frame into the frame of the voxels
+   * \param[out] keys pointer to buffer to be filled with 4 values per pixel: the 3 key components and the key type
+   * \note a pixel is of type OCCUPIED_KEY if labeled as background, of type MODEL_KEY if far clipped or labeled as a
+   *       mesh and of type NO_KEY otherwise. The key pass needs to be enabled by enableKeyProjection.
+   */
+  void getFilteredKeys(const Eigen::Isometry3d& transform, unsigned short* keys) const;
+
   /**
    * \brief set the shadow threshold. points that are further away than the rendered model are filtered out.
    *        Except they are further away than this threshold. Then these points are kept, but its label is set to
@@ -205,6 +235,13 @@ protected:
    */
   void doFilter(const void* sensor_data, const int encoding) const;
 
+  /**
+   * \brief the third pass that projects the last filtered depth map into voxel keys
+   * \param[in] transform transformation from the sensor frame into the frame of the voxels
+   * \param[out] keys pointer to buffer to be filled with 4 values per pixel
+   */
+  void doProjectKeys(const Eigen::Isometry3d& transform, unsigned short* keys) const;
+
   /**
    * \brief used within a Job to allow the main thread adding meshes
    * \param[in] handle the handle of the mesh that is predetermined and passed
@@ -272,12 +309,33 @@ protected:
   /** \brief second pass renderer for filtering the results of first pass*/
   GLRendererPtr depth_filter_;
 
+  /** \brief optional third pass renderer for projecting the filtered depth map into voxel keys*/
+  GLRendererPtr key_projector_;
+
   /** \brief canvas element (screen-filling quad) for second pass*/
   GLuint canvas_;
 
   /** \brief handle depth texture from sensor data*/
   GLuint sensor_depth_texture_;
 
+  /** \brief handle to the unclipped depth texture from sensor data, used by the key projection*/
+  GLuint raw_depth_texture_;
+
+  /** \brief scale from the values of raw_depth_texture_ to meters*/
+  mutable float raw_depth_scale_;
+
+  /** \brief whether the filtered labels were retrieved since the last filtering, i.e. are prefetched after the next*/
+  mutable bool filtered_labels_read_;
+
+  /** \brief whether the filtered depth was retrieved since the last filtering, i.e. is prefetched after the next*/
+  mutable bool filtered_depth_read_;
+
+  /** \brief inverse edge length of the voxels of the key projection*/
+  float inverse_key_resolution_;
+
+  /** \brief offset added to the quantized coordinates of the key projection*/
+  float key_offset_;
+
   /** \brief handle to GLSL location of shadow threshold*/
   GLuint shadow_threshold_location_;
 
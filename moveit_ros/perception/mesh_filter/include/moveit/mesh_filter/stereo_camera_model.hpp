@@ -88,8 +88,8 @@ public:
     void setRenderParameters(GLRenderer& renderer) const override;
 
     /**
-     * \brief set the shader parameters required for the mesh filtering
-     * @param[in] renderer the renderer that holds the filtering shader
+     * \brief set the shader parameters required for the mesh filtering and the key projection
+     * @param[in] renderer the renderer that holds the filtering or projection shader
      */
     void setFilterParameters(GLRenderer& renderer) const override;
 
@@ -163,5 +163,8 @@ public:
 
   /** \brief source code of the fragment shader used to filter the depth map*/
   static const std::string FILTER_FRAGMENT_SHADER_SOURCE;
+
+  /** \brief source code of the fragment shader used to project the filtered depth map into voxel keys*/
+  static const std::string PROJECT_FRAGMENT_SHADER_SOURCE;
 };
 }  // namespace mesh_filter
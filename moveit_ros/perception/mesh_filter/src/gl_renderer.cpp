@@ -44,6 +44,7 @@
 #include <GL/freeglut.h>
 #include <moveit/mesh_filter/gl_renderer.hpp>
 #include <moveit/utils/logger.hpp>
+#include <cstring>
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
@@ -54,13 +55,18 @@
 
 using namespace std;
 
-mesh_filter::GLRenderer::GLRenderer(unsigned width, unsigned height, double near, double far)
+mesh_filter::GLRenderer::GLRenderer(unsigned width, unsigned height, double near, double far, GLenum color_format)
   : width_(width)
   , height_(height)
   , fbo_id_(0)
   , rbo_id_(0)
   , rgb_id_(0)
   , depth_id_(0)
+  , color_format_(color_format)
+  , color_pbo_(0)
+  , depth_pbo_(0)
+  , color_readback_(false)
+  , depth_readback_(false)
   , program_(0)
   , near_(near)
   , far_(far)
@@ -129,7 +135,7 @@ void mesh_filter::GLRenderer::initFrameBuffers()
 {
   glGenTextures(1, &rgb_id_);
   glBindTexture(GL_TEXTURE_2D, rgb_id_);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexImage2D(GL_TEXTURE_2D, 0, color_format_, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -165,6 +171,16 @@ void mesh_filter::GLRenderer::initFrameBuffers()
     throw runtime_error("Couldn't create frame buffer");
 
   glBindFramebuffer(GL_FRAMEBUFFER, 0);  // Unbind our frame buffer
+
+  // both buffers are downloaded with 4 bytes per pixel
+  glGenBuffers(1, &color_pbo_);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, color_pbo_);
+  glBufferData(GL_PIXEL_PACK_BUFFER, width_ * height_ * 4, nullptr, GL_STREAM_READ);
+  glGenBuffers(1, &depth_pbo_);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, depth_pbo_);
+  glBufferData(GL_PIXEL_PACK_BUFFER, width_ * height_ * sizeof(float), nullptr, GL_STREAM_READ);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  color_readback_ = depth_readback_ = false;
 }
 
 void mesh_filter::GLRenderer::deleteFrameBuffers()
@@ -177,8 +193,13 @@ void mesh_filter::GLRenderer::deleteFrameBuffers()
     glDeleteTextures(1, &depth_id_);
   if (rgb_id_)
     glDeleteTextures(1, &rgb_id_);
+  if (color_pbo_)
+    glDeleteBuffers(1, &color_pbo_);
+  if (depth_pbo_)
+    glDeleteBuffers(1, &depth_pbo_);
 
-  rbo_id_ = fbo_id_ = depth_id_ = rgb_id_ = 0;
+  rbo_id_ = fbo_id_ = depth_id_ = rgb_id_ = color_pbo_ = depth_pbo_ = 0;
+  color_readback_ = depth_readback_ = false;
 }
 
 void mesh_filter::GLRenderer::begin() const
@@ -186,6 +207,8 @@ void mesh_filter::GLRenderer::begin() const
   glPushAttrib(GL_VIEWPORT_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_POLYGON_BIT | GL_PIXEL_MODE_BIT);
   glBindFramebuffer(GL_FRAMEBUFFER, fbo_id_);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  // started downloads belong to the previous content of the buffers
+  color_readback_ = depth_readback_ = false;
   glViewport(0, 0, width_, height_);
   glUseProgram(program_);
   setCameraParameters();
@@ -207,20 +230,66 @@ void mesh_filter::GLRenderer::end() const
 
 void mesh_filter::GLRenderer::getColorBuffer(unsigned char* buffer) const
 {
+  if (color_readback_ && copyPixelBuffer(color_pbo_, buffer, width_ * height_ * 4))
+    return;
   glBindFramebuffer(GL_FRAMEBUFFER, fbo_id_);
   glBindTexture(GL_TEXTURE_2D, rgb_id_);
   glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer);
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+void mesh_filter::GLRenderer::getColorBuffer(unsigned short* buffer) const
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_id_);
+  glBindTexture(GL_TEXTURE_2D, rgb_id_);
+  glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_SHORT, buffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
 void mesh_filter::GLRenderer::getDepthBuffer(float* buffer) const
 {
+  if (depth_readback_ && copyPixelBuffer(depth_pbo_, buffer, width_ * height_ * sizeof(float)))
+    return;
   glBindFramebuffer(GL_FRAMEBUFFER, fbo_id_);
   glBindTexture(GL_TEXTURE_2D, depth_id_);
   glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, GL_FLOAT, buffer);
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+void mesh_filter::GLRenderer::startReadback(bool color, bool depth) const
+{
+  // with a pixel pack buffer bound, glGetTexImage only queues the transfer and returns
+  if (color)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, color_pbo_);
+    glBindTexture(GL_TEXTURE_2D, rgb_id_);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    color_readback_ = true;
+  }
+  if (depth)
+  {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, depth_pbo_);
+    glBindTexture(GL_TEXTURE_2D, depth_id_);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    depth_readback_ = true;
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool mesh_filter::GLRenderer::copyPixelBuffer(GLuint pbo, void* buffer, std::size_t size)
+{
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+  const void* data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if (data)
+  {
+    memcpy(buffer, data, size);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  return data != nullptr;
+}
+
 GLuint mesh_filter::GLRenderer::setShadersFromFile(const string& vertex_filename, const string& fragment_filename)
 {
   if (program_)
@@ -61,6 +61,12 @@ mesh_filter::MeshFilterBase::MeshFilterBase(const TransformCallback& transform_c
   , next_handle_(FIRST_LABEL)  // 0 and 1 are reserved!
   , min_handle_(FIRST_LABEL)
   , stop_(false)
+  , raw_depth_texture_(0)
+  , raw_depth_scale_(1.0)
+  , filtered_labels_read_(false)
+  , filtered_depth_read_(false)
+  , inverse_key_resolution_(1.0)
+  , key_offset_(0.0)
   , transform_callback_(transform_callback)
   , padding_scale_(1.0)
   , padding_offset_(0.01)
@@ -148,10 +154,13 @@ void mesh_filter::MeshFilterBase::deInitialize()
 {
   glDeleteLists(canvas_, 1);
   glDeleteTextures(1, &sensor_depth_texture_);
+  if (raw_depth_texture_)
+    glDeleteTextures(1, &raw_depth_texture_);
 
   meshes_.clear();
   mesh_renderer_.reset();
   depth_filter_.reset();
+  key_projector_.reset();
 }
 
 void mesh_filter::MeshFilterBase::setSize(unsigned int width, unsigned int height)
@@ -163,6 +172,43 @@ void mesh_filter::MeshFilterBase::setSize(unsigned int width, unsigned int heigh
   depth_filter_->setCameraParameters(width, width, width >> 1, height >> 1);
 }
 
+bool mesh_filter::MeshFilterBase::enableKeyProjection(double resolution, unsigned short key_offset,
+                                                      const std::string& vertex_shader,
+                                                      const std::string& fragment_shader)
+{
+  FilterJob<bool>* enabler = new FilterJob<bool>([this, resolution, key_offset, &vertex_shader, &fragment_shader] {
+    try
+    {
+      // 16 bit per channel hold the keys exactly, such that only the keys need to be downloaded
+      GLRendererPtr key_projector = std::make_shared<GLRenderer>(
+          sensor_parameters_->getWidth(), sensor_parameters_->getHeight(),
+          sensor_parameters_->getNearClippingPlaneDistance(), sensor_parameters_->getFarClippingPlaneDistance(),
+          GL_RGBA16);
+      key_projector->setShadersFromString(vertex_shader, fragment_shader);
+
+      key_projector->begin();
+      glUniform1i(glGetUniformLocation(key_projector->getProgramID(), "raw"), 6);
+      glUniform1i(glGetUniformLocation(key_projector->getProgramID(), "label"), 4);
+      key_projector->end();
+
+      if (!raw_depth_texture_)
+        glGenTextures(1, &raw_depth_texture_);
+      inverse_key_resolution_ = 1.0 / resolution;
+      key_offset_ = key_offset;
+      key_projector_ = key_projector;
+      return true;
+    }
+    catch (const std::runtime_error&)
+    {
+      return false;
+    }
+  });
+  JobPtr job(enabler);
+  addJob(job);
+  job->wait();
+  return enabler->getResult();
+}
+
 void mesh_filter::MeshFilterBase::setTransformCallback(const TransformCallback& transform_callback)
 {
   std::unique_lock<std::mutex> _(transform_callback_mutex_);
@@ -245,7 +291,10 @@ void mesh_filter::MeshFilterBase::getModelDepth(float* depth) const
 
 void mesh_filter::MeshFilterBase::getFilteredDepth(float* depth) const
 {
-  JobPtr job1 = std::make_shared<FilterJob<void>>([&filter = *depth_filter_, depth] { filter.getDepthBuffer(depth); });
+  JobPtr job1 = std::make_shared<FilterJob<void>>([this, depth] {
+    filtered_depth_read_ = true;
+    depth_filter_->getDepthBuffer(depth);
+  });
   JobPtr job2 = std::make_shared<FilterJob<void>>(
       [&parameters = *sensor_parameters_, depth] { parameters.transformFilteredDepthToMetricDepth(depth); });
   {
@@ -260,8 +309,10 @@ void mesh_filter::MeshFilterBase::getFilteredDepth(float* depth) const
 
 void mesh_filter::MeshFilterBase::getFilteredLabels(LabelType* labels) const
 {
-  JobPtr job = std::make_shared<FilterJob<void>>(
-      [&filter = *depth_filter_, labels] { filter.getColorBuffer(reinterpret_cast<unsigned char*>(labels)); });
+  JobPtr job = std::make_shared<FilterJob<void>>([this, labels] {
+    filtered_labels_read_ = true;
+    depth_filter_->getColorBuffer(reinterpret_cast<unsigned char*>(labels));
+  });
   addJob(job);
   job->wait();
 }
@@ -393,6 +444,60 @@ void mesh_filter::MeshFilterBase::doFilter(const void* sensor_data, const int en
   glBindTexture(GL_TEXTURE_2D, color_texture);
   glCallList(canvas_);
   depth_filter_->end();
+
+  // clients usually retrieve the same results for each sensor data, so their downloads overlap with the key projection
+  // and the wake up of the client instead of stalling the pipeline when they were requested
+  depth_filter_->startReadback(filtered_labels_read_, filtered_depth_read_);
+  filtered_labels_read_ = filtered_depth_read_ = false;
+
+  // the key projection needs the depth beyond the clipping planes, so it gets an unscaled copy of the sensor data
+  if (key_projector_)
+  {
+    glActiveTexture(GL_TEXTURE6);
+    glBindTexture(GL_TEXTURE_2D, raw_depth_texture_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE32F_ARB, sensor_parameters_->getWidth(),
+                 sensor_parameters_->getHeight(), 0, GL_LUMINANCE, encoding, sensor_data);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    // unsigned shorts in millimeters are mapped to the range 0-1 during transfer
+    raw_depth_scale_ = (encoding == GL_UNSIGNED_SHORT) ? 65.535 : 1.0;
+  }
+}
+
+void mesh_filter::MeshFilterBase::doProjectKeys(const Eigen::Isometry3d& transform, unsigned short* keys) const
+{
+  key_projector_->begin();
+  sensor_parameters_->setFilterParameters(*key_projector_);
+  glEnable(GL_TEXTURE_2D);
+  glEnable(GL_DEPTH_TEST);
+  glDepthFunc(GL_ALWAYS);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_ALPHA_TEST);
+  glDisable(GL_BLEND);
+
+  const GLuint program = key_projector_->getProgramID();
+  const Eigen::Matrix3f rotation = transform.linear().cast<float>();
+  const Eigen::Vector3f translation = transform.translation().cast<float>();
+  // Eigen and OpenGL both store matrices in column-major order
+  glUniformMatrix3fv(glGetUniformLocation(program, "rotation"), 1, GL_FALSE, rotation.data());
+  glUniform3f(glGetUniformLocation(program, "translation"), translation[0], translation[1], translation[2]);
+  glUniform1f(glGetUniformLocation(program, "depth_scale"), raw_depth_scale_);
+  glUniform1f(glGetUniformLocation(program, "inverse_resolution"), inverse_key_resolution_);
+  glUniform1f(glGetUniformLocation(program, "key_offset"), key_offset_);
+
+  // bind unscaled sensor depth
+  glActiveTexture(GL_TEXTURE6);
+  glBindTexture(GL_TEXTURE_2D, raw_depth_texture_);
+
+  // bind filtered labels
+  glActiveTexture(GL_TEXTURE4);
+  glBindTexture(GL_TEXTURE_2D, depth_filter_->getColorTexture());
+  glCallList(canvas_);
+  key_projector_->end();
+
+  key_projector_->getColorBuffer(keys);
 }
 
 void mesh_filter::MeshFilterBase::setPaddingOffset(float offset)
@@ -404,3 +509,13 @@ void mesh_filter::MeshFilterBase::setPaddingScale(float scale)
 {
   padding_scale_ = scale;
 }
+
+void mesh_filter::MeshFilterBase::getFilteredKeys(const Eigen::Isometry3d& transform, unsigned short* keys) const
+{
+  if (!key_projector_)
+    throw std::runtime_error("The key projection is not enabled.");
+
+  JobPtr job = std::make_shared<FilterJob<void>>([this, transform, keys] { doProjectKeys(transform, keys); });
+  addJob(job);
+  job->wait();
+}
@@ -100,6 +100,8 @@ void mesh_filter::StereoCameraModel::Parameters::setFilterParameters(GLRenderer&
 {
   glUniform1f(glGetUniformLocation(renderer.getProgramID(), "near"), near_clipping_plane_distance_);
   glUniform1f(glGetUniformLocation(renderer.getProgramID(), "far"), far_clipping_plane_distance_);
+  glUniform2f(glGetUniformLocation(renderer.getProgramID(), "focal_length"), fx_, fy_);
+  glUniform2f(glGetUniformLocation(renderer.getProgramID(), "principal_point"), cx_, cy_);
 
   renderer.setClippingRange(near_clipping_plane_distance_, far_clipping_plane_distance_);
   renderer.setBufferSize(width_, height_);
@@ -180,3 +182,34 @@ const std::string mesh_filter::StereoCameraModel::FILTER_FRAGMENT_SHADER_SOURCE
     "      }"
     " }"
     "}";
+
+// keys are written as normalized 16 bit values, so that the color buffer holds the exact octree keys. The type
+// follows the labels of the filter pass: background pixels are occupied, far clipped and model pixels are model cells.
+const std::string mesh_filter::StereoCameraModel::PROJECT_FRAGMENT_SHADER_SOURCE =
+    "#version 120\n"
+    "uniform sampler2D raw;"
+    "uniform sampler2D label;"
+    "uniform vec2 focal_length;"
+    "uniform vec2 principal_point;"
+    "uniform float depth_scale;"
+    "uniform mat3 rotation;"
+    "uniform vec3 translation;"
+    "uniform float inverse_resolution;"
+    "uniform float key_offset;"
+    "const float keyScale = 1.0 / 65535.0;"
+    "void main()"
+    "{"
+    " vec4 lValue = floor(texture2D(label, gl_TexCoord[0].st) * 255.0 + 0.5);"
+    " float zValue = float(texture2D(raw, gl_TexCoord[0].st)) * depth_scale;"
+    " float type = 0.0;"
+    " if (zValue > 0.0) {"
+    "   if (lValue.g + lValue.b + lValue.a > 0.0 || lValue.r >= 3.0)"
+    "     type = 2.0;"
+    "   else if (lValue.r == 0.0)"
+    "     type = 1.0;"
+    " }"
+    " vec2 pixel = gl_FragCoord.xy - 0.5;"
+    " vec3 point = vec3((pixel - principal_point) / focal_length * zValue, zValue);"
+    " vec3 key = floor((rotation * point + translation) * inverse_resolution) + key_offset;"
+    " gl_FragColor = vec4(key, type) * keyScale;"
+    "}";
@@ -73,6 +73,9 @@ public:
 
   void setTransformCallback(const TransformCallback& transform_callback);
 
+  /** \brief Set the number of threads computing a containment mask, 1 by default */
+  void setNumThreads(unsigned int num_threads);
+
   /** \brief Compute the containment mask (INSIDE or OUTSIDE) for a given pointcloud. If a mask element is INSIDE, the
      point
       is inside the robot. The point is outside if the mask element is OUTSIDE.
@@ -121,9 +124,35 @@ protected:
   std::vector<bodies::BoundingSphere> bspheres_;
 
 private:
+  /** \brief The number of neighboring points of a cloud that are tested together */
+  static constexpr int BLOCK_SIZE = 64;
+  using Block = Eigen::Matrix<float, 3, BLOCK_SIZE>;
+
+  /** \brief A body at its pose for the current cloud, with the data to test points against it in blocks */
+  struct PosedBody
+  {
+    const bodies::Body* body;
+    Eigen::AlignedBox3f box;
+    shapes::ShapeType type;
+    /** \brief The scaled and padded half extents of boxes, radius and half length of cylinders, radius of spheres */
+    Eigen::Vector3f extents;
+    Eigen::Matrix3f body_R_world;
+    Eigen::Vector3f body_t_world;
+  };
+
   /** \brief Free memory. */
   void freeMemory();
 
+  static PosedBody poseBody(const bodies::Body& body);
+
+  /** \brief Test which candidate points of a block are inside a body, vectorized for boxes, cylinders and spheres */
+  static Eigen::Array<bool, 1, BLOCK_SIZE> containsPoints(const PosedBody& body, const Block& points,
+                                                          const Eigen::Array<bool, 1, BLOCK_SIZE>& candidates);
+
+  /** \brief The bodies with a transform for the current cloud, in the order of bodies_ */
+  std::vector<PosedBody> posed_bodies_;
+  unsigned int num_threads_;
+
   ShapeHandle next_handle_;
   ShapeHandle min_handle_;
   std::map<ShapeHandle, std::set<SeeShape, SortBodies>::iterator> used_handles_;
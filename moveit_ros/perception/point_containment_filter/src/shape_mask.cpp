@@ -41,6 +41,8 @@
 #include <rclcpp/logging.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <algorithm>
+
 namespace
 {
 rclcpp::Logger getLogger()
@@ -50,7 +52,7 @@ rclcpp::Logger getLogger()
 }  // namespace
 
 point_containment_filter::ShapeMask::ShapeMask(const TransformCallback& transform_callback)
-  : transform_callback_(transform_callback), next_handle_(1), min_handle_(1)
+  : transform_callback_(transform_callback), num_threads_(1), next_handle_(1), min_handle_(1)
 {
 }
 
@@ -66,6 +68,12 @@ void point_containment_filter::ShapeMask::freeMemory()
   bodies_.clear();
 }
 
+void point_containment_filter::ShapeMask::setNumThreads(unsigned int num_threads)
+{
+  std::scoped_lock _(shapes_lock_);
+  num_threads_ = std::max(num_threads, 1u);
+}
+
 void point_containment_filter::ShapeMask::setTransformCallback(const TransformCallback& transform_callback)
 {
   std::scoped_lock _(shapes_lock_);
@@ -143,6 +151,7 @@ void point_containment_filter::ShapeMask::maskContainment(const sensor_msgs::msg
   {
     Eigen::Isometry3d tmp;
     bspheres_.resize(bodies_.size());
+    posed_bodies_.clear();
     std::size_t j = 0;
     for (std::set<SeeShape>::const_iterator it = bodies_.begin(); it != bodies_.end(); ++it)
     {
@@ -163,6 +172,7 @@ void point_containment_filter::ShapeMask::maskContainment(const sensor_msgs::msg
       {
         it->body->setPose(tmp);
         it->body->computeBoundingSphere(bspheres_[j++]);
+        posed_bodies_.push_back(poseBody(*it->body));
       }
     }
 
@@ -176,31 +186,133 @@ void point_containment_filter::ShapeMask::maskContainment(const sensor_msgs::msg
     sensor_msgs::PointCloud2ConstIterator<float> iter_y(data_in, "y");
     sensor_msgs::PointCloud2ConstIterator<float> iter_z(data_in, "z");
 
-    // Cloud iterators are not incremented in the for loop, because of the pragma
-    // Comment out below parallelization as it can result in very high CPU consumption
-    //#pragma omp parallel for schedule(dynamic)
-    for (int i = 0; i < static_cast<int>(np); ++i)
+    // The points are tested in blocks of neighbors in the cloud, which are usually close to each other. Only the bodies
+    // whose bounding box overlaps the bounding box of a block are tested, primitive bodies for all its points at once.
+    const Eigen::Vector3f bound_center = bound.center.cast<float>();
+    const auto min_dist = static_cast<float>(min_sensor_dist);
+    const auto max_dist = static_cast<float>(max_sensor_dist);
+    const auto num_blocks = static_cast<int>((np + BLOCK_SIZE - 1) / BLOCK_SIZE);
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads_) if (num_threads_ > 1)
+    for (int block = 0; block < num_blocks; ++block)
     {
-      Eigen::Vector3d pt = Eigen::Vector3d(*(iter_x + i), *(iter_y + i), *(iter_z + i));
-      double d = pt.norm();
-      int out = OUTSIDE;
-      if (d < min_sensor_dist || d > max_sensor_dist)
+      const unsigned int begin = static_cast<unsigned int>(block) * BLOCK_SIZE;
+      const unsigned int size = std::min<unsigned int>(BLOCK_SIZE, np - begin);
+      Block points;
+      Eigen::Array<bool, 1, BLOCK_SIZE> candidates;
+      Eigen::AlignedBox3f block_box;
+      for (unsigned int i = 0; i < BLOCK_SIZE; ++i)
       {
-        out = CLIP;
+        // Padding points of the last block are at the bound center and never candidates
+        candidates[i] = false;
+        if (i >= size)
+        {
+          points.col(i) = bound_center;
+          continue;
+        }
+        points.col(i) << *(iter_x + begin + i), *(iter_y + begin + i), *(iter_z + begin + i);
+
+        const float d = points.col(i).norm();
+        int out = OUTSIDE;
+        if (d < min_dist || d > max_dist)
+        {
+          out = CLIP;
+        }
+        else if ((bound_center - points.col(i)).squaredNorm() < radius_squared)
+        {
+          candidates[i] = true;
+          block_box.extend(points.col(i));
+        }
+        mask[begin + i] = out;
       }
-      else if ((bound.center - pt).squaredNorm() < radius_squared)
+
+      for (auto body = posed_bodies_.cbegin(); body != posed_bodies_.cend() && candidates.any(); ++body)
       {
-        for (std::set<SeeShape>::const_iterator it = bodies_.begin(); it != bodies_.end() && out == OUTSIDE; ++it)
+        if (!body->box.intersects(block_box))
+          continue;
+        const Eigen::Array<bool, 1, BLOCK_SIZE> inside = containsPoints(*body, points, candidates);
+        for (unsigned int i = 0; i < size; ++i)
         {
-          if (it->body->containsPoint(pt))
-            out = INSIDE;
+          if (inside[i])
+            mask[begin + i] = INSIDE;
         }
+        candidates = candidates && !inside;
       }
-      mask[i] = out;
     }
   }
 }
 
+point_containment_filter::ShapeMask::PosedBody point_containment_filter::ShapeMask::poseBody(const bodies::Body& body)
+{
+  PosedBody posed_body;
+  posed_body.body = &body;
+  bodies::AABB box;
+  body.computeBoundingBox(box);
+  posed_body.box = box.cast<float>();
+
+  // The scaled and padded dimensions, like the bodies compute them for their containment tests
+  posed_body.type = body.getType();
+  const auto dimensions = body.getDimensions();
+  const double scale = body.getScale();
+  const double padding = body.getPadding();
+  switch (posed_body.type)
+  {
+    case shapes::SPHERE:
+      posed_body.extents.setConstant(static_cast<float>(dimensions[0] * scale + padding));
+      break;
+    case shapes::BOX:
+      for (int i = 0; i < 3; ++i)
+        posed_body.extents[i] = static_cast<float>(dimensions[i] * scale / 2.0 + padding);
+      break;
+    case shapes::CYLINDER:
+      posed_body.extents << static_cast<float>(dimensions[0] * scale + padding),
+          static_cast<float>(dimensions[1] * scale / 2.0 + padding), 0.0f;
+      break;
+    default:
+      posed_body.extents.setZero();
+      break;
+  }
+  const Eigen::Isometry3d body_h_world = body.getPose().inverse();
+  posed_body.body_R_world = body_h_world.linear().cast<float>();
+  posed_body.body_t_world = body_h_world.translation().cast<float>();
+  return posed_body;
+}
+
+Eigen::Array<bool, 1, point_containment_filter::ShapeMask::BLOCK_SIZE>
+point_containment_filter::ShapeMask::containsPoints(const PosedBody& body, const Block& points,
+                                                    const Eigen::Array<bool, 1, BLOCK_SIZE>& candidates)
+{
+  Eigen::Array<bool, 1, BLOCK_SIZE> inside;
+  if (body.type == shapes::SPHERE || body.type == shapes::BOX || body.type == shapes::CYLINDER)
+  {
+    Block local_points = body.body_R_world * points;
+    local_points.colwise() += body.body_t_world;
+    if (body.type == shapes::SPHERE)
+    {
+      inside = local_points.colwise().squaredNorm().array() < body.extents[0] * body.extents[0];
+    }
+    else if (body.type == shapes::BOX)
+    {
+      const Eigen::Array<float, 3, BLOCK_SIZE> distances = local_points.array().abs();
+      inside = (distances.row(0) <= body.extents[0]) && (distances.row(1) <= body.extents[1]) &&
+               (distances.row(2) <= body.extents[2]);
+    }
+    else
+    {
+      inside = (local_points.topRows<2>().colwise().squaredNorm().array() < body.extents[0] * body.extents[0]) &&
+               (local_points.row(2).array().abs() <= body.extents[1]);
+    }
+    return inside && candidates;
+  }
+
+  // Other bodies are only tested for the candidate points in their bounding box
+  for (int i = 0; i < BLOCK_SIZE; ++i)
+  {
+    inside[i] = candidates[i] && body.box.contains(points.col(i)) &&
+                body.body->containsPoint(points.col(i).cast<double>());
+  }
+  return inside;
+}
+
 int point_containment_filter::ShapeMask::getMaskContainment(const Eigen::Vector3d& pt) const
 {
   std::scoped_lock _(shapes_lock_);
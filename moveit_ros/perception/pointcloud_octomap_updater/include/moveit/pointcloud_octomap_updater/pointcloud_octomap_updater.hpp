@@ -51,6 +51,7 @@
 #include <moveit/point_containment_filter/shape_mask.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace occupancy_map_monitor
 {
@@ -75,6 +76,10 @@ protected:
 private:
   bool getShapeTransform(ShapeHandle h, Eigen::Isometry3d& transform) const;
   void cloudMsgCallback(const sensor_msgs::msg::PointCloud2::ConstSharedPtr& cloud_msg);
+  /* copy the points of a cloud that are not cropped, one per octree voxel if voxel filtering is enabled */
+  void prefilterCloud(const sensor_msgs::msg::PointCloud2& cloud, const Eigen::Matrix3f& map_R_sensor,
+                      const Eigen::Vector3f& map_t_sensor);
+  void publishFilteredCloud(const sensor_msgs::msg::PointCloud2& cloud, unsigned int subsample);
 
   // TODO: Enable private node for publishing filtered point cloud
   // ros::NodeHandle root_nh_;
@@ -94,6 +99,12 @@ private:
   double max_range_;
   unsigned int point_subsample_;
   double max_update_rate_;
+  unsigned int num_threads_;
+  bool voxel_filter_;
+  double min_range_;
+  Eigen::Vector3f crop_box_min_;
+  Eigen::Vector3f crop_box_max_;
+  bool prefilter_;
   std::string filtered_cloud_topic_;
   std::string ns_;
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr filtered_cloud_publisher_;
@@ -101,9 +112,25 @@ private:
   message_filters::Subscriber<sensor_msgs::msg::PointCloud2>* point_cloud_subscriber_;
   tf2_ros::MessageFilter<sensor_msgs::msg::PointCloud2>* point_cloud_filter_;
 
-  /* used to store all cells in the map which a given ray passes through during raycasting.
-     we cache this here because it dynamically pre-allocates a lot of memory in its constructor */
-  octomap::KeyRay key_ray_;
+  /* The cells of a point cloud found by one thread */
+  struct CloudCells
+  {
+    octomap::KeySet occupied, model, clip;
+  };
+
+  /* used to store all cells in the map which a given ray passes through during raycasting, one per thread.
+     we cache these here because they dynamically pre-allocate a lot of memory in their constructor */
+  std::vector<octomap::KeyRay> key_rays_;
+
+  /* buffers of the threads integrating a point cloud, reused for the next clouds */
+  std::vector<CloudCells> thread_cells_;
+  std::vector<octomap::KeySet> thread_free_cells_;
+  std::vector<Eigen::Matrix3Xf> thread_points_;
+  std::vector<octomap::OcTreeKey> ray_ends_;
+
+  /* the prefiltered cloud and its voxels, reused for the next clouds */
+  sensor_msgs::msg::PointCloud2 prefiltered_cloud_;
+  octomap::KeySet voxel_keys_;
 
   std::unique_ptr<point_containment_filter::ShapeMask> shape_mask_;
   std::vector<int> mask_;
@@ -54,7 +54,11 @@
 #include <tf2_ros/create_timer_ros.h>
 #include <moveit/utils/logger.hpp>
 #include <rclcpp/version.h>
+#include <omp.h>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
 
 namespace occupancy_map_monitor
@@ -66,6 +70,10 @@ PointCloudOctomapUpdater::PointCloudOctomapUpdater()
   , max_range_(std::numeric_limits<double>::infinity())
   , point_subsample_(1)
   , max_update_rate_(0)
+  , num_threads_(1)
+  , voxel_filter_(false)
+  , min_range_(0.0)
+  , prefilter_(false)
   , point_cloud_subscriber_(nullptr)
   , point_cloud_filter_(nullptr)
   , logger_(moveit::getLogger("moveit.ros.pointcloud_octomap_updater"))
@@ -74,8 +82,29 @@ PointCloudOctomapUpdater::PointCloudOctomapUpdater()
 
 bool PointCloudOctomapUpdater::setParams(const std::string& name_space)
 {
-  // This parameter is optional
+  // These parameters are optional
   node_->get_parameter_or(name_space + ".ns", ns_, std::string());
+  node_->get_parameter_or(name_space + ".num_threads", num_threads_, 1u);
+  node_->get_parameter_or(name_space + ".voxel_filter", voxel_filter_, false);
+  node_->get_parameter_or(name_space + ".min_range", min_range_, 0.0);
+  std::vector<double> crop_box_min, crop_box_max;
+  node_->get_parameter_or(name_space + ".crop_box_min", crop_box_min, std::vector<double>());
+  node_->get_parameter_or(name_space + ".crop_box_max", crop_box_max, std::vector<double>());
+  bool crop = false;
+  crop_box_min_.setConstant(-std::numeric_limits<float>::infinity());
+  crop_box_max_.setConstant(std::numeric_limits<float>::infinity());
+  if (crop_box_min.size() == 3 && crop_box_max.size() == 3)
+  {
+    crop_box_min_ = Eigen::Vector3d(crop_box_min.data()).cast<float>();
+    crop_box_max_ = Eigen::Vector3d(crop_box_max.data()).cast<float>();
+    crop = true;
+  }
+  else if (!crop_box_min.empty() || !crop_box_max.empty())
+  {
+    RCLCPP_ERROR(logger_, "The corners of the crop box need 3 coordinates each, not cropping");
+  }
+  prefilter_ = voxel_filter_ || min_range_ > 0.0 || crop;
+
   return node_->get_parameter(name_space + ".point_cloud_topic", point_cloud_topic_) &&
          node_->get_parameter(name_space + ".max_range", max_range_) &&
          node_->get_parameter(name_space + ".padding_offset", padding_) &&
@@ -112,6 +141,8 @@ void PointCloudOctomapUpdater::start()
         node_->create_publisher<sensor_msgs::msg::PointCloud2>(prefix + filtered_cloud_topic_, rclcpp::SensorDataQoS());
   }
 
+  shape_mask_->setNumThreads(num_threads_);
+
   if (point_cloud_subscriber_)
     return;
 
@@ -236,119 +267,140 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
   if (!updateTransformCache(cloud_msg->header.frame_id, cloud_msg->header.stamp))
     return;
 
-  /* mask out points on the robot */
-  shape_mask_->maskContainment(*cloud_msg, sensor_origin_eigen, 0.0, max_range_, mask_);
-  updateMask(*cloud_msg, sensor_origin_eigen, mask_);
-
-  octomap::KeySet free_cells, occupied_cells, model_cells, clip_cells;
-  std::unique_ptr<sensor_msgs::msg::PointCloud2> filtered_cloud;
+  // The sensor pose in single precision, to transform many points at once, which Eigen vectorizes
+  Eigen::Matrix3f map_R_sensor;
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+      map_R_sensor(i, j) = static_cast<float>(map_h_sensor.getBasis()[i][j]);
+  }
+  const Eigen::Vector3f map_t_sensor = sensor_origin_eigen.cast<float>();
 
-  // We only use these iterators if we are creating a filtered_cloud for
-  // publishing. We cannot default construct these, so we use unique_ptr's
-  // to defer construction
-  std::unique_ptr<sensor_msgs::PointCloud2Iterator<float>> iter_filtered_x;
-  std::unique_ptr<sensor_msgs::PointCloud2Iterator<float>> iter_filtered_y;
-  std::unique_ptr<sensor_msgs::PointCloud2Iterator<float>> iter_filtered_z;
+  /* reduce the cloud before the points are masked and ray cast */
+  if (prefilter_)
+    prefilterCloud(*cloud_msg, map_R_sensor, map_t_sensor);
+  const sensor_msgs::msg::PointCloud2& cloud = prefilter_ ? prefiltered_cloud_ : *cloud_msg;
+  const unsigned int subsample = prefilter_ ? 1 : point_subsample_;
 
-  if (!filtered_cloud_topic_.empty())
+  /* mask out points on the robot */
+  shape_mask_->maskContainment(cloud, sensor_origin_eigen, 0.0, max_range_, mask_);
+  updateMask(cloud, sensor_origin_eigen, mask_);
+
+  const unsigned int num_threads = std::max(num_threads_, 1u);
+  thread_cells_.resize(num_threads);
+  thread_free_cells_.resize(num_threads);
+  thread_points_.resize(num_threads);
+  key_rays_.resize(num_threads);
+  for (unsigned int thread = 0; thread < num_threads; ++thread)
   {
-    filtered_cloud = std::make_unique<sensor_msgs::msg::PointCloud2>();
-    filtered_cloud->header = cloud_msg->header;
-    sensor_msgs::PointCloud2Modifier pcd_modifier(*filtered_cloud);
-    pcd_modifier.setPointCloud2FieldsByString(1, "xyz");
-    pcd_modifier.resize(cloud_msg->width * cloud_msg->height);
-
-    // we have created a filtered_out, so we can create the iterators now
-    iter_filtered_x = std::make_unique<sensor_msgs::PointCloud2Iterator<float>>(*filtered_cloud, "x");
-    iter_filtered_y = std::make_unique<sensor_msgs::PointCloud2Iterator<float>>(*filtered_cloud, "y");
-    iter_filtered_z = std::make_unique<sensor_msgs::PointCloud2Iterator<float>>(*filtered_cloud, "z");
+    thread_cells_[thread].occupied.clear();
+    thread_cells_[thread].model.clear();
+    thread_cells_[thread].clip.clear();
+    thread_free_cells_[thread].clear();
   }
-  size_t filtered_cloud_size = 0;
 
+  const auto max_range = static_cast<float>(max_range_);
+  const unsigned int num_rows = (cloud.height + subsample - 1) / subsample;
+  const unsigned int points_per_row = (cloud.width + subsample - 1) / subsample;
+
+  std::atomic<bool> failed{ false };
   tree_->lockRead();
 
-  try
+  /* do ray tracing to find which cells this point cloud indicates should be free, and which it indicates
+   * should be occupied. Each thread collects the cells of its rows, they are merged afterwards. */
+#pragma omp parallel num_threads(num_threads)
   {
-    /* do ray tracing to find which cells this point cloud indicates should be free, and which it indicates
-     * should be occupied */
-    for (unsigned int row = 0; row < cloud_msg->height; row += point_subsample_)
+    const int thread = omp_get_thread_num();
+    CloudCells& cells = thread_cells_[thread];
+    Eigen::Matrix3Xf& points = thread_points_[thread];
+    Eigen::Matrix3Xf map_points(3, points_per_row);
+    points.resize(3, points_per_row);
+
+#pragma omp for schedule(static)
+    for (unsigned int row_index = 0; row_index < num_rows; ++row_index)
     {
-      unsigned int row_c = row * cloud_msg->width;
-      sensor_msgs::PointCloud2ConstIterator<float> pt_iter(*cloud_msg, "x");
-      // set iterator to point at start of the current row
-      pt_iter += row_c;
-
-      for (unsigned int col = 0; col < cloud_msg->width; col += point_subsample_, pt_iter += point_subsample_)
+      try
       {
-        // if (mask_[row_c + col] == point_containment_filter::ShapeMask::CLIP)
-        //  continue;
-
-        /* check for NaN */
-        if (!std::isnan(pt_iter[0]) && !std::isnan(pt_iter[1]) && !std::isnan(pt_iter[2]))
+        const unsigned int row = row_index * subsample;
+        const unsigned int row_c = row * cloud.width;
+        sensor_msgs::PointCloud2ConstIterator<float> pt_iter(cloud, "x");
+        // set iterator to point at start of the current row
+        pt_iter += row_c;
+        for (unsigned int i = 0; i < points_per_row; ++i, pt_iter += subsample)
+          points.col(i) << pt_iter[0], pt_iter[1], pt_iter[2];
+        map_points.noalias() = map_R_sensor * points;
+        map_points.colwise() += map_t_sensor;
+
+        for (unsigned int i = 0; i < points_per_row; ++i)
         {
+          /* check for NaN */
+          if (points.col(i).hasNaN())
+            continue;
+
           /* occupied cell at ray endpoint if ray is shorter than max range and this point
              isn't on a part of the robot*/
-          if (mask_[row_c + col] == point_containment_filter::ShapeMask::INSIDE)
+          const int mask = mask_[row_c + i * subsample];
+          if (mask == point_containment_filter::ShapeMask::INSIDE)
           {
-            // transform to map frame
-            tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(pt_iter[0], pt_iter[1], pt_iter[2]);
-            model_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
+            cells.model.insert(tree_->coordToKey(map_points(0, i), map_points(1, i), map_points(2, i)));
           }
-          else if (mask_[row_c + col] == point_containment_filter::ShapeMask::CLIP)
+          else if (mask == point_containment_filter::ShapeMask::CLIP)
           {
-            tf2::Vector3 clipped_point_tf =
-                map_h_sensor * (tf2::Vector3(pt_iter[0], pt_iter[1], pt_iter[2]).normalize() * max_range_);
-            clip_cells.insert(
-                tree_->coordToKey(clipped_point_tf.getX(), clipped_point_tf.getY(), clipped_point_tf.getZ()));
+            const Eigen::Vector3f clipped_point =
+                map_R_sensor * (points.col(i).normalized() * max_range) + map_t_sensor;
+            cells.clip.insert(tree_->coordToKey(clipped_point.x(), clipped_point.y(), clipped_point.z()));
           }
           else
           {
-            tf2::Vector3 point_tf = map_h_sensor * tf2::Vector3(pt_iter[0], pt_iter[1], pt_iter[2]);
-            occupied_cells.insert(tree_->coordToKey(point_tf.getX(), point_tf.getY(), point_tf.getZ()));
-            // build list of valid points if we want to publish them
-            if (filtered_cloud)
-            {
-              **iter_filtered_x = pt_iter[0];
-              **iter_filtered_y = pt_iter[1];
-              **iter_filtered_z = pt_iter[2];
-              ++filtered_cloud_size;
-              ++*iter_filtered_x;
-              ++*iter_filtered_y;
-              ++*iter_filtered_z;
-            }
+            cells.occupied.insert(tree_->coordToKey(map_points(0, i), map_points(1, i), map_points(2, i)));
           }
         }
       }
+      catch (...)
+      {
+        failed = true;
+      }
     }
+  }
 
-    /* compute the free cells along each ray that ends at an occupied cell */
-    for (const octomap::OcTreeKey& occupied_cell : occupied_cells)
-    {
-      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(occupied_cell), key_ray_))
-        free_cells.insert(key_ray_.begin(), key_ray_.end());
-    }
+  // The cells of all threads, merged into the cells of the first one
+  octomap::KeySet& occupied_cells = thread_cells_[0].occupied;
+  octomap::KeySet& model_cells = thread_cells_[0].model;
+  octomap::KeySet& clip_cells = thread_cells_[0].clip;
+  octomap::KeySet& free_cells = thread_free_cells_[0];
+  for (unsigned int thread = 1; thread < num_threads; ++thread)
+  {
+    occupied_cells.insert(thread_cells_[thread].occupied.begin(), thread_cells_[thread].occupied.end());
+    model_cells.insert(thread_cells_[thread].model.begin(), thread_cells_[thread].model.end());
+    clip_cells.insert(thread_cells_[thread].clip.begin(), thread_cells_[thread].clip.end());
+  }
 
-    /* compute the free cells along each ray that ends at a model cell */
-    for (const octomap::OcTreeKey& model_cell : model_cells)
+  /* compute the free cells along each ray that ends at an occupied, a model or a clipped cell */
+  ray_ends_.clear();
+  ray_ends_.insert(ray_ends_.end(), occupied_cells.begin(), occupied_cells.end());
+  ray_ends_.insert(ray_ends_.end(), model_cells.begin(), model_cells.end());
+  ray_ends_.insert(ray_ends_.end(), clip_cells.begin(), clip_cells.end());
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 64)
+  for (std::size_t i = 0; i < ray_ends_.size(); ++i)
+  {
+    const int thread = omp_get_thread_num();
+    try
     {
-      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(model_cell), key_ray_))
-        free_cells.insert(key_ray_.begin(), key_ray_.end());
+      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(ray_ends_[i]), key_rays_[thread]))
+        thread_free_cells_[thread].insert(key_rays_[thread].begin(), key_rays_[thread].end());
     }
-
-    /* compute the free cells along each ray that ends at a clipped cell */
-    for (const octomap::OcTreeKey& clip_cell : clip_cells)
+    catch (...)
     {
-      if (tree_->computeRayKeys(sensor_origin, tree_->keyToCoord(clip_cell), key_ray_))
-        free_cells.insert(key_ray_.begin(), key_ray_.end());
+      failed = true;
     }
   }
-  catch (...)
-  {
-    tree_->unlockRead();
-    return;
-  }
 
   tree_->unlockRead();
+  if (failed)
+    return;
+
+  for (unsigned int thread = 1; thread < num_threads; ++thread)
+    free_cells.insert(thread_free_cells_[thread].begin(), thread_free_cells_[thread].end());
 
   /* cells that overlap with the model are not occupied */
   for (const octomap::OcTreeKey& model_cell : model_cells)
@@ -383,11 +435,91 @@ void PointCloudOctomapUpdater::cloudMsgCallback(const sensor_msgs::msg::PointClo
   RCLCPP_DEBUG(logger_, "Processed point cloud in %lf ms", (node_->now() - start).seconds() * 1000.0);
   tree_->triggerUpdateCallback();
 
-  if (filtered_cloud)
+  if (!filtered_cloud_topic_.empty())
+    publishFilteredCloud(cloud, subsample);
+}
+
+void PointCloudOctomapUpdater::prefilterCloud(const sensor_msgs::msg::PointCloud2& cloud,
+                                              const Eigen::Matrix3f& map_R_sensor, const Eigen::Vector3f& map_t_sensor)
+{
+  prefiltered_cloud_.header = cloud.header;
+  sensor_msgs::PointCloud2Modifier pcd_modifier(prefiltered_cloud_);
+  if (prefiltered_cloud_.fields.empty())
+    pcd_modifier.setPointCloud2FieldsByString(1, "xyz");
+  pcd_modifier.resize(cloud.width * cloud.height);
+  sensor_msgs::PointCloud2Iterator<float> iter_prefiltered(prefiltered_cloud_, "x");
+  size_t prefiltered_cloud_size = 0;
+  const auto min_range_squared = static_cast<float>(min_range_ * min_range_);
+  voxel_keys_.clear();
+
+  for (unsigned int row = 0; row < cloud.height; row += point_subsample_)
   {
-    sensor_msgs::PointCloud2Modifier pcd_modifier(*filtered_cloud);
-    pcd_modifier.resize(filtered_cloud_size);
-    filtered_cloud_publisher_->publish(*filtered_cloud);
+    const unsigned int row_c = row * cloud.width;
+    sensor_msgs::PointCloud2ConstIterator<float> pt_iter(cloud, "x");
+    pt_iter += row_c;
+    for (unsigned int col = 0; col < cloud.width; col += point_subsample_, pt_iter += point_subsample_)
+    {
+      const Eigen::Vector3f point(pt_iter[0], pt_iter[1], pt_iter[2]);
+      if (point.hasNaN() || point.squaredNorm() < min_range_squared)
+        continue;
+
+      // crop to the region of interest in the map frame
+      const Eigen::Vector3f map_point = map_R_sensor * point + map_t_sensor;
+      if ((map_point.array() < crop_box_min_.array()).any() || (map_point.array() > crop_box_max_.array()).any())
+        continue;
+
+      // keep the first point of each voxel of the octree
+      if (voxel_filter_ && !voxel_keys_.insert(tree_->coordToKey(map_point.x(), map_point.y(), map_point.z())).second)
+        continue;
+
+      iter_prefiltered[0] = point.x();
+      iter_prefiltered[1] = point.y();
+      iter_prefiltered[2] = point.z();
+      ++iter_prefiltered;
+      ++prefiltered_cloud_size;
+    }
+  }
+
+  pcd_modifier.resize(prefiltered_cloud_size);
+}
+
+void PointCloudOctomapUpdater::publishFilteredCloud(const sensor_msgs::msg::PointCloud2& cloud,
+                                                    unsigned int subsample)
+{
+  sensor_msgs::msg::PointCloud2 filtered_cloud;
+  filtered_cloud.header = cloud.header;
+  sensor_msgs::PointCloud2Modifier pcd_modifier(filtered_cloud);
+  pcd_modifier.setPointCloud2FieldsByString(1, "xyz");
+  pcd_modifier.resize(cloud.width * cloud.height);
+  sensor_msgs::PointCloud2Iterator<float> iter_filtered_x(filtered_cloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_filtered_y(filtered_cloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_filtered_z(filtered_cloud, "z");
+  size_t filtered_cloud_size = 0;
+
+  // The valid points that are neither on the robot nor clipped, in the order of the cloud
+  for (unsigned int row = 0; row < cloud.height; row += subsample)
+  {
+    const unsigned int row_c = row * cloud.width;
+    sensor_msgs::PointCloud2ConstIterator<float> pt_iter(cloud, "x");
+    pt_iter += row_c;
+    for (unsigned int col = 0; col < cloud.width; col += subsample, pt_iter += subsample)
+    {
+      const int mask = mask_[row_c + col];
+      if (!std::isnan(pt_iter[0]) && !std::isnan(pt_iter[1]) && !std::isnan(pt_iter[2]) &&
+          mask != point_containment_filter::ShapeMask::INSIDE && mask != point_containment_filter::ShapeMask::CLIP)
+      {
+        *iter_filtered_x = pt_iter[0];
+        *iter_filtered_y = pt_iter[1];
+        *iter_filtered_z = pt_iter[2];
+        ++filtered_cloud_size;
+        ++iter_filtered_x;
+        ++iter_filtered_y;
+        ++iter_filtered_z;
+      }
+    }
   }
+
+  pcd_modifier.resize(filtered_cloud_size);
+  filtered_cloud_publisher_->publish(filtered_cloud);
 }
 }  // namespace occupancy_map_monitor
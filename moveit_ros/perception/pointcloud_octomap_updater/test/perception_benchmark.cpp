@@ -0,0 +1,279 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+// To run this benchmark, 'cd' to the build/moveit_ros_perception/pointcloud_octomap_updater directory and directly run
+// the binary. Benchmarks replay a synthetic frame of a 640x480 sensor through the stages of the octomap updaters and
+// take {source, threads} as arguments, where source 0 is a point cloud and 1 a depth image. Besides the time per frame
+// and the throughput in points and frames per second, the counters give the time of each stage per frame in
+// milliseconds. A concurrent reader locks the octree like a collision checker, which causes the lock wait.
+
+#include <benchmark/benchmark.h>
+#include <moveit/collision_detection/occupancy_map.hpp>
+#include <moveit/point_containment_filter/shape_mask.hpp>
+#include <geometric_shapes/shapes.h>
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+
+#include <omp.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr unsigned int WIDTH = 640;
+constexpr unsigned int HEIGHT = 480;
+constexpr double FOCAL_LENGTH = 525.0;
+constexpr double MAX_RANGE = 5.0;
+constexpr double RESOLUTION = 0.02;
+// A collision checker holding the octree for READ_HOLD out of every READ_PERIOD
+constexpr std::chrono::microseconds READ_HOLD(2000);
+constexpr std::chrono::microseconds READ_PERIOD(10000);
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point& start)
+{
+  const Clock::time_point now = Clock::now();
+  const double ms = std::chrono::duration<double, std::milli>(now - start).count();
+  start = now;
+  return ms;
+}
+
+// The depth in meters seen by pixel (u, v): an uneven wall at 3 m with a box in front, some pixels without data
+float syntheticDepth(unsigned int u, unsigned int v)
+{
+  if ((u * 31 + v * 17) % 50 == 0)
+    return std::numeric_limits<float>::quiet_NaN();
+  if (u > 400 && u < 500 && v > 200 && v < 300)
+    return 1.5f;
+  return 3.0f + 0.2f * std::sin(0.02f * u) * std::cos(0.03f * v);
+}
+
+// A depth image in the sensor frame, with z pointing forward like optical frames
+std::vector<float> createDepthImage()
+{
+  std::vector<float> depth(WIDTH * HEIGHT);
+  for (unsigned int v = 0; v < HEIGHT; ++v)
+  {
+    for (unsigned int u = 0; u < WIDTH; ++u)
+      depth[v * WIDTH + u] = syntheticDepth(u, v);
+  }
+  return depth;
+}
+
+// Back project a depth image into an organized point cloud, as the depth image updater does without the GPU
+void projectDepthImage(const std::vector<float>& depth, sensor_msgs::msg::PointCloud2& cloud)
+{
+  sensor_msgs::PointCloud2Iterator<float> iter_x(cloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_y(cloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_z(cloud, "z");
+  for (unsigned int v = 0; v < HEIGHT; ++v)
+  {
+    for (unsigned int u = 0; u < WIDTH; ++u, ++iter_x, ++iter_y, ++iter_z)
+    {
+      const float d = depth[v * WIDTH + u];
+      *iter_x = (u - 0.5f * WIDTH) / FOCAL_LENGTH * d;
+      *iter_y = (v - 0.5f * HEIGHT) / FOCAL_LENGTH * d;
+      *iter_z = d;
+    }
+  }
+}
+
+sensor_msgs::msg::PointCloud2 createCloud()
+{
+  sensor_msgs::msg::PointCloud2 cloud;
+  cloud.header.frame_id = "sensor";
+  sensor_msgs::PointCloud2Modifier modifier(cloud);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+  modifier.resize(WIDTH * HEIGHT);
+  cloud.width = WIDTH;
+  cloud.height = HEIGHT;
+  cloud.row_step = cloud.width * cloud.point_step;
+  cloud.is_dense = false;
+  return cloud;
+}
+
+// A few robot links in front of the sensor, such that masking has to test many points against their bodies
+void addRobotShapes(point_containment_filter::ShapeMask& mask, std::vector<Eigen::Isometry3d>& poses)
+{
+  const std::vector<std::pair<shapes::ShapeConstPtr, Eigen::Vector3d>> links = {
+    { std::make_shared<shapes::Box>(0.3, 0.3, 0.3), Eigen::Vector3d(0.3, 0.2, 1.0) },
+    { std::make_shared<shapes::Cylinder>(0.08, 0.6), Eigen::Vector3d(0.0, 0.3, 1.2) },
+    { std::make_shared<shapes::Sphere>(0.12), Eigen::Vector3d(-0.3, 0.0, 0.9) },
+    { std::make_shared<shapes::Box>(0.1, 0.1, 0.4), Eigen::Vector3d(-0.2, -0.3, 1.4) },
+  };
+  for (const auto& link : links)
+  {
+    const point_containment_filter::ShapeHandle handle = mask.addShape(link.first, 1.0, 0.03);
+    if (poses.size() <= handle)
+      poses.resize(handle + 1, Eigen::Isometry3d::Identity());
+    poses[handle] = Eigen::Translation3d(link.second) * Eigen::Isometry3d::Identity();
+  }
+}
+}  // namespace
+
+// Update an octree with the same frame over and over, like the point cloud and depth image updaters do on the CPU
+static void octomapUpdate(benchmark::State& st)
+{
+  const bool depth_source = st.range(0) != 0;
+  const auto num_threads = static_cast<unsigned int>(st.range(1));
+
+  std::vector<Eigen::Isometry3d> shape_poses;
+  point_containment_filter::ShapeMask shape_mask(
+      [&shape_poses](point_containment_filter::ShapeHandle handle, Eigen::Isometry3d& transform) {
+        if (handle >= shape_poses.size())
+          return false;
+        transform = shape_poses[handle];
+        return true;
+      });
+  shape_mask.setNumThreads(num_threads);
+  addRobotShapes(shape_mask, shape_poses);
+
+  const std::vector<float> depth = createDepthImage();
+  sensor_msgs::msg::PointCloud2 cloud = createCloud();
+  projectDepthImage(depth, cloud);
+
+  // the sensor looks along the x axis of the map, 1 m above the ground
+  const auto half_pi = static_cast<float>(M_PI_2);
+  const Eigen::Matrix3f map_R_sensor =
+      (Eigen::AngleAxisf(-half_pi, Eigen::Vector3f::UnitZ()) * Eigen::AngleAxisf(-half_pi, Eigen::Vector3f::UnitX()))
+          .toRotationMatrix();
+  const Eigen::Vector3f map_t_sensor(0.0f, 0.0f, 1.0f);
+  const octomap::point3d sensor_origin(map_t_sensor.x(), map_t_sensor.y(), map_t_sensor.z());
+
+  collision_detection::OccMapTree tree(RESOLUTION);
+  std::atomic<bool> stop_reader{ false };
+  std::thread reader([&] {
+    while (!stop_reader)
+    {
+      {
+        collision_detection::OccMapTree::ReadLock lock = tree.reading();
+        std::this_thread::sleep_for(READ_HOLD);
+      }
+      std::this_thread::sleep_for(READ_PERIOD - READ_HOLD);
+    }
+  });
+
+  std::vector<int> mask;
+  Eigen::Matrix3Xf map_points(3, WIDTH * HEIGHT);
+  std::vector<octomap::KeySet> thread_occupied(num_threads), thread_free(num_threads);
+  std::vector<octomap::KeyRay> key_rays(num_threads);
+  std::vector<octomap::OcTreeKey> ray_ends;
+  double transform_ms = 0.0, mask_ms = 0.0, ray_cast_ms = 0.0, lock_wait_ms = 0.0, tree_update_ms = 0.0;
+
+  for (auto _ : st)
+  {
+    Clock::time_point start = Clock::now();
+
+    // transform: back project the depth image, transform the points into the map frame
+    if (depth_source)
+      projectDepthImage(depth, cloud);
+    sensor_msgs::PointCloud2ConstIterator<float> pt_iter(cloud, "x");
+    for (unsigned int i = 0; i < WIDTH * HEIGHT; ++i, ++pt_iter)
+      map_points.col(i) << pt_iter[0], pt_iter[1], pt_iter[2];
+    map_points = (map_R_sensor * map_points).colwise() + map_t_sensor;
+    transform_ms += elapsedMs(start);
+
+    // masking: the points on the robot
+    shape_mask.maskContainment(cloud, Eigen::Vector3d::Zero(), 0.0, MAX_RANGE, mask);
+    mask_ms += elapsedMs(start);
+
+    // ray casting: the occupied cells and the free cells on the rays towards them
+    {
+      collision_detection::OccMapTree::ReadLock lock = tree.reading();
+      for (unsigned int thread = 0; thread < num_threads; ++thread)
+      {
+        thread_occupied[thread].clear();
+        thread_free[thread].clear();
+      }
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+      for (unsigned int i = 0; i < WIDTH * HEIGHT; ++i)
+      {
+        if (mask[i] == point_containment_filter::ShapeMask::OUTSIDE && !map_points.col(i).hasNaN())
+          thread_occupied[omp_get_thread_num()].insert(
+              tree.coordToKey(map_points(0, i), map_points(1, i), map_points(2, i)));
+      }
+      for (unsigned int thread = 1; thread < num_threads; ++thread)
+        thread_occupied[0].insert(thread_occupied[thread].begin(), thread_occupied[thread].end());
+
+      ray_ends.assign(thread_occupied[0].begin(), thread_occupied[0].end());
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 64)
+      for (std::size_t i = 0; i < ray_ends.size(); ++i)
+      {
+        const int thread = omp_get_thread_num();
+        if (tree.computeRayKeys(sensor_origin, tree.keyToCoord(ray_ends[i]), key_rays[thread]))
+          thread_free[thread].insert(key_rays[thread].begin(), key_rays[thread].end());
+      }
+      for (unsigned int thread = 1; thread < num_threads; ++thread)
+        thread_free[0].insert(thread_free[thread].begin(), thread_free[thread].end());
+      for (const octomap::OcTreeKey& key : thread_occupied[0])
+        thread_free[0].erase(key);
+    }
+    ray_cast_ms += elapsedMs(start);
+
+    // lock wait: until readers of the octree are done
+    collision_detection::OccMapTree::WriteLock lock = tree.writing();
+    lock_wait_ms += elapsedMs(start);
+
+    // tree update: integrate the cells
+    for (const octomap::OcTreeKey& key : thread_free[0])
+      tree.updateNode(key, false);
+    for (const octomap::OcTreeKey& key : thread_occupied[0])
+      tree.updateNode(key, true);
+    lock.unlock();
+    tree_update_ms += elapsedMs(start);
+  }
+
+  stop_reader = true;
+  reader.join();
+
+  st.SetItemsProcessed(st.iterations() * WIDTH * HEIGHT);
+  st.counters["frames"] = benchmark::Counter(st.iterations(), benchmark::Counter::kIsRate);
+  st.counters["transform_ms"] = benchmark::Counter(transform_ms, benchmark::Counter::kAvgIterations);
+  st.counters["mask_ms"] = benchmark::Counter(mask_ms, benchmark::Counter::kAvgIterations);
+  st.counters["ray_cast_ms"] = benchmark::Counter(ray_cast_ms, benchmark::Counter::kAvgIterations);
+  st.counters["lock_wait_ms"] = benchmark::Counter(lock_wait_ms, benchmark::Counter::kAvgIterations);
+  st.counters["tree_update_ms"] = benchmark::Counter(tree_update_ms, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(octomapUpdate)
+    ->ArgsProduct({ { 0, 1 }, { 1, 2, 4, 8 } })
+    ->ArgNames({ "source", "threads" })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
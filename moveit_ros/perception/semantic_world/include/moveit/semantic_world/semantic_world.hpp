@@ -113,6 +113,17 @@ public:
                                                                   unsigned int num_heights = 2,
                                                                   double min_distance_from_edge = 0.10) const;
 
+  /**
+   * @brief Generate possible place poses for a given object on several tables concurrently, like the
+   * generatePlacePoses() overload taking a table name.
+   * @param thread_count The maximum number of threads to use, 0 for one per hardware thread
+   * @return The place poses on each table, in the order of \e table_names
+   */
+  std::vector<std::vector<geometry_msgs::msg::PoseStamped>>
+  generatePlacePosesBatch(const std::vector<std::string>& table_names, const shapes::ShapeConstPtr& object_shape,
+                          const geometry_msgs::msg::Quaternion& object_orientation, double resolution,
+                          double delta_height = 0.01, unsigned int num_heights = 2, std::size_t thread_count = 0) const;
+
   void clear();
 
   bool addTablesToCollisionWorld();
@@ -132,6 +143,26 @@ public:
                             double min_distance_from_edge = 0.0, double min_vertical_offset = 0.0) const;
 
 private:
+  struct TableContour;
+  using TableContourConstPtr = std::shared_ptr<const TableContour>;
+
+  static TableContourConstPtr computeTableContour(const object_recognition_msgs::msg::Table& table);
+
+  bool computePlacementOffsets(const shapes::ShapeConstPtr& object_shape,
+                               const geometry_msgs::msg::Quaternion& object_orientation,
+                               double& min_distance_from_edge, double& height_above_table) const;
+
+  std::vector<geometry_msgs::msg::PoseStamped>
+  generateContourPlacePoses(const object_recognition_msgs::msg::Table& table, const TableContour& contour,
+                            double resolution, double height_above_table, double delta_height, unsigned int num_heights,
+                            double min_distance_from_edge) const;
+
+  bool isInsideTableContour(const geometry_msgs::msg::Pose& pose, const TableContour& contour,
+                            double min_distance_from_edge, double min_vertical_offset) const;
+
+  /** @brief Index the footprints of the tables in the collision world on a grid in the XY plane */
+  void buildTableIndex();
+
   shapes::Mesh* createSolidMeshFromPlanarPolygon(const shapes::Mesh& polygon, double thickness) const;
 
   shapes::Mesh* orientPlanarPolygon(const shapes::Mesh& polygon) const;
@@ -150,6 +181,13 @@ private:
 
   std::map<std::string, object_recognition_msgs::msg::Table> current_tables_in_collision_world_;
 
+  /// rasterized contours of the tables in the collision world, computed once when they are added
+  std::map<std::string, TableContourConstPtr> table_contours_;
+
+  /// names of the tables whose footprint overlaps a grid cell, in the order of current_tables_in_collision_world_
+  std::map<std::pair<long, long>, std::vector<std::string>> table_index_;
+  double table_index_cell_size_;
+
   rclcpp::Subscription<object_recognition_msgs::msg::TableArray>::SharedPtr table_subscriber_;
 
   rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr visualization_publisher_;
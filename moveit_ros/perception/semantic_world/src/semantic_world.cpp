@@ -60,14 +60,34 @@
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <Eigen/Geometry>
 
+#include <atomic>
+#include <set>
+#include <thread>
+
 namespace moveit
 {
 namespace semantic_world
 {
+namespace
+{
+// pixels per meter of the images the table contours are rasterized in
+const int SCALE_FACTOR = 100;
+}  // namespace
+
+// The convex hull of a table as a contour in the table frame, for point to polygon tests
+struct SemanticWorld::TableContour
+{
+  float x_min = 0.0f, x_max = 0.0f, y_min = 0.0f, y_max = 0.0f;
+  std::vector<cv::Point> contour;
+  Eigen::Isometry3d pose;
+};
 
 SemanticWorld::SemanticWorld(const rclcpp::Node::SharedPtr& node,
                              const planning_scene::PlanningSceneConstPtr& planning_scene)
-  : planning_scene_(planning_scene), node_handle_(node), logger_(moveit::getLogger("moveit.ros.semantic_world"))
+  : planning_scene_(planning_scene)
+  , node_handle_(node)
+  , table_index_cell_size_(1.0)
+  , logger_(moveit::getLogger("moveit.ros.semantic_world"))
 
 {
   table_subscriber_ = node_handle_->create_subscription<object_recognition_msgs::msg::TableArray>(
@@ -127,6 +147,7 @@ bool SemanticWorld::addTablesToCollisionWorld()
   planning_scene_diff_publisher_->publish(planning_scene);
   planning_scene.world.collision_objects.clear();
   current_tables_in_collision_world_.clear();
+  table_contours_.clear();
   // Add the new tables
   for (std::size_t i = 0; i < table_array_.tables.size(); ++i)
   {
@@ -135,6 +156,7 @@ bool SemanticWorld::addTablesToCollisionWorld()
     ss << "table_" << i;
     co.id = ss.str();
     current_tables_in_collision_world_[co.id] = table_array_.tables[i];
+    table_contours_[co.id] = computeTableContour(table_array_.tables[i]);
     co.operation = moveit_msgs::msg::CollisionObject::ADD;
 
     const std::vector<geometry_msgs::msg::Point>& convex_hull = table_array_.tables[i].convex_hull;
@@ -181,6 +203,7 @@ bool SemanticWorld::addTablesToCollisionWorld()
     delete table_shape;
     delete table_mesh_solid;
   }
+  buildTableIndex();
   planning_scene_diff_publisher_->publish(planning_scene);
   return true;
 }
@@ -223,6 +246,8 @@ void SemanticWorld::clear()
 {
   table_array_.tables.clear();
   current_tables_in_collision_world_.clear();
+  table_contours_.clear();
+  table_index_.clear();
 }
 
 std::vector<geometry_msgs::msg::PoseStamped>
@@ -230,32 +255,88 @@ SemanticWorld::generatePlacePoses(const std::string& table_name, const shapes::S
                                   const geometry_msgs::msg::Quaternion& object_orientation, double resolution,
                                   double delta_height, unsigned int num_heights) const
 {
-  object_recognition_msgs::msg::Table chosen_table;
   std::map<std::string, object_recognition_msgs::msg::Table>::const_iterator it =
       current_tables_in_collision_world_.find(table_name);
 
+  std::vector<geometry_msgs::msg::PoseStamped> place_poses;
   if (it != current_tables_in_collision_world_.end())
   {
-    chosen_table = it->second;
-    return generatePlacePoses(chosen_table, object_shape, object_orientation, resolution, delta_height, num_heights);
+    double min_distance_from_edge = 0;
+    double height_above_table = 0;
+    if (!computePlacementOffsets(object_shape, object_orientation, min_distance_from_edge, height_above_table))
+      return place_poses;
+    return generateContourPlacePoses(it->second, *table_contours_.at(table_name), resolution, height_above_table,
+                                     delta_height, num_heights, min_distance_from_edge);
   }
 
-  std::vector<geometry_msgs::msg::PoseStamped> place_poses;
   RCLCPP_ERROR(logger_, "Did not find table %s to place on", table_name.c_str());
   return place_poses;
 }
 
+std::vector<std::vector<geometry_msgs::msg::PoseStamped>>
+SemanticWorld::generatePlacePosesBatch(const std::vector<std::string>& table_names,
+                                       const shapes::ShapeConstPtr& object_shape,
+                                       const geometry_msgs::msg::Quaternion& object_orientation, double resolution,
+                                       double delta_height, unsigned int num_heights, std::size_t thread_count) const
+{
+  std::vector<std::vector<geometry_msgs::msg::PoseStamped>> place_poses(table_names.size());
+  double min_distance_from_edge = 0;
+  double height_above_table = 0;
+  if (!computePlacementOffsets(object_shape, object_orientation, min_distance_from_edge, height_above_table))
+    return place_poses;
+
+  // the tables are handed out one at a time, as their sizes and hence the number of sampled poses vary
+  std::atomic<std::size_t> next{ 0 };
+  auto generate = [&] {
+    for (std::size_t i = next++; i < table_names.size(); i = next++)
+    {
+      std::map<std::string, object_recognition_msgs::msg::Table>::const_iterator it =
+          current_tables_in_collision_world_.find(table_names[i]);
+      if (it == current_tables_in_collision_world_.end())
+      {
+        RCLCPP_ERROR(logger_, "Did not find table %s to place on", table_names[i].c_str());
+        continue;
+      }
+      place_poses[i] = generateContourPlacePoses(it->second, *table_contours_.at(it->first), resolution,
+                                                 height_above_table, delta_height, num_heights, min_distance_from_edge);
+    }
+  };
+
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  thread_count = std::min(thread_count, table_names.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(generate);
+  generate();
+  for (std::thread& thread : threads)
+    thread.join();
+  return place_poses;
+}
+
 std::vector<geometry_msgs::msg::PoseStamped>
 SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& chosen_table,
                                   const shapes::ShapeConstPtr& object_shape,
                                   const geometry_msgs::msg::Quaternion& object_orientation, double resolution,
                                   double delta_height, unsigned int num_heights) const
 {
-  std::vector<geometry_msgs::msg::PoseStamped> place_poses;
+  double min_distance_from_edge = 0;
+  double height_above_table = 0;
+  if (!computePlacementOffsets(object_shape, object_orientation, min_distance_from_edge, height_above_table))
+    return std::vector<geometry_msgs::msg::PoseStamped>();
+
+  return generatePlacePoses(chosen_table, resolution, height_above_table, delta_height, num_heights,
+                            min_distance_from_edge);
+}
+
+bool SemanticWorld::computePlacementOffsets(const shapes::ShapeConstPtr& object_shape,
+                                            const geometry_msgs::msg::Quaternion& object_orientation,
+                                            double& min_distance_from_edge, double& height_above_table) const
+{
   if (object_shape->type != shapes::MESH && object_shape->type != shapes::SPHERE && object_shape->type != shapes::BOX &&
       object_shape->type != shapes::CYLINDER && object_shape->type != shapes::CONE)
   {
-    return place_poses;
+    return false;
   }
 
   double x_min(std::numeric_limits<double>::max()), x_max(-std::numeric_limits<double>::max());
@@ -264,8 +345,8 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& cho
 
   Eigen::Quaterniond rotation(object_orientation.x, object_orientation.y, object_orientation.z, object_orientation.w);
   Eigen::Isometry3d object_pose(rotation);
-  double min_distance_from_edge = 0;
-  double height_above_table = 0;
+  min_distance_from_edge = 0;
+  height_above_table = 0;
 
   if (object_shape->type == shapes::MESH)
   {
@@ -316,9 +397,7 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& cho
     min_distance_from_edge = cone->radius;
     height_above_table = cone->length / 2.0;
   }
-
-  return generatePlacePoses(chosen_table, resolution, height_above_table, delta_height, num_heights,
-                            min_distance_from_edge);
+  return true;
 }
 
 std::vector<geometry_msgs::msg::PoseStamped>
@@ -326,12 +405,19 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& tab
                                   double height_above_table, double delta_height, unsigned int num_heights,
                                   double min_distance_from_edge) const
 {
-  std::vector<geometry_msgs::msg::PoseStamped> place_poses;
+  return generateContourPlacePoses(table, *computeTableContour(table), resolution, height_above_table, delta_height,
+                                   num_heights, min_distance_from_edge);
+}
+
+SemanticWorld::TableContourConstPtr
+SemanticWorld::computeTableContour(const object_recognition_msgs::msg::Table& table)
+{
+  auto table_contour = std::make_shared<TableContour>();
+  tf2::fromMsg(table.pose, table_contour->pose);
   // Assumption that the table's normal is along the Z axis
   if (table.convex_hull.empty())
-    return place_poses;
-  const int scale_factor = 100;
-  std::vector<cv::Point2f> table_contour;
+    return table_contour;
+
   float x_min = table.convex_hull[0].x, x_max = x_min, y_min = table.convex_hull[0].y, y_max = y_min;
   for (std::size_t j = 1; j < table.convex_hull.size(); ++j)
   {
@@ -352,8 +438,9 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& tab
       y_max = table.convex_hull[j].y;
     }
   }
+  std::vector<cv::Point2f> table_contour_points;
   for (const geometry_msgs::msg::Point& vertex : table.convex_hull)
-    table_contour.push_back(cv::Point((vertex.x - x_min) * scale_factor, (vertex.y - y_min) * scale_factor));
+    table_contour_points.push_back(cv::Point((vertex.x - x_min) * SCALE_FACTOR, (vertex.y - y_min) * SCALE_FACTOR));
 
   double x_range = fabs(x_max - x_min);
   double y_range = fabs(y_max - y_min);
@@ -362,48 +449,66 @@ SemanticWorld::generatePlacePoses(const object_recognition_msgs::msg::Table& tab
     max_range = static_cast<int>(y_range) + 1;
 
   int image_scale = std::max<int>(max_range, 4);
-  cv::Mat src = cv::Mat::zeros(image_scale * scale_factor, image_scale * scale_factor, CV_8UC1);
+  cv::Mat src = cv::Mat::zeros(image_scale * SCALE_FACTOR, image_scale * SCALE_FACTOR, CV_8UC1);
 
   for (std::size_t j = 0; j < table.convex_hull.size(); ++j)
   {
-    cv::line(src, table_contour[j], table_contour[(j + 1) % table.convex_hull.size()], cv::Scalar(255), 3, 8);
+    cv::line(src, table_contour_points[j], table_contour_points[(j + 1) % table.convex_hull.size()], cv::Scalar(255),
+             3, 8);
   }
 
-  unsigned int num_x = fabs(x_max - x_min) / resolution + 1;
-  unsigned int num_y = fabs(y_max - y_min) / resolution + 1;
-
-  RCLCPP_DEBUG(logger_, "Num points for possible place operations: %d %d", num_x, num_y);
-
   std::vector<std::vector<cv::Point> > contours;
   std::vector<cv::Vec4i> hierarchy;
   cv::findContours(src, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
 
+  table_contour->x_min = x_min;
+  table_contour->x_max = x_max;
+  table_contour->y_min = y_min;
+  table_contour->y_max = y_max;
+  if (!contours.empty())
+    table_contour->contour = contours[0];
+  return table_contour;
+}
+
+std::vector<geometry_msgs::msg::PoseStamped>
+SemanticWorld::generateContourPlacePoses(const object_recognition_msgs::msg::Table& table, const TableContour& contour,
+                                         double resolution, double height_above_table, double delta_height,
+                                         unsigned int num_heights, double min_distance_from_edge) const
+{
+  std::vector<geometry_msgs::msg::PoseStamped> place_poses;
+  if (contour.contour.empty())
+    return place_poses;
+
+  unsigned int num_x = fabs(contour.x_max - contour.x_min) / resolution + 1;
+  unsigned int num_y = fabs(contour.y_max - contour.y_min) / resolution + 1;
+
+  RCLCPP_DEBUG(logger_, "Num points for possible place operations: %d %d", num_x, num_y);
+
   for (std::size_t j = 0; j < num_x; ++j)
   {
-    int point_x = j * resolution * scale_factor;
+    int point_x = j * resolution * SCALE_FACTOR;
     for (std::size_t k = 0; k < num_y; ++k)
     {
+      // the distance to the edge is the same at all heights
+      int point_y = k * resolution * SCALE_FACTOR;
+      cv::Point2f point2f(point_x, point_y);
+      double result = cv::pointPolygonTest(contour.contour, point2f, true);
+      if (static_cast<int>(result) < static_cast<int>(min_distance_from_edge * SCALE_FACTOR))
+        continue;
+
       for (std::size_t mm = 0; mm < num_heights; ++mm)
       {
-        int point_y = k * resolution * scale_factor;
-        cv::Point2f point2f(point_x, point_y);
-        double result = cv::pointPolygonTest(contours[0], point2f, true);
-        if (static_cast<int>(result) >= static_cast<int>(min_distance_from_edge * scale_factor))
-        {
-          Eigen::Vector3d point(static_cast<double>(point_x) / scale_factor + x_min,
-                                static_cast<double>(point_y) / scale_factor + y_min,
-                                height_above_table + mm * delta_height);
-          Eigen::Isometry3d pose;
-          tf2::fromMsg(table.pose, pose);
-          point = pose * point;
-          geometry_msgs::msg::PoseStamped place_pose;
-          place_pose.pose.orientation.w = 1.0;
-          place_pose.pose.position.x = point.x();
-          place_pose.pose.position.y = point.y();
-          place_pose.pose.position.z = point.z();
-          place_pose.header = table.header;
-          place_poses.push_back(place_pose);
-        }
+        Eigen::Vector3d point(static_cast<double>(point_x) / SCALE_FACTOR + contour.x_min,
+                              static_cast<double>(point_y) / SCALE_FACTOR + contour.y_min,
+                              height_above_table + mm * delta_height);
+        point = contour.pose * point;
+        geometry_msgs::msg::PoseStamped place_pose;
+        place_pose.pose.orientation.w = 1.0;
+        place_pose.pose.position.x = point.x();
+        place_pose.pose.position.y = point.y();
+        place_pose.pose.position.z = point.z();
+        place_pose.header = table.header;
+        place_poses.push_back(place_pose);
       }
     }
   }
@@ -414,58 +519,18 @@ bool SemanticWorld::isInsideTableContour(const geometry_msgs::msg::Pose& pose,
                                          const object_recognition_msgs::msg::Table& table,
                                          double min_distance_from_edge, double min_vertical_offset) const
 {
-  // Assumption that the table's normal is along the Z axis
-  if (table.convex_hull.empty())
-    return false;
-  float x_min = table.convex_hull[0].x, x_max = x_min, y_min = table.convex_hull[0].y, y_max = y_min;
-  for (std::size_t j = 1; j < table.convex_hull.size(); ++j)
-  {
-    if (table.convex_hull[j].x < x_min)
-    {
-      x_min = table.convex_hull[j].x;
-    }
-    else if (table.convex_hull[j].x > x_max)
-    {
-      x_max = table.convex_hull[j].x;
-    }
-    if (table.convex_hull[j].y < y_min)
-    {
-      y_min = table.convex_hull[j].y;
-    }
-    else if (table.convex_hull[j].y > y_max)
-    {
-      y_max = table.convex_hull[j].y;
-    }
-  }
-  const int scale_factor = 100;
-  std::vector<cv::Point2f> table_contour;
-  for (const geometry_msgs::msg::Point& vertex : table.convex_hull)
-    table_contour.push_back(cv::Point((vertex.x - x_min) * scale_factor, (vertex.y - y_min) * scale_factor));
-
-  double x_range = fabs(x_max - x_min);
-  double y_range = fabs(y_max - y_min);
-  int max_range = static_cast<int>(x_range) + 1;
-  if (max_range < static_cast<int>(y_range) + 1)
-    max_range = static_cast<int>(y_range) + 1;
-
-  int image_scale = std::max<int>(max_range, 4);
-  cv::Mat src = cv::Mat::zeros(image_scale * scale_factor, image_scale * scale_factor, CV_8UC1);
-
-  for (std::size_t j = 0; j < table.convex_hull.size(); ++j)
-  {
-    cv::line(src, table_contour[j], table_contour[(j + 1) % table.convex_hull.size()], cv::Scalar(255), 3, 8);
-  }
-
-  std::vector<std::vector<cv::Point> > contours;
-  std::vector<cv::Vec4i> hierarchy;
-  cv::findContours(src, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+  return isInsideTableContour(pose, *computeTableContour(table), min_distance_from_edge, min_vertical_offset);
+}
 
-  Eigen::Vector3d point(pose.position.x, pose.position.y, pose.position.z);
-  Eigen::Isometry3d pose_table;
-  tf2::fromMsg(table.pose, pose_table);
+bool SemanticWorld::isInsideTableContour(const geometry_msgs::msg::Pose& pose, const TableContour& contour,
+                                         double min_distance_from_edge, double min_vertical_offset) const
+{
+  if (contour.contour.empty())
+    return false;
 
   // Point in table frame
-  point = pose_table.inverse() * point;
+  Eigen::Vector3d point(pose.position.x, pose.position.y, pose.position.z);
+  point = contour.pose.inverse() * point;
   // Assuming Z axis points upwards for the table
   if (point.z() < -fabs(min_vertical_offset))
   {
@@ -473,24 +538,75 @@ bool SemanticWorld::isInsideTableContour(const geometry_msgs::msg::Pose& pose,
     return false;
   }
 
-  int point_x = (point.x() - x_min) * scale_factor;
-  int point_y = (point.y() - y_min) * scale_factor;
+  int point_x = (point.x() - contour.x_min) * SCALE_FACTOR;
+  int point_y = (point.y() - contour.y_min) * SCALE_FACTOR;
   cv::Point2f point2f(point_x, point_y);
-  double result = cv::pointPolygonTest(contours[0], point2f, true);
+  double result = cv::pointPolygonTest(contour.contour, point2f, true);
   RCLCPP_DEBUG(logger_, "table distance: %f", result);
 
-  return static_cast<int>(result) >= static_cast<int>(min_distance_from_edge * scale_factor);
+  return static_cast<int>(result) >= static_cast<int>(min_distance_from_edge * SCALE_FACTOR);
+}
+
+void SemanticWorld::buildTableIndex()
+{
+  table_index_.clear();
+
+  // bounds of the table contours in the XY plane of the planning frame
+  std::map<std::string, Eigen::AlignedBox2d> footprints;
+  double extent_sum = 0.0;
+  for (const std::pair<const std::string, TableContourConstPtr>& table_contour : table_contours_)
+  {
+    const TableContour& contour = *table_contour.second;
+    if (contour.contour.empty())
+      continue;
+    Eigen::AlignedBox2d& footprint = footprints[table_contour.first];
+    for (double x : { contour.x_min, contour.x_max })
+    {
+      for (double y : { contour.y_min, contour.y_max })
+        footprint.extend((contour.pose * Eigen::Vector3d(x, y, 0.0)).head<2>());
+    }
+    extent_sum += footprint.sizes().maxCoeff();
+  }
+  if (footprints.empty())
+    return;
+
+  // cells of about the size of a table, such that most tables overlap few cells and most cells few tables
+  table_index_cell_size_ = std::max(0.1, extent_sum / footprints.size());
+  for (const std::pair<const std::string, Eigen::AlignedBox2d>& footprint : footprints)
+  {
+    const Eigen::Vector2d min = (footprint.second.min() / table_index_cell_size_).array().floor();
+    const Eigen::Vector2d max = (footprint.second.max() / table_index_cell_size_).array().floor();
+    for (long i = min.x(); i <= max.x(); ++i)
+    {
+      for (long j = min.y(); j <= max.y(); ++j)
+        table_index_[{ i, j }].push_back(footprint.first);
+    }
+  }
 }
 
 std::string SemanticWorld::findObjectTable(const geometry_msgs::msg::Pose& pose, double min_distance_from_edge,
                                            double min_vertical_offset) const
 {
-  std::map<std::string, object_recognition_msgs::msg::Table>::const_iterator it;
-  for (it = current_tables_in_collision_world_.begin(); it != current_tables_in_collision_world_.end(); ++it)
+  // Only test the tables whose footprint is near the pose, with some slack for the rasterized contours
+  const double margin = std::max(0.0, -min_distance_from_edge) + 0.05;
+  std::set<std::string> candidates;
+  for (long i = std::floor((pose.position.x - margin) / table_index_cell_size_);
+       i <= std::floor((pose.position.x + margin) / table_index_cell_size_); ++i)
+  {
+    for (long j = std::floor((pose.position.y - margin) / table_index_cell_size_);
+         j <= std::floor((pose.position.y + margin) / table_index_cell_size_); ++j)
+    {
+      std::map<std::pair<long, long>, std::vector<std::string>>::const_iterator cell = table_index_.find({ i, j });
+      if (cell != table_index_.end())
+        candidates.insert(cell->second.begin(), cell->second.end());
+    }
+  }
+
+  for (const std::string& table_name : candidates)
   {
-    RCLCPP_DEBUG_STREAM(logger_, "Testing table: " << it->first);
-    if (isInsideTableContour(pose, it->second, min_distance_from_edge, min_vertical_offset))
-      return it->first;
+    RCLCPP_DEBUG_STREAM(logger_, "Testing table: " << table_name);
+    if (isInsideTableContour(pose, *table_contours_.at(table_name), min_distance_from_edge, min_vertical_offset))
+      return table_name;
   }
   return std::string();
 }
@@ -41,6 +41,7 @@
 #include <moveit/planning_pipeline/planning_pipeline.hpp>
 #include <moveit/planning_scene_monitor/planning_scene_monitor.hpp>
 #include <moveit/robot_state/conversions.hpp>
+#include <chrono>
 #include <thread>
 #include <moveit/utils/logger.hpp>
 
@@ -127,12 +128,15 @@ planning_interface::MotionPlanResponse PlanningComponent::plan(const PlanRequest
     return plan_solution;
   }
 
+  std::optional<double> lock_wait_time;
   if (!planning_scene)
   {  // Clone current planning scene
     auto planning_scene_monitor = moveit_cpp_->getPlanningSceneMonitorNonConst();
     planning_scene_monitor->updateFrameTransforms();
-    planning_scene = [planning_scene_monitor] {
+    planning_scene = [planning_scene_monitor, &lock_wait_time] {
+      const auto lock_start = std::chrono::steady_clock::now();
       planning_scene_monitor::LockedPlanningSceneRO ls(planning_scene_monitor);
+      lock_wait_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - lock_start).count();
       return planning_scene::PlanningScene::clone(ls);
     }();
     planning_scene_monitor.reset();  // release this pointer}
@@ -144,8 +148,10 @@ planning_interface::MotionPlanResponse PlanningComponent::plan(const PlanRequest
   planning_scene->setCurrentState(request.start_state);
 
   // Run planning attempt
-  return moveit::planning_pipeline_interfaces::planWithSinglePipeline(request, planning_scene,
-                                                                      moveit_cpp_->getPlanningPipelines());
+  plan_solution = moveit::planning_pipeline_interfaces::planWithSinglePipeline(request, planning_scene,
+                                                                               moveit_cpp_->getPlanningPipelines());
+  plan_solution.statistics.lock_wait_time = lock_wait_time;
+  return plan_solution;
 }
 
 planning_interface::MotionPlanResponse PlanningComponent::plan(
@@ -172,13 +178,16 @@ planning_interface::MotionPlanResponse PlanningComponent::plan(
     return plan_solution;
   }
 
+  std::optional<double> lock_wait_time;
   if (!planning_scene)
   {  // Clone current planning scene
     planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor =
         moveit_cpp_->getPlanningSceneMonitorNonConst();
     planning_scene_monitor->updateFrameTransforms();
-    planning_scene = [planning_scene_monitor] {
+    planning_scene = [planning_scene_monitor, &lock_wait_time] {
+      const auto lock_start = std::chrono::steady_clock::now();
       planning_scene_monitor::LockedPlanningSceneRO ls(planning_scene_monitor);
+      lock_wait_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - lock_start).count();
       return planning_scene::PlanningScene::clone(ls);
     }();
     planning_scene_monitor.reset();  // release this pointer}
@@ -207,6 +216,7 @@ planning_interface::MotionPlanResponse PlanningComponent::plan(
     RCLCPP_ERROR(logger_, "MotionPlanResponse vector was empty after parallel planning");
     plan_solution.error_code = moveit::core::MoveItErrorCode::INVALID_GOAL_CONSTRAINTS;
   }
+  plan_solution.statistics.lock_wait_time = lock_wait_time;
   // Run planning attempt
   return plan_solution;
 }
@@ -45,6 +45,11 @@
 #include <rclcpp/logger.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 
 /** \brief This namespace includes functionality specific to the execution and monitoring of motion plans */
 namespace plan_execution
@@ -146,7 +151,16 @@ public:
 
 private:
   void planAndExecuteHelper(ExecutableMotionPlan& plan, const Options& opt);
-  bool isRemainingPathValid(const ExecutableMotionPlan& plan, const std::pair<int, int>& path_segment);
+  /** \brief Check the remaining waypoints of the trajectory component path_segment.first, starting at waypoint
+      path_segment.second, in batches. If \e interrupted returns true between two batches, the check stops and the path
+      is considered valid. */
+  bool isRemainingPathValid(const ExecutableMotionPlan& plan, const std::pair<int, int>& path_segment,
+                            const std::function<bool()>& interrupted = nullptr);
+
+  // Validate the remaining path after scene updates on a dedicated thread while plan is executed
+  void startPathValidation(const ExecutableMotionPlan& plan);
+  void stopPathValidation();
+  void pathValidationLoop(const ExecutableMotionPlan& plan, std::chrono::duration<double> debounce);
 
   void planningSceneUpdatedCallback(const planning_scene_monitor::PlanningSceneMonitor::SceneUpdateType update_type);
   void doneWithTrajectoryExecution(const moveit_controller_manager::ExecutionStatus& status);
@@ -178,10 +192,16 @@ private:
     }
   } preempt_;
 
-  bool new_scene_update_;
+  std::atomic<bool> new_scene_update_;
+
+  std::atomic<bool> execution_complete_;
+  std::atomic<bool> path_became_invalid_;
 
-  bool execution_complete_;
-  bool path_became_invalid_;
+  // Path validation thread, woken up by scene updates
+  std::thread path_validation_thread_;
+  std::mutex path_validation_mutex_;
+  std::condition_variable path_validation_condition_;
+  std::atomic<bool> stop_path_validation_{ false };
 
   rclcpp::Logger logger_;
 
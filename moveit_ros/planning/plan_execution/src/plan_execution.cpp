@@ -49,11 +49,20 @@
 #include <rclcpp/utilities.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <memory>
+
 // #include <dynamic_reconfigure/server.h>
 // #include <moveit_ros_planning/PlanExecutionDynamicReconfigureConfig.hpp>
 
 namespace plan_execution
 {
+namespace
+{
+// Waypoints checked for collisions at once, whether the check was interrupted is tested between batches
+constexpr std::size_t PATH_VALIDATION_BATCH_SIZE = 32;
+// Default time to wait for further scene updates before the path is validated
+constexpr double DEFAULT_PATH_VALIDATION_DEBOUNCE = 0.05;  // seconds
+}  // namespace
 
 // class PlanExecution::DynamicReconfigureImpl
 // {
@@ -107,6 +116,7 @@ plan_execution::PlanExecution::PlanExecution(
 
 plan_execution::PlanExecution::~PlanExecution()
 {
+  stopPathValidation();
   // delete reconfigure_impl_;
 }
 
@@ -266,52 +276,70 @@ void plan_execution::PlanExecution::planAndExecuteHelper(ExecutableMotionPlan& p
 }
 
 bool plan_execution::PlanExecution::isRemainingPathValid(const ExecutableMotionPlan& plan,
-                                                         const std::pair<int, int>& path_segment)
+                                                         const std::pair<int, int>& path_segment,
+                                                         const std::function<bool()>& interrupted)
 {
   if (path_segment.first >= 0 &&
       plan.plan_components[path_segment.first].trajectory_monitoring)  // If path_segment.second <= 0, the function
                                                                        // will fallback to check the entire trajectory
   {
-    planning_scene_monitor::LockedPlanningSceneRO lscene(plan.planning_scene_monitor);  // lock the scene so that it
-                                                                                        // does not modify the world
-                                                                                        // representation while
-                                                                                        // isStateValid() is called
+    // The monitored scene is checked through a snapshot, which does not block scene updates while the path is checked
+    planning_scene::PlanningSceneConstPtr scene;
+    if (plan.planning_scene_monitor && plan.planning_scene == plan.planning_scene_monitor->getPlanningScene())
+      scene = plan.planning_scene_monitor->getSceneSnapshot();
+    std::unique_ptr<planning_scene_monitor::LockedPlanningSceneRO> lscene;
+    if (!scene)
+    {
+      // lock the scene so that it does not modify the world representation while the path is checked
+      lscene = std::make_unique<planning_scene_monitor::LockedPlanningSceneRO>(plan.planning_scene_monitor);
+      scene = plan.planning_scene;
+    }
+
     const robot_trajectory::RobotTrajectory& t = *plan.plan_components[path_segment.first].trajectory;
     const collision_detection::AllowedCollisionMatrix* acm =
         plan.plan_components[path_segment.first].allowed_collision_matrix.get();
+    if (!acm)
+      acm = &scene->getAllowedCollisionMatrix();
     std::size_t wpc = t.getWayPointCount();
     collision_detection::CollisionRequest req;
     req.group_name = t.getGroupName();
     req.pad_environment_collisions = false;
-    for (std::size_t i = std::max(path_segment.second - 1, 0); i < wpc; ++i)
+
+    // Waypoints are checked in batches, the upcoming ones first, so that collisions close ahead are found early
+    std::vector<const moveit::core::RobotState*> states;
+    std::vector<collision_detection::CollisionResult> results;
+    states.reserve(PATH_VALIDATION_BATCH_SIZE);
+    for (std::size_t begin = std::max(path_segment.second - 1, 0); begin < wpc; begin += PATH_VALIDATION_BATCH_SIZE)
     {
-      collision_detection::CollisionResult res;
-      if (acm)
-      {
-        plan.planning_scene->checkCollision(req, res, t.getWayPoint(i), *acm);
-      }
-      else
+      if (interrupted && interrupted())
+        return true;
+
+      states.clear();
+      for (std::size_t i = begin; i < std::min(begin + PATH_VALIDATION_BATCH_SIZE, wpc); ++i)
+        states.push_back(&t.getWayPoint(i));
+      const std::size_t first_collision =
+          scene->getCollisionEnvUnpadded()->checkCollisionBatch(req, states, results, *acm, true);
+
+      std::size_t invalid = states.size();
+      for (std::size_t k = 0; k < std::min(first_collision + 1, states.size()); ++k)
       {
-        plan.planning_scene->checkCollision(req, res, t.getWayPoint(i));
+        if (k == first_collision || !scene->isStateFeasible(*states[k], false))
+        {
+          invalid = k;
+          break;
+        }
       }
-
-      if (res.collision || !plan.planning_scene->isStateFeasible(t.getWayPoint(i), false))
+      if (invalid < states.size())
       {
+        const std::size_t i = begin + invalid;
         RCLCPP_INFO(logger_, "Trajectory component '%s' is invalid for waypoint %ld out of %ld",
                     plan.plan_components[path_segment.first].description.c_str(), i, wpc);
 
         // call the same functions again, in verbose mode, to show what issues have been detected
-        plan.planning_scene->isStateFeasible(t.getWayPoint(i), true);
+        scene->isStateFeasible(t.getWayPoint(i), true);
         req.verbose = true;
-        res.clear();
-        if (acm)
-        {
-          plan.planning_scene->checkCollision(req, res, t.getWayPoint(i), *acm);
-        }
-        else
-        {
-          plan.planning_scene->checkCollision(req, res, t.getWayPoint(i));
-        }
+        collision_detection::CollisionResult res;
+        scene->checkCollision(req, res, t.getWayPoint(i), *acm);
         return false;
       }
     }
@@ -319,6 +347,75 @@ bool plan_execution::PlanExecution::isRemainingPathValid(const ExecutableMotionP
   return true;
 }
 
+void plan_execution::PlanExecution::startPathValidation(const ExecutableMotionPlan& plan)
+{
+  stopPathValidation();
+  double debounce = DEFAULT_PATH_VALIDATION_DEBOUNCE;
+  node_->get_parameter_or("plan_execution.path_validation_debounce", debounce, DEFAULT_PATH_VALIDATION_DEBOUNCE);
+  stop_path_validation_ = false;
+  path_validation_thread_ = std::thread([this, &plan, debounce] {
+    pathValidationLoop(plan, std::chrono::duration<double>(std::max(debounce, 0.0)));
+  });
+}
+
+void plan_execution::PlanExecution::stopPathValidation()
+{
+  {
+    std::scoped_lock lock(path_validation_mutex_);
+    stop_path_validation_ = true;
+  }
+  path_validation_condition_.notify_all();
+  if (path_validation_thread_.joinable())
+    path_validation_thread_.join();
+}
+
+void plan_execution::PlanExecution::pathValidationLoop(const ExecutableMotionPlan& plan,
+                                                       std::chrono::duration<double> debounce)
+{
+  // Versions of the monitored scene the remaining path was last validated against
+  bool validated = false;
+  std::uint64_t world_version = 0;
+  std::uint64_t collision_check_version = 0;
+
+  std::unique_lock lock(path_validation_mutex_);
+  while (!stop_path_validation_)
+  {
+    path_validation_condition_.wait(lock, [this] { return stop_path_validation_ || new_scene_update_; });
+    // Bursts of scene updates, e.g. from sensors, are validated once
+    if (path_validation_condition_.wait_for(lock, debounce, [this] { return stop_path_validation_.load(); }))
+      break;
+    new_scene_update_ = false;
+    lock.unlock();
+
+    // Updates that change neither the world nor the allowed collisions, e.g. of transforms, keep the path valid
+    bool changed = true;
+    if (plan.planning_scene_monitor && plan.planning_scene == plan.planning_scene_monitor->getPlanningScene())
+    {
+      planning_scene_monitor::LockedPlanningSceneRO lscene(plan.planning_scene_monitor);
+      changed = !validated || lscene->getWorld()->getVersion() != world_version ||
+                lscene->getCollisionCheckVersion() != collision_check_version;
+      world_version = lscene->getWorld()->getVersion();
+      collision_check_version = lscene->getCollisionCheckVersion();
+    }
+
+    if (changed)
+    {
+      std::pair<int, int> current_index = trajectory_execution_manager_->getCurrentExpectedTrajectoryIndex();
+      // A newer update restarts the validation with the newer scene
+      const auto interrupted = [this] { return stop_path_validation_ || new_scene_update_; };
+      if (!isRemainingPathValid(plan, current_index, interrupted))
+      {
+        RCLCPP_INFO(logger_, "Trajectory component '%s' is invalid after scene update",
+                    plan.plan_components[current_index.first].description.c_str());
+        path_became_invalid_ = true;
+        break;
+      }
+      validated = !new_scene_update_;
+    }
+    lock.lock();
+  }
+}
+
 moveit_msgs::msg::MoveItErrorCodes plan_execution::PlanExecution::executeAndMonitor(ExecutableMotionPlan& plan,
                                                                                     bool reset_preempted)
 {
@@ -431,27 +528,16 @@ moveit_msgs::msg::MoveItErrorCodes plan_execution::PlanExecution::executeAndMoni
   path_became_invalid_ = false;
   bool preempt_requested = false;
 
+  // check the path on environment updates in the meantime
+  startPathValidation(plan);
   while (rclcpp::ok() && !execution_complete_ && !path_became_invalid_)
   {
     r.sleep();
-    // check the path if there was an environment update in the meantime
-    if (new_scene_update_)
-    {
-      new_scene_update_ = false;
-      std::pair<int, int> current_index = trajectory_execution_manager_->getCurrentExpectedTrajectoryIndex();
-      if (!isRemainingPathValid(plan, current_index))
-      {
-        RCLCPP_INFO(logger_, "Trajectory component '%s' is invalid after scene update",
-                    plan.plan_components[current_index.first].description.c_str());
-        path_became_invalid_ = true;
-        break;
-      }
-    }
-
     preempt_requested = preempt_.checkAndClear();
     if (preempt_requested)
       break;
   }
+  stopPathValidation();
 
   // stop execution if needed
   if (preempt_requested)
@@ -518,7 +604,13 @@ void plan_execution::PlanExecution::planningSceneUpdatedCallback(
 {
   if (update_type & (planning_scene_monitor::PlanningSceneMonitor::UPDATE_GEOMETRY |
                      planning_scene_monitor::PlanningSceneMonitor::UPDATE_TRANSFORMS))
-    new_scene_update_ = true;
+  {
+    {
+      std::scoped_lock lock(path_validation_mutex_);
+      new_scene_update_ = true;
+    }
+    path_validation_condition_.notify_all();
+  }
 }
 
 void plan_execution::PlanExecution::doneWithTrajectoryExecution(
@@ -34,6 +34,7 @@
 
 /* Author: Ioan Sucan, Sachin Chitta */
 
+#include <algorithm>
 #include <chrono>
 #include <moveit/planning_scene_monitor/planning_scene_monitor.hpp>
 #include <boost/program_options/parsers.hpp>
@@ -70,6 +71,37 @@ void runCollisionDetection(unsigned int id, unsigned int trials, const planning_
               static_cast<double>(trials) / duration);
 }
 
+void runCollisionProfile(unsigned int trials, unsigned int pair_count, const planning_scene::PlanningScene& scene,
+                         const moveit::core::RobotState& state)
+{
+  collision_detection::CollisionRequest req;
+  req.profile = true;
+  collision_detection::CollisionPairStatisticsMap statistics;
+  for (unsigned int i = 0; i < trials; ++i)
+  {
+    collision_detection::CollisionResult res;
+    scene.checkCollision(req, res, state);
+    for (const auto& [pair, pair_statistics] : res.pair_statistics)
+      statistics[pair] += pair_statistics;
+  }
+
+  std::vector<collision_detection::CollisionPairStatisticsMap::const_iterator> pairs;
+  for (auto it = statistics.cbegin(); it != statistics.cend(); ++it)
+    pairs.push_back(it);
+  std::sort(pairs.begin(), pairs.end(),
+            [](const auto& a, const auto& b) { return a->second.narrowphase_time > b->second.narrowphase_time; });
+  if (pairs.size() > pair_count)
+    pairs.resize(pair_count);
+
+  RCLCPP_INFO(getLogger(), "Most expensive pairs over %u collision checks:", trials);
+  for (const auto& it : pairs)
+  {
+    RCLCPP_INFO(getLogger(), "  '%s' - '%s': %zu candidates, %zu narrowphase checks, %lf s", it->first.first.c_str(),
+                it->first.second.c_str(), it->second.broadphase_candidates, it->second.narrowphase_calls,
+                it->second.narrowphase_time);
+  }
+}
+
 int main(int argc, char** argv)
 {
   rclcpp::init(argc, argv);
@@ -78,13 +110,17 @@ int main(int argc, char** argv)
 
   unsigned int nthreads = 2;
   unsigned int trials = 10000;
+  unsigned int profile = 0;
   boost::program_options::options_description desc;
   desc.add_options()("nthreads", boost::program_options::value<unsigned int>(&nthreads)->default_value(nthreads),
                      "Number of threads to use")(
       "trials", boost::program_options::value<unsigned int>(&trials)->default_value(trials),
       "Number of collision checks to perform with each thread")("wait",
                                                                 "Wait for a user command (so the planning scene can be "
-                                                                "updated in the background)")("help", "this screen");
+                                                                "updated in the background)")(
+      "profile", boost::program_options::value<unsigned int>(&profile)->default_value(profile),
+      "Number of most expensive body pairs to report after profiling the checks (0 disables profiling)")("help",
+                                                                                                    "this screen");
   boost::program_options::variables_map vm;
   boost::program_options::parsed_options po = boost::program_options::parse_command_line(argc, argv, desc);
   boost::program_options::store(po, vm);
@@ -145,6 +181,9 @@ int main(int argc, char** argv)
       threads[i]->join();
       delete threads[i];
     }
+
+    if (profile > 0)
+      runCollisionProfile(trials, profile, *psm.getPlanningScene(), *states[0]);
   }
   else
     RCLCPP_ERROR(node->get_logger(), "Planning scene not configured");
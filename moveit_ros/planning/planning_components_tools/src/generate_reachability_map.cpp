@@ -0,0 +1,151 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Generate the reachability map of a planning group offline */
+
+#include <moveit/planning_scene/planning_scene.hpp>
+#include <moveit/reachability_map/reachability_map.hpp>
+#include <moveit/robot_model_loader/robot_model_loader.hpp>
+#include <boost/program_options.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <moveit/utils/logger.hpp>
+
+namespace po = boost::program_options;
+
+// Sample random configurations of a planning group and record which voxels and orientations its tip reaches, such
+// that planning can reject unreachable goals and seed IK with configurations known to reach a pose.
+int main(int argc, char* argv[])
+{
+  std::string group_name;
+  std::string base;
+  std::string tip;
+  std::string output;
+  double resolution;
+  unsigned int num;
+  bool check_collisions;
+  po::options_description desc("Options");
+  // clang-format off
+  desc.add_options()
+      ("help", "show help message")
+      ("group", po::value<std::string>(&group_name)->required(), "name of planning group")
+      ("base", po::value<std::string>(&base)->default_value("default"),
+       "base frame of the IK solver (by default the parent link of the group, like the kinematics plugin loader)")
+      ("tip", po::value<std::string>(&tip)->default_value("default"),
+       "tip frame of the IK solver (by default the last link of the group)")
+      ("resolution", po::value<double>(&resolution)->default_value(0.05), "edge length of a voxel in meters")
+      ("num", po::value<unsigned int>(&num)->default_value(1000000), "number of random configurations to sample")
+      ("check_collisions", po::value<bool>(&check_collisions)->default_value(true),
+       "whether to skip configurations in self-collision")
+      ("output", po::value<std::string>(&output)->required(), "file to write the map to");
+  // clang-format on
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+
+  if (vm.count("help") != 0u)
+  {
+    std::cout << desc << '\n';
+    return 1;
+  }
+  po::notify(vm);
+
+  if (resolution <= 0.0)
+  {
+    std::cerr << "The resolution needs to be positive\n";
+    return 1;
+  }
+
+  rclcpp::init(argc, argv);
+  rclcpp::Node::SharedPtr node = rclcpp::Node::make_shared("generate_reachability_map");
+  moveit::setNodeLoggerName(node->get_name());
+
+  robot_model_loader::RobotModelLoader robot_model_loader(node, "robot_description", false);
+  const moveit::core::RobotModelPtr& robot_model = robot_model_loader.getModel();
+  if (!robot_model)
+  {
+    RCLCPP_ERROR(node->get_logger(), "Unable to load the robot model");
+    rclcpp::shutdown();
+    return 1;
+  }
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(group_name);
+  if (group == nullptr)
+  {
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  if (base == "default")
+  {
+    const moveit::core::LinkModel* parent = group->getLinkModels().front()->getParentJointModel()->getParentLinkModel();
+    base = parent ? parent->getName() : robot_model->getModelFrame();
+  }
+  if (!base.empty() && base[0] == '/')
+    base = base.substr(1);
+  if (tip == "default")
+    tip = group->getLinkModels().back()->getName();
+
+  planning_scene::PlanningScene planning_scene(robot_model);
+  moveit::core::RobotState& robot_state = planning_scene.getCurrentStateNonConst();
+  robot_state.setToDefaultValues();
+  collision_detection::CollisionRequest collision_request;
+  collision_detection::CollisionResult collision_result;
+  unsigned int num_self_collisions = 0;
+  moveit::core::GroupStateValidityCallbackFn validity_callback;
+  if (check_collisions)
+  {
+    validity_callback = [&](moveit::core::RobotState* state, const moveit::core::JointModelGroup* /*group*/,
+                            const double* /*values*/) {
+      collision_result.clear();
+      planning_scene.checkSelfCollision(collision_request, collision_result, *state);
+      if (!collision_result.collision)
+        return true;
+      ++num_self_collisions;
+      return false;
+    };
+  }
+
+  const reachability_map::ReachabilityMapPtr map =
+      reachability_map::ReachabilityMap::generate(robot_state, group, base, tip, resolution, num, validity_callback);
+  if (!map || !map->save(output))
+  {
+    rclcpp::shutdown();
+    return 1;
+  }
+  RCLCPP_INFO(node->get_logger(),
+              "Wrote %zu voxels reached by %u samples of group %s to %s, %u samples were in self-collision",
+              map->getNumVoxels(), num, group_name.c_str(), output.c_str(), num_self_collisions);
+
+  rclcpp::shutdown();
+  return 0;
+}
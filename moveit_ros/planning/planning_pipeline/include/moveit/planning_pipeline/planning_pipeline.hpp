@@ -48,6 +48,7 @@
 #include <rclcpp/rclcpp.hpp>
 #include <moveit_msgs/msg/pipeline_state.hpp>
 #include <memory>
+#include <mutex>
 #include <moveit_planning_pipeline_export.h>
 #include <planning_pipeline_parameters.hpp>
 
@@ -186,7 +187,8 @@ public:
                                   planning_interface::MotionPlanResponse& res,
                                   const bool publish_received_requests = false) const;
 
-  /** \brief Request termination, if a generatePlan() function is currently computing plans */
+  /** \brief Request termination, if a generatePlan() function is currently computing plans. The running planning
+      context is terminated, and a pipeline that hasn't started its planners yet stops with PREEMPTED before them. */
   void terminate() const;
 
   /** \brief Get the names of the planning plugins used */
@@ -243,16 +245,21 @@ private:
   /**
    * @brief Helper function to publish the planning pipeline state during the planning process
    *
-   * @param req Current request to publish
+   * @param req Current request to publish, only copied if the pipeline state is published
    * @param res Current pipeline result
    * @param pipeline_stage Last pipeline stage that got invoked
    */
-  void publishPipelineState(moveit_msgs::msg::MotionPlanRequest req, const planning_interface::MotionPlanResponse& res,
-                            const std::string& pipeline_stage) const;
+  void publishPipelineState(const moveit_msgs::msg::MotionPlanRequest& req,
+                            const planning_interface::MotionPlanResponse& res, const std::string& pipeline_stage) const;
 
   // Flag that indicates whether or not the planning pipeline is currently solving a planning problem
   mutable std::atomic<bool> active_;
 
+  // Flag that indicates whether terminate() was called since generatePlan() started, and the context being solved
+  mutable std::atomic<bool> terminated_;
+  mutable std::mutex active_context_mutex_;
+  mutable planning_interface::PlanningContextPtr active_context_;
+
   // ROS node and parameters
   std::shared_ptr<rclcpp::Node> node_;
   const std::string parameter_namespace_;
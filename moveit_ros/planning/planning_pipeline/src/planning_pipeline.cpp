@@ -37,6 +37,11 @@
 #include <moveit/planning_pipeline/planning_pipeline.hpp>
 #include <fmt/format.h>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
+#include <moveit/utils/work_counters.hpp>
+
+#include <chrono>
+#include <future>
 
 namespace
 {
@@ -77,6 +82,44 @@ getTrajectoryConstraints(const robot_trajectory::RobotTrajectoryPtr& trajectory)
   }
   return trajectory_constraints;
 }
+
+/**
+ * @brief Counts the work done in the calling thread while in scope and stores the counts in the statistics of a
+ * response on destruction, i.e. on every exit of the planning pipeline
+ */
+class ScopedStatistics
+{
+public:
+  explicit ScopedStatistics(planning_interface::MotionPlanStatistics& statistics)
+    : statistics_(statistics), counters_scope_(&counters_)
+  {
+  }
+  ~ScopedStatistics()
+  {
+    statistics_.collision_checks = counters_.collision_checks.load();
+    statistics_.fk_calls = counters_.fk_calls.load();
+    statistics_.ik_calls = counters_.ik_calls.load();
+    statistics_.states_sampled = counters_.states_sampled.load();
+  }
+  ScopedStatistics(const ScopedStatistics&) = delete;
+  ScopedStatistics& operator=(const ScopedStatistics&) = delete;
+
+  moveit::WorkCounters* counters()
+  {
+    return &counters_;
+  }
+
+private:
+  planning_interface::MotionPlanStatistics& statistics_;
+  moveit::WorkCounters counters_;
+  moveit::ScopedWorkCounters counters_scope_;
+};
+
+/// @brief Seconds elapsed since a time point
+double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
 }  // namespace
 
 namespace planning_pipeline
@@ -84,6 +127,7 @@ namespace planning_pipeline
 PlanningPipeline::PlanningPipeline(const moveit::core::RobotModelConstPtr& model,
                                    const std::shared_ptr<rclcpp::Node>& node, const std::string& parameter_namespace)
   : active_{ false }
+  , terminated_{ false }
   , node_(node)
   , parameter_namespace_(parameter_namespace)
   , robot_model_(model)
@@ -101,6 +145,7 @@ PlanningPipeline::PlanningPipeline(const moveit::core::RobotModelConstPtr& model
                                    const std::vector<std::string>& request_adapter_plugin_names,
                                    const std::vector<std::string>& response_adapter_plugin_names)
   : active_{ false }
+  , terminated_{ false }
   , node_(node)
   , parameter_namespace_(parameter_namespace)
   , robot_model_(model)
@@ -234,14 +279,14 @@ void PlanningPipeline::configure()
   }
 }
 
-void PlanningPipeline::publishPipelineState(moveit_msgs::msg::MotionPlanRequest req,
+void PlanningPipeline::publishPipelineState(const moveit_msgs::msg::MotionPlanRequest& req,
                                             const planning_interface::MotionPlanResponse& res,
                                             const std::string& pipeline_stage) const
 {
   if (progress_publisher_)
   {
     moveit_msgs::msg::PipelineState progress;
-    progress.request = std::move(req);
+    progress.request = req;
     res.getMessage(progress.response);
     progress.pipeline_stage = pipeline_stage;
     progress_publisher_->publish(progress);
@@ -254,9 +299,13 @@ bool PlanningPipeline::generatePlan(const planning_scene::PlanningSceneConstPtr&
                                     const bool publish_received_requests) const
 {
   assert(!planner_map_.empty());
+  MOVEIT_TRACEPOINT_SCOPE_DETAIL("planning_pipeline.generate_plan", getName());
+  res.statistics = planning_interface::MotionPlanStatistics();
+  ScopedStatistics statistics(res.statistics);
 
   // Set planning pipeline active
   active_ = true;
+  terminated_ = false;
 
   // broadcast the request we are about to work on, if needed
   if (publish_received_requests)
@@ -272,23 +321,64 @@ bool PlanningPipeline::generatePlan(const planning_scene::PlanningSceneConstPtr&
   try
   {
     // Call plan request adapter chain
-    for (const auto& req_adapter : planning_request_adapter_vector_)
+    // Consecutive adapters that don't modify the request only depend on the preceding ones, so they run concurrently.
+    // Their results are still reported in the configured order.
+    const auto& req_adapters = planning_request_adapter_vector_;
+    for (std::size_t begin = 0; begin < req_adapters.size();)
     {
-      assert(req_adapter);
-      RCLCPP_INFO(node_->get_logger(), "Calling PlanningRequestAdapter '%s'", req_adapter->getDescription().c_str());
-      const auto status = req_adapter->adapt(planning_scene, mutable_request);
-      res.error_code = status.val;
-      // Publish progress
-      publishPipelineState(mutable_request, res, req_adapter->getDescription());
-      // If adapter does not succeed, break chain and return false
-      if (!res.error_code)
+      std::size_t end = begin + 1;
+      if (!req_adapters[begin]->modifiesRequest())
       {
-        RCLCPP_ERROR(node_->get_logger(),
-                     "PlanningRequestAdapter '%s' failed, because '%s'. Aborting planning pipeline.",
-                     req_adapter->getDescription().c_str(), status.message.c_str());
-        active_ = false;
-        return false;
+        while (end < req_adapters.size() && !req_adapters[end]->modifiesRequest())
+        {
+          ++end;
+        }
+      }
+
+      std::vector<double> stage_times(end - begin);
+      std::vector<std::future<moveit::core::MoveItErrorCode>> concurrent_statuses;
+      for (std::size_t i = begin + 1; i < end; ++i)
+      {
+        concurrent_statuses.push_back(std::async(std::launch::async, [&, i, &req_adapter = req_adapters[i]] {
+          MOVEIT_TRACEPOINT_SCOPE_DETAIL("planning_pipeline.request_adapter", req_adapter->getDescription());
+          const moveit::ScopedWorkCounters work_counters(statistics.counters());
+          const auto start = std::chrono::steady_clock::now();
+          const auto status = req_adapter->adapt(planning_scene, mutable_request);
+          stage_times[i - begin] = secondsSince(start);
+          return status;
+        }));
       }
+
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const auto& req_adapter = req_adapters[i];
+        RCLCPP_INFO(node_->get_logger(), "Calling PlanningRequestAdapter '%s'", req_adapter->getDescription().c_str());
+        const auto status = [&] {
+          if (i != begin)
+          {
+            return concurrent_statuses[i - begin - 1].get();
+          }
+          MOVEIT_TRACEPOINT_SCOPE_DETAIL("planning_pipeline.request_adapter", req_adapter->getDescription());
+          const auto start = std::chrono::steady_clock::now();
+          const auto status = req_adapter->adapt(planning_scene, mutable_request);
+          stage_times[0] = secondsSince(start);
+          return status;
+        }();
+        res.statistics.stage_times.emplace_back(req_adapter->getDescription(), stage_times[i - begin]);
+        res.error_code = status.val;
+        // Publish progress
+        publishPipelineState(mutable_request, res, req_adapter->getDescription());
+        // If adapter does not succeed, break chain and return false
+        if (!res.error_code)
+        {
+          RCLCPP_ERROR(node_->get_logger(),
+                       "PlanningRequestAdapter '%s' failed, because '%s'. Aborting planning pipeline.",
+                       req_adapter->getDescription().c_str(), status.message.c_str());
+          active_ = false;
+          return false;
+        }
+      }
+      begin = end;
     }
 
     // Call planners
@@ -314,9 +404,30 @@ bool PlanningPipeline::generatePlan(const planning_scene::PlanningSceneConstPtr&
         return false;
       }
 
-      // Run planner
+      // Run planner, unless the pipeline was terminated before the planner could be interrupted
+      {
+        std::scoped_lock lock(active_context_mutex_);
+        if (terminated_)
+        {
+          RCLCPP_INFO(node_->get_logger(), "Planning pipeline was terminated before calling Planner '%s'",
+                      planner->getDescription().c_str());
+          res.error_code = moveit::core::MoveItErrorCode::PREEMPTED;
+          active_ = false;
+          return false;
+        }
+        active_context_ = context;
+      }
       RCLCPP_INFO(node_->get_logger(), "Calling Planner '%s'", planner->getDescription().c_str());
-      context->solve(res);
+      {
+        MOVEIT_TRACEPOINT_SCOPE_DETAIL("planning_pipeline.planner", planner->getDescription());
+        const auto start = std::chrono::steady_clock::now();
+        context->solve(res);
+        res.statistics.stage_times.emplace_back(planner->getDescription(), secondsSince(start));
+      }
+      {
+        std::scoped_lock lock(active_context_mutex_);
+        active_context_.reset();
+      }
       publishPipelineState(mutable_request, res, planner->getDescription());
 
       // If planner does not succeed, break chain and return false
@@ -332,12 +443,24 @@ bool PlanningPipeline::generatePlan(const planning_scene::PlanningSceneConstPtr&
     // Call plan response adapter chain
     if (res.error_code)
     {
+      // Let the request adapters connect the solution to the original request, e.g. to the original start state
+      for (auto req_adapter = planning_request_adapter_vector_.rbegin();
+           req_adapter != planning_request_adapter_vector_.rend(); ++req_adapter)
+      {
+        (*req_adapter)->adaptResponse(planning_scene, req, res);
+      }
+
       // Call plan request adapter chain
       for (const auto& res_adapter : planning_response_adapter_vector_)
       {
         assert(res_adapter);
         RCLCPP_INFO(node_->get_logger(), "Calling PlanningResponseAdapter '%s'", res_adapter->getDescription().c_str());
-        res_adapter->adapt(planning_scene, mutable_request, res);
+        {
+          MOVEIT_TRACEPOINT_SCOPE_DETAIL("planning_pipeline.response_adapter", res_adapter->getDescription());
+          const auto start = std::chrono::steady_clock::now();
+          res_adapter->adapt(planning_scene, mutable_request, res);
+          res.statistics.stage_times.emplace_back(res_adapter->getDescription(), secondsSince(start));
+        }
         publishPipelineState(mutable_request, res, res_adapter->getDescription());
         // If adapter does not succeed, break chain and return false
         if (!res.error_code)
@@ -353,6 +476,10 @@ bool PlanningPipeline::generatePlan(const planning_scene::PlanningSceneConstPtr&
   catch (std::exception& ex)
   {
     RCLCPP_ERROR(logger_, "Exception caught: '%s'", ex.what());
+    {
+      std::scoped_lock lock(active_context_mutex_);
+      active_context_.reset();
+    }
     // Set planning pipeline to inactive
     active_ = false;
     return false;
@@ -375,12 +502,13 @@ bool PlanningPipeline::generatePlan(const planning_scene::PlanningSceneConstPtr&
 
 void PlanningPipeline::terminate() const
 {
-  for (const auto& planner_pair : planner_map_)
+  // Only the context solving this pipeline's request is terminated, PlannerManager::terminate() would stop the
+  // contexts of all pipelines
+  std::scoped_lock lock(active_context_mutex_);
+  terminated_ = true;
+  if (active_context_)
   {
-    if (planner_pair.second)
-    {
-      planner_pair.second->terminate();
-    }
+    active_context_->terminate();
   }
 }
 }  // namespace planning_pipeline
@@ -59,6 +59,27 @@ public:
   }
 };
 
+/// @brief A dummy request adapter that only validates the request and is always successful
+class AlwaysSuccessValidatingRequestAdapter : public planning_interface::PlanningRequestAdapter
+{
+public:
+  std::string getDescription() const override
+  {
+    return "AlwaysSuccessValidatingRequestAdapter";
+  }
+  moveit::core::MoveItErrorCode adapt(const planning_scene::PlanningSceneConstPtr& /*planning_scene*/,
+                                      planning_interface::MotionPlanRequest& /*req*/) const override
+  {
+    // Mock light computations
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return moveit::core::MoveItErrorCode(moveit_msgs::msg::MoveItErrorCodes::SUCCESS, std::string(""), getDescription());
+  }
+  bool modifiesRequest() const override
+  {
+    return false;
+  }
+};
+
 /// @brief A dummy response adapter that does nothing and is always successful
 class AlwaysSuccessResponseAdapter : public planning_interface::PlanningResponseAdapter
 {
@@ -132,5 +153,7 @@ public:
 CLASS_LOADER_REGISTER_CLASS(planning_pipeline_test::DummyPlannerManager, planning_interface::PlannerManager)
 CLASS_LOADER_REGISTER_CLASS(planning_pipeline_test::AlwaysSuccessRequestAdapter,
                             planning_interface::PlanningRequestAdapter)
+CLASS_LOADER_REGISTER_CLASS(planning_pipeline_test::AlwaysSuccessValidatingRequestAdapter,
+                            planning_interface::PlanningRequestAdapter)
 CLASS_LOADER_REGISTER_CLASS(planning_pipeline_test::AlwaysSuccessResponseAdapter,
                             planning_interface::PlanningResponseAdapter)
@@ -95,6 +95,19 @@ TEST_F(TestPlanningPipeline, HappyPath)
   const auto planning_scene_ptr = std::make_shared<planning_scene::PlanningScene>(robot_model_);
   EXPECT_TRUE(pipeline_ptr_->generatePlan(planning_scene_ptr, motion_plan_request, motion_plan_response));
   EXPECT_TRUE(motion_plan_response.error_code);
+
+  // AND the statistics contain the time of every stage and the work counts
+  const auto& statistics = motion_plan_response.statistics;
+  ASSERT_EQ(statistics.stage_times.size(), REQUEST_ADAPTERS.size() + PLANNER_PLUGINS.size() + RESPONSE_ADAPTERS.size());
+  for (const auto& [stage, time] : statistics.stage_times)
+  {
+    EXPECT_FALSE(stage.empty());
+    EXPECT_GE(time, 0.0);
+  }
+  EXPECT_TRUE(statistics.collision_checks.has_value());
+  EXPECT_TRUE(statistics.fk_calls.has_value());
+  EXPECT_TRUE(statistics.ik_calls.has_value());
+  EXPECT_TRUE(statistics.states_sampled.has_value());
 }
 
 TEST_F(TestPlanningPipeline, NoPlannerPluginConfigured)
@@ -115,6 +128,52 @@ TEST_F(TestPlanningPipeline, NoPlannerPluginConfigured)
                std::runtime_error);
 }
 
+TEST_F(TestPlanningPipeline, ConcurrentValidatingRequestAdapters)
+{
+  // GIVEN a pipeline with a modifying request adapter followed by validating ones, each taking 100ms
+  const std::vector<std::string> request_adapters{ "planning_pipeline_test/AlwaysSuccessRequestAdapter",
+                                                   "planning_pipeline_test/AlwaysSuccessValidatingRequestAdapter",
+                                                   "planning_pipeline_test/AlwaysSuccessValidatingRequestAdapter",
+                                                   "planning_pipeline_test/AlwaysSuccessValidatingRequestAdapter" };
+  pipeline_ptr_ = std::make_shared<planning_pipeline::PlanningPipeline>(
+      robot_model_, node_, "", std::vector<std::string>({ PLANNER_PLUGINS.front() }), request_adapters);
+  planning_interface::MotionPlanResponse motion_plan_response;
+  planning_interface::MotionPlanRequest motion_plan_request;
+  const auto planning_scene_ptr = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+
+  // WHEN generatePlan is called
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(pipeline_ptr_->generatePlan(planning_scene_ptr, motion_plan_request, motion_plan_response));
+  const auto duration = std::chrono::steady_clock::now() - start;
+
+  // THEN the validating adapters run concurrently after the modifying one, followed by the planner taking 1s
+  EXPECT_TRUE(motion_plan_response.error_code);
+  EXPECT_GE(duration, std::chrono::milliseconds(1200));
+  EXPECT_LT(duration, std::chrono::milliseconds(1350));
+}
+
+TEST_F(TestPlanningPipeline, TerminateBeforePlanner)
+{
+  // GIVEN a pipeline whose request adapters take 200ms before the planner is called
+  pipeline_ptr_ = std::make_shared<planning_pipeline::PlanningPipeline>(
+      robot_model_, node_, "", std::vector<std::string>({ PLANNER_PLUGINS.front() }), REQUEST_ADAPTERS);
+  planning_interface::MotionPlanResponse motion_plan_response;
+  planning_interface::MotionPlanRequest motion_plan_request;
+  const auto planning_scene_ptr = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+
+  // WHEN the pipeline is terminated while the request adapters are running
+  std::thread terminate_thread([this] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pipeline_ptr_->terminate();
+  });
+  EXPECT_FALSE(pipeline_ptr_->generatePlan(planning_scene_ptr, motion_plan_request, motion_plan_response));
+  terminate_thread.join();
+
+  // THEN the planner is not called and the pipeline reports that it was preempted
+  EXPECT_EQ(motion_plan_response.error_code.val, moveit::core::MoveItErrorCode::PREEMPTED);
+  EXPECT_FALSE(pipeline_ptr_->isActive());
+}
+
 int main(int argc, char** argv)
 {
   rclcpp::init(argc, argv);
@@ -0,0 +1,156 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Selection of the planning pipelines to run for a request, based on their recorded performance */
+
+#pragma once
+
+#include <moveit/planning_pipeline_interfaces/planning_pipeline_interfaces.hpp>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace moveit
+{
+namespace planning_pipeline_interfaces
+{
+/** \brief Features of a planning problem that the performance of planners is recorded for */
+struct PlanningProblemFeatures
+{
+  /** \brief Bits of constraint_types */
+  enum ConstraintType : unsigned int
+  {
+    JOINT_GOAL = 1,
+    POSITION_GOAL = 2,
+    ORIENTATION_GOAL = 4,
+    VISIBILITY_GOAL = 8,
+    PATH_CONSTRAINTS = 16
+  };
+
+  std::string group_name;
+  /** \brief The types of constraints used by the request, a combination of ConstraintType bits */
+  unsigned int constraint_types = 0;
+  /** \brief The number of world objects rounded down to a power of two, as 1 + its binary logarithm, 0 if empty */
+  unsigned int scene_density = 0;
+
+  bool operator<(const PlanningProblemFeatures& other) const
+  {
+    return std::tie(group_name, constraint_types, scene_density) <
+           std::tie(other.group_name, other.constraint_types, other.scene_density);
+  }
+};
+
+/** \brief Compute the features of a planning problem */
+PlanningProblemFeatures getPlanningProblemFeatures(const ::planning_interface::MotionPlanRequest& motion_plan_request,
+                                                   const ::planning_scene::PlanningScene& planning_scene);
+
+/** \brief A portfolio of planning pipelines and planner configurations that learns which of them to run.
+
+    For every combination of problem features, pipeline and planner id, the portfolio records how often planning
+    succeeded and how long successful planning took. Candidate requests are ranked by their expected time to a
+    solution, i.e. the mean planning time of their successes divided by their success rate. Candidates that haven't
+    been tried often enough for the features of a problem are preferred, so that the portfolio keeps learning.
+    Results can also be added directly, e.g. from benchmark runs, and the history can be stored in a file.
+
+    The class is thread-safe. */
+class PlannerPortfolio
+{
+public:
+  /** \param min_attempts The number of results a candidate needs to be ranked by its performance */
+  PlannerPortfolio(std::size_t min_attempts = 3);
+
+  /** \brief Record a planning result of a pipeline and planner for a problem */
+  void addResult(const PlanningProblemFeatures& features, const std::string& pipeline_id, const std::string& planner_id,
+                 bool success, double planning_time);
+
+  /** \brief Record planning responses. Responses are assigned to the request with the same planner id, responses
+      whose planner id isn't unique among the requests are ignored, as are preempted ones. */
+  void addResponses(const std::vector<::planning_interface::MotionPlanRequest>& motion_plan_requests,
+                    const std::vector<::planning_interface::MotionPlanResponse>& motion_plan_responses,
+                    const ::planning_scene::PlanningScene& planning_scene);
+
+  /** \brief Select the most promising candidate requests for a planning problem
+      \param [in] candidates Requests for the same problem, with different pipelines or planner ids
+      \param [in] planning_scene Scene that the problem is solved in
+      \param [in] max_requests The maximum number of requests to select
+      \return The selected requests, the most promising first */
+  std::vector<::planning_interface::MotionPlanRequest>
+  selectRequests(const std::vector<::planning_interface::MotionPlanRequest>& candidates,
+                 const ::planning_scene::PlanningScene& planning_scene, std::size_t max_requests) const;
+
+  /** \brief Get the expected time to a solution of a candidate, infinite if it never succeeded */
+  double getExpectedPlanningTime(const PlanningProblemFeatures& features, const std::string& pipeline_id,
+                                 const std::string& planner_id) const;
+
+  /** \brief Get the number of results recorded for a candidate */
+  std::size_t getAttempts(const PlanningProblemFeatures& features, const std::string& pipeline_id,
+                          const std::string& planner_id) const;
+
+  /** \brief Write the recorded results to a file, returns false on failure */
+  bool save(const std::string& file_name) const;
+
+  /** \brief Add the results stored in a file to the recorded ones, returns false on failure */
+  bool load(const std::string& file_name);
+
+private:
+  struct Statistics
+  {
+    std::size_t attempts = 0;
+    std::size_t successes = 0;
+    double success_time = 0.0;
+  };
+  using CandidateKey = std::tuple<PlanningProblemFeatures, std::string, std::string>;
+
+  double getExpectedPlanningTime(const Statistics& statistics) const;
+
+  const std::size_t min_attempts_;
+  std::map<CandidateKey, Statistics> statistics_;
+  mutable std::mutex statistics_mutex_;
+};
+
+/** \brief Plan with the planning pipelines that the portfolio selects, and record their results in the portfolio
+ * \param [in,out] portfolio Portfolio selecting the requests
+ * \param [in] max_requests The maximum number of pipelines to run in parallel
+ * The other parameters are passed to planWithParallelPipelines().
+ */
+const std::vector<::planning_interface::MotionPlanResponse> planWithPortfolio(
+    PlannerPortfolio& portfolio, const std::vector<::planning_interface::MotionPlanRequest>& motion_plan_requests,
+    const ::planning_scene::PlanningSceneConstPtr& planning_scene,
+    const std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>& planning_pipelines,
+    std::size_t max_requests, const StoppingCriterionFunction& stopping_criterion_callback = nullptr,
+    const SolutionSelectionFunction& solution_selection_function = nullptr);
+}  // namespace planning_pipeline_interfaces
+}  // namespace moveit
@@ -86,6 +86,8 @@ typedef std::function<::planning_interface::MotionPlanResponse(
  terminate after the max. planning time defined in the MotionPlanningRequest is reached.
  * \param [in] solution_selection_function Function to select a specific solution out of all available solution. If no
  function is provided, all solutions are returned.
+ * \param [in] wait_for_all_pipelines If false, the function returns as soon as the stopping criterion is met, with the
+ solutions that met it. The terminated pipelines then finish in the background.
  + \return If a solution_selection_function is provided a vector containing the selected response is returned, otherwise
  the vector contains all solutions produced.
 */
@@ -94,7 +96,7 @@ const std::vector<::planning_interface::MotionPlanResponse> planWithParallelPipe
     const ::planning_scene::PlanningSceneConstPtr& planning_scene,
     const std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>& planning_pipelines,
     const StoppingCriterionFunction& stopping_criterion_callback = nullptr,
-    const SolutionSelectionFunction& solution_selection_function = nullptr);
+    const SolutionSelectionFunction& solution_selection_function = nullptr, bool wait_for_all_pipelines = true);
 
 /** \brief Utility function to create a map of named planning pipelines
  * \param [in] pipeline_names Vector of planning pipeline names to be used. Each name is also the namespace from which
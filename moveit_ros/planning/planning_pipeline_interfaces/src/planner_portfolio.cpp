@@ -0,0 +1,255 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_pipeline_interfaces/planner_portfolio.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace moveit
+{
+namespace planning_pipeline_interfaces
+{
+namespace
+{
+rclcpp::Logger getLogger()
+{
+  return moveit::getLogger("moveit.ros.planner_portfolio");
+}
+
+unsigned int getConstraintTypes(const moveit_msgs::msg::Constraints& constraints)
+{
+  unsigned int types = 0;
+  if (!constraints.joint_constraints.empty())
+    types |= PlanningProblemFeatures::JOINT_GOAL;
+  if (!constraints.position_constraints.empty())
+    types |= PlanningProblemFeatures::POSITION_GOAL;
+  if (!constraints.orientation_constraints.empty())
+    types |= PlanningProblemFeatures::ORIENTATION_GOAL;
+  if (!constraints.visibility_constraints.empty())
+    types |= PlanningProblemFeatures::VISIBILITY_GOAL;
+  return types;
+}
+}  // namespace
+
+PlanningProblemFeatures getPlanningProblemFeatures(const ::planning_interface::MotionPlanRequest& motion_plan_request,
+                                                   const ::planning_scene::PlanningScene& planning_scene)
+{
+  PlanningProblemFeatures features;
+  features.group_name = motion_plan_request.group_name;
+  for (const moveit_msgs::msg::Constraints& goal : motion_plan_request.goal_constraints)
+    features.constraint_types |= getConstraintTypes(goal);
+  if (getConstraintTypes(motion_plan_request.path_constraints) != 0)
+    features.constraint_types |= PlanningProblemFeatures::PATH_CONSTRAINTS;
+  for (std::size_t objects = planning_scene.getWorld()->size(); objects > 0; objects /= 2)
+    ++features.scene_density;
+  return features;
+}
+
+PlannerPortfolio::PlannerPortfolio(std::size_t min_attempts) : min_attempts_(min_attempts)
+{
+}
+
+void PlannerPortfolio::addResult(const PlanningProblemFeatures& features, const std::string& pipeline_id,
+                                 const std::string& planner_id, bool success, double planning_time)
+{
+  std::scoped_lock lock(statistics_mutex_);
+  Statistics& statistics = statistics_[CandidateKey(features, pipeline_id, planner_id)];
+  ++statistics.attempts;
+  if (success)
+  {
+    ++statistics.successes;
+    statistics.success_time += planning_time;
+  }
+}
+
+void PlannerPortfolio::addResponses(const std::vector<::planning_interface::MotionPlanRequest>& motion_plan_requests,
+                                    const std::vector<::planning_interface::MotionPlanResponse>& motion_plan_responses,
+                                    const ::planning_scene::PlanningScene& planning_scene)
+{
+  for (const ::planning_interface::MotionPlanResponse& response : motion_plan_responses)
+  {
+    if (response.error_code.val == moveit::core::MoveItErrorCode::PREEMPTED)
+      continue;
+    const auto is_responding = [&](const ::planning_interface::MotionPlanRequest& request) {
+      return request.planner_id == response.planner_id;
+    };
+    const auto request = std::find_if(motion_plan_requests.begin(), motion_plan_requests.end(), is_responding);
+    if (request == motion_plan_requests.end() ||
+        std::find_if(request + 1, motion_plan_requests.end(), is_responding) != motion_plan_requests.end())
+    {
+      RCLCPP_DEBUG(getLogger(), "Not recording the response of planner '%s', its request is ambiguous",
+                   response.planner_id.c_str());
+      continue;
+    }
+    addResult(getPlanningProblemFeatures(*request, planning_scene), request->pipeline_id, request->planner_id,
+              static_cast<bool>(response), response.planning_time);
+  }
+}
+
+std::vector<::planning_interface::MotionPlanRequest>
+PlannerPortfolio::selectRequests(const std::vector<::planning_interface::MotionPlanRequest>& candidates,
+                                 const ::planning_scene::PlanningScene& planning_scene, std::size_t max_requests) const
+{
+  // Candidates without enough results come first in their given order, the others by their expected planning time
+  std::vector<std::pair<double, std::size_t>> ranking;
+  ranking.reserve(candidates.size());
+  {
+    std::scoped_lock lock(statistics_mutex_);
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      const auto it = statistics_.find(CandidateKey(getPlanningProblemFeatures(candidates[i], planning_scene),
+                                                    candidates[i].pipeline_id, candidates[i].planner_id));
+      const bool explore = it == statistics_.end() || it->second.attempts < min_attempts_;
+      ranking.emplace_back(explore ? -1.0 : getExpectedPlanningTime(it->second), i);
+    }
+  }
+  std::stable_sort(ranking.begin(), ranking.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<::planning_interface::MotionPlanRequest> selected;
+  for (std::size_t i = 0; i < std::min(max_requests, ranking.size()); ++i)
+    selected.push_back(candidates[ranking[i].second]);
+  return selected;
+}
+
+double PlannerPortfolio::getExpectedPlanningTime(const PlanningProblemFeatures& features,
+                                                 const std::string& pipeline_id, const std::string& planner_id) const
+{
+  std::scoped_lock lock(statistics_mutex_);
+  const auto it = statistics_.find(CandidateKey(features, pipeline_id, planner_id));
+  return it == statistics_.end() ? std::numeric_limits<double>::infinity() : getExpectedPlanningTime(it->second);
+}
+
+double PlannerPortfolio::getExpectedPlanningTime(const Statistics& statistics) const
+{
+  if (statistics.successes == 0)
+    return std::numeric_limits<double>::infinity();
+  // the success rate is estimated with Laplace's rule of succession, so that few results aren't overrated
+  const double success_rate = (statistics.successes + 1.0) / (statistics.attempts + 2.0);
+  return statistics.success_time / statistics.successes / success_rate;
+}
+
+std::size_t PlannerPortfolio::getAttempts(const PlanningProblemFeatures& features, const std::string& pipeline_id,
+                                          const std::string& planner_id) const
+{
+  std::scoped_lock lock(statistics_mutex_);
+  const auto it = statistics_.find(CandidateKey(features, pipeline_id, planner_id));
+  return it == statistics_.end() ? 0 : it->second.attempts;
+}
+
+bool PlannerPortfolio::save(const std::string& file_name) const
+{
+  std::ofstream file(file_name);
+  if (!file)
+  {
+    RCLCPP_ERROR(getLogger(), "Unable to open '%s' for writing the planner portfolio", file_name.c_str());
+    return false;
+  }
+
+  // one line per candidate, names are quoted to allow for spaces
+  std::scoped_lock lock(statistics_mutex_);
+  for (const auto& [key, statistics] : statistics_)
+  {
+    const auto& [features, pipeline_id, planner_id] = key;
+    file << std::quoted(features.group_name) << ' ' << features.constraint_types << ' ' << features.scene_density << ' '
+         << std::quoted(pipeline_id) << ' ' << std::quoted(planner_id) << ' ' << statistics.attempts << ' '
+         << statistics.successes << ' ' << statistics.success_time << '\n';
+  }
+  return static_cast<bool>(file);
+}
+
+bool PlannerPortfolio::load(const std::string& file_name)
+{
+  std::ifstream file(file_name);
+  if (!file)
+  {
+    RCLCPP_ERROR(getLogger(), "Unable to open '%s' for reading the planner portfolio", file_name.c_str());
+    return false;
+  }
+
+  std::scoped_lock lock(statistics_mutex_);
+  std::string line;
+  while (std::getline(file, line))
+  {
+    std::istringstream line_stream(line);
+    PlanningProblemFeatures features;
+    std::string pipeline_id, planner_id;
+    Statistics loaded;
+    if (!(line_stream >> std::quoted(features.group_name) >> features.constraint_types >> features.scene_density >>
+          std::quoted(pipeline_id) >> std::quoted(planner_id) >> loaded.attempts >> loaded.successes >>
+          loaded.success_time))
+    {
+      RCLCPP_ERROR(getLogger(), "Invalid planner portfolio entry '%s' in '%s'", line.c_str(), file_name.c_str());
+      return false;
+    }
+    Statistics& statistics = statistics_[CandidateKey(features, pipeline_id, planner_id)];
+    statistics.attempts += loaded.attempts;
+    statistics.successes += loaded.successes;
+    statistics.success_time += loaded.success_time;
+  }
+  return true;
+}
+
+const std::vector<::planning_interface::MotionPlanResponse> planWithPortfolio(
+    PlannerPortfolio& portfolio, const std::vector<::planning_interface::MotionPlanRequest>& motion_plan_requests,
+    const ::planning_scene::PlanningSceneConstPtr& planning_scene,
+    const std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>& planning_pipelines,
+    std::size_t max_requests, const StoppingCriterionFunction& stopping_criterion_callback,
+    const SolutionSelectionFunction& solution_selection_function)
+{
+  const auto selected_requests = portfolio.selectRequests(motion_plan_requests, *planning_scene, max_requests);
+  for (const auto& request : selected_requests)
+  {
+    RCLCPP_DEBUG(getLogger(), "Selected planner '%s' of pipeline '%s'", request.planner_id.c_str(),
+                 request.pipeline_id.c_str());
+  }
+
+  // All responses are needed for recording, so the selection function is applied afterwards
+  const auto responses =
+      planWithParallelPipelines(selected_requests, planning_scene, planning_pipelines, stopping_criterion_callback);
+  portfolio.addResponses(selected_requests, responses, *planning_scene);
+
+  if (solution_selection_function)
+  {
+    return { solution_selection_function(responses) };
+  }
+  return responses;
+}
+}  // namespace planning_pipeline_interfaces
+}  // namespace moveit
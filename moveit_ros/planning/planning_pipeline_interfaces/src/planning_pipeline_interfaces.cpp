@@ -37,6 +37,9 @@
 #include <moveit/planning_pipeline_interfaces/planning_pipeline_interfaces.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 
 namespace moveit
@@ -76,17 +79,177 @@ planWithSinglePipeline(const ::planning_interface::MotionPlanRequest& motion_pla
   return motion_plan_response;
 }
 
+namespace
+{
+/** \brief Threads that are kept alive for planning requests. A new thread is only started if all existing ones are
+ * busy, so that all requests start planning immediately, like with one thread per request. */
+class PlanningThreadPool
+{
+public:
+  ~PlanningThreadPool()
+  {
+    {
+      std::scoped_lock lock(mutex_);
+      stop_ = true;
+    }
+    condition_.notify_all();
+    for (std::thread& thread : threads_)
+    {
+      thread.join();
+    }
+  }
+
+  void run(std::function<void()> job)
+  {
+    {
+      std::scoped_lock lock(mutex_);
+      jobs_.push_back(std::move(job));
+      if (jobs_.size() > idle_threads_)
+      {
+        threads_.emplace_back([this] { work(); });
+      }
+    }
+    condition_.notify_one();
+  }
+
+private:
+  void work()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      ++idle_threads_;
+      condition_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+      --idle_threads_;
+      if (jobs_.empty())
+      {
+        return;
+      }
+      std::function<void()> job = std::move(jobs_.front());
+      jobs_.pop_front();
+      lock.unlock();
+      job();
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> jobs_;
+  std::vector<std::thread> threads_;
+  std::size_t idle_threads_ = 0;
+  bool stop_ = false;
+};
+
+PlanningThreadPool& getPlanningThreadPool()
+{
+  static PlanningThreadPool pool;
+  return pool;
+}
+
+// State shared by the planning jobs of one planWithParallelPipelines() call, which may return before all jobs finished
+struct ParallelPlanningState
+{
+  using PlanningPipelineMap = std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>;
+
+  ParallelPlanningState(const std::vector<::planning_interface::MotionPlanRequest>& motion_plan_requests,
+                        const ::planning_scene::PlanningSceneConstPtr& planning_scene,
+                        const PlanningPipelineMap& planning_pipelines,
+                        const StoppingCriterionFunction& stopping_criterion_callback)
+    : motion_plan_requests(motion_plan_requests)
+    , planning_scene(planning_scene)
+    , planning_pipelines(planning_pipelines)
+    , stopping_criterion_callback(stopping_criterion_callback)
+    , plan_responses_container(motion_plan_requests.size())
+  {
+  }
+
+  const std::vector<::planning_interface::MotionPlanRequest> motion_plan_requests;
+  const ::planning_scene::PlanningSceneConstPtr planning_scene;
+  const PlanningPipelineMap planning_pipelines;
+  const StoppingCriterionFunction stopping_criterion_callback;
+
+  // Guards the responses, so that the stopping criterion sees a consistent container
+  std::mutex mutex;
+  std::condition_variable condition;
+  PlanResponsesContainer plan_responses_container;
+  std::size_t finished_requests = 0;
+  bool stopped = false;
+  std::vector<::planning_interface::MotionPlanResponse> solutions_when_stopped;
+};
+
+void terminatePipelines(const ParallelPlanningState& state)
+{
+  for (const auto& request : state.motion_plan_requests)
+  {
+    const auto it = state.planning_pipelines.find(request.pipeline_id);
+    if (it == state.planning_pipelines.end())
+    {
+      RCLCPP_WARN(getLogger(), "Cannot terminate pipeline '%s' because no pipeline with that name exists",
+                  request.pipeline_id.c_str());
+      continue;
+    }
+    if (it->second->isActive())
+    {
+      it->second->terminate();
+    }
+  }
+}
+
+void planRequest(const std::shared_ptr<ParallelPlanningState>& state, std::size_t request_index)
+{
+  const auto& request = state->motion_plan_requests[request_index];
+  {
+    // Requests that haven't started when the stopping criterion was met are skipped
+    std::scoped_lock lock(state->mutex);
+    if (state->stopped)
+    {
+      ++state->finished_requests;
+      state->condition.notify_all();
+      return;
+    }
+  }
+
+  auto plan_solution = ::planning_interface::MotionPlanResponse();
+  try
+  {
+    // Use planning scene if provided, otherwise the planning scene from planning scene monitor is used
+    plan_solution = planWithSinglePipeline(request, state->planning_scene, state->planning_pipelines);
+  }
+  catch (const std::exception& e)
+  {
+    RCLCPP_ERROR(getLogger(), "Planning pipeline '%s' threw exception '%s'", request.pipeline_id.c_str(), e.what());
+    plan_solution = ::planning_interface::MotionPlanResponse();
+    plan_solution.error_code = moveit::core::MoveItErrorCode::FAILURE;
+  }
+  plan_solution.planner_id = request.planner_id;
+
+  std::scoped_lock lock(state->mutex);
+  state->plan_responses_container.pushBack(plan_solution);
+  ++state->finished_requests;
+  if (!state->stopped && state->stopping_criterion_callback != nullptr &&
+      state->stopping_criterion_callback(state->plan_responses_container, state->motion_plan_requests))
+  {
+    // Terminate planning pipelines
+    RCLCPP_INFO(getLogger(), "Stopping criterion met: Terminating planning pipelines that are still active");
+    state->stopped = true;
+    state->solutions_when_stopped = state->plan_responses_container.getSolutions();
+    terminatePipelines(*state);
+  }
+  state->condition.notify_all();
+}
+}  // namespace
+
 const std::vector<::planning_interface::MotionPlanResponse> planWithParallelPipelines(
     const std::vector<::planning_interface::MotionPlanRequest>& motion_plan_requests,
     const ::planning_scene::PlanningSceneConstPtr& planning_scene,
     const std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>& planning_pipelines,
     const StoppingCriterionFunction& stopping_criterion_callback,
-    const SolutionSelectionFunction& solution_selection_function)
+    const SolutionSelectionFunction& solution_selection_function, bool wait_for_all_pipelines)
 {
-  // Create solutions container
-  PlanResponsesContainer plan_responses_container{ motion_plan_requests.size() };
-  std::vector<std::thread> planning_threads;
-  planning_threads.reserve(motion_plan_requests.size());
+  // The state is shared with the planning jobs, which may outlive this call if it doesn't wait for all pipelines
+  auto state = std::make_shared<ParallelPlanningState>(motion_plan_requests, planning_scene, planning_pipelines,
+                                                       stopping_criterion_callback);
 
   // Print a warning if more parallel planning problems than available concurrent threads are defined. If
   // std::thread::hardware_concurrency() is not defined, the command returns 0 so the check does not work
@@ -99,73 +262,32 @@ const std::vector<::planning_interface::MotionPlanResponse> planWithParallelPipe
                 motion_plan_requests.size(), hardware_concurrency);
   }
 
-  // Launch planning threads
-  for (const auto& request : motion_plan_requests)
+  // Launch planning jobs
+  for (std::size_t i = 0; i < motion_plan_requests.size(); ++i)
   {
-    auto planning_thread = std::thread([&]() {
-      auto plan_solution = ::planning_interface::MotionPlanResponse();
-      try
-      {
-        // Use planning scene if provided, otherwise the planning scene from planning scene monitor is used
-        plan_solution = planWithSinglePipeline(request, planning_scene, planning_pipelines);
-      }
-      catch (const std::exception& e)
-      {
-        RCLCPP_ERROR(getLogger(), "Planning pipeline '%s' threw exception '%s'", request.pipeline_id.c_str(), e.what());
-        plan_solution = ::planning_interface::MotionPlanResponse();
-        plan_solution.error_code = moveit::core::MoveItErrorCode::FAILURE;
-      }
-      plan_solution.planner_id = request.planner_id;
-      plan_responses_container.pushBack(plan_solution);
-
-      if (stopping_criterion_callback != nullptr)
-      {
-        if (stopping_criterion_callback(plan_responses_container, motion_plan_requests))
-        {
-          // Terminate planning pipelines
-          RCLCPP_INFO(getLogger(), "Stopping criterion met: Terminating planning pipelines that are still active");
-          for (const auto& request : motion_plan_requests)
-          {
-            try
-            {
-              const auto& planning_pipeline = planning_pipelines.at(request.pipeline_id);
-              if (planning_pipeline->isActive())
-              {
-                planning_pipeline->terminate();
-              }
-            }
-            catch (const std::out_of_range&)
-            {
-              RCLCPP_WARN(getLogger(), "Cannot terminate pipeline '%s' because no pipeline with that name exists",
-                          request.pipeline_id.c_str());
-            }
-          }
-        }
-      }
-    });
-    planning_threads.push_back(std::move(planning_thread));
+    getPlanningThreadPool().run([state, i] { planRequest(state, i); });
   }
 
-  // Wait for threads to finish
-  for (auto& planning_thread : planning_threads)
+  // Wait for the jobs to finish, or only until the stopping criterion is met
+  std::vector<::planning_interface::MotionPlanResponse> solutions;
   {
-    if (planning_thread.joinable())
-    {
-      planning_thread.join();
-    }
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&] {
+      return state->finished_requests == motion_plan_requests.size() || (state->stopped && !wait_for_all_pipelines);
+    });
+    solutions = state->finished_requests == motion_plan_requests.size() ?
+                    state->plan_responses_container.getSolutions() :
+                    state->solutions_when_stopped;
   }
 
   // If a solution selection function is provided, it is used to compute the return value
   if (solution_selection_function)
   {
-    std::vector<::planning_interface::MotionPlanResponse> solutions;
-    solutions.reserve(1);
-    solutions.push_back(solution_selection_function(plan_responses_container.getSolutions()));
-    return solutions;
+    return { solution_selection_function(solutions) };
   }
 
   // Otherwise, just return the unordered list of solutions
-  return plan_responses_container.getSolutions();
+  return solutions;
 }
 
 std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>
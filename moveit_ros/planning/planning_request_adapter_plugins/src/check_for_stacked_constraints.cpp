@@ -88,6 +88,11 @@ public:
     return moveit::core::MoveItErrorCode(moveit_msgs::msg::MoveItErrorCodes::SUCCESS, std::string(""), getDescription());
   }
 
+  [[nodiscard]] bool modifiesRequest() const override
+  {
+    return false;
+  }
+
 private:
   std::unique_ptr<default_request_adapter_parameters::ParamListener> param_listener_;
   rclcpp::Logger logger_;
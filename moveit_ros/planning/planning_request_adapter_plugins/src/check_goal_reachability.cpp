@@ -0,0 +1,156 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: A planning request adapter that rejects requests whose goal regions a precomputed reachability map marks as
+ * unreachable, before any planning time is spent on them.
+ */
+
+#include <moveit/kinematic_constraints/kinematic_constraint.hpp>
+#include <moveit/planning_interface/planning_request_adapter.hpp>
+#include <moveit/reachability_map/reachability_map.hpp>
+#include <moveit/robot_state/conversions.hpp>
+#include <class_loader/class_loader.hpp>
+#include <geometric_shapes/bodies.h>
+#include <rclcpp/logger.hpp>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/node.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <default_request_adapter_parameters.hpp>
+
+namespace default_planning_request_adapters
+{
+
+/** @brief Reject requests whose goal position regions are all outside the reachability map of the planning group. */
+class CheckGoalReachability : public planning_interface::PlanningRequestAdapter
+{
+public:
+  CheckGoalReachability() : logger_(moveit::getLogger("moveit.ros.check_goal_reachability"))
+  {
+  }
+
+  void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
+  {
+    param_listener_ = std::make_unique<default_request_adapter_parameters::ParamListener>(node, parameter_namespace);
+    for (const std::string& file_name : param_listener_->get_params().reachability_map_files)
+    {
+      if (reachability_map::ReachabilityMapConstPtr map = reachability_map::ReachabilityMap::load(file_name))
+        reachability_maps_.push_back(map);
+    }
+  }
+
+  [[nodiscard]] std::string getDescription() const override
+  {
+    return std::string("CheckGoalReachability");
+  }
+
+  [[nodiscard]] moveit::core::MoveItErrorCode adapt(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                                    planning_interface::MotionPlanRequest& req) const override
+  {
+    RCLCPP_DEBUG(logger_, "Running '%s'", getDescription().c_str());
+    if (req.goal_constraints.empty())
+      return moveit::core::MoveItErrorCode(moveit_msgs::msg::MoveItErrorCodes::SUCCESS, std::string(""),
+                                           getDescription());
+
+    // goal regions given relative to robot links move with the start state
+    moveit::core::RobotState start_state = planning_scene->getCurrentState();
+    moveit::core::robotStateMsgToRobotState(planning_scene->getTransforms(), req.start_state, start_state);
+    start_state.update();
+
+    // the goal is reached if any of the constraint sets is satisfied
+    for (const moveit_msgs::msg::Constraints& goal : req.goal_constraints)
+    {
+      if (isReachable(*planning_scene, start_state, req.group_name, goal))
+        return moveit::core::MoveItErrorCode(moveit_msgs::msg::MoveItErrorCodes::SUCCESS, std::string(""),
+                                             getDescription());
+    }
+    RCLCPP_ERROR(logger_, "The goal regions of group '%s' are outside of its reachability map",
+                 req.group_name.c_str());
+    return moveit::core::MoveItErrorCode(moveit_msgs::msg::MoveItErrorCodes::INVALID_GOAL_CONSTRAINTS,
+                                         std::string("Goal regions are unreachable"), getDescription());
+  }
+
+  [[nodiscard]] bool modifiesRequest() const override
+  {
+    return false;
+  }
+
+private:
+  bool isReachable(const planning_scene::PlanningScene& planning_scene, const moveit::core::RobotState& start_state,
+                   const std::string& group_name, const moveit_msgs::msg::Constraints& goal) const
+  {
+    for (const reachability_map::ReachabilityMapConstPtr& map : reachability_maps_)
+    {
+      if (map->getGroupName() != group_name || !start_state.getRobotModel()->hasLinkModel(map->getBaseFrame()))
+        continue;
+      const Eigen::Isometry3d base_inverse = start_state.getGlobalLinkTransform(map->getBaseFrame()).inverse();
+      for (const moveit_msgs::msg::PositionConstraint& position_constraint : goal.position_constraints)
+      {
+        if (position_constraint.link_name != map->getTipFrame())
+          continue;
+        kinematic_constraints::PositionConstraint constraint(planning_scene.getRobotModel());
+        if (!constraint.configure(position_constraint, planning_scene.getTransforms()))
+          continue;
+
+        // the constraint holds for a point offset from the link, whose orientation is unknown here
+        const double offset = constraint.getLinkOffset().norm();
+        const Eigen::Isometry3d region_frame = constraint.mobileReferenceFrame() ?
+                                                   start_state.getFrameTransform(constraint.getReferenceFrame()) :
+                                                   Eigen::Isometry3d::Identity();
+        bool region_reachable = false;
+        for (const bodies::BodyPtr& region : constraint.getConstraintRegions())
+        {
+          bodies::BoundingSphere sphere;
+          region->computeBoundingSphere(sphere);
+          if (map->isRegionReachable(base_inverse * region_frame * sphere.center, sphere.radius + offset))
+          {
+            region_reachable = true;
+            break;
+          }
+        }
+        if (!region_reachable)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  std::unique_ptr<default_request_adapter_parameters::ParamListener> param_listener_;
+  std::vector<reachability_map::ReachabilityMapConstPtr> reachability_maps_;
+  rclcpp::Logger logger_;
+};
+}  // namespace default_planning_request_adapters
+
+CLASS_LOADER_REGISTER_CLASS(default_planning_request_adapters::CheckGoalReachability,
+                            planning_interface::PlanningRequestAdapter)
@@ -196,6 +196,12 @@ public:
     return status;
   }
 
+  [[nodiscard]] bool modifiesRequest() const override
+  {
+    // the start state is only ever changed if it may be fixed
+    return param_listener_->get_params().fix_start_state;
+  }
+
 private:
   std::unique_ptr<default_request_adapter_parameters::ParamListener> param_listener_;
   rclcpp::Logger logger_;
@@ -47,6 +47,9 @@
 
 #include <default_request_adapter_parameters.hpp>
 
+#include <algorithm>
+#include <mutex>
+
 namespace default_planning_request_adapters
 {
 
@@ -72,6 +75,23 @@ public:
     moveit::core::RobotState start_state = planning_scene->getCurrentState();
     moveit::core::robotStateMsgToRobotState(planning_scene->getTransforms(), req.start_state, start_state);
 
+    // Repeated requests from the same start state, e.g. for replanning, reuse the last result while the scene is
+    // unchanged
+    CachedResult key;
+    key.planning_scene = planning_scene;
+    key.world_version = planning_scene->getWorld()->getVersion();
+    key.collision_check_version = planning_scene->getCollisionCheckVersion();
+    key.group_name = req.group_name;
+    key.state_key = getStateKey(start_state);
+    {
+      std::scoped_lock lock(cached_result_mutex_);
+      if (cached_result_.matches(key))
+      {
+        RCLCPP_DEBUG(logger_, "Reusing the collision status of the unchanged start state");
+        return cached_result_.status;
+      }
+    }
+
     collision_detection::CollisionRequest creq;
     creq.group_name = req.group_name;
     collision_detection::CollisionResult cres;
@@ -99,11 +119,62 @@ public:
       status.message = std::string(contact_information);
     }
     status.source = getDescription();
+
+    key.status = status;
+    std::scoped_lock lock(cached_result_mutex_);
+    cached_result_ = std::move(key);
     return status;
   }
 
+  [[nodiscard]] bool modifiesRequest() const override
+  {
+    return false;
+  }
+
 private:
+  // The result of the last check, identified by the scene, its versions, the group and the start state
+  struct CachedResult
+  {
+    planning_scene::PlanningSceneConstWeakPtr planning_scene;
+    std::uint64_t world_version = 0;
+    std::uint64_t collision_check_version = 0;
+    std::string group_name;
+    std::string state_key;
+    moveit::core::MoveItErrorCode status;
+
+    bool matches(const CachedResult& other) const
+    {
+      return world_version == other.world_version && collision_check_version == other.collision_check_version &&
+             group_name == other.group_name && state_key == other.state_key &&
+             planning_scene.lock() == other.planning_scene.lock();
+    }
+  };
+
+  // Identify a state by its exact joint positions and the bodies attached to its links
+  static std::string getStateKey(const moveit::core::RobotState& state)
+  {
+    std::vector<const moveit::core::AttachedBody*> attached_bodies;
+    state.getAttachedBodies(attached_bodies);
+    std::sort(attached_bodies.begin(), attached_bodies.end(),
+              [](const moveit::core::AttachedBody* a, const moveit::core::AttachedBody* b) {
+                return a->getName() < b->getName();
+              });
+
+    std::string key(reinterpret_cast<const char*>(state.getVariablePositions()),
+                    state.getVariableCount() * sizeof(double));
+    for (const moveit::core::AttachedBody* attached_body : attached_bodies)
+    {
+      key += attached_body->getName();
+      key.push_back('\0');
+      key += attached_body->getAttachedLinkName();
+      key.push_back('\0');
+    }
+    return key;
+  }
+
   rclcpp::Logger logger_;
+  mutable std::mutex cached_result_mutex_;
+  mutable CachedResult cached_result_;
 };
 }  // namespace default_planning_request_adapters
 
@@ -0,0 +1,189 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: This adapter replaces a start state in collision by a nearby collision-free state, sampled on several threads.
+ */
+
+#include <moveit/planning_interface/planning_request_adapter.hpp>
+#include <moveit/collision_detection/collision_batch.hpp>
+#include <moveit/robot_state/conversions.hpp>
+#include <class_loader/class_loader.hpp>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/node.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <default_request_adapter_parameters.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace default_planning_request_adapters
+{
+
+/** @brief If the start state is in collision, this adapter samples collision-free states near it, by perturbing each
+ * joint by a fraction of its range. The sampled states are checked for collisions concurrently in batches, until a
+ * collision-free state is found, the sampling attempts are used up or the time budget is exhausted. The first
+ * collision-free state replaces the start state of the request. Once planning succeeded, the original start state is
+ * prepended to the solution, so that it can be executed without another planning request.
+ */
+class FixStartStateCollision : public planning_interface::PlanningRequestAdapter
+{
+public:
+  FixStartStateCollision() : logger_(moveit::getLogger("moveit.ros.fix_start_state_collision"))
+  {
+  }
+
+  void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
+  {
+    param_listener_ = std::make_unique<default_request_adapter_parameters::ParamListener>(node, parameter_namespace);
+    const auto threads = param_listener_->get_params().start_state_repair_threads;
+    thread_pool_ = std::make_unique<collision_detection::CollisionThreadPool>(
+        threads > 0 ? static_cast<std::size_t>(threads) : std::max(1u, std::thread::hardware_concurrency()));
+  }
+
+  [[nodiscard]] std::string getDescription() const override
+  {
+    return std::string("FixStartStateCollision");
+  }
+
+  [[nodiscard]] moveit::core::MoveItErrorCode adapt(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                                    planning_interface::MotionPlanRequest& req) const override
+  {
+    RCLCPP_DEBUG(logger_, "Running '%s'", getDescription().c_str());
+
+    auto status = moveit::core::MoveItErrorCode(moveit_msgs::msg::MoveItErrorCodes::SUCCESS, "", getDescription());
+    moveit::core::RobotState start_state = getStartState(*planning_scene, req);
+    if (!planning_scene->isStateColliding(start_state, req.group_name))
+      return status;
+
+    status.val = moveit_msgs::msg::MoveItErrorCodes::START_STATE_IN_COLLISION;
+    const moveit::core::JointModelGroup* group = start_state.getRobotModel()->getJointModelGroup(req.group_name);
+    if (!group)
+    {
+      status.message = "Unable to fix the start state in collision without a valid planning group.";
+      RCLCPP_WARN(logger_, "%s", status.message.c_str());
+      return status;
+    }
+
+    const auto params = param_listener_->get_params();
+    std::vector<double> distances;
+    for (const moveit::core::JointModel* joint : group->getActiveJointModels())
+      distances.push_back(joint->getMaximumExtent() * params.jiggle_fraction);
+
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::duration<double>(params.start_state_repair_time_budget);
+    const auto max_attempts = static_cast<std::size_t>(params.max_sampling_attempts);
+    const std::size_t batch_size = thread_pool_->getThreadCount();
+    std::vector<moveit::core::RobotState> samples(batch_size, start_state);
+    std::vector<char> colliding(batch_size);
+    random_numbers::RandomNumberGenerator& rng = getRandomNumberGenerator();
+
+    for (std::size_t attempts = 0; attempts < max_attempts && std::chrono::steady_clock::now() < deadline;)
+    {
+      // Sampling uses the random number generator of the planning thread, so only the collision checks are concurrent
+      const std::size_t count = std::min(batch_size, max_attempts - attempts);
+      for (std::size_t i = 0; i < count; ++i)
+        samples[i].setToRandomPositionsNearBy(group, start_state, distances, rng);
+      const std::function<void(std::size_t)> check = [&](std::size_t i) {
+        colliding[i] = planning_scene->isStateColliding(samples[i], req.group_name);
+      };
+      if (!thread_pool_->tryRun(count, check))
+      {
+        for (std::size_t i = 0; i < count; ++i)
+          check(i);
+      }
+      attempts += count;
+
+      const auto valid = std::find(colliding.begin(), colliding.begin() + count, 0);
+      if (valid != colliding.begin() + count)
+      {
+        moveit::core::robotStateToRobotStateMsg(samples[valid - colliding.begin()], req.start_state);
+        RCLCPP_INFO(logger_, "Found a valid start state near the start state in collision after %zu attempts",
+                    attempts);
+        status.val = moveit_msgs::msg::MoveItErrorCodes::SUCCESS;
+        status.message = "Replaced the start state in collision.";
+        return status;
+      }
+    }
+
+    status.message = "Unable to find a valid state near the start state in collision.";
+    RCLCPP_WARN(logger_, "%s", status.message.c_str());
+    return status;
+  }
+
+  void adaptResponse(const planning_scene::PlanningSceneConstPtr& planning_scene,
+                     const planning_interface::MotionPlanRequest& req,
+                     planning_interface::MotionPlanResponse& res) const override
+  {
+    if (!res.trajectory || res.trajectory->empty())
+      return;
+
+    // The solution only starts somewhere else if the original start state had to be replaced
+    moveit::core::RobotState start_state = getStartState(*planning_scene, req);
+    if (start_state.distance(res.trajectory->getFirstWayPoint()) == 0.0 ||
+        !planning_scene->isStateColliding(start_state, req.group_name))
+    {
+      return;
+    }
+
+    res.trajectory->addPrefixWayPoint(start_state, 0.0);
+    moveit::core::robotStateToRobotStateMsg(start_state, res.start_state);
+  }
+
+private:
+  static moveit::core::RobotState getStartState(const planning_scene::PlanningScene& planning_scene,
+                                                const planning_interface::MotionPlanRequest& req)
+  {
+    moveit::core::RobotState start_state = planning_scene.getCurrentState();
+    moveit::core::robotStateMsgToRobotState(planning_scene.getTransforms(), req.start_state, start_state);
+    return start_state;
+  }
+
+  // Pipelines may share the adapter and plan concurrently, so each planning thread samples with its own generator
+  static random_numbers::RandomNumberGenerator& getRandomNumberGenerator()
+  {
+    thread_local random_numbers::RandomNumberGenerator rng;
+    return rng;
+  }
+
+  std::unique_ptr<default_request_adapter_parameters::ParamListener> param_listener_;
+  std::unique_ptr<collision_detection::CollisionThreadPool> thread_pool_;
+  rclcpp::Logger logger_;
+};
+}  // namespace default_planning_request_adapters
+
+CLASS_LOADER_REGISTER_CLASS(default_planning_request_adapters::FixStartStateCollision,
+                            planning_interface::PlanningRequestAdapter)
@@ -0,0 +1,128 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <rclcpp/rclcpp.hpp>
+
+#include <geometric_shapes/shapes.h>
+#include <moveit/planning_interface/planning_request_adapter.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
+#include <moveit/robot_state/conversions.hpp>
+#include <moveit/utils/robot_model_test_utils.hpp>
+#include <pluginlib/class_loader.hpp>
+
+class TestFixStartStateCollision : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rclcpp::init(0, nullptr);
+    node_ = std::make_shared<rclcpp::Node>("test_fix_start_state_collision_adapter", "");
+
+    robot_model_ = moveit::core::loadTestingRobotModel("panda");
+    planning_scene_ = std::make_shared<planning_scene::PlanningScene>(robot_model_);
+    planning_scene_->getCurrentStateNonConst().setToDefaultValues();
+
+    plugin_loader_ = std::make_unique<pluginlib::ClassLoader<planning_interface::PlanningRequestAdapter>>(
+        "moveit_core", "planning_interface::PlanningRequestAdapter");
+    adapter_ = plugin_loader_->createUniqueInstance("default_planning_request_adapters/FixStartStateCollision");
+    adapter_->initialize(node_, "");
+
+    request_.group_name = "panda_arm";
+    moveit::core::robotStateToRobotStateMsg(planning_scene_->getCurrentState(), request_.start_state);
+  }
+
+  void TearDown() override
+  {
+    rclcpp::shutdown();
+  }
+
+  // Enclose the whole robot, such that every state is in collision
+  void addEnclosingBox()
+  {
+    planning_scene_->getWorldNonConst()->addToObject("box", std::make_shared<shapes::Box>(10.0, 10.0, 10.0),
+                                                     Eigen::Isometry3d::Identity());
+  }
+
+  std::shared_ptr<rclcpp::Node> node_;
+  moveit::core::RobotModelPtr robot_model_;
+  std::shared_ptr<planning_scene::PlanningScene> planning_scene_;
+  std::unique_ptr<pluginlib::ClassLoader<planning_interface::PlanningRequestAdapter>> plugin_loader_;
+  pluginlib::UniquePtr<planning_interface::PlanningRequestAdapter> adapter_;
+  planning_interface::MotionPlanRequest request_;
+};
+
+TEST_F(TestFixStartStateCollision, ValidStartStateIsKept)
+{
+  const moveit_msgs::msg::RobotState start_state = request_.start_state;
+  const auto result = adapter_->adapt(planning_scene_, request_);
+  EXPECT_EQ(result.val, moveit_msgs::msg::MoveItErrorCodes::SUCCESS);
+  EXPECT_EQ(request_.start_state, start_state);
+}
+
+TEST_F(TestFixStartStateCollision, UnfixableStartStateFails)
+{
+  addEnclosingBox();
+  const auto result = adapter_->adapt(planning_scene_, request_);
+  EXPECT_EQ(result.val, moveit_msgs::msg::MoveItErrorCodes::START_STATE_IN_COLLISION);
+}
+
+TEST_F(TestFixStartStateCollision, OriginalStartStateIsPrepended)
+{
+  addEnclosingBox();
+
+  // A solution planned from a replaced start state
+  moveit::core::RobotState replaced_start_state = planning_scene_->getCurrentState();
+  replaced_start_state.setVariablePosition("panda_joint1", 0.1);
+  planning_interface::MotionPlanResponse response;
+  response.trajectory = std::make_shared<robot_trajectory::RobotTrajectory>(robot_model_, request_.group_name);
+  response.trajectory->addSuffixWayPoint(replaced_start_state, 0.0);
+
+  adapter_->adaptResponse(planning_scene_, request_, response);
+  ASSERT_EQ(response.trajectory->getWayPointCount(), 2u);
+  EXPECT_EQ(response.trajectory->getFirstWayPoint().distance(planning_scene_->getCurrentState()), 0.0);
+
+  // A solution from the original start state is left alone
+  adapter_->adaptResponse(planning_scene_, request_, response);
+  EXPECT_EQ(response.trajectory->getWayPointCount(), 2u);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
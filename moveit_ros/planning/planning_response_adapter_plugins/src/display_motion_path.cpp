@@ -42,6 +42,11 @@
 #include <moveit/utils/logger.hpp>
 #include <moveit_msgs/msg/display_trajectory.hpp>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include <default_response_adapter_parameters.hpp>
 
 namespace default_planning_response_adapters
@@ -50,6 +55,8 @@ namespace default_planning_response_adapters
  * @brief Adapter to publish the EE path as marker array via ROS topic if a path exist. Otherwise, a warning is printed
  * but this adapter cannot fail.
  *
+ * The message is created and published by a background thread from a copy of the path, so that neither the conversion
+ * nor later adapters modifying the response delay each other.
  */
 class DisplayMotionPath : public planning_interface::PlanningResponseAdapter
 {
@@ -58,6 +65,17 @@ public:
   {
   }
 
+  ~DisplayMotionPath() override
+  {
+    {
+      std::scoped_lock lock(queue_mutex_);
+      stop_ = true;
+    }
+    queue_condition_.notify_one();
+    if (publisher_thread_.joinable())
+      publisher_thread_.join();
+  }
+
   void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
   {
     auto param_listener =
@@ -66,6 +84,7 @@ public:
     const auto params = param_listener->get_params();
     display_path_publisher_ = node->create_publisher<moveit_msgs::msg::DisplayTrajectory>(params.display_path_topic,
                                                                                           rclcpp::SystemDefaultsQoS());
+    publisher_thread_ = std::thread([this] { publishPaths(); });
   }
 
   [[nodiscard]] std::string getDescription() const override
@@ -73,19 +92,20 @@ public:
     return std::string("DisplayMotionPath");
   }
 
-  void adapt(const planning_scene::PlanningSceneConstPtr& planning_scene,
+  void adapt(const planning_scene::PlanningSceneConstPtr& /* planning_scene */,
              const planning_interface::MotionPlanRequest& /* req */,
              planning_interface::MotionPlanResponse& res) const override
   {
     RCLCPP_DEBUG(logger_, " Running '%s'", getDescription().c_str());
     if (res.trajectory)
     {
-      moveit_msgs::msg::DisplayTrajectory disp;
-      disp.model_id = planning_scene->getRobotModel()->getName();
-      disp.trajectory.resize(1);
-      res.trajectory->getRobotTrajectoryMsg(disp.trajectory.at(0));
-      moveit::core::robotStateToRobotStateMsg(res.trajectory->getFirstWayPoint(), disp.trajectory_start);
-      display_path_publisher_->publish(disp);
+      // Later adapters may modify the waypoints of the response, so the published path owns its waypoints
+      auto path = std::make_shared<const robot_trajectory::RobotTrajectory>(*res.trajectory, true);
+      {
+        std::scoped_lock lock(queue_mutex_);
+        queue_.push_back(std::move(path));
+      }
+      queue_condition_.notify_one();
     }
     else
     {
@@ -94,8 +114,38 @@ public:
   }
 
 private:
+  void publishPaths()
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (true)
+    {
+      queue_condition_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (stop_)
+        return;
+      const robot_trajectory::RobotTrajectoryConstPtr path = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+
+      moveit_msgs::msg::DisplayTrajectory disp;
+      disp.model_id = path->getRobotModel()->getName();
+      disp.trajectory.resize(1);
+      path->getRobotTrajectoryMsg(disp.trajectory.at(0));
+      moveit::core::robotStateToRobotStateMsg(path->getFirstWayPoint(), disp.trajectory_start);
+      display_path_publisher_->publish(disp);
+
+      lock.lock();
+    }
+  }
+
   rclcpp::Logger logger_;
   rclcpp::Publisher<moveit_msgs::msg::DisplayTrajectory>::SharedPtr display_path_publisher_;
+
+  // Paths waiting to be published by publisher_thread_
+  std::deque<robot_trajectory::RobotTrajectoryConstPtr> queue_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_condition_;
+  bool stop_ = false;
+  std::thread publisher_thread_;
 };
 }  // namespace default_planning_response_adapters
 
@@ -0,0 +1,334 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Desc: Response adapter that shortens a path by randomized shortcutting and smooths it with a cubic B-spline,
+   validating candidate motions on several threads
+*/
+
+#include <moveit/planning_interface/planning_response_adapter.hpp>
+#include <moveit/collision_detection/collision_batch.hpp>
+#include <class_loader/class_loader.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include <default_response_adapter_parameters.hpp>
+
+namespace default_planning_response_adapters
+{
+namespace
+{
+// Smallest reduction of the path length for which a shortcut is considered
+constexpr double MIN_SHORTCUT_GAIN = 1e-6;
+
+// Validity checks of states and motions of a single path, safe to call from several threads
+struct MotionValidator
+{
+  const planning_scene::PlanningScene& scene;
+  const moveit_msgs::msg::Constraints& constraints;
+  const moveit::core::JointModelGroup* group;  // nullptr if the path moves all joints
+  std::string group_name;
+  double max_step;
+
+  double distance(const moveit::core::RobotState& from, const moveit::core::RobotState& to) const
+  {
+    return group ? from.distance(to, group) : from.distance(to);
+  }
+
+  // The joints not in the group are left untouched in state
+  void interpolate(const moveit::core::RobotState& from, const moveit::core::RobotState& to, double t,
+                   moveit::core::RobotState& state) const
+  {
+    if (group)
+    {
+      from.interpolate(to, t, state, group);
+    }
+    else
+    {
+      from.interpolate(to, t, state);
+    }
+  }
+
+  bool isStateValid(moveit::core::RobotState& state) const
+  {
+    state.updateCollisionBodyTransforms();
+    return scene.isStateValid(state, constraints, group_name);
+  }
+
+  // Check the states between from and to at most max_step apart, excluding both end points
+  bool isMotionValid(const moveit::core::RobotState& from, const moveit::core::RobotState& to,
+                     moveit::core::RobotState& scratch) const
+  {
+    const auto steps = static_cast<std::size_t>(std::ceil(distance(from, to) / max_step));
+    scratch = from;
+    for (std::size_t step = 1; step < steps; ++step)
+    {
+      interpolate(from, to, static_cast<double>(step) / static_cast<double>(steps), scratch);
+      if (!isStateValid(scratch))
+        return false;
+    }
+    return true;
+  }
+};
+
+struct Shortcut
+{
+  std::size_t from;
+  std::size_t to;
+  double gain;
+};
+}  // namespace
+
+/**
+ * @brief Adapter shortening and smoothing the solution path before it is time-parameterized.
+ *
+ * Each round samples a batch of shortcuts between two waypoints of the path, validates their motions concurrently and
+ * applies the non-overlapping valid shortcuts with the largest length reduction. The shortened path is then resampled
+ * and its interior waypoints are repeatedly moved towards the cubic B-spline through their neighbors, keeping only
+ * moves with valid motions. Batches are sampled and applied independently of the number of threads, so the result only
+ * depends on the seed as long as the time budget is not exhausted. Existing time stamps of the path are discarded.
+ */
+class ShortcutPath : public planning_interface::PlanningResponseAdapter
+{
+public:
+  ShortcutPath() : logger_(moveit::getLogger("moveit.ros.shortcut_path"))
+  {
+  }
+
+  void initialize(const rclcpp::Node::SharedPtr& node, const std::string& parameter_namespace) override
+  {
+    param_listener_ = std::make_unique<default_response_adapter_parameters::ParamListener>(node, parameter_namespace);
+  }
+
+  [[nodiscard]] std::string getDescription() const override
+  {
+    return std::string("ShortcutPath");
+  }
+
+  void adapt(const planning_scene::PlanningSceneConstPtr& planning_scene,
+             const planning_interface::MotionPlanRequest& req,
+             planning_interface::MotionPlanResponse& res) const override
+  {
+    RCLCPP_DEBUG(logger_, " Running '%s'", getDescription().c_str());
+    if (!res.trajectory)
+    {
+      RCLCPP_ERROR(logger_, "Cannot apply response adapter '%s' because MotionPlanResponse does not contain a path.",
+                   getDescription().c_str());
+      res.error_code = moveit::core::MoveItErrorCode::INVALID_MOTION_PLAN;
+      return;
+    }
+
+    const auto params = param_listener_->get_params().shortcut;
+    if (res.trajectory->getWayPointCount() < 3)
+      return;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(params.time_budget);
+    const auto budget_left = [&deadline] { return std::chrono::steady_clock::now() < deadline; };
+
+    const moveit::core::JointModelGroup* group = res.trajectory->getGroup();
+    const MotionValidator validator{ *planning_scene, req.path_constraints, group,
+                                     group ? group->getName() : req.group_name, params.max_step };
+
+    std::vector<moveit::core::RobotState> path;
+    path.reserve(res.trajectory->getWayPointCount());
+    for (std::size_t i = 0; i < res.trajectory->getWayPointCount(); ++i)
+      path.push_back(res.trajectory->getWayPoint(i));
+    const double initial_length = pathLength(validator, path);
+
+    const std::size_t thread_count = params.thread_count > 0 ? static_cast<std::size_t>(params.thread_count) :
+                                                               std::max(1u, std::thread::hardware_concurrency());
+    collision_detection::CollisionThreadPool pool(thread_count);
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(params.seed));
+
+    std::size_t shortcut_count = 0;
+    for (int round = 0; round < params.max_iterations && path.size() >= 3 && budget_left(); ++round)
+      shortcut_count += shortcutRound(validator, pool, rng, static_cast<std::size_t>(params.attempts_per_batch), path);
+
+    std::size_t smoothed_count = 0;
+    if (params.spline_iterations > 0 && budget_left())
+    {
+      densify(validator, path);
+      for (int iteration = 0; iteration < params.spline_iterations && budget_left(); ++iteration)
+      {
+        // moving only every other waypoint keeps the neighbors of each moved waypoint fixed
+        smoothed_count += smoothWayPoints(validator, pool, 1, path);
+        smoothed_count += smoothWayPoints(validator, pool, 2, path);
+      }
+    }
+
+    const double final_length = pathLength(validator, path);
+    RCLCPP_DEBUG(logger_, "Applied %zu shortcuts and %zu smoothing steps, path length %f -> %f with %zu waypoints",
+                 shortcut_count, smoothed_count, initial_length, final_length, path.size());
+
+    res.trajectory->clear();
+    for (moveit::core::RobotState& state : path)
+      res.trajectory->addSuffixWayPoint(std::make_shared<moveit::core::RobotState>(std::move(state)), 0.0);
+  }
+
+private:
+  static double pathLength(const MotionValidator& validator, const std::vector<moveit::core::RobotState>& path)
+  {
+    double length = 0.0;
+    for (std::size_t i = 1; i < path.size(); ++i)
+      length += validator.distance(path[i - 1], path[i]);
+    return length;
+  }
+
+  // Sample a batch of shortcuts, validate them concurrently and apply the best non-overlapping valid ones
+  static std::size_t shortcutRound(const MotionValidator& validator, collision_detection::CollisionThreadPool& pool,
+                                   std::mt19937& rng, std::size_t attempts,
+                                   std::vector<moveit::core::RobotState>& path)
+  {
+    // lengths_from_start[i] is the path length up to waypoint i
+    std::vector<double> lengths_from_start(path.size(), 0.0);
+    for (std::size_t i = 1; i < path.size(); ++i)
+      lengths_from_start[i] = lengths_from_start[i - 1] + validator.distance(path[i - 1], path[i]);
+
+    // mt19937 output is fully specified, unlike std::uniform_int_distribution, so batches are portable
+    std::vector<Shortcut> candidates;
+    candidates.reserve(attempts);
+    for (std::size_t attempt = 0; attempt < attempts; ++attempt)
+    {
+      const std::size_t from = rng() % (path.size() - 2);
+      const std::size_t to = from + 2 + rng() % (path.size() - from - 2);
+      const double gain =
+          lengths_from_start[to] - lengths_from_start[from] - validator.distance(path[from], path[to]);
+      if (gain > MIN_SHORTCUT_GAIN)
+        candidates.push_back({ from, to, gain });
+    }
+
+    std::vector<char> valid(candidates.size(), 0);
+    pool.tryRun(candidates.size(), [&](std::size_t i) {
+      moveit::core::RobotState scratch(path[candidates[i].from]);
+      valid[i] = validator.isMotionValid(path[candidates[i].from], path[candidates[i].to], scratch);
+    });
+
+    std::vector<Shortcut> accepted;
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      if (valid[i])
+        accepted.push_back(candidates[i]);
+    }
+    std::stable_sort(accepted.begin(), accepted.end(),
+                     [](const Shortcut& a, const Shortcut& b) { return a.gain > b.gain; });
+
+    std::vector<Shortcut> applied;
+    for (const Shortcut& shortcut : accepted)
+    {
+      const bool overlaps = std::any_of(applied.begin(), applied.end(), [&shortcut](const Shortcut& other) {
+        return shortcut.from < other.to && other.from < shortcut.to;
+      });
+      if (!overlaps)
+        applied.push_back(shortcut);
+    }
+
+    // erase from the back, so the indices of the remaining shortcuts stay valid
+    std::sort(applied.begin(), applied.end(), [](const Shortcut& a, const Shortcut& b) { return a.from > b.from; });
+    for (const Shortcut& shortcut : applied)
+    {
+      path.erase(path.begin() + static_cast<std::ptrdiff_t>(shortcut.from + 1),
+                 path.begin() + static_cast<std::ptrdiff_t>(shortcut.to));
+    }
+    return applied.size();
+  }
+
+  // Insert waypoints so that consecutive waypoints are at most max_step apart
+  static void densify(const MotionValidator& validator, std::vector<moveit::core::RobotState>& path)
+  {
+    std::vector<moveit::core::RobotState> dense;
+    dense.reserve(path.size());
+    dense.push_back(path.front());
+    for (std::size_t i = 1; i < path.size(); ++i)
+    {
+      const auto steps =
+          static_cast<std::size_t>(std::ceil(validator.distance(path[i - 1], path[i]) / validator.max_step));
+      for (std::size_t step = 1; step < steps; ++step)
+      {
+        dense.push_back(path[i - 1]);
+        validator.interpolate(path[i - 1], path[i], static_cast<double>(step) / static_cast<double>(steps),
+                              dense.back());
+      }
+      dense.push_back(path[i]);
+    }
+    path.swap(dense);
+  }
+
+  // Move the waypoints first, first + 2, ... towards the uniform cubic B-spline defined by the path and return the
+  // number of moved waypoints. A waypoint is only moved if it and its motions to both neighbors remain valid.
+  static std::size_t smoothWayPoints(const MotionValidator& validator, collision_detection::CollisionThreadPool& pool,
+                                     std::size_t first, std::vector<moveit::core::RobotState>& path)
+  {
+    if (path.size() < first + 2)
+      return 0;
+    const std::size_t count = (path.size() - first) / 2;
+
+    std::vector<moveit::core::RobotState> smoothed(count, path.front());
+    std::vector<char> valid(count, 0);
+    pool.tryRun(count, [&](std::size_t i) {
+      const std::size_t index = first + 2 * i;
+      // (p[k-1] + 4 p[k] + p[k+1]) / 6 is the point one third of the way from p[k] to the midpoint of its neighbors
+      moveit::core::RobotState midpoint(path[index]);
+      validator.interpolate(path[index - 1], path[index + 1], 0.5, midpoint);
+      smoothed[i] = path[index];
+      validator.interpolate(path[index], midpoint, 1.0 / 3.0, smoothed[i]);
+
+      moveit::core::RobotState scratch(path[index]);
+      valid[i] = validator.isStateValid(smoothed[i]) &&
+                 validator.isMotionValid(path[index - 1], smoothed[i], scratch) &&
+                 validator.isMotionValid(smoothed[i], path[index + 1], scratch);
+    });
+
+    std::size_t moved = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      if (valid[i])
+      {
+        path[first + 2 * i] = std::move(smoothed[i]);
+        ++moved;
+      }
+    }
+    return moved;
+  }
+
+  std::unique_ptr<default_response_adapter_parameters::ParamListener> param_listener_;
+  rclcpp::Logger logger_;
+};
+}  // namespace default_planning_response_adapters
+
+CLASS_LOADER_REGISTER_CLASS(default_planning_response_adapters::ShortcutPath,
+                            planning_interface::PlanningResponseAdapter)
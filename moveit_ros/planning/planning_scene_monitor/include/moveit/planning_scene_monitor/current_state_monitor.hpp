@@ -40,6 +40,7 @@
 #include <functional>
 #include <string>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 
 #include <boost/signals2.hpp>
@@ -55,6 +56,7 @@
 namespace planning_scene_monitor
 {
 using JointStateUpdateCallback = std::function<void(sensor_msgs::msg::JointState::ConstSharedPtr)>;
+using StateUpdateCallback = std::function<void(const moveit::core::RobotStateConstPtr&, const rclcpp::Time&)>;
 
 /** @class CurrentStateMonitor
     @brief Monitors the joint_states topic and tf to maintain the current state of the robot. */
@@ -253,6 +255,15 @@ public:
    *  @return Returns the current state */
   moveit::core::RobotStatePtr getCurrentState() const;
 
+  /** @brief Get the latest state without copying it and without blocking the monitor's updates.
+   *  The returned state is shared among all readers and is never modified. Its transforms are up to date.
+   *  @return Returns the latest state */
+  moveit::core::RobotStateConstPtr getLatestState() const;
+
+  /** @brief Get the latest state, shared as in getLatestState(), and the time stamp of the update that produced it
+   *  @return Returns a pair of the latest state and its time stamp */
+  std::pair<moveit::core::RobotStateConstPtr, rclcpp::Time> getLatestStateAndTime() const;
+
   /** @brief Set the state \e upd to the current state maintained by this class. */
   void setToCurrentState(moveit::core::RobotState& upd) const;
 
@@ -263,6 +274,21 @@ public:
    *  @return Returns a pair of the current state and its time stamp */
   std::pair<moveit::core::RobotStatePtr, rclcpp::Time> getCurrentStateAndTime() const;
 
+  /** @brief Keep the last \e size states of the monitor in a history, so that getStateAtTime() can look them up.
+   *  The history is preallocated and disabled (size 0) by default. Changing its size discards the recorded states.
+   *  @param size The number of states kept in the history */
+  void setStateHistorySize(std::size_t size);
+
+  /** @brief Get the number of states kept in the history */
+  std::size_t getStateHistorySize() const;
+
+  /** @brief Set the positions of \e state to the monitored state at time \e t,
+   *  interpolated between the two recorded states closest to \e t.
+   *  @param t The time to look up
+   *  @param state The state to update, which must use the model of the monitor
+   *  @return false if \e t is not covered by the history */
+  bool getStateAtTime(const rclcpp::Time& t, moveit::core::RobotState& state) const;
+
   /** @brief Get the current state values as a map from joint names to joint state values
    *  @return Returns the map from joint names to joint state values*/
   std::map<std::string, double> getCurrentStateValues() const;
@@ -289,6 +315,10 @@ public:
   /** @brief Add a function that will be called whenever the joint state is updated*/
   void addUpdateCallback(const JointStateUpdateCallback& fn);
 
+  /** @brief Add a function that will be called with the latest state, as returned by getLatestStateAndTime(),
+   *  whenever the state is updated */
+  void addStateUpdateCallback(const StateUpdateCallback& fn);
+
   /** @brief Clear the functions to be called when an update to the joint state is received */
   void clearUpdateCallbacks();
 
@@ -326,11 +356,33 @@ private:
   void updateMultiDofJoints();
   void transformCallback(const tf2_msgs::msg::TFMessage::ConstSharedPtr& msg, const bool is_static);
 
+  // An immutable copy of robot_state_, shared with the readers of getLatestState()
+  struct LatestState
+  {
+    moveit::core::RobotState state;
+    rclcpp::Time stamp;
+  };
+
+  // Replace latest_state_ by a copy of robot_state_, requires state_update_lock_ to be held
+  void updateLatestState();
+
+  // Record robot_state_ in the state history, requires state_update_lock_ to be held
+  void updateStateHistory();
+
+  // Call the update callbacks after the state was updated by joint_state
+  void callUpdateCallbacks(const sensor_msgs::msg::JointState::ConstSharedPtr& joint_state);
+
   std::unique_ptr<MiddlewareHandle> middleware_handle_;
   std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
   moveit::core::RobotModelConstPtr robot_model_;
   moveit::core::RobotState robot_state_;
   std::map<const moveit::core::JointModel*, rclcpp::Time> joint_time_;
+
+  // The joint names of the last joint state message and the single-DOF joints they resolve to (nullptr for names
+  // that are not single-DOF joints of the model), so consecutive messages with the same layout skip the name lookups
+  std::vector<std::string> joint_state_names_;
+  std::vector<const moveit::core::JointModel*> joint_state_joints_;
+
   bool state_monitor_started_;
   bool copy_dynamics_;  // Copy velocity and effort from joint_state
   rclcpp::Time monitor_start_time_ = rclcpp::Time(0, 0, RCL_ROS_TIME);
@@ -340,6 +392,16 @@ private:
   mutable std::mutex state_update_lock_;
   mutable std::condition_variable state_update_condition_;
   std::vector<JointStateUpdateCallback> update_callbacks_;
+  std::vector<StateUpdateCallback> state_update_callbacks_;
+
+  // only accessed through std::atomic_load() and std::atomic_store(), so readers never wait for state_update_lock_
+  std::shared_ptr<const LatestState> latest_state_;
+
+  // Ring buffer of the last states, with the variable positions of state i at history_positions_[i * variable count]
+  std::vector<double> history_positions_;
+  std::vector<rclcpp::Time> history_stamps_;
+  std::size_t history_begin_ = 0;  // index of the oldest recorded state
+  std::size_t history_count_ = 0;  // number of recorded states
 
   bool use_sim_time_;
 
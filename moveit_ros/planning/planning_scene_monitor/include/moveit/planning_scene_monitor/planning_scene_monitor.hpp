@@ -46,11 +46,16 @@
 #include <moveit/planning_scene_monitor/current_state_monitor.hpp>
 #include <moveit/collision_plugin_loader/collision_plugin_loader.hpp>
 #include <moveit_msgs/srv/get_planning_scene.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <thread>
 #include <shared_mutex>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include <moveit_planning_scene_monitor_export.h>
 
@@ -58,6 +63,28 @@ namespace planning_scene_monitor
 {
 MOVEIT_CLASS_FORWARD(PlanningSceneMonitor);  // Defines PlanningSceneMonitorPtr, ConstPtr, WeakPtr... etc
 
+/** @brief A histogram of samples (e.g. durations in seconds) in buckets with exponentially growing upper bounds */
+struct MOVEIT_PLANNING_SCENE_MONITOR_EXPORT SampleHistogram
+{
+  /** @brief Buckets end at \e first_bound * \e factor^i for i < \e bucket_count - 1, the last bucket is unbounded */
+  SampleHistogram(double first_bound = 1e-5, double factor = 10.0, std::size_t bucket_count = 7);
+
+  /** @brief Add a sample to its bucket */
+  void add(double sample);
+
+  /** @brief The mean of the samples, 0 if there are none */
+  double mean() const
+  {
+    return count ? sum / static_cast<double>(count) : 0.0;
+  }
+
+  std::vector<double> bounds;          /// upper bounds of all but the last bucket
+  std::vector<std::uint64_t> buckets;  /// number of samples in each bucket
+  std::uint64_t count = 0;             /// number of samples
+  double sum = 0.0;                    /// sum of the samples
+  double max = 0.0;                    /// largest sample
+};
+
 /**
  * @brief PlanningSceneMonitor
  * Subscribes to the topic \e planning_scene */
@@ -192,6 +219,14 @@ public:
     return scene_const_;
   }
 
+  /** @brief Returns an immutable copy of the current planning scene.
+   *
+   * Unlike a LockedPlanningSceneRO, holding the snapshot does not lock the monitor, so long running readers such as
+   * planners never delay scene updates and are not delayed by them. The copy is made by the first call after a scene
+   * update and shared by all readers until the next one; it is not updated afterwards.
+   * @return The snapshot, or nullptr if the monitor has no scene */
+  planning_scene::PlanningSceneConstPtr getSceneSnapshot();
+
   /** @brief Return true if the scene \e scene can be updated directly
       or indirectly by this monitor. This function will return true if
       the pointer of the scene is the same as the one maintained,
@@ -319,6 +354,43 @@ public:
     }
   }
 
+  /** @brief Collect the messages received by the scene monitor for \e window seconds and apply them together.
+   *
+   *  The collected messages are applied under a single lock and trigger a single update event. Collision object
+   *  updates that later messages supersede are dropped, e.g. all but the last of a series of moves of an object.
+   *  @param window the coalescing window in seconds. By default this is 0, i.e. messages are applied as they arrive. */
+  void setSceneUpdateCoalescingWindow(double window);
+
+  /** @brief Get the window (seconds) in which the messages of the scene monitor are coalesced, 0 if they are not */
+  double getSceneUpdateCoalescingWindow() const
+  {
+    return dt_scene_update_coalescing_.count();
+  }
+
+  /** @brief Statistics of the work done by the monitor, to attribute latency of scene updates and their readers */
+  struct Statistics
+  {
+    SampleHistogram read_lock_wait;      /// seconds waited for shared locks of the scene
+    SampleHistogram write_lock_wait;     /// seconds waited for exclusive locks of the scene
+    SampleHistogram write_lock_hold;     /// seconds exclusive locks of the scene were held
+    SampleHistogram scene_update_apply;  /// seconds spent applying scene messages and object updates
+    SampleHistogram publish_time;        /// seconds spent computing and publishing monitored scenes
+    /// serialized bytes of the published scenes, only measured while the statistics are published
+    SampleHistogram publish_size{ 1e3, 10.0, 6 };
+    std::size_t pending_scene_updates = 0;      /// scene messages currently waiting for the coalescing window
+    std::size_t max_pending_scene_updates = 0;  /// largest number of scene messages waiting at once
+  };
+
+  /** @brief Get the statistics collected since construction or the last call to resetStatistics() */
+  Statistics getStatistics() const;
+
+  /** @brief Restart collecting statistics */
+  void resetStatistics();
+
+  /** @brief Publish the statistics of the monitor as diagnostic_msgs/DiagnosticArray on /diagnostics every \e period
+   *  seconds. Pass 0 to stop publishing, which is the default. */
+  void setStatisticsPublishingPeriod(double period);
+
   /** @brief Start the scene monitor (ROS topic-based)
    *  @param scene_topic The name of the planning scene topic
    */
@@ -465,6 +537,13 @@ protected:
   rclcpp::Time last_update_time_;                  /// Last time the state was updated
   rclcpp::Time last_robot_motion_time_;            /// Last time the robot has moved
 
+  std::atomic<std::uint64_t> scene_epoch_{ 0 };              /// incremented on every scene update
+  planning_scene::PlanningSceneConstPtr scene_snapshot_;     /// copy of the scene shared by getSceneSnapshot()
+  std::uint64_t scene_snapshot_epoch_{ 0 };                  /// value of scene_epoch_ when scene_snapshot_ was copied
+  std::mutex scene_snapshot_mutex_;                          /// mutex for scene_snapshot_
+  std::shared_ptr<const octomap::OcTree> octomap_snapshot_;  /// copy of the octomap shared by scene snapshots
+  std::uint64_t octomap_snapshot_version_{ 0 };              /// update count of the octomap when it was copied
+
   std::shared_ptr<rclcpp::Node> node_;
 
   // TODO: (anasarrak) callbacks on ROS2?
@@ -511,6 +590,18 @@ protected:
   // this is used by MoveGroup and related application nodes
   rclcpp::Service<moveit_msgs::srv::GetPlanningScene>::SharedPtr get_scene_service_;
 
+  // messages of the world objects and of the octomap, reused by the service until the underlying data changes
+  struct CachedCollisionObjectMsg
+  {
+    collision_detection::World::ObjectConstPtr object;
+    moveit_msgs::msg::CollisionObject msg;
+  };
+  std::map<std::string, CachedCollisionObjectMsg> collision_object_msg_cache_;
+  shapes::ShapeConstPtr octomap_msg_cache_shape_;  /// octree shape the cached message was serialized from
+  std::uint64_t octomap_msg_cache_update_count_{ 0 };
+  octomap_msgs::msg::Octomap octomap_msg_cache_;
+  std::mutex scene_msg_cache_mutex_;
+
   // include a octomap monitor
   std::unique_ptr<occupancy_map_monitor::OccupancyMapMonitor> octomap_monitor_;
 
@@ -536,6 +627,23 @@ protected:
                                                                          /// are received
 
 private:
+  // std::unique_lock (EXCLUSIVE) or std::shared_lock on scene_update_mutex_ that records its timing in statistics_
+  template <bool EXCLUSIVE>
+  class TimedSceneLock;
+
+  // add a sample to a histogram of statistics_
+  void recordStatistic(SampleHistogram Statistics::*histogram, double sample);
+
+  // update the number of pending scene messages in statistics_
+  void recordPendingSceneUpdates(std::size_t count);
+
+  // get an immutable copy of the monitored octree for scene snapshots, shared until the octree is updated;
+  // called with scene_snapshot_mutex_ locked
+  std::shared_ptr<const octomap::OcTree> getOctomapSnapshot(collision_detection::OccMapTree& tree);
+
+  // publish statistics_ on statistics_publisher_, called by statistics_timer_
+  void publishStatistics();
+
   void getUpdatedFrameTransforms(std::vector<geometry_msgs::msg::TransformStamped>& transforms);
 
   // publish planning scene update diffs (runs in its own thread)
@@ -550,10 +658,20 @@ private:
   // Callback for a new planning scene msg
   void newPlanningSceneCallback(const moveit_msgs::msg::PlanningScene::ConstSharedPtr& scene);
 
+  // apply the messages collected in pending_scene_updates_, called by scene_update_coalescing_timer_
+  void applyPendingSceneUpdates();
+
+  // Apply planning scene messages in order under a single lock and trigger one update event for all of them
+  bool newPlanningSceneMessages(const std::vector<const moveit_msgs::msg::PlanningScene*>& scenes);
+
   // Callback for requesting the full planning scene via service
   void getPlanningSceneServiceCallback(const moveit_msgs::srv::GetPlanningScene::Request::SharedPtr& req,
                                        const moveit_msgs::srv::GetPlanningScene::Response::SharedPtr& res);
 
+  // Fill the collision objects or the octomap of the scene from the caches of their messages, while scene is locked
+  void getCachedCollisionObjectMsgs(std::vector<moveit_msgs::msg::CollisionObject>& collision_objects);
+  void getCachedOctomapMsg(octomap_msgs::msg::OctomapWithPose& octomap);
+
   void updatePublishSettings(bool publish_geom_updates, bool publish_state_updates, bool publish_transform_updates,
                              bool publish_planning_scene, double publish_planning_scene_hz);
 
@@ -568,11 +686,40 @@ private:
   // This field is protected by state_pending_mutex_
   std::chrono::duration<double> dt_state_update_;  // 1hz
 
+  // Lock for pending_scene_updates_ and dt_scene_update_coalescing_
+  std::mutex pending_scene_updates_mutex_;
+
+  /// Planning scene messages received by the scene monitor during the current coalescing window
+  std::vector<moveit_msgs::msg::PlanningScene::ConstSharedPtr> pending_scene_updates_;
+
+  /// the window in which planning scene messages are coalesced, 0 if they are applied as they arrive
+  std::chrono::duration<double> dt_scene_update_coalescing_;
+
+  /// timer applying the coalesced planning scene messages
+  rclcpp::TimerBase::SharedPtr scene_update_coalescing_timer_;
+
+  // Lock for statistics_
+  mutable std::mutex statistics_mutex_;
+
+  /// statistics of the work done by the monitor
+  Statistics statistics_;
+
+  /// time the exclusive lock taken by lockSceneWrite() was acquired
+  std::chrono::steady_clock::time_point scene_write_locked_time_;
+
+  /// publisher of the statistics, created when they are first published, and the timer publishing them
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr statistics_publisher_;
+  rclcpp::TimerBase::SharedPtr statistics_timer_;
+  std::atomic<bool> measure_publish_size_{ false };
+
   /// the amount of time to wait when looking up transforms
   // Setting this to a non-zero value resolves issues when the sensor data is
   // arriving so fast that it is preceding the transform state.
   rclcpp::Duration shape_transform_cache_lookup_wait_time_;
 
+  /// resolution of the octomap in scene snapshots, 0 for the resolution of the monitored octomap
+  double octomap_planning_resolution_ = 0.0;
+
   /// timer for state updates.
   // Check if last_state_update_ is true and if so call updateSceneWithCurrentState()
   // Not safe to access from callback functions.
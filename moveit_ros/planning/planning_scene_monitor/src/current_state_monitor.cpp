@@ -41,6 +41,7 @@
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <limits>
 #include <memory>
@@ -63,6 +64,7 @@ CurrentStateMonitor::CurrentStateMonitor(std::unique_ptr<CurrentStateMonitor::Mi
   , logger_(moveit::getLogger("moveit.ros.current_state_monitor"))
 {
   robot_state_.setToDefaultValues();
+  updateLatestState();
 }
 
 CurrentStateMonitor::CurrentStateMonitor(const rclcpp::Node::SharedPtr& node,
@@ -79,10 +81,126 @@ CurrentStateMonitor::~CurrentStateMonitor()
 }
 
 moveit::core::RobotStatePtr CurrentStateMonitor::getCurrentState() const
+{
+  return std::make_shared<moveit::core::RobotState>(*getLatestState());
+}
+
+moveit::core::RobotStateConstPtr CurrentStateMonitor::getLatestState() const
+{
+  const std::shared_ptr<const LatestState> latest_state = std::atomic_load(&latest_state_);
+  return moveit::core::RobotStateConstPtr(latest_state, &latest_state->state);
+}
+
+std::pair<moveit::core::RobotStateConstPtr, rclcpp::Time> CurrentStateMonitor::getLatestStateAndTime() const
+{
+  const std::shared_ptr<const LatestState> latest_state = std::atomic_load(&latest_state_);
+  return std::make_pair(moveit::core::RobotStateConstPtr(latest_state, &latest_state->state), latest_state->stamp);
+}
+
+void CurrentStateMonitor::updateLatestState()
+{
+  std::shared_ptr<LatestState> latest_state(new LatestState{ robot_state_, current_state_time_ });
+  latest_state->state.update();
+  std::atomic_store(&latest_state_, std::shared_ptr<const LatestState>(std::move(latest_state)));
+}
+
+void CurrentStateMonitor::setStateHistorySize(std::size_t size)
 {
   std::unique_lock<std::mutex> slock(state_update_lock_);
-  moveit::core::RobotState* result = new moveit::core::RobotState(robot_state_);
-  return moveit::core::RobotStatePtr(result);
+  history_positions_.assign(size * robot_model_->getVariableCount(), 0.0);
+  history_stamps_.assign(size, rclcpp::Time(0, 0, RCL_ROS_TIME));
+  history_begin_ = 0;
+  history_count_ = 0;
+}
+
+std::size_t CurrentStateMonitor::getStateHistorySize() const
+{
+  std::unique_lock<std::mutex> slock(state_update_lock_);
+  return history_stamps_.size();
+}
+
+void CurrentStateMonitor::updateStateHistory()
+{
+  const std::size_t capacity = history_stamps_.size();
+  if (capacity == 0)
+    return;
+
+  std::size_t index = (history_begin_ + history_count_ + capacity - 1) % capacity;  // newest recorded state
+  if (history_count_ == 0 || current_state_time_ > history_stamps_[index])
+  {
+    if (history_count_ < capacity)
+    {
+      index = (history_begin_ + history_count_) % capacity;
+      ++history_count_;
+    }
+    else
+    {
+      index = history_begin_;
+      history_begin_ = (history_begin_ + 1) % capacity;
+    }
+    history_stamps_[index] = current_state_time_;
+  }
+  // else: partial joint states may arrive with the same or older stamps,
+  // they update the newest recorded state to keep the history in time order
+
+  const std::size_t variable_count = robot_model_->getVariableCount();
+  std::copy_n(robot_state_.getVariablePositions(), variable_count,
+              history_positions_.begin() + index * variable_count);
+}
+
+bool CurrentStateMonitor::getStateAtTime(const rclcpp::Time& t, moveit::core::RobotState& state) const
+{
+  std::unique_lock<std::mutex> slock(state_update_lock_);
+  const std::size_t capacity = history_stamps_.size();
+  if (history_count_ == 0 || t < history_stamps_[history_begin_])
+    return false;
+
+  const std::size_t variable_count = robot_model_->getVariableCount();
+  const auto stamp = [&](std::size_t i) -> const rclcpp::Time& {
+    return history_stamps_[(history_begin_ + i) % capacity];
+  };
+  const auto positions = [&](std::size_t i) {
+    return history_positions_.data() + ((history_begin_ + i) % capacity) * variable_count;
+  };
+
+  // find the first recorded state after t
+  std::size_t low = 1;
+  std::size_t high = history_count_;
+  while (low < high)
+  {
+    const std::size_t mid = (low + high) / 2;
+    if (stamp(mid) <= t)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  if (low == history_count_)
+  {
+    // the state did not change between the newest recorded state and the latest update
+    if (t > current_state_time_)
+      return false;
+    state.setVariablePositions(positions(low - 1));
+    return true;
+  }
+
+  const double fraction = (t - stamp(low - 1)).seconds() / (stamp(low) - stamp(low - 1)).seconds();
+  std::vector<double> interpolated(variable_count);
+  robot_model_->interpolate(positions(low - 1), positions(low), fraction, interpolated.data());
+  state.setVariablePositions(interpolated.data());
+  return true;
+}
+
+void CurrentStateMonitor::callUpdateCallbacks(const sensor_msgs::msg::JointState::ConstSharedPtr& joint_state)
+{
+  for (JointStateUpdateCallback& update_callback : update_callbacks_)
+    update_callback(joint_state);
+  if (!state_update_callbacks_.empty())
+  {
+    const auto [state, stamp] = getLatestStateAndTime();
+    for (StateUpdateCallback& state_update_callback : state_update_callbacks_)
+      state_update_callback(state, stamp);
+  }
 }
 
 rclcpp::Time CurrentStateMonitor::getCurrentStateTime() const
@@ -140,9 +258,16 @@ void CurrentStateMonitor::addUpdateCallback(const JointStateUpdateCallback& fn)
     update_callbacks_.push_back(fn);
 }
 
+void CurrentStateMonitor::addStateUpdateCallback(const StateUpdateCallback& fn)
+{
+  if (fn)
+    state_update_callbacks_.push_back(fn);
+}
+
 void CurrentStateMonitor::clearUpdateCallbacks()
 {
   update_callbacks_.clear();
+  state_update_callbacks_.clear();
 }
 
 void CurrentStateMonitor::startStateMonitor(const std::string& joint_states_topic)
@@ -339,17 +464,28 @@ void CurrentStateMonitor::jointStateCallback(const sensor_msgs::msg::JointState:
     // read the received values, and update their time stamps
     std::size_t n = joint_state->name.size();
     current_state_time_ = joint_state->header.stamp;
-    for (std::size_t i = 0; i < n; ++i)
+    if (joint_state->name != joint_state_names_)
     {
-      // Skip joints that don't belong to the RobotModel
-      if (!robot_model_->hasJointModel(joint_state->name[i]))
+      joint_state_names_ = joint_state->name;
+      joint_state_joints_.clear();
+      joint_state_joints_.reserve(n);
+      const moveit::core::NameIndexTable& joint_table = robot_model_->getJointIndexTable();
+      for (const std::string& name : joint_state_names_)
       {
-        continue;
+        // Skip joints that don't belong to the RobotModel
+        const int index = joint_table.find(name);
+        const moveit::core::JointModel* jm = index >= 0 ? robot_model_->getJointModel(index) : nullptr;
+        // ignore fixed joints, multi-dof joints (they should not even be in the message)
+        if (jm && jm->getVariableCount() != 1)
+          jm = nullptr;
+        joint_state_joints_.push_back(jm);
       }
+    }
 
-      const moveit::core::JointModel* jm = robot_model_->getJointModel(joint_state->name[i]);
-      // ignore fixed joints, multi-dof joints (they should not even be in the message)
-      if (jm->getVariableCount() != 1)
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const moveit::core::JointModel* jm = joint_state_joints_[i];
+      if (!jm)
         continue;
 
       joint_time_.insert_or_assign(jm, joint_state->header.stamp);
@@ -401,14 +537,17 @@ void CurrentStateMonitor::jointStateCallback(const sensor_msgs::msg::JointState:
         }
       }
     }
+
+    if (update)
+    {
+      updateLatestState();
+      updateStateHistory();
+    }
   }
 
   // callbacks, if needed
   if (update)
-  {
-    for (JointStateUpdateCallback& update_callback : update_callbacks_)
-      update_callback(joint_state);
-  }
+    callUpdateCallbacks(joint_state);
 
   // notify waitForCurrentState() *after* potential update callbacks
   state_update_condition_.notify_all();
@@ -474,6 +613,12 @@ void CurrentStateMonitor::updateMultiDofJoints()
       robot_state_.setJointPositions(joint, new_values.data());
       update = true;
     }
+
+    if (update)
+    {
+      updateLatestState();
+      updateStateHistory();
+    }
   }
 
   // callbacks, if needed
@@ -481,9 +626,7 @@ void CurrentStateMonitor::updateMultiDofJoints()
   {
     // stub joint state: multi-dof joints are not modelled in the message,
     // but we should still trigger the update callbacks
-    auto joint_state = std::make_shared<sensor_msgs::msg::JointState>();
-    for (JointStateUpdateCallback& update_callback : update_callbacks_)
-      update_callback(joint_state);
+    callUpdateCallbacks(std::make_shared<sensor_msgs::msg::JointState>());
   }
 
   if (update)
@@ -39,6 +39,7 @@
 #include <moveit/utils/message_checks.hpp>
 #include <moveit/exceptions/exceptions.hpp>
 #include <moveit_msgs/srv/get_planning_scene.hpp>
+#include <octomap_msgs/conversions.h>
 #include <moveit/utils/logger.hpp>
 
 // TODO: Remove conditional includes when released to all active distros.
@@ -56,9 +57,13 @@
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+#include <list>
 #include <memory>
 
 #include <std_msgs/msg/string.hpp>
+#include <rclcpp/serialization.hpp>
 
 #include <chrono>
 using namespace std::chrono_literals;
@@ -73,6 +78,73 @@ const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_TOPIC = "planning
 const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_SERVICE = "get_planning_scene";
 const std::string PlanningSceneMonitor::MONITORED_PLANNING_SCENE_TOPIC = "monitored_planning_scene";
 
+SampleHistogram::SampleHistogram(double first_bound, double factor, std::size_t bucket_count)
+  : buckets(std::max<std::size_t>(bucket_count, 1), 0)
+{
+  for (std::size_t i = 0; i + 1 < buckets.size(); ++i)
+    bounds.push_back(first_bound * std::pow(factor, static_cast<double>(i)));
+}
+
+void SampleHistogram::add(double sample)
+{
+  const auto bucket = std::lower_bound(bounds.begin(), bounds.end(), sample) - bounds.begin();
+  ++buckets[bucket];
+  ++count;
+  sum += sample;
+  max = std::max(max, sample);
+}
+
+template <bool EXCLUSIVE>
+class PlanningSceneMonitor::TimedSceneLock
+{
+public:
+  explicit TimedSceneLock(PlanningSceneMonitor& monitor) : monitor_(monitor)
+  {
+    lock();
+  }
+
+  ~TimedSceneLock()
+  {
+    if (locked_)
+      unlock();
+  }
+
+  TimedSceneLock(const TimedSceneLock&) = delete;
+  TimedSceneLock& operator=(const TimedSceneLock&) = delete;
+
+  // lock() and unlock() make this usable with new_scene_update_condition_
+  void lock()
+  {
+    const auto start = std::chrono::steady_clock::now();
+    if constexpr (EXCLUSIVE)
+      monitor_.scene_update_mutex_.lock();
+    else
+      monitor_.scene_update_mutex_.lock_shared();
+    locked_ = true;
+    locked_time_ = std::chrono::steady_clock::now();
+    monitor_.recordStatistic(EXCLUSIVE ? &Statistics::write_lock_wait : &Statistics::read_lock_wait,
+                             std::chrono::duration<double>(locked_time_ - start).count());
+  }
+
+  void unlock()
+  {
+    const auto hold = std::chrono::duration<double>(std::chrono::steady_clock::now() - locked_time_).count();
+    locked_ = false;
+    if constexpr (EXCLUSIVE)
+    {
+      monitor_.scene_update_mutex_.unlock();
+      monitor_.recordStatistic(&Statistics::write_lock_hold, hold);
+    }
+    else
+      monitor_.scene_update_mutex_.unlock_shared();
+  }
+
+private:
+  PlanningSceneMonitor& monitor_;
+  bool locked_ = false;
+  std::chrono::steady_clock::time_point locked_time_;
+};
+
 PlanningSceneMonitor::PlanningSceneMonitor(const rclcpp::Node::SharedPtr& node, const std::string& robot_description,
                                            const std::string& name)
   : PlanningSceneMonitor(node, planning_scene::PlanningScenePtr(), robot_description, name)
@@ -103,6 +175,7 @@ PlanningSceneMonitor::PlanningSceneMonitor(const rclcpp::Node::SharedPtr& node,
   , private_executor_(std::make_shared<rclcpp::executors::SingleThreadedExecutor>())
   , tf_buffer_(std::make_shared<tf2_ros::Buffer>(node->get_clock()))
   , dt_state_update_(0.0)
+  , dt_scene_update_coalescing_(0.0)
   , shape_transform_cache_lookup_wait_time_(0, 0)
   , rm_loader_(rm_loader)
   , logger_(moveit::getLogger("moveit.ros.planning_scene_monitor"))
@@ -135,6 +208,7 @@ PlanningSceneMonitor::~PlanningSceneMonitor()
     scene_->setAttachedBodyUpdateCallback(moveit::core::AttachedBodyCallback());
   }
   stopPublishingPlanningScene();
+  setStatisticsPublishingPeriod(0.0);
   stopStateMonitor();
   stopWorldGeometryMonitor();
   stopSceneMonitor();
@@ -223,6 +297,12 @@ void PlanningSceneMonitor::initialize(const planning_scene::PlanningScenePtr& sc
 
   shape_transform_cache_lookup_wait_time_ = rclcpp::Duration::from_seconds(temp_wait_time);
 
+  if (!robot_description_.empty())
+  {
+    node_->get_parameter_or(robot_description_ + "_planning.octomap_planning_resolution", octomap_planning_resolution_,
+                            0.0);
+  }
+
   state_update_pending_ = false;
   // Period for 0.1 sec
   using std::chrono::nanoseconds;
@@ -364,7 +444,7 @@ void PlanningSceneMonitor::monitorDiffs(bool flag)
   {
     if (flag)
     {
-      std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+      TimedSceneLock<true> ulock(*this);
       if (scene_)
       {
         scene_->setAttachedBodyUpdateCallback(moveit::core::AttachedBodyCallback());
@@ -390,7 +470,7 @@ void PlanningSceneMonitor::monitorDiffs(bool flag)
         stopPublishingPlanningScene();
       }
       {
-        std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+        TimedSceneLock<true> ulock(*this);
         if (scene_)
         {
           scene_->decoupleParent();
@@ -468,10 +548,12 @@ void PlanningSceneMonitor::scenePublishingThread()
     bool publish_msg = false;
     bool is_full = false;
     rclcpp::Rate rate(publish_planning_scene_frequency_);
+    std::chrono::steady_clock::time_point publish_start;
     {
-      std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+      TimedSceneLock<true> ulock(*this);
       while (new_scene_update_ == UPDATE_NONE && publish_planning_scene_)
         new_scene_update_condition_.wait(ulock);
+      publish_start = std::chrono::steady_clock::now();
       if (new_scene_update_ != UPDATE_NONE)
       {
         if ((publish_update_types_ & new_scene_update_) || new_scene_update_ == UPDATE_SCENE)
@@ -528,7 +610,15 @@ void PlanningSceneMonitor::scenePublishingThread()
     }
     if (publish_msg)
     {
+      if (measure_publish_size_)
+      {
+        rclcpp::SerializedMessage serialized_msg;
+        rclcpp::Serialization<moveit_msgs::msg::PlanningScene>().serialize_message(&msg, &serialized_msg);
+        recordStatistic(&Statistics::publish_size, static_cast<double>(serialized_msg.size()));
+      }
       planning_scene_publisher_->publish(msg);
+      recordStatistic(&Statistics::publish_time,
+                      std::chrono::duration<double>(std::chrono::steady_clock::now() - publish_start).count());
       if (is_full)
         RCLCPP_DEBUG(logger_, "Published full planning scene: '%s'", msg.name.c_str());
       rate.sleep();
@@ -569,6 +659,133 @@ bool sceneIsParentOf(const planning_scene::PlanningSceneConstPtr& scene,
     return sceneIsParentOf(scene->getParent(), possible_parent);
   return false;
 }
+
+// Determine the kind of update a planning scene message applies to a scene named old_scene_name
+int getSceneUpdateType(const moveit_msgs::msg::PlanningScene& scene, const std::string& old_scene_name)
+{
+  using SceneUpdateType = PlanningSceneMonitor::SceneUpdateType;
+  if (!scene.is_diff)
+    return SceneUpdateType::UPDATE_SCENE;
+
+  // if we have a diff, try to more accurately determine the update type
+  bool no_other_scene_upd = (scene.name.empty() || scene.name == old_scene_name) &&
+                            scene.allowed_collision_matrix.entry_names.empty() && scene.link_padding.empty() &&
+                            scene.link_scale.empty();
+  if (!no_other_scene_upd)
+    return SceneUpdateType::UPDATE_SCENE;
+
+  int upd = SceneUpdateType::UPDATE_NONE;
+  if (!moveit::core::isEmpty(scene.world))
+    upd |= SceneUpdateType::UPDATE_GEOMETRY;
+
+  if (!scene.fixed_frame_transforms.empty())
+    upd |= SceneUpdateType::UPDATE_TRANSFORMS;
+
+  if (!moveit::core::isEmpty(scene.robot_state))
+  {
+    upd |= SceneUpdateType::UPDATE_STATE;
+    if (!scene.robot_state.attached_collision_objects.empty() || !scene.robot_state.is_diff)
+      upd |= SceneUpdateType::UPDATE_GEOMETRY;
+  }
+  return upd;
+}
+
+// Drop the messages and collision object updates of a sequence of planning scene messages
+// that are made obsolete by later messages of the same sequence.
+// Messages that had collision objects removed are copied into filtered_scenes.
+std::vector<const moveit_msgs::msg::PlanningScene*>
+coalescePlanningSceneMessages(const std::vector<moveit_msgs::msg::PlanningScene::ConstSharedPtr>& scenes,
+                              std::list<moveit_msgs::msg::PlanningScene>& filtered_scenes)
+{
+  using moveit_msgs::msg::CollisionObject;
+
+  // a full scene, which also replaces the robot state, makes all earlier messages obsolete
+  std::size_t first = 0;
+  for (std::size_t i = scenes.size(); i > 0; --i)
+  {
+    if (!scenes[i - 1]->is_diff && !scenes[i - 1]->robot_state.is_diff)
+    {
+      first = i - 1;
+      break;
+    }
+  }
+
+  // how far the updates of an object are superseded by the later messages
+  enum Superseded
+  {
+    BY_MOVE,  // object poses are overwritten by a later move
+    ALL       // the object is replaced or removed later
+  };
+  std::map<std::string, Superseded> superseded;
+  bool all_superseded = false;  // all world objects are removed later
+
+  std::vector<const moveit_msgs::msg::PlanningScene*> result(scenes.size() - first);
+  for (std::size_t i = scenes.size(); i > first; --i)
+  {
+    const moveit_msgs::msg::PlanningScene& scene = *scenes[i - 1];
+    std::vector<bool> keep(scene.world.collision_objects.size(), true);
+    bool dropped = false;
+    if (scene.is_diff)
+    {
+      for (std::size_t j = scene.world.collision_objects.size(); j > 0; --j)
+      {
+        const CollisionObject& object = scene.world.collision_objects[j - 1];
+        const auto it = superseded.find(object.id);
+        if (all_superseded ||
+            (it != superseded.end() && (it->second == ALL || object.operation == CollisionObject::MOVE)))
+        {
+          keep[j - 1] = false;
+          dropped = true;
+          continue;
+        }
+
+        if (object.operation == CollisionObject::REMOVE && object.id.empty())
+          all_superseded = true;
+        else if (object.operation == CollisionObject::ADD || object.operation == CollisionObject::REMOVE)
+          superseded[object.id] = ALL;
+        else if (object.operation == CollisionObject::MOVE)
+          superseded[object.id] = BY_MOVE;
+        else
+          superseded.erase(object.id);
+      }
+    }
+
+    // a full scene replaces the world of the earlier messages
+    if (!scene.is_diff)
+    {
+      superseded.clear();
+      all_superseded = true;
+    }
+
+    // the robot state is applied before the world, so attaching or detaching objects
+    // makes the updates of earlier messages relevant again
+    if (!scene.robot_state.is_diff)
+    {
+      superseded.clear();
+      all_superseded = false;
+    }
+    for (const auto& attached_object : scene.robot_state.attached_collision_objects)
+    {
+      superseded.erase(attached_object.object.id);
+      all_superseded = false;
+    }
+
+    if (dropped)
+    {
+      moveit_msgs::msg::PlanningScene& filtered_scene = filtered_scenes.emplace_back(scene);
+      filtered_scene.world.collision_objects.clear();
+      for (std::size_t j = 0; j < keep.size(); ++j)
+      {
+        if (keep[j])
+          filtered_scene.world.collision_objects.push_back(scene.world.collision_objects[j]);
+      }
+      result[i - 1 - first] = &filtered_scene;
+    }
+    else
+      result[i - 1 - first] = &scene;
+  }
+  return result;
+}
 }  // namespace
 
 bool PlanningSceneMonitor::updatesScene(const planning_scene::PlanningScenePtr& scene) const
@@ -581,8 +798,65 @@ bool PlanningSceneMonitor::updatesScene(const planning_scene::PlanningSceneConst
   return sceneIsParentOf(scene_const_, scene.get());
 }
 
+planning_scene::PlanningSceneConstPtr PlanningSceneMonitor::getSceneSnapshot()
+{
+  std::scoped_lock slock(scene_snapshot_mutex_);
+  if (scene_snapshot_ && scene_snapshot_epoch_ == scene_epoch_)
+    return scene_snapshot_;
+
+  planning_scene::PlanningScenePtr snapshot;
+  lockSceneRead();
+  try
+  {
+    // an update that races the copy bumps the epoch afterwards, so the next call copies the scene again
+    const std::uint64_t epoch = scene_epoch_;
+    if (scene_)
+    {
+      snapshot = planning_scene::PlanningScene::clone(scene_);
+
+      // the occupancy map monitor updates its octree in place, so the snapshot needs its own copy; a compact one of
+      // the occupied cells at the planning resolution is enough for collision checking
+      collision_detection::World::ObjectConstPtr map =
+          snapshot->getWorld()->getObject(planning_scene::PlanningScene::OCTOMAP_NS);
+      if (octomap_monitor_ && map && map->shapes_.size() == 1)
+      {
+        const shapes::OcTree* octree = static_cast<const shapes::OcTree*>(map->shapes_[0].get());
+        const collision_detection::OccMapTreePtr& tree = octomap_monitor_->getOcTreePtr();
+        if (octree->octree == tree)
+          snapshot->processOctomapPtr(getOctomapSnapshot(*tree), map->shape_poses_[0]);
+      }
+    }
+    scene_snapshot_epoch_ = epoch;
+    unlockSceneRead();
+  }
+  catch (...)
+  {
+    unlockSceneRead();
+    throw;
+  }
+  scene_snapshot_ = snapshot;
+  return scene_snapshot_;
+}
+
+std::shared_ptr<const octomap::OcTree> PlanningSceneMonitor::getOctomapSnapshot(collision_detection::OccMapTree& tree)
+{
+  // snapshots after state or object updates share the copy of an unchanged octree; the update count is read before
+  // copying, such that a racing update at worst causes another copy with the next snapshot
+  collision_detection::OccMapTree::ReadLock lock = tree.reading();
+  const std::uint64_t version = tree.getUpdateCount();
+  if (!octomap_snapshot_ || octomap_snapshot_version_ != version)
+  {
+    octomap_snapshot_ = collision_detection::createPlanningOcTree(tree, octomap_planning_resolution_);
+    octomap_snapshot_version_ = version;
+  }
+  return octomap_snapshot_;
+}
+
 void PlanningSceneMonitor::triggerSceneUpdateEvent(SceneUpdateType update_type)
 {
+  if (update_type != UPDATE_NONE)
+    ++scene_epoch_;
+
   // do not modify update functions while we are calling them
   std::scoped_lock lock(update_lock_);
 
@@ -654,11 +928,92 @@ void PlanningSceneMonitor::getPlanningSceneServiceCallback(
   if (req->components.components & moveit_msgs::msg::PlanningSceneComponents::TRANSFORMS)
     updateFrameTransforms();
 
-  moveit_msgs::msg::PlanningSceneComponents all_components;
-  all_components.components = UINT_MAX;  // Return all scene components if nothing is specified.
+  // Return all scene components if nothing is specified.
+  const std::uint32_t components = req->components.components ? req->components.components : UINT_MAX;
+  const bool geometry = components & moveit_msgs::msg::PlanningSceneComponents::WORLD_OBJECT_GEOMETRY;
+  const bool octomap = components & moveit_msgs::msg::PlanningSceneComponents::OCTOMAP;
+
+  // serializing meshes and the octomap dominates the cost of the service, so their messages are cached
+  moveit_msgs::msg::PlanningSceneComponents uncached_components;
+  uncached_components.components = components & ~moveit_msgs::msg::PlanningSceneComponents::WORLD_OBJECT_GEOMETRY &
+                                   ~moveit_msgs::msg::PlanningSceneComponents::OCTOMAP;
+  if (geometry)
+    uncached_components.components &= ~moveit_msgs::msg::PlanningSceneComponents::WORLD_OBJECT_NAMES;
+
+  TimedSceneLock<true> ulock(*this);
+  scene_->getPlanningSceneMsg(res->scene, uncached_components);
+  std::scoped_lock lock(scene_msg_cache_mutex_);
+  if (geometry)
+    getCachedCollisionObjectMsgs(res->scene.world.collision_objects);
+  if (octomap)
+    getCachedOctomapMsg(res->scene.world.octomap);
+}
 
-  std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
-  scene_->getPlanningSceneMsg(res->scene, req->components.components ? req->components : all_components);
+void PlanningSceneMonitor::getCachedCollisionObjectMsgs(
+    std::vector<moveit_msgs::msg::CollisionObject>& collision_objects)
+{
+  // the world copies an object before modifying it if the object is shared, which the cache does by holding it, so
+  // a cached message is up to date as long as the world still contains the same object
+  const collision_detection::WorldConstPtr& world = scene_->getWorld();
+  std::map<std::string, CachedCollisionObjectMsg> cache;
+  collision_objects.clear();
+  collision_objects.reserve(world->size());
+  for (const auto& [id, object] : *world)
+  {
+    if (id == planning_scene::PlanningScene::OCTOMAP_NS)
+      continue;
+    CachedCollisionObjectMsg& entry = cache[id];
+    const auto cached = collision_object_msg_cache_.find(id);
+    if (cached != collision_object_msg_cache_.end() && cached->second.object == object)
+      entry = std::move(cached->second);
+    else
+    {
+      entry.object = object;
+      scene_->getCollisionObjectMsg(entry.msg, id);
+    }
+    collision_objects.push_back(entry.msg);
+
+    // object types are stored by the scene, they change independently of the object
+    moveit_msgs::msg::CollisionObject& collision_object = collision_objects.back();
+    if ((!collision_object.primitives.empty() || !collision_object.meshes.empty() ||
+         !collision_object.planes.empty()) &&
+        scene_->hasObjectType(id))
+      collision_object.type = scene_->getObjectType(id);
+  }
+  collision_object_msg_cache_.swap(cache);
+}
+
+void PlanningSceneMonitor::getCachedOctomapMsg(octomap_msgs::msg::OctomapWithPose& octomap)
+{
+  const collision_detection::World::ObjectConstPtr map =
+      scene_->getWorld()->getObject(planning_scene::PlanningScene::OCTOMAP_NS);
+  if (!map || map->shapes_.size() != 1)
+  {
+    octomap_msg_cache_shape_.reset();
+    scene_->getOctomapMsg(octomap);
+    return;
+  }
+
+  // the occupancy map monitor updates its octree in place, other octrees are replaced by a new shape on every change
+  const shapes::OcTree* octree = static_cast<const shapes::OcTree*>(map->shapes_[0].get());
+  collision_detection::OccMapTree::ReadLock tree_lock;
+  std::uint64_t update_count = 0;
+  if (octomap_monitor_ && octree->octree == octomap_monitor_->getOcTreePtr())
+  {
+    const collision_detection::OccMapTreePtr& tree = octomap_monitor_->getOcTreePtr();
+    tree_lock = tree->reading();
+    update_count = tree->getUpdateCount();
+  }
+  if (octomap_msg_cache_shape_ != map->shapes_[0] || octomap_msg_cache_update_count_ != update_count)
+  {
+    octomap_msg_cache_ = octomap_msgs::msg::Octomap();
+    octomap_msgs::fullMapToMsg(*octree->octree, octomap_msg_cache_);
+    octomap_msg_cache_shape_ = map->shapes_[0];
+    octomap_msg_cache_update_count_ = update_count;
+  }
+  octomap.header.frame_id = scene_->getPlanningFrame();
+  octomap.octomap = octomap_msg_cache_;
+  octomap.origin = tf2::toMsg(map->shape_poses_[0]);
 }
 
 void PlanningSceneMonitor::updatePublishSettings(bool publish_geom_updates, bool publish_state_updates,
@@ -692,14 +1047,151 @@ void PlanningSceneMonitor::updatePublishSettings(bool publish_geom_updates, bool
 
 void PlanningSceneMonitor::newPlanningSceneCallback(const moveit_msgs::msg::PlanningScene::ConstSharedPtr& scene)
 {
+  {
+    std::scoped_lock lock(pending_scene_updates_mutex_);
+    if (dt_scene_update_coalescing_.count() > 0.0)
+    {
+      pending_scene_updates_.push_back(scene);
+      recordPendingSceneUpdates(pending_scene_updates_.size());
+      return;
+    }
+  }
   newPlanningSceneMessage(*scene);
 }
 
+void PlanningSceneMonitor::applyPendingSceneUpdates()
+{
+  // keep the lock while applying, so that the messages of consecutive windows are applied in order
+  std::scoped_lock lock(pending_scene_updates_mutex_);
+  if (pending_scene_updates_.empty())
+    return;
+
+  std::list<moveit_msgs::msg::PlanningScene> filtered_scenes;
+  newPlanningSceneMessages(coalescePlanningSceneMessages(pending_scene_updates_, filtered_scenes));
+  pending_scene_updates_.clear();
+  recordPendingSceneUpdates(0);
+}
+
+void PlanningSceneMonitor::setSceneUpdateCoalescingWindow(double window)
+{
+  if (scene_update_coalescing_timer_)
+  {
+    scene_update_coalescing_timer_->cancel();
+    scene_update_coalescing_timer_.reset();
+  }
+  {
+    std::scoped_lock lock(pending_scene_updates_mutex_);
+    dt_scene_update_coalescing_ = std::chrono::duration<double>(std::max(window, 0.0));
+  }
+
+  // the messages collected so far are not held back by the new window
+  applyPendingSceneUpdates();
+  if (dt_scene_update_coalescing_.count() > 0.0)
+  {
+    scene_update_coalescing_timer_ =
+        pnode_->create_wall_timer(dt_scene_update_coalescing_, [this]() { applyPendingSceneUpdates(); });
+  }
+  RCLCPP_INFO(logger_, "Coalescing planning scene updates over %lf seconds", dt_scene_update_coalescing_.count());
+}
+
+PlanningSceneMonitor::Statistics PlanningSceneMonitor::getStatistics() const
+{
+  std::scoped_lock lock(statistics_mutex_);
+  return statistics_;
+}
+
+void PlanningSceneMonitor::resetStatistics()
+{
+  std::scoped_lock lock(statistics_mutex_);
+  const std::size_t pending_scene_updates = statistics_.pending_scene_updates;
+  statistics_ = Statistics();
+  statistics_.pending_scene_updates = statistics_.max_pending_scene_updates = pending_scene_updates;
+}
+
+void PlanningSceneMonitor::recordStatistic(SampleHistogram Statistics::*histogram, double sample)
+{
+  std::scoped_lock lock(statistics_mutex_);
+  (statistics_.*histogram).add(sample);
+}
+
+void PlanningSceneMonitor::recordPendingSceneUpdates(std::size_t count)
+{
+  std::scoped_lock lock(statistics_mutex_);
+  statistics_.pending_scene_updates = count;
+  statistics_.max_pending_scene_updates = std::max(statistics_.max_pending_scene_updates, count);
+}
+
+void PlanningSceneMonitor::setStatisticsPublishingPeriod(double period)
+{
+  if (statistics_timer_)
+  {
+    statistics_timer_->cancel();
+    statistics_timer_.reset();
+  }
+  if (period <= 0.0)
+  {
+    measure_publish_size_ = false;
+    return;
+  }
+
+  if (!statistics_publisher_)
+    statistics_publisher_ = pnode_->create_publisher<diagnostic_msgs::msg::DiagnosticArray>("/diagnostics", 1);
+  measure_publish_size_ = true;
+  statistics_timer_ =
+      pnode_->create_wall_timer(std::chrono::duration<double>(period), [this]() { publishStatistics(); });
+  RCLCPP_INFO(logger_, "Publishing scene monitor statistics every %lf seconds", period);
+}
+
+void PlanningSceneMonitor::publishStatistics()
+{
+  const Statistics statistics = getStatistics();
+
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = "PlanningSceneMonitor: " + monitor_name_;
+  status.hardware_id = node_->get_fully_qualified_name();
+  status.message = fmt::format("{} scene messages pending, max write lock wait {:.3f} s",
+                               statistics.pending_scene_updates, statistics.write_lock_wait.max);
+
+  const auto add_value = [&status](const std::string& key, const std::string& value) {
+    diagnostic_msgs::msg::KeyValue key_value;
+    key_value.key = key;
+    key_value.value = value;
+    status.values.push_back(key_value);
+  };
+  const auto add_histogram = [&add_value](const std::string& name, const SampleHistogram& histogram) {
+    add_value(name + " count", std::to_string(histogram.count));
+    add_value(name + " mean", fmt::format("{:g}", histogram.mean()));
+    add_value(name + " max", fmt::format("{:g}", histogram.max));
+    // bucket counts, each labeled with its upper bound
+    std::string buckets;
+    for (std::size_t i = 0; i < histogram.buckets.size(); ++i)
+    {
+      const std::string bound = i < histogram.bounds.size() ? fmt::format("{:g}", histogram.bounds[i]) : "inf";
+      buckets += fmt::format("{}{}: {}", buckets.empty() ? "" : ", ", bound, histogram.buckets[i]);
+    }
+    add_value(name + " histogram", buckets);
+  };
+  add_histogram("read lock wait [s]", statistics.read_lock_wait);
+  add_histogram("write lock wait [s]", statistics.write_lock_wait);
+  add_histogram("write lock hold [s]", statistics.write_lock_hold);
+  add_histogram("scene update apply [s]", statistics.scene_update_apply);
+  add_histogram("publish time [s]", statistics.publish_time);
+  add_histogram("publish size [bytes]", statistics.publish_size);
+  add_value("pending scene updates", std::to_string(statistics.pending_scene_updates));
+  add_value("max pending scene updates", std::to_string(statistics.max_pending_scene_updates));
+
+  diagnostic_msgs::msg::DiagnosticArray msg;
+  msg.header.stamp = node_->get_clock()->now();
+  msg.status.push_back(status);
+  statistics_publisher_->publish(msg);
+}
+
 void PlanningSceneMonitor::clearOctomap()
 {
   bool removed = false;
   {
-    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    TimedSceneLock<true> ulock(*this);
     removed = scene_->getWorldNonConst()->removeObject(scene_->OCTOMAP_NS);
 
     if (octomap_monitor_)
@@ -719,50 +1211,60 @@ void PlanningSceneMonitor::clearOctomap()
 }
 
 bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::PlanningScene& scene)
+{
+  return newPlanningSceneMessages({ &scene });
+}
+
+bool PlanningSceneMonitor::newPlanningSceneMessages(const std::vector<const moveit_msgs::msg::PlanningScene*>& scenes)
 {
   if (!scene_)
     return false;
 
-  bool result;
+  bool result = true;
 
-  SceneUpdateType upd = UPDATE_SCENE;
-  std::string old_scene_name;
+  int upd = UPDATE_NONE;
   {
-    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    TimedSceneLock<true> ulock(*this);
     // we don't want the transform cache to update while we are potentially changing attached bodies
     std::scoped_lock prevent_shape_cache_updates(shape_handles_lock_);
+    const auto apply_start = std::chrono::steady_clock::now();
 
-    last_update_time_ = rclcpp::Clock().now();
-    last_robot_motion_time_ = scene.robot_state.joint_state.header.stamp;
-    RCLCPP_DEBUG(logger_, "scene update %f robot stamp: %f", fmod(last_update_time_.seconds(), 10.),
-                 fmod(last_robot_motion_time_.seconds(), 10.));
-    old_scene_name = scene_->getName();
-
-    if (!scene.is_diff && parent_scene_)
+    for (const moveit_msgs::msg::PlanningScene* scene_msg : scenes)
     {
-      // If there is no new robot_state, transfer RobotState from current scene to parent scene
-      if (scene.robot_state.is_diff)
-        parent_scene_->setCurrentState(scene_->getCurrentState());
-      // clear maintained (diff) scene_ and set the full new scene in parent_scene_ instead
-      scene_->clearDiffs();
-      result = parent_scene_->setPlanningSceneMsg(scene);
-      // There were no callbacks for individual object changes, so rebuild the octree masks
-      excludeAttachedBodiesFromOctree();
-      excludeWorldObjectsFromOctree();
-    }
-    else
-    {
-      result = scene_->usePlanningSceneMsg(scene);
-    }
+      const moveit_msgs::msg::PlanningScene& scene = *scene_msg;
+      last_update_time_ = rclcpp::Clock().now();
+      last_robot_motion_time_ = scene.robot_state.joint_state.header.stamp;
+      RCLCPP_DEBUG(logger_, "scene update %f robot stamp: %f", fmod(last_update_time_.seconds(), 10.),
+                   fmod(last_robot_motion_time_.seconds(), 10.));
+      const std::string old_scene_name = scene_->getName();
 
-    if (octomap_monitor_)
-    {
-      if (!scene.is_diff && scene.world.octomap.octomap.data.empty())
+      if (!scene.is_diff && parent_scene_)
       {
-        octomap_monitor_->getOcTreePtr()->lockWrite();
-        octomap_monitor_->getOcTreePtr()->clear();
-        octomap_monitor_->getOcTreePtr()->unlockWrite();
+        // If there is no new robot_state, transfer RobotState from current scene to parent scene
+        if (scene.robot_state.is_diff)
+          parent_scene_->setCurrentState(scene_->getCurrentState());
+        // clear maintained (diff) scene_ and set the full new scene in parent_scene_ instead
+        scene_->clearDiffs();
+        result = parent_scene_->setPlanningSceneMsg(scene) && result;
+        // There were no callbacks for individual object changes, so rebuild the octree masks
+        excludeAttachedBodiesFromOctree();
+        excludeWorldObjectsFromOctree();
       }
+      else
+      {
+        result = scene_->usePlanningSceneMsg(scene) && result;
+      }
+
+      if (octomap_monitor_)
+      {
+        if (!scene.is_diff && scene.world.octomap.octomap.data.empty())
+        {
+          octomap_monitor_->getOcTreePtr()->lockWrite();
+          octomap_monitor_->getOcTreePtr()->clear();
+          octomap_monitor_->getOcTreePtr()->unlockWrite();
+        }
+      }
+      upd |= getSceneUpdateType(scene, old_scene_name);
     }
     robot_model_ = scene_->getRobotModel();
 
@@ -771,32 +1273,11 @@ bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::Plann
       excludeAttachedBodiesFromOctree();  // in case updates have happened to the attached bodies, put them in
       excludeWorldObjectsFromOctree();    // in case updates have happened to the attached bodies, put them in
     }
+    recordStatistic(&Statistics::scene_update_apply,
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - apply_start).count());
   }
 
-  // if we have a diff, try to more accurately determine the update type
-  if (scene.is_diff)
-  {
-    bool no_other_scene_upd = (scene.name.empty() || scene.name == old_scene_name) &&
-                              scene.allowed_collision_matrix.entry_names.empty() && scene.link_padding.empty() &&
-                              scene.link_scale.empty();
-    if (no_other_scene_upd)
-    {
-      upd = UPDATE_NONE;
-      if (!moveit::core::isEmpty(scene.world))
-        upd = static_cast<SceneUpdateType>(static_cast<int>(upd) | static_cast<int>(UPDATE_GEOMETRY));
-
-      if (!scene.fixed_frame_transforms.empty())
-        upd = static_cast<SceneUpdateType>(static_cast<int>(upd) | static_cast<int>(UPDATE_TRANSFORMS));
-
-      if (!moveit::core::isEmpty(scene.robot_state))
-      {
-        upd = static_cast<SceneUpdateType>(static_cast<int>(upd) | static_cast<int>(UPDATE_STATE));
-        if (!scene.robot_state.attached_collision_objects.empty() || !scene.robot_state.is_diff)
-          upd = static_cast<SceneUpdateType>(static_cast<int>(upd) | static_cast<int>(UPDATE_GEOMETRY));
-      }
-    }
-  }
-  triggerSceneUpdateEvent(upd);
+  triggerSceneUpdateEvent(static_cast<SceneUpdateType>(upd));
   return result;
 }
 
@@ -808,9 +1289,13 @@ bool PlanningSceneMonitor::processCollisionObjectMsg(const moveit_msgs::msg::Col
 
   updateFrameTransforms();
   {
-    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    TimedSceneLock<true> ulock(*this);
     last_update_time_ = rclcpp::Clock().now();
-    if (!scene_->processCollisionObjectMsg(*object))
+    const auto apply_start = std::chrono::steady_clock::now();
+    const bool processed = scene_->processCollisionObjectMsg(*object);
+    recordStatistic(&Statistics::scene_update_apply,
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - apply_start).count());
+    if (!processed)
       return false;
     if (color_msg.has_value())
       scene_->setObjectColor(color_msg.value().id, color_msg.value().color);
@@ -830,9 +1315,13 @@ bool PlanningSceneMonitor::processAttachedCollisionObjectMsg(
 
   updateFrameTransforms();
   {
-    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    TimedSceneLock<true> ulock(*this);
     last_update_time_ = rclcpp::Clock().now();
-    if (!scene_->processAttachedCollisionObjectMsg(*object))
+    const auto apply_start = std::chrono::steady_clock::now();
+    const bool processed = scene_->processAttachedCollisionObjectMsg(*object);
+    recordStatistic(&Statistics::scene_update_apply,
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - apply_start).count());
+    if (!processed)
       return false;
   }
   triggerSceneUpdateEvent(UPDATE_GEOMETRY);
@@ -847,8 +1336,9 @@ void PlanningSceneMonitor::newPlanningSceneWorldCallback(
   {
     updateFrameTransforms();
     {
-      std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+      TimedSceneLock<true> ulock(*this);
       last_update_time_ = rclcpp::Clock().now();
+      const auto apply_start = std::chrono::steady_clock::now();
       scene_->getWorldNonConst()->clearObjects();
       scene_->processPlanningSceneWorldMsg(*world);
       if (octomap_monitor_)
@@ -860,6 +1350,8 @@ void PlanningSceneMonitor::newPlanningSceneWorldCallback(
           octomap_monitor_->getOcTreePtr()->unlockWrite();
         }
       }
+      recordStatistic(&Statistics::scene_update_apply,
+                      std::chrono::duration<double>(std::chrono::steady_clock::now() - apply_start).count());
     }
     triggerSceneUpdateEvent(UPDATE_SCENE);
   }
@@ -1130,7 +1622,7 @@ bool PlanningSceneMonitor::waitForCurrentRobotState(const rclcpp::Time& t, doubl
   // As publishing planning scene updates is throttled (2Hz by default), a 1s timeout is a suitable default.
   auto start = node_->get_clock()->now();
   auto timeout = rclcpp::Duration::from_seconds(wait_time);
-  std::shared_lock<std::shared_mutex> lock(scene_update_mutex_);
+  TimedSceneLock<false> lock(*this);
   rclcpp::Time prev_robot_motion_time = last_robot_motion_time_;
   while (last_robot_motion_time_ < t &&  // Wait until the state update actually reaches the scene.
          timeout > rclcpp::Duration(0, 0))
@@ -1154,7 +1646,10 @@ bool PlanningSceneMonitor::waitForCurrentRobotState(const rclcpp::Time& t, doubl
 
 void PlanningSceneMonitor::lockSceneRead()
 {
+  const auto start = std::chrono::steady_clock::now();
   scene_update_mutex_.lock_shared();
+  recordStatistic(&Statistics::read_lock_wait,
+                  std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
   if (octomap_monitor_)
     octomap_monitor_->getOcTreePtr()->lockRead();
 }
@@ -1168,16 +1663,24 @@ void PlanningSceneMonitor::unlockSceneRead()
 
 void PlanningSceneMonitor::lockSceneWrite()
 {
+  const auto start = std::chrono::steady_clock::now();
   scene_update_mutex_.lock();
+  scene_write_locked_time_ = std::chrono::steady_clock::now();
+  recordStatistic(&Statistics::write_lock_wait,
+                  std::chrono::duration<double>(scene_write_locked_time_ - start).count());
   if (octomap_monitor_)
     octomap_monitor_->getOcTreePtr()->lockWrite();
 }
 
 void PlanningSceneMonitor::unlockSceneWrite()
 {
+  // writers through LockedPlanningSceneRW do not necessarily trigger an update event
+  ++scene_epoch_;
   if (octomap_monitor_)
     octomap_monitor_->getOcTreePtr()->unlockWrite();
+  const auto hold = std::chrono::duration<double>(std::chrono::steady_clock::now() - scene_write_locked_time_);
   scene_update_mutex_.unlock();
+  recordStatistic(&Statistics::write_lock_hold, hold.count());
 }
 
 void PlanningSceneMonitor::startSceneMonitor(const std::string& scene_topic)
@@ -1203,6 +1706,12 @@ void PlanningSceneMonitor::stopSceneMonitor()
     RCLCPP_INFO(logger_, "Stopping planning scene monitor");
     planning_scene_subscriber_.reset();
   }
+  if (scene_update_coalescing_timer_)
+  {
+    scene_update_coalescing_timer_->cancel();
+    scene_update_coalescing_timer_.reset();
+  }
+  applyPendingSceneUpdates();
 }
 
 bool PlanningSceneMonitor::getShapeTransformCache(const std::string& target_frame, const rclcpp::Time& target_time,
@@ -1459,7 +1968,7 @@ void PlanningSceneMonitor::octomapUpdateCallback()
 
   updateFrameTransforms();
   {
-    std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+    TimedSceneLock<true> ulock(*this);
     last_update_time_ = rclcpp::Clock().now();
     octomap_monitor_->getOcTreePtr()->lockRead();
     try
@@ -1524,7 +2033,7 @@ void PlanningSceneMonitor::updateSceneWithCurrentState()
     }
 
     {
-      std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+      TimedSceneLock<true> ulock(*this);
       last_update_time_ = last_robot_motion_time_ = current_state_monitor_->getCurrentStateTime();
       RCLCPP_DEBUG(logger_, "robot state update %f", fmod(last_robot_motion_time_.seconds(), 10.));
       current_state_monitor_->setToCurrentState(scene_->getCurrentStateNonConst());
@@ -1597,7 +2106,7 @@ void PlanningSceneMonitor::updateFrameTransforms()
     std::vector<geometry_msgs::msg::TransformStamped> transforms;
     getUpdatedFrameTransforms(transforms);
     {
-      std::unique_lock<std::shared_mutex> ulock(scene_update_mutex_);
+      TimedSceneLock<true> ulock(*this);
       scene_->getTransformsNonConst().setTransforms(transforms);
       last_update_time_ = rclcpp::Clock().now();
     }
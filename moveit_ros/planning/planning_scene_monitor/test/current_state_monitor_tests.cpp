@@ -199,6 +199,87 @@ TEST(CurrentStateMonitorTests, WaitForCompleteStateWaits)
   EXPECT_NEAR(nanoseconds_slept.count(), 1e+9, 1e3);
 }
 
+TEST(CurrentStateMonitorTests, LatestStateIsShared)
+{
+  auto mock_middleware_handle = std::make_unique<MockMiddlewareHandle>();
+  planning_scene_monitor::JointStateUpdateCallback joint_state_callback;
+  EXPECT_CALL(*mock_middleware_handle, createJointStateSubscription)
+      .WillOnce(testing::SaveArg<1>(&joint_state_callback));
+
+  // GIVEN a CurrentStateMonitor that is started
+  planning_scene_monitor::CurrentStateMonitor current_state_monitor{
+    std::move(mock_middleware_handle), moveit::core::loadTestingRobotModel("panda"),
+    std::make_shared<tf2_ros::Buffer>(std::make_shared<rclcpp::Clock>()), false
+  };
+  current_state_monitor.startStateMonitor();
+  ASSERT_TRUE(joint_state_callback);
+
+  moveit::core::RobotStateConstPtr callback_state;
+  current_state_monitor.addStateUpdateCallback(
+      [&](const moveit::core::RobotStateConstPtr& state, const rclcpp::Time& /*stamp*/) { callback_state = state; });
+
+  // WHEN the state was not updated
+  // THEN readers share the same state
+  const moveit::core::RobotStateConstPtr initial_state = current_state_monitor.getLatestState();
+  EXPECT_EQ(initial_state, current_state_monitor.getLatestState());
+
+  // WHEN a joint state is received
+  auto joint_state = std::make_shared<sensor_msgs::msg::JointState>();
+  joint_state->header.stamp = rclcpp::Time(1, 0, RCL_ROS_TIME);
+  joint_state->name = { "panda_joint1" };
+  joint_state->position = { 0.5 };
+  joint_state_callback(joint_state);
+
+  // THEN the latest state is replaced and passed to the callback, while earlier states remain unchanged
+  const auto [latest_state, stamp] = current_state_monitor.getLatestStateAndTime();
+  EXPECT_NE(initial_state, latest_state);
+  EXPECT_EQ(callback_state, latest_state);
+  EXPECT_EQ(stamp, rclcpp::Time(1, 0, RCL_ROS_TIME));
+  EXPECT_DOUBLE_EQ(latest_state->getVariablePosition("panda_joint1"), 0.5);
+  EXPECT_NE(initial_state->getVariablePosition("panda_joint1"), 0.5);
+  EXPECT_DOUBLE_EQ(current_state_monitor.getCurrentState()->getVariablePosition("panda_joint1"), 0.5);
+}
+
+TEST(CurrentStateMonitorTests, StateHistoryLookup)
+{
+  auto mock_middleware_handle = std::make_unique<MockMiddlewareHandle>();
+  planning_scene_monitor::JointStateUpdateCallback joint_state_callback;
+  EXPECT_CALL(*mock_middleware_handle, createJointStateSubscription)
+      .WillOnce(testing::SaveArg<1>(&joint_state_callback));
+
+  // GIVEN a started CurrentStateMonitor with a history of three states
+  const moveit::core::RobotModelPtr robot_model = moveit::core::loadTestingRobotModel("panda");
+  planning_scene_monitor::CurrentStateMonitor current_state_monitor{
+    std::move(mock_middleware_handle), robot_model,
+    std::make_shared<tf2_ros::Buffer>(std::make_shared<rclcpp::Clock>()), false
+  };
+  current_state_monitor.setStateHistorySize(3);
+  EXPECT_EQ(current_state_monitor.getStateHistorySize(), 3u);
+  current_state_monitor.startStateMonitor();
+  ASSERT_TRUE(joint_state_callback);
+
+  moveit::core::RobotState state(robot_model);
+  EXPECT_FALSE(current_state_monitor.getStateAtTime(rclcpp::Time(1, 0, RCL_ROS_TIME), state));
+
+  // WHEN four joint states are received
+  for (int i = 1; i <= 4; ++i)
+  {
+    auto joint_state = std::make_shared<sensor_msgs::msg::JointState>();
+    joint_state->header.stamp = rclcpp::Time(i, 0, RCL_ROS_TIME);
+    joint_state->name = { "panda_joint1" };
+    joint_state->position = { 0.1 * i };
+    joint_state_callback(joint_state);
+  }
+
+  // THEN the states of the last three are interpolated
+  ASSERT_TRUE(current_state_monitor.getStateAtTime(rclcpp::Time(2, 500000000, RCL_ROS_TIME), state));
+  EXPECT_NEAR(state.getVariablePosition("panda_joint1"), 0.25, 1e-9);
+  ASSERT_TRUE(current_state_monitor.getStateAtTime(rclcpp::Time(4, 0, RCL_ROS_TIME), state));
+  EXPECT_NEAR(state.getVariablePosition("panda_joint1"), 0.4, 1e-9);
+  EXPECT_FALSE(current_state_monitor.getStateAtTime(rclcpp::Time(1, 0, RCL_ROS_TIME), state));
+  EXPECT_FALSE(current_state_monitor.getStateAtTime(rclcpp::Time(5, 0, RCL_ROS_TIME), state));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -147,6 +147,168 @@ TEST_F(PlanningSceneMonitorTest, UpdateTypes)
   TRIGGERS_UPDATE(msg, UpdateType::UPDATE_SCENE);
 }
 
+TEST_F(PlanningSceneMonitorTest, SceneSnapshot)
+{
+  auto snapshot{ planning_scene_monitor_->getSceneSnapshot() };
+  ASSERT_TRUE(snapshot);
+  EXPECT_NE(snapshot, planning_scene_monitor_->getPlanningScene());
+  EXPECT_EQ(snapshot, planning_scene_monitor_->getSceneSnapshot());
+
+  moveit_msgs::msg::PlanningScene msg;
+  msg.is_diff = msg.robot_state.is_diff = true;
+  moveit_msgs::msg::CollisionObject collision_object;
+  collision_object.header.frame_id = "base_link";
+  collision_object.id = "object";
+  collision_object.operation = moveit_msgs::msg::CollisionObject::ADD;
+  collision_object.pose.orientation.w = 1.0;
+  collision_object.primitives.emplace_back();
+  collision_object.primitives.back().type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  collision_object.primitives.back().dimensions = { 1.0 };
+  msg.world.collision_objects.emplace_back(collision_object);
+  planning_scene_monitor_->newPlanningSceneMessage(msg);
+
+  // earlier snapshots are not affected by updates
+  EXPECT_FALSE(snapshot->getWorld()->hasObject("object"));
+  auto updated_snapshot{ planning_scene_monitor_->getSceneSnapshot() };
+  EXPECT_NE(snapshot, updated_snapshot);
+  EXPECT_TRUE(updated_snapshot->getWorld()->hasObject("object"));
+
+  {
+    planning_scene_monitor::LockedPlanningSceneRW ls(planning_scene_monitor_);
+    ls->getWorldNonConst()->removeObject("object");
+  }
+  EXPECT_TRUE(updated_snapshot->getWorld()->hasObject("object"));
+  EXPECT_FALSE(planning_scene_monitor_->getSceneSnapshot()->getWorld()->hasObject("object"));
+}
+
+TEST_F(PlanningSceneMonitorTest, GetPlanningSceneServiceCache)
+{
+  planning_scene_monitor_->providePlanningSceneService("get_planning_scene_cache_test");
+  auto client = test_node_->create_client<moveit_msgs::srv::GetPlanningScene>("get_planning_scene_cache_test");
+  ASSERT_TRUE(client->wait_for_service(std::chrono::seconds(5)));
+  const auto get_scene = [&client]() {
+    auto request = std::make_shared<moveit_msgs::srv::GetPlanningScene::Request>();
+    request->components.components = moveit_msgs::msg::PlanningSceneComponents::WORLD_OBJECT_GEOMETRY;
+    auto response = client->async_send_request(request);
+    EXPECT_EQ(response.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    return response.get()->scene;
+  };
+
+  moveit_msgs::msg::CollisionObject collision_object;
+  collision_object.header.frame_id = "base_link";
+  collision_object.id = "object";
+  collision_object.operation = moveit_msgs::msg::CollisionObject::ADD;
+  collision_object.pose.orientation.w = 1.0;
+  collision_object.primitives.emplace_back();
+  collision_object.primitives.back().type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  collision_object.primitives.back().dimensions = { 1.0 };
+  {
+    planning_scene_monitor::LockedPlanningSceneRW ls(planning_scene_monitor_);
+    ASSERT_TRUE(ls->processCollisionObjectMsg(collision_object));
+  }
+
+  moveit_msgs::msg::PlanningScene scene = get_scene();
+  ASSERT_EQ(scene.world.collision_objects.size(), 1u);
+  EXPECT_EQ(scene.world.collision_objects[0].primitives.size(), 1u);
+  EXPECT_EQ(get_scene().world.collision_objects, scene.world.collision_objects);
+  const double x = scene.world.collision_objects[0].pose.position.x;
+
+  // changes of the object invalidate its cached message
+  {
+    planning_scene_monitor::LockedPlanningSceneRW ls(planning_scene_monitor_);
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.translation().x() = 1.0;
+    ASSERT_TRUE(ls->getWorldNonConst()->moveObject("object", pose));
+  }
+  scene = get_scene();
+  ASSERT_EQ(scene.world.collision_objects.size(), 1u);
+  EXPECT_DOUBLE_EQ(scene.world.collision_objects[0].pose.position.x, x + 1.0);
+
+  {
+    planning_scene_monitor::LockedPlanningSceneRW ls(planning_scene_monitor_);
+    ls->getWorldNonConst()->removeObject("object");
+  }
+  EXPECT_TRUE(get_scene().world.collision_objects.empty());
+}
+
+TEST_F(PlanningSceneMonitorTest, CoalesceSceneUpdates)
+{
+  planning_scene_monitor_->startSceneMonitor("coalesced_planning_scene");
+  // long enough that the messages are only applied when the scene monitor is stopped
+  planning_scene_monitor_->setSceneUpdateCoalescingWindow(60.0);
+  EXPECT_EQ(planning_scene_monitor_->getSceneUpdateCoalescingWindow(), 60.0);
+
+  std::atomic<int> updates{ 0 };
+  planning_scene_monitor_->clearUpdateCallbacks();
+  planning_scene_monitor_->addUpdateCallback([&](auto /*type*/) { ++updates; });
+
+  auto publisher = test_node_->create_publisher<moveit_msgs::msg::PlanningScene>("coalesced_planning_scene", 10);
+  moveit_msgs::msg::PlanningScene msg;
+  msg.is_diff = msg.robot_state.is_diff = true;
+  moveit_msgs::msg::CollisionObject collision_object;
+  collision_object.header.frame_id = "base_link";
+  collision_object.id = "object";
+  collision_object.operation = moveit_msgs::msg::CollisionObject::ADD;
+  collision_object.pose.orientation.w = 1.0;
+  collision_object.primitives.emplace_back();
+  collision_object.primitives.back().type = shape_msgs::msg::SolidPrimitive::SPHERE;
+  collision_object.primitives.back().dimensions = { 0.1 };
+  msg.world.collision_objects.emplace_back(collision_object);
+  publisher->publish(msg);
+
+  for (double x : { 1.0, 2.0, 3.0 })
+  {
+    msg.world.collision_objects.back().operation = moveit_msgs::msg::CollisionObject::MOVE;
+    msg.world.collision_objects.back().primitives.clear();
+    msg.world.collision_objects.back().pose.position.x = x;
+    publisher->publish(msg);
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds{ 1 });
+  EXPECT_EQ(updates, 0);
+  EXPECT_FALSE(scene_->getWorld()->hasObject("object"));
+
+  // stopping the scene monitor applies the collected messages
+  planning_scene_monitor_->stopSceneMonitor();
+  EXPECT_EQ(updates, 1);
+  ASSERT_TRUE(scene_->getWorld()->hasObject("object"));
+  EXPECT_DOUBLE_EQ(scene_->getWorld()->getObject("object")->pose_.translation().x(), 3.0);
+}
+
+TEST(SampleHistogram, Buckets)
+{
+  planning_scene_monitor::SampleHistogram histogram(1.0, 10.0, 3);
+  ASSERT_EQ(histogram.bounds, (std::vector<double>{ 1.0, 10.0 }));
+  EXPECT_EQ(histogram.mean(), 0.0);
+  for (double sample : { 0.5, 1.0, 5.0, 50.0 })
+    histogram.add(sample);
+  EXPECT_EQ(histogram.buckets, (std::vector<std::uint64_t>{ 2, 1, 1 }));
+  EXPECT_EQ(histogram.count, 4u);
+  EXPECT_DOUBLE_EQ(histogram.mean(), 56.5 / 4);
+  EXPECT_EQ(histogram.max, 50.0);
+}
+
+TEST_F(PlanningSceneMonitorTest, Statistics)
+{
+  planning_scene_monitor_->resetStatistics();
+  EXPECT_EQ(planning_scene_monitor_->getStatistics().scene_update_apply.count, 0u);
+
+  moveit_msgs::msg::PlanningScene msg;
+  msg.is_diff = msg.robot_state.is_diff = true;
+  planning_scene_monitor_->newPlanningSceneMessage(msg);
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ls(planning_scene_monitor_);
+  }
+
+  const auto statistics = planning_scene_monitor_->getStatistics();
+  EXPECT_EQ(statistics.scene_update_apply.count, 1u);
+  EXPECT_GE(statistics.write_lock_wait.count, 1u);
+  EXPECT_GE(statistics.read_lock_wait.count, 1u);
+
+  planning_scene_monitor_->resetStatistics();
+  EXPECT_EQ(planning_scene_monitor_->getStatistics().write_lock_hold.count, 0u);
+}
+
 int main(int argc, char** argv)
 {
   rclcpp::init(argc, argv);
@@ -91,6 +91,12 @@ public:
     return urdf_string_;
   }
 
+  /** @brief Get the SRDF string*/
+  const std::string& getSRDFString() const
+  {
+    return srdf_string_;
+  }
+
   /** @brief Get the parsed URDF model*/
   const urdf::ModelInterfaceSharedPtr& getURDF() const
   {
@@ -74,6 +74,11 @@ public:
     /** @brief Flag indicating whether the kinematics solvers should be loaded as well, using specified ROS parameters
      */
     bool load_kinematics_solvers;
+
+    /** @brief Directory for binary snapshots of the robot model (see moveit::core::RobotModelSnapshot), speeding up
+     * subsequent starts with the same robot description. If empty, the ROS parameter
+     * "<robot_description>_planning.model_cache_directory" is used. Snapshots are disabled if both are empty. */
+    std::string model_cache_directory;
   };
 
   /** @brief Default constructor */
@@ -129,6 +134,9 @@ public:
 private:
   void configure(const Options& opt);
 
+  /** @brief Build the robot model from the loaded description, using a snapshot in \e cache_directory if possible */
+  void buildModel(const std::string& cache_directory);
+
   moveit::core::RobotModelPtr model_;
   rdf_loader::RDFLoaderPtr rdf_loader_;
   kinematics_plugin_loader::KinematicsPluginLoaderPtr kinematics_loader_;
@@ -35,12 +35,15 @@
 /* Author: Ioan Sucan, E. Gil Jones */
 
 #include <moveit/robot_model_loader/robot_model_loader.hpp>
+#include <moveit/robot_model/robot_model_snapshot.hpp>
 #include <rclcpp/clock.hpp>
 #include <rclcpp/duration.hpp>
 #include <rclcpp/logger.hpp>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/parameter_value.hpp>
 #include <rclcpp/time.hpp>
+#include <filesystem>
+#include <sstream>
 #include <typeinfo>
 #include <moveit/utils/logger.hpp>
 
@@ -116,9 +119,15 @@ void RobotModelLoader::configure(const Options& opt)
   }
   if (rdf_loader_->getURDF())
   {
-    const srdf::ModelSharedPtr& srdf =
-        rdf_loader_->getSRDF() ? rdf_loader_->getSRDF() : std::make_shared<srdf::Model>();
-    model_ = std::make_shared<moveit::core::RobotModel>(rdf_loader_->getURDF(), srdf);
+    std::string cache_directory = opt.model_cache_directory;
+    if (cache_directory.empty() && !rdf_loader_->getRobotDescription().empty())
+    {
+      const std::string param_name = rdf_loader_->getRobotDescription() + "_planning.model_cache_directory";
+      if (!node_->has_parameter(param_name))
+        node_->declare_parameter(param_name, std::string());
+      node_->get_parameter(param_name, cache_directory);
+    }
+    buildModel(cache_directory);
   }
 
   if (model_ && !rdf_loader_->getRobotDescription().empty())
@@ -253,6 +262,40 @@ void RobotModelLoader::configure(const Options& opt)
   RCLCPP_DEBUG(logger_, "Loaded kinematic model in %f seconds", (clock.now() - start).seconds());
 }
 
+void RobotModelLoader::buildModel(const std::string& cache_directory)
+{
+  const srdf::ModelSharedPtr& srdf = rdf_loader_->getSRDF() ? rdf_loader_->getSRDF() : std::make_shared<srdf::Model>();
+  if (cache_directory.empty())
+  {
+    model_ = std::make_shared<moveit::core::RobotModel>(rdf_loader_->getURDF(), srdf);
+    return;
+  }
+
+  moveit::core::RobotModelSnapshot snapshot(
+      moveit::core::RobotModelSnapshot::computeKey(rdf_loader_->getURDFString(), rdf_loader_->getSRDFString()));
+  std::stringstream path;
+  path << cache_directory << "/robot_model_" << std::hex << snapshot.getKey() << ".bin";
+  if (snapshot.load(path.str()))
+    RCLCPP_DEBUG(logger_, "Loaded %zu meshes from robot model snapshot '%s'", snapshot.getMeshCount(),
+                 path.str().c_str());
+
+  model_ = std::make_shared<moveit::core::RobotModel>(rdf_loader_->getURDF(), srdf, snapshot.getMeshLoader());
+
+  if (snapshot.isModified())
+  {
+    std::error_code ec;
+    std::filesystem::create_directories(cache_directory, ec);
+    if (!ec && snapshot.save(path.str()))
+    {
+      RCLCPP_INFO(logger_, "Wrote robot model snapshot '%s'", path.str().c_str());
+    }
+    else
+    {
+      RCLCPP_WARN(logger_, "Unable to write robot model snapshot to '%s'", cache_directory.c_str());
+    }
+  }
+}
+
 void RobotModelLoader::loadKinematicsSolvers(const kinematics_plugin_loader::KinematicsPluginLoaderPtr& kloader)
 {
   if (rdf_loader_ && model_)
@@ -72,6 +72,10 @@ public:
   /// successfully.
   using PathSegmentCompleteCallback = std::function<void(std::size_t)>;
 
+  /// Definition of the function signature that is called with the expected trajectory index during execution, as
+  /// returned by getCurrentExpectedTrajectoryIndex()
+  using ProgressCallback = std::function<void(const std::pair<int, int>&)>;
+
   /// Data structure that represents information necessary to execute a trajectory
   struct TrajectoryExecutionContext
   {
@@ -178,8 +182,13 @@ public:
   /// point within that trajectory.
   /// Values of -1 are returned when there is no trajectory being executed, or if the trajectory was passed using
   /// pushAndExecute().
+  /// This does not block and can be polled at high rates.
   std::pair<int, int> getCurrentExpectedTrajectoryIndex() const;
 
+  /// Call \e callback with getCurrentExpectedTrajectoryIndex() at \e rate Hz while trajectories execute, whenever the
+  /// index changed. The callback is called from the node's executor. An empty callback or a rate <= 0 disables it.
+  void setProgressCallback(const ProgressCallback& callback, double rate);
+
   /// Return the controller status for the last attempted execution
   moveit_controller_manager::ExecutionStatus getLastExecutionStatus() const;
 
@@ -229,6 +238,15 @@ public:
   /// Get the current state of waiting for the trajectory being completed.
   bool waitForTrajectoryCompletion() const;
 
+  /// Enable or disable splicing of pushed trajectories. With splicing, consecutive trajectories for the same
+  /// controllers whose positions and velocities continue each other are sent as one trajectory, such that the robot
+  /// does not stop and settle between them. The segment callback is called for each of them when the spliced
+  /// trajectory completes, and getCurrentExpectedTrajectoryIndex() refers to the first of them.
+  void setSpliceTrajectories(bool flag);
+
+  /// Get whether consecutive trajectories are spliced.
+  bool spliceTrajectories() const;
+
   rclcpp::Node::SharedPtr getControllerManagerNode()
   {
     return controller_mgr_node_;
@@ -283,11 +301,16 @@ private:
 
   void executeThread(const ExecutionCompleteCallback& callback, const PathSegmentCompleteCallback& part_callback,
                      bool auto_clear);
-  bool executePart(std::size_t part_index);
+  bool executePart(const TrajectoryExecutionContext& context, std::size_t part_index);
+  /// Append \e next to \e context if it continues it for the same controllers, return false otherwise
+  bool spliceContext(TrajectoryExecutionContext& context, const TrajectoryExecutionContext& next) const;
   bool waitForRobotToStop(const TrajectoryExecutionContext& context, double wait_time = 1.0);
 
   void stopExecutionInternal();
 
+  /// Publish the expected times of the points of the trajectory context being executed, -1 if there is none
+  void publishTimeIndex(int context, std::vector<rclcpp::Time> times = {});
+
   void receiveEvent(const std_msgs::msg::String::ConstSharedPtr& event);
 
   void loadControllerParams();
@@ -304,6 +327,10 @@ private:
   planning_scene_monitor::CurrentStateMonitorPtr csm_;
   rclcpp::Subscription<std_msgs::msg::String>::SharedPtr event_topic_subscriber_;
   std::map<std::string, ControllerInformation> known_controllers_;
+  rclcpp::Time last_controller_reload_{ 0, 0, RCL_ROS_TIME };  // time known_controllers_ was listed
+  // controllers selected for (actuated joints, available controllers), valid until known_controllers_ change
+  std::map<std::pair<std::set<std::string>, std::vector<std::string> >, std::vector<std::string> >
+      controller_selection_cache_;
   bool manage_controllers_;
 
   // thread used to execute trajectories using the execute() command
@@ -317,9 +344,14 @@ private:
 
   moveit_controller_manager::ExecutionStatus last_execution_status_;
   std::vector<moveit_controller_manager::MoveItControllerHandlePtr> active_handles_;
-  int current_context_;
-  std::vector<rclcpp::Time> time_index_;  // used to find current expected trajectory location
-  mutable std::mutex time_index_mutex_;
+  // used to find current expected trajectory location; immutable once published, accessed with std::atomic_load/store
+  struct TimeIndex
+  {
+    int context = -1;
+    std::vector<rclcpp::Time> times;
+  };
+  std::shared_ptr<const TimeIndex> time_index_;
+  rclcpp::TimerBase::SharedPtr progress_timer_;
   bool execution_complete_;
 
   std::vector<TrajectoryExecutionContext*> trajectories_;
@@ -342,6 +374,7 @@ private:
   double allowed_start_tolerance_;  // joint tolerance for validate(): radians for revolute joints
   double execution_velocity_scaling_;
   bool wait_for_trajectory_completion_;
+  bool splice_trajectories_;
 
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr callback_handler_;
 };
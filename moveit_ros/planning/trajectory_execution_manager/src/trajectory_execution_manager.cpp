@@ -41,6 +41,7 @@
 #include <memory>
 #include <tf2_eigen/tf2_eigen.hpp>
 #include <moveit/utils/logger.hpp>
+#include <moveit/utils/tracing.hpp>
 
 namespace trajectory_execution_manager
 {
@@ -54,6 +55,7 @@ static const double DEFAULT_CONTROLLER_GOAL_DURATION_MARGIN = 0.5;  // allow 0.5
 static const double DEFAULT_CONTROLLER_GOAL_DURATION_SCALING =
     1.1;  // allow the execution of a trajectory to take more time than expected (scaled by a value > 1)
 static const bool DEFAULT_CONTROL_MULTI_DOF_JOINT_VARIABLES = false;
+static const double SPLICE_VELOCITY_TOLERANCE = 0.01;  // rad/s or m/s, for velocities of spliced trajectories
 
 TrajectoryExecutionManager::TrajectoryExecutionManager(const rclcpp::Node::SharedPtr& node,
                                                        const moveit::core::RobotModelConstPtr& robot_model,
@@ -83,6 +85,7 @@ TrajectoryExecutionManager::TrajectoryExecutionManager(const rclcpp::Node::Share
 
 TrajectoryExecutionManager::~TrajectoryExecutionManager()
 {
+  progress_timer_.reset();
   stopExecution(true);
   if (private_executor_)
     private_executor_->cancel();
@@ -94,12 +97,13 @@ void TrajectoryExecutionManager::initialize()
 {
   verbose_ = false;
   execution_complete_ = true;
-  current_context_ = -1;
+  publishTimeIndex(-1);
   last_execution_status_ = moveit_controller_manager::ExecutionStatus::SUCCEEDED;
   execution_duration_monitoring_ = true;
   execution_velocity_scaling_ = 1.0;
   allowed_start_tolerance_ = 0.01;
   wait_for_trajectory_completion_ = true;
+  splice_trajectories_ = false;
   control_multi_dof_joint_variables_ = DEFAULT_CONTROL_MULTI_DOF_JOINT_VARIABLES;
 
   allowed_execution_duration_scaling_ = DEFAULT_CONTROLLER_GOAL_DURATION_SCALING;
@@ -209,6 +213,7 @@ void TrajectoryExecutionManager::initialize()
   controller_mgr_node_->get_parameter("trajectory_execution.allowed_start_tolerance", allowed_start_tolerance_);
   controller_mgr_node_->get_parameter("trajectory_execution.control_multi_dof_joint_variables",
                                       control_multi_dof_joint_variables_);
+  controller_mgr_node_->get_parameter("trajectory_execution.splice_trajectories", splice_trajectories_);
 
   if (manage_controllers_)
   {
@@ -249,6 +254,10 @@ void TrajectoryExecutionManager::initialize()
       {
         setWaitForTrajectoryCompletion(parameter.as_bool());
       }
+      else if (name == "trajectory_execution.splice_trajectories")
+      {
+        setSpliceTrajectories(parameter.as_bool());
+      }
       else
       {
         result.successful = false;
@@ -319,6 +328,16 @@ bool TrajectoryExecutionManager::waitForTrajectoryCompletion() const
   return wait_for_trajectory_completion_;
 }
 
+void TrajectoryExecutionManager::setSpliceTrajectories(bool flag)
+{
+  splice_trajectories_ = flag;
+}
+
+bool TrajectoryExecutionManager::spliceTrajectories() const
+{
+  return splice_trajectories_;
+}
+
 bool TrajectoryExecutionManager::isManagingControllers() const
 {
   return manage_controllers_;
@@ -456,6 +475,8 @@ bool TrajectoryExecutionManager::push(const moveit_msgs::msg::RobotTrajectory& t
 void TrajectoryExecutionManager::reloadControllerInformation()
 {
   known_controllers_.clear();
+  controller_selection_cache_.clear();
+  last_controller_reload_ = node_->now();
   if (controller_manager_)
   {
     std::vector<std::string> names;
@@ -529,7 +550,12 @@ void TrajectoryExecutionManager::updateControllerState(ControllerInformation& ci
     {
       if (verbose_)
         RCLCPP_INFO(logger_, "Updating information for controller '%s'.", ci.name_.c_str());
-      ci.state_ = controller_manager_->getControllerState(ci.name_);
+      const moveit_controller_manager::MoveItControllerManager::ControllerState state =
+          controller_manager_->getControllerState(ci.name_);
+      // selections prefer active and default controllers, so they need to be made again when these change
+      if (state.active_ != ci.state_.active_ || state.default_ != ci.state_.default_)
+        controller_selection_cache_.clear();
+      ci.state_ = state;
       ci.last_update_ = node_->now();
     }
   }
@@ -546,27 +572,31 @@ void TrajectoryExecutionManager::updateControllersState(const rclcpp::Duration&
 bool TrajectoryExecutionManager::checkControllerCombination(std::vector<std::string>& selected,
                                                             const std::set<std::string>& actuated_joints)
 {
-  std::set<std::string> combined_joints;
+  std::vector<const ControllerInformation*> selected_info;
+  selected_info.reserve(selected.size());
   for (const std::string& controller : selected)
-  {
-    const ControllerInformation& ci = known_controllers_[controller];
-    combined_joints.insert(ci.joints_.begin(), ci.joints_.end());
-  }
+    selected_info.push_back(&known_controllers_[controller]);
 
   if (verbose_)
   {
     std::stringstream ss, saj, sac;
-    for (const std::string& controller : selected)
-      ss << controller << ' ';
+    for (const ControllerInformation* ci : selected_info)
+    {
+      ss << ci->name_ << ' ';
+      for (const std::string& joint : ci->joints_)
+        sac << joint << ' ';
+    }
     for (const std::string& actuated_joint : actuated_joints)
       saj << actuated_joint << ' ';
-    for (const std::string& combined_joint : combined_joints)
-      sac << combined_joint << ' ';
     RCLCPP_INFO(logger_, "Checking if controllers [ %s] operating on joints [ %s] cover joints [ %s]", ss.str().c_str(),
                 sac.str().c_str(), saj.str().c_str());
   }
 
-  return std::includes(combined_joints.begin(), combined_joints.end(), actuated_joints.begin(), actuated_joints.end());
+  // every actuated joint needs to be operated by one of the selected controllers
+  return std::all_of(actuated_joints.begin(), actuated_joints.end(), [&selected_info](const std::string& joint) {
+    return std::any_of(selected_info.begin(), selected_info.end(),
+                       [&joint](const ControllerInformation* ci) { return ci->joints_.count(joint) > 0; });
+  });
 }
 
 void TrajectoryExecutionManager::generateControllerCombination(std::size_t start_index, std::size_t controller_count,
@@ -741,6 +771,16 @@ bool TrajectoryExecutionManager::selectControllers(const std::set<std::string>&
                                                    const std::vector<std::string>& available_controllers,
                                                    std::vector<std::string>& selected_controllers)
 {
+  // refreshing outdated controller states drops the cached selections if a state changed
+  updateControllersState(DEFAULT_CONTROLLER_INFORMATION_VALIDITY_AGE);
+  const std::pair<std::set<std::string>, std::vector<std::string>> key(actuated_joints, available_controllers);
+  const auto cached = controller_selection_cache_.find(key);
+  if (cached != controller_selection_cache_.end())
+  {
+    selected_controllers = cached->second;
+    return true;
+  }
+
   for (std::size_t i = 1; i <= available_controllers.size(); ++i)
   {
     if (findControllers(actuated_joints, i, available_controllers, selected_controllers))
@@ -761,6 +801,7 @@ bool TrajectoryExecutionManager::selectControllers(const std::set<std::string>&
           }
         }
       }
+      controller_selection_cache_[key] = selected_controllers;
       return true;
     }
   }
@@ -919,13 +960,14 @@ bool TrajectoryExecutionManager::validate(const TrajectoryExecutionContext& cont
 
   RCLCPP_INFO(logger_, "Validating trajectory with allowed_start_tolerance %g", allowed_start_tolerance_);
 
-  moveit::core::RobotStatePtr current_state;
-  if (!csm_->waitForCurrentState(node_->now()) || !(current_state = csm_->getCurrentState()))
+  // the latest state is shared without copying it; the start point is compared joint by joint in local buffers
+  moveit::core::RobotStateConstPtr current_state;
+  if (!csm_->waitForCurrentState(node_->now()) || !(current_state = csm_->getLatestState()))
   {
     RCLCPP_WARN(logger_, "Failed to validate trajectory: couldn't receive full current joint state within 1s");
     return false;
   }
-  moveit::core::RobotState reference_state(*current_state);
+  std::vector<double> current_positions, reference_positions;
   for (const auto& trajectory : context.trajectory_parts_)
   {
     if (!trajectory.joint_trajectory.points.empty())
@@ -939,41 +981,56 @@ bool TrajectoryExecutionManager::validate(const TrajectoryExecutionContext& cont
         return false;
       }
 
-      std::set<const moveit::core::JointModel*> joints;
+      std::vector<const moveit::core::JointModel*> joints;
+      std::vector<int> variable_indices;
+      variable_indices.reserve(joint_names.size());
+      const moveit::core::NameIndexTable& variable_table = robot_model_->getVariableIndexTable();
       for (const auto& joint_name : joint_names)
       {
-        const moveit::core::JointModel* jm = robot_model_->getJointOfVariable(joint_name);
-        if (!jm)
+        const int variable_index = variable_table.find(joint_name);
+        if (variable_index < 0)
         {
           RCLCPP_ERROR_STREAM(logger_, "Unknown joint in trajectory: " << joint_name);
           return false;
         }
 
-        joints.insert(jm);
+        variable_indices.push_back(variable_index);
+        const moveit::core::JointModel* joint = robot_model_->getJointOfVariable(variable_index);
+        if (std::find(joints.begin(), joints.end(), joint) == joints.end())
+          joints.push_back(joint);
       }
 
-      // Copy all variable positions to reference state, and then compare start state joint distance within bounds
+      // Compare the start point with the current state joint by joint, overriding the current positions of a joint
+      // with the variables in the trajectory, and compare the joint distance within bounds
       // Note on multi-DOF joints: Instead of comparing the translation and rotation distances like it's done for
       // the multi-dof trajectory, this check will use the joint's internal distance implementation instead.
       // This is more accurate, but may require special treatment for cases like the diff drive's turn path geometry.
-      reference_state.setVariablePositions(joint_names, positions);
-
       for (const auto joint : joints)
       {
-        reference_state.enforcePositionBounds(joint);
-        current_state->enforcePositionBounds(joint);
-        if (reference_state.distance(*current_state, joint) > allowed_start_tolerance_)
+        const int first_variable = joint->getFirstVariableIndex();
+        const double* joint_positions = current_state->getJointPositions(joint);
+        current_positions.assign(joint_positions, joint_positions + joint->getVariableCount());
+        reference_positions = current_positions;
+        for (std::size_t i = 0; i < variable_indices.size(); ++i)
+        {
+          const int offset = variable_indices[i] - first_variable;
+          if (offset >= 0 && offset < static_cast<int>(joint->getVariableCount()))
+            reference_positions[offset] = positions[i];
+        }
+
+        joint->enforcePositionBounds(reference_positions.data());
+        joint->enforcePositionBounds(current_positions.data());
+        if (joint->distance(reference_positions.data(), current_positions.data()) > allowed_start_tolerance_)
         {
           RCLCPP_ERROR(logger_,
                        "Invalid Trajectory: start point deviates from current robot state more than %g at joint '%s'."
                        "\nEnable DEBUG for detailed state info.",
                        allowed_start_tolerance_, joint->getName().c_str());
           RCLCPP_DEBUG(logger_, "| Joint | Expected | Current |");
-          for (const auto& joint_name : joint_names)
+          for (std::size_t i = 0; i < joint_names.size(); ++i)
           {
-            RCLCPP_DEBUG(logger_, "| %s | %g | %g |", joint_name.c_str(),
-                         reference_state.getVariablePosition(joint_name),
-                         current_state->getVariablePosition(joint_name));
+            RCLCPP_DEBUG(logger_, "| %s | %g | %g |", joint_names[i].c_str(), positions[i],
+                         current_state->getVariablePosition(variable_indices[i]));
           }
           return false;
         }
@@ -995,7 +1052,7 @@ bool TrajectoryExecutionManager::validate(const TrajectoryExecutionContext& cont
 
       for (std::size_t i = 0, end = joint_names.size(); i < end; ++i)
       {
-        const moveit::core::JointModel* jm = current_state->getJointModel(joint_names[i]);
+        const moveit::core::JointModel* jm = robot_model_->getJointModel(joint_names[i]);
         if (!jm)
         {
           RCLCPP_ERROR_STREAM(logger_, "Unknown joint in trajectory: " << joint_names[i]);
@@ -1036,11 +1093,15 @@ bool TrajectoryExecutionManager::configure(TrajectoryExecutionContext& context,
     return true;
   }
 
-  reloadControllerInformation();
+  // the controllers are listed again if the information is outdated, or below if no controllers match
+  if (node_->now() - last_controller_reload_ >= DEFAULT_CONTROLLER_INFORMATION_VALIDITY_AGE)
+    reloadControllerInformation();
   std::set<std::string> actuated_joints;
 
   auto is_actuated = [this](const std::string& joint_name) -> bool {
-    const moveit::core::JointModel* jm = robot_model_->getJointOfVariable(joint_name);
+    const int variable_index = robot_model_->getVariableIndexTable().find(joint_name);
+    const moveit::core::JointModel* jm =
+        variable_index >= 0 ? robot_model_->getJointOfVariable(variable_index) : nullptr;
     return (jm && !jm->isPassive() && !jm->getMimic() && jm->getType() != moveit::core::JointModel::FIXED);
   };
   for (const std::string& joint_name : trajectory.multi_dof_joint_trajectory.joint_names)
@@ -1282,6 +1343,7 @@ void TrajectoryExecutionManager::clear()
 void TrajectoryExecutionManager::executeThread(const ExecutionCompleteCallback& callback,
                                                const PathSegmentCompleteCallback& part_callback, bool auto_clear)
 {
+  MOVEIT_TRACEPOINT_SCOPE("trajectory_execution_manager.execute");
   // if we already got a stop request before we even started anything, we abort
   if (execution_complete_)
   {
@@ -1300,9 +1362,25 @@ void TrajectoryExecutionManager::executeThread(const ExecutionCompleteCallback&
   std::size_t i = 0;
   for (; i < trajectories_.size(); ++i)
   {
-    bool epart = executePart(i);
+    // the trajectories that continue this one are sent along with it, up to trajectory 'last'
+    std::size_t last = i;
+    TrajectoryExecutionContext spliced;
+    if (splice_trajectories_)
+    {
+      spliced = *trajectories_[i];
+      while (last + 1 < trajectories_.size() && spliceContext(spliced, *trajectories_[last + 1]))
+        ++last;
+      if (last > i)
+        RCLCPP_INFO(logger_, "Splicing trajectories %zu to %zu", i, last);
+    }
+
+    bool epart = executePart(last > i ? spliced : *trajectories_[i], i);
     if (epart && part_callback)
-      part_callback(i);
+    {
+      for (std::size_t j = i; j <= last; ++j)
+        part_callback(j);
+    }
+    i = last;
     if (!epart || execution_complete_)
     {
       ++i;
@@ -1331,9 +1409,57 @@ void TrajectoryExecutionManager::executeThread(const ExecutionCompleteCallback&
     callback(last_execution_status_);
 }
 
-bool TrajectoryExecutionManager::executePart(std::size_t part_index)
+bool TrajectoryExecutionManager::spliceContext(TrajectoryExecutionContext& context,
+                                               const TrajectoryExecutionContext& next) const
+{
+  if (context.controllers_ != next.controllers_ || context.trajectory_parts_.size() != next.trajectory_parts_.size())
+    return false;
+
+  for (std::size_t i = 0; i < context.trajectory_parts_.size(); ++i)
+  {
+    const trajectory_msgs::msg::JointTrajectory& trajectory = context.trajectory_parts_[i].joint_trajectory;
+    const trajectory_msgs::msg::JointTrajectory& next_trajectory = next.trajectory_parts_[i].joint_trajectory;
+    // multi-dof trajectories and trajectories with their own start time are executed on their own
+    if (!context.trajectory_parts_[i].multi_dof_joint_trajectory.points.empty() ||
+        !next.trajectory_parts_[i].multi_dof_joint_trajectory.points.empty() || next_trajectory.header.stamp.sec != 0 ||
+        next_trajectory.header.stamp.nanosec != 0 || trajectory.points.empty() || next_trajectory.points.empty() ||
+        trajectory.joint_names != next_trajectory.joint_names)
+      return false;
+
+    // the next trajectory needs to start where this one ends, at the same velocity if both specify it
+    const trajectory_msgs::msg::JointTrajectoryPoint& end = trajectory.points.back();
+    const trajectory_msgs::msg::JointTrajectoryPoint& start = next_trajectory.points.front();
+    for (std::size_t j = 0; j < trajectory.joint_names.size(); ++j)
+    {
+      const moveit::core::JointModel* jm = robot_model_->getJointOfVariable(trajectory.joint_names[j]);
+      if (!jm || jm->getVariableCount() != 1 || j >= end.positions.size() || j >= start.positions.size() ||
+          fabs(jm->distance(&end.positions[j], &start.positions[j])) > allowed_start_tolerance_)
+        return false;
+      if (j < end.velocities.size() && j < start.velocities.size() &&
+          fabs(end.velocities[j] - start.velocities[j]) > SPLICE_VELOCITY_TOLERANCE)
+        return false;
+    }
+  }
+
+  for (std::size_t i = 0; i < context.trajectory_parts_.size(); ++i)
+  {
+    std::vector<trajectory_msgs::msg::JointTrajectoryPoint>& points =
+        context.trajectory_parts_[i].joint_trajectory.points;
+    const std::vector<trajectory_msgs::msg::JointTrajectoryPoint>& next_points =
+        next.trajectory_parts_[i].joint_trajectory.points;
+    const rclcpp::Duration offset(points.back().time_from_start);
+    // the first point of the next trajectory is the last point of this one
+    for (std::size_t j = 1; j < next_points.size(); ++j)
+    {
+      points.push_back(next_points[j]);
+      points.back().time_from_start = offset + rclcpp::Duration(next_points[j].time_from_start);
+    }
+  }
+  return true;
+}
+
+bool TrajectoryExecutionManager::executePart(const TrajectoryExecutionContext& context, std::size_t part_index)
 {
-  TrajectoryExecutionContext& context = *trajectories_[part_index];
 
   // first make sure desired controllers are active
   if (ensureActiveControllers(context.controllers_))
@@ -1347,10 +1473,7 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
       std::scoped_lock slock(execution_state_mutex_);
       if (!execution_complete_)
       {
-        // time indexing uses this member too, so we lock this mutex as well
-        time_index_mutex_.lock();
-        current_context_ = part_index;
-        time_index_mutex_.unlock();
+        publishTimeIndex(part_index);
         active_handles_.resize(context.controllers_.size());
         for (std::size_t i = 0; i < context.controllers_.size(); ++i)
         {
@@ -1366,7 +1489,7 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
           if (!h)
           {
             active_handles_.clear();
-            current_context_ = -1;
+            publishTimeIndex(-1);
             last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
             RCLCPP_ERROR(logger_, "No controller handle for controller '%s'. Aborting.",
                          context.controllers_[i].c_str());
@@ -1404,7 +1527,7 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
             if (i > 0)
               RCLCPP_ERROR(logger_, "Cancelling previously sent trajectory parts");
             active_handles_.clear();
-            current_context_ = -1;
+            publishTimeIndex(-1);
             last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
             return false;
           }
@@ -1469,17 +1592,16 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
     // construct a map from expected time to state index, for easy access to expected state location
     if (longest_part >= 0)
     {
-      std::scoped_lock slock(time_index_mutex_);
-
+      std::vector<rclcpp::Time> time_index;
       if (context.trajectory_parts_[longest_part].joint_trajectory.points.size() >=
           context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points.size())
       {
         auto d = rclcpp::Duration::from_seconds(0);
         if (rclcpp::Time(context.trajectory_parts_[longest_part].joint_trajectory.header.stamp) > current_time)
           d = rclcpp::Time(context.trajectory_parts_[longest_part].joint_trajectory.header.stamp) - current_time;
-        for (trajectory_msgs::msg::JointTrajectoryPoint& point :
+        for (const trajectory_msgs::msg::JointTrajectoryPoint& point :
              context.trajectory_parts_[longest_part].joint_trajectory.points)
-          time_index_.push_back(current_time + d + rclcpp::Duration(point.time_from_start));
+          time_index.push_back(current_time + d + rclcpp::Duration(point.time_from_start));
       }
       else
       {
@@ -1489,10 +1611,11 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
           d = rclcpp::Time(context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.header.stamp) -
               current_time;
         }
-        for (trajectory_msgs::msg::MultiDOFJointTrajectoryPoint& point :
+        for (const trajectory_msgs::msg::MultiDOFJointTrajectoryPoint& point :
              context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points)
-          time_index_.push_back(current_time + d + rclcpp::Duration(point.time_from_start));
+          time_index.push_back(current_time + d + rclcpp::Duration(point.time_from_start));
       }
+      publishTimeIndex(part_index, std::move(time_index));
     }
 
     bool result = true;
@@ -1542,10 +1665,7 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
     active_handles_.clear();
 
     // clear the time index
-    time_index_mutex_.lock();
-    time_index_.clear();
-    current_context_ = -1;
-    time_index_mutex_.unlock();
+    publishTimeIndex(-1);
 
     execution_state_mutex_.unlock();
     return result;
@@ -1621,15 +1741,37 @@ bool TrajectoryExecutionManager::waitForRobotToStop(const TrajectoryExecutionCon
 
 std::pair<int, int> TrajectoryExecutionManager::getCurrentExpectedTrajectoryIndex() const
 {
-  std::scoped_lock slock(time_index_mutex_);
-  if (current_context_ < 0)
+  const std::shared_ptr<const TimeIndex> time_index = std::atomic_load(&time_index_);
+  if (time_index->context < 0)
     return std::make_pair(-1, -1);
-  if (time_index_.empty())
-    return std::make_pair(static_cast<int>(current_context_), -1);
+  if (time_index->times.empty())
+    return std::make_pair(time_index->context, -1);
   std::vector<rclcpp::Time>::const_iterator time_index_it =
-      std::lower_bound(time_index_.begin(), time_index_.end(), node_->now());
-  int pos = time_index_it - time_index_.begin();
-  return std::make_pair(static_cast<int>(current_context_), pos);
+      std::lower_bound(time_index->times.begin(), time_index->times.end(), node_->now());
+  int pos = time_index_it - time_index->times.begin();
+  return std::make_pair(time_index->context, pos);
+}
+
+void TrajectoryExecutionManager::publishTimeIndex(int context, std::vector<rclcpp::Time> times)
+{
+  auto time_index = std::make_shared<TimeIndex>();
+  time_index->context = context;
+  time_index->times = std::move(times);
+  std::atomic_store(&time_index_, std::shared_ptr<const TimeIndex>(std::move(time_index)));
+}
+
+void TrajectoryExecutionManager::setProgressCallback(const ProgressCallback& callback, double rate)
+{
+  progress_timer_.reset();
+  if (!callback || rate <= 0.0)
+    return;
+  progress_timer_ = node_->create_wall_timer(
+      std::chrono::duration<double>(1.0 / rate), [this, callback, last = std::make_pair(-1, -1)]() mutable {
+        const std::pair<int, int> progress = getCurrentExpectedTrajectoryIndex();
+        if (progress.first >= 0 && progress != last)
+          callback(progress);
+        last = progress;
+      });
 }
 
 const std::vector<TrajectoryExecutionManager::TrajectoryExecutionContext*>&
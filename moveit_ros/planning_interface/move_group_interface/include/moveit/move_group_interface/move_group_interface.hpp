@@ -54,6 +54,7 @@
 
 #include <rclcpp_action/rclcpp_action.hpp>
 
+#include <future>
 #include <memory>
 #include <utility>
 #include <tf2_ros/buffer.h>
@@ -116,6 +117,15 @@ public:
     double planning_time;
   };
 
+  /// \brief The outcome of an asynchronous planning request
+  struct PlanResult
+  {
+    moveit::core::MoveItErrorCode error_code;
+
+    /// The plan, only filled if planning succeeded
+    Plan plan{};
+  };
+
   /**
       \brief Construct a MoveGroupInterface instance call using a specified set of options \e opt.
 
@@ -716,6 +726,30 @@ public:
       target. No execution is performed. The resulting plan is stored in \e plan*/
   moveit::core::MoveItErrorCode plan(Plan& plan);
 
+  /** \name Asynchronous requests
+   *  The requests are built from the settings of the interface at the time of the call, so the next request can be
+   *  configured and sent while the previous one is processed, e.g. planning from the end of the executing trajectory.
+   *  The futures are resolved by the callbacks of the interface's executor. Requests still pending when the interface
+   *  is destroyed end with a std::future_error (broken promise).
+   */
+  /**@{*/
+
+  /** \brief Compute a motion plan like plan(), without waiting for the result */
+  std::shared_future<PlanResult> planAsync();
+
+  /** \brief Plan and execute a trajectory like move(), the future is resolved when the execution ends */
+  std::shared_future<moveit::core::MoveItErrorCode> moveAsync();
+
+  /** \brief Execute a \e plan like execute(), the future is resolved when the execution ends */
+  std::shared_future<moveit::core::MoveItErrorCode>
+  executeAsync(const Plan& plan, const std::vector<std::string>& controllers = std::vector<std::string>());
+
+  /** \brief Execute a \e trajectory like execute(), the future is resolved when the execution ends */
+  std::shared_future<moveit::core::MoveItErrorCode>
+  executeAsync(const moveit_msgs::msg::RobotTrajectory& trajectory,
+               const std::vector<std::string>& controllers = std::vector<std::string>());
+  /**@}*/
+
   /** \brief Given a \e plan, execute it without waiting for completion.
    *  \param [in] plan The motion plan for which to execute
    *  \param [in] controllers An optional list of ros2_controllers to execute with. If none, MoveIt will attempt to find
@@ -38,6 +38,7 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <future>
 #include <memory>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 #include <moveit/warehouse/constraints_storage.hpp>
@@ -646,89 +647,105 @@ public:
     return true;
   }
 
-  moveit::core::MoveItErrorCode plan(Plan& plan)
+  /** \brief Send an action goal, the returned future is resolved with the converted result or with \e failure if the
+   * goal is rejected or has no result. The future doesn't refer to this instance. */
+  template <typename ActionT, typename ResultT, typename ConvertFn>
+  std::shared_future<ResultT> sendGoal(rclcpp_action::Client<ActionT>& client, const typename ActionT::Goal& goal,
+                                       const std::string& request, const ResultT& failure, ConvertFn convert)
   {
-    if (!move_action_client_ || !move_action_client_->action_server_is_ready())
-    {
-      RCLCPP_INFO_STREAM(logger_, "MoveGroup action client/server not ready");
-      return moveit::core::MoveItErrorCode::FAILURE;
-    }
-    RCLCPP_INFO_STREAM(logger_, "MoveGroup action client/server ready");
-
-    moveit_msgs::action::MoveGroup::Goal goal;
-    constructGoal(goal);
-    goal.planning_options.plan_only = true;
-    goal.planning_options.look_around = false;
-    goal.planning_options.replan = false;
-    goal.planning_options.planning_scene_diff.is_diff = true;
-    goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
-
-    bool done = false;
-    rclcpp_action::ResultCode code = rclcpp_action::ResultCode::UNKNOWN;
-    std::shared_ptr<moveit_msgs::action::MoveGroup::Result> res;
-    auto send_goal_opts = rclcpp_action::Client<moveit_msgs::action::MoveGroup>::SendGoalOptions();
-
+    auto promise = std::make_shared<std::promise<ResultT>>();
+    std::shared_future<ResultT> future = promise->get_future().share();
+    typename rclcpp_action::Client<ActionT>::SendGoalOptions send_goal_opts;
     send_goal_opts.goal_response_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::SharedPtr& goal_handle) {
+        [logger = logger_, promise, request,
+         failure](const typename rclcpp_action::ClientGoalHandle<ActionT>::SharedPtr& goal_handle) {
           if (!goal_handle)
           {
-            done = true;
-            RCLCPP_INFO(logger_, "Planning request rejected");
+            RCLCPP_INFO(logger, "%s request rejected", request.c_str());
+            promise->set_value(failure);
           }
           else
-            RCLCPP_INFO(logger_, "Planning request accepted");
+            RCLCPP_INFO(logger, "%s request accepted", request.c_str());
         };
     send_goal_opts.result_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::WrappedResult& result) {
-          res = result.result;
-          code = result.code;
-          done = true;
-
+        [logger = logger_, promise, request, failure,
+         convert](const typename rclcpp_action::ClientGoalHandle<ActionT>::WrappedResult& result) {
           switch (result.code)
           {
             case rclcpp_action::ResultCode::SUCCEEDED:
-              RCLCPP_INFO(logger_, "Planning request complete!");
+              RCLCPP_INFO(logger, "%s request complete!", request.c_str());
               break;
             case rclcpp_action::ResultCode::ABORTED:
-              RCLCPP_INFO(logger_, "Planning request aborted");
-              return;
+              RCLCPP_INFO(logger, "%s request aborted", request.c_str());
+              break;
             case rclcpp_action::ResultCode::CANCELED:
-              RCLCPP_INFO(logger_, "Planning request canceled");
-              return;
+              RCLCPP_INFO(logger, "%s request canceled", request.c_str());
+              break;
             default:
-              RCLCPP_INFO(logger_, "Planning request unknown result code");
-              return;
+              RCLCPP_INFO(logger, "%s request unknown result code", request.c_str());
+              break;
           }
+          promise->set_value(result.result ? convert(result) : failure);
         };
+    client.async_send_goal(goal, send_goal_opts);
+    return future;
+  }
 
-    auto goal_handle_future = move_action_client_->async_send_goal(goal, send_goal_opts);
-
-    // wait until send_goal_opts.result_callback is called
-    while (!done)
+  std::shared_future<PlanResult> planAsync()
+  {
+    PlanResult failure;
+    failure.error_code = moveit::core::MoveItErrorCode::FAILURE;
+    if (!move_action_client_ || !move_action_client_->action_server_is_ready())
     {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      RCLCPP_INFO_STREAM(logger_, "MoveGroup action client/server not ready");
+      std::promise<PlanResult> promise;
+      promise.set_value(failure);
+      return promise.get_future().share();
     }
+    RCLCPP_INFO_STREAM(logger_, "MoveGroup action client/server ready");
 
-    if (code != rclcpp_action::ResultCode::SUCCEEDED)
-    {
-      RCLCPP_ERROR_STREAM(logger_, "MoveGroupInterface::plan() failed or timeout reached");
-      return res->error_code;
-    }
+    moveit_msgs::action::MoveGroup::Goal goal;
+    constructGoal(goal);
+    goal.planning_options.plan_only = true;
+    goal.planning_options.look_around = false;
+    goal.planning_options.replan = false;
+    goal.planning_options.planning_scene_diff.is_diff = true;
+    goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    plan.trajectory = res->planned_trajectory;
-    plan.start_state = res->trajectory_start;
-    plan.planning_time = res->planning_time;
-    RCLCPP_INFO(logger_, "time taken to generate plan: %g seconds", plan.planning_time);
+    return sendGoal(
+        *move_action_client_, goal, "Planning", failure,
+        [logger = logger_](const auto& result) {
+          PlanResult plan_result;
+          plan_result.error_code = result.result->error_code;
+          if (result.code != rclcpp_action::ResultCode::SUCCEEDED)
+          {
+            RCLCPP_ERROR_STREAM(logger, "MoveGroupInterface::plan() failed or timeout reached");
+            return plan_result;
+          }
+          plan_result.plan.trajectory = result.result->planned_trajectory;
+          plan_result.plan.start_state = result.result->trajectory_start;
+          plan_result.plan.planning_time = result.result->planning_time;
+          RCLCPP_INFO(logger, "time taken to generate plan: %g seconds", plan_result.plan.planning_time);
+          return plan_result;
+        });
+  }
 
-    return res->error_code;
+  moveit::core::MoveItErrorCode plan(Plan& plan)
+  {
+    const PlanResult& result = planAsync().get();
+    if (result.error_code)
+      plan = result.plan;
+    return result.error_code;
   }
 
-  moveit::core::MoveItErrorCode move(bool wait)
+  std::shared_future<moveit::core::MoveItErrorCode> moveAsync()
   {
     if (!move_action_client_ || !move_action_client_->action_server_is_ready())
     {
       RCLCPP_INFO_STREAM(logger_, "MoveGroup action client/server not ready");
-      return moveit::core::MoveItErrorCode::FAILURE;
+      std::promise<moveit::core::MoveItErrorCode> promise;
+      promise.set_value(moveit::core::MoveItErrorCode::FAILURE);
+      return promise.get_future().share();
     }
 
     moveit_msgs::action::MoveGroup::Goal goal;
@@ -740,126 +757,60 @@ public:
     goal.planning_options.planning_scene_diff.is_diff = true;
     goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    bool done = false;
-    rclcpp_action::ResultCode code = rclcpp_action::ResultCode::UNKNOWN;
-    std::shared_ptr<moveit_msgs::action::MoveGroup_Result> res;
-    auto send_goal_opts = rclcpp_action::Client<moveit_msgs::action::MoveGroup>::SendGoalOptions();
-
-    send_goal_opts.goal_response_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::SharedPtr& goal_handle) {
-          if (!goal_handle)
+    return sendGoal(
+        *move_action_client_, goal, "Plan and Execute",
+        moveit::core::MoveItErrorCode(moveit::core::MoveItErrorCode::FAILURE),
+        [logger = logger_](const auto& result) {
+          if (result.code != rclcpp_action::ResultCode::SUCCEEDED)
           {
-            done = true;
-            RCLCPP_INFO(logger_, "Plan and Execute request rejected");
+            RCLCPP_ERROR_STREAM(logger, "MoveGroupInterface::move() failed or timeout reached");
           }
-          else
-            RCLCPP_INFO(logger_, "Plan and Execute request accepted");
-        };
-    send_goal_opts.result_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::MoveGroup>::WrappedResult& result) {
-          res = result.result;
-          code = result.code;
-          done = true;
+          return moveit::core::MoveItErrorCode(result.result->error_code);
+        });
+  }
 
-          switch (result.code)
-          {
-            case rclcpp_action::ResultCode::SUCCEEDED:
-              RCLCPP_INFO(logger_, "Plan and Execute request complete!");
-              break;
-            case rclcpp_action::ResultCode::ABORTED:
-              RCLCPP_INFO(logger_, "Plan and Execute request aborted");
-              return;
-            case rclcpp_action::ResultCode::CANCELED:
-              RCLCPP_INFO(logger_, "Plan and Execute request canceled");
-              return;
-            default:
-              RCLCPP_INFO(logger_, "Plan and Execute request unknown result code");
-              return;
-          }
-        };
-    auto goal_handle_future = move_action_client_->async_send_goal(goal, send_goal_opts);
+  moveit::core::MoveItErrorCode move(bool wait)
+  {
+    const std::shared_future<moveit::core::MoveItErrorCode> result = moveAsync();
     if (!wait)
       return moveit::core::MoveItErrorCode::SUCCESS;
-
-    // wait until send_goal_opts.result_callback is called
-    while (!done)
-    {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-
-    if (code != rclcpp_action::ResultCode::SUCCEEDED)
-    {
-      RCLCPP_ERROR_STREAM(logger_, "MoveGroupInterface::move() failed or timeout reached");
-    }
-    return res->error_code;
+    return result.get();
   }
 
-  moveit::core::MoveItErrorCode execute(const moveit_msgs::msg::RobotTrajectory& trajectory, bool wait,
-                                        const std::vector<std::string>& controllers = std::vector<std::string>())
+  std::shared_future<moveit::core::MoveItErrorCode>
+  executeAsync(const moveit_msgs::msg::RobotTrajectory& trajectory,
+               const std::vector<std::string>& controllers = std::vector<std::string>())
   {
     if (!execute_action_client_ || !execute_action_client_->action_server_is_ready())
     {
       RCLCPP_INFO_STREAM(logger_, "execute_action_client_ client/server not ready");
-      return moveit::core::MoveItErrorCode::FAILURE;
+      std::promise<moveit::core::MoveItErrorCode> promise;
+      promise.set_value(moveit::core::MoveItErrorCode::FAILURE);
+      return promise.get_future().share();
     }
 
-    bool done = false;
-    rclcpp_action::ResultCode code = rclcpp_action::ResultCode::UNKNOWN;
-    std::shared_ptr<moveit_msgs::action::ExecuteTrajectory_Result> res;
-    auto send_goal_opts = rclcpp_action::Client<moveit_msgs::action::ExecuteTrajectory>::SendGoalOptions();
-
-    send_goal_opts.goal_response_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::ExecuteTrajectory>::SharedPtr& goal_handle) {
-          if (!goal_handle)
-          {
-            done = true;
-            RCLCPP_INFO(logger_, "Execute request rejected");
-          }
-          else
-            RCLCPP_INFO(logger_, "Execute request accepted");
-        };
-    send_goal_opts.result_callback =
-        [&](const rclcpp_action::ClientGoalHandle<moveit_msgs::action::ExecuteTrajectory>::WrappedResult& result) {
-          res = result.result;
-          code = result.code;
-          done = true;
-
-          switch (result.code)
-          {
-            case rclcpp_action::ResultCode::SUCCEEDED:
-              RCLCPP_INFO(logger_, "Execute request success!");
-              break;
-            case rclcpp_action::ResultCode::ABORTED:
-              RCLCPP_INFO(logger_, "Execute request aborted");
-              return;
-            case rclcpp_action::ResultCode::CANCELED:
-              RCLCPP_INFO(logger_, "Execute request canceled");
-              return;
-            default:
-              RCLCPP_INFO(logger_, "Execute request unknown result code");
-              return;
-          }
-        };
-
     moveit_msgs::action::ExecuteTrajectory::Goal goal;
     goal.trajectory = trajectory;
     goal.controller_names = controllers;
 
-    auto goal_handle_future = execute_action_client_->async_send_goal(goal, send_goal_opts);
+    return sendGoal(
+        *execute_action_client_, goal, "Execute", moveit::core::MoveItErrorCode(moveit::core::MoveItErrorCode::FAILURE),
+        [logger = logger_](const auto& result) {
+          if (result.code != rclcpp_action::ResultCode::SUCCEEDED)
+          {
+            RCLCPP_ERROR_STREAM(logger, "MoveGroupInterface::execute() failed or timeout reached");
+          }
+          return moveit::core::MoveItErrorCode(result.result->error_code);
+        });
+  }
+
+  moveit::core::MoveItErrorCode execute(const moveit_msgs::msg::RobotTrajectory& trajectory, bool wait,
+                                        const std::vector<std::string>& controllers = std::vector<std::string>())
+  {
+    const std::shared_future<moveit::core::MoveItErrorCode> result = executeAsync(trajectory, controllers);
     if (!wait)
       return moveit::core::MoveItErrorCode::SUCCESS;
-
-    // wait until send_goal_opts.result_callback is called
-    while (!done)
-    {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-
-    if (code != rclcpp_action::ResultCode::SUCCEEDED)
-    {
-      RCLCPP_ERROR_STREAM(logger_, "MoveGroupInterface::execute() failed or timeout reached");
-    }
-    return res->error_code;
+    return result.get();
   }
 
   double computeCartesianPath(const std::vector<geometry_msgs::msg::Pose>& waypoints, double step,
@@ -1449,6 +1400,29 @@ moveit::core::MoveItErrorCode MoveGroupInterface::plan(Plan& plan)
   return impl_->plan(plan);
 }
 
+std::shared_future<MoveGroupInterface::PlanResult> MoveGroupInterface::planAsync()
+{
+  return impl_->planAsync();
+}
+
+std::shared_future<moveit::core::MoveItErrorCode> MoveGroupInterface::moveAsync()
+{
+  return impl_->moveAsync();
+}
+
+std::shared_future<moveit::core::MoveItErrorCode>
+MoveGroupInterface::executeAsync(const Plan& plan, const std::vector<std::string>& controllers)
+{
+  return impl_->executeAsync(plan.trajectory, controllers);
+}
+
+std::shared_future<moveit::core::MoveItErrorCode>
+MoveGroupInterface::executeAsync(const moveit_msgs::msg::RobotTrajectory& trajectory,
+                                 const std::vector<std::string>& controllers)
+{
+  return impl_->executeAsync(trajectory, controllers);
+}
+
 double MoveGroupInterface::computeCartesianPath(const std::vector<geometry_msgs::msg::Pose>& waypoints, double eef_step,
                                                 moveit_msgs::msg::RobotTrajectory& trajectory, bool avoid_collisions,
                                                 moveit_msgs::msg::MoveItErrorCodes* error_code)
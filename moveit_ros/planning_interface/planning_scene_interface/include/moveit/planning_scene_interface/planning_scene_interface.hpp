@@ -42,6 +42,7 @@
 #include <moveit_msgs/msg/collision_object.hpp>
 #include <moveit_msgs/msg/attached_collision_object.hpp>
 #include <moveit_msgs/msg/planning_scene.hpp>
+#include <future>
 
 namespace moveit
 {
@@ -114,6 +115,13 @@ public:
       const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
       const std::vector<moveit_msgs::msg::ObjectColor>& object_colors = std::vector<moveit_msgs::msg::ObjectColor>());
 
+  /** \brief Apply collision objects to the planning scene of the move_group node as a single diff, without blocking.
+      The returned future becomes ready once move_group applied the diff, and holds whether that succeeded.
+      If object_colors do not specify an id, the corresponding object id from collision_objects is used. */
+  std::shared_future<bool> applyCollisionObjectsAsync(
+      const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
+      const std::vector<moveit_msgs::msg::ObjectColor>& object_colors = std::vector<moveit_msgs::msg::ObjectColor>());
+
   /** \brief Apply attached collision object to the planning scene of the move_group node synchronously.
       Other PlanningSceneMonitors will NOT receive the update unless they subscribe to move_group's monitored scene */
   bool applyAttachedCollisionObject(const moveit_msgs::msg::AttachedCollisionObject& attached_collision_object);
@@ -127,6 +135,10 @@ public:
       Other PlanningSceneMonitors will NOT receive the update unless they subscribe to move_group's monitored scene */
   bool applyPlanningScene(const moveit_msgs::msg::PlanningScene& ps);
 
+  /** \brief Update the planning_scene of the move_group node with the given ps, without blocking.
+      The returned future becomes ready once move_group applied the update, and holds whether that succeeded. */
+  std::shared_future<bool> applyPlanningSceneAsync(const moveit_msgs::msg::PlanningScene& ps);
+
   /** \brief Add collision objects to the world via /planning_scene.
       Make sure object.operation is set to object.ADD.
 
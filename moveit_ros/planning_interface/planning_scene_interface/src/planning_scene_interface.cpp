@@ -41,12 +41,56 @@
 #include <algorithm>
 #include <rclcpp/executors.hpp>
 #include <rclcpp/future_return_code.hpp>
+#include <rclcpp/version.h>
 #include <moveit/utils/logger.hpp>
+#include <thread>
 
 namespace moveit
 {
 namespace planning_interface
 {
+namespace
+{
+// Function to support both Rolling and Humble on the main branch
+// Rolling has deprecated the version of the create_client method that takes
+// rmw_qos_profile_services_default for the QoS argument
+#if RCLCPP_VERSION_GTE(17, 0, 0)  // Rolling
+auto qosDefault()
+{
+  return rclcpp::SystemDefaultsQoS();
+}
+#else  // Humble
+auto qosDefault()
+{
+  return rmw_qos_profile_services_default;
+}
+#endif
+
+// Build a single diff adding the objects, with colors that don't specify an id applying to the corresponding object
+moveit_msgs::msg::PlanningScene
+collisionObjectsDiff(const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
+                     const std::vector<moveit_msgs::msg::ObjectColor>& object_colors)
+{
+  moveit_msgs::msg::PlanningScene ps;
+  ps.robot_state.is_diff = true;
+  ps.is_diff = true;
+  ps.world.collision_objects = collision_objects;
+  ps.object_colors = object_colors;
+
+  for (size_t i = 0; i < ps.object_colors.size(); ++i)
+  {
+    if (ps.object_colors[i].id.empty() && i < collision_objects.size())
+    {
+      ps.object_colors[i].id = collision_objects[i].id;
+    }
+    else
+    {
+      break;
+    }
+  }
+  return ps;
+}
+}  // namespace
 
 class PlanningSceneInterface::PlanningSceneInterfaceImpl
 {
@@ -65,6 +109,14 @@ public:
     apply_planning_scene_service_ =
         node_->create_client<moveit_msgs::srv::ApplyPlanningScene>(move_group::APPLY_PLANNING_SCENE_SERVICE_NAME);
 
+    // responses of asynchronous requests are handled by a separate executor, the blocking calls spin the node
+    callback_group_ = node_->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive,
+                                                   false /* don't spin with node executor */);
+    callback_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+    callback_thread_ = std::thread([this]() { callback_executor_.spin(); });
+    async_apply_planning_scene_service_ = node_->create_client<moveit_msgs::srv::ApplyPlanningScene>(
+        move_group::APPLY_PLANNING_SCENE_SERVICE_NAME, qosDefault(), callback_group_);
+
     if (wait)
     {
       waitForService(std::static_pointer_cast<rclcpp::ClientBase>(planning_scene_service_));
@@ -72,6 +124,13 @@ public:
     }
   }
 
+  ~PlanningSceneInterfaceImpl()
+  {
+    callback_executor_.cancel();
+    if (callback_thread_.joinable())
+      callback_thread_.join();
+  }
+
   std::vector<std::string> getKnownObjectNames(bool with_type)
   {
     auto request = std::make_shared<moveit_msgs::srv::GetPlanningScene::Request>();
@@ -243,6 +302,20 @@ public:
     return response->success;
   }
 
+  std::shared_future<bool> applyPlanningSceneAsync(const moveit_msgs::msg::PlanningScene& planning_scene)
+  {
+    auto request = std::make_shared<moveit_msgs::srv::ApplyPlanningScene::Request>();
+    request->scene = planning_scene;
+
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::shared_future<bool> future = promise->get_future().share();
+    async_apply_planning_scene_service_->async_send_request(
+        request, [promise](rclcpp::Client<moveit_msgs::srv::ApplyPlanningScene>::SharedFuture response) {
+          promise->set_value(response.get()->success);
+        });
+    return future;
+  }
+
   void addCollisionObjects(const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
                            const std::vector<moveit_msgs::msg::ObjectColor>& object_colors) const
   {
@@ -300,6 +373,11 @@ private:
   rclcpp::Client<moveit_msgs::srv::ApplyPlanningScene>::SharedPtr apply_planning_scene_service_;
   rclcpp::Publisher<moveit_msgs::msg::PlanningScene>::SharedPtr planning_scene_diff_publisher_;
   moveit::core::RobotModelConstPtr robot_model_;
+
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
+  rclcpp::executors::SingleThreadedExecutor callback_executor_;
+  std::thread callback_thread_;
+  rclcpp::Client<moveit_msgs::srv::ApplyPlanningScene>::SharedPtr async_apply_planning_scene_service_;
 };
 
 PlanningSceneInterface::PlanningSceneInterface(const std::string& ns, bool wait)
@@ -372,25 +450,14 @@ bool PlanningSceneInterface::applyCollisionObjects(
     const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
     const std::vector<moveit_msgs::msg::ObjectColor>& object_colors)
 {
-  moveit_msgs::msg::PlanningScene ps;
-  ps.robot_state.is_diff = true;
-  ps.is_diff = true;
-  ps.world.collision_objects = collision_objects;
-  ps.object_colors = object_colors;
-
-  for (size_t i = 0; i < ps.object_colors.size(); ++i)
-  {
-    if (ps.object_colors[i].id.empty() && i < collision_objects.size())
-    {
-      ps.object_colors[i].id = collision_objects[i].id;
-    }
-    else
-    {
-      break;
-    }
-  }
+  return applyPlanningScene(collisionObjectsDiff(collision_objects, object_colors));
+}
 
-  return applyPlanningScene(ps);
+std::shared_future<bool> PlanningSceneInterface::applyCollisionObjectsAsync(
+    const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
+    const std::vector<moveit_msgs::msg::ObjectColor>& object_colors)
+{
+  return impl_->applyPlanningSceneAsync(collisionObjectsDiff(collision_objects, object_colors));
 }
 
 bool PlanningSceneInterface::applyAttachedCollisionObject(
@@ -419,6 +486,11 @@ bool PlanningSceneInterface::applyPlanningScene(const moveit_msgs::msg::Planning
   return impl_->applyPlanningScene(ps);
 }
 
+std::shared_future<bool> PlanningSceneInterface::applyPlanningSceneAsync(const moveit_msgs::msg::PlanningScene& ps)
+{
+  return impl_->applyPlanningSceneAsync(ps);
+}
+
 void PlanningSceneInterface::addCollisionObjects(const std::vector<moveit_msgs::msg::CollisionObject>& collision_objects,
                                                  const std::vector<moveit_msgs::msg::ObjectColor>& object_colors) const
 {
@@ -188,6 +188,12 @@ public:
    * end-effectors and joints. */
   void clearLastMarkerPoses();
 
+  /** \brief Notify the handler that a newer pose update for the marker \e marker_name was received.
+   * An IK search that handleEndEffector() is still running for an older pose of that marker then stops at the next
+   * solution it finds, without checking the state validity callback and without notifying the update callback.
+   * RobotInteraction calls this whenever it queues a pose update. */
+  void notifyPoseUpdate(const std::string& marker_name);
+
   /** \brief Update the internal state maintained by the handler using
    * information from the received feedback message. */
   virtual void handleEndEffector(const EndEffectorInteraction& eef,
@@ -237,8 +243,10 @@ private:
 
   // Update RobotState for a new pose of an eef.
   // YOU MUST LOCK state_lock_ BEFORE CALLING THIS.
+  // The IK search stops early and no callback is set once \e superseded returns true.
   void updateStateEndEffector(moveit::core::RobotState& state, const EndEffectorInteraction& eef,
-                              const geometry_msgs::msg::Pose& pose, StateChangeCallbackFn& callback);
+                              const geometry_msgs::msg::Pose& pose, const std::function<bool()>& superseded,
+                              StateChangeCallbackFn& callback);
 
   // Update RobotState for a new joint position.
   // YOU MUST LOCK state_lock_ BEFORE CALLING THIS.
@@ -254,6 +262,9 @@ private:
    * True if Interaction \e name is not in a valid pose. */
   bool getErrorState(const std::string& name) const;
 
+  // Number of pose updates notified for the marker \e marker_name.
+  std::size_t getPoseUpdateCount(const std::string& marker_name);
+
   // Contains the (user-programmable) pose offset between the end-effector
   // parent link (or a virtual joint) and the desired control frame for the
   // interactive marker. The offset is expressed in the frame of the parent
@@ -275,6 +286,10 @@ private:
   std::mutex pose_map_lock_;
   std::mutex offset_map_lock_;
 
+  // Number of pose updates received by RobotInteraction, for each marker
+  std::map<std::string, std::size_t> pose_update_counts_;
+  std::mutex pose_update_lock_;
+
   // per group options for doing kinematics.
   // PROTECTED BY state_lock_ - The POINTER is protected by state_lock_.  The
   // CONTENTS is protected internally.
@@ -43,6 +43,7 @@
 #include <moveit/robot_state/robot_state.hpp>
 #include <moveit/robot_interaction/interaction.hpp>
 #include <rclcpp/logger.hpp>
+#include <deque>
 #include <memory>
 #include <functional>
 #include <thread>
@@ -201,7 +202,8 @@ private:
   bool run_processing_thread_;
 
   std::condition_variable new_feedback_condition_;
-  std::map<std::string, visualization_msgs::msg::InteractiveMarkerFeedback::ConstSharedPtr> feedback_map_;
+  // Pending feedback for each marker, in order of arrival. Consecutive pose updates are merged into the latest one.
+  std::map<std::string, std::deque<visualization_msgs::msg::InteractiveMarkerFeedback::ConstSharedPtr>> feedback_map_;
 
   moveit::core::RobotModelConstPtr robot_model_;
 
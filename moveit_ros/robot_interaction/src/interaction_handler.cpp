@@ -189,6 +189,19 @@ void InteractionHandler::clearLastMarkerPoses()
   pose_map_.clear();
 }
 
+void InteractionHandler::notifyPoseUpdate(const std::string& marker_name)
+{
+  std::scoped_lock slock(pose_update_lock_);
+  ++pose_update_counts_[marker_name];
+}
+
+std::size_t InteractionHandler::getPoseUpdateCount(const std::string& marker_name)
+{
+  std::scoped_lock slock(pose_update_lock_);
+  std::map<std::string, std::size_t>::const_iterator it = pose_update_counts_.find(marker_name);
+  return it != pose_update_counts_.end() ? it->second : 0;
+}
+
 void InteractionHandler::setMenuHandler(const std::shared_ptr<interactive_markers::MenuHandler>& mh)
 {
   std::scoped_lock lock(state_lock_);
@@ -246,11 +259,18 @@ void InteractionHandler::handleEndEffector(
 
   StateChangeCallbackFn callback;
 
+  // a newer pose update makes the IK solution for this one obsolete
+  const std::size_t pose_update_count = getPoseUpdateCount(feedback->marker_name);
+  const auto superseded = [this, &marker_name = feedback->marker_name, pose_update_count] {
+    return getPoseUpdateCount(marker_name) != pose_update_count;
+  };
+
   // modify the RobotState in-place with state_lock_ held.
   // This locks state_lock_ before calling updateState()
-  LockedRobotState::modifyState([this, &eef, &pose = tpose.pose, &callback](moveit::core::RobotState* state) {
-    updateStateEndEffector(*state, eef, pose, callback);
-  });
+  LockedRobotState::modifyState(
+      [this, &eef, &pose = tpose.pose, &superseded, &callback](moveit::core::RobotState* state) {
+        updateStateEndEffector(*state, eef, pose, superseded, callback);
+      });
 
   // This calls update_callback_ to notify client that state changed.
   if (callback)
@@ -306,13 +326,27 @@ void InteractionHandler::updateStateGeneric(
 
 // MUST hold state_lock_ when calling this!
 void InteractionHandler::updateStateEndEffector(moveit::core::RobotState& state, const EndEffectorInteraction& eef,
-                                                const geometry_msgs::msg::Pose& pose, StateChangeCallbackFn& callback)
+                                                const geometry_msgs::msg::Pose& pose,
+                                                const std::function<bool()>& superseded,
+                                                StateChangeCallbackFn& callback)
 {
   // This is called with state_lock_ held, so no additional locking needed to
   // access kinematic_options_map_.
   KinematicOptions kinematic_options = kinematic_options_map_->getOptions(eef.parent_group);
 
+  // Solvers only give up on a pose once their timeout expired, but they stop at the first solution that is accepted.
+  // Solutions the validity callback rejects (e.g. colliding ones) are therefore accepted once the pose is stale.
+  const moveit::core::GroupStateValidityCallbackFn validity_callback = kinematic_options.state_validity_callback_;
+  kinematic_options.state_validity_callback_ = [&superseded, &validity_callback](
+                                                   moveit::core::RobotState* robot_state,
+                                                   const moveit::core::JointModelGroup* group,
+                                                   const double* ik_solution) {
+    return superseded() || !validity_callback || validity_callback(robot_state, group, ik_solution);
+  };
+
   bool ok = kinematic_options.setStateFromIK(state, eef.parent_group, eef.parent_link, pose);
+  if (superseded())
+    return;  // the error state and the client are updated for the newer pose
   bool error_state_changed = setErrorState(eef.parent_group, !ok);
   if (update_callback_)
   {
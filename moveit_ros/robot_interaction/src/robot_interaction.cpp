@@ -758,13 +758,33 @@ void RobotInteraction::processInteractiveMarkerFeedback(
     return;
   }
 
-  feedback_map_[feedback->marker_name] = feedback;
+  // only the latest pose matters, but other events (e.g. MOUSE_UP) must still be delivered in order
+  std::deque<visualization_msgs::msg::InteractiveMarkerFeedback::ConstSharedPtr>& pending =
+      feedback_map_[feedback->marker_name];
+  using visualization_msgs::msg::InteractiveMarkerFeedback;
+  if (feedback->event_type == InteractiveMarkerFeedback::POSE_UPDATE)
+  {
+    if (!pending.empty() && pending.back()->event_type == InteractiveMarkerFeedback::POSE_UPDATE)
+      pending.back() = feedback;
+    else
+      pending.push_back(feedback);
+
+    // stop the IK search of the handler for the previous pose
+    std::map<std::string, InteractionHandlerPtr>::const_iterator jt =
+        handlers_.find(feedback->marker_name.substr(3, u - 3));
+    if (jt != handlers_.end())
+      jt->second->notifyPoseUpdate(feedback->marker_name);
+  }
+  else
+    pending.push_back(feedback);
   new_feedback_condition_.notify_all();
 }
 
 void RobotInteraction::processingThread()
 {
   std::unique_lock<std::mutex> ulock(marker_access_lock_);
+  // markers are served in turn, so that a continuously dragged marker doesn't starve the others
+  std::string last_marker;
 
   while (run_processing_thread_ && rclcpp::ok())
   {
@@ -773,8 +793,14 @@ void RobotInteraction::processingThread()
 
     while (!feedback_map_.empty() && rclcpp::ok())
     {
-      auto feedback = feedback_map_.begin()->second;
-      feedback_map_.erase(feedback_map_.begin());
+      auto next = feedback_map_.upper_bound(last_marker);
+      if (next == feedback_map_.end())
+        next = feedback_map_.begin();
+      last_marker = next->first;
+      auto feedback = next->second.front();
+      next->second.pop_front();
+      if (next->second.empty())
+        feedback_map_.erase(next);
       RCLCPP_DEBUG(logger_, "Processing feedback from map for marker [%s]", feedback->marker_name.c_str());
 
       std::map<std::string, std::size_t>::const_iterator it = shown_markers_.find(feedback->marker_name);
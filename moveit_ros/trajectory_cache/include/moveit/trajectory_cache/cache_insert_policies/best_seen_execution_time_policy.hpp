@@ -24,6 +24,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include <warehouse_ros/message_collection.h>
 #include <moveit/move_group_interface/move_group_interface.hpp>
@@ -113,6 +115,13 @@ public:
                        const moveit::planning_interface::MoveGroupInterface::Plan& value,
                        double exact_match_precision) override;
 
+  std::optional<std::vector<warehouse_ros::MessageWithMetadata<moveit_msgs::msg::RobotTrajectory>::ConstPtr>>
+  fetchMatchingIndexedEntries(
+      const moveit::planning_interface::MoveGroupInterface& move_group,
+      const std::vector<warehouse_ros::MessageWithMetadata<moveit_msgs::msg::RobotTrajectory>::ConstPtr>& entries,
+      const moveit_msgs::msg::MotionPlanRequest& key,
+      const moveit::planning_interface::MoveGroupInterface::Plan& value, double exact_match_precision) override;
+
   bool shouldPruneMatchingEntry(
       const moveit::planning_interface::MoveGroupInterface& move_group, const moveit_msgs::msg::MotionPlanRequest& key,
       const moveit::planning_interface::MoveGroupInterface::Plan& value,
@@ -217,6 +226,13 @@ public:
                        const moveit_msgs::srv::GetCartesianPath::Response& value,
                        double exact_match_precision) override;
 
+  std::optional<std::vector<warehouse_ros::MessageWithMetadata<moveit_msgs::msg::RobotTrajectory>::ConstPtr>>
+  fetchMatchingIndexedEntries(
+      const moveit::planning_interface::MoveGroupInterface& move_group,
+      const std::vector<warehouse_ros::MessageWithMetadata<moveit_msgs::msg::RobotTrajectory>::ConstPtr>& entries,
+      const moveit_msgs::srv::GetCartesianPath::Request& key,
+      const moveit_msgs::srv::GetCartesianPath::Response& value, double exact_match_precision) override;
+
   bool shouldPruneMatchingEntry(
       const moveit::planning_interface::MoveGroupInterface& move_group,
       const moveit_msgs::srv::GetCartesianPath::Request& key, const moveit_msgs::srv::GetCartesianPath::Response& value,
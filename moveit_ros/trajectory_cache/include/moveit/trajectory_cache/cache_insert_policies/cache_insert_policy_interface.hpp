@@ -21,6 +21,9 @@
 
 #pragma once
 
+#include <optional>
+#include <vector>
+
 #include <warehouse_ros/message_collection.h>
 #include <moveit/move_group_interface/move_group_interface.hpp>
 
@@ -113,7 +116,8 @@ namespace trajectory_cache
  * ^^^^^^^^^
  * The TrajectoryCache will call the following interface methods in the following order:
  *   1. sanitize, once
- *   2. fetchMatchingEntries, once
+ *   2. fetchMatchingIndexedEntries with the in-memory index, and fetchMatchingEntries, once, if it is not
+ *      implemented or the index is not used
  *   3. shouldPruneMatchingEntry, once per fetched entry from fetchMatchingEntries
  *   4. shouldInsert, once
  *   5. appendInsertMetadata, once, if shouldInsert returns true
@@ -165,6 +169,30 @@ public:
                        const warehouse_ros::MessageCollection<CacheEntryT>& coll, const KeyT& key, const ValueT& value,
                        double exact_match_precision) = 0;
 
+  /** @brief Fetches all "matching" cache entries for comparison for pruning from the metadata of all cache entries of
+   * the cache namespace, so that no database query is needed.
+   *
+   * This is used instead of fetchMatchingEntries when TrajectoryCache::Options::use_in_memory_index is set.
+   * Implementations must return the same entries in the same order, and update the same internal state, as
+   * fetchMatchingEntries. The default implementation returns std::nullopt, making the cache call
+   * fetchMatchingEntries instead.
+   *
+   * @param[in] move_group. The manipulator move group, used to get its state.
+   * @param[in] entries. The metadata of all cache entries of the cache namespace.
+   * @param[in] key. The object used to key the insertion candidate with.
+   * @param[in] value. The object that the TrajectoryCache was passed to insert.
+   * @param[in] exact_match_precision. Tolerance for float precision comparison for what counts as an exact match.
+   * @returns The metadata of matching cache entries, or std::nullopt if not supported.
+   */
+  virtual std::optional<std::vector<typename warehouse_ros::MessageWithMetadata<CacheEntryT>::ConstPtr>>
+  fetchMatchingIndexedEntries(
+      const moveit::planning_interface::MoveGroupInterface& /*move_group*/,
+      const std::vector<typename warehouse_ros::MessageWithMetadata<CacheEntryT>::ConstPtr>& /*entries*/,
+      const KeyT& /*key*/, const ValueT& /*value*/, double /*exact_match_precision*/)
+  {
+    return std::nullopt;
+  }
+
   /** @brief Returns whether a matched cache entry should be pruned.
    *
    * NOTE: The TrajectoryCache class also has some top-level logic to preserve cache entries that
@@ -0,0 +1,144 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Planning scene world features to key the trajectory cache on.
+ *
+ * These features key cache entries on a hash of the collision objects and octomap of the planning scene world, so
+ * that fetched trajectories were planned in the same world.
+ *
+ * @see FeaturesInterface<FeatureSourceT>
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include <geometry_msgs/msg/point.hpp>
+#include <moveit_msgs/msg/planning_scene_world.hpp>
+
+#include <moveit/trajectory_cache/features/features_interface.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+/** @brief Computes a hash of a planning scene world that is stable across processes and platforms.
+ *
+ * Header stamps, object colors and operations are ignored, and all coordinates and dimensions are quantized to
+ * multiples of @p resolution, so that numerically noisy copies of the same world hash identically. Collision objects
+ * are hashed in order of their IDs.
+ *
+ * Shapes of collision objects in @p frame_id (or in any frame, if it is empty) that lie entirely farther than
+ * @p radius from @p center are ignored, as are collision objects without other shapes. Collision objects in other
+ * frames and planes are always hashed. The octomap is hashed as a whole,
+ * since its serialized data is hashed without being deserialized.
+ *
+ * @param[in] world. The planning scene world to hash.
+ * @param[in] resolution. The quantization step of coordinates and dimensions, in meters.
+ * @param[in] frame_id. The frame of @p center.
+ * @param[in] center. The center of the region of the world to hash, e.g. the base of the robot.
+ * @param[in] radius. The radius of the region of the world to hash.
+ * @returns The hash, formatted as a hexadecimal string.
+ */
+std::string hashPlanningSceneWorld(const moveit_msgs::msg::PlanningSceneWorld& world, double resolution,
+                                   const std::string& frame_id = "",
+                                   const geometry_msgs::msg::Point& center = geometry_msgs::msg::Point(),
+                                   double radius = std::numeric_limits<double>::infinity());
+
+/** @class PlanningSceneWorldFeatures<FeatureSourceT>
+ * @brief Keys cache entries on a hash of the planning scene world near the robot.
+ *
+ * The world is obtained from a user-supplied function at insert and fetch time, e.g. from the world message of a
+ * planning scene monitor, since neither the plan request nor the move group carry it. A fetched trajectory was then
+ * inserted with an identical world near the robot, up to the quantization @p resolution, so it does not need to be
+ * fully re-validated for collisions with the world. Attached objects and the robot state are not part of the hash.
+ *
+ * Fuzzy and exact fetches both require the hash to be equal.
+ *
+ * @see hashPlanningSceneWorld
+ */
+template <typename FeatureSourceT>
+class PlanningSceneWorldFeatures final : public FeaturesInterface<FeatureSourceT>
+{
+public:
+  using WorldProvider = std::function<moveit_msgs::msg::PlanningSceneWorld()>;
+
+  /**
+   * @param[in] world_provider. Returns the current planning scene world.
+   * @param[in] resolution. The quantization step of coordinates and dimensions, in meters.
+   * @param[in] frame_id. The frame of @p center, usually the planning frame.
+   * @param[in] center. The center of the region of the world to hash.
+   * @param[in] radius. The radius of the region of the world to hash, e.g. the reach of the robot.
+   */
+  PlanningSceneWorldFeatures(WorldProvider world_provider, double resolution, std::string frame_id = "",
+                             geometry_msgs::msg::Point center = geometry_msgs::msg::Point(),
+                             double radius = std::numeric_limits<double>::infinity())
+    : name_("PlanningSceneWorldFeatures")
+    , world_provider_(std::move(world_provider))
+    , resolution_(resolution)
+    , frame_id_(std::move(frame_id))
+    , center_(center)
+    , radius_(radius)
+  {
+  }
+
+  std::string getName() const override
+  {
+    return name_;
+  }
+
+  moveit::core::MoveItErrorCode
+  appendFeaturesAsFuzzyFetchQuery(warehouse_ros::Query& query, const FeatureSourceT& source,
+                                  const moveit::planning_interface::MoveGroupInterface& move_group,
+                                  double exact_match_precision) const override
+  {
+    return appendFeaturesAsExactFetchQuery(query, source, move_group, exact_match_precision);
+  }
+
+  moveit::core::MoveItErrorCode
+  appendFeaturesAsExactFetchQuery(warehouse_ros::Query& query, const FeatureSourceT& /*source*/,
+                                  const moveit::planning_interface::MoveGroupInterface& /*move_group*/,
+                                  double /*exact_match_precision*/) const override
+  {
+    query.append(name_ + ".world_hash", hashPlanningSceneWorld(world_provider_(), resolution_, frame_id_, center_,
+                                                               radius_));
+    return moveit::core::MoveItErrorCode::SUCCESS;
+  }
+
+  moveit::core::MoveItErrorCode
+  appendFeaturesAsInsertMetadata(warehouse_ros::Metadata& metadata, const FeatureSourceT& /*source*/,
+                                 const moveit::planning_interface::MoveGroupInterface& /*move_group*/) const override
+  {
+    metadata.append(name_ + ".world_hash", hashPlanningSceneWorld(world_provider_(), resolution_, frame_id_, center_,
+                                                                  radius_));
+    return moveit::core::MoveItErrorCode::SUCCESS;
+  }
+
+private:
+  const std::string name_;
+  const WorldProvider world_provider_;
+  const double resolution_;
+  const std::string frame_id_;
+  const geometry_msgs::msg::Point center_;
+  const double radius_;
+};
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
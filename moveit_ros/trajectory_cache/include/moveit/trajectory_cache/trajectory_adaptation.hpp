@@ -0,0 +1,91 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Adaptation of near-miss cache entries to a motion plan request.
+ *
+ * A cache fetch only hits if the start and goal of a cache entry are within the tolerances of its features. Entries
+ * whose endpoints are slightly off can still be reused by connecting them to the requested start and goal, which takes
+ * a few milliseconds instead of a full plan.
+ *
+ * @see TrajectoryCache
+ */
+
+#pragma once
+
+#include <string>
+
+#include <moveit/move_group_interface/move_group_interface.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
+#include <moveit/utils/moveit_error_code.hpp>
+#include <moveit_msgs/msg/motion_plan_request.hpp>
+#include <moveit_msgs/msg/robot_trajectory.hpp>
+
+#include <moveit/trajectory_cache/trajectory_cache.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+/** @brief Options of the adaptation of cached trajectories. */
+struct TrajectoryAdaptationOptions
+{
+  /** @brief The largest difference of any joint between the requested and the cached start state. */
+  double start_tolerance = 0.1;
+
+  /** @brief The largest difference of any joint between the requested and the cached goal. */
+  double goal_tolerance = 0.1;
+
+  /** @brief The largest joint step between the waypoints of the connecting segments. */
+  double max_connector_step = 0.01;
+
+  /** @brief The path tolerance of the time parameterization of the adapted trajectory. */
+  double path_tolerance = 0.1;
+
+  /** @brief The sample time of the time parameterization of the adapted trajectory. */
+  double resample_dt = 0.1;
+};
+
+/**
+ * @brief Fetches the cached trajectory nearest to a motion plan request, and connects it to the requested start and
+ * goal.
+ *
+ * The cache is fetched with the features of the BestSeenExecutionTimePolicy, using the adaptation tolerances. Of the
+ * matching entries, the one with the smallest sum of its start and goal differences is adapted: Joint space
+ * straight line segments, like the ones of a Pilz PTP motion, connect the requested start to the cached start and the
+ * cached goal to the requested goal. The adapted trajectory is time parameterized with the scaling factors of the
+ * request, and checked for validity with its path and goal constraints in @p planning_scene.
+ *
+ * WARNING: Only goals with joint constraints on all active joints of the group are supported.
+ *
+ * @param[in] cache. The trajectory cache to fetch from.
+ * @param[in] move_group. The manipulator move group, used to get its state.
+ * @param[in] cache_namespace. A namespace to separate cache entries by.
+ * @param[in] plan_request. The motion plan request to adapt a cached trajectory to.
+ * @param[in] planning_scene. The planning scene to check the adapted trajectory in, also providing the start state if
+ * the request has a diff or empty start state.
+ * @param[in] options. The adaptation options.
+ * @param[out] trajectory. The adapted trajectory.
+ * @returns MoveItErrorCode::SUCCESS if a trajectory was adapted. Otherwise, will return a different error code, in
+ * which case the request should be planned instead.
+ */
+moveit::core::MoveItErrorCode
+fetchAdaptedTrajectory(const TrajectoryCache& cache, const moveit::planning_interface::MoveGroupInterface& move_group,
+                       const std::string& cache_namespace, const moveit_msgs::msg::MotionPlanRequest& plan_request,
+                       const planning_scene::PlanningSceneConstPtr& planning_scene,
+                       const TrajectoryAdaptationOptions& options, moveit_msgs::msg::RobotTrajectory& trajectory);
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
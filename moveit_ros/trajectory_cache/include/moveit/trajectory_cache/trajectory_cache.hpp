@@ -20,7 +20,15 @@
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include <rclcpp/rclcpp.hpp>
@@ -39,6 +47,7 @@
 
 #include <moveit/trajectory_cache/cache_insert_policies/cache_insert_policy_interface.hpp>
 #include <moveit/trajectory_cache/features/features_interface.hpp>
+#include <moveit/trajectory_cache/trajectory_cache_statistics.hpp>
 
 namespace moveit_ros
 {
@@ -100,8 +109,23 @@ namespace trajectory_cache
  *
  * Thread-Safety
  * ^^^^^^^^^^^^^
- * This class is NOT thread safe. Synchronize use of it if you need it in
- * multi-threaded contexts.
+ * All methods may be called concurrently. Fetches share the cache, while
+ * inserts, prunes and configuration changes have exclusive access to it.
+ * Calls into the warehouse_ros database connection are serialized, so
+ * concurrent fetches only run in parallel with Options::use_in_memory_index.
+ *
+ * The asynchronous insert methods queue inserts for a background writer
+ * thread, which keeps database writes and pruning off the critical path of
+ * planning. Use flushInserts() to wait for queued inserts.
+ *
+ * Statistics
+ * ^^^^^^^^^^
+ * The cache counts fetch hits and misses, inserts and prunes per cache
+ * namespace, and keeps histograms of the fetch latency and its phases.
+ * Optionally, it also records which features cause misses, and periodically
+ * publishes the statistics as a diagnostic_msgs/DiagnosticArray.
+ *
+ * @see TrajectoryCache::getStatistics
  *
  * Injectable Feature Extraction and Cache Insert Policies
  * ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
@@ -205,6 +229,12 @@ public:
    */
   explicit TrajectoryCache(const rclcpp::Node::SharedPtr& node);
 
+  /** @brief Writes the queued inserts and stops the background writer thread. */
+  ~TrajectoryCache();
+
+  TrajectoryCache(const TrajectoryCache&) = delete;
+  TrajectoryCache& operator=(const TrajectoryCache&) = delete;
+
   /**
    * @brief Options struct for TrajectoryCache.
    *
@@ -217,6 +247,17 @@ public:
    * @property num_additional_trajectories_to_preserve_when_pruning_worse. The number of additional cached trajectories
    * to preserve when `prune_worse_trajectories` is true. It is useful to keep more than one matching trajectory to
    * have alternative trajectories to handle obstacles.
+   * @property use_in_memory_index. If true, the metadata of all cache entries of a cache namespace is kept in memory,
+   * and fetches match and sort it in-process instead of querying the database with the features. Only the selected
+   * trajectories are then read from the database. The index is reloaded after inserts and prunes of this cache, and
+   * when the number of entries in the database changes, e.g. because another process inserted entries. Inserts and
+   * prunes of this cache update the index in place, and cache insert policies that support it (e.g.
+   * BestSeenExecutionTimePolicy) match the entries to prune in the index instead of querying the database.
+   * @property collect_feature_statistics. If true, every missed fetch also checks each of its features on its own,
+   * to count the features that match no cache entry. This costs one extra database query per feature and miss without
+   * the in-memory index.
+   * @property statistics_publish_period_s. If positive, the statistics are published with this period on the
+   * `~/trajectory_cache_statistics` topic of the node. This requires the node to be spun.
    */
   struct Options
   {
@@ -225,6 +266,11 @@ public:
 
     double exact_match_precision = 1e-6;
     size_t num_additional_trajectories_to_preserve_when_pruning_worse = 1;
+
+    bool use_in_memory_index = false;
+
+    bool collect_feature_statistics = false;
+    double statistics_publish_period_s = 0.0;
   };
 
   /**
@@ -360,6 +406,35 @@ public:
                         const std::vector<std::unique_ptr<FeaturesInterface<moveit_msgs::msg::MotionPlanRequest>>>&
                             additional_features = {});
 
+  /**
+   * @brief Queues a trajectory insert for the background writer thread, like insertTrajectory().
+   *
+   * The call returns without waiting for the database. Features that use the move group, e.g. for an unset start
+   * state, see its state at the time of the insert.
+   *
+   * @see TrajectoryCache::insertTrajectory
+   * @see TrajectoryCache::flushInserts
+   *
+   * @param[in] move_group. The manipulator move group, kept alive until the insert is done.
+   * @param[in] cache_namespace. A namespace to separate cache entries by. The name of the robot is a good choice.
+   * @param[in] plan_request. The motion plan request to extract features from to key the cache with.
+   * @param[in] plan. The plan containing the trajectory to insert.
+   * @param[in] cache_insert_policy. The cache insert policy to use, owned by the queued insert.
+   * @param[in] prune_worse_trajectories. If true, will prune the cache according to the `cache_insert_policy`'s pruning
+   * logic.
+   * @param[in] additional_features. Additional features to key the cache with, owned by the queued insert.
+   */
+  void insertTrajectoryAsync(
+      const std::shared_ptr<const moveit::planning_interface::MoveGroupInterface>& move_group,
+      const std::string& cache_namespace, const moveit_msgs::msg::MotionPlanRequest& plan_request,
+      const moveit::planning_interface::MoveGroupInterface::Plan& plan,
+      std::unique_ptr<CacheInsertPolicyInterface<moveit_msgs::msg::MotionPlanRequest,
+                                                 moveit::planning_interface::MoveGroupInterface::Plan,
+                                                 moveit_msgs::msg::RobotTrajectory>>
+          cache_insert_policy,
+      bool prune_worse_trajectories = true,
+      std::vector<std::unique_ptr<FeaturesInterface<moveit_msgs::msg::MotionPlanRequest>>> additional_features = {});
+
   /**@}*/
 
   /**
@@ -440,14 +515,156 @@ public:
       const std::vector<std::unique_ptr<FeaturesInterface<moveit_msgs::srv::GetCartesianPath::Request>>>&
           additional_features = {});
 
+  /**
+   * @brief Queues a cartesian trajectory insert for the background writer thread, like insertCartesianTrajectory().
+   *
+   * @see TrajectoryCache::insertCartesianTrajectory
+   * @see TrajectoryCache::insertTrajectoryAsync
+   */
+  void insertCartesianTrajectoryAsync(
+      const std::shared_ptr<const moveit::planning_interface::MoveGroupInterface>& move_group,
+      const std::string& cache_namespace, const moveit_msgs::srv::GetCartesianPath::Request& plan_request,
+      const moveit_msgs::srv::GetCartesianPath::Response& plan,
+      std::unique_ptr<CacheInsertPolicyInterface<moveit_msgs::srv::GetCartesianPath::Request,
+                                                 moveit_msgs::srv::GetCartesianPath::Response,
+                                                 moveit_msgs::msg::RobotTrajectory>>
+          cache_insert_policy,
+      bool prune_worse_trajectories = true,
+      std::vector<std::unique_ptr<FeaturesInterface<moveit_msgs::srv::GetCartesianPath::Request>>>
+          additional_features = {});
+
+  /**@}*/
+
+  /**
+   * @name Background inserts
+   */
+  /**@{*/
+
+  /** @brief Blocks until all inserts queued before the call are written to the database. */
+  void flushInserts();
+
+  /** @brief Gets the number of queued inserts that are not written yet. */
+  size_t getPendingInsertCount() const;
+
+  /**@}*/
+
+  /**
+   * @name Statistics
+   */
+  /**@{*/
+
+  /** @brief Gets a copy of the statistics collected since init() or the last resetStatistics(). */
+  TrajectoryCacheStatistics getStatistics() const;
+
+  /** @brief Clears the statistics. */
+  void resetStatistics();
+
   /**@}*/
 
 private:
+  /** @brief Queues an insert for the background writer thread, starting the thread if needed. */
+  void queueInsert(std::function<void()> insert);
+
+  /** @brief Writes queued inserts in batches until the cache is destroyed. */
+  void insertLoop();
+
+  /** @brief Cache entry metadata of one cache namespace, for Options::use_in_memory_index. */
+  struct MetadataIndex
+  {
+    std::vector<warehouse_ros::MessageWithMetadata<moveit_msgs::msg::RobotTrajectory>::ConstPtr> entries;
+    int max_id = -1;  // Largest database ID of the entries.
+    bool stale = true;
+  };
+
+  /** @brief Fetches all trajectories matching the features from the in-memory index of a cache namespace.
+   * Behaves like the database query of the fetch methods.
+   */
+  template <typename FeatureSourceT>
+  std::vector<warehouse_ros::MessageWithMetadata<moveit_msgs::msg::RobotTrajectory>::ConstPtr>
+  fetchAllMatchingIndexedTrajectories(const moveit::planning_interface::MoveGroupInterface& move_group,
+                                      const std::string& database, const std::string& cache_namespace,
+                                      const FeatureSourceT& plan_request,
+                                      const std::vector<std::unique_ptr<FeaturesInterface<FeatureSourceT>>>& features,
+                                      const std::string& sort_by, bool ascending, bool metadata_only) const;
+
+  /** @brief Gets the metadata of all entries of a cache namespace, reloading it from the database if needed.
+   * The entries are copied, so that concurrent fetches can match them while the index is reloaded.
+   */
+  std::vector<warehouse_ros::MessageWithMetadata<moveit_msgs::msg::RobotTrajectory>::ConstPtr>
+  getIndexedEntries(const std::string& database, const std::string& cache_namespace) const;
+
+  /** @brief Marks the in-memory index of a cache namespace to be reloaded on the next fetch. */
+  void invalidateIndex(const std::string& database, const std::string& cache_namespace);
+
+  /** @brief Removes a pruned entry from the in-memory index of a cache namespace, if it is loaded. */
+  void removeFromIndex(const std::string& database, const std::string& cache_namespace, int id);
+
+  /** @brief Adds entries inserted after the last indexed one to the in-memory index of a cache namespace, if it is
+   * loaded, so that inserts don't reload the whole index.
+   */
+  void addNewEntriesToIndex(const std::string& database, const std::string& cache_namespace,
+                            const warehouse_ros::MessageCollection<moveit_msgs::msg::RobotTrajectory>& coll);
+
+  /** @brief Durations of the phases of a fetch, in seconds. */
+  struct FetchTimings
+  {
+    double query_build_s = 0.0;
+    double database_s = 0.0;
+    double match_and_sort_s = 0.0;
+  };
+
+  /** @brief Records a fetch of a cache namespace that started at `start`. */
+  void recordFetch(const std::string& database, const std::string& cache_namespace, bool hit,
+                   const std::chrono::steady_clock::time_point& start, const FetchTimings& timings) const;
+
+  /** @brief Records the duration of a database call of a fetch, outside of fetchAllMatching*(). */
+  void recordFetchDatabaseTime(const std::string& database, const std::string& cache_namespace,
+                               const std::chrono::steady_clock::time_point& start) const;
+
+  /** @brief Records the outcome of an insert that started at `start`. */
+  void recordInsert(const std::string& database, const std::string& cache_namespace, bool inserted,
+                    size_t pruned_entries, const std::chrono::steady_clock::time_point& start) const;
+
+  /** @brief Records the features of a fetch, blaming those that match no entry on their own for a miss.
+   * `matches_any_entry` checks a single feature.
+   */
+  template <typename FeatureSourceT>
+  void recordFeatureStatistics(
+      const std::string& database, const std::string& cache_namespace,
+      const std::vector<std::unique_ptr<FeaturesInterface<FeatureSourceT>>>& features, bool hit,
+      const std::function<bool(const FeaturesInterface<FeatureSourceT>&)>& matches_any_entry) const;
+
+  /** @brief Publishes the statistics on the statistics topic. */
+  void publishStatistics() const;
+
   rclcpp::Node::SharedPtr node_;
   rclcpp::Logger logger_;
   warehouse_ros::DatabaseConnection::Ptr db_;
 
   Options options_;
+
+  // In-memory indices, keyed by "<database>@<cache_namespace>".
+  mutable std::map<std::string, MetadataIndex> metadata_indices_;
+
+  // Shared by fetches, exclusive for inserts and configuration changes.
+  mutable std::shared_mutex cache_mutex_;
+  // Serializes calls into the database connection and updates of the in-memory indices by concurrent fetches.
+  mutable std::mutex db_mutex_;
+
+  // Background writer queue.
+  std::deque<std::function<void()>> insert_queue_;
+  size_t pending_inserts_ = 0;  // Queued inserts and inserts being written.
+  mutable std::mutex insert_queue_mutex_;
+  std::condition_variable insert_queue_condition_;
+  std::condition_variable inserts_done_condition_;
+  bool stop_insert_thread_ = false;
+  std::thread insert_thread_;
+
+  // Statistics, keyed like the in-memory indices.
+  mutable TrajectoryCacheStatistics statistics_;
+  mutable std::mutex statistics_mutex_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr statistics_publisher_;
+  rclcpp::TimerBase::SharedPtr statistics_timer_;
 };
 
 }  // namespace trajectory_cache
@@ -0,0 +1,101 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Hit rate, latency and feature match statistics of the trajectory cache.
+ *
+ * @see TrajectoryCache::getStatistics
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+/** @class LatencyHistogram
+ * @brief Histogram of durations, with fixed buckets spaced by factors of ten.
+ */
+struct LatencyHistogram
+{
+  /** @brief Upper bounds of the buckets, in seconds. The last bucket counts all longer durations. */
+  static constexpr std::array<double, 6> BUCKET_UPPER_BOUNDS_S = { 1e-4, 1e-3, 1e-2, 1e-1, 1.0, 10.0 };
+
+  /** @brief Adds a duration, in seconds. */
+  void record(double duration_s);
+
+  /** @brief Gets the mean duration, in seconds, or zero if there are no samples. */
+  double mean() const;
+
+  std::array<uint64_t, BUCKET_UPPER_BOUNDS_S.size() + 1> bucket_counts{};
+  uint64_t count = 0;
+  double sum_s = 0.0;
+  double max_s = 0.0;
+};
+
+/** @class FeatureMatchStatistics
+ * @brief How often a feature took part in fetches, and in how many missed fetches it matched no cache entry on its
+ * own, i.e. blamed for the miss.
+ */
+struct FeatureMatchStatistics
+{
+  uint64_t fetches = 0;
+  uint64_t misses = 0;
+};
+
+/** @class CacheNamespaceStatistics
+ * @brief Fetch and insert statistics of one cache namespace.
+ *
+ * Fetch latency is split into building the query from the features, calls into the database (which include the
+ * deserialization and, without the in-memory index, the sorting of the results), and matching and sorting the
+ * in-memory index.
+ */
+struct CacheNamespaceStatistics
+{
+  uint64_t fetches = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+
+  uint64_t inserts = 0;
+  uint64_t skipped_inserts = 0;
+  uint64_t pruned_entries = 0;
+
+  LatencyHistogram fetch_latency;
+  LatencyHistogram query_build_latency;
+  LatencyHistogram database_latency;
+  LatencyHistogram match_and_sort_latency;
+  LatencyHistogram insert_latency;
+
+  /** @brief Statistics keyed by feature name, only collected with Options::collect_feature_statistics. */
+  std::map<std::string, FeatureMatchStatistics> features;
+};
+
+/** @brief Statistics keyed by "<database>@<cache_namespace>". */
+using TrajectoryCacheStatistics = std::map<std::string, CacheNamespaceStatistics>;
+
+/** @brief Converts statistics to one diagnostic status per cache namespace, with the counters, the mean and max
+ * latencies, the histogram buckets and the feature statistics as key-value pairs.
+ */
+diagnostic_msgs::msg::DiagnosticArray toDiagnosticArray(const TrajectoryCacheStatistics& statistics);
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
@@ -0,0 +1,90 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Offline population of the trajectory cache with the best solutions of known motions.
+ *
+ * Motions that are known in advance, e.g. moves between the stations of a work cell, can be planned repeatedly with
+ * several planning pipelines in parallel before production. The cache then keeps the solutions with the best seen
+ * execution time, so that production requests hit the cache from their first cycle.
+ *
+ * @see TrajectoryCache
+ * @see BestSeenExecutionTimePolicy
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <moveit/move_group_interface/move_group_interface.hpp>
+#include <moveit/moveit_cpp/planning_component.hpp>
+#include <moveit/planning_pipeline/planning_pipeline.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
+#include <moveit_msgs/msg/motion_plan_request.hpp>
+
+#include <moveit/trajectory_cache/trajectory_cache.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+/** @brief Statistics of a trajectory cache warm-up. */
+struct TrajectoryCacheWarmupStatistics
+{
+  /** @brief The number of parallel planning calls. */
+  size_t num_planning_rounds = 0;
+
+  /** @brief The number of solutions that were offered to the cache. */
+  size_t num_solutions = 0;
+
+  /** @brief The number of motion templates without any solution. */
+  size_t num_unsolved_templates = 0;
+};
+
+/**
+ * @brief Populates the trajectory cache with the best seen solutions of a set of motion templates.
+ *
+ * Each template is planned for @p num_rounds rounds, each of which runs one request per entry of
+ * @p plan_request_parameters in parallel. The requests are copies of the template, with the pipeline, planner, number
+ * of attempts and planning time of the entry. All solutions are inserted with the BestSeenExecutionTimePolicy and keyed
+ * on the template, so that only the fastest solution of each template remains in the cache.
+ *
+ * Inserts run on the background writer of the cache while the next rounds are planned. The function returns after all
+ * of them are written.
+ *
+ * @param[in] cache. The initialized trajectory cache to populate.
+ * @param[in] move_group. The manipulator move group, used to extract the cache features.
+ * @param[in] cache_namespace. The namespace to insert the cache entries into.
+ * @param[in] motion_templates. The motion plan requests that production is expected to send, e.g. constructed by
+ * MoveGroupInterface::constructMotionPlanRequest() with explicit start states.
+ * @param[in] planning_scene. The planning scene to plan in.
+ * @param[in] planning_pipelines. The planning pipelines to plan with, e.g. from MoveItCpp::getPlanningPipelines().
+ * @param[in] plan_request_parameters. The pipelines and planners to run in parallel in each round.
+ * @param[in] num_rounds. The number of times each template is planned.
+ * @returns Statistics of the warm-up.
+ */
+TrajectoryCacheWarmupStatistics warmUpTrajectoryCache(
+    TrajectoryCache& cache, const std::shared_ptr<const moveit::planning_interface::MoveGroupInterface>& move_group,
+    const std::string& cache_namespace, const std::vector<moveit_msgs::msg::MotionPlanRequest>& motion_templates,
+    const planning_scene::PlanningSceneConstPtr& planning_scene,
+    const std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>& planning_pipelines,
+    const moveit_cpp::PlanningComponent::MultiPipelinePlanRequestParameters& plan_request_parameters,
+    size_t num_rounds);
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
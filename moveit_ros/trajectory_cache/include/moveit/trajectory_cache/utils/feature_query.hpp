@@ -0,0 +1,136 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief In-memory evaluation of cache feature queries.
+ */
+
+#pragma once
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <warehouse_ros/metadata.h>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+/** @class FeatureQuery
+ * @brief A warehouse_ros::Query that records the constraints appended to it, so that they can be evaluated against
+ * the metadata of cache entries that are already in memory, instead of being sent to the database.
+ *
+ * Features append their fetch constraints to it like to a query of a MessageCollection. An entry matches if it has
+ * every constrained field and satisfies every constraint, as with the database query.
+ */
+class FeatureQuery : public warehouse_ros::Query
+{
+public:
+  void append(const std::string& name, const std::string& val) override;
+  void append(const std::string& name, const double val) override;
+  void append(const std::string& name, const int val) override;
+  void append(const std::string& name, const bool val) override;
+  void appendLT(const std::string& name, const double val) override;
+  void appendLT(const std::string& name, const int val) override;
+  void appendLTE(const std::string& name, const double val) override;
+  void appendLTE(const std::string& name, const int val) override;
+  void appendGT(const std::string& name, const double val) override;
+  void appendGT(const std::string& name, const int val) override;
+  void appendGTE(const std::string& name, const double val) override;
+  void appendGTE(const std::string& name, const int val) override;
+  void appendRange(const std::string& name, const double lower, const double upper) override;
+  void appendRange(const std::string& name, const int lower, const int upper) override;
+  void appendRangeInclusive(const std::string& name, const double lower, const double upper) override;
+  void appendRangeInclusive(const std::string& name, const int lower, const int upper) override;
+
+  /** @brief Checks whether a cache entry satisfies all recorded constraints.
+   *
+   * @param[in] entry. A warehouse_ros::MessageWithMetadata, or anything else with its metadata lookup methods.
+   * @returns True if the entry has all constrained fields and satisfies all constraints.
+   */
+  template <typename EntryT>
+  bool matches(const EntryT& entry) const
+  {
+    for (const Constraint& constraint : constraints_)
+    {
+      if (!entry.lookupField(constraint.name))
+      {
+        return false;
+      }
+
+      if (const std::string* value = std::get_if<std::string>(&constraint.value))
+      {
+        if (entry.lookupString(constraint.name) != *value)
+        {
+          return false;
+        }
+      }
+      else if (const bool* value = std::get_if<bool>(&constraint.value))
+      {
+        if (entry.lookupBool(constraint.name) != *value)
+        {
+          return false;
+        }
+      }
+      else if (std::holds_alternative<int>(constraint.value))
+      {
+        if (!satisfies(constraint, static_cast<double>(entry.lookupInt(constraint.name))))
+        {
+          return false;
+        }
+      }
+      else if (!satisfies(constraint, entry.lookupDouble(constraint.name)))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** @brief Gets the number of recorded constraints. */
+  size_t size() const;
+
+private:
+  enum class Comparison
+  {
+    EQUAL,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    RANGE,
+    RANGE_INCLUSIVE
+  };
+
+  struct Constraint
+  {
+    std::string name;
+    Comparison comparison;
+    std::variant<std::string, double, int, bool> value;
+    double upper = 0.0;  // Upper bound of ranges, value holds the lower bound.
+  };
+
+  /** @brief Checks a numeric value against a numeric constraint. */
+  static bool satisfies(const Constraint& constraint, double value);
+
+  void appendNumeric(const std::string& name, Comparison comparison, double value, double upper = 0.0);
+  void appendNumeric(const std::string& name, Comparison comparison, int value, int upper = 0);
+
+  std::vector<Constraint> constraints_;
+};
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
@@ -21,6 +21,8 @@
  * @author methylDragon
  */
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <sstream>
@@ -37,6 +39,7 @@
 #include <moveit/trajectory_cache/features/constant_features.hpp>
 #include <moveit/trajectory_cache/features/get_cartesian_path_request_features.hpp>
 #include <moveit/trajectory_cache/features/motion_plan_request_features.hpp>
+#include <moveit/trajectory_cache/utils/feature_query.hpp>
 #include <moveit/trajectory_cache/utils/utils.hpp>
 
 namespace moveit_ros
@@ -65,6 +68,34 @@ const std::string EXECUTION_TIME = "execution_time_s";
 const std::string FRACTION = "fraction";
 const std::string PLANNING_TIME = "planning_time_s";
 
+/** @brief Matches the entries of a cache namespace against the exact features, and sorts the matching entries by
+ * execution time like the database query of fetchMatchingEntries. Only the matching entries are sorted.
+ */
+template <typename FeatureSourceT>
+std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>
+matchIndexedEntries(const std::vector<std::unique_ptr<FeaturesInterface<FeatureSourceT>>>& features,
+                    const std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>& entries,
+                    const MoveGroupInterface& move_group, const FeatureSourceT& key, double exact_match_precision)
+{
+  FeatureQuery query;
+  for (const auto& feature : features)
+  {
+    if (MoveItErrorCode ret = feature->appendFeaturesAsExactFetchQuery(query, key, move_group, exact_match_precision);
+        !ret)
+    {
+      return {};
+    }
+  }
+
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> out;
+  std::copy_if(entries.begin(), entries.end(), std::back_inserter(out),
+               [&query](const auto& entry) { return query.matches(*entry); });
+  std::stable_sort(out.begin(), out.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs->lookupDouble(EXECUTION_TIME) < rhs->lookupDouble(EXECUTION_TIME);
+  });
+  return out;
+}
+
 }  // namespace
 
 // =================================================================================================
@@ -176,6 +207,21 @@ std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> BestSeenExecutionTim
   return out;
 }
 
+std::optional<std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>>
+BestSeenExecutionTimePolicy::fetchMatchingIndexedEntries(
+    const MoveGroupInterface& move_group, const std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>& entries,
+    const MotionPlanRequest& key, const MoveGroupInterface::Plan& /*value*/, double exact_match_precision)
+{
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> out =
+      matchIndexedEntries(exact_matching_supported_features_, entries, move_group, key, exact_match_precision);
+  if (!out.empty())
+  {
+    best_seen_execution_time_ = out[0]->lookupDouble(EXECUTION_TIME);
+  }
+
+  return out;
+}
+
 bool BestSeenExecutionTimePolicy::shouldPruneMatchingEntry(
     const MoveGroupInterface& /*move_group*/, const MotionPlanRequest& /*key*/, const MoveGroupInterface::Plan& value,
     const MessageWithMetadata<RobotTrajectory>::ConstPtr& matching_entry, std::string* reason)
@@ -376,6 +422,21 @@ std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> CartesianBestSeenExe
   return out;
 }
 
+std::optional<std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>>
+CartesianBestSeenExecutionTimePolicy::fetchMatchingIndexedEntries(
+    const MoveGroupInterface& move_group, const std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>& entries,
+    const GetCartesianPath::Request& key, const GetCartesianPath::Response& /*value*/, double exact_match_precision)
+{
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> out =
+      matchIndexedEntries(exact_matching_supported_features_, entries, move_group, key, exact_match_precision);
+  if (!out.empty())
+  {
+    best_seen_execution_time_ = out[0]->lookupDouble(EXECUTION_TIME);
+  }
+
+  return out;
+}
+
 bool CartesianBestSeenExecutionTimePolicy::shouldPruneMatchingEntry(
     const MoveGroupInterface& /*move_group*/, const GetCartesianPath::Request& /*key*/,
     const GetCartesianPath::Response& value, const MessageWithMetadata<RobotTrajectory>::ConstPtr& matching_entry,
@@ -0,0 +1,266 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Implementation of planning scene world features to key the trajectory cache on.
+ * @see FeaturesInterface<FeatureSourceT>
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <tf2/LinearMath/Transform.h>
+
+#include <moveit/trajectory_cache/features/planning_scene_world_features.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+using ::moveit_msgs::msg::CollisionObject;
+using ::moveit_msgs::msg::PlanningSceneWorld;
+
+namespace
+{
+
+// 64 bit FNV-1a, fed with explicitly ordered bytes so that the hash does not depend on the platform.
+class StableHasher
+{
+public:
+  explicit StableHasher(double resolution) : resolution_(resolution)
+  {
+  }
+
+  void addInt(int64_t value)
+  {
+    for (int i = 0; i < 8; ++i)
+    {
+      addByte(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+    }
+  }
+
+  void addDouble(double value)
+  {
+    if (resolution_ > 0.0)
+    {
+      addInt(std::llround(value / resolution_));
+      return;
+    }
+    value = value == 0.0 ? 0.0 : value;  // Hash -0.0 like 0.0.
+    int64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    addInt(bits);
+  }
+
+  void addString(const std::string& value)
+  {
+    addInt(static_cast<int64_t>(value.size()));
+    for (const char c : value)
+    {
+      addByte(static_cast<uint8_t>(c));
+    }
+  }
+
+  void addPose(const geometry_msgs::msg::Pose& pose)
+  {
+    addDouble(pose.position.x);
+    addDouble(pose.position.y);
+    addDouble(pose.position.z);
+
+    // q and -q are the same orientation.
+    const double sign = pose.orientation.w < 0.0 ? -1.0 : 1.0;
+    addDouble(sign * pose.orientation.x);
+    addDouble(sign * pose.orientation.y);
+    addDouble(sign * pose.orientation.z);
+    addDouble(sign * pose.orientation.w);
+  }
+
+  void addByte(uint8_t byte)
+  {
+    hash_ = (hash_ ^ byte) * 1099511628211ULL;
+  }
+
+  uint64_t getHash() const
+  {
+    return hash_;
+  }
+
+private:
+  const double resolution_;
+  uint64_t hash_ = 14695981039346656037ULL;
+};
+
+tf2::Transform toTransform(const geometry_msgs::msg::Pose& pose)
+{
+  return tf2::Transform(
+      tf2::Quaternion(pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w),
+      tf2::Vector3(pose.position.x, pose.position.y, pose.position.z));
+}
+
+// Whether a shape with the given pose and bounding radius around its origin may reach into the region.
+bool isNearRegion(const tf2::Transform& object_pose, const geometry_msgs::msg::Pose& shape_pose, double extent,
+                  const tf2::Vector3& center, double radius)
+{
+  if (std::isinf(radius))
+  {
+    return true;
+  }
+  const tf2::Vector3 position = object_pose * tf2::Vector3(shape_pose.position.x, shape_pose.position.y,
+                                                           shape_pose.position.z);
+  return position.distance(center) - extent <= radius;
+}
+
+// A conservative bound of the distance of the points of a primitive from its origin.
+double getPrimitiveExtent(const shape_msgs::msg::SolidPrimitive& primitive)
+{
+  double squared_sum = 0.0;
+  for (const double dimension : primitive.dimensions)
+  {
+    squared_sum += dimension * dimension;
+  }
+  return std::sqrt(squared_sum);
+}
+
+double getMeshExtent(const shape_msgs::msg::Mesh& mesh)
+{
+  double extent = 0.0;
+  for (const geometry_msgs::msg::Point& vertex : mesh.vertices)
+  {
+    extent = std::max(extent, std::sqrt(vertex.x * vertex.x + vertex.y * vertex.y + vertex.z * vertex.z));
+  }
+  return extent;
+}
+
+// Hashes the shapes of a collision object near the region, returns whether there were any.
+bool addCollisionObject(StableHasher& hasher, const CollisionObject& object, bool filter, const tf2::Vector3& center,
+                        double radius)
+{
+  const tf2::Transform object_pose = toTransform(object.pose);
+  bool has_shapes = false;
+
+  for (size_t i = 0; i < object.primitives.size() && i < object.primitive_poses.size(); ++i)
+  {
+    const shape_msgs::msg::SolidPrimitive& primitive = object.primitives[i];
+    if (filter && !isNearRegion(object_pose, object.primitive_poses[i], getPrimitiveExtent(primitive), center, radius))
+    {
+      continue;
+    }
+    has_shapes = true;
+    hasher.addInt(primitive.type);
+    hasher.addPose(object.primitive_poses[i]);
+    hasher.addInt(static_cast<int64_t>(primitive.dimensions.size()));
+    for (const double dimension : primitive.dimensions)
+    {
+      hasher.addDouble(dimension);
+    }
+  }
+
+  for (size_t i = 0; i < object.meshes.size() && i < object.mesh_poses.size(); ++i)
+  {
+    const shape_msgs::msg::Mesh& mesh = object.meshes[i];
+    if (filter && !isNearRegion(object_pose, object.mesh_poses[i], getMeshExtent(mesh), center, radius))
+    {
+      continue;
+    }
+    has_shapes = true;
+    hasher.addPose(object.mesh_poses[i]);
+    hasher.addInt(static_cast<int64_t>(mesh.vertices.size()));
+    for (const geometry_msgs::msg::Point& vertex : mesh.vertices)
+    {
+      hasher.addDouble(vertex.x);
+      hasher.addDouble(vertex.y);
+      hasher.addDouble(vertex.z);
+    }
+    hasher.addInt(static_cast<int64_t>(mesh.triangles.size()));
+    for (const shape_msgs::msg::MeshTriangle& triangle : mesh.triangles)
+    {
+      for (const uint32_t vertex_index : triangle.vertex_indices)
+      {
+        hasher.addInt(vertex_index);
+      }
+    }
+  }
+
+  // Planes are unbounded, so they always reach into the region.
+  for (size_t i = 0; i < object.planes.size() && i < object.plane_poses.size(); ++i)
+  {
+    has_shapes = true;
+    hasher.addPose(object.plane_poses[i]);
+    for (const double coefficient : object.planes[i].coef)
+    {
+      hasher.addDouble(coefficient);
+    }
+  }
+
+  return has_shapes;
+}
+
+}  // namespace
+
+std::string hashPlanningSceneWorld(const PlanningSceneWorld& world, double resolution, const std::string& frame_id,
+                                   const geometry_msgs::msg::Point& center, double radius)
+{
+  StableHasher hasher(resolution);
+  const tf2::Vector3 region_center(center.x, center.y, center.z);
+
+  std::vector<const CollisionObject*> objects;
+  objects.reserve(world.collision_objects.size());
+  for (const CollisionObject& object : world.collision_objects)
+  {
+    objects.push_back(&object);
+  }
+  std::sort(objects.begin(), objects.end(),
+            [](const CollisionObject* lhs, const CollisionObject* rhs) { return lhs->id < rhs->id; });
+
+  for (const CollisionObject* object : objects)
+  {
+    // Objects are hashed separately, so that they can be skipped when none of their shapes is near the region.
+    StableHasher object_hasher(resolution);
+    object_hasher.addString(object->id);
+    object_hasher.addString(object->header.frame_id);
+    object_hasher.addPose(object->pose);
+    const bool filter = frame_id.empty() || object->header.frame_id == frame_id;
+    if (addCollisionObject(object_hasher, *object, filter, region_center, radius))
+    {
+      hasher.addInt(static_cast<int64_t>(object_hasher.getHash()));
+    }
+  }
+
+  const octomap_msgs::msg::Octomap& octomap = world.octomap.octomap;
+  if (!octomap.data.empty())
+  {
+    hasher.addString(world.octomap.header.frame_id);
+    hasher.addPose(world.octomap.origin);
+    hasher.addString(octomap.id);
+    hasher.addInt(octomap.binary ? 1 : 0);
+    hasher.addDouble(octomap.resolution);
+    hasher.addInt(static_cast<int64_t>(octomap.data.size()));
+    for (const int8_t byte : octomap.data)
+    {
+      hasher.addByte(static_cast<uint8_t>(byte));
+    }
+  }
+
+  std::ostringstream hash;
+  hash << std::hex << std::setw(16) << std::setfill('0') << hasher.getHash();
+  return hash.str();
+}
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
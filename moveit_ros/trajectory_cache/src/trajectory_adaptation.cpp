@@ -0,0 +1,208 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Implementation of the adaptation of near-miss cache entries to a motion plan request.
+ * @see trajectory_adaptation.hpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <rclcpp/logging.hpp>
+
+#include <moveit/robot_state/conversions.hpp>
+#include <moveit/robot_trajectory/robot_trajectory.hpp>
+#include <moveit/trajectory_processing/time_optimal_trajectory_generation.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <moveit/trajectory_cache/cache_insert_policies/best_seen_execution_time_policy.hpp>
+#include <moveit/trajectory_cache/trajectory_adaptation.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+using ::warehouse_ros::MessageWithMetadata;
+
+using ::moveit::core::MoveItErrorCode;
+using ::moveit::planning_interface::MoveGroupInterface;
+
+using ::moveit_msgs::msg::MotionPlanRequest;
+using ::moveit_msgs::msg::MoveItErrorCodes;
+using ::moveit_msgs::msg::RobotTrajectory;
+
+namespace
+{
+
+// The largest difference of any active joint of the group.
+double getMaxJointDistance(const moveit::core::RobotState& lhs, const moveit::core::RobotState& rhs,
+                           const moveit::core::JointModelGroup* group)
+{
+  double max_distance = 0.0;
+  for (const moveit::core::JointModel* joint : group->getActiveJointModels())
+  {
+    max_distance = std::max(max_distance, joint->distance(lhs.getJointPositions(joint), rhs.getJointPositions(joint)));
+  }
+  return max_distance;
+}
+
+// Appends a joint space straight line from the last waypoint to the target, excluding the last waypoint.
+void appendConnector(robot_trajectory::RobotTrajectory& trajectory, const moveit::core::RobotState& target,
+                     double max_step)
+{
+  const moveit::core::JointModelGroup* group = trajectory.getGroup();
+  const moveit::core::RobotState from = trajectory.getLastWayPoint();
+  const size_t num_steps =
+      std::max<size_t>(1, static_cast<size_t>(std::ceil(getMaxJointDistance(from, target, group) / max_step)));
+
+  moveit::core::RobotState state = from;
+  for (size_t i = 1; i <= num_steps; ++i)
+  {
+    from.interpolate(target, static_cast<double>(i) / num_steps, state, group);
+    state.update();
+    trajectory.addSuffixWayPoint(state, 0.0);
+  }
+}
+
+// Scaling factors outside of (0, 1] mean no scaling, like for the planners.
+double getScalingFactor(double scaling_factor)
+{
+  return scaling_factor > 0.0 && scaling_factor <= 1.0 ? scaling_factor : 1.0;
+}
+
+}  // namespace
+
+MoveItErrorCode fetchAdaptedTrajectory(const TrajectoryCache& cache, const MoveGroupInterface& move_group,
+                                       const std::string& cache_namespace, const MotionPlanRequest& plan_request,
+                                       const planning_scene::PlanningSceneConstPtr& planning_scene,
+                                       const TrajectoryAdaptationOptions& options, RobotTrajectory& trajectory)
+{
+  const rclcpp::Logger logger = moveit::getLogger("moveit.ros.trajectory_cache");
+  const moveit::core::RobotModelConstPtr& robot_model = planning_scene->getRobotModel();
+  const moveit::core::JointModelGroup* group = robot_model->getJointModelGroup(plan_request.group_name);
+  if (group == nullptr)
+  {
+    return MoveItErrorCode(MoveItErrorCodes::INVALID_GROUP_NAME,
+                           "Unknown group name `" + plan_request.group_name + "` in plan request");
+  }
+
+  // Requested start and goal.
+  moveit::core::RobotState start_state = planning_scene->getCurrentState();
+  moveit::core::robotStateMsgToRobotState(planning_scene->getTransforms(), plan_request.start_state, start_state);
+  start_state.update();
+
+  if (plan_request.goal_constraints.size() != 1 || !plan_request.goal_constraints[0].position_constraints.empty() ||
+      !plan_request.goal_constraints[0].orientation_constraints.empty() ||
+      !plan_request.goal_constraints[0].visibility_constraints.empty())
+  {
+    return MoveItErrorCode(MoveItErrorCodes::INVALID_GOAL_CONSTRAINTS,
+                           "Only a single goal with joint constraints can be adapted to");
+  }
+  moveit::core::RobotState goal_state = start_state;
+  std::vector<std::string> constrained_joints;
+  for (const moveit_msgs::msg::JointConstraint& joint_constraint : plan_request.goal_constraints[0].joint_constraints)
+  {
+    if (!robot_model->hasJointModel(joint_constraint.joint_name))
+    {
+      return MoveItErrorCode(MoveItErrorCodes::INVALID_GOAL_CONSTRAINTS,
+                             "Unknown joint `" + joint_constraint.joint_name + "` in goal constraints");
+    }
+    goal_state.setVariablePosition(joint_constraint.joint_name, joint_constraint.position);
+    constrained_joints.push_back(joint_constraint.joint_name);
+  }
+  for (const std::string& joint_name : group->getActiveJointModelNames())
+  {
+    if (std::find(constrained_joints.begin(), constrained_joints.end(), joint_name) == constrained_joints.end())
+    {
+      return MoveItErrorCode(MoveItErrorCodes::INVALID_GOAL_CONSTRAINTS,
+                             "Goal constraints do not constrain active joint `" + joint_name + "`");
+    }
+  }
+  goal_state.update();
+
+  // Nearest cache entry.
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_trajectories =
+      cache.fetchAllMatchingTrajectories(
+          move_group, cache_namespace, plan_request,
+          BestSeenExecutionTimePolicy::getSupportedFeatures(options.start_tolerance, options.goal_tolerance),
+          /*sort_by=*/"execution_time_s", /*ascending=*/true);
+
+  std::unique_ptr<robot_trajectory::RobotTrajectory> nearest;
+  double nearest_distance = std::numeric_limits<double>::infinity();
+  for (const auto& matching_trajectory : matching_trajectories)
+  {
+    auto candidate = std::make_unique<robot_trajectory::RobotTrajectory>(robot_model, group);
+    candidate->setRobotTrajectoryMsg(start_state, *matching_trajectory);
+    if (candidate->empty())
+    {
+      continue;
+    }
+
+    // Entries are sorted by execution time, so the faster one wins ties.
+    const double distance = getMaxJointDistance(start_state, candidate->getFirstWayPoint(), group) +
+                            getMaxJointDistance(candidate->getLastWayPoint(), goal_state, group);
+    if (distance < nearest_distance)
+    {
+      nearest = std::move(candidate);
+      nearest_distance = distance;
+    }
+  }
+  if (!nearest)
+  {
+    return MoveItErrorCode(MoveItErrorCodes::PLANNING_FAILED, "No cached trajectory near the plan request");
+  }
+
+  // Connect the requested endpoints. The connectors end at the cached endpoints, which are therefore skipped.
+  robot_trajectory::RobotTrajectory adapted(robot_model, group);
+  adapted.addSuffixWayPoint(start_state, 0.0);
+  if (getMaxJointDistance(start_state, nearest->getFirstWayPoint(), group) > 0.0)
+  {
+    appendConnector(adapted, nearest->getFirstWayPoint(), options.max_connector_step);
+  }
+  for (size_t i = 1; i < nearest->getWayPointCount(); ++i)
+  {
+    adapted.addSuffixWayPoint(nearest->getWayPoint(i), 0.0);
+  }
+  if (getMaxJointDistance(adapted.getLastWayPoint(), goal_state, group) > 0.0)
+  {
+    appendConnector(adapted, goal_state, options.max_connector_step);
+  }
+
+  trajectory_processing::TimeOptimalTrajectoryGeneration time_parameterization(options.path_tolerance,
+                                                                                options.resample_dt);
+  if (!time_parameterization.computeTimeStamps(adapted,
+                                               getScalingFactor(plan_request.max_velocity_scaling_factor),
+                                               getScalingFactor(plan_request.max_acceleration_scaling_factor)))
+  {
+    return MoveItErrorCode(MoveItErrorCodes::FAILURE, "Could not time parameterize the adapted trajectory");
+  }
+
+  if (!planning_scene->isPathValid(adapted, plan_request.path_constraints, plan_request.goal_constraints,
+                                   plan_request.group_name))
+  {
+    return MoveItErrorCode(MoveItErrorCodes::INVALID_MOTION_PLAN, "The adapted trajectory is invalid");
+  }
+
+  RCLCPP_DEBUG(logger, "Adapted a cached trajectory with endpoint distance %f", nearest_distance);
+  adapted.getRobotTrajectoryMsg(trajectory);
+  return MoveItErrorCode::SUCCESS;
+}
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
@@ -17,8 +17,10 @@
  * @author methylDragon
  */
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include <rclcpp/rclcpp.hpp>
@@ -36,6 +38,7 @@
 
 #include <moveit/move_group_interface/move_group_interface.hpp>
 #include <moveit/warehouse/moveit_message_storage.hpp>
+#include <moveit/trajectory_cache/utils/feature_query.hpp>
 #include <moveit/trajectory_cache/utils/utils.hpp>
 #include <moveit/robot_state/conversions.hpp>
 #include <moveit/robot_state/robot_state.hpp>
@@ -83,6 +86,14 @@ const std::string EXECUTION_TIME = "execution_time_s";
 const std::string FRACTION = "fraction";
 const std::string PLANNING_TIME = "planning_time_s";
 
+const std::string TRAJECTORY_DATABASE = "move_group_trajectory_cache";
+const std::string CARTESIAN_TRAJECTORY_DATABASE = "move_group_cartesian_trajectory_cache";
+
+double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 }  // namespace
 
 // =================================================================================================
@@ -127,8 +138,29 @@ TrajectoryCache::TrajectoryCache(const rclcpp::Node::SharedPtr& node)
 {
 }
 
+TrajectoryCache::~TrajectoryCache()
+{
+  if (statistics_timer_)
+  {
+    statistics_timer_->cancel();
+  }
+  {
+    std::scoped_lock lock(insert_queue_mutex_);
+    stop_insert_thread_ = true;
+  }
+  insert_queue_condition_.notify_all();
+  if (insert_thread_.joinable())
+  {
+    insert_thread_.join();
+  }
+}
+
 bool TrajectoryCache::init(const TrajectoryCache::Options& options)
 {
+  std::unique_lock lock(cache_mutex_);
+
+  metadata_indices_.clear();
+
   RCLCPP_DEBUG(logger_, "Opening trajectory cache database at: %s (Port: %d, Precision: %f)", options.db_path.c_str(),
                options.db_port, options.exact_match_precision);
 
@@ -137,6 +169,23 @@ bool TrajectoryCache::init(const TrajectoryCache::Options& options)
   db_ = moveit_warehouse::loadDatabase(node_);
   options_ = options;
 
+  resetStatistics();
+  if (statistics_timer_)
+  {
+    statistics_timer_->cancel();
+    statistics_timer_.reset();
+  }
+  if (options.statistics_publish_period_s > 0.0)
+  {
+    if (!statistics_publisher_)
+    {
+      statistics_publisher_ = node_->create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+          "~/trajectory_cache_statistics", rclcpp::SystemDefaultsQoS());
+    }
+    statistics_timer_ = node_->create_wall_timer(std::chrono::duration<double>(options.statistics_publish_period_s),
+                                                 [this] { publishStatistics(); });
+  }
+
   db_->setParams(options.db_path, options.db_port);
   return db_->connect();
 }
@@ -147,6 +196,8 @@ bool TrajectoryCache::init(const TrajectoryCache::Options& options)
 
 unsigned TrajectoryCache::countTrajectories(const std::string& cache_namespace)
 {
+  std::shared_lock lock(cache_mutex_);
+  std::scoped_lock db_lock(db_mutex_);
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_trajectory_cache", cache_namespace);
   return coll.count();
@@ -154,6 +205,8 @@ unsigned TrajectoryCache::countTrajectories(const std::string& cache_namespace)
 
 unsigned TrajectoryCache::countCartesianTrajectories(const std::string& cache_namespace)
 {
+  std::shared_lock lock(cache_mutex_);
+  std::scoped_lock db_lock(db_mutex_);
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_cartesian_trajectory_cache", cache_namespace);
   return coll.count();
@@ -161,32 +214,38 @@ unsigned TrajectoryCache::countCartesianTrajectories(const std::string& cache_na
 
 std::string TrajectoryCache::getDbPath() const
 {
+  std::shared_lock lock(cache_mutex_);
   return options_.db_path;
 }
 
 uint32_t TrajectoryCache::getDbPort() const
 {
+  std::shared_lock lock(cache_mutex_);
   return options_.db_port;
 }
 
 double TrajectoryCache::getExactMatchPrecision() const
 {
+  std::shared_lock lock(cache_mutex_);
   return options_.exact_match_precision;
 }
 
 void TrajectoryCache::setExactMatchPrecision(double exact_match_precision)
 {
+  std::unique_lock lock(cache_mutex_);
   options_.exact_match_precision = exact_match_precision;
 }
 
 size_t TrajectoryCache::getNumAdditionalTrajectoriesToPreserveWhenPruningWorse() const
 {
+  std::shared_lock lock(cache_mutex_);
   return options_.num_additional_trajectories_to_preserve_when_pruning_worse;
 }
 
 void TrajectoryCache::setNumAdditionalTrajectoriesToPreserveWhenPruningWorse(
     size_t num_additional_trajectories_to_preserve_when_pruning_worse)
 {
+  std::unique_lock lock(cache_mutex_);
   options_.num_additional_trajectories_to_preserve_when_pruning_worse =
       num_additional_trajectories_to_preserve_when_pruning_worse;
 }
@@ -200,6 +259,16 @@ std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> TrajectoryCache::fet
     const std::vector<std::unique_ptr<FeaturesInterface<MotionPlanRequest>>>& features, const std::string& sort_by,
     bool ascending, bool metadata_only) const
 {
+  std::shared_lock lock(cache_mutex_);
+  if (options_.use_in_memory_index)
+  {
+    return fetchAllMatchingIndexedTrajectories(move_group, TRAJECTORY_DATABASE, cache_namespace, plan_request, features,
+                                               sort_by, ascending, metadata_only);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  FetchTimings timings;
+  std::scoped_lock db_lock(db_mutex_);
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_trajectory_cache", cache_namespace);
 
@@ -215,7 +284,26 @@ std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> TrajectoryCache::fet
       return {};
     }
   }
-  return coll.queryList(query, metadata_only, sort_by, ascending);
+  timings.query_build_s = secondsSince(start);
+
+  const auto database_start = std::chrono::steady_clock::now();
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_trajectories =
+      coll.queryList(query, metadata_only, sort_by, ascending);
+  timings.database_s = secondsSince(database_start);
+  recordFetch(TRAJECTORY_DATABASE, cache_namespace, !matching_trajectories.empty(), start, timings);
+
+  if (options_.collect_feature_statistics)
+  {
+    recordFeatureStatistics<MotionPlanRequest>(
+        TRAJECTORY_DATABASE, cache_namespace, features, !matching_trajectories.empty(),
+        [&](const FeaturesInterface<MotionPlanRequest>& feature) {
+          Query::Ptr feature_query = coll.createQuery();
+          return feature.appendFeaturesAsFuzzyFetchQuery(*feature_query, plan_request, move_group,
+                                                         options_.exact_match_precision) &&
+                 !coll.queryList(feature_query, /*metadata_only=*/true).empty();
+        });
+  }
+  return matching_trajectories;
 }
 
 MessageWithMetadata<RobotTrajectory>::ConstPtr TrajectoryCache::fetchBestMatchingTrajectory(
@@ -233,6 +321,9 @@ MessageWithMetadata<RobotTrajectory>::ConstPtr TrajectoryCache::fetchBestMatchin
     return nullptr;
   }
 
+  std::shared_lock lock(cache_mutex_);
+  const auto start = std::chrono::steady_clock::now();
+  std::scoped_lock db_lock(db_mutex_);
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_trajectory_cache", cache_namespace);
 
@@ -241,7 +332,9 @@ MessageWithMetadata<RobotTrajectory>::ConstPtr TrajectoryCache::fetchBestMatchin
   Query::Ptr best_query = coll.createQuery();
   best_query->append("id", best_trajectory_id);
 
-  return coll.findOne(best_query, metadata_only);
+  MessageWithMetadata<RobotTrajectory>::ConstPtr best_trajectory = coll.findOne(best_query, metadata_only);
+  recordFetchDatabaseTime(TRAJECTORY_DATABASE, cache_namespace, start);
+  return best_trajectory;
 }
 
 bool TrajectoryCache::insertTrajectory(
@@ -251,6 +344,9 @@ bool TrajectoryCache::insertTrajectory(
     bool prune_worse_trajectories,
     const std::vector<std::unique_ptr<FeaturesInterface<MotionPlanRequest>>>& additional_features)
 {
+  std::unique_lock lock(cache_mutex_);
+  const auto start = std::chrono::steady_clock::now();
+  size_t pruned_entries = 0;
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_trajectory_cache", cache_namespace);
 
@@ -259,11 +355,28 @@ bool TrajectoryCache::insertTrajectory(
   {
     RCLCPP_ERROR_STREAM(logger_, "Skipping trajectory insert, invalid inputs: " << ret.message);
     cache_insert_policy.reset();
+    recordInsert(TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
     return false;
   }
 
-  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_entries =
-      cache_insert_policy.fetchMatchingEntries(move_group, coll, plan_request, plan, options_.exact_match_precision);
+  // The in-memory index, if used, saves querying the database for the entries to prune.
+  std::optional<std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>> indexed_matching_entries;
+  if (options_.use_in_memory_index)
+  {
+    indexed_matching_entries = cache_insert_policy.fetchMatchingIndexedEntries(
+        move_group, getIndexedEntries(TRAJECTORY_DATABASE, cache_namespace), plan_request, plan,
+        options_.exact_match_precision);
+  }
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_entries;
+  if (indexed_matching_entries)
+  {
+    matching_entries = std::move(*indexed_matching_entries);
+  }
+  else
+  {
+    matching_entries =
+        cache_insert_policy.fetchMatchingEntries(move_group, coll, plan_request, plan, options_.exact_match_precision);
+  }
 
   // Prune.
   if (prune_worse_trajectories)
@@ -280,7 +393,8 @@ bool TrajectoryCache::insertTrajectory(
 
         Query::Ptr delete_query = coll.createQuery();
         delete_query->append("id", delete_id);
-        coll.removeMessages(delete_query);
+        pruned_entries += coll.removeMessages(delete_query);
+        removeFromIndex(TRAJECTORY_DATABASE, cache_namespace, delete_id);
       }
     }
   }
@@ -298,6 +412,7 @@ bool TrajectoryCache::insertTrajectory(
                           "Skipping trajectory insert: Could not construct insert metadata from cache_insert_policy: "
                               << cache_insert_policy.getName() << ": " << ret.message);
       cache_insert_policy.reset();
+      recordInsert(TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
       return false;
     }
 
@@ -311,19 +426,23 @@ bool TrajectoryCache::insertTrajectory(
                             "Skipping trajectory insert: Could not construct insert metadata additional_feature: "
                                 << additional_feature->getName() << ": " << ret.message);
         cache_insert_policy.reset();
+        recordInsert(TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
         return false;
       }
     }
 
     RCLCPP_DEBUG_STREAM(logger_, "Inserting trajectory:" << insert_reason);
     coll.insert(plan.trajectory, insert_metadata);
+    addNewEntriesToIndex(TRAJECTORY_DATABASE, cache_namespace, coll);
     cache_insert_policy.reset();
+    recordInsert(TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/true, pruned_entries, start);
     return true;
   }
   else
   {
     RCLCPP_DEBUG_STREAM(logger_, "Skipping trajectory insert:" << insert_reason);
     cache_insert_policy.reset();
+    recordInsert(TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
     return false;
   }
 }
@@ -338,6 +457,16 @@ std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> TrajectoryCache::fet
     const std::vector<std::unique_ptr<FeaturesInterface<GetCartesianPath::Request>>>& features,
     const std::string& sort_by, bool ascending, bool metadata_only) const
 {
+  std::shared_lock lock(cache_mutex_);
+  if (options_.use_in_memory_index)
+  {
+    return fetchAllMatchingIndexedTrajectories(move_group, CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, plan_request,
+                                               features, sort_by, ascending, metadata_only);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  FetchTimings timings;
+  std::scoped_lock db_lock(db_mutex_);
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_cartesian_trajectory_cache", cache_namespace);
 
@@ -353,7 +482,26 @@ std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> TrajectoryCache::fet
       return {};
     }
   }
-  return coll.queryList(query, metadata_only, sort_by, ascending);
+  timings.query_build_s = secondsSince(start);
+
+  const auto database_start = std::chrono::steady_clock::now();
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_trajectories =
+      coll.queryList(query, metadata_only, sort_by, ascending);
+  timings.database_s = secondsSince(database_start);
+  recordFetch(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, !matching_trajectories.empty(), start, timings);
+
+  if (options_.collect_feature_statistics)
+  {
+    recordFeatureStatistics<GetCartesianPath::Request>(
+        CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, features, !matching_trajectories.empty(),
+        [&](const FeaturesInterface<GetCartesianPath::Request>& feature) {
+          Query::Ptr feature_query = coll.createQuery();
+          return feature.appendFeaturesAsFuzzyFetchQuery(*feature_query, plan_request, move_group,
+                                                         options_.exact_match_precision) &&
+                 !coll.queryList(feature_query, /*metadata_only=*/true).empty();
+        });
+  }
+  return matching_trajectories;
 }
 
 MessageWithMetadata<RobotTrajectory>::ConstPtr TrajectoryCache::fetchBestMatchingCartesianTrajectory(
@@ -372,6 +520,9 @@ MessageWithMetadata<RobotTrajectory>::ConstPtr TrajectoryCache::fetchBestMatchin
     return nullptr;
   }
 
+  std::shared_lock lock(cache_mutex_);
+  const auto start = std::chrono::steady_clock::now();
+  std::scoped_lock db_lock(db_mutex_);
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_cartesian_trajectory_cache", cache_namespace);
 
@@ -380,7 +531,9 @@ MessageWithMetadata<RobotTrajectory>::ConstPtr TrajectoryCache::fetchBestMatchin
   Query::Ptr best_query = coll.createQuery();
   best_query->append("id", best_trajectory_id);
 
-  return coll.findOne(best_query, metadata_only);
+  MessageWithMetadata<RobotTrajectory>::ConstPtr best_trajectory = coll.findOne(best_query, metadata_only);
+  recordFetchDatabaseTime(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, start);
+  return best_trajectory;
 }
 
 bool TrajectoryCache::insertCartesianTrajectory(
@@ -391,6 +544,9 @@ bool TrajectoryCache::insertCartesianTrajectory(
     bool prune_worse_trajectories,
     const std::vector<std::unique_ptr<FeaturesInterface<GetCartesianPath::Request>>>& additional_features)
 {
+  std::unique_lock lock(cache_mutex_);
+  const auto start = std::chrono::steady_clock::now();
+  size_t pruned_entries = 0;
   MessageCollection<RobotTrajectory> coll =
       db_->openCollection<RobotTrajectory>("move_group_cartesian_trajectory_cache", cache_namespace);
 
@@ -399,11 +555,28 @@ bool TrajectoryCache::insertCartesianTrajectory(
   {
     RCLCPP_ERROR_STREAM(logger_, "Skipping cartesian trajectory insert, invalid inputs: " << ret.message);
     cache_insert_policy.reset();
+    recordInsert(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
     return false;
   }
 
-  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_entries =
-      cache_insert_policy.fetchMatchingEntries(move_group, coll, plan_request, plan, options_.exact_match_precision);
+  // The in-memory index, if used, saves querying the database for the entries to prune.
+  std::optional<std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>> indexed_matching_entries;
+  if (options_.use_in_memory_index)
+  {
+    indexed_matching_entries = cache_insert_policy.fetchMatchingIndexedEntries(
+        move_group, getIndexedEntries(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace), plan_request, plan,
+        options_.exact_match_precision);
+  }
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_entries;
+  if (indexed_matching_entries)
+  {
+    matching_entries = std::move(*indexed_matching_entries);
+  }
+  else
+  {
+    matching_entries =
+        cache_insert_policy.fetchMatchingEntries(move_group, coll, plan_request, plan, options_.exact_match_precision);
+  }
 
   // Prune.
   if (prune_worse_trajectories)
@@ -420,7 +593,8 @@ bool TrajectoryCache::insertCartesianTrajectory(
 
         Query::Ptr delete_query = coll.createQuery();
         delete_query->append("id", delete_id);
-        coll.removeMessages(delete_query);
+        pruned_entries += coll.removeMessages(delete_query);
+        removeFromIndex(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, delete_id);
       }
     }
   }
@@ -438,6 +612,7 @@ bool TrajectoryCache::insertCartesianTrajectory(
                                    "cache_insert_policy: "
                                        << cache_insert_policy.getName() << ": " << ret.message);
       cache_insert_policy.reset();
+      recordInsert(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
       return false;
     }
 
@@ -451,22 +626,367 @@ bool TrajectoryCache::insertCartesianTrajectory(
             logger_, "Skipping cartesian trajectory insert: Could not construct insert metadata additional_feature: "
                          << additional_feature->getName() << ": " << ret.message);
         cache_insert_policy.reset();
+        recordInsert(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
         return false;
       }
     }
 
     RCLCPP_DEBUG_STREAM(logger_, "Inserting cartesian trajectory:" << insert_reason);
     coll.insert(plan.solution, insert_metadata);
+    addNewEntriesToIndex(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, coll);
     cache_insert_policy.reset();
+    recordInsert(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/true, pruned_entries, start);
     return true;
   }
   else
   {
     RCLCPP_DEBUG_STREAM(logger_, "Skipping cartesian insert:" << insert_reason);
     cache_insert_policy.reset();
+    recordInsert(CARTESIAN_TRAJECTORY_DATABASE, cache_namespace, /*inserted=*/false, pruned_entries, start);
     return false;
   }
 }
 
+// =================================================================================================
+// Background Inserts.
+// =================================================================================================
+
+void TrajectoryCache::insertTrajectoryAsync(
+    const std::shared_ptr<const MoveGroupInterface>& move_group, const std::string& cache_namespace,
+    const MotionPlanRequest& plan_request, const MoveGroupInterface::Plan& plan,
+    std::unique_ptr<CacheInsertPolicyInterface<MotionPlanRequest, MoveGroupInterface::Plan, RobotTrajectory>>
+        cache_insert_policy,
+    bool prune_worse_trajectories,
+    std::vector<std::unique_ptr<FeaturesInterface<MotionPlanRequest>>> additional_features)
+{
+  // The queue holds copyable functions, so the move-only arguments are shared
+  std::shared_ptr<CacheInsertPolicyInterface<MotionPlanRequest, MoveGroupInterface::Plan, RobotTrajectory>> policy =
+      std::move(cache_insert_policy);
+  auto features = std::make_shared<std::vector<std::unique_ptr<FeaturesInterface<MotionPlanRequest>>>>(
+      std::move(additional_features));
+  queueInsert([this, move_group, cache_namespace, plan_request, plan, policy, prune_worse_trajectories, features] {
+    insertTrajectory(*move_group, cache_namespace, plan_request, plan, *policy, prune_worse_trajectories, *features);
+  });
+}
+
+void TrajectoryCache::insertCartesianTrajectoryAsync(
+    const std::shared_ptr<const MoveGroupInterface>& move_group, const std::string& cache_namespace,
+    const GetCartesianPath::Request& plan_request, const GetCartesianPath::Response& plan,
+    std::unique_ptr<CacheInsertPolicyInterface<GetCartesianPath::Request, GetCartesianPath::Response, RobotTrajectory>>
+        cache_insert_policy,
+    bool prune_worse_trajectories,
+    std::vector<std::unique_ptr<FeaturesInterface<GetCartesianPath::Request>>> additional_features)
+{
+  // The queue holds copyable functions, so the move-only arguments are shared
+  std::shared_ptr<CacheInsertPolicyInterface<GetCartesianPath::Request, GetCartesianPath::Response, RobotTrajectory>>
+      policy = std::move(cache_insert_policy);
+  auto features = std::make_shared<std::vector<std::unique_ptr<FeaturesInterface<GetCartesianPath::Request>>>>(
+      std::move(additional_features));
+  queueInsert([this, move_group, cache_namespace, plan_request, plan, policy, prune_worse_trajectories, features] {
+    insertCartesianTrajectory(*move_group, cache_namespace, plan_request, plan, *policy, prune_worse_trajectories,
+                              *features);
+  });
+}
+
+void TrajectoryCache::flushInserts()
+{
+  std::unique_lock lock(insert_queue_mutex_);
+  inserts_done_condition_.wait(lock, [this] { return pending_inserts_ == 0; });
+}
+
+size_t TrajectoryCache::getPendingInsertCount() const
+{
+  std::scoped_lock lock(insert_queue_mutex_);
+  return pending_inserts_;
+}
+
+void TrajectoryCache::queueInsert(std::function<void()> insert)
+{
+  {
+    std::scoped_lock lock(insert_queue_mutex_);
+    insert_queue_.push_back(std::move(insert));
+    ++pending_inserts_;
+    if (!insert_thread_.joinable())
+    {
+      insert_thread_ = std::thread([this] { insertLoop(); });
+    }
+  }
+  insert_queue_condition_.notify_one();
+}
+
+void TrajectoryCache::insertLoop()
+{
+  std::unique_lock lock(insert_queue_mutex_);
+  while (true)
+  {
+    insert_queue_condition_.wait(lock, [this] { return stop_insert_thread_ || !insert_queue_.empty(); });
+    // Queued inserts are written before the thread stops.
+    if (insert_queue_.empty())
+    {
+      return;
+    }
+
+    // Inserts queued in the meantime are written as one batch.
+    std::deque<std::function<void()>> batch;
+    batch.swap(insert_queue_);
+    lock.unlock();
+    for (const std::function<void()>& insert : batch)
+    {
+      try
+      {
+        insert();
+      }
+      catch (const std::exception& e)
+      {
+        RCLCPP_ERROR_STREAM(logger_, "Background trajectory insert failed: " << e.what());
+      }
+    }
+    lock.lock();
+    pending_inserts_ -= batch.size();
+    inserts_done_condition_.notify_all();
+  }
+}
+
+// =================================================================================================
+// In-Memory Index.
+// =================================================================================================
+
+template <typename FeatureSourceT>
+std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> TrajectoryCache::fetchAllMatchingIndexedTrajectories(
+    const MoveGroupInterface& move_group, const std::string& database, const std::string& cache_namespace,
+    const FeatureSourceT& plan_request, const std::vector<std::unique_ptr<FeaturesInterface<FeatureSourceT>>>& features,
+    const std::string& sort_by, bool ascending, bool metadata_only) const
+{
+  const auto start = std::chrono::steady_clock::now();
+  FetchTimings timings;
+  FeatureQuery query;
+  for (const auto& feature : features)
+  {
+    if (MoveItErrorCode ret =
+            feature->appendFeaturesAsFuzzyFetchQuery(query, plan_request, move_group,
+                                                     /*exact_match_precision=*/options_.exact_match_precision);
+        !ret)
+    {
+      RCLCPP_ERROR_STREAM(logger_, "Could not construct trajectory query: " << ret.message);
+      return {};
+    }
+  }
+
+  timings.query_build_s = secondsSince(start);
+
+  auto phase_start = std::chrono::steady_clock::now();
+  const std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> entries =
+      getIndexedEntries(database, cache_namespace);
+  timings.database_s = secondsSince(phase_start);
+
+  phase_start = std::chrono::steady_clock::now();
+  std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr> matching_trajectories;
+  for (const auto& entry : entries)
+  {
+    if (query.matches(*entry))
+    {
+      matching_trajectories.push_back(entry);
+    }
+  }
+
+  // Entries without the sort feature go last.
+  std::stable_sort(matching_trajectories.begin(), matching_trajectories.end(),
+                   [&sort_by, ascending](const auto& lhs, const auto& rhs) {
+                     const bool lhs_has_feature = lhs->lookupField(sort_by);
+                     if (lhs_has_feature != rhs->lookupField(sort_by))
+                     {
+                       return lhs_has_feature;
+                     }
+                     if (!lhs_has_feature)
+                     {
+                       return false;
+                     }
+                     return ascending ? lhs->lookupDouble(sort_by) < rhs->lookupDouble(sort_by) :
+                                        lhs->lookupDouble(sort_by) > rhs->lookupDouble(sort_by);
+                   });
+  timings.match_and_sort_s = secondsSince(phase_start);
+
+  if (options_.collect_feature_statistics)
+  {
+    recordFeatureStatistics<FeatureSourceT>(
+        database, cache_namespace, features, !matching_trajectories.empty(),
+        [&](const FeaturesInterface<FeatureSourceT>& feature) {
+          FeatureQuery feature_query;
+          return feature.appendFeaturesAsFuzzyFetchQuery(feature_query, plan_request, move_group,
+                                                         options_.exact_match_precision) &&
+                 std::any_of(entries.begin(), entries.end(),
+                             [&feature_query](const auto& entry) { return feature_query.matches(*entry); });
+        });
+  }
+
+  if (!metadata_only)
+  {
+    // Only the selected trajectories are read from the database.
+    phase_start = std::chrono::steady_clock::now();
+    std::scoped_lock db_lock(db_mutex_);
+    MessageCollection<RobotTrajectory> coll = db_->openCollection<RobotTrajectory>(database, cache_namespace);
+    for (auto& matching_trajectory : matching_trajectories)
+    {
+      Query::Ptr id_query = coll.createQuery();
+      id_query->append("id", matching_trajectory->lookupInt("id"));
+      matching_trajectory = coll.findOne(id_query, /*metadata_only=*/false);
+    }
+    timings.database_s += secondsSince(phase_start);
+  }
+  recordFetch(database, cache_namespace, !matching_trajectories.empty(), start, timings);
+  return matching_trajectories;
+}
+
+std::vector<MessageWithMetadata<RobotTrajectory>::ConstPtr>
+TrajectoryCache::getIndexedEntries(const std::string& database, const std::string& cache_namespace) const
+{
+  std::scoped_lock db_lock(db_mutex_);
+  MessageCollection<RobotTrajectory> coll = db_->openCollection<RobotTrajectory>(database, cache_namespace);
+  MetadataIndex& index = metadata_indices_[database + "@" + cache_namespace];
+
+  // Entries inserted or removed through other connections to the database change the count.
+  if (index.stale || coll.count() != index.entries.size())
+  {
+    index.entries = coll.queryList(coll.createQuery(), /*metadata_only=*/true);
+    index.max_id = -1;
+    for (const auto& entry : index.entries)
+    {
+      index.max_id = std::max(index.max_id, entry->lookupInt("id"));
+    }
+    index.stale = false;
+  }
+  return index.entries;
+}
+
+void TrajectoryCache::invalidateIndex(const std::string& database, const std::string& cache_namespace)
+{
+  if (auto it = metadata_indices_.find(database + "@" + cache_namespace); it != metadata_indices_.end())
+  {
+    it->second.stale = true;
+  }
+}
+
+void TrajectoryCache::removeFromIndex(const std::string& database, const std::string& cache_namespace, int id)
+{
+  auto it = metadata_indices_.find(database + "@" + cache_namespace);
+  if (it == metadata_indices_.end() || it->second.stale)
+  {
+    return;
+  }
+  auto& entries = it->second.entries;
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [id](const auto& entry) { return entry->lookupInt("id") == id; }),
+                entries.end());
+}
+
+void TrajectoryCache::addNewEntriesToIndex(const std::string& database, const std::string& cache_namespace,
+                                           const MessageCollection<RobotTrajectory>& coll)
+{
+  auto it = metadata_indices_.find(database + "@" + cache_namespace);
+  if (it == metadata_indices_.end() || it->second.stale)
+  {
+    return;
+  }
+
+  // Database IDs increase with every insert. If they don't, the entry count check of getIndexedEntries reloads.
+  MetadataIndex& index = it->second;
+  Query::Ptr query = coll.createQuery();
+  query->appendGT("id", index.max_id);
+  for (const auto& entry : coll.queryList(query, /*metadata_only=*/true))
+  {
+    index.max_id = std::max(index.max_id, entry->lookupInt("id"));
+    index.entries.push_back(entry);
+  }
+}
+
+// =================================================================================================
+// Statistics.
+// =================================================================================================
+
+TrajectoryCacheStatistics TrajectoryCache::getStatistics() const
+{
+  std::scoped_lock lock(statistics_mutex_);
+  return statistics_;
+}
+
+void TrajectoryCache::resetStatistics()
+{
+  std::scoped_lock lock(statistics_mutex_);
+  statistics_.clear();
+}
+
+void TrajectoryCache::recordFetch(const std::string& database, const std::string& cache_namespace, bool hit,
+                                  const std::chrono::steady_clock::time_point& start,
+                                  const FetchTimings& timings) const
+{
+  const double fetch_s = secondsSince(start);
+  std::scoped_lock lock(statistics_mutex_);
+  CacheNamespaceStatistics& stats = statistics_[database + "@" + cache_namespace];
+  ++stats.fetches;
+  ++(hit ? stats.hits : stats.misses);
+  stats.fetch_latency.record(fetch_s);
+  stats.query_build_latency.record(timings.query_build_s);
+  stats.database_latency.record(timings.database_s);
+  if (options_.use_in_memory_index)
+  {
+    stats.match_and_sort_latency.record(timings.match_and_sort_s);
+  }
+}
+
+void TrajectoryCache::recordFetchDatabaseTime(const std::string& database, const std::string& cache_namespace,
+                                              const std::chrono::steady_clock::time_point& start) const
+{
+  const double database_s = secondsSince(start);
+  std::scoped_lock lock(statistics_mutex_);
+  statistics_[database + "@" + cache_namespace].database_latency.record(database_s);
+}
+
+void TrajectoryCache::recordInsert(const std::string& database, const std::string& cache_namespace, bool inserted,
+                                   size_t pruned_entries, const std::chrono::steady_clock::time_point& start) const
+{
+  const double insert_s = secondsSince(start);
+  std::scoped_lock lock(statistics_mutex_);
+  CacheNamespaceStatistics& stats = statistics_[database + "@" + cache_namespace];
+  ++(inserted ? stats.inserts : stats.skipped_inserts);
+  stats.pruned_entries += pruned_entries;
+  stats.insert_latency.record(insert_s);
+}
+
+template <typename FeatureSourceT>
+void TrajectoryCache::recordFeatureStatistics(
+    const std::string& database, const std::string& cache_namespace,
+    const std::vector<std::unique_ptr<FeaturesInterface<FeatureSourceT>>>& features, bool hit,
+    const std::function<bool(const FeaturesInterface<FeatureSourceT>&)>& matches_any_entry) const
+{
+  // The single feature checks run before locking, since they may query the database.
+  std::vector<bool> blamed(features.size(), false);
+  if (!hit)
+  {
+    for (size_t i = 0; i < features.size(); ++i)
+    {
+      blamed[i] = !matches_any_entry(*features[i]);
+    }
+  }
+
+  std::scoped_lock lock(statistics_mutex_);
+  CacheNamespaceStatistics& stats = statistics_[database + "@" + cache_namespace];
+  for (size_t i = 0; i < features.size(); ++i)
+  {
+    FeatureMatchStatistics& feature_stats = stats.features[features[i]->getName()];
+    ++feature_stats.fetches;
+    if (blamed[i])
+    {
+      ++feature_stats.misses;
+    }
+  }
+}
+
+void TrajectoryCache::publishStatistics() const
+{
+  diagnostic_msgs::msg::DiagnosticArray array = toDiagnosticArray(getStatistics());
+  array.header.stamp = node_->now();
+  statistics_publisher_->publish(array);
+}
+
 }  // namespace trajectory_cache
 }  // namespace moveit_ros
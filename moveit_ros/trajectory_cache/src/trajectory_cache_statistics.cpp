@@ -0,0 +1,123 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Implementation of the trajectory cache statistics.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include <moveit/trajectory_cache/trajectory_cache_statistics.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+namespace
+{
+
+using ::diagnostic_msgs::msg::DiagnosticArray;
+using ::diagnostic_msgs::msg::DiagnosticStatus;
+using ::diagnostic_msgs::msg::KeyValue;
+
+void appendValue(DiagnosticStatus& status, const std::string& key, const std::string& value)
+{
+  KeyValue key_value;
+  key_value.key = key;
+  key_value.value = value;
+  status.values.push_back(std::move(key_value));
+}
+
+void appendHistogram(DiagnosticStatus& status, const std::string& name, const LatencyHistogram& histogram)
+{
+  appendValue(status, name + ".count", std::to_string(histogram.count));
+  appendValue(status, name + ".mean_s", std::to_string(histogram.mean()));
+  appendValue(status, name + ".max_s", std::to_string(histogram.max_s));
+
+  // Buckets are named by their upper bound, like the "le" label of Prometheus histograms.
+  for (size_t i = 0; i < histogram.bucket_counts.size(); ++i)
+  {
+    std::ostringstream bound;
+    if (i < LatencyHistogram::BUCKET_UPPER_BOUNDS_S.size())
+    {
+      bound << LatencyHistogram::BUCKET_UPPER_BOUNDS_S[i];
+    }
+    else
+    {
+      bound << "inf";
+    }
+    appendValue(status, name + ".le_" + bound.str(), std::to_string(histogram.bucket_counts[i]));
+  }
+}
+
+}  // namespace
+
+void LatencyHistogram::record(double duration_s)
+{
+  const auto bucket = std::lower_bound(BUCKET_UPPER_BOUNDS_S.begin(), BUCKET_UPPER_BOUNDS_S.end(), duration_s);
+  ++bucket_counts[bucket - BUCKET_UPPER_BOUNDS_S.begin()];
+  ++count;
+  sum_s += duration_s;
+  max_s = std::max(max_s, duration_s);
+}
+
+double LatencyHistogram::mean() const
+{
+  return count == 0 ? 0.0 : sum_s / static_cast<double>(count);
+}
+
+DiagnosticArray toDiagnosticArray(const TrajectoryCacheStatistics& statistics)
+{
+  DiagnosticArray array;
+  for (const auto& [name, stats] : statistics)
+  {
+    DiagnosticStatus status;
+    status.level = DiagnosticStatus::OK;
+    status.name = "trajectory_cache: " + name;
+    status.hardware_id = name;
+
+    std::ostringstream message;
+    message << std::fixed << std::setprecision(1) << "hit rate "
+            << (stats.fetches == 0 ? 0.0 : 100.0 * static_cast<double>(stats.hits) / static_cast<double>(stats.fetches))
+            << "% of " << stats.fetches << " fetches";
+    status.message = message.str();
+
+    appendValue(status, "fetches", std::to_string(stats.fetches));
+    appendValue(status, "hits", std::to_string(stats.hits));
+    appendValue(status, "misses", std::to_string(stats.misses));
+    appendValue(status, "inserts", std::to_string(stats.inserts));
+    appendValue(status, "skipped_inserts", std::to_string(stats.skipped_inserts));
+    appendValue(status, "pruned_entries", std::to_string(stats.pruned_entries));
+
+    appendHistogram(status, "fetch_latency", stats.fetch_latency);
+    appendHistogram(status, "query_build_latency", stats.query_build_latency);
+    appendHistogram(status, "database_latency", stats.database_latency);
+    appendHistogram(status, "match_and_sort_latency", stats.match_and_sort_latency);
+    appendHistogram(status, "insert_latency", stats.insert_latency);
+
+    for (const auto& [feature_name, feature_stats] : stats.features)
+    {
+      appendValue(status, "feature." + feature_name + ".fetches", std::to_string(feature_stats.fetches));
+      appendValue(status, "feature." + feature_name + ".misses", std::to_string(feature_stats.misses));
+    }
+    array.status.push_back(std::move(status));
+  }
+  return array;
+}
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
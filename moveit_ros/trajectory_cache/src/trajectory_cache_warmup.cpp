@@ -0,0 +1,103 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Implementation of the offline population of the trajectory cache.
+ * @see trajectory_cache_warmup.hpp
+ */
+
+#include <rclcpp/logging.hpp>
+
+#include <moveit/planning_pipeline_interfaces/planning_pipeline_interfaces.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <moveit/trajectory_cache/cache_insert_policies/best_seen_execution_time_policy.hpp>
+#include <moveit/trajectory_cache/trajectory_cache_warmup.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+using ::moveit::planning_interface::MoveGroupInterface;
+using ::moveit_msgs::msg::MotionPlanRequest;
+
+TrajectoryCacheWarmupStatistics warmUpTrajectoryCache(
+    TrajectoryCache& cache, const std::shared_ptr<const MoveGroupInterface>& move_group,
+    const std::string& cache_namespace, const std::vector<MotionPlanRequest>& motion_templates,
+    const planning_scene::PlanningSceneConstPtr& planning_scene,
+    const std::unordered_map<std::string, planning_pipeline::PlanningPipelinePtr>& planning_pipelines,
+    const moveit_cpp::PlanningComponent::MultiPipelinePlanRequestParameters& plan_request_parameters,
+    size_t num_rounds)
+{
+  const rclcpp::Logger logger = moveit::getLogger("moveit.ros.trajectory_cache_warmup");
+  TrajectoryCacheWarmupStatistics statistics;
+
+  for (size_t template_index = 0; template_index < motion_templates.size(); ++template_index)
+  {
+    const MotionPlanRequest& motion_template = motion_templates[template_index];
+
+    // The scaling factors are cache features, so they are kept from the template.
+    std::vector<MotionPlanRequest> requests;
+    requests.reserve(plan_request_parameters.plan_request_parameter_vector.size());
+    for (const auto& parameters : plan_request_parameters.plan_request_parameter_vector)
+    {
+      MotionPlanRequest& request = requests.emplace_back(motion_template);
+      request.pipeline_id = parameters.planning_pipeline;
+      request.planner_id = parameters.planner_id;
+      request.num_planning_attempts = parameters.planning_attempts;
+      request.allowed_planning_time = parameters.planning_time;
+    }
+
+    size_t num_template_solutions = 0;
+    for (size_t round = 0; round < num_rounds; ++round)
+    {
+      const std::vector<::planning_interface::MotionPlanResponse> responses =
+          moveit::planning_pipeline_interfaces::planWithParallelPipelines(requests, planning_scene,
+                                                                            planning_pipelines);
+      ++statistics.num_planning_rounds;
+
+      for (const auto& response : responses)
+      {
+        if (!response || !response.trajectory)
+        {
+          continue;
+        }
+        MoveGroupInterface::Plan plan;
+        response.trajectory->getRobotTrajectoryMsg(plan.trajectory);
+        plan.start_state = response.start_state;
+        plan.planning_time = response.planning_time;
+
+        // Keyed on the template, since the pipeline and planner are not cache features.
+        cache.insertTrajectoryAsync(move_group, cache_namespace, motion_template, plan,
+                                    std::make_unique<BestSeenExecutionTimePolicy>());
+        ++num_template_solutions;
+      }
+    }
+
+    statistics.num_solutions += num_template_solutions;
+    if (num_template_solutions == 0)
+    {
+      ++statistics.num_unsolved_templates;
+      RCLCPP_WARN(logger, "No solution found for motion template %zu of group '%s'", template_index,
+                  motion_template.group_name.c_str());
+    }
+  }
+
+  cache.flushInserts();
+  return statistics;
+}
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
@@ -0,0 +1,149 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Populates a trajectory cache with the best seen trajectories between a set of stations.
+ *
+ * Parameters:
+ *   - group_name: The planning group to plan for.
+ *   - cache_namespace: The cache namespace to insert into, the robot name by default.
+ *   - db_path, db_port: The database to populate.
+ *   - stations: The names of the stations, each with a `stations.<name>` parameter holding the positions of the active
+ *     joints of the group.
+ *   - moves: The moves to plan, as "<start station>:<goal station>". All moves between stations by default.
+ *   - plan_request_namespaces: The namespaces of the `plan_request_params` to plan with in parallel.
+ *   - num_rounds: The number of times each move is planned.
+ *
+ * The move_group node must be running, since the cache features are extracted with a MoveGroupInterface. The planning
+ * pipelines are loaded by this node, like by MoveItCpp.
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include <moveit/move_group_interface/move_group_interface.hpp>
+#include <moveit/moveit_cpp/moveit_cpp.hpp>
+#include <moveit/planning_scene_monitor/planning_scene_monitor.hpp>
+#include <moveit/robot_state/robot_state.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <moveit/trajectory_cache/trajectory_cache.hpp>
+#include <moveit/trajectory_cache/trajectory_cache_warmup.hpp>
+
+using ::moveit::planning_interface::MoveGroupInterface;
+using ::moveit_ros::trajectory_cache::TrajectoryCache;
+
+int main(int argc, char** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::NodeOptions node_options;
+  node_options.automatically_declare_parameters_from_overrides(true);
+  rclcpp::Node::SharedPtr node = rclcpp::Node::make_shared("trajectory_cache_warmup", node_options);
+  moveit::setNodeLoggerName(node->get_name());
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  std::thread spinner([&executor] { executor.spin(); });
+  auto shutdown = [&](int code) {
+    rclcpp::shutdown();
+    spinner.join();
+    return code;
+  };
+
+  const std::string group_name = node->get_parameter_or<std::string>("group_name", "");
+  const std::vector<std::string> station_names =
+      node->get_parameter_or<std::vector<std::string>>("stations", std::vector<std::string>());
+  std::vector<std::string> moves =
+      node->get_parameter_or<std::vector<std::string>>("moves", std::vector<std::string>());
+  const std::vector<std::string> plan_request_namespaces = node->get_parameter_or<std::vector<std::string>>(
+      "plan_request_namespaces", std::vector<std::string>({ "ompl" }));
+  const int num_rounds = node->get_parameter_or<int>("num_rounds", 10);
+
+  if (group_name.empty() || station_names.size() < 2)
+  {
+    RCLCPP_ERROR(node->get_logger(), "The parameters group_name and stations (at least two) are required");
+    return shutdown(1);
+  }
+  if (moves.empty())
+  {
+    for (const std::string& start : station_names)
+    {
+      for (const std::string& goal : station_names)
+      {
+        if (start != goal)
+        {
+          moves.push_back(start + ":" + goal);
+        }
+      }
+    }
+  }
+
+  auto moveit_cpp = std::make_shared<moveit_cpp::MoveItCpp>(node);
+  auto move_group = std::make_shared<MoveGroupInterface>(node, group_name);
+
+  TrajectoryCache::Options cache_options;
+  cache_options.db_path = node->get_parameter_or<std::string>("db_path", cache_options.db_path);
+  cache_options.db_port = node->get_parameter_or<int>("db_port", static_cast<int>(cache_options.db_port));
+  TrajectoryCache cache(node);
+  if (!cache.init(cache_options))
+  {
+    RCLCPP_ERROR(node->get_logger(), "Could not connect to the trajectory cache database");
+    return shutdown(1);
+  }
+  const std::string cache_namespace =
+      node->get_parameter_or<std::string>("cache_namespace", moveit_cpp->getRobotModel()->getName());
+
+  // The motion templates are constructed like the requests of the move group in production.
+  moveit::core::RobotState state(moveit_cpp->getRobotModel());
+  state.setToDefaultValues();
+  std::vector<moveit_msgs::msg::MotionPlanRequest> motion_templates;
+  for (const std::string& move : moves)
+  {
+    const size_t separator = move.find(':');
+    std::vector<double> start_positions;
+    std::vector<double> goal_positions;
+    if (separator == std::string::npos ||
+        !node->get_parameter("stations." + move.substr(0, separator), start_positions) ||
+        !node->get_parameter("stations." + move.substr(separator + 1), goal_positions))
+    {
+      RCLCPP_ERROR(node->get_logger(), "Invalid move '%s', stations must be defined as stations.<name>", move.c_str());
+      return shutdown(1);
+    }
+
+    state.setJointGroupActivePositions(group_name, start_positions);
+    move_group->setStartState(state);
+    if (!move_group->setJointValueTarget(goal_positions))
+    {
+      RCLCPP_ERROR(node->get_logger(), "Invalid goal of move '%s'", move.c_str());
+      return shutdown(1);
+    }
+    move_group->constructMotionPlanRequest(motion_templates.emplace_back());
+  }
+
+  const moveit_cpp::PlanningComponent::MultiPipelinePlanRequestParameters plan_request_parameters(
+      node, plan_request_namespaces);
+  const auto statistics = moveit_ros::trajectory_cache::warmUpTrajectoryCache(
+      cache, move_group, cache_namespace, motion_templates,
+      moveit_cpp->getPlanningSceneMonitorNonConst()->getSceneSnapshot(),
+      moveit_cpp->getPlanningPipelines(), plan_request_parameters, static_cast<size_t>(std::max(num_rounds, 1)));
+
+  RCLCPP_INFO(node->get_logger(),
+              "Planned %zu moves in %zu rounds, offered %zu solutions, %zu moves without solution. The cache holds "
+              "%u trajectories in namespace '%s'",
+              motion_templates.size(), statistics.num_planning_rounds, statistics.num_solutions,
+              statistics.num_unsolved_templates, cache.countTrajectories(cache_namespace), cache_namespace.c_str());
+  return shutdown(statistics.num_unsolved_templates == 0 ? 0 : 1);
+}
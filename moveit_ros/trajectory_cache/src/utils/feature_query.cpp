@@ -0,0 +1,148 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Implementation of the in-memory evaluation of cache feature queries.
+ */
+
+#include <string>
+
+#include <moveit/trajectory_cache/utils/feature_query.hpp>
+
+namespace moveit_ros
+{
+namespace trajectory_cache
+{
+
+void FeatureQuery::append(const std::string& name, const std::string& val)
+{
+  constraints_.push_back({ name, Comparison::EQUAL, val });
+}
+
+void FeatureQuery::append(const std::string& name, const double val)
+{
+  appendNumeric(name, Comparison::EQUAL, val);
+}
+
+void FeatureQuery::append(const std::string& name, const int val)
+{
+  appendNumeric(name, Comparison::EQUAL, val);
+}
+
+void FeatureQuery::append(const std::string& name, const bool val)
+{
+  constraints_.push_back({ name, Comparison::EQUAL, val });
+}
+
+void FeatureQuery::appendLT(const std::string& name, const double val)
+{
+  appendNumeric(name, Comparison::LESS, val);
+}
+
+void FeatureQuery::appendLT(const std::string& name, const int val)
+{
+  appendNumeric(name, Comparison::LESS, val);
+}
+
+void FeatureQuery::appendLTE(const std::string& name, const double val)
+{
+  appendNumeric(name, Comparison::LESS_EQUAL, val);
+}
+
+void FeatureQuery::appendLTE(const std::string& name, const int val)
+{
+  appendNumeric(name, Comparison::LESS_EQUAL, val);
+}
+
+void FeatureQuery::appendGT(const std::string& name, const double val)
+{
+  appendNumeric(name, Comparison::GREATER, val);
+}
+
+void FeatureQuery::appendGT(const std::string& name, const int val)
+{
+  appendNumeric(name, Comparison::GREATER, val);
+}
+
+void FeatureQuery::appendGTE(const std::string& name, const double val)
+{
+  appendNumeric(name, Comparison::GREATER_EQUAL, val);
+}
+
+void FeatureQuery::appendGTE(const std::string& name, const int val)
+{
+  appendNumeric(name, Comparison::GREATER_EQUAL, val);
+}
+
+void FeatureQuery::appendRange(const std::string& name, const double lower, const double upper)
+{
+  appendNumeric(name, Comparison::RANGE, lower, upper);
+}
+
+void FeatureQuery::appendRange(const std::string& name, const int lower, const int upper)
+{
+  appendNumeric(name, Comparison::RANGE, lower, upper);
+}
+
+void FeatureQuery::appendRangeInclusive(const std::string& name, const double lower, const double upper)
+{
+  appendNumeric(name, Comparison::RANGE_INCLUSIVE, lower, upper);
+}
+
+void FeatureQuery::appendRangeInclusive(const std::string& name, const int lower, const int upper)
+{
+  appendNumeric(name, Comparison::RANGE_INCLUSIVE, lower, upper);
+}
+
+size_t FeatureQuery::size() const
+{
+  return constraints_.size();
+}
+
+bool FeatureQuery::satisfies(const Constraint& constraint, double value)
+{
+  const double bound = std::holds_alternative<int>(constraint.value) ? std::get<int>(constraint.value) :
+                                                                       std::get<double>(constraint.value);
+  switch (constraint.comparison)
+  {
+    case Comparison::EQUAL:
+      return value == bound;
+    case Comparison::LESS:
+      return value < bound;
+    case Comparison::LESS_EQUAL:
+      return value <= bound;
+    case Comparison::GREATER:
+      return value > bound;
+    case Comparison::GREATER_EQUAL:
+      return value >= bound;
+    case Comparison::RANGE:
+      return value > bound && value < constraint.upper;
+    case Comparison::RANGE_INCLUSIVE:
+      return value >= bound && value <= constraint.upper;
+  }
+  return false;
+}
+
+void FeatureQuery::appendNumeric(const std::string& name, Comparison comparison, double value, double upper)
+{
+  constraints_.push_back({ name, comparison, value, upper });
+}
+
+void FeatureQuery::appendNumeric(const std::string& name, Comparison comparison, int value, int upper)
+{
+  constraints_.push_back({ name, comparison, value, static_cast<double>(upper) });
+}
+
+}  // namespace trajectory_cache
+}  // namespace moveit_ros
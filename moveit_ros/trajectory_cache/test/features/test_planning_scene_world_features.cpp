@@ -0,0 +1,125 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Tests for the planning scene world features.
+ */
+
+#include <gtest/gtest.h>
+
+#include <moveit_msgs/msg/planning_scene_world.hpp>
+#include <shape_msgs/msg/solid_primitive.hpp>
+
+#include <moveit/trajectory_cache/features/planning_scene_world_features.hpp>
+
+namespace
+{
+
+using ::moveit_msgs::msg::CollisionObject;
+using ::moveit_msgs::msg::PlanningSceneWorld;
+using ::shape_msgs::msg::SolidPrimitive;
+
+using ::moveit_ros::trajectory_cache::hashPlanningSceneWorld;
+
+CollisionObject makeBox(const std::string& id, double x)
+{
+  CollisionObject object;
+  object.id = id;
+  object.header.frame_id = "world";
+  object.pose.orientation.w = 1.0;
+  object.pose.position.x = x;
+
+  SolidPrimitive box;
+  box.type = SolidPrimitive::BOX;
+  box.dimensions = { 0.1, 0.1, 0.1 };
+  object.primitives.push_back(box);
+  object.primitive_poses.emplace_back().orientation.w = 1.0;
+  return object;
+}
+
+TEST(PlanningSceneWorldFeatures, HashIsStableUnderNoiseAndReordering)
+{
+  PlanningSceneWorld world;
+  world.collision_objects = { makeBox("a", 0.5), makeBox("b", 1.0) };
+  const std::string hash = hashPlanningSceneWorld(world, 0.01);
+  EXPECT_EQ(hash.size(), 16u);
+
+  PlanningSceneWorld noisy = world;
+  std::swap(noisy.collision_objects[0], noisy.collision_objects[1]);
+  noisy.collision_objects[0].pose.position.x += 1e-4;
+  noisy.collision_objects[1].header.stamp.sec = 42;
+  noisy.collision_objects[1].operation = CollisionObject::APPEND;
+  EXPECT_EQ(hashPlanningSceneWorld(noisy, 0.01), hash);
+
+  // The same orientation with the opposite quaternion sign.
+  noisy.collision_objects[0].pose.orientation.w = -1.0;
+  EXPECT_EQ(hashPlanningSceneWorld(noisy, 0.01), hash);
+}
+
+TEST(PlanningSceneWorldFeatures, HashChangesWithWorld)
+{
+  PlanningSceneWorld world;
+  world.collision_objects = { makeBox("a", 0.5) };
+  const std::string hash = hashPlanningSceneWorld(world, 0.01);
+
+  PlanningSceneWorld moved = world;
+  moved.collision_objects[0].pose.position.x += 0.05;
+  EXPECT_NE(hashPlanningSceneWorld(moved, 0.01), hash);
+
+  PlanningSceneWorld resized = world;
+  resized.collision_objects[0].primitives[0].dimensions[2] = 0.2;
+  EXPECT_NE(hashPlanningSceneWorld(resized, 0.01), hash);
+
+  PlanningSceneWorld renamed = world;
+  renamed.collision_objects[0].id = "b";
+  EXPECT_NE(hashPlanningSceneWorld(renamed, 0.01), hash);
+
+  PlanningSceneWorld with_octomap = world;
+  with_octomap.octomap.octomap.data = { 1, 2, 3 };
+  const std::string octomap_hash = hashPlanningSceneWorld(with_octomap, 0.01);
+  EXPECT_NE(octomap_hash, hash);
+  with_octomap.octomap.octomap.data = { 1, 2, 4 };
+  EXPECT_NE(hashPlanningSceneWorld(with_octomap, 0.01), octomap_hash);
+}
+
+TEST(PlanningSceneWorldFeatures, HashIgnoresObjectsOutsideRegion)
+{
+  geometry_msgs::msg::Point center;
+  PlanningSceneWorld world;
+  world.collision_objects = { makeBox("near", 0.5) };
+  const std::string hash = hashPlanningSceneWorld(world, 0.01, "world", center, 1.0);
+
+  PlanningSceneWorld with_far_object = world;
+  with_far_object.collision_objects.push_back(makeBox("far", 5.0));
+  EXPECT_EQ(hashPlanningSceneWorld(with_far_object, 0.01, "world", center, 1.0), hash);
+  EXPECT_NE(hashPlanningSceneWorld(with_far_object, 0.01), hashPlanningSceneWorld(world, 0.01));
+
+  // Objects in other frames can't be located, so they are kept.
+  with_far_object.collision_objects.back().header.frame_id = "table";
+  EXPECT_NE(hashPlanningSceneWorld(with_far_object, 0.01, "world", center, 1.0), hash);
+
+  // Shapes reaching into the region are kept.
+  PlanningSceneWorld with_large_object = world;
+  with_large_object.collision_objects.push_back(makeBox("large", 2.0));
+  with_large_object.collision_objects.back().primitives[0].dimensions = { 2.5, 0.1, 0.1 };
+  EXPECT_NE(hashPlanningSceneWorld(with_large_object, 0.01, "world", center, 1.0), hash);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
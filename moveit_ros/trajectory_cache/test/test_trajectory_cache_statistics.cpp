@@ -0,0 +1,92 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Tests for the trajectory cache statistics.
+ */
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <moveit/trajectory_cache/trajectory_cache_statistics.hpp>
+
+namespace
+{
+
+using ::diagnostic_msgs::msg::DiagnosticArray;
+using ::diagnostic_msgs::msg::DiagnosticStatus;
+
+using ::moveit_ros::trajectory_cache::CacheNamespaceStatistics;
+using ::moveit_ros::trajectory_cache::LatencyHistogram;
+using ::moveit_ros::trajectory_cache::toDiagnosticArray;
+using ::moveit_ros::trajectory_cache::TrajectoryCacheStatistics;
+
+std::string lookup(const DiagnosticStatus& status, const std::string& key)
+{
+  auto it = std::find_if(status.values.begin(), status.values.end(),
+                         [&key](const auto& key_value) { return key_value.key == key; });
+  return it == status.values.end() ? "<missing>" : it->value;
+}
+
+TEST(LatencyHistogram, RecordsIntoBuckets)
+{
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.mean(), 0.0);
+
+  histogram.record(5e-5);
+  histogram.record(1e-3);  // Upper bounds are inclusive.
+  histogram.record(0.5);
+  histogram.record(20.0);
+
+  EXPECT_EQ(histogram.count, 4u);
+  EXPECT_EQ(histogram.bucket_counts[0], 1u);
+  EXPECT_EQ(histogram.bucket_counts[1], 1u);
+  EXPECT_EQ(histogram.bucket_counts[4], 1u);
+  EXPECT_EQ(histogram.bucket_counts.back(), 1u);
+  EXPECT_DOUBLE_EQ(histogram.max_s, 20.0);
+  EXPECT_DOUBLE_EQ(histogram.mean(), (5e-5 + 1e-3 + 0.5 + 20.0) / 4);
+}
+
+TEST(TrajectoryCacheStatistics, ConvertsToDiagnostics)
+{
+  TrajectoryCacheStatistics statistics;
+  CacheNamespaceStatistics& stats = statistics["move_group_trajectory_cache@panda"];
+  stats.fetches = 4;
+  stats.hits = 3;
+  stats.misses = 1;
+  stats.fetch_latency.record(2e-3);
+  stats.features["StartStateJointStateFeatures"].fetches = 4;
+  stats.features["StartStateJointStateFeatures"].misses = 1;
+
+  const DiagnosticArray array = toDiagnosticArray(statistics);
+  ASSERT_EQ(array.status.size(), 1u);
+  const DiagnosticStatus& status = array.status[0];
+  EXPECT_EQ(status.hardware_id, "move_group_trajectory_cache@panda");
+  EXPECT_EQ(status.message, "hit rate 75.0% of 4 fetches");
+  EXPECT_EQ(lookup(status, "hits"), "3");
+  EXPECT_EQ(lookup(status, "fetch_latency.count"), "1");
+  EXPECT_EQ(lookup(status, "fetch_latency.le_0.01"), "1");
+  EXPECT_EQ(lookup(status, "fetch_latency.le_inf"), "0");
+  EXPECT_EQ(lookup(status, "feature.StartStateJointStateFeatures.misses"), "1");
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+// Copyright 2026 MoveIt maintainers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/** @file
+ * @brief Tests for the in-memory evaluation of cache feature queries.
+ */
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <rclcpp/version.h>
+
+#include <geometry_msgs/msg/point.hpp>
+#include <moveit/trajectory_cache/utils/feature_query.hpp>
+
+#include "../fixtures/warehouse_fixture.hpp"
+
+namespace
+{
+
+using ::warehouse_ros::MessageCollection;
+using ::warehouse_ros::MessageWithMetadata;
+using ::warehouse_ros::Metadata;
+using ::warehouse_ros::Query;
+
+using ::moveit_ros::trajectory_cache::FeatureQuery;
+
+// Count the entries matching a feature query in memory.
+size_t countMatches(const std::vector<MessageWithMetadata<geometry_msgs::msg::Point>::ConstPtr>& entries,
+                    const FeatureQuery& query)
+{
+  size_t count = 0;
+  for (const auto& entry : entries)
+  {
+    if (query.matches(*entry))
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// Same exclusion as the warehouse query tests of test_utils.
+#if RCLCPP_VERSION_GTE(28, 3, 3)
+TEST_F(WarehouseFixture, FeatureQueryMatchesLikeDatabaseQuery)
+{
+  MessageCollection<geometry_msgs::msg::Point> coll =
+      db_->openCollection<geometry_msgs::msg::Point>("test_db", "test_collection");
+
+  for (int i = 0; i < 5; ++i)
+  {
+    Metadata::Ptr metadata = coll.createMetadata();
+    metadata->append("value", static_cast<double>(i));
+    metadata->append("name", i % 2 == 0 ? std::string("even") : std::string("odd"));
+    coll.insert(geometry_msgs::msg::Point(), metadata);
+  }
+  const std::vector<MessageWithMetadata<geometry_msgs::msg::Point>::ConstPtr> entries =
+      coll.queryList(coll.createQuery(), /*metadata_only=*/true);
+  ASSERT_EQ(entries.size(), 5);
+
+  // Apply the same constraints to a database query and to a feature query.
+  const auto expect_same_matches = [&](const std::function<void(Query&)>& append) {
+    Query::Ptr db_query = coll.createQuery();
+    append(*db_query);
+    FeatureQuery feature_query;
+    append(feature_query);
+    EXPECT_EQ(countMatches(entries, feature_query), coll.queryList(db_query, /*metadata_only=*/true).size());
+  };
+
+  expect_same_matches([](Query& query) { query.appendRangeInclusive("value", 1.0, 3.0); });
+  expect_same_matches([](Query& query) { query.appendRange("value", 1.0, 3.0); });
+  expect_same_matches([](Query& query) { query.appendLT("value", 2.0); });
+  expect_same_matches([](Query& query) { query.appendLTE("value", 2.0); });
+  expect_same_matches([](Query& query) { query.appendGT("value", 2.0); });
+  expect_same_matches([](Query& query) { query.appendGTE("value", 2.0); });
+  expect_same_matches([](Query& query) { query.append("value", 4.0); });
+  expect_same_matches([](Query& query) { query.append("name", std::string("even")); });
+  expect_same_matches([](Query& query) {
+    query.append("name", std::string("odd"));
+    query.appendGTE("value", 2.0);
+  });
+}
+#endif
+
+TEST_F(WarehouseFixture, FeatureQueryRejectsMissingFields)
+{
+  MessageCollection<geometry_msgs::msg::Point> coll =
+      db_->openCollection<geometry_msgs::msg::Point>("test_db", "test_collection");
+
+  Metadata::Ptr metadata = coll.createMetadata();
+  metadata->append("value", 5.0);
+  coll.insert(geometry_msgs::msg::Point(), metadata);
+  const std::vector<MessageWithMetadata<geometry_msgs::msg::Point>::ConstPtr> entries =
+      coll.queryList(coll.createQuery(), /*metadata_only=*/true);
+  ASSERT_EQ(entries.size(), 1);
+
+  FeatureQuery empty_query;
+  EXPECT_EQ(empty_query.size(), 0);
+  EXPECT_EQ(countMatches(entries, empty_query), 1);
+
+  FeatureQuery unrelated_query;
+  unrelated_query.appendRangeInclusive("unrelated_metadata", 0.0, 10.0);
+  EXPECT_EQ(unrelated_query.size(), 1);
+  EXPECT_EQ(countMatches(entries, unrelated_query), 0);
+
+  FeatureQuery related_query;
+  related_query.appendRangeInclusive("value", 4.5, 5.5);
+  EXPECT_EQ(countMatches(entries, related_query), 1);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  rclcpp::init(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -61,6 +61,7 @@ class Property;
 class StringProperty;
 class BoolProperty;
 class FloatProperty;
+class IntProperty;
 class RosTopicProperty;
 class ColorProperty;
 class EnumProperty;
@@ -218,6 +219,7 @@ protected:
   rviz_common::properties::FloatProperty* scene_display_time_property_;
   rviz_common::properties::EnumProperty* octree_render_property_;
   rviz_common::properties::EnumProperty* octree_coloring_property_;
+  rviz_common::properties::IntProperty* octree_depth_property_;
 
   // rclcpp node
   rclcpp::Node::SharedPtr node_;
@@ -47,6 +47,7 @@
 #include <rviz_common/properties/property.hpp>
 #include <rviz_common/properties/bool_property.hpp>
 #include <rviz_common/properties/float_property.hpp>
+#include <rviz_common/properties/int_property.hpp>
 #include <rviz_common/properties/color_property.hpp>
 #include <rviz_common/properties/enum_property.hpp>
 #include <rviz_common/display_context.hpp>
@@ -127,6 +128,13 @@ PlanningSceneDisplay::PlanningSceneDisplay(bool listen_to_planning_scene, bool s
   octree_coloring_property_->addOption("Z-Axis", OCTOMAP_Z_AXIS_COLOR);
   octree_coloring_property_->addOption("Cell Probability", OCTOMAP_PROBABLILTY_COLOR);
 
+  octree_depth_property_ = new rviz_common::properties::IntProperty(
+      "Voxel Render Depth", 0,
+      "Maximum octree depth of the rendered voxels, coarser voxels render faster (0 for full depth)", scene_category_,
+      SLOT(changedOctreeRenderMode()), this);
+  octree_depth_property_->setMin(0);
+  octree_depth_property_->setMax(16);
+
   scene_display_time_property_ =
       new rviz_common::properties::FloatProperty("Scene Display Time", 0.01f,
                                                  "The amount of wall-time to wait in between rendering "
@@ -369,7 +377,7 @@ void PlanningSceneDisplay::renderPlanningScene()
       planning_scene_render_->renderPlanningScene(
           ps, env_color, attached_color, static_cast<OctreeVoxelRenderMode>(octree_render_property_->getOptionInt()),
           static_cast<OctreeVoxelColorMode>(octree_coloring_property_->getOptionInt()),
-          scene_alpha_property_->getFloat());
+          scene_alpha_property_->getFloat(), octree_depth_property_->getInt());
     }
     else
     {
@@ -425,10 +433,12 @@ void PlanningSceneDisplay::changedSceneDisplayTime()
 
 void PlanningSceneDisplay::changedOctreeRenderMode()
 {
+  queueRenderSceneGeometry();
 }
 
 void PlanningSceneDisplay::changedOctreeColorMode()
 {
+  queueRenderSceneGeometry();
 }
 
 void PlanningSceneDisplay::changedSceneRobotVisualEnabled()
@@ -41,6 +41,7 @@
 #include <moveit/rviz_plugin_render_tools/render_shapes.hpp>
 #include <rviz_common/properties/color_property.hpp>
 #include <OgreMaterial.h>
+#include <map>
 
 namespace moveit_rviz_plugin
 {
@@ -67,16 +68,38 @@ public:
 
   void updateRobotPosition(const planning_scene::PlanningSceneConstPtr& scene);
 
+  /** \brief Render the robot and the world objects of \e scene.
+   *
+   * Only world objects that changed since the previous call are rendered again, objects that merely moved are
+   * repositioned. \e max_octree_depth limits the depth of rendered octree voxels, 0 renders the full depth. */
   void renderPlanningScene(const planning_scene::PlanningSceneConstPtr& scene,
                            const Ogre::ColourValue& default_scene_color,
                            const Ogre::ColourValue& default_attached_color, OctreeVoxelRenderMode voxel_render_mode,
-                           OctreeVoxelColorMode voxel_color_mode, double default_scene_alpha);
+                           OctreeVoxelColorMode voxel_color_mode, double default_scene_alpha,
+                           std::size_t max_octree_depth = 0);
   void clear();
 
 private:
+  /** \brief The rendered shapes of a world object, relative to a scene node at the object pose */
+  struct ObjectRender
+  {
+    collision_detection::World::ObjectConstPtr object;
+    std::uint64_t octree_update_count = 0;
+    Ogre::ColourValue color;
+    double alpha = 0.0;
+    Ogre::SceneNode* node = nullptr;
+    RenderShapesPtr render_shapes;
+  };
+
+  void clearObjectRender(ObjectRender& render);
+
   Ogre::SceneNode* planning_scene_geometry_node_;
   rviz_common::DisplayContext* context_;
-  RenderShapesPtr render_shapes_;
   RobotStateVisualizationPtr scene_robot_;
+
+  std::map<std::string, ObjectRender> object_renders_;
+  OctreeVoxelRenderMode octree_voxel_rendering_;
+  OctreeVoxelColorMode octree_color_mode_;
+  std::size_t max_octree_depth_;
 };
 }  // namespace moveit_rviz_plugin
@@ -59,7 +59,7 @@ public:
 
   void renderShape(Ogre::SceneNode* node, const shapes::Shape* s, const Eigen::Isometry3d& p,
                    OctreeVoxelRenderMode octree_voxel_rendering, OctreeVoxelColorMode octree_color_mode,
-                   const Ogre::ColourValue& color, double alpha);
+                   const Ogre::ColourValue& color, double alpha, std::size_t max_octree_depth = 0);
   void updateShapeColors(double r, double g, double b, double a);
   void clear();
 
@@ -136,6 +136,11 @@ protected:
   double getStateDisplayTime();
   void clearTrajectoryTrail();
 
+  /**
+   * \brief get an upper bound of the distance that any point of the robot geometry moves between two states
+   */
+  double getMaxLinkMotion(const moveit::core::RobotState& from, const moveit::core::RobotState& to) const;
+
   // Handles actually drawing the robot along motion plans
   RobotStateVisualizationPtr display_path_robot_;
   std_msgs::msg::ColorRGBA default_attached_object_color_;
@@ -147,6 +152,8 @@ protected:
   robot_trajectory::RobotTrajectoryPtr displaying_trajectory_message_;
   robot_trajectory::RobotTrajectoryPtr trajectory_message_to_display_;
   std::vector<RobotStateVisualizationUniquePtr> trajectory_trail_;
+  std::vector<int> trajectory_trail_waypoints_;                    // waypoint shown by each robot of the trail
+  std::vector<RobotStateVisualizationUniquePtr> trail_robot_pool_;  // hidden trail robots, kept for reuse
   rclcpp::Subscription<moveit_msgs::msg::DisplayTrajectory>::SharedPtr trajectory_topic_sub_;
   bool animating_path_;
   bool drop_displaying_trajectory_;
@@ -180,6 +187,7 @@ protected:
   rviz_common::properties::ColorProperty* robot_color_property_;
   rviz_common::properties::BoolProperty* enable_robot_color_property_;
   rviz_common::properties::IntProperty* trail_step_size_property_;
+  rviz_common::properties::FloatProperty* trail_min_link_motion_property_;
 };
 
 }  // namespace moveit_rviz_plugin
@@ -37,22 +37,54 @@
 #include <moveit/rviz_plugin_render_tools/planning_scene_render.hpp>
 #include <moveit/rviz_plugin_render_tools/robot_state_visualization.hpp>
 #include <moveit/rviz_plugin_render_tools/render_shapes.hpp>
+#include <moveit/collision_detection/occupancy_map.hpp>
 #include <rviz_common/display_context.hpp>
+#include <algorithm>
 
 #include <OgreSceneNode.h>
 #include <OgreSceneManager.h>
 
 namespace moveit_rviz_plugin
 {
+namespace
+{
+// octrees filled by an occupancy map monitor in the same process are updated in place, without a new shape
+std::uint64_t getOctreeUpdateCount(const collision_detection::World::Object& object)
+{
+  std::uint64_t count = 0;
+  for (const shapes::ShapeConstPtr& shape : object.shapes_)
+  {
+    if (shape->type != shapes::OCTREE)
+      continue;
+    const octomap::OcTree* octree = static_cast<const shapes::OcTree&>(*shape).octree.get();
+    if (const auto* tree = dynamic_cast<const collision_detection::OccMapTree*>(octree))
+      count += tree->getUpdateCount();
+  }
+  return count;
+}
+
+bool sameShapes(const collision_detection::World::Object& a, const collision_detection::World::Object& b)
+{
+  return a.shapes_ == b.shapes_ && a.shape_poses_.size() == b.shape_poses_.size() &&
+         std::equal(a.shape_poses_.begin(), a.shape_poses_.end(), b.shape_poses_.begin(),
+                    [](const Eigen::Isometry3d& p, const Eigen::Isometry3d& q) { return p.matrix() == q.matrix(); });
+}
+}  // namespace
+
 PlanningSceneRender::PlanningSceneRender(Ogre::SceneNode* node, rviz_common::DisplayContext* context,
                                          const RobotStateVisualizationPtr& robot)
-  : planning_scene_geometry_node_(node->createChildSceneNode()), context_(context), scene_robot_(robot)
+  : planning_scene_geometry_node_(node->createChildSceneNode())
+  , context_(context)
+  , scene_robot_(robot)
+  , octree_voxel_rendering_(OCTOMAP_OCCUPIED_VOXELS)
+  , octree_color_mode_(OCTOMAP_Z_AXIS_COLOR)
+  , max_octree_depth_(0)
 {
-  render_shapes_ = std::make_shared<RenderShapes>(context);
 }
 
 PlanningSceneRender::~PlanningSceneRender()
 {
+  clear();
   context_->getSceneManager()->destroySceneNode(planning_scene_geometry_node_);
 }
 
@@ -68,19 +100,37 @@ void PlanningSceneRender::updateRobotPosition(const planning_scene::PlanningScen
 
 void PlanningSceneRender::clear()
 {
-  render_shapes_->clear();
+  for (auto& [id, render] : object_renders_)
+    clearObjectRender(render);
+  object_renders_.clear();
+}
+
+void PlanningSceneRender::clearObjectRender(ObjectRender& render)
+{
+  // the shapes detach from the node when they are destroyed
+  render.render_shapes->clear();
+  context_->getSceneManager()->destroySceneNode(render.node);
+  render.node = nullptr;
 }
 
 void PlanningSceneRender::renderPlanningScene(const planning_scene::PlanningSceneConstPtr& scene,
                                               const Ogre::ColourValue& default_env_color,
                                               const Ogre::ColourValue& default_attached_color,
                                               OctreeVoxelRenderMode octree_voxel_rendering,
-                                              OctreeVoxelColorMode octree_color_mode, double default_scene_alpha)
+                                              OctreeVoxelColorMode octree_color_mode, double default_scene_alpha,
+                                              std::size_t max_octree_depth)
 {
   if (!scene)
     return;
 
-  clear();
+  if (octree_voxel_rendering != octree_voxel_rendering_ || octree_color_mode != octree_color_mode_ ||
+      max_octree_depth != max_octree_depth_)
+  {
+    clear();
+    octree_voxel_rendering_ = octree_voxel_rendering;
+    octree_color_mode_ = octree_color_mode;
+    max_octree_depth_ = max_octree_depth;
+  }
 
   if (scene_robot_)
   {
@@ -97,10 +147,20 @@ void PlanningSceneRender::renderPlanningScene(const planning_scene::PlanningScen
     scene_robot_->update(moveit::core::RobotStateConstPtr(rs), color, color_map);
   }
 
-  const std::vector<std::string>& ids = scene->getWorld()->getObjectIds();
-  for (const std::string& id : ids)
+  const collision_detection::WorldConstPtr& world = scene->getWorld();
+  for (auto it = object_renders_.begin(); it != object_renders_.end();)
+  {
+    if (world->hasObject(it->first))
+    {
+      ++it;
+      continue;
+    }
+    clearObjectRender(it->second);
+    it = object_renders_.erase(it);
+  }
+
+  for (const auto& [id, object] : *world)
   {
-    collision_detection::CollisionEnv::ObjectConstPtr object = scene->getWorld()->getObject(id);
     Ogre::ColourValue color = default_env_color;
     double alpha = default_scene_alpha;
     if (scene->hasObjectColor(id))
@@ -112,12 +172,39 @@ void PlanningSceneRender::renderPlanningScene(const planning_scene::PlanningScen
       color.a = c.a;
       alpha = c.a;
     }
-    for (std::size_t j = 0; j < object->shapes_.size(); ++j)
+
+    // world objects are copied on write, so an unchanged pointer means an unchanged object
+    ObjectRender& render = object_renders_[id];
+    const std::uint64_t octree_update_count = getOctreeUpdateCount(*object);
+    const bool same_look = render.object && render.color == color && render.alpha == alpha &&
+                           render.octree_update_count == octree_update_count;
+    if (same_look && render.object == object)
+      continue;
+
+    if (!render.node)
+    {
+      render.node = planning_scene_geometry_node_->createChildSceneNode();
+      render.render_shapes = std::make_shared<RenderShapes>(context_);
+    }
+    if (!same_look || !sameShapes(*render.object, *object))
     {
-      render_shapes_->renderShape(planning_scene_geometry_node_, object->shapes_[j].get(),
-                                  object->global_shape_poses_[j], octree_voxel_rendering, octree_color_mode, color,
-                                  alpha);
+      render.render_shapes->clear();
+      for (std::size_t j = 0; j < object->shapes_.size(); ++j)
+      {
+        render.render_shapes->renderShape(render.node, object->shapes_[j].get(), object->shape_poses_[j],
+                                          octree_voxel_rendering, octree_color_mode, color, alpha, max_octree_depth);
+      }
     }
+
+    const Eigen::Vector3d& position = object->pose_.translation();
+    const Eigen::Quaterniond orientation(object->pose_.linear());
+    render.node->setPosition(Ogre::Vector3(position.x(), position.y(), position.z()));
+    render.node->setOrientation(Ogre::Quaternion(orientation.w(), orientation.x(), orientation.y(), orientation.z()));
+
+    render.object = object;
+    render.octree_update_count = octree_update_count;
+    render.color = color;
+    render.alpha = alpha;
   }
 }
 }  // namespace moveit_rviz_plugin
@@ -71,7 +71,7 @@ void RenderShapes::clear()
 
 void RenderShapes::renderShape(Ogre::SceneNode* node, const shapes::Shape* s, const Eigen::Isometry3d& p,
                                OctreeVoxelRenderMode octree_voxel_rendering, OctreeVoxelColorMode octree_color_mode,
-                               const Ogre::ColourValue& color, double alpha)
+                               const Ogre::ColourValue& color, double alpha, std::size_t max_octree_depth)
 {
   rviz_rendering::Shape* ogre_shape = nullptr;
   Eigen::Vector3d translation = p.translation();
@@ -85,7 +85,7 @@ void RenderShapes::renderShape(Ogre::SceneNode* node, const shapes::Shape* s, co
   {
     std::unique_ptr<shapes::Mesh> m(shapes::createMeshFromShape(static_cast<const shapes::Cone&>(*s)));
     if (m)
-      renderShape(node, m.get(), p, octree_voxel_rendering, octree_color_mode, color, alpha);
+      renderShape(node, m.get(), p, octree_voxel_rendering, octree_color_mode, color, alpha, max_octree_depth);
     return;
   }
 
@@ -162,7 +162,8 @@ void RenderShapes::renderShape(Ogre::SceneNode* node, const shapes::Shape* s, co
       if (octree_voxel_rendering != OCTOMAP_DISABLED)
       {
         auto octree = std::make_shared<moveit_rviz_plugin::OcTreeRender>(
-            static_cast<const shapes::OcTree*>(s)->octree, octree_voxel_rendering, octree_color_mode, 0u, node);
+            static_cast<const shapes::OcTree*>(s)->octree, octree_voxel_rendering, octree_color_mode, max_octree_depth,
+            node);
         octree->setPosition(position);
         octree->setOrientation(orientation);
         octree_voxel_grids_.push_back(octree);
@@ -127,6 +127,13 @@ TrajectoryVisualization::TrajectoryVisualization(rviz_common::properties::Proper
                                                                        widget, SLOT(changedTrailStepSize()), this);
   trail_step_size_property_->setMin(1);
 
+  trail_min_link_motion_property_ = new rviz_common::properties::FloatProperty(
+      "Trail Min Link Motion", 0.0f,
+      "Skip trail samples until a link moved at least this distance (m) relative to the previous trail robot. "
+      "Zero shows every sample.",
+      widget, SLOT(changedTrailStepSize()), this);
+  trail_min_link_motion_property_->setMin(0.0);
+
   interrupt_display_property_ = new rviz_common::properties::BoolProperty(
       "Interrupt Display", false,
       "Immediately show newly planned trajectory, interrupting the currently displayed one.", widget);
@@ -141,6 +148,7 @@ TrajectoryVisualization::TrajectoryVisualization(rviz_common::properties::Proper
 TrajectoryVisualization::~TrajectoryVisualization()
 {
   clearTrajectoryTrail();
+  trail_robot_pool_.clear();
   trajectory_message_to_display_.reset();
   displaying_trajectory_message_.reset();
 
@@ -211,6 +219,8 @@ void TrajectoryVisualization::onRobotModelLoaded(const moveit::core::RobotModelC
 
   // Load rviz robot
   display_path_robot_->load(*robot_model_->getURDF());
+  clearTrajectoryTrail();
+  trail_robot_pool_.clear();  // loaded with the previous model
   enabledRobotColor();  // force-refresh to account for saved display configuration
   // perform post-poned subscription to trajectory topic
   // Check if topic name is empty
@@ -232,7 +242,14 @@ void TrajectoryVisualization::reset()
 
 void TrajectoryVisualization::clearTrajectoryTrail()
 {
+  // loading the meshes of a robot is expensive, so the robots are hidden and reused by the next trail
+  for (RobotStateVisualizationUniquePtr& r : trajectory_trail_)
+  {
+    r->setVisible(false);
+    trail_robot_pool_.push_back(std::move(r));
+  }
   trajectory_trail_.clear();
+  trajectory_trail_waypoints_.clear();
 }
 
 void TrajectoryVisualization::changedLoopDisplay()
@@ -254,27 +271,66 @@ void TrajectoryVisualization::changedShowTrail()
   if (!t)
     return;
 
-  int stepsize = trail_step_size_property_->getInt();
-  // always include last trajectory point
-  trajectory_trail_.resize(
-      static_cast<int>(std::ceil((t->getWayPointCount() + stepsize - 1) / static_cast<float>(stepsize))));
+  // sample every step size-th waypoint and always include the last trajectory point, skipping samples that would
+  // hardly differ from the previous trail robot
+  const int stepsize = trail_step_size_property_->getInt();
+  const double min_link_motion = trail_min_link_motion_property_->getFloat();
+  const int waypoint_count = t->getWayPointCount();
+  for (int waypoint_i = 0; waypoint_i < waypoint_count; waypoint_i += stepsize)
+  {
+    if (trajectory_trail_waypoints_.empty() || min_link_motion <= 0.0 ||
+        getMaxLinkMotion(t->getWayPoint(trajectory_trail_waypoints_.back()), t->getWayPoint(waypoint_i)) >=
+            min_link_motion)
+      trajectory_trail_waypoints_.push_back(waypoint_i);
+  }
+  if (trajectory_trail_waypoints_.back() != waypoint_count - 1)
+    trajectory_trail_waypoints_.push_back(waypoint_count - 1);
+
+  trajectory_trail_.resize(trajectory_trail_waypoints_.size());
   for (std::size_t i = 0; i < trajectory_trail_.size(); ++i)
   {
-    int waypoint_i = std::min(i * stepsize, t->getWayPointCount() - 1);  // limit to last trajectory point
-    auto r =
-        std::make_unique<RobotStateVisualization>(scene_node_, context_, "Trail Robot " + std::to_string(i), nullptr);
-    r->load(*robot_model_->getURDF());
+    const int waypoint_i = trajectory_trail_waypoints_[i];
+    RobotStateVisualizationUniquePtr r;
+    if (!trail_robot_pool_.empty())
+    {
+      r = std::move(trail_robot_pool_.back());
+      trail_robot_pool_.pop_back();
+    }
+    else
+    {
+      // the robots taken from the pool were created for lower indices, so the name is unique
+      r = std::make_unique<RobotStateVisualization>(scene_node_, context_, "Trail Robot " + std::to_string(i), nullptr);
+      r->load(*robot_model_->getURDF());
+    }
     r->setVisualVisible(display_path_visual_enabled_property_->getBool());
     r->setCollisionVisible(display_path_collision_enabled_property_->getBool());
     r->setAlpha(robot_path_alpha_property_->getFloat());
     r->update(t->getWayPointPtr(waypoint_i), default_attached_object_color_);
     if (enable_robot_color_property_->getBool())
       setRobotColor(&(r->getRobot()), robot_color_property_->getColor());
+    else
+      unsetRobotColor(&(r->getRobot()));
     r->setVisible(display_->isEnabled() && (!animating_path_ || waypoint_i <= current_state_));
     trajectory_trail_[i] = std::move(r);
   }
 }
 
+double TrajectoryVisualization::getMaxLinkMotion(const moveit::core::RobotState& from,
+                                                 const moveit::core::RobotState& to) const
+{
+  // bound the motion of the geometry of each link by the motion of its origin and its rotation times its extent
+  double max_motion = 0.0;
+  for (const moveit::core::LinkModel* link : robot_model_->getLinkModelsWithCollisionGeometry())
+  {
+    const Eigen::Isometry3d& from_pose = from.getGlobalLinkTransform(link);
+    const Eigen::Isometry3d& to_pose = to.getGlobalLinkTransform(link);
+    const double rotation = Eigen::AngleAxisd(from_pose.linear().transpose() * to_pose.linear()).angle();
+    max_motion = std::max(max_motion, (to_pose.translation() - from_pose.translation()).norm() +
+                                          rotation * 0.5 * link->getShapeExtentsAtOrigin().norm());
+  }
+  return max_motion;
+}
+
 void TrajectoryVisualization::changedTrailStepSize()
 {
   if (trail_display_property_->getBool())
@@ -498,10 +554,8 @@ void TrajectoryVisualization::update(double wall_dt, double sim_dt)
              (tm = displaying_trajectory_message_->getWayPointDurationFromPrevious(current_state_ + 1) / rt_factor) <
                  current_state_time_)
       {
+        // skipped waypoints are not rendered, the robot is updated to the last one below
         current_state_time_ -= tm;
-        // if we are stuck in the while loop we should move the robot along the path to keep up
-        if (tm < current_state_time_)
-          display_path_robot_->update(displaying_trajectory_message_->getWayPointPtr(current_state_));
         ++current_state_;
       }
     }
@@ -520,10 +574,7 @@ void TrajectoryVisualization::update(double wall_dt, double sim_dt)
         trajectory_slider_panel_->setSliderPosition(current_state_);
       display_path_robot_->update(displaying_trajectory_message_->getWayPointPtr(current_state_));
       for (std::size_t i = 0; i < trajectory_trail_.size(); ++i)
-      {
-        trajectory_trail_[i]->setVisible(
-            std::min(waypoint_count - 1, static_cast<int>(i) * trail_step_size_property_->getInt()) <= current_state_);
-      }
+        trajectory_trail_[i]->setVisible(trajectory_trail_waypoints_[i] <= current_state_);
     }
     else
     {
@@ -578,6 +629,10 @@ void TrajectoryVisualization::incomingDisplayTrajectory(const moveit_msgs::msg::
         t->append(tmp, 0.0);
       }
     }
+    // compute the link transforms of all waypoints on this executor thread, rather than when the render thread
+    // animates the trajectory or builds its trail
+    for (std::size_t i = 0; i < t->getWayPointCount(); ++i)
+      t->getWayPointPtr(i)->update();
     display_->setStatus(rviz_common::properties::StatusProperty::Ok, "Trajectory", "");
   }
   catch (const moveit::Exception& e)
@@ -64,6 +64,10 @@ public:
 
   void addConstraints(const moveit_msgs::msg::Constraints& msg, const std::string& robot = "",
                       const std::string& group = "");
+  /** \brief Add all \e msgs, replacing existing constraints of the same name. The existing names are looked up once
+   * for the whole batch instead of once per message. */
+  void addConstraints(const std::vector<moveit_msgs::msg::Constraints>& msgs, const std::string& robot = "",
+                      const std::string& group = "");
   bool hasConstraints(const std::string& name, const std::string& robot = "", const std::string& group = "") const;
   void getKnownConstraints(std::vector<std::string>& names, const std::string& robot = "",
                            const std::string& group = "") const;
@@ -74,6 +78,12 @@ public:
   bool getConstraints(ConstraintsWithMetadata& msg_m, const std::string& name, const std::string& robot = "",
                       const std::string& group = "") const;
 
+  /** \brief Get all constraints whose name matches \e regex (all constraints if empty) with a single query, sorted by
+   * name. \e names receives the name of each message. */
+  void getConstraints(const std::string& regex, std::vector<ConstraintsWithMetadata>& msgs,
+                      std::vector<std::string>& names, const std::string& robot = "",
+                      const std::string& group = "") const;
+
   void renameConstraints(const std::string& old_name, const std::string& new_name, const std::string& robot = "",
                          const std::string& group = "");
 
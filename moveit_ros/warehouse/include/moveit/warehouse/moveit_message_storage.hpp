@@ -37,8 +37,13 @@
 #pragma once
 
 #include <warehouse_ros/database_connection.h>
+#include <warehouse_ros/database_loader.h>
+#include <map>
+#include <mutex>
+#include <regex>
 #include <vector>
 #include <string>
+#include <utility>
 
 namespace moveit_warehouse
 {
@@ -59,9 +64,51 @@ protected:
   /// Keep only the \e names that match \e regex
   void filterNames(const std::string& regex, std::vector<std::string>& names) const;
 
+  /// Keep only the \e messages whose entry in \e names matches \e regex
+  template <typename MessageT>
+  void filterMessages(const std::string& regex, std::vector<MessageT>& messages, std::vector<std::string>& names) const
+  {
+    if (regex.empty())
+      return;
+    std::regex r(regex);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+      if (std::regex_match(names[i], r))
+      {
+        messages[kept] = std::move(messages[i]);
+        names[kept] = std::move(names[i]);
+        ++kept;
+      }
+    }
+    messages.resize(kept);
+    names.resize(kept);
+  }
+
   warehouse_ros::DatabaseConnection::Ptr conn_;
 };
 
 /// \brief Load a database connection
 typename warehouse_ros::DatabaseConnection::Ptr loadDatabase(const rclcpp::Node::SharedPtr& node);
+
+/** \brief Keeps connected database connections, so that loading data from the same database several times (e.g. for
+ * every scene of a benchmark) reuses the open connection instead of connecting again. Connections are shared by host
+ * and port; like any warehouse_ros connection, a pooled connection must only be used by one thread at a time. */
+class DatabaseConnectionPool
+{
+public:
+  DatabaseConnectionPool(const rclcpp::Node::SharedPtr& node);
+
+  /** \brief Get a connected connection to the database at \e host and \e port, reusing the pooled one if it is still
+   * connected. Return nullptr if connecting fails. */
+  warehouse_ros::DatabaseConnection::Ptr getConnection(const std::string& host, unsigned port, float timeout = 60.0);
+
+  /// \brief Drop all pooled connections
+  void clear();
+
+private:
+  warehouse_ros::DatabaseLoader db_loader_;
+  std::mutex mutex_;
+  std::map<std::pair<std::string, unsigned>, warehouse_ros::DatabaseConnection::Ptr> connections_;
+};
 }  // namespace moveit_warehouse
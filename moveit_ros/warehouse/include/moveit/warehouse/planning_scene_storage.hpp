@@ -70,6 +70,11 @@ public:
   void addPlanningScene(const moveit_msgs::msg::PlanningScene& scene);
   void addPlanningQuery(const moveit_msgs::msg::MotionPlanRequest& planning_query, const std::string& scene_name,
                         const std::string& query_name = "");
+  /** \brief Add several planning queries to the scene \e scene_name, as addPlanningQuery() does for each of them. The
+   * stored queries of the scene are fetched once for the whole batch instead of once per query. \e query_names is
+   * either empty (generate all names) or has one name per query. */
+  void addPlanningQueries(const std::vector<moveit_msgs::msg::MotionPlanRequest>& planning_queries,
+                          const std::string& scene_name, const std::vector<std::string>& query_names = {});
   void addPlanningResult(const moveit_msgs::msg::MotionPlanRequest& planning_query,
                          const moveit_msgs::msg::RobotTrajectory& result, const std::string& scene_name);
 
@@ -91,6 +96,10 @@ public:
                                const std::string& scene_name) const;
   void getPlanningQueries(std::vector<MotionPlanRequestWithMetadata>& planning_queries,
                           std::vector<std::string>& query_names, const std::string& scene_name) const;
+  /** \brief Get the queries of \e scene_name whose name matches \e regex (all queries if empty) with a single
+   * query to the database */
+  void getPlanningQueries(const std::string& regex, std::vector<MotionPlanRequestWithMetadata>& planning_queries,
+                          std::vector<std::string>& query_names, const std::string& scene_name) const;
 
   void getPlanningResults(std::vector<RobotTrajectoryWithMetadata>& planning_results, const std::string& scene_name,
                           const moveit_msgs::msg::MotionPlanRequest& planning_query) const;
@@ -61,6 +61,10 @@ public:
   RobotStateStorage(warehouse_ros::DatabaseConnection::Ptr conn);
 
   void addRobotState(const moveit_msgs::msg::RobotState& msg, const std::string& name, const std::string& robot = "");
+  /** \brief Add all \e msgs with the corresponding \e names, replacing existing states of the same name. The existing
+   * names are looked up once for the whole batch instead of once per state. */
+  void addRobotStates(const std::vector<moveit_msgs::msg::RobotState>& msgs, const std::vector<std::string>& names,
+                      const std::string& robot = "");
   bool hasRobotState(const std::string& name, const std::string& robot = "") const;
   void getKnownRobotStates(std::vector<std::string>& names, const std::string& robot = "") const;
   void getKnownRobotStates(const std::string& regex, std::vector<std::string>& names,
@@ -69,6 +73,11 @@ public:
   /** \brief Get the constraints named \e name. Return false on failure. */
   bool getRobotState(RobotStateWithMetadata& msg_m, const std::string& name, const std::string& robot = "") const;
 
+  /** \brief Get all states whose name matches \e regex (all states if empty) with a single query, sorted by name.
+   * \e names receives the name of each state. */
+  void getRobotStates(const std::string& regex, std::vector<RobotStateWithMetadata>& msgs,
+                      std::vector<std::string>& names, const std::string& robot = "") const;
+
   void renameRobotState(const std::string& old_name, const std::string& new_name, const std::string& robot = "");
 
   void removeRobotState(const std::string& name, const std::string& robot = "");
@@ -0,0 +1,74 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <moveit_msgs/msg/robot_trajectory.hpp>
+
+namespace moveit_warehouse
+{
+/** \brief Options of the compact trajectory encoding */
+struct TrajectoryCodecOptions
+{
+  /** \brief Quantization step of positions, velocities, accelerations, efforts and multi-DOF transforms and twists */
+  double resolution = 1e-6;
+
+  /** \brief Compress the encoding with zstd, if MoveIt was built with zstd */
+  bool compress = true;
+};
+
+/** \brief Version of the schema written by encodeTrajectory() */
+constexpr uint8_t TRAJECTORY_CODEC_SCHEMA_VERSION = 1;
+
+/** \brief Whether encodeTrajectory() can compress, i.e. MoveIt was built with zstd */
+bool isTrajectoryCompressionAvailable();
+
+/** \brief Encode a trajectory compactly for storage in a database
+ *
+ * Joint and frame names are stored once, values are quantized to multiples of \e options.resolution and stored as
+ * variable length differences to the previous waypoint, and times are stored as differences in nanoseconds. The
+ * encoding starts with a schema version, so that stored trajectories can still be decoded by later versions.
+ * \return False if the trajectory can't be encoded, because it contains values that are not finite or compression
+ * failed */
+bool encodeTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory, std::vector<uint8_t>& data,
+                      const TrajectoryCodecOptions& options = TrajectoryCodecOptions());
+
+/** \brief Decode a trajectory encoded by encodeTrajectory()
+ * \return False if the data is corrupt, of an unknown schema version, or compressed while MoveIt was built without
+ * zstd */
+bool decodeTrajectory(const std::vector<uint8_t>& data, moveit_msgs::msg::RobotTrajectory& trajectory);
+}  // namespace moveit_warehouse
@@ -62,6 +62,11 @@ public:
 
   void addTrajectoryConstraints(const moveit_msgs::msg::TrajectoryConstraints& msg, const std::string& name,
                                 const std::string& robot = "", const std::string& group = "");
+  /** \brief Add all \e msgs with the corresponding \e names, replacing existing constraints of the same name. The
+   * existing names are looked up once for the whole batch instead of once per message. */
+  void addTrajectoryConstraints(const std::vector<moveit_msgs::msg::TrajectoryConstraints>& msgs,
+                                const std::vector<std::string>& names, const std::string& robot = "",
+                                const std::string& group = "");
   bool hasTrajectoryConstraints(const std::string& name, const std::string& robot = "",
                                 const std::string& group = "") const;
   void getKnownTrajectoryConstraints(std::vector<std::string>& names, const std::string& robot = "",
@@ -73,6 +78,12 @@ public:
   bool getTrajectoryConstraints(TrajectoryConstraintsWithMetadata& msg_m, const std::string& name,
                                 const std::string& robot = "", const std::string& group = "") const;
 
+  /** \brief Get all constraints whose name matches \e regex (all constraints if empty) with a single query, sorted by
+   * name. \e names receives the name of each message. */
+  void getTrajectoryConstraints(const std::string& regex, std::vector<TrajectoryConstraintsWithMetadata>& msgs,
+                                std::vector<std::string>& names, const std::string& robot = "",
+                                const std::string& group = "") const;
+
   void renameTrajectoryConstraints(const std::string& old_name, const std::string& new_name,
                                    const std::string& robot = "", const std::string& group = "");
 
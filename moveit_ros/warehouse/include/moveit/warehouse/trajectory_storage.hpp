@@ -0,0 +1,95 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#pragma once
+
+#include <moveit/warehouse/moveit_message_storage.hpp>
+#include <moveit/warehouse/trajectory_codec.hpp>
+#include <moveit/macros/class_forward.hpp>
+#include <moveit_msgs/msg/robot_trajectory.hpp>
+#include <std_msgs/msg/u_int8_multi_array.hpp>
+#include <rclcpp/logger.hpp>
+
+namespace moveit_warehouse
+{
+typedef warehouse_ros::MessageWithMetadata<std_msgs::msg::UInt8MultiArray>::ConstPtr EncodedTrajectoryWithMetadata;
+typedef warehouse_ros::MessageCollection<std_msgs::msg::UInt8MultiArray>::Ptr EncodedTrajectoryCollection;
+
+MOVEIT_CLASS_FORWARD(TrajectoryStorage);  // Defines TrajectoryStoragePtr, ConstPtr, WeakPtr... etc
+
+/** \brief Named storage of robot trajectories, in the compact encoding of encodeTrajectory() */
+class TrajectoryStorage : public MoveItMessageStorage
+{
+public:
+  static const std::string DATABASE_NAME;
+
+  static const std::string TRAJECTORY_ID_NAME;
+  static const std::string TRAJECTORY_GROUP_NAME;
+  static const std::string ROBOT_NAME;
+  static const std::string SCHEMA_VERSION_NAME;
+
+  TrajectoryStorage(warehouse_ros::DatabaseConnection::Ptr conn,
+                    const TrajectoryCodecOptions& codec_options = TrajectoryCodecOptions());
+
+  /** \brief Store the trajectory \e msg named \e name, replacing a stored one. Return false if it can't be encoded. */
+  bool addTrajectory(const moveit_msgs::msg::RobotTrajectory& msg, const std::string& name,
+                     const std::string& robot = "", const std::string& group = "");
+  bool hasTrajectory(const std::string& name, const std::string& robot = "", const std::string& group = "") const;
+  void getKnownTrajectories(std::vector<std::string>& names, const std::string& robot = "",
+                            const std::string& group = "") const;
+  void getKnownTrajectories(const std::string& regex, std::vector<std::string>& names, const std::string& robot = "",
+                            const std::string& group = "") const;
+
+  /** \brief Get the trajectory named \e name. Return false on failure, or if it can't be decoded. */
+  bool getTrajectory(moveit_msgs::msg::RobotTrajectory& msg, const std::string& name, const std::string& robot = "",
+                     const std::string& group = "") const;
+
+  void renameTrajectory(const std::string& old_name, const std::string& new_name, const std::string& robot = "",
+                        const std::string& group = "");
+
+  void removeTrajectory(const std::string& name, const std::string& robot = "", const std::string& group = "");
+
+  void reset();
+
+private:
+  void createCollections();
+
+  warehouse_ros::Query::Ptr createQuery(const std::string& name, const std::string& robot,
+                                        const std::string& group) const;
+
+  TrajectoryCodecOptions codec_options_;
+  EncodedTrajectoryCollection trajectory_collection_;
+  rclcpp::Logger logger_;
+};
+}  // namespace moveit_warehouse
@@ -37,6 +37,7 @@
 #include <moveit/warehouse/constraints_storage.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <set>
 #include <utility>
 
 const std::string moveit_warehouse::ConstraintsStorage::DATABASE_NAME = "moveit_constraints";
@@ -83,6 +84,26 @@ void moveit_warehouse::ConstraintsStorage::addConstraints(const moveit_msgs::msg
   RCLCPP_DEBUG(logger_, "%s constraints '%s'", replace ? "Replaced" : "Added", msg.name.c_str());
 }
 
+void moveit_warehouse::ConstraintsStorage::addConstraints(const std::vector<moveit_msgs::msg::Constraints>& msgs,
+                                                          const std::string& robot, const std::string& group)
+{
+  std::vector<std::string> known_names;
+  getKnownConstraints(known_names, robot, group);
+  std::set<std::string> known(known_names.begin(), known_names.end());
+  for (const moveit_msgs::msg::Constraints& msg : msgs)
+  {
+    if (known.count(msg.name))
+      removeConstraints(msg.name, robot, group);
+    Metadata::Ptr metadata = constraints_collection_->createMetadata();
+    metadata->append(CONSTRAINTS_ID_NAME, msg.name);
+    metadata->append(ROBOT_NAME, robot);
+    metadata->append(CONSTRAINTS_GROUP_NAME, group);
+    constraints_collection_->insert(msg, metadata);
+    known.insert(msg.name);
+  }
+  RCLCPP_DEBUG(logger_, "Added %zu constraints", msgs.size());
+}
+
 bool moveit_warehouse::ConstraintsStorage::hasConstraints(const std::string& name, const std::string& robot,
                                                           const std::string& group) const
 {
@@ -145,6 +166,28 @@ bool moveit_warehouse::ConstraintsStorage::getConstraints(ConstraintsWithMetadat
   }
 }
 
+void moveit_warehouse::ConstraintsStorage::getConstraints(const std::string& regex,
+                                                          std::vector<ConstraintsWithMetadata>& msgs,
+                                                          std::vector<std::string>& names, const std::string& robot,
+                                                          const std::string& group) const
+{
+  Query::Ptr q = constraints_collection_->createQuery();
+  if (!robot.empty())
+    q->append(ROBOT_NAME, robot);
+  if (!group.empty())
+    q->append(CONSTRAINTS_GROUP_NAME, group);
+  msgs = constraints_collection_->queryList(q, false, CONSTRAINTS_ID_NAME, true);
+  names.resize(msgs.size());
+  for (std::size_t i = 0; i < msgs.size(); ++i)
+  {
+    names[i] = msgs[i]->lookupField(CONSTRAINTS_ID_NAME) ? msgs[i]->lookupString(CONSTRAINTS_ID_NAME) : "";
+    // in case the constraints were renamed, the name in the message may be out of date
+    const_cast<moveit_msgs::msg::Constraints*>(static_cast<const moveit_msgs::msg::Constraints*>(msgs[i].get()))->name =
+        names[i];
+  }
+  filterMessages(regex, msgs, names);
+}
+
 void moveit_warehouse::ConstraintsStorage::renameConstraints(const std::string& old_name, const std::string& new_name,
                                                              const std::string& robot, const std::string& group)
 {
@@ -70,3 +70,34 @@ typename warehouse_ros::DatabaseConnection::Ptr moveit_warehouse::loadDatabase(c
   }
   return dbloader->loadDatabase();
 }
+
+moveit_warehouse::DatabaseConnectionPool::DatabaseConnectionPool(const rclcpp::Node::SharedPtr& node)
+  : db_loader_(node)
+{
+}
+
+typename warehouse_ros::DatabaseConnection::Ptr
+moveit_warehouse::DatabaseConnectionPool::getConnection(const std::string& host, unsigned port, float timeout)
+{
+  std::scoped_lock lock(mutex_);
+  const auto key = std::make_pair(host, port);
+  auto it = connections_.find(key);
+  if (it != connections_.end() && it->second->isConnected())
+    return it->second;
+
+  warehouse_ros::DatabaseConnection::Ptr conn = db_loader_.loadDatabase();
+  if (!conn || !conn->setParams(host, port, timeout) || !conn->connect())
+  {
+    if (it != connections_.end())
+      connections_.erase(it);
+    return nullptr;
+  }
+  connections_[key] = conn;
+  return conn;
+}
+
+void moveit_warehouse::DatabaseConnectionPool::clear()
+{
+  std::scoped_lock lock(mutex_);
+  connections_.clear();
+}
@@ -35,6 +35,8 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/warehouse/planning_scene_storage.hpp>
+#include <map>
+#include <set>
 #include <utility>
 #include <rclcpp/serialization.hpp>
 #include <regex>
@@ -147,6 +149,71 @@ void moveit_warehouse::PlanningSceneStorage::addPlanningQuery(const moveit_msgs:
     addNewPlanningRequest(planning_query, scene_name, query_name);
 }
 
+void moveit_warehouse::PlanningSceneStorage::addPlanningQueries(
+    const std::vector<moveit_msgs::msg::MotionPlanRequest>& planning_queries, const std::string& scene_name,
+    const std::vector<std::string>& query_names)
+{
+  if (!query_names.empty() && query_names.size() != planning_queries.size())
+  {
+    RCLCPP_ERROR(logger_, "Got %zu planning queries but %zu names", planning_queries.size(), query_names.size());
+    return;
+  }
+
+  // index the stored requests of the scene by their serialization, like getMotionPlanRequestName() compares them
+  rclcpp::Serialization<moveit_msgs::msg::MotionPlanRequest> serializer;
+  const auto serialize = [&serializer](const moveit_msgs::msg::MotionPlanRequest& msg) {
+    rclcpp::SerializedMessage serialized_msg;
+    serializer.serialize_message(&msg, &serialized_msg);
+    return std::string(reinterpret_cast<const char*>(serialized_msg.get_rcl_serialized_message().buffer),
+                       serialized_msg.size());
+  };
+  Query::Ptr q = motion_plan_request_collection_->createQuery();
+  q->append(PLANNING_SCENE_ID_NAME, scene_name);
+  std::vector<MotionPlanRequestWithMetadata> existing_requests = motion_plan_request_collection_->queryList(q, false);
+  std::map<std::string, std::string> names_by_request;
+  std::set<std::string> used;
+  for (MotionPlanRequestWithMetadata& existing_request : existing_requests)
+  {
+    const std::string name = existing_request->lookupString(MOTION_PLAN_REQUEST_ID_NAME);
+    names_by_request.emplace(serialize(*existing_request), name);
+    used.insert(name);
+  }
+  std::size_t index = existing_requests.size();
+
+  for (std::size_t i = 0; i < planning_queries.size(); ++i)
+  {
+    const std::string serialized = serialize(planning_queries[i]);
+    const auto existing = names_by_request.find(serialized);
+    const std::string id = existing == names_by_request.end() ? "" : existing->second;
+    std::string query_name = query_names.empty() ? "" : query_names[i];
+
+    // if we are trying to overwrite, we remove the old query first (if it exists).
+    if (!query_name.empty() && id.empty() && used.count(query_name))
+    {
+      removePlanningQuery(scene_name, query_name);
+      for (auto it = names_by_request.begin(); it != names_by_request.end();)
+        it = it->second == query_name ? names_by_request.erase(it) : std::next(it);
+    }
+    if (id == query_name && !id.empty())
+      continue;
+
+    if (query_name.empty())
+    {
+      do
+      {
+        query_name = "Motion Plan Request " + std::to_string(index++);
+      } while (used.count(query_name));
+    }
+    Metadata::Ptr metadata = motion_plan_request_collection_->createMetadata();
+    metadata->append(PLANNING_SCENE_ID_NAME, scene_name);
+    metadata->append(MOTION_PLAN_REQUEST_ID_NAME, query_name);
+    motion_plan_request_collection_->insert(planning_queries[i], metadata);
+    names_by_request.emplace(serialized, query_name);
+    used.insert(query_name);
+  }
+  RCLCPP_DEBUG(logger_, "Saved %zu planning queries for scene '%s'", planning_queries.size(), scene_name.c_str());
+}
+
 std::string
 moveit_warehouse::PlanningSceneStorage::addNewPlanningRequest(const moveit_msgs::msg::MotionPlanRequest& planning_query,
                                                               const std::string& scene_name,
@@ -325,6 +392,14 @@ void moveit_warehouse::PlanningSceneStorage::getPlanningQueries(
   }
 }
 
+void moveit_warehouse::PlanningSceneStorage::getPlanningQueries(
+    const std::string& regex, std::vector<MotionPlanRequestWithMetadata>& planning_queries,
+    std::vector<std::string>& query_names, const std::string& scene_name) const
+{
+  getPlanningQueries(planning_queries, query_names, scene_name);
+  filterMessages(regex, planning_queries, query_names);
+}
+
 void moveit_warehouse::PlanningSceneStorage::getPlanningResults(
     std::vector<RobotTrajectoryWithMetadata>& planning_results, const std::string& scene_name,
     const moveit_msgs::msg::MotionPlanRequest& planning_query) const
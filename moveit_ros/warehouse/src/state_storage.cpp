@@ -37,6 +37,7 @@
 #include <moveit/warehouse/state_storage.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <set>
 #include <utility>
 
 const std::string moveit_warehouse::RobotStateStorage::DATABASE_NAME = "moveit_robot_states";
@@ -81,6 +82,31 @@ void moveit_warehouse::RobotStateStorage::addRobotState(const moveit_msgs::msg::
   RCLCPP_DEBUG(logger_, "%s robot state '%s'", replace ? "Replaced" : "Added", name.c_str());
 }
 
+void moveit_warehouse::RobotStateStorage::addRobotStates(const std::vector<moveit_msgs::msg::RobotState>& msgs,
+                                                         const std::vector<std::string>& names,
+                                                         const std::string& robot)
+{
+  if (msgs.size() != names.size())
+  {
+    RCLCPP_ERROR(logger_, "Got %zu robot states but %zu names", msgs.size(), names.size());
+    return;
+  }
+  std::vector<std::string> known_names;
+  getKnownRobotStates(known_names, robot);
+  std::set<std::string> known(known_names.begin(), known_names.end());
+  for (std::size_t i = 0; i < msgs.size(); ++i)
+  {
+    if (known.count(names[i]))
+      removeRobotState(names[i], robot);
+    Metadata::Ptr metadata = state_collection_->createMetadata();
+    metadata->append(STATE_NAME, names[i]);
+    metadata->append(ROBOT_NAME, robot);
+    state_collection_->insert(msgs[i], metadata);
+    known.insert(names[i]);
+  }
+  RCLCPP_DEBUG(logger_, "Added %zu robot states", msgs.size());
+}
+
 bool moveit_warehouse::RobotStateStorage::hasRobotState(const std::string& name, const std::string& robot) const
 {
   Query::Ptr q = state_collection_->createQuery();
@@ -132,6 +158,21 @@ bool moveit_warehouse::RobotStateStorage::getRobotState(RobotStateWithMetadata&
   }
 }
 
+void moveit_warehouse::RobotStateStorage::getRobotStates(const std::string& regex,
+                                                         std::vector<RobotStateWithMetadata>& msgs,
+                                                         std::vector<std::string>& names,
+                                                         const std::string& robot) const
+{
+  Query::Ptr q = state_collection_->createQuery();
+  if (!robot.empty())
+    q->append(ROBOT_NAME, robot);
+  msgs = state_collection_->queryList(q, false, STATE_NAME, true);
+  names.resize(msgs.size());
+  for (std::size_t i = 0; i < msgs.size(); ++i)
+    names[i] = msgs[i]->lookupField(STATE_NAME) ? msgs[i]->lookupString(STATE_NAME) : "";
+  filterMessages(regex, msgs, names);
+}
+
 void moveit_warehouse::RobotStateStorage::renameRobotState(const std::string& old_name, const std::string& new_name,
                                                            const std::string& robot)
 {
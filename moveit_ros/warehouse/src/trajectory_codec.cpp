@@ -0,0 +1,490 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/warehouse/trajectory_codec.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#ifdef MOVEIT_WAREHOUSE_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace moveit_warehouse
+{
+namespace
+{
+enum TrajectoryCodecFlags : uint8_t
+{
+  ZSTD_COMPRESSED = 1
+};
+
+class Writer
+{
+public:
+  Writer(std::vector<uint8_t>& data, double resolution) : data_(data), resolution_(resolution)
+  {
+  }
+
+  void writeUnsigned(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      data_.push_back(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    data_.push_back(static_cast<uint8_t>(value));
+  }
+
+  // Zigzag encoding, so that small negative values are short as well
+  void writeSigned(int64_t value)
+  {
+    writeUnsigned((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+
+  void writeDouble(double value)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i)
+      data_.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+  }
+
+  void writeString(const std::string& value)
+  {
+    writeUnsigned(value.size());
+    data_.insert(data_.end(), value.begin(), value.end());
+  }
+
+  void writeHeader(const std_msgs::msg::Header& header)
+  {
+    writeSigned(header.stamp.sec);
+    writeUnsigned(header.stamp.nanosec);
+    writeString(header.frame_id);
+  }
+
+  void writeNames(const std::vector<std::string>& names)
+  {
+    writeUnsigned(names.size());
+    for (const std::string& name : names)
+      writeString(name);
+  }
+
+  // Differences of the quantized values to the ones of the previous waypoint
+  bool writeValues(const std::vector<double>& values, std::vector<int64_t>& previous)
+  {
+    writeUnsigned(values.size());
+    previous.resize(values.size(), 0);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      if (!std::isfinite(values[i]))
+        return false;
+      const int64_t quantized = std::llround(values[i] / resolution_);
+      writeSigned(quantized - previous[i]);
+      previous[i] = quantized;
+    }
+    return true;
+  }
+
+  void writeDuration(const builtin_interfaces::msg::Duration& duration, int64_t& previous_ns)
+  {
+    const int64_t ns = static_cast<int64_t>(duration.sec) * 1000000000 + duration.nanosec;
+    writeSigned(ns - previous_ns);
+    previous_ns = ns;
+  }
+
+private:
+  std::vector<uint8_t>& data_;
+  const double resolution_;
+};
+
+class Reader
+{
+public:
+  Reader(const uint8_t* data, std::size_t size) : data_(data), size_(size)
+  {
+  }
+
+  bool readUnsigned(uint64_t& value)
+  {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+      if (pos_ >= size_)
+        return false;
+      const uint8_t byte = data_[pos_++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        return true;
+    }
+    return false;
+  }
+
+  bool readSigned(int64_t& value)
+  {
+    uint64_t zigzag;
+    if (!readUnsigned(zigzag))
+      return false;
+    value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    return true;
+  }
+
+  bool readDouble(double& value)
+  {
+    if (size_ - pos_ < 8)
+      return false;
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i)
+      bits |= static_cast<uint64_t>(data_[pos_++]) << (8 * i);
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+  }
+
+  // Sizes are checked against the remaining data, so that corrupt sizes can't cause huge allocations
+  bool readSize(std::size_t& size)
+  {
+    uint64_t value;
+    if (!readUnsigned(value) || value > size_ - pos_)
+      return false;
+    size = static_cast<std::size_t>(value);
+    return true;
+  }
+
+  bool readString(std::string& value)
+  {
+    std::size_t size;
+    if (!readSize(size))
+      return false;
+    value.assign(reinterpret_cast<const char*>(data_ + pos_), size);
+    pos_ += size;
+    return true;
+  }
+
+  bool readHeader(std_msgs::msg::Header& header)
+  {
+    int64_t sec;
+    uint64_t nanosec;
+    if (!readSigned(sec) || !readUnsigned(nanosec) || !readString(header.frame_id))
+      return false;
+    header.stamp.sec = static_cast<int32_t>(sec);
+    header.stamp.nanosec = static_cast<uint32_t>(nanosec);
+    return true;
+  }
+
+  bool readNames(std::vector<std::string>& names)
+  {
+    std::size_t size;
+    if (!readSize(size))
+      return false;
+    names.resize(size);
+    for (std::string& name : names)
+    {
+      if (!readString(name))
+        return false;
+    }
+    return true;
+  }
+
+  bool readValues(std::vector<double>& values, std::vector<int64_t>& previous, double resolution)
+  {
+    std::size_t size;
+    if (!readSize(size))
+      return false;
+    values.resize(size);
+    previous.resize(size, 0);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      int64_t delta;
+      if (!readSigned(delta))
+        return false;
+      previous[i] += delta;
+      values[i] = static_cast<double>(previous[i]) * resolution;
+    }
+    return true;
+  }
+
+  bool readDuration(builtin_interfaces::msg::Duration& duration, int64_t& previous_ns)
+  {
+    int64_t delta;
+    if (!readSigned(delta))
+      return false;
+    previous_ns += delta;
+    // Negative durations have a negative sec and a positive nanosec
+    int64_t sec = previous_ns / 1000000000;
+    if (previous_ns % 1000000000 < 0)
+      --sec;
+    duration.sec = static_cast<int32_t>(sec);
+    duration.nanosec = static_cast<uint32_t>(previous_ns - sec * 1000000000);
+    return true;
+  }
+
+  bool atEnd() const
+  {
+    return pos_ == size_;
+  }
+
+  std::size_t position() const
+  {
+    return pos_;
+  }
+
+private:
+  const uint8_t* data_;
+  const std::size_t size_;
+  std::size_t pos_ = 0;
+};
+
+// Multi-DOF waypoints are stored as flat arrays of 7 values per transform and 6 values per twist
+void flattenTransforms(const std::vector<geometry_msgs::msg::Transform>& transforms, std::vector<double>& values)
+{
+  values.clear();
+  for (const geometry_msgs::msg::Transform& t : transforms)
+  {
+    values.insert(values.end(), { t.translation.x, t.translation.y, t.translation.z, t.rotation.x, t.rotation.y,
+                                  t.rotation.z, t.rotation.w });
+  }
+}
+
+void flattenTwists(const std::vector<geometry_msgs::msg::Twist>& twists, std::vector<double>& values)
+{
+  values.clear();
+  for (const geometry_msgs::msg::Twist& t : twists)
+  {
+    values.insert(values.end(), { t.linear.x, t.linear.y, t.linear.z, t.angular.x, t.angular.y, t.angular.z });
+  }
+}
+
+bool unflattenTransforms(const std::vector<double>& values, std::vector<geometry_msgs::msg::Transform>& transforms)
+{
+  if (values.size() % 7 != 0)
+    return false;
+  transforms.resize(values.size() / 7);
+  for (std::size_t i = 0; i < transforms.size(); ++i)
+  {
+    const double* v = &values[7 * i];
+    transforms[i].translation.x = v[0];
+    transforms[i].translation.y = v[1];
+    transforms[i].translation.z = v[2];
+    transforms[i].rotation.x = v[3];
+    transforms[i].rotation.y = v[4];
+    transforms[i].rotation.z = v[5];
+    transforms[i].rotation.w = v[6];
+  }
+  return true;
+}
+
+bool unflattenTwists(const std::vector<double>& values, std::vector<geometry_msgs::msg::Twist>& twists)
+{
+  if (values.size() % 6 != 0)
+    return false;
+  twists.resize(values.size() / 6);
+  for (std::size_t i = 0; i < twists.size(); ++i)
+  {
+    const double* v = &values[6 * i];
+    twists[i].linear.x = v[0];
+    twists[i].linear.y = v[1];
+    twists[i].linear.z = v[2];
+    twists[i].angular.x = v[3];
+    twists[i].angular.y = v[4];
+    twists[i].angular.z = v[5];
+  }
+  return true;
+}
+
+bool encodePayload(const moveit_msgs::msg::RobotTrajectory& trajectory, double resolution, std::vector<uint8_t>& data)
+{
+  Writer writer(data, resolution);
+  writer.writeDouble(resolution);
+
+  const trajectory_msgs::msg::JointTrajectory& joint_trajectory = trajectory.joint_trajectory;
+  writer.writeHeader(joint_trajectory.header);
+  writer.writeNames(joint_trajectory.joint_names);
+  writer.writeUnsigned(joint_trajectory.points.size());
+  std::vector<int64_t> positions, velocities, accelerations, effort;
+  int64_t time_ns = 0;
+  for (const trajectory_msgs::msg::JointTrajectoryPoint& point : joint_trajectory.points)
+  {
+    if (!writer.writeValues(point.positions, positions) || !writer.writeValues(point.velocities, velocities) ||
+        !writer.writeValues(point.accelerations, accelerations) || !writer.writeValues(point.effort, effort))
+      return false;
+    writer.writeDuration(point.time_from_start, time_ns);
+  }
+
+  const trajectory_msgs::msg::MultiDOFJointTrajectory& multi_dof_trajectory = trajectory.multi_dof_joint_trajectory;
+  writer.writeHeader(multi_dof_trajectory.header);
+  writer.writeNames(multi_dof_trajectory.joint_names);
+  writer.writeUnsigned(multi_dof_trajectory.points.size());
+  std::vector<int64_t> transforms, twists, twist_accelerations;
+  std::vector<double> values;
+  time_ns = 0;
+  for (const trajectory_msgs::msg::MultiDOFJointTrajectoryPoint& point : multi_dof_trajectory.points)
+  {
+    flattenTransforms(point.transforms, values);
+    if (!writer.writeValues(values, transforms))
+      return false;
+    flattenTwists(point.velocities, values);
+    if (!writer.writeValues(values, twists))
+      return false;
+    flattenTwists(point.accelerations, values);
+    if (!writer.writeValues(values, twist_accelerations))
+      return false;
+    writer.writeDuration(point.time_from_start, time_ns);
+  }
+  return true;
+}
+
+bool decodePayload(Reader& reader, moveit_msgs::msg::RobotTrajectory& trajectory)
+{
+  double resolution;
+  if (!reader.readDouble(resolution))
+    return false;
+
+  trajectory_msgs::msg::JointTrajectory& joint_trajectory = trajectory.joint_trajectory;
+  std::size_t num_points;
+  if (!reader.readHeader(joint_trajectory.header) || !reader.readNames(joint_trajectory.joint_names) ||
+      !reader.readSize(num_points))
+    return false;
+  joint_trajectory.points.resize(num_points);
+  std::vector<int64_t> positions, velocities, accelerations, effort;
+  int64_t time_ns = 0;
+  for (trajectory_msgs::msg::JointTrajectoryPoint& point : joint_trajectory.points)
+  {
+    if (!reader.readValues(point.positions, positions, resolution) ||
+        !reader.readValues(point.velocities, velocities, resolution) ||
+        !reader.readValues(point.accelerations, accelerations, resolution) ||
+        !reader.readValues(point.effort, effort, resolution) || !reader.readDuration(point.time_from_start, time_ns))
+      return false;
+  }
+
+  trajectory_msgs::msg::MultiDOFJointTrajectory& multi_dof_trajectory = trajectory.multi_dof_joint_trajectory;
+  if (!reader.readHeader(multi_dof_trajectory.header) || !reader.readNames(multi_dof_trajectory.joint_names) ||
+      !reader.readSize(num_points))
+    return false;
+  multi_dof_trajectory.points.resize(num_points);
+  std::vector<int64_t> transforms, twists, twist_accelerations;
+  std::vector<double> values;
+  time_ns = 0;
+  for (trajectory_msgs::msg::MultiDOFJointTrajectoryPoint& point : multi_dof_trajectory.points)
+  {
+    if (!reader.readValues(values, transforms, resolution) || !unflattenTransforms(values, point.transforms) ||
+        !reader.readValues(values, twists, resolution) || !unflattenTwists(values, point.velocities) ||
+        !reader.readValues(values, twist_accelerations, resolution) ||
+        !unflattenTwists(values, point.accelerations) || !reader.readDuration(point.time_from_start, time_ns))
+      return false;
+  }
+  return reader.atEnd();
+}
+}  // namespace
+
+bool isTrajectoryCompressionAvailable()
+{
+#ifdef MOVEIT_WAREHOUSE_HAS_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool encodeTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory, std::vector<uint8_t>& data,
+                      const TrajectoryCodecOptions& options)
+{
+  data.clear();
+  if (!(options.resolution > 0.0))
+    return false;
+
+  std::vector<uint8_t> payload;
+  if (!encodePayload(trajectory, options.resolution, payload))
+    return false;
+
+  data.push_back(TRAJECTORY_CODEC_SCHEMA_VERSION);
+#ifdef MOVEIT_WAREHOUSE_HAS_ZSTD
+  if (options.compress)
+  {
+    data.push_back(ZSTD_COMPRESSED);
+    Writer(data, options.resolution).writeUnsigned(payload.size());
+    const std::size_t offset = data.size();
+    data.resize(offset + ZSTD_compressBound(payload.size()));
+    const std::size_t compressed_size =
+        ZSTD_compress(data.data() + offset, data.size() - offset, payload.data(), payload.size(), ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(compressed_size))
+    {
+      data.clear();
+      return false;
+    }
+    data.resize(offset + compressed_size);
+    return true;
+  }
+#endif
+  data.push_back(0);
+  data.insert(data.end(), payload.begin(), payload.end());
+  return true;
+}
+
+bool decodeTrajectory(const std::vector<uint8_t>& data, moveit_msgs::msg::RobotTrajectory& trajectory)
+{
+  if (data.size() < 2 || data[0] != TRAJECTORY_CODEC_SCHEMA_VERSION)
+    return false;
+  trajectory = moveit_msgs::msg::RobotTrajectory();
+
+  const uint8_t flags = data[1];
+  if ((flags & ZSTD_COMPRESSED) == 0)
+  {
+    Reader reader(data.data() + 2, data.size() - 2);
+    return decodePayload(reader, trajectory);
+  }
+
+#ifdef MOVEIT_WAREHOUSE_HAS_ZSTD
+  Reader size_reader(data.data() + 2, data.size() - 2);
+  uint64_t payload_size;
+  if (!size_reader.readUnsigned(payload_size))
+    return false;
+  const std::size_t offset = 2 + size_reader.position();
+
+  // The frame records the decompressed size, which must match the stored one
+  const unsigned long long frame_size = ZSTD_getFrameContentSize(data.data() + offset, data.size() - offset);
+  if (frame_size != payload_size)
+    return false;
+  std::vector<uint8_t> payload(payload_size);
+  const std::size_t decompressed_size =
+      ZSTD_decompress(payload.data(), payload.size(), data.data() + offset, data.size() - offset);
+  if (ZSTD_isError(decompressed_size) || decompressed_size != payload_size)
+    return false;
+  Reader reader(payload.data(), payload.size());
+  return decodePayload(reader, trajectory);
+#else
+  return false;
+#endif
+}
+}  // namespace moveit_warehouse
@@ -37,6 +37,7 @@
 #include <moveit/warehouse/trajectory_constraints_storage.hpp>
 #include <moveit/utils/logger.hpp>
 
+#include <set>
 #include <utility>
 
 const std::string moveit_warehouse::TrajectoryConstraintsStorage::DATABASE_NAME = "moveit_trajectory_constraints";
@@ -86,6 +87,32 @@ void moveit_warehouse::TrajectoryConstraintsStorage::addTrajectoryConstraints(
   RCLCPP_DEBUG(logger_, "%s constraints '%s'", replace ? "Replaced" : "Added", name.c_str());
 }
 
+void moveit_warehouse::TrajectoryConstraintsStorage::addTrajectoryConstraints(
+    const std::vector<moveit_msgs::msg::TrajectoryConstraints>& msgs, const std::vector<std::string>& names,
+    const std::string& robot, const std::string& group)
+{
+  if (msgs.size() != names.size())
+  {
+    RCLCPP_ERROR(logger_, "Got %zu trajectory constraints but %zu names", msgs.size(), names.size());
+    return;
+  }
+  std::vector<std::string> known_names;
+  getKnownTrajectoryConstraints(known_names, robot, group);
+  std::set<std::string> known(known_names.begin(), known_names.end());
+  for (std::size_t i = 0; i < msgs.size(); ++i)
+  {
+    if (known.count(names[i]))
+      removeTrajectoryConstraints(names[i], robot, group);
+    Metadata::Ptr metadata = constraints_collection_->createMetadata();
+    metadata->append(CONSTRAINTS_ID_NAME, names[i]);
+    metadata->append(ROBOT_NAME, robot);
+    metadata->append(CONSTRAINTS_GROUP_NAME, group);
+    constraints_collection_->insert(msgs[i], metadata);
+    known.insert(names[i]);
+  }
+  RCLCPP_DEBUG(logger_, "Added %zu trajectory constraints", msgs.size());
+}
+
 bool moveit_warehouse::TrajectoryConstraintsStorage::hasTrajectoryConstraints(const std::string& name,
                                                                               const std::string& robot,
                                                                               const std::string& group) const
@@ -151,6 +178,22 @@ bool moveit_warehouse::TrajectoryConstraintsStorage::getTrajectoryConstraints(Tr
   }
 }
 
+void moveit_warehouse::TrajectoryConstraintsStorage::getTrajectoryConstraints(
+    const std::string& regex, std::vector<TrajectoryConstraintsWithMetadata>& msgs, std::vector<std::string>& names,
+    const std::string& robot, const std::string& group) const
+{
+  Query::Ptr q = constraints_collection_->createQuery();
+  if (!robot.empty())
+    q->append(ROBOT_NAME, robot);
+  if (!group.empty())
+    q->append(CONSTRAINTS_GROUP_NAME, group);
+  msgs = constraints_collection_->queryList(q, false, CONSTRAINTS_ID_NAME, true);
+  names.resize(msgs.size());
+  for (std::size_t i = 0; i < msgs.size(); ++i)
+    names[i] = msgs[i]->lookupField(CONSTRAINTS_ID_NAME) ? msgs[i]->lookupString(CONSTRAINTS_ID_NAME) : "";
+  filterMessages(regex, msgs, names);
+}
+
 void moveit_warehouse::TrajectoryConstraintsStorage::renameTrajectoryConstraints(const std::string& old_name,
                                                                                  const std::string& new_name,
                                                                                  const std::string& robot,
@@ -0,0 +1,179 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, MoveIt maintainers
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/warehouse/trajectory_storage.hpp>
+#include <moveit/utils/logger.hpp>
+
+#include <utility>
+
+const std::string moveit_warehouse::TrajectoryStorage::DATABASE_NAME = "moveit_trajectories";
+
+const std::string moveit_warehouse::TrajectoryStorage::TRAJECTORY_ID_NAME = "trajectory_id";
+const std::string moveit_warehouse::TrajectoryStorage::TRAJECTORY_GROUP_NAME = "group_id";
+const std::string moveit_warehouse::TrajectoryStorage::ROBOT_NAME = "robot_id";
+const std::string moveit_warehouse::TrajectoryStorage::SCHEMA_VERSION_NAME = "schema_version";
+
+using warehouse_ros::Metadata;
+using warehouse_ros::Query;
+
+moveit_warehouse::TrajectoryStorage::TrajectoryStorage(warehouse_ros::DatabaseConnection::Ptr conn,
+                                                       const TrajectoryCodecOptions& codec_options)
+  : MoveItMessageStorage(std::move(conn))
+  , codec_options_(codec_options)
+  , logger_(moveit::getLogger("moveit.ros.warehouse_trajectory_storage"))
+{
+  createCollections();
+}
+
+void moveit_warehouse::TrajectoryStorage::createCollections()
+{
+  trajectory_collection_ = conn_->openCollectionPtr<std_msgs::msg::UInt8MultiArray>(DATABASE_NAME, "trajectories");
+}
+
+void moveit_warehouse::TrajectoryStorage::reset()
+{
+  trajectory_collection_.reset();
+  conn_->dropDatabase(DATABASE_NAME);
+  createCollections();
+}
+
+Query::Ptr moveit_warehouse::TrajectoryStorage::createQuery(const std::string& name, const std::string& robot,
+                                                            const std::string& group) const
+{
+  Query::Ptr q = trajectory_collection_->createQuery();
+  q->append(TRAJECTORY_ID_NAME, name);
+  if (!robot.empty())
+    q->append(ROBOT_NAME, robot);
+  if (!group.empty())
+    q->append(TRAJECTORY_GROUP_NAME, group);
+  return q;
+}
+
+bool moveit_warehouse::TrajectoryStorage::addTrajectory(const moveit_msgs::msg::RobotTrajectory& msg,
+                                                        const std::string& name, const std::string& robot,
+                                                        const std::string& group)
+{
+  std_msgs::msg::UInt8MultiArray encoded;
+  if (!encodeTrajectory(msg, encoded.data, codec_options_))
+  {
+    RCLCPP_ERROR(logger_, "Unable to encode trajectory '%s'", name.c_str());
+    return false;
+  }
+
+  bool replace = false;
+  if (hasTrajectory(name, robot, group))
+  {
+    removeTrajectory(name, robot, group);
+    replace = true;
+  }
+  Metadata::Ptr metadata = trajectory_collection_->createMetadata();
+  metadata->append(TRAJECTORY_ID_NAME, name);
+  metadata->append(ROBOT_NAME, robot);
+  metadata->append(TRAJECTORY_GROUP_NAME, group);
+  metadata->append(SCHEMA_VERSION_NAME, static_cast<int>(TRAJECTORY_CODEC_SCHEMA_VERSION));
+  trajectory_collection_->insert(encoded, metadata);
+  RCLCPP_DEBUG(logger_, "%s trajectory '%s' (%zu bytes)", replace ? "Replaced" : "Added", name.c_str(),
+               encoded.data.size());
+  return true;
+}
+
+bool moveit_warehouse::TrajectoryStorage::hasTrajectory(const std::string& name, const std::string& robot,
+                                                        const std::string& group) const
+{
+  std::vector<EncodedTrajectoryWithMetadata> trajectories =
+      trajectory_collection_->queryList(createQuery(name, robot, group), true);
+  return !trajectories.empty();
+}
+
+void moveit_warehouse::TrajectoryStorage::getKnownTrajectories(const std::string& regex,
+                                                               std::vector<std::string>& names,
+                                                               const std::string& robot,
+                                                               const std::string& group) const
+{
+  getKnownTrajectories(names, robot, group);
+  filterNames(regex, names);
+}
+
+void moveit_warehouse::TrajectoryStorage::getKnownTrajectories(std::vector<std::string>& names,
+                                                               const std::string& robot,
+                                                               const std::string& group) const
+{
+  names.clear();
+  Query::Ptr q = trajectory_collection_->createQuery();
+  if (!robot.empty())
+    q->append(ROBOT_NAME, robot);
+  if (!group.empty())
+    q->append(TRAJECTORY_GROUP_NAME, group);
+  std::vector<EncodedTrajectoryWithMetadata> trajectories =
+      trajectory_collection_->queryList(q, true, TRAJECTORY_ID_NAME, true);
+  for (EncodedTrajectoryWithMetadata& trajectory : trajectories)
+  {
+    if (trajectory->lookupField(TRAJECTORY_ID_NAME))
+      names.push_back(trajectory->lookupString(TRAJECTORY_ID_NAME));
+  }
+}
+
+bool moveit_warehouse::TrajectoryStorage::getTrajectory(moveit_msgs::msg::RobotTrajectory& msg,
+                                                        const std::string& name, const std::string& robot,
+                                                        const std::string& group) const
+{
+  std::vector<EncodedTrajectoryWithMetadata> trajectories =
+      trajectory_collection_->queryList(createQuery(name, robot, group), false);
+  if (trajectories.empty())
+    return false;
+
+  if (!decodeTrajectory(trajectories.back()->data, msg))
+  {
+    RCLCPP_ERROR(logger_, "Unable to decode trajectory '%s', it may have been stored by a newer version",
+                 name.c_str());
+    return false;
+  }
+  return true;
+}
+
+void moveit_warehouse::TrajectoryStorage::renameTrajectory(const std::string& old_name, const std::string& new_name,
+                                                           const std::string& robot, const std::string& group)
+{
+  Metadata::Ptr m = trajectory_collection_->createMetadata();
+  m->append(TRAJECTORY_ID_NAME, new_name);
+  trajectory_collection_->modifyMetadata(createQuery(old_name, robot, group), m);
+  RCLCPP_DEBUG(logger_, "Renamed trajectory from '%s' to '%s'", old_name.c_str(), new_name.c_str());
+}
+
+void moveit_warehouse::TrajectoryStorage::removeTrajectory(const std::string& name, const std::string& robot,
+                                                           const std::string& group)
+{
+  unsigned int rem = trajectory_collection_->removeMessages(createQuery(name, robot, group));
+  RCLCPP_DEBUG(logger_, "Removed %u trajectories (named '%s')", rem, name.c_str());
+}
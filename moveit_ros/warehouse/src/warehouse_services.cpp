@@ -48,7 +48,12 @@
 #include <rclcpp/node_options.hpp>
 #include <rclcpp/parameter_value.hpp>
 #include <rclcpp/utilities.hpp>
+#include <rclcpp/version.h>
 #include <moveit/utils/logger.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 namespace
 {
@@ -56,6 +61,86 @@ rclcpp::Logger getLogger()
 {
   return moveit::getLogger("moveit.ros.warehouse_services");
 }
+
+// Function to support both Rolling and Humble on the main branch
+// Rolling has deprecated the version of the create_service method that takes
+// rmw_qos_profile_services_default for the QoS argument
+#if RCLCPP_VERSION_GTE(17, 0, 0)  // Rolling
+auto qosDefault()
+{
+  return rclcpp::ServicesQoS();
+}
+#else  // Humble
+auto qosDefault()
+{
+  return rmw_qos_profile_services_default;
+}
+#endif
+
+// warehouse_ros connections must not be used concurrently, so every service call borrows a storage with its own
+// connection for the duration of the call; calls wait only if all connections are busy.
+class RobotStateStoragePool
+{
+public:
+  void add(const moveit_warehouse::RobotStateStoragePtr& storage)
+  {
+    {
+      std::scoped_lock lock(mutex_);
+      free_.push_back(storage);
+    }
+    free_cv_.notify_one();
+  }
+
+  template <typename Function>
+  bool call(const Function& function)
+  {
+    moveit_warehouse::RobotStateStoragePtr storage;
+    {
+      std::unique_lock lock(mutex_);
+      free_cv_.wait(lock, [this] { return !free_.empty(); });
+      storage = free_.back();
+      free_.pop_back();
+    }
+    bool result = false;
+    try
+    {
+      result = function(*storage);
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(getLogger(), "Warehouse request failed: %s", ex.what());
+    }
+    add(storage);
+    return result;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable free_cv_;
+  std::vector<moveit_warehouse::RobotStateStoragePtr> free_;
+};
+
+warehouse_ros::DatabaseConnection::Ptr connectToWarehouse(const rclcpp::Node::SharedPtr& node, const std::string& host,
+                                                          int port, double connection_timeout, int connection_retries)
+{
+  warehouse_ros::DatabaseConnection::Ptr conn = moveit_warehouse::loadDatabase(node);
+  conn->setParams(host, port, connection_timeout);
+
+  RCLCPP_INFO(node->get_logger(), "Connecting to warehouse on %s:%d", host.c_str(), port);
+  int tries = 0;
+  while (!conn->connect())
+  {
+    ++tries;
+    RCLCPP_WARN(node->get_logger(), "Failed to connect to DB on %s:%d (try %d/%d).", host.c_str(), port, tries,
+                connection_retries);
+    if (tries == connection_retries)
+    {
+      RCLCPP_FATAL(node->get_logger(), "Failed to connect too many times, giving up");
+      return nullptr;
+    }
+  }
+  return conn;
+}
 }  // namespace
 
 static const std::string ROBOT_DESCRIPTION = "robot_description";
@@ -154,31 +239,29 @@ int main(int argc, char** argv)
   int port;
   double connection_timeout;
   int connection_retries;
+  int num_threads;
 
   node->get_parameter_or(std::string("warehouse_host"), host, std::string("localhost"));
   node->get_parameter_or(std::string("warehouse_port"), port, 33829);
   node->get_parameter_or(std::string("warehouse_db_connection_timeout"), connection_timeout, 5.0);
   node->get_parameter_or(std::string("warehouse_db_connection_retries"), connection_retries, 5);
+  // number of service calls served concurrently, each on its own database connection
+  node->get_parameter_or(std::string("warehouse_service_threads"), num_threads, 4);
+  num_threads = std::max(num_threads, 1);
 
-  warehouse_ros::DatabaseConnection::Ptr conn;
+  RobotStateStoragePool pool;
+  moveit_warehouse::RobotStateStoragePtr storage;
 
   try
   {
-    conn = moveit_warehouse::loadDatabase(node);
-    conn->setParams(host, port, connection_timeout);
-
-    RCLCPP_INFO(node->get_logger(), "Connecting to warehouse on %s:%d", host.c_str(), port);
-    int tries = 0;
-    while (!conn->connect())
+    for (int i = 0; i < num_threads; ++i)
     {
-      ++tries;
-      RCLCPP_WARN(node->get_logger(), "Failed to connect to DB on %s:%d (try %d/%d).", host.c_str(), port, tries,
-                  connection_retries);
-      if (tries == connection_retries)
-      {
-        RCLCPP_FATAL(node->get_logger(), "Failed to connect too many times, giving up");
+      warehouse_ros::DatabaseConnection::Ptr conn =
+          connectToWarehouse(node, host, port, connection_timeout, connection_retries);
+      if (!conn)
         return 1;
-      }
+      storage = std::make_shared<moveit_warehouse::RobotStateStorage>(conn);
+      pool.add(storage);
     }
   }
   catch (std::exception& ex)
@@ -187,10 +270,8 @@ int main(int argc, char** argv)
     return 1;
   }
 
-  moveit_warehouse::RobotStateStorage rs(conn);
-
   std::vector<std::string> names;
-  rs.getKnownRobotStates(names);
+  storage->getKnownRobotStates(names);
   if (names.empty())
   {
     RCLCPP_INFO(node->get_logger(), "There are no previously stored robot states");
@@ -204,49 +285,57 @@ int main(int argc, char** argv)
 
   auto save_cb = [&](const std::shared_ptr<moveit_msgs::srv::SaveRobotStateToWarehouse::Request>& request,
                      const std::shared_ptr<moveit_msgs::srv::SaveRobotStateToWarehouse::Response>& response) -> bool {
-    return storeState(request, response, rs);
+    return pool.call([&](moveit_warehouse::RobotStateStorage& rs) { return storeState(request, response, rs); });
   };
 
   auto list_cb = [&](const std::shared_ptr<moveit_msgs::srv::ListRobotStatesInWarehouse::Request>& request,
                      const std::shared_ptr<moveit_msgs::srv::ListRobotStatesInWarehouse::Response>& response) -> bool {
-    return listStates(request, response, rs);
+    return pool.call([&](moveit_warehouse::RobotStateStorage& rs) { return listStates(request, response, rs); });
   };
 
   auto get_cb = [&](const std::shared_ptr<moveit_msgs::srv::GetRobotStateFromWarehouse::Request>& request,
                     const std::shared_ptr<moveit_msgs::srv::GetRobotStateFromWarehouse::Response>& response) -> bool {
-    return getState(request, response, rs);
+    return pool.call([&](moveit_warehouse::RobotStateStorage& rs) { return getState(request, response, rs); });
   };
 
   auto has_cb =
       [&](const std::shared_ptr<moveit_msgs::srv::CheckIfRobotStateExistsInWarehouse::Request>& request,
           const std::shared_ptr<moveit_msgs::srv::CheckIfRobotStateExistsInWarehouse::Response>& response) -> bool {
-    return hasState(request, response, rs);
+    return pool.call([&](moveit_warehouse::RobotStateStorage& rs) { return hasState(request, response, rs); });
   };
 
   auto rename_cb =
       [&](const std::shared_ptr<moveit_msgs::srv::RenameRobotStateInWarehouse::Request>& request,
           const std::shared_ptr<moveit_msgs::srv::RenameRobotStateInWarehouse::Response>& response) -> bool {
-    return renameState(request, response, rs);
+    return pool.call([&](moveit_warehouse::RobotStateStorage& rs) { return renameState(request, response, rs); });
   };
 
   auto delete_cb =
       [&](const std::shared_ptr<moveit_msgs::srv::DeleteRobotStateFromWarehouse::Request>& request,
           const std::shared_ptr<moveit_msgs::srv::DeleteRobotStateFromWarehouse::Response>& response) -> bool {
-    return deleteState(request, response, rs);
+    return pool.call([&](moveit_warehouse::RobotStateStorage& rs) { return deleteState(request, response, rs); });
   };
 
-  auto save_state_server =
-      node->create_service<moveit_msgs::srv::SaveRobotStateToWarehouse>("save_robot_state", save_cb);
-  auto list_states_server =
-      node->create_service<moveit_msgs::srv::ListRobotStatesInWarehouse>("list_robot_states", list_cb);
-  auto get_state_server = node->create_service<moveit_msgs::srv::GetRobotStateFromWarehouse>("get_robot_state", get_cb);
-  auto has_state_server =
-      node->create_service<moveit_msgs::srv::CheckIfRobotStateExistsInWarehouse>("has_robot_state", has_cb);
-  auto rename_state_server =
-      node->create_service<moveit_msgs::srv::RenameRobotStateInWarehouse>("rename_robot_state", rename_cb);
-  auto delete_state_server =
-      node->create_service<moveit_msgs::srv::DeleteRobotStateFromWarehouse>("delete_robot_state", delete_cb);
-
-  rclcpp::spin(node);
+  // a reentrant group lets the executor threads serve several calls, also of the same service, at the same time
+  rclcpp::CallbackGroup::SharedPtr callback_group = node->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+  const auto qos = qosDefault();
+
+  auto save_state_server = node->create_service<moveit_msgs::srv::SaveRobotStateToWarehouse>(
+      "save_robot_state", save_cb, qos, callback_group);
+  auto list_states_server = node->create_service<moveit_msgs::srv::ListRobotStatesInWarehouse>(
+      "list_robot_states", list_cb, qos, callback_group);
+  auto get_state_server = node->create_service<moveit_msgs::srv::GetRobotStateFromWarehouse>(
+      "get_robot_state", get_cb, qos, callback_group);
+  auto has_state_server = node->create_service<moveit_msgs::srv::CheckIfRobotStateExistsInWarehouse>(
+      "has_robot_state", has_cb, qos, callback_group);
+  auto rename_state_server = node->create_service<moveit_msgs::srv::RenameRobotStateInWarehouse>(
+      "rename_robot_state", rename_cb, qos, callback_group);
+  auto delete_state_server = node->create_service<moveit_msgs::srv::DeleteRobotStateFromWarehouse>(
+      "delete_robot_state", delete_cb, qos, callback_group);
+
+  rclcpp::executors::MultiThreadedExecutor executor(rclcpp::ExecutorOptions(), num_threads);
+  executor.add_node(node);
+  executor.spin();
+  rclcpp::shutdown();
   return 0;
 }
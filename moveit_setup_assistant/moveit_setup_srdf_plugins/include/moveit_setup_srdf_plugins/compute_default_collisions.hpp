@@ -37,11 +37,18 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <set>
+#include <string>
 #include <moveit/macros/class_forward.hpp>
 namespace planning_scene
 {
 MOVEIT_CLASS_FORWARD(PlanningScene);  // Defines PlanningScenePtr, ConstPtr, WeakPtr... etc
 }
+namespace urdf
+{
+class ModelInterface;
+}
 
 namespace moveit_setup
 {
@@ -77,6 +84,28 @@ struct LinkPairData
  */
 typedef std::map<std::pair<std::string, std::string>, LinkPairData> LinkPairMap;
 
+/**
+ * \brief Intermediate results of computeDefaultCollisions(), which are reused when it runs again for the same URDF
+ * model and collision fraction, e.g. with a different number of trials
+ */
+struct DefaultCollisionsCache
+{
+  std::shared_ptr<const urdf::ModelInterface> urdf_model;
+  double min_collision_fraction = 0.0;
+
+  /// link pairs after disabling the adjacent, default and always colliding pairs
+  LinkPairMap link_pairs;
+  unsigned int num_adjacent = 0;
+  unsigned int num_default = 0;
+  unsigned int num_always = 0;
+
+  /// pairs seen colliding while looking for the always colliding pairs
+  std::set<std::pair<std::string, std::string>> always_seen_colliding;
+  /// pairs seen colliding in any of the num_trials random states sampled so far
+  std::set<std::pair<std::string, std::string>> links_seen_colliding;
+  unsigned int num_trials = 0;
+};
+
 /**
  * \brief Generate an adjacency list of links that are always and never in collision, to speed up collision detection
  * \param parent_scene A reference to the robot in the planning scene
@@ -84,11 +113,14 @@ typedef std::map<std::pair<std::string, std::string>, LinkPairData> LinkPairMap;
  * \param trials Set the number random collision checks that are made. Increase the probability of correctness
  * \param min_collision_fraction If collisions are found between a pair of links >= this fraction, the are assumed
  * "always" in collision
+ * \param cache Optional results of a previous call. If they match the URDF model and collision fraction, only the
+ * random states beyond the ones already sampled are checked, otherwise they are replaced by the results of this call.
  * \return Adj List of unique set of pairs of links in string-based form
  */
 LinkPairMap computeDefaultCollisions(const planning_scene::PlanningSceneConstPtr& parent_scene, unsigned int* progress,
                                      const bool include_never_colliding, const unsigned int trials,
-                                     const double min_collision_faction, const bool verbose);
+                                     const double min_collision_faction, const bool verbose,
+                                     DefaultCollisionsCache* cache = nullptr);
 
 /**
  * \brief Generate a list of unique link pairs for all links with geometry. Order pairs alphabetically. n choose 2 pairs
@@ -96,6 +96,9 @@ protected:
   /// main storage of link pair data
   LinkPairMap link_pairs_;
 
+  /// results of the previous generation, reused when only the sampling density changed
+  DefaultCollisionsCache collisions_cache_;
+
   // For threaded operations
   boost::thread worker_;
   unsigned int progress_;
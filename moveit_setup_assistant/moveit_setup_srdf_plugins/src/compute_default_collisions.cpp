@@ -39,6 +39,8 @@
 #include <boost/math/special_functions/binomial.hpp>  // for statistics at end
 #include <boost/thread.hpp>
 #include <boost/assign.hpp>
+#include <algorithm>
+#include <atomic>
 #include <unordered_map>
 #include <moveit/utils/logger.hpp>
 
@@ -67,28 +69,31 @@ const std::unordered_map<std::string, DisabledReason> REASONS_FROM_STRING = boos
 // Unique set of pairs of links in string-based form
 typedef std::set<std::pair<std::string, std::string> > StringPairSet;
 
-// Struct for passing parameters to threads, for cleaner code
+// Struct for sharing the sampling of random states between threads, for cleaner code
 struct ThreadComputation
 {
-  ThreadComputation(planning_scene::PlanningScene& scene, const collision_detection::CollisionRequest& req,
-                    int thread_id, int num_trials, StringPairSet* links_seen_colliding, std::mutex* lock,
+  ThreadComputation(const planning_scene::PlanningScene& scene, const collision_detection::CollisionRequest& req,
+                    unsigned int num_trials, StringPairSet* links_seen_colliding, std::size_t num_candidates,
                     unsigned int* progress)
     : scene_(scene)
     , req_(req)
-    , thread_id_(thread_id)
     , num_trials_(num_trials)
     , links_seen_colliding_(links_seen_colliding)
-    , lock_(lock)
+    , num_candidates_(num_candidates)
     , progress_(progress)
   {
   }
-  planning_scene::PlanningScene& scene_;
+  const planning_scene::PlanningScene& scene_;
   const collision_detection::CollisionRequest& req_;
-  int thread_id_;
   unsigned int num_trials_;
+  std::atomic<unsigned int> next_trial_{ 0 };
+  std::atomic<bool> stop_{ false };
+  std::mutex lock_;  // protects the members below
   StringPairSet* links_seen_colliding_;
-  std::mutex* lock_;
-  unsigned int* progress_;  // only to be updated by thread 0
+  std::vector<std::pair<std::string, std::string>> new_pairs_;  // pairs seen colliding, in the order they were found
+  std::atomic<std::size_t> num_new_pairs_{ 0 };
+  std::size_t num_candidates_;  // enabled pairs that were not seen colliding yet
+  unsigned int* progress_;      // only to be updated by the calling thread
 };
 
 // LinkGraph defines a Link's model and a set of unique links it connects
@@ -165,26 +170,32 @@ static unsigned int disableAlwaysInCollision(planning_scene::PlanningScene& scen
  * \param links_seen_colliding Set of links that have at some point been seen in collision
  * \return number of never in collision links found and disabled
  */
-static unsigned int disableNeverInCollision(const unsigned int num_trials, planning_scene::PlanningScene& scene,
+static unsigned int disableNeverInCollision(const unsigned int num_trials, const planning_scene::PlanningScene& scene,
                                             LinkPairMap& link_pairs, const collision_detection::CollisionRequest& req,
                                             StringPairSet& links_seen_colliding, unsigned int* progress);
 
 /**
  * \brief Thread for getting the pairs of links that are never in collision
- * \param tc Struct that encapsulates all the data each thread needs
+ * \param tc Struct that encapsulates all the data shared by the threads
+ * \param calling_thread Whether this is the calling thread, which reports progress and can be interrupted
  */
-static void disableNeverInCollisionThread(ThreadComputation tc);
+static void disableNeverInCollisionThread(ThreadComputation& tc, bool calling_thread);
 
 // ******************************************************************************************
 // Generates an adjacency list of links that are always and never in collision, to speed up collision detection
 // ******************************************************************************************
 LinkPairMap computeDefaultCollisions(const planning_scene::PlanningSceneConstPtr& parent_scene, unsigned int* progress,
                                      const bool include_never_colliding, const unsigned int num_trials,
-                                     const double min_collision_fraction, const bool verbose)
+                                     const double min_collision_fraction, const bool verbose,
+                                     DefaultCollisionsCache* cache)
 {
   // Create new instance of planning scene using pointer
   planning_scene::PlanningScenePtr scene = parent_scene->diff();
 
+  // The pairs disabled before sampling many random states don't depend on the number of trials
+  const bool reuse_cache = cache && cache->urdf_model == scene->getRobotModel()->getURDF() &&
+                           cache->min_collision_fraction == min_collision_fraction;
+
   // Map of disabled collisions that contains a link as a key and an ordered list of links that are connected.
   LinkPairMap link_pairs;
 
@@ -209,13 +220,7 @@ LinkPairMap computeDefaultCollisions(const planning_scene::PlanningSceneConstPtr
   *progress = 2;  // Progress bar feedback
   boost::this_thread::interruption_point();
 
-  // 2. DISABLE ALL ADJACENT LINK COLLISIONS ---------------------------------------------------------
-  // if 2 links are adjacent, or adjacent with a zero-shape between them, disable collision checking for them
-  unsigned int num_adjacent = disableAdjacentLinks(*scene, link_graph, link_pairs);
-  *progress = 4;  // Progress bar feedback
-  boost::this_thread::interruption_point();
-
-  // 3. INITIAL CONTACTS TO CONSIDER GUESS -----------------------------------------------------------
+  // 2. INITIAL CONTACTS TO CONSIDER GUESS -----------------------------------------------------------
   // Create collision detection request object
   collision_detection::CollisionRequest req;
   req.contacts = true;
@@ -224,17 +229,55 @@ LinkPairMap computeDefaultCollisions(const planning_scene::PlanningSceneConstPtr
   req.max_contacts_per_pair = 1;
   req.verbose = false;
 
-  // 4. DISABLE "DEFAULT" COLLISIONS --------------------------------------------------------
-  // Disable all collision checks that occur when the robot is started in its default state
-  unsigned int num_default = disableDefaultCollisions(*scene, link_pairs, req);
-  *progress = 6;  // Progress bar feedback
-  boost::this_thread::interruption_point();
+  unsigned int num_adjacent = 0;
+  unsigned int num_default = 0;
+  unsigned int num_always = 0;
+  if (reuse_cache)
+  {
+    // Restore the pairs disabled by steps 3. to 5. of a previous call
+    link_pairs = cache->link_pairs;
+    links_seen_colliding = cache->always_seen_colliding;
+    num_adjacent = cache->num_adjacent;
+    num_default = cache->num_default;
+    num_always = cache->num_always;
+    for (const std::pair<const std::pair<std::string, std::string>, LinkPairData>& link_pair : link_pairs)
+    {
+      if (link_pair.second.disable_check)
+        scene->getAllowedCollisionMatrixNonConst().setEntry(link_pair.first.first, link_pair.first.second, true);
+    }
+  }
+  else
+  {
+    // 3. DISABLE ALL ADJACENT LINK COLLISIONS ---------------------------------------------------------
+    // if 2 links are adjacent, or adjacent with a zero-shape between them, disable collision checking for them
+    num_adjacent = disableAdjacentLinks(*scene, link_graph, link_pairs);
+    *progress = 4;  // Progress bar feedback
+    boost::this_thread::interruption_point();
+
+    // 4. DISABLE "DEFAULT" COLLISIONS --------------------------------------------------------
+    // Disable all collision checks that occur when the robot is started in its default state
+    num_default = disableDefaultCollisions(*scene, link_pairs, req);
+    *progress = 6;  // Progress bar feedback
+    boost::this_thread::interruption_point();
 
-  // 5. ALWAYS IN COLLISION --------------------------------------------------------------------
-  // Compute the links that are always in collision
-  unsigned int num_always =
-      disableAlwaysInCollision(*scene, link_pairs, req, links_seen_colliding, min_collision_fraction);
-  // RCLCPP_INFO_STREAM(getLogger(), "Links seen colliding total = %d", int(links_seen_colliding.size()));
+    // 5. ALWAYS IN COLLISION --------------------------------------------------------------------
+    // Compute the links that are always in collision
+    num_always = disableAlwaysInCollision(*scene, link_pairs, req, links_seen_colliding, min_collision_fraction);
+    // RCLCPP_INFO_STREAM(getLogger(), "Links seen colliding total = %d", int(links_seen_colliding.size()));
+
+    if (cache)
+    {
+      cache->urdf_model = scene->getRobotModel()->getURDF();
+      cache->min_collision_fraction = min_collision_fraction;
+      cache->link_pairs = link_pairs;
+      cache->num_adjacent = num_adjacent;
+      cache->num_default = num_default;
+      cache->num_always = num_always;
+      cache->always_seen_colliding = links_seen_colliding;
+      cache->links_seen_colliding = links_seen_colliding;
+      cache->num_trials = 0;
+    }
+  }
   *progress = 8;  // Progress bar feedback
   boost::this_thread::interruption_point();
 
@@ -243,7 +286,19 @@ LinkPairMap computeDefaultCollisions(const planning_scene::PlanningSceneConstPtr
   unsigned int num_never = 0;
   if (include_never_colliding)  // option of function
   {
-    num_never = disableNeverInCollision(num_trials, *scene, link_pairs, req, links_seen_colliding, progress);
+    // More random states only add to the pairs seen colliding in the states sampled previously
+    unsigned int num_new_trials = num_trials;
+    if (cache && num_trials >= cache->num_trials)
+    {
+      links_seen_colliding = cache->links_seen_colliding;
+      num_new_trials -= cache->num_trials;
+    }
+    num_never = disableNeverInCollision(num_new_trials, *scene, link_pairs, req, links_seen_colliding, progress);
+    if (cache)
+    {
+      cache->links_seen_colliding = links_seen_colliding;
+      cache->num_trials = num_trials;
+    }
   }
 
   if (verbose)
@@ -538,20 +593,37 @@ unsigned int disableAlwaysInCollision(planning_scene::PlanningScene& scene, Link
 // ******************************************************************************************
 // Get the pairs of links that are never in collision
 // ******************************************************************************************
-unsigned int disableNeverInCollision(const unsigned int num_trials, planning_scene::PlanningScene& scene,
+unsigned int disableNeverInCollision(const unsigned int num_trials, const planning_scene::PlanningScene& scene,
                                      LinkPairMap& link_pairs, const collision_detection::CollisionRequest& req,
                                      StringPairSet& links_seen_colliding, unsigned int* progress)
 {
   unsigned int num_disabled = 0;
-  std::vector<std::thread> bgroup;
-  std::mutex lock;  // used for sharing the same data structures
 
-  int num_threads = std::thread::hardware_concurrency();  // how many cores does this computer have?
+  // Count the pairs that random states may still find colliding
+  std::size_t num_candidates = 0;
+  for (const std::pair<const std::pair<std::string, std::string>, LinkPairData>& link_pair : link_pairs)
+  {
+    if (!link_pair.second.disable_check && links_seen_colliding.find(link_pair.first) == links_seen_colliding.end())
+      ++num_candidates;
+  }
+
+  ThreadComputation tc(scene, req, num_trials, &links_seen_colliding, num_candidates, progress);
+  const unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());  // how many cores?
+  std::vector<std::thread> bgroup;
+  for (unsigned int i = 1; i < num_threads; ++i)
+    bgroup.emplace_back([&tc] { disableNeverInCollisionThread(tc, false); });
 
-  for (int i = 0; i < num_threads; ++i)
+  try
+  {
+    disableNeverInCollisionThread(tc, true);
+  }
+  catch (...)
   {
-    ThreadComputation tc(scene, req, i, num_trials / num_threads, &links_seen_colliding, &lock, progress);
-    bgroup.push_back(std::thread([tc] { return disableNeverInCollisionThread(tc); }));
+    // the calling thread was interrupted, stop the other threads before unwinding
+    tc.stop_ = true;
+    for (auto& thread : bgroup)
+      thread.join();
+    throw;
   }
 
   for (auto& thread : bgroup)
@@ -584,43 +656,50 @@ unsigned int disableNeverInCollision(const unsigned int num_trials, planning_sce
 // ******************************************************************************************
 // Thread for getting the pairs of links that are never in collision
 // ******************************************************************************************
-void disableNeverInCollisionThread(ThreadComputation tc)
+void disableNeverInCollisionThread(ThreadComputation& tc, bool calling_thread)
 {
-  // User feedback vars
-  const unsigned int progress_interval = tc.num_trials_ / 20;  // show progress update every 5%
-
   // Create a new kinematic state for this thread to work on
   moveit::core::RobotState robot_state(tc.scene_.getRobotModel());
 
-  // Do a large number of tests
-  for (unsigned int i = 0; i < tc.num_trials_; ++i)
-  {
-    boost::this_thread::interruption_point();
+  // Pairs seen colliding by any thread are allowed to collide in this thread's matrix, such that later checks skip
+  // them and only report pairs that were not seen colliding yet
+  collision_detection::AllowedCollisionMatrix acm = tc.scene_.getAllowedCollisionMatrix();
+  std::size_t num_synced_pairs = 0;
 
-    // Status update at intervals and only for 0 thread
-    if (i % progress_interval == 0 && tc.thread_id_ == 0)
+  // Do a large number of tests, taking the trials one by one so that the threads finish together
+  for (unsigned int i = tc.next_trial_++; i < tc.num_trials_ && !tc.stop_; i = tc.next_trial_++)
+  {
+    if (calling_thread)
     {
+      boost::this_thread::interruption_point();
       (*tc.progress_) = i * 92 / tc.num_trials_ + 8;  // 8 is the amount of progress already completed in prev steps
     }
 
+    if (tc.num_new_pairs_ > num_synced_pairs)
+    {
+      std::scoped_lock slock(tc.lock_);
+      for (; num_synced_pairs < tc.new_pairs_.size(); ++num_synced_pairs)
+        acm.setEntry(tc.new_pairs_[num_synced_pairs].first, tc.new_pairs_[num_synced_pairs].second, true);
+    }
+
     collision_detection::CollisionResult res;
     robot_state.setToRandomPositions();
-    tc.scene_.checkSelfCollision(tc.req_, res, robot_state);
+    tc.scene_.checkSelfCollision(tc.req_, res, robot_state, acm);
 
     // Check all contacts
-    for (collision_detection::CollisionResult::ContactMap::const_iterator it = res.contacts.begin();
-         it != res.contacts.end(); ++it)
+    for (const auto& [link_pair, contacts] : res.contacts)
     {
-      // Check if this collision pair is unique before doing a thread lock
-      if (tc.links_seen_colliding_->find(it->first) == tc.links_seen_colliding_->end())
-      {
-        // Collision Matrix and links_seen_colliding is modified only if needed, based on above if statement
+      acm.setEntry(link_pair.first, link_pair.second, true);
 
-        std::scoped_lock slock(*tc.lock_);
-        tc.links_seen_colliding_->insert(it->first);
+      std::scoped_lock slock(tc.lock_);
+      if (tc.links_seen_colliding_->insert(link_pair).second)
+      {
+        tc.new_pairs_.push_back(link_pair);
+        ++tc.num_new_pairs_;
 
-        tc.scene_.getAllowedCollisionMatrixNonConst().setEntry(it->first.first, it->first.second,
-                                                               true);  // disable link checking in the collision matrix
+        // Once all enabled pairs were seen colliding, further states can't find a pair that is never colliding
+        if (tc.num_candidates_ > 0 && --tc.num_candidates_ == 0)
+          tc.stop_ = true;
       }
     }
   }
@@ -164,7 +164,7 @@ void DefaultCollisions::generateCollisionTable(unsigned int num_trials, double m
 
   // Find the default collision matrix - all links that are allowed to collide
   link_pairs_ = computeDefaultCollisions(srdf_config_->getPlanningScene(), &progress_, include_never_colliding,
-                                         num_trials, min_frac, verbose);
+                                         num_trials, min_frac, verbose, &collisions_cache_);
 
   // End the progress bar loop
   progress_ = 100;
@@ -36,6 +36,8 @@
 #include <moveit_setup_framework/testing_utils.hpp>
 #include <moveit_setup_framework/data/srdf_config.hpp>
 #include <moveit_setup_srdf_plugins/planning_groups.hpp>
+#include <moveit_setup_srdf_plugins/compute_default_collisions.hpp>
+#include <moveit/planning_scene/planning_scene.hpp>
 #include <tinyxml2.h>
 
 using moveit_setup::getSharePath;
@@ -197,6 +199,39 @@ TEST_F(SRDFTest, SetJointsThenLinks)
   EXPECT_EQ(countElements(*group_el, "link"), 2u);
 }
 
+TEST_F(SRDFTest, DefaultCollisionsReuseCache)
+{
+  initializeWithFanuc();
+  using moveit_setup::srdf_setup::LinkPairMap;
+
+  planning_scene::PlanningScenePtr scene = srdf_config_->getPlanningScene();
+  scene->getAllowedCollisionMatrixNonConst().clear();
+  unsigned int progress = 0;
+  moveit_setup::srdf_setup::DefaultCollisionsCache cache;
+  const LinkPairMap sparse =
+      moveit_setup::srdf_setup::computeDefaultCollisions(scene, &progress, true, 1000, 0.95, false, &cache);
+  EXPECT_EQ(cache.num_trials, 1000u);
+  EXPECT_EQ(progress, 100u);
+
+  // more trials only sample the additional states, so they can only enable pairs that were never seen colliding
+  const LinkPairMap dense =
+      moveit_setup::srdf_setup::computeDefaultCollisions(scene, &progress, true, 3000, 0.95, false, &cache);
+  EXPECT_EQ(cache.num_trials, 3000u);
+  ASSERT_EQ(dense.size(), sparse.size());
+  for (const auto& [link_pair, data] : dense)
+  {
+    const moveit_setup::srdf_setup::LinkPairData& sparse_data = sparse.at(link_pair);
+    if (sparse_data.reason != moveit_setup::srdf_setup::NEVER)
+    {
+      EXPECT_EQ(data.reason, sparse_data.reason);
+    }
+    if (data.reason == moveit_setup::srdf_setup::NEVER)
+    {
+      EXPECT_EQ(sparse_data.reason, moveit_setup::srdf_setup::NEVER);
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);